@@ -0,0 +1,164 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef BENCHMARK_ALLOCATIONS_HPP
+#define BENCHMARK_ALLOCATIONS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "xtensor/xutils.hpp"
+
+namespace xt
+{
+    namespace alloc_bench
+    {
+        /**
+         * Allocations of the tracking allocator (XTENSOR_ALLOC_TRACKING with
+         * the count policy) since the previous benchmark, per iteration of
+         * the reported runs. The allocations of the set up of the benchmark and
+         * of the runs that estimate the number of iterations are included,
+         * so that an allocation free loop reports a small fraction rather
+         * than exactly 0, while each allocation of the loop adds 1.
+         */
+        class allocation_probe
+        {
+        public:
+
+            using run_type = benchmark::BenchmarkReporter::Run;
+
+            allocation_probe()
+                : m_allocations(alloc_tracking::statistics().allocations.load()), m_last(0.)
+            {
+            }
+
+            double update(const std::vector<run_type>& runs)
+            {
+                std::size_t allocations = alloc_tracking::statistics().allocations.load();
+                std::size_t delta = allocations - m_allocations;
+                m_allocations = allocations;
+                int64_t iterations = 0;
+                for (const auto& run : runs)
+                {
+                    if (!is_aggregate(run))
+                    {
+                        iterations += static_cast<int64_t>(run.iterations);
+                    }
+                }
+                m_last = iterations != 0 ? static_cast<double>(delta) / static_cast<double>(iterations) : 0.;
+                return m_last;
+            }
+
+            double last() const noexcept
+            {
+                return m_last;
+            }
+
+        private:
+
+            static bool is_aggregate(const run_type& run)
+            {
+                const std::string& name = run.benchmark_name;
+                for (const char* suffix : {"_mean", "_median", "_stddev"})
+                {
+                    std::string s(suffix);
+                    if (name.size() >= s.size() && name.compare(name.size() - s.size(), s.size(), s) == 0)
+                    {
+                        return true;
+                    }
+                }
+                return run.report_big_o || run.report_rms;
+            }
+
+            std::size_t m_allocations;
+            double m_last;
+        };
+
+        /**
+         * Adds the allocs_per_iter counter of the probe to the runs reported
+         * by the reporter R. The display reporter updates the probe, the file
+         * reporter, called next with the same runs, reuses its value.
+         */
+        template <class R>
+        class allocation_reporter : public R
+        {
+        public:
+
+            using run_type = benchmark::BenchmarkReporter::Run;
+
+            allocation_reporter(allocation_probe& probe, bool update)
+                : p_probe(&probe), m_update(update)
+            {
+            }
+
+            void ReportRuns(const std::vector<run_type>& reports) override
+            {
+                double allocations = m_update ? p_probe->update(reports) : p_probe->last();
+                std::vector<run_type> runs(reports);
+                for (auto& run : runs)
+                {
+                    run.counters["allocs_per_iter"] = benchmark::Counter(allocations);
+                }
+                R::ReportRuns(runs);
+            }
+
+        private:
+
+            allocation_probe* p_probe;
+            bool m_update;
+        };
+
+        // Returns true if the results are written to a json file, the only
+        // file format whose reporter is decorated
+        inline bool has_json_output(int argc, char** argv)
+        {
+            bool out = false;
+            bool json = true;
+            for (int i = 1; i < argc; ++i)
+            {
+                std::string arg(argv[i]);
+                if (arg.compare(0, 16, "--benchmark_out=") == 0)
+                {
+                    out = arg.size() > 16;
+                }
+                else if (arg.compare(0, 23, "--benchmark_out_format=") == 0)
+                {
+                    json = arg.substr(23) == "json";
+                }
+            }
+            return out && json;
+        }
+
+        /**
+         * Runs the benchmarks with the allocs_per_iter counter added to the
+         * console output, and to the json file output if \c json_output is
+         * true; it must be computed with has_json_output before the arguments
+         * are consumed by benchmark::Initialize.
+         */
+        inline void run_with_allocation_counters(bool json_output)
+        {
+            allocation_probe probe;
+            allocation_reporter<benchmark::ConsoleReporter> display(probe, true);
+            if (json_output)
+            {
+                allocation_reporter<benchmark::JSONReporter> file(probe, false);
+                benchmark::RunSpecifiedBenchmarks(&display, &file);
+            }
+            else
+            {
+                benchmark::RunSpecifiedBenchmarks(&display);
+            }
+        }
+    }
+}
+
+#endif
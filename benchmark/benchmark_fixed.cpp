@@ -0,0 +1,415 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef BENCHMARK_FIXED_HPP
+#define BENCHMARK_FIXED_HPP
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "xtensor/xfixed.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xreducer.hpp"
+
+#if defined(XTENSOR_BENCHMARK_EIGEN)
+#include <Eigen/Core>
+#endif
+
+namespace xt
+{
+    namespace fixed_bench
+    {
+
+        /****************************
+         * Benchmark initialization *
+         ****************************/
+
+        // Every kernel loops over many small N x N objects; their number
+        // decreases with N so that each array of objects holds 4M values
+        // (one million 2 x 2 objects), much more than the last level cache.
+        template <std::size_t N>
+        constexpr std::size_t object_count()
+        {
+            return (std::size_t(1) << 22) / (N * N);
+        }
+
+        template <std::size_t N>
+        using fixed_matrix = xtensor_fixed<double, xshape<N, N>>;
+
+        template <std::size_t N>
+        using fixed_vector = xtensor_fixed<double, xshape<N>>;
+
+        template <std::size_t N>
+        using raw_matrix = std::array<double, N * N>;
+
+        template <class M>
+        inline std::vector<M> make_objects(std::size_t count, double offset)
+        {
+            std::vector<M> res(count);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                double* p = res[i].data();
+                for (std::size_t k = 0; k < res[i].size(); ++k)
+                {
+                    p[k] = offset + static_cast<double>((i + k) % 17);
+                }
+            }
+            return res;
+        }
+
+        template <std::size_t N>
+        inline std::vector<raw_matrix<N>> make_raw_objects(std::size_t count, double offset)
+        {
+            std::vector<raw_matrix<N>> res(count);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                for (std::size_t k = 0; k < N * N; ++k)
+                {
+                    res[i][k] = offset + static_cast<double>((i + k) % 17);
+                }
+            }
+            return res;
+        }
+
+        inline void set_items(benchmark::State& state, std::size_t count, std::size_t values_per_object)
+        {
+            state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+            state.counters["values"] = static_cast<double>(values_per_object);
+        }
+
+        /***********************
+         * element-wise chains *
+         ***********************/
+
+        template <std::size_t N>
+        inline void chain_raw(benchmark::State& state)
+        {
+            constexpr std::size_t count = object_count<N>();
+            auto a = make_raw_objects<N>(count, 1.);
+            auto b = make_raw_objects<N>(count, 2.);
+            std::vector<raw_matrix<N>> res(count);
+            for (auto _ : state)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    for (std::size_t k = 0; k < N * N; ++k)
+                    {
+                        res[i][k] = a[i][k] * b[i][k] + a[i][k] * 0.5;
+                    }
+                }
+                benchmark::DoNotOptimize(res.data());
+            }
+            set_items(state, count, N * N);
+        }
+
+        template <std::size_t N>
+        inline void chain_xfixed(benchmark::State& state)
+        {
+            constexpr std::size_t count = object_count<N>();
+            auto a = make_objects<fixed_matrix<N>>(count, 1.);
+            auto b = make_objects<fixed_matrix<N>>(count, 2.);
+            std::vector<fixed_matrix<N>> res(count);
+            for (auto _ : state)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    res[i] = a[i] * b[i] + a[i] * 0.5;
+                }
+                benchmark::DoNotOptimize(res.data());
+            }
+            set_items(state, count, N * N);
+        }
+
+        template <std::size_t N>
+        inline void chain_xfixed_noalias(benchmark::State& state)
+        {
+            constexpr std::size_t count = object_count<N>();
+            auto a = make_objects<fixed_matrix<N>>(count, 1.);
+            auto b = make_objects<fixed_matrix<N>>(count, 2.);
+            std::vector<fixed_matrix<N>> res(count);
+            for (auto _ : state)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    noalias(res[i]) = a[i] * b[i] + a[i] * 0.5;
+                }
+                benchmark::DoNotOptimize(res.data());
+            }
+            set_items(state, count, N * N);
+        }
+
+        // a longer chain, evaluated in place
+        template <std::size_t N>
+        inline void chain_inplace_raw(benchmark::State& state)
+        {
+            constexpr std::size_t count = object_count<N>();
+            auto a = make_raw_objects<N>(count, 1.);
+            auto b = make_raw_objects<N>(count, 2.);
+            for (auto _ : state)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    for (std::size_t k = 0; k < N * N; ++k)
+                    {
+                        a[i][k] += (b[i][k] - a[i][k]) * 1e-3 + b[i][k] * b[i][k] * 1e-6;
+                    }
+                }
+                benchmark::DoNotOptimize(a.data());
+            }
+            set_items(state, count, N * N);
+        }
+
+        template <std::size_t N>
+        inline void chain_inplace_xfixed(benchmark::State& state)
+        {
+            constexpr std::size_t count = object_count<N>();
+            auto a = make_objects<fixed_matrix<N>>(count, 1.);
+            auto b = make_objects<fixed_matrix<N>>(count, 2.);
+            for (auto _ : state)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    a[i] += (b[i] - a[i]) * 1e-3 + b[i] * b[i] * 1e-6;
+                }
+                benchmark::DoNotOptimize(a.data());
+            }
+            set_items(state, count, N * N);
+        }
+
+        /**************
+         * reductions *
+         **************/
+
+        template <std::size_t N>
+        inline void sum_raw(benchmark::State& state)
+        {
+            constexpr std::size_t count = object_count<N>();
+            auto a = make_raw_objects<N>(count, 1.);
+            std::vector<double> res(count);
+            for (auto _ : state)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    double acc = 0.;
+                    for (std::size_t k = 0; k < N * N; ++k)
+                    {
+                        acc += a[i][k];
+                    }
+                    res[i] = acc;
+                }
+                benchmark::DoNotOptimize(res.data());
+            }
+            set_items(state, count, N * N);
+        }
+
+        template <std::size_t N>
+        inline void sum_xfixed(benchmark::State& state)
+        {
+            constexpr std::size_t count = object_count<N>();
+            auto a = make_objects<fixed_matrix<N>>(count, 1.);
+            std::vector<double> res(count);
+            for (auto _ : state)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    res[i] = sum(a[i], evaluation_strategy::immediate())();
+                }
+                benchmark::DoNotOptimize(res.data());
+            }
+            set_items(state, count, N * N);
+        }
+
+        template <std::size_t N>
+        inline void sum_xfixed_lazy(benchmark::State& state)
+        {
+            constexpr std::size_t count = object_count<N>();
+            auto a = make_objects<fixed_matrix<N>>(count, 1.);
+            std::vector<double> res(count);
+            for (auto _ : state)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    res[i] = sum(a[i])();
+                }
+                benchmark::DoNotOptimize(res.data());
+            }
+            set_items(state, count, N * N);
+        }
+
+        template <std::size_t N>
+        inline void row_sum_raw(benchmark::State& state)
+        {
+            constexpr std::size_t count = object_count<N>();
+            auto a = make_raw_objects<N>(count, 1.);
+            std::vector<std::array<double, N>> res(count);
+            for (auto _ : state)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    for (std::size_t r = 0; r < N; ++r)
+                    {
+                        double acc = 0.;
+                        for (std::size_t c = 0; c < N; ++c)
+                        {
+                            acc += a[i][r * N + c];
+                        }
+                        res[i][r] = acc;
+                    }
+                }
+                benchmark::DoNotOptimize(res.data());
+            }
+            set_items(state, count, N * N);
+        }
+
+        template <std::size_t N>
+        inline void row_sum_xfixed(benchmark::State& state)
+        {
+            constexpr std::size_t count = object_count<N>();
+            auto a = make_objects<fixed_matrix<N>>(count, 1.);
+            std::vector<fixed_vector<N>> res(count);
+            for (auto _ : state)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    noalias(res[i]) = sum(a[i], {1});
+                }
+                benchmark::DoNotOptimize(res.data());
+            }
+            set_items(state, count, N * N);
+        }
+
+#if defined(XTENSOR_BENCHMARK_EIGEN)
+
+        /*********
+         * Eigen *
+         *********/
+
+        template <std::size_t N>
+        using eigen_matrix = Eigen::Matrix<double, int(N), int(N), Eigen::RowMajor>;
+
+        template <class M>
+        using eigen_vector_of = std::vector<M, Eigen::aligned_allocator<M>>;
+
+        template <std::size_t N>
+        inline eigen_vector_of<eigen_matrix<N>> make_eigen_objects(std::size_t count, double offset)
+        {
+            eigen_vector_of<eigen_matrix<N>> res(count);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                double* p = res[i].data();
+                for (std::size_t k = 0; k < N * N; ++k)
+                {
+                    p[k] = offset + static_cast<double>((i + k) % 17);
+                }
+            }
+            return res;
+        }
+
+        template <std::size_t N>
+        inline void chain_eigen(benchmark::State& state)
+        {
+            constexpr std::size_t count = object_count<N>();
+            auto a = make_eigen_objects<N>(count, 1.);
+            auto b = make_eigen_objects<N>(count, 2.);
+            eigen_vector_of<eigen_matrix<N>> res(count);
+            for (auto _ : state)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    res[i] = (a[i].array() * b[i].array() + a[i].array() * 0.5).matrix();
+                }
+                benchmark::DoNotOptimize(res.data());
+            }
+            set_items(state, count, N * N);
+        }
+
+        template <std::size_t N>
+        inline void chain_inplace_eigen(benchmark::State& state)
+        {
+            constexpr std::size_t count = object_count<N>();
+            auto a = make_eigen_objects<N>(count, 1.);
+            auto b = make_eigen_objects<N>(count, 2.);
+            for (auto _ : state)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    a[i].array() += (b[i].array() - a[i].array()) * 1e-3 + b[i].array() * b[i].array() * 1e-6;
+                }
+                benchmark::DoNotOptimize(a.data());
+            }
+            set_items(state, count, N * N);
+        }
+
+        template <std::size_t N>
+        inline void sum_eigen(benchmark::State& state)
+        {
+            constexpr std::size_t count = object_count<N>();
+            auto a = make_eigen_objects<N>(count, 1.);
+            std::vector<double> res(count);
+            for (auto _ : state)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    res[i] = a[i].sum();
+                }
+                benchmark::DoNotOptimize(res.data());
+            }
+            set_items(state, count, N * N);
+        }
+
+        template <std::size_t N>
+        inline void row_sum_eigen(benchmark::State& state)
+        {
+            using vector_type = Eigen::Matrix<double, int(N), 1>;
+            constexpr std::size_t count = object_count<N>();
+            auto a = make_eigen_objects<N>(count, 1.);
+            eigen_vector_of<vector_type> res(count);
+            for (auto _ : state)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    res[i] = a[i].rowwise().sum();
+                }
+                benchmark::DoNotOptimize(res.data());
+            }
+            set_items(state, count, N * N);
+        }
+#endif
+
+#define XTENSOR_FIXED_BENCHMARKS(KERNEL)  \
+        BENCHMARK_TEMPLATE(KERNEL, 2);    \
+        BENCHMARK_TEMPLATE(KERNEL, 3);    \
+        BENCHMARK_TEMPLATE(KERNEL, 4);    \
+        BENCHMARK_TEMPLATE(KERNEL, 8)
+
+        XTENSOR_FIXED_BENCHMARKS(chain_raw);
+        XTENSOR_FIXED_BENCHMARKS(chain_xfixed);
+        XTENSOR_FIXED_BENCHMARKS(chain_xfixed_noalias);
+        XTENSOR_FIXED_BENCHMARKS(chain_inplace_raw);
+        XTENSOR_FIXED_BENCHMARKS(chain_inplace_xfixed);
+        XTENSOR_FIXED_BENCHMARKS(sum_raw);
+        XTENSOR_FIXED_BENCHMARKS(sum_xfixed);
+        XTENSOR_FIXED_BENCHMARKS(sum_xfixed_lazy);
+        XTENSOR_FIXED_BENCHMARKS(row_sum_raw);
+        XTENSOR_FIXED_BENCHMARKS(row_sum_xfixed);
+#if defined(XTENSOR_BENCHMARK_EIGEN)
+        XTENSOR_FIXED_BENCHMARKS(chain_eigen);
+        XTENSOR_FIXED_BENCHMARKS(chain_inplace_eigen);
+        XTENSOR_FIXED_BENCHMARKS(sum_eigen);
+        XTENSOR_FIXED_BENCHMARKS(row_sum_eigen);
+#endif
+
+#undef XTENSOR_FIXED_BENCHMARKS
+    }
+}
+
+#endif
@@ -0,0 +1,312 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef BENCHMARK_IO_HPP
+#define BENCHMARK_IO_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "xtensor/xcsv.hpp"
+#include "xtensor/xnpy.hpp"
+#include "xtensor/xtensor.hpp"
+
+#if defined(XTENSOR_BENCHMARK_JSON)
+#include "xtensor/xjson.hpp"
+#endif
+
+namespace xt
+{
+    namespace io_bench
+    {
+
+        /****************************
+         * Benchmark initialization *
+         ****************************/
+
+        // state.range(0) is the number of rows of 64 elements
+        template <class T>
+        inline xtensor<T, 2> make_io_data(benchmark::State& state)
+        {
+            xtensor<T, 2> data({static_cast<std::size_t>(state.range(0)), std::size_t(64)});
+            for (std::size_t i = 0; i < data.size(); ++i)
+            {
+                data.data()[i] = static_cast<T>(i % 1000) / static_cast<T>(8);
+            }
+            return data;
+        }
+
+        template <class T>
+        inline std::string io_file_name(const char* kernel)
+        {
+            return std::string("xbenchmark_io_") + kernel + "_" + std::to_string(sizeof(T));
+        }
+
+        // Drops the pages of the file from the page cache, so that the next
+        // read comes from the disk; returns false when this is not supported
+        inline bool evict_file_cache(const std::string& filename)
+        {
+#if (defined(__unix__) || defined(__APPLE__)) && defined(POSIX_FADV_DONTNEED)
+            int fd = ::open(filename.c_str(), O_RDONLY);
+            if (fd == -1)
+            {
+                return false;
+            }
+            ::fsync(fd);
+            bool res = ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+            ::close(fd);
+            return res;
+#else
+            (void) filename;
+            return false;
+#endif
+        }
+
+        // state.range(1) selects a cold cache when it is not zero
+        inline bool cold_cache(benchmark::State& state, const std::string& filename)
+        {
+            if (state.range(1) == 0)
+            {
+                state.SetLabel("warm");
+                return false;
+            }
+            state.SetLabel("cold");
+            state.PauseTiming();
+            bool res = evict_file_cache(filename);
+            state.ResumeTiming();
+            return res;
+        }
+
+        inline void io_args(benchmark::internal::Benchmark* b)
+        {
+            for (int rows : {16, 1024, 65536})
+            {
+                b->Args({rows, 0});
+            }
+        }
+
+        inline void file_args(benchmark::internal::Benchmark* b)
+        {
+            for (int rows : {16, 1024, 65536})
+            {
+                b->Args({rows, 0});
+                b->Args({rows, 1});
+            }
+        }
+
+        /*******
+         * npy *
+         *******/
+
+        template <class T>
+        inline void npy_dump_stream(benchmark::State& state)
+        {
+            auto data = make_io_data<T>(state);
+            for (auto _ : state)
+            {
+                std::ostringstream stream;
+                detail::dump_npy_stream(stream, data);
+                benchmark::DoNotOptimize(stream.tellp());
+            }
+            state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size() * sizeof(T)));
+        }
+
+        template <class T>
+        inline void npy_load_stream(benchmark::State& state)
+        {
+            auto data = make_io_data<T>(state);
+            std::ostringstream out;
+            detail::dump_npy_stream(out, data);
+            std::string buffer = out.str();
+            xtensor<T, 2> res;
+            for (auto _ : state)
+            {
+                std::istringstream stream(buffer);
+                load_npy_into(stream, res);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size() * sizeof(T)));
+        }
+
+        template <class T>
+        inline void npy_dump_file(benchmark::State& state)
+        {
+            auto data = make_io_data<T>(state);
+            std::string filename = io_file_name<T>("dump") + ".npy";
+            for (auto _ : state)
+            {
+                dump_npy(filename, data);
+            }
+            std::remove(filename.c_str());
+            state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size() * sizeof(T)));
+        }
+
+        template <class T>
+        inline void npy_load_file(benchmark::State& state)
+        {
+            auto data = make_io_data<T>(state);
+            std::string filename = io_file_name<T>("load") + ".npy";
+            dump_npy(filename, data);
+            for (auto _ : state)
+            {
+                cold_cache(state, filename);
+                auto res = load_npy<T>(filename);
+                benchmark::DoNotOptimize(res.data());
+            }
+            std::remove(filename.c_str());
+            state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size() * sizeof(T)));
+        }
+
+        // the mapped elements are summed so that they are actually read
+        template <class T>
+        inline void npy_mmap_file(benchmark::State& state)
+        {
+            auto data = make_io_data<T>(state);
+            std::string filename = io_file_name<T>("mmap") + ".npy";
+            dump_npy(filename, data);
+            for (auto _ : state)
+            {
+                cold_cache(state, filename);
+                auto res = mmap_npy<T>(filename);
+                T acc = T(0);
+                for (auto v : res)
+                {
+                    acc += v;
+                }
+                benchmark::DoNotOptimize(acc);
+            }
+            std::remove(filename.c_str());
+            state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size() * sizeof(T)));
+        }
+
+        /*******
+         * csv *
+         *******/
+
+        template <class T>
+        inline void csv_dump_stream(benchmark::State& state)
+        {
+            auto data = make_io_data<T>(state);
+            for (auto _ : state)
+            {
+                std::ostringstream stream;
+                dump_csv(stream, data);
+                benchmark::DoNotOptimize(stream.tellp());
+            }
+            state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size() * sizeof(T)));
+        }
+
+        template <class T>
+        inline void csv_load_stream(benchmark::State& state)
+        {
+            auto data = make_io_data<T>(state);
+            std::ostringstream out;
+            dump_csv(out, data);
+            std::string buffer = out.str();
+            for (auto _ : state)
+            {
+                std::istringstream stream(buffer);
+                auto res = load_csv<T>(stream);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.counters["text_bytes"] = static_cast<double>(buffer.size());
+            state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size() * sizeof(T)));
+        }
+
+        template <class T>
+        inline void csv_load_file(benchmark::State& state)
+        {
+            auto data = make_io_data<T>(state);
+            std::string filename = io_file_name<T>("load") + ".csv";
+            {
+                std::ofstream out(filename);
+                dump_csv(out, data);
+            }
+            for (auto _ : state)
+            {
+                cold_cache(state, filename);
+                auto res = load_csv<T>(filename);
+                benchmark::DoNotOptimize(res.data());
+            }
+            std::remove(filename.c_str());
+            state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size() * sizeof(T)));
+        }
+
+        BENCHMARK_TEMPLATE(npy_dump_stream, double)->Apply(io_args);
+        BENCHMARK_TEMPLATE(npy_dump_stream, float)->Apply(io_args);
+        BENCHMARK_TEMPLATE(npy_dump_stream, std::int32_t)->Apply(io_args);
+        BENCHMARK_TEMPLATE(npy_load_stream, double)->Apply(io_args);
+        BENCHMARK_TEMPLATE(npy_load_stream, float)->Apply(io_args);
+        BENCHMARK_TEMPLATE(npy_load_stream, std::int32_t)->Apply(io_args);
+        BENCHMARK_TEMPLATE(npy_dump_file, double)->Apply(io_args);
+        BENCHMARK_TEMPLATE(npy_load_file, double)->Apply(file_args);
+        BENCHMARK_TEMPLATE(npy_load_file, std::int32_t)->Apply(file_args);
+        BENCHMARK_TEMPLATE(npy_mmap_file, double)->Apply(file_args);
+
+        BENCHMARK_TEMPLATE(csv_dump_stream, double)->Apply(io_args);
+        BENCHMARK_TEMPLATE(csv_dump_stream, std::int32_t)->Apply(io_args);
+        BENCHMARK_TEMPLATE(csv_load_stream, double)->Apply(io_args);
+        BENCHMARK_TEMPLATE(csv_load_stream, std::int32_t)->Apply(io_args);
+        BENCHMARK_TEMPLATE(csv_load_file, double)->Apply(file_args);
+
+#if defined(XTENSOR_BENCHMARK_JSON)
+
+        /********
+         * json *
+         ********/
+
+        template <class T>
+        inline void json_dump_string(benchmark::State& state)
+        {
+            auto data = make_io_data<T>(state);
+            for (auto _ : state)
+            {
+                nlohmann::json j;
+                to_json(j, data);
+                std::string text = j.dump();
+                benchmark::DoNotOptimize(text.data());
+            }
+            state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size() * sizeof(T)));
+        }
+
+        template <class T>
+        inline void json_load_string(benchmark::State& state)
+        {
+            auto data = make_io_data<T>(state);
+            nlohmann::json out;
+            to_json(out, data);
+            std::string text = out.dump();
+            xtensor<T, 2> res;
+            for (auto _ : state)
+            {
+                nlohmann::json j = nlohmann::json::parse(text);
+                from_json(j, res);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size() * sizeof(T)));
+        }
+
+        BENCHMARK_TEMPLATE(json_dump_string, double)->Apply(io_args);
+        BENCHMARK_TEMPLATE(json_dump_string, std::int32_t)->Apply(io_args);
+        BENCHMARK_TEMPLATE(json_load_string, double)->Apply(io_args);
+        BENCHMARK_TEMPLATE(json_load_string, std::int32_t)->Apply(io_args);
+#endif
+    }
+}
+
+#endif
@@ -8,6 +8,7 @@
 
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <map>
 #include <string>
 
@@ -15,8 +16,11 @@
 
 #include "xtensor/xarray.hpp"
 #include "xtensor/xnoalias.hpp"
+#include "xtensor/xquantize.hpp"
 #include "xtensor/xtensor.hpp"
 
+#include "benchmark_roofline.hpp"
+
 // For how many sizes should math functions be tested?
 #define MATH_RANGE 64, 64
 
@@ -79,6 +83,7 @@ namespace xt
                 xt::noalias(res) = f(lhs, rhs);
                 benchmark::DoNotOptimize(res.data());
             }
+            roofline::report(state, 3 * res.size() * sizeof(double));
         }
 
         template <class F, class V>
@@ -95,6 +100,7 @@ namespace xt
                 std::copy(fct.storage_begin(), fct.storage_end(), res.storage_begin());
                 benchmark::DoNotOptimize(res.data());
             }
+            roofline::report(state, 3 * res.size() * sizeof(double));
         }
 
         template <class F, class V>
@@ -110,6 +116,7 @@ namespace xt
                 xt::noalias(res) = f(lhs);
                 benchmark::DoNotOptimize(res.data());
             }
+            roofline::report(state, 2 * res.size() * sizeof(double));
         }
 
         template <class F>
@@ -128,6 +135,7 @@ namespace xt
                 }
                 benchmark::DoNotOptimize(res.data());
             }
+            roofline::report(state, 3 * size * sizeof(double));
         }
 
         template <class F>
@@ -146,6 +154,7 @@ namespace xt
                 }
                 benchmark::DoNotOptimize(res.data());
             }
+            roofline::report(state, 2 * size * sizeof(double));
         }
 
         /**********************
@@ -307,6 +316,7 @@ namespace xt
             res += typename T::value_type(1);
             benchmark::DoNotOptimize(res.data());
         }
+        roofline::report(state, 2 * res.size() * sizeof(typename T::value_type));
     }
 
     template <class T>
@@ -324,6 +334,7 @@ namespace xt
             }
             benchmark::DoNotOptimize(res.data());
         }
+        roofline::report(state, 2 * res.size() * sizeof(typename T::value_type));
     }
 
     template <class T>
@@ -364,8 +375,56 @@ namespace xt
         }
     }
 
+    void saturating_add_int8(benchmark::State& state)
+    {
+        std::size_t sz = static_cast<std::size_t>(state.range(0));
+        xtensor<std::int8_t, 2> a = xtensor<std::int8_t, 2>::from_shape({sz, sz});
+        xtensor<std::int8_t, 2> b = xtensor<std::int8_t, 2>::from_shape({sz, sz});
+        xtensor<std::int8_t, 2> res = xtensor<std::int8_t, 2>::from_shape({sz, sz});
+        a.fill(std::int8_t(100));
+        b.fill(std::int8_t(50));
+        for (auto _ : state)
+        {
+            noalias(res) = saturating_add(a, b);
+            benchmark::DoNotOptimize(res.data());
+        }
+        roofline::report(state, 3 * res.size() * sizeof(std::int8_t));
+    }
+
+    void requantize_int32(benchmark::State& state)
+    {
+        std::size_t sz = static_cast<std::size_t>(state.range(0));
+        xtensor<std::int32_t, 2> acc = xtensor<std::int32_t, 2>::from_shape({sz, sz});
+        xtensor<std::int8_t, 2> res = xtensor<std::int8_t, 2>::from_shape({sz, sz});
+        acc.fill(12345);
+        for (auto _ : state)
+        {
+            noalias(res) = requantize(acc, 1 << 20, 30, 3);
+            benchmark::DoNotOptimize(res.data());
+        }
+        roofline::report(state, res.size() * (sizeof(std::int32_t) + sizeof(std::int8_t)));
+    }
+
+    void dot_accumulate_int8(benchmark::State& state)
+    {
+        std::size_t sz = static_cast<std::size_t>(state.range(0));
+        xtensor<std::int8_t, 1> a = xtensor<std::int8_t, 1>::from_shape({sz * sz});
+        xtensor<std::int8_t, 1> b = xtensor<std::int8_t, 1>::from_shape({sz * sz});
+        a.fill(std::int8_t(-3));
+        b.fill(std::int8_t(7));
+        for (auto _ : state)
+        {
+            std::int32_t res = dot_accumulate(a, b);
+            benchmark::DoNotOptimize(res);
+        }
+        roofline::report(state, 2 * a.size() * sizeof(std::int8_t), 2 * a.size());
+    }
+
     BENCHMARK_TEMPLATE(scalar_assign, xtensor<double, 2>)->Range(MATH_RANGE);
     BENCHMARK_TEMPLATE(scalar_assign_ref, xtensor<double, 2>)->Range(MATH_RANGE);
     BENCHMARK_TEMPLATE(boolean_func, xtensor<double, 2>)->Range(MATH_RANGE);
     BENCHMARK_TEMPLATE(boolean_func_ref, xtensor<double, 2>)->Range(MATH_RANGE);
+    BENCHMARK(saturating_add_int8)->Range(MATH_RANGE);
+    BENCHMARK(requantize_int32)->Range(MATH_RANGE);
+    BENCHMARK(dot_accumulate_int8)->Range(MATH_RANGE);
 }
@@ -0,0 +1,217 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef BENCHMARK_PARALLEL_HPP
+#define BENCHMARK_PARALLEL_HPP
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <benchmark/benchmark.h>
+
+#include "xtensor/xassign.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xparallel.hpp"
+#include "xtensor/xreducer.hpp"
+#include "xtensor/xstrided_view.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xvectorize.hpp"
+
+namespace xt
+{
+    namespace parallel_scaling
+    {
+
+        /*****************
+         * thread limits *
+         *****************/
+
+        // Runs the benchmarked kernels with at most n threads of the backend
+        // selected by the parallel assignment paths
+        class thread_limit
+        {
+        public:
+
+            explicit thread_limit(std::size_t n)
+#if defined(XTENSOR_USE_TBB)
+                : m_arena(static_cast<int>(n))
+#endif
+            {
+#if !defined(XTENSOR_USE_TBB) && defined(XTENSOR_USE_OPENMP)
+                omp_set_num_threads(static_cast<int>(n));
+#endif
+                (void) n;
+            }
+
+            template <class F>
+            void run(F&& f)
+            {
+#if defined(XTENSOR_USE_TBB)
+                m_arena.execute(std::forward<F>(f));
+#else
+                f();
+#endif
+            }
+
+        private:
+
+#if defined(XTENSOR_USE_TBB)
+            tbb::task_arena m_arena;
+#endif
+        };
+
+        inline std::size_t max_threads()
+        {
+#if defined(XTENSOR_PARALLEL_ENABLED)
+            std::size_t n = std::thread::hardware_concurrency();
+            return n == 0 ? 1 : n;
+#else
+            return 1;
+#endif
+        }
+
+        // sizes x thread counts, the single thread run of each size coming
+        // first so that it gives the reference of the speedups
+        inline void scaling_args(benchmark::internal::Benchmark* b)
+        {
+            for (int size : {64, 512, 2048})
+            {
+                for (std::size_t threads = 1; threads <= max_threads(); threads *= 2)
+                {
+                    b->Args({size, static_cast<int>(threads)});
+                }
+            }
+        }
+
+        /******************
+         * scaling report *
+         ******************/
+
+        // Measures the wall time per iteration of a kernel and reports its
+        // speedup and efficiency relative to the single thread run
+        template <class F>
+        inline void run_scaling(benchmark::State& state, const std::string& kernel, std::size_t bytes, F&& f)
+        {
+            using clock_type = std::chrono::steady_clock;
+            static std::map<std::pair<std::string, int>, double> references;
+
+            std::size_t threads = static_cast<std::size_t>(state.range(1));
+            thread_limit limit(threads);
+            auto start = clock_type::now();
+            for (auto _ : state)
+            {
+                limit.run(f);
+            }
+            double elapsed = std::chrono::duration<double>(clock_type::now() - start).count();
+            double time = elapsed / static_cast<double>(state.iterations());
+
+            auto key = std::make_pair(kernel, static_cast<int>(state.range(0)));
+            if (threads == 1)
+            {
+                references[key] = time;
+            }
+            auto it = references.find(key);
+            double speedup = it != references.end() ? it->second / time : 0.;
+            state.counters["threads"] = static_cast<double>(threads);
+            state.counters["speedup"] = speedup;
+            state.counters["efficiency"] = speedup / static_cast<double>(threads);
+            state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+        }
+
+        template <class V>
+        inline void init_scaling_data(V& v)
+        {
+            using T = typename V::value_type;
+            for (std::size_t i = 0; i < v.size(); ++i)
+            {
+                v.data()[i] = T(0.5) * T(i % 97) + T(1);
+            }
+        }
+
+        /***********
+         * kernels *
+         ***********/
+
+        inline void scaling_linear_assign(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            xtensor<double, 2> x({n, n}), y({n, n}), res({n, n});
+            init_scaling_data(x);
+            init_scaling_data(y);
+            run_scaling(state, "linear", 3 * x.size() * sizeof(double), [&]()
+            {
+                noalias(res) = 3.0 * x - 2.0 * y;
+                benchmark::DoNotOptimize(res.data());
+            });
+        }
+
+        inline void scaling_strided_assign(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            xtensor<double, 2> x({n, 2 * n}), res({n, n});
+            init_scaling_data(x);
+            auto sv = strided_view(x, {all(), range(0, 2 * n, 2)});
+            run_scaling(state, "strided", 2 * res.size() * sizeof(double), [&]()
+            {
+                noalias(res) = 2.0 * sv + 1.0;
+                benchmark::DoNotOptimize(res.data());
+            });
+        }
+
+        inline void scaling_stepper_assign(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            xtensor<double, 2> x({n, 2 * n}), res({n, n});
+            init_scaling_data(x);
+            auto sv = strided_view(x, {all(), range(0, 2 * n, 2)});
+            // the functor only accepts scalars, which rules out the SIMD loops
+            auto f = vectorize([](double a) { return a < 1.5 ? a : 1.5; });
+            run_scaling(state, "stepper", 2 * res.size() * sizeof(double), [&]()
+            {
+                noalias(res) = f(sv);
+                benchmark::DoNotOptimize(res.data());
+            });
+        }
+
+        inline void scaling_reduce_axis(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            xtensor<double, 2> x({n, n});
+            xtensor<double, 1> res({n});
+            init_scaling_data(x);
+            run_scaling(state, "reduce_axis", x.size() * sizeof(double), [&]()
+            {
+                noalias(res) = sum(x, {1});
+                benchmark::DoNotOptimize(res.data());
+            });
+        }
+
+        inline void scaling_reduce_all(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            xtensor<double, 2> x({n, n});
+            init_scaling_data(x);
+            run_scaling(state, "reduce_all", x.size() * sizeof(double), [&]()
+            {
+                double res = sum(x)();
+                benchmark::DoNotOptimize(res);
+            });
+        }
+
+        BENCHMARK(scaling_linear_assign)->Apply(scaling_args)->UseRealTime();
+        BENCHMARK(scaling_strided_assign)->Apply(scaling_args)->UseRealTime();
+        BENCHMARK(scaling_stepper_assign)->Apply(scaling_args)->UseRealTime();
+        BENCHMARK(scaling_reduce_axis)->Apply(scaling_args)->UseRealTime();
+        BENCHMARK(scaling_reduce_all)->Apply(scaling_args)->UseRealTime();
+    }
+}
+
+#endif
@@ -0,0 +1,114 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef BENCHMARK_ROOFLINE_HPP
+#define BENCHMARK_ROOFLINE_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace xt
+{
+    namespace roofline
+    {
+        /**
+         * Bandwidth of the STREAM triad a[i] = b[i] + s * c[i] on arrays much
+         * larger than the last level cache, in bytes per second. Following
+         * STREAM, the bytes written are counted once. It is measured at the
+         * first call, as the best of several runs.
+         */
+        inline double memory_bandwidth()
+        {
+            static double bandwidth = []()
+            {
+                using clock_type = std::chrono::steady_clock;
+                constexpr std::size_t size = std::size_t(1) << 23;
+                std::vector<double> a(size, 0.), b(size, 1.), c(size, 2.);
+                double best = 0.;
+                for (int run = 0; run < 5; ++run)
+                {
+                    auto start = clock_type::now();
+                    double* pa = a.data();
+                    const double* pb = b.data();
+                    const double* pc = c.data();
+                    for (std::size_t i = 0; i < size; ++i)
+                    {
+                        pa[i] = pb[i] + 3. * pc[i];
+                    }
+                    benchmark::DoNotOptimize(pa);
+                    benchmark::ClobberMemory();
+                    double elapsed = std::chrono::duration<double>(clock_type::now() - start).count();
+                    best = std::max(best, 3. * sizeof(double) * size / elapsed);
+                }
+                return best;
+            }();
+            return bandwidth;
+        }
+
+        /**
+         * Rate of double precision floating point operations of a multiply-add
+         * loop on arrays that stay in the L1 cache, in flops per second. It
+         * is measured at the first call, as the best of several runs.
+         */
+        inline double flop_rate()
+        {
+            static double rate = []()
+            {
+                using clock_type = std::chrono::steady_clock;
+                constexpr std::size_t size = 512;
+                constexpr std::size_t repeat = 20000;
+                std::vector<double> a(size, 1.);
+                double best = 0.;
+                for (int run = 0; run < 5; ++run)
+                {
+                    auto start = clock_type::now();
+                    double* pa = a.data();
+                    for (std::size_t r = 0; r < repeat; ++r)
+                    {
+                        for (std::size_t i = 0; i < size; ++i)
+                        {
+                            pa[i] = pa[i] * 0.999999 + 1e-7;
+                        }
+                        benchmark::ClobberMemory();
+                    }
+                    benchmark::DoNotOptimize(pa);
+                    double elapsed = std::chrono::duration<double>(clock_type::now() - start).count();
+                    best = std::max(best, 2. * size * repeat / elapsed);
+                }
+                return best;
+            }();
+            return rate;
+        }
+
+        /**
+         * Reports the achieved fraction of the memory bandwidth and of the
+         * flop rate of a benchmark, given the bytes moved and the floating
+         * point operations of one iteration; a null count is not reported.
+         */
+        inline void report(benchmark::State& state, std::size_t bytes, std::size_t flops = 0)
+        {
+            if (bytes != 0)
+            {
+                state.counters["bandwidth_fraction"] = benchmark::Counter(static_cast<double>(bytes) / memory_bandwidth(),
+                                                                          benchmark::Counter::kIsIterationInvariantRate);
+                state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bytes));
+            }
+            if (flops != 0)
+            {
+                state.counters["flop_fraction"] = benchmark::Counter(static_cast<double>(flops) / flop_rate(),
+                                                                     benchmark::Counter::kIsIterationInvariantRate);
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,405 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef BENCHMARK_SORT_HPP
+#define BENCHMARK_SORT_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "xtensor/xhistogram.hpp"
+#include "xtensor/xsort.hpp"
+#include "xtensor/xtensor.hpp"
+
+namespace xt
+{
+    namespace sort_bench
+    {
+
+        /****************************
+         * Benchmark initialization *
+         ****************************/
+
+        // state.range(1) selects the distribution of the values
+        enum distribution
+        {
+            random_values = 0,
+            sorted_values = 1,
+            few_unique_values = 2
+        };
+
+        inline const char* distribution_label(int d)
+        {
+            return d == sorted_values ? "sorted" : d == few_unique_values ? "few unique" : "random";
+        }
+
+        template <class V>
+        inline void init_sort_data(V& v, int d)
+        {
+            using T = typename V::value_type;
+            std::mt19937 engine(42);
+            std::uniform_int_distribution<int> dist(0, d == few_unique_values ? 15 : 1 << 30);
+            for (auto& el : v.storage())
+            {
+                el = static_cast<T>(dist(engine)) / static_cast<T>(d == few_unique_values ? 1 : 7);
+            }
+            if (d == sorted_values)
+            {
+                std::sort(v.storage().begin(), v.storage().end());
+            }
+        }
+
+        inline void sort_args(benchmark::internal::Benchmark* b)
+        {
+            for (int size : {1 << 10, 1 << 16, 1 << 20})
+            {
+                for (int d : {random_values, sorted_values, few_unique_values})
+                {
+                    b->Args({size, d});
+                }
+            }
+        }
+
+        template <class T>
+        inline xtensor<T, 1> make_sort_data(benchmark::State& state)
+        {
+            xtensor<T, 1> data({static_cast<std::size_t>(state.range(0))});
+            init_sort_data(data, static_cast<int>(state.range(1)));
+            state.SetLabel(distribution_label(static_cast<int>(state.range(1))));
+            return data;
+        }
+
+        /********
+         * sort *
+         ********/
+
+        template <class T>
+        inline void sort_xsort(benchmark::State& state)
+        {
+            auto data = make_sort_data<T>(state);
+            for (auto _ : state)
+            {
+                auto res = xt::sort(data);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        template <class T>
+        inline void sort_xsort_radix(benchmark::State& state)
+        {
+            auto data = make_sort_data<T>(state);
+            for (auto _ : state)
+            {
+                auto res = xt::sort(data, -1, sorting_method::radix());
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        template <class T>
+        inline void sort_std_sort(benchmark::State& state)
+        {
+            auto data = make_sort_data<T>(state);
+            for (auto _ : state)
+            {
+                std::vector<T> res(data.cbegin(), data.cend());
+                std::sort(res.begin(), res.end());
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        // lanes of a 2D tensor, state.range(1) being the sorted axis
+        template <class T>
+        inline void sort_xsort_axis(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            xtensor<T, 2> data({n, n});
+            init_sort_data(data, random_values);
+            std::ptrdiff_t axis = static_cast<std::ptrdiff_t>(state.range(1));
+            for (auto _ : state)
+            {
+                auto res = xt::sort(data, axis);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+        }
+
+        // same lanes, sorted in the buffer of the tensor
+        template <class T>
+        inline void sort_inplace_axis(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            xtensor<T, 2> data({n, n});
+            init_sort_data(data, random_values);
+            xtensor<T, 2> work = data;
+            std::ptrdiff_t axis = static_cast<std::ptrdiff_t>(state.range(1));
+            for (auto _ : state)
+            {
+                state.PauseTiming();
+                std::copy(data.cbegin(), data.cend(), work.begin());
+                state.ResumeTiming();
+                xt::sort_inplace(work, axis);
+                benchmark::DoNotOptimize(work.data());
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+        }
+
+        // many lanes of a few elements, sorted by sorting networks
+        template <class T>
+        inline void sort_small_lanes(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            xtensor<T, 2> data({std::size_t(1) << 16, n});
+            init_sort_data(data, random_values);
+            for (auto _ : state)
+            {
+                auto res = xt::sort(data, 1);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+        }
+
+        template <class T>
+        inline void sort_small_lanes_std_sort(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            xtensor<T, 2> data({std::size_t(1) << 16, n});
+            init_sort_data(data, random_values);
+            for (auto _ : state)
+            {
+                xtensor<T, 2> res = data;
+                for (auto it = res.begin(); it != res.end(); it += std::ptrdiff_t(n))
+                {
+                    std::sort(it, it + std::ptrdiff_t(n));
+                }
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+        }
+
+        /***********
+         * argsort *
+         ***********/
+
+        template <class T>
+        inline void argsort_xsort(benchmark::State& state)
+        {
+            auto data = make_sort_data<T>(state);
+            for (auto _ : state)
+            {
+                auto res = xt::argsort(data);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        template <class T>
+        inline void argsort_std_sort(benchmark::State& state)
+        {
+            auto data = make_sort_data<T>(state);
+            for (auto _ : state)
+            {
+                std::vector<std::size_t> res(data.size());
+                std::iota(res.begin(), res.end(), std::size_t(0));
+                std::sort(res.begin(), res.end(), [&data](std::size_t i, std::size_t j) { return data(i) < data(j); });
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        /**********
+         * unique *
+         **********/
+
+        template <class T>
+        inline void unique_xsort(benchmark::State& state)
+        {
+            auto data = make_sort_data<T>(state);
+            for (auto _ : state)
+            {
+                auto res = xt::unique(data);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        template <class T>
+        inline void unique_xsort_hash(benchmark::State& state)
+        {
+            auto data = make_sort_data<T>(state);
+            for (auto _ : state)
+            {
+                auto res = xt::unique(data, unique_method::hash());
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        template <class T>
+        inline void unique_std_unique(benchmark::State& state)
+        {
+            auto data = make_sort_data<T>(state);
+            for (auto _ : state)
+            {
+                std::vector<T> res(data.cbegin(), data.cend());
+                std::sort(res.begin(), res.end());
+                res.erase(std::unique(res.begin(), res.end()), res.end());
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        /****************
+         * searchsorted *
+         ****************/
+
+        // as many values as sorted elements, state.range(1) being the
+        // distribution of the values
+        template <class T>
+        inline void searchsorted_xsort(benchmark::State& state)
+        {
+            auto values = make_sort_data<T>(state);
+            xtensor<T, 1> sorted = values;
+            std::sort(sorted.begin(), sorted.end());
+            for (auto _ : state)
+            {
+                auto res = xt::searchsorted(sorted, values);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        template <class T>
+        inline void searchsorted_std_lower_bound(benchmark::State& state)
+        {
+            auto values = make_sort_data<T>(state);
+            xtensor<T, 1> sorted = values;
+            std::sort(sorted.begin(), sorted.end());
+            for (auto _ : state)
+            {
+                std::vector<std::size_t> res(values.size());
+                for (std::size_t i = 0; i < values.size(); ++i)
+                {
+                    res[i] = static_cast<std::size_t>(std::lower_bound(sorted.cbegin(), sorted.cend(), values(i)) - sorted.cbegin());
+                }
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        /*************
+         * histogram *
+         *************/
+
+        template <class T>
+        inline void histogram_xhistogram(benchmark::State& state)
+        {
+            auto data = make_sort_data<T>(state);
+            for (auto _ : state)
+            {
+                auto res = xt::histogram(data, std::size_t(64));
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        template <class T>
+        inline void histogram_std_loop(benchmark::State& state)
+        {
+            auto data = make_sort_data<T>(state);
+            for (auto _ : state)
+            {
+                auto bounds = std::minmax_element(data.cbegin(), data.cend());
+                double left = static_cast<double>(*bounds.first);
+                double right = static_cast<double>(*bounds.second);
+                double scale = right > left ? 64. / (right - left) : 0.;
+                std::vector<double> res(64, 0.);
+                for (auto v : data)
+                {
+                    std::size_t bin = static_cast<std::size_t>((static_cast<double>(v) - left) * scale);
+                    res[std::min(bin, std::size_t(63))] += 1.;
+                }
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        inline void bincount_xhistogram(benchmark::State& state)
+        {
+            xtensor<int, 1> data = xt::cast<int>(make_sort_data<double>(state)) % 1024;
+            for (auto _ : state)
+            {
+                auto res = xt::bincount(data);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        inline void bincount_std_loop(benchmark::State& state)
+        {
+            xtensor<int, 1> data = xt::cast<int>(make_sort_data<double>(state)) % 1024;
+            for (auto _ : state)
+            {
+                auto right = *std::max_element(data.cbegin(), data.cend());
+                std::vector<int> res(static_cast<std::size_t>(right + 1), 0);
+                for (auto v : data)
+                {
+                    ++res[static_cast<std::size_t>(v)];
+                }
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        BENCHMARK_TEMPLATE(sort_xsort, double)->Apply(sort_args);
+        BENCHMARK_TEMPLATE(sort_xsort, std::int32_t)->Apply(sort_args);
+        BENCHMARK_TEMPLATE(sort_xsort_radix, double)->Apply(sort_args);
+        BENCHMARK_TEMPLATE(sort_xsort_radix, std::int32_t)->Apply(sort_args);
+        BENCHMARK_TEMPLATE(sort_std_sort, double)->Apply(sort_args);
+        BENCHMARK_TEMPLATE(sort_std_sort, std::int32_t)->Apply(sort_args);
+        BENCHMARK_TEMPLATE(sort_xsort_axis, double)->Args({1024, 0})->Args({1024, 1});
+        BENCHMARK_TEMPLATE(sort_xsort_axis, float)->Args({1024, 0})->Args({1024, 1});
+        BENCHMARK_TEMPLATE(sort_inplace_axis, double)->Args({1024, 0})->Args({1024, 1});
+        BENCHMARK_TEMPLATE(sort_inplace_axis, float)->Args({1024, 0})->Args({1024, 1});
+        BENCHMARK_TEMPLATE(sort_small_lanes, float)->Arg(4)->Arg(9)->Arg(16)->Arg(32);
+        BENCHMARK_TEMPLATE(sort_small_lanes, std::int32_t)->Arg(4)->Arg(9)->Arg(16)->Arg(32);
+        BENCHMARK_TEMPLATE(sort_small_lanes_std_sort, float)->Arg(4)->Arg(9)->Arg(16)->Arg(32);
+        BENCHMARK_TEMPLATE(sort_small_lanes_std_sort, std::int32_t)->Arg(4)->Arg(9)->Arg(16)->Arg(32);
+
+        BENCHMARK_TEMPLATE(argsort_xsort, double)->Apply(sort_args);
+        BENCHMARK_TEMPLATE(argsort_xsort, std::int32_t)->Apply(sort_args);
+        BENCHMARK_TEMPLATE(argsort_std_sort, double)->Apply(sort_args);
+        BENCHMARK_TEMPLATE(argsort_std_sort, std::int32_t)->Apply(sort_args);
+
+        BENCHMARK_TEMPLATE(unique_xsort, double)->Apply(sort_args);
+        BENCHMARK_TEMPLATE(unique_xsort, std::int32_t)->Apply(sort_args);
+        BENCHMARK_TEMPLATE(unique_xsort_hash, double)->Apply(sort_args);
+        BENCHMARK_TEMPLATE(unique_xsort_hash, std::int32_t)->Apply(sort_args);
+        BENCHMARK_TEMPLATE(unique_std_unique, double)->Apply(sort_args);
+        BENCHMARK_TEMPLATE(unique_std_unique, std::int32_t)->Apply(sort_args);
+
+        BENCHMARK_TEMPLATE(searchsorted_xsort, double)->Apply(sort_args);
+        BENCHMARK_TEMPLATE(searchsorted_std_lower_bound, double)->Apply(sort_args);
+
+        BENCHMARK_TEMPLATE(histogram_xhistogram, double)->Apply(sort_args);
+        BENCHMARK_TEMPLATE(histogram_xhistogram, float)->Apply(sort_args);
+        BENCHMARK_TEMPLATE(histogram_std_loop, double)->Apply(sort_args);
+        BENCHMARK_TEMPLATE(histogram_std_loop, float)->Apply(sort_args);
+        BENCHMARK(bincount_xhistogram)->Apply(sort_args);
+        BENCHMARK(bincount_std_loop)->Apply(sort_args);
+    }
+}
+
+#endif
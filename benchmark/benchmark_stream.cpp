@@ -0,0 +1,197 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef BENCHMARK_STREAM_HPP
+#define BENCHMARK_STREAM_HPP
+
+#include <cstddef>
+
+#include <benchmark/benchmark.h>
+
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xtensor.hpp"
+
+#include "benchmark_roofline.hpp"
+
+// sizes fitting in the L1 and L2 caches, and much larger than the last level cache
+#define STREAM_RANGE Arg(1 << 10)->Arg(1 << 15)->Arg(1 << 23)
+
+namespace xt
+{
+    namespace stream
+    {
+
+        /****************************
+         * Benchmark initialization *
+         ****************************/
+
+        struct stream_data
+        {
+            explicit stream_data(std::size_t size)
+                : a({size}, 1.), b({size}, 2.), c({size}, 0.5)
+            {
+            }
+
+            xtensor<double, 1> a;
+            xtensor<double, 1> b;
+            xtensor<double, 1> c;
+        };
+
+        constexpr double scalar = 3.;
+
+        /*********************
+         * Raw pointer loops *
+         *********************/
+
+        inline void stream_copy_ref(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            stream_data d(size);
+            for (auto _ : state)
+            {
+                double* c = d.c.data();
+                const double* a = d.a.data();
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    c[i] = a[i];
+                }
+                benchmark::DoNotOptimize(c);
+            }
+            roofline::report(state, 2 * size * sizeof(double));
+        }
+
+        inline void stream_scale_ref(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            stream_data d(size);
+            for (auto _ : state)
+            {
+                double* b = d.b.data();
+                const double* c = d.c.data();
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    b[i] = scalar * c[i];
+                }
+                benchmark::DoNotOptimize(b);
+            }
+            roofline::report(state, 2 * size * sizeof(double), size);
+        }
+
+        inline void stream_add_ref(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            stream_data d(size);
+            for (auto _ : state)
+            {
+                double* c = d.c.data();
+                const double* a = d.a.data();
+                const double* b = d.b.data();
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    c[i] = a[i] + b[i];
+                }
+                benchmark::DoNotOptimize(c);
+            }
+            roofline::report(state, 3 * size * sizeof(double), size);
+        }
+
+        inline void stream_triad_ref(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            stream_data d(size);
+            for (auto _ : state)
+            {
+                double* a = d.a.data();
+                const double* b = d.b.data();
+                const double* c = d.c.data();
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    a[i] = b[i] + scalar * c[i];
+                }
+                benchmark::DoNotOptimize(a);
+            }
+            roofline::report(state, 3 * size * sizeof(double), 2 * size);
+        }
+
+        /*******************
+         * xtensor kernels *
+         *******************/
+
+        inline void stream_copy_xtensor(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            stream_data d(size);
+            for (auto _ : state)
+            {
+                noalias(d.c) = d.a;
+                benchmark::DoNotOptimize(d.c.data());
+            }
+            roofline::report(state, 2 * size * sizeof(double));
+        }
+
+        inline void stream_scale_xtensor(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            stream_data d(size);
+            for (auto _ : state)
+            {
+                noalias(d.b) = scalar * d.c;
+                benchmark::DoNotOptimize(d.b.data());
+            }
+            roofline::report(state, 2 * size * sizeof(double), size);
+        }
+
+        inline void stream_add_xtensor(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            stream_data d(size);
+            for (auto _ : state)
+            {
+                noalias(d.c) = d.a + d.b;
+                benchmark::DoNotOptimize(d.c.data());
+            }
+            roofline::report(state, 3 * size * sizeof(double), size);
+        }
+
+        inline void stream_triad_xtensor(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            stream_data d(size);
+            for (auto _ : state)
+            {
+                noalias(d.a) = d.b + scalar * d.c;
+                benchmark::DoNotOptimize(d.a.data());
+            }
+            roofline::report(state, 3 * size * sizeof(double), 2 * size);
+        }
+
+        inline void stream_inplace_scale_xtensor(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            stream_data d(size);
+            for (auto _ : state)
+            {
+                d.b *= 1.000001;
+                benchmark::DoNotOptimize(d.b.data());
+            }
+            roofline::report(state, 2 * size * sizeof(double), size);
+        }
+
+        BENCHMARK(stream_copy_ref)->STREAM_RANGE;
+        BENCHMARK(stream_copy_xtensor)->STREAM_RANGE;
+        BENCHMARK(stream_scale_ref)->STREAM_RANGE;
+        BENCHMARK(stream_scale_xtensor)->STREAM_RANGE;
+        BENCHMARK(stream_inplace_scale_xtensor)->STREAM_RANGE;
+        BENCHMARK(stream_add_ref)->STREAM_RANGE;
+        BENCHMARK(stream_add_xtensor)->STREAM_RANGE;
+        BENCHMARK(stream_triad_ref)->STREAM_RANGE;
+        BENCHMARK(stream_triad_xtensor)->STREAM_RANGE;
+    }
+}
+
+#endif
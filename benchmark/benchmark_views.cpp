@@ -6,13 +6,20 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <array>
 #include <cstddef>
 #include <chrono>
+#include <numeric>
 #include <string>
+#include <vector>
 
 #include <benchmark/benchmark.h>
 
 #include "xtensor/xarray.hpp"
+#include "xtensor/xbroadcast.hpp"
+#include "xtensor/xdynamic_view.hpp"
+#include "xtensor/xindex_view.hpp"
+#include "xtensor/xmasked_view.hpp"
 #include "xtensor/xnoalias.hpp"
 #include "xtensor/xstrided_view.hpp"
 #include "xtensor/xmanipulation.hpp"
@@ -224,4 +231,374 @@ namespace xt
         BENCHMARK_CAPTURE(transpose_assign_rm_cm, 10x20x500, {10, 20, 500});
         BENCHMARK_CAPTURE(transpose_assign_cm_rm, 10x20x500, {10, 20, 500});
     }
+
+    // Element access and assignment into containers of the views whose
+    // assignment falls back to the stepper, compared with the equivalent
+    // range view and with a raw loop.
+    namespace view_kinds
+    {
+        constexpr std::size_t N = 512;
+
+        struct view_data
+        {
+            view_data()
+                : data(xt::reshape_view(xt::arange<double>(double(N * N)), {N, N})),
+                  row(xt::arange<double>(double(N))),
+                  even(N / 2), dropped(N / 8)
+            {
+                std::iota(even.begin(), even.end(), std::size_t(0));
+                for (auto& i : even)
+                {
+                    i *= 2;
+                }
+                std::iota(dropped.begin(), dropped.end(), std::size_t(0));
+                for (auto& i : dropped)
+                {
+                    i *= 8;
+                }
+            }
+
+            xtensor<double, 2> data;
+            xtensor<double, 1> row;
+            std::vector<std::size_t> even;
+            std::vector<std::size_t> dropped;
+        };
+
+        template <class V>
+        inline void iterate(benchmark::State& state, const V& v)
+        {
+            for (auto _ : state)
+            {
+                double acc = std::accumulate(v.cbegin(), v.cend(), 0.);
+                benchmark::DoNotOptimize(acc);
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(v.size()));
+        }
+
+        template <class R, class V>
+        inline void assign(benchmark::State& state, R& res, const V& v)
+        {
+            for (auto _ : state)
+            {
+                noalias(res) = v;
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(res.size()));
+        }
+
+        /**********************
+         * every other column *
+         **********************/
+
+        inline void even_columns_raw(benchmark::State& state)
+        {
+            view_data d;
+            xtensor<double, 2> res = zeros<double>({N, N / 2});
+            for (auto _ : state)
+            {
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                    for (std::size_t j = 0; j < N / 2; ++j)
+                    {
+                        res(i, j) = d.data(i, 2 * j);
+                    }
+                }
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(res.size()));
+        }
+
+        inline void even_columns_range_iterate(benchmark::State& state)
+        {
+            view_data d;
+            iterate(state, view(d.data, all(), range(0, N, 2)));
+        }
+
+        inline void even_columns_range_assign(benchmark::State& state)
+        {
+            view_data d;
+            xtensor<double, 2> res = zeros<double>({N, N / 2});
+            assign(state, res, view(d.data, all(), range(0, N, 2)));
+        }
+
+        inline void even_columns_keep_iterate(benchmark::State& state)
+        {
+            view_data d;
+            iterate(state, view(d.data, all(), keep(d.even)));
+        }
+
+        inline void even_columns_keep_assign(benchmark::State& state)
+        {
+            view_data d;
+            xtensor<double, 2> res = zeros<double>({N, N / 2});
+            assign(state, res, view(d.data, all(), keep(d.even)));
+        }
+
+        inline void even_columns_dynamic_view_iterate(benchmark::State& state)
+        {
+            view_data d;
+            iterate(state, dynamic_view(d.data, xdynamic_slice_vector{all(), range(0, int(N), 2)}));
+        }
+
+        inline void even_columns_dynamic_view_assign(benchmark::State& state)
+        {
+            view_data d;
+            xtensor<double, 2> res = zeros<double>({N, N / 2});
+            assign(state, res, dynamic_view(d.data, xdynamic_slice_vector{all(), range(0, int(N), 2)}));
+        }
+
+        inline void even_columns_strided_view_iterate(benchmark::State& state)
+        {
+            view_data d;
+            iterate(state, strided_view(d.data, xstrided_slice_vector{all(), range(0, int(N), 2)}));
+        }
+
+        inline void even_columns_strided_view_assign(benchmark::State& state)
+        {
+            view_data d;
+            xtensor<double, 2> res = zeros<double>({N, N / 2});
+            assign(state, res, strided_view(d.data, xstrided_slice_vector{all(), range(0, int(N), 2)}));
+        }
+
+        /****************************
+         * drop of one row out of 8 *
+         ****************************/
+
+        inline void drop_rows_iterate(benchmark::State& state)
+        {
+            view_data d;
+            iterate(state, view(d.data, drop(d.dropped), all()));
+        }
+
+        inline void drop_rows_assign(benchmark::State& state)
+        {
+            view_data d;
+            xtensor<double, 2> res = zeros<double>({N - N / 8, N});
+            assign(state, res, view(d.data, drop(d.dropped), all()));
+        }
+
+        /**************************************
+         * index_view, filter and masked_view *
+         **************************************/
+
+        inline void index_view_iterate(benchmark::State& state)
+        {
+            view_data d;
+            std::vector<xindex> indices;
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                indices.push_back({i, (i * 7) % N});
+            }
+            iterate(state, index_view(d.data, indices));
+        }
+
+        inline void index_view_assign(benchmark::State& state)
+        {
+            view_data d;
+            std::vector<xindex> indices;
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                indices.push_back({i, (i * 7) % N});
+            }
+            xtensor<double, 1> res = zeros<double>({N});
+            assign(state, res, index_view(d.data, indices));
+        }
+
+        inline void filter_iterate(benchmark::State& state)
+        {
+            view_data d;
+            for (auto _ : state)
+            {
+                auto v = filter(d.data, d.data > double(N * N / 2));
+                double acc = std::accumulate(v.cbegin(), v.cend(), 0.);
+                benchmark::DoNotOptimize(acc);
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(d.data.size()));
+        }
+
+        inline void filter_assign(benchmark::State& state)
+        {
+            view_data d;
+            xtensor<double, 1> res = zeros<double>({N * N / 2 - 1});
+            for (auto _ : state)
+            {
+                noalias(res) = filter(d.data, d.data > double(N * N / 2));
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(d.data.size()));
+        }
+
+        inline void masked_view_iterate(benchmark::State& state)
+        {
+            view_data d;
+            xtensor<bool, 2> mask = d.data > double(N * N / 2);
+            auto v = masked_view(d.data, mask);
+            for (auto _ : state)
+            {
+                double acc = 0.;
+                for (auto it = v.cbegin(); it != v.cend(); ++it)
+                {
+                    auto val = *it;
+                    if (val.visible())
+                    {
+                        acc += val.value();
+                    }
+                }
+                benchmark::DoNotOptimize(acc);
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(d.data.size()));
+        }
+
+        inline void masked_view_assign(benchmark::State& state)
+        {
+            view_data d;
+            xtensor<bool, 2> mask = d.data > double(N * N / 2);
+            xtensor<double, 2> res = d.data;
+            auto v = masked_view(res, mask);
+            for (auto _ : state)
+            {
+                v = d.data;
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(d.data.size()));
+        }
+
+        /*******************
+         * broadcast views *
+         *******************/
+
+        inline void broadcast_row_raw(benchmark::State& state)
+        {
+            view_data d;
+            xtensor<double, 2> res = zeros<double>({N, N});
+            for (auto _ : state)
+            {
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                    for (std::size_t j = 0; j < N; ++j)
+                    {
+                        res(i, j) = d.data(i, j) + d.row(j);
+                    }
+                }
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(res.size()));
+        }
+
+        inline void broadcast_row_assign(benchmark::State& state)
+        {
+            view_data d;
+            xtensor<double, 2> res = zeros<double>({N, N});
+            assign(state, res, d.data + d.row);
+        }
+
+        inline void broadcast_column_assign(benchmark::State& state)
+        {
+            view_data d;
+            xtensor<double, 2> res = zeros<double>({N, N});
+            assign(state, res, d.data + view(d.row, all(), newaxis()));
+        }
+
+        inline void broadcast_view_iterate(benchmark::State& state)
+        {
+            view_data d;
+            iterate(state, broadcast(d.row, std::array<std::size_t, 2>{N, N}));
+        }
+
+        inline void broadcast_view_assign(benchmark::State& state)
+        {
+            view_data d;
+            xtensor<double, 2> res = zeros<double>({N, N});
+            assign(state, res, broadcast(d.row, std::array<std::size_t, 2>{N, N}));
+        }
+
+        BENCHMARK(even_columns_raw);
+        BENCHMARK(even_columns_range_iterate);
+        BENCHMARK(even_columns_range_assign);
+        BENCHMARK(even_columns_keep_iterate);
+        BENCHMARK(even_columns_keep_assign);
+        BENCHMARK(even_columns_dynamic_view_iterate);
+        BENCHMARK(even_columns_dynamic_view_assign);
+        BENCHMARK(even_columns_strided_view_iterate);
+        BENCHMARK(even_columns_strided_view_assign);
+        BENCHMARK(drop_rows_iterate);
+        BENCHMARK(drop_rows_assign);
+        BENCHMARK(index_view_iterate);
+        BENCHMARK(index_view_assign);
+        BENCHMARK(filter_iterate);
+        BENCHMARK(filter_assign);
+        BENCHMARK(masked_view_iterate);
+        BENCHMARK(masked_view_assign);
+        BENCHMARK(broadcast_row_raw);
+        BENCHMARK(broadcast_row_assign);
+        BENCHMARK(broadcast_column_assign);
+        BENCHMARK(broadcast_view_iterate);
+        BENCHMARK(broadcast_view_assign);
+    }
+
+    // Assignments of views of an array which does not fit in the caches,
+    // whose outer strides or indices jump over pages. Build with
+    // -DXTENSOR_PREFETCH_DISTANCE=0 to measure them without software
+    // prefetching.
+    namespace view_prefetch
+    {
+        constexpr std::size_t N = 2048;
+
+        inline const xtensor<double, 2>& large_data()
+        {
+            static const xtensor<double, 2> data = xt::reshape_view(xt::arange<double>(double(N * N)), {N, N});
+            return data;
+        }
+
+        // short rows of a view with a large outer stride (strided loop)
+        inline void prefetch_strided_rows_assign(benchmark::State& state)
+        {
+            const auto& data = large_data();
+            auto v = view(data, range(0, N, 4), range(0, 16));
+            xtensor<double, 2> res = zeros<double>({N / 4, std::size_t(16)});
+            for (auto _ : state)
+            {
+                noalias(res) = v;
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(res.size()));
+        }
+
+        // runs of the stepper assigner along the columns
+        inline void prefetch_transposed_assign(benchmark::State& state)
+        {
+            const auto& data = large_data();
+            xtensor<double, 2> res = zeros<double>({N, N});
+            for (auto _ : state)
+            {
+                noalias(res) = transpose(data);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(res.size()));
+        }
+
+        // scattered indices of an index view
+        inline void prefetch_index_view_assign(benchmark::State& state)
+        {
+            const auto& data = large_data();
+            std::vector<std::array<std::size_t, 2>> indices;
+            indices.reserve(N * 16);
+            for (std::size_t i = 0; i < N * 16; ++i)
+            {
+                indices.push_back({(i * 7919) % N, (i * 104729) % N});
+            }
+            auto v = index_view(data, indices);
+            xtensor<double, 1> res = zeros<double>({indices.size()});
+            for (auto _ : state)
+            {
+                noalias(res) = v;
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(res.size()));
+        }
+
+        BENCHMARK(prefetch_strided_rows_assign);
+        BENCHMARK(prefetch_transposed_assign);
+        BENCHMARK(prefetch_index_view_assign);
+    }
 }
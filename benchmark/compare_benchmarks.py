@@ -0,0 +1,178 @@
+#!/usr/bin/env python3
+############################################################################
+# Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    #
+#                                                                          #
+# Distributed under the terms of the BSD 3-Clause License.                 #
+#                                                                          #
+# The full license is in the file LICENSE, distributed with this software. #
+############################################################################
+
+"""Records the results of the xtensor benchmarks per commit and compares
+them with a baseline.
+
+    compare_benchmarks.py record --binary ./benchmark_xtensor --history dir
+    compare_benchmarks.py compare --history dir --baseline <commit> [--contender <commit>]
+    compare_benchmarks.py compare baseline.json contender.json
+
+The benchmarks are run with repetitions, and a benchmark is reported as
+a regression (or an improvement) when the change of its median time is
+larger than the threshold and the Mann-Whitney U test between the two sets
+of repetitions is significant, so that the noise of the runs is not taken
+for a change. The exit status is 1 when a regression is found.
+"""
+
+import argparse
+import json
+import math
+import os
+import statistics
+import subprocess
+import sys
+
+
+def git_revision(short=True):
+    args = ['git', 'rev-parse'] + (['--short'] if short else []) + ['HEAD']
+    try:
+        return subprocess.check_output(args, universal_newlines=True).strip()
+    except (OSError, subprocess.CalledProcessError):
+        return 'unknown'
+
+
+def history_file(history, revision):
+    return os.path.join(history, revision + '.json')
+
+
+def record(args):
+    os.makedirs(args.history, exist_ok=True)
+    revision = args.revision or git_revision()
+    out = history_file(args.history, revision)
+    command = [args.binary,
+               '--benchmark_repetitions=%d' % args.repetitions,
+               '--benchmark_out=' + out,
+               '--benchmark_out_format=json']
+    if args.filter:
+        command.append('--benchmark_filter=' + args.filter)
+    subprocess.check_call(command)
+    print('results of %s written to %s' % (revision, out))
+    return out
+
+
+def load_runs(filename):
+    """Returns the times of the repetitions of each benchmark, by name."""
+    with open(filename) as f:
+        data = json.load(f)
+    runs = {}
+    for b in data.get('benchmarks', []):
+        # the aggregates (mean, median, stddev) are recomputed from the repetitions
+        if b.get('run_type', 'iteration') != 'iteration':
+            continue
+        name = b.get('run_name', b['name'])
+        runs.setdefault(name, []).append(float(b['real_time']))
+    return runs
+
+
+def mann_whitney_pvalue(x, y):
+    """Two-sided p-value of the Mann-Whitney U test, from the normal
+    approximation with tie correction."""
+    n1, n2 = len(x), len(y)
+    if n1 == 0 or n2 == 0:
+        return 1.
+    values = sorted([(v, 0) for v in x] + [(v, 1) for v in y])
+    ranks = [0.] * len(values)
+    ties = 0.
+    i = 0
+    while i < len(values):
+        j = i
+        while j + 1 < len(values) and values[j + 1][0] == values[i][0]:
+            j += 1
+        for k in range(i, j + 1):
+            ranks[k] = (i + j) / 2. + 1.
+        t = j - i + 1
+        ties += t ** 3 - t
+        i = j + 1
+    r1 = sum(r for r, (_, s) in zip(ranks, values) if s == 0)
+    u = r1 - n1 * (n1 + 1) / 2.
+    n = n1 + n2
+    mu = n1 * n2 / 2.
+    sigma2 = n1 * n2 / 12. * ((n + 1) - ties / (n * (n - 1)))
+    if sigma2 <= 0.:
+        return 1.
+    z = (abs(u - mu) - 0.5) / math.sqrt(sigma2)
+    return math.erfc(max(z, 0.) / math.sqrt(2.))
+
+
+def compare(args):
+    if args.files:
+        if len(args.files) != 2:
+            sys.exit('compare expects a baseline and a contender file')
+        baseline_file, contender_file = args.files
+    else:
+        if not args.history or not args.baseline:
+            sys.exit('compare expects two files, or --history and --baseline')
+        baseline_file = history_file(args.history, args.baseline)
+        contender_file = history_file(args.history, args.contender or git_revision())
+
+    baseline = load_runs(baseline_file)
+    contender = load_runs(contender_file)
+
+    regressions = 0
+    rows = []
+    for name in sorted(set(baseline) & set(contender)):
+        old, new = baseline[name], contender[name]
+        old_median, new_median = statistics.median(old), statistics.median(new)
+        change = (new_median - old_median) / old_median if old_median else 0.
+        pvalue = mann_whitney_pvalue(old, new)
+        significant = pvalue < args.alpha and abs(change) > args.threshold
+        status = ''
+        if significant:
+            status = 'REGRESSION' if change > 0 else 'improvement'
+            regressions += change > 0
+        if significant or args.all:
+            rows.append((name, old_median, new_median, change, pvalue, status))
+
+    if rows:
+        width = max(len(r[0]) for r in rows)
+        print('%-*s %14s %14s %9s %8s' % (width, 'benchmark', 'baseline', 'contender', 'change', 'p-value'))
+        for name, old_median, new_median, change, pvalue, status in rows:
+            print('%-*s %14.1f %14.1f %+8.1f%% %8.4f %s'
+                  % (width, name, old_median, new_median, 100. * change, pvalue, status))
+    missing = sorted(set(baseline) ^ set(contender))
+    if missing:
+        print('%d benchmarks are only in one of the results' % len(missing))
+    print('%d regressions beyond the threshold of %.1f%% (alpha = %g)'
+          % (regressions, 100. * args.threshold, args.alpha))
+    return 1 if regressions else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest='command')
+
+    rec = sub.add_parser('record', help='run the benchmarks and store their results for the current commit')
+    rec.add_argument('--binary', required=True, help='benchmark executable')
+    rec.add_argument('--history', required=True, help='directory of the results, one json file per commit')
+    rec.add_argument('--revision', help='name of the results (defaults to the current commit)')
+    rec.add_argument('--repetitions', type=int, default=10, help='repetitions of each benchmark')
+    rec.add_argument('--filter', help='regular expression selecting the benchmarks')
+
+    cmp = sub.add_parser('compare', help='compare the results of a contender with a baseline')
+    cmp.add_argument('files', nargs='*', help='baseline and contender json files')
+    cmp.add_argument('--history', help='directory of the results, one json file per commit')
+    cmp.add_argument('--baseline', help='commit of the baseline results')
+    cmp.add_argument('--contender', help='commit of the contender results (defaults to the current commit)')
+    cmp.add_argument('--threshold', type=float, default=0.05, help='relative change of the median ignored as noise')
+    cmp.add_argument('--alpha', type=float, default=0.05, help='significance level of the Mann-Whitney U test')
+    cmp.add_argument('--all', action='store_true', help='print all the benchmarks, not only the changes')
+
+    args = parser.parse_args()
+    if args.command == 'record':
+        record(args)
+        return 0
+    if args.command == 'compare':
+        return compare(args)
+    parser.print_help()
+    return 2
+
+
+if __name__ == '__main__':
+    sys.exit(main())
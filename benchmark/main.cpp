@@ -13,6 +13,10 @@
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xarray.hpp"
 
+#if defined(XTENSOR_BENCHMARK_ALLOCATIONS)
+#include "benchmark_allocations.hpp"
+#endif
+
 #ifdef XTENSOR_USE_XSIMD
 #ifdef __GNUC__
 template <class T>
@@ -41,7 +45,14 @@ void print_stats()
 int main(int argc, char** argv)
 {
     print_stats();
+#if defined(XTENSOR_BENCHMARK_ALLOCATIONS)
+    bool json_output = xt::alloc_bench::has_json_output(argc, argv);
+#endif
     benchmark::Initialize(&argc, argv);
     if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+#if defined(XTENSOR_BENCHMARK_ALLOCATIONS)
+    xt::alloc_bench::run_with_allocation_counters(json_output);
+#else
     benchmark::RunSpecifiedBenchmarks();
+#endif
 }
@@ -10,13 +10,18 @@
 #define XTENSOR_ACCUMULATOR_HPP
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
 #include <numeric>
 #include <type_traits>
+#include <vector>
 
 #include "xexpression.hpp"
+#include "xparallel.hpp"
+#include "xreducer.hpp"
 #include "xstrides.hpp"
 #include "xtensor_forward.hpp"
+#include "xtensor_simd.hpp"
 
 namespace xt
 {
@@ -183,48 +188,230 @@ namespace xt
             }
         }
 
-        template <class F, class E>
-        inline auto accumulator_impl(F&& f, E&& e, std::size_t axis, evaluation_strategy::immediate)
+        // Inclusive scan of the n contiguous elements of a lane whose
+        // first element has already been initialized.
+        template <class T, class F>
+        inline void scan_contiguous_serial(T* data, std::size_t n, F& f)
         {
-            using accumulate_functor = std::decay_t<decltype(std::get<0>(f))>;
-            using function_return_type = typename accumulate_functor::result_type;
-            using result_type = xaccumulator_return_type_t<std::decay_t<E>, function_return_type>;
+            for (std::size_t i = 1; i < n; ++i)
+            {
+                data[i] = f(data[i - 1], data[i]);
+            }
+        }
 
-            if (axis >= e.dimension())
+        // Accumulating functions whose lanes may be scanned by blocks: they
+        // are associative, and stateless, so that they can be called from
+        // several threads at once. Any other function, such as a moving
+        // average, is scanned serially.
+        template <class F>
+        struct is_associative_accumulator : std::false_type
+        {
+        };
+
+        template <class T>
+        struct is_associative_accumulator<std::plus<T>> : std::is_arithmetic<T>
+        {
+        };
+
+        template <class T>
+        struct is_associative_accumulator<std::multiplies<T>> : std::is_arithmetic<T>
+        {
+        };
+
+        // Work-efficient parallel scan: blocks of the lane are scanned concurrently,
+        // then the prefix of the preceding blocks is applied to each block. The
+        // number of blocks does not depend on the number of threads.
+        template <class T, class F>
+        inline void scan_contiguous(T* data, std::size_t n, F& f, std::true_type /*associative*/)
+        {
+#if defined(XTENSOR_PARALLEL_ENABLED)
+            constexpr std::size_t max_blocks = 64;
+            if (parallel::use_parallel(n) && n >= 2 * max_blocks)
             {
-                throw std::runtime_error("Axis larger than expression dimension in accumulator.");
+                std::size_t block_size = std::max((n + max_blocks - 1) / max_blocks, parallel::grain(1));
+                std::size_t nblocks = (n + block_size - 1) / block_size;
+                if (nblocks > 1)
+                {
+                    parallel_for(std::size_t(0), nblocks, std::size_t(1), [&](std::size_t b_first, std::size_t b_last)
+                    {
+                        for (std::size_t b = b_first; b < b_last; ++b)
+                        {
+                            std::size_t offset = b * block_size;
+                            scan_contiguous_serial(data + offset, (std::min)(block_size, n - offset), f);
+                        }
+                    });
+
+                    // prefix[b] accumulates the blocks preceding block b
+                    std::vector<T> prefix(nblocks);
+                    prefix[1] = data[block_size - 1];
+                    for (std::size_t b = 2; b < nblocks; ++b)
+                    {
+                        prefix[b] = f(prefix[b - 1], data[b * block_size - 1]);
+                    }
+
+                    parallel_for(std::size_t(1), nblocks, std::size_t(1), [&](std::size_t b_first, std::size_t b_last)
+                    {
+                        for (std::size_t b = b_first; b < b_last; ++b)
+                        {
+                            T* block = data + b * block_size;
+                            std::size_t size = (std::min)(block_size, n - b * block_size);
+                            const T p = prefix[b];
+                            for (std::size_t i = 0; i < size; ++i)
+                            {
+                                block[i] = f(p, block[i]);
+                            }
+                        }
+                    });
+                    return;
+                }
             }
+#endif
+            scan_contiguous_serial(data, n, f);
+        }
 
-            result_type result = e;  // assign + make a copy, we need it anyways
+        template <class T, class F>
+        inline void scan_contiguous(T* data, std::size_t n, F& f, std::false_type /*associative*/)
+        {
+            scan_contiguous_serial(data, n, f);
+        }
+
+        template <class T, class F>
+        inline void scan_contiguous(T* data, std::size_t n, F& f)
+        {
+            scan_contiguous(data, n, f, is_associative_accumulator<std::decay_t<F>>());
+        }
 
-            std::size_t inner_stride = static_cast<std::size_t>(result.strides()[axis]);
-            std::size_t outer_stride = 1;  // this is either going row- or column-wise (strides.back / strides.front)
-            std::size_t outer_loop_size = 0;
-            std::size_t inner_loop_size = 0;
+        // Accumulates the n elements of row into the ones of next
+        template <class T, class F>
+        inline void accumulate_row(const T* row, T* next, std::size_t n, F& f, std::false_type /*simd*/)
+        {
+            for (std::size_t c = 0; c < n; ++c)
+            {
+                next[c] = f(row[c], next[c]);
+            }
+        }
 
-            auto set_loop_sizes = [&outer_loop_size, &inner_loop_size](auto first, auto last, std::ptrdiff_t ax) {
-                outer_loop_size = std::accumulate(first,
-                                                  first + ax,
-                                                  std::size_t(1), std::multiplies<std::size_t>());
+#ifdef XTENSOR_USE_XSIMD
+        template <class T, class F>
+        inline void accumulate_row(const T* row, T* next, std::size_t n, F& f, std::true_type /*simd*/)
+        {
+            using batch_type = xsimd::simd_type<T>;
+            using simd_reduce_type = simd_reduce<std::decay_t<F>, batch_type>;
+            constexpr std::size_t simd_size = batch_type::size;
+            std::size_t simd_end = n - n % simd_size;
+            for (std::size_t c = 0; c < simd_end; c += simd_size)
+            {
+                batch_type acc = simd_reduce_type::apply(f, xsimd::load_simd<T, T>(row + c, xsimd::unaligned_mode()),
+                                                         xsimd::load_simd<T, T>(next + c, xsimd::unaligned_mode()));
+                acc.store_unaligned(next + c);
+            }
+            accumulate_row(row + simd_end, next + simd_end, n - simd_end, f, std::false_type());
+        }
 
-                inner_loop_size = std::accumulate(first + ax,
-                                                  last,
-                                                  std::size_t(1), std::multiplies<std::size_t>());
-            };
+        template <class T, class F>
+        struct use_simd_accumulate
+        {
+            using batch_type = xsimd::simd_type<T>;
+            static constexpr bool value = xsimd::simd_traits<T>::size > 1 &&
+                                          std::is_same<std::decay_t<decltype(std::declval<F&>()(std::declval<T>(), std::declval<T>()))>,
+                                                       T>::value &&
+                                          simd_reduce<std::decay_t<F>, batch_type>::value;
+        };
+#else
+        template <class T, class F>
+        struct use_simd_accumulate
+        {
+            static constexpr bool value = false;
+        };
+#endif
+
+        // Number of columns accumulated down all the rows of a block before
+        // moving to the next columns: the previous row of the tile stays in
+        // the L1 cache while the next one is streamed.
+        template <class T>
+        constexpr std::size_t accumulate_tile_size() noexcept
+        {
+            return XTENSOR_L1_CACHE_SIZE / (2 * sizeof(T)) == 0 ? std::size_t(1)
+                                                                : XTENSOR_L1_CACHE_SIZE / (2 * sizeof(T));
+        }
 
-            if (result_type::static_layout == layout_type::row_major)
+        // Accumulates n_blocks contiguous blocks of n_axis rows of row_size
+        // elements, each row being accumulated into the next one.
+        template <class T, class F>
+        inline void accumulate_rows(T* data, std::size_t n_blocks, std::size_t n_axis, std::size_t row_size, F& f)
+        {
+            if (n_axis < 2)
             {
-                set_loop_sizes(result.shape().cbegin(), result.shape().cend(), static_cast<std::ptrdiff_t>(axis));
+                return;
             }
-            else
+
+            // few long contiguous lanes are scanned in parallel one after the other
+            if (row_size == 1 && n_axis >= 64 * n_blocks)
             {
-                set_loop_sizes(result.shape().cbegin(), result.shape().cend(), static_cast<std::ptrdiff_t>(axis + 1));
-                std::swap(inner_loop_size, outer_loop_size);
+                for (std::size_t b = 0; b < n_blocks; ++b)
+                {
+                    scan_contiguous(data + b * n_axis, n_axis, f);
+                }
+                return;
             }
 
-            std::size_t pos = 0;
+            // otherwise lanes are independent, [first, last) indexes the
+            // columns of all the blocks; the columns are processed by tiles,
+            // each row of a tile being accumulated into the next one
+            using use_simd = std::integral_constant<bool, use_simd_accumulate<T, F>::value>;
+            constexpr std::size_t tile_size = accumulate_tile_size<T>();
+            auto accumulate_columns = [&](std::size_t first, std::size_t last, F& fn)
+            {
+                while (first < last)
+                {
+                    std::size_t b = first / row_size;
+                    std::size_t c_first = first - b * row_size;
+                    std::size_t c_last = (std::min)(row_size, c_first + (last - first));
+                    T* block = data + b * n_axis * row_size;
+                    for (std::size_t t = c_first; t < c_last; t += tile_size)
+                    {
+                        std::size_t width = (std::min)(tile_size, c_last - t);
+                        T* row = block + t;
+                        for (std::size_t k = 1; k < n_axis; ++k, row += row_size)
+                        {
+                            accumulate_row(row, row + row_size, width, fn, use_simd());
+                        }
+                    }
+                    first += c_last - c_first;
+                }
+            };
+
+            std::size_t n_columns = n_blocks * row_size;
+#if defined(XTENSOR_PARALLEL_ENABLED)
+            if (parallel::use_parallel(n_columns * n_axis))
+            {
+                // each chunk accumulates with its own copy of the function
+                parallel_for(std::size_t(0), n_columns, parallel::grain(n_axis), [&](std::size_t first, std::size_t last)
+                {
+                    F fn = f;
+                    accumulate_columns(first, last, fn);
+                });
+                return;
+            }
+#endif
+            accumulate_columns(std::size_t(0), n_columns, f);
+        }
 
-            inner_loop_size = inner_loop_size - inner_stride;
+        // Accumulates in place the container result along axis
+        template <class F, class R>
+        inline void accumulate_inplace(F&& f, R& result, std::size_t axis)
+        {
+            // the result is made of n_blocks contiguous blocks of n_axis rows along axis,
+            // rows of row_size elements are accumulated into each other
+            auto first = result.shape().cbegin();
+            auto last = result.shape().cend();
+            std::ptrdiff_t ax = static_cast<std::ptrdiff_t>(axis);
+            std::size_t n_axis = result.shape()[axis];
+            std::size_t before = std::accumulate(first, first + ax, std::size_t(1), std::multiplies<std::size_t>());
+            std::size_t after = std::accumulate(first + ax + 1, last, std::size_t(1), std::multiplies<std::size_t>());
+            bool row_major = result.layout() == layout_type::row_major;
+            std::size_t n_blocks = row_major ? before : after;
+            std::size_t row_size = row_major ? after : before;
 
             // activate the init loop if we have an init function other than identity
             if (!std::is_same<decltype(std::get<1>(f)), xtl::identity>::value)
@@ -232,17 +419,35 @@ namespace xt
                 accumulator_init_with_f(std::get<1>(f), result, axis);
             }
 
-            pos = 0;
-            for (std::size_t i = 0; i < outer_loop_size; ++i)
+            auto accumulate_fct = std::get<0>(f);
+            accumulate_rows(result.data(), n_blocks, n_axis, row_size, accumulate_fct);
+        }
+
+        // Accumulates in place the size elements of the contiguous storage of result
+        // which have been copied from the expression, except the first one, which
+        // is initialized from first.
+        template <class F, class R, class V>
+        inline void accumulate_flat_inplace(F&& f, R& result, const V& first)
+        {
+            result.storage()[0] = std::get<1>(f)(first);
+            auto accumulate_fct = std::get<0>(f);
+            scan_contiguous(result.data(), result.size(), accumulate_fct);
+        }
+
+        template <class F, class E>
+        inline auto accumulator_impl(F&& f, E&& e, std::size_t axis, evaluation_strategy::immediate)
+        {
+            using accumulate_functor = std::decay_t<decltype(std::get<0>(f))>;
+            using function_return_type = typename accumulate_functor::result_type;
+            using result_type = xaccumulator_return_type_t<std::decay_t<E>, function_return_type>;
+
+            if (axis >= e.dimension())
             {
-                for (std::size_t j = 0; j < inner_loop_size; ++j)
-                {
-                    result.storage()[pos + inner_stride] = std::get<0>(f)(result.storage()[pos],
-                                                                          result.storage()[pos + inner_stride]);
-                    pos += outer_stride;
-                }
-                pos += inner_stride;
+                throw std::runtime_error("Axis larger than expression dimension in accumulator.");
             }
+
+            result_type result = e;  // assign + make a copy, we need it anyways
+            accumulate_inplace(std::forward<F>(f), result, axis);
             return result;
         }
 
@@ -256,16 +461,15 @@ namespace xt
             std::size_t sz = e.size();
             auto result = result_type::from_shape({sz});
 
-            auto it = e.template begin<XTENSOR_DEFAULT_LAYOUT>();
-
-            result.storage()[0] = std::get<1>(f)(*it);
-            ++it;
-
-            for (std::size_t idx = 0; it != e.template end<XTENSOR_DEFAULT_LAYOUT>(); ++it)
+            if (sz == 0)
             {
-                result.storage()[idx + 1] = std::get<0>(f)(result.storage()[idx], *it);
-                ++idx;
+                return result;
             }
+
+            auto it = e.template begin<XTENSOR_DEFAULT_LAYOUT>();
+            auto first = *it;
+            std::copy(++it, e.template end<XTENSOR_DEFAULT_LAYOUT>(), result.storage().begin() + 1);
+            accumulate_flat_inplace(std::forward<F>(f), result, first);
             return result;
         }
     }
@@ -306,6 +510,69 @@ namespace xt
         std::size_t ax = normalize_axis(e.dimension(), axis);
         return detail::accumulator_impl(std::forward<F>(f), std::forward<E>(e), ax, evaluation_strategy);
     }
+
+    /**
+     * Accumulate and flatten into an existing container
+     * **NOTE** This function is not lazy!
+     *
+     * The container is resized to hold the e.size() accumulated values if
+     * needed, the values are written directly into its storage, without
+     * allocating an intermediate result.
+     *
+     * @param out the container receiving the accumulated values
+     * @param f functor to use for accumulation
+     * @param e xexpression to be accumulated
+     *
+     * @return a reference to out
+     */
+    template <class R, class F, class E>
+    inline R& accumulate_into(xexpression<R>& out, F&& f, E&& e)
+    {
+        R& res = out.derived_cast();
+        std::size_t sz = e.size();
+        using shape_type = std::array<std::size_t, 1>;
+        res.resize(shape_type{sz});
+        if (sz != 0)
+        {
+            auto it = e.template begin<XTENSOR_DEFAULT_LAYOUT>();
+            auto first = *it;
+            std::copy(++it, e.template end<XTENSOR_DEFAULT_LAYOUT>(), res.storage().begin() + 1);
+            detail::accumulate_flat_inplace(std::forward<F>(f), res, first);
+        }
+        return res;
+    }
+
+    /**
+     * Accumulate over axis into an existing container
+     * **NOTE** This function is not lazy!
+     *
+     * The container is resized to the shape of \c e if needed, the values are
+     * assigned to it and accumulated in place, without allocating an
+     * intermediate result. \c e may be \c out itself.
+     *
+     * @param out the container receiving the accumulated values
+     * @param f Functor to use for accumulation
+     * @param e xexpression to accumulate
+     * @param axis Axis to perform accumulation over
+     *
+     * @return a reference to out
+     */
+    template <class R, class F, class E>
+    inline R& accumulate_into(xexpression<R>& out, F&& f, E&& e, std::ptrdiff_t axis)
+    {
+        R& res = out.derived_cast();
+        std::size_t ax = normalize_axis(e.dimension(), axis);
+        if (ax >= e.dimension())
+        {
+            throw std::runtime_error("Axis larger than expression dimension in accumulator.");
+        }
+        if (static_cast<const void*>(&res) != static_cast<const void*>(&e))
+        {
+            res.assign(std::forward<E>(e));
+        }
+        detail::accumulate_inplace(std::forward<F>(f), res, ax);
+        return res;
+    }
 }
 
 #endif
@@ -44,6 +44,18 @@ namespace xt
 
         template <class P>
         using default_allocator_for_ptr_t = typename default_allocator_for_ptr<P>::type;
+
+        template <class B, class P, class O, class A>
+        inline B make_xbuffer_adaptor(P&& pointer, typename A::size_type size, const O&, const A& alloc)
+        {
+            return B(std::forward<P>(pointer), size, alloc);
+        }
+
+        template <class B, class P, class A>
+        inline B make_xbuffer_adaptor(P&& pointer, typename A::size_type size, const external_ownership& ownership, const A& alloc)
+        {
+            return B(std::forward<P>(pointer), size, ownership, alloc);
+        }
     }
 
     /**************************
@@ -93,7 +105,8 @@ namespace xt
      * @param pointer the pointer to the beginning of the dynamic array
      * @param size the size of the dynamic array
      * @param ownership indicates whether the adaptor takes ownership of the array.
-     *        Possible values are ``no_ownerhsip()`` or ``acquire_ownership()``
+     *        Possible values are ``no_ownership()``, ``acquire_ownership()``,
+     *        ``shared_ownership()`` or an ``external_ownership``
      * @param shape the shape of the xarray_adaptor
      * @param l the layout_type of the xarray_adaptor
      * @param alloc the allocator used for allocating / deallocating the dynamic array
@@ -109,7 +122,8 @@ namespace xt
      * @param pointer the pointer to the beginning of the dynamic array
      * @param size the size of the dynamic array
      * @param ownership indicates whether the adaptor takes ownership of the array.
-     *        Possible values are ``no_ownerhsip()`` or ``acquire_ownership()``
+     *        Possible values are ``no_ownership()``, ``acquire_ownership()``,
+     *        ``shared_ownership()`` or an ``external_ownership``
      * @param shape the shape of the xarray_adaptor
      * @param strides the strides of the xarray_adaptor
      * @param alloc the allocator used for allocating / deallocating the dynamic array
@@ -177,7 +191,8 @@ namespace xt
      * @param pointer the pointer to the beginning of the dynamic array
      * @param size the size of the dynamic array
      * @param ownership indicates whether the adaptor takes ownership of the array.
-     *        Possible values are ``no_ownerhsip()`` or ``acquire_ownership()``
+     *        Possible values are ``no_ownership()``, ``acquire_ownership()``,
+     *        ``shared_ownership()`` or an ``external_ownership``
      * @param l the layout_type of the xtensor_adaptor
      * @param alloc the allocator used for allocating / deallocating the dynamic array
      */
@@ -191,7 +206,8 @@ namespace xt
      * @param pointer the pointer to the beginning of the dynamic array
      * @param size the size of the dynamic array
      * @param ownership indicates whether the adaptor takes ownership of the array.
-     *        Possible values are ``no_ownerhsip()`` or ``acquire_ownership()``
+     *        Possible values are ``no_ownership()``, ``acquire_ownership()``,
+     *        ``shared_ownership()`` or an ``external_ownership``
      * @param shape the shape of the xtensor_adaptor
      * @param l the layout_type of the xtensor_adaptor
      * @param alloc the allocator used for allocating / deallocating the dynamic array
@@ -207,7 +223,8 @@ namespace xt
      * @param pointer the pointer to the beginning of the dynamic array
      * @param size the size of the dynamic array
      * @param ownership indicates whether the adaptor takes ownership of the array.
-     *        Possible values are ``no_ownerhsip()`` or ``acquire_ownership()``
+     *        Possible values are ``no_ownership()``, ``acquire_ownership()``,
+     *        ``shared_ownership()`` or an ``external_ownership``
      * @param shape the shape of the xtensor_adaptor
      * @param strides the strides of the xtensor_adaptor
      * @param alloc the allocator used for allocating / deallocating the dynamic array
@@ -272,11 +289,11 @@ namespace xt
     template <layout_type L, class P, class O, class SC, class A,
               typename std::enable_if_t<!detail::is_array<std::decay_t<SC>>::value, int>>
     inline xarray_adaptor<xbuffer_adaptor<xtl::closure_type_t<P>, O, A>, L, SC>
-    adapt(P&& pointer, typename A::size_type size, O, const SC& shape, layout_type l, const A& alloc)
+    adapt(P&& pointer, typename A::size_type size, O ownership, const SC& shape, layout_type l, const A& alloc)
     {
         using buffer_type = xbuffer_adaptor<xtl::closure_type_t<P>, O, A>;
         using return_type = xarray_adaptor<buffer_type, L, SC>;
-        buffer_type buf(std::forward<P>(pointer), size, alloc);
+        buffer_type buf = detail::make_xbuffer_adaptor<buffer_type>(std::forward<P>(pointer), size, ownership, alloc);
         return return_type(std::move(buf), shape, l);
     }
 
@@ -285,11 +302,11 @@ namespace xt
               typename std::enable_if_t<!detail::is_array<std::decay_t<SC>>::value, int>,
               typename std::enable_if_t<!std::is_same<layout_type, std::decay_t<SS>>::value, int>>
     inline xarray_adaptor<xbuffer_adaptor<xtl::closure_type_t<P>, O, A>, layout_type::dynamic, std::decay_t<SC>>
-    adapt(P&& pointer, typename A::size_type size, O, SC&& shape, SS&& strides, const A& alloc)
+    adapt(P&& pointer, typename A::size_type size, O ownership, SC&& shape, SS&& strides, const A& alloc)
     {
         using buffer_type = xbuffer_adaptor<xtl::closure_type_t<P>, O, A>;
         using return_type = xarray_adaptor<buffer_type, layout_type::dynamic, std::decay_t<SC>>;
-        buffer_type buf(std::forward<P>(pointer), size, alloc);
+        buffer_type buf = detail::make_xbuffer_adaptor<buffer_type>(std::forward<P>(pointer), size, ownership, alloc);
         return return_type(std::move(buf),
                            xtl::forward_sequence<typename return_type::inner_shape_type>(shape),
                            xtl::forward_sequence<typename return_type::inner_strides_type>(strides));
@@ -374,11 +391,11 @@ namespace xt
     // 1-D case - buffer version
     template <layout_type L, class P, class O, class A>
     inline xtensor_adaptor<xbuffer_adaptor<xtl::closure_type_t<P>, O, A>, 1, L>
-    adapt(P&& pointer, typename A::size_type size, O, layout_type l, const A& alloc)
+    adapt(P&& pointer, typename A::size_type size, O ownership, layout_type l, const A& alloc)
     {
         using buffer_type = xbuffer_adaptor<xtl::closure_type_t<P>, O, A>;
         using return_type = xtensor_adaptor<buffer_type, 1, L>;
-        buffer_type buf(std::forward<P>(pointer), size, alloc);
+        buffer_type buf = detail::make_xbuffer_adaptor<buffer_type>(std::forward<P>(pointer), size, ownership, alloc);
         const std::array<typename A::size_type, 1> shape{size};
         return return_type(std::move(buf), shape, l);
     }
@@ -387,12 +404,12 @@ namespace xt
     template <layout_type L, class P, class O, class SC, class A,
               typename std::enable_if_t<detail::is_array<std::decay_t<SC>>::value, int>>
     inline xtensor_adaptor<xbuffer_adaptor<xtl::closure_type_t<P>, O, A>, detail::array_size<SC>::value, L>
-    adapt(P&& pointer, typename A::size_type size, O, const SC& shape, layout_type l, const A& alloc)
+    adapt(P&& pointer, typename A::size_type size, O ownership, const SC& shape, layout_type l, const A& alloc)
     {
         using buffer_type = xbuffer_adaptor<xtl::closure_type_t<P>, O, A>;
         constexpr std::size_t N = detail::array_size<SC>::value;
         using return_type = xtensor_adaptor<buffer_type, N, L>;
-        buffer_type buf(std::forward<P>(pointer), size, alloc);
+        buffer_type buf = detail::make_xbuffer_adaptor<buffer_type>(std::forward<P>(pointer), size, ownership, alloc);
         return return_type(std::move(buf), shape, l);
     }
 
@@ -401,12 +418,12 @@ namespace xt
               typename std::enable_if_t<detail::is_array<std::decay_t<SC>>::value, int>,
               typename std::enable_if_t<!std::is_same<layout_type, std::decay_t<SS>>::value, int>>
     inline xtensor_adaptor<xbuffer_adaptor<xtl::closure_type_t<P>, O, A>, detail::array_size<SC>::value, layout_type::dynamic>
-    adapt(P&& pointer, typename A::size_type size, O, SC&& shape, SS&& strides, const A& alloc)
+    adapt(P&& pointer, typename A::size_type size, O ownership, SC&& shape, SS&& strides, const A& alloc)
     {
         using buffer_type = xbuffer_adaptor<xtl::closure_type_t<P>, O, A>;
         constexpr std::size_t N = detail::array_size<SC>::value;
         using return_type = xtensor_adaptor<buffer_type, N, layout_type::dynamic>;
-        buffer_type buf(std::forward<P>(pointer), size, alloc);
+        buffer_type buf = detail::make_xbuffer_adaptor<buffer_type>(std::forward<P>(pointer), size, ownership, alloc);
         return return_type(std::move(buf),
                            xtl::forward_sequence<typename return_type::inner_shape_type>(shape),
                            xtl::forward_sequence<typename return_type::inner_strides_type>(strides));
@@ -10,25 +10,52 @@
 #define XTENSOR_ASSIGN_HPP
 
 #include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <cstdint>
+#include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <xtl/xsequence.hpp>
 
 #include "xconcepts.hpp"
+#include "xdispatch.hpp"
 #include "xexpression.hpp"
 #include "xiterator.hpp"
 #include "xstrides.hpp"
 #include "xtensor_forward.hpp"
 #include "xutils.hpp"
 #include "xfunction.hpp"
-
-#if defined(XTENSOR_USE_TBB)
-#include <tbb/tbb.h>
-#endif
+#include "xhalf.hpp"
+#include "xinstrument.hpp"
+#include "xparallel.hpp"
 
 namespace xt
 {
+    template <class CT, class X>
+    class xbroadcast;
+
+    template <class F, class CT>
+    class xfunctor_view;
+
+    template <class F, class CT, class X>
+    class xreducer;
+
+    namespace detail
+    {
+        template <class E>
+        struct is_xreducer : std::false_type
+        {
+        };
+
+        template <class F, class CT, class X>
+        struct is_xreducer<xreducer<F, CT, X>> : std::true_type
+        {
+        };
+    }
 
     /********************
      * Assign functions *
@@ -55,6 +82,50 @@ namespace xt
     template <class E1, class E2>
     void strided_assign(E1& e1, const E2& e2, std::true_type /*enable*/);
 
+    template <class... E1, class... E2>
+    void assign_all(std::tuple<E1&...> e1, const xexpression<E2>&... e2);
+
+    /****************
+     * xassign_plan *
+     ****************/
+
+    /**
+     * @class xassign_plan
+     * @brief Assignment decisions computed once and reused for expressions
+     * of the same types.
+     *
+     * Assigning an expression checks its broadcasting and whether it can be
+     * assigned linearly, which can outweigh the computation for small
+     * tensors. A plan records these decisions for a pair of expressions, and
+     * can assign any later pair of the same types with the same shapes and
+     * strides without checking them again; the shapes are only checked when
+     * XTENSOR_ENABLE_ASSERT is defined. The left-hand side is not resized by
+     * run.
+     *
+     * @tparam E1 the type of the expression to assign to
+     * @tparam E2 the type of the assigned expression
+     */
+    template <class E1, class E2>
+    class xassign_plan
+    {
+    public:
+
+        xassign_plan(E1& e1, const E2& e2);
+
+        void run(E1& e1, const E2& e2) const;
+
+        bool trivial_broadcast() const noexcept;
+        bool linear_assign() const noexcept;
+
+    private:
+
+        bool m_trivial;
+        bool m_linear;
+    };
+
+    template <class E1, class E2>
+    xassign_plan<E1, E2> make_assign_plan(xexpression<E1>& e1, const xexpression<E2>& e2);
+
     /************************
      * xexpression_assigner *
      ************************/
@@ -69,6 +140,9 @@ namespace xt
 
         template <class E1, class E2>
         static void assign_data(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial);
+
+        template <class E1, class E2>
+        static void assign_data(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial, bool linear_assign);
     };
 
     template <class Tag>
@@ -128,6 +202,10 @@ namespace xt
 
     private:
 
+        void run_n(size_type n);
+        void run_n(size_type n, std::false_type /*load_run*/);
+        void run_n(size_type n, std::true_type /*load_run*/);
+
         E1& m_e1;
 
         lhs_iterator m_lhs;
@@ -179,667 +257,3242 @@ namespace xt
         static void run(E1& e1, const E2& e2);
     };
 
-    /***********************************
-     * Assign functions implementation *
-     ***********************************/
+    /*********************
+     * unrolled_assigner *
+     *********************/
 
-    template <class E1, class E2>
-    inline void assign_data(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial)
+    // Assigns expressions of small fixed shapes with a loop unrolled at
+    // compile time
+    template <bool enable>
+    class unrolled_assigner
     {
-        using tag = xexpression_tag_t<E1, E2>;
-        xexpression_assigner<tag>::assign_data(e1, e2, trivial);
-    }
+    public:
 
-    template <class E1, class E2>
-    inline void assign_xexpression(xexpression<E1>& e1, const xexpression<E2>& e2)
+        template <class E1, class E2>
+        static bool run(E1& e1, const E2& e2);
+    };
+
+    /**********************
+     * transpose_assigner *
+     **********************/
+
+    // Copies expressions whose unit strides are on different dimensions
+    // (e.g. transposed or rotated views) tile by tile, and expressions
+    // reversed along the unit stride dimension (e.g. flipped views) line by
+    // line
+    template <bool enable>
+    class transpose_assigner
     {
-        xtl::mpl::static_if<has_assign_to<E1, E2>::value>([&](auto self)
+    public:
+
+        template <class E1, class E2>
+        static bool run(E1& e1, const E2& e2);
+    };
+
+    /***********************
+     * loop_order_assigner *
+     ***********************/
+
+    // Assigns expressions whose operands have conflicting layouts (e.g. a
+    // column major operand to a row major container) in the loop order
+    // minimizing the strides of all the operands, tile by tile when the
+    // operands do not agree on the inner dimension
+    template <bool enable>
+    class loop_order_assigner
+    {
+    public:
+
+        template <class E1, class E2>
+        static bool run(E1& e1, const E2& e2);
+    };
+
+    /****************
+     * run_assigner *
+     ****************/
+
+    // Assigns views with a keep or drop slice run by run, each run of
+    // contiguous indices being a strided sub-assignment (see xview.hpp)
+    template <class E1, class E2, class Enable = void>
+    class run_assigner
+    {
+    public:
+
+        static bool run(E1& /*e1*/, const E2& /*e2*/)
         {
-            self(e2).derived_cast().assign_to(e1);
-        }, /*else*/ [&](auto /*self*/)
+            return false;
+        }
+    };
+
+    /**********************
+     * replicate_assigner *
+     **********************/
+
+    // Assigns expressions broadcast along the leading dimensions of a row
+    // major buffer (e.g. a row broadcast to a matrix) by computing the block
+    // of the trailing dimensions once and copying it to the other blocks
+    template <class E1, class E2, class Enable = void>
+    class replicate_assigner
+    {
+    public:
+
+        static bool run(E1& /*e1*/, const E2& /*e2*/)
         {
-            using tag = xexpression_tag_t<E1, E2>;
-            xexpression_assigner<tag>::assign_xexpression(e1, e2);
-        });
-    }
+            return false;
+        }
+    };
 
     template <class E1, class E2>
-    inline void computed_assign(xexpression<E1>& e1, const xexpression<E2>& e2)
+    class replicate_assigner<E1, E2, std::enable_if_t<has_data_interface<E1>::value && has_strides<E1>::value &&
+                                                      E1::contiguous_layout>>
     {
-        using tag = xexpression_tag_t<E1, E2>;
-        xexpression_assigner<tag>::computed_assign(e1, e2);
-    }
+    public:
 
-    template <class E1, class E2, class F>
-    inline void scalar_computed_assign(xexpression<E1>& e1, const E2& e2, F&& f)
-    {
-        using tag = xexpression_tag_t<E1, E2>;
-        xexpression_assigner<tag>::scalar_computed_assign(e1, e2, std::forward<F>(f));
-    }
+        static bool run(E1& e1, const E2& e2);
+    };
 
-    template <class E1, class E2>
-    inline void assert_compatible_shape(const xexpression<E1>& e1, const xexpression<E2>& e2)
+    /*************************
+     * reducer_view_assigner *
+     *************************/
+
+    // Assigns views of lazy reducers by reducing the corresponding region
+    // of the reduced expression at once (see xreducer.hpp)
+    template <class E1, class E2, class Enable = void>
+    class reducer_view_assigner
     {
-        using tag = xexpression_tag_t<E1, E2>;
-        xexpression_assigner<tag>::assert_compatible_shape(e1, e2);
-    }
+    public:
 
-    /***************************************
-     * xexpression_assigner implementation *
-     ***************************************/
+        static bool run(E1& /*e1*/, const E2& /*e2*/)
+        {
+            return false;
+        }
+    };
+
+    /***********************
+     * conversion_assigner *
+     ***********************/
+
+    template <class E1, class E2>
+    struct xassign_traits;
 
     namespace detail
     {
-        template <class E1, class E2>
-        constexpr bool linear_static_layout()
+        template <class R>
+        struct cast;
+
+        template <class D, class S>
+        struct element_converter
         {
-            // A row_major or column_major container with a dimension <= 1 is computed as
-            // layout any, leading to some performance improvements, for example when
-            // assigning a col-major vector to a row-major vector etc
-            return compute_layout(select_layout<E1::static_layout, typename E1::shape_type>::value,
-                                  select_layout<E2::static_layout, typename E2::shape_type>::value) != layout_type::dynamic;
+            D operator()(const S& s) const noexcept
+            {
+                return element_conversion<D, S>::apply(s);
+            }
+        };
+
+        // vectorized conversions between float and the 16 bit floating point types
+        template <class D, class S>
+        inline bool convert_half(const S*, D*, std::size_t) noexcept
+        {
+            return false;
         }
 
-        template <class E1, class E2>
-        inline bool is_linear_assign(const E1& e1, const E2& e2)
+        inline bool convert_half(const float16* src, float* dst, std::size_t n) noexcept
         {
-            return (E1::contiguous_layout && E2::contiguous_layout && linear_static_layout<E1, E2>()) ||
-                   (e1.layout() != layout_type::dynamic && e2.has_linear_assign(e1.strides()));
+            half_to_float(src, dst, n);
+            return true;
+        }
+
+        inline bool convert_half(const float* src, float16* dst, std::size_t n) noexcept
+        {
+            float_to_half(src, dst, n);
+            return true;
+        }
+
+        inline bool convert_half(const bfloat16* src, float* dst, std::size_t n) noexcept
+        {
+            half_to_float(src, dst, n);
+            return true;
+        }
+
+        inline bool convert_half(const float* src, bfloat16* dst, std::size_t n) noexcept
+        {
+            float_to_half(src, dst, n);
+            return true;
+        }
+
+        template <class D, class S>
+        inline void convert_contiguous(const S* src, D* dst, std::size_t n) noexcept
+        {
+            if (convert_half(src, dst, n) || dispatch::transform(element_converter<D, S>(), src, dst, n))
+            {
+                return;
+            }
+            // a plain loop over raw pointers that the compiler vectorizes
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                dst[i] = element_conversion<D, S>::apply(src[i]);
+            }
         }
 
         template <class E, class = void>
-        struct has_step_leading : std::false_type
+        struct conversion_source
         {
+            static constexpr bool value = false;
         };
 
         template <class E>
-        struct has_step_leading<E, void_t<decltype(std::declval<E>().step_leading())>>
-            : std::true_type
+        using data_value_type_t = std::decay_t<decltype(*std::declval<const E&>().data())>;
+
+        template <class E>
+        struct conversion_source<E, std::enable_if_t<has_data_interface<E>::value && E::contiguous_layout &&
+                                                      std::is_same<data_value_type_t<E>, typename E::value_type>::value>>
         {
+            static constexpr bool value = true;
+            using value_type = typename E::value_type;
+
+            static const value_type* data(const E& e) noexcept
+            {
+                return e.data() + e.data_offset();
+            }
         };
 
-        template <class T>
-        struct use_strided_loop
+        template <class F, class = void>
+        struct is_cast_functor : std::false_type
         {
-            static constexpr bool stepper_deref() { return std::is_reference<typename T::stepper::reference>::value; }
-            static constexpr bool value = has_strides<T>::value && has_step_leading<typename T::stepper>::value && stepper_deref();
         };
 
-        template <class T>
-        struct use_strided_loop<xscalar<T>>
+        template <class F>
+        struct is_cast_functor<F, void_t<typename cast<typename F::result_type>::functor>>
+            : std::is_same<F, typename cast<typename F::result_type>::functor>
+        {
+        };
+
+        // xt::cast of a contiguous expression reads the buffer of its argument
+        template <class F, class CT>
+        struct conversion_source<xfunction<F, CT>, std::enable_if_t<is_cast_functor<F>::value &&
+                                                                    conversion_source<std::decay_t<CT>>::value>>
         {
             static constexpr bool value = true;
+            using value_type = typename conversion_source<std::decay_t<CT>>::value_type;
+
+            static const value_type* data(const xfunction<F, CT>& e) noexcept
+            {
+                return conversion_source<std::decay_t<CT>>::data(std::get<0>(e.arguments()));
+            }
         };
 
-        template <class F, class... CT>
-        struct use_strided_loop<xfunction<F, CT...>>
+        template <class T>
+        using is_conversion_arithmetic = std::integral_constant<bool, (std::is_arithmetic<T>::value &&
+                                                                       !std::is_same<T, bool>::value) ||
+                                                                      is_half_float<T>::value>;
+
+        template <class E1, class E2>
+        struct use_conversion_assign
         {
-            using simd_arg_type = typename xfunction<F, CT...>::simd_argument_type;
-            static constexpr bool value = xtl::conjunction<use_strided_loop<std::decay_t<CT>>...>::value &&
-                                          xfunction<F, CT...>::has_simd_interface::value;
+            using source = conversion_source<E2>;
+            using destination = conversion_source<E1>;
+
+            template <class S, class D>
+            static constexpr bool types()
+            {
+                // a cast to a third type cannot be skipped, and the simd
+                // assignment already converts batches except for the
+                // saturating conversions
+                return is_conversion_arithmetic<S>::value && is_conversion_arithmetic<D>::value &&
+                       !std::is_same<S, D>::value &&
+                       (std::is_same<typename E2::value_type, S>::value ||
+                        std::is_same<typename E2::value_type, D>::value) &&
+                       (!xassign_traits<E1, E2>::simd_assign() || is_saturating_conversion<D, S>::value);
+            }
+
+            template <class V = source>
+            static constexpr std::enable_if_t<V::value && destination::value, bool> get(int)
+            {
+                return types<typename V::value_type, typename E1::value_type>();
+            }
+
+            static constexpr bool get(...)
+            {
+                return false;
+            }
+
+            static constexpr bool value()
+            {
+                return get(0);
+            }
         };
     }
 
-    template <class E1, class E2>
-    struct xassign_traits
-    {
-        // constexpr methods instead of constexpr data members avoid the need of difinitions at namespace
-        // scope of these data members (since they are odr-used).
-        static constexpr bool contiguous_layout() { return E1::contiguous_layout && E2::contiguous_layout; }
-        static constexpr bool convertible_types() { return std::is_convertible<typename E2::value_type, typename E1::value_type>::value; }
-        static constexpr bool lhs_simd_size() { return xsimd::simd_traits<typename E1::value_type>::size > 1; }
-        static constexpr bool rhs_simd_size() { return xsimd::simd_traits<typename E2::value_type>::size > 1; }
-        static constexpr bool simd_size() { return lhs_simd_size() && rhs_simd_size(); }
-        static constexpr bool forbid_simd() { return !has_simd_interface<E2>::value; }
-        static constexpr bool simd_assign() { return contiguous_layout() && convertible_types() && simd_size() && has_simd_interface<E2>::value; }
-        static constexpr bool simd_strided_loop() { return convertible_types() && simd_size() &&
-                                                           detail::use_strided_loop<E2>::value &&
-                                                           detail::use_strided_loop<E1>::value; }
-    };
-
-    template <class E1, class E2>
-    inline void xexpression_assigner_base<xtensor_expression_tag>::assign_data(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial)
+    // Assigns between contiguous buffers of different arithmetic types, or
+    // from xt::cast of a contiguous expression, with a loop converting
+    // between raw pointers instead of per element steppers
+    template <class E1, class E2, class Enable = void>
+    class conversion_assigner
     {
-        E1& de1 = e1.derived_cast();
-        const E2& de2 = e2.derived_cast();
+    public:
 
-        bool linear_assign = trivial && detail::is_linear_assign(de1, de2);
-        constexpr bool simd_assign = xassign_traits<E1, E2>::simd_assign();
-        constexpr bool strided_simd_assign = xassign_traits<E1, E2>::simd_strided_loop();
-        if (linear_assign)
-        {
-            linear_assigner<simd_assign>::run(de1, de2);
-        }
-        else if (strided_simd_assign)
-        {
-            strided_loop_assigner<strided_simd_assign>::run(de1, de2);
-        }
-        else
+        static bool run(E1& /*e1*/, const E2& /*e2*/)
         {
-            stepper_assigner<E1, E2, default_assignable_layout(E1::static_layout)> assigner(de1, de2);
-            assigner.run();
+            return false;
         }
-    }
-
-    template <class Tag>
-    template <class E1, class E2>
-    inline void xexpression_assigner<Tag>::assign_xexpression(E1& e1, const E2& e2)
-    {
-        bool trivial_broadcast = resize(e1.derived_cast(), e2.derived_cast());
-        base_type::assign_data(e1, e2, trivial_broadcast);
-    }
+    };
 
-    template <class Tag>
     template <class E1, class E2>
-    inline void xexpression_assigner<Tag>::computed_assign(xexpression<E1>& e1, const xexpression<E2>& e2)
+    class conversion_assigner<E1, E2, std::enable_if_t<detail::use_conversion_assign<E1, E2>::value()>>
     {
-        using shape_type = typename E1::shape_type;
-        using size_type = typename E1::size_type;
+    public:
 
-        E1& de1 = e1.derived_cast();
-        const E2& de2 = e2.derived_cast();
+        static bool run(E1& e1, const E2& e2);
+    };
 
-        size_type dim = de2.dimension();
-        shape_type shape = xtl::make_sequence<shape_type>(dim, size_type(0));
-        bool trivial_broadcast = de2.broadcast_shape(shape, true);
+    /*******************
+     * bitset_assigner *
+     *******************/
 
-        if (dim > de1.dimension() || shape > de1.shape())
+    namespace detail
+    {
+        template <class S, class = void>
+        struct is_bitset_storage : std::false_type
         {
-            typename E1::temporary_type tmp(shape);
-            base_type::assign_data(tmp, e2, trivial_broadcast);
-            de1.assign_temporary(std::move(tmp));
-        }
-        else
+        };
+
+        // xtl::xdynamic_bitset holds the bit i in the position i % N of its
+        // block i / N, N being the number of bits of a block
+        template <class S>
+        struct is_bitset_storage<S, void_t<typename S::block_type,
+                                           decltype(std::declval<const S&>().block_count()),
+                                           decltype(std::declval<const S&>().data())>>
+            : std::true_type
         {
-            base_type::assign_data(e1, e2, trivial_broadcast);
-        }
-    }
+        };
 
-    template <class Tag>
-    template <class E1, class E2, class F>
-    inline void xexpression_assigner<Tag>::scalar_computed_assign(xexpression<E1>& e1, const E2& e2, F&& f)
-    {
-        E1& d = e1.derived_cast();
-        using size_type = typename E1::size_type;
-        auto dst = d.storage().begin();
-        for (size_type i = d.size(); i > 0; --i)
+        template <class E, class = void>
+        struct bitset_source
         {
-            *dst = f(*dst, e2);
-            ++dst;
+            static constexpr bool value = false;
+        };
+
+        // a container holds each of its elements once in its storage, in the
+        // order of its strides
+        template <class E>
+        struct bitset_source<E, std::enable_if_t<std::is_base_of<xcontainer<E>, E>::value &&
+                                                 is_bitset_storage<std::decay_t<typename E::storage_type>>::value>>
+        {
+            static constexpr bool value = true;
+            using block_type = typename std::decay_t<typename E::storage_type>::block_type;
+
+            static bool packed(const E& e, std::size_t size) noexcept
+            {
+                return static_cast<std::size_t>(e.storage().size()) == size;
+            }
+
+            static block_type block(const E& e, std::size_t i) noexcept
+            {
+                return e.storage().data()[i];
+            }
+        };
+
+        template <class CT>
+        struct bitset_source<xscalar<CT>, std::enable_if_t<std::is_convertible<typename xscalar<CT>::value_type, bool>::value>>
+        {
+            static constexpr bool value = true;
+            using block_type = void;
+
+            static bool packed(const xscalar<CT>& /*e*/, std::size_t /*size*/) noexcept
+            {
+                return true;
+            }
+
+            template <class B>
+            static B block(const xscalar<CT>& e) noexcept
+            {
+                return static_cast<bool>(e()) ? static_cast<B>(~B(0)) : B(0);
+            }
+        };
+
+        template <class E>
+        using is_bitset_container = std::integral_constant<bool, std::is_base_of<xcontainer<E>, E>::value &&
+                                                                 bitset_source<E>::value>;
+
+        // number of set bits of a block
+        template <class B>
+        inline std::size_t popcount(B block) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return sizeof(B) <= sizeof(unsigned int) ? static_cast<std::size_t>(__builtin_popcount(static_cast<unsigned int>(block)))
+                                                     : static_cast<std::size_t>(__builtin_popcountll(static_cast<unsigned long long>(block)));
+#else
+            std::size_t res = 0;
+            for (; block != B(0); block &= static_cast<B>(block - B(1)))
+            {
+                ++res;
+            }
+            return res;
+#endif
+        }
+
+        // position of the lowest set bit of a non-zero block
+        template <class B>
+        inline std::size_t lowest_bit(B block) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<std::size_t>(__builtin_ctzll(static_cast<unsigned long long>(block)));
+#else
+            std::size_t res = 0;
+            for (; (block & B(1)) == B(0); block = static_cast<B>(block >> 1))
+            {
+                ++res;
+            }
+            return res;
+#endif
+        }
+
+        // number of set bits of the blocks holding size bits, whose bits
+        // past the size are cleared
+        template <class B>
+        inline std::size_t count_bits(const B* blocks, std::size_t size) noexcept
+        {
+            constexpr std::size_t block_size = 8 * sizeof(B);
+            std::size_t block_count = (size + block_size - 1) / block_size;
+            std::size_t res = 0;
+            for (std::size_t i = 0; i < block_count; ++i)
+            {
+                res += popcount(blocks[i]);
+            }
+            return res;
+        }
+
+        template <class E1, class E2>
+        struct use_bitset_assign
+        {
+            template <class D = bitset_source<E1>, class S = bitset_source<E2>>
+            static constexpr std::enable_if_t<D::value && S::value, bool> blocks(int)
+            {
+                // scalars fill blocks of any type
+                return !std::is_void<typename D::block_type>::value &&
+                       (std::is_void<typename S::block_type>::value ||
+                        std::is_same<typename D::block_type, typename S::block_type>::value);
+            }
+
+            static constexpr bool blocks(...)
+            {
+                return false;
+            }
+
+            static constexpr bool value()
+            {
+                return blocks(0);
+            }
+        };
+        // boolean expressions, such as comparisons, are packed into the
+        // blocks of bit-packed flags
+        template <class E1, class E2>
+        struct use_bitset_pack
+        {
+            template <class D = bitset_source<E1>, class S = bitset_source<E2>>
+            static constexpr std::enable_if_t<D::value && !S::value, bool> blocks(int)
+            {
+                return !std::is_void<typename D::block_type>::value &&
+                       std::is_convertible<typename E2::value_type, bool>::value;
+            }
+
+            static constexpr bool blocks(...)
+            {
+                return false;
+            }
+
+            static constexpr bool value()
+            {
+                return blocks(0);
+            }
+        };
+    }
+
+    // Assigns bit-packed flags, i.e. containers whose storage is an
+    // xtl::xdynamic_bitset, block by block instead of proxy by proxy
+    template <class E1, class E2, class Enable = void>
+    class bitset_assigner
+    {
+    public:
+
+        static bool run(E1& /*e1*/, const E2& /*e2*/)
+        {
+            return false;
         }
+    };
+
+    template <class E1, class E2>
+    class bitset_assigner<E1, E2, std::enable_if_t<detail::use_bitset_assign<E1, E2>::value()>>
+    {
+    public:
+
+        static bool run(E1& e1, const E2& e2);
+
+    private:
+
+        using block_type = typename detail::bitset_source<E1>::block_type;
+
+        template <class E>
+        static block_type block(const E& e, std::size_t i) noexcept;
+
+        template <class CT>
+        static block_type block(const xscalar<CT>& e, std::size_t i) noexcept;
+    };
+
+    // Packs boolean expressions that can be iterated linearly along the
+    // flags, a block of bits at a time; the test of the elements of a block
+    // has no branch, so that it can be vectorized into mask extractions.
+    template <class E1, class E2>
+    class bitset_assigner<E1, E2, std::enable_if_t<detail::use_bitset_pack<E1, E2>::value()>>
+    {
+    public:
+
+        static bool run(E1& e1, const E2& e2);
+    };
+
+    /***********************************
+     * Assign functions implementation *
+     ***********************************/
+
+    template <class E1, class E2>
+    inline void assign_data(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial)
+    {
+        using tag = xexpression_tag_t<E1, E2>;
+        xexpression_assigner<tag>::assign_data(e1, e2, trivial);
     }
 
-    template <class Tag>
     template <class E1, class E2>
-    inline void xexpression_assigner<Tag>::assert_compatible_shape(const xexpression<E1>& e1, const xexpression<E2>& e2)
+    inline void assign_xexpression(xexpression<E1>& e1, const xexpression<E2>& e2)
     {
-        const E1& de1 = e1.derived_cast();
-        const E2& de2 = e2.derived_cast();
-        if (!broadcastable(de2.shape(), de1.shape()))
+        xtl::mpl::static_if<has_assign_to<E1, E2>::value>([&](auto self)
         {
-            throw_broadcast_error(de2.shape(), de1.shape());
+            self(e2).derived_cast().assign_to(e1);
+        }, /*else*/ [&](auto /*self*/)
+        {
+            using tag = xexpression_tag_t<E1, E2>;
+            xexpression_assigner<tag>::assign_xexpression(e1, e2);
+        });
+    }
+
+    template <class E1, class E2>
+    inline void computed_assign(xexpression<E1>& e1, const xexpression<E2>& e2)
+    {
+        using tag = xexpression_tag_t<E1, E2>;
+        xexpression_assigner<tag>::computed_assign(e1, e2);
+    }
+
+    template <class E1, class E2, class F>
+    inline void scalar_computed_assign(xexpression<E1>& e1, const E2& e2, F&& f)
+    {
+        using tag = xexpression_tag_t<E1, E2>;
+        xexpression_assigner<tag>::scalar_computed_assign(e1, e2, std::forward<F>(f));
+    }
+
+    template <class E1, class E2>
+    inline void assert_compatible_shape(const xexpression<E1>& e1, const xexpression<E2>& e2)
+    {
+        using tag = xexpression_tag_t<E1, E2>;
+        xexpression_assigner<tag>::assert_compatible_shape(e1, e2);
+    }
+
+    /***************************************
+     * xexpression_assigner implementation *
+     ***************************************/
+
+    namespace detail
+    {
+        template <class E1, class E2>
+        constexpr bool linear_static_layout()
+        {
+            // A row_major or column_major container with a dimension <= 1 is computed as
+            // layout any, leading to some performance improvements, for example when
+            // assigning a col-major vector to a row-major vector etc
+            return compute_layout(select_layout<E1::static_layout, typename E1::shape_type>::value,
+                                  select_layout<E2::static_layout, typename E2::shape_type>::value) != layout_type::dynamic;
+        }
+
+        template <class E1, class E2>
+        inline bool is_linear_assign(const E1& e1, const E2& e2)
+        {
+            return (E1::contiguous_layout && E2::contiguous_layout && linear_static_layout<E1, E2>()) ||
+                   (e1.layout() != layout_type::dynamic && e2.has_linear_assign(e1.strides()));
         }
+
+        template <class E, class = void>
+        struct has_step_leading : std::false_type
+        {
+        };
+
+        template <class E>
+        struct has_step_leading<E, void_t<decltype(std::declval<E>().step_leading())>>
+            : std::true_type
+        {
+        };
+
+        template <class T>
+        struct use_strided_loop
+        {
+            static constexpr bool stepper_deref() { return std::is_reference<typename T::stepper::reference>::value; }
+            static constexpr bool value = has_strides<T>::value && has_step_leading<typename T::stepper>::value && stepper_deref();
+        };
+
+        template <class T>
+        struct use_strided_loop<xscalar<T>>
+        {
+            static constexpr bool value = true;
+        };
+
+        template <class F, class... CT>
+        struct use_strided_loop<xfunction<F, CT...>>
+        {
+            using simd_arg_type = typename xfunction<F, CT...>::simd_argument_type;
+            static constexpr bool value = xtl::conjunction<use_strided_loop<std::decay_t<CT>>...>::value &&
+                                          xfunction<F, CT...>::has_simd_interface::value &&
+                                          !xfunction<F, CT...>::simd_meta_getter::linear_simd_only::value;
+        };
+
+        // functor views gather their elements through the stepper of the
+        // underlying expression, whose strides they share
+        template <class F, class CT>
+        struct use_strided_loop<xfunctor_view<F, CT>>
+        {
+            static constexpr bool value = use_strided_loop<std::decay_t<CT>>::value &&
+                                          has_simd_interface<xfunctor_view<F, CT>>::value;
+        };
     }
 
     namespace detail
     {
-        template <bool B, class... CT>
-        struct static_trivial_broadcast;
+        // expressions whose operands all expose their strides, the loop
+        // order of their assignment can be chosen from these strides
+        template <class T>
+        struct has_operand_strides : has_strides<T>
+        {
+        };
 
-        template <class... CT>
-        struct static_trivial_broadcast<true, CT...>
+        template <class T>
+        struct has_operand_strides<xscalar<T>> : std::true_type
+        {
+        };
+
+        template <class F, class... CT>
+        struct has_operand_strides<xfunction<F, CT...>>
+            : xtl::conjunction<has_operand_strides<std::decay_t<CT>>...>
+        {
+        };
+
+        template <class F, class CT>
+        struct has_operand_strides<xfunctor_view<F, CT>>
+            : has_operand_strides<std::decay_t<CT>>
+        {
+        };
+    }
+
+    template <class E1, class E2>
+    struct xassign_traits
+    {
+        // constexpr methods instead of constexpr data members avoid the need of difinitions at namespace
+        // scope of these data members (since they are odr-used).
+        static constexpr bool contiguous_layout() { return E1::contiguous_layout && E2::contiguous_layout; }
+        static constexpr bool convertible_types() { return std::is_convertible<typename E2::value_type, typename E1::value_type>::value; }
+        static constexpr bool lhs_simd_size() { return xsimd::simd_traits<typename E1::value_type>::size > 1; }
+        static constexpr bool rhs_simd_size() { return xsimd::simd_traits<typename E2::value_type>::size > 1; }
+        // batches convert without saturating (see detail::convert_element)
+        static constexpr bool saturating_conversion() { return detail::is_saturating_conversion<typename E1::value_type,
+                                                                                    typename E2::value_type>::value; }
+        static constexpr bool simd_size() { return lhs_simd_size() && rhs_simd_size() && !saturating_conversion(); }
+        static constexpr bool forbid_simd() { return !has_simd_interface<E2>::value; }
+        static constexpr bool simd_assign() { return contiguous_layout() && convertible_types() && simd_size() && has_simd_interface<E2>::value; }
+        // expressions whose layout is only dense at runtime (e.g. views with runtime ranges)
+        static constexpr bool simd_linear_assign() { return convertible_types() && simd_size() &&
+                                                            has_simd_interface<E1>::value && has_simd_interface<E2>::value; }
+        static constexpr std::size_t fixed_size() { return detail::fixed_shape_size<typename E1::shape_type>::value; }
+        static constexpr bool unrolled_assign() { return convertible_types() && fixed_size() != 0 &&
+                                                         fixed_size() <= XTENSOR_FIXED_UNROLL_SIZE &&
+                                                         fixed_size() == detail::fixed_shape_size<typename E2::shape_type>::value; }
+        static constexpr bool transpose_assign() { return convertible_types() &&
+                                                          has_data_interface<E1>::value && has_strides<E1>::value &&
+                                                          has_data_interface<E2>::value && has_strides<E2>::value; }
+        static constexpr bool loop_order_assign() { return convertible_types() && has_strides<E1>::value &&
+                                                           detail::has_operand_strides<E2>::value; }
+        static constexpr bool simd_strided_loop() { return convertible_types() && simd_size() && has_strides<E1>::value &&
+                                                           detail::use_strided_loop<E2>::value &&
+                                                           detail::use_strided_loop<E1>::value; }
+    };
+
+    /***************
+     * assign_plan *
+     ***************/
+
+    /**
+     * Loops that can be selected at compile time to assign an expression.
+     * @sa assign_plan
+     */
+    enum class assign_kind
+    {
+        /// the elements are copied by a loop unrolled over a small fixed shape
+        unrolled,
+        /// the storages are traversed linearly with SIMD batches
+        simd_linear,
+        /// the storages are traversed linearly, element by element
+        linear,
+        /// the inner dimension is traversed with SIMD batches, the others by strides
+        simd_strided,
+        /// the elements are traversed by steppers maintaining a multi-index
+        stepper
+    };
+
+    namespace detail
+    {
+        template <class E1, class E2>
+        constexpr assign_kind select_assign_kind()
+        {
+            using traits = xassign_traits<E1, E2>;
+            return !(traits::contiguous_layout() && linear_static_layout<E1, E2>()) ?
+                       (traits::simd_strided_loop() ? assign_kind::simd_strided : assign_kind::stepper) :
+                   traits::unrolled_assign() ? assign_kind::unrolled :
+                   (traits::simd_assign() || traits::simd_linear_assign()) ? assign_kind::simd_linear : assign_kind::linear;
+        }
+    }
+
+    /**
+     * @class assign_plan
+     * @brief Compile-time description of the assignment of an expression.
+     *
+     * The kind member is the loop selected by the assignment of an
+     * expression of type E2 to an expression of type E1 of the same shape.
+     * Expressions whose layout is only known to be contiguous at runtime,
+     * such as views with ranges, are described by the loop used when they
+     * are not; special cases detected at runtime (conversions, transposed
+     * or mixed layouts, runs of slices) are not reported.
+     *
+     * @tparam E1 the type of the expression to assign to
+     * @tparam E2 the type of the assigned expression
+     */
+    template <class E1, class E2>
+    struct assign_plan
+    {
+        static constexpr assign_kind kind = detail::select_assign_kind<std::decay_t<E1>, std::decay_t<E2>>();
+
+        static constexpr bool simd() { return kind == assign_kind::simd_linear || kind == assign_kind::simd_strided; }
+    };
+
+    template <class E1, class E2>
+    constexpr assign_kind assign_plan<E1, E2>::kind;
+
+    /**
+     * Fails to compile if the assignment of \c e2 to \c e1 does not use one
+     * of the SIMD loops. This locks the fast path of an expression in tests.
+     * @sa assign_plan
+     */
+    template <class E1, class E2>
+    inline void require_simd_assign(const xexpression<E1>&, const xexpression<E2>&) noexcept
+    {
+        static_assert(assign_plan<E1, E2>::simd(), "the assignment does not use a SIMD loop");
+    }
+
+    template <class E1, class E2>
+    inline void xexpression_assigner_base<xtensor_expression_tag>::assign_data(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial)
+    {
+        bool linear_assign = trivial && detail::is_linear_assign(e1.derived_cast(), e2.derived_cast());
+        assign_data(e1, e2, trivial, linear_assign);
+    }
+
+    template <class E1, class E2>
+    inline void xexpression_assigner_base<xtensor_expression_tag>::assign_data(xexpression<E1>& e1, const xexpression<E2>& e2,
+                                                                                bool trivial, bool linear_assign)
+    {
+        E1& de1 = e1.derived_cast();
+        const E2& de2 = e2.derived_cast();
+        XTENSOR_INSTRUMENT_SCOPE(detail::is_xreducer<E2>::value ? instrument::event_kind::reducer_assign
+                                                                : instrument::event_kind::assign,
+                                 de1, E2, instrument::assign_bytes(de1, de2));
+
+        constexpr bool simd_assign = xassign_traits<E1, E2>::simd_assign() ||
+                                     xassign_traits<E1, E2>::simd_linear_assign();
+        constexpr bool strided_simd_assign = xassign_traits<E1, E2>::simd_strided_loop();
+        if (linear_assign)
+        {
+            if (!unrolled_assigner<xassign_traits<E1, E2>::unrolled_assign()>::run(de1, de2) &&
+                !conversion_assigner<E1, E2>::run(de1, de2) &&
+                !bitset_assigner<E1, E2>::run(de1, de2))
+            {
+                linear_assigner<simd_assign>::run(de1, de2);
+            }
+        }
+        else if (replicate_assigner<E1, E2>::run(de1, de2))
+        {
+            // the block of the trailing dimensions has been computed once and replicated
+        }
+        else if (trivial && reducer_view_assigner<E1, E2>::run(de1, de2))
+        {
+            // the region of the reduced expression has been reduced at once
+        }
+        else if (trivial && transpose_assigner<xassign_traits<E1, E2>::transpose_assign()>::run(de1, de2))
+        {
+            // the transposed layouts have been copied tile by tile
+        }
+        else if (trivial && run_assigner<E1, E2>::run(de1, de2))
+        {
+            // the contiguous runs of the keep or drop slice have been assigned
+        }
+        else if (trivial && loop_order_assigner<xassign_traits<E1, E2>::loop_order_assign()>::run(de1, de2))
+        {
+            // the operands with conflicting layouts have been assigned in their best loop order
+        }
+        else if (strided_simd_assign)
+        {
+            strided_loop_assigner<strided_simd_assign>::run(de1, de2);
+        }
+        else
+        {
+            stepper_assigner<E1, E2, default_assignable_layout(E1::static_layout)> assigner(de1, de2);
+            assigner.run();
+        }
+    }
+
+    template <class Tag>
+    template <class E1, class E2>
+    inline void xexpression_assigner<Tag>::assign_xexpression(E1& e1, const E2& e2)
+    {
+        bool trivial_broadcast = resize(e1.derived_cast(), e2.derived_cast());
+        base_type::assign_data(e1, e2, trivial_broadcast);
+    }
+
+    template <class Tag>
+    template <class E1, class E2>
+    inline void xexpression_assigner<Tag>::computed_assign(xexpression<E1>& e1, const xexpression<E2>& e2)
+    {
+        using shape_type = typename E1::shape_type;
+        using size_type = typename E1::size_type;
+
+        E1& de1 = e1.derived_cast();
+        const E2& de2 = e2.derived_cast();
+
+        size_type dim = de2.dimension();
+        shape_type shape = xtl::make_sequence<shape_type>(dim, size_type(0));
+        bool trivial_broadcast = de2.broadcast_shape(shape, true);
+
+        if (dim > de1.dimension() || shape > de1.shape())
+        {
+            typename E1::temporary_type tmp(shape);
+            base_type::assign_data(tmp, e2, trivial_broadcast);
+            de1.assign_temporary(std::move(tmp));
+        }
+        else
+        {
+            base_type::assign_data(e1, e2, trivial_broadcast);
+        }
+    }
+
+    namespace detail
+    {
+        // Expressions whose elements are plain lvalues can compute a scalar
+        // assignment as the assignment of f(e1, scalar) to e1
+        template <class E>
+        struct use_scalar_function_assign
+            : std::integral_constant<bool, std::is_same<xexpression_tag_t<E>, xtensor_expression_tag>::value &&
+                                           std::is_same<typename E::reference, typename E::value_type&>::value>
+        {
+        };
+
+        template <class F, class B, class = void>
+        struct is_scalar_batch_callable : std::false_type
+        {
+        };
+
+        template <class F, class B>
+        struct is_scalar_batch_callable<F, B, void_t<decltype(std::declval<const F&>()(std::declval<const B&>(), std::declval<const B&>()))>>
+            : std::is_convertible<decltype(std::declval<const F&>()(std::declval<const B&>(), std::declval<const B&>())), B>
+        {
+        };
+
+        // The scalar is converted to the value type of the expression when the
+        // usual arithmetic conversions would do it anyway, so that f can be
+        // applied to batches of this type
+        template <class F, class T, class S>
+        struct use_scalar_simd_assign
+            : std::integral_constant<bool, std::is_arithmetic<T>::value && std::is_arithmetic<S>::value &&
+                                           std::is_same<std::common_type_t<T, S>, T>::value &&
+                                           !std::is_same<xsimd::simd_type<T>, T>::value &&
+                                           is_scalar_batch_callable<F, xsimd::simd_type<T>>::value>
+        {
+        };
+
+        template <class F, bool simd>
+        class scalar_assign_functor
+        {
+        public:
+
+            explicit scalar_assign_functor(const F& f)
+                : m_f(f)
+            {
+            }
+
+            template <class T1, class T2>
+            auto operator()(const T1& arg1, const T2& arg2) const -> decltype(std::declval<const F&>()(arg1, arg2))
+            {
+                return m_f(arg1, arg2);
+            }
+
+        protected:
+
+            F m_f;
+        };
+
+        template <class F>
+        class scalar_assign_functor<F, true> : public scalar_assign_functor<F, false>
+        {
+        public:
+
+            using base_type = scalar_assign_functor<F, false>;
+            using base_type::base_type;
+
+            template <class B>
+            auto simd_apply(const B& arg1, const B& arg2) const -> decltype(std::declval<const F&>()(arg1, arg2))
+            {
+                return this->m_f(arg1, arg2);
+            }
+        };
+
+        template <class E1, class E2, class F>
+        inline void scalar_function_assign(E1& e1, const E2& e2, const F& f, std::true_type)
+        {
+            using value_type = typename E1::value_type;
+            using simd = use_scalar_simd_assign<F, value_type, E2>;
+            using scalar_type = std::conditional_t<simd::value, value_type, E2>;
+            using functor_type = scalar_assign_functor<F, simd::value>;
+            using function_type = xfunction<functor_type, const E1&, xscalar<scalar_type>>;
+            const E1& ce1 = e1;
+            function_type fct(functor_type(f), ce1, xscalar<scalar_type>(static_cast<scalar_type>(e2)));
+            xt::assign_data(e1, fct, true);
+        }
+
+        template <class E1, class E2, class F>
+        inline void scalar_function_assign(E1& e1, const E2& e2, const F& f, std::false_type)
+        {
+            using size_type = typename E1::size_type;
+            auto dst = e1.storage().begin();
+            for (size_type i = e1.size(); i > 0; --i)
+            {
+                *dst = f(*dst, e2);
+                ++dst;
+            }
+        }
+    }
+
+    /**
+     * Computes f(e1, e2) into e1 for a scalar e2. Plain containers and views
+     * take the assignment paths of expressions, that is the SIMD linear or
+     * strided loops, run in parallel when a parallel backend is enabled.
+     */
+    template <class Tag>
+    template <class E1, class E2, class F>
+    inline void xexpression_assigner<Tag>::scalar_computed_assign(xexpression<E1>& e1, const E2& e2, F&& f)
+    {
+        detail::scalar_function_assign(e1.derived_cast(), e2, f, detail::use_scalar_function_assign<E1>());
+    }
+
+    template <class Tag>
+    template <class E1, class E2>
+    inline void xexpression_assigner<Tag>::assert_compatible_shape(const xexpression<E1>& e1, const xexpression<E2>& e2)
+    {
+        const E1& de1 = e1.derived_cast();
+        const E2& de2 = e2.derived_cast();
+        if (!broadcastable(de2.shape(), de1.shape()))
+        {
+            throw_broadcast_error(de2.shape(), de1.shape());
+        }
+    }
+
+    namespace detail
+    {
+        template <bool B, class... CT>
+        struct static_trivial_broadcast;
+
+        template <class... CT>
+        struct static_trivial_broadcast<true, CT...>
+        {
+            static constexpr bool value = detail::promote_index<typename std::decay_t<CT>::shape_type...>::value;
+        };
+
+        template <class... CT>
+        struct static_trivial_broadcast<false, CT...>
+        {
+            static constexpr bool value = false;
+        };
+    }
+
+    template <class Tag>
+    template <class E1, class E2>
+    inline bool xexpression_assigner<Tag>::resize(E1& e1, const E2& e2)
+    {
+        // If our RHS is not a xfunction, we know that the RHS is at least potentially trivial
+        // We check the strides of the RHS in detail::is_trivial_broadcast to see if they match up!
+        // So we can skip a shape copy and a call to broadcast_shape(...)
+        e1.resize(e2.shape());
+        return true;
+    }
+
+    template <class Tag>
+    template <class E1, class F, class... CT>
+    inline bool xexpression_assigner<Tag>::resize(E1& e1, const xfunction<F, CT...>& e2)
+    {
+        return xtl::mpl::static_if<detail::is_fixed<typename xfunction<F, CT...>::shape_type>::value>(
+            [&](auto /*self*/) {
+                /*
+                 * If the shape of the xfunction is statically known, we can compute the broadcast triviality
+                 * at compile time plus we can resize right away.
+                 */
+                // resize in case LHS is not a fixed size container. If it is, this is a NOP
+                e1.resize(typename xfunction<F, CT...>::shape_type{});
+                return detail::static_trivial_broadcast<detail::is_fixed<typename xfunction<F, CT...>::shape_type>::value, CT...>::value;
+            },
+            /* else */ [&](auto /*self*/)
+            {
+                using index_type = xindex_type_t<typename E1::shape_type>;
+                using size_type = typename E1::size_type;
+                size_type size = e2.dimension();
+                index_type shape = xtl::make_sequence<index_type>(size, size_type(0));
+                bool trivial_broadcast = e2.broadcast_shape(shape, true);
+                e1.resize(std::move(shape));
+                return trivial_broadcast;
+            }
+        );
+    }
+
+    /***********************************
+     * stepper_assigner implementation *
+     ***********************************/
+
+    template <class E1, class E2, layout_type L>
+    inline stepper_assigner<E1, E2, L>::stepper_assigner(E1& e1, const E2& e2)
+        : m_e1(e1), m_lhs(e1.stepper_begin(e1.shape())),
+          m_rhs(e2.stepper_begin(e1.shape())),
+          m_index(xtl::make_sequence<index_type>(e1.shape().size(), size_type(0)))
+    {
+    }
+
+    template <class E1, class E2, layout_type L>
+    inline void stepper_assigner<E1, E2, L>::run()
+    {
+        XTENSOR_INSTRUMENT_SCOPE(instrument::event_kind::stepper_assign, m_e1, E2,
+                                 m_e1.size() * (sizeof(typename E1::value_type) + sizeof(typename E2::value_type)));
+#if defined(XTENSOR_PARALLEL_ENABLED)
+        // The outermost dimension (according to L) is split into chunks, each chunk
+        // is assigned with a copy of this assigner moved to its first index.
+        const auto& shape = m_e1.shape();
+        size_type dim = shape.size();
+        if (dim != 0 && parallel::use_parallel(m_e1.size()))
+        {
+            size_type outer_dim = L == layout_type::row_major ? size_type(0) : dim - 1;
+            size_type outer_size = static_cast<size_type>(shape[outer_dim]);
+            size_type inner_size = outer_size != 0 ? m_e1.size() / outer_size : size_type(0);
+            parallel_for(std::size_t(0), outer_size, parallel::grain(inner_size), [&](std::size_t first, std::size_t last)
+            {
+                stepper_assigner chunk(*this);
+                chunk.m_index[outer_dim] = first;
+                chunk.step(outer_dim, static_cast<size_type>(first));
+                chunk.run_n(static_cast<size_type>(last - first) * inner_size);
+            });
+            return;
+        }
+#endif
+        run_n(m_e1.size());
+    }
+
+    template <class E1, class E2, layout_type L>
+    inline void stepper_assigner<E1, E2, L>::run_n(size_type n)
+    {
+        using argument_type = std::decay_t<decltype(*m_rhs)>;
+        using result_type = std::decay_t<decltype(*m_lhs)>;
+        using load_run = std::integral_constant<bool, std::is_arithmetic<argument_type>::value &&
+                                                      std::is_arithmetic<result_type>::value &&
+                                                      detail::has_load_run<rhs_iterator, result_type>::value>;
+        run_n(n, load_run());
+    }
+
+    template <class E1, class E2, layout_type L>
+    inline void stepper_assigner<E1, E2, L>::run_n(size_type n, std::false_type /*load_run*/)
+    {
+        using argument_type = std::decay_t<decltype(*m_rhs)>;
+        using result_type = std::decay_t<decltype(*m_lhs)>;
+        // the saturating conversions include the sign changes of integers
+        constexpr bool is_narrowing = is_narrowing_conversion<argument_type, result_type>::value ||
+                                      detail::is_saturating_conversion<result_type, argument_type>::value;
+
+        for (size_type i = 0; i < n; ++i)
+        {
+            *m_lhs = conditional_cast<is_narrowing, result_type>(*m_rhs);
+            stepper_tools<L>::increment_stepper(*this, m_index, m_e1.shape());
+        }
+    }
+
+    // The elements are assigned by runs of the inner dimension (according
+    // to L): the rhs stepper reads a run into a buffer with a single call,
+    // instead of dispatching a step to all the nodes of the expression for
+    // each element. The steppers never step past the last element of a row,
+    // whose copy is followed by the usual increment to the next row.
+    template <class E1, class E2, layout_type L>
+    inline void stepper_assigner<E1, E2, L>::run_n(size_type n, std::true_type /*load_run*/)
+    {
+        using result_type = std::decay_t<decltype(*m_lhs)>;
+        const auto& shape = m_e1.shape();
+        size_type dim = shape.size();
+        if (dim == 0)
+        {
+            run_n(n, std::false_type());
+            return;
+        }
+
+        size_type inner = L == layout_type::row_major ? dim - 1 : size_type(0);
+        size_type extent = static_cast<size_type>(shape[inner]);
+        detail::run_buffer<result_type> buffer;
+        while (n != 0)
+        {
+            size_type row_rest = extent - static_cast<size_type>(m_index[inner]);
+            size_type count = (std::min)((std::min)(row_rest, n), size_type(detail::run_buffer_size));
+            bool row_end = count == row_rest;
+            size_type run = row_end ? count - 1 : count;
+            detail::load_run(m_rhs, inner, run, buffer.data);
+            detail::store_run(m_lhs, inner, run, buffer.data);
+            n -= count;
+            if (row_end)
+            {
+                *m_lhs = static_cast<result_type>(*m_rhs);
+                m_index[inner] = extent - 1;
+                if (n != 0)
+                {
+                    stepper_tools<L>::increment_stepper(*this, m_index, shape);
+                }
+            }
+            else
+            {
+                m_index[inner] += run;
+            }
+        }
+    }
+
+    template <class E1, class E2, layout_type L>
+    inline void stepper_assigner<E1, E2, L>::step(size_type i)
+    {
+        m_lhs.step(i);
+        m_rhs.step(i);
+    }
+
+    template <class E1, class E2, layout_type L>
+    inline void stepper_assigner<E1, E2, L>::step(size_type i, size_type n)
+    {
+        m_lhs.step(i, n);
+        m_rhs.step(i, n);
+    }
+
+    template <class E1, class E2, layout_type L>
+    inline void stepper_assigner<E1, E2, L>::reset(size_type i)
+    {
+        m_lhs.reset(i);
+        m_rhs.reset(i);
+    }
+
+    template <class E1, class E2, layout_type L>
+    inline void stepper_assigner<E1, E2, L>::to_end(layout_type l)
+    {
+        m_lhs.to_end(l);
+        m_rhs.to_end(l);
+    }
+
+    /**********************************
+     * linear_assigner implementation *
+     **********************************/
+
+    namespace detail
+    {
+        template <class E, class V, class = void>
+        struct has_data_pointer : std::false_type
+        {
+        };
+
+        template <class E, class V>
+        struct has_data_pointer<E, V, std::enable_if_t<std::is_same<decltype(std::declval<E&>().data()), V*>::value>>
+            : std::true_type
+        {
+        };
+
+        template <class E1, class V>
+        using use_stream_store = xtl::conjunction<std::is_same<typename E1::value_type, V>,
+                                                  has_data_pointer<E1, V>,
+                                                  has_stream_store<V>>;
+
+        template <class LA, class RA, class V, class E1, class E2>
+        inline void linear_simd_range(E1& e1, const E2& e2, std::size_t first, std::size_t last, std::false_type /*stream*/)
+        {
+            constexpr std::size_t simd_size = xsimd::simd_type<V>::size;
+            for (std::size_t i = first; i < last; i += simd_size)
+            {
+                e1.template store_simd<LA>(i, e2.template load_simd<RA, V>(i));
+            }
+        }
+
+        template <class LA, class RA, class V, class E1, class E2>
+        inline void linear_simd_range(E1& e1, const E2& e2, std::size_t first, std::size_t last, std::true_type /*stream*/)
+        {
+            using simd_type = xsimd::simd_type<V>;
+            constexpr std::size_t simd_size = simd_type::size;
+            V* dst = e1.data() + e1.data_offset();
+            for (std::size_t i = first; i < last; i += simd_size)
+            {
+                stream_storer<V, simd_type>::store(dst + i, e2.template load_simd<RA, V>(i));
+            }
+            stream_fence();
+        }
+
+        // Non-temporal stores require destinations aligned on the size of
+        // the batches, which unaligned containers only guarantee from
+        // align_begin if the alignment of their value type allows it
+        template <class V, class E1>
+        inline bool use_stream_range(E1& e1, std::size_t first, std::size_t last, std::true_type)
+        {
+            constexpr std::size_t batch_bytes = xsimd::simd_type<V>::size * sizeof(V);
+            const V* dst = e1.data() + e1.data_offset() + first;
+            return streaming::use_streaming((last - first) * sizeof(V)) &&
+                   reinterpret_cast<std::uintptr_t>(dst) % batch_bytes == 0;
+        }
+
+        template <class V, class E1>
+        inline bool use_stream_range(E1&, std::size_t, std::size_t, std::false_type)
+        {
+            return false;
+        }
+    }
+
+    namespace detail
+    {
+        struct plus;
+        struct minus;
+        struct multiplies;
+        struct divides;
+
+        template <class F>
+        struct is_dispatch_binary_functor
+            : xtl::disjunction<std::is_same<F, plus>, std::is_same<F, minus>,
+                               std::is_same<F, multiplies>, std::is_same<F, divides>>
+        {
+        };
+
+        // operand of a dispatched kernel: the buffer of a contiguous expression
+        // or a scalar, holding values of type T
+        template <class E, class T, class = void>
+        struct dispatch_operand
+        {
+            static constexpr bool value = false;
+        };
+
+        template <class E, class T>
+        struct dispatch_operand<E, T, std::enable_if_t<conversion_source<E>::value &&
+                                                       std::is_same<typename conversion_source<E>::value_type, T>::value>>
+        {
+            static constexpr bool value = true;
+
+            static const T* get(const E& e) noexcept
+            {
+                return conversion_source<E>::data(e);
+            }
+        };
+
+        template <class CT, class T>
+        struct dispatch_operand<xscalar<CT>, T, std::enable_if_t<std::is_same<std::decay_t<CT>, T>::value>>
+        {
+            static constexpr bool value = true;
+
+            static dispatch::scalar_operand<T> get(const xscalar<CT>& e) noexcept
+            {
+                return dispatch::scalar_operand<T>{e()};
+            }
+        };
+
+        template <class T>
+        inline const T* dispatch_offset(const T* p, std::size_t i) noexcept
+        {
+            return p + i;
+        }
+
+        template <class T>
+        inline dispatch::scalar_operand<T> dispatch_offset(dispatch::scalar_operand<T> s, std::size_t) noexcept
+        {
+            return s;
+        }
+
+        // arithmetic operator applied to contiguous buffers or scalars of the
+        // value type of a contiguous destination
+        template <class E1, class E2, class = void>
+        struct dispatch_binary_assign : std::false_type
+        {
+        };
+
+        template <class E1, class F, class CT1, class CT2>
+        struct dispatch_binary_assign<E1, xfunction<F, CT1, CT2>,
+                                      std::enable_if_t<is_dispatch_binary_functor<F>::value &&
+                                                       dispatch::is_kernel_type<typename E1::value_type>::value &&
+                                                       E1::contiguous_layout &&
+                                                       has_data_pointer<E1, typename E1::value_type>::value &&
+                                                       dispatch_operand<std::decay_t<CT1>, typename E1::value_type>::value &&
+                                                       dispatch_operand<std::decay_t<CT2>, typename E1::value_type>::value>>
+            : std::true_type
+        {
+        };
+
+        template <class E1, class E2>
+        inline bool dispatch_linear_assign(E1&, const E2&, std::false_type) noexcept
+        {
+            return false;
+        }
+
+        // Runs the kernel of the instruction set selected at runtime, when
+        // it is better than the one the assignment loops are compiled for
+        template <class E1, class F, class CT1, class CT2>
+        inline bool dispatch_linear_assign(E1& e1, const xfunction<F, CT1, CT2>& e2, std::true_type)
+        {
+            if (cpu::dispatch_isa() == cpu::isa::generic)
+            {
+                return false;
+            }
+            using value_type = typename E1::value_type;
+            using lhs_operand = dispatch_operand<std::decay_t<CT1>, value_type>;
+            using rhs_operand = dispatch_operand<std::decay_t<CT2>, value_type>;
+            value_type* dst = e1.data() + e1.data_offset();
+            auto a = lhs_operand::get(std::get<0>(e2.arguments()));
+            auto b = rhs_operand::get(std::get<1>(e2.arguments()));
+            std::size_t size = e1.size();
+            auto run = [&](std::size_t first, std::size_t last) {
+                dispatch::binary(F(), dispatch_offset(a, first), dispatch_offset(b, first), dst + first, last - first);
+            };
+#if defined(XTENSOR_PARALLEL_ENABLED)
+            if (parallel::use_parallel(size))
+            {
+                std::size_t line = std::max(XTENSOR_CACHE_LINE_SIZE / sizeof(value_type), std::size_t(1));
+                parallel_for(std::size_t(0), size, parallel::grain(1, line), run);
+                return true;
+            }
+#endif
+            run(std::size_t(0), size);
+            return true;
+        }
+    }
+
+    namespace detail
+    {
+        // Operand of a loop over raw pointers: the buffer of a contiguous
+        // expression, a scalar, or a function of such operands
+        template <class E, class = void>
+        struct loop_operand : std::false_type
+        {
+        };
+
+        template <class E>
+        struct loop_operand<E, std::enable_if_t<has_data_interface<E>::value && E::contiguous_layout &&
+                                                std::is_arithmetic<typename E::value_type>::value &&
+                                                std::is_same<data_value_type_t<E>, typename E::value_type>::value>>
+            : std::true_type
+        {
+            using type = const typename E::value_type*;
+
+            static type get(const E& e) noexcept
+            {
+                return e.data() + e.data_offset();
+            }
+        };
+
+        // number of elements of the blocks of 16 bit floating point values
+        // converted to float at once
+        constexpr std::size_t staged_block_size = 256;
+
+        // A buffer of 16 bit floating point values, read as float from blocks
+        // converted by stage_operand
+        template <class H>
+        struct staged_operand
+        {
+            const H* p_src;
+            std::size_t m_first;
+            float m_block[staged_block_size];
+
+            float operator[](std::size_t i) const noexcept
+            {
+                return m_block[i - m_first];
+            }
+        };
+
+        template <class E>
+        struct loop_operand<E, std::enable_if_t<has_data_interface<E>::value && E::contiguous_layout &&
+                                                is_half_float<typename E::value_type>::value &&
+                                                std::is_same<data_value_type_t<E>, typename E::value_type>::value>>
+            : std::true_type
+        {
+            using type = staged_operand<typename E::value_type>;
+
+            static type get(const E& e) noexcept
+            {
+                return type{e.data() + e.data_offset(), 0};
+            }
+        };
+
+        template <class CT>
+        struct loop_operand<xscalar<CT>, std::enable_if_t<std::is_arithmetic<std::decay_t<CT>>::value>>
+            : std::true_type
+        {
+            using type = dispatch::scalar_operand<std::decay_t<CT>>;
+
+            static type get(const xscalar<CT>& e) noexcept
+            {
+                return type{e()};
+            }
+        };
+
+        template <class F, class... O>
+        struct loop_function
+        {
+            const F& m_f;
+            std::tuple<O...> m_operands;
+
+            auto operator[](std::size_t i) const
+            {
+                return apply(i, std::index_sequence_for<O...>());
+            }
+
+            template <std::size_t... I>
+            auto apply(std::size_t i, std::index_sequence<I...>) const
+            {
+                return m_f(std::get<I>(m_operands)[i]...);
+            }
+        };
+
+        template <class F, class... CT>
+        struct loop_operand<xfunction<F, CT...>,
+                            std::enable_if_t<sizeof...(CT) != 0 &&
+                                             (std::is_arithmetic<typename xfunction<F, CT...>::value_type>::value ||
+                                              is_half_float<typename xfunction<F, CT...>::value_type>::value) &&
+                                             xtl::conjunction<loop_operand<std::decay_t<CT>>...>::value>>
+            : std::true_type
+        {
+            using function_type = xfunction<F, CT...>;
+            using type = loop_function<typename function_type::functor_type,
+                                       typename loop_operand<std::decay_t<CT>>::type...>;
+
+            static type get(const function_type& e) noexcept
+            {
+                return get_impl(e, std::index_sequence_for<CT...>());
+            }
+
+            template <std::size_t... I>
+            static type get_impl(const function_type& e, std::index_sequence<I...>) noexcept
+            {
+                return type{e.functor(), std::make_tuple(loop_operand<std::decay_t<CT>>::get(std::get<I>(e.arguments()))...)};
+            }
+        };
+
+        template <class O>
+        struct is_staged_operand : std::false_type
+        {
+        };
+
+        template <class H>
+        struct is_staged_operand<staged_operand<H>> : std::true_type
+        {
+        };
+
+        template <class F, class... O>
+        struct is_staged_operand<loop_function<F, O...>> : xtl::disjunction<is_staged_operand<O>...>
+        {
+        };
+
+        template <class O>
+        inline void stage_operand(O&, std::size_t, std::size_t) noexcept
+        {
+        }
+
+        template <class H>
+        inline void stage_operand(staged_operand<H>& op, std::size_t first, std::size_t n) noexcept
+        {
+            op.m_first = first;
+            half_to_float(op.p_src + first, op.m_block, n);
+        }
+
+        template <class F, class... O, std::size_t... I>
+        inline void stage_operands(loop_function<F, O...>& op, std::size_t first, std::size_t n,
+                                   std::index_sequence<I...>) noexcept
+        {
+            using swallow = int[];
+            (void)swallow{0, (stage_operand(std::get<I>(op.m_operands), first, n), 0)...};
+        }
+
+        template <class F, class... O>
+        inline void stage_operand(loop_function<F, O...>& op, std::size_t first, std::size_t n) noexcept
+        {
+            stage_operands(op, first, n, std::index_sequence_for<O...>());
+        }
+
+        template <class E1, class E2, class = void>
+        struct use_loop_assign : std::false_type
+        {
+        };
+
+        // a copy between buffers of the same 16 bit type does not convert
+        template <class E1, class E2>
+        struct use_loop_assign<E1, E2, std::enable_if_t<loop_operand<E1>::value &&
+                                                        has_data_pointer<E1, typename E1::value_type>::value &&
+                                                        loop_operand<E2>::value>>
+            : xtl::negation<std::is_same<typename loop_operand<E2>::type, staged_operand<typename E1::value_type>>>
+        {
+        };
+
+        // blocks of operands and of destination of 16 bit floating point
+        // types are converted to float with vectorized conversions
+        template <class E1, class E2>
+        using use_staged_loop = std::integral_constant<bool, is_half_float<typename E1::value_type>::value ||
+                                                             is_staged_operand<typename loop_operand<E2>::type>::value>;
+
+        template <class V, class O>
+        inline void loop_store(V* dst, const O& src, std::size_t first, std::size_t last, std::false_type /*half*/)
+        {
+            XTENSOR_PRAGMA_SIMD
+            for (std::size_t i = first; i < last; ++i)
+            {
+                dst[i] = convert_element<V>(src[i]);
+            }
+        }
+
+        template <class V, class O>
+        inline void loop_store(V* dst, const O& src, std::size_t first, std::size_t last, std::true_type /*half*/)
+        {
+            float block[staged_block_size];
+            std::size_t n = last - first;
+            XTENSOR_PRAGMA_SIMD
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                block[i] = static_cast<float>(src[first + i]);
+            }
+            float_to_half(block, dst + first, n);
+        }
+
+        template <class E2, class V>
+        inline void loop_assign_range(V* dst, const E2& e2, std::size_t first, std::size_t last, std::false_type /*staged*/)
+        {
+            auto src = loop_operand<E2>::get(e2);
+            loop_store(dst, src, first, last, std::false_type());
+        }
+
+        template <class E2, class V>
+        inline void loop_assign_range(V* dst, const E2& e2, std::size_t first, std::size_t last, std::true_type /*staged*/)
+        {
+            auto src = loop_operand<E2>::get(e2);
+            for (std::size_t block = first; block < last; block += staged_block_size)
+            {
+                std::size_t block_last = std::min(block + staged_block_size, last);
+                stage_operand(src, block, block_last - block);
+                loop_store(dst, src, block, block_last, is_half_float<V>());
+            }
+        }
+
+        template <class E1, class E2>
+        inline bool loop_linear_assign(E1&, const E2&, std::false_type) noexcept
+        {
+            return false;
+        }
+
+        // Linear assignments that are not evaluated with xsimd batches run a
+        // loop over raw pointers that the compiler can vectorize, instead of
+        // the iterator loop. The destination may be one of the operands, which
+        // only carries dependencies between iterations with the same index.
+        template <class E1, class E2>
+        inline bool loop_linear_assign(E1& e1, const E2& e2, std::true_type)
+        {
+            using value_type = typename E1::value_type;
+            value_type* dst = e1.data() + e1.data_offset();
+            std::size_t size = e1.size();
+            auto run = [&](std::size_t first, std::size_t last) {
+                loop_assign_range(dst, e2, first, last, use_staged_loop<E1, E2>());
+            };
+#if defined(XTENSOR_PARALLEL_ENABLED)
+            if (parallel::use_parallel(size))
+            {
+                std::size_t line = std::max(XTENSOR_CACHE_LINE_SIZE / sizeof(value_type), std::size_t(1));
+                parallel_for(std::size_t(0), size, parallel::grain(1, line), run);
+                return true;
+            }
+#endif
+            run(std::size_t(0), size);
+            return true;
+        }
+    }
+
+    template <bool simd_assign>
+    template <class E1, class E2>
+    inline void linear_assigner<simd_assign>::run(E1& e1, const E2& e2)
+    {
+        XTENSOR_INSTRUMENT_SCOPE(instrument::event_kind::linear_assign, e1, E2, instrument::assign_bytes(e1, e2));
+        if (detail::dispatch_linear_assign(e1, e2, detail::dispatch_binary_assign<E1, E2>()))
+        {
+            return;
+        }
+        using lhs_align_mode = xsimd::container_alignment_t<E1>;
+        constexpr bool is_aligned = std::is_same<lhs_align_mode, aligned_mode>::value;
+        using rhs_align_mode = std::conditional_t<is_aligned, inner_aligned_mode, unaligned_mode>;
+        using value_type = std::common_type_t<typename E1::value_type, typename E2::value_type>;
+        using simd_type = xsimd::simd_type<value_type>;
+        using size_type = typename E1::size_type;
+        using stream_type = detail::use_stream_store<E1, value_type>;
+        size_type size = e1.size();
+        constexpr size_type simd_size = simd_type::size;
+
+        size_type align_begin = is_aligned ? 0 : xsimd::get_alignment_offset(e1.data() + e1.data_offset(), size, simd_size);
+        size_type align_end = align_begin + ((size - align_begin) & ~(simd_size - 1));
+
+        for (size_type i = 0; i < align_begin; ++i)
+        {
+            e1.data_element(i) = e2.data_element(i);
+        }
+
+        // large destinations are written with non-temporal stores, that do not
+        // read them into the caches (see streaming::min_bytes)
+        bool stream = detail::use_stream_range<value_type>(e1, align_begin, align_end, stream_type());
+        auto assign_range = [&](size_type first, size_type last) {
+            if (stream)
+            {
+                detail::linear_simd_range<lhs_align_mode, rhs_align_mode, value_type>(e1, e2, first, last, stream_type());
+            }
+            else
+            {
+                detail::linear_simd_range<lhs_align_mode, rhs_align_mode, value_type>(e1, e2, first, last, std::false_type());
+            }
+        };
+
+#if defined(XTENSOR_PARALLEL_ENABLED)
+        if (parallel::use_parallel(size))
+        {
+            // chunks are expressed in number of simd batches so that every
+            // chunk boundary stays aligned, and span whole cache lines
+            constexpr std::size_t batch_bytes = simd_size * sizeof(value_type);
+            constexpr std::size_t line_batches = XTENSOR_CACHE_LINE_SIZE > batch_bytes ?
+                                                 XTENSOR_CACHE_LINE_SIZE / batch_bytes : 1;
+            parallel_for(std::size_t(0), (align_end - align_begin) / simd_size, parallel::grain(simd_size, line_batches),
+                         [&](std::size_t first, std::size_t last)
+            {
+                assign_range(align_begin + first * simd_size, align_begin + last * simd_size);
+            });
+        }
+        else
+#endif
+        {
+            assign_range(align_begin, align_end);
+        }
+        for (size_type i = align_end; i < size; ++i)
+        {
+            e1.data_element(i) = e2.data_element(i);
+        }
+    }
+
+    template <class E1, class E2>
+    inline void linear_assigner<false>::run(E1& e1, const E2& e2)
+    {
+        XTENSOR_INSTRUMENT_SCOPE(instrument::event_kind::linear_assign, e1, E2, instrument::assign_bytes(e1, e2));
+        using is_convertible = std::is_convertible<typename std::decay_t<E2>::value_type,
+                                                   typename std::decay_t<E1>::value_type>;
+        // If the types are not compatible, this function is still instantiated but never called.
+        // To avoid compilation problems in effectively unused code trivial_assigner_run_impl is
+        // empty in this case.
+        run_impl(e1, e2, is_convertible());
+    }
+
+    template <class E1, class E2>
+    inline void linear_assigner<false>::run_impl(E1& e1, const E2& e2, std::true_type /*is_convertible*/)
+    {
+        if (detail::dispatch_linear_assign(e1, e2, detail::dispatch_binary_assign<E1, E2>()) ||
+            detail::loop_linear_assign(e1, e2, detail::use_loop_assign<E1, E2>()))
+        {
+            return;
+        }
+        using value_type = typename E1::value_type;
+        using size_type = typename E1::size_type;
+        auto src = detail::linear_begin(e2);
+        auto dst = detail::linear_begin(e1);
+        size_type n = e1.size();
+
+#if defined(XTENSOR_PARALLEL_ENABLED)
+        if (parallel::use_parallel(n))
+        {
+            constexpr std::size_t line_size = XTENSOR_CACHE_LINE_SIZE > sizeof(value_type) ?
+                                              XTENSOR_CACHE_LINE_SIZE / sizeof(value_type) : 1;
+            parallel_for(std::size_t(0), static_cast<std::size_t>(n), parallel::grain(1, line_size),
+                         [&](std::size_t first, std::size_t last)
+            {
+                auto chunk_src = src + static_cast<std::ptrdiff_t>(first);
+                auto chunk_dst = dst + static_cast<std::ptrdiff_t>(first);
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    *chunk_dst = detail::convert_element<value_type>(*chunk_src);
+                    ++chunk_src;
+                    ++chunk_dst;
+                }
+            });
+            return;
+        }
+#endif
+        for (; n > size_type(0); --n)
+        {
+            *dst = detail::convert_element<value_type>(*src);
+            ++src;
+            ++dst;
+        }
+    }
+
+    template <class E1, class E2>
+    inline void linear_assigner<false>::run_impl(E1&, const E2&, std::false_type /*is_convertible*/)
+    {
+        XTENSOR_PRECONDITION(false,
+            "Internal error: linear_assigner called with unrelated types.");
+
+    }
+
+    /****************************************
+     * strided_loop_assigner implementation *
+     ****************************************/
+
+    namespace strided_assign_detail
+    {
+        template <layout_type layout>
+        struct idx_tools;
+
+        template <>
+        struct idx_tools<layout_type::row_major>
+        {
+            template <class T>
+            static void next_idx(T& outer_index, T& outer_shape)
+            {
+                auto i = outer_index.size();
+                for (; i > 0; --i)
+                {
+                    if (outer_index[i - 1] + 1 >= outer_shape[i - 1])
+                    {
+                        outer_index[i - 1] = 0;
+                    }
+                    else
+                    {
+                        outer_index[i - 1]++;
+                        break;
+                    }
+                }
+            }
+        };
+
+        template <>
+        struct idx_tools<layout_type::column_major>
+        {
+            template <class T>
+            static void next_idx(T& outer_index, T& outer_shape)
+            {
+                using size_type = typename T::size_type;
+                size_type i = 0;
+                auto sz = outer_index.size();
+                for (; i < sz; ++i)
+                {
+                    if (outer_index[i] + 1 >= outer_shape[i])
+                    {
+                        outer_index[i] = 0;
+                    }
+                    else
+                    {
+                        outer_index[i]++;
+                        break;
+                    }
+                }
+            }
+        };
+
+        // Returns the first dimension (in the index space of s1) from which
+        // all the strides of s2 are 0, i.e. from which the operand is
+        // broadcast (row major only).
+        template <class S1, class S2>
+        inline std::size_t check_broadcast_overlap(const S1& s1, const S2& s2)
+        {
+            auto s2_index = s2.size();
+            for (; s2_index != 0 && s2[s2_index - 1] == 0; --s2_index)
+            {
+            }
+            return s2_index == 0 ? std::size_t(0) : s1.size() - (s2.size() - s2_index);
+        }
+
+        template <layout_type L, class S>
+        struct check_strides_functor
+        {
+            using strides_type = S;
+
+            check_strides_functor(const S& strides, std::size_t cut, bool allow_splat = false)
+                : m_cut(cut),
+                  m_strides(strides),
+                  m_allow_splat(allow_splat),
+                  m_splat(false)
+            {
+            }
+
+            template <class T, layout_type LE = L>
+            std::enable_if_t<LE == layout_type::row_major, std::size_t>
+            operator()(const T& el)
+            {
+                auto var = check_strides_overlap<layout_type::row_major>::get(m_strides, el.strides());
+                if (m_allow_splat && var > m_cut)
+                {
+                    // operands broadcast on the inner dimensions (e.g. of shape (N, 1))
+                    // are splatted instead of loaded
+                    auto zero_var = check_broadcast_overlap(m_strides, el.strides());
+                    if (zero_var < var)
+                    {
+                        var = zero_var;
+                        m_splat = true;
+                    }
+                }
+                if (var > m_cut)
+                {
+                    m_cut = var;
+                }
+                return m_cut;
+            }
+
+            template <class T, layout_type LE = L>
+            std::enable_if_t<LE == layout_type::column_major, std::size_t>
+            operator()(const T& el)
+            {
+                auto var = check_strides_overlap<layout_type::column_major>::get(m_strides, el.strides());
+                if (var < m_cut)
+                {
+                    m_cut = var;
+                }
+                return m_cut;
+            }
+
+            template <class T>
+            std::size_t operator()(const xt::xscalar<T>& /*el*/)
+            {
+                return m_cut;
+            }
+
+            template <class F, class... CT>
+            std::size_t operator()(const xt::xfunction<F, CT...>& xf)
+            {
+                xt::for_each(*this, xf.arguments());
+                return m_cut;
+            }
+
+            template <class F, class CT>
+            std::size_t operator()(const xt::xfunctor_view<F, CT>& xf)
+            {
+                return (*this)(xf.expression());
+            }
+
+            bool splat() const noexcept
+            {
+                return m_splat;
+            }
+
+        private:
+
+            std::size_t m_cut;
+            const strides_type& m_strides;
+            bool m_allow_splat;
+            bool m_splat;
+        };
+
+        // Returns the first (row major) or the last (column major) dimension
+        // of the innermost block of e1 whose elements are contiguous, e.g. 1
+        // for a 2-D container with padded rows.
+        template <class E1>
+        inline std::size_t contiguous_cut(const E1& e1, bool is_row_major)
+        {
+            using strides_value_type = typename std::decay_t<decltype(e1.strides())>::value_type;
+            const auto& shape = e1.shape();
+            const auto& strides = e1.strides();
+            strides_value_type data_size = 1;
+            if (is_row_major)
+            {
+                std::size_t i = shape.size();
+                for (; i != 0; --i)
+                {
+                    if (shape[i - 1] != 1 && static_cast<strides_value_type>(strides[i - 1]) != data_size)
+                    {
+                        break;
+                    }
+                    data_size *= static_cast<strides_value_type>(shape[i - 1]);
+                }
+                return i;
+            }
+            else
+            {
+                std::size_t i = 0;
+                for (; i < shape.size(); ++i)
+                {
+                    if (shape[i] != 1 && static_cast<strides_value_type>(strides[i]) != data_size)
+                    {
+                        break;
+                    }
+                    data_size *= static_cast<strides_value_type>(shape[i]);
+                }
+                return i;
+            }
+        }
+
+        template <class E1, class E2>
+        auto get_loop_sizes(const E1& e1, const E2& e2, bool is_row_major)
+        {
+            std::size_t cut = 0;
+            bool splat = false;
+
+            // the inner loop must not run over the gaps between the
+            // contiguous blocks of e1 (e.g. padded rows)
+            std::size_t e1_cut = E1::contiguous_layout ? (is_row_major ? 0 : e1.dimension())
+                                                       : contiguous_cut(e1, is_row_major);
+            if (E1::static_layout == layout_type::row_major || is_row_major)
+            {
+                // the steppers of splatted operands check the stride of the last
+                // dimension, which is 1 in the other operands and in e1 unless its
+                // extent is 1
+                bool allow_splat = e1.dimension() != 0 && e1.shape().back() != 1;
+                auto csf = check_strides_functor<layout_type::row_major, decltype(e1.strides())>(e1.strides(), e1_cut, allow_splat);
+                cut = csf(e2);
+                splat = csf.splat();
+            }
+            else if (E1::static_layout == layout_type::column_major || !is_row_major)
+            {
+                auto csf = check_strides_functor<layout_type::column_major, decltype(e1.strides())>(e1.strides(), e1_cut);
+                cut = csf(e2);
+            } // can't reach here because this would have already triggered the fallback
+
+            using shape_value_type = typename E1::shape_type::value_type;
+            std::size_t outer_loop_size = static_cast<std::size_t>(
+                            std::accumulate(e1.shape().begin(), e1.shape().begin() + static_cast<std::ptrdiff_t>(cut),
+                                shape_value_type(1), std::multiplies<shape_value_type>{}));
+            std::size_t inner_loop_size = static_cast<std::size_t>(
+                            std::accumulate(e1.shape().begin() + static_cast<std::ptrdiff_t>(cut), e1.shape().end(),
+                                shape_value_type(1), std::multiplies<shape_value_type>{}));
+
+            if (E1::static_layout == layout_type::column_major || !is_row_major)
+            {
+                std::swap(outer_loop_size, inner_loop_size);
+            }
+
+            return std::make_tuple(inner_loop_size, outer_loop_size, cut, splat);
+        }
+
+        // Prefetches the beginning of the row which the strided loop reaches
+        // rows_ahead rows after the current one, in the operands whose outer
+        // stride spans at least a page: the hardware prefetchers do not
+        // follow these jumps, and every row would start with cache misses.
+        class row_prefetcher
+        {
+        public:
+
+            row_prefetcher(std::size_t step_dim, std::size_t outer_dim, bool is_row_major,
+                           std::size_t inner_loop_size) noexcept
+                : m_step_dim(step_dim), m_outer_dim(outer_dim),
+                  m_lead(is_row_major && outer_dim != 0 ? outer_dim - 1 : std::size_t(0)),
+                  m_inner_loop_size(inner_loop_size), m_rows_ahead(rows_ahead(inner_loop_size))
+            {
+            }
+
+            template <class E, class S>
+            void add(const E& e, const S& shape, bool write)
+            {
+                add_impl(e, shape, write, std::integral_constant<bool, has_data_interface<E>::value && has_strides<E>::value>());
+            }
+
+            template <class F, class... CT, class S>
+            void add(const xfunction<F, CT...>& f, const S& shape, bool write)
+            {
+                for_each([&](const auto& arg) { this->add(arg, shape, write); }, f.arguments());
+            }
+
+            template <class I>
+            void operator()(const I& idx, const I& max_shape) const noexcept
+            {
+                if (m_operands.empty() || idx[m_lead] + m_rows_ahead >= max_shape[m_lead])
+                {
+                    return;
+                }
+                for (const auto& op : m_operands)
+                {
+                    std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(m_rows_ahead) * op.strides[m_lead];
+                    for (std::size_t i = 0; i < idx.size(); ++i)
+                    {
+                        offset += static_cast<std::ptrdiff_t>(idx[i]) * op.strides[i];
+                    }
+                    if (op.write)
+                    {
+                        detail::prefetch_write(op.p_data + offset);
+                    }
+                    else
+                    {
+                        detail::prefetch_read(op.p_data + offset);
+                    }
+                }
+            }
+
+        private:
+
+            struct operand
+            {
+                const char* p_data;
+                // in bytes, for the dimensions of the outer loop
+                dynamic_shape<std::ptrdiff_t> strides;
+                bool write;
+            };
+
+            // the row which contains the element prefetch_distance elements
+            // ahead of the beginning of the current row
+            static std::size_t rows_ahead(std::size_t inner_loop_size) noexcept
+            {
+                if (detail::prefetch_distance == 0)
+                {
+                    return 0;
+                }
+                std::size_t row_size = inner_loop_size == 0 ? std::size_t(1) : inner_loop_size;
+                return (detail::prefetch_distance + row_size - 1) / row_size;
+            }
+
+            template <class E, class S>
+            void add_impl(const E& e, const S& shape, bool write, std::true_type)
+            {
+                using data_type = std::remove_cv_t<std::remove_pointer_t<decltype(e.data())>>;
+                bool same_shape = e.dimension() == shape.size() && std::equal(shape.cbegin(), shape.cend(), e.shape().cbegin());
+                if (m_rows_ahead == 0 || m_outer_dim == 0 || !same_shape)
+                {
+                    return;
+                }
+                std::ptrdiff_t lead_stride = static_cast<std::ptrdiff_t>(e.strides()[m_step_dim + m_lead]);
+                // adjacent rows are read sequentially
+                bool adjacent_rows = static_cast<std::size_t>(lead_stride < 0 ? -lead_stride : lead_stride) == m_inner_loop_size;
+                if (adjacent_rows || !detail::use_stride_prefetch<data_type>(lead_stride))
+                {
+                    return;
+                }
+                operand op;
+                op.p_data = reinterpret_cast<const char*>(e.data() + e.data_offset());
+                xt::resize_container(op.strides, m_outer_dim);
+                for (std::size_t i = 0; i < m_outer_dim; ++i)
+                {
+                    op.strides[i] = static_cast<std::ptrdiff_t>(e.strides()[m_step_dim + i]) * static_cast<std::ptrdiff_t>(sizeof(data_type));
+                }
+                op.write = write;
+                m_operands.push_back(std::move(op));
+            }
+
+            template <class E, class S>
+            void add_impl(const E& /*e*/, const S& /*shape*/, bool /*write*/, std::false_type) noexcept
+            {
+            }
+
+            std::size_t m_step_dim;
+            std::size_t m_outer_dim;
+            std::size_t m_lead;
+            std::size_t m_inner_loop_size;
+            std::size_t m_rows_ahead;
+            std::vector<operand> m_operands;
+        };
+
+        template <bool splat>
+        struct leading_step;
+
+        template <>
+        struct leading_step<false>
+        {
+            template <class S, class F>
+            static S step_simd(F& fct_stepper, std::size_t /*dim*/)
+            {
+                return fct_stepper.template step_simd<S>();
+            }
+
+            template <class F>
+            static void step(F& fct_stepper, std::size_t /*dim*/)
+            {
+                fct_stepper.step_leading();
+            }
+        };
+
+        template <>
+        struct leading_step<true>
+        {
+            template <class S, class F>
+            static S step_simd(F& fct_stepper, std::size_t dim)
+            {
+                return fct_stepper.template step_simd<S>(dim);
+            }
+
+            template <class F>
+            static void step(F& fct_stepper, std::size_t dim)
+            {
+                fct_stepper.step_leading(dim);
+            }
+        };
+
+        template <class S, bool contiguous_lhs, bool splat = false, class R, class F, class I>
+        inline void strided_loop(R& res_stepper, F& fct_stepper, I& idx, I& max_shape,
+                                 std::size_t outer_loop_size, std::size_t simd_size,
+                                 std::size_t simd_rest, std::size_t step_dim, bool is_row_major,
+                                 const row_prefetcher& prefetch, std::size_t leading_dim = 0)
+        {
+            for (std::size_t ox = 0; ox < outer_loop_size; ++ox)
+            {
+                for (std::size_t i = 0; i < simd_size; ++i)
+                {
+                    res_stepper.template store_simd<S>(leading_step<splat>::template step_simd<S>(fct_stepper, leading_dim));
+                }
+                for (std::size_t i = 0; i < simd_rest; ++i)
+                {
+                    *(res_stepper) = *(fct_stepper);
+                    res_stepper.step_leading();
+                    leading_step<splat>::step(fct_stepper, leading_dim);
+                }
+
+                is_row_major ?
+                    idx_tools<layout_type::row_major>::next_idx(idx, max_shape) :
+                    idx_tools<layout_type::column_major>::next_idx(idx, max_shape);
+
+                prefetch(idx, max_shape);
+                fct_stepper.to_begin();
+
+                // need to step E1 as well if not contigous assign (e.g. view)
+                if (!contiguous_lhs)
+                {
+                    res_stepper.to_begin();
+                    for (std::size_t i = 0; i < idx.size(); ++i)
+                    {
+                        fct_stepper.step(i + step_dim, idx[i]);
+                        res_stepper.step(i + step_dim, idx[i]);
+                    }
+                }
+                else
+                {
+                    for (std::size_t i = 0; i < idx.size(); ++i)
+                    {
+                        fct_stepper.step(i + step_dim, idx[i]);
+                    }
+                }
+            }
+        }
+    }
+
+    template <bool simd>
+    template <class E1, class E2>
+    inline void strided_loop_assigner<simd>::run(E1& e1, const E2& e2)
+    {
+        XTENSOR_INSTRUMENT_SCOPE(instrument::event_kind::strided_loop_assign, e1, E2, instrument::assign_bytes(e1, e2));
+        bool is_row_major = true;
+        using fallback_assigner = stepper_assigner<E1, E2, default_assignable_layout(E1::static_layout)>;
+
+        if (E1::static_layout == layout_type::dynamic)
+        {
+            layout_type dynamic_layout = e1.layout();
+            switch (dynamic_layout)
+            {
+                case layout_type::row_major:
+                    is_row_major = true;
+                    break;
+                case layout_type::column_major:
+                    is_row_major = false;
+                    break;
+                default:
+                    // strided containers (e.g. padded rows) whose innermost
+                    // dimension is contiguous
+                    if (strided_assign_detail::contiguous_cut(e1, true) != e1.dimension())
+                    {
+                        is_row_major = true;
+                    }
+                    else if (strided_assign_detail::contiguous_cut(e1, false) != 0)
+                    {
+                        is_row_major = false;
+                    }
+                    else
+                    {
+                        return fallback_assigner(e1, e2).run();
+                    }
+            }
+        }
+        else if (E1::static_layout == layout_type::row_major)
+        {
+            is_row_major = true;
+        }
+        else if (E1::static_layout == layout_type::column_major)
+        {
+            is_row_major = false;
+        }
+        else
+        {
+            throw std::runtime_error("Illegal layout set (layout_type::any?).");
+        }
+
+        std::size_t inner_loop_size, outer_loop_size, cut;
+        bool splat;
+        std::tie(inner_loop_size, outer_loop_size, cut, splat) = strided_assign_detail::get_loop_sizes(e1, e2, is_row_major);
+
+        if ((is_row_major && cut == e1.dimension()) || (!is_row_major && cut == 0)) 
+        {
+            return fallback_assigner(e1, e2).run();
+        }
+
+        // TODO can we get rid of this and use `shape_type`?
+        dynamic_shape<std::size_t> idx, max_shape;
+
+        if (is_row_major)
+        {
+            xt::resize_container(idx, cut);
+            max_shape.assign(e1.shape().begin(), e1.shape().begin() + static_cast<std::ptrdiff_t>(cut));
+        }
+        else
+        {
+            xt::resize_container(idx, e1.shape().size() - cut);
+            max_shape.assign(e1.shape().begin() + static_cast<std::ptrdiff_t>(cut), e1.shape().end());
+        }
+
+        // add this when we have std::array index!
+        // std::fill(idx.begin(), idx.end(), 0);
+        using value_type = std::common_type_t<typename E1::value_type, typename E2::value_type>;
+        using simd_type = xsimd::simd_type<value_type>;
+
+        std::size_t simd_size = inner_loop_size / simd_type::size;
+        std::size_t simd_rest = inner_loop_size % simd_type::size;
+
+        auto fct_stepper = e2.stepper_begin(e1.shape());
+        auto res_stepper = e1.stepper_begin(e1.shape());
+
+        // TODO in 1D case this is ambigous -- could be RM or CM.
+        //      Use default layout to make decision
+        std::size_t step_dim = 0;
+        if (!is_row_major) // row major case
+        {
+            step_dim = cut;
+        }
+        // splatting is only enabled for row major loops
+        std::size_t leading_dim = e1.dimension() - 1;
+
+        strided_assign_detail::row_prefetcher prefetch(step_dim, idx.size(), is_row_major, inner_loop_size);
+        prefetch.add(e2, e1.shape(), false);
+        if (!E1::contiguous_layout)
+        {
+            prefetch.add(e1, e1.shape(), true);
+        }
+
+#if defined(XTENSOR_PARALLEL_ENABLED)
+        if (parallel::use_parallel(outer_loop_size * inner_loop_size))
         {
-            static constexpr bool value = detail::promote_index<typename std::decay_t<CT>::shape_type...>::value;
-        };
+            // Each chunk of the outer loop gets its own steppers, moved to the
+            // first outer index of the chunk.
+            detail::shape_divider outer_divider(max_shape);
+            parallel_for(std::size_t(0), outer_loop_size, parallel::grain(inner_loop_size),
+                         [&](std::size_t first, std::size_t last)
+            {
+                auto chunk_idx = idx;
+                auto chunk_fct_stepper = fct_stepper;
+                auto chunk_res_stepper = res_stepper;
 
-        template <class... CT>
-        struct static_trivial_broadcast<false, CT...>
+                outer_divider.unravel(first, chunk_idx, is_row_major ? layout_type::row_major : layout_type::column_major);
+
+                for (std::size_t i = 0; i < chunk_idx.size(); ++i)
+                {
+                    chunk_fct_stepper.step(i + step_dim, chunk_idx[i]);
+                    chunk_res_stepper.step(i + step_dim, chunk_idx[i]);
+                }
+
+                if (splat)
+                {
+                    strided_assign_detail::strided_loop<simd_type, E1::contiguous_layout, true>(chunk_res_stepper, chunk_fct_stepper,
+                                                                                            chunk_idx, max_shape, last - first,
+                                                                                            simd_size, simd_rest, step_dim, is_row_major,
+                                                                                            prefetch, leading_dim);
+                }
+                else
+                {
+                    strided_assign_detail::strided_loop<simd_type, E1::contiguous_layout>(chunk_res_stepper, chunk_fct_stepper,
+                                                                                      chunk_idx, max_shape, last - first,
+                                                                                      simd_size, simd_rest, step_dim, is_row_major,
+                                                                                      prefetch);
+                }
+            });
+            return;
+        }
+#endif
+        if (splat)
         {
-            static constexpr bool value = false;
-        };
+            strided_assign_detail::strided_loop<simd_type, E1::contiguous_layout, true>(res_stepper, fct_stepper, idx, max_shape,
+                                                                                    outer_loop_size, simd_size, simd_rest,
+                                                                                    step_dim, is_row_major, prefetch, leading_dim);
+        }
+        else
+        {
+            strided_assign_detail::strided_loop<simd_type, E1::contiguous_layout>(res_stepper, fct_stepper, idx, max_shape,
+                                                                              outer_loop_size, simd_size, simd_rest,
+                                                                              step_dim, is_row_major, prefetch);
+        }
     }
 
-    template <class Tag>
+    template <>
     template <class E1, class E2>
-    inline bool xexpression_assigner<Tag>::resize(E1& e1, const E2& e2)
+    inline void strided_loop_assigner<false>::run(E1& /*e1*/, const E2& /*e2*/)
     {
-        // If our RHS is not a xfunction, we know that the RHS is at least potentially trivial
-        // We check the strides of the RHS in detail::is_trivial_broadcast to see if they match up!
-        // So we can skip a shape copy and a call to broadcast_shape(...)
-        e1.resize(e2.shape());
-        return true;
     }
 
-    template <class Tag>
-    template <class E1, class F, class... CT>
-    inline bool xexpression_assigner<Tag>::resize(E1& e1, const xfunction<F, CT...>& e2)
+    /**************************************
+     * conversion_assigner implementation *
+     **************************************/
+
+    template <class E1, class E2>
+    inline bool conversion_assigner<E1, E2, std::enable_if_t<detail::use_conversion_assign<E1, E2>::value()>>::run(E1& e1, const E2& e2)
     {
-        return xtl::mpl::static_if<detail::is_fixed<typename xfunction<F, CT...>::shape_type>::value>(
-            [&](auto /*self*/) {
-                /*
-                 * If the shape of the xfunction is statically known, we can compute the broadcast triviality
-                 * at compile time plus we can resize right away.
-                 */
-                // resize in case LHS is not a fixed size container. If it is, this is a NOP
-                e1.resize(typename xfunction<F, CT...>::shape_type{});
-                return detail::static_trivial_broadcast<detail::is_fixed<typename xfunction<F, CT...>::shape_type>::value, CT...>::value;
-            },
-            /* else */ [&](auto /*self*/)
+        using source_type = typename detail::conversion_source<E2>::value_type;
+        using value_type = typename E1::value_type;
+        const source_type* src = detail::conversion_source<E2>::data(e2);
+        value_type* dst = e1.data() + e1.data_offset();
+        std::size_t n = static_cast<std::size_t>(e1.size());
+
+#if defined(XTENSOR_PARALLEL_ENABLED)
+        if (parallel::use_parallel(n))
+        {
+            constexpr std::size_t line_size = XTENSOR_CACHE_LINE_SIZE > sizeof(value_type) ?
+                                              XTENSOR_CACHE_LINE_SIZE / sizeof(value_type) : 1;
+            parallel_for(std::size_t(0), n, parallel::grain(1, line_size),
+                         [&](std::size_t first, std::size_t last)
             {
-                using index_type = xindex_type_t<typename E1::shape_type>;
-                using size_type = typename E1::size_type;
-                size_type size = e2.dimension();
-                index_type shape = xtl::make_sequence<index_type>(size, size_type(0));
-                bool trivial_broadcast = e2.broadcast_shape(shape, true);
-                e1.resize(std::move(shape));
-                return trivial_broadcast;
-            }
-        );
+                detail::convert_contiguous(src + first, dst + first, last - first);
+            });
+            return true;
+        }
+#endif
+        detail::convert_contiguous(src, dst, n);
+        return true;
     }
 
-    /***********************************
-     * stepper_assigner implementation *
-     ***********************************/
-
-    template <class E1, class E2, layout_type L>
-    inline stepper_assigner<E1, E2, L>::stepper_assigner(E1& e1, const E2& e2)
-        : m_e1(e1), m_lhs(e1.stepper_begin(e1.shape())),
-          m_rhs(e2.stepper_begin(e1.shape())),
-          m_index(xtl::make_sequence<index_type>(e1.shape().size(), size_type(0)))
-    {
-    }
+    /**********************************
+     * bitset_assigner implementation *
+     **********************************/
 
-    template <class E1, class E2, layout_type L>
-    inline void stepper_assigner<E1, E2, L>::run()
+    template <class E1, class E2>
+    inline bool bitset_assigner<E1, E2, std::enable_if_t<detail::use_bitset_assign<E1, E2>::value()>>::run(E1& e1, const E2& e2)
     {
-        using size_type = typename E1::size_type;
-        using argument_type = std::decay_t<decltype(*m_rhs)>;
-        using result_type = std::decay_t<decltype(*m_lhs)>;
-        constexpr bool is_narrowing = is_narrowing_conversion<argument_type, result_type>::value;
-
-        size_type s = m_e1.size();
-        for (size_type i = 0; i < s; ++i)
+        std::size_t size = static_cast<std::size_t>(e1.size());
+        if (!detail::bitset_source<E1>::packed(e1, size) || !detail::bitset_source<E2>::packed(e2, size))
         {
-            *m_lhs = conditional_cast<is_narrowing, result_type>(*m_rhs);
-            stepper_tools<L>::increment_stepper(*this, m_index, m_e1.shape());
+            return false;
         }
-    }
 
-    template <class E1, class E2, layout_type L>
-    inline void stepper_assigner<E1, E2, L>::step(size_type i)
-    {
-        m_lhs.step(i);
-        m_rhs.step(i);
-    }
+        auto& bits = e1.storage();
+        block_type* dst = bits.data();
+        std::size_t block_count = static_cast<std::size_t>(bits.block_count());
+        for (std::size_t i = 0; i < block_count; ++i)
+        {
+            dst[i] = block(e2, i);
+        }
 
-    template <class E1, class E2, layout_type L>
-    inline void stepper_assigner<E1, E2, L>::step(size_type i, size_type n)
-    {
-        m_lhs.step(i, n);
-        m_rhs.step(i, n);
+        // the bits past the size in the last block must remain cleared
+        constexpr std::size_t block_size = 8 * sizeof(block_type);
+        std::size_t extra_bits = size % block_size;
+        if (extra_bits != 0)
+        {
+            dst[block_count - 1] &= static_cast<block_type>((block_type(1) << extra_bits) - 1);
+        }
+        return true;
     }
 
-    template <class E1, class E2, layout_type L>
-    inline void stepper_assigner<E1, E2, L>::reset(size_type i)
+    template <class E1, class E2>
+    template <class E>
+    inline auto bitset_assigner<E1, E2, std::enable_if_t<detail::use_bitset_assign<E1, E2>::value()>>::block(const E& e, std::size_t i) noexcept
+        -> block_type
     {
-        m_lhs.reset(i);
-        m_rhs.reset(i);
+        return detail::bitset_source<E>::block(e, i);
     }
 
-    template <class E1, class E2, layout_type L>
-    inline void stepper_assigner<E1, E2, L>::to_end(layout_type l)
+    template <class E1, class E2>
+    template <class CT>
+    inline auto bitset_assigner<E1, E2, std::enable_if_t<detail::use_bitset_assign<E1, E2>::value()>>::block(const xscalar<CT>& e, std::size_t) noexcept
+        -> block_type
     {
-        m_lhs.to_end(l);
-        m_rhs.to_end(l);
+        return detail::bitset_source<xscalar<CT>>::template block<block_type>(e);
     }
 
-    /**********************************
-     * linear_assigner implementation *
-     **********************************/
-
-    template <bool simd_assign>
     template <class E1, class E2>
-    inline void linear_assigner<simd_assign>::run(E1& e1, const E2& e2)
+    inline bool bitset_assigner<E1, E2, std::enable_if_t<detail::use_bitset_pack<E1, E2>::value()>>::run(E1& e1, const E2& e2)
     {
-        using lhs_align_mode = xsimd::container_alignment_t<E1>;
-        constexpr bool is_aligned = std::is_same<lhs_align_mode, aligned_mode>::value;
-        using rhs_align_mode = std::conditional_t<is_aligned, inner_aligned_mode, unaligned_mode>;
-        using value_type = std::common_type_t<typename E1::value_type, typename E2::value_type>;
-        using simd_type = xsimd::simd_type<value_type>;
-        using size_type = typename E1::size_type;
-        size_type size = e1.size();
-        constexpr size_type simd_size = simd_type::size;
+        using block_type = typename detail::bitset_source<E1>::block_type;
+        constexpr std::size_t block_size = 8 * sizeof(block_type);
 
-        size_type align_begin = is_aligned ? 0 : xsimd::get_alignment_offset(e1.data(), size, simd_size);
-        size_type align_end = align_begin + ((size - align_begin) & ~(simd_size - 1));
-
-        for (size_type i = 0; i < align_begin; ++i)
+        std::size_t size = static_cast<std::size_t>(e1.size());
+        if (!detail::bitset_source<E1>::packed(e1, size))
         {
-            e1.data_element(i) = e2.data_element(i);
+            return false;
         }
 
-        #if defined(XTENSOR_USE_TBB)
-        tbb::parallel_for(align_begin, align_end, simd_size, [&](size_t i)
+        block_type* dst = e1.storage().data();
+        std::size_t block_count = static_cast<std::size_t>(e1.storage().block_count());
+        auto src = detail::linear_begin(e2);
+        auto pack_blocks = [&](std::size_t first, std::size_t last)
         {
-            e1.template store_simd<lhs_align_mode>(i, e2.template load_simd<rhs_align_mode, value_type>(i));
-        });
-        #else
-        for (size_type i = align_begin; i < align_end; i += simd_size)
+            auto it = src;
+            it += static_cast<std::ptrdiff_t>(first * block_size);
+            for (std::size_t b = first; b != last; ++b)
+            {
+                std::size_t n = (std::min)(block_size, size - b * block_size);
+                block_type bits = block_type(0);
+                for (std::size_t j = 0; j != n; ++j, ++it)
+                {
+                    bits |= static_cast<block_type>(static_cast<block_type>(static_cast<bool>(*it)) << j);
+                }
+                dst[b] = bits;
+            }
+        };
+
+        if (parallel::use_parallel(size))
         {
-            e1.template store_simd<lhs_align_mode>(i, e2.template load_simd<rhs_align_mode, value_type>(i));
+            parallel_for(std::size_t(0), block_count, parallel::grain(block_size), pack_blocks);
         }
-        #endif
-        for (size_type i = align_end; i < size; ++i)
+        else
         {
-            e1.data_element(i) = e2.data_element(i);
+            pack_blocks(std::size_t(0), block_count);
         }
+        return true;
     }
 
-    template <class E1, class E2>
-    inline void linear_assigner<false>::run(E1& e1, const E2& e2)
-    {
-        using is_convertible = std::is_convertible<typename std::decay_t<E2>::value_type,
-                                                   typename std::decay_t<E1>::value_type>;
-        // If the types are not compatible, this function is still instantiated but never called.
-        // To avoid compilation problems in effectively unused code trivial_assigner_run_impl is
-        // empty in this case.
-        run_impl(e1, e2, is_convertible());
-    }
+    /************************************
+     * unrolled_assigner implementation *
+     ************************************/
 
-    template <class E1, class E2>
-    inline void linear_assigner<false>::run_impl(E1& e1, const E2& e2, std::true_type /*is_convertible*/)
+    namespace unrolled_assign_detail
     {
-        using value_type = typename E1::value_type;
-        using size_type = typename E1::size_type;
-        auto src = detail::linear_begin(e2);
-        auto dst = detail::linear_begin(e1);
-        size_type n = e1.size();
+        using swallow = int[];
 
-#if defined(XTENSOR_USE_TBB)
-        tbb::parallel_for(std::ptrdiff_t(0), static_cast<std::ptrdiff_t>(n), [&](std::ptrdiff_t i)
+        template <std::size_t S, class T, class E1, class E2, std::size_t... I>
+        inline void run_batches(E1& e1, const E2& e2, std::index_sequence<I...>)
         {
-            *(dst + i) = static_cast<value_type>(*(src + i));
-        });
-#else
-        for (; n > size_type(0); --n)
+            (void) swallow{0, (e1.template store_simd<unaligned_mode>(I * S, e2.template load_simd<unaligned_mode, T>(I * S)), 0)...};
+        }
+
+        template <std::size_t B, class E1, class E2, std::size_t... I>
+        inline void run_elements(E1& e1, const E2& e2, std::index_sequence<I...>, std::true_type /*simd*/)
         {
-            *dst = static_cast<value_type>(*src);
-            ++src;
-            ++dst;
+            (void) swallow{0, (e1.data_element(B + I) = e2.data_element(B + I), 0)...};
+        }
+
+        template <std::size_t B, class E1, class E2, std::size_t... I>
+        inline void run_elements(E1& e1, const E2& e2, std::index_sequence<I...>, std::false_type /*simd*/)
+        {
+            using value_type = typename E1::value_type;
+            auto src = detail::linear_begin(e2);
+            auto dst = detail::linear_begin(e1);
+            (void) swallow{0, (static_cast<void>(I), *dst = detail::convert_element<value_type>(*src), ++src, ++dst, 0)...};
+            (void) src;
+            (void) dst;
         }
-#endif
     }
 
+    template <bool enable>
     template <class E1, class E2>
-    inline void linear_assigner<false>::run_impl(E1&, const E2&, std::false_type /*is_convertible*/)
+    inline bool unrolled_assigner<enable>::run(E1& e1, const E2& e2)
     {
-        XTENSOR_PRECONDITION(false,
-            "Internal error: linear_assigner called with unrelated types.");
+        using traits = xassign_traits<E1, E2>;
+        using value_type = std::common_type_t<typename E1::value_type, typename E2::value_type>;
+        constexpr bool simd = traits::simd_assign();
+        constexpr std::size_t size = traits::fixed_size();
+        constexpr std::size_t simd_size = simd ? xsimd::simd_type<value_type>::size : 1;
+        constexpr std::size_t n_batches = simd ? size / simd_size : 0;
+
+        unrolled_assign_detail::run_batches<simd_size, value_type>(e1, e2, std::make_index_sequence<n_batches>());
+        unrolled_assign_detail::run_elements<n_batches * simd_size>(e1, e2, std::make_index_sequence<size - n_batches * simd_size>(),
+                                                                    std::integral_constant<bool, simd>());
+        return true;
+    }
 
+    template <>
+    template <class E1, class E2>
+    inline bool unrolled_assigner<false>::run(E1& /*e1*/, const E2& /*e2*/)
+    {
+        return false;
     }
 
-    /****************************************
-     * strided_loop_assigner implementation *
-     ****************************************/
+    /*************************************
+     * transpose_assigner implementation *
+     *************************************/
 
-    namespace strided_assign_detail
+    namespace transpose_assign_detail
     {
-        template <layout_type layout>
-        struct idx_tools;
+        // largest power of two (at most 64) such that a source and a
+        // destination tile fit in the L1 cache
+        template <class T>
+        constexpr std::size_t tile_size()
+        {
+            std::size_t tile = 8;
+            while (tile < 64 && 2 * (2 * tile) * (2 * tile) * sizeof(T) <= XTENSOR_L1_CACHE_SIZE)
+            {
+                tile *= 2;
+            }
+            return tile;
+        }
 
-        template <>
-        struct idx_tools<layout_type::row_major>
+        // the unit stride of the source may be reversed (-1)
+        template <class S, class X>
+        inline std::size_t unit_stride_dimension(const S& shape, const X& strides, bool reversed)
         {
-            template <class T>
-            static void next_idx(T& outer_index, T& outer_shape)
+            for (std::size_t i = 0; i < shape.size(); ++i)
             {
-                auto i = outer_index.size();
-                for (; i > 0; --i)
+                if ((strides[i] == 1 || (reversed && strides[i] == -1)) && shape[i] != 1)
                 {
-                    if (outer_index[i - 1] + 1 >= outer_shape[i - 1])
-                    {
-                        outer_index[i - 1] = 0;
-                    }
-                    else
+                    return i;
+                }
+            }
+            return shape.size();
+        }
+
+        // Walks the dimensions other than the unit stride ones in row major
+        // order: offsets(n, offset1, offset2) computes the offsets of the
+        // n-th position in both expressions.
+        class outer_offsets
+        {
+        public:
+
+            template <class S, class X>
+            outer_offsets(const S& shape, const X& strides1, const X& strides2, std::size_t d1, std::size_t d2)
+            {
+                for (std::size_t i = 0; i < shape.size(); ++i)
+                {
+                    if (i != d1 && i != d2)
                     {
-                        outer_index[i - 1]++;
-                        break;
+                        m_shape.push_back(shape[i]);
+                        m_strides1.push_back(strides1[i]);
+                        m_strides2.push_back(strides2[i]);
+                        m_dividers.emplace_back(static_cast<std::size_t>(shape[i]));
                     }
                 }
             }
+
+            std::size_t size() const
+            {
+                return compute_size(m_shape);
+            }
+
+            void operator()(std::size_t n, std::ptrdiff_t& offset1, std::ptrdiff_t& offset2) const
+            {
+                offset1 = 0;
+                offset2 = 0;
+                for (std::size_t i = m_shape.size(); i != 0; --i)
+                {
+                    std::ptrdiff_t idx = static_cast<std::ptrdiff_t>(m_dividers[i - 1].divmod(n));
+                    offset1 += idx * m_strides1[i - 1];
+                    offset2 += idx * m_strides2[i - 1];
+                }
+            }
+
+        private:
+
+            std::vector<std::size_t> m_shape;
+            std::vector<std::ptrdiff_t> m_strides1;
+            std::vector<std::ptrdiff_t> m_strides2;
+            std::vector<detail::index_divider> m_dividers;
         };
 
-        template <>
-        struct idx_tools<layout_type::column_major>
+        // Copies the lines of a source reversed along the unit stride
+        // dimension: a plain loop over raw pointers with a decreasing source
+        // index, that the compilers vectorize with a reversal of the lanes.
+        template <class T, class E1, class E2>
+        inline void reverse_lines(E1& e1, const E2& e2, const outer_offsets& offsets, std::size_t n)
         {
-            template <class T>
-            static void next_idx(T& outer_index, T& outer_shape)
+            auto dst = e1.data() + e1.data_offset();
+            auto src = e2.data() + e2.data_offset();
+            std::ptrdiff_t last = static_cast<std::ptrdiff_t>(n) - 1;
+
+            auto copy_lines = [&](std::size_t first, std::size_t end)
             {
-                using size_type = typename T::size_type;
-                size_type i = 0;
-                auto sz = outer_index.size();
-                for (; i < sz; ++i)
+                for (std::size_t line = first; line < end; ++line)
                 {
-                    if (outer_index[i] + 1 >= outer_shape[i])
+                    std::ptrdiff_t offset1, offset2;
+                    offsets(line, offset1, offset2);
+                    auto d = dst + offset1;
+                    auto s = src + offset2 - last;
+                    for (std::ptrdiff_t i = 0; i <= last; ++i)
                     {
-                        outer_index[i] = 0;
+                        d[i] = detail::convert_element<T>(s[last - i]);
                     }
-                    else
+                }
+            };
+
+            std::size_t n_lines = offsets.size();
+#if defined(XTENSOR_PARALLEL_ENABLED)
+            if (parallel::use_parallel(n_lines * n))
+            {
+                parallel_for(std::size_t(0), n_lines, parallel::grain(n), copy_lines);
+                return;
+            }
+#endif
+            copy_lines(std::size_t(0), n_lines);
+        }
+    }
+
+    /**
+     * Returns false without assigning anything if e2 is neither a permutation
+     * of the layout of e1 nor reversed along its unit stride dimension.
+     */
+    template <bool enable>
+    template <class E1, class E2>
+    inline bool transpose_assigner<enable>::run(E1& e1, const E2& e2)
+    {
+        using value_type = typename E1::value_type;
+        using strides_type = std::vector<std::ptrdiff_t>;
+        using shape_type = std::vector<std::size_t>;
+
+        std::size_t dim = e1.dimension();
+        if (dim == 0 || e2.dimension() != dim || !std::equal(e1.shape().cbegin(), e1.shape().cend(), e2.shape().cbegin()))
+        {
+            return false;
+        }
+
+        shape_type shape(e1.shape().cbegin(), e1.shape().cend());
+        strides_type strides1(e1.strides().cbegin(), e1.strides().cend());
+        strides_type strides2(e2.strides().cbegin(), e2.strides().cend());
+        std::size_t d1 = transpose_assign_detail::unit_stride_dimension(shape, strides1, false);
+        std::size_t d2 = transpose_assign_detail::unit_stride_dimension(shape, strides2, true);
+        if (d1 == dim || d2 == dim || (d1 == d2 && strides2[d2] == 1))
+        {
+            return false;
+        }
+
+        transpose_assign_detail::outer_offsets offsets(shape, strides1, strides2, d1, d2);
+        if (d1 == d2)
+        {
+            transpose_assign_detail::reverse_lines<value_type>(e1, e2, offsets, shape[d1]);
+            return true;
+        }
+        std::size_t outer_size = offsets.size();
+
+        constexpr std::size_t tile = transpose_assign_detail::tile_size<value_type>();
+        std::size_t n1 = shape[d1];
+        std::size_t n2 = shape[d2];
+        std::ptrdiff_t dst_stride = strides1[d2];
+        std::ptrdiff_t src_stride = strides2[d1];
+        std::ptrdiff_t src_unit = strides2[d2];
+        std::size_t n_tiles = (n2 + tile - 1) / tile;
+
+        auto dst = e1.data() + e1.data_offset();
+        auto src = e2.data() + e2.data_offset();
+
+        // each work item copies a band of tile rows of the source
+        auto copy_bands = [&](std::size_t first, std::size_t last)
+        {
+            for (std::size_t item = first; item < last; ++item)
+            {
+                std::size_t first2 = (item % n_tiles) * tile;
+                std::size_t last2 = std::min(first2 + tile, n2);
+                std::ptrdiff_t offset1, offset2;
+                offsets(item / n_tiles, offset1, offset2);
+                for (std::size_t first1 = 0; first1 < n1; first1 += tile)
+                {
+                    std::size_t last1 = std::min(first1 + tile, n1);
+                    for (std::size_t i2 = first2; i2 < last2; ++i2)
                     {
-                        outer_index[i]++;
-                        break;
+                        auto d = dst + offset1 + static_cast<std::ptrdiff_t>(i2) * dst_stride;
+                        auto s = src + offset2 + static_cast<std::ptrdiff_t>(i2) * src_unit;
+                        for (std::size_t i1 = first1; i1 < last1; ++i1)
+                        {
+                            d[i1] = detail::convert_element<value_type>(s[static_cast<std::ptrdiff_t>(i1) * src_stride]);
+                        }
                     }
                 }
             }
         };
 
-        template <layout_type L, class S>
-        struct check_strides_functor
+        std::size_t n_items = outer_size * n_tiles;
+#if defined(XTENSOR_PARALLEL_ENABLED)
+        if (parallel::use_parallel(e1.size()))
         {
-            using strides_type = S;
+            parallel_for(std::size_t(0), n_items, parallel::grain(tile * n1, 1), copy_bands);
+            return true;
+        }
+#endif
+        copy_bands(std::size_t(0), n_items);
+        return true;
+    }
 
-            check_strides_functor(const S& strides)
-                : m_cut(L == layout_type::row_major ? 0 : strides.size()),
-                  m_strides(strides)
-            {
-            }
+    template <>
+    template <class E1, class E2>
+    inline bool transpose_assigner<false>::run(E1& /*e1*/, const E2& /*e2*/)
+    {
+        return false;
+    }
 
-            template <class T, layout_type LE = L>
-            std::enable_if_t<LE == layout_type::row_major, std::size_t>
-            operator()(const T& el)
+    /**************************************
+     * loop_order_assigner implementation *
+     **************************************/
+
+    namespace loop_order_detail
+    {
+        // Calls f(strides, value_size) for the destination and for each
+        // operand of an expression
+        template <class F>
+        class operand_strides_visitor
+        {
+        public:
+
+            explicit operand_strides_visitor(F& f)
+                : m_f(f)
             {
-                auto var = check_strides_overlap<layout_type::row_major>::get(m_strides, el.strides());
-                if (var > m_cut)
-                {
-                    m_cut = var;
-                }
-                return m_cut;
             }
 
-            template <class T, layout_type LE = L>
-            std::enable_if_t<LE == layout_type::column_major, std::size_t>
-            operator()(const T& el)
+            template <class T>
+            void operator()(const T& el)
             {
-                auto var = check_strides_overlap<layout_type::column_major>::get(m_strides, el.strides());
-                if (var < m_cut)
-                {
-                    m_cut = var;
-                }
-                return m_cut;
+                m_f(el.strides(), sizeof(typename T::value_type));
             }
 
             template <class T>
-            std::size_t operator()(const xt::xscalar<T>& /*el*/)
+            void operator()(const xt::xscalar<T>& /*el*/)
             {
-                return m_cut;
             }
 
-            template <class F, class... CT>
-            std::size_t operator()(const xt::xfunction<F, CT...>& xf)
+            template <class Func, class... CT>
+            void operator()(const xt::xfunction<Func, CT...>& xf)
             {
                 xt::for_each(*this, xf.arguments());
-                return m_cut;
+            }
+
+            template <class Func, class CT>
+            void operator()(const xt::xfunctor_view<Func, CT>& xf)
+            {
+                (*this)(xf.expression());
             }
 
         private:
 
-            std::size_t m_cut;
-            const strides_type& m_strides;
+            F& m_f;
         };
 
+        template <class E, class F>
+        inline void visit_operand_strides(const E& e, F& f)
+        {
+            operand_strides_visitor<F> visitor(f);
+            visitor(e);
+        }
+
+        template <class T>
+        inline std::size_t stride_size(T stride)
+        {
+            return static_cast<std::size_t>(std::abs(static_cast<std::ptrdiff_t>(stride)));
+        }
+
+        // Chooses the loop order of the assignment of e2 to e1, in the manner
+        // of the iterators of NumPy: the dimensions are sorted by decreasing
+        // cost, the sum of the strides (in bytes) of all the operands, the
+        // natural order of e1 breaking the ties. The dimensions of extent 1
+        // are left out. When an operand has a smaller stride on the second
+        // cheapest dimension than on the inner one, the layouts conflict and
+        // both dimensions are tiled. Returns false when e1 is assigned in its
+        // own order without conflict, which the other assigners handle.
         template <class E1, class E2>
-        auto get_loop_sizes(const E1& e1, const E2& e2, bool is_row_major)
+        inline bool plan_loop_order(const E1& e1, const E2& e2, std::vector<std::size_t>& outer,
+                                    std::size_t& inner, std::size_t& tiled)
         {
-            std::size_t cut = 0;
+            const auto& shape = e1.shape();
+            std::size_t dim = shape.size();
+            std::vector<std::size_t> order;
+            for (std::size_t i = 0; i < dim; ++i)
+            {
+                std::size_t d = e1.layout() == layout_type::column_major ? dim - 1 - i : i;
+                if (shape[d] == 0)
+                {
+                    return false;
+                }
+                if (shape[d] != 1)
+                {
+                    order.push_back(d);
+                }
+            }
+            if (order.size() < 2)
+            {
+                return false;
+            }
 
-            // TODO! if E1 is !contiguous --> initialize cut to sensible value!
-            if (E1::static_layout == layout_type::row_major || is_row_major)
+            bool valid = true;
+            std::vector<std::size_t> cost(dim, std::size_t(0));
+            auto add_cost = [&](const auto& strides, std::size_t value_size)
             {
-                auto csf = check_strides_functor<layout_type::row_major, decltype(e1.strides())>(e1.strides());
-                cut = csf(e2);
+                if (strides.size() != dim)
+                {
+                    valid = false;
+                    return;
+                }
+                for (std::size_t d = 0; d < dim; ++d)
+                {
+                    cost[d] += stride_size(strides[d]) * value_size;
+                }
+            };
+            visit_operand_strides(e1, add_cost);
+            visit_operand_strides(e2, add_cost);
+            if (!valid)
+            {
+                return false;
             }
-            else if (E1::static_layout == layout_type::column_major || !is_row_major)
+
+            std::size_t natural_inner = order.back();
+            std::stable_sort(order.begin(), order.end(), [&cost](std::size_t lhs, std::size_t rhs)
             {
-                auto csf = check_strides_functor<layout_type::column_major, decltype(e1.strides())>(e1.strides());
-                cut = csf(e2);
-            } // can't reach here because this would have already triggered the fallback
+                return cost[lhs] > cost[rhs];
+            });
+            inner = order.back();
+            std::size_t second = order[order.size() - 2];
 
-            using shape_value_type = typename E1::shape_type::value_type;
-            std::size_t outer_loop_size = static_cast<std::size_t>(
-                            std::accumulate(e1.shape().begin(), e1.shape().begin() + static_cast<std::ptrdiff_t>(cut),
-                                shape_value_type(1), std::multiplies<shape_value_type>{}));
-            std::size_t inner_loop_size = static_cast<std::size_t>(
-                            std::accumulate(e1.shape().begin() + static_cast<std::ptrdiff_t>(cut), e1.shape().end(),
-                                shape_value_type(1), std::multiplies<shape_value_type>{}));
+            bool conflict = false;
+            auto check_conflict = [&](const auto& strides, std::size_t /*value_size*/)
+            {
+                std::size_t s = stride_size(strides[second]);
+                conflict = conflict || (s != 0 && s < stride_size(strides[inner]));
+            };
+            visit_operand_strides(e1, check_conflict);
+            visit_operand_strides(e2, check_conflict);
+            if (inner == natural_inner && !conflict)
+            {
+                return false;
+            }
 
-            if (E1::static_layout == layout_type::column_major || !is_row_major)
+            tiled = conflict ? second : dim;
+            order.resize(order.size() - (conflict ? 2 : 1));
+            outer = std::move(order);
+            return true;
+        }
+    }
+
+    /**
+     * Returns false without assigning anything if e1 is assigned in its own
+     * order and the layouts of the operands do not conflict.
+     */
+    template <bool enable>
+    template <class E1, class E2>
+    inline bool loop_order_assigner<enable>::run(E1& e1, const E2& e2)
+    {
+        std::vector<std::size_t> outer;
+        std::size_t inner, tiled;
+        if (!loop_order_detail::plan_loop_order(e1, e2, outer, inner, tiled))
+        {
+            return false;
+        }
+
+        using lhs_stepper = typename E1::stepper;
+        using rhs_stepper = typename E2::const_stepper;
+        using argument_type = std::decay_t<decltype(*std::declval<rhs_stepper>())>;
+        using result_type = std::decay_t<decltype(*std::declval<lhs_stepper>())>;
+        // the saturating conversions include the sign changes of integers
+        constexpr bool is_narrowing = is_narrowing_conversion<argument_type, result_type>::value ||
+                                      detail::is_saturating_conversion<result_type, argument_type>::value;
+
+        const auto& shape = e1.shape();
+        std::size_t dim = shape.size();
+        std::size_t n_inner = static_cast<std::size_t>(shape[inner]);
+        std::size_t n_tiled = tiled != dim ? static_cast<std::size_t>(shape[tiled]) : std::size_t(1);
+        std::size_t tile = tiled != dim ? transpose_assign_detail::tile_size<typename E1::value_type>() : n_inner;
+
+        std::vector<std::size_t> outer_shape(outer.size());
+        for (std::size_t k = 0; k < outer.size(); ++k)
+        {
+            outer_shape[k] = static_cast<std::size_t>(shape[outer[k]]);
+        }
+        detail::shape_divider outer_divider(outer_shape);
+
+        // each work item assigns the tiles of a position of the outer dimensions
+        auto assign_outer = [&](std::size_t first, std::size_t last)
+        {
+            lhs_stepper lhs = e1.stepper_begin(shape);
+            rhs_stepper rhs = e2.stepper_begin(shape);
+            std::vector<std::size_t> idx(outer.size());
+            outer_divider.unravel(first, idx);
+            for (std::size_t k = 0; k < outer.size(); ++k)
             {
-                std::swap(outer_loop_size, inner_loop_size);
+                lhs.step(outer[k], idx[k]);
+                rhs.step(outer[k], idx[k]);
+            }
+
+            for (std::size_t item = first; item < last; ++item)
+            {
+                for (std::size_t first_t = 0; first_t < n_tiled; first_t += tile)
+                {
+                    std::size_t last_t = (std::min)(first_t + tile, n_tiled);
+                    for (std::size_t first_i = 0; first_i < n_inner; first_i += tile)
+                    {
+                        std::size_t last_i = (std::min)(first_i + tile, n_inner);
+                        for (std::size_t t = first_t; t < last_t; ++t)
+                        {
+                            // the steppers never move past the last element of a row
+                            lhs_stepper l = lhs;
+                            rhs_stepper r = rhs;
+                            if (tiled != dim)
+                            {
+                                l.step(tiled, t);
+                                r.step(tiled, t);
+                            }
+                            l.step(inner, first_i);
+                            r.step(inner, first_i);
+                            for (std::size_t i = first_i + 1; i < last_i; ++i)
+                            {
+                                *l = conditional_cast<is_narrowing, result_type>(*r);
+                                l.step(inner);
+                                r.step(inner);
+                            }
+                            *l = conditional_cast<is_narrowing, result_type>(*r);
+                        }
+                    }
+                }
+
+                for (std::size_t k = outer.size(); k != 0; --k)
+                {
+                    if (++idx[k - 1] != outer_shape[k - 1])
+                    {
+                        lhs.step(outer[k - 1]);
+                        rhs.step(outer[k - 1]);
+                        break;
+                    }
+                    idx[k - 1] = 0;
+                    lhs.reset(outer[k - 1]);
+                    rhs.reset(outer[k - 1]);
+                }
             }
+        };
 
-            return std::make_tuple(inner_loop_size, outer_loop_size, cut);
+        std::size_t outer_size = compute_size(outer_shape);
+#if defined(XTENSOR_PARALLEL_ENABLED)
+        if (parallel::use_parallel(e1.size()))
+        {
+            parallel_for(std::size_t(0), outer_size, parallel::grain(n_inner * n_tiled, 1), assign_outer);
+            return true;
         }
+#endif
+        assign_outer(std::size_t(0), outer_size);
+        return true;
     }
 
-    template <bool simd>
+    template <>
     template <class E1, class E2>
-    inline void strided_loop_assigner<simd>::run(E1& e1, const E2& e2)
+    inline bool loop_order_assigner<false>::run(E1& /*e1*/, const E2& /*e2*/)
     {
-        bool is_row_major = true;
-        using fallback_assigner = stepper_assigner<E1, E2, default_assignable_layout(E1::static_layout)>;
+        return false;
+    }
 
-        if (E1::static_layout == layout_type::dynamic)
+    /*************************************
+     * replicate_assigner implementation *
+     *************************************/
+
+    namespace detail
+    {
+        // The expression whose elements are replicated: broadcast
+        // expressions are replicated from the expression they broadcast
+        template <class E>
+        struct replicated_source
         {
-            layout_type dynamic_layout = e1.layout();
-            switch (dynamic_layout)
+            static const E& get(const E& e) noexcept
             {
-                case layout_type::row_major:
-                    is_row_major = true;
-                    break;
-                case layout_type::column_major:
-                    is_row_major = false;
-                    break;
-                default:
-                    return fallback_assigner(e1, e2).run();
+                return e;
+            }
+        };
+
+        template <class CT, class X>
+        struct replicated_source<xbroadcast<CT, X>>
+        {
+            static const auto& get(const xbroadcast<CT, X>& e) noexcept
+            {
+                return e.expression();
             }
+        };
+    }
+
+    template <class E1, class E2>
+    inline bool replicate_assigner<E1, E2, std::enable_if_t<has_data_interface<E1>::value && has_strides<E1>::value &&
+                                                            E1::contiguous_layout>>::run(E1& e1, const E2& e2)
+    {
+        using value_type = typename E1::value_type;
+        const auto& src = detail::replicated_source<E2>::get(e2);
+        const auto& shape = e1.shape();
+        std::size_t dim = shape.size();
+        std::size_t src_dim = src.dimension();
+        if (src_dim > dim)
+        {
+            return false;
         }
-        else if (E1::static_layout == layout_type::row_major)
+
+        // the leading dimensions missing in the source or of size one
+        std::size_t offset = dim - src_dim;
+        std::size_t lead = 0;
+        std::size_t n = 1;
+        while (lead != dim && (lead < offset || src.shape()[lead - offset] == 1))
         {
-            is_row_major = true;
+            n *= static_cast<std::size_t>(shape[lead]);
+            ++lead;
         }
-        else if (E1::static_layout == layout_type::column_major)
+        std::size_t block = 1;
+        for (std::size_t i = lead; i != dim; ++i)
         {
-            is_row_major = false;
+            block *= static_cast<std::size_t>(shape[i]);
         }
-        else
+        if (n < 2 || block == 0)
         {
-            throw std::runtime_error("Illegal layout set (layout_type::any?).");
+            return false;
         }
 
-        std::size_t inner_loop_size, outer_loop_size, cut;
-        std::tie(inner_loop_size, outer_loop_size, cut) = strided_assign_detail::get_loop_sizes(e1, e2, is_row_major);
-
-        if ((is_row_major && cut == e1.dimension()) || (!is_row_major && cut == 0)) 
+        dynamic_shape<std::ptrdiff_t> strides(dim);
+        compute_strides(shape, layout_type::row_major, strides);
+        for (std::size_t i = 0; i != dim; ++i)
         {
-            return fallback_assigner(e1, e2).run();
+            if (shape[i] != 1 && strides[i] != static_cast<std::ptrdiff_t>(e1.strides()[i]))
+            {
+                return false;
+            }
         }
 
-        // TODO can we get rid of this and use `shape_type`?
-        dynamic_shape<std::size_t> idx, max_shape;
-
-        if (is_row_major)
+        // the block keeps the leading dimensions of size one of the source
+        std::size_t block_dim = std::max(src_dim, dim - lead);
+        dynamic_shape<std::size_t> block_shape(block_dim, std::size_t(1));
+        for (std::size_t i = dim - block_dim; i != dim; ++i)
         {
-            xt::resize_container(idx, cut);
-            max_shape.assign(e1.shape().begin(), e1.shape().begin() + static_cast<std::ptrdiff_t>(cut));
+            if (i >= lead)
+            {
+                block_shape[i - (dim - block_dim)] = static_cast<std::size_t>(shape[i]);
+            }
         }
-        else
+
+        value_type* data = e1.data() + e1.data_offset();
+        auto it = src.template cbegin<layout_type::row_major>(block_shape);
+        for (std::size_t i = 0; i != block; ++i, ++it)
         {
-            xt::resize_container(idx, e1.shape().size() - cut);
-            max_shape.assign(e1.shape().begin() + static_cast<std::ptrdiff_t>(cut), e1.shape().end());
+            data[i] = detail::convert_element<value_type>(*it);
         }
 
-        // add this when we have std::array index!
-        // std::fill(idx.begin(), idx.end(), 0);
-        using value_type = std::common_type_t<typename E1::value_type, typename E2::value_type>;
-        using simd_type = xsimd::simd_type<value_type>;
+        auto replicate = [data, block](std::size_t first, std::size_t last)
+        {
+            for (std::size_t i = first; i != last; ++i)
+            {
+                std::copy(data, data + block, data + i * block);
+            }
+        };
+#if defined(XTENSOR_PARALLEL_ENABLED)
+        if (parallel::use_parallel(n * block))
+        {
+            parallel_for(std::size_t(1), n, parallel::grain(block, 1), replicate);
+            return true;
+        }
+#endif
+        replicate(std::size_t(1), n);
+        return true;
+    }
 
-        std::size_t simd_size = inner_loop_size / simd_type::size;
-        std::size_t simd_rest = inner_loop_size % simd_type::size;
+    /*****************************
+     * assign_all implementation *
+     *****************************/
 
-        auto fct_stepper = e2.stepper_begin(e1.shape());
-        auto res_stepper = e1.stepper_begin(e1.shape());
+    namespace fused_assign_detail
+    {
+        template <class E1, class E2>
+        struct simd_batch
+        {
+            using value_type = std::common_type_t<typename E1::value_type, typename E2::value_type>;
+            static constexpr bool enabled = xassign_traits<E1, E2>::simd_assign() ||
+                                            xassign_traits<E1, E2>::simd_linear_assign();
+            static constexpr std::size_t value = enabled ? xsimd::simd_type<value_type>::size : 0;
+        };
 
-        // TODO in 1D case this is ambigous -- could be RM or CM.
-        //      Use default layout to make decision
-        std::size_t step_dim = 0;
-        if (!is_row_major) // row major case
+        template <std::size_t N, std::size_t... M>
+        struct same_simd_size : xtl::conjunction<std::integral_constant<bool, N == M>...>
         {
-            step_dim = cut;
-        }
+        };
 
-        for (std::size_t ox = 0; ox < outer_loop_size; ++ox)
+        using swallow = int[];
+
+        template <class T1, class T2, std::size_t... I>
+        inline void linear_run(T1& e1, const T2& e2, std::index_sequence<I...>, std::true_type /*simd*/)
         {
-            for (std::size_t i = 0; i < simd_size; ++i)
+            using first_type = simd_batch<std::decay_t<std::tuple_element_t<0, T1>>,
+                                          std::decay_t<std::tuple_element_t<0, T2>>>;
+            using size_type = std::size_t;
+            constexpr size_type simd_size = first_type::value;
+            size_type size = std::get<0>(e1).size();
+            size_type align_end = size & ~(simd_size - 1);
+
+            // every operand of the batch i is loaded once for all the outputs
+            auto run_batches = [&](size_type first, size_type last)
+            {
+                for (size_type i = first * simd_size; i < last * simd_size; i += simd_size)
+                {
+                    (void) swallow{0, (std::get<I>(e1).template store_simd<unaligned_mode>(i,
+                        std::get<I>(e2).template load_simd<unaligned_mode, typename simd_batch<
+                            std::decay_t<std::tuple_element_t<I, T1>>,
+                            std::decay_t<std::tuple_element_t<I, T2>>>::value_type>(i)), 0)...};
+                }
+            };
+
+#if defined(XTENSOR_PARALLEL_ENABLED)
+            if (parallel::use_parallel(size))
             {
-                res_stepper.template store_simd<simd_type>(fct_stepper.template step_simd<simd_type>());
+                parallel_for(size_type(0), align_end / simd_size, parallel::grain(simd_size * sizeof...(I)), run_batches);
             }
-            for (std::size_t i = 0; i < simd_rest; ++i)
+            else
+#endif
             {
-                *(res_stepper) = *(fct_stepper);
-                res_stepper.step_leading();
-                fct_stepper.step_leading();
+                run_batches(size_type(0), align_end / simd_size);
             }
+            for (size_type i = align_end; i < size; ++i)
+            {
+                (void) swallow{0, (std::get<I>(e1).data_element(i) = std::get<I>(e2).data_element(i), 0)...};
+            }
+        }
 
-            is_row_major ?
-                strided_assign_detail::idx_tools<layout_type::row_major>::next_idx(idx, max_shape) :
-                strided_assign_detail::idx_tools<layout_type::column_major>::next_idx(idx, max_shape);
-
-            fct_stepper.to_begin();
+        template <class T1, class T2, std::size_t... I>
+        inline void linear_run(T1& e1, const T2& e2, std::index_sequence<I...>, std::false_type /*simd*/)
+        {
+            std::size_t size = std::get<0>(e1).size();
 
-            // need to step E1 as well if not contigous assign (e.g. view)
-            if (!E1::contiguous_layout)
+            auto run_elements = [&](std::size_t first, std::size_t last)
             {
-                res_stepper.to_begin();
-                for (std::size_t i = 0; i < idx.size(); ++i)
+                auto src = std::make_tuple((detail::linear_begin(std::get<I>(e2)) + static_cast<std::ptrdiff_t>(first))...);
+                auto dst = std::make_tuple((detail::linear_begin(std::get<I>(e1)) + static_cast<std::ptrdiff_t>(first))...);
+                for (std::size_t i = first; i < last; ++i)
                 {
-                    fct_stepper.step(i + step_dim, idx[i]);
-                    res_stepper.step(i + step_dim, idx[i]);
+                    (void) swallow{0, (*std::get<I>(dst) = detail::convert_element<typename std::decay_t<std::tuple_element_t<I, T1>>::value_type>(*std::get<I>(src)),
+                                       ++std::get<I>(src), ++std::get<I>(dst), 0)...};
                 }
+            };
+
+#if defined(XTENSOR_PARALLEL_ENABLED)
+            if (parallel::use_parallel(size))
+            {
+                using value_type = typename std::decay_t<std::tuple_element_t<0, T1>>::value_type;
+                constexpr std::size_t line_size = XTENSOR_CACHE_LINE_SIZE > sizeof(value_type) ?
+                                                  XTENSOR_CACHE_LINE_SIZE / sizeof(value_type) : 1;
+                parallel_for(std::size_t(0), size, parallel::grain(sizeof...(I), line_size), run_elements);
+                return;
+            }
+#endif
+            run_elements(std::size_t(0), size);
+        }
+
+        template <class E1, class E2>
+        inline bool resize(E1& e1, const E2& e2)
+        {
+            using shape_type = typename E1::shape_type;
+            using size_type = typename E1::size_type;
+            shape_type shape = xtl::make_sequence<shape_type>(e2.dimension(), size_type(0));
+            bool trivial_broadcast = e2.broadcast_shape(shape, true);
+            e1.resize(std::move(shape));
+            return trivial_broadcast;
+        }
+
+        template <class... E1, class... E2, std::size_t... I>
+        inline void run(std::tuple<E1&...>& e1, const std::tuple<const E2&...>& e2, std::index_sequence<I...> seq)
+        {
+            std::array<bool, sizeof...(I)> trivial = {{resize(std::get<I>(e1), std::get<I>(e2))...}};
+            std::size_t size = std::get<0>(e1).size();
+            bool fused = true;
+            (void) swallow{0, (fused = fused && trivial[I] && std::get<I>(e1).size() == size &&
+                                       detail::is_linear_assign(std::get<I>(e1), std::get<I>(e2)), 0)...};
+
+            if (fused)
+            {
+                constexpr bool simd = xtl::conjunction<std::integral_constant<bool, (simd_batch<E1, E2>::value > 1)>...>::value &&
+                                      same_simd_size<simd_batch<E1, E2>::value...>::value;
+                linear_run(e1, e2, seq, std::integral_constant<bool, simd>());
             }
             else
             {
-                for (std::size_t i = 0; i < idx.size(); ++i)
-                {
-                    fct_stepper.step(i + step_dim, idx[i]);
-                }
+                (void) swallow{0, (assign_data(std::get<I>(e1), std::get<I>(e2), trivial[I]), 0)...};
             }
         }
     }
 
-    template <>
+    /**
+     * @brief Assigns several expressions in a single pass.
+     *
+     * Each expression of \c e2 is assigned to the corresponding expression of
+     * \c e1, which is resized to its shape. When all the results have the same
+     * size and can be assigned linearly, they are computed in the same loop,
+     * so that the operands shared by several expressions are read only once:
+     *
+     * \code{.cpp}
+     * xt::assign_all(std::tie(x, y), a + b, a * b);
+     * \endcode
+     *
+     * Otherwise the expressions are assigned one after the other. As with
+     * \ref noalias, the results must not alias the operands.
+     *
+     * @param e1 the expressions to assign to, usually built with std::tie
+     * @param e2 the expressions to assign
+     */
+    template <class... E1, class... E2>
+    inline void assign_all(std::tuple<E1&...> e1, const xexpression<E2>&... e2)
+    {
+        static_assert(sizeof...(E1) == sizeof...(E2), "assign_all requires as many results as expressions");
+        static_assert(sizeof...(E1) != 0, "assign_all requires at least one expression");
+        std::tuple<const E2&...> de2(e2.derived_cast()...);
+        fused_assign_detail::run(e1, de2, std::make_index_sequence<sizeof...(E2)>());
+    }
+
+    /*******************************
+     * xassign_plan implementation *
+     *******************************/
+
+    /**
+     * Resizes \c e1 to the shape of \c e2 and computes the assignment
+     * decisions of the pair.
+     */
     template <class E1, class E2>
-    inline void strided_loop_assigner<false>::run(E1& /*e1*/, const E2& /*e2*/)
+    inline xassign_plan<E1, E2>::xassign_plan(E1& e1, const E2& e2)
+    {
+        using shape_type = typename E1::shape_type;
+        using size_type = typename E1::size_type;
+        shape_type shape = xtl::make_sequence<shape_type>(e2.dimension(), size_type(0));
+        m_trivial = e2.broadcast_shape(shape, true);
+        e1.resize(std::move(shape));
+        m_linear = m_trivial && detail::is_linear_assign(e1, e2);
+    }
+
+    /**
+     * Assigns \c e2 to \c e1 with the decisions of the plan.
+     */
+    template <class E1, class E2>
+    inline void xassign_plan<E1, E2>::run(E1& e1, const E2& e2) const
+    {
+        XTENSOR_ASSERT(e1.dimension() == e2.dimension() &&
+                       std::equal(e1.shape().cbegin(), e1.shape().cend(), e2.shape().cbegin()));
+        xexpression_assigner_base<xtensor_expression_tag>::assign_data(e1, e2, m_trivial, m_linear);
+    }
+
+    /**
+     * Returns true if the broadcasting of the assignment is trivial.
+     */
+    template <class E1, class E2>
+    inline bool xassign_plan<E1, E2>::trivial_broadcast() const noexcept
+    {
+        return m_trivial;
+    }
+
+    /**
+     * Returns true if the assignment goes through the linear assigner.
+     */
+    template <class E1, class E2>
+    inline bool xassign_plan<E1, E2>::linear_assign() const noexcept
+    {
+        return m_linear;
+    }
+
+    /**
+     * @brief Builds an assignment plan from \c e1 and \c e2.
+     *
+     * \code{.cpp}
+     * auto plan = xt::make_assign_plan(res[0], a[0] + b[0]);
+     * for (std::size_t i = 0; i < res.size(); ++i)
+     * {
+     *     plan.run(res[i], a[i] + b[i]);
+     * }
+     * \endcode
+     *
+     * @param e1 the expression to assign to, resized to the shape of \c e2
+     * @param e2 the assigned expression
+     */
+    template <class E1, class E2>
+    inline xassign_plan<E1, E2> make_assign_plan(xexpression<E1>& e1, const xexpression<E2>& e2)
     {
+        return xassign_plan<E1, E2>(e1.derived_cast(), e2.derived_cast());
     }
 }
 
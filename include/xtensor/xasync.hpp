@@ -0,0 +1,124 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_ASYNC_HPP
+#define XTENSOR_ASYNC_HPP
+
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "xeval.hpp"
+#include "xexpression.hpp"
+#include "xparallel.hpp"
+
+namespace xt
+{
+    /**
+     * @defgroup async_functions Asynchronous evaluation
+     *
+     * The asynchronous functions evaluate an expression in a task run by
+     * parallel::launch, and return a std::future that becomes ready when the
+     * evaluation completes, or holds the exception it threw. The expression
+     * is moved or copied into the task, so that the temporaries it holds by
+     * value live until completion; the containers it refers to, like the
+     * lvalue operands of an operator, must outlive the future, unless they
+     * are shared with make_xshared.
+     */
+
+    namespace detail
+    {
+        template <class R, class F>
+        inline std::future<R> launch_async(F&& f)
+        {
+            auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+            std::future<R> res = task->get_future();
+            // the task runs with the parallel settings and the instruction
+            // set of the launching thread
+            parallel::settings_type settings = parallel::settings();
+            cpu::isa selected = cpu::selected_isa();
+            parallel::launch([task, settings, selected]()
+            {
+                parallel::scoped_settings guard(settings.min_size, settings.grain_size);
+                cpu::scoped_isa isa_guard(selected);
+                (*task)();
+            });
+            return res;
+        }
+
+        // destination of async_assign: a reference to an lvalue container or
+        // view, or a copy of a proxy such as the result of noalias
+        template <class T>
+        struct async_target
+        {
+            T target;
+        };
+    }
+
+    /**
+     * @ingroup async_functions
+     * Type of the container holding the result of eval_async(e).
+     */
+    template <class E>
+    using async_eval_type_t = std::decay_t<decltype(eval(std::declval<std::decay_t<E>>()))>;
+
+    /**
+     * @ingroup async_functions
+     * @brief Evaluates an expression asynchronously.
+     *
+     * \code{.cpp}
+     * xt::xarray<double> a = ...;
+     * auto f = xt::eval_async(xt::exp(a) * 2.);
+     * receive_next_message();      // runs while the expression is evaluated
+     * xt::xarray<double> res = f.get();
+     * \endcode
+     *
+     * @param e the expression to evaluate, moved or copied into the task
+     * @return a future holding the container returned by xt::eval
+     */
+    template <class E, typename std::enable_if_t<is_xexpression<std::decay_t<E>>::value, int> = 0>
+    inline std::future<async_eval_type_t<E>> eval_async(E&& e)
+    {
+        using result_type = async_eval_type_t<E>;
+        using expression_type = std::decay_t<E>;
+        return detail::launch_async<result_type>([expr = expression_type(std::forward<E>(e))]() mutable -> result_type {
+            return result_type(std::move(expr));
+        });
+    }
+
+    /**
+     * @ingroup async_functions
+     * @brief Assigns an expression to a container or a view asynchronously.
+     *
+     * out = e is evaluated in a task; out may also be the result of noalias.
+     * Neither out nor the containers that e refers to may be accessed by
+     * other threads before the future is ready.
+     *
+     * \code{.cpp}
+     * auto done = xt::async_assign(xt::noalias(out), a + b);
+     * send(previous_result);
+     * done.get();                  // rethrows the exception of the assignment, if any
+     * \endcode
+     *
+     * @param out the destination, which must outlive the future
+     * @param e the expression to assign, moved or copied into the task
+     * @return a future that is ready once the assignment completes
+     */
+    template <class E1, class E2, typename std::enable_if_t<is_xexpression<std::decay_t<E2>>::value, int> = 0>
+    inline std::future<void> async_assign(E1&& out, E2&& e)
+    {
+        using expression_type = std::decay_t<E2>;
+        return detail::launch_async<void>([dst = detail::async_target<E1>{ std::forward<E1>(out) },
+                                           expr = expression_type(std::forward<E2>(e))]() mutable {
+            dst.target = expr;
+        });
+    }
+}
+
+#endif
@@ -9,8 +9,13 @@
 #ifndef XTENSOR_AXIS_ITERATOR_HPP
 #define XTENSOR_AXIS_ITERATOR_HPP
 
+#include <cstddef>
+#include <stdexcept>
+
 #include <xtl/xclosure.hpp>
 
+#include "xparallel.hpp"
+#include "xstrided_view.hpp"
 #include "xview.hpp"
 
 namespace xt
@@ -83,6 +88,9 @@ namespace xt
     template <class E>
     auto axis_end(E&& e);
 
+    template <class E, class F>
+    void parallel_for_each_axis(E&& e, std::size_t axis, F&& f);
+
     /*********************************
      * xaxis_iterator implementation *
      *********************************/
@@ -192,6 +200,111 @@ namespace xt
         using size_type = typename std::decay_t<E>::size_type;
         return return_type(std::forward<E>(e), size_type(e.shape()[0]));
     }
+
+    /*****************************************
+     * parallel_for_each_axis implementation *
+     *****************************************/
+
+    namespace detail
+    {
+        // The slices keep the layout of the expression when they are
+        // made of its outermost index (according to that layout).
+        inline layout_type axis_slice_layout(layout_type l, std::size_t axis, std::size_t dim) noexcept
+        {
+            bool outer = (l == layout_type::row_major && axis == 0) ||
+                         (l == layout_type::column_major && axis + 1 == dim);
+            return outer ? l : layout_type::dynamic;
+        }
+
+        template <class E>
+        inline layout_type axis_slice_layout(const E& e, std::size_t axis) noexcept
+        {
+            layout_type l = has_data_interface<std::decay_t<E>>::value ? e.layout() : XTENSOR_DEFAULT_LAYOUT;
+            return axis_slice_layout(l, axis, e.dimension());
+        }
+    }
+
+    /**
+     * Calls \em f on each slice of \em e along \em axis. The slices are
+     * strided views of dimension ``e.dimension() - 1``, as the views of an
+     * xaxis_iterator along axis 0. They are split into chunks that may be
+     * processed concurrently (see parallel_for); each chunk builds a single
+     * view and moves it from one slice to the next by changing its offset,
+     * instead of building a view, with its own shape and strides, per slice.
+     * Hence \em f must not keep a reference to the view after it returns,
+     * and must be safe to call concurrently for different slices.
+     *
+     * \code{.cpp}
+     * xt::xarray<double> a = xt::random::rand<double>({1000, 3, 3});
+     * // normalizes each 3 x 3 matrix by its maximum
+     * xt::parallel_for_each_axis(a, 0, [](auto& s) { s /= xt::amax(s)(); });
+     * \endcode
+     *
+     * @param e the expression whose slices are visited
+     * @param axis the axis along which the slices are taken
+     * @param f the function called with each slice
+     */
+    template <class E, class F>
+    inline void parallel_for_each_axis(E&& e, std::size_t axis, F&& f)
+    {
+        using expression_type = std::remove_reference_t<E>;
+        using shape_type = dynamic_shape<std::size_t>;
+        using strides_type = get_strides_t<shape_type>;
+        using view_type = xstrided_view<xclosure_t<expression_type&>, shape_type>;
+
+        expression_type& ex = e;
+        std::size_t dim = ex.dimension();
+        if (axis >= dim)
+        {
+            throw std::runtime_error("parallel_for_each_axis: axis out of bounds");
+        }
+
+        const auto& e_strides = detail::get_strides(ex);
+        shape_type shape(dim - 1);
+        strides_type strides(dim - 1);
+        for (std::size_t i = 0, j = 0; i < dim; ++i)
+        {
+            if (i != axis)
+            {
+                shape[j] = static_cast<std::size_t>(ex.shape()[i]);
+                strides[j] = static_cast<std::ptrdiff_t>(e_strides[i]);
+                ++j;
+            }
+        }
+        std::size_t n = static_cast<std::size_t>(ex.shape()[axis]);
+        std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(detail::get_offset(ex));
+        std::ptrdiff_t axis_stride = static_cast<std::ptrdiff_t>(e_strides[axis]);
+        layout_type l = detail::axis_slice_layout(ex, axis);
+
+        auto visit = [&](std::size_t first, std::size_t last) {
+            auto slice_offset = [&](std::size_t i) {
+                return static_cast<std::size_t>(offset + static_cast<std::ptrdiff_t>(i) * axis_stride);
+            };
+            shape_type sh(shape);
+            strides_type str(strides);
+            view_type v(ex, std::move(sh), std::move(str), slice_offset(first), l);
+            f(v);
+            for (std::size_t i = first + 1; i < last; ++i)
+            {
+                v.reset_offset(slice_offset(i));
+                f(v);
+            }
+        };
+
+        if (n == 0)
+        {
+            return;
+        }
+        std::size_t slice_size = ex.size() / n;
+        if (parallel::use_parallel(ex.size()))
+        {
+            parallel_for(std::size_t(0), n, parallel::grain(slice_size), visit);
+        }
+        else
+        {
+            visit(std::size_t(0), n);
+        }
+    }
 }
 
 #endif
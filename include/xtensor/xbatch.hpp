@@ -0,0 +1,252 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_BATCH_HPP
+#define XTENSOR_BATCH_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#include "xfixed.hpp"
+#include "xshape.hpp"
+#include "xtensor.hpp"
+#include "xview.hpp"
+
+namespace xt
+{
+    /**********************
+     * xbatch declaration *
+     **********************/
+
+    /**
+     * @class xbatch
+     * @brief Batch of small tensors of the same fixed shape, stored in
+     * structure of arrays layout.
+     *
+     * The batch holds its elements in a tensor whose last dimension is the
+     * index of the slot: the same element of all the slots is contiguous, so
+     * that element-wise expressions of whole batches or of components (see
+     * \ref component) are vectorized across the slots. \ref operator[] still
+     * gives a view of a slot with the shape of \c E.
+     *
+     * \code{.cpp}
+     * xt::xbatch<xt::xtensor_fixed<double, xt::xshape<3, 3>>> a(n), b(n), c(n);
+     * c.tensor() = a.tensor() * b.tensor();
+     * auto trace = xt::eval(a.component(0, 0) + a.component(1, 1) + a.component(2, 2));
+     * a[5] = xt::eye(3);
+     * \endcode
+     *
+     * @tparam E the type of the tensors of the batch, an xtensor_fixed
+     */
+    template <class E>
+    class xbatch
+    {
+    public:
+
+        using slot_type = E;
+        using slot_shape_type = typename E::shape_type;
+        using value_type = typename E::value_type;
+        using size_type = std::size_t;
+
+        static constexpr std::size_t slot_dimension = slot_shape_type::size();
+        using tensor_type = xtensor<value_type, slot_dimension + 1>;
+        using reference = typename tensor_type::reference;
+        using const_reference = typename tensor_type::const_reference;
+
+        static_assert(detail::is_fixed<slot_shape_type>::value, "xbatch requires tensors of fixed shape");
+
+        xbatch();
+        explicit xbatch(size_type size);
+
+        size_type size() const noexcept;
+        void resize(size_type size);
+
+        auto operator[](size_type i);
+        auto operator[](size_type i) const;
+
+        template <class... Idx>
+        reference operator()(size_type i, Idx... idx);
+        template <class... Idx>
+        const_reference operator()(size_type i, Idx... idx) const;
+
+        slot_type get(size_type i) const;
+
+        template <class... Idx>
+        auto component(Idx... idx);
+        template <class... Idx>
+        auto component(Idx... idx) const;
+
+        tensor_type& tensor() noexcept;
+        const tensor_type& tensor() const noexcept;
+
+    private:
+
+        template <class T, std::size_t... K>
+        static auto slot_view(T& t, size_type i, std::index_sequence<K...>);
+
+        std::array<size_type, slot_dimension + 1> tensor_shape(size_type size) const;
+
+        tensor_type m_tensor;
+    };
+
+    /*************************
+     * xbatch implementation *
+     *************************/
+
+    template <class E>
+    constexpr std::size_t xbatch<E>::slot_dimension;
+
+    /**
+     * Builds an empty batch.
+     */
+    template <class E>
+    inline xbatch<E>::xbatch()
+        : m_tensor(tensor_shape(0))
+    {
+    }
+
+    /**
+     * Builds a batch of \c size slots, whose elements are not initialized.
+     */
+    template <class E>
+    inline xbatch<E>::xbatch(size_type size)
+        : m_tensor(tensor_shape(size))
+    {
+    }
+
+    /**
+     * Returns the number of slots of the batch.
+     */
+    template <class E>
+    inline auto xbatch<E>::size() const noexcept -> size_type
+    {
+        return m_tensor.shape()[slot_dimension];
+    }
+
+    /**
+     * Resizes the batch to \c size slots. The elements are not preserved.
+     */
+    template <class E>
+    inline void xbatch<E>::resize(size_type size)
+    {
+        m_tensor.resize(tensor_shape(size));
+    }
+
+    /**
+     * Returns a view of the slot \c i, with the shape of \c E.
+     */
+    template <class E>
+    inline auto xbatch<E>::operator[](size_type i)
+    {
+        return slot_view(m_tensor, i, std::make_index_sequence<slot_dimension>());
+    }
+
+    /**
+     * Returns a constant view of the slot \c i, with the shape of \c E.
+     */
+    template <class E>
+    inline auto xbatch<E>::operator[](size_type i) const
+    {
+        return slot_view(m_tensor, i, std::make_index_sequence<slot_dimension>());
+    }
+
+    /**
+     * Returns a reference to the element at the index \c idx of the slot \c i.
+     */
+    template <class E>
+    template <class... Idx>
+    inline auto xbatch<E>::operator()(size_type i, Idx... idx) -> reference
+    {
+        return m_tensor(idx..., i);
+    }
+
+    /**
+     * Returns a constant reference to the element at the index \c idx of
+     * the slot \c i.
+     */
+    template <class E>
+    template <class... Idx>
+    inline auto xbatch<E>::operator()(size_type i, Idx... idx) const -> const_reference
+    {
+        return m_tensor(idx..., i);
+    }
+
+    /**
+     * Returns a copy of the slot \c i.
+     */
+    template <class E>
+    inline auto xbatch<E>::get(size_type i) const -> slot_type
+    {
+        return slot_type((*this)[i]);
+    }
+
+    /**
+     * Returns a contiguous one-dimensional view of the element at the index
+     * \c idx of all the slots.
+     */
+    template <class E>
+    template <class... Idx>
+    inline auto xbatch<E>::component(Idx... idx)
+    {
+        static_assert(sizeof...(Idx) == slot_dimension, "component requires an index of each dimension of the slots");
+        return view(m_tensor, idx..., all());
+    }
+
+    /**
+     * Returns a constant contiguous one-dimensional view of the element at
+     * the index \c idx of all the slots.
+     */
+    template <class E>
+    template <class... Idx>
+    inline auto xbatch<E>::component(Idx... idx) const
+    {
+        static_assert(sizeof...(Idx) == slot_dimension, "component requires an index of each dimension of the slots");
+        return view(m_tensor, idx..., all());
+    }
+
+    /**
+     * Returns the tensor holding the elements, whose last dimension is the
+     * index of the slots.
+     */
+    template <class E>
+    inline auto xbatch<E>::tensor() noexcept -> tensor_type&
+    {
+        return m_tensor;
+    }
+
+    /**
+     * Returns the constant tensor holding the elements, whose last
+     * dimension is the index of the slots.
+     */
+    template <class E>
+    inline auto xbatch<E>::tensor() const noexcept -> const tensor_type&
+    {
+        return m_tensor;
+    }
+
+    template <class E>
+    template <class T, std::size_t... K>
+    inline auto xbatch<E>::slot_view(T& t, size_type i, std::index_sequence<K...>)
+    {
+        return view(t, (static_cast<void>(K), all())..., i);
+    }
+
+    template <class E>
+    inline auto xbatch<E>::tensor_shape(size_type size) const -> std::array<size_type, slot_dimension + 1>
+    {
+        std::array<size_type, slot_dimension + 1> shape;
+        slot_shape_type slot_shape;
+        std::copy(slot_shape.begin(), slot_shape.end(), shape.begin());
+        shape[slot_dimension] = size;
+        return shape;
+    }
+}
+
+#endif
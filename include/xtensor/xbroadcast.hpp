@@ -116,6 +116,7 @@ namespace xt
         using const_pointer = typename xexpression_type::const_pointer;
         using size_type = typename xexpression_type::size_type;
         using difference_type = typename xexpression_type::difference_type;
+        using simd_value_type = xsimd::simd_type<value_type>;
 
         using iterable_base = xconst_iterable<self_type>;
         using inner_shape_type = typename iterable_base::inner_shape_type;
@@ -178,6 +179,25 @@ namespace xt
         template <class E>
         rebind_t<E> build_broadcast(E&& e) const;
 
+        //
+        // SIMD interface, only valid when has_linear_assign returns true,
+        // i.e. when the expression is not broadcast
+        //
+
+        template <class requested_type>
+        using simd_return_type = xsimd::simd_return_type<value_type, requested_type>;
+
+        template <class T, class R>
+        using enable_simd_interface = std::enable_if_t<has_simd_interface<T>::value, R>;
+
+        template <class align, class requested_type = value_type,
+                  std::size_t N = xsimd::simd_traits<requested_type>::size,
+                  class T = xexpression_type>
+        enable_simd_interface<T, simd_return_type<requested_type>> load_simd(size_type i) const;
+
+        template <class T = xexpression_type>
+        enable_simd_interface<T, const_reference> data_element(size_type i) const;
+
     private:
 
         CT m_e;
@@ -481,6 +501,20 @@ namespace xt
     {
         return rebind_t<E>(std::forward<E>(e), inner_shape_type(m_shape));
     }
+
+    template <class CT, class X>
+    template <class align, class requested_type, std::size_t N, class T>
+    inline auto xbroadcast<CT, X>::load_simd(size_type i) const -> enable_simd_interface<T, simd_return_type<requested_type>>
+    {
+        return m_e.template load_simd<align, requested_type>(i);
+    }
+
+    template <class CT, class X>
+    template <class T>
+    inline auto xbroadcast<CT, X>::data_element(size_type i) const -> enable_simd_interface<T, const_reference>
+    {
+        return m_e.data_element(i);
+    }
 }
 
 #endif
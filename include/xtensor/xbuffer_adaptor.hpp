@@ -10,6 +10,7 @@
 #define XTENSOR_BUFFER_ADAPTOR_HPP
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
 #include <iterator>
 #include <memory>
@@ -33,6 +34,35 @@ namespace xt
     {
     };
 
+    struct shared_ownership
+    {
+    };
+
+    /**
+     * @class external_ownership
+     * @brief Ownership policy for buffers released by a custom function.
+     *
+     * The policy holds a type-erased handle on the buffer, e.g. a memory
+     * pool block, a mapped file or a buffer of another library. Adaptors
+     * created with this policy share the handle, and the buffer is released
+     * when the last of them is destroyed.
+     */
+    class external_ownership
+    {
+    public:
+
+        explicit external_ownership(std::shared_ptr<void> handle) noexcept;
+
+        template <class F, class = std::enable_if_t<!std::is_convertible<F, std::shared_ptr<void>>::value>>
+        explicit external_ownership(F&& release);
+
+        const std::shared_ptr<void>& handle() const noexcept;
+
+    private:
+
+        std::shared_ptr<void> m_handle;
+    };
+
     template <class CP, class O = no_ownership, class A = std::allocator<std::remove_pointer_t<std::remove_reference_t<CP>>>>
     class xbuffer_adaptor;
 
@@ -130,6 +160,107 @@ namespace xt
             allocator_type m_allocator;
         };
 
+        template <class CP, class A>
+        class xbuffer_shared_storage
+        {
+        public:
+
+            using self_type = xbuffer_shared_storage<CP, A>;
+            using allocator_type = A;
+            using value_type = typename allocator_type::value_type;
+            using reference = std::conditional_t<std::is_const<std::remove_pointer_t<std::remove_reference_t<CP>>>::value,
+                                  typename allocator_type::const_reference,
+                                  typename allocator_type::reference>;
+            using const_reference = typename allocator_type::const_reference;
+            using pointer = std::conditional_t<std::is_const<std::remove_pointer_t<std::remove_reference_t<CP>>>::value,
+                                  typename allocator_type::const_pointer,
+                                  typename allocator_type::pointer>;
+            using const_pointer = typename allocator_type::const_pointer;
+            using size_type = typename allocator_type::size_type;
+            using difference_type = typename allocator_type::difference_type;
+
+            xbuffer_shared_storage() = default;
+
+            template <class P>
+            xbuffer_shared_storage(P&& data, size_type size, const allocator_type& alloc = allocator_type());
+
+            xbuffer_shared_storage(size_type size, const value_type& value, const allocator_type& alloc = allocator_type());
+
+            size_type size() const noexcept;
+            void resize(size_type size);
+
+            pointer data();
+            const_pointer data() const noexcept;
+
+            long use_count() const noexcept;
+
+            allocator_type get_allocator() const noexcept;
+
+            void swap(self_type& rhs) noexcept;
+
+        private:
+
+            using buffer_pointer = typename allocator_type::pointer;
+
+            struct shared_buffer
+            {
+                shared_buffer(buffer_pointer data, size_type size, const allocator_type& alloc);
+                ~shared_buffer();
+
+                buffer_pointer p_data;
+                size_type m_size;
+                allocator_type m_allocator;
+            };
+
+            using buffer_type = std::shared_ptr<shared_buffer>;
+
+            buffer_type make_buffer(size_type size);
+            void detach();
+
+            buffer_type p_buffer;
+            allocator_type m_allocator;
+        };
+
+        template <class CP, class A>
+        class xbuffer_external_storage
+        {
+        public:
+
+            using self_type = xbuffer_external_storage<CP, A>;
+            using allocator_type = A;
+            using value_type = typename allocator_type::value_type;
+            using reference = std::conditional_t<std::is_const<std::remove_pointer_t<std::remove_reference_t<CP>>>::value,
+                                  typename allocator_type::const_reference,
+                                  typename allocator_type::reference>;
+            using const_reference = typename allocator_type::const_reference;
+            using pointer = std::conditional_t<std::is_const<std::remove_pointer_t<std::remove_reference_t<CP>>>::value,
+                                  typename allocator_type::const_pointer,
+                                  typename allocator_type::pointer>;
+            using const_pointer = typename allocator_type::const_pointer;
+            using size_type = typename allocator_type::size_type;
+            using difference_type = typename allocator_type::difference_type;
+
+            xbuffer_external_storage();
+
+            template <class P>
+            xbuffer_external_storage(P&& data, size_type size, const external_ownership& ownership,
+                                     const allocator_type& alloc = allocator_type());
+
+            size_type size() const noexcept;
+            void resize(size_type size);
+
+            pointer data() noexcept;
+            const_pointer data() const noexcept;
+
+            void swap(self_type& rhs) noexcept;
+
+        private:
+
+            pointer p_data;
+            size_type m_size;
+            std::shared_ptr<void> m_handle;
+        };
+
         template <class CP, class A, class O>
         struct get_buffer_storage
         {
@@ -142,6 +273,18 @@ namespace xt
             using type = xbuffer_owner_storage<CP, A>;
         };
 
+        template <class CP, class A>
+        struct get_buffer_storage<CP, A, shared_ownership>
+        {
+            using type = xbuffer_shared_storage<CP, A>;
+        };
+
+        template <class CP, class A>
+        struct get_buffer_storage<CP, A, external_ownership>
+        {
+            using type = xbuffer_external_storage<CP, A>;
+        };
+
         template <class CP, class A, class O>
         using buffer_storage_t = typename get_buffer_storage<CP, A, O>::type;
     }
@@ -171,9 +314,14 @@ namespace xt
 
         xbuffer_adaptor() = default;
 
-        template <class P>
+        template <class P, class = std::enable_if_t<!std::is_integral<std::decay_t<P>>::value>>
         xbuffer_adaptor(P&& data, size_type size, const allocator_type& alloc = allocator_type());
 
+        xbuffer_adaptor(size_type size, const value_type& value, const allocator_type& alloc = allocator_type());
+
+        template <class P>
+        xbuffer_adaptor(P&& data, size_type size, const O& ownership, const allocator_type& alloc = allocator_type());
+
         ~xbuffer_adaptor() = default;
 
         xbuffer_adaptor(const self_type&) = default;
@@ -215,6 +363,8 @@ namespace xt
 
         using base_type::data;
         using base_type::swap;
+
+        long use_count() const noexcept;
     };
 
     template <class CP, class O, class A>
@@ -428,17 +578,273 @@ namespace xt
         }
     }
 
+    /*************************************
+     * external_ownership implementation *
+     *************************************/
+
+    /**
+     * Builds an ownership policy keeping \c handle alive as long as the
+     * buffer is adapted.
+     */
+    inline external_ownership::external_ownership(std::shared_ptr<void> handle) noexcept
+        : m_handle(std::move(handle))
+    {
+    }
+
+    /**
+     * Builds an ownership policy calling \c release() when the buffer is
+     * not adapted anymore.
+     */
+    template <class F, class>
+    inline external_ownership::external_ownership(F&& release)
+        : m_handle(nullptr, [release = std::forward<F>(release)](void*) mutable { release(); })
+    {
+    }
+
+    inline const std::shared_ptr<void>& external_ownership::handle() const noexcept
+    {
+        return m_handle;
+    }
+
+    /*******************************************
+     * xbuffer_external_storage implementation *
+     *******************************************/
+
+    namespace detail
+    {
+        template <class CP, class A>
+        inline xbuffer_external_storage<CP, A>::xbuffer_external_storage()
+            : p_data(nullptr), m_size(0)
+        {
+        }
+
+        template <class CP, class A>
+        template <class P>
+        inline xbuffer_external_storage<CP, A>::xbuffer_external_storage(P&& data, size_type size,
+                                                                         const external_ownership& ownership,
+                                                                         const allocator_type&)
+            : p_data(std::forward<P>(data)), m_size(size), m_handle(ownership.handle())
+        {
+        }
+
+        template <class CP, class A>
+        inline auto xbuffer_external_storage<CP, A>::size() const noexcept -> size_type
+        {
+            return m_size;
+        }
+
+        template <class CP, class A>
+        inline void xbuffer_external_storage<CP, A>::resize(size_type size)
+        {
+            if (size != m_size)
+            {
+                throw std::runtime_error("xbuffer_external_storage not resizable");
+            }
+        }
+
+        template <class CP, class A>
+        inline auto xbuffer_external_storage<CP, A>::data() noexcept -> pointer
+        {
+            return p_data;
+        }
+
+        template <class CP, class A>
+        inline auto xbuffer_external_storage<CP, A>::data() const noexcept -> const_pointer
+        {
+            return p_data;
+        }
+
+        template <class CP, class A>
+        inline void xbuffer_external_storage<CP, A>::swap(self_type& rhs) noexcept
+        {
+            using std::swap;
+            swap(p_data, rhs.p_data);
+            swap(m_size, rhs.m_size);
+            swap(m_handle, rhs.m_handle);
+        }
+    }
+
+    /*****************************************
+     * xbuffer_shared_storage implementation *
+     *****************************************/
+
+    namespace detail
+    {
+        template <class CP, class A>
+        inline xbuffer_shared_storage<CP, A>::shared_buffer::shared_buffer(buffer_pointer data, size_type size,
+                                                                           const allocator_type& alloc)
+            : p_data(data), m_size(size), m_allocator(alloc)
+        {
+        }
+
+        template <class CP, class A>
+        inline xbuffer_shared_storage<CP, A>::shared_buffer::~shared_buffer()
+        {
+            safe_destroy_deallocate(m_allocator, p_data, m_size);
+        }
+
+        template <class CP, class A>
+        template <class P>
+        inline xbuffer_shared_storage<CP, A>::xbuffer_shared_storage(P&& data, size_type size, const allocator_type& alloc)
+            : m_allocator(alloc)
+        {
+            buffer_pointer p = const_cast<buffer_pointer>(static_cast<const_pointer>(data));
+            try
+            {
+                p_buffer = std::make_shared<shared_buffer>(p, size, m_allocator);
+            }
+            catch (...)
+            {
+                safe_destroy_deallocate(m_allocator, p, size);
+                throw;
+            }
+        }
+
+        template <class CP, class A>
+        inline xbuffer_shared_storage<CP, A>::xbuffer_shared_storage(size_type size, const value_type& value,
+                                                                     const allocator_type& alloc)
+            : m_allocator(alloc)
+        {
+            p_buffer = make_buffer(size);
+            if (p_buffer)
+            {
+                std::fill(p_buffer->p_data, p_buffer->p_data + size, value);
+            }
+        }
+
+        template <class CP, class A>
+        inline auto xbuffer_shared_storage<CP, A>::size() const noexcept -> size_type
+        {
+            return p_buffer ? p_buffer->m_size : size_type(0);
+        }
+
+        template <class CP, class A>
+        inline void xbuffer_shared_storage<CP, A>::resize(size_type size)
+        {
+            if (size != this->size())
+            {
+                p_buffer = make_buffer(size);
+            }
+        }
+
+        /**
+         * Returns a pointer to the buffer, which is copied first if it is
+         * shared with other storages.
+         */
+        template <class CP, class A>
+        inline auto xbuffer_shared_storage<CP, A>::data() -> pointer
+        {
+            detach();
+            return p_buffer ? p_buffer->p_data : nullptr;
+        }
+
+        template <class CP, class A>
+        inline auto xbuffer_shared_storage<CP, A>::data() const noexcept -> const_pointer
+        {
+            return p_buffer ? p_buffer->p_data : nullptr;
+        }
+
+        /**
+         * Returns the number of storages sharing the buffer.
+         */
+        template <class CP, class A>
+        inline long xbuffer_shared_storage<CP, A>::use_count() const noexcept
+        {
+            return p_buffer.use_count();
+        }
+
+        template <class CP, class A>
+        inline auto xbuffer_shared_storage<CP, A>::get_allocator() const noexcept -> allocator_type
+        {
+            return allocator_type(m_allocator);
+        }
+
+        template <class CP, class A>
+        inline void xbuffer_shared_storage<CP, A>::swap(self_type& rhs) noexcept
+        {
+            using std::swap;
+            swap(p_buffer, rhs.p_buffer);
+            swap(m_allocator, rhs.m_allocator);
+        }
+
+        template <class CP, class A>
+        inline auto xbuffer_shared_storage<CP, A>::make_buffer(size_type size) -> buffer_type
+        {
+            if (size == 0)
+            {
+                return buffer_type();
+            }
+            buffer_pointer p = safe_init_allocate(m_allocator, size);
+            try
+            {
+                return std::make_shared<shared_buffer>(p, size, m_allocator);
+            }
+            catch (...)
+            {
+                safe_destroy_deallocate(m_allocator, p, size);
+                throw;
+            }
+        }
+
+        template <class CP, class A>
+        inline void xbuffer_shared_storage<CP, A>::detach()
+        {
+            if (!p_buffer)
+            {
+                return;
+            }
+            if (p_buffer.use_count() == 1)
+            {
+                // synchronizes with the release of the buffer by the other
+                // owners, which may have read it while it was shared
+                std::atomic_thread_fence(std::memory_order_acquire);
+                return;
+            }
+            buffer_type tmp = make_buffer(p_buffer->m_size);
+            if (xtrivially_default_constructible<value_type>::value)
+            {
+                std::uninitialized_copy(p_buffer->p_data, p_buffer->p_data + p_buffer->m_size, tmp->p_data);
+            }
+            else
+            {
+                std::copy(p_buffer->p_data, p_buffer->p_data + p_buffer->m_size, tmp->p_data);
+            }
+            p_buffer = std::move(tmp);
+        }
+    }
+
     /**********************************
      * xbuffer_adaptor implementation *
      **********************************/
 
     template <class CP, class O, class A>
-    template <class P>
+    template <class P, class>
     inline xbuffer_adaptor<CP, O, A>::xbuffer_adaptor(P&& data, size_type size, const allocator_type& alloc)
         : base_type(std::forward<P>(data), size, alloc)
     {
     }
 
+    /**
+     * Allocates a buffer of \c size elements initialized to \c value. Only
+     * available with the shared_ownership policy.
+     */
+    template <class CP, class O, class A>
+    inline xbuffer_adaptor<CP, O, A>::xbuffer_adaptor(size_type size, const value_type& value, const allocator_type& alloc)
+        : base_type(size, value, alloc)
+    {
+    }
+
+    /**
+     * Adapts a buffer whose ownership policy holds a state, such as
+     * external_ownership.
+     */
+    template <class CP, class O, class A>
+    template <class P>
+    inline xbuffer_adaptor<CP, O, A>::xbuffer_adaptor(P&& data, size_type size, const O& ownership, const allocator_type& alloc)
+        : base_type(std::forward<P>(data), size, ownership, alloc)
+    {
+    }
+
     template <class CP, class O, class A>
     inline auto xbuffer_adaptor<CP, O, A>::operator=(temporary_type&& tmp) -> self_type&
     {
@@ -561,6 +967,16 @@ namespace xt
         return rend();
     }
 
+    /**
+     * Returns the number of adaptors sharing the buffer. Only available
+     * with the shared_ownership policy.
+     */
+    template <class CP, class O, class A>
+    inline long xbuffer_adaptor<CP, O, A>::use_count() const noexcept
+    {
+        return base_type::use_count();
+    }
+
     template <class CP, class O, class A>
     inline bool operator==(const xbuffer_adaptor<CP, O, A>& lhs,
                            const xbuffer_adaptor<CP, O, A>& rhs)
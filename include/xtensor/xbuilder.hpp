@@ -13,10 +13,12 @@
 #ifndef XTENSOR_BUILDER_HPP
 #define XTENSOR_BUILDER_HPP
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstddef>
 #include <functional>
+#include <numeric>
 #include <utility>
 #include <vector>
 #ifdef X_OLD_CLANG
@@ -29,7 +31,10 @@
 #include "xbroadcast.hpp"
 #include "xfunction.hpp"
 #include "xgenerator.hpp"
+#include "xnoalias.hpp"
 #include "xoperation.hpp"
+#include "xparallel.hpp"
+#include "xstrided_view.hpp"
 
 namespace xt
 {
@@ -129,6 +134,39 @@ namespace xt
         return xtensor_fixed<T, fixed_shape<N...>, L>();
     }
 
+    /**
+     * Create a xcontainer (xarray or xtensor) filled with zeros, whose storage comes from
+     * zero_page_allocator: the large storages are mapped on memory zeroed lazily by the
+     * system, the pages are only materialized when they are first written. Neither this
+     * function nor the assignment of zeros(shape) to the container write the elements.
+     *
+     * - ``std::vector`` → ``xarray<T>``
+     * - ``std::array`` or ``initializer_list`` → ``xtensor<T, N>``
+     *
+     * @param shape shape of the new xcontainer
+     */
+    template <class T, layout_type L = XTENSOR_DEFAULT_LAYOUT, class S>
+    inline xarray<T, L, zero_page_allocator<T>> zeros_container(const S& shape)
+    {
+        return xarray<T, L, zero_page_allocator<T>>::from_shape(shape);
+    }
+
+    template <class T, layout_type L = XTENSOR_DEFAULT_LAYOUT, class ST, std::size_t N>
+    inline xtensor<T, N, L, zero_page_allocator<T>> zeros_container(const std::array<ST, N>& shape)
+    {
+        using shape_type = typename xtensor<T, N, L, zero_page_allocator<T>>::shape_type;
+        return xtensor<T, N, L, zero_page_allocator<T>>(xtl::forward_sequence<shape_type>(shape));
+    }
+
+#ifndef X_OLD_CLANG
+    template <class T, layout_type L = XTENSOR_DEFAULT_LAYOUT, class I, std::size_t N>
+    inline xtensor<T, N, L, zero_page_allocator<T>> zeros_container(const I(&shape)[N])
+    {
+        using shape_type = typename xtensor<T, N, L, zero_page_allocator<T>>::shape_type;
+        return xtensor<T, N, L, zero_page_allocator<T>>(xtl::forward_sequence<shape_type>(shape));
+    }
+#endif
+
     /**
      * Create a xcontainer (xarray, xtensor or xtensor_fixed) with uninitialized values of
      * the same shape, value type and layout as the input xexpression *e*.
@@ -215,6 +253,19 @@ namespace xt
                 return m_start + m_step * T(*first);
             }
 
+            inline T data_element(std::size_t i) const
+            {
+                return m_start + m_step * T(i);
+            }
+
+            // start + step * (i + iota), computed with the same operations
+            // as data_element so that both give the same values
+            template <class requested_type, std::size_t N>
+            inline xsimd::simd_return_type<T, requested_type> load_simd(std::size_t i) const
+            {
+                return load_simd_impl<requested_type, N>(i, std::is_same<T, requested_type>());
+            }
+
             template <class E>
             inline void assign_to(xexpression<E>& e) const noexcept
             {
@@ -234,6 +285,31 @@ namespace xt
             value_type m_stop;
             value_type m_step;
 
+            template <class requested_type, std::size_t N>
+            inline auto load_simd_impl(std::size_t i, std::true_type) const
+            {
+                std::array<T, N> iota;
+                for (std::size_t k = 0; k < N; ++k)
+                {
+                    iota[k] = T(i + k);
+                }
+                using simd_type = xsimd::simd_return_type<T, requested_type>;
+                return static_cast<simd_type>(xsimd::set_simd<T, T>(m_start) +
+                                              xsimd::set_simd<T, T>(m_step) * xsimd::load_simd<T, T>(iota.data(), xsimd::unaligned_mode()));
+            }
+
+            // the elements are converted one by one to the requested type
+            template <class requested_type, std::size_t N>
+            inline auto load_simd_impl(std::size_t i, std::false_type) const
+            {
+                std::array<T, N> buffer;
+                for (std::size_t k = 0; k < N; ++k)
+                {
+                    buffer[k] = data_element(i + k);
+                }
+                return xsimd::load_simd<T, requested_type>(buffer.data(), xsimd::unaligned_mode());
+            }
+
             template <class T1, class... Args>
             inline T access_impl(T1 t, Args...) const
             {
@@ -278,6 +354,12 @@ namespace xt
                 return access_impl(first, last);
             }
 
+            template <class E, class FT = F>
+            inline auto assign_to(xexpression<E>& e) const noexcept -> decltype(std::declval<const FT&>().assign_to(e))
+            {
+                return m_ft.assign_to(e);
+            }
+
         private:
 
             F m_ft;
@@ -303,14 +385,78 @@ namespace xt
             template <class It>
             inline T operator()(const It& /*begin*/, const It& end) const
             {
-                using lvalue_type = typename std::iterator_traits<It>::value_type;
-                return *(end - 1) == *(end - 2) + static_cast<lvalue_type>(static_cast<unsigned int>(m_k)) ? T(1) : T(0);
+                std::ptrdiff_t col = static_cast<std::ptrdiff_t>(*(end - 1));
+                std::ptrdiff_t row = static_cast<std::ptrdiff_t>(*(end - 2));
+                return col - row == m_k ? T(1) : T(0);
+            }
+
+            // fills the storage with zeros and writes the ones of each
+            // diagonal, instead of comparing the indices of every element
+            template <class E>
+            inline void assign_to(xexpression<E>& e) const noexcept
+            {
+                auto& de = e.derived_cast();
+                std::fill(de.storage().begin(), de.storage().end(), T(0));
+
+                const auto& shape = de.shape();
+                const auto& strides = de.strides();
+                std::size_t dim = shape.size();
+                if (dim < 2)
+                {
+                    return;
+                }
+                std::ptrdiff_t nb_rows = static_cast<std::ptrdiff_t>(shape[dim - 2]);
+                std::ptrdiff_t nb_cols = static_cast<std::ptrdiff_t>(shape[dim - 1]);
+                std::ptrdiff_t first_row = m_k < 0 ? -m_k : 0;
+                std::ptrdiff_t last_row = (std::min)(nb_rows, nb_cols - m_k);
+                std::ptrdiff_t diagonal_stride = static_cast<std::ptrdiff_t>(strides[dim - 2] + strides[dim - 1]);
+                std::ptrdiff_t first_offset = first_row * static_cast<std::ptrdiff_t>(strides[dim - 2]) +
+                                              (first_row + m_k) * static_cast<std::ptrdiff_t>(strides[dim - 1]);
+
+                std::size_t nb_matrices = std::accumulate(shape.cbegin(), shape.cend() - 2, std::size_t(1), std::multiplies<std::size_t>());
+                for (std::size_t m = 0; m < nb_matrices; ++m)
+                {
+                    // offset of the matrix m, decomposed over the leading dimensions
+                    std::ptrdiff_t offset = first_offset;
+                    std::size_t index = m;
+                    for (std::size_t d = dim - 2; d-- > 0;)
+                    {
+                        offset += static_cast<std::ptrdiff_t>(index % shape[d]) * static_cast<std::ptrdiff_t>(strides[d]);
+                        index /= shape[d];
+                    }
+                    for (std::ptrdiff_t r = first_row; r < last_row; ++r, offset += diagonal_stride)
+                    {
+                        de.storage()[static_cast<std::size_t>(offset)] = T(1);
+                    }
+                }
             }
 
         private:
 
             int m_k;
         };
+
+        // linspace and logspace of floating point values compute their
+        // elements in their own type: skipping the cast keeps the simd
+        // interface of the generator
+        template <class T, class E>
+        inline auto cast_generated(E&& e, std::true_type) noexcept
+        {
+            return std::forward<E>(e);
+        }
+
+        template <class T, class E>
+        inline auto cast_generated(E&& e, std::false_type) noexcept
+        {
+            return xt::cast<T>(std::forward<E>(e));
+        }
+
+        template <class T, class E>
+        inline auto cast_generated(E&& e) noexcept
+        {
+            using is_same_type = std::is_same<typename std::decay_t<E>::value_type, T>;
+            return cast_generated<T>(std::forward<E>(e), is_same_type());
+        }
     }
 
     /**
@@ -385,7 +531,7 @@ namespace xt
     {
         using fp_type = std::common_type_t<T, double>;
         fp_type step = fp_type(stop - start) / fp_type(num_samples - (endpoint ? 1 : 0));
-        return cast<T>(detail::make_xgenerator(detail::arange_impl<fp_type>(fp_type(start), fp_type(stop), step), {num_samples}));
+        return detail::cast_generated<T>(detail::make_xgenerator(detail::arange_impl<fp_type>(fp_type(start), fp_type(stop), step), {num_samples}));
     }
 
     /**
@@ -401,11 +547,43 @@ namespace xt
     template <class T>
     inline auto logspace(T start, T stop, std::size_t num_samples, T base = 10, bool endpoint = true) noexcept
     {
-        return cast<T>(pow(std::move(base), linspace(start, stop, num_samples, endpoint)));
+        return detail::cast_generated<T>(pow(std::move(base), linspace(start, stop, num_samples, endpoint)));
     }
 
     namespace detail
     {
+        // Assigns each expression of the tuple to the strided view of its
+        // block in e, given by slices(i, expression), so that every block is
+        // copied with the regular (linear or strided simd) assignment. Large
+        // results are assigned in parallel across the expressions.
+        template <class E, class... CT, class F>
+        inline void assign_blocks(E& e, const std::tuple<CT...>& t, F&& slices)
+        {
+            auto assign_block = [&e, &t, &slices](std::size_t i) {
+                apply<void>(i, [&e, &slices, i](const auto& arr) {
+                    auto block = strided_view(e, slices(i, arr));
+                    noalias(block) = arr;
+                }, t);
+            };
+
+            if (sizeof...(CT) > 1 && parallel::use_parallel(e.size()))
+            {
+                parallel_for(std::size_t(0), sizeof...(CT), std::size_t(1), [&assign_block](std::size_t first, std::size_t last) {
+                    for (std::size_t i = first; i != last; ++i)
+                    {
+                        assign_block(i);
+                    }
+                });
+            }
+            else
+            {
+                for (std::size_t i = 0; i != sizeof...(CT); ++i)
+                {
+                    assign_block(i);
+                }
+            }
+        }
+
         template <class... CT>
         class concatenate_impl
         {
@@ -433,6 +611,29 @@ namespace xt
                 return access_impl(xindex(first, last));
             }
 
+            template <class E>
+            inline void assign_to(xexpression<E>& e) const noexcept
+            {
+                std::array<std::ptrdiff_t, sizeof...(CT)> offsets;
+                std::ptrdiff_t offset = 0;
+                for (size_type i = 0; i < sizeof...(CT); ++i)
+                {
+                    offsets[i] = offset;
+                    offset += apply<std::ptrdiff_t>(i, [this](const auto& arr) {
+                        return static_cast<std::ptrdiff_t>(arr.shape()[this->m_axis]);
+                    }, m_t);
+                }
+
+                auto& de = e.derived_cast();
+                xstrided_slice_vector sv(de.dimension(), all());
+                assign_blocks(de, m_t, [this, &offsets, &sv](size_type i, const auto& arr) {
+                    xstrided_slice_vector block_sv = sv;
+                    std::ptrdiff_t first = offsets[i];
+                    block_sv[this->m_axis] = range(first, first + static_cast<std::ptrdiff_t>(arr.shape()[this->m_axis]));
+                    return block_sv;
+                });
+            }
+
         private:
 
             inline value_type access_impl(xindex idx) const
@@ -492,6 +693,18 @@ namespace xt
                 return access_impl(xindex(first, last));
             }
 
+            template <class E>
+            inline void assign_to(xexpression<E>& e) const noexcept
+            {
+                auto& de = e.derived_cast();
+                xstrided_slice_vector sv(de.dimension(), all());
+                assign_blocks(de, m_t, [this, &sv](size_type i, const auto&) {
+                    xstrided_slice_vector block_sv = sv;
+                    block_sv[this->m_axis] = static_cast<std::ptrdiff_t>(i);
+                    return block_sv;
+                });
+            }
+
         private:
 
             inline value_type access_impl(xindex idx) const
@@ -666,6 +879,77 @@ namespace xt
         return detail::meshgrid_impl(std::make_index_sequence<sizeof...(E)>(), std::forward<E>(e)...);
     }
 
+    namespace detail
+    {
+        // Strided view of the one-dimensional expression e repeated along the
+        // dimensions other than I, with a null stride on these dimensions
+        template <std::size_t I, std::size_t N, class E>
+        inline auto meshgrid_view(E&& e, std::array<std::size_t, N> shape)
+        {
+            std::array<std::ptrdiff_t, N> strides;
+            strides.fill(0);
+            strides[I] = shape[I] > 1 ? static_cast<std::ptrdiff_t>(get_strides(e)[0]) : 0;
+            std::size_t offset = static_cast<std::size_t>(get_offset(e));
+            return strided_view(std::forward<E>(e), std::move(shape), std::move(strides), offset);
+        }
+
+        template <std::size_t I, std::size_t N>
+        inline std::array<std::size_t, N> sparse_meshgrid_shape(std::size_t size) noexcept
+        {
+            std::array<std::size_t, N> shape;
+            shape.fill(1);
+            shape[I] = size;
+            return shape;
+        }
+
+        template <std::size_t... I, class... E>
+        inline auto broadcast_meshgrid_impl(std::index_sequence<I...>, E&&... e)
+        {
+            const std::array<std::size_t, sizeof...(E)> shape = {{e.shape()[0]...}};
+            return std::make_tuple(meshgrid_view<I>(std::forward<E>(e), shape)...);
+        }
+
+        template <std::size_t... I, class... E>
+        inline auto sparse_meshgrid_impl(std::index_sequence<I...>, E&&... e)
+        {
+            return std::make_tuple(meshgrid_view<I>(std::forward<E>(e), sparse_meshgrid_shape<I, sizeof...(E)>(e.shape()[0]))...);
+        }
+    }
+
+    /**
+     * @brief Return coordinate tensors from coordinate vectors, as views.
+     *        Same as \ref meshgrid, except that the coordinate tensors are strided
+     *        views of the one-dimensional expressions, with null strides along the
+     *        dimensions where the coordinates are repeated: they hold no memory,
+     *        and are assigned with the strided loops which broadcast the repeated
+     *        coordinates. The expressions must outlive the views when they are
+     *        lvalues.
+     *
+     * @param e one-dimensional xexpressions
+     * @returns tuple of xstrided_view expressions of shape ``(N1, N2, ..., Nn)``.
+     */
+    template <class... E>
+    inline auto broadcast_meshgrid(E&&... e)
+    {
+        return detail::broadcast_meshgrid_impl(std::make_index_sequence<sizeof...(E)>(), std::forward<E>(e)...);
+    }
+
+    /**
+     * @brief Return sparse coordinate tensors from coordinate vectors.
+     *        Equivalent to numpy's ``meshgrid(x1, ..., xn, indexing='ij', sparse=True)``:
+     *        the i-th coordinate tensor is a view of the i-th expression with the shape
+     *        ``(1, ..., Ni, ..., 1)``, which broadcasts against the others in element-wise
+     *        expressions.
+     *
+     * @param e one-dimensional xexpressions
+     * @returns tuple of xstrided_view expressions.
+     */
+    template <class... E>
+    inline auto sparse_meshgrid(E&&... e)
+    {
+        return detail::sparse_meshgrid_impl(std::make_index_sequence<sizeof...(E)>(), std::forward<E>(e)...);
+    }
+
     namespace detail
     {
         template <class CT>
@@ -0,0 +1,605 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_CACHED_HPP
+#define XTENSOR_CACHED_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#include "xeval.hpp"
+#include "xexception.hpp"
+#include "xexpression.hpp"
+#include "xiterable.hpp"
+#include "xnoalias.hpp"
+#include "xstrides.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+
+    /***********
+     * xcached *
+     ***********/
+
+    template <class CT>
+    class xcached;
+
+    namespace detail
+    {
+        template <class E>
+        using cached_buffer_t = std::decay_t<decltype(eval(std::declval<E>()))>;
+
+        // number of elements evaluated at once by a partial access
+        constexpr std::size_t cached_tile_size = 4096;
+    }
+
+    template <class CT>
+    struct xiterable_inner_types<xcached<CT>>
+    {
+        using buffer_type = detail::cached_buffer_t<std::decay_t<CT>>;
+        using inner_shape_type = typename buffer_type::inner_shape_type;
+        using const_stepper = typename buffer_type::const_stepper;
+        using stepper = const_stepper;
+    };
+
+    /**
+     * @class xcached
+     * @brief Expression memoizing the values of another expression.
+     *
+     * The xcached class evaluates the underlying expression once, into a
+     * buffer it owns, and serves the later accesses from that buffer. An
+     * access to a single element evaluates the tile of contiguous elements
+     * holding it; the assignment of the xcached, or of an expression it is
+     * an operand of, evaluates the missing tiles at once. The buffer is kept
+     * until invalidate() is called, for instance after the operands of the
+     * underlying expression have been modified. The first accesses may be
+     * concurrent, each tile is evaluated once.
+     *
+     * xcached is not meant to be used directly, but only with the \ref cached
+     * helper function.
+     *
+     * @tparam CT the closure type of the \ref xexpression to cache
+     *
+     * @sa cached
+     */
+    template <class CT>
+    class xcached : public xexpression<xcached<CT>>,
+                    public xconst_iterable<xcached<CT>>
+    {
+    public:
+
+        using self_type = xcached<CT>;
+        using xexpression_type = std::decay_t<CT>;
+        using buffer_type = detail::cached_buffer_t<xexpression_type>;
+        using expression_tag = xtensor_expression_tag;
+
+        using value_type = typename buffer_type::value_type;
+        using reference = typename buffer_type::const_reference;
+        using const_reference = typename buffer_type::const_reference;
+        using pointer = typename buffer_type::const_pointer;
+        using const_pointer = typename buffer_type::const_pointer;
+        using size_type = typename buffer_type::size_type;
+        using difference_type = typename buffer_type::difference_type;
+
+        using iterable_base = xconst_iterable<self_type>;
+        using inner_shape_type = typename iterable_base::inner_shape_type;
+        using shape_type = inner_shape_type;
+
+        using stepper = typename iterable_base::stepper;
+        using const_stepper = typename iterable_base::const_stepper;
+
+        using const_storage_iterator = typename buffer_type::const_storage_iterator;
+
+        static constexpr layout_type static_layout = buffer_type::static_layout;
+        static constexpr bool contiguous_layout = true;
+
+        template <class CTA, class = std::enable_if_t<!std::is_same<std::decay_t<CTA>, xcached>::value>>
+        explicit xcached(CTA&& e, size_type tile_size = detail::cached_tile_size);
+
+        xcached(const xcached& rhs);
+        xcached(xcached&& rhs);
+        xcached& operator=(const xcached&) = delete;
+        xcached& operator=(xcached&&) = delete;
+
+        size_type size() const noexcept;
+        size_type dimension() const noexcept;
+        const inner_shape_type& shape() const noexcept;
+        layout_type layout() const noexcept;
+
+        template <class... Args>
+        const_reference operator()(Args... args) const;
+
+        template <class... Args>
+        const_reference at(Args... args) const;
+
+        template <class... Args>
+        const_reference unchecked(Args... args) const;
+
+        template <class S>
+        disable_integral_t<S, const_reference> operator[](const S& index) const;
+        template <class I>
+        const_reference operator[](std::initializer_list<I> index) const;
+        const_reference operator[](size_type i) const;
+
+        template <class It>
+        const_reference element(It first, It last) const;
+
+        const buffer_type& evaluate() const;
+        void invalidate() noexcept;
+        bool is_evaluated() const noexcept;
+
+        const xexpression_type& expression() const noexcept;
+
+        template <class S>
+        bool broadcast_shape(S& shape, bool reuse_cache = false) const;
+
+        template <class S>
+        bool has_linear_assign(const S& strides) const;
+
+        template <class S>
+        const_stepper stepper_begin(const S& shape) const;
+        template <class S>
+        const_stepper stepper_end(const S& shape, layout_type l) const;
+
+        const_storage_iterator storage_cbegin() const;
+        const_storage_iterator storage_cend() const;
+
+        const_reference data_element(size_type i) const;
+
+        template <class align, class requested_type = value_type,
+                  std::size_t N = xsimd::simd_traits<requested_type>::size>
+        typename buffer_type::template simd_return_type<requested_type> load_simd(size_type i) const;
+
+    private:
+
+        const_reference cached_at(size_type offset) const;
+        void evaluate_tile(size_type tile) const;
+        void init_tiles();
+
+        CT m_e;
+        mutable buffer_type m_buffer;
+        size_type m_tile_size;
+        size_type m_ntiles;
+        mutable std::unique_ptr<std::atomic<bool>[]> m_tiles;
+        mutable size_type m_nevaluated;
+        mutable std::atomic<bool> m_complete;
+        mutable std::mutex m_mutex;
+    };
+
+    /*************************
+     * cached implementation *
+     *************************/
+
+    /**
+     * @brief Returns an \ref xexpression memoizing the values of \p e.
+     *
+     * Repeated accesses to a lazy reduction or function recompute it on
+     * each access; the returned expression computes each value once:
+     *
+     * \code{.cpp}
+     * auto m = xt::cached(xt::mean(a, {1}));
+     * for (std::size_t i = 0; i < n; ++i)
+     * {
+     *     res(i) = (m(i) - m(0)) / m(n - 1);   // m(0) and m(n - 1) are computed once
+     * }
+     * m.invalidate();                         // after a has been modified
+     * \endcode
+     *
+     * The returned expression either holds a const reference to \p e or a
+     * copy depending on whether \p e is an lvalue or an rvalue.
+     *
+     * @param e the expression to cache
+     * @param tile_size the number of contiguous elements evaluated by the
+     * access to one of them
+     */
+    template <class E>
+    inline auto cached(E&& e, std::size_t tile_size = detail::cached_tile_size)
+    {
+        using cached_type = xcached<const_xclosure_t<E>>;
+        return cached_type(std::forward<E>(e), tile_size);
+    }
+
+    /**************************
+     * xcached implementation *
+     **************************/
+
+    /**
+     * @name Constructors
+     */
+    //@{
+    /**
+     * Constructs an xcached expression memoizing the specified \ref xexpression.
+     * The buffer is allocated, its elements are evaluated upon access.
+     *
+     * @param e the expression to cache
+     * @param tile_size the number of contiguous elements evaluated at once
+     */
+    template <class CT>
+    template <class CTA, class>
+    inline xcached<CT>::xcached(CTA&& e, size_type tile_size)
+        : m_e(std::forward<CTA>(e)),
+          m_buffer(buffer_type::from_shape(m_e.shape())),
+          m_tile_size(std::max(tile_size, size_type(1))),
+          m_nevaluated(0),
+          m_complete(false)
+    {
+        init_tiles();
+    }
+
+    template <class CT>
+    inline xcached<CT>::xcached(const xcached& rhs)
+        : m_e(rhs.m_e),
+          m_buffer(rhs.m_buffer),
+          m_tile_size(rhs.m_tile_size),
+          m_nevaluated(0),
+          m_complete(false)
+    {
+        init_tiles();
+        for (size_type t = 0; t < m_ntiles; ++t)
+        {
+            m_tiles[t].store(rhs.m_tiles[t].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        m_nevaluated = rhs.m_nevaluated;
+        m_complete.store(rhs.m_complete.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    template <class CT>
+    inline xcached<CT>::xcached(xcached&& rhs)
+        : m_e(std::forward<CT>(rhs.m_e)),
+          m_buffer(std::move(rhs.m_buffer)),
+          m_tile_size(rhs.m_tile_size),
+          m_ntiles(rhs.m_ntiles),
+          m_tiles(std::move(rhs.m_tiles)),
+          m_nevaluated(rhs.m_nevaluated),
+          m_complete(rhs.m_complete.load(std::memory_order_relaxed))
+    {
+    }
+    //@}
+
+    /**
+     * @name Size and shape
+     */
+    //@{
+    /**
+     * Returns the size of the expression.
+     */
+    template <class CT>
+    inline auto xcached<CT>::size() const noexcept -> size_type
+    {
+        return m_buffer.size();
+    }
+
+    /**
+     * Returns the number of dimensions of the expression.
+     */
+    template <class CT>
+    inline auto xcached<CT>::dimension() const noexcept -> size_type
+    {
+        return m_buffer.dimension();
+    }
+
+    /**
+     * Returns the shape of the expression.
+     */
+    template <class CT>
+    inline auto xcached<CT>::shape() const noexcept -> const inner_shape_type&
+    {
+        return m_buffer.shape();
+    }
+
+    /**
+     * Returns the layout_type of the buffer.
+     */
+    template <class CT>
+    inline layout_type xcached<CT>::layout() const noexcept
+    {
+        return m_buffer.layout();
+    }
+    //@}
+
+    /**
+     * @name Data
+     */
+    //@{
+    /**
+     * Returns a constant reference to the element at the specified position in the expression,
+     * evaluating the tile holding it if needed.
+     * @param args a list of indices specifying the position in the expression. Indices
+     * must be unsigned integers, the number of indices should be equal or greater than
+     * the number of dimensions of the expression.
+     */
+    template <class CT>
+    template <class... Args>
+    inline auto xcached<CT>::operator()(Args... args) const -> const_reference
+    {
+        XTENSOR_TRY(check_index(shape(), args...));
+        XTENSOR_CHECK_DIMENSION(shape(), args...);
+        return cached_at(xt::data_offset<size_type>(m_buffer.strides(), static_cast<std::ptrdiff_t>(args)...));
+    }
+
+    /**
+     * Returns a constant reference to the element at the specified position in the expression,
+     * after dimension and bounds checking.
+     * @param args a list of indices specifying the position in the expression. Indices
+     * must be unsigned integers, the number of indices should be equal to the number of dimensions
+     * of the expression.
+     * @exception std::out_of_range if the number of argument is greater than the number of dimensions
+     * or if indices are out of bounds.
+     */
+    template <class CT>
+    template <class... Args>
+    inline auto xcached<CT>::at(Args... args) const -> const_reference
+    {
+        check_access(shape(), static_cast<size_type>(args)...);
+        return this->operator()(args...);
+    }
+
+    /**
+     * Returns a constant reference to the element at the specified position in the expression.
+     * @param args a list of indices specifying the position in the expression. Indices
+     * must be unsigned integers, the number of indices must be equal to the number of
+     * dimensions of the expression, else the behavior is undefined.
+     */
+    template <class CT>
+    template <class... Args>
+    inline auto xcached<CT>::unchecked(Args... args) const -> const_reference
+    {
+        return cached_at(xt::unchecked_data_offset<size_type, static_layout>(m_buffer.strides(), static_cast<std::ptrdiff_t>(args)...));
+    }
+
+    /**
+     * Returns a constant reference to the element at the specified position in the expression.
+     * @param index a sequence of indices specifying the position in the expression. Indices
+     * must be unsigned integers, the number of indices in the sequence should be equal or greater
+     * than the number of dimensions of the expression.
+     */
+    template <class CT>
+    template <class S>
+    inline auto xcached<CT>::operator[](const S& index) const
+        -> disable_integral_t<S, const_reference>
+    {
+        return element(index.cbegin(), index.cend());
+    }
+
+    template <class CT>
+    template <class I>
+    inline auto xcached<CT>::operator[](std::initializer_list<I> index) const -> const_reference
+    {
+        return element(index.begin(), index.end());
+    }
+
+    template <class CT>
+    inline auto xcached<CT>::operator[](size_type i) const -> const_reference
+    {
+        return operator()(i);
+    }
+
+    /**
+     * Returns a constant reference to the element at the specified position in the expression.
+     * @param first iterator starting the sequence of indices
+     * @param last iterator ending the sequence of indices
+     * The number of indices in the sequence should be equal to or greater
+     * than the number of dimensions of the expression.
+     */
+    template <class CT>
+    template <class It>
+    inline auto xcached<CT>::element(It first, It last) const -> const_reference
+    {
+        XTENSOR_TRY(check_element_index(shape(), first, last));
+        return cached_at(element_offset<size_type>(m_buffer.strides(), first, last));
+    }
+
+    /**
+     * Evaluates the elements that have not been evaluated yet.
+     * @return the buffer holding the values of the expression
+     */
+    template <class CT>
+    inline auto xcached<CT>::evaluate() const -> const buffer_type&
+    {
+        if (!m_complete.load(std::memory_order_acquire))
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_nevaluated == 0)
+            {
+                noalias(m_buffer) = m_e;
+                std::for_each(m_tiles.get(), m_tiles.get() + m_ntiles, [](std::atomic<bool>& t)
+                {
+                    t.store(true, std::memory_order_relaxed);
+                });
+                m_nevaluated = m_ntiles;
+                m_complete.store(true, std::memory_order_release);
+            }
+            else
+            {
+                for (size_type t = 0; t < m_ntiles && m_nevaluated != m_ntiles; ++t)
+                {
+                    evaluate_tile(t);
+                }
+            }
+        }
+        return m_buffer;
+    }
+
+    /**
+     * Discards the cached values, they are evaluated again upon the next
+     * accesses. Must not be called concurrently with an access.
+     */
+    template <class CT>
+    inline void xcached<CT>::invalidate() noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::for_each(m_tiles.get(), m_tiles.get() + m_ntiles, [](std::atomic<bool>& t)
+        {
+            t.store(false, std::memory_order_relaxed);
+        });
+        m_nevaluated = 0;
+        m_complete.store(false, std::memory_order_release);
+    }
+
+    /**
+     * Returns true if all the elements have been evaluated.
+     */
+    template <class CT>
+    inline bool xcached<CT>::is_evaluated() const noexcept
+    {
+        return m_complete.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Returns a constant reference to the underlying expression of the cached expression.
+     */
+    template <class CT>
+    inline auto xcached<CT>::expression() const noexcept -> const xexpression_type&
+    {
+        return m_e;
+    }
+    //@}
+
+    /**
+     * @name Broadcasting
+     */
+    //@{
+    /**
+     * Broadcast the shape of the expression to the specified parameter.
+     * This is the first access of the assignment of an expression the
+     * xcached is an operand of, the missing elements are evaluated.
+     * @param shape the result shape
+     * @param reuse_cache parameter for internal optimization
+     * @return a boolean indicating whether the broadcasting is trivial
+     */
+    template <class CT>
+    template <class S>
+    inline bool xcached<CT>::broadcast_shape(S& shape, bool reuse_cache) const
+    {
+        return evaluate().broadcast_shape(shape, reuse_cache);
+    }
+
+    /**
+     * Checks whether the xcached can be linearly assigned to an expression
+     * with the specified strides.
+     * @return a boolean indicating whether a linear assign is possible
+     */
+    template <class CT>
+    template <class S>
+    inline bool xcached<CT>::has_linear_assign(const S& strides) const
+    {
+        return evaluate().has_linear_assign(strides);
+    }
+    //@}
+
+    template <class CT>
+    template <class S>
+    inline auto xcached<CT>::stepper_begin(const S& shape) const -> const_stepper
+    {
+        return evaluate().stepper_begin(shape);
+    }
+
+    template <class CT>
+    template <class S>
+    inline auto xcached<CT>::stepper_end(const S& shape, layout_type l) const -> const_stepper
+    {
+        return evaluate().stepper_end(shape, l);
+    }
+
+    template <class CT>
+    inline auto xcached<CT>::storage_cbegin() const -> const_storage_iterator
+    {
+        return evaluate().storage_cbegin();
+    }
+
+    template <class CT>
+    inline auto xcached<CT>::storage_cend() const -> const_storage_iterator
+    {
+        return evaluate().storage_cend();
+    }
+
+    template <class CT>
+    inline auto xcached<CT>::data_element(size_type i) const -> const_reference
+    {
+        return evaluate().data_element(i);
+    }
+
+    template <class CT>
+    template <class align, class requested_type, std::size_t N>
+    inline auto xcached<CT>::load_simd(size_type i) const
+        -> typename buffer_type::template simd_return_type<requested_type>
+    {
+        return evaluate().template load_simd<align, requested_type, N>(i);
+    }
+
+    template <class CT>
+    inline auto xcached<CT>::cached_at(size_type offset) const -> const_reference
+    {
+        if (!m_complete.load(std::memory_order_acquire))
+        {
+            size_type tile = offset / m_tile_size;
+            if (!m_tiles[tile].load(std::memory_order_acquire))
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                evaluate_tile(tile);
+            }
+        }
+        return m_buffer.data()[offset];
+    }
+
+    // must be called with m_mutex locked
+    template <class CT>
+    inline void xcached<CT>::evaluate_tile(size_type tile) const
+    {
+        if (m_tiles[tile].load(std::memory_order_relaxed))
+        {
+            return;
+        }
+        size_type first = tile * m_tile_size;
+        size_type last = std::min(first + m_tile_size, m_buffer.size());
+        const auto& shape = m_buffer.shape();
+        auto index = unravel_from_strides(first, m_buffer.strides(), m_buffer.layout());
+        auto* data = m_buffer.data();
+        bool row_major = m_buffer.layout() == layout_type::row_major;
+        size_type dim = index.size();
+        for (size_type k = first; k != last; ++k)
+        {
+            data[k] = m_e.element(index.cbegin(), index.cend());
+            // next index in the order of the storage
+            for (size_type d = 0; d != dim; ++d)
+            {
+                size_type axis = row_major ? dim - 1 - d : d;
+                if (++index[axis] != static_cast<typename decltype(index)::value_type>(shape[axis]))
+                {
+                    break;
+                }
+                index[axis] = 0;
+            }
+        }
+        m_tiles[tile].store(true, std::memory_order_release);
+        if (++m_nevaluated == m_ntiles)
+        {
+            m_complete.store(true, std::memory_order_release);
+        }
+    }
+
+    template <class CT>
+    inline void xcached<CT>::init_tiles()
+    {
+        m_ntiles = std::max((m_buffer.size() + m_tile_size - 1) / m_tile_size, size_type(1));
+        m_tiles.reset(new std::atomic<bool>[m_ntiles]);
+        for (size_type t = 0; t < m_ntiles; ++t)
+        {
+            m_tiles[t].store(false, std::memory_order_relaxed);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,505 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_CHUNK_FILE_STORE_HPP
+#define XTENSOR_CHUNK_FILE_STORE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <xtl/xsequence.hpp>
+
+#include "xchunked_array.hpp"
+#include "xnpy.hpp"
+#include "xshape.hpp"
+
+namespace xt
+{
+
+    /*********************
+     * xchunk_file_store *
+     *********************/
+
+    /**
+     * @class xchunk_file_store
+     * @brief Chunk store of an \ref xchunked_array keeping the chunks in npy
+     * files, with a bounded cache of chunks in memory.
+     *
+     * The chunk of index (i0, ..., in) in the grid is stored in the file
+     * <tt>prefix + "i0.....in.npy"</tt>; chunks without file are filled with
+     * zeros. At most \c capacity chunks are held in memory: the least
+     * recently used one is evicted when another chunk is loaded, and written
+     * back to its file if it has been accessed through a non-constant method.
+     * When a chunk is loaded, the \c prefetch next chunks in row-major order
+     * of the grid, which is the order of \ref xchunked_array::for_each_chunk
+     * and of the assignments, are read by background tasks. An array of any
+     * size is thus evaluated with the memory of <tt>capacity + prefetch</tt>
+     * chunks:
+     *
+     * \code{.cpp}
+     * auto a = xt::chunked_file_array<double>("data/a.", {100000, 100000}, {2000, 2000}, 8);
+     * auto b = xt::chunked_file_array<double>("data/b.", {100000, 100000}, {2000, 2000}, 8);
+     * b = 2. * a + 1.;
+     * b.chunks().flush();
+     * \endcode
+     *
+     * A reference to a chunk remains valid until \c capacity other chunks
+     * have been loaded.
+     *
+     * @tparam C the type of the chunks, an xtensor or an xarray
+     */
+    template <class C>
+    class xchunk_file_store
+    {
+    public:
+
+        using self_type = xchunk_file_store<C>;
+        using value_type = C;
+        using reference = C&;
+        using const_reference = const C&;
+        using size_type = std::size_t;
+        using shape_type = dynamic_shape<std::size_t>;
+        using chunk_shape_type = typename C::shape_type;
+
+        xchunk_file_store(const std::string& prefix, size_type capacity, size_type prefetch = 1);
+        ~xchunk_file_store();
+
+        xchunk_file_store(const xchunk_file_store&) = delete;
+        xchunk_file_store& operator=(const xchunk_file_store&) = delete;
+
+        xchunk_file_store(xchunk_file_store&&) = default;
+        xchunk_file_store& operator=(xchunk_file_store&&) noexcept;
+
+        const shape_type& shape() const noexcept;
+        size_type size() const noexcept;
+        size_type capacity() const noexcept;
+        size_type prefetch() const noexcept;
+        size_type cached_count() const;
+
+        template <class S1, class S2>
+        void resize_chunks(const S1& shape, const S2& chunk_shape);
+
+        template <class It>
+        reference element(It first, It last);
+        template <class It>
+        const_reference element(It first, It last) const;
+
+        void flush();
+
+        std::string chunk_filename(size_type i) const;
+
+    private:
+
+        struct entry
+        {
+            C chunk;
+            bool dirty;
+            std::list<size_type>::iterator position;
+        };
+
+        struct state_type
+        {
+            std::string prefix;
+            size_type capacity;
+            size_type prefetch;
+            shape_type shape;
+            shape_type chunk_shape;
+            shape_type grid_shape;
+            // most recently used chunks first
+            std::list<size_type> lru;
+            std::unordered_map<size_type, entry> chunks;
+            std::unordered_map<size_type, std::future<C>> pending;
+            std::mutex mutex;
+        };
+
+        template <class It>
+        size_type linear_index(It first, It last) const;
+
+        reference fetch(size_type i, bool dirty) const;
+        void evict() const;
+        void schedule_prefetch(size_type i) const;
+        void write_dirty() const;
+        chunk_shape_type chunk_box(size_type i) const;
+
+        static C load_chunk(const std::string& filename, const chunk_shape_type& box);
+
+        std::unique_ptr<state_type> m_state;
+    };
+
+    template <class T, layout_type L = XTENSOR_DEFAULT_LAYOUT, class S>
+    xchunked_array<xchunk_file_store<detail::chunk_container_t<T, S, L>>>
+    chunked_file_array(const std::string& prefix, const S& shape, const S& chunk_shape,
+                       std::size_t capacity, std::size_t prefetch = 1);
+
+#ifndef X_OLD_CLANG
+    template <class T, layout_type L = XTENSOR_DEFAULT_LAYOUT, class I, std::size_t N>
+    xchunked_array<xchunk_file_store<detail::chunk_container_t<T, std::array<std::size_t, N>, L>>>
+    chunked_file_array(const std::string& prefix, const I (&shape)[N], const I (&chunk_shape)[N],
+                       std::size_t capacity, std::size_t prefetch = 1);
+#endif
+
+    /************************************
+     * xchunk_file_store implementation *
+     ************************************/
+
+    /**
+     * Builds a store whose chunk files are named after \c prefix. The
+     * geometry of the chunks is set by the \ref xchunked_array owning
+     * the store.
+     * @param prefix the prefix of the chunk file names, usually an existing
+     *               directory followed by a separator
+     * @param capacity the maximal number of chunks held in memory
+     * @param prefetch the number of chunks read ahead in the background
+     * @throw std::runtime_error if capacity is 0.
+     */
+    template <class C>
+    inline xchunk_file_store<C>::xchunk_file_store(const std::string& prefix, size_type capacity, size_type prefetch)
+        : m_state(std::make_unique<state_type>())
+    {
+        if (capacity == 0)
+        {
+            throw std::runtime_error("xchunk_file_store: the capacity must be at least one chunk");
+        }
+        m_state->prefix = prefix;
+        m_state->capacity = capacity;
+        m_state->prefetch = prefetch;
+    }
+
+    /**
+     * Writes the dirty chunks back to their files.
+     */
+    template <class C>
+    inline xchunk_file_store<C>::~xchunk_file_store()
+    {
+        if (m_state)
+        {
+            try
+            {
+                flush();
+            }
+            catch (...)
+            {
+            }
+        }
+    }
+
+    // the previous state is flushed when rhs is destroyed
+    template <class C>
+    inline auto xchunk_file_store<C>::operator=(xchunk_file_store&& rhs) noexcept -> self_type&
+    {
+        std::swap(m_state, rhs.m_state);
+        return *this;
+    }
+
+    /**
+     * Returns the shape of the grid of chunks.
+     */
+    template <class C>
+    inline auto xchunk_file_store<C>::shape() const noexcept -> const shape_type&
+    {
+        return m_state->grid_shape;
+    }
+
+    /**
+     * Returns the number of chunks.
+     */
+    template <class C>
+    inline auto xchunk_file_store<C>::size() const noexcept -> size_type
+    {
+        return compute_size(m_state->grid_shape);
+    }
+
+    /**
+     * Returns the maximal number of chunks held in memory.
+     */
+    template <class C>
+    inline auto xchunk_file_store<C>::capacity() const noexcept -> size_type
+    {
+        return m_state->capacity;
+    }
+
+    /**
+     * Returns the number of chunks read ahead in the background.
+     */
+    template <class C>
+    inline auto xchunk_file_store<C>::prefetch() const noexcept -> size_type
+    {
+        return m_state->prefetch;
+    }
+
+    /**
+     * Returns the number of chunks currently held in memory, the chunks
+     * being read ahead excepted.
+     */
+    template <class C>
+    inline auto xchunk_file_store<C>::cached_count() const -> size_type
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        return m_state->chunks.size();
+    }
+
+    /**
+     * Sets the shape of the array and of its chunks. The dirty chunks are
+     * written back and the cache is emptied; the files are kept, and must
+     * hold chunks of the new geometry to be read.
+     */
+    template <class C>
+    template <class S1, class S2>
+    inline void xchunk_file_store<C>::resize_chunks(const S1& shape, const S2& chunk_shape)
+    {
+        state_type& st = *m_state;
+        std::lock_guard<std::mutex> lock(st.mutex);
+        write_dirty();
+        for (auto& p : st.pending)
+        {
+            p.second.wait();
+        }
+        st.pending.clear();
+        st.chunks.clear();
+        st.lru.clear();
+
+        size_type dim = shape.size();
+        st.shape.assign(shape.cbegin(), shape.cend());
+        st.chunk_shape.assign(chunk_shape.cbegin(), chunk_shape.cend());
+        st.grid_shape.resize(dim);
+        for (size_type d = 0; d < dim; ++d)
+        {
+            st.grid_shape[d] = (st.shape[d] + st.chunk_shape[d] - 1) / st.chunk_shape[d];
+        }
+    }
+
+    /**
+     * Returns a reference to the chunk at the specified position in the grid,
+     * loading it if needed. The chunk is written back to its file when it
+     * is evicted.
+     * @param first iterator starting the sequence of indices
+     * @param last iterator ending the sequence of indices
+     */
+    template <class C>
+    template <class It>
+    inline auto xchunk_file_store<C>::element(It first, It last) -> reference
+    {
+        return fetch(linear_index(first, last), true);
+    }
+
+    /**
+     * Returns a constant reference to the chunk at the specified position in
+     * the grid, loading it if needed.
+     * @param first iterator starting the sequence of indices
+     * @param last iterator ending the sequence of indices
+     */
+    template <class C>
+    template <class It>
+    inline auto xchunk_file_store<C>::element(It first, It last) const -> const_reference
+    {
+        return fetch(linear_index(first, last), false);
+    }
+
+    /**
+     * Writes the dirty chunks held in memory back to their files.
+     */
+    template <class C>
+    inline void xchunk_file_store<C>::flush()
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        write_dirty();
+    }
+
+    /**
+     * Returns the name of the file of the chunk \c i, the chunks being
+     * numbered in row-major order of the grid.
+     */
+    template <class C>
+    inline std::string xchunk_file_store<C>::chunk_filename(size_type i) const
+    {
+        const shape_type& grid = m_state->grid_shape;
+        std::string name = ".npy";
+        for (size_type d = grid.size(); d > 0; --d)
+        {
+            name = std::to_string(i % grid[d - 1]) + (d == grid.size() ? "" : ".") + name;
+            i /= grid[d - 1];
+        }
+        return m_state->prefix + (grid.empty() ? "0" : "") + name;
+    }
+
+    template <class C>
+    template <class It>
+    inline auto xchunk_file_store<C>::linear_index(It first, It last) const -> size_type
+    {
+        const shape_type& grid = m_state->grid_shape;
+        size_type i = 0;
+        for (size_type d = 0; first != last; ++first, ++d)
+        {
+            i = i * grid[d] + static_cast<size_type>(*first);
+        }
+        return i;
+    }
+
+    template <class C>
+    inline auto xchunk_file_store<C>::fetch(size_type i, bool dirty) const -> reference
+    {
+        state_type& st = *m_state;
+        std::lock_guard<std::mutex> lock(st.mutex);
+        auto it = st.chunks.find(i);
+        if (it != st.chunks.end())
+        {
+            st.lru.splice(st.lru.begin(), st.lru, it->second.position);
+            it->second.dirty = it->second.dirty || dirty;
+            return it->second.chunk;
+        }
+
+        C chunk;
+        auto p = st.pending.find(i);
+        if (p != st.pending.end())
+        {
+            std::future<C> f = std::move(p->second);
+            st.pending.erase(p);
+            chunk = f.get();
+        }
+        else
+        {
+            chunk = load_chunk(chunk_filename(i), chunk_box(i));
+        }
+        while (st.chunks.size() >= st.capacity)
+        {
+            evict();
+        }
+        st.lru.push_front(i);
+        auto res = st.chunks.emplace(i, entry{std::move(chunk), dirty, st.lru.begin()});
+        schedule_prefetch(i);
+        return res.first->second.chunk;
+    }
+
+    // The chunk is erased once written, so that it is not lost if the
+    // write fails.
+    template <class C>
+    inline void xchunk_file_store<C>::evict() const
+    {
+        state_type& st = *m_state;
+        size_type victim = st.lru.back();
+        auto it = st.chunks.find(victim);
+        if (it->second.dirty)
+        {
+            dump_npy(chunk_filename(victim), it->second.chunk);
+        }
+        st.chunks.erase(it);
+        st.lru.pop_back();
+    }
+
+    // The background tasks only read their file: a chunk is not read ahead
+    // while it is held in memory, and thus while it may be written back.
+    template <class C>
+    inline void xchunk_file_store<C>::schedule_prefetch(size_type i) const
+    {
+        state_type& st = *m_state;
+        size_type n = size();
+        for (size_type j = i + 1; j <= i + st.prefetch && j < n; ++j)
+        {
+            if (st.chunks.find(j) == st.chunks.end() && st.pending.find(j) == st.pending.end())
+            {
+                st.pending.emplace(j, std::async(std::launch::async, &self_type::load_chunk, chunk_filename(j), chunk_box(j)));
+            }
+        }
+    }
+
+    template <class C>
+    inline void xchunk_file_store<C>::write_dirty() const
+    {
+        for (auto& c : m_state->chunks)
+        {
+            if (c.second.dirty)
+            {
+                dump_npy(chunk_filename(c.first), c.second.chunk);
+                c.second.dirty = false;
+            }
+        }
+    }
+
+    // Shape of the chunk i, truncated at the upper edges of the array.
+    template <class C>
+    inline auto xchunk_file_store<C>::chunk_box(size_type i) const -> chunk_shape_type
+    {
+        const state_type& st = *m_state;
+        size_type dim = st.grid_shape.size();
+        chunk_shape_type box = xtl::make_sequence<chunk_shape_type>(dim, size_type(0));
+        for (size_type d = dim; d > 0; --d)
+        {
+            size_type origin = (i % st.grid_shape[d - 1]) * st.chunk_shape[d - 1];
+            box[d - 1] = std::min(st.chunk_shape[d - 1], st.shape[d - 1] - origin);
+            i /= st.grid_shape[d - 1];
+        }
+        return box;
+    }
+
+    template <class C>
+    inline C xchunk_file_store<C>::load_chunk(const std::string& filename, const chunk_shape_type& box)
+    {
+        C chunk;
+        std::ifstream stream(filename, std::ifstream::binary);
+        if (!stream)
+        {
+            chunk.resize(box);
+            chunk.fill(typename C::value_type());
+            return chunk;
+        }
+        load_npy_into(stream, chunk);
+        if (chunk.dimension() != box.size() || !std::equal(box.cbegin(), box.cend(), chunk.shape().cbegin()))
+        {
+            throw std::runtime_error("xchunk_file_store: the shape of the chunk in " + filename + " does not match the array");
+        }
+        return chunk;
+    }
+
+    /*****************************************
+     * chunked_file_array builder functions *
+     *****************************************/
+
+    /**
+     * Builds a chunked array of elements of type \c T whose chunks are kept
+     * in npy files, see \ref xchunk_file_store. The existing chunk files are
+     * read on demand, the missing ones hold zeros.
+     * @tparam T the value type of the array
+     * @tparam L the layout of the chunks
+     * @param prefix the prefix of the chunk file names
+     * @param shape the shape of the array
+     * @param chunk_shape the shape of the chunks
+     * @param capacity the maximal number of chunks held in memory
+     * @param prefetch the number of chunks read ahead in the background
+     */
+    template <class T, layout_type L, class S>
+    inline xchunked_array<xchunk_file_store<detail::chunk_container_t<T, S, L>>>
+    chunked_file_array(const std::string& prefix, const S& shape, const S& chunk_shape,
+                       std::size_t capacity, std::size_t prefetch)
+    {
+        using store_type = xchunk_file_store<detail::chunk_container_t<T, S, L>>;
+        return xchunked_array<store_type>(shape, chunk_shape, store_type(prefix, capacity, prefetch));
+    }
+
+#ifndef X_OLD_CLANG
+    template <class T, layout_type L, class I, std::size_t N>
+    inline xchunked_array<xchunk_file_store<detail::chunk_container_t<T, std::array<std::size_t, N>, L>>>
+    chunked_file_array(const std::string& prefix, const I (&shape)[N], const I (&chunk_shape)[N],
+                       std::size_t capacity, std::size_t prefetch)
+    {
+        using shape_type = std::array<std::size_t, N>;
+        return chunked_file_array<T, L>(prefix, xtl::forward_sequence<shape_type>(shape),
+                                        xtl::forward_sequence<shape_type>(chunk_shape), capacity, prefetch);
+    }
+#endif
+}
+
+#endif
@@ -0,0 +1,1308 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_CHUNKED_ARRAY_HPP
+#define XTENSOR_CHUNKED_ARRAY_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <xtl/xsequence.hpp>
+
+#include "xarray.hpp"
+#include "xassign.hpp"
+#include "xexception.hpp"
+#include "xexpression.hpp"
+#include "xiterable.hpp"
+#include "xparallel.hpp"
+#include "xscalar.hpp"
+#include "xsemantic.hpp"
+#include "xshape.hpp"
+#include "xstrides.hpp"
+#include "xtensor.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+
+    /****************************
+     * xchunked_array extension *
+     ****************************/
+
+    namespace extension
+    {
+        template <class Tag, class CS>
+        struct xchunked_array_base_impl;
+
+        template <class CS>
+        struct xchunked_array_base_impl<xtensor_expression_tag, CS>
+        {
+            using type = xtensor_empty_base;
+        };
+
+        template <class CS>
+        struct xchunked_array_base
+            : xchunked_array_base_impl<xexpression_tag_t<typename CS::value_type>, CS>
+        {
+        };
+
+        template <class CS>
+        using xchunked_array_base_t = typename xchunked_array_base<CS>::type;
+    }
+
+    namespace detail
+    {
+        // Stores sizing their chunks themselves, such as the stores loading
+        // them on demand, provide resize_chunks(shape, chunk_shape); their
+        // chunks are visited by a single thread.
+        template <class CS, class = void>
+        struct has_resize_chunks : std::false_type
+        {
+        };
+
+        template <class CS>
+        struct has_resize_chunks<CS, void_t<decltype(std::declval<CS&>().resize_chunks(std::declval<const std::vector<std::size_t>&>(),
+                                                                                       std::declval<const std::vector<std::size_t>&>()))>>
+            : std::true_type
+        {
+        };
+    }
+
+    /*********************
+     * xchunked_semantic *
+     *********************/
+
+    /**
+     * @class xchunked_semantic
+     * @brief Implementation of the xsemantic_base interface for chunked
+     * arrays.
+     *
+     * The xchunked_semantic class evaluates the right-hand side of the
+     * assignments chunk by chunk, in parallel over the chunks when
+     * XTENSOR_PARALLEL_ENABLED is defined. Computed assignments do not
+     * build a temporary of the whole array either: the left-hand side may
+     * appear in the right-hand side only at the position being assigned.
+     *
+     * @tparam D the derived type
+     */
+    template <class D>
+    class xchunked_semantic : public xsemantic_base<D>
+    {
+    public:
+
+        using base_type = xsemantic_base<D>;
+        using derived_type = D;
+        using temporary_type = typename base_type::temporary_type;
+
+        using base_type::operator+=;
+        using base_type::operator-=;
+        using base_type::operator*=;
+        using base_type::operator/=;
+        using base_type::operator%=;
+        using base_type::operator&=;
+        using base_type::operator|=;
+        using base_type::operator^=;
+
+        template <class E>
+        derived_type& operator+=(const xexpression<E>&);
+
+        template <class E>
+        derived_type& operator-=(const xexpression<E>&);
+
+        template <class E>
+        derived_type& operator*=(const xexpression<E>&);
+
+        template <class E>
+        derived_type& operator/=(const xexpression<E>&);
+
+        template <class E>
+        derived_type& operator%=(const xexpression<E>&);
+
+        template <class E>
+        derived_type& operator&=(const xexpression<E>&);
+
+        template <class E>
+        derived_type& operator|=(const xexpression<E>&);
+
+        template <class E>
+        derived_type& operator^=(const xexpression<E>&);
+
+        derived_type& assign_temporary(temporary_type&&);
+
+        template <class E>
+        derived_type& assign_xexpression(const xexpression<E>& e);
+
+        template <class E>
+        derived_type& computed_assign(const xexpression<E>& e);
+
+        template <class E, class F>
+        derived_type& scalar_computed_assign(const E& e, F&& f);
+
+    protected:
+
+        xchunked_semantic() = default;
+        ~xchunked_semantic() = default;
+
+        xchunked_semantic(const xchunked_semantic&) = default;
+        xchunked_semantic& operator=(const xchunked_semantic&) = default;
+
+        xchunked_semantic(xchunked_semantic&&) = default;
+        xchunked_semantic& operator=(xchunked_semantic&&) = default;
+
+        template <class E>
+        derived_type& operator=(const xexpression<E>&);
+
+        template <class F>
+        void apply_chunks(F&& f);
+
+    private:
+
+        template <class E>
+        void assign_chunks(const E& e);
+    };
+
+    /******************
+     * xchunked_array *
+     ******************/
+
+    template <class CS>
+    class xchunked_array;
+
+    template <class CS>
+    struct xcontainer_inner_types<xchunked_array<CS>>
+    {
+        using temporary_type = xchunked_array<CS>;
+    };
+
+    template <class CS>
+    struct xiterable_inner_types<xchunked_array<CS>>
+    {
+        using inner_shape_type = typename CS::value_type::shape_type;
+        using const_stepper = xindexed_stepper<xchunked_array<CS>, true>;
+        using stepper = xindexed_stepper<xchunked_array<CS>, false>;
+    };
+
+    /**
+     * @class xchunked_array
+     * @brief Multidimensional array stored as a grid of chunks.
+     *
+     * The xchunked_array class holds its elements in chunks of the same
+     * shape (the chunks at the upper edges of the array are truncated to
+     * the shape of the array), each one being a dense container. It is an
+     * \ref xexpression with the usual element access and steppers, and
+     * exposes its chunks through \ref chunks and \ref for_each_chunk.
+     *
+     * Assigning an expression to a chunked array evaluates it chunk by
+     * chunk, so that the elements written stay in cache, and in parallel
+     * over the chunks when XTENSOR_PARALLEL_ENABLED is defined:
+     *
+     * \code{.cpp}
+     * auto a = xt::chunked_array<double>({10000, 10000}, {1000, 1000});
+     * a = xt::sin(b) + 2. * c;
+     * a += 1.;
+     * \endcode
+     *
+     * Element access has to locate the chunk first, loops over the chunks
+     * are much faster than loops over the elements.
+     *
+     * @tparam CS the chunk storage, an \ref xarray of chunks by default.
+     * The storage must provide the chunk type as \c value_type, a
+     * \c shape_type, and the \c shape, \c size, \c resize and \c element
+     * methods of xarray. Stores that size their chunks themselves, such as
+     * \ref xchunk_file_store, provide \c resize_chunks(shape, chunk_shape)
+     * instead of \c resize; their chunks are visited by a single thread.
+     */
+    template <class CS>
+    class xchunked_array : public xchunked_semantic<xchunked_array<CS>>,
+                           public xiterable<xchunked_array<CS>>,
+                           public extension::xchunked_array_base_t<CS>
+    {
+    public:
+
+        using self_type = xchunked_array<CS>;
+        using semantic_base = xchunked_semantic<self_type>;
+        using chunk_storage_type = CS;
+        using chunk_type = typename CS::value_type;
+        using grid_shape_type = typename CS::shape_type;
+
+        using extension_base = extension::xchunked_array_base_t<CS>;
+        using expression_tag = typename extension_base::expression_tag;
+
+        using value_type = typename chunk_type::value_type;
+        using reference = typename chunk_type::reference;
+        using const_reference = typename chunk_type::const_reference;
+        using pointer = typename chunk_type::pointer;
+        using const_pointer = typename chunk_type::const_pointer;
+        using size_type = typename chunk_type::size_type;
+        using difference_type = typename chunk_type::difference_type;
+
+        using iterable_base = xiterable<self_type>;
+        using inner_shape_type = typename iterable_base::inner_shape_type;
+        using shape_type = inner_shape_type;
+        using index_type = xindex_type_t<shape_type>;
+
+        using stepper = typename iterable_base::stepper;
+        using const_stepper = typename iterable_base::const_stepper;
+
+        using temporary_type = typename xcontainer_inner_types<self_type>::temporary_type;
+
+        static constexpr layout_type static_layout = layout_type::dynamic;
+        static constexpr bool contiguous_layout = false;
+
+        template <class S1, class S2, class = disable_xexpression<S1>>
+        xchunked_array(const S1& shape, const S2& chunk_shape);
+
+        template <class S1, class S2>
+        xchunked_array(const S1& shape, const S2& chunk_shape, chunk_storage_type chunks);
+
+        template <class E, class S>
+        xchunked_array(const xexpression<E>& e, const S& chunk_shape);
+
+        ~xchunked_array() = default;
+
+        xchunked_array(const xchunked_array&) = default;
+        xchunked_array& operator=(const xchunked_array&) = default;
+
+        xchunked_array(xchunked_array&&) = default;
+        xchunked_array& operator=(xchunked_array&&) = default;
+
+        template <class E>
+        self_type& operator=(const xexpression<E>& e);
+
+        template <class E>
+        disable_xexpression<E, self_type>& operator=(const E& e);
+
+        size_type size() const noexcept;
+        size_type dimension() const noexcept;
+        const inner_shape_type& shape() const noexcept;
+        layout_type layout() const noexcept;
+
+        template <class S>
+        void resize(const S& shape);
+
+        template <class T>
+        void fill(const T& value);
+
+        template <class... Args>
+        reference operator()(Args... args);
+        template <class... Args>
+        reference at(Args... args);
+        template <class... Args>
+        reference unchecked(Args... args);
+        template <class S>
+        disable_integral_t<S, reference> operator[](const S& index);
+        template <class I>
+        reference operator[](std::initializer_list<I> index);
+        reference operator[](size_type i);
+
+        template <class It>
+        reference element(It first, It last);
+
+        template <class... Args>
+        const_reference operator()(Args... args) const;
+        template <class... Args>
+        const_reference at(Args... args) const;
+        template <class... Args>
+        const_reference unchecked(Args... args) const;
+        template <class S>
+        disable_integral_t<S, const_reference> operator[](const S& index) const;
+        template <class I>
+        const_reference operator[](std::initializer_list<I> index) const;
+        const_reference operator[](size_type i) const;
+
+        template <class It>
+        const_reference element(It first, It last) const;
+
+        const inner_shape_type& chunk_shape() const noexcept;
+        const grid_shape_type& grid_shape() const noexcept;
+        size_type chunk_count() const noexcept;
+
+        chunk_storage_type& chunks() noexcept;
+        const chunk_storage_type& chunks() const noexcept;
+
+        template <class F>
+        void for_each_chunk(F&& f);
+        template <class F>
+        void for_each_chunk(F&& f) const;
+        template <class F>
+        void for_each_chunk(size_type first, size_type last, F&& f);
+        template <class F>
+        void for_each_chunk(size_type first, size_type last, F&& f) const;
+
+        template <class O>
+        bool broadcast_shape(O& shape, bool reuse_cache = false) const;
+
+        template <class O>
+        bool has_linear_assign(const O& /*strides*/) const noexcept;
+
+        template <class ST>
+        stepper stepper_begin(const ST& shape);
+        template <class ST>
+        stepper stepper_end(const ST& shape, layout_type);
+
+        template <class ST>
+        const_stepper stepper_begin(const ST& shape) const;
+        template <class ST>
+        const_stepper stepper_end(const ST& shape, layout_type) const;
+
+    private:
+
+        using grid_index_type = xindex_type_t<grid_shape_type>;
+
+        template <class S>
+        void check_chunk_shape(const S& chunk_shape) const;
+
+        void resize_chunks(std::true_type /*store sizes the chunks*/);
+        void resize_chunks(std::false_type /*store sizes the chunks*/);
+
+        template <class It>
+        void chunk_indices(It first, It last, grid_index_type& grid, index_type& local) const;
+
+        void chunk_position(size_type i, grid_index_type& grid, index_type& origin) const;
+
+        template <class ST, class F>
+        static void visit_chunks(ST& st, size_type first, size_type last, F&& f);
+
+        inner_shape_type m_shape;
+        inner_shape_type m_chunk_shape;
+        detail::shape_divider m_chunk_divider;
+        chunk_storage_type m_chunks;
+    };
+
+    namespace detail
+    {
+        template <class T, class S, layout_type L, bool = (static_dimension<S>::value >= 0)>
+        struct chunk_container
+        {
+            using type = xarray<T, L>;
+        };
+
+        template <class T, class S, layout_type L>
+        struct chunk_container<T, S, L, true>
+        {
+            using type = xtensor<T, static_cast<std::size_t>(static_dimension<S>::value), L>;
+        };
+
+        template <class T, class S, layout_type L>
+        using chunk_container_t = typename chunk_container<T, S, L>::type;
+
+        template <class T, class S, layout_type L>
+        using chunked_array_type_t = xchunked_array<xarray<chunk_container_t<T, S, L>>>;
+    }
+
+    template <class T, layout_type L = XTENSOR_DEFAULT_LAYOUT, class S>
+    detail::chunked_array_type_t<T, S, L> chunked_array(const S& shape, const S& chunk_shape);
+
+#ifndef X_OLD_CLANG
+    template <class T, layout_type L = XTENSOR_DEFAULT_LAYOUT, class I, std::size_t N>
+    detail::chunked_array_type_t<T, std::array<std::size_t, N>, L> chunked_array(const I (&shape)[N], const I (&chunk_shape)[N]);
+#endif
+
+    /************************************
+     * xchunked_semantic implementation *
+     ************************************/
+
+    namespace detail
+    {
+        /**
+         * Assigns the elements of the box of the expression starting at
+         * origin and having the shape of the chunk, the stepper src being
+         * at the beginning of the expression broadcast to the shape of the
+         * chunked array.
+         */
+        template <class C, class ST, class O>
+        inline void assign_chunk(C& chunk, ST src, const O& origin)
+        {
+            using size_type = typename C::size_type;
+            using value_type = typename C::value_type;
+
+            const auto& box = chunk.shape();
+            size_type dim = box.size();
+            for (size_type d = 0; d < dim; ++d)
+            {
+                src.step(d, origin[d]);
+            }
+            auto dst = chunk.stepper_begin(box);
+            if (dim == 0)
+            {
+                *dst = static_cast<value_type>(*src);
+                return;
+            }
+
+            size_type last = dim - 1;
+            size_type inner = box[last];
+            size_type outer = chunk.size() / inner;
+            auto index = xtl::make_sequence<xindex_type_t<typename C::shape_type>>(dim, size_type(0));
+            for (size_type o = 0; o < outer; ++o)
+            {
+                for (size_type i = 0; i < inner; ++i)
+                {
+                    *dst = static_cast<value_type>(*src);
+                    dst.step(last);
+                    src.step(last);
+                }
+                dst.step_back(last, inner);
+                src.step_back(last, inner);
+                for (size_type d = last; d > 0; --d)
+                {
+                    if (++index[d - 1] < box[d - 1])
+                    {
+                        dst.step(d - 1);
+                        src.step(d - 1);
+                        break;
+                    }
+                    index[d - 1] = 0;
+                    dst.step_back(d - 1, box[d - 1] - 1);
+                    src.step_back(d - 1, box[d - 1] - 1);
+                }
+            }
+        }
+    }
+
+    /**
+     * @name Computed assignement
+     */
+    //@{
+    /**
+     * Adds the xexpression \c e to \c *this, chunk by chunk.
+     * @param e the xexpression to add.
+     * @return a reference to \c *this.
+     */
+    template <class D>
+    template <class E>
+    inline auto xchunked_semantic<D>::operator+=(const xexpression<E>& e) -> derived_type&
+    {
+        return computed_assign(this->derived_cast() + e.derived_cast());
+    }
+
+    /**
+     * Subtracts the xexpression \c e from \c *this, chunk by chunk.
+     * @param e the xexpression to subtract.
+     * @return a reference to \c *this.
+     */
+    template <class D>
+    template <class E>
+    inline auto xchunked_semantic<D>::operator-=(const xexpression<E>& e) -> derived_type&
+    {
+        return computed_assign(this->derived_cast() - e.derived_cast());
+    }
+
+    /**
+     * Multiplies \c *this with the xexpression \c e, chunk by chunk.
+     * @param e the xexpression involved in the operation.
+     * @return a reference to \c *this.
+     */
+    template <class D>
+    template <class E>
+    inline auto xchunked_semantic<D>::operator*=(const xexpression<E>& e) -> derived_type&
+    {
+        return computed_assign(this->derived_cast() * e.derived_cast());
+    }
+
+    /**
+     * Divides \c *this by the xexpression \c e, chunk by chunk.
+     * @param e the xexpression involved in the operation.
+     * @return a reference to \c *this.
+     */
+    template <class D>
+    template <class E>
+    inline auto xchunked_semantic<D>::operator/=(const xexpression<E>& e) -> derived_type&
+    {
+        return computed_assign(this->derived_cast() / e.derived_cast());
+    }
+
+    /**
+     * Computes the remainder of \c *this after division by the xexpression
+     * \c e, chunk by chunk.
+     * @param e the xexpression involved in the operation.
+     * @return a reference to \c *this.
+     */
+    template <class D>
+    template <class E>
+    inline auto xchunked_semantic<D>::operator%=(const xexpression<E>& e) -> derived_type&
+    {
+        return computed_assign(this->derived_cast() % e.derived_cast());
+    }
+
+    /**
+     * Computes the bitwise and of \c *this and the xexpression \c e, chunk
+     * by chunk.
+     * @param e the xexpression involved in the operation.
+     * @return a reference to \c *this.
+     */
+    template <class D>
+    template <class E>
+    inline auto xchunked_semantic<D>::operator&=(const xexpression<E>& e) -> derived_type&
+    {
+        return computed_assign(this->derived_cast() & e.derived_cast());
+    }
+
+    /**
+     * Computes the bitwise or of \c *this and the xexpression \c e, chunk
+     * by chunk.
+     * @param e the xexpression involved in the operation.
+     * @return a reference to \c *this.
+     */
+    template <class D>
+    template <class E>
+    inline auto xchunked_semantic<D>::operator|=(const xexpression<E>& e) -> derived_type&
+    {
+        return computed_assign(this->derived_cast() | e.derived_cast());
+    }
+
+    /**
+     * Computes the bitwise xor of \c *this and the xexpression \c e, chunk
+     * by chunk.
+     * @param e the xexpression involved in the operation.
+     * @return a reference to \c *this.
+     */
+    template <class D>
+    template <class E>
+    inline auto xchunked_semantic<D>::operator^=(const xexpression<E>& e) -> derived_type&
+    {
+        return computed_assign(this->derived_cast() ^ e.derived_cast());
+    }
+    //@}
+
+    /**
+     * Assigns the temporary \c tmp to \c *this.
+     * @param tmp the temporary to assign.
+     * @return a reference to \c *this.
+     */
+    template <class D>
+    inline auto xchunked_semantic<D>::assign_temporary(temporary_type&& tmp) -> derived_type&
+    {
+        return (this->derived_cast() = std::move(tmp));
+    }
+
+    /**
+     * Assigns the xexpression \c e to \c *this chunk by chunk, after
+     * resizing \c *this to the shape of \c e if needed. The chunk shape
+     * is kept.
+     */
+    template <class D>
+    template <class E>
+    inline auto xchunked_semantic<D>::assign_xexpression(const xexpression<E>& e) -> derived_type&
+    {
+        D& d = this->derived_cast();
+        const E& de = e.derived_cast();
+        const auto& shape = de.shape();
+        if (shape.size() != d.dimension() || !std::equal(shape.cbegin(), shape.cend(), d.shape().cbegin()))
+        {
+            d.resize(shape);
+        }
+        assign_chunks(de);
+        return d;
+    }
+
+    /**
+     * Assigns the xexpression \c e, whose shape must broadcast to the
+     * shape of \c *this, chunk by chunk.
+     * @throw broadcast_error if the shape of \c e does not broadcast to
+     * the shape of \c *this.
+     */
+    template <class D>
+    template <class E>
+    inline auto xchunked_semantic<D>::computed_assign(const xexpression<E>& e) -> derived_type&
+    {
+        D& d = this->derived_cast();
+        const E& de = e.derived_cast();
+        if (!broadcastable(de.shape(), d.shape()))
+        {
+            throw_broadcast_error(de.shape(), d.shape());
+        }
+        assign_chunks(de);
+        return d;
+    }
+
+    template <class D>
+    template <class E, class F>
+    inline auto xchunked_semantic<D>::scalar_computed_assign(const E& e, F&& f) -> derived_type&
+    {
+        apply_chunks([&e, &f](auto& chunk, const auto&) {
+            xt::scalar_computed_assign(chunk, e, f);
+        });
+        return this->derived_cast();
+    }
+
+    template <class D>
+    template <class E>
+    inline auto xchunked_semantic<D>::operator=(const xexpression<E>& e) -> derived_type&
+    {
+        return assign_xexpression(e);
+    }
+
+    /**
+     * Calls f(chunk, origin) for each chunk, in parallel over the chunks
+     * when XTENSOR_PARALLEL_ENABLED is defined and the array is large
+     * enough according to the parallel settings.
+     */
+    template <class D>
+    template <class F>
+    inline void xchunked_semantic<D>::apply_chunks(F&& f)
+    {
+        D& d = this->derived_cast();
+        std::size_t n = d.chunk_count();
+#if defined(XTENSOR_PARALLEL_ENABLED)
+        if (!detail::has_resize_chunks<typename D::chunk_storage_type>::value && n > 1 && parallel::use_parallel(d.size()))
+        {
+            std::size_t chunk_size = compute_size(d.chunk_shape());
+            parallel_for(std::size_t(0), n, parallel::grain(chunk_size), [&d, &f](std::size_t first, std::size_t last) {
+                d.for_each_chunk(first, last, f);
+            });
+            return;
+        }
+#endif
+        d.for_each_chunk(std::size_t(0), n, f);
+    }
+
+    template <class D>
+    template <class E>
+    inline void xchunked_semantic<D>::assign_chunks(const E& e)
+    {
+        const auto& shape = this->derived_cast().shape();
+        apply_chunks([&e, &shape](auto& chunk, const auto& origin) {
+            detail::assign_chunk(chunk, e.stepper_begin(shape), origin);
+        });
+    }
+
+    /*********************************
+     * xchunked_array implementation *
+     *********************************/
+
+    /**
+     * @name Constructors
+     */
+    //@{
+    /**
+     * Allocates a chunked array with the specified shape, split in chunks of
+     * shape \c chunk_shape. The elements are not initialized.
+     * @param shape the shape of the array
+     * @param chunk_shape the shape of the chunks
+     * @throw std::runtime_error if the chunk shape has a different dimension
+     * from the shape or a zero extent.
+     */
+    template <class CS>
+    template <class S1, class S2, class>
+    inline xchunked_array<CS>::xchunked_array(const S1& shape, const S2& chunk_shape)
+        : xchunked_array(shape, chunk_shape, chunk_storage_type())
+    {
+    }
+
+    /**
+     * Builds a chunked array with the specified shape over the chunk store
+     * \c chunks, split in chunks of shape \c chunk_shape.
+     * @param shape the shape of the array
+     * @param chunk_shape the shape of the chunks
+     * @param chunks the chunk store
+     * @throw std::runtime_error if the chunk shape has a different dimension
+     * from the shape or a zero extent.
+     */
+    template <class CS>
+    template <class S1, class S2>
+    inline xchunked_array<CS>::xchunked_array(const S1& shape, const S2& chunk_shape, chunk_storage_type chunks)
+        : m_chunks(std::move(chunks))
+    {
+        check_chunk_shape(chunk_shape);
+        m_chunk_shape = xtl::make_sequence<inner_shape_type>(chunk_shape.size(), size_type(0));
+        std::copy(chunk_shape.cbegin(), chunk_shape.cend(), m_chunk_shape.begin());
+        m_chunk_divider = detail::shape_divider(m_chunk_shape);
+        if (shape.size() != m_chunk_shape.size())
+        {
+            throw std::runtime_error("xchunked_array: the chunk shape must have the dimension of the shape");
+        }
+        resize(shape);
+    }
+
+    /**
+     * Builds a chunked array with chunks of shape \c chunk_shape from the
+     * xexpression \c e, which is evaluated chunk by chunk.
+     * @param e the xexpression to evaluate
+     * @param chunk_shape the shape of the chunks
+     */
+    template <class CS>
+    template <class E, class S>
+    inline xchunked_array<CS>::xchunked_array(const xexpression<E>& e, const S& chunk_shape)
+        : xchunked_array(e.derived_cast().shape(), chunk_shape)
+    {
+        semantic_base::assign_xexpression(e);
+    }
+    //@}
+
+    /**
+     * @name Extended copy semantic
+     */
+    //@{
+    /**
+     * The extended assignment operator, evaluates \c e chunk by chunk.
+     * Unlike the other containers, no temporary of the whole array is
+     * built: \c *this may appear in \c e only at the position being
+     * assigned.
+     */
+    template <class CS>
+    template <class E>
+    inline auto xchunked_array<CS>::operator=(const xexpression<E>& e) -> self_type&
+    {
+        return semantic_base::operator=(e);
+    }
+    //@}
+
+    /**
+     * Assigns the scalar \c e to all the elements.
+     */
+    template <class CS>
+    template <class E>
+    inline auto xchunked_array<CS>::operator=(const E& e) -> disable_xexpression<E, self_type>&
+    {
+        fill(e);
+        return *this;
+    }
+
+    /**
+     * @name Size and shape
+     */
+    //@{
+    /**
+     * Returns the number of elements of the array.
+     */
+    template <class CS>
+    inline auto xchunked_array<CS>::size() const noexcept -> size_type
+    {
+        return compute_size(m_shape);
+    }
+
+    /**
+     * Returns the number of dimensions of the array.
+     */
+    template <class CS>
+    inline auto xchunked_array<CS>::dimension() const noexcept -> size_type
+    {
+        return m_shape.size();
+    }
+
+    /**
+     * Returns the shape of the array.
+     */
+    template <class CS>
+    inline auto xchunked_array<CS>::shape() const noexcept -> const inner_shape_type&
+    {
+        return m_shape;
+    }
+
+    template <class CS>
+    inline layout_type xchunked_array<CS>::layout() const noexcept
+    {
+        return static_layout;
+    }
+
+    /**
+     * Resizes the array to \c shape, keeping the chunk shape. The elements
+     * are not preserved.
+     * @param shape the new shape, whose dimension must be the one of the
+     * chunk shape
+     */
+    template <class CS>
+    template <class S>
+    inline void xchunked_array<CS>::resize(const S& shape)
+    {
+        if (shape.size() != m_chunk_shape.size())
+        {
+            throw std::runtime_error("xchunked_array: the chunk shape must have the dimension of the shape");
+        }
+        size_type dim = shape.size();
+        m_shape = xtl::make_sequence<inner_shape_type>(dim, size_type(0));
+        std::copy(shape.cbegin(), shape.cend(), m_shape.begin());
+        resize_chunks(std::integral_constant<bool, detail::has_resize_chunks<CS>::value>());
+    }
+    //@}
+
+    template <class CS>
+    inline void xchunked_array<CS>::resize_chunks(std::true_type)
+    {
+        m_chunks.resize_chunks(m_shape, m_chunk_shape);
+    }
+
+    template <class CS>
+    inline void xchunked_array<CS>::resize_chunks(std::false_type)
+    {
+        size_type dim = m_shape.size();
+        grid_shape_type grid = xtl::make_sequence<grid_shape_type>(dim, size_type(0));
+        for (size_type d = 0; d < dim; ++d)
+        {
+            grid[d] = (m_shape[d] + m_chunk_shape[d] - 1) / m_chunk_shape[d];
+        }
+        m_chunks.resize(grid);
+
+        inner_shape_type box = m_chunk_shape;
+        grid_index_type grid_index = xtl::make_sequence<grid_index_type>(dim, size_type(0));
+        index_type origin = xtl::make_sequence<index_type>(dim, size_type(0));
+        for (size_type i = 0; i < m_chunks.size(); ++i)
+        {
+            chunk_position(i, grid_index, origin);
+            for (size_type d = 0; d < dim; ++d)
+            {
+                box[d] = std::min(m_chunk_shape[d], m_shape[d] - origin[d]);
+            }
+            m_chunks.element(grid_index.cbegin(), grid_index.cend()).resize(box);
+        }
+    }
+
+    /**
+     * Fills the array with the given value.
+     * @param value the value to fill the array with.
+     */
+    template <class CS>
+    template <class T>
+    inline void xchunked_array<CS>::fill(const T& value)
+    {
+        semantic_base::apply_chunks([&value](auto& chunk, const auto&) {
+            chunk.fill(value);
+        });
+    }
+
+    /**
+     * @name Data
+     */
+    //@{
+    /**
+     * Returns a reference to the element at the specified position in the array.
+     * @param args a list of indices specifying the position in the array. Indices
+     * must be unsigned integers, the number of indices should be equal or greater
+     * than the number of dimensions of the array.
+     */
+    template <class CS>
+    template <class... Args>
+    inline auto xchunked_array<CS>::operator()(Args... args) -> reference
+    {
+        XTENSOR_TRY(check_index(shape(), args...));
+        std::array<size_type, sizeof...(Args)> index = {{static_cast<size_type>(args)...}};
+        return element(index.cbegin(), index.cend());
+    }
+
+    /**
+     * Returns a reference to the element at the specified position in the
+     * array, after dimension and bounds checking.
+     * @param args a list of indices specifying the position in the array. Indices
+     * must be unsigned integers, the number of indices should be equal to the
+     * number of dimensions of the array.
+     * @exception std::out_of_range if the number of argument is greater than the
+     * number of dimensions or if indices are out of bounds.
+     */
+    template <class CS>
+    template <class... Args>
+    inline auto xchunked_array<CS>::at(Args... args) -> reference
+    {
+        check_access(shape(), static_cast<size_type>(args)...);
+        return this->operator()(args...);
+    }
+
+    /**
+     * Returns a reference to the element at the specified position in the
+     * array. The number of indices must be equal to the number of dimensions
+     * of the array, else the behavior is undefined.
+     */
+    template <class CS>
+    template <class... Args>
+    inline auto xchunked_array<CS>::unchecked(Args... args) -> reference
+    {
+        std::array<size_type, sizeof...(Args)> index = {{static_cast<size_type>(args)...}};
+        return element(index.cbegin(), index.cend());
+    }
+
+    /**
+     * Returns a reference to the element at the specified position in the array.
+     * @param index a sequence of indices specifying the position in the array.
+     * Indices must be unsigned integers, the number of indices in the sequence
+     * should be equal or greater than the number of dimensions of the array.
+     */
+    template <class CS>
+    template <class S>
+    inline auto xchunked_array<CS>::operator[](const S& index) -> disable_integral_t<S, reference>
+    {
+        return element(index.cbegin(), index.cend());
+    }
+
+    template <class CS>
+    template <class I>
+    inline auto xchunked_array<CS>::operator[](std::initializer_list<I> index) -> reference
+    {
+        return element(index.begin(), index.end());
+    }
+
+    template <class CS>
+    inline auto xchunked_array<CS>::operator[](size_type i) -> reference
+    {
+        return operator()(i);
+    }
+
+    /**
+     * Returns a reference to the element at the specified position in the array.
+     * @param first iterator starting the sequence of indices
+     * @param last iterator ending the sequence of indices
+     * The number of indices in the sequence should be equal to or greater
+     * than the number of dimensions of the array.
+     */
+    template <class CS>
+    template <class It>
+    inline auto xchunked_array<CS>::element(It first, It last) -> reference
+    {
+        grid_index_type grid = xtl::make_sequence<grid_index_type>(dimension(), size_type(0));
+        index_type local = xtl::make_sequence<index_type>(dimension(), size_type(0));
+        chunk_indices(first, last, grid, local);
+        return m_chunks.element(grid.cbegin(), grid.cend()).element(local.cbegin(), local.cend());
+    }
+
+    /**
+     * Returns a constant reference to the element at the specified position in the array.
+     * @param args a list of indices specifying the position in the array. Indices
+     * must be unsigned integers, the number of indices should be equal or greater
+     * than the number of dimensions of the array.
+     */
+    template <class CS>
+    template <class... Args>
+    inline auto xchunked_array<CS>::operator()(Args... args) const -> const_reference
+    {
+        XTENSOR_TRY(check_index(shape(), args...));
+        std::array<size_type, sizeof...(Args)> index = {{static_cast<size_type>(args)...}};
+        return element(index.cbegin(), index.cend());
+    }
+
+    /**
+     * Returns a constant reference to the element at the specified position
+     * in the array, after dimension and bounds checking.
+     * @param args a list of indices specifying the position in the array. Indices
+     * must be unsigned integers, the number of indices should be equal to the
+     * number of dimensions of the array.
+     * @exception std::out_of_range if the number of argument is greater than the
+     * number of dimensions or if indices are out of bounds.
+     */
+    template <class CS>
+    template <class... Args>
+    inline auto xchunked_array<CS>::at(Args... args) const -> const_reference
+    {
+        check_access(shape(), static_cast<size_type>(args)...);
+        return this->operator()(args...);
+    }
+
+    /**
+     * Returns a constant reference to the element at the specified position
+     * in the array. The number of indices must be equal to the number of
+     * dimensions of the array, else the behavior is undefined.
+     */
+    template <class CS>
+    template <class... Args>
+    inline auto xchunked_array<CS>::unchecked(Args... args) const -> const_reference
+    {
+        std::array<size_type, sizeof...(Args)> index = {{static_cast<size_type>(args)...}};
+        return element(index.cbegin(), index.cend());
+    }
+
+    /**
+     * Returns a constant reference to the element at the specified position in the array.
+     * @param index a sequence of indices specifying the position in the array.
+     * Indices must be unsigned integers, the number of indices in the sequence
+     * should be equal or greater than the number of dimensions of the array.
+     */
+    template <class CS>
+    template <class S>
+    inline auto xchunked_array<CS>::operator[](const S& index) const -> disable_integral_t<S, const_reference>
+    {
+        return element(index.cbegin(), index.cend());
+    }
+
+    template <class CS>
+    template <class I>
+    inline auto xchunked_array<CS>::operator[](std::initializer_list<I> index) const -> const_reference
+    {
+        return element(index.begin(), index.end());
+    }
+
+    template <class CS>
+    inline auto xchunked_array<CS>::operator[](size_type i) const -> const_reference
+    {
+        return operator()(i);
+    }
+
+    /**
+     * Returns a constant reference to the element at the specified position in the array.
+     * @param first iterator starting the sequence of indices
+     * @param last iterator ending the sequence of indices
+     * The number of indices in the sequence should be equal to or greater
+     * than the number of dimensions of the array.
+     */
+    template <class CS>
+    template <class It>
+    inline auto xchunked_array<CS>::element(It first, It last) const -> const_reference
+    {
+        grid_index_type grid = xtl::make_sequence<grid_index_type>(dimension(), size_type(0));
+        index_type local = xtl::make_sequence<index_type>(dimension(), size_type(0));
+        chunk_indices(first, last, grid, local);
+        return m_chunks.element(grid.cbegin(), grid.cend()).element(local.cbegin(), local.cend());
+    }
+    //@}
+
+    /**
+     * @name Chunks
+     */
+    //@{
+    /**
+     * Returns the shape of the chunks. The chunks at the upper edges of the
+     * array are truncated to the shape of the array.
+     */
+    template <class CS>
+    inline auto xchunked_array<CS>::chunk_shape() const noexcept -> const inner_shape_type&
+    {
+        return m_chunk_shape;
+    }
+
+    /**
+     * Returns the shape of the grid of chunks.
+     */
+    template <class CS>
+    inline auto xchunked_array<CS>::grid_shape() const noexcept -> const grid_shape_type&
+    {
+        return m_chunks.shape();
+    }
+
+    /**
+     * Returns the number of chunks.
+     */
+    template <class CS>
+    inline auto xchunked_array<CS>::chunk_count() const noexcept -> size_type
+    {
+        return m_chunks.size();
+    }
+
+    /**
+     * Returns the storage of the chunks, whose shape is the grid shape.
+     */
+    template <class CS>
+    inline auto xchunked_array<CS>::chunks() noexcept -> chunk_storage_type&
+    {
+        return m_chunks;
+    }
+
+    /**
+     * Returns the constant storage of the chunks, whose shape is the grid shape.
+     */
+    template <class CS>
+    inline auto xchunked_array<CS>::chunks() const noexcept -> const chunk_storage_type&
+    {
+        return m_chunks;
+    }
+
+    /**
+     * Calls f(chunk, origin) for each chunk in row-major order of the grid,
+     * where origin is the index in the array of the first element of the chunk.
+     */
+    template <class CS>
+    template <class F>
+    inline void xchunked_array<CS>::for_each_chunk(F&& f)
+    {
+        visit_chunks(*this, size_type(0), chunk_count(), std::forward<F>(f));
+    }
+
+    /**
+     * Calls f(chunk, origin) for each constant chunk in row-major order of
+     * the grid, where origin is the index in the array of the first element
+     * of the chunk.
+     */
+    template <class CS>
+    template <class F>
+    inline void xchunked_array<CS>::for_each_chunk(F&& f) const
+    {
+        visit_chunks(*this, size_type(0), chunk_count(), std::forward<F>(f));
+    }
+
+    /**
+     * Calls f(chunk, origin) for the chunks of index [first, last) in
+     * row-major order of the grid.
+     */
+    template <class CS>
+    template <class F>
+    inline void xchunked_array<CS>::for_each_chunk(size_type first, size_type last, F&& f)
+    {
+        visit_chunks(*this, first, last, std::forward<F>(f));
+    }
+
+    /**
+     * Calls f(chunk, origin) for the constant chunks of index [first, last)
+     * in row-major order of the grid.
+     */
+    template <class CS>
+    template <class F>
+    inline void xchunked_array<CS>::for_each_chunk(size_type first, size_type last, F&& f) const
+    {
+        visit_chunks(*this, first, last, std::forward<F>(f));
+    }
+    //@}
+
+    /**
+     * @name Broadcasting
+     */
+    //@{
+    /**
+     * Broadcast the shape of the array to the specified parameter.
+     * @param shape the result shape
+     * @param reuse_cache parameter for internal optimization
+     * @return a boolean indicating whether the broadcasting is trivial
+     */
+    template <class CS>
+    template <class O>
+    inline bool xchunked_array<CS>::broadcast_shape(O& shape, bool) const
+    {
+        return xt::broadcast_shape(m_shape, shape);
+    }
+
+    /**
+     * Checks whether the xchunked_array can be linearly assigned to an expression
+     * with the specified strides.
+     * @return a boolean indicating whether a linear assign is possible
+     */
+    template <class CS>
+    template <class O>
+    inline bool xchunked_array<CS>::has_linear_assign(const O& /*strides*/) const noexcept
+    {
+        return false;
+    }
+    //@}
+
+    template <class CS>
+    template <class ST>
+    inline auto xchunked_array<CS>::stepper_begin(const ST& shape) -> stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return stepper(this, offset);
+    }
+
+    template <class CS>
+    template <class ST>
+    inline auto xchunked_array<CS>::stepper_end(const ST& shape, layout_type) -> stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return stepper(this, offset, true);
+    }
+
+    template <class CS>
+    template <class ST>
+    inline auto xchunked_array<CS>::stepper_begin(const ST& shape) const -> const_stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return const_stepper(this, offset);
+    }
+
+    template <class CS>
+    template <class ST>
+    inline auto xchunked_array<CS>::stepper_end(const ST& shape, layout_type) const -> const_stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return const_stepper(this, offset, true);
+    }
+
+    template <class CS>
+    template <class S>
+    inline void xchunked_array<CS>::check_chunk_shape(const S& chunk_shape) const
+    {
+        if (std::find(chunk_shape.cbegin(), chunk_shape.cend(), 0) != chunk_shape.cend())
+        {
+            throw std::runtime_error("xchunked_array: the chunk shape must not have a zero extent");
+        }
+    }
+
+    // Splits the index of an element into the index of its chunk in the grid
+    // and its index in the chunk; the leading indices beyond the dimension
+    // are ignored, the missing leading ones are 0.
+    template <class CS>
+    template <class It>
+    inline void xchunked_array<CS>::chunk_indices(It first, It last, grid_index_type& grid, index_type& local) const
+    {
+        size_type dim = dimension();
+        size_type n = static_cast<size_type>(std::distance(first, last));
+        size_type d = 0;
+        if (n > dim)
+        {
+            std::advance(first, static_cast<std::ptrdiff_t>(n - dim));
+        }
+        else
+        {
+            d = dim - n;
+        }
+        for (; d < dim; ++d, ++first)
+        {
+            std::size_t i = static_cast<std::size_t>(*first);
+            local[d] = static_cast<size_type>(m_chunk_divider[d].divmod(i));
+            grid[d] = static_cast<size_type>(i);
+        }
+    }
+
+    // Index in the grid and origin in the array of the chunk i, the chunks
+    // being numbered in row-major order of the grid.
+    template <class CS>
+    inline void xchunked_array<CS>::chunk_position(size_type i, grid_index_type& grid, index_type& origin) const
+    {
+        const auto& grid_shape = m_chunks.shape();
+        for (size_type d = grid_shape.size(); d > 0; --d)
+        {
+            grid[d - 1] = i % grid_shape[d - 1];
+            i /= grid_shape[d - 1];
+            origin[d - 1] = grid[d - 1] * m_chunk_shape[d - 1];
+        }
+    }
+
+    template <class CS>
+    template <class ST, class F>
+    inline void xchunked_array<CS>::visit_chunks(ST& st, size_type first, size_type last, F&& f)
+    {
+        size_type dim = st.dimension();
+        grid_index_type grid = xtl::make_sequence<grid_index_type>(dim, size_type(0));
+        index_type origin = xtl::make_sequence<index_type>(dim, size_type(0));
+        for (size_type i = first; i < last; ++i)
+        {
+            st.chunk_position(i, grid, origin);
+            f(st.m_chunks.element(grid.cbegin(), grid.cend()), origin);
+        }
+    }
+
+    /************************************
+     * chunked_array builder functions *
+     ************************************/
+
+    /**
+     * Builds a chunked array of elements of type \c T with the specified
+     * shape, split in chunks of shape \c chunk_shape. The chunks are
+     * xtensor containers when the dimension of \c S is known at compile
+     * time, xarray containers otherwise. The elements are not initialized.
+     * @tparam T the value type of the array
+     * @tparam L the layout of the chunks
+     * @param shape the shape of the array
+     * @param chunk_shape the shape of the chunks
+     */
+    template <class T, layout_type L, class S>
+    inline detail::chunked_array_type_t<T, S, L> chunked_array(const S& shape, const S& chunk_shape)
+    {
+        return detail::chunked_array_type_t<T, S, L>(shape, chunk_shape);
+    }
+
+#ifndef X_OLD_CLANG
+    template <class T, layout_type L, class I, std::size_t N>
+    inline detail::chunked_array_type_t<T, std::array<std::size_t, N>, L> chunked_array(const I (&shape)[N], const I (&chunk_shape)[N])
+    {
+        using shape_type = std::array<std::size_t, N>;
+        return chunked_array<T, L>(xtl::forward_sequence<shape_type>(shape), xtl::forward_sequence<shape_type>(chunk_shape));
+    }
+#endif
+}
+
+#endif
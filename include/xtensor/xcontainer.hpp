@@ -245,6 +245,20 @@ namespace xt
         inner_backstrides_type& mutable_backstrides();
     };
 
+    /**
+     * Growth policy of the data container in xstrided_container::resize.
+     * With both modes, the buffer is kept when the new size fits in its
+     * capacity, unless the container shrinks below a quarter of it.
+     */
+    enum class resize_mode
+    {
+        /// the buffer is reallocated to the exact size when it grows
+        exact,
+        /// the capacity grows geometrically, which makes repeated growth
+        /// (e.g. row by row) linear instead of quadratic
+        geometric
+    };
+
     /**
      * @class xstrided_container
      * @brief Partial implementation of xcontainer that embeds the strides and the shape
@@ -282,6 +296,11 @@ namespace xt
         void resize(S&& shape, layout_type l);
         template <class S = shape_type>
         void resize(S&& shape, const strides_type& strides);
+        template <class S = shape_type>
+        void resize(S&& shape, resize_mode mode);
+        template <class S = shape_type>
+        void resize_padded(S&& shape, layout_type l = layout_type::row_major,
+                           size_type padding = xsimd::simd_traits<value_type>::size);
 
         template <class S = shape_type>
         void reshape(S&& shape, layout_type layout = base_type::static_layout);
@@ -977,6 +996,31 @@ namespace xt
             (void) size;
             XTENSOR_ASSERT_MSG(c.size() == size, "Trying to resize const data container with wrong size.");
         }
+
+        template <class C, class = void>
+        struct has_reserve : std::false_type
+        {
+        };
+
+        template <class C>
+        struct has_reserve<C, void_t<decltype(std::declval<C&>().reserve(std::declval<C&>().capacity()))>>
+            : std::true_type
+        {
+        };
+
+        template <class C, class S>
+        inline std::enable_if_t<has_reserve<C>::value> reserve_data_container(C& c, S size)
+        {
+            if (static_cast<std::size_t>(size) > static_cast<std::size_t>(c.capacity()))
+            {
+                c.reserve(std::max(static_cast<typename C::size_type>(size), 2 * c.capacity()));
+            }
+        }
+
+        template <class C, class S>
+        inline std::enable_if_t<!has_reserve<C>::value> reserve_data_container(C&, S)
+        {
+        }
     }
 
     /**
@@ -1041,6 +1085,57 @@ namespace xt
         detail::resize_data_container(this->storage(), compute_size(m_shape));
     }
 
+    /**
+     * Resizes the container with the given growth policy. With
+     * resize_mode::geometric, the elements are preserved in the order of
+     * the data container, up to the new size: growing a row major container
+     * along its first axis keeps its rows.
+     * @param shape the new shape
+     * @param mode the growth policy of the data container
+     */
+    template <class D>
+    template <class S>
+    inline void xstrided_container<D>::resize(S&& shape, resize_mode mode)
+    {
+        if (mode == resize_mode::geometric)
+        {
+            detail::reserve_data_container(this->storage(), compute_size(shape));
+        }
+        resize(std::forward<S>(shape));
+    }
+
+    /**
+     * Resizes the container with padded rows (resp. columns): the leading
+     * dimension is rounded up to a multiple of \c padding elements, so that
+     * every row starts at the alignment of the first one and the inner loops
+     * of the assignment do not straddle rows. The padding elements are part
+     * of the data container but not of the container. Requires a container
+     * whose layout template parameter is layout_type::dynamic.
+     * @param shape the new shape
+     * @param l the order of the rows, layout_type::row_major or layout_type::column_major
+     * @param padding the number of elements the leading dimension is a multiple of,
+     *        the SIMD width of the value type by default
+     */
+    template <class D>
+    template <class S>
+    inline void xstrided_container<D>::resize_padded(S&& shape, layout_type l, size_type padding)
+    {
+        if (base_type::static_layout != layout_type::dynamic)
+        {
+            throw std::runtime_error("Cannot resize with padding when layout() is != layout_type::dynamic.");
+        }
+        if (l != layout_type::row_major && l != layout_type::column_major)
+        {
+            throw std::runtime_error("Padded layout must be row_major or column_major.");
+        }
+        m_shape = xtl::forward_sequence<shape_type>(shape);
+        resize_container(m_strides, m_shape.size());
+        resize_container(m_backstrides, m_shape.size());
+        size_type data_size = compute_padded_strides(m_shape, l, padding, m_strides, m_backstrides);
+        m_layout = do_strides_match(m_shape, m_strides, l) ? l : layout_type::dynamic;
+        detail::resize_data_container(this->storage(), data_size);
+    }
+
     /**
      * Reshapes the container and keeps old elements
      * @param shape the new shape (has to have same number of elements as the original container)
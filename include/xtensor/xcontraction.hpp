@@ -0,0 +1,982 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_CONTRACTION_HPP
+#define XTENSOR_CONTRACTION_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xadapt.hpp"
+#include "xarray.hpp"
+#include "xbuilder.hpp"
+#include "xeval.hpp"
+#include "xexpression.hpp"
+#include "xmanipulation.hpp"
+#include "xmath.hpp"
+#include "xnoalias.hpp"
+#include "xparallel.hpp"
+#include "xtensor_config.hpp"
+#include "xtensor_simd.hpp"
+
+namespace xt
+{
+
+    /************************
+     * contraction kernels *
+     ************************/
+
+    namespace detail
+    {
+        template <class T1, class T2>
+        using contraction_type_t = std::decay_t<decltype(std::declval<T1>() * std::declval<T2>())>;
+
+        namespace contraction
+        {
+            // Blocking of the matrix product C = A * B of row-major matrices:
+            // a block of kc rows of B and nc columns is packed in panels of nr
+            // columns, shared by the tiles of the output computed in parallel,
+            // and each tile packs its block of mc rows of A in panels of mr
+            // rows. The micro-kernel accumulates mr x nr elements of C in
+            // registers over the kc elements of the panels.
+            constexpr std::size_t kc_block = 256;
+            constexpr std::size_t mc_block = 96;
+            constexpr std::size_t nc_block = 2048;
+            constexpr std::size_t nb_block = 256;
+
+            // products of at most this number of multiply-adds are computed
+            // with a plain loop, without packing
+            constexpr std::size_t small_size = 32768;
+
+            template <class T, class = void>
+            struct kernel
+            {
+                static constexpr std::size_t mr = 4;
+                static constexpr std::size_t nr = 8;
+
+                static void run(std::size_t kc, const T* a, const T* b, T* c, std::size_t ldc,
+                                std::size_t m, std::size_t n, bool overwrite)
+                {
+                    T acc[mr * nr] = {};
+                    for (std::size_t p = 0; p < kc; ++p)
+                    {
+                        const T* ap = a + p * mr;
+                        const T* bp = b + p * nr;
+                        for (std::size_t i = 0; i < mr; ++i)
+                        {
+                            T ai = ap[i];
+                            XTENSOR_PRAGMA_SIMD
+                            for (std::size_t j = 0; j < nr; ++j)
+                            {
+                                acc[i * nr + j] += ai * bp[j];
+                            }
+                        }
+                    }
+                    store(acc, c, ldc, m, n, overwrite);
+                }
+
+                static void store(const T* acc, T* c, std::size_t ldc, std::size_t m, std::size_t n, bool overwrite)
+                {
+                    for (std::size_t i = 0; i < m; ++i)
+                    {
+                        T* ci = c + i * ldc;
+                        for (std::size_t j = 0; j < n; ++j)
+                        {
+                            ci[j] = overwrite ? acc[i * nr + j] : ci[j] + acc[i * nr + j];
+                        }
+                    }
+                }
+            };
+
+#ifdef XTENSOR_USE_XSIMD
+            template <class B>
+            inline B multiply_add(const B& a, const B& b, const B& c, std::true_type /*floating point*/)
+            {
+                return xsimd::fma(a, b, c);
+            }
+
+            template <class B>
+            inline B multiply_add(const B& a, const B& b, const B& c, std::false_type /*floating point*/)
+            {
+                return a * b + c;
+            }
+
+            // register tile of mr rows of two batches each
+            template <class T>
+            struct kernel<T, std::enable_if_t<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value &&
+                                              (xsimd::simd_traits<T>::size > 1)>>
+            {
+                using batch_type = xsimd::simd_type<T>;
+                static constexpr std::size_t simd_size = batch_type::size;
+                static constexpr std::size_t mr = 4;
+                static constexpr std::size_t nr = 2 * simd_size;
+
+                static void run(std::size_t kc, const T* a, const T* b, T* c, std::size_t ldc,
+                                std::size_t m, std::size_t n, bool overwrite)
+                {
+                    using is_floating = std::is_floating_point<T>;
+                    batch_type acc[mr][2];
+                    for (std::size_t i = 0; i < mr; ++i)
+                    {
+                        acc[i][0] = xsimd::set_simd(T(0));
+                        acc[i][1] = acc[i][0];
+                    }
+                    for (std::size_t p = 0; p < kc; ++p)
+                    {
+                        const T* ap = a + p * mr;
+                        batch_type b0 = xsimd::load_simd<T, T>(b + p * nr, xsimd::unaligned_mode());
+                        batch_type b1 = xsimd::load_simd<T, T>(b + p * nr + simd_size, xsimd::unaligned_mode());
+                        for (std::size_t i = 0; i < mr; ++i)
+                        {
+                            batch_type ai = xsimd::set_simd(ap[i]);
+                            acc[i][0] = multiply_add(ai, b0, acc[i][0], is_floating());
+                            acc[i][1] = multiply_add(ai, b1, acc[i][1], is_floating());
+                        }
+                    }
+                    alignas(XTENSOR_CACHE_LINE_SIZE) T tile[mr * nr];
+                    for (std::size_t i = 0; i < mr; ++i)
+                    {
+                        acc[i][0].store_unaligned(tile + i * nr);
+                        acc[i][1].store_unaligned(tile + i * nr + simd_size);
+                    }
+                    for (std::size_t i = 0; i < m; ++i)
+                    {
+                        T* ci = c + i * ldc;
+                        for (std::size_t j = 0; j < n; ++j)
+                        {
+                            ci[j] = overwrite ? tile[i * nr + j] : ci[j] + tile[i * nr + j];
+                        }
+                    }
+                }
+            };
+#endif
+
+            // copies the m x kc block of a (leading dimension lda) in panels
+            // of mr rows, the missing rows of the last panel being zeros
+            template <std::size_t mr, class T>
+            inline void pack_a(const T* a, std::size_t lda, std::size_t m, std::size_t kc, T* dst)
+            {
+                for (std::size_t r = 0; r < m; r += mr)
+                {
+                    std::size_t rows = std::min(mr, m - r);
+                    T* panel = dst + r * kc;
+                    for (std::size_t p = 0; p < kc; ++p)
+                    {
+                        for (std::size_t i = 0; i < rows; ++i)
+                        {
+                            panel[p * mr + i] = a[(r + i) * lda + p];
+                        }
+                        for (std::size_t i = rows; i < mr; ++i)
+                        {
+                            panel[p * mr + i] = T(0);
+                        }
+                    }
+                }
+            }
+
+            // copies the kc x n block of b (leading dimension ldb) in panels
+            // of nr columns, the missing columns of the last panel being zeros
+            template <std::size_t nr, class T>
+            inline void pack_b(const T* b, std::size_t ldb, std::size_t kc, std::size_t n, T* dst)
+            {
+                for (std::size_t col = 0; col < n; col += nr)
+                {
+                    std::size_t cols = std::min(nr, n - col);
+                    T* panel = dst + col * kc;
+                    for (std::size_t p = 0; p < kc; ++p)
+                    {
+                        const T* bp = b + p * ldb + col;
+                        for (std::size_t j = 0; j < cols; ++j)
+                        {
+                            panel[p * nr + j] = bp[j];
+                        }
+                        for (std::size_t j = cols; j < nr; ++j)
+                        {
+                            panel[p * nr + j] = T(0);
+                        }
+                    }
+                }
+            }
+
+            template <class T>
+            inline void gemm_small(std::size_t m, std::size_t n, std::size_t k, const T* a, const T* b, T* c)
+            {
+                for (std::size_t i = 0; i < m; ++i)
+                {
+                    T* ci = c + i * n;
+                    std::fill(ci, ci + n, T(0));
+                    for (std::size_t p = 0; p < k; ++p)
+                    {
+                        T aip = a[i * k + p];
+                        const T* bp = b + p * n;
+                        XTENSOR_PRAGMA_SIMD
+                        for (std::size_t j = 0; j < n; ++j)
+                        {
+                            ci[j] += aip * bp[j];
+                        }
+                    }
+                }
+            }
+
+            /**
+             * Computes c = a * b, a being a row-major m x k matrix, b a row-major
+             * k x n matrix and c a row-major m x n matrix. The tiles of c are
+             * computed in parallel when XTENSOR_PARALLEL_ENABLED is defined and
+             * c is large enough according to the parallel settings.
+             */
+            template <class T>
+            inline void gemm(std::size_t m, std::size_t n, std::size_t k, const T* a, const T* b, T* c)
+            {
+                using kernel_type = kernel<T>;
+                constexpr std::size_t mr = kernel_type::mr;
+                constexpr std::size_t nr = kernel_type::nr;
+                // the blocks are made of whole panels
+                constexpr std::size_t mc = (mc_block + mr - 1) / mr * mr;
+                constexpr std::size_t nb = (nb_block + nr - 1) / nr * nr;
+                constexpr std::size_t nc = (nc_block + nb - 1) / nb * nb;
+
+                if (m == 0 || n == 0)
+                {
+                    return;
+                }
+                if (k == 0 || m * n * k <= small_size)
+                {
+                    gemm_small(m, n, k, a, b, c);
+                    return;
+                }
+
+                std::vector<T> packed_b((std::min(nc, (n + nr - 1) / nr * nr)) * std::min(kc_block, k));
+                for (std::size_t jc = 0; jc < n; jc += nc)
+                {
+                    std::size_t ncols = std::min(nc, n - jc);
+                    for (std::size_t pc = 0; pc < k; pc += kc_block)
+                    {
+                        std::size_t kc = std::min(kc_block, k - pc);
+                        bool overwrite = pc == 0;
+                        pack_b<nr>(b + pc * n + jc, n, kc, ncols, packed_b.data());
+
+                        std::size_t row_blocks = (m + mc - 1) / mc;
+                        std::size_t col_blocks = (ncols + nb - 1) / nb;
+                        auto compute_tiles = [&](std::size_t first, std::size_t last) {
+                            std::vector<T> packed_a(mc * kc);
+                            std::size_t packed_block = row_blocks;
+                            for (std::size_t t = first; t < last; ++t)
+                            {
+                                // consecutive tiles share their block of a
+                                std::size_t ib = t / col_blocks;
+                                std::size_t jb = t % col_blocks;
+                                std::size_t ic = ib * mc;
+                                std::size_t mrows = std::min(mc, m - ic);
+                                if (ib != packed_block)
+                                {
+                                    pack_a<mr>(a + ic * k + pc, k, mrows, kc, packed_a.data());
+                                    packed_block = ib;
+                                }
+                                std::size_t col_end = std::min(ncols, (jb + 1) * nb);
+                                for (std::size_t jr = jb * nb; jr < col_end; jr += nr)
+                                {
+                                    for (std::size_t ir = 0; ir < mrows; ir += mr)
+                                    {
+                                        kernel_type::run(kc, packed_a.data() + ir * kc, packed_b.data() + jr * kc,
+                                                         c + (ic + ir) * n + jc + jr, n,
+                                                         std::min(mr, mrows - ir), std::min(nr, col_end - jr), overwrite);
+                                    }
+                                }
+                            }
+                        };
+
+                        std::size_t tiles = row_blocks * col_blocks;
+                        if (tiles > 1 && parallel::use_parallel(m * ncols))
+                        {
+                            parallel_for(std::size_t(0), tiles, parallel::grain(mc * nb), compute_tiles);
+                        }
+                        else
+                        {
+                            compute_tiles(std::size_t(0), tiles);
+                        }
+                    }
+                }
+            }
+
+            // pointer to the row-major elements of e permuted by perm, copied
+            // to buffer unless e holds them already
+            template <class T, class E>
+            inline const T* direct_matrix(const E& e, const std::vector<std::size_t>& perm, std::true_type)
+            {
+                for (std::size_t i = 0; i < perm.size(); ++i)
+                {
+                    if (perm[i] != i)
+                    {
+                        return nullptr;
+                    }
+                }
+                return e.layout() == layout_type::row_major ? e.data() + e.data_offset() : nullptr;
+            }
+
+            template <class T, class E>
+            inline const T* direct_matrix(const E&, const std::vector<std::size_t>&, std::false_type)
+            {
+                return nullptr;
+            }
+
+            template <class T, class E>
+            inline const T* matrix(const E& e, const std::vector<std::size_t>& perm, std::vector<T>& buffer)
+            {
+                using direct = std::is_same<typename E::value_type, T>;
+                if (const T* data = direct_matrix<T>(e, perm, direct()))
+                {
+                    return data;
+                }
+                std::vector<std::size_t> shape(perm.size());
+                for (std::size_t i = 0; i < perm.size(); ++i)
+                {
+                    shape[i] = e.shape()[perm[i]];
+                }
+                buffer.resize(e.size());
+                auto dst = adapt(buffer.data(), buffer.size(), no_ownership(), shape, layout_type::row_major);
+                noalias(dst) = transpose(e, perm);
+                return buffer.data();
+            }
+
+            /**********
+             * einsum *
+             **********/
+
+            // operand of einsum, a row-major tensor whose axes are labelled
+            // by the characters of labels; data points to storage or to the
+            // elements of an input expression evaluated in place
+            template <class T>
+            struct einsum_operand
+            {
+                einsum_operand() = default;
+                einsum_operand(einsum_operand&&) = default;
+                einsum_operand& operator=(einsum_operand&&) = default;
+                einsum_operand(const einsum_operand&) = delete;
+                einsum_operand& operator=(const einsum_operand&) = delete;
+
+                std::size_t size() const noexcept
+                {
+                    return std::accumulate(shape.cbegin(), shape.cend(), std::size_t(1), std::multiplies<std::size_t>());
+                }
+
+                auto view() const
+                {
+                    return adapt(data, size(), no_ownership(), shape, layout_type::row_major);
+                }
+
+                std::vector<T> storage;
+                const T* data = nullptr;
+                std::vector<std::size_t> shape;
+                std::string labels;
+            };
+
+            struct einsum_subscripts
+            {
+                std::vector<std::string> inputs;
+                std::string output;
+            };
+
+            // the axes covered by an ellipsis are labelled by characters that
+            // cannot appear in the subscripts, the last axes by the last ones
+            constexpr char einsum_ellipsis_label = '\x01';
+            constexpr std::size_t einsum_max_ellipsis = 31;
+
+            inline bool is_einsum_label(char c) noexcept
+            {
+                return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+            }
+
+            inline std::string einsum_ellipsis_labels(std::size_t first, std::size_t last)
+            {
+                std::string res;
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    res.push_back(static_cast<char>(einsum_ellipsis_label + static_cast<char>(i)));
+                }
+                return res;
+            }
+
+            // replaces the ellipsis of the subscripts of an operand with
+            // dimension dim by the labels of the axes it covers
+            inline std::string expand_einsum_ellipsis(const std::string& subscripts, std::size_t dim, std::size_t& ellipsis_dim)
+            {
+                std::size_t pos = subscripts.find("...");
+                if (pos == std::string::npos)
+                {
+                    if (subscripts.size() != dim)
+                    {
+                        throw std::runtime_error("einsum: the subscripts '" + subscripts + "' do not match the dimension of the operand");
+                    }
+                    return subscripts;
+                }
+                if (subscripts.find('.', pos + 3) != std::string::npos)
+                {
+                    throw std::runtime_error("einsum: invalid ellipsis in subscripts '" + subscripts + "'");
+                }
+                std::size_t nlabels = subscripts.size() - 3;
+                if (dim < nlabels || dim - nlabels > einsum_max_ellipsis)
+                {
+                    throw std::runtime_error("einsum: the subscripts '" + subscripts + "' do not match the dimension of the operand");
+                }
+                std::size_t n = dim - nlabels;
+                ellipsis_dim = std::max(ellipsis_dim, n);
+                return subscripts.substr(0, pos) + einsum_ellipsis_labels(einsum_max_ellipsis - n, einsum_max_ellipsis) +
+                       subscripts.substr(pos + 3);
+            }
+
+            inline einsum_subscripts parse_einsum(const std::string& spec, const std::vector<std::size_t>& dims)
+            {
+                std::string s;
+                std::copy_if(spec.cbegin(), spec.cend(), std::back_inserter(s), [](char c) { return c != ' '; });
+                std::size_t arrow = s.find("->");
+                std::string lhs = s.substr(0, arrow);
+
+                einsum_subscripts res;
+                std::size_t ellipsis_dim = 0;
+                std::size_t first = 0;
+                for (std::size_t i = 0; i < dims.size(); ++i)
+                {
+                    std::size_t last = std::min(lhs.find(',', first), lhs.size());
+                    if (first > lhs.size())
+                    {
+                        throw std::runtime_error("einsum: fewer subscripts than operands in '" + spec + "'");
+                    }
+                    res.inputs.push_back(expand_einsum_ellipsis(lhs.substr(first, last - first), dims[i], ellipsis_dim));
+                    first = last + 1;
+                }
+                if (first <= lhs.size())
+                {
+                    throw std::runtime_error("einsum: more subscripts than operands in '" + spec + "'");
+                }
+
+                std::string ellipsis = einsum_ellipsis_labels(einsum_max_ellipsis - ellipsis_dim, einsum_max_ellipsis);
+                if (arrow == std::string::npos)
+                {
+                    // implicit mode: the labels appearing once, sorted, after
+                    // the axes of the ellipsis
+                    std::string all;
+                    for (const auto& input : res.inputs)
+                    {
+                        all += input;
+                    }
+                    std::string once;
+                    for (char c : all)
+                    {
+                        if (is_einsum_label(c) && std::count(all.cbegin(), all.cend(), c) == 1)
+                        {
+                            once.push_back(c);
+                        }
+                    }
+                    std::sort(once.begin(), once.end());
+                    res.output = ellipsis + once;
+                }
+                else
+                {
+                    std::string rhs = s.substr(arrow + 2);
+                    std::size_t pos = rhs.find("...");
+                    res.output = pos == std::string::npos ? rhs : rhs.substr(0, pos) + ellipsis + rhs.substr(pos + 3);
+                }
+
+                for (const auto& input : res.inputs)
+                {
+                    for (char c : input)
+                    {
+                        if (!is_einsum_label(c) && (c < einsum_ellipsis_label || c >= einsum_ellipsis_label + char(einsum_max_ellipsis)))
+                        {
+                            throw std::runtime_error("einsum: invalid subscripts '" + spec + "'");
+                        }
+                    }
+                }
+                for (std::size_t i = 0; i < res.output.size(); ++i)
+                {
+                    char c = res.output[i];
+                    bool found = std::any_of(res.inputs.cbegin(), res.inputs.cend(),
+                                             [c](const std::string& input) { return input.find(c) != std::string::npos; });
+                    if (!found || res.output.find(c, i + 1) != std::string::npos)
+                    {
+                        throw std::runtime_error("einsum: invalid output subscripts in '" + spec + "'");
+                    }
+                }
+                return res;
+            }
+
+            template <class T, class E>
+            inline einsum_operand<T> evaluate_einsum_operand(const E& e, std::string labels)
+            {
+                einsum_operand<T> res;
+                res.shape.assign(e.shape().cbegin(), e.shape().cend());
+                res.storage.resize(res.size());
+                auto dst = adapt(res.storage.data(), res.storage.size(), no_ownership(), res.shape, layout_type::row_major);
+                noalias(dst) = e;
+                res.data = res.storage.data();
+                res.labels = std::move(labels);
+                return res;
+            }
+
+            // operands that are lvalue row-major containers of the result
+            // type are used in place, the others are copied
+            template <class T, class E>
+            inline einsum_operand<T> make_einsum_operand(E&& e, const std::string& labels)
+            {
+                using direct = std::integral_constant<bool, std::is_lvalue_reference<E>::value &&
+                                                            std::is_same<typename std::decay_t<E>::value_type, T>::value>;
+                std::vector<std::size_t> identity(e.dimension());
+                std::iota(identity.begin(), identity.end(), std::size_t(0));
+                if (const T* data = direct_matrix<T>(e, identity, direct()))
+                {
+                    einsum_operand<T> res;
+                    res.data = data;
+                    res.shape.assign(e.shape().cbegin(), e.shape().cend());
+                    res.labels = labels;
+                    return res;
+                }
+                return evaluate_einsum_operand<T>(e, labels);
+            }
+
+            // takes the diagonals of the repeated labels of op and sums over
+            // the axes whose label is not in keep
+            template <class T>
+            inline void reduce_einsum_operand(einsum_operand<T>& op, const std::string& keep)
+            {
+                for (std::size_t i = 0; i < op.labels.size(); ++i)
+                {
+                    std::size_t j = op.labels.find(op.labels[i], i + 1);
+                    if (j != std::string::npos)
+                    {
+                        std::string labels = op.labels;
+                        labels.erase(j, 1);
+                        labels.erase(i, 1);
+                        labels.push_back(op.labels[i]);
+                        op = evaluate_einsum_operand<T>(diagonal(op.view(), 0, i, j), labels);
+                        i = std::size_t(-1);
+                    }
+                }
+
+                std::vector<std::size_t> axes;
+                std::string labels;
+                for (std::size_t i = 0; i < op.labels.size(); ++i)
+                {
+                    if (keep.find(op.labels[i]) == std::string::npos)
+                    {
+                        axes.push_back(i);
+                    }
+                    else
+                    {
+                        labels.push_back(op.labels[i]);
+                    }
+                }
+                if (!axes.empty())
+                {
+                    op = evaluate_einsum_operand<T>(sum<T>(op.view(), axes, evaluation_strategy::immediate()), labels);
+                }
+            }
+
+            // contracts the labels shared by a and b that are not in keep;
+            // the shared labels in keep are batch axes of the result, which
+            // are followed by the other axes of a and those of b
+            template <class T>
+            inline einsum_operand<T> contract_einsum_operands(const einsum_operand<T>& a, const einsum_operand<T>& b,
+                                                              const std::string& keep)
+            {
+                std::vector<std::size_t> batch_a, batch_b, free_a, free_b, contracted_a, contracted_b;
+                std::string batch_labels, free_labels_a, free_labels_b;
+                for (std::size_t i = 0; i < a.labels.size(); ++i)
+                {
+                    std::size_t j = b.labels.find(a.labels[i]);
+                    if (j == std::string::npos)
+                    {
+                        free_a.push_back(i);
+                        free_labels_a.push_back(a.labels[i]);
+                    }
+                    else if (keep.find(a.labels[i]) != std::string::npos)
+                    {
+                        batch_a.push_back(i);
+                        batch_b.push_back(j);
+                        batch_labels.push_back(a.labels[i]);
+                    }
+                    else
+                    {
+                        contracted_a.push_back(i);
+                        contracted_b.push_back(j);
+                    }
+                }
+                for (std::size_t j = 0; j < b.labels.size(); ++j)
+                {
+                    if (a.labels.find(b.labels[j]) == std::string::npos)
+                    {
+                        free_b.push_back(j);
+                        free_labels_b.push_back(b.labels[j]);
+                    }
+                }
+
+                auto extent = [](const einsum_operand<T>& op, const std::vector<std::size_t>& axes) {
+                    std::size_t res = 1;
+                    for (std::size_t axis : axes)
+                    {
+                        res *= op.shape[axis];
+                    }
+                    return res;
+                };
+                std::size_t batch = extent(a, batch_a);
+                std::size_t m = extent(a, free_a);
+                std::size_t n = extent(b, free_b);
+                std::size_t k = extent(a, contracted_a);
+
+                std::vector<std::size_t> perm_a(batch_a);
+                perm_a.insert(perm_a.end(), free_a.cbegin(), free_a.cend());
+                perm_a.insert(perm_a.end(), contracted_a.cbegin(), contracted_a.cend());
+                std::vector<std::size_t> perm_b(batch_b);
+                perm_b.insert(perm_b.end(), contracted_b.cbegin(), contracted_b.cend());
+                perm_b.insert(perm_b.end(), free_b.cbegin(), free_b.cend());
+
+                std::vector<T> buffer_a;
+                std::vector<T> buffer_b;
+                const T* pa = matrix<T>(a.view(), perm_a, buffer_a);
+                const T* pb = matrix<T>(b.view(), perm_b, buffer_b);
+
+                einsum_operand<T> res;
+                res.labels = batch_labels + free_labels_a + free_labels_b;
+                for (std::size_t axis : batch_a)
+                {
+                    res.shape.push_back(a.shape[axis]);
+                }
+                for (std::size_t axis : free_a)
+                {
+                    res.shape.push_back(a.shape[axis]);
+                }
+                for (std::size_t axis : free_b)
+                {
+                    res.shape.push_back(b.shape[axis]);
+                }
+                res.storage.resize(batch * m * n);
+                res.data = res.storage.data();
+
+                T* pc = res.storage.data();
+                auto multiply = [&](std::size_t first, std::size_t last) {
+                    for (std::size_t t = first; t < last; ++t)
+                    {
+                        gemm(m, n, k, pa + t * m * k, pb + t * k * n, pc + t * m * n);
+                    }
+                };
+                if (batch > 1 && parallel::use_parallel(batch * m * n))
+                {
+                    parallel_for(std::size_t(0), batch, parallel::grain(m * n), multiply);
+                }
+                else
+                {
+                    multiply(std::size_t(0), batch);
+                }
+                return res;
+            }
+
+            // labels of the operands other than ops[i] and ops[j], and of the output
+            template <class T>
+            inline std::string einsum_kept_labels(const std::vector<einsum_operand<T>>& ops, std::size_t i, std::size_t j,
+                                                  const std::string& output)
+            {
+                std::string res = output;
+                for (std::size_t l = 0; l < ops.size(); ++l)
+                {
+                    if (l != i && l != j)
+                    {
+                        res += ops[l].labels;
+                    }
+                }
+                return res;
+            }
+
+            /**
+             * Contracts the operands pairwise, choosing at each step the pair
+             * with the smallest result, then the smallest number of
+             * multiply-adds, so that the outer product of all the operands is
+             * never formed.
+             */
+            template <class T>
+            inline einsum_operand<T> contract_einsum(std::vector<einsum_operand<T>>& ops, const std::string& output,
+                                                     const std::map<char, std::size_t>& sizes)
+            {
+                for (std::size_t i = 0; i < ops.size(); ++i)
+                {
+                    reduce_einsum_operand(ops[i], einsum_kept_labels(ops, i, i, output));
+                }
+                while (ops.size() > 1)
+                {
+                    std::size_t best_i = 0;
+                    std::size_t best_j = 1;
+                    std::pair<std::size_t, std::size_t> best_cost(std::size_t(-1), std::size_t(-1));
+                    for (std::size_t i = 0; i < ops.size(); ++i)
+                    {
+                        for (std::size_t j = i + 1; j < ops.size(); ++j)
+                        {
+                            std::string keep = einsum_kept_labels(ops, i, j, output);
+                            std::string all = ops[i].labels + ops[j].labels;
+                            std::pair<std::size_t, std::size_t> cost(1, 1);
+                            for (std::size_t l = 0; l < all.size(); ++l)
+                            {
+                                if (all.find(all[l]) == l)
+                                {
+                                    std::size_t size = sizes.at(all[l]);
+                                    cost.second *= size;
+                                    cost.first *= keep.find(all[l]) == std::string::npos ? 1 : size;
+                                }
+                            }
+                            if (cost < best_cost)
+                            {
+                                best_cost = cost;
+                                best_i = i;
+                                best_j = j;
+                            }
+                        }
+                    }
+                    std::string keep = einsum_kept_labels(ops, best_i, best_j, output);
+                    einsum_operand<T> res = contract_einsum_operands(ops[best_i], ops[best_j], keep);
+                    ops.erase(ops.begin() + static_cast<std::ptrdiff_t>(best_j));
+                    ops.erase(ops.begin() + static_cast<std::ptrdiff_t>(best_i));
+                    ops.push_back(std::move(res));
+                }
+                reduce_einsum_operand(ops.front(), output);
+                return std::move(ops.front());
+            }
+        }
+    }
+
+    /************************
+     * tensordot functions *
+     ************************/
+
+    /**
+     * @defgroup contraction_functions Tensor contractions
+     *
+     * The contractions are computed by a cache-blocked matrix product of the
+     * operands permuted and reshaped into matrices, with register-tiled kernels
+     * vectorized with xsimd when it is enabled, and parallel over the tiles
+     * of the output.
+     */
+
+    /**
+     * @ingroup contraction_functions
+     * @brief Sum of products over the given axes of two expressions.
+     *
+     * The axes_a[i]-th axis of \em a is contracted with the axes_b[i]-th axis
+     * of \em b. The shape of the result is made of the remaining axes of
+     * \em a followed by the remaining axes of \em b, like numpy.tensordot.
+     *
+     * \code{.cpp}
+     * xt::xarray<double> c = xt::tensordot(a, b, {1}, {0});    // matrix product
+     * xt::xarray<double> d = xt::tensordot(x, y, {0, 2}, {1, 3});
+     * \endcode
+     *
+     * @param a the first expression
+     * @param b the second expression
+     * @param axes_a the contracted axes of \em a
+     * @param axes_b the contracted axes of \em b, of the same sizes
+     * @throw std::runtime_error if the axes are invalid or their sizes differ
+     * @return an \ref xarray holding the contraction
+     */
+    template <class E1, class E2>
+    inline xarray<detail::contraction_type_t<typename E1::value_type, typename E2::value_type>>
+    tensordot(const xexpression<E1>& a, const xexpression<E2>& b,
+              const std::vector<std::size_t>& axes_a, const std::vector<std::size_t>& axes_b)
+    {
+        using value_type = detail::contraction_type_t<typename E1::value_type, typename E2::value_type>;
+        auto&& ea = eval(a.derived_cast());
+        auto&& eb = eval(b.derived_cast());
+        std::size_t dim_a = ea.dimension();
+        std::size_t dim_b = eb.dimension();
+        if (axes_a.size() != axes_b.size())
+        {
+            throw std::runtime_error("tensordot: the numbers of contracted axes differ");
+        }
+
+        std::vector<bool> contracted_a(dim_a, false);
+        std::vector<bool> contracted_b(dim_b, false);
+        std::size_t k = 1;
+        for (std::size_t i = 0; i < axes_a.size(); ++i)
+        {
+            if (axes_a[i] >= dim_a || axes_b[i] >= dim_b)
+            {
+                throw std::runtime_error("tensordot: contracted axis out of bounds");
+            }
+            if (contracted_a[axes_a[i]] || contracted_b[axes_b[i]])
+            {
+                throw std::runtime_error("tensordot: an axis is contracted twice");
+            }
+            if (ea.shape()[axes_a[i]] != eb.shape()[axes_b[i]])
+            {
+                throw std::runtime_error("tensordot: the contracted axes have different sizes");
+            }
+            contracted_a[axes_a[i]] = true;
+            contracted_b[axes_b[i]] = true;
+            k *= ea.shape()[axes_a[i]];
+        }
+
+        // a is permuted to (free axes, contracted axes), b to (contracted
+        // axes, free axes)
+        std::vector<std::size_t> perm_a;
+        std::vector<std::size_t> perm_b(axes_b);
+        std::vector<std::size_t> shape;
+        std::size_t m = 1;
+        std::size_t n = 1;
+        for (std::size_t i = 0; i < dim_a; ++i)
+        {
+            if (!contracted_a[i])
+            {
+                perm_a.push_back(i);
+                shape.push_back(ea.shape()[i]);
+                m *= ea.shape()[i];
+            }
+        }
+        perm_a.insert(perm_a.end(), axes_a.cbegin(), axes_a.cend());
+        for (std::size_t i = 0; i < dim_b; ++i)
+        {
+            if (!contracted_b[i])
+            {
+                perm_b.push_back(i);
+                shape.push_back(eb.shape()[i]);
+                n *= eb.shape()[i];
+            }
+        }
+
+        std::vector<value_type> buffer_a;
+        std::vector<value_type> buffer_b;
+        const value_type* pa = detail::contraction::matrix<value_type>(ea, perm_a, buffer_a);
+        const value_type* pb = detail::contraction::matrix<value_type>(eb, perm_b, buffer_b);
+
+        using result_type = xarray<value_type>;
+        result_type res = result_type::from_shape(shape);
+        if (res.layout() == layout_type::row_major)
+        {
+            detail::contraction::gemm(m, n, k, pa, pb, res.data());
+        }
+        else
+        {
+            std::vector<value_type> c(m * n);
+            detail::contraction::gemm(m, n, k, pa, pb, c.data());
+            noalias(res) = adapt(c.data(), c.size(), no_ownership(), shape, layout_type::row_major);
+        }
+        return res;
+    }
+
+    /**
+     * @ingroup contraction_functions
+     * @brief Contraction of the last \em axes axes of \em a with the first
+     * \em axes axes of \em b.
+     *
+     * tensordot(a, b, 1) is the matrix product of two matrices, and
+     * tensordot(a, b, 0) their outer product.
+     * @param a the first expression
+     * @param b the second expression
+     * @param axes the number of contracted axes
+     * @throw std::runtime_error if an expression has less than \em axes
+     * dimensions or the sizes of the contracted axes differ
+     * @return an \ref xarray holding the contraction
+     */
+    template <class E1, class E2>
+    inline xarray<detail::contraction_type_t<typename E1::value_type, typename E2::value_type>>
+    tensordot(const xexpression<E1>& a, const xexpression<E2>& b, std::size_t axes = 2)
+    {
+        std::size_t dim_a = a.derived_cast().dimension();
+        if (axes > dim_a || axes > b.derived_cast().dimension())
+        {
+            throw std::runtime_error("tensordot: more contracted axes than dimensions");
+        }
+        std::vector<std::size_t> axes_a(axes);
+        std::vector<std::size_t> axes_b(axes);
+        for (std::size_t i = 0; i < axes; ++i)
+        {
+            axes_a[i] = dim_a - axes + i;
+            axes_b[i] = i;
+        }
+        return tensordot(a, b, axes_a, axes_b);
+    }
+
+    /**
+     * @ingroup contraction_functions
+     * @brief Einstein summation of the operands, like numpy.einsum.
+     *
+     * The subscripts label the axes of each operand with letters, separated
+     * by commas, optionally followed by "->" and the labels of the axes of the
+     * result. The elements are multiplied along the axes with the same label
+     * and summed over the labels that are not in the result. Without "->",
+     * the result has the labels that appear once, in alphabetical order.
+     * An ellipsis stands for the remaining axes of an operand, those of the
+     * different operands being aligned to the right.
+     *
+     * The operands are contracted pairwise with the kernels of tensordot,
+     * in an order chosen to keep the intermediate results small; repeated
+     * labels in an operand take its diagonal, and labels of a single operand
+     * missing from the result are summed before any product.
+     *
+     * \code{.cpp}
+     * xt::xarray<double> c = xt::einsum("ij,jk->ik", a, b);
+     * xt::xarray<double> t = xt::einsum("ii", a);                // trace
+     * xt::xarray<double> d = xt::einsum("bij,bjk->bik", x, y);   // batch product
+     * xt::xarray<double> e = xt::einsum("ij,jk,kl->il", a, b, c);
+     * \endcode
+     *
+     * @param subscripts the subscripts of the operands and of the result
+     * @param operands the operands
+     * @throw std::runtime_error if the subscripts are invalid or the sizes of
+     * the axes with the same label differ
+     * @return an \ref xarray holding the result
+     */
+    template <class... E>
+    inline xarray<std::common_type_t<typename E::value_type...>>
+    einsum(const std::string& subscripts, const xexpression<E>&... operands)
+    {
+        using value_type = std::common_type_t<typename E::value_type...>;
+        using operand_type = detail::contraction::einsum_operand<value_type>;
+        static_assert(sizeof...(E) > 0, "einsum requires at least one operand");
+        std::vector<std::size_t> dims = { operands.derived_cast().dimension()... };
+        detail::contraction::einsum_subscripts parsed = detail::contraction::parse_einsum(subscripts, dims);
+
+        std::vector<operand_type> ops;
+        ops.reserve(sizeof...(E));
+        std::size_t index = 0;
+        auto add_operand = [&](auto&& e) {
+            ops.push_back(detail::contraction::make_einsum_operand<value_type>(std::forward<decltype(e)>(e), parsed.inputs[index]));
+            ++index;
+            return 0;
+        };
+        int expand[] = { 0, add_operand(eval(operands.derived_cast()))... };
+        (void)expand;
+
+        std::map<char, std::size_t> sizes;
+        for (const auto& op : ops)
+        {
+            for (std::size_t i = 0; i < op.labels.size(); ++i)
+            {
+                auto inserted = sizes.insert(std::make_pair(op.labels[i], op.shape[i]));
+                if (inserted.first->second != op.shape[i])
+                {
+                    throw std::runtime_error("einsum: the axes labelled '" + std::string(1, op.labels[i]) + "' have different sizes");
+                }
+            }
+        }
+
+        operand_type res = detail::contraction::contract_einsum(ops, parsed.output, sizes);
+        std::vector<std::size_t> perm(parsed.output.size());
+        for (std::size_t i = 0; i < perm.size(); ++i)
+        {
+            perm[i] = res.labels.find(parsed.output[i]);
+        }
+        xarray<value_type> result = transpose(res.view(), perm);
+        return result;
+    }
+}
+
+#endif
@@ -0,0 +1,348 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_CONVOLVE_HPP
+#define XTENSOR_CONVOLVE_HPP
+
+#include <algorithm>
+#include <complex>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xarray.hpp"
+#include "xbuilder.hpp"
+#include "xparallel.hpp"
+#include "xrolling.hpp"
+#include "xtensor_config.hpp"
+
+namespace xt
+{
+    /**
+     * @defgroup convolve_functions Convolution and correlation
+     *
+     * Direct 1-D and 2-D convolutions and correlations. The inner loops run
+     * over contiguous output elements for each element of the kernel, so
+     * that they are vectorized, and the lines of the output are computed in
+     * parallel with parallel_for.
+     */
+
+    /**
+     * @ingroup convolve_functions
+     * Size of the result of a convolution or a correlation.
+     */
+    enum class convolve_mode
+    {
+        /// every overlap of the operands, of size m + n - 1
+        full,
+        /// the center of the full result, of size max(m, n)
+        same,
+        /// the complete overlaps, of size max(m, n) - min(m, n) + 1
+        valid
+    };
+
+    namespace detail
+    {
+        template <class T1, class T2>
+        using convolve_type_t = std::decay_t<decltype(std::declval<T1>() * std::declval<T2>())>;
+
+        template <class T>
+        inline T convolve_conj(const T& t)
+        {
+            return t;
+        }
+
+        template <class T>
+        inline std::complex<T> convolve_conj(const std::complex<T>& t)
+        {
+            return std::conj(t);
+        }
+
+        // outputs [start, start + size) of the full convolution along an axis
+        struct convolve_range
+        {
+            std::size_t start;
+            std::size_t size;
+        };
+
+        inline convolve_range convolve_output(std::size_t m, std::size_t n, convolve_mode mode, bool correlation)
+        {
+            std::size_t lo = std::min(m, n);
+            std::size_t hi = std::max(m, n);
+            switch (mode)
+            {
+            case convolve_mode::same:
+                // numpy correlates a longer kernel with the operands swapped
+                // and reverses the result, which shifts the center
+                return { correlation && n > m ? lo - 1 - (lo - 1) / 2 : (lo - 1) / 2, hi };
+            case convolve_mode::valid:
+                return { lo - 1, hi - lo + 1 };
+            default:
+                return { 0, m + n - 1 };
+            }
+        }
+
+        // number of outputs of a 1-D convolution kept in cache while all the
+        // elements of the kernel are applied to them
+        constexpr std::size_t convolve_block = 2048;
+
+        /**
+         * Accumulates y[o] += sum_t w[t] * x[start + o - t] for o in [0, size),
+         * the terms whose index in x is out of [0, m) being zeros.
+         */
+        template <class R, class T>
+        inline void convolve_line(const T* x, std::size_t m, const R* w, std::size_t n,
+                                  std::size_t start, std::size_t size, R* y)
+        {
+            for (std::size_t t = 0; t < n; ++t)
+            {
+                std::size_t first = std::max(start, t);
+                std::size_t last = std::min(start + size, t + m);
+                if (first >= last)
+                {
+                    continue;
+                }
+                R wt = w[t];
+                R* yt = y + (first - start);
+                const T* xt = x + (first - t);
+                std::size_t count = last - first;
+                XTENSOR_PRAGMA_SIMD
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    yt[i] += wt * static_cast<R>(xt[i]);
+                }
+            }
+        }
+
+        template <class F>
+        inline void convolve_for(std::size_t n, std::size_t work, std::size_t item_size, F&& f)
+        {
+            if (n > 1 && parallel::use_parallel(work))
+            {
+                parallel_for(std::size_t(0), n, parallel::grain(item_size), std::forward<F>(f));
+            }
+            else
+            {
+                f(std::size_t(0), n);
+            }
+        }
+
+        // row-major copy of the kernel, flipped and conjugated for a correlation
+        template <class R, class E>
+        inline xarray<R, layout_type::row_major> convolve_kernel(const E& v, bool correlation)
+        {
+            xarray<R, layout_type::row_major> w = v;
+            if (correlation)
+            {
+                std::reverse(w.data(), w.data() + w.size());
+                std::transform(w.data(), w.data() + w.size(), w.data(), [](const R& r) { return convolve_conj(r); });
+            }
+            return w;
+        }
+
+        template <class R, class E1, class E2>
+        inline xarray<R, layout_type::row_major> convolve_1d(const E1& a, const E2& v, convolve_mode mode, bool correlation)
+        {
+            std::size_t m = a.shape()[0];
+            std::size_t n = v.shape()[0];
+            convolve_range r = convolve_output(m, n, mode, correlation);
+            auto w = convolve_kernel<R>(v, correlation);
+            xarray<R, layout_type::row_major> res = zeros<R>({ r.size });
+            rolling_source(a, [&](const auto* x) {
+                std::size_t blocks = (r.size + convolve_block - 1) / convolve_block;
+                convolve_for(blocks, r.size * n, convolve_block * n, [&](std::size_t first, std::size_t last) {
+                    for (std::size_t b = first; b < last; ++b)
+                    {
+                        std::size_t offset = b * convolve_block;
+                        std::size_t size = std::min(convolve_block, r.size - offset);
+                        convolve_line(x, m, w.data(), n, r.start + offset, size, res.data() + offset);
+                    }
+                });
+            }, rolling_row_major<E1>());
+            return res;
+        }
+
+        template <class R, class E1, class E2>
+        inline xarray<R, layout_type::row_major> convolve_2d(const E1& a, const E2& v, convolve_mode mode, bool correlation)
+        {
+            std::size_t m0 = a.shape()[0];
+            std::size_t m1 = a.shape()[1];
+            std::size_t n0 = v.shape()[0];
+            std::size_t n1 = v.shape()[1];
+            convolve_range r0 = convolve_output(m0, n0, mode, correlation);
+            convolve_range r1 = convolve_output(m1, n1, mode, correlation);
+            auto w = convolve_kernel<R>(v, correlation);
+            xarray<R, layout_type::row_major> res = zeros<R>({ r0.size, r1.size });
+            rolling_source(a, [&](const auto* x) {
+                convolve_for(r0.size, res.size() * w.size(), r1.size * w.size(), [&](std::size_t first, std::size_t last) {
+                    for (std::size_t o = first; o < last; ++o)
+                    {
+                        std::size_t j = r0.start + o;
+                        std::size_t t_first = j >= m0 ? j - m0 + 1 : 0;
+                        std::size_t t_last = std::min(n0, j + 1);
+                        for (std::size_t t = t_first; t < t_last; ++t)
+                        {
+                            convolve_line(x + (j - t) * m1, m1, w.data() + t * n1, n1, r1.start, r1.size,
+                                          res.data() + o * r1.size);
+                        }
+                    }
+                });
+            }, rolling_row_major<E1>());
+            return res;
+        }
+
+        template <class R, class E1, class E2, class E3>
+        inline xarray<R, layout_type::row_major> convolve_separable_2d(const E1& a, const E2& v0, const E3& v1,
+                                                                       convolve_mode mode)
+        {
+            std::size_t m0 = a.shape()[0];
+            std::size_t m1 = a.shape()[1];
+            std::size_t n0 = v0.shape()[0];
+            std::size_t n1 = v1.shape()[0];
+            convolve_range r0 = convolve_output(m0, n0, mode, false);
+            convolve_range r1 = convolve_output(m1, n1, mode, false);
+            auto w0 = convolve_kernel<R>(v0, false);
+            auto w1 = convolve_kernel<R>(v1, false);
+
+            // convolution of the rows, then of the columns of the result
+            xarray<R, layout_type::row_major> tmp = zeros<R>({ m0, r1.size });
+            rolling_source(a, [&](const auto* x) {
+                convolve_for(m0, tmp.size() * n1, r1.size * n1, [&](std::size_t first, std::size_t last) {
+                    for (std::size_t i = first; i < last; ++i)
+                    {
+                        convolve_line(x + i * m1, m1, w1.data(), n1, r1.start, r1.size, tmp.data() + i * r1.size);
+                    }
+                });
+            }, rolling_row_major<E1>());
+
+            xarray<R, layout_type::row_major> res = zeros<R>({ r0.size, r1.size });
+            convolve_for(r0.size, res.size() * n0, r1.size * n0, [&](std::size_t first, std::size_t last) {
+                for (std::size_t o = first; o < last; ++o)
+                {
+                    std::size_t j = r0.start + o;
+                    std::size_t t_first = j >= m0 ? j - m0 + 1 : 0;
+                    std::size_t t_last = std::min(n0, j + 1);
+                    R* y = res.data() + o * r1.size;
+                    for (std::size_t t = t_first; t < t_last; ++t)
+                    {
+                        R wt = w0[t];
+                        const R* line = tmp.data() + (j - t) * r1.size;
+                        XTENSOR_PRAGMA_SIMD
+                        for (std::size_t i = 0; i < r1.size; ++i)
+                        {
+                            y[i] += wt * line[i];
+                        }
+                    }
+                }
+            });
+            return res;
+        }
+
+        template <class R, class E1, class E2>
+        inline xarray<R, layout_type::row_major> convolve_impl(const xexpression<E1>& a_expr, const xexpression<E2>& v_expr,
+                                                               convolve_mode mode, bool correlation)
+        {
+            const E1& a = a_expr.derived_cast();
+            const E2& v = v_expr.derived_cast();
+            if (a.dimension() != v.dimension() || a.dimension() == 0 || a.dimension() > 2)
+            {
+                throw std::runtime_error("convolve: the operands must be both 1-D or both 2-D");
+            }
+            if (a.size() == 0 || v.size() == 0)
+            {
+                throw std::runtime_error("convolve: empty operand");
+            }
+            return a.dimension() == 1 ? convolve_1d<R>(a, v, mode, correlation)
+                                      : convolve_2d<R>(a, v, mode, correlation);
+        }
+    }
+
+    /**
+     * @ingroup convolve_functions
+     * @brief Discrete convolution of two 1-D or two 2-D expressions.
+     *
+     * res[j] = sum_t a[j - t] * v[t], like numpy.convolve for 1-D operands;
+     * 2-D operands are convolved along both axes, each axis following the
+     * modes of the 1-D convolution.
+     *
+     * @param a the first expression
+     * @param v the second expression, of the same dimension
+     * @param mode the size of the result
+     * @throw std::runtime_error if the operands are not both 1-D or both 2-D,
+     * or if one of them is empty
+     * @return an \ref xarray holding the convolution
+     */
+    template <class E1, class E2>
+    inline auto convolve(const xexpression<E1>& a, const xexpression<E2>& v, convolve_mode mode = convolve_mode::full)
+    {
+        using value_type = detail::convolve_type_t<typename E1::value_type, typename E2::value_type>;
+        return detail::convolve_impl<value_type>(a, v, mode, false);
+    }
+
+    /**
+     * @ingroup convolve_functions
+     * @brief Cross-correlation of two 1-D or two 2-D expressions.
+     *
+     * res[k] = sum_t a[t + k] * conj(v[t]), like numpy.correlate for 1-D
+     * operands; 2-D operands are correlated along both axes.
+     *
+     * @param a the first expression
+     * @param v the second expression, of the same dimension
+     * @param mode the size of the result
+     * @throw std::runtime_error if the operands are not both 1-D or both 2-D,
+     * or if one of them is empty
+     * @return an \ref xarray holding the correlation
+     */
+    template <class E1, class E2>
+    inline auto correlate(const xexpression<E1>& a, const xexpression<E2>& v, convolve_mode mode = convolve_mode::valid)
+    {
+        using value_type = detail::convolve_type_t<typename E1::value_type, typename E2::value_type>;
+        return detail::convolve_impl<value_type>(a, v, mode, true);
+    }
+
+    /**
+     * @ingroup convolve_functions
+     * @brief Convolution of a 2-D expression with the separable kernel
+     * outer(v0, v1).
+     *
+     * The rows are convolved with \em v1, then the columns with \em v0, in
+     * O(n0 + n1) operations per output element instead of O(n0 * n1); the
+     * result is that of convolve(a, outer(v0, v1), mode).
+     *
+     * @param a the 2-D expression
+     * @param v0 the 1-D kernel of the columns
+     * @param v1 the 1-D kernel of the rows
+     * @param mode the size of the result
+     * @throw std::runtime_error if the dimensions are not 2, 1 and 1, or if an
+     * operand is empty
+     * @return an \ref xarray holding the convolution
+     */
+    template <class E1, class E2, class E3>
+    inline auto convolve_separable(const xexpression<E1>& a, const xexpression<E2>& v0, const xexpression<E3>& v1,
+                                   convolve_mode mode = convolve_mode::full)
+    {
+        using kernel_type = detail::convolve_type_t<typename E2::value_type, typename E3::value_type>;
+        using value_type = detail::convolve_type_t<typename E1::value_type, kernel_type>;
+        const auto& ea = a.derived_cast();
+        const auto& ev0 = v0.derived_cast();
+        const auto& ev1 = v1.derived_cast();
+        if (ea.dimension() != 2 || ev0.dimension() != 1 || ev1.dimension() != 1)
+        {
+            throw std::runtime_error("convolve_separable: the operand must be 2-D and the kernels 1-D");
+        }
+        if (ea.size() == 0 || ev0.size() == 0 || ev1.size() == 0)
+        {
+            throw std::runtime_error("convolve_separable: empty operand");
+        }
+        return detail::convolve_separable_2d<value_type>(ea, ev0, ev1, mode);
+    }
+}
+
+#endif
@@ -9,13 +9,27 @@
 #ifndef XTENSOR_CSV_HPP
 #define XTENSOR_CSV_HPP
 
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <exception>
+#include <fstream>
 #include <istream>
 #include <iterator>
+#include <limits>
+#include <numeric>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
+#include "xfile_mapping.hpp"
+#include "xformat.hpp"
+#include "xparallel.hpp"
 #include "xtensor.hpp"
 
 namespace xt
@@ -28,11 +42,44 @@ namespace xt
     template <class T, class A = std::allocator<T>>
     using xcsv_tensor = xtensor_container<std::vector<T, A>, 2, layout_type::row_major>;
 
+    /**
+     * Type used to parse a column of a CSV file, see csv_options.
+     */
+    enum class csv_dtype
+    {
+        /// the column is parsed as the value type of the result
+        value_type,
+        /// the column is parsed as a 64-bit integer, then converted
+        integer,
+        /// the column is parsed as a double, then converted
+        floating
+    };
+
+    /**
+     * Options of load_csv for CSV files.
+     */
+    struct csv_options
+    {
+        /// the character separating the cells of a row
+        char delimiter = ',';
+        /// the number of lines skipped at the beginning of the file, e.g. a header
+        std::size_t skip_rows = 0;
+        /// the indices of the columns to load, in the order of the result; all
+        /// the columns are loaded if empty
+        std::vector<std::size_t> columns;
+        /// the types used to parse the columns, indexed like the columns of the
+        /// file; the missing ones are parsed as the value type of the result
+        std::vector<csv_dtype> dtypes;
+    };
+
     template <class T, class A = std::allocator<T>>
     xcsv_tensor<T, A> load_csv(std::istream& stream);
 
+    template <class T, class A = std::allocator<T>>
+    xcsv_tensor<T, A> load_csv(const std::string& filename, const csv_options& options = csv_options());
+
     template <class E>
-    void dump_csv(std::ostream& stream, const xexpression<E>& e);
+    void dump_csv(std::ostream& stream, const xexpression<E>& e, std::streamsize precision = -1);
 
     /*****************************************
      * load_csv and dump_csv implementations *
@@ -76,19 +123,392 @@ namespace xt
         template <>
         inline unsigned long long lexical_cast<unsigned long long>(const std::string& cell) { return std::stoull(cell); }
 
+        /**************
+         * csv_reader *
+         **************/
+
+        // Reads the stream by large blocks and returns the lines in place,
+        // without allocating per line.
+        class csv_reader
+        {
+        public:
+
+            explicit csv_reader(std::istream& stream);
+
+            bool next_line(const char*& first, const char*& last);
+
+        private:
+
+            void fill();
+
+            std::istream& m_stream;
+            std::vector<char> m_buffer;
+            std::size_t m_begin;
+            std::size_t m_end;
+            bool m_eof;
+        };
+
+        inline csv_reader::csv_reader(std::istream& stream)
+            : m_stream(stream), m_buffer(std::size_t(1) << 16), m_begin(0), m_end(0), m_eof(false)
+        {
+            m_buffer[0] = '\0';
+        }
+
+        inline void csv_reader::fill()
+        {
+            // move the incomplete line to the front, and grow the buffer
+            // if it is not large enough to hold it
+            std::size_t remaining = m_end - m_begin;
+            std::memmove(m_buffer.data(), m_buffer.data() + m_begin, remaining);
+            m_begin = 0;
+            m_end = remaining;
+            if (m_end + 1 >= m_buffer.size())
+            {
+                m_buffer.resize(2 * m_buffer.size());
+            }
+            // the last byte is kept for a terminating null character
+            m_stream.read(m_buffer.data() + m_end, std::streamsize(m_buffer.size() - m_end - 1));
+            std::size_t count = static_cast<std::size_t>(m_stream.gcount());
+            m_end += count;
+            m_buffer[m_end] = '\0';
+            if (count == 0 || !m_stream)
+            {
+                m_eof = true;
+            }
+        }
+
+        inline bool csv_reader::next_line(const char*& first, const char*& last)
+        {
+            std::size_t searched = m_begin;
+            while (true)
+            {
+                const char* begin = m_buffer.data() + m_begin;
+                const void* nl = std::memchr(m_buffer.data() + searched, '\n', m_end - searched);
+                if (nl != nullptr || (m_eof && m_begin != m_end))
+                {
+                    first = begin;
+                    last = nl != nullptr ? static_cast<const char*>(nl) : m_buffer.data() + m_end;
+                    m_begin = static_cast<std::size_t>(last - m_buffer.data()) + (nl != nullptr ? 1 : 0);
+                    if (last != first && *(last - 1) == '\r')
+                    {
+                        --last;
+                    }
+                    return true;
+                }
+                if (m_eof)
+                {
+                    return false;
+                }
+                std::size_t scanned = m_end - m_begin;
+                fill();
+                searched = m_begin + scanned;
+            }
+        }
+
+        /*****************
+         * number parser *
+         *****************/
+
+        inline const char* skip_csv_blanks(const char* first, const char* last)
+        {
+            while (first != last && (*first == ' ' || *first == '\t'))
+            {
+                ++first;
+            }
+            return first;
+        }
+
+        template <class T>
+        struct csv_float_traits;
+
+        template <>
+        struct csv_float_traits<float>
+        {
+            // largest exactly representable mantissa and power of ten
+            static constexpr std::uint64_t max_mantissa = std::uint64_t(1) << 24;
+            static constexpr int max_exponent = 10;
+
+            static float convert(const char* first, char** end)
+            {
+                return std::strtof(first, end);
+            }
+        };
+
+        template <>
+        struct csv_float_traits<double>
+        {
+            static constexpr std::uint64_t max_mantissa = std::uint64_t(1) << 53;
+            static constexpr int max_exponent = 22;
+
+            static double convert(const char* first, char** end)
+            {
+                return std::strtod(first, end);
+            }
+        };
+
+        template <>
+        struct csv_float_traits<long double>
+        {
+            static constexpr std::uint64_t max_mantissa = std::uint64_t(1) << 53;
+            static constexpr int max_exponent = 22;
+
+            static long double convert(const char* first, char** end)
+            {
+                return std::strtold(first, end);
+            }
+        };
+
+        // Parses a floating point number. The common case of a number with at
+        // most 19 significant digits whose mantissa and power of ten are exactly
+        // representable is computed with a single multiplication or division,
+        // which is correctly rounded; the other numbers (and inf or nan) are
+        // converted with strtod. Returns nullptr if no number could be parsed.
+        template <class T>
+        inline const char* parse_csv_float(const char* first, const char* last, T& value)
+        {
+            using traits = csv_float_traits<T>;
+            static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                             1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+            const char* p = first;
+            bool negative = false;
+            if (p != last && (*p == '-' || *p == '+'))
+            {
+                negative = *p == '-';
+                ++p;
+            }
+            std::uint64_t mantissa = 0;
+            int n_digits = 0;
+            int exponent = 0;
+            const char* digits = p;
+            for (; p != last && *p >= '0' && *p <= '9'; ++p)
+            {
+                mantissa = 10 * mantissa + std::uint64_t(*p - '0');
+                n_digits += mantissa != 0 ? 1 : 0;
+            }
+            bool has_digits = p != digits;
+            if (p != last && *p == '.')
+            {
+                const char* fraction = ++p;
+                for (; p != last && *p >= '0' && *p <= '9'; ++p)
+                {
+                    mantissa = 10 * mantissa + std::uint64_t(*p - '0');
+                    n_digits += mantissa != 0 ? 1 : 0;
+                }
+                exponent = -static_cast<int>(p - fraction);
+                has_digits = has_digits || p != fraction;
+            }
+            if (has_digits && p != last && (*p == 'e' || *p == 'E'))
+            {
+                const char* q = p + 1;
+                bool negative_exponent = false;
+                if (q != last && (*q == '-' || *q == '+'))
+                {
+                    negative_exponent = *q == '-';
+                    ++q;
+                }
+                if (q != last && *q >= '0' && *q <= '9')
+                {
+                    int e = 0;
+                    for (; q != last && *q >= '0' && *q <= '9'; ++q)
+                    {
+                        e = e < 10000 ? 10 * e + (*q - '0') : e;
+                    }
+                    exponent += negative_exponent ? -e : e;
+                    p = q;
+                }
+            }
+
+            if (has_digits && n_digits <= 19 && mantissa <= traits::max_mantissa &&
+                exponent >= -traits::max_exponent && exponent <= traits::max_exponent)
+            {
+                T m = static_cast<T>(mantissa);
+                T v = exponent < 0 ? m / static_cast<T>(powers[-exponent]) : m * static_cast<T>(powers[exponent]);
+                value = negative ? -v : v;
+                return p;
+            }
+
+            // strtod needs a null terminated string: the characters that may
+            // belong to the number (including inf, nan and hexadecimal floats)
+            // are copied
+            const char* span = first;
+            while (span != last && (std::isalnum(static_cast<unsigned char>(*span)) || *span == '+' ||
+                                    *span == '-' || *span == '.' || *span == '(' || *span == ')' || *span == '_'))
+            {
+                ++span;
+            }
+            char buffer[64];
+            std::string long_span;
+            const char* source = buffer;
+            std::size_t length = static_cast<std::size_t>(span - first);
+            if (length < sizeof(buffer))
+            {
+                std::memcpy(buffer, first, length);
+                buffer[length] = '\0';
+            }
+            else
+            {
+                long_span.assign(first, span);
+                source = long_span.c_str();
+            }
+            char* end = nullptr;
+            value = traits::convert(source, &end);
+            return end == source ? nullptr : first + (end - source);
+        }
+
+        template <class T>
+        inline const char* parse_csv_integer(const char* first, const char* last, T& value)
+        {
+            const char* p = first;
+            bool negative = false;
+            if (p != last && (*p == '-' || *p == '+'))
+            {
+                negative = *p == '-';
+                ++p;
+            }
+            using unsigned_type = unsigned long long;
+            const unsigned_type max = negative ? unsigned_type(std::numeric_limits<T>::max()) + 1
+                                               : unsigned_type(std::numeric_limits<T>::max());
+            if (negative && std::is_unsigned<T>::value)
+            {
+                return nullptr;
+            }
+            unsigned_type res = 0;
+            const char* digits = p;
+            for (; p != last && *p >= '0' && *p <= '9'; ++p)
+            {
+                unsigned_type d = unsigned_type(*p - '0');
+                if (res > (max - d) / 10)
+                {
+                    throw std::out_of_range("Value out of range in CSV");
+                }
+                res = 10 * res + d;
+            }
+            if (p == digits)
+            {
+                return nullptr;
+            }
+            value = negative ? static_cast<T>(0 - res) : static_cast<T>(res);
+            return p;
+        }
+
+        template <class T>
+        using csv_parser_category = std::integral_constant<int,
+            std::is_floating_point<T>::value ? 0 :
+            (std::is_integral<T>::value && !std::is_same<T, bool>::value && sizeof(T) > sizeof(char)) ? 1 : 2>;
+
+        template <class T>
+        inline const char* parse_csv_value(const char* first, const char* last, T& value, char, std::integral_constant<int, 0>)
+        {
+            return parse_csv_float(first, last, value);
+        }
+
+        template <class T>
+        inline const char* parse_csv_value(const char* first, const char* last, T& value, char, std::integral_constant<int, 1>)
+        {
+            return parse_csv_integer(first, last, value);
+        }
+
+        // other types are read with their stream operator
+        template <class T>
+        inline const char* parse_csv_value(const char* first, const char* last, T& value, char delimiter,
+                                           std::integral_constant<int, 2>)
+        {
+            const char* end = std::find(first, last, delimiter);
+            while (end != first && (*(end - 1) == ' ' || *(end - 1) == '\t'))
+            {
+                --end;
+            }
+            value = lexical_cast<T>(std::string(first, end));
+            return end;
+        }
+
+        // parses the value of a column parsed as another type than T
+        template <class T, class V>
+        inline const char* parse_csv_as(const char* first, const char* last, T& value, std::true_type)
+        {
+            V v;
+            const char* end = parse_csv_value(first, last, v, ',', csv_parser_category<V>());
+            value = static_cast<T>(v);
+            return end;
+        }
+
+        template <class T, class V>
+        inline const char* parse_csv_as(const char*, const char*, T&, std::false_type)
+        {
+            throw std::runtime_error("CSV column types can only be used with arithmetic value types");
+        }
+
+        // Parses the cell beginning at first and returns the position of the
+        // following delimiter, or last if this is the last cell of the row.
+        template <class T>
+        inline const char* parse_csv_cell(const char* first, const char* last, T& value, char delimiter,
+                                          csv_dtype dtype = csv_dtype::value_type)
+        {
+            const char* cell = skip_csv_blanks(first, last);
+            const char* end = nullptr;
+            switch (dtype)
+            {
+            case csv_dtype::integer:
+                end = parse_csv_as<T, long long>(cell, last, value, std::is_arithmetic<T>());
+                break;
+            case csv_dtype::floating:
+                end = parse_csv_as<T, double>(cell, last, value, std::is_arithmetic<T>());
+                break;
+            default:
+                end = parse_csv_value(cell, last, value, delimiter, csv_parser_category<T>());
+                break;
+            }
+            end = end == nullptr ? cell : skip_csv_blanks(end, last);
+            if (end == cell || (end != last && *end != delimiter))
+            {
+                const char* cell_end = std::find(cell, last, delimiter);
+                throw std::runtime_error("Invalid value in CSV: " + std::string(cell, cell_end));
+            }
+            return end;
+        }
+
         template <class ST, class T, class OI>
-        ST load_csv_row(std::istream& row_stream, OI output, std::string cell)
+        ST load_csv_row(const char* first, const char* last, OI output, char delimiter = ',')
         {
             ST length = 0;
-            while (std::getline(row_stream, cell, ','))
+            while (first != last)
             {
-                *output++ = lexical_cast<T>(cell);
+                T value;
+                const char* end = parse_csv_cell(first, last, value, delimiter);
+                *output++ = value;
                 ++length;
+                // a trailing delimiter is followed by an empty cell
+                first = end == last ? last : end + 1;
+                if (end != last && first == last)
+                {
+                    throw std::runtime_error("Invalid value in CSV: empty cell");
+                }
             }
             return length;
         }
-    }
 
+        // Calls f(line_first, line_last) on the non empty lines of [first, last).
+        template <class F>
+        inline void for_each_csv_line(const char* first, const char* last, F&& f)
+        {
+            while (first != last)
+            {
+                const void* nl = std::memchr(first, '\n', static_cast<std::size_t>(last - first));
+                const char* line_last = nl != nullptr ? static_cast<const char*>(nl) : last;
+                const char* next = nl != nullptr ? line_last + 1 : last;
+                if (line_last != first && *(line_last - 1) == '\r')
+                {
+                    --line_last;
+                }
+                if (line_last != first)
+                {
+                    f(first, line_last);
+                }
+                first = next;
+            }
+        }
+    }
     /**
      * @brief Load tensor from CSV.
      * 
@@ -109,11 +529,12 @@ namespace xt
         size_type nbrow = 0, nbcol = 0;
         {
             output_iterator output(data);
-            std::string row, cell;
-            while (std::getline(stream, row))
+            detail::csv_reader reader(stream);
+            const char* first;
+            const char* last;
+            while (reader.next_line(first, last))
             {
-                std::stringstream row_stream(row);
-                nbcol = detail::load_csv_row<size_type, T, output_iterator>(row_stream, output, cell);
+                nbcol = detail::load_csv_row<size_type, T, output_iterator>(first, last, output);
                 ++nbrow;
             }
         }
@@ -128,14 +549,200 @@ namespace xt
         return tensor_type(std::move(data), std::move(shape), std::move(strides));
     }
 
+    namespace detail
+    {
+        // Splits [first, last) into chunks beginning at line boundaries.
+        inline std::vector<const char*> split_csv_lines(const char* first, const char* last)
+        {
+            std::size_t n_bytes = static_cast<std::size_t>(last - first);
+            std::size_t chunk_min = std::max(parallel::grain(1), std::size_t(4096));
+            std::size_t n_chunks = parallel::use_parallel(n_bytes) ?
+                std::max(std::min(std::size_t(64), n_bytes / chunk_min), std::size_t(1)) : std::size_t(1);
+            std::vector<const char*> starts(n_chunks + 1, last);
+            starts[0] = first;
+            for (std::size_t k = 1; k < n_chunks; ++k)
+            {
+                const char* p = std::max(first + k * (n_bytes / n_chunks), starts[k - 1]);
+                if (p == last)
+                {
+                    break;
+                }
+                // a chunk begins after the end of line preceding its nominal start
+                const void* nl = std::memchr(p - 1, '\n', static_cast<std::size_t>(last - p + 1));
+                starts[k] = nl != nullptr ? static_cast<const char*>(nl) + 1 : last;
+            }
+            return starts;
+        }
+
+        template <class F>
+        inline void for_each_csv_chunk(std::size_t n_chunks, F&& f)
+        {
+            // the exceptions are rethrown in the order of the chunks
+            std::vector<std::exception_ptr> errors(n_chunks);
+            auto run = [&](std::size_t first, std::size_t last)
+            {
+                for (std::size_t c = first; c < last; ++c)
+                {
+                    try
+                    {
+                        f(c);
+                    }
+                    catch (...)
+                    {
+                        errors[c] = std::current_exception();
+                    }
+                }
+            };
+            if (n_chunks > 1)
+            {
+                parallel_for(std::size_t(0), n_chunks, std::size_t(1), run);
+            }
+            else
+            {
+                run(std::size_t(0), n_chunks);
+            }
+            for (const auto& e : errors)
+            {
+                if (e)
+                {
+                    std::rethrow_exception(e);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Load tensor from a CSV file.
+     *
+     * The file is mapped in memory. Its lines are split among threads, which
+     * parse them directly into the result. Empty lines are ignored.
+     * @param filename the name of the CSV file
+     * @param options the delimiter, the number of lines to skip, and the
+     *                columns to load with their types
+     */
+    template <class T, class A>
+    xcsv_tensor<T, A> load_csv(const std::string& filename, const csv_options& options)
+    {
+        using tensor_type = xcsv_tensor<T, A>;
+        using shape_type = typename tensor_type::shape_type;
+        using size_type = typename tensor_type::size_type;
+
+        {
+            std::ifstream stream(filename, std::ifstream::binary | std::ifstream::ate);
+            if (!stream)
+            {
+                throw std::runtime_error("IO Error: failed to open file: "s + filename);
+            }
+            if (stream.tellg() == 0)
+            {
+                return tensor_type(shape_type({0, 0}));
+            }
+        }
+        detail::file_mapping mapping(filename, mmap_mode::read_only);
+        const char* first = mapping.data();
+        const char* last = first + mapping.size();
+        for (std::size_t i = 0; i < options.skip_rows && first != last; ++i)
+        {
+            const void* nl = std::memchr(first, '\n', static_cast<std::size_t>(last - first));
+            first = nl != nullptr ? static_cast<const char*>(nl) + 1 : last;
+        }
+
+        // the first line gives the number of columns
+        size_type n_columns = 0;
+        detail::for_each_csv_line(first, last, [&](const char* f, const char* l)
+        {
+            if (n_columns == 0)
+            {
+                n_columns = static_cast<size_type>(std::count(f, l, options.delimiter)) + 1;
+            }
+        });
+
+        std::vector<std::ptrdiff_t> target(n_columns, -1);
+        size_type n_selected = options.columns.empty() ? n_columns : options.columns.size();
+        for (size_type k = 0; k < n_selected; ++k)
+        {
+            size_type c = options.columns.empty() ? k : options.columns[k];
+            if (c >= n_columns || target[c] != -1)
+            {
+                throw std::runtime_error("Invalid column selection in CSV: " + std::to_string(c));
+            }
+            target[c] = static_cast<std::ptrdiff_t>(k);
+        }
+        if (options.dtypes.size() > n_columns)
+        {
+            throw std::runtime_error("More column types than columns in CSV");
+        }
+        std::vector<csv_dtype> dtypes(options.dtypes);
+        dtypes.resize(n_columns, csv_dtype::value_type);
+
+        // the bits of std::vector<bool> cannot be written concurrently
+        std::vector<const char*> starts = std::is_same<T, bool>::value ?
+            std::vector<const char*>({first, last}) : detail::split_csv_lines(first, last);
+        std::size_t n_chunks = starts.size() - 1;
+        std::vector<size_type> row_offsets(n_chunks + 1, 0);
+        detail::for_each_csv_chunk(n_chunks, [&](std::size_t c)
+        {
+            size_type count = 0;
+            detail::for_each_csv_line(starts[c], starts[c + 1], [&count](const char*, const char*) { ++count; });
+            row_offsets[c + 1] = count;
+        });
+        std::partial_sum(row_offsets.begin(), row_offsets.end(), row_offsets.begin());
+
+        tensor_type res(shape_type({row_offsets.back(), n_selected}));
+        detail::for_each_csv_chunk(n_chunks, [&](std::size_t c)
+        {
+            size_type row = row_offsets[c];
+            detail::for_each_csv_line(starts[c], starts[c + 1], [&](const char* f, const char* l)
+            {
+                auto output = res.storage().begin() + static_cast<std::ptrdiff_t>(row * n_selected);
+                size_type column = 0;
+                while (true)
+                {
+                    if (column == n_columns)
+                    {
+                        throw std::runtime_error("Inconsistent row lengths in CSV");
+                    }
+                    const char* end;
+                    if (target[column] >= 0)
+                    {
+                        T value;
+                        end = detail::parse_csv_cell(f, l, value, options.delimiter, dtypes[column]);
+                        output[target[column]] = value;
+                    }
+                    else
+                    {
+                        end = std::find(f, l, options.delimiter);
+                    }
+                    ++column;
+                    if (end == l)
+                    {
+                        break;
+                    }
+                    f = end + 1;
+                }
+                if (column != n_columns)
+                {
+                    throw std::runtime_error("Inconsistent row lengths in CSV");
+                }
+                ++row;
+            });
+        });
+        return res;
+    }
+
     /**
      * @brief Dump tensor to CSV.
-     * 
+     *
+     * The values are formatted in a buffer which is written to the stream
+     * in large blocks.
      * @param stream the output stream to write the CSV encoded values
      * @param e the tensor expression to serialize
+     * @param precision the number of significant digits of floating point
+     *                  values; the default gives the shortest representation
+     *                  that is read back as the same value
      */
     template <class E>
-    void dump_csv(std::ostream& stream, const xexpression<E>& e)
+    void dump_csv(std::ostream& stream, const xexpression<E>& e, std::streamsize precision)
     {
         using size_type = typename E::size_type;
         const E& ex = e.derived_cast();
@@ -144,25 +751,29 @@ namespace xt
             throw std::runtime_error("Only 2-D expressions can be serialized to CSV");
         }
         size_type nbrows = ex.shape()[0], nbcols = ex.shape()[1];
+        int prec = precision < 0 ? -1 : static_cast<int>(std::min(precision, std::streamsize(detail::max_format_precision)));
+        detail::format_buffer buffer(stream);
         auto st = ex.stepper_begin(ex.shape());
         for (size_type r = 0; r != nbrows; ++r)
         {
             for (size_type c = 0; c != nbcols; ++c)
             {
-                stream << *st;
+                buffer.format(*st, prec);
                 if (c != nbcols - 1)
                 {
                     st.step(1);
-                    stream << ',';
+                    buffer.put(',');
                 }
                 else
                 {
                     st.reset(1);
                     st.step(0);
-                    stream << std::endl;
+                    buffer.put('\n');
                 }
             }
         }
+        buffer.flush();
+        stream.flush();
     }
 }
 
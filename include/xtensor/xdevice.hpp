@@ -0,0 +1,748 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_DEVICE_HPP
+#define XTENSOR_DEVICE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#ifdef XTENSOR_USE_OPENMP_OFFLOAD
+#include <omp.h>
+#endif
+
+#include "xarray.hpp"
+#include "xexpression.hpp"
+#include "xfunction.hpp"
+#include "xscalar.hpp"
+#include "xstrides.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+    template <class T>
+    class xdevice_array;
+
+    namespace detail
+    {
+        /*****************
+         * device memory *
+         *****************/
+
+        // maximum dimension of the expressions evaluated on the device, the
+        // indices of the broadcast operands are unravelled in fixed size arrays
+        constexpr std::size_t device_max_dimension = 8;
+
+#ifdef XTENSOR_USE_OPENMP_OFFLOAD
+        inline void* device_allocate(std::size_t bytes)
+        {
+            void* p = omp_target_alloc(bytes, omp_get_default_device());
+            if (p == nullptr)
+            {
+                throw std::bad_alloc();
+            }
+            return p;
+        }
+
+        inline void device_deallocate(void* p) noexcept
+        {
+            omp_target_free(p, omp_get_default_device());
+        }
+
+        inline void device_memcpy(void* dst, const void* src, std::size_t bytes, int dst_device, int src_device)
+        {
+            if (omp_target_memcpy(dst, const_cast<void*>(src), bytes, 0, 0, dst_device, src_device) != 0)
+            {
+                throw std::runtime_error("device: transfer failed");
+            }
+        }
+
+        inline void copy_to_device(void* dst, const void* src, std::size_t bytes)
+        {
+            device_memcpy(dst, src, bytes, omp_get_default_device(), omp_get_initial_device());
+        }
+
+        inline void copy_to_host(void* dst, const void* src, std::size_t bytes)
+        {
+            device_memcpy(dst, src, bytes, omp_get_initial_device(), omp_get_default_device());
+        }
+
+        inline void copy_on_device(void* dst, const void* src, std::size_t bytes)
+        {
+            device_memcpy(dst, src, bytes, omp_get_default_device(), omp_get_default_device());
+        }
+#else
+        // without offloading, the device is the host
+        inline void* device_allocate(std::size_t bytes)
+        {
+            void* p = std::malloc(bytes);
+            if (p == nullptr)
+            {
+                throw std::bad_alloc();
+            }
+            return p;
+        }
+
+        inline void device_deallocate(void* p) noexcept
+        {
+            std::free(p);
+        }
+
+        inline void copy_to_device(void* dst, const void* src, std::size_t bytes)
+        {
+            std::memcpy(dst, src, bytes);
+        }
+
+        inline void copy_to_host(void* dst, const void* src, std::size_t bytes)
+        {
+            std::memcpy(dst, src, bytes);
+        }
+
+        inline void copy_on_device(void* dst, const void* src, std::size_t bytes)
+        {
+            std::memcpy(dst, src, bytes);
+        }
+#endif
+    }
+
+    /*****************
+     * xdevice_array *
+     *****************/
+
+    /**
+     * @class xdevice_array
+     * @brief Dense multidimensional array stored in the memory of an
+     * accelerator.
+     *
+     * The elements of an xdevice_array are stored in row-major order in the
+     * memory of the default OpenMP device when XTENSOR_USE_OPENMP_OFFLOAD
+     * is defined, and in host memory otherwise. They are not accessible
+     * from the host: they are transferred explicitly with device::to_device
+     * and device::to_host.
+     *
+     * Elementwise functions of device arrays and scalars, built with the
+     * operators and the mathematical functions of xtensor, are evaluated
+     * on the device when they are assigned to an xdevice_array, or reduced
+     * with device::sum and device::amax. Their operands are broadcast as
+     * usual.
+     *
+     * @tparam T the value type of the elements, trivially copyable
+     */
+    template <class T>
+    class xdevice_array : public xexpression<xdevice_array<T>>
+    {
+    public:
+
+        static_assert(std::is_trivially_copyable<T>::value, "xdevice_array only holds trivially copyable values");
+
+        using self_type = xdevice_array<T>;
+        using value_type = T;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using shape_type = dynamic_shape<std::size_t>;
+        using expression_tag = xtensor_expression_tag;
+
+        static constexpr layout_type static_layout = layout_type::row_major;
+        static constexpr bool contiguous_layout = true;
+
+        xdevice_array();
+        explicit xdevice_array(const shape_type& shape);
+
+        template <class E>
+        xdevice_array(const xexpression<E>& e);
+
+        ~xdevice_array();
+
+        xdevice_array(const xdevice_array& rhs);
+        xdevice_array& operator=(const xdevice_array& rhs);
+
+        xdevice_array(xdevice_array&& rhs) noexcept;
+        xdevice_array& operator=(xdevice_array&& rhs) noexcept;
+
+        template <class E>
+        self_type& operator=(const xexpression<E>& e);
+
+        size_type size() const noexcept;
+        size_type dimension() const noexcept;
+        const shape_type& shape() const noexcept;
+        layout_type layout() const noexcept;
+
+        pointer data() noexcept;
+        const_pointer data() const noexcept;
+
+        void resize(const shape_type& shape);
+
+        template <class S>
+        bool broadcast_shape(S& shape, bool reuse_cache = false) const;
+
+    private:
+
+        void swap(xdevice_array& rhs) noexcept;
+
+        shape_type m_shape;
+        size_type m_size = 0;
+        pointer p_data = nullptr;
+    };
+
+    namespace detail
+    {
+        /*******************
+         * device closures *
+         *******************/
+
+        // The closures evaluated on the device are trivially copyable
+        // copies of the expression trees, computing the element at a given
+        // row-major index of the result.
+
+        template <class... C>
+        struct device_pack;
+
+        template <>
+        struct device_pack<>
+        {
+        };
+
+        template <class C, class... R>
+        struct device_pack<C, R...>
+        {
+            C head;
+            device_pack<R...> tail;
+        };
+
+        inline device_pack<> make_device_pack()
+        {
+            return {};
+        }
+
+        template <class C, class... R>
+        inline device_pack<C, R...> make_device_pack(const C& c, const R&... r)
+        {
+            return {c, make_device_pack(r...)};
+        }
+
+        template <std::size_t I>
+        struct device_pack_get
+        {
+            template <class P>
+            static const auto& get(const P& p) noexcept
+            {
+                return device_pack_get<I - 1>::get(p.tail);
+            }
+        };
+
+        template <>
+        struct device_pack_get<0>
+        {
+            template <class P>
+            static const auto& get(const P& p) noexcept
+            {
+                return p.head;
+            }
+        };
+
+        template <class T>
+        struct device_scalar
+        {
+            T value;
+
+            T operator()(std::size_t) const noexcept
+            {
+                return value;
+            }
+        };
+
+        template <class T>
+        struct device_operand
+        {
+            const T* p_data;
+            bool linear;
+            std::size_t dimension;
+            index_divider shape[device_max_dimension];
+            std::size_t strides[device_max_dimension];
+
+            T operator()(std::size_t i) const noexcept
+            {
+                if (linear)
+                {
+                    return p_data[i];
+                }
+                std::size_t offset = 0;
+                for (std::size_t d = dimension; d != 0; --d)
+                {
+                    offset += shape[d - 1].divmod(i) * strides[d - 1];
+                }
+                return p_data[offset];
+            }
+        };
+
+        template <class F, class... C>
+        struct device_function
+        {
+            F functor;
+            device_pack<C...> arguments;
+
+            auto operator()(std::size_t i) const
+            {
+                return apply(i, std::make_index_sequence<sizeof...(C)>());
+            }
+
+            template <std::size_t... I>
+            auto apply(std::size_t i, std::index_sequence<I...>) const
+            {
+                return functor(device_pack_get<I>::get(arguments)(i)...);
+            }
+        };
+
+        template <class T, class S>
+        inline device_operand<T> make_device_closure(const xdevice_array<T>& a, const S& shape);
+
+        template <class CT, class S>
+        inline device_scalar<std::decay_t<CT>> make_device_closure(const xscalar<CT>& s, const S& shape);
+
+        template <class F, class... CT, class S>
+        inline auto make_device_closure(const xfunction<F, CT...>& f, const S& shape);
+
+        template <class E, class S>
+        inline device_scalar<int> make_device_closure(const xexpression<E>& e, const S& shape);
+
+        template <class T, class S>
+        inline device_operand<T> make_device_closure(const xdevice_array<T>& a, const S& shape)
+        {
+            // the operand is broadcast by null strides
+            device_operand<T> res;
+            res.p_data = a.data();
+            res.linear = a.dimension() == shape.size() && std::equal(shape.cbegin(), shape.cend(), a.shape().cbegin());
+            res.dimension = shape.size();
+            std::size_t stride = 1;
+            for (std::size_t d = shape.size(); d != 0; --d)
+            {
+                res.shape[d - 1] = index_divider(shape[d - 1]);
+                res.strides[d - 1] = 0;
+                if (d - 1 + a.dimension() >= shape.size())
+                {
+                    std::size_t extent = a.shape()[d - 1 + a.dimension() - shape.size()];
+                    res.strides[d - 1] = extent == 1 ? 0 : stride;
+                    stride *= extent;
+                }
+            }
+            return res;
+        }
+
+        template <class CT, class S>
+        inline device_scalar<std::decay_t<CT>> make_device_closure(const xscalar<CT>& s, const S&)
+        {
+            return {s()};
+        }
+
+        template <class F, class... CT, class S, std::size_t... I>
+        inline auto make_device_function(const xfunction<F, CT...>& f, const S& shape, std::index_sequence<I...>)
+        {
+            using functor_type = typename xfunction<F, CT...>::functor_type;
+            static_assert(std::is_trivially_copyable<functor_type>::value,
+                          "the functions evaluated on the device must be trivially copyable");
+            using closure_type = device_function<functor_type, decltype(make_device_closure(std::get<I>(f.arguments()), shape))...>;
+            return closure_type{f.functor(), make_device_pack(make_device_closure(std::get<I>(f.arguments()), shape)...)};
+        }
+
+        template <class F, class... CT, class S>
+        inline auto make_device_closure(const xfunction<F, CT...>& f, const S& shape)
+        {
+            return make_device_function(f, shape, std::make_index_sequence<sizeof...(CT)>());
+        }
+
+        template <class E, class S>
+        inline device_scalar<int> make_device_closure(const xexpression<E>&, const S&)
+        {
+            static_assert(!std::is_same<E, E>::value,
+                          "device expressions only hold device arrays, scalars and functions of them: "
+                          "transfer the host operands with device::to_device");
+            return {0};
+        }
+
+        template <class E>
+        inline dynamic_shape<std::size_t> device_shape(const E& e)
+        {
+            if (e.dimension() > device_max_dimension)
+            {
+                throw std::runtime_error("device: the expressions have at most " +
+                                         std::to_string(device_max_dimension) + " dimensions");
+            }
+            return dynamic_shape<std::size_t>(e.shape().cbegin(), e.shape().cend());
+        }
+
+        /******************
+         * device kernels *
+         ******************/
+
+        template <class T, class C>
+        inline void device_assign(T* out, std::size_t n, const C& closure)
+        {
+            C c = closure;
+#ifdef XTENSOR_USE_OPENMP_OFFLOAD
+#pragma omp target teams distribute parallel for is_device_ptr(out) firstprivate(c)
+#endif
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                out[i] = static_cast<T>(c(i));
+            }
+        }
+
+        template <class R, class C>
+        inline R device_sum(std::size_t n, const C& closure)
+        {
+            C c = closure;
+            R res = R(0);
+#ifdef XTENSOR_USE_OPENMP_OFFLOAD
+#pragma omp target teams distribute parallel for firstprivate(c) map(tofrom : res) reduction(+ : res)
+#endif
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                res += static_cast<R>(c(i));
+            }
+            return res;
+        }
+
+        template <class R, class C>
+        inline R device_max(std::size_t n, const C& closure)
+        {
+            C c = closure;
+            R res = std::numeric_limits<R>::lowest();
+#ifdef XTENSOR_USE_OPENMP_OFFLOAD
+#pragma omp target teams distribute parallel for firstprivate(c) map(tofrom : res) reduction(max : res)
+#endif
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                R v = static_cast<R>(c(i));
+                res = v > res ? v : res;
+            }
+            return res;
+        }
+
+        /*******************
+         * host transfers *
+         *******************/
+
+        template <class E, class = void>
+        struct is_device_transferable : std::false_type
+        {
+        };
+
+        template <class E>
+        struct is_device_transferable<E, std::enable_if_t<has_data_interface<E>::value>>
+            : std::integral_constant<bool, E::contiguous_layout && !is_bitset_container<E>::value &&
+                                           std::is_same<data_value_type_t<E>, typename E::value_type>::value>
+        {
+        };
+
+        template <class T, class E>
+        inline void transfer_to_device(T* dst, const E& e, std::false_type)
+        {
+            xarray<T, layout_type::row_major> tmp = e;
+            copy_to_device(dst, tmp.data(), tmp.size() * sizeof(T));
+        }
+
+        template <class T, class E>
+        inline void transfer_to_device(T* dst, const E& e, std::true_type)
+        {
+            // contiguous row-major storages are transferred without copy
+            if (e.dimension() > 1 && e.layout() != layout_type::row_major)
+            {
+                transfer_to_device(dst, e, std::false_type());
+            }
+            else
+            {
+                copy_to_device(dst, e.data() + e.data_offset(), e.size() * sizeof(T));
+            }
+        }
+    }
+
+    /********************************
+     * xdevice_array implementation *
+     ********************************/
+
+    /**
+     * Allocates a 0-D array on the device, its element is not initialized.
+     */
+    template <class T>
+    inline xdevice_array<T>::xdevice_array()
+    {
+        resize(shape_type());
+    }
+
+    /**
+     * Allocates an array of the specified shape on the device, the
+     * elements are not initialized.
+     * @param shape the shape of the array
+     */
+    template <class T>
+    inline xdevice_array<T>::xdevice_array(const shape_type& shape)
+    {
+        resize(shape);
+    }
+
+    /**
+     * Evaluates the elementwise expression \a e on the device.
+     */
+    template <class T>
+    template <class E>
+    inline xdevice_array<T>::xdevice_array(const xexpression<E>& e)
+    {
+        *this = e;
+    }
+
+    template <class T>
+    inline xdevice_array<T>::~xdevice_array()
+    {
+        if (p_data != nullptr)
+        {
+            detail::device_deallocate(p_data);
+        }
+    }
+
+    template <class T>
+    inline xdevice_array<T>::xdevice_array(const xdevice_array& rhs)
+        : xdevice_array(rhs.m_shape)
+    {
+        if (m_size != 0)
+        {
+            detail::copy_on_device(p_data, rhs.p_data, m_size * sizeof(T));
+        }
+    }
+
+    template <class T>
+    inline auto xdevice_array<T>::operator=(const xdevice_array& rhs) -> self_type&
+    {
+        self_type tmp(rhs);
+        swap(tmp);
+        return *this;
+    }
+
+    template <class T>
+    inline xdevice_array<T>::xdevice_array(xdevice_array&& rhs) noexcept
+        : m_shape(), m_size(0), p_data(nullptr)
+    {
+        swap(rhs);
+    }
+
+    template <class T>
+    inline auto xdevice_array<T>::operator=(xdevice_array&& rhs) noexcept -> self_type&
+    {
+        swap(rhs);
+        return *this;
+    }
+
+    /**
+     * Evaluates the elementwise expression \a e on the device, and
+     * resizes the array to its shape if needed.
+     */
+    template <class T>
+    template <class E>
+    inline auto xdevice_array<T>::operator=(const xexpression<E>& e) -> self_type&
+    {
+        const E& de = e.derived_cast();
+        shape_type shape = detail::device_shape(de);
+        auto closure = detail::make_device_closure(de, shape);
+        if (shape == m_shape && compute_size(shape) == m_size)
+        {
+            // the operands of the same shape are read at the index of the
+            // result, the array itself can be one of them
+            detail::device_assign(p_data, m_size, closure);
+        }
+        else
+        {
+            self_type tmp(shape);
+            detail::device_assign(tmp.p_data, tmp.m_size, closure);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    /**
+     * Returns the number of elements of the array.
+     */
+    template <class T>
+    inline auto xdevice_array<T>::size() const noexcept -> size_type
+    {
+        return m_size;
+    }
+
+    /**
+     * Returns the number of dimensions of the array.
+     */
+    template <class T>
+    inline auto xdevice_array<T>::dimension() const noexcept -> size_type
+    {
+        return m_shape.size();
+    }
+
+    /**
+     * Returns the shape of the array.
+     */
+    template <class T>
+    inline auto xdevice_array<T>::shape() const noexcept -> const shape_type&
+    {
+        return m_shape;
+    }
+
+    template <class T>
+    inline layout_type xdevice_array<T>::layout() const noexcept
+    {
+        return layout_type::row_major;
+    }
+
+    /**
+     * Returns a pointer to the elements in the device memory, it must
+     * not be dereferenced on the host.
+     */
+    template <class T>
+    inline auto xdevice_array<T>::data() noexcept -> pointer
+    {
+        return p_data;
+    }
+
+    template <class T>
+    inline auto xdevice_array<T>::data() const noexcept -> const_pointer
+    {
+        return p_data;
+    }
+
+    /**
+     * Resizes the array, the elements are not preserved when the number
+     * of elements changes.
+     * @param shape the new shape of the array
+     */
+    template <class T>
+    inline void xdevice_array<T>::resize(const shape_type& shape)
+    {
+        size_type size = compute_size(shape);
+        if (size != m_size)
+        {
+            pointer p = size == 0 ? nullptr : static_cast<pointer>(detail::device_allocate(size * sizeof(T)));
+            if (p_data != nullptr)
+            {
+                detail::device_deallocate(p_data);
+            }
+            p_data = p;
+            m_size = size;
+        }
+        m_shape = shape;
+    }
+
+    template <class T>
+    template <class S>
+    inline bool xdevice_array<T>::broadcast_shape(S& shape, bool) const
+    {
+        return xt::broadcast_shape(m_shape, shape);
+    }
+
+    template <class T>
+    inline void xdevice_array<T>::swap(xdevice_array& rhs) noexcept
+    {
+        std::swap(m_shape, rhs.m_shape);
+        std::swap(m_size, rhs.m_size);
+        std::swap(p_data, rhs.p_data);
+    }
+
+    namespace device
+    {
+        /**
+         * Transfers the values of a host expression to the device.
+         * @param e the host \ref xexpression to transfer
+         * @return an xdevice_array holding the values of \a e
+         */
+        template <class E>
+        inline auto to_device(const xexpression<E>& e)
+        {
+            using value_type = std::decay_t<typename E::value_type>;
+            const E& de = e.derived_cast();
+            xdevice_array<value_type> res(typename xdevice_array<value_type>::shape_type(de.shape().cbegin(), de.shape().cend()));
+            if (res.size() != 0)
+            {
+                detail::transfer_to_device(res.data(), de, detail::is_device_transferable<E>());
+            }
+            return res;
+        }
+
+        /**
+         * Transfers the elements of a device array to the host.
+         * @param d the xdevice_array to transfer
+         * @return a row-major xarray holding the elements of \a d
+         */
+        template <class T>
+        inline auto to_host(const xdevice_array<T>& d)
+        {
+            auto res = xarray<T, layout_type::row_major>::from_shape(d.shape());
+            if (d.size() != 0)
+            {
+                detail::copy_to_host(res.data(), d.data(), d.size() * sizeof(T));
+            }
+            return res;
+        }
+
+        /**
+         * Evaluates an elementwise expression of device arrays on the
+         * device.
+         * @param e the device \ref xexpression to evaluate
+         * @return an xdevice_array holding the values of \a e
+         */
+        template <class E>
+        inline auto eval(const xexpression<E>& e)
+        {
+            return xdevice_array<std::decay_t<typename E::value_type>>(e);
+        }
+
+        /**
+         * Returns the sum of the values of an elementwise expression of
+         * device arrays, computed on the device.
+         */
+        template <class E>
+        inline auto sum(const xexpression<E>& e)
+        {
+            using result_type = big_promote_type_t<std::decay_t<typename E::value_type>>;
+            static_assert(std::is_arithmetic<result_type>::value, "device::sum only reduces arithmetic values");
+            const E& de = e.derived_cast();
+            auto shape = detail::device_shape(de);
+            return detail::device_sum<result_type>(compute_size(shape), detail::make_device_closure(de, shape));
+        }
+
+        /**
+         * Returns the maximum of the values of an elementwise expression of
+         * device arrays, computed on the device.
+         * @throw std::runtime_error if the expression has no element
+         */
+        template <class E>
+        inline auto amax(const xexpression<E>& e)
+        {
+            using result_type = std::decay_t<typename E::value_type>;
+            static_assert(std::is_arithmetic<result_type>::value, "device::amax only reduces arithmetic values");
+            const E& de = e.derived_cast();
+            auto shape = detail::device_shape(de);
+            std::size_t size = compute_size(shape);
+            if (size == 0)
+            {
+                throw std::runtime_error("device::amax: the expression has no element");
+            }
+            return detail::device_max<result_type>(size, detail::make_device_closure(de, shape));
+        }
+    }
+}
+
+#endif
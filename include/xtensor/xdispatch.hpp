@@ -0,0 +1,374 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_DISPATCH_HPP
+#define XTENSOR_DISPATCH_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+#include "xtensor_config.hpp"
+
+// Runtime dispatch is available for x86-64 GCC and Clang, whose target
+// attribute compiles a function for an instruction set that the rest of the
+// translation unit does not assume.
+#if defined(XTENSOR_USE_CPU_DISPATCH) && (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define XTENSOR_CPU_DISPATCH_ENABLED
+#define XTENSOR_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define XTENSOR_TARGET_AVX512 __attribute__((target("avx512f,avx512dq,avx512vl,avx2,fma")))
+#endif
+
+namespace xt
+{
+
+    /*******
+     * cpu *
+     *******/
+
+    /**
+     * Instruction sets of the kernels selected at runtime. When
+     * XTENSOR_USE_CPU_DISPATCH is defined, the hot loops over contiguous
+     * buffers (linear assignments of arithmetic operators, conversions,
+     * sums and products of immediate reductions) are also compiled
+     * for AVX2 and AVX-512, and the best instruction set supported by the
+     * processor is selected at the first call, so that a binary built for
+     * the baseline x86-64 uses the wide registers of the machine it runs on.
+     */
+    namespace cpu
+    {
+        enum class isa
+        {
+            generic,
+            avx2,
+            avx512
+        };
+
+        const char* to_string(isa i) noexcept;
+
+        isa compiled_isa() noexcept;
+        isa detected_isa() noexcept;
+        isa selected_isa() noexcept;
+        void select_isa(isa i) noexcept;
+        isa dispatch_isa() noexcept;
+
+        /**
+         * Selects the instruction set of the dispatched kernels of the
+         * calling thread for the lifetime of the object; the selection of
+         * the enclosing guard, or the global one, applies again upon
+         * destruction. The other threads are not affected.
+         */
+        class scoped_isa
+        {
+        public:
+
+            explicit scoped_isa(isa i) noexcept;
+            ~scoped_isa();
+
+            scoped_isa(const scoped_isa&) = delete;
+            scoped_isa& operator=(const scoped_isa&) = delete;
+
+        private:
+
+            isa m_isa;
+            const isa* m_previous;
+        };
+    }
+
+    /**********************
+     * cpu implementation *
+     **********************/
+
+    namespace cpu
+    {
+        inline const char* to_string(isa i) noexcept
+        {
+            switch (i)
+            {
+            case isa::avx2:
+                return "avx2";
+            case isa::avx512:
+                return "avx512";
+            default:
+                return "generic";
+            }
+        }
+
+        /**
+         * Returns the instruction set assumed by the whole translation unit,
+         * given by the compiler flags.
+         */
+        inline isa compiled_isa() noexcept
+        {
+#if defined(__AVX512F__) && defined(__AVX512DQ__) && defined(__AVX512VL__)
+            return isa::avx512;
+#elif defined(__AVX2__) && defined(__FMA__)
+            return isa::avx2;
+#else
+            return isa::generic;
+#endif
+        }
+
+        /**
+         * Returns the best instruction set supported by the processor among
+         * those the kernels are compiled for; the processor is queried once.
+         */
+        inline isa detected_isa() noexcept
+        {
+#if defined(XTENSOR_CPU_DISPATCH_ENABLED)
+            static const isa detected = []() {
+                __builtin_cpu_init();
+                if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq") &&
+                    __builtin_cpu_supports("avx512vl"))
+                {
+                    return isa::avx512;
+                }
+                if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+                {
+                    return isa::avx2;
+                }
+                return isa::generic;
+            }();
+            return detected;
+#else
+            return compiled_isa();
+#endif
+        }
+
+        namespace detail
+        {
+            inline std::atomic<isa>& global_selection() noexcept
+            {
+                static std::atomic<isa> selected(detected_isa());
+                return selected;
+            }
+
+            // selection of the innermost scoped_isa of the calling thread
+            inline const isa*& selection_override() noexcept
+            {
+                static thread_local const isa* p = nullptr;
+                return p;
+            }
+
+            inline isa bounded_isa(isa i) noexcept
+            {
+                return static_cast<int>(i) < static_cast<int>(detected_isa()) ? i : detected_isa();
+            }
+        }
+
+        /**
+         * Returns the instruction set used by the dispatched kernels of the
+         * calling thread: the one of its innermost scoped_isa if any, the
+         * global selection otherwise, which is the detected one unless
+         * another one was selected.
+         */
+        inline isa selected_isa() noexcept
+        {
+            const isa* local = detail::selection_override();
+            return local != nullptr ? *local : detail::global_selection().load(std::memory_order_relaxed);
+        }
+
+        /**
+         * Selects the instruction set of the dispatched kernels, for instance
+         * to compare them; it is bounded by the detected one.
+         */
+        inline void select_isa(isa i) noexcept
+        {
+            detail::global_selection().store(detail::bounded_isa(i), std::memory_order_relaxed);
+        }
+
+        /**
+         * Returns the instruction set of the kernel to call instead of the
+         * inline loop, or isa::generic when the loop is compiled for at least
+         * the selected instruction set.
+         */
+        inline isa dispatch_isa() noexcept
+        {
+            isa i = selected_isa();
+            return static_cast<int>(i) > static_cast<int>(compiled_isa()) ? i : isa::generic;
+        }
+
+        inline scoped_isa::scoped_isa(isa i) noexcept
+            : m_isa(detail::bounded_isa(i)), m_previous(detail::selection_override())
+        {
+            detail::selection_override() = &m_isa;
+        }
+
+        inline scoped_isa::~scoped_isa()
+        {
+            detail::selection_override() = m_previous;
+        }
+    }
+
+    /********************
+     * dispatch kernels *
+     ********************/
+
+    namespace detail
+    {
+        namespace dispatch
+        {
+            // broadcast scalar operand of a binary kernel
+            template <class T>
+            struct scalar_operand
+            {
+                T value;
+
+                T operator[](std::size_t) const noexcept
+                {
+                    return value;
+                }
+            };
+
+            // number of partial results of the reduction kernels, enough to
+            // fill the lanes of two AVX-512 registers of 32 bit values
+            constexpr std::size_t reduce_lanes = 32;
+
+#define XTENSOR_DISPATCH_KERNELS(SUFFIX, TARGET)                                                \
+            template <class F, class S, class D>                                                \
+            TARGET void transform_##SUFFIX(F f, const S* src, D* dst, std::size_t n)            \
+            {                                                                                   \
+                for (std::size_t i = 0; i < n; ++i)                                             \
+                {                                                                               \
+                    dst[i] = f(src[i]);                                                         \
+                }                                                                               \
+            }                                                                                   \
+                                                                                                \
+            template <class F, class A, class B, class T>                                       \
+            TARGET void binary_##SUFFIX(F f, A a, B b, T* res, std::size_t n)                   \
+            {                                                                                   \
+                for (std::size_t i = 0; i < n; ++i)                                             \
+                {                                                                               \
+                    res[i] = f(a[i], b[i]);                                                     \
+                }                                                                               \
+            }                                                                                   \
+                                                                                                \
+            template <class R, class F, class T>                                                \
+            TARGET R reduce_##SUFFIX(F f, const T* first, std::size_t n)                        \
+            {                                                                                   \
+                R lanes[reduce_lanes];                                                          \
+                for (std::size_t l = 0; l < reduce_lanes; ++l)                                  \
+                {                                                                               \
+                    lanes[l] = static_cast<R>(first[l]);                                        \
+                }                                                                               \
+                std::size_t end = n - n % reduce_lanes;                                         \
+                for (std::size_t i = reduce_lanes; i < end; i += reduce_lanes)                  \
+                {                                                                               \
+                    for (std::size_t l = 0; l < reduce_lanes; ++l)                              \
+                    {                                                                           \
+                        lanes[l] = f(lanes[l], static_cast<R>(first[i + l]));                   \
+                    }                                                                           \
+                }                                                                               \
+                R res = lanes[0];                                                               \
+                for (std::size_t l = 1; l < reduce_lanes; ++l)                                  \
+                {                                                                               \
+                    res = f(res, lanes[l]);                                                     \
+                }                                                                               \
+                for (std::size_t i = end; i < n; ++i)                                           \
+                {                                                                               \
+                    res = f(res, static_cast<R>(first[i]));                                     \
+                }                                                                               \
+                return res;                                                                     \
+            }
+
+#if defined(XTENSOR_CPU_DISPATCH_ENABLED)
+            XTENSOR_DISPATCH_KERNELS(avx2, XTENSOR_TARGET_AVX2)
+            XTENSOR_DISPATCH_KERNELS(avx512, XTENSOR_TARGET_AVX512)
+#endif
+
+#undef XTENSOR_DISPATCH_KERNELS
+
+            /**
+             * dst[i] = f(src[i]) for i in [0, n); returns false if no kernel
+             * of the selected instruction set applies, and the caller
+             * then runs its own loop.
+             */
+            template <class F, class S, class D>
+            inline bool transform(F f, const S* src, D* dst, std::size_t n)
+            {
+#if defined(XTENSOR_CPU_DISPATCH_ENABLED)
+                switch (cpu::dispatch_isa())
+                {
+                case cpu::isa::avx512:
+                    transform_avx512(f, src, dst, n);
+                    return true;
+                case cpu::isa::avx2:
+                    transform_avx2(f, src, dst, n);
+                    return true;
+                default:
+                    return false;
+                }
+#else
+                (void)f; (void)src; (void)dst; (void)n;
+                return false;
+#endif
+            }
+
+            /**
+             * res[i] = f(a[i], b[i]) for i in [0, n), a and b being pointers
+             * or scalar operands; returns false if no kernel applies.
+             */
+            template <class F, class A, class B, class T>
+            inline bool binary(F f, A a, B b, T* res, std::size_t n)
+            {
+#if defined(XTENSOR_CPU_DISPATCH_ENABLED)
+                switch (cpu::dispatch_isa())
+                {
+                case cpu::isa::avx512:
+                    binary_avx512(f, a, b, res, n);
+                    return true;
+                case cpu::isa::avx2:
+                    binary_avx2(f, a, b, res, n);
+                    return true;
+                default:
+                    return false;
+                }
+#else
+                (void)f; (void)a; (void)b; (void)res; (void)n;
+                return false;
+#endif
+            }
+
+            /**
+             * Reduces the n contiguous elements starting at first with f,
+             * accumulating partial results in independent lanes; returns
+             * false if no kernel applies or if n is too small to fill them.
+             */
+            template <class R, class F, class T>
+            inline bool reduce(F f, const T* first, std::size_t n, R& res)
+            {
+#if defined(XTENSOR_CPU_DISPATCH_ENABLED)
+                if (n < 2 * reduce_lanes)
+                {
+                    return false;
+                }
+                switch (cpu::dispatch_isa())
+                {
+                case cpu::isa::avx512:
+                    res = reduce_avx512<R>(f, first, n);
+                    return true;
+                case cpu::isa::avx2:
+                    res = reduce_avx2<R>(f, first, n);
+                    return true;
+                default:
+                    return false;
+                }
+#else
+                (void)f; (void)first; (void)n; (void)res;
+                return false;
+#endif
+            }
+
+            template <class T>
+            using is_kernel_type = std::integral_constant<bool, std::is_arithmetic<T>::value &&
+                                                                !std::is_same<T, bool>::value>;
+        }
+    }
+}
+
+#endif
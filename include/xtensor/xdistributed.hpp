@@ -0,0 +1,751 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_DISTRIBUTED_HPP
+#define XTENSOR_DISTRIBUTED_HPP
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef XTENSOR_USE_MPI
+#include <mpi.h>
+#endif
+
+#include "xreducer.hpp"
+#include "xstrided_view.hpp"
+#include "xtensor.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+    namespace distributed
+    {
+
+        /****************
+         * communicator *
+         ****************/
+
+        /// Rank of the missing neighbors of the blocks on the global boundaries
+        constexpr int no_rank = -1;
+
+        /**
+         * @class communicator
+         * @brief Group of processes sharing a distributed array.
+         *
+         * When XTENSOR_USE_MPI is defined, the communicator wraps an MPI
+         * communicator, MPI_COMM_WORLD by default, and MPI must have been
+         * initialized by the application. Otherwise, it is made of the
+         * calling process only.
+         */
+        class communicator
+        {
+        public:
+
+#ifdef XTENSOR_USE_MPI
+            explicit communicator(MPI_Comm comm = MPI_COMM_WORLD) noexcept;
+            MPI_Comm get() const noexcept;
+#else
+            communicator() = default;
+#endif
+
+            int rank() const;
+            int size() const;
+
+            template <class T>
+            T allreduce_sum(const T& value) const;
+
+            template <class T>
+            T allreduce_max(const T& value) const;
+
+            template <class T>
+            void sendrecv(const T* send, int dest, T* recv, int source, std::size_t count) const;
+
+        private:
+
+#ifdef XTENSOR_USE_MPI
+            MPI_Comm m_comm;
+#endif
+        };
+
+        /*************
+         * partition *
+         *************/
+
+        /**
+         * @class partition
+         * @brief Decomposition of an array in blocks over a grid of ranks.
+         *
+         * The ranks are arranged in a grid whose number of ranks along the
+         * partitioned axes are as close as possible, with a single rank along
+         * the other axes. The blocks along an axis differ by one element at
+         * most, the first ones being the largest. The ranks are numbered in
+         * the row-major order of the grid.
+         */
+        class partition
+        {
+        public:
+
+            using shape_type = std::vector<std::size_t>;
+
+            template <class S>
+            partition(const S& shape, const std::vector<std::size_t>& axes, int nranks, int rank);
+
+            const shape_type& shape() const noexcept;
+            const std::vector<std::size_t>& axes() const noexcept;
+            const shape_type& grid_shape() const noexcept;
+            const shape_type& coordinates() const noexcept;
+            const shape_type& local_shape() const noexcept;
+            const shape_type& local_offset() const noexcept;
+
+            int rank() const noexcept;
+            int neighbor(std::size_t axis, int direction) const;
+
+        private:
+
+            int rank_of(const shape_type& coordinates) const;
+
+            shape_type m_shape;
+            std::vector<std::size_t> m_axes;
+            shape_type m_grid_shape;
+            shape_type m_coordinates;
+            shape_type m_local_shape;
+            shape_type m_local_offset;
+            int m_rank;
+        };
+    }
+
+    /****************
+     * xdistributed *
+     ****************/
+
+    /**
+     * @class xdistributed
+     * @brief Array partitioned in blocks across the ranks of a communicator.
+     *
+     * Each rank holds its block in an xtensor, surrounded by halos of
+     * \c halo elements along the partitioned axes. Elementwise expressions
+     * are evaluated on the blocks with the regular assignment of xtensor:
+     *
+     * \code{.cpp}
+     * xt::xdistributed<double, 2> u({4096, 4096}, {0, 1}, 1), v({4096, 4096}, {0, 1}, 1);
+     * v.local() = 2. * u.local() + 1.;
+     * u.exchange_halos();
+     * v.local() = u.shifted(0, -1) + u.shifted(0, 1) - 2. * u.local();
+     * double total = xt::distributed::sum(v);
+     * \endcode
+     *
+     * The views returned by shifted() cross the boundaries of the block and
+     * read the halos, that exchange_halos() fills with the elements of the
+     * neighbor blocks. The halos on the global boundaries are not modified
+     * by the exchange, so that they can hold boundary conditions.
+     *
+     * @tparam T the value type of the elements
+     * @tparam N the number of dimensions
+     */
+    template <class T, std::size_t N>
+    class xdistributed
+    {
+    public:
+
+        using value_type = T;
+        using local_type = xtensor<T, N>;
+        using shape_type = std::array<std::size_t, N>;
+        using communicator_type = distributed::communicator;
+        using partition_type = distributed::partition;
+
+        xdistributed(const shape_type& shape, const std::vector<std::size_t>& axes, std::size_t halo = 0,
+                     communicator_type comm = communicator_type());
+
+        const shape_type& shape() const noexcept;
+        std::size_t halo() const noexcept;
+        const communicator_type& comm() const noexcept;
+        const partition_type& get_partition() const noexcept;
+
+        local_type& local_data() noexcept;
+        const local_type& local_data() const noexcept;
+
+        auto local();
+        auto local() const;
+
+        auto shifted(std::size_t axis, std::ptrdiff_t offset);
+        auto shifted(std::size_t axis, std::ptrdiff_t offset) const;
+
+        void exchange_halos();
+
+    private:
+
+        bool has_halo(std::size_t axis) const noexcept;
+        xstrided_slice_vector owned_slices(std::size_t axis, std::ptrdiff_t offset) const;
+        xstrided_slice_vector slab_slices(std::size_t axis, std::size_t first) const;
+
+        shape_type m_shape;
+        std::size_t m_halo;
+        communicator_type m_comm;
+        partition_type m_partition;
+        local_type m_local;
+    };
+
+    namespace distributed
+    {
+        template <class T, std::size_t N>
+        auto sum(const xdistributed<T, N>& d);
+
+        template <class T, std::size_t N>
+        auto amax(const xdistributed<T, N>& d);
+
+        template <class T, std::size_t N>
+        auto mean(const xdistributed<T, N>& d);
+    }
+
+    /*******************************
+     * communicator implementation *
+     *******************************/
+
+    namespace distributed
+    {
+#ifdef XTENSOR_USE_MPI
+        namespace detail
+        {
+            inline MPI_Datatype mpi_datatype(const char&) { return MPI_CHAR; }
+            inline MPI_Datatype mpi_datatype(const signed char&) { return MPI_SIGNED_CHAR; }
+            inline MPI_Datatype mpi_datatype(const unsigned char&) { return MPI_UNSIGNED_CHAR; }
+            inline MPI_Datatype mpi_datatype(const short&) { return MPI_SHORT; }
+            inline MPI_Datatype mpi_datatype(const unsigned short&) { return MPI_UNSIGNED_SHORT; }
+            inline MPI_Datatype mpi_datatype(const int&) { return MPI_INT; }
+            inline MPI_Datatype mpi_datatype(const unsigned int&) { return MPI_UNSIGNED; }
+            inline MPI_Datatype mpi_datatype(const long&) { return MPI_LONG; }
+            inline MPI_Datatype mpi_datatype(const unsigned long&) { return MPI_UNSIGNED_LONG; }
+            inline MPI_Datatype mpi_datatype(const long long&) { return MPI_LONG_LONG; }
+            inline MPI_Datatype mpi_datatype(const unsigned long long&) { return MPI_UNSIGNED_LONG_LONG; }
+            inline MPI_Datatype mpi_datatype(const float&) { return MPI_FLOAT; }
+            inline MPI_Datatype mpi_datatype(const double&) { return MPI_DOUBLE; }
+            inline MPI_Datatype mpi_datatype(const long double&) { return MPI_LONG_DOUBLE; }
+
+            inline void check_mpi(int code, const char* what)
+            {
+                if (code != MPI_SUCCESS)
+                {
+                    throw std::runtime_error(std::string("communicator: ") + what + " failed");
+                }
+            }
+
+            inline int mpi_rank(int rank) noexcept
+            {
+                return rank == no_rank ? MPI_PROC_NULL : rank;
+            }
+        }
+
+        inline communicator::communicator(MPI_Comm comm) noexcept
+            : m_comm(comm)
+        {
+        }
+
+        /**
+         * Returns the wrapped MPI communicator.
+         */
+        inline MPI_Comm communicator::get() const noexcept
+        {
+            return m_comm;
+        }
+
+        inline int communicator::rank() const
+        {
+            int res = 0;
+            detail::check_mpi(MPI_Comm_rank(m_comm, &res), "MPI_Comm_rank");
+            return res;
+        }
+
+        inline int communicator::size() const
+        {
+            int res = 0;
+            detail::check_mpi(MPI_Comm_size(m_comm, &res), "MPI_Comm_size");
+            return res;
+        }
+
+        /**
+         * Returns the sum of the values of all the ranks.
+         */
+        template <class T>
+        inline T communicator::allreduce_sum(const T& value) const
+        {
+            T res = value;
+            detail::check_mpi(MPI_Allreduce(&value, &res, 1, detail::mpi_datatype(value), MPI_SUM, m_comm), "MPI_Allreduce");
+            return res;
+        }
+
+        /**
+         * Returns the maximum of the values of all the ranks.
+         */
+        template <class T>
+        inline T communicator::allreduce_max(const T& value) const
+        {
+            T res = value;
+            detail::check_mpi(MPI_Allreduce(&value, &res, 1, detail::mpi_datatype(value), MPI_MAX, m_comm), "MPI_Allreduce");
+            return res;
+        }
+
+        /**
+         * Sends \c count elements to \c dest and receives \c count elements
+         * from \c source. Either rank can be no_rank.
+         */
+        template <class T>
+        inline void communicator::sendrecv(const T* send, int dest, T* recv, int source, std::size_t count) const
+        {
+            if (count > static_cast<std::size_t>(INT_MAX) / sizeof(T))
+            {
+                throw std::runtime_error("communicator: message too large");
+            }
+            int bytes = static_cast<int>(count * sizeof(T));
+            detail::check_mpi(MPI_Sendrecv(send, bytes, MPI_BYTE, detail::mpi_rank(dest), 0,
+                                           recv, bytes, MPI_BYTE, detail::mpi_rank(source), 0,
+                                           m_comm, MPI_STATUS_IGNORE), "MPI_Sendrecv");
+        }
+#else
+        inline int communicator::rank() const
+        {
+            return 0;
+        }
+
+        inline int communicator::size() const
+        {
+            return 1;
+        }
+
+        template <class T>
+        inline T communicator::allreduce_sum(const T& value) const
+        {
+            return value;
+        }
+
+        template <class T>
+        inline T communicator::allreduce_max(const T& value) const
+        {
+            return value;
+        }
+
+        template <class T>
+        inline void communicator::sendrecv(const T* send, int dest, T* recv, int source, std::size_t count) const
+        {
+            if (dest == 0 && source == 0)
+            {
+                std::copy(send, send + count, recv);
+            }
+        }
+#endif
+
+        /****************************
+         * partition implementation *
+         ****************************/
+
+        /**
+         * Decomposes an array over the ranks.
+         * @param shape the shape of the array
+         * @param axes the partitioned axes
+         * @param nranks the number of ranks
+         * @param rank the rank of the calling process
+         * @throw std::runtime_error if an axis is repeated or out of range, or
+         * if a partitioned axis has less elements than ranks.
+         */
+        template <class S>
+        inline partition::partition(const S& shape, const std::vector<std::size_t>& axes, int nranks, int rank)
+            : m_shape(shape.cbegin(), shape.cend()), m_axes(axes),
+              m_grid_shape(m_shape.size(), std::size_t(1)), m_rank(rank)
+        {
+            std::size_t dim = m_shape.size();
+            std::vector<bool> seen(dim, false);
+            for (auto axis : m_axes)
+            {
+                if (axis >= dim || seen[axis])
+                {
+                    throw std::runtime_error("partition: the partitioned axes must be distinct axes of the array");
+                }
+                seen[axis] = true;
+            }
+            if (nranks < 1 || rank < 0 || rank >= nranks)
+            {
+                throw std::runtime_error("partition: invalid rank");
+            }
+
+            // the largest prime factors of the number of ranks go to the
+            // axes having the fewest ranks
+            std::size_t n = static_cast<std::size_t>(nranks);
+            std::vector<std::size_t> factors;
+            for (std::size_t f = 2; f * f <= n; ++f)
+            {
+                for (; n % f == 0; n /= f)
+                {
+                    factors.push_back(f);
+                }
+            }
+            if (n > 1)
+            {
+                factors.push_back(n);
+            }
+            if (!factors.empty() && m_axes.empty())
+            {
+                throw std::runtime_error("partition: no axis to partition over several ranks");
+            }
+            std::sort(factors.rbegin(), factors.rend());
+            for (auto f : factors)
+            {
+                auto target = std::min_element(m_axes.cbegin(), m_axes.cend(), [this](std::size_t a, std::size_t b) {
+                    return m_grid_shape[a] < m_grid_shape[b];
+                });
+                m_grid_shape[*target] *= f;
+            }
+
+            m_coordinates.resize(dim);
+            m_local_shape.resize(dim);
+            m_local_offset.resize(dim);
+            std::size_t r = static_cast<std::size_t>(rank);
+            for (std::size_t d = dim; d != 0; --d)
+            {
+                std::size_t p = m_grid_shape[d - 1];
+                std::size_t extent = m_shape[d - 1];
+                if (p > extent)
+                {
+                    throw std::runtime_error("partition: more ranks than elements along a partitioned axis");
+                }
+                std::size_t c = r % p;
+                r /= p;
+                m_coordinates[d - 1] = c;
+                m_local_shape[d - 1] = extent / p + (c < extent % p ? 1 : 0);
+                m_local_offset[d - 1] = c * (extent / p) + std::min(c, extent % p);
+            }
+        }
+
+        /**
+         * Returns the shape of the whole array.
+         */
+        inline auto partition::shape() const noexcept -> const shape_type&
+        {
+            return m_shape;
+        }
+
+        inline auto partition::axes() const noexcept -> const std::vector<std::size_t>&
+        {
+            return m_axes;
+        }
+
+        /**
+         * Returns the number of ranks along each axis.
+         */
+        inline auto partition::grid_shape() const noexcept -> const shape_type&
+        {
+            return m_grid_shape;
+        }
+
+        /**
+         * Returns the coordinates of the block of the rank in the grid.
+         */
+        inline auto partition::coordinates() const noexcept -> const shape_type&
+        {
+            return m_coordinates;
+        }
+
+        /**
+         * Returns the shape of the block of the rank.
+         */
+        inline auto partition::local_shape() const noexcept -> const shape_type&
+        {
+            return m_local_shape;
+        }
+
+        /**
+         * Returns the index in the array of the first element of the block.
+         */
+        inline auto partition::local_offset() const noexcept -> const shape_type&
+        {
+            return m_local_offset;
+        }
+
+        inline int partition::rank() const noexcept
+        {
+            return m_rank;
+        }
+
+        /**
+         * Returns the rank holding the next block along \c axis when
+         * \c direction is positive, the previous one otherwise, and no_rank
+         * if the block is on the boundary of the array.
+         */
+        inline int partition::neighbor(std::size_t axis, int direction) const
+        {
+            shape_type coordinates = m_coordinates;
+            if (direction < 0)
+            {
+                if (coordinates[axis] == 0)
+                {
+                    return no_rank;
+                }
+                --coordinates[axis];
+            }
+            else
+            {
+                if (coordinates[axis] + 1 == m_grid_shape[axis])
+                {
+                    return no_rank;
+                }
+                ++coordinates[axis];
+            }
+            return rank_of(coordinates);
+        }
+
+        inline int partition::rank_of(const shape_type& coordinates) const
+        {
+            std::size_t res = 0;
+            for (std::size_t d = 0; d != coordinates.size(); ++d)
+            {
+                res = res * m_grid_shape[d] + coordinates[d];
+            }
+            return static_cast<int>(res);
+        }
+    }
+
+    /*******************************
+     * xdistributed implementation *
+     *******************************/
+
+    /**
+     * Allocates the block of the calling rank. The elements are not
+     * initialized.
+     * @param shape the shape of the whole array
+     * @param axes the axes along which the array is partitioned
+     * @param halo the width of the halos along the partitioned axes
+     * @param comm the communicator of the ranks sharing the array
+     * @throw std::runtime_error if the decomposition is invalid or if a
+     * block is thinner than the halo.
+     */
+    template <class T, std::size_t N>
+    inline xdistributed<T, N>::xdistributed(const shape_type& shape, const std::vector<std::size_t>& axes, std::size_t halo,
+                                            communicator_type comm)
+        : m_shape(shape), m_halo(halo), m_comm(comm), m_partition(shape, axes, comm.size(), comm.rank())
+    {
+        shape_type local_shape;
+        std::copy(m_partition.local_shape().cbegin(), m_partition.local_shape().cend(), local_shape.begin());
+        for (auto axis : axes)
+        {
+            if (local_shape[axis] < m_halo)
+            {
+                throw std::runtime_error("xdistributed: the blocks must be at least as wide as the halos");
+            }
+            local_shape[axis] += 2 * m_halo;
+        }
+        m_local = local_type::from_shape(local_shape);
+    }
+
+    /**
+     * Returns the shape of the whole array.
+     */
+    template <class T, std::size_t N>
+    inline auto xdistributed<T, N>::shape() const noexcept -> const shape_type&
+    {
+        return m_shape;
+    }
+
+    template <class T, std::size_t N>
+    inline std::size_t xdistributed<T, N>::halo() const noexcept
+    {
+        return m_halo;
+    }
+
+    template <class T, std::size_t N>
+    inline auto xdistributed<T, N>::comm() const noexcept -> const communicator_type&
+    {
+        return m_comm;
+    }
+
+    /**
+     * Returns the decomposition of the array, giving the shape and the
+     * position of the block of the rank.
+     */
+    template <class T, std::size_t N>
+    inline auto xdistributed<T, N>::get_partition() const noexcept -> const partition_type&
+    {
+        return m_partition;
+    }
+
+    /**
+     * Returns the container holding the block of the rank and its halos.
+     */
+    template <class T, std::size_t N>
+    inline auto xdistributed<T, N>::local_data() noexcept -> local_type&
+    {
+        return m_local;
+    }
+
+    template <class T, std::size_t N>
+    inline auto xdistributed<T, N>::local_data() const noexcept -> const local_type&
+    {
+        return m_local;
+    }
+
+    /**
+     * Returns a view on the block of the rank, without the halos.
+     */
+    template <class T, std::size_t N>
+    inline auto xdistributed<T, N>::local()
+    {
+        return strided_view(m_local, owned_slices(0, 0));
+    }
+
+    template <class T, std::size_t N>
+    inline auto xdistributed<T, N>::local() const
+    {
+        return strided_view(m_local, owned_slices(0, 0));
+    }
+
+    /**
+     * Returns a view of the shape of the block, shifted by \c offset
+     * elements along \c axis: its element i along the axis is the element
+     * i + offset of the block, in the halos when it is out of the block.
+     * @throw std::runtime_error if the shift is larger than the halo.
+     */
+    template <class T, std::size_t N>
+    inline auto xdistributed<T, N>::shifted(std::size_t axis, std::ptrdiff_t offset)
+    {
+        return strided_view(m_local, owned_slices(axis, offset));
+    }
+
+    template <class T, std::size_t N>
+    inline auto xdistributed<T, N>::shifted(std::size_t axis, std::ptrdiff_t offset) const
+    {
+        return strided_view(m_local, owned_slices(axis, offset));
+    }
+
+    /**
+     * Fills the halos with the elements of the neighbor blocks, axis after
+     * axis so that the corners of the halos are filled as well. All the
+     * ranks must call it.
+     */
+    template <class T, std::size_t N>
+    inline void xdistributed<T, N>::exchange_halos()
+    {
+        if (m_halo == 0)
+        {
+            return;
+        }
+        for (auto axis : m_partition.axes())
+        {
+            std::size_t n = m_partition.local_shape()[axis];
+            int lower = m_partition.neighbor(axis, -1);
+            int upper = m_partition.neighbor(axis, 1);
+
+            auto exchange = [&](std::size_t send_first, int dest, std::size_t recv_first, int source)
+            {
+                local_type send = strided_view(m_local, slab_slices(axis, send_first));
+                local_type recv = local_type::from_shape(send.shape());
+                m_comm.sendrecv(send.data(), dest, recv.data(), source, send.size());
+                if (source != distributed::no_rank)
+                {
+                    strided_view(m_local, slab_slices(axis, recv_first)) = recv;
+                }
+            };
+            // the last elements of the block go to the lower halo of the next
+            // block, the first ones to the upper halo of the previous block
+            exchange(n, upper, 0, lower);
+            exchange(m_halo, lower, n + m_halo, upper);
+        }
+    }
+
+    template <class T, std::size_t N>
+    inline bool xdistributed<T, N>::has_halo(std::size_t axis) const noexcept
+    {
+        const auto& axes = m_partition.axes();
+        return m_halo != 0 && std::find(axes.cbegin(), axes.cend(), axis) != axes.cend();
+    }
+
+    template <class T, std::size_t N>
+    inline xstrided_slice_vector xdistributed<T, N>::owned_slices(std::size_t axis, std::ptrdiff_t offset) const
+    {
+        if (offset != 0 && (axis >= N || !has_halo(axis) || static_cast<std::size_t>(std::abs(offset)) > m_halo))
+        {
+            throw std::runtime_error("xdistributed: shift larger than the halo");
+        }
+        xstrided_slice_vector res;
+        for (std::size_t d = 0; d != N; ++d)
+        {
+            std::ptrdiff_t first = has_halo(d) ? static_cast<std::ptrdiff_t>(m_halo) : 0;
+            if (d == axis)
+            {
+                first += offset;
+            }
+            std::ptrdiff_t n = static_cast<std::ptrdiff_t>(m_partition.local_shape()[d]);
+            res.push_back(range(first, first + n));
+        }
+        return res;
+    }
+
+    // slab of the width of the halo starting at first along axis, holding the
+    // halos of the other axes
+    template <class T, std::size_t N>
+    inline xstrided_slice_vector xdistributed<T, N>::slab_slices(std::size_t axis, std::size_t first) const
+    {
+        xstrided_slice_vector res;
+        for (std::size_t d = 0; d != N; ++d)
+        {
+            if (d == axis)
+            {
+                res.push_back(range(first, first + m_halo));
+            }
+            else
+            {
+                res.push_back(all());
+            }
+        }
+        return res;
+    }
+
+    /*****************************************
+     * distributed reductions implementation *
+     *****************************************/
+
+    namespace distributed
+    {
+        /**
+         * Returns the sum of the elements of the distributed array, on all
+         * the ranks. All the ranks must call it.
+         */
+        template <class T, std::size_t N>
+        inline auto sum(const xdistributed<T, N>& d)
+        {
+            auto local = xt::sum(d.local())();
+            return d.comm().allreduce_sum(local);
+        }
+
+        /**
+         * Returns the maximum of the elements of the distributed array, on
+         * all the ranks. All the ranks must call it.
+         */
+        template <class T, std::size_t N>
+        inline auto amax(const xdistributed<T, N>& d)
+        {
+            auto local = xt::amax(d.local())();
+            return d.comm().allreduce_max(local);
+        }
+
+        /**
+         * Returns the mean of the elements of the distributed array, on all
+         * the ranks. All the ranks must call it.
+         */
+        template <class T, std::size_t N>
+        inline auto mean(const xdistributed<T, N>& d)
+        {
+            using result_type = std::decay_t<decltype(xt::mean(d.local())())>;
+            return static_cast<result_type>(distributed::sum(d)) / static_cast<result_type>(compute_size(d.shape()));
+        }
+    }
+}
+
+#endif
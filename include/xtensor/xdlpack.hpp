@@ -0,0 +1,219 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_DLPACK_HPP
+#define XTENSOR_DLPACK_HPP
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <dlpack/dlpack.h>
+
+#include "xarray.hpp"
+#include "xbuffer_adaptor.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+    /**
+     * @typedef dlpack_adaptor
+     * Type of the adaptors returned by from_dlpack. The adaptor releases the
+     * DLPack tensor when it is destroyed, as well as all its copies and the
+     * views holding it.
+     *
+     * @tparam T The value type of the elements.
+     */
+    template <class T>
+    using dlpack_adaptor = xarray_adaptor<xbuffer_adaptor<T*, external_ownership, std::allocator<T>>,
+                                          layout_type::dynamic,
+                                          std::vector<std::size_t>>;
+
+    template <class T>
+    dlpack_adaptor<T> from_dlpack(DLManagedTensor* tensor);
+
+    template <class E>
+    DLManagedTensor* to_dlpack(E&& e);
+
+    /*************************
+     * dlpack implementation *
+     *************************/
+
+    namespace detail
+    {
+        template <class T>
+        struct dlpack_type_code
+        {
+            static_assert(std::is_arithmetic<T>::value, "DLPack only supports arithmetic and complex types");
+            static constexpr std::uint8_t value = static_cast<std::uint8_t>(
+                std::is_floating_point<T>::value ? kDLFloat : (std::is_signed<T>::value ? kDLInt : kDLUInt));
+        };
+
+        template <class T>
+        struct dlpack_type_code<std::complex<T>>
+        {
+            static constexpr std::uint8_t value = static_cast<std::uint8_t>(kDLComplex);
+        };
+
+        template <class T>
+        inline DLDataType dlpack_data_type() noexcept
+        {
+            DLDataType res;
+            res.code = dlpack_type_code<T>::value;
+            res.bits = static_cast<std::uint8_t>(8 * sizeof(T));
+            res.lanes = 1;
+            return res;
+        }
+
+        template <class C>
+        struct dlpack_context
+        {
+            template <class CT>
+            explicit dlpack_context(CT&& c)
+                : m_container(std::forward<CT>(c))
+            {
+            }
+
+            C m_container;
+            std::vector<std::int64_t> m_shape;
+            std::vector<std::int64_t> m_strides;
+            DLManagedTensor m_tensor;
+        };
+
+        template <class C>
+        inline void dlpack_deleter(DLManagedTensor* tensor)
+        {
+            delete static_cast<dlpack_context<C>*>(tensor->manager_ctx);
+        }
+    }
+
+    /**
+     * @brief Adapts a DLPack tensor without copying its elements.
+     *
+     * The returned adaptor takes the ownership of \c tensor and calls its
+     * deleter when the adaptor and all its copies are destroyed. The tensor
+     * must be in host memory and hold elements of type \c T; otherwise a
+     * std::runtime_error is thrown and the tensor is not released.
+     *
+     * @param tensor the DLPack tensor to adapt
+     * @tparam T the value type of the elements
+     */
+    template <class T>
+    inline dlpack_adaptor<T> from_dlpack(DLManagedTensor* tensor)
+    {
+        using buffer_type = typename dlpack_adaptor<T>::storage_type;
+        using shape_type = typename dlpack_adaptor<T>::shape_type;
+        using strides_type = typename dlpack_adaptor<T>::strides_type;
+
+        if (tensor == nullptr)
+        {
+            throw std::runtime_error("from_dlpack: null tensor");
+        }
+        const DLTensor& t = tensor->dl_tensor;
+        if (t.device.device_type != kDLCPU && t.device.device_type != kDLCUDAHost)
+        {
+            throw std::runtime_error("from_dlpack: the tensor is not in host memory");
+        }
+        DLDataType dtype = detail::dlpack_data_type<T>();
+        if (t.dtype.code != dtype.code || t.dtype.bits != dtype.bits || t.dtype.lanes != dtype.lanes)
+        {
+            throw std::runtime_error("from_dlpack: the type of the tensor does not match the requested value type");
+        }
+
+        std::size_t dim = static_cast<std::size_t>(t.ndim);
+        shape_type shape(dim);
+        strides_type strides(dim);
+        bool row_major = true;
+        bool column_major = true;
+        std::ptrdiff_t row_stride = 1;
+        for (std::size_t i = dim; i != 0; --i)
+        {
+            shape[i - 1] = static_cast<std::size_t>(t.shape[i - 1]);
+            std::ptrdiff_t stride = t.strides != nullptr ? static_cast<std::ptrdiff_t>(t.strides[i - 1]) : row_stride;
+            if (stride < 0)
+            {
+                throw std::runtime_error("from_dlpack: negative strides are not supported");
+            }
+            strides[i - 1] = shape[i - 1] == 1 ? 0 : stride;
+            row_major = row_major && (shape[i - 1] == 1 || stride == row_stride);
+            row_stride *= static_cast<std::ptrdiff_t>(shape[i - 1]);
+        }
+        std::ptrdiff_t column_stride = 1;
+        for (std::size_t i = 0; i < dim; ++i)
+        {
+            column_major = column_major && (shape[i] == 1 || strides[i] == column_stride);
+            column_stride *= static_cast<std::ptrdiff_t>(shape[i]);
+        }
+
+        T* data = reinterpret_cast<T*>(static_cast<char*>(t.data) + t.byte_offset);
+        buffer_type buffer(data, compute_size(shape), external_ownership([tensor]() {
+            if (tensor->deleter != nullptr)
+            {
+                tensor->deleter(tensor);
+            }
+        }));
+        if (row_major || column_major)
+        {
+            return dlpack_adaptor<T>(std::move(buffer), shape, row_major ? layout_type::row_major : layout_type::column_major);
+        }
+        return dlpack_adaptor<T>(std::move(buffer), shape, strides);
+    }
+
+    /**
+     * @brief Exports a container as a DLPack tensor without copying its elements.
+     *
+     * The container is moved (or copied if \c e is an lvalue) into the
+     * returned tensor, whose deleter destroys it. Moving a container or
+     * copying an xarray_shared is O(1). The tensor lives in host memory.
+     *
+     * @param e the container to export
+     */
+    template <class E>
+    inline DLManagedTensor* to_dlpack(E&& e)
+    {
+        using container_type = std::decay_t<E>;
+        using value_type = typename container_type::value_type;
+        using context_type = detail::dlpack_context<container_type>;
+        static_assert(has_data_interface<container_type>::value, "to_dlpack requires an expression with a data interface");
+
+        std::unique_ptr<context_type> context(new context_type(std::forward<E>(e)));
+        const container_type& c = context->m_container;
+        std::size_t dim = c.dimension();
+        context->m_shape.resize(dim);
+        context->m_strides.resize(dim);
+        std::int64_t row_stride = 1;
+        for (std::size_t i = dim; i != 0; --i)
+        {
+            std::int64_t extent = static_cast<std::int64_t>(c.shape()[i - 1]);
+            context->m_shape[i - 1] = extent;
+            // the strides of axes of length 1 are 0 in xtensor
+            context->m_strides[i - 1] = extent == 1 ? row_stride : static_cast<std::int64_t>(c.strides()[i - 1]);
+            row_stride *= extent;
+        }
+
+        DLTensor& t = context->m_tensor.dl_tensor;
+        t.data = const_cast<void*>(static_cast<const void*>(c.data() + c.data_offset()));
+        t.device.device_type = kDLCPU;
+        t.device.device_id = 0;
+        t.ndim = static_cast<std::int32_t>(dim);
+        t.dtype = detail::dlpack_data_type<value_type>();
+        t.shape = context->m_shape.data();
+        t.strides = context->m_strides.data();
+        t.byte_offset = 0;
+        context->m_tensor.manager_ctx = context.get();
+        context->m_tensor.deleter = &detail::dlpack_deleter<container_type>;
+        return &(context.release()->m_tensor);
+    }
+}
+
+#endif
@@ -0,0 +1,617 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_DTYPE_HPP
+#define XTENSOR_DTYPE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xarray.hpp"
+#include "xbuffer_adaptor.hpp"
+#include "xmath.hpp"
+#include "xstorage.hpp"
+#include "xtensor_config.hpp"
+
+namespace xt
+{
+
+    /*********
+     * dtype *
+     *********/
+
+    /**
+     * Runtime tag of the value type of an xdtype_array.
+     */
+    enum class dtype
+    {
+        boolean,
+        int8,
+        uint8,
+        int16,
+        uint16,
+        int32,
+        uint32,
+        int64,
+        uint64,
+        float32,
+        float64
+    };
+
+    const char* to_string(dtype t) noexcept;
+    std::size_t itemsize(dtype t);
+    bool is_floating_point(dtype t) noexcept;
+    dtype promote_types(dtype t1, dtype t2) noexcept;
+
+    namespace detail
+    {
+        constexpr dtype integer_dtype(std::size_t size, bool is_signed) noexcept
+        {
+            return size == 1 ? (is_signed ? dtype::int8 : dtype::uint8) :
+                   size == 2 ? (is_signed ? dtype::int16 : dtype::uint16) :
+                   size == 4 ? (is_signed ? dtype::int32 : dtype::uint32) :
+                               (is_signed ? dtype::int64 : dtype::uint64);
+        }
+    }
+
+    /**
+     * @brief Traits class returning the dtype of a value type.
+     *
+     * The integral types are mapped according to their size and signedness,
+     * so that e.g. \c long and \c long long share the same dtype on LP64
+     * platforms.
+     */
+    template <class T, class = void>
+    struct dtype_of;
+
+    template <>
+    struct dtype_of<bool> : std::integral_constant<dtype, dtype::boolean>
+    {
+    };
+
+    template <class T>
+    struct dtype_of<T, std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value && sizeof(T) <= 8>>
+        : std::integral_constant<dtype, detail::integer_dtype(sizeof(T), std::is_signed<T>::value)>
+    {
+    };
+
+    template <>
+    struct dtype_of<float> : std::integral_constant<dtype, dtype::float32>
+    {
+    };
+
+    template <>
+    struct dtype_of<double> : std::integral_constant<dtype, dtype::float64>
+    {
+    };
+
+    /**
+     * Type of the values tagged by a dtype, passed to the functors
+     * of visit_dtype.
+     */
+    template <class T>
+    struct dtype_tag
+    {
+        using type = T;
+    };
+
+    template <class F>
+    decltype(auto) visit_dtype(dtype t, F&& f);
+
+    /****************
+     * xdtype_array *
+     ****************/
+
+    /**
+     * @class xdtype_array
+     * @brief Multidimensional array whose value type is chosen at runtime.
+     *
+     * The elements are held by a contiguous buffer tagged by a dtype. visit
+     * calls a generic functor with an xarray_adaptor of the buffer, typed
+     * after the dtype, so that the kernels compiled for this value type
+     * (vectorized assignments and reductions) run on dynamic data. The
+     * arithmetic operators and the reductions of xdtype_array are built
+     * upon visit: the operands are first converted to their common dtype,
+     * so that each operation is instantiated once per dtype instead of once
+     * per pair of dtypes.
+     */
+    class xdtype_array
+    {
+    public:
+
+        using size_type = std::size_t;
+        using shape_type = dynamic_shape<std::size_t>;
+        using buffer_type = uvector<char, XTENSOR_DEFAULT_ALLOCATOR(char)>;
+
+        template <class T>
+        using buffer_adaptor_type = xbuffer_adaptor<T*, no_ownership, std::allocator<std::remove_const_t<T>>>;
+
+        template <class T>
+        using adaptor_type = xarray_adaptor<buffer_adaptor_type<T>, layout_type::dynamic, shape_type>;
+
+        xdtype_array();
+        xdtype_array(dtype t, const shape_type& shape, layout_type l = XTENSOR_DEFAULT_LAYOUT);
+
+        template <class E>
+        explicit xdtype_array(const xexpression<E>& e);
+
+        dtype type() const noexcept;
+        size_type dimension() const noexcept;
+        size_type size() const noexcept;
+        const shape_type& shape() const noexcept;
+        layout_type layout() const noexcept;
+        size_type itemsize() const;
+        size_type nbytes() const noexcept;
+
+        void* data() noexcept;
+        const void* data() const noexcept;
+
+        template <class T>
+        adaptor_type<T> as();
+
+        template <class T>
+        adaptor_type<const T> as() const;
+
+        template <class F>
+        decltype(auto) visit(F&& f);
+
+        template <class F>
+        decltype(auto) visit(F&& f) const;
+
+        xdtype_array astype(dtype t) const;
+
+        xdtype_array sum() const;
+        xdtype_array sum(const std::vector<std::size_t>& axes) const;
+        xdtype_array prod() const;
+        xdtype_array prod(const std::vector<std::size_t>& axes) const;
+        xdtype_array amin() const;
+        xdtype_array amin(const std::vector<std::size_t>& axes) const;
+        xdtype_array amax() const;
+        xdtype_array amax(const std::vector<std::size_t>& axes) const;
+        xdtype_array mean() const;
+        xdtype_array mean(const std::vector<std::size_t>& axes) const;
+
+    private:
+
+        template <class T>
+        void check_type(const char* name) const;
+
+        template <class F>
+        xdtype_array reduce(F&& f) const;
+
+        dtype m_type;
+        shape_type m_shape;
+        layout_type m_layout;
+        buffer_type m_buffer;
+    };
+
+    xdtype_array operator+(const xdtype_array& lhs, const xdtype_array& rhs);
+    xdtype_array operator-(const xdtype_array& lhs, const xdtype_array& rhs);
+    xdtype_array operator*(const xdtype_array& lhs, const xdtype_array& rhs);
+    xdtype_array operator/(const xdtype_array& lhs, const xdtype_array& rhs);
+
+    /************************
+     * dtype implementation *
+     ************************/
+
+    /**
+     * Returns the numpy name of the dtype.
+     */
+    inline const char* to_string(dtype t) noexcept
+    {
+        switch (t)
+        {
+            case dtype::boolean:
+                return "bool";
+            case dtype::int8:
+                return "int8";
+            case dtype::uint8:
+                return "uint8";
+            case dtype::int16:
+                return "int16";
+            case dtype::uint16:
+                return "uint16";
+            case dtype::int32:
+                return "int32";
+            case dtype::uint32:
+                return "uint32";
+            case dtype::int64:
+                return "int64";
+            case dtype::uint64:
+                return "uint64";
+            case dtype::float32:
+                return "float32";
+            case dtype::float64:
+                return "float64";
+        }
+        return "unknown";
+    }
+
+    /**
+     * Dispatches a runtime dtype to a generic functor: calls \c f with a
+     * dtype_tag of the value type corresponding to \c t. The functor must
+     * return the same type for every dtype.
+     */
+    template <class F>
+    inline decltype(auto) visit_dtype(dtype t, F&& f)
+    {
+        switch (t)
+        {
+            case dtype::boolean:
+                return f(dtype_tag<bool>());
+            case dtype::int8:
+                return f(dtype_tag<std::int8_t>());
+            case dtype::uint8:
+                return f(dtype_tag<std::uint8_t>());
+            case dtype::int16:
+                return f(dtype_tag<std::int16_t>());
+            case dtype::uint16:
+                return f(dtype_tag<std::uint16_t>());
+            case dtype::int32:
+                return f(dtype_tag<std::int32_t>());
+            case dtype::uint32:
+                return f(dtype_tag<std::uint32_t>());
+            case dtype::int64:
+                return f(dtype_tag<std::int64_t>());
+            case dtype::uint64:
+                return f(dtype_tag<std::uint64_t>());
+            case dtype::float32:
+                return f(dtype_tag<float>());
+            case dtype::float64:
+                return f(dtype_tag<double>());
+        }
+        throw std::runtime_error("visit_dtype: unknown dtype");
+    }
+
+    /**
+     * Returns the size in bytes of the values of the dtype.
+     */
+    inline std::size_t itemsize(dtype t)
+    {
+        return visit_dtype(t, [](auto tag) { return sizeof(typename decltype(tag)::type); });
+    }
+
+    inline bool is_floating_point(dtype t) noexcept
+    {
+        return t == dtype::float32 || t == dtype::float64;
+    }
+
+    namespace detail
+    {
+        inline bool is_signed_dtype(dtype t) noexcept
+        {
+            return t == dtype::int8 || t == dtype::int16 || t == dtype::int32 || t == dtype::int64;
+        }
+    }
+
+    /**
+     * @brief Returns the smallest dtype to which both dtypes can be safely
+     * converted, following the rules of numpy.
+     *
+     * Booleans are promoted to any other type, mixed signed and unsigned
+     * integers to the next larger signed integer, int64 and uint64 to
+     * float64, and integers mixed with float32 to float64 unless they fit
+     * in 16 bits.
+     */
+    inline dtype promote_types(dtype t1, dtype t2) noexcept
+    {
+        if (t1 == t2 || t2 == dtype::boolean)
+        {
+            return t1;
+        }
+        if (t1 == dtype::boolean)
+        {
+            return t2;
+        }
+        std::size_t s1 = itemsize(t1);
+        std::size_t s2 = itemsize(t2);
+        bool f1 = is_floating_point(t1);
+        bool f2 = is_floating_point(t2);
+        if (f1 || f2)
+        {
+            if (f1 && f2)
+            {
+                return s1 > s2 ? t1 : t2;
+            }
+            std::size_t int_size = f1 ? s2 : s1;
+            dtype float_type = f1 ? t1 : t2;
+            return int_size <= 2 && float_type == dtype::float32 ? dtype::float32 : dtype::float64;
+        }
+        bool i1 = detail::is_signed_dtype(t1);
+        bool i2 = detail::is_signed_dtype(t2);
+        if (i1 == i2)
+        {
+            return s1 > s2 ? t1 : t2;
+        }
+        std::size_t signed_size = i1 ? s1 : s2;
+        std::size_t unsigned_size = i1 ? s2 : s1;
+        if (signed_size > unsigned_size)
+        {
+            return i1 ? t1 : t2;
+        }
+        return unsigned_size == 8 ? dtype::float64 : detail::integer_dtype(2 * unsigned_size, true);
+    }
+
+    /*******************************
+     * xdtype_array implementation *
+     *******************************/
+
+    /**
+     * Builds a 0-D array of type float64.
+     */
+    inline xdtype_array::xdtype_array()
+        : xdtype_array(dtype::float64, shape_type())
+    {
+    }
+
+    /**
+     * Allocates an array of the given dtype, shape and layout. The elements
+     * are not initialized.
+     * @param t the dtype of the elements
+     * @param shape the shape of the array
+     * @param l the layout of the array, either row_major or column_major
+     */
+    inline xdtype_array::xdtype_array(dtype t, const shape_type& shape, layout_type l)
+        : m_type(t), m_shape(shape), m_layout(l)
+    {
+        if (l != layout_type::row_major && l != layout_type::column_major)
+        {
+            throw std::runtime_error("xdtype_array: the layout must be row_major or column_major");
+        }
+        m_buffer.resize(compute_size(m_shape) * xt::itemsize(t));
+    }
+
+    /**
+     * Copies an expression, the dtype of the array is the one of its
+     * value type.
+     */
+    template <class E>
+    inline xdtype_array::xdtype_array(const xexpression<E>& e)
+        : xdtype_array(dtype_of<typename E::value_type>::value,
+                       xtl::forward_sequence<shape_type>(e.derived_cast().shape()))
+    {
+        as<typename E::value_type>() = e;
+    }
+
+    inline dtype xdtype_array::type() const noexcept
+    {
+        return m_type;
+    }
+
+    inline auto xdtype_array::dimension() const noexcept -> size_type
+    {
+        return m_shape.size();
+    }
+
+    inline auto xdtype_array::size() const noexcept -> size_type
+    {
+        return compute_size(m_shape);
+    }
+
+    inline auto xdtype_array::shape() const noexcept -> const shape_type&
+    {
+        return m_shape;
+    }
+
+    inline layout_type xdtype_array::layout() const noexcept
+    {
+        return m_layout;
+    }
+
+    inline auto xdtype_array::itemsize() const -> size_type
+    {
+        return xt::itemsize(m_type);
+    }
+
+    inline auto xdtype_array::nbytes() const noexcept -> size_type
+    {
+        return m_buffer.size();
+    }
+
+    inline void* xdtype_array::data() noexcept
+    {
+        return m_buffer.data();
+    }
+
+    inline const void* xdtype_array::data() const noexcept
+    {
+        return m_buffer.data();
+    }
+
+    /**
+     * Returns an adaptor of the elements, T must correspond to the dtype
+     * of the array, otherwise a std::runtime_error is thrown.
+     */
+    template <class T>
+    inline auto xdtype_array::as() -> adaptor_type<T>
+    {
+        check_type<T>("as");
+        return adaptor_type<T>(buffer_adaptor_type<T>(reinterpret_cast<T*>(m_buffer.data()), size()),
+                               m_shape, m_layout);
+    }
+
+    template <class T>
+    inline auto xdtype_array::as() const -> adaptor_type<const T>
+    {
+        check_type<T>("as");
+        return adaptor_type<const T>(buffer_adaptor_type<const T>(reinterpret_cast<const T*>(m_buffer.data()), size()),
+                                     m_shape, m_layout);
+    }
+
+    /**
+     * Calls \c f with an adaptor of the elements typed after the dtype of
+     * the array. The functor must return the same type for every dtype.
+     */
+    template <class F>
+    inline decltype(auto) xdtype_array::visit(F&& f)
+    {
+        return visit_dtype(m_type, [this, &f](auto tag) -> decltype(auto) {
+            return f(this->as<typename decltype(tag)::type>());
+        });
+    }
+
+    template <class F>
+    inline decltype(auto) xdtype_array::visit(F&& f) const
+    {
+        return visit_dtype(m_type, [this, &f](auto tag) -> decltype(auto) {
+            return f(this->as<typename decltype(tag)::type>());
+        });
+    }
+
+    /**
+     * Returns a copy of the array converted to the given dtype.
+     */
+    inline xdtype_array xdtype_array::astype(dtype t) const
+    {
+        xdtype_array res(t, m_shape, m_layout);
+        visit([&res](const auto& src) {
+            res.visit([&src](auto dst) {
+                using value_type = typename decltype(dst)::value_type;
+                dst = cast<value_type>(src);
+            });
+        });
+        return res;
+    }
+
+    /**
+     * @name Reductions
+     *
+     * The reductions are evaluated immediately; their dtype is the one of the
+     * result of the corresponding reducer on the value type of the array.
+     */
+    //@{
+    inline xdtype_array xdtype_array::sum() const
+    {
+        return reduce([](const auto& a) { return xt::sum(a, evaluation_strategy::immediate()); });
+    }
+
+    inline xdtype_array xdtype_array::sum(const std::vector<std::size_t>& axes) const
+    {
+        return reduce([&axes](const auto& a) { return xt::sum(a, axes, evaluation_strategy::immediate()); });
+    }
+
+    inline xdtype_array xdtype_array::prod() const
+    {
+        return reduce([](const auto& a) { return xt::prod(a, evaluation_strategy::immediate()); });
+    }
+
+    inline xdtype_array xdtype_array::prod(const std::vector<std::size_t>& axes) const
+    {
+        return reduce([&axes](const auto& a) { return xt::prod(a, axes, evaluation_strategy::immediate()); });
+    }
+
+    inline xdtype_array xdtype_array::amin() const
+    {
+        return reduce([](const auto& a) { return xt::amin(a, evaluation_strategy::immediate()); });
+    }
+
+    inline xdtype_array xdtype_array::amin(const std::vector<std::size_t>& axes) const
+    {
+        return reduce([&axes](const auto& a) { return xt::amin(a, axes, evaluation_strategy::immediate()); });
+    }
+
+    inline xdtype_array xdtype_array::amax() const
+    {
+        return reduce([](const auto& a) { return xt::amax(a, evaluation_strategy::immediate()); });
+    }
+
+    inline xdtype_array xdtype_array::amax(const std::vector<std::size_t>& axes) const
+    {
+        return reduce([&axes](const auto& a) { return xt::amax(a, axes, evaluation_strategy::immediate()); });
+    }
+
+    inline xdtype_array xdtype_array::mean() const
+    {
+        return reduce([](const auto& a) { return xt::mean(a, evaluation_strategy::immediate()); });
+    }
+
+    inline xdtype_array xdtype_array::mean(const std::vector<std::size_t>& axes) const
+    {
+        return reduce([&axes](const auto& a) { return xt::mean(a, axes, evaluation_strategy::immediate()); });
+    }
+    //@}
+
+    template <class T>
+    inline void xdtype_array::check_type(const char* name) const
+    {
+        if (dtype_of<std::remove_const_t<T>>::value != m_type)
+        {
+            throw std::runtime_error(std::string("xdtype_array::") + name + ": the array holds elements of type " +
+                                     to_string(m_type) + ", not " + to_string(dtype_of<std::remove_const_t<T>>::value));
+        }
+    }
+
+    template <class F>
+    inline xdtype_array xdtype_array::reduce(F&& f) const
+    {
+        return visit([&f](const auto& a) { return xdtype_array(f(a)); });
+    }
+
+    namespace detail
+    {
+        // Converts the operands to their common dtype, or to float64 for the
+        // division of integers, and applies f to their adaptors.
+        template <class F>
+        inline xdtype_array dtype_binary(const xdtype_array& lhs, const xdtype_array& rhs, bool floating, F&& f)
+        {
+            dtype t = promote_types(lhs.type(), rhs.type());
+            if (floating && !is_floating_point(t))
+            {
+                t = dtype::float64;
+            }
+            xdtype_array lhs_tmp = lhs.type() == t ? xdtype_array(t, {}) : lhs.astype(t);
+            xdtype_array rhs_tmp = rhs.type() == t ? xdtype_array(t, {}) : rhs.astype(t);
+            const xdtype_array& l = lhs.type() == t ? lhs : lhs_tmp;
+            const xdtype_array& r = rhs.type() == t ? rhs : rhs_tmp;
+            return l.visit([&r, t, &f](const auto& a) {
+                using value_type = typename std::decay_t<decltype(a)>::value_type;
+                auto b = r.as<value_type>();
+                auto expr = f(a, b);
+                xdtype_array res(t, xtl::forward_sequence<xdtype_array::shape_type>(expr.shape()));
+                res.as<value_type>() = expr;
+                return res;
+            });
+        }
+    }
+
+    /**
+     * @name Arithmetic operators
+     *
+     * The operands are broadcast and converted to the dtype returned by
+     * promote_types; integers are divided as float64.
+     */
+    //@{
+    inline xdtype_array operator+(const xdtype_array& lhs, const xdtype_array& rhs)
+    {
+        return detail::dtype_binary(lhs, rhs, false, [](const auto& a, const auto& b) { return a + b; });
+    }
+
+    inline xdtype_array operator-(const xdtype_array& lhs, const xdtype_array& rhs)
+    {
+        return detail::dtype_binary(lhs, rhs, false, [](const auto& a, const auto& b) { return a - b; });
+    }
+
+    inline xdtype_array operator*(const xdtype_array& lhs, const xdtype_array& rhs)
+    {
+        return detail::dtype_binary(lhs, rhs, false, [](const auto& a, const auto& b) { return a * b; });
+    }
+
+    inline xdtype_array operator/(const xdtype_array& lhs, const xdtype_array& rhs)
+    {
+        return detail::dtype_binary(lhs, rhs, true, [](const auto& a, const auto& b) { return a / b; });
+    }
+    //@}
+}
+
+#endif
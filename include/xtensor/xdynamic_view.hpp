@@ -9,6 +9,8 @@
 #ifndef XTENSOR_DYNAMIC_VIEW_HPP
 #define XTENSOR_DYNAMIC_VIEW_HPP
 
+#include <array>
+
 #include <xtl/xsequence.hpp>
 #include <xtl/xvariant.hpp>
 
@@ -225,6 +227,26 @@ namespace xt
         template <class E>
         rebind_t<E> build_view(E&& e) const;
 
+        template <class SV>
+        void reset_slices(const SV& slices);
+
+        //
+        // SIMD interface, the elements are gathered one by one
+        //
+
+        template <class requested_type>
+        using simd_return_type = xsimd::simd_return_type<value_type, requested_type>;
+
+        template <class align, class simd>
+        void store_simd(size_type i, const simd& e);
+
+        template <class align, class requested_type = value_type,
+                  std::size_t N = xsimd::simd_traits<requested_type>::size>
+        simd_return_type<requested_type> load_simd(size_type i) const;
+
+        reference data_element(size_type i);
+        const_reference data_element(size_type i) const;
+
     private:
 
         using offset_type = typename base_type::offset_type;
@@ -293,6 +315,9 @@ namespace xt
 
     using xdynamic_slice_vector = std::vector<xdynamic_slice<std::ptrdiff_t>>;
 
+    template <class E, class SV>
+    auto dynamic_view(E&& e, const SV& slices);
+
     template <class E>
     auto dynamic_view(E&& e, const xdynamic_slice_vector& slices);
 
@@ -527,6 +552,10 @@ namespace xt
     inline auto xdynamic_view<CT, S, L, FST>::data_offset() const noexcept -> size_type
     {
         size_type offset = base_type::data_offset();
+        if (m_slices.empty())
+        {
+            return offset;
+        }
         size_type sl_offset = xtl::visit([](const auto& sl) { return sl(size_type(0)); }, m_slices[0]);
         return offset + sl_offset * m_adj_strides[0];
     }
@@ -582,6 +611,83 @@ namespace xt
                            base_type::data_offset(), this->layout(), std::move(svt), std::move(adj_str));
     }
 
+    /**
+     * Rebinds the view to new slices of its underlying expression, in place.
+     * The shape, strides and slices of the view reuse their storage, so
+     * that rebinding a view in a loop, instead of building a new one for
+     * each iteration, does not allocate as long as the keep and drop slices
+     * fit in the storage of the previous ones.
+     *
+     * \code{.cpp}
+     * xt::xarray<double> a = xt::arange(100.);
+     * a.resize({10, 10});
+     * std::array<xt::xdynamic_slice<std::ptrdiff_t>, 1> slices = {{xt::range(0, 2)}};
+     * auto v = xt::dynamic_view(a, slices);
+     * for (std::ptrdiff_t i = 1; i < 5; ++i)
+     * {
+     *     slices[0] = xt::range(2 * i, 2 * i + 2);
+     *     v.reset_slices(slices);
+     *     // ...
+     * }
+     * \endcode
+     *
+     * @param slices the new slices, in a container of xdynamic_slice
+     */
+    template <class CT, class S, layout_type L, class FST>
+    template <class SV>
+    inline void xdynamic_view<CT, S, L, FST>::reset_slices(const SV& slices)
+    {
+        using policy = detail::adj_strides_policy<slice_vector_type>;
+        const auto& e = expression();
+        detail::strided_view_args<policy> args;
+        args.new_slices = std::move(m_slices);
+        args.fill_args(e.shape(), detail::get_strides(e), detail::get_offset(e), e.layout(), slices);
+        base_type::reset_geometry(std::move(args.new_shape), std::move(args.new_strides), args.new_offset, args.new_layout);
+        m_slices = std::move(args.new_slices);
+        m_adj_strides = std::move(args.new_adj_strides);
+    }
+
+    template <class CT, class S, layout_type L, class FST>
+    template <class align, class simd>
+    inline void xdynamic_view<CT, S, L, FST>::store_simd(size_type i, const simd& e)
+    {
+        constexpr std::size_t size = xsimd::revert_simd_traits<simd>::size;
+        std::array<value_type, size> buffer;
+        xsimd::store_simd<value_type, typename simd::value_type>(buffer.data(), e, xsimd::unaligned_mode());
+        for (std::size_t k = 0; k < size; ++k)
+        {
+            data_element(i + k) = buffer[k];
+        }
+    }
+
+    template <class CT, class S, layout_type L, class FST>
+    template <class align, class requested_type, std::size_t N>
+    inline auto xdynamic_view<CT, S, L, FST>::load_simd(size_type i) const -> simd_return_type<requested_type>
+    {
+        std::array<value_type, N> buffer;
+        for (std::size_t k = 0; k < N; ++k)
+        {
+            buffer[k] = data_element(i + k);
+        }
+        return xsimd::load_simd<value_type, requested_type>(buffer.data(), xsimd::unaligned_mode());
+    }
+
+    // The linear index follows the order of begin(), like the linear assignment
+    // of expressions without storage iterators.
+    template <class CT, class S, layout_type L, class FST>
+    inline auto xdynamic_view<CT, S, L, FST>::data_element(size_type i) -> reference
+    {
+        auto index = unravel_index(i, shape(), XTENSOR_DEFAULT_LAYOUT);
+        return element(index.cbegin(), index.cend());
+    }
+
+    template <class CT, class S, layout_type L, class FST>
+    inline auto xdynamic_view<CT, S, L, FST>::data_element(size_type i) const -> const_reference
+    {
+        auto index = unravel_index(i, shape(), XTENSOR_DEFAULT_LAYOUT);
+        return element(index.cbegin(), index.cend());
+    }
+
     template <class CT, class S, layout_type L, class FST>
     inline auto xdynamic_view<CT, S, L, FST>::data_xbegin() noexcept -> container_iterator
     {
@@ -634,6 +740,10 @@ namespace xt
     inline auto xdynamic_view<CT, S, L, FST>::adjust_offset(offset_type offset, T idx, Args... args) const noexcept -> offset_type
     {
         constexpr size_type nb_args = sizeof...(Args) + 1;
+        if (m_slices.empty())
+        {
+            return offset;
+        }
         size_type dim = base_type::dimension();
         offset_type res = nb_args > dim ? adjust_offset(offset, args...) : adjust_offset_impl(offset, dim - nb_args, idx, args...);
         return res;
@@ -669,6 +779,10 @@ namespace xt
     template <class It>
     inline auto xdynamic_view<CT, S, L, FST>::adjust_element_offset(offset_type offset, It first, It last) const noexcept -> offset_type
     {
+        if (m_slices.empty())
+        {
+            return offset;
+        }
         auto dst = std::distance(first, last);
         offset_type dim = static_cast<offset_type>(dimension());
         offset_type loop_offset = dst < dim ? dim - dst : offset_type(0);
@@ -700,20 +814,25 @@ namespace xt
 
         protected:
 
+            // The slices are only stored when there is at least one keep or
+            // drop slice; clearing keeps the capacity of a reused vector
             inline void resize(std::size_t size)
             {
-                new_slices.resize(size);
+                new_slices.clear();
                 new_adj_strides.resize(size);
             }
 
             inline void set_fake_slice(std::size_t idx)
             {
-                new_slices[idx] = xfake_slice<std::ptrdiff_t>();
+                if (!new_slices.empty())
+                {
+                    new_slices[idx] = xfake_slice<std::ptrdiff_t>();
+                }
                 new_adj_strides[idx] = std::ptrdiff_t(0);
             }
 
-            template <class ST, class S>
-            bool fill_args(const xdynamic_slice_vector& slices, std::size_t sl_idx,
+            template <class V, class ST, class S>
+            bool fill_args(const V& slices, std::size_t sl_idx,
                            std::size_t i, std::size_t old_shape,
                            const ST& old_stride,
                            S& shape, get_strides_t<S>& strides)
@@ -722,8 +841,8 @@ namespace xt
                     || fill_args_impl<xdrop_slice<std::ptrdiff_t>>(slices, sl_idx, i, old_shape, old_stride, shape, strides);
             }
 
-            template <class SL, class ST, class S>
-            bool fill_args_impl(const xdynamic_slice_vector& slices, std::size_t sl_idx,
+            template <class SL, class V, class ST, class S>
+            bool fill_args_impl(const V& slices, std::size_t sl_idx,
                                 std::size_t i, std::size_t old_shape,
                                 const ST& old_stride,
                                 S& shape, get_strides_t<S>& strides)
@@ -731,6 +850,10 @@ namespace xt
                 auto* sl = xtl::get_if<SL>(&slices[sl_idx]);
                 if (sl != nullptr)
                 {
+                    if (new_slices.empty())
+                    {
+                        new_slices.resize(new_adj_strides.size());
+                    }
                     new_slices[i] = *sl;
                     auto& ns = xtl::get<SL>(new_slices[i]);
                     ns.normalize(old_shape);
@@ -743,8 +866,8 @@ namespace xt
         };
     }
 
-    template <class E>
-    inline auto dynamic_view(E&& e, const xdynamic_slice_vector& slices)
+    template <class E, class SV>
+    inline auto dynamic_view(E&& e, const SV& slices)
     {
         using view_type = xdynamic_view<xclosure_t<E>, dynamic_shape<std::size_t>>;
         using slice_vector = typename view_type::slice_vector_type;
@@ -754,6 +877,12 @@ namespace xt
         return view_type(std::forward<E>(e), std::move(args.new_shape), std::move(args.new_strides), args.new_offset,
                          args.new_layout, std::move(args.new_slices), std::move(args.new_adj_strides));
     }
+
+    template <class E>
+    inline auto dynamic_view(E&& e, const xdynamic_slice_vector& slices)
+    {
+        return dynamic_view<E, xdynamic_slice_vector>(std::forward<E>(e), slices);
+    }
 }
 
 #endif
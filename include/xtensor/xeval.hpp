@@ -9,6 +9,13 @@
 #ifndef XTENSOR_EVAL_HPP
 #define XTENSOR_EVAL_HPP
 
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+
+#include <xtl/xsequence.hpp>
+
+#include "xstrides.hpp"
 #include "xtensor_forward.hpp"
 
 namespace xt
@@ -18,10 +25,35 @@ namespace xt
     {
         template <class T>
         using is_container = std::is_base_of<xcontainer<std::remove_const_t<T>>, T>;
+
+        template <class A, class T>
+        using rebind_allocator_t = typename std::allocator_traits<A>::template rebind_alloc<T>;
+
+        // Builds a container of the shape of e whose storage is allocated
+        // with alloc, then assigns e without temporary.
+        template <class R, class E, class A>
+        inline R eval_with_allocator(const E& e, const A& alloc)
+        {
+            using storage_type = typename R::storage_type;
+            using shape_type = typename R::inner_shape_type;
+            using strides_type = typename R::inner_strides_type;
+            using size_type = typename shape_type::value_type;
+            shape_type shape = xtl::make_sequence<shape_type>(e.dimension(), size_type(0));
+            std::copy(e.shape().cbegin(), e.shape().cend(), shape.begin());
+            strides_type strides = xtl::make_sequence<strides_type>(e.dimension(), typename strides_type::value_type(0));
+            std::size_t size = compute_strides(shape, R::static_layout, strides);
+            R res(storage_type(size, alloc), std::move(shape), std::move(strides));
+            res.assign(e);
+            return res;
+        }
     }
 
     /**
      * Force evaluation of xexpression.
+     * The evaluation of expressions that are not containers goes through the
+     * regular assignment: the linear, strided loop and stepper assignments
+     * are all split into chunks run by parallel_for when a parallel backend
+     * is enabled (see XTENSOR_PARALLEL_ENABLED).
      * @return xarray or xtensor depending on shape type
      *
      * \code{.cpp}
@@ -60,6 +92,70 @@ namespace xt
         return xtensor_fixed<typename I::value_type, typename I::shape_type>(std::forward<T>(t));
     }
     /// @endcond
+
+    /**
+     * Evaluates an expression into a new container whose storage is
+     * allocated with \c alloc, rebound to the value type of the expression,
+     * for instance an arena_allocator. Unlike eval without allocator, a
+     * container is always copied.
+     * @param t the expression to evaluate
+     * @param alloc the allocator of the storage of the result
+     * @return an xtensor if the expression has a fixed number of dimensions,
+     * an xarray otherwise
+     *
+     * \code{.cpp}
+     * xt::arena_scope scope;
+     * auto tmp = xt::eval(a * b + c, xt::arena_allocator<double>());
+     * \endcode
+     */
+    template <class T, class A, class I = std::decay_t<T>>
+    inline auto eval(T&& t, const A& alloc)
+        -> std::enable_if_t<detail::is_array<typename I::shape_type>::value,
+                            xtensor<typename I::value_type, std::tuple_size<typename I::shape_type>::value, XTENSOR_DEFAULT_LAYOUT,
+                                    detail::rebind_allocator_t<A, typename I::value_type>>>
+    {
+        using value_type = typename I::value_type;
+        using allocator_type = detail::rebind_allocator_t<A, value_type>;
+        using result_type = xtensor<value_type, std::tuple_size<typename I::shape_type>::value, XTENSOR_DEFAULT_LAYOUT, allocator_type>;
+        return detail::eval_with_allocator<result_type>(t, allocator_type(alloc));
+    }
+
+    /// @cond DOXYGEN_INCLUDE_SFINAE
+    template <class T, class A, class I = std::decay_t<T>>
+    inline auto eval(T&& t, const A& alloc)
+        -> std::enable_if_t<!detail::is_array<typename I::shape_type>::value,
+                            xarray<typename I::value_type, XTENSOR_DEFAULT_LAYOUT, detail::rebind_allocator_t<A, typename I::value_type>>>
+    {
+        using value_type = typename I::value_type;
+        using allocator_type = detail::rebind_allocator_t<A, value_type>;
+        using result_type = xarray<value_type, XTENSOR_DEFAULT_LAYOUT, allocator_type>;
+        return detail::eval_with_allocator<result_type>(t, allocator_type(alloc));
+    }
+    /// @endcond
+
+    /**
+     * Evaluates an expression into an existing container or view, without
+     * temporary. Containers are resized to the shape of the expression; the
+     * storage they already hold is reused when the size does not change.
+     * Since no temporary is used, \c out must not be involved in \c e.
+     * @param out the destination
+     * @param e the expression to evaluate
+     * @return a reference to \c out
+     *
+     * \code{.cpp}
+     * xt::xarray<double> out;
+     * for (const auto& frame : frames)
+     * {
+     *     xt::eval_into(out, frame * window);  // no allocation after the first frame
+     * }
+     * \endcode
+     */
+    template <class C, class E>
+    inline C& eval_into(C& out, const xexpression<E>& e)
+    {
+        out.assign(e);
+        return out;
+    }
 }
 
 #endif
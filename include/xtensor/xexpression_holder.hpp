@@ -10,6 +10,10 @@
 #ifndef XTENSOR_XEXPRESSION_HOLDER_HPP
 #define XTENSOR_XEXPRESSION_HOLDER_HPP
 
+#include <complex>
+#include <cstdint>
+#include <string>
+
 #include <nlohmann/json.hpp>
 
 #include "xtl/xany.hpp"
@@ -51,11 +55,18 @@ namespace xt
         void to_json(nlohmann::json&) const;
         void from_json(const nlohmann::json&);
 
+#if defined(XTENSOR_JSON_BINARY)
+        void to_json_binary(nlohmann::json&) const;
+#endif
+
         ~xexpression_holder();
 
     private:
 
         void init_pointer_from_json(const nlohmann::json&);
+#if defined(XTENSOR_JSON_BINARY)
+        void init_pointer_from_dtype(const std::string&);
+#endif
         void check_holder() const;
 
         implementation_type* p_holder;
@@ -68,6 +79,10 @@ namespace xt
     void to_json(nlohmann::json& j, const xexpression_holder& o);
     void from_json(const nlohmann::json& j, xexpression_holder& o);
 
+#if defined(XTENSOR_JSON_BINARY)
+    void to_json_binary(nlohmann::json& j, const xexpression_holder& o);
+#endif
+
     namespace detail
     {
         class xexpression_holder_impl // Entity semantic
@@ -82,6 +97,9 @@ namespace xt
             virtual xexpression_holder_impl* clone() const = 0;
             virtual void to_json(nlohmann::json&) const = 0;
             virtual void from_json(const nlohmann::json&) = 0;
+#if defined(XTENSOR_JSON_BINARY)
+            virtual void to_json_binary(nlohmann::json&) const = 0;
+#endif
             virtual ~xexpression_holder_impl() = default;
 
         protected:
@@ -101,6 +119,9 @@ namespace xt
 
             void to_json(nlohmann::json&) const;
             void from_json(const nlohmann::json&);
+#if defined(XTENSOR_JSON_BINARY)
+            void to_json_binary(nlohmann::json&) const;
+#endif
 
             ~xexpression_wrapper() = default;
 
@@ -168,8 +189,31 @@ namespace xt
         p_holder->to_json(j);
     }
 
+#if defined(XTENSOR_JSON_BINARY)
+    inline void xexpression_holder::to_json_binary(nlohmann::json& j) const
+    {
+        if (p_holder == nullptr)
+        {
+            return;
+        }
+        p_holder->to_json_binary(j);
+    }
+#endif
+
     inline void xexpression_holder::from_json(const nlohmann::json& j)
     {
+#if defined(XTENSOR_JSON_BINARY)
+        // binary tensor written by to_json_binary
+        if (j.is_object() && j.contains("dtype") && j["dtype"].is_string())
+        {
+            if (p_holder == nullptr)
+            {
+                init_pointer_from_dtype(j["dtype"].get<std::string>());
+            }
+            p_holder->from_json(j);
+            return;
+        }
+#endif
         if (!j.is_array())
         {
             throw std::runtime_error("Received a JSON that does not contain a tensor");
@@ -193,23 +237,62 @@ namespace xt
         {
             xt::xarray<double> empty_arr;
             p_holder = new detail::xexpression_wrapper<xt::xarray<double>>(std::move(empty_arr));
+            return;
         }
 
         if (j.is_boolean())
         {
             xt::xarray<bool> empty_arr;
             p_holder = new detail::xexpression_wrapper<xt::xarray<bool>>(std::move(empty_arr));
+            return;
         }
 
         if (j.is_string())
         {
             xt::xarray<std::string> empty_arr;
             p_holder = new detail::xexpression_wrapper<xt::xarray<std::string>>(std::move(empty_arr));
+            return;
         }
 
         throw std::runtime_error("Received a JSON with a tensor that contains unsupported data type");
     }
 
+#if defined(XTENSOR_JSON_BINARY)
+    namespace detail
+    {
+        template <class T>
+        inline xexpression_holder_impl* make_holder_for_dtype(const std::string& kind_size)
+        {
+            if (detail::json_dtype<T>().substr(1) != kind_size)
+            {
+                return nullptr;
+            }
+            return new xexpression_wrapper<xarray<T>>(xarray<T>());
+        }
+
+        template <class T, class T1, class... Ts>
+        inline xexpression_holder_impl* make_holder_for_dtype(const std::string& kind_size)
+        {
+            xexpression_holder_impl* res = make_holder_for_dtype<T>(kind_size);
+            return res != nullptr ? res : make_holder_for_dtype<T1, Ts...>(kind_size);
+        }
+    }
+
+    inline void xexpression_holder::init_pointer_from_dtype(const std::string& dtype)
+    {
+        if (dtype.size() > 1)
+        {
+            p_holder = detail::make_holder_for_dtype<double, float, std::int64_t, std::int32_t, std::int16_t, std::int8_t,
+                                                     std::uint64_t, std::uint32_t, std::uint16_t, std::uint8_t, bool,
+                                                     std::complex<double>, std::complex<float>>(dtype.substr(1));
+        }
+        if (p_holder == nullptr)
+        {
+            throw std::runtime_error("Received a JSON with a tensor that contains unsupported data type: " + dtype);
+        }
+    }
+#endif
+
     inline void xexpression_holder::check_holder() const
     {
         if (p_holder == nullptr)
@@ -237,6 +320,17 @@ namespace xt
         o.from_json(j);
     }
 
+#if defined(XTENSOR_JSON_BINARY)
+    /**
+     * Binary JSON serialization of the held expression, see to_json_binary
+     * in xjson.hpp. The result is read back with from_json.
+     */
+    inline void to_json_binary(nlohmann::json& j, const xexpression_holder& o)
+    {
+        o.to_json_binary(j);
+    }
+#endif
+
     namespace detail
     {
         template <class CTE>
@@ -265,6 +359,14 @@ namespace xt
             ::xt::from_json(j, m_expression);
         }
 
+#if defined(XTENSOR_JSON_BINARY)
+        template <class CTE>
+        inline void xexpression_wrapper<CTE>::to_json_binary(nlohmann::json& j) const
+        {
+            ::xt::to_json_binary(j, m_expression);
+        }
+#endif
+
         template <class CTE>
         inline xexpression_wrapper<CTE>::xexpression_wrapper(const xexpression_wrapper& wrapper)
             : xexpression_holder_impl(),
@@ -0,0 +1,472 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_FAST_MATH_HPP
+#define XTENSOR_FAST_MATH_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "xmath.hpp"
+#include "xtensor_simd.hpp"
+
+namespace xt
+{
+    namespace fast
+    {
+        namespace detail
+        {
+            /*************
+             * constants *
+             *************/
+
+            template <class T>
+            struct fast_constants;
+
+            // the constants are functions so that binding them to the
+            // constructors of xsimd batches does not odr-use them
+            template <>
+            struct fast_constants<float>
+            {
+                using int_type = std::int32_t;
+                static constexpr int_type exponent_bias() { return 127; }
+                static constexpr int mantissa_bits() { return 23; }
+                static constexpr int_type mantissa_mask() { return 0x007fffff; }
+                static constexpr int_type one_bits() { return 0x3f800000; }
+                static constexpr float denormal_scale() { return 8388608.f; }
+                // bounds of the arguments of exp whose result is a normal number
+                static constexpr float exp_min() { return -87.3f; }
+                static constexpr float exp_max() { return 88.3f; }
+            };
+
+            template <>
+            struct fast_constants<double>
+            {
+                using int_type = std::int64_t;
+                static constexpr int_type exponent_bias() { return 1023; }
+                static constexpr int mantissa_bits() { return 52; }
+                static constexpr int_type mantissa_mask() { return 0x000fffffffffffff; }
+                static constexpr int_type one_bits() { return 0x3ff0000000000000; }
+                static constexpr double denormal_scale() { return 4503599627370496.; }
+                static constexpr double exp_min() { return -708.; }
+                static constexpr double exp_max() { return 709.; }
+            };
+
+            template <class T>
+            using fast_value_t = std::conditional_t<std::is_same<T, float>::value, float, double>;
+
+            template <class B>
+            struct is_fast_simd
+                : std::integral_constant<bool, std::is_same<B, float>::value || std::is_same<B, double>::value>
+            {
+            };
+
+            /*************************************
+             * operations on scalars and batches *
+             *************************************/
+
+            template <class V>
+            struct fast_ops
+            {
+                using value_type = V;
+                using int_type = typename fast_constants<V>::int_type;
+
+                static V select(bool cond, const V& a, const V& b)
+                {
+                    return cond ? a : b;
+                }
+
+                static int_type to_bits(const V& x)
+                {
+                    int_type res;
+                    std::memcpy(&res, &x, sizeof(V));
+                    return res;
+                }
+
+                static V from_bits(const int_type& i)
+                {
+                    V res;
+                    std::memcpy(&res, &i, sizeof(V));
+                    return res;
+                }
+
+                static int_type to_int(const V& x)
+                {
+                    return static_cast<int_type>(x);
+                }
+
+                static V to_float(const int_type& i)
+                {
+                    return static_cast<V>(i);
+                }
+
+                static int_type shift_left(const int_type& i, int n)
+                {
+                    return static_cast<int_type>(i << n);
+                }
+
+                static int_type shift_right(const int_type& i, int n)
+                {
+                    return static_cast<int_type>(i >> n);
+                }
+            };
+
+#ifdef XTENSOR_USE_XSIMD
+            template <class T, std::size_t N>
+            struct is_fast_simd<xsimd::batch<T, N>> : is_fast_simd<T>
+            {
+            };
+
+            template <class T, std::size_t N>
+            struct fast_ops<xsimd::batch<T, N>>
+            {
+                using batch_type = xsimd::batch<T, N>;
+                using value_type = T;
+                using int_type = xsimd::batch<typename fast_constants<T>::int_type, N>;
+
+                static batch_type select(const xsimd::batch_bool<T, N>& cond, const batch_type& a, const batch_type& b)
+                {
+                    return xsimd::select(cond, a, b);
+                }
+
+                static int_type to_bits(const batch_type& x)
+                {
+                    return xsimd::bitwise_cast<int_type>(x);
+                }
+
+                static batch_type from_bits(const int_type& i)
+                {
+                    return xsimd::bitwise_cast<batch_type>(i);
+                }
+
+                static int_type to_int(const batch_type& x)
+                {
+                    return xsimd::to_int(x);
+                }
+
+                static batch_type to_float(const int_type& i)
+                {
+                    return xsimd::to_float(i);
+                }
+
+                static int_type shift_left(const int_type& i, int n)
+                {
+                    return i << n;
+                }
+
+                static int_type shift_right(const int_type& i, int n)
+                {
+                    return i >> n;
+                }
+            };
+#endif
+
+            template <class V, class T>
+            inline V horner(const V&, T c)
+            {
+                return V(c);
+            }
+
+            template <class V, class T, class... Ts>
+            inline V horner(const V& x, T c, Ts... cs)
+            {
+                return V(c) + x * horner(x, cs...);
+            }
+
+            /******************
+             * implementation *
+             ******************/
+
+            // 2^n for the integral values n of the range of normal exponents
+            template <class V>
+            inline V pow2n(const V& n)
+            {
+                using ops = fast_ops<V>;
+                using C = fast_constants<typename ops::value_type>;
+                using I = typename ops::int_type;
+                return ops::from_bits(ops::shift_left(ops::to_int(n) + I(C::exponent_bias()), C::mantissa_bits()));
+            }
+
+            // exp(x) = 2^n exp(r), |r| <= ln(2) / 2, with the Taylor polynomial
+            // of degree 6 of exp(r)
+            template <class V>
+            inline V exp_impl(const V& x)
+            {
+                using ops = fast_ops<V>;
+                using T = typename ops::value_type;
+                using C = fast_constants<T>;
+                using std::floor;
+                const V lo(T(C::exp_min()));
+                const V hi(T(C::exp_max()));
+                V xc = ops::select(x < lo, lo, ops::select(x > hi, hi, x));
+                V n = floor(xc * V(T(1.4426950408889634)) + V(T(0.5)));
+                V r = (xc - n * V(T(0.693145751953125))) - n * V(T(1.42860682030941723212e-6));
+                V p = horner(r, T(1), T(1), T(1. / 2), T(1. / 6), T(1. / 24), T(1. / 120), T(1. / 720));
+                V res = p * pow2n(n);
+                res = ops::select(x < lo, V(T(0)), res);
+                return ops::select(x > hi, V(std::numeric_limits<T>::infinity()), res);
+            }
+
+            // log(x) = e ln(2) + log(m), sqrt(2) / 2 <= m < sqrt(2), with the
+            // series of atanh in s = (m - 1) / (m + 1), |s| < 0.172
+            template <class V>
+            inline V log_impl(const V& x)
+            {
+                using ops = fast_ops<V>;
+                using T = typename ops::value_type;
+                using I = typename ops::int_type;
+                using C = fast_constants<T>;
+                const V zero(T(0));
+                const V one(T(1));
+                auto denormal = x < V(std::numeric_limits<T>::min());
+                I bits = ops::to_bits(ops::select(denormal, x * V(T(C::denormal_scale())), x));
+                V e = ops::to_float(ops::shift_right(bits, C::mantissa_bits()) - I(C::exponent_bias()));
+                e = e - ops::select(denormal, V(T(C::mantissa_bits())), zero);
+                V m = ops::from_bits((bits & I(C::mantissa_mask())) | I(C::one_bits()));
+                auto big = m > V(T(1.4142135623730951));
+                m = ops::select(big, m * V(T(0.5)), m);
+                e = e + ops::select(big, one, zero);
+                V f = m - one;
+                V s = f / (f + V(T(2)));
+                V p = horner(s * s, T(2), T(2. / 3), T(2. / 5), T(2. / 7));
+                V res = e * V(T(0.693145751953125)) + (e * V(T(1.42860682030941723212e-6)) + s * p);
+                res = ops::select(x == zero, V(-std::numeric_limits<T>::infinity()), res);
+                res = ops::select(x < zero, V(std::numeric_limits<T>::quiet_NaN()), res);
+                res = ops::select(x == V(std::numeric_limits<T>::infinity()), x, res);
+                return ops::select(x != x, x, res);
+            }
+
+            // x = n pi / 2 + r, |r| <= pi / 4; the three parts of pi / 2 have
+            // few enough bits for n * part to be exact when |n| < 2^13
+            template <class V>
+            inline V reduce_half_pi(const V& x, V& quadrant)
+            {
+                using std::floor;
+                using T = typename fast_ops<V>::value_type;
+                V n = floor(x * V(T(0.63661977236758134)) + V(T(0.5)));
+                quadrant = n - V(T(4)) * floor(n * V(T(0.25)));
+                return ((x - n * V(T(1.5703125))) - n * V(T(4.837512969970703125e-4))) - n * V(T(7.54978995489188216e-8));
+            }
+
+            template <class V>
+            inline V sin_kernel(const V& r, const V& r2)
+            {
+                using T = typename fast_ops<V>::value_type;
+                return r + r * r2 * horner(r2, T(-1. / 6), T(1. / 120), T(-1. / 5040));
+            }
+
+            template <class V>
+            inline V cos_kernel(const V& r2)
+            {
+                using T = typename fast_ops<V>::value_type;
+                return horner(r2, T(1), T(-1. / 2), T(1. / 24), T(-1. / 720), T(1. / 40320));
+            }
+
+            template <class V>
+            inline V sin_impl(const V& x)
+            {
+                using ops = fast_ops<V>;
+                using T = typename ops::value_type;
+                V q;
+                V r = reduce_half_pi(x, q);
+                V r2 = r * r;
+                V s = sin_kernel(r, r2);
+                V c = cos_kernel(r2);
+                return ops::select(q == V(T(0)), s, ops::select(q == V(T(1)), c, ops::select(q == V(T(2)), -s, -c)));
+            }
+
+            template <class V>
+            inline V cos_impl(const V& x)
+            {
+                using ops = fast_ops<V>;
+                using T = typename ops::value_type;
+                V q;
+                V r = reduce_half_pi(x, q);
+                V r2 = r * r;
+                V s = sin_kernel(r, r2);
+                V c = cos_kernel(r2);
+                return ops::select(q == V(T(0)), c, ops::select(q == V(T(1)), -s, ops::select(q == V(T(2)), -c, s)));
+            }
+
+            // Taylor polynomial for |x| < 0.4, 1 - 2 / (exp(2 |x|) + 1) otherwise
+            template <class V>
+            inline V tanh_impl(const V& x)
+            {
+                using ops = fast_ops<V>;
+                using T = typename ops::value_type;
+                using std::abs;
+                const V one(T(1));
+                V ax = abs(x);
+                V small = x * horner(x * x, T(1), T(-1. / 3), T(2. / 15), T(-17. / 315), T(62. / 2835));
+                V large = one - V(T(2)) / (exp_impl(ax + ax) + one);
+                large = ops::select(x < V(T(0)), -large, large);
+                return ops::select(ax < V(T(0.4)), small, large);
+            }
+
+            // Taylor polynomial for |x| < 0.5, formula 7.1.26 of Abramowitz and
+            // Stegun otherwise
+            template <class V>
+            inline V erf_impl(const V& x)
+            {
+                using ops = fast_ops<V>;
+                using T = typename ops::value_type;
+                using std::abs;
+                const V one(T(1));
+                V ax = abs(x);
+                V x2 = x * x;
+                V small = x * horner(x2, T(1.1283791670955126), T(-1.1283791670955126 / 3), T(1.1283791670955126 / 10),
+                                     T(-1.1283791670955126 / 42), T(1.1283791670955126 / 216));
+                V t = one / (one + V(T(0.3275911)) * ax);
+                V p = t * horner(t, T(0.254829592), T(-0.284496736), T(1.421413741), T(-1.453152027), T(1.061405429));
+                V large = one - p * exp_impl(-x2);
+                large = ops::select(x < V(T(0)), -large, large);
+                return ops::select(ax < V(T(0.5)), small, large);
+            }
+        }
+
+        /************
+         * functors *
+         ************/
+
+#define XTENSOR_FAST_MATH_FUNCTOR(NAME)                                              \
+    struct NAME##_fun                                                                \
+    {                                                                                \
+        template <class T>                                                           \
+        auto operator()(const T& arg) const                                          \
+        {                                                                            \
+            return detail::NAME##_impl(static_cast<detail::fast_value_t<T>>(arg));   \
+        }                                                                            \
+        template <class B, XTENSOR_REQUIRE<detail::is_fast_simd<B>::value>>          \
+        B simd_apply(const B& arg) const                                             \
+        {                                                                            \
+            return detail::NAME##_impl(arg);                                         \
+        }                                                                            \
+    }
+
+        XTENSOR_FAST_MATH_FUNCTOR(exp);
+        XTENSOR_FAST_MATH_FUNCTOR(log);
+        XTENSOR_FAST_MATH_FUNCTOR(sin);
+        XTENSOR_FAST_MATH_FUNCTOR(cos);
+        XTENSOR_FAST_MATH_FUNCTOR(tanh);
+        XTENSOR_FAST_MATH_FUNCTOR(erf);
+
+#undef XTENSOR_FAST_MATH_FUNCTOR
+
+        /*************
+         * functions *
+         *************/
+
+        /**
+         * @ingroup fast_math_functions
+         * @brief Approximate natural exponential function.
+         *
+         * Returns an \ref xfunction for the element-wise approximate
+         * exponential of \em e. The relative error is below 1e-6. The
+         * result is 0 below -87.3 (-708 for double) and +inf above 88.3
+         * (709 for double); NaN is propagated.
+         * @param e an \ref xexpression
+         * @return an \ref xfunction
+         */
+        template <class E>
+        inline auto exp(E&& e) noexcept
+            -> xt::detail::xfunction_type_t<exp_fun, E>
+        {
+            return xt::detail::make_xfunction<exp_fun>(std::forward<E>(e));
+        }
+
+        /**
+         * @ingroup fast_math_functions
+         * @brief Approximate natural logarithm function.
+         *
+         * Returns an \ref xfunction for the element-wise approximate
+         * natural logarithm of \em e. The relative error is below 1e-6,
+         * denormal numbers included. The result is -inf for 0, +inf for
+         * +inf and NaN for negative numbers and NaN.
+         * @param e an \ref xexpression
+         * @return an \ref xfunction
+         */
+        template <class E>
+        inline auto log(E&& e) noexcept
+            -> xt::detail::xfunction_type_t<log_fun, E>
+        {
+            return xt::detail::make_xfunction<log_fun>(std::forward<E>(e));
+        }
+
+        /**
+         * @ingroup fast_math_functions
+         * @brief Approximate sine function.
+         *
+         * Returns an \ref xfunction for the element-wise approximate sine
+         * of \em e. The absolute error is below 1e-6 for arguments of
+         * magnitude up to 1e4; the range reduction loses accuracy beyond.
+         * @param e an \ref xexpression
+         * @return an \ref xfunction
+         */
+        template <class E>
+        inline auto sin(E&& e) noexcept
+            -> xt::detail::xfunction_type_t<sin_fun, E>
+        {
+            return xt::detail::make_xfunction<sin_fun>(std::forward<E>(e));
+        }
+
+        /**
+         * @ingroup fast_math_functions
+         * @brief Approximate cosine function.
+         *
+         * Returns an \ref xfunction for the element-wise approximate
+         * cosine of \em e. The absolute error is below 1e-6 for arguments
+         * of magnitude up to 1e4; the range reduction loses accuracy beyond.
+         * @param e an \ref xexpression
+         * @return an \ref xfunction
+         */
+        template <class E>
+        inline auto cos(E&& e) noexcept
+            -> xt::detail::xfunction_type_t<cos_fun, E>
+        {
+            return xt::detail::make_xfunction<cos_fun>(std::forward<E>(e));
+        }
+
+        /**
+         * @ingroup fast_math_functions
+         * @brief Approximate hyperbolic tangent function.
+         *
+         * Returns an \ref xfunction for the element-wise approximate
+         * hyperbolic tangent of \em e. The relative error is below 1e-5.
+         * @param e an \ref xexpression
+         * @return an \ref xfunction
+         */
+        template <class E>
+        inline auto tanh(E&& e) noexcept
+            -> xt::detail::xfunction_type_t<tanh_fun, E>
+        {
+            return xt::detail::make_xfunction<tanh_fun>(std::forward<E>(e));
+        }
+
+        /**
+         * @ingroup fast_math_functions
+         * @brief Approximate error function.
+         *
+         * Returns an \ref xfunction for the element-wise approximate error
+         * function of \em e. The relative error is below 1e-5.
+         * @param e an \ref xexpression
+         * @return an \ref xfunction
+         */
+        template <class E>
+        inline auto erf(E&& e) noexcept
+            -> xt::detail::xfunction_type_t<erf_fun, E>
+        {
+            return xt::detail::make_xfunction<erf_fun>(std::forward<E>(e));
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,439 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_FILE_MAPPING_HPP
+#define XTENSOR_FILE_MAPPING_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace xt
+{
+    using namespace std::string_literals;
+
+    /**
+     * Access mode of memory mapped files, see mmap_npy.
+     */
+    enum class mmap_mode
+    {
+        /// the data is shared with the file and must not be modified
+        read_only,
+        /// the data can be modified, the changes are private to the
+        /// process and never written back to the file
+        copy_on_write
+    };
+
+    namespace detail
+    {
+        /****************
+         * file_mapping *
+         ****************/
+
+        // Maps a whole file in memory, the mapping is released upon destruction.
+        class file_mapping
+        {
+        public:
+
+            file_mapping(const std::string& filename, mmap_mode mode);
+            ~file_mapping();
+
+            file_mapping(const file_mapping&) = delete;
+            file_mapping& operator=(const file_mapping&) = delete;
+
+            char* data() const noexcept;
+            std::size_t size() const noexcept;
+
+        private:
+
+            char* p_data;
+            std::size_t m_size;
+#if defined(_WIN32)
+            HANDLE m_file;
+            HANDLE m_mapping;
+#endif
+        };
+
+#if defined(_WIN32)
+        inline file_mapping::file_mapping(const std::string& filename, mmap_mode mode)
+            : p_data(nullptr), m_size(0), m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr)
+        {
+            m_file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                 OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (m_file == INVALID_HANDLE_VALUE)
+            {
+                throw std::runtime_error("IO Error: failed to open file: "s + filename);
+            }
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+            {
+                CloseHandle(m_file);
+                throw std::runtime_error("IO Error: failed to map file: "s + filename);
+            }
+            m_size = static_cast<std::size_t>(size.QuadPart);
+            bool cow = mode == mmap_mode::copy_on_write;
+            m_mapping = CreateFileMappingA(m_file, nullptr, cow ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+            if (m_mapping != nullptr)
+            {
+                p_data = static_cast<char*>(MapViewOfFile(m_mapping, cow ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0));
+            }
+            if (p_data == nullptr)
+            {
+                if (m_mapping != nullptr)
+                {
+                    CloseHandle(m_mapping);
+                }
+                CloseHandle(m_file);
+                throw std::runtime_error("IO Error: failed to map file: "s + filename);
+            }
+        }
+
+        inline file_mapping::~file_mapping()
+        {
+            UnmapViewOfFile(p_data);
+            CloseHandle(m_mapping);
+            CloseHandle(m_file);
+        }
+#else
+        inline file_mapping::file_mapping(const std::string& filename, mmap_mode mode)
+            : p_data(nullptr), m_size(0)
+        {
+            int fd = ::open(filename.c_str(), O_RDONLY);
+            if (fd == -1)
+            {
+                throw std::runtime_error("IO Error: failed to open file: "s + filename);
+            }
+            struct stat st;
+            if (::fstat(fd, &st) == -1 || st.st_size == 0)
+            {
+                ::close(fd);
+                throw std::runtime_error("IO Error: failed to map file: "s + filename);
+            }
+            m_size = static_cast<std::size_t>(st.st_size);
+            // a private mapping can be written even though the file is opened read-only
+            bool cow = mode == mmap_mode::copy_on_write;
+            void* addr = ::mmap(nullptr, m_size, cow ? PROT_READ | PROT_WRITE : PROT_READ,
+                                cow ? MAP_PRIVATE : MAP_SHARED, fd, 0);
+            // the mapping stays valid after the file descriptor is closed
+            ::close(fd);
+            if (addr == MAP_FAILED)
+            {
+                throw std::runtime_error("IO Error: failed to map file: "s + filename);
+            }
+            p_data = static_cast<char*>(addr);
+        }
+
+        inline file_mapping::~file_mapping()
+        {
+            ::munmap(p_data, m_size);
+        }
+#endif
+
+        inline char* file_mapping::data() const noexcept
+        {
+            return p_data;
+        }
+
+        inline std::size_t file_mapping::size() const noexcept
+        {
+            return m_size;
+        }
+
+        /*************************
+         * shared_memory_mapping *
+         *************************/
+
+        // Maps a named shared memory object, either created with a given size
+        // and mapped for writing, or opened and mapped read-only. The mapping
+        // is released upon destruction, the object itself lives until it is
+        // removed with remove_shared_memory.
+        class shared_memory_mapping
+        {
+        public:
+
+            shared_memory_mapping(const std::string& name, std::size_t size);
+            explicit shared_memory_mapping(const std::string& name);
+            ~shared_memory_mapping();
+
+            shared_memory_mapping(const shared_memory_mapping&) = delete;
+            shared_memory_mapping& operator=(const shared_memory_mapping&) = delete;
+
+            char* data() const noexcept;
+            std::size_t size() const noexcept;
+
+        private:
+
+            char* p_data;
+            std::size_t m_size;
+#if defined(_WIN32)
+            HANDLE m_mapping;
+#endif
+        };
+
+#if defined(_WIN32)
+        inline shared_memory_mapping::shared_memory_mapping(const std::string& name, std::size_t size)
+            : p_data(nullptr), m_size(size), m_mapping(nullptr)
+        {
+            unsigned long long s = static_cast<unsigned long long>(size);
+            m_mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                           static_cast<DWORD>(s >> 32), static_cast<DWORD>(s & 0xffffffffULL),
+                                           name.c_str());
+            if (m_mapping == nullptr || GetLastError() == ERROR_ALREADY_EXISTS)
+            {
+                if (m_mapping != nullptr)
+                {
+                    CloseHandle(m_mapping);
+                }
+                throw std::runtime_error("IO Error: failed to create shared memory: "s + name);
+            }
+            p_data = static_cast<char*>(MapViewOfFile(m_mapping, FILE_MAP_WRITE, 0, 0, size));
+            if (p_data == nullptr)
+            {
+                CloseHandle(m_mapping);
+                throw std::runtime_error("IO Error: failed to map shared memory: "s + name);
+            }
+        }
+
+        inline shared_memory_mapping::shared_memory_mapping(const std::string& name)
+            : p_data(nullptr), m_size(0), m_mapping(nullptr)
+        {
+            m_mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+            if (m_mapping == nullptr)
+            {
+                throw std::runtime_error("IO Error: failed to open shared memory: "s + name);
+            }
+            p_data = static_cast<char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+            MEMORY_BASIC_INFORMATION info;
+            if (p_data == nullptr || VirtualQuery(p_data, &info, sizeof(info)) == 0)
+            {
+                if (p_data != nullptr)
+                {
+                    UnmapViewOfFile(p_data);
+                }
+                CloseHandle(m_mapping);
+                throw std::runtime_error("IO Error: failed to map shared memory: "s + name);
+            }
+            // the size of the view is rounded up to the page size
+            m_size = static_cast<std::size_t>(info.RegionSize);
+        }
+
+        inline shared_memory_mapping::~shared_memory_mapping()
+        {
+            UnmapViewOfFile(p_data);
+            CloseHandle(m_mapping);
+        }
+
+        // the object is destroyed with its last handle, there is nothing to remove
+        inline void remove_shared_memory(const std::string&)
+        {
+        }
+#else
+        // POSIX names start with a single slash
+        inline std::string shared_memory_name(const std::string& name)
+        {
+            return !name.empty() && name[0] == '/' ? name : "/"s + name;
+        }
+
+        inline shared_memory_mapping::shared_memory_mapping(const std::string& name, std::size_t size)
+            : p_data(nullptr), m_size(size)
+        {
+            std::string shm_name = shared_memory_name(name);
+            int fd = ::shm_open(shm_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+            if (fd == -1)
+            {
+                throw std::runtime_error("IO Error: failed to create shared memory: "s + name);
+            }
+            void* addr = MAP_FAILED;
+            if (::ftruncate(fd, static_cast<off_t>(size)) == 0)
+            {
+                addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            }
+            ::close(fd);
+            if (addr == MAP_FAILED)
+            {
+                ::shm_unlink(shm_name.c_str());
+                throw std::runtime_error("IO Error: failed to map shared memory: "s + name);
+            }
+            p_data = static_cast<char*>(addr);
+        }
+
+        inline shared_memory_mapping::shared_memory_mapping(const std::string& name)
+            : p_data(nullptr), m_size(0)
+        {
+            int fd = ::shm_open(shared_memory_name(name).c_str(), O_RDONLY, 0);
+            if (fd == -1)
+            {
+                throw std::runtime_error("IO Error: failed to open shared memory: "s + name);
+            }
+            struct stat st;
+            if (::fstat(fd, &st) == -1 || st.st_size == 0)
+            {
+                ::close(fd);
+                throw std::runtime_error("IO Error: failed to map shared memory: "s + name);
+            }
+            m_size = static_cast<std::size_t>(st.st_size);
+            void* addr = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (addr == MAP_FAILED)
+            {
+                throw std::runtime_error("IO Error: failed to map shared memory: "s + name);
+            }
+            p_data = static_cast<char*>(addr);
+        }
+
+        inline shared_memory_mapping::~shared_memory_mapping()
+        {
+            ::munmap(p_data, m_size);
+        }
+
+        // the object is removed once the processes mapping it have unmapped it
+        inline void remove_shared_memory(const std::string& name)
+        {
+            if (::shm_unlink(shared_memory_name(name).c_str()) == -1)
+            {
+                throw std::runtime_error("IO Error: failed to remove shared memory: "s + name);
+            }
+        }
+#endif
+
+        inline char* shared_memory_mapping::data() const noexcept
+        {
+            return p_data;
+        }
+
+        inline std::size_t shared_memory_mapping::size() const noexcept
+        {
+            return m_size;
+        }
+
+        /*********************
+         * mapping_allocator *
+         *********************/
+
+        // Allocator of the buffer adaptors over mapped memory (see mmap_npy):
+        // the mapping is released when the mapped buffer is deallocated, buffers
+        // allocated later on (e.g. when the adaptor is resized) live on the heap.
+        template <class T>
+        class mapping_allocator
+        {
+        public:
+
+            using value_type = T;
+            using pointer = T*;
+            using const_pointer = const T*;
+            using reference = T&;
+            using const_reference = const T&;
+            using size_type = std::size_t;
+            using difference_type = std::ptrdiff_t;
+
+            template <class U>
+            struct rebind
+            {
+                using other = mapping_allocator<U>;
+            };
+
+            mapping_allocator() = default;
+            mapping_allocator(std::shared_ptr<void> mapping, pointer mapped) noexcept;
+
+            template <class U>
+            mapping_allocator(const mapping_allocator<U>& rhs) noexcept;
+
+            pointer allocate(size_type n);
+            void deallocate(pointer p, size_type n);
+
+            template <class U, class... Args>
+            void construct(U* p, Args&&... args);
+
+            template <class U>
+            void destroy(U* p);
+
+        private:
+
+            std::shared_ptr<void> m_mapping;
+            pointer p_mapped = nullptr;
+
+            template <class U>
+            friend class mapping_allocator;
+        };
+
+        template <class T>
+        inline mapping_allocator<T>::mapping_allocator(std::shared_ptr<void> mapping, pointer mapped) noexcept
+            : m_mapping(std::move(mapping)), p_mapped(mapped)
+        {
+        }
+
+        template <class T>
+        template <class U>
+        inline mapping_allocator<T>::mapping_allocator(const mapping_allocator<U>&) noexcept
+        {
+        }
+
+        template <class T>
+        inline auto mapping_allocator<T>::allocate(size_type n) -> pointer
+        {
+            return std::allocator<T>().allocate(n);
+        }
+
+        template <class T>
+        inline void mapping_allocator<T>::deallocate(pointer p, size_type n)
+        {
+            if (m_mapping != nullptr && p == p_mapped)
+            {
+                m_mapping.reset();
+                p_mapped = nullptr;
+            }
+            else
+            {
+                std::allocator<T>().deallocate(p, n);
+            }
+        }
+
+        template <class T>
+        template <class U, class... Args>
+        inline void mapping_allocator<T>::construct(U* p, Args&&... args)
+        {
+            new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+        }
+
+        template <class T>
+        template <class U>
+        inline void mapping_allocator<T>::destroy(U* p)
+        {
+            p->~U();
+        }
+
+        template <class T>
+        inline bool operator==(const mapping_allocator<T>&, const mapping_allocator<T>&) noexcept
+        {
+            return true;
+        }
+
+        template <class T>
+        inline bool operator!=(const mapping_allocator<T>&, const mapping_allocator<T>&) noexcept
+        {
+            return false;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,765 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_FORMAT_HPP
+#define XTENSOR_FORMAT_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace xt
+{
+    namespace detail
+    {
+        /*********************
+         * number formatting *
+         *********************/
+
+        // The functions below format numbers into character buffers without
+        // going through the locale machinery of std::ostream, which dominates
+        // the cost of writing large tensors.
+
+        // Upper bound of the length of a number formatted by format_integer,
+        // or by format_float with a precision of at most max_format_precision.
+        constexpr std::size_t max_format_length = 64;
+        constexpr int max_format_precision = 40;
+
+        template <class T>
+        struct format_float_traits;
+
+        template <>
+        struct format_float_traits<float>
+        {
+            // unsigned integer holding the bits of the value, used by the
+            // shortest representation
+            using bits_type = std::uint32_t;
+
+            static int print(char* buffer, std::size_t size, const char* conversion, int width, int precision, float value)
+            {
+                return std::snprintf(buffer, size, conversion, width, precision, double(value));
+            }
+
+            static float parse(const char* str)
+            {
+                return std::strtof(str, nullptr);
+            }
+        };
+
+        template <>
+        struct format_float_traits<double>
+        {
+            using bits_type = std::uint64_t;
+
+            static int print(char* buffer, std::size_t size, const char* conversion, int width, int precision, double value)
+            {
+                return std::snprintf(buffer, size, conversion, width, precision, value);
+            }
+
+            static double parse(const char* str)
+            {
+                return std::strtod(str, nullptr);
+            }
+        };
+
+        template <>
+        struct format_float_traits<long double>
+        {
+            // the shortest representation of long double is searched with printf
+            using bits_type = void;
+
+            static int print(char* buffer, std::size_t size, const char* conversion, int width, int precision, long double value)
+            {
+                // conversion is a double conversion, e.g. "%*.*g"
+                char long_conversion[8] = {'%', '*', '.', '*', 'L', conversion[4], '\0'};
+                return std::snprintf(buffer, size, long_conversion, width, precision, value);
+            }
+
+            static long double parse(const char* str)
+            {
+                return std::strtold(str, nullptr);
+            }
+        };
+
+        /**
+         * Writes the decimal representation of the integer \c value at \c out
+         * and returns the end of the written characters.
+         */
+        template <class T>
+        inline char* format_integer(char* out, T value)
+        {
+            using unsigned_type = std::make_unsigned_t<std::conditional_t<std::is_same<T, bool>::value, unsigned char, T>>;
+            unsigned_type u = static_cast<unsigned_type>(value);
+            if (std::is_signed<T>::value && value < T(0))
+            {
+                *out++ = '-';
+                u = unsigned_type(unsigned_type(0) - u);
+            }
+            char digits[24];
+            char* d = digits;
+            do
+            {
+                *d++ = static_cast<char>('0' + u % 10);
+                u = static_cast<unsigned_type>(u / 10);
+            } while (u != 0);
+            while (d != digits)
+            {
+                *out++ = *--d;
+            }
+            return out;
+        }
+
+        /******************************************
+         * shortest representation of float data *
+         ******************************************/
+
+        // Grisu2 algorithm of F. Loitsch, "Printing Floating-Point Numbers
+        // Quickly and Accurately with Integers" (PLDI 2010): the digits of the
+        // value are generated with 64-bit integers only, and the result is
+        // the shortest representation read back as the value in more than
+        // 99.9% of the cases; the others have one extra digit.
+
+        namespace grisu
+        {
+            struct diyfp
+            {
+                std::uint64_t f;
+                int e;
+            };
+
+            inline diyfp sub(const diyfp& x, const diyfp& y)
+            {
+                return {x.f - y.f, x.e};
+            }
+
+            // product of the significands rounded to 64 bits
+            inline diyfp mul(const diyfp& x, const diyfp& y)
+            {
+                const std::uint64_t u_lo = x.f & 0xFFFFFFFFu;
+                const std::uint64_t u_hi = x.f >> 32u;
+                const std::uint64_t v_lo = y.f & 0xFFFFFFFFu;
+                const std::uint64_t v_hi = y.f >> 32u;
+                const std::uint64_t p0 = u_lo * v_lo;
+                const std::uint64_t p1 = u_lo * v_hi;
+                const std::uint64_t p2 = u_hi * v_lo;
+                const std::uint64_t p3 = u_hi * v_hi;
+                std::uint64_t q = (p0 >> 32u) + (p1 & 0xFFFFFFFFu) + (p2 & 0xFFFFFFFFu);
+                q += std::uint64_t(1) << 31u;
+                const std::uint64_t h = p3 + (p2 >> 32u) + (p1 >> 32u) + (q >> 32u);
+                return {h, x.e + y.e + 64};
+            }
+
+            inline diyfp normalize(diyfp x)
+            {
+                while ((x.f >> 63u) == 0)
+                {
+                    x.f <<= 1u;
+                    x.e--;
+                }
+                return x;
+            }
+
+            inline diyfp normalize_to(const diyfp& x, int target_exponent)
+            {
+                return {x.f << static_cast<unsigned>(x.e - target_exponent), target_exponent};
+            }
+
+            struct boundaries
+            {
+                diyfp w;
+                diyfp minus;
+                diyfp plus;
+            };
+
+            // the value and the boundaries of its rounding interval, with
+            // the same exponent
+            template <class T>
+            inline boundaries compute_boundaries(T value)
+            {
+                using bits_type = typename format_float_traits<T>::bits_type;
+                constexpr int precision = std::numeric_limits<T>::digits;
+                constexpr int bias = std::numeric_limits<T>::max_exponent - 1 + (precision - 1);
+                constexpr int min_exponent = 1 - bias;
+                constexpr std::uint64_t hidden_bit = std::uint64_t(1) << (precision - 1);
+
+                bits_type bits;
+                std::memcpy(&bits, &value, sizeof(T));
+                const std::uint64_t biased_exponent = std::uint64_t(bits) >> (precision - 1);
+                const std::uint64_t fraction = std::uint64_t(bits) & (hidden_bit - 1);
+
+                const diyfp v = biased_exponent == 0
+                    ? diyfp{fraction, min_exponent}
+                    : diyfp{fraction + hidden_bit, static_cast<int>(biased_exponent) - bias};
+                const bool lower_boundary_is_closer = fraction == 0 && biased_exponent > 1;
+                const diyfp m_plus = {2 * v.f + 1, v.e - 1};
+                const diyfp m_minus = lower_boundary_is_closer ? diyfp{4 * v.f - 1, v.e - 2}
+                                                               : diyfp{2 * v.f - 1, v.e - 1};
+                const diyfp w_plus = normalize(m_plus);
+                const diyfp w_minus = normalize_to(m_minus, w_plus.e);
+                return {normalize(v), w_minus, w_plus};
+            }
+
+            struct cached_power
+            {
+                std::uint64_t f;
+                int e;
+                int k;
+            };
+
+            constexpr int cached_powers_min_exponent = -300;
+            constexpr int cached_powers_step = 8;
+            constexpr std::size_t cached_powers_size = 79;
+
+            // Big unsigned integer with the few operations needed to compute
+            // the cached powers of ten.
+            class bignum
+            {
+            public:
+
+                explicit bignum(std::uint32_t value)
+                    : m_limbs(1, value)
+                {
+                }
+
+                void multiply(std::uint32_t factor)
+                {
+                    std::uint64_t carry = 0;
+                    for (auto& limb : m_limbs)
+                    {
+                        carry += std::uint64_t(limb) * factor;
+                        limb = static_cast<std::uint32_t>(carry);
+                        carry >>= 32u;
+                    }
+                    if (carry != 0)
+                    {
+                        m_limbs.push_back(static_cast<std::uint32_t>(carry));
+                    }
+                }
+
+                void shift_left()
+                {
+                    std::uint32_t carry = 0;
+                    for (auto& limb : m_limbs)
+                    {
+                        std::uint32_t next = limb >> 31u;
+                        limb = (limb << 1u) | carry;
+                        carry = next;
+                    }
+                    if (carry != 0)
+                    {
+                        m_limbs.push_back(carry);
+                    }
+                }
+
+                void subtract(const bignum& rhs)
+                {
+                    std::int64_t borrow = 0;
+                    for (std::size_t i = 0; i < m_limbs.size(); ++i)
+                    {
+                        std::int64_t d = std::int64_t(m_limbs[i]) - borrow - (i < rhs.m_limbs.size() ? std::int64_t(rhs.m_limbs[i]) : 0);
+                        borrow = d < 0 ? 1 : 0;
+                        m_limbs[i] = static_cast<std::uint32_t>(d + (borrow << 32));
+                    }
+                    trim();
+                }
+
+                bool less(const bignum& rhs) const
+                {
+                    if (m_limbs.size() != rhs.m_limbs.size())
+                    {
+                        return m_limbs.size() < rhs.m_limbs.size();
+                    }
+                    for (std::size_t i = m_limbs.size(); i-- > 0;)
+                    {
+                        if (m_limbs[i] != rhs.m_limbs[i])
+                        {
+                            return m_limbs[i] < rhs.m_limbs[i];
+                        }
+                    }
+                    return false;
+                }
+
+                int bit_length() const
+                {
+                    int n = 32 * static_cast<int>(m_limbs.size() - 1);
+                    for (std::uint32_t top = m_limbs.back(); top != 0; top >>= 1u)
+                    {
+                        ++n;
+                    }
+                    return n;
+                }
+
+                bool bit(int i) const
+                {
+                    return ((m_limbs[std::size_t(i / 32)] >> unsigned(i % 32)) & 1u) != 0;
+                }
+
+            private:
+
+                void trim()
+                {
+                    while (m_limbs.size() > 1 && m_limbs.back() == 0)
+                    {
+                        m_limbs.pop_back();
+                    }
+                }
+
+                std::vector<std::uint32_t> m_limbs;
+            };
+
+            // 10^k = f * 2^e, with f normalized and rounded to 64 bits
+            inline cached_power compute_power(int k)
+            {
+                bignum p(1);
+                for (int i = 0; i < (k < 0 ? -k : k); ++i)
+                {
+                    p.multiply(10);
+                }
+                std::uint64_t f = 0;
+                int e = 0;
+                bool round_up = false;
+                if (k >= 0)
+                {
+                    int n = p.bit_length();
+                    for (int i = n - 1; i >= n - 64 && i >= 0; --i)
+                    {
+                        f = (f << 1u) | (p.bit(i) ? 1u : 0u);
+                    }
+                    e = n - 64;
+                    if (n < 64)
+                    {
+                        f <<= unsigned(64 - n);
+                    }
+                    round_up = n > 64 && p.bit(n - 65);
+                }
+                else
+                {
+                    // long division of 1 by 10^-k, bit by bit
+                    bignum r(1);
+                    int shift = 0;
+                    while (r.less(p))
+                    {
+                        r.shift_left();
+                        ++shift;
+                    }
+                    for (int i = 0; i < 65; ++i)
+                    {
+                        bool b = !r.less(p);
+                        if (b)
+                        {
+                            r.subtract(p);
+                        }
+                        if (i < 64)
+                        {
+                            f = (f << 1u) | (b ? 1u : 0u);
+                        }
+                        else
+                        {
+                            round_up = b;
+                        }
+                        r.shift_left();
+                    }
+                    e = -shift - 63;
+                }
+                if (round_up && ++f == 0)
+                {
+                    f = std::uint64_t(1) << 63u;
+                    ++e;
+                }
+                return {f, e, k};
+            }
+
+            inline const std::vector<cached_power>& cached_powers()
+            {
+                static const std::vector<cached_power> powers = []()
+                {
+                    std::vector<cached_power> res;
+                    res.reserve(cached_powers_size);
+                    for (std::size_t i = 0; i < cached_powers_size; ++i)
+                    {
+                        res.push_back(compute_power(cached_powers_min_exponent + cached_powers_step * int(i)));
+                    }
+                    return res;
+                }();
+                return powers;
+            }
+
+            // The scaled significands have a binary exponent in [alpha, gamma],
+            // which lets the digit generation work on 32-bit integral parts.
+            constexpr int alpha = -60;
+            constexpr int gamma = -32;
+
+            inline const cached_power& get_cached_power(int e)
+            {
+                // smallest k such that alpha <= e + e_c(k) + 64
+                const int f = alpha - e - 1;
+                const int k = (f * 78913) / (1 << 18) + (f > 0 ? 1 : 0);
+                const std::size_t index = static_cast<std::size_t>(-cached_powers_min_exponent + k + (cached_powers_step - 1)) /
+                                          cached_powers_step;
+                return cached_powers()[index];
+            }
+
+            inline int find_largest_pow10(std::uint32_t n, std::uint32_t& pow10)
+            {
+                int digits = 1;
+                pow10 = 1;
+                while (digits < 10 && n / pow10 >= 10)
+                {
+                    pow10 *= 10;
+                    ++digits;
+                }
+                return digits;
+            }
+
+            inline void round_digits(char* buffer, int length, std::uint64_t dist, std::uint64_t delta,
+                                     std::uint64_t rest, std::uint64_t ten_k)
+            {
+                // moves the last digit towards the value while the
+                // result stays in the rounding interval
+                while (rest < dist && delta - rest >= ten_k &&
+                       (rest + ten_k < dist || dist - rest > rest + ten_k - dist))
+                {
+                    buffer[length - 1]--;
+                    rest += ten_k;
+                }
+            }
+
+            inline void generate_digits(char* buffer, int& length, int& decimal_exponent,
+                                        diyfp m_minus, diyfp w, diyfp m_plus)
+            {
+                std::uint64_t delta = sub(m_plus, m_minus).f;
+                std::uint64_t dist = sub(m_plus, w).f;
+                const unsigned shift = static_cast<unsigned>(-m_plus.e);
+                const std::uint64_t one = std::uint64_t(1) << shift;
+
+                std::uint32_t p1 = static_cast<std::uint32_t>(m_plus.f >> shift);
+                std::uint64_t p2 = m_plus.f & (one - 1);
+
+                std::uint32_t pow10;
+                int n = find_largest_pow10(p1, pow10);
+                while (n > 0)
+                {
+                    const std::uint32_t d = p1 / pow10;
+                    p1 = p1 % pow10;
+                    buffer[length++] = static_cast<char>('0' + d);
+                    --n;
+                    const std::uint64_t rest = (std::uint64_t(p1) << shift) + p2;
+                    if (rest <= delta)
+                    {
+                        decimal_exponent += n;
+                        round_digits(buffer, length, dist, delta, rest, std::uint64_t(pow10) << shift);
+                        return;
+                    }
+                    pow10 /= 10;
+                }
+
+                int m = 0;
+                while (true)
+                {
+                    p2 *= 10;
+                    const std::uint64_t d = p2 >> shift;
+                    p2 &= one - 1;
+                    buffer[length++] = static_cast<char>('0' + d);
+                    ++m;
+                    delta *= 10;
+                    dist *= 10;
+                    if (p2 <= delta)
+                    {
+                        break;
+                    }
+                }
+                decimal_exponent -= m;
+                round_digits(buffer, length, dist, delta, p2, one);
+            }
+
+            // writes the digits of the positive finite value, which is
+            // then equal to digits * 10^decimal_exponent
+            template <class T>
+            inline int shortest_digits(char* buffer, int& decimal_exponent, T value)
+            {
+                const boundaries b = compute_boundaries(value);
+                const cached_power& cached = get_cached_power(b.plus.e);
+                const diyfp c = {cached.f, cached.e};
+                const diyfp w = mul(b.w, c);
+                const diyfp w_minus = mul(b.minus, c);
+                const diyfp w_plus = mul(b.plus, c);
+                // the products are exact within one ulp, the interval is
+                // shrunk accordingly
+                const diyfp m_minus = {w_minus.f + 1, w_minus.e};
+                const diyfp m_plus = {w_plus.f - 1, w_plus.e};
+                int length = 0;
+                decimal_exponent = -cached.k;
+                generate_digits(buffer, length, decimal_exponent, m_minus, w, m_plus);
+                return length;
+            }
+
+            // lays out the digits like printf("%g") does, in fixed notation
+            // for decimal exponents in [-4, digits10]
+            template <class T>
+            inline char* format_digits(char* out, const char* digits, int length, int decimal_exponent)
+            {
+                constexpr int max_fixed_exponent = std::numeric_limits<T>::digits10;
+                const int n = length + decimal_exponent;
+                if (decimal_exponent >= 0 && n <= max_fixed_exponent)
+                {
+                    out = std::copy(digits, digits + length, out);
+                    return std::fill_n(out, decimal_exponent, '0');
+                }
+                if (0 < n && n <= max_fixed_exponent)
+                {
+                    out = std::copy(digits, digits + n, out);
+                    *out++ = '.';
+                    return std::copy(digits + n, digits + length, out);
+                }
+                if (-4 < n && n <= 0)
+                {
+                    *out++ = '0';
+                    *out++ = '.';
+                    out = std::fill_n(out, -n, '0');
+                    return std::copy(digits, digits + length, out);
+                }
+                *out++ = digits[0];
+                if (length > 1)
+                {
+                    *out++ = '.';
+                    out = std::copy(digits + 1, digits + length, out);
+                }
+                *out++ = 'e';
+                int exponent = n - 1;
+                *out++ = exponent < 0 ? '-' : '+';
+                exponent = exponent < 0 ? -exponent : exponent;
+                if (exponent < 10)
+                {
+                    *out++ = '0';
+                }
+                return format_integer(out, exponent);
+            }
+        }
+
+        template <class T>
+        inline char* format_shortest(char* out, T value, std::false_type /*printf*/)
+        {
+            using traits = format_float_traits<T>;
+            int n = 0;
+            for (int p = std::numeric_limits<T>::digits10; p <= std::numeric_limits<T>::max_digits10; ++p)
+            {
+                n = traits::print(out, max_format_length, "%*.*g", 0, p, value);
+                if (traits::parse(out) == value)
+                {
+                    break;
+                }
+            }
+            return out + n;
+        }
+
+        template <class T>
+        inline char* format_shortest(char* out, T value, std::true_type /*grisu*/)
+        {
+            char digits[24];
+            int decimal_exponent = 0;
+            int length = grisu::shortest_digits(digits, decimal_exponent, value);
+            return grisu::format_digits<T>(out, digits, length, decimal_exponent);
+        }
+
+        /**
+         * Writes the floating point \c value at \c out and returns the end of
+         * the written characters. A negative \c precision gives the shortest
+         * representation that is read back as \c value, otherwise the value is
+         * formatted like std::ostream does with the given precision.
+         */
+        template <class T>
+        inline char* format_float(char* out, T value, int precision = -1)
+        {
+            using traits = format_float_traits<T>;
+            constexpr std::size_t size = max_format_length;
+            if (precision >= 0)
+            {
+                precision = precision > max_format_precision ? max_format_precision : precision;
+                return out + traits::print(out, size, "%*.*g", 0, precision, value);
+            }
+            if (std::isnan(value))
+            {
+                return std::copy_n("nan", 3, out);
+            }
+            if (std::signbit(value))
+            {
+                *out++ = '-';
+                value = -value;
+            }
+            if (std::isinf(value))
+            {
+                return std::copy_n("inf", 3, out);
+            }
+            if (value == T(0))
+            {
+                *out = '0';
+                return out + 1;
+            }
+            return format_shortest(out, value, std::integral_constant<bool, !std::is_void<typename traits::bits_type>::value>());
+        }
+
+        /**
+         * Appends \c value formatted with the \c printf \c conversion (e.g.
+         * "%*.*f" or "%*.*e") and the given width and precision to \c out.
+         */
+        template <class T>
+        inline void format_printf(std::string& out, const char* conversion, int width, int precision, T value)
+        {
+            using traits = format_float_traits<T>;
+            std::size_t offset = out.size();
+            out.resize(offset + max_format_length);
+            int n = traits::print(&out[offset], max_format_length, conversion, width, precision, value);
+            if (n >= int(max_format_length))
+            {
+                out.resize(offset + std::size_t(n) + 1);
+                traits::print(&out[offset], std::size_t(n) + 1, conversion, width, precision, value);
+            }
+            out.resize(offset + std::size_t(n));
+        }
+
+        template <class T>
+        using is_formatted_integer = std::integral_constant<bool, std::is_integral<T>::value &&
+                                                                      !std::is_same<T, char>::value &&
+                                                                      !std::is_same<T, signed char>::value &&
+                                                                      !std::is_same<T, unsigned char>::value>;
+
+        /*****************
+         * format_buffer *
+         *****************/
+
+        /**
+         * Buffer formatting numbers in a reusable block of memory which is
+         * written to a stream when it is full, upon flush and upon destruction.
+         * The types that have no fast formatting (characters, user types) are
+         * written with the operator<< of the stream.
+         */
+        class format_buffer
+        {
+        public:
+
+            explicit format_buffer(std::ostream& out, std::size_t capacity = 65536);
+            ~format_buffer();
+
+            format_buffer(const format_buffer&) = delete;
+            format_buffer& operator=(const format_buffer&) = delete;
+
+            void put(char c);
+            void write(const char* str, std::size_t n);
+
+            template <class T>
+            void format(const T& value, int precision = -1);
+
+            void flush();
+
+        private:
+
+            char* reserve(std::size_t n);
+
+            template <class T>
+            void format_impl(const T& value, int precision, std::true_type /*integer*/, std::false_type);
+            template <class T>
+            void format_impl(const T& value, int precision, std::false_type, std::true_type /*floating*/);
+            template <class T>
+            void format_impl(const T& value, int precision, std::false_type, std::false_type);
+
+            std::ostream& m_out;
+            std::vector<char> m_buffer;
+            std::size_t m_size;
+        };
+
+        /********************************
+         * format_buffer implementation *
+         ********************************/
+
+        inline format_buffer::format_buffer(std::ostream& out, std::size_t capacity)
+            : m_out(out), m_buffer(capacity < 2 * max_format_length ? 2 * max_format_length : capacity), m_size(0)
+        {
+        }
+
+        inline format_buffer::~format_buffer()
+        {
+            flush();
+        }
+
+        inline void format_buffer::put(char c)
+        {
+            *reserve(1) = c;
+            ++m_size;
+        }
+
+        inline void format_buffer::write(const char* str, std::size_t n)
+        {
+            if (n > m_buffer.size())
+            {
+                flush();
+                m_out.write(str, static_cast<std::streamsize>(n));
+            }
+            else
+            {
+                std::copy(str, str + n, reserve(n));
+                m_size += n;
+            }
+        }
+
+        template <class T>
+        inline void format_buffer::format(const T& value, int precision)
+        {
+            format_impl(value, precision, is_formatted_integer<T>(), std::is_floating_point<T>());
+        }
+
+        inline void format_buffer::flush()
+        {
+            if (m_size != 0)
+            {
+                m_out.write(m_buffer.data(), static_cast<std::streamsize>(m_size));
+                m_size = 0;
+            }
+        }
+
+        inline char* format_buffer::reserve(std::size_t n)
+        {
+            if (m_size + n > m_buffer.size())
+            {
+                flush();
+            }
+            return m_buffer.data() + m_size;
+        }
+
+        template <class T>
+        inline void format_buffer::format_impl(const T& value, int, std::true_type, std::false_type)
+        {
+            char* first = reserve(max_format_length);
+            m_size += static_cast<std::size_t>(format_integer(first, value) - first);
+        }
+
+        template <class T>
+        inline void format_buffer::format_impl(const T& value, int precision, std::false_type, std::true_type)
+        {
+            char* first = reserve(max_format_length);
+            m_size += static_cast<std::size_t>(format_float(first, value, precision) - first);
+        }
+
+        template <class T>
+        inline void format_buffer::format_impl(const T& value, int, std::false_type, std::false_type)
+        {
+            flush();
+            m_out << value;
+        }
+    }
+}
+
+#endif
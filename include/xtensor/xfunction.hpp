@@ -140,6 +140,66 @@ namespace xt
             using type = T;
         };
 
+        // Checks that simd_apply of F accepts the batches returned by
+        // load_simd<align, R> of the arguments CT
+        template <class F, class R, class T, class = void>
+        struct has_simd_call : std::false_type
+        {
+        };
+
+        template <class F, class R, class... CT>
+        struct has_simd_call<F, R, std::tuple<CT...>,
+                             void_t<decltype(std::declval<const F&>().simd_apply(
+                                 std::declval<xsimd::simd_return_type<xvalue_type_t<std::decay_t<CT>>, R>>()...))>>
+            : std::true_type
+        {
+        };
+
+        // the arguments of a comparison are loaded as batches of their common type
+        template <class... CT>
+        struct simd_comparison_common_type
+        {
+            using type = std::common_type_t<xvalue_type_t<std::decay_t<CT>>...>;
+        };
+
+        template <class F, class... CT>
+        struct has_simd_comparison_call
+            : has_simd_call<F, typename simd_comparison_common_type<CT...>::type, std::tuple<CT...>>
+        {
+        };
+
+        template <class V>
+        struct has_simd_arithmetic_type
+            : xtl::conjunction<std::is_arithmetic<V>, has_simd_type<V>>
+        {
+        };
+
+        // Boolean expressions that can be loaded as batches of booleans of the
+        // type V: boolean storage, and comparisons of elements of type V
+        template <class E, class V, class = void>
+        struct is_simd_condition : std::false_type
+        {
+        };
+
+        template <class E, class V>
+        struct is_simd_condition<E, V, std::enable_if_t<std::is_same<decltype(std::declval<const E&>().data()), const bool*>::value>>
+            : std::true_type
+        {
+        };
+
+        template <class F, class... CT, class V>
+        struct is_simd_condition<xfunction<F, CT...>, V, void>
+            : std::is_same<typename xfunction<F, CT...>::simd_meta_getter::simd_comparison_type, V>
+        {
+        };
+
+        template <class E, class V>
+        struct is_simd_condition_argument
+            : xtl::disjunction<has_simd_type<xvalue_type_t<E>>,
+                               xtl::conjunction<std::is_same<xvalue_type_t<E>, bool>, is_simd_condition<E, V>>>
+        {
+        };
+
         // This meta struct checks wether SIMD should be activated for our 
         // functor "F"
         template <class V, class F, class... CT>
@@ -150,15 +210,48 @@ namespace xt
             // check if all arguments are supported by SIMD
             using simd_arguments_exist = xtl::conjunction<has_simd_type<scalar_result_type>,
                                                           has_simd_type<xvalue_type_t<std::decay_t<CT>>>...>;
+
+            // conditions (e.g. of where) do not have a simd type on their own, but are
+            // loaded as batches of booleans of the result type
+            using simd_condition_arguments_exist = xtl::conjunction<has_simd_type<scalar_result_type>,
+                                                                    xtl::disjunction<std::is_same<xvalue_type_t<std::decay_t<CT>>, bool>...>,
+                                                                    is_simd_condition_argument<std::decay_t<CT>, scalar_result_type>...>;
+
+            // comparisons only provide batches of booleans to an enclosing function
+            using simd_comparison_arguments_exist = xtl::conjunction<std::integral_constant<bool, sizeof...(CT) != 0>,
+                                                                     std::is_same<scalar_result_type, bool>,
+                                                                     has_simd_arithmetic_type<xvalue_type_t<std::decay_t<CT>>>...>;
+
             // if yes, insert correct type here
-            using simd_value_type = xtl::mpl::eval_if_t<simd_arguments_exist,
+            using simd_value_type = xtl::mpl::eval_if_t<xtl::disjunction<simd_arguments_exist, simd_condition_arguments_exist>,
                                                         meta_identity<xsimd::simd_type<scalar_result_type>>,
                                                         make_invalid_type<>>;
             // if all types are supported, check that the functor has a working 
             // simd_apply and all arguments have the simd interface
-            using use_xsimd = xtl::conjunction<simd_arguments_exist,
-                                               has_simd_apply<F, scalar_result_type>,
-                                               has_simd_interface<std::decay_t<CT>>...>;
+            using use_xsimd_batches = xtl::conjunction<simd_arguments_exist,
+                                                       has_simd_apply<F, scalar_result_type>,
+                                                       has_simd_interface<std::decay_t<CT>>...>;
+
+            using use_xsimd_conditions = xtl::conjunction<xtl::negation<simd_arguments_exist>,
+                                                          simd_condition_arguments_exist,
+                                                          has_simd_interface<std::decay_t<CT>>...,
+                                                          has_simd_call<F, scalar_result_type, std::tuple<CT...>>>;
+
+            using use_xsimd_comparisons = xtl::conjunction<xtl::negation<simd_arguments_exist>,
+                                                           simd_comparison_arguments_exist,
+                                                           has_simd_interface<std::decay_t<CT>>...,
+                                                           has_simd_comparison_call<F, CT...>>;
+
+            using use_xsimd = xtl::disjunction<use_xsimd_batches, use_xsimd_conditions, use_xsimd_comparisons>;
+
+            // type of the batches loaded by a comparison, void if F is not a comparison
+            using simd_comparison_type = xtl::mpl::eval_if_t<use_xsimd_comparisons,
+                                                             simd_comparison_common_type<CT...>,
+                                                             meta_identity<void>>;
+
+            // functions with batches of booleans are only loaded with load_simd;
+            // their steppers do not know the batch type of the conditions
+            using linear_simd_only = xtl::conjunction<use_xsimd, xtl::negation<use_xsimd_batches>>;
         };
     }
 
@@ -266,14 +359,22 @@ namespace xt
         static constexpr layout_type static_layout = compute_layout(std::decay_t<CT>::static_layout...);
         static constexpr bool contiguous_layout = detail::conjunction_c<std::decay_t<CT>::contiguous_layout...>::value;
 
+        // the iterators in the static layout of a contiguous function advance
+        // the storage iterators of the operands when the broadcast is trivial
+        template <layout_type L>
+        using use_linear_iterator = std::integral_constant<bool, L == static_layout && contiguous_layout>;
+
         template <layout_type L>
-        using layout_iterator = typename iterable_base::template layout_iterator<L>;
+        using const_layout_iterator = std::conditional_t<use_linear_iterator<L>::value,
+                                                         xdispatch_iterator<xfunction_iterator<F, CT...>,
+                                                                            typename iterable_base::template const_layout_iterator<L>>,
+                                                         typename iterable_base::template const_layout_iterator<L>>;
         template <layout_type L>
-        using const_layout_iterator = typename iterable_base::template const_layout_iterator<L>;
+        using layout_iterator = const_layout_iterator<L>;
         template <layout_type L>
-        using reverse_layout_iterator = typename iterable_base::template reverse_layout_iterator<L>;
+        using const_reverse_layout_iterator = std::reverse_iterator<const_layout_iterator<L>>;
         template <layout_type L>
-        using const_reverse_layout_iterator = typename iterable_base::template const_reverse_layout_iterator<L>;
+        using reverse_layout_iterator = const_reverse_layout_iterator<L>;
 
         template <class S, layout_type L>
         using broadcast_iterator = typename iterable_base::template broadcast_iterator<S, L>;
@@ -289,10 +390,10 @@ namespace xt
         using const_reverse_storage_iterator = std::reverse_iterator<const_storage_iterator>;
         using reverse_storage_iterator = std::reverse_iterator<storage_iterator>;
 
-        using iterator = typename iterable_base::iterator;
-        using const_iterator = typename iterable_base::const_iterator;
-        using reverse_iterator = typename iterable_base::reverse_iterator;
-        using const_reverse_iterator = typename iterable_base::const_reverse_iterator;
+        using iterator = layout_iterator<DL>;
+        using const_iterator = const_layout_iterator<DL>;
+        using reverse_iterator = reverse_layout_iterator<DL>;
+        using const_reverse_iterator = const_reverse_layout_iterator<DL>;
 
         template <class Func, class... CTA, class U = std::enable_if_t<!std::is_base_of<std::decay_t<Func>, self_type>::value>>
         xfunction(Func&& f, CTA&&... e) noexcept;
@@ -343,6 +444,24 @@ namespace xt
         using iterable_base::crbegin;
         using iterable_base::crend;
 
+        template <layout_type L = DL>
+        const_layout_iterator<L> begin() const noexcept;
+        template <layout_type L = DL>
+        const_layout_iterator<L> end() const noexcept;
+        template <layout_type L = DL>
+        const_layout_iterator<L> cbegin() const noexcept;
+        template <layout_type L = DL>
+        const_layout_iterator<L> cend() const noexcept;
+
+        template <layout_type L = DL>
+        const_reverse_layout_iterator<L> rbegin() const noexcept;
+        template <layout_type L = DL>
+        const_reverse_layout_iterator<L> rend() const noexcept;
+        template <layout_type L = DL>
+        const_reverse_layout_iterator<L> crbegin() const noexcept;
+        template <layout_type L = DL>
+        const_reverse_layout_iterator<L> crend() const noexcept;
+
         const_storage_iterator storage_begin() const noexcept;
         const_storage_iterator storage_end() const noexcept;
         const_storage_iterator storage_cbegin() const noexcept;
@@ -367,7 +486,10 @@ namespace xt
                   std::size_t N = xsimd::simd_traits<requested_type>::size>
         simd_return_type<requested_type> load_simd(size_type i) const;
 
-        const tuple_type& arguments() const noexcept;
+        const tuple_type& arguments() const& noexcept;
+        tuple_type&& arguments() && noexcept;
+
+        const functor_type& functor() const noexcept;
 
     private:
 
@@ -395,6 +517,11 @@ namespace xt
         template <class Func, std::size_t... I>
         auto build_iterator(Func&& f, std::index_sequence<I...>) const noexcept;
 
+        template <layout_type L>
+        const_layout_iterator<L> build_layout_iterator(bool end_index, std::true_type) const noexcept;
+        template <layout_type L>
+        const_layout_iterator<L> build_layout_iterator(bool end_index, std::false_type) const noexcept;
+
         size_type compute_dimension() const noexcept;
 
         void compute_cached_shape() const;
@@ -545,19 +672,40 @@ namespace xt
         template <class ST>
         ST step_simd();
 
+        template <class ST>
+        ST step_simd(size_type dim);
+
         value_type step_leading();
+        value_type step_leading(size_type dim);
+
+        // the runs of the operands are read into buffers, which is only
+        // worth it for arithmetic operands
+        static constexpr bool arithmetic_operands =
+            detail::conjunction_c<std::is_arithmetic<typename std::decay_t<CT>::const_stepper::value_type>::value...>::value;
+
+        template <class T, bool B = arithmetic_operands, class = std::enable_if_t<B>>
+        void load_run(size_type dim, size_type n, T* out);
 
     private:
 
         template <std::size_t... I>
         reference deref_impl(std::index_sequence<I...>) const;
 
+        template <class T, std::size_t... I>
+        void load_run_impl(std::index_sequence<I...>, size_type dim, size_type n, T* out);
+
         template <class ST, std::size_t... I>
         ST step_simd_impl(std::index_sequence<I...>);
 
+        template <class ST, std::size_t... I>
+        ST step_simd_impl(std::index_sequence<I...>, size_type dim);
+
         template <std::size_t... I>
         value_type step_leading_impl(std::index_sequence<I...>);
 
+        template <std::size_t... I>
+        value_type step_leading_impl(std::index_sequence<I...>, size_type dim);
+
         const xfunction_type* p_f;
         std::tuple<typename std::decay_t<CT>::const_stepper...> m_it;
     };
@@ -782,6 +930,106 @@ namespace xt
     }
     //@}
 
+    /**
+     * @name Iterators
+     */
+    //@{
+    /**
+     * Returns a constant iterator to the first element of the function.
+     * In the static layout of a function of contiguous operands, the
+     * iterator advances the storage iterators of the operands instead of
+     * a multi-index when the broadcast is trivial.
+     * @tparam L layout used for the traversal. Default value is \c XTENSOR_DEFAULT_LAYOUT.
+     */
+    template <class F, class... CT>
+    template <layout_type L>
+    inline auto xfunction<F, CT...>::begin() const noexcept -> const_layout_iterator<L>
+    {
+        return cbegin<L>();
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last element
+     * of the function.
+     * @tparam L layout used for the traversal. Default value is \c XTENSOR_DEFAULT_LAYOUT.
+     */
+    template <class F, class... CT>
+    template <layout_type L>
+    inline auto xfunction<F, CT...>::end() const noexcept -> const_layout_iterator<L>
+    {
+        return cend<L>();
+    }
+
+    /**
+     * Returns a constant iterator to the first element of the function.
+     * @tparam L layout used for the traversal. Default value is \c XTENSOR_DEFAULT_LAYOUT.
+     */
+    template <class F, class... CT>
+    template <layout_type L>
+    inline auto xfunction<F, CT...>::cbegin() const noexcept -> const_layout_iterator<L>
+    {
+        return build_layout_iterator<L>(false, use_linear_iterator<L>());
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last element
+     * of the function.
+     * @tparam L layout used for the traversal. Default value is \c XTENSOR_DEFAULT_LAYOUT.
+     */
+    template <class F, class... CT>
+    template <layout_type L>
+    inline auto xfunction<F, CT...>::cend() const noexcept -> const_layout_iterator<L>
+    {
+        return build_layout_iterator<L>(true, use_linear_iterator<L>());
+    }
+
+    /**
+     * Returns a constant iterator to the first element of the reversed function.
+     * @tparam L layout used for the traversal. Default value is \c XTENSOR_DEFAULT_LAYOUT.
+     */
+    template <class F, class... CT>
+    template <layout_type L>
+    inline auto xfunction<F, CT...>::rbegin() const noexcept -> const_reverse_layout_iterator<L>
+    {
+        return crbegin<L>();
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last element
+     * of the reversed function.
+     * @tparam L layout used for the traversal. Default value is \c XTENSOR_DEFAULT_LAYOUT.
+     */
+    template <class F, class... CT>
+    template <layout_type L>
+    inline auto xfunction<F, CT...>::rend() const noexcept -> const_reverse_layout_iterator<L>
+    {
+        return crend<L>();
+    }
+
+    /**
+     * Returns a constant iterator to the first element of the reversed function.
+     * @tparam L layout used for the traversal. Default value is \c XTENSOR_DEFAULT_LAYOUT.
+     */
+    template <class F, class... CT>
+    template <layout_type L>
+    inline auto xfunction<F, CT...>::crbegin() const noexcept -> const_reverse_layout_iterator<L>
+    {
+        return const_reverse_layout_iterator<L>(cend<L>());
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last element
+     * of the reversed function.
+     * @tparam L layout used for the traversal. Default value is \c XTENSOR_DEFAULT_LAYOUT.
+     */
+    template <class F, class... CT>
+    template <layout_type L>
+    inline auto xfunction<F, CT...>::crend() const noexcept -> const_reverse_layout_iterator<L>
+    {
+        return const_reverse_layout_iterator<L>(cbegin<L>());
+    }
+    //@}
+
     template <class F, class... CT>
     inline auto xfunction<F, CT...>::storage_begin() const noexcept -> const_storage_iterator
     {
@@ -870,11 +1118,23 @@ namespace xt
     }
 
     template <class F, class... CT>
-    inline auto xfunction<F, CT...>::arguments() const noexcept -> const tuple_type&
+    inline auto xfunction<F, CT...>::arguments() const& noexcept -> const tuple_type&
     {
         return m_e;
     }
 
+    template <class F, class... CT>
+    inline auto xfunction<F, CT...>::arguments() && noexcept -> tuple_type&&
+    {
+        return std::move(m_e);
+    }
+
+    template <class F, class... CT>
+    inline auto xfunction<F, CT...>::functor() const noexcept -> const functor_type&
+    {
+        return m_f;
+    }
+
     template <class F, class... CT>
     template <std::size_t... I>
     inline layout_type xfunction<F, CT...>::layout_impl(std::index_sequence<I...>) const noexcept
@@ -958,6 +1218,34 @@ namespace xt
         return const_storage_iterator(this, f(std::get<I>(m_e))...);
     }
 
+    template <class F, class... CT>
+    template <layout_type L>
+    inline auto xfunction<F, CT...>::build_layout_iterator(bool end_index, std::true_type) const noexcept
+        -> const_layout_iterator<L>
+    {
+        using stepper_iterator = typename iterable_base::template const_layout_iterator<L>;
+        // the operands have the layout L, a trivial broadcast means that
+        // their storage is visited in the order of the iteration
+        shape();
+        if (m_cache.is_trivial)
+        {
+            return const_layout_iterator<L>(end_index ? storage_cend() : storage_cbegin(), stepper_iterator(), true);
+        }
+        else
+        {
+            stepper_iterator it = end_index ? iterable_base::template cend<L>() : iterable_base::template cbegin<L>();
+            return const_layout_iterator<L>(storage_cbegin(), std::move(it), false);
+        }
+    }
+
+    template <class F, class... CT>
+    template <layout_type L>
+    inline auto xfunction<F, CT...>::build_layout_iterator(bool end_index, std::false_type) const noexcept
+        -> const_layout_iterator<L>
+    {
+        return end_index ? iterable_base::template cend<L>() : iterable_base::template cbegin<L>();
+    }
+
     template <class F, class... CT>
     inline auto xfunction<F, CT...>::compute_dimension() const noexcept -> size_type
     {
@@ -1150,6 +1438,23 @@ namespace xt
         return (p_f->m_f)(*std::get<I>(m_it)...);
     }
 
+    template <class F, class... CT>
+    template <class T, std::size_t... I>
+    inline void xfunction_stepper<F, CT...>::load_run_impl(std::index_sequence<I...>, size_type dim, size_type n, T* out)
+    {
+        std::tuple<detail::run_buffer<typename std::decay_t<CT>::const_stepper::value_type>...> buffers;
+        for (size_type first = 0; first < n; first += detail::run_buffer_size)
+        {
+            size_type count = (std::min)(n - first, size_type(detail::run_buffer_size));
+            using swallow = int[];
+            (void)swallow{0, (detail::load_run(std::get<I>(m_it), dim, count, std::get<I>(buffers).data), 0)...};
+            for (size_type i = 0; i < count; ++i)
+            {
+                out[first + i] = detail::convert_element<T>((p_f->m_f)(std::get<I>(buffers).data[i]...));
+            }
+        }
+    }
+
     template <class F, class... CT>
     template <class ST, std::size_t... I>
     inline ST xfunction_stepper<F, CT...>::step_simd_impl(std::index_sequence<I...>)
@@ -1176,12 +1481,58 @@ namespace xt
         return (p_f->m_f)(std::get<I>(m_it).step_leading()...);
     }
 
+    /**
+     * Reads the \c n elements of a run along the dimension \c dim into
+     * \c out: the runs of the operands are read into buffers, then the
+     * function is applied to the buffers, so that the operands are called
+     * once per run instead of once per element.
+     */
+    template <class F, class... CT>
+    template <class T, bool B, class>
+    inline void xfunction_stepper<F, CT...>::load_run(size_type dim, size_type n, T* out)
+    {
+        load_run_impl(std::make_index_sequence<sizeof...(CT)>(), dim, n, out);
+    }
+
     template <class F, class... CT>
     inline auto xfunction_stepper<F, CT...>::step_leading()
         -> value_type
     {
         return step_leading_impl(std::make_index_sequence<sizeof...(CT)>());
     }
+
+    template <class F, class... CT>
+    template <class ST, std::size_t... I>
+    inline ST xfunction_stepper<F, CT...>::step_simd_impl(std::index_sequence<I...>, size_type dim)
+    {
+        return (p_f->m_f.simd_apply)(std::get<I>(m_it).template
+            step_simd<detail::get_simd_type_t<std::tuple_element_t<I, typename xfunction_type::tuple_type>,
+                                              ST,
+                                              typename xfunction_type::simd_argument_type
+                                              >>(dim)...);
+    }
+
+    template <class F, class... CT>
+    template <class ST>
+    inline ST xfunction_stepper<F, CT...>::step_simd(size_type dim)
+    {
+        return step_simd_impl<ST>(std::make_index_sequence<sizeof...(CT)>(), dim);
+    }
+
+    template <class F, class... CT>
+    template <std::size_t... I>
+    inline auto xfunction_stepper<F, CT...>::step_leading_impl(std::index_sequence<I...>, size_type dim)
+        -> value_type
+    {
+        return (p_f->m_f)(std::get<I>(m_it).step_leading(dim)...);
+    }
+
+    template <class F, class... CT>
+    inline auto xfunction_stepper<F, CT...>::step_leading(size_type dim)
+        -> value_type
+    {
+        return step_leading_impl(std::make_index_sequence<sizeof...(CT)>(), dim);
+    }
 }
 
 #endif
@@ -137,6 +137,8 @@ namespace xt
         using size_type = typename xexpression_type::size_type;
         using difference_type = typename xexpression_type::difference_type;
 
+        using simd_value_type = xsimd::simd_type<value_type>;
+
         using shape_type = typename xexpression_type::shape_type;
 
         static constexpr layout_type static_layout = xexpression_type::static_layout;
@@ -323,6 +325,30 @@ namespace xt
         template <class E>
         rebind_t<E> build_functor_view(E&& e) const;
 
+        //
+        // SIMD interface
+        //
+
+        template <class requested_type>
+        using simd_return_type = xsimd::simd_return_type<value_type, requested_type>;
+
+        template <class T, class R>
+        using enable_simd_interface = std::enable_if_t<has_simd_interface<T>::value, R>;
+
+        template <class align, class simd, class T = xexpression_type>
+        enable_simd_interface<T, void> store_simd(size_type i, const simd& e);
+
+        template <class align, class requested_type = value_type,
+                  std::size_t N = xsimd::simd_traits<requested_type>::size,
+                  class T = xexpression_type>
+        enable_simd_interface<T, simd_return_type<requested_type>> load_simd(size_type i) const;
+
+        template <class T = xexpression_type>
+        enable_simd_interface<T, reference> data_element(size_type i);
+
+        template <class T = xexpression_type>
+        enable_simd_interface<T, const_reference> data_element(size_type i) const;
+
     private:
 
         CT m_e;
@@ -343,8 +369,8 @@ namespace xt
     class xfunctor_iterator : public xtl::xrandom_access_iterator_base<xfunctor_iterator<F, IT>,
                                                                        typename F::value_type,
                                                                        typename std::iterator_traits<IT>::difference_type,
-                                                                       typename xtl::xproxy_wrapper<decltype(std::declval<F>()(*(IT())))>::pointer,
-                                                                       xtl::xproxy_wrapper<decltype(std::declval<F>()(*(IT())))>>
+                                                                       typename xtl::xproxy_wrapper<decltype(std::declval<F>()(*std::declval<IT>()))>::pointer,
+                                                                       xtl::xproxy_wrapper<decltype(std::declval<F>()(*std::declval<IT>()))>>
     {
     public:
 
@@ -352,7 +378,7 @@ namespace xt
         using subiterator_traits = std::iterator_traits<IT>;
 
         using value_type = typename functor_type::value_type;
-        using reference = xtl::xproxy_wrapper<decltype(std::declval<functor_type>()(*(IT())))>;
+        using reference = xtl::xproxy_wrapper<decltype(std::declval<functor_type>()(*std::declval<IT>()))>;
         using pointer = typename reference::pointer;
         using difference_type = typename subiterator_traits::difference_type;
         using iterator_category = typename subiterator_traits::iterator_category;
@@ -421,6 +447,15 @@ namespace xt
         void to_begin();
         void to_end(layout_type);
 
+        template <class R>
+        R step_simd();
+
+        template <class R>
+        R step_simd(size_type dim);
+
+        value_type step_leading();
+        value_type step_leading(size_type dim);
+
     private:
 
         ST m_stepper;
@@ -1240,6 +1275,58 @@ namespace xt
         return rebind_t<E>(functor_type(m_functor), std::forward<E>(e));
     }
 
+    /**
+     * @name SIMD interface
+     */
+    //@{
+    /**
+     * Stores a batch of elements, starting at the linear index \c i.
+     * The elements are scattered one by one through the functor.
+     */
+    template <class F, class CT>
+    template <class align, class simd, class T>
+    inline auto xfunctor_view<F, CT>::store_simd(size_type i, const simd& e) -> enable_simd_interface<T, void>
+    {
+        constexpr std::size_t size = xsimd::revert_simd_traits<simd>::size;
+        std::array<value_type, size> buffer;
+        xsimd::store_simd<value_type, typename simd::value_type>(buffer.data(), e, xsimd::unaligned_mode());
+        for (std::size_t k = 0; k < size; ++k)
+        {
+            m_functor(m_e.data_element(i + k)) = buffer[k];
+        }
+    }
+
+    /**
+     * Returns a batch of elements, starting at the linear index \c i.
+     * The elements are gathered one by one through the functor.
+     */
+    template <class F, class CT>
+    template <class align, class requested_type, std::size_t N, class T>
+    inline auto xfunctor_view<F, CT>::load_simd(size_type i) const -> enable_simd_interface<T, simd_return_type<requested_type>>
+    {
+        std::array<value_type, N> buffer;
+        for (std::size_t k = 0; k < N; ++k)
+        {
+            buffer[k] = m_functor(m_e.data_element(i + k));
+        }
+        return xsimd::load_simd<value_type, requested_type>(buffer.data(), xsimd::unaligned_mode());
+    }
+
+    template <class F, class CT>
+    template <class T>
+    inline auto xfunctor_view<F, CT>::data_element(size_type i) -> enable_simd_interface<T, reference>
+    {
+        return m_functor(m_e.data_element(i));
+    }
+
+    template <class F, class CT>
+    template <class T>
+    inline auto xfunctor_view<F, CT>::data_element(size_type i) const -> enable_simd_interface<T, const_reference>
+    {
+        return m_functor(m_e.data_element(i));
+    }
+    //@}
+
     /************************************
      * xfunctor_iterator implementation *
      ************************************/
@@ -1385,5 +1472,49 @@ namespace xt
     {
         m_stepper.to_end(l);
     }
+
+    template <class F, class ST>
+    template <class R>
+    inline R xfunctor_stepper<F, ST>::step_simd()
+    {
+        std::array<value_type, xsimd::revert_simd_traits<R>::size> buffer;
+        for (std::size_t k = 0; k < buffer.size(); ++k)
+        {
+            buffer[k] = (*p_functor)(*m_stepper);
+            m_stepper.step_leading();
+        }
+        R reg;
+        reg.load_unaligned(buffer.data());
+        return reg;
+    }
+
+    template <class F, class ST>
+    template <class R>
+    inline R xfunctor_stepper<F, ST>::step_simd(size_type dim)
+    {
+        std::array<value_type, xsimd::revert_simd_traits<R>::size> buffer;
+        for (std::size_t k = 0; k < buffer.size(); ++k)
+        {
+            buffer[k] = (*p_functor)(*m_stepper);
+            m_stepper.step_leading(dim);
+        }
+        R reg;
+        reg.load_unaligned(buffer.data());
+        return reg;
+    }
+
+    template <class F, class ST>
+    inline auto xfunctor_stepper<F, ST>::step_leading() -> value_type
+    {
+        m_stepper.step_leading();
+        return (*p_functor)(*m_stepper);
+    }
+
+    template <class F, class ST>
+    inline auto xfunctor_stepper<F, ST>::step_leading(size_type dim) -> value_type
+    {
+        m_stepper.step_leading(dim);
+        return (*p_functor)(*m_stepper);
+    }
 }
 #endif
@@ -21,6 +21,8 @@
 #include "xexpression.hpp"
 #include "xiterable.hpp"
 #include "xstrides.hpp"
+#include "xtensor_forward.hpp"
+#include "xtensor_simd.hpp"
 #include "xutils.hpp"
 
 namespace xt
@@ -57,6 +59,22 @@ namespace xt
     template <class F, class R, class S>
     class xgenerator;
 
+    namespace detail
+    {
+        // functors generating the elements of a one-dimensional generator
+        // from their linear index (see arange_impl)
+        template <class F, class = void>
+        struct has_linear_element : std::false_type
+        {
+        };
+
+        template <class F>
+        struct has_linear_element<F, void_t<decltype(std::declval<const F&>().data_element(std::size_t(0)))>>
+            : std::true_type
+        {
+        };
+    }
+
     template <class C, class R, class S>
     struct xiterable_inner_types<xgenerator<C, R, S>>
     {
@@ -134,14 +152,27 @@ namespace xt
         bool broadcast_shape(O& shape, bool reuse_cache = false) const;
 
         template <class O>
-        bool has_linear_assign(const O& /*strides*/) const noexcept;
+        bool has_linear_assign(const O& strides) const noexcept;
+
+        template <class FE = functor_type, class = std::enable_if_t<detail::has_linear_element<FE>::value>>
+        const_reference data_element(size_type i) const;
+
+        template <class requested_type>
+        using simd_return_type = xsimd::simd_return_type<value_type, requested_type>;
+
+        template <class align, class requested_type = value_type,
+                  std::size_t N = xsimd::simd_traits<requested_type>::size, class FE = functor_type,
+                  class = decltype(std::declval<const FE&>().template load_simd<requested_type, N>(size_type(0)))>
+        simd_return_type<requested_type> load_simd(size_type i) const;
 
         template <class O>
         const_stepper stepper_begin(const O& shape) const noexcept;
         template <class O>
         const_stepper stepper_end(const O& shape, layout_type) const noexcept;
 
-        template <class E, class FE = F, class = std::enable_if_t<has_assign_to<E, FE>::value>>
+        // the functors write the storage of the resized container directly
+        template <class E, class FE = F, class = std::enable_if_t<has_assign_to<E, FE>::value &&
+                                                                  std::is_base_of<xcontainer<E>, E>::value>>
         void assign_to(xexpression<E>& e) const noexcept;
 
         const functor_type& functor() const noexcept;
@@ -349,12 +380,37 @@ namespace xt
      */
     template <class F, class R, class S>
     template <class O>
-    inline bool xgenerator<F, R, S>::has_linear_assign(const O& /*strides*/) const noexcept
+    inline bool xgenerator<F, R, S>::has_linear_assign(const O& strides) const noexcept
     {
-        return false;
+        // the linear index of a one-dimensional generator is its index
+        // along the single axis, when the destination is contiguous
+        return detail::has_linear_element<functor_type>::value && m_shape.size() == 1 && strides.size() == 1 &&
+               (m_shape[0] < 2 || strides[0] == 1);
     }
     //@}
 
+    /**
+     * Returns the element at the linear index \c i, for functors
+     * generating one-dimensional expressions from the linear index.
+     */
+    template <class F, class R, class S>
+    template <class FE, class>
+    inline auto xgenerator<F, R, S>::data_element(size_type i) const -> const_reference
+    {
+        return m_f.data_element(i);
+    }
+
+    /**
+     * Returns a batch of elements starting at the linear index \c i,
+     * for functors generating batches.
+     */
+    template <class F, class R, class S>
+    template <class align, class requested_type, std::size_t N, class FE, class>
+    inline auto xgenerator<F, R, S>::load_simd(size_type i) const -> simd_return_type<requested_type>
+    {
+        return m_f.template load_simd<requested_type, N>(i);
+    }
+
     template <class F, class R, class S>
     template <class O>
     inline auto xgenerator<F, R, S>::stepper_begin(const O& shape) const noexcept -> const_stepper
@@ -0,0 +1,617 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_HALF_HPP
+#define XTENSOR_HALF_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+#include "xutils.hpp"
+
+namespace xt
+{
+
+    /*******************
+     * half conversion *
+     *******************/
+
+    namespace detail
+    {
+        inline std::uint32_t float_bits(float f) noexcept
+        {
+            std::uint32_t bits;
+            std::memcpy(&bits, &f, sizeof(float));
+            return bits;
+        }
+
+        inline float bits_float(std::uint32_t bits) noexcept
+        {
+            float f;
+            std::memcpy(&f, &bits, sizeof(float));
+            return f;
+        }
+
+        // IEEE binary16 bits of f, rounded to nearest even
+        inline std::uint16_t float_to_half_bits(float f) noexcept
+        {
+            std::uint32_t x = float_bits(f);
+            std::uint32_t sign = (x >> 16) & 0x8000u;
+            x &= 0x7fffffffu;
+            if (x >= 0x7f800000u)
+            {
+                // infinity, or NaN made quiet with the high bits of its payload
+                return static_cast<std::uint16_t>(sign | 0x7c00u | (x > 0x7f800000u ? 0x0200u | ((x >> 13) & 0x03ffu) : 0u));
+            }
+            if (x >= 0x477ff000u)
+            {
+                // at least 65520, halfway between the largest half and 2^16
+                return static_cast<std::uint16_t>(sign | 0x7c00u);
+            }
+            if (x < 0x38800000u)
+            {
+                // below 2^-14: subnormal half, in units of 2^-24
+                if (x < 0x33000000u)
+                {
+                    return static_cast<std::uint16_t>(sign);
+                }
+                std::uint32_t shift = 126u - (x >> 23);
+                std::uint32_t mantissa = (x & 0x007fffffu) | 0x00800000u;
+                std::uint32_t res = mantissa >> shift;
+                std::uint32_t rem = mantissa & ((1u << shift) - 1u);
+                std::uint32_t halfway = 1u << (shift - 1u);
+                res += (rem > halfway || (rem == halfway && (res & 1u))) ? 1u : 0u;
+                return static_cast<std::uint16_t>(sign | res);
+            }
+            std::uint32_t res = (x - 0x38000000u) >> 13;
+            std::uint32_t rem = x & 0x1fffu;
+            res += (rem > 0x1000u || (rem == 0x1000u && (res & 1u))) ? 1u : 0u;
+            return static_cast<std::uint16_t>(sign | res);
+        }
+
+        inline float half_bits_to_float(std::uint16_t h) noexcept
+        {
+            std::uint32_t sign = static_cast<std::uint32_t>(h & 0x8000u) << 16;
+            std::uint32_t exponent = (h >> 10) & 0x1fu;
+            std::uint32_t mantissa = h & 0x03ffu;
+            if (exponent == 0x1fu)
+            {
+                return bits_float(sign | 0x7f800000u | (mantissa << 13));
+            }
+            if (exponent == 0u)
+            {
+                if (mantissa == 0u)
+                {
+                    return bits_float(sign);
+                }
+                // subnormal half, normal float
+                exponent = 113u;
+                while ((mantissa & 0x0400u) == 0u)
+                {
+                    mantissa <<= 1;
+                    --exponent;
+                }
+                return bits_float(sign | (exponent << 23) | ((mantissa & 0x03ffu) << 13));
+            }
+            return bits_float(sign | ((exponent + 112u) << 23) | (mantissa << 13));
+        }
+
+        // bfloat16 bits of f (the high half of its bits), rounded to nearest even
+        inline std::uint16_t float_to_bfloat16_bits(float f) noexcept
+        {
+            std::uint32_t x = float_bits(f);
+            if ((x & 0x7fffffffu) > 0x7f800000u)
+            {
+                return static_cast<std::uint16_t>((x >> 16) | 0x0040u);
+            }
+            x += 0x7fffu + ((x >> 16) & 1u);
+            return static_cast<std::uint16_t>(x >> 16);
+        }
+
+        inline float bfloat16_bits_to_float(std::uint16_t h) noexcept
+        {
+            return bits_float(static_cast<std::uint32_t>(h) << 16);
+        }
+
+        // Rounds d to a float whose last bit is set when the conversion is
+        // inexact; rounding this float to a type of at least two bits less
+        // of mantissa gives the correctly rounded d, without double rounding
+        inline float round_to_odd_float(double d) noexcept
+        {
+            if (d != d)
+            {
+                return static_cast<float>(d);
+            }
+            if (std::fabs(d) > static_cast<double>((std::numeric_limits<float>::max)()))
+            {
+                return d < 0. ? -std::numeric_limits<float>::infinity() : std::numeric_limits<float>::infinity();
+            }
+            float f = static_cast<float>(d);
+            if (static_cast<double>(f) != d)
+            {
+                std::uint32_t bits = float_bits(f);
+                if (std::fabs(static_cast<double>(f)) > std::fabs(d))
+                {
+                    --bits;
+                }
+                f = bits_float(bits | 1u);
+            }
+            return f;
+        }
+
+        template <class T>
+        inline float half_source(T value, std::true_type /*is float*/) noexcept
+        {
+            return value;
+        }
+
+        template <class T>
+        inline float half_source(T value, std::false_type /*is float*/) noexcept
+        {
+            return round_to_odd_float(static_cast<double>(value));
+        }
+
+        template <class T>
+        inline float half_source(T value) noexcept
+        {
+            return half_source(value, std::is_same<T, float>());
+        }
+    }
+
+    /***********
+     * float16 *
+     ***********/
+
+    /**
+     * @class float16
+     * @brief IEEE 754 half precision floating point value.
+     *
+     * float16 is a storage type: it converts implicitly to and from float,
+     * so that the arithmetic operators and the mathematical functions
+     * compute in single precision, and the result is rounded to the nearest
+     * half precision value when it is stored back. Containers of float16
+     * halve the memory of float containers; their contiguous conversions to
+     * and from float are vectorized (see half_to_float).
+     */
+    class float16
+    {
+    public:
+
+        float16() = default;
+
+        template <class T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>
+        float16(T value) noexcept;
+
+        operator float() const noexcept;
+
+        template <class T>
+        float16& operator+=(const T& rhs) noexcept;
+        template <class T>
+        float16& operator-=(const T& rhs) noexcept;
+        template <class T>
+        float16& operator*=(const T& rhs) noexcept;
+        template <class T>
+        float16& operator/=(const T& rhs) noexcept;
+
+        static constexpr float16 from_bits(std::uint16_t bits) noexcept;
+        constexpr std::uint16_t bits() const noexcept;
+
+    private:
+
+        struct bits_tag
+        {
+        };
+
+        constexpr float16(std::uint16_t bits, bits_tag) noexcept;
+
+        std::uint16_t m_bits;
+    };
+
+    /************
+     * bfloat16 *
+     ************/
+
+    /**
+     * @class bfloat16
+     * @brief Brain floating point value, the 16 high bits of a float.
+     *
+     * bfloat16 has the exponent range of float with 8 bits of mantissa. Like
+     * float16, it is a storage type converting implicitly to and from float.
+     */
+    class bfloat16
+    {
+    public:
+
+        bfloat16() = default;
+
+        template <class T, std::enable_if_t<std::is_arithmetic<T>::value, int> = 0>
+        bfloat16(T value) noexcept;
+
+        operator float() const noexcept;
+
+        template <class T>
+        bfloat16& operator+=(const T& rhs) noexcept;
+        template <class T>
+        bfloat16& operator-=(const T& rhs) noexcept;
+        template <class T>
+        bfloat16& operator*=(const T& rhs) noexcept;
+        template <class T>
+        bfloat16& operator/=(const T& rhs) noexcept;
+
+        static constexpr bfloat16 from_bits(std::uint16_t bits) noexcept;
+        constexpr std::uint16_t bits() const noexcept;
+
+    private:
+
+        struct bits_tag
+        {
+        };
+
+        constexpr bfloat16(std::uint16_t bits, bits_tag) noexcept;
+
+        std::uint16_t m_bits;
+    };
+
+    template <class T>
+    struct is_half_float : std::false_type
+    {
+    };
+
+    template <>
+    struct is_half_float<float16> : std::true_type
+    {
+    };
+
+    template <>
+    struct is_half_float<bfloat16> : std::true_type
+    {
+    };
+
+    /**
+     * @defgroup half_conversions Half precision conversions
+     *
+     * Conversions of n contiguous values between float and a 16 bit floating
+     * point type. The float16 conversions use the F16C instructions when they
+     * are enabled (e.g. with -mf16c or -march=native), the other ones are
+     * loops over integers that the compiler vectorizes.
+     */
+
+    void half_to_float(const float16* src, float* dst, std::size_t n) noexcept;
+    void float_to_half(const float* src, float16* dst, std::size_t n) noexcept;
+    void half_to_float(const bfloat16* src, float* dst, std::size_t n) noexcept;
+    void float_to_half(const float* src, bfloat16* dst, std::size_t n) noexcept;
+
+    /**************************
+     * float16 implementation *
+     **************************/
+
+    /**
+     * Builds the half precision value nearest to \c value; the values of
+     * other types than float are not rounded to float first.
+     */
+    template <class T, std::enable_if_t<std::is_arithmetic<T>::value, int>>
+    inline float16::float16(T value) noexcept
+        : m_bits(detail::float_to_half_bits(detail::half_source(value)))
+    {
+    }
+
+    inline float16::operator float() const noexcept
+    {
+        return detail::half_bits_to_float(m_bits);
+    }
+
+    template <class T>
+    inline float16& float16::operator+=(const T& rhs) noexcept
+    {
+        *this = static_cast<float>(*this) + rhs;
+        return *this;
+    }
+
+    template <class T>
+    inline float16& float16::operator-=(const T& rhs) noexcept
+    {
+        *this = static_cast<float>(*this) - rhs;
+        return *this;
+    }
+
+    template <class T>
+    inline float16& float16::operator*=(const T& rhs) noexcept
+    {
+        *this = static_cast<float>(*this) * rhs;
+        return *this;
+    }
+
+    template <class T>
+    inline float16& float16::operator/=(const T& rhs) noexcept
+    {
+        *this = static_cast<float>(*this) / rhs;
+        return *this;
+    }
+
+    /**
+     * Returns the value whose binary16 representation is \c bits.
+     */
+    inline constexpr float16 float16::from_bits(std::uint16_t bits) noexcept
+    {
+        return float16(bits, bits_tag());
+    }
+
+    /**
+     * Returns the binary16 representation of the value.
+     */
+    inline constexpr std::uint16_t float16::bits() const noexcept
+    {
+        return m_bits;
+    }
+
+    inline constexpr float16::float16(std::uint16_t bits, bits_tag) noexcept
+        : m_bits(bits)
+    {
+    }
+
+    /***************************
+     * bfloat16 implementation *
+     ***************************/
+
+    template <class T, std::enable_if_t<std::is_arithmetic<T>::value, int>>
+    inline bfloat16::bfloat16(T value) noexcept
+        : m_bits(detail::float_to_bfloat16_bits(detail::half_source(value)))
+    {
+    }
+
+    inline bfloat16::operator float() const noexcept
+    {
+        return detail::bfloat16_bits_to_float(m_bits);
+    }
+
+    template <class T>
+    inline bfloat16& bfloat16::operator+=(const T& rhs) noexcept
+    {
+        *this = static_cast<float>(*this) + rhs;
+        return *this;
+    }
+
+    template <class T>
+    inline bfloat16& bfloat16::operator-=(const T& rhs) noexcept
+    {
+        *this = static_cast<float>(*this) - rhs;
+        return *this;
+    }
+
+    template <class T>
+    inline bfloat16& bfloat16::operator*=(const T& rhs) noexcept
+    {
+        *this = static_cast<float>(*this) * rhs;
+        return *this;
+    }
+
+    template <class T>
+    inline bfloat16& bfloat16::operator/=(const T& rhs) noexcept
+    {
+        *this = static_cast<float>(*this) / rhs;
+        return *this;
+    }
+
+    inline constexpr bfloat16 bfloat16::from_bits(std::uint16_t bits) noexcept
+    {
+        return bfloat16(bits, bits_tag());
+    }
+
+    inline constexpr std::uint16_t bfloat16::bits() const noexcept
+    {
+        return m_bits;
+    }
+
+    inline constexpr bfloat16::bfloat16(std::uint16_t bits, bits_tag) noexcept
+        : m_bits(bits)
+    {
+    }
+
+    static_assert(sizeof(float16) == sizeof(std::uint16_t) && sizeof(bfloat16) == sizeof(std::uint16_t),
+                  "16 bit floating point types must not be padded");
+
+    /***********************************
+     * half conversions implementation *
+     ***********************************/
+
+    /**
+     * @ingroup half_conversions
+     * Converts n float16 values to float.
+     */
+    inline void half_to_float(const float16* src, float* dst, std::size_t n) noexcept
+    {
+        std::size_t i = 0;
+#if defined(__F16C__)
+        for (; i + 8 <= n; i += 8)
+        {
+            __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+        }
+#endif
+        for (; i < n; ++i)
+        {
+            dst[i] = detail::half_bits_to_float(src[i].bits());
+        }
+    }
+
+    /**
+     * @ingroup half_conversions
+     * Converts n float values to float16, rounded to nearest even.
+     */
+    inline void float_to_half(const float* src, float16* dst, std::size_t n) noexcept
+    {
+        std::size_t i = 0;
+#if defined(__F16C__)
+        for (; i + 8 <= n; i += 8)
+        {
+            __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), h);
+        }
+#endif
+        for (; i < n; ++i)
+        {
+            dst[i] = float16::from_bits(detail::float_to_half_bits(src[i]));
+        }
+    }
+
+    /**
+     * @ingroup half_conversions
+     * Converts n bfloat16 values to float.
+     */
+    inline void half_to_float(const bfloat16* src, float* dst, std::size_t n) noexcept
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            dst[i] = detail::bfloat16_bits_to_float(src[i].bits());
+        }
+    }
+
+    /**
+     * @ingroup half_conversions
+     * Converts n float values to bfloat16, rounded to nearest even.
+     */
+    inline void float_to_half(const float* src, bfloat16* dst, std::size_t n) noexcept
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            dst[i] = bfloat16::from_bits(detail::float_to_bfloat16_bits(src[i]));
+        }
+    }
+
+    // sums and products of 16 bit floating point values accumulate in
+    // double precision, like the ones of float values
+    template <>
+    struct big_promote_type<float16>
+    {
+        using type = double;
+    };
+
+    template <>
+    struct big_promote_type<bfloat16>
+    {
+        using type = double;
+    };
+
+    namespace detail
+    {
+        template <class D, class H>
+        struct is_saturating_conversion<D, H, std::enable_if_t<std::is_integral<D>::value && !std::is_same<D, bool>::value &&
+                                                               is_half_float<H>::value>>
+            : std::true_type
+        {
+        };
+
+        // out of range values saturate like the conversions from float
+        template <class D, class H>
+        struct element_conversion<D, H, std::enable_if_t<std::is_integral<D>::value && !std::is_same<D, bool>::value &&
+                                                         is_half_float<H>::value>>
+        {
+            static D apply(const H& v) noexcept
+            {
+                return element_conversion<D, float>::apply(static_cast<float>(v));
+            }
+        };
+    }
+}
+
+/******************
+ * numeric_limits *
+ ******************/
+
+namespace std
+{
+    template <>
+    class numeric_limits<xt::float16>
+    {
+    public:
+
+        static constexpr bool is_specialized = true;
+        static constexpr bool is_signed = true;
+        static constexpr bool is_integer = false;
+        static constexpr bool is_exact = false;
+        static constexpr bool has_infinity = true;
+        static constexpr bool has_quiet_NaN = true;
+        static constexpr bool has_signaling_NaN = true;
+        static constexpr float_denorm_style has_denorm = denorm_present;
+        static constexpr bool has_denorm_loss = false;
+        static constexpr float_round_style round_style = round_to_nearest;
+        static constexpr bool is_iec559 = true;
+        static constexpr bool is_bounded = true;
+        static constexpr bool is_modulo = false;
+        static constexpr int digits = 11;
+        static constexpr int digits10 = 3;
+        static constexpr int max_digits10 = 5;
+        static constexpr int radix = 2;
+        static constexpr int min_exponent = -13;
+        static constexpr int min_exponent10 = -4;
+        static constexpr int max_exponent = 16;
+        static constexpr int max_exponent10 = 4;
+        static constexpr bool traps = false;
+        static constexpr bool tinyness_before = false;
+
+        static constexpr xt::float16 min() noexcept { return xt::float16::from_bits(0x0400); }
+        static constexpr xt::float16 lowest() noexcept { return xt::float16::from_bits(0xfbff); }
+        static constexpr xt::float16 max() noexcept { return xt::float16::from_bits(0x7bff); }
+        static constexpr xt::float16 epsilon() noexcept { return xt::float16::from_bits(0x1400); }
+        static constexpr xt::float16 round_error() noexcept { return xt::float16::from_bits(0x3800); }
+        static constexpr xt::float16 infinity() noexcept { return xt::float16::from_bits(0x7c00); }
+        static constexpr xt::float16 quiet_NaN() noexcept { return xt::float16::from_bits(0x7e00); }
+        static constexpr xt::float16 signaling_NaN() noexcept { return xt::float16::from_bits(0x7d00); }
+        static constexpr xt::float16 denorm_min() noexcept { return xt::float16::from_bits(0x0001); }
+    };
+
+    template <>
+    class numeric_limits<xt::bfloat16>
+    {
+    public:
+
+        static constexpr bool is_specialized = true;
+        static constexpr bool is_signed = true;
+        static constexpr bool is_integer = false;
+        static constexpr bool is_exact = false;
+        static constexpr bool has_infinity = true;
+        static constexpr bool has_quiet_NaN = true;
+        static constexpr bool has_signaling_NaN = true;
+        static constexpr float_denorm_style has_denorm = denorm_present;
+        static constexpr bool has_denorm_loss = false;
+        static constexpr float_round_style round_style = round_to_nearest;
+        static constexpr bool is_iec559 = false;
+        static constexpr bool is_bounded = true;
+        static constexpr bool is_modulo = false;
+        static constexpr int digits = 8;
+        static constexpr int digits10 = 2;
+        static constexpr int max_digits10 = 4;
+        static constexpr int radix = 2;
+        static constexpr int min_exponent = -125;
+        static constexpr int min_exponent10 = -37;
+        static constexpr int max_exponent = 128;
+        static constexpr int max_exponent10 = 38;
+        static constexpr bool traps = false;
+        static constexpr bool tinyness_before = false;
+
+        static constexpr xt::bfloat16 min() noexcept { return xt::bfloat16::from_bits(0x0080); }
+        static constexpr xt::bfloat16 lowest() noexcept { return xt::bfloat16::from_bits(0xff7f); }
+        static constexpr xt::bfloat16 max() noexcept { return xt::bfloat16::from_bits(0x7f7f); }
+        static constexpr xt::bfloat16 epsilon() noexcept { return xt::bfloat16::from_bits(0x3c00); }
+        static constexpr xt::bfloat16 round_error() noexcept { return xt::bfloat16::from_bits(0x3f00); }
+        static constexpr xt::bfloat16 infinity() noexcept { return xt::bfloat16::from_bits(0x7f80); }
+        static constexpr xt::bfloat16 quiet_NaN() noexcept { return xt::bfloat16::from_bits(0x7fc0); }
+        static constexpr xt::bfloat16 signaling_NaN() noexcept { return xt::bfloat16::from_bits(0x7fa0); }
+        static constexpr xt::bfloat16 denorm_min() noexcept { return xt::bfloat16::from_bits(0x0001); }
+    };
+}
+
+#endif
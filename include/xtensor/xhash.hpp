@@ -0,0 +1,236 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_HASH_HPP
+#define XTENSOR_HASH_HPP
+
+#include <algorithm>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+#include "xassign.hpp"
+#include "xexpression.hpp"
+#include "xlayout.hpp"
+#include "xparallel.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+
+    /**
+     * @defgroup hash_functions Hash functions
+     */
+
+    namespace detail
+    {
+        // number of elements hashed at once, the hashes of the blocks are
+        // combined in order whatever the number of threads
+        constexpr std::size_t hash_block_size = 8192;
+
+        inline std::uint64_t hash_mix(std::uint64_t x) noexcept
+        {
+            x ^= x >> 33;
+            x *= 0xff51afd7ed558ccdULL;
+            x ^= x >> 33;
+            x *= 0xc4ceb9fe1a85ec53ULL;
+            x ^= x >> 33;
+            return x;
+        }
+
+        inline std::uint64_t hash_combine(std::uint64_t seed, std::uint64_t h) noexcept
+        {
+            return hash_mix(seed ^ (h + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+        }
+
+        // the bits of a value, values comparing equal have the same bits
+        template <class T>
+        inline std::enable_if_t<std::is_integral<T>::value, std::uint64_t> hash_bits(const T& v) noexcept
+        {
+            return static_cast<std::uint64_t>(v);
+        }
+
+        template <class T>
+        inline std::enable_if_t<std::is_floating_point<T>::value, std::uint64_t> hash_bits(const T& v) noexcept
+        {
+            // -0 is hashed as 0
+            T n = v + T(0);
+            std::uint64_t res = 0;
+            std::memcpy(&res, &n, sizeof(T) < sizeof(res) ? sizeof(T) : sizeof(res));
+            return res;
+        }
+
+        template <class T>
+        inline std::uint64_t hash_bits(const std::complex<T>& v) noexcept
+        {
+            return hash_combine(hash_bits(v.real()), hash_bits(v.imag()));
+        }
+
+        template <class T>
+        inline std::enable_if_t<!std::is_arithmetic<T>::value, std::uint64_t> hash_bits(const T& v)
+        {
+            return static_cast<std::uint64_t>(std::hash<T>()(v));
+        }
+
+        // kind and size of the value type, so that the same values held
+        // in arrays of different types have different hashes
+        template <class T>
+        inline std::uint64_t hash_type_tag() noexcept
+        {
+            std::uint64_t kind = std::is_floating_point<T>::value ? 1 : std::is_signed<T>::value ? 2 :
+                                 std::is_integral<T>::value ? 3 : 4;
+            return (kind << 32) | static_cast<std::uint64_t>(sizeof(T));
+        }
+
+        // Hashes n values with four independent lanes, so that consecutive
+        // values are mixed without waiting for each other; it is advanced
+        // past the values.
+        template <class It>
+        inline std::uint64_t hash_block(It& it, std::size_t n)
+        {
+            std::uint64_t lanes[4] = { 0x243f6a8885a308d3ULL, 0x13198a2e03707344ULL,
+                                       0xa4093822299f31d0ULL, 0x082efa98ec4e6c89ULL };
+            std::size_t quad_end = n - n % 4;
+            for (std::size_t i = 0; i != quad_end; i += 4)
+            {
+                for (std::size_t l = 0; l != 4; ++l, ++it)
+                {
+                    std::uint64_t x = (lanes[l] ^ hash_bits(*it)) * 0x9e3779b97f4a7c15ULL;
+                    lanes[l] = x ^ (x >> 29);
+                }
+            }
+            for (std::size_t l = 0; l != n - quad_end; ++l, ++it)
+            {
+                std::uint64_t x = (lanes[l] ^ hash_bits(*it)) * 0x9e3779b97f4a7c15ULL;
+                lanes[l] = x ^ (x >> 29);
+            }
+            std::uint64_t res = hash_mix(lanes[0]);
+            for (std::size_t l = 1; l != 4; ++l)
+            {
+                res = hash_combine(res, lanes[l]);
+            }
+            return hash_combine(res, static_cast<std::uint64_t>(n));
+        }
+
+        template <class E, class = void>
+        struct is_hash_contiguous : std::false_type
+        {
+        };
+
+        template <class E>
+        struct is_hash_contiguous<E, std::enable_if_t<has_data_interface<E>::value>>
+            : std::integral_constant<bool, E::contiguous_layout && !is_bitset_container<E>::value &&
+                                           std::is_same<data_value_type_t<E>, typename E::value_type>::value>
+        {
+        };
+
+        template <class E>
+        inline bool hash_blocks(const E& e, std::vector<std::uint64_t>& blocks, std::size_t size, std::true_type)
+        {
+            if (e.dimension() > 1 && e.layout() != layout_type::row_major)
+            {
+                return false;
+            }
+            using value_type = typename E::value_type;
+            const value_type* p = e.data() + e.data_offset();
+            auto hash_range = [&blocks, p, size](std::size_t first, std::size_t last)
+            {
+                for (std::size_t b = first; b != last; ++b)
+                {
+                    const value_type* it = p + b * hash_block_size;
+                    blocks[b] = hash_block(it, (std::min)(hash_block_size, size - b * hash_block_size));
+                }
+            };
+            if (blocks.size() > 1 && parallel::use_parallel(size))
+            {
+                parallel_for(std::size_t(0), blocks.size(), parallel::grain(hash_block_size), hash_range);
+            }
+            else
+            {
+                hash_range(std::size_t(0), blocks.size());
+            }
+            return true;
+        }
+
+        template <class E>
+        inline bool hash_blocks(const E&, std::vector<std::uint64_t>&, std::size_t, std::false_type)
+        {
+            return false;
+        }
+    }
+
+    /**
+     * @ingroup hash_functions
+     * @brief Hash of the shape and the values of an expression.
+     *
+     * The values are hashed in row-major order, so that expressions
+     * comparing equal with operator== and having the same value type have
+     * the same hash, whatever their layout. The hash depends on the kind
+     * and the size of the value type: arrays of different types holding
+     * the same values have different hashes. The storage of contiguous
+     * row-major expressions is hashed by blocks, in parallel when
+     * XTENSOR_PARALLEL_ENABLED is defined, and the hash does not depend on
+     * the number of threads. The hash is not meant to be stable across
+     * versions nor platforms.
+     * @param e the \ref xexpression to hash
+     * @return the hash of \a e
+     */
+    template <class E>
+    inline std::size_t hash(const xexpression<E>& e)
+    {
+        const E& de = e.derived_cast();
+        using value_type = typename E::value_type;
+
+        std::uint64_t res = detail::hash_mix(detail::hash_type_tag<value_type>());
+        res = detail::hash_combine(res, static_cast<std::uint64_t>(de.dimension()));
+        for (auto s : de.shape())
+        {
+            res = detail::hash_combine(res, static_cast<std::uint64_t>(s));
+        }
+
+        std::size_t size = static_cast<std::size_t>(de.size());
+        std::vector<std::uint64_t> blocks((size + detail::hash_block_size - 1) / detail::hash_block_size);
+        if (!detail::hash_blocks(de, blocks, size, detail::is_hash_contiguous<E>()))
+        {
+            auto it = de.template cbegin<layout_type::row_major>();
+            for (std::size_t b = 0; b != blocks.size(); ++b)
+            {
+                blocks[b] = detail::hash_block(it, (std::min)(detail::hash_block_size, size - b * detail::hash_block_size));
+            }
+        }
+        for (auto h : blocks)
+        {
+            res = detail::hash_combine(res, h);
+        }
+        return static_cast<std::size_t>(res);
+    }
+
+    /**
+     * @ingroup hash_functions
+     * @brief Function object calling \ref hash, to be used as the hash of
+     * the keys of unordered containers.
+     *
+     * \code{.cpp}
+     * std::unordered_map<xt::xarray<double>, double, xt::expression_hash> cache;
+     * \endcode
+     */
+    struct expression_hash
+    {
+        template <class E>
+        std::size_t operator()(const xexpression<E>& e) const
+        {
+            return hash(e);
+        }
+    };
+}
+
+#endif
@@ -13,11 +13,161 @@
 #ifndef XTENSOR_HISTOGRAM_HPP
 #define XTENSOR_HISTOGRAM_HPP
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+#include "xparallel.hpp"
+#include "xsearch.hpp"
 #include "xtensor.hpp"
 #include "xsort.hpp"
 
 namespace xt
 {
+    namespace detail
+    {
+        /**
+         * Accumulates the contributions of the n data-points into the n_bins
+         * bins of count; fill(first, last, bins) adds the contributions of the
+         * data-points [first, last) to bins. Large inputs are split in blocks
+         * filling local histograms concurrently, which are then merged in block
+         * order: the block count does not depend on the number of threads, so
+         * that the result does not either.
+         */
+        template <class T, class F>
+        inline void accumulate_histogram(T* count, std::size_t n_bins, std::size_t n, F&& fill)
+        {
+            constexpr std::size_t max_blocks = 64;
+            // blocks hold at least as many data-points as there are bins,
+            // merging the local histograms is then cheaper than filling them
+            std::size_t n_blocks = std::min(max_blocks, n / std::max(n_bins, parallel::grain(1)));
+            if (!parallel::use_parallel(n) || parallel::in_parallel_region() || n_blocks < 2)
+            {
+                fill(std::size_t(0), n, count);
+                return;
+            }
+            std::size_t block_size = (n + n_blocks - 1) / n_blocks;
+            n_blocks = (n + block_size - 1) / block_size;
+            std::vector<T> local(n_blocks * n_bins, T(0));
+            parallel_for(std::size_t(0), n_blocks, std::size_t(1), [&](std::size_t first, std::size_t last)
+            {
+                for (std::size_t b = first; b < last; ++b)
+                {
+                    fill(b * block_size, std::min((b + 1) * block_size, n), local.data() + b * n_bins);
+                }
+            });
+            for (std::size_t b = 0; b < n_blocks; ++b)
+            {
+                const T* lb = local.data() + b * n_bins;
+                for (std::size_t k = 0; k < n_bins; ++k)
+                {
+                    count[k] += lb[k];
+                }
+            }
+        }
+
+        // True if the n bin-edges are equally spaced, up to rounding errors
+        // small enough for uniform_bin to be exact.
+        template <class T>
+        inline bool uniform_edges(const T* edges, std::size_t n)
+        {
+            if (n < 2)
+            {
+                return false;
+            }
+            double lo = static_cast<double>(edges[0]);
+            double width = (static_cast<double>(edges[n - 1]) - lo) / static_cast<double>(n - 1);
+            if (!(width > 0.))
+            {
+                return false;
+            }
+            double tol = 1e-6 * width;
+            for (std::size_t i = 1; i < n - 1; ++i)
+            {
+                if (std::abs(static_cast<double>(edges[i]) - (lo + static_cast<double>(i) * width)) > tol)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // O(1) bin lookup in uniform bins: the index computed from the bin width
+        // is corrected by comparison with the neighbouring edges, so that the
+        // result is the same as a search in the edges.
+        template <class T, class V>
+        inline std::size_t uniform_bin(const T* edges, std::size_t n_bins, double lo, double scale, const V& v)
+        {
+            double pos = (static_cast<double>(v) - lo) * scale;
+            std::size_t b = pos > 0. ? std::min(static_cast<std::size_t>(pos), n_bins - 1) : std::size_t(0);
+            if (b > 0 && v < edges[b])
+            {
+                --b;
+            }
+            else if (b + 1 < n_bins && !(v < edges[b + 1]))
+            {
+                ++b;
+            }
+            return b;
+        }
+
+        /**
+         * Finds the bins of values in the n_edges sorted bin-edges, in constant
+         * time if the bins are uniform and with a binary search otherwise; the
+         * last bin includes its right edge.
+         */
+        template <class T>
+        class bin_lookup
+        {
+        public:
+
+            bin_lookup(const T* edges, std::size_t n_edges)
+                : p_edges(edges), m_n_bins(n_edges - 1), m_uniform(uniform_edges(edges, n_edges)),
+                  m_lo(static_cast<double>(edges[0])),
+                  m_scale(static_cast<double>(m_n_bins) / (static_cast<double>(edges[m_n_bins]) - m_lo))
+            {
+            }
+
+            std::size_t size() const noexcept
+            {
+                return m_n_bins;
+            }
+
+            bool uniform() const noexcept
+            {
+                return m_uniform;
+            }
+
+            double width(std::size_t i) const
+            {
+                return static_cast<double>(p_edges[i + 1]) - static_cast<double>(p_edges[i]);
+            }
+
+            template <class V>
+            std::size_t operator()(const V& v) const
+            {
+                if (m_uniform)
+                {
+                    return uniform_bin(p_edges, m_n_bins, m_lo, m_scale, v);
+                }
+                std::size_t iedge;
+                branchless_search<true>(p_edges, m_n_bins + 1, &v, 1, &iedge);
+                return std::min(std::max(iedge, std::size_t(1)) - 1, m_n_bins - 1);
+            }
+
+        private:
+
+            const T* p_edges;
+            std::size_t m_n_bins;
+            bool m_uniform;
+            double m_lo;
+            double m_scale;
+        };
+    }
+
     /**
      * @ingroup histogram
      * @brief Compute the histogram of a set of data.
@@ -53,22 +203,47 @@ namespace xt
         // initialize output
         xt::xtensor<value_type, 1> count = xt::zeros<value_type>({bin_edges.size() - 1});
 
-        // indices that sort "data"
-        auto isort = xt::argsort(data);
-
-        // index of the current bin
-        size_type ibin = 0;
-
-        // fill the histogram: loop over (sorted) data
-        for (auto& idx : isort)
+        // bins of equal width are found in constant time, others by a binary
+        // search in the bin-edges; the last bin includes its right edge
+        auto&& edges = xt::eval(bin_edges);
+        xt::xtensor<typename std::decay_t<E1>::value_type, 1> values = data;
+        xt::xtensor<value_type, 1> w = weights;
+        const auto* pe = edges.data();
+        const auto* pv = values.data();
+        const auto* pw = w.data();
+        std::size_t nbin = edges.size() - 1;
+
+        detail::bin_lookup<std::decay_t<decltype(*pe)>> lookup(pe, edges.size());
+        if (lookup.uniform())
         {
-            // - proceed to the relevant bin
-            while (data[idx] >= bin_edges[ibin+1] && ibin < bin_edges.size() - 2)
+            detail::accumulate_histogram(count.data(), nbin, values.size(),
+                                         [=](std::size_t first, std::size_t last, value_type* bins)
             {
-                ++ibin;
-            }
-            // - update the count
-            count[ibin] += weights[idx];
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    bins[lookup(pv[i])] += pw[i];
+                }
+            });
+        }
+        else
+        {
+            detail::accumulate_histogram(count.data(), nbin, values.size(),
+                                         [=](std::size_t first, std::size_t last, value_type* bins)
+            {
+                constexpr std::size_t chunk = 256;
+                std::array<std::size_t, chunk> iedge;
+                for (std::size_t i = first; i < last; i += chunk)
+                {
+                    std::size_t len = std::min(chunk, last - i);
+                    // number of bin-edges less than or equal to each data-point
+                    detail::branchless_search<true>(pe, nbin + 1, pv + i, len, iedge.data());
+                    for (std::size_t j = 0; j < len; ++j)
+                    {
+                        std::size_t ibin = std::max(iedge[j], std::size_t(1)) - 1;
+                        bins[std::min(ibin, nbin - 1)] += pw[i + j];
+                    }
+                }
+            });
         }
 
         // cast type
@@ -340,6 +515,230 @@ namespace xt
                                    left, right, bins, mode);
     }
 
+    namespace detail
+    {
+        // Fills the row-major histogram count of shape (lookups[0].size(), ...)
+        // with the weights of the n points, coord(i, d) being the d-th
+        // coordinate of the i-th point, in a single pass over the points.
+        template <class T, class L, class C, class W>
+        inline void histogramdd_fill(T* count, const std::vector<L>& lookups, std::size_t n,
+                                     C&& coord, const W* weights)
+        {
+            std::size_t dim = lookups.size();
+            std::vector<std::size_t> strides(dim);
+            std::size_t n_bins = 1;
+            for (std::size_t d = dim; d > 0; --d)
+            {
+                strides[d - 1] = n_bins;
+                n_bins *= lookups[d - 1].size();
+            }
+            accumulate_histogram(count, n_bins, n, [&](std::size_t first, std::size_t last, T* bins)
+            {
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    std::size_t ibin = 0;
+                    for (std::size_t d = 0; d < dim; ++d)
+                    {
+                        ibin += strides[d] * lookups[d](coord(i, d));
+                    }
+                    bins[ibin] += weights[i];
+                }
+            });
+        }
+
+        // Divides the counts by the total count and the bin volumes.
+        template <class R, class L>
+        inline void histogramdd_density(R* prob, const std::vector<L>& lookups, std::size_t n_bins)
+        {
+            R total = std::accumulate(prob, prob + n_bins, R(0));
+            std::size_t dim = lookups.size();
+            std::vector<std::size_t> index(dim, 0);
+            for (std::size_t k = 0; k < n_bins; ++k)
+            {
+                double volume = 1.;
+                for (std::size_t d = 0; d < dim; ++d)
+                {
+                    volume *= lookups[d].width(index[d]);
+                }
+                prob[k] /= static_cast<R>(volume) * total;
+                // row-major increment of the multi-index
+                for (std::size_t d = dim; d > 0; --d)
+                {
+                    if (++index[d - 1] < lookups[d - 1].size())
+                    {
+                        break;
+                    }
+                    index[d - 1] = 0;
+                }
+            }
+        }
+    }
+
+    /**
+     * @ingroup histogram
+     * @brief Compute the multi-dimensional histogram of a set of points.
+     *
+     * The points are binned in a single pass over the data; uniform bins are
+     * found in constant time, and large inputs are accumulated in parallel
+     * like in histogram.
+     *
+     * @param sample The points, a two-dimensional expression of shape (N, D).
+     * @param bin_edges A sequence of D one-dimensional expressions holding the bin-edges along each dimension.
+     * @param weights Weight factors corresponding to each point.
+     * @param density If true the resulting integral is normalized to 1. [default: false]
+     * @return An xarray<R> of shape (bin_edges[0].size()-1, ..., bin_edges[D-1].size()-1).
+     */
+    template <class R = double, class E1, class B, class E2>
+    inline auto histogramdd(E1&& sample, const B& bin_edges, E2&& weights, bool density = false)
+    {
+        using sample_type = typename std::decay_t<E1>::value_type;
+        using value_type = typename std::decay_t<E2>::value_type;
+        using edge_type = typename std::decay_t<decltype(*bin_edges.begin())>::value_type;
+
+        XTENSOR_ASSERT(sample.dimension() == 2);
+        XTENSOR_ASSERT(weights.dimension() == 1);
+        XTENSOR_ASSERT(weights.size() == sample.shape()[0]);
+
+        xt::xtensor<sample_type, 2> points = sample;
+        std::size_t n = points.shape()[0];
+        std::size_t dim = points.shape()[1];
+        XTENSOR_ASSERT(std::size_t(std::distance(bin_edges.begin(), bin_edges.end())) == dim);
+
+        std::vector<xt::xtensor<edge_type, 1>> edges(bin_edges.begin(), bin_edges.end());
+        std::vector<detail::bin_lookup<edge_type>> lookups;
+        std::vector<std::size_t> shape;
+        for (const auto& e : edges)
+        {
+            XTENSOR_ASSERT(e.size() >= 2);
+            XTENSOR_ASSERT(std::is_sorted(e.cbegin(), e.cend()));
+            lookups.emplace_back(e.data(), e.size());
+            shape.push_back(e.size() - 1);
+        }
+
+        xt::xtensor<value_type, 1> w = weights;
+        xt::xarray<value_type> count = xt::zeros<value_type>(shape);
+        const sample_type* pp = points.data();
+        detail::histogramdd_fill(count.data(), lookups, n,
+                                 [pp, dim](std::size_t i, std::size_t d) { return pp[i * dim + d]; },
+                                 w.data());
+
+        xt::xarray<R> prob = xt::cast<R>(count);
+        if (density)
+        {
+            detail::histogramdd_density(prob.data(), lookups, prob.size());
+        }
+        return prob;
+    }
+
+    /**
+     * @ingroup histogram
+     * @brief Compute the multi-dimensional histogram of a set of points.
+     *
+     * @param sample The points, a two-dimensional expression of shape (N, D).
+     * @param bin_edges A sequence of D one-dimensional expressions holding the bin-edges along each dimension.
+     * @param density If true the resulting integral is normalized to 1. [default: false]
+     * @return An xarray<R> of shape (bin_edges[0].size()-1, ..., bin_edges[D-1].size()-1).
+     */
+    template <class R = double, class E1, class B>
+    inline auto histogramdd(E1&& sample, const B& bin_edges, bool density = false)
+    {
+        using value_type = typename std::decay_t<E1>::value_type;
+        std::size_t n = sample.shape()[0];
+        return histogramdd<R>(std::forward<E1>(sample), bin_edges, xt::ones<value_type>({n}), density);
+    }
+
+    /**
+     * @ingroup histogram
+     * @brief Compute the two-dimensional histogram of a set of points.
+     *
+     * @param x The x-coordinates of the points.
+     * @param y The y-coordinates of the points.
+     * @param x_edges The bin-edges along x.
+     * @param y_edges The bin-edges along y.
+     * @param weights Weight factors corresponding to each point.
+     * @param density If true the resulting integral is normalized to 1. [default: false]
+     * @return An xtensor<R, 2> of shape (x_edges.size()-1, y_edges.size()-1).
+     */
+    template <class R = double, class E1, class E2, class E3, class E4, class E5>
+    inline auto histogram2d(E1&& x, E2&& y, E3&& x_edges, E4&& y_edges, E5&& weights, bool density = false)
+    {
+        using value_type = typename std::decay_t<E5>::value_type;
+        using coord_type = std::common_type_t<typename std::decay_t<E1>::value_type,
+                                              typename std::decay_t<E2>::value_type>;
+        using edge_type = std::common_type_t<typename std::decay_t<E3>::value_type,
+                                             typename std::decay_t<E4>::value_type>;
+
+        XTENSOR_ASSERT(x.dimension() == 1);
+        XTENSOR_ASSERT(y.dimension() == 1);
+        XTENSOR_ASSERT(x.size() == y.size());
+        XTENSOR_ASSERT(weights.size() == x.size());
+
+        xt::xtensor<coord_type, 1> px = x;
+        xt::xtensor<coord_type, 1> py = y;
+        std::vector<xt::xtensor<edge_type, 1>> edges = {x_edges, y_edges};
+        std::vector<detail::bin_lookup<edge_type>> lookups;
+        for (const auto& e : edges)
+        {
+            XTENSOR_ASSERT(e.size() >= 2);
+            XTENSOR_ASSERT(std::is_sorted(e.cbegin(), e.cend()));
+            lookups.emplace_back(e.data(), e.size());
+        }
+
+        xt::xtensor<value_type, 1> w = weights;
+        xt::xtensor<value_type, 2> count = xt::zeros<value_type>({lookups[0].size(), lookups[1].size()});
+        const coord_type* ppx = px.data();
+        const coord_type* ppy = py.data();
+        detail::histogramdd_fill(count.data(), lookups, px.size(),
+                                 [ppx, ppy](std::size_t i, std::size_t d) { return d == 0 ? ppx[i] : ppy[i]; },
+                                 w.data());
+
+        xt::xtensor<R, 2> prob = xt::cast<R>(count);
+        if (density)
+        {
+            detail::histogramdd_density(prob.data(), lookups, prob.size());
+        }
+        return prob;
+    }
+
+    /**
+     * @ingroup histogram
+     * @brief Compute the two-dimensional histogram of a set of points.
+     *
+     * @param x The x-coordinates of the points.
+     * @param y The y-coordinates of the points.
+     * @param x_edges The bin-edges along x.
+     * @param y_edges The bin-edges along y.
+     * @param density If true the resulting integral is normalized to 1. [default: false]
+     * @return An xtensor<R, 2> of shape (x_edges.size()-1, y_edges.size()-1).
+     */
+    template <class R = double, class E1, class E2, class E3, class E4>
+    inline auto histogram2d(E1&& x, E2&& y, E3&& x_edges, E4&& y_edges, bool density = false)
+    {
+        using value_type = typename std::decay_t<E1>::value_type;
+        std::size_t n = x.size();
+        return histogram2d<R>(std::forward<E1>(x), std::forward<E2>(y), std::forward<E3>(x_edges),
+                              std::forward<E4>(y_edges), xt::ones<value_type>({n}), density);
+    }
+
+    /**
+     * @ingroup histogram
+     * @brief Compute the two-dimensional histogram of a set of points, with
+     * bins of equal width between the minimum and maximum of each coordinate.
+     *
+     * @param x The x-coordinates of the points.
+     * @param y The y-coordinates of the points.
+     * @param bins The number of bins along each dimension. [default: 10]
+     * @param density If true the resulting integral is normalized to 1. [default: false]
+     * @return An xtensor<R, 2> of shape (bins, bins).
+     */
+    template <class R = double, class E1, class E2>
+    inline auto histogram2d(E1&& x, E2&& y, std::size_t bins = 10, bool density = false)
+    {
+        auto x_edges = histogram_bin_edges(x, bins, histogram_algorithm::linspace);
+        auto y_edges = histogram_bin_edges(y, bins, histogram_algorithm::linspace);
+        return histogram2d<R>(std::forward<E1>(x), std::forward<E2>(y), x_edges, y_edges, density);
+    }
+
     /**
      * Count number of occurrences of each value in array of non-negative ints.
      * 
@@ -379,10 +778,14 @@ namespace xt
         xt::xtensor<result_value_type, 1> res =
             xt::zeros<result_value_type>({std::max(minlength, std::size_t(left_right[1] + 1))});
 
-        for (size_type i = 0; i < data.size(); ++i)
+        detail::accumulate_histogram(res.data(), res.size(), data.size(),
+                                     [&data, &weights](std::size_t first, std::size_t last, result_value_type* bins)
         {
-            res(data(i)) += weights(i);
-        }
+            for (size_type i = first; i < last; ++i)
+            {
+                bins[static_cast<std::size_t>(data(i))] += weights(i);
+            }
+        });
 
         return res;
     }
@@ -11,13 +11,22 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "xexpression.hpp"
 #include "xiterable.hpp"
+#include "xnoalias.hpp"
+#include "xoperation.hpp"
+#include "xparallel.hpp"
 #include "xstrides.hpp"
+#include "xtensor.hpp"
 #include "xutils.hpp"
 
 namespace xt
@@ -164,6 +173,8 @@ namespace xt
         template <class It>
         const_reference element(It first, It last) const;
 
+        void prefetch_element(size_type i) const noexcept;
+
         xexpression_type& expression() noexcept;
         const xexpression_type& expression() const noexcept;
 
@@ -254,8 +265,8 @@ namespace xt
 
     private:
 
-        template <class F>
-        self_type& apply(F&& func);
+        template <class E>
+        self_type& apply(E&& values);
 
         ECT m_e;
         CCT m_condition;
@@ -504,6 +515,30 @@ namespace xt
         return m_e[m_indices[(*first)]];
     }
 
+    /**
+     * Prefetches the element at the position \c i in the xindex_view when
+     * the underlying expression has a data interface and does not fit in
+     * the caches; the steppers of the view call it for the positions
+     * they reach a few elements later.
+     * @param i the position in the xindex_view
+     */
+    template <class CT, class I>
+    inline void xindex_view<CT, I>::prefetch_element(size_type i) const noexcept
+    {
+        xtl::mpl::static_if<has_data_interface<xexpression_type>::value && has_strides<xexpression_type>::value>([&](auto self)
+        {
+            const auto& e = self(m_e);
+            if (e.size() * sizeof(value_type) >= detail::prefetch_min_bytes)
+            {
+                const auto& index = m_indices[i];
+                auto offset = element_offset<difference_type>(e.strides(), std::begin(index), std::end(index));
+                detail::prefetch_read(e.data() + e.data_offset() + offset);
+            }
+        }, /*else*/ [](auto /*self*/)
+        {
+        });
+    }
+
     /**
      * Returns a reference to the underlying expression of the view.
      */
@@ -632,7 +667,7 @@ namespace xt
     template <class E>
     inline auto xfiltration<ECT, CCT>::operator=(const E& e) -> disable_xexpression<E, self_type&>
     {
-        return apply([this, &e](const_reference v, bool cond) { return cond ? e : v; });
+        return apply(e);
     }
     //@}
 
@@ -649,7 +684,7 @@ namespace xt
     template <class E>
     inline auto xfiltration<ECT, CCT>::operator+=(const E& e) -> disable_xexpression<E, self_type&>
     {
-        return apply([&e](const_reference v, bool cond) { return cond ? v + e : v; });
+        return apply(m_e + e);
     }
 
     /**
@@ -661,7 +696,7 @@ namespace xt
     template <class E>
     inline auto xfiltration<ECT, CCT>::operator-=(const E& e) -> disable_xexpression<E, self_type&>
     {
-        return apply([&e](const_reference v, bool cond) { return cond ? v - e : v; });
+        return apply(m_e - e);
     }
 
     /**
@@ -673,7 +708,7 @@ namespace xt
     template <class E>
     inline auto xfiltration<ECT, CCT>::operator*=(const E& e) -> disable_xexpression<E, self_type&>
     {
-        return apply([&e](const_reference v, bool cond) { return cond ? v * e : v; });
+        return apply(m_e * e);
     }
 
     /**
@@ -685,7 +720,7 @@ namespace xt
     template <class E>
     inline auto xfiltration<ECT, CCT>::operator/=(const E& e) -> disable_xexpression<E, self_type&>
     {
-        return apply([&e](const_reference v, bool cond) { return cond ? v / e : v; });
+        return apply(m_e / e);
     }
 
     /**
@@ -697,14 +732,17 @@ namespace xt
     template <class E>
     inline auto xfiltration<ECT, CCT>::operator%=(const E& e) -> disable_xexpression<E, self_type&>
     {
-        return apply([&e](const_reference v, bool cond) { return cond ? v % e : v; });
+        return apply(m_e % e);
     }
 
     template <class ECT, class CCT>
-    template <class F>
-    inline auto xfiltration<ECT, CCT>::apply(F&& func) -> self_type&
+    template <class E>
+    inline auto xfiltration<ECT, CCT>::apply(E&& values) -> self_type&
     {
-        std::transform(m_e.cbegin(), m_e.cend(), m_condition.cbegin(), m_e.begin(), func);
+        // where selects between the new and the current values by batches
+        // (see conditional_ternary), without a branch per element; every
+        // element is read before it is written at the same position
+        noalias(m_e) = where(m_condition, std::forward<E>(values), m_e);
         return *this;
     }
 
@@ -758,7 +796,8 @@ namespace xt
      * This is equivalent to \verbatim{index_view(e, argwhere(condition));}\endverbatim
      * The returned view is not optimal if you just want to assign a scalar to the filtered
      * elements. In that case, you should consider using the \ref filtration function
-     * instead.
+     * instead. To copy the filtered elements into a container, \ref extract avoids
+     * building the indices of the view.
      *
      * @param e the underlying xexpression
      * @param condition xexpression with shape of \a e which selects indices
@@ -779,6 +818,591 @@ namespace xt
         return view_type(std::forward<E>(e), std::move(indices));
     }
 
+    namespace detail
+    {
+        // Stream compaction without branches: every element is written to
+        // the next free slot, which only advances when its mask is true.
+        // The range stops after the last true value so that the writes stay
+        // within the slots of the range.
+        template <class T, class M, class D>
+        inline void compress_range(const T* src, M mask, std::size_t first, std::size_t end, D* dst)
+        {
+            mask += static_cast<std::ptrdiff_t>(first);
+            std::size_t k = 0;
+            for (std::size_t i = first; i != end; ++i, ++mask)
+            {
+                dst[k] = src[i];
+                k += static_cast<std::size_t>(static_cast<bool>(*mask));
+            }
+        }
+
+        template <class T, class M, class R>
+        inline void compress_linear(const T* src, M mask, std::size_t size, R& res)
+        {
+            using value_type = typename R::value_type;
+            std::size_t nb_chunks = parallel::use_parallel(size) ? std::size_t(64) : std::size_t(1);
+            std::size_t chunk_size = (size + nb_chunks - 1) / nb_chunks;
+            std::vector<compress_count> counts(nb_chunks);
+
+            auto chunk_first = [chunk_size](std::size_t c) { return c * chunk_size; };
+            auto chunk_last = [chunk_size, size](std::size_t c) { return (std::min)(size, (c + 1) * chunk_size); };
+            parallel_for(std::size_t(0), nb_chunks, std::size_t(1), [&](std::size_t first, std::size_t last) {
+                for (std::size_t c = first; c != last; ++c)
+                {
+                    counts[c] = count_mask(mask, (std::min)(size, chunk_first(c)), chunk_last(c));
+                }
+            });
+
+            std::vector<std::size_t> offsets(nb_chunks + 1, 0);
+            for (std::size_t c = 0; c != nb_chunks; ++c)
+            {
+                offsets[c + 1] = offsets[c] + counts[c].count;
+            }
+            typename R::shape_type shape = {offsets[nb_chunks]};
+            res.resize(shape);
+
+            value_type* dst = res.data();
+            parallel_for(std::size_t(0), nb_chunks, std::size_t(1), [&](std::size_t first, std::size_t last) {
+                for (std::size_t c = first; c != last; ++c)
+                {
+                    if (counts[c].count != 0)
+                    {
+                        compress_range(src, mask, chunk_first(c), counts[c].end, dst + offsets[c]);
+                    }
+                }
+            });
+        }
+    }
+
+    namespace detail
+    {
+        // copies the elements whose bit is set in the packed flags, a block
+        // of bits at a time
+        template <class T, class B, class R>
+        inline void compress_bits(const T* src, const B* blocks, std::size_t size, R& res)
+        {
+            using value_type = typename R::value_type;
+            constexpr std::size_t block_size = 8 * sizeof(B);
+            typename R::shape_type shape = {count_bits(blocks, size)};
+            res.resize(shape);
+
+            value_type* dst = res.data();
+            std::size_t block_count = (size + block_size - 1) / block_size;
+            for (std::size_t b = 0; b != block_count; ++b)
+            {
+                for (B bits = blocks[b]; bits != B(0); bits &= static_cast<B>(bits - 1))
+                {
+                    *dst++ = src[b * block_size + lowest_bit(bits)];
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief returns the elements of \a e where \a condition is true.
+     *
+     * Returns a one-dimensional container holding the elements selected
+     * by \a condition, in row major order, like the evaluation of
+     * \ref filter. When \a e is a contiguous row major expression and the
+     * condition can be iterated linearly along it (e.g. <tt>a > 0</tt>),
+     * the elements are compacted in a single pass over \a e, without
+     * building the indices of the selected elements; large expressions
+     * are processed in parallel, counting the elements selected in every
+     * chunk before copying them. Bit-packed conditions (\ref xarray_bitset)
+     * are consumed a block of bits at a time.
+     *
+     * @param condition xexpression with the shape of \a e
+     * @param e the xexpression to extract the elements from
+     *
+     * \code{.cpp}
+     * xarray<double> a = {{1,5,3}, {4,5,6}};
+     * xtensor<double, 1> b = extract(a >= 5, a);
+     * std::cout << b << std::endl; // {5, 5, 6}
+     * \endcode
+     *
+     * \sa filter
+     */
+    template <class C, class E>
+    inline auto extract(const xexpression<C>& condition, const xexpression<E>& e)
+    {
+        const C& dc = condition.derived_cast();
+        const E& de = e.derived_cast();
+        using value_type = typename E::value_type;
+        using result_type = xtensor<value_type, 1>;
+
+        if (dc.dimension() != de.dimension() || !std::equal(dc.shape().cbegin(), dc.shape().cend(), de.shape().cbegin()))
+        {
+            throw std::runtime_error("extract: condition and expression must have the same shape");
+        }
+
+        result_type res;
+        xtl::mpl::static_if<has_data_interface<E>::value && E::contiguous_layout>([&](auto self)
+        {
+            const auto& se = self(de);
+            bool row_major = se.dimension() < 2 || se.layout() == layout_type::row_major;
+            if (row_major && dc.has_linear_assign(se.strides()))
+            {
+                xtl::mpl::static_if<detail::is_bitset_container<C>::value>([&](auto self_c)
+                {
+                    const auto& sc = self_c(dc);
+                    if (detail::bitset_source<C>::packed(sc, se.size()))
+                    {
+                        detail::compress_bits(se.data() + se.data_offset(), sc.storage().data(), se.size(), res);
+                    }
+                    else
+                    {
+                        detail::compress_linear(se.data() + se.data_offset(), detail::linear_begin(sc), se.size(), res);
+                    }
+                }, /*else*/ [&](auto self_c)
+                {
+                    detail::compress_linear(se.data() + se.data_offset(), detail::linear_begin(self_c(dc)), se.size(), res);
+                });
+            }
+            else
+            {
+                res = filter(se, dc);
+            }
+        }, /*else*/ [&](auto self)
+        {
+            res = filter(self(de), dc);
+        });
+        return res;
+    }
+
+    namespace detail
+    {
+        // The positions gathered or scattered this many elements ahead are
+        // prefetched when the indexed expression does not fit in the caches
+        constexpr std::size_t gather_prefetch_distance = prefetch_distance;
+        constexpr std::size_t gather_prefetch_min_bytes = prefetch_min_bytes;
+
+        template <class T>
+        inline bool use_gather_prefetch(std::size_t size) noexcept
+        {
+            return size * sizeof(T) >= gather_prefetch_min_bytes;
+        }
+
+        template <class I>
+        inline std::size_t normalize_take_index(I i, std::size_t size, std::true_type /*is_signed*/)
+        {
+            return i < I(0) ? static_cast<std::size_t>(static_cast<std::ptrdiff_t>(size) + static_cast<std::ptrdiff_t>(i))
+                            : static_cast<std::size_t>(i);
+        }
+
+        template <class I>
+        inline std::size_t normalize_take_index(I i, std::size_t, std::false_type /*is_signed*/)
+        {
+            return static_cast<std::size_t>(i);
+        }
+
+        // Copies the indices, negative ones counting from the end like in
+        // NumPy, and checks that they are lower than size
+        template <class I>
+        inline std::vector<std::size_t> take_indices(const I& indices, std::size_t size, const char* error)
+        {
+            using index_type = std::decay_t<decltype(*std::begin(indices))>;
+            std::vector<std::size_t> res;
+            res.reserve(static_cast<std::size_t>(std::distance(std::begin(indices), std::end(indices))));
+            bool in_bounds = true;
+            for (auto it = std::begin(indices); it != std::end(indices); ++it)
+            {
+                std::size_t i = normalize_take_index(*it, size, std::is_signed<index_type>());
+                in_bounds &= i < size;
+                res.push_back(i);
+            }
+            if (!in_bounds)
+            {
+                throw std::runtime_error(error);
+            }
+            return res;
+        }
+
+        // dst[k] = src[idx[k]] for k in [first, last)
+        template <class T, class D>
+        inline void gather_range(const T* src, const std::size_t* idx, std::size_t first, std::size_t last,
+                                 D* dst, bool prefetch)
+        {
+            std::size_t k = first;
+            if (prefetch && last - first > gather_prefetch_distance)
+            {
+                for (; k != last - gather_prefetch_distance; ++k)
+                {
+                    prefetch_read(src + idx[k + gather_prefetch_distance]);
+                    dst[k] = src[idx[k]];
+                }
+            }
+            for (; k != last; ++k)
+            {
+                dst[k] = src[idx[k]];
+            }
+        }
+
+        template <class T, class D>
+        inline void gather(const T* src, std::size_t src_size, const std::vector<std::size_t>& idx, D* dst)
+        {
+            bool prefetch = use_gather_prefetch<T>(src_size);
+            if (parallel::use_parallel(idx.size()))
+            {
+                parallel_for(std::size_t(0), idx.size(), parallel::grain(1, 1), [&](std::size_t first, std::size_t last) {
+                    gather_range(src, idx.data(), first, last, dst, prefetch);
+                });
+            }
+            else
+            {
+                gather_range(src, idx.data(), std::size_t(0), idx.size(), dst, prefetch);
+            }
+        }
+
+        // Gathers along an axis of a row major buffer of shape
+        // (outer, axis_size, inner): the result has shape (outer, idx.size(), inner)
+        // and is built by copying rows of inner elements
+        template <class T, class D>
+        inline void gather_axis(const T* src, std::size_t outer, std::size_t axis_size, std::size_t inner,
+                                const std::vector<std::size_t>& idx, D* dst)
+        {
+            std::size_t count = idx.size();
+            if (inner == 1)
+            {
+                bool prefetch = use_gather_prefetch<T>(axis_size);
+                auto gather_rows = [&](std::size_t first, std::size_t last) {
+                    for (std::size_t o = first; o != last; ++o)
+                    {
+                        gather_range(src + o * axis_size, idx.data(), std::size_t(0), count, dst + o * count, prefetch);
+                    }
+                };
+                if (parallel::use_parallel(outer * count))
+                {
+                    parallel_for(std::size_t(0), outer, parallel::grain(count, 1), gather_rows);
+                }
+                else
+                {
+                    gather_rows(std::size_t(0), outer);
+                }
+                return;
+            }
+
+            auto copy_rows = [&](std::size_t first, std::size_t last) {
+                for (std::size_t r = first; r != last; ++r)
+                {
+                    const T* row = src + ((r / count) * axis_size + idx[r % count]) * inner;
+                    std::copy(row, row + inner, dst + r * inner);
+                }
+            };
+            if (parallel::use_parallel(outer * count * inner))
+            {
+                parallel_for(std::size_t(0), outer * count, parallel::grain(inner, 1), copy_rows);
+            }
+            else
+            {
+                copy_rows(std::size_t(0), outer * count);
+            }
+        }
+
+        // Generic gather through the element access of the expression: the k-th
+        // element of the result, of shape res_shape, is the element of e at the
+        // position computed by index(k, position)
+        template <class E, class S, class D, class F>
+        inline void gather_elements(const E& e, const S& res_shape, std::size_t size, D* dst, F index)
+        {
+            using index_type = svector<std::size_t, 4>;
+            auto run = [&](std::size_t first, std::size_t last) {
+                index_type position(res_shape.size());
+                for (std::size_t k = first; k != last; ++k)
+                {
+                    index(k, position);
+                    dst[k] = e.element(position.cbegin(), position.cend());
+                }
+            };
+            if (parallel::use_parallel(size))
+            {
+                parallel_for(std::size_t(0), size, parallel::grain(1, 1), run);
+            }
+            else
+            {
+                run(std::size_t(0), size);
+            }
+        }
+
+        template <class E>
+        using use_take_data = std::integral_constant<bool, has_data_interface<E>::value && E::contiguous_layout &&
+                                                           !is_bitset_container<E>::value>;
+
+        template <class E>
+        inline bool is_row_major_data(const E& e)
+        {
+            return e.dimension() < 2 || e.layout() == layout_type::row_major;
+        }
+    }
+
+    /**
+     * @brief returns the elements of the flattened \a e at \a indices.
+     *
+     * Returns a one-dimensional container holding the elements of
+     * \a e at the positions \a indices in row major order, like
+     * <tt>numpy.take(e, indices)</tt>; negative indices count from
+     * the end. The elements of contiguous row major expressions are
+     * gathered from their buffer, prefetching the positions ahead of the
+     * copy when the buffer does not fit in the caches; large index sets
+     * are gathered in parallel. Unlike \ref index_view, the result owns
+     * its elements.
+     *
+     * @param e the xexpression to take the elements from
+     * @param indices a sequence of integral positions in the flattened \a e
+     *
+     * \code{.cpp}
+     * xarray<double> a = {{1, 5, 3}, {4, 5, 6}};
+     * xtensor<double, 1> b = take(a, std::vector<int>{5, 0, -2});
+     * std::cout << b << std::endl; // {6, 1, 5}
+     * \endcode
+     *
+     * \sa put
+     */
+    template <class E, class I>
+    inline auto take(const xexpression<E>& e, const I& indices)
+    {
+        const E& de = e.derived_cast();
+        using value_type = typename E::value_type;
+        using result_type = xtensor<value_type, 1>;
+
+        std::vector<std::size_t> idx = detail::take_indices(indices, de.size(), "take: index out of bounds");
+        result_type res;
+        typename result_type::shape_type shape = {idx.size()};
+        res.resize(shape);
+
+        xtl::mpl::static_if<detail::use_take_data<E>::value>([&](auto self)
+        {
+            const auto& se = self(de);
+            if (detail::is_row_major_data(se))
+            {
+                detail::gather(se.data() + se.data_offset(), se.size(), idx, res.data());
+            }
+            else
+            {
+                detail::shape_divider divider(se.shape());
+                detail::gather_elements(se, se.shape(), idx.size(), res.data(), [&](std::size_t k, auto& position) {
+                    divider.unravel(idx[k], position);
+                });
+            }
+        }, /*else*/ [&](auto self)
+        {
+            const auto& se = self(de);
+            detail::shape_divider divider(se.shape());
+            detail::gather_elements(se, se.shape(), idx.size(), res.data(), [&](std::size_t k, auto& position) {
+                divider.unravel(idx[k], position);
+            });
+        });
+        return res;
+    }
+
+    /**
+     * @brief returns the slices of \a e at \a indices along \a axis.
+     *
+     * Returns a container whose shape is the shape of \a e where the
+     * extent along \a axis is replaced by the number of \a indices,
+     * like <tt>numpy.take(e, indices, axis)</tt>; negative indices count
+     * from the end. For contiguous row major expressions, the rows of
+     * elements following \a axis are copied as blocks; along the innermost
+     * axis, the elements are gathered within every row. Large results are
+     * built in parallel.
+     *
+     * @param e the xexpression to take the slices from
+     * @param indices a sequence of integral positions along \a axis
+     * @param axis the axis along which the slices are taken
+     *
+     * \code{.cpp}
+     * xarray<double> a = {{1, 5, 3}, {4, 5, 6}};
+     * xarray<double> b = take(a, std::vector<int>{2, 0}, 1);
+     * std::cout << b << std::endl; // {{3, 1}, {6, 4}}
+     * \endcode
+     */
+    template <class E, class I>
+    inline auto take(const xexpression<E>& e, const I& indices, std::size_t axis)
+    {
+        const E& de = e.derived_cast();
+        using value_type = typename E::value_type;
+        using result_type = xarray<value_type>;
+
+        if (axis >= de.dimension())
+        {
+            throw std::runtime_error("take: axis out of bounds");
+        }
+
+        std::size_t axis_size = static_cast<std::size_t>(de.shape()[axis]);
+        std::vector<std::size_t> idx = detail::take_indices(indices, axis_size, "take: index out of bounds");
+        typename result_type::shape_type shape(de.shape().cbegin(), de.shape().cend());
+        shape[axis] = idx.size();
+        result_type res(shape);
+
+        detail::shape_divider divider(shape);
+        auto index = [&](std::size_t k, auto& position) {
+            divider.unravel(k, position);
+            position[axis] = idx[position[axis]];
+        };
+
+        xtl::mpl::static_if<detail::use_take_data<E>::value>([&](auto self)
+        {
+            const auto& se = self(de);
+            if (detail::is_row_major_data(se))
+            {
+                std::size_t outer = std::accumulate(se.shape().cbegin(), se.shape().cbegin() + std::ptrdiff_t(axis),
+                                                    std::size_t(1), std::multiplies<std::size_t>());
+                std::size_t inner = std::accumulate(se.shape().cbegin() + std::ptrdiff_t(axis) + 1, se.shape().cend(),
+                                                    std::size_t(1), std::multiplies<std::size_t>());
+                detail::gather_axis(se.data() + se.data_offset(), outer, axis_size, inner, idx, res.data());
+            }
+            else
+            {
+                detail::gather_elements(se, shape, res.size(), res.data(), index);
+            }
+        }, /*else*/ [&](auto self)
+        {
+            detail::gather_elements(self(de), shape, res.size(), res.data(), index);
+        });
+        return res;
+    }
+
+    namespace detail
+    {
+        // Scatters v(k) to dst[idx[k]], for the indices falling in
+        // [dst_first, dst_last); when an index is repeated, the value of its
+        // last occurrence is written, like with a serial loop.
+        template <class D, class F>
+        inline void scatter_range(D* dst, const std::vector<std::size_t>& idx, std::size_t dst_first,
+                                  std::size_t dst_last, F&& v, bool prefetch)
+        {
+            std::size_t count = idx.size();
+            std::size_t limit = prefetch && count > gather_prefetch_distance ? count - gather_prefetch_distance : 0;
+            for (std::size_t k = 0; k != count; ++k)
+            {
+                if (k < limit)
+                {
+                    std::size_t j = idx[k + gather_prefetch_distance];
+                    if (j >= dst_first && j < dst_last)
+                    {
+                        prefetch_write(dst + j);
+                    }
+                }
+                std::size_t i = idx[k];
+                if (i >= dst_first && i < dst_last)
+                {
+                    dst[i] = v(k);
+                }
+            }
+        }
+
+        // Every task owns a range of the destination and scans all the
+        // indices, so that the writes of the tasks never overlap
+        template <class D, class F>
+        inline void scatter(D* dst, std::size_t size, const std::vector<std::size_t>& idx, F&& v)
+        {
+            bool prefetch = use_gather_prefetch<D>(size);
+            if (parallel::use_parallel(idx.size()) && !parallel::in_parallel_region())
+            {
+                std::size_t nb_parts = 8;
+                std::size_t part_size = (size + nb_parts - 1) / nb_parts;
+                parallel_for(std::size_t(0), nb_parts, std::size_t(1), [&](std::size_t first, std::size_t last) {
+                    scatter_range(dst, idx, first * part_size, (std::min)(size, last * part_size), v, prefetch);
+                });
+            }
+            else
+            {
+                scatter_range(dst, idx, std::size_t(0), size, v, prefetch);
+            }
+        }
+
+        template <class E, class F>
+        inline void put_impl(E& e, const std::vector<std::size_t>& idx, F&& v)
+        {
+            xtl::mpl::static_if<use_take_data<E>::value>([&](auto self)
+            {
+                auto& se = self(e);
+                if (is_row_major_data(se))
+                {
+                    scatter(se.data() + se.data_offset(), se.size(), idx, v);
+                    return;
+                }
+                svector<std::size_t, 4> position(se.dimension());
+                shape_divider divider(se.shape());
+                for (std::size_t k = 0; k != idx.size(); ++k)
+                {
+                    divider.unravel(idx[k], position);
+                    se.element(position.cbegin(), position.cend()) = v(k);
+                }
+            }, /*else*/ [&](auto self)
+            {
+                auto& se = self(e);
+                svector<std::size_t, 4> position(se.dimension());
+                shape_divider divider(se.shape());
+                for (std::size_t k = 0; k != idx.size(); ++k)
+                {
+                    divider.unravel(idx[k], position);
+                    se.element(position.cbegin(), position.cend()) = v(k);
+                }
+            });
+        }
+    }
+
+    /**
+     * @brief assigns \a values to the elements of the flattened \a e at \a indices.
+     *
+     * Like <tt>numpy.put(e, indices, values)</tt>, the k-th index receives
+     * the element <tt>k % values.size()</tt> of \a values in row major
+     * order; negative indices count from the end, and the last
+     * occurrence of a repeated index wins. Contiguous row major
+     * expressions are written through their buffer, prefetching the
+     * positions ahead of the writes for large buffers;
+     * large index sets are scattered in parallel, every task writing
+     * its own range of the buffer.
+     *
+     * @param e the xexpression to write
+     * @param indices a sequence of integral positions in the flattened \a e
+     * @param values the xexpression holding the values to write
+     *
+     * \code{.cpp}
+     * xarray<double> a = {{1, 5, 3}, {4, 5, 6}};
+     * put(a, std::vector<int>{0, -1}, xarray<double>{10, 20});
+     * std::cout << a << std::endl; // {{10, 5, 3}, {4, 5, 20}}
+     * \endcode
+     *
+     * \sa take
+     */
+    template <class E, class I, class V>
+    inline void put(xexpression<E>& e, const I& indices, const xexpression<V>& values)
+    {
+        E& de = e.derived_cast();
+        using value_type = typename E::value_type;
+        std::vector<std::size_t> idx = detail::take_indices(indices, de.size(), "put: index out of bounds");
+        const V& dv = values.derived_cast();
+        std::vector<value_type> v(dv.cbegin(), dv.cend());
+        if (v.empty())
+        {
+            if (!idx.empty())
+            {
+                throw std::runtime_error("put: cannot put empty values");
+            }
+            return;
+        }
+        std::size_t nb_values = v.size();
+        detail::put_impl(de, idx, [&v, nb_values](std::size_t k) -> value_type { return v[k % nb_values]; });
+    }
+
+    /**
+     * @brief assigns \a value to the elements of the flattened \a e at \a indices.
+     *
+     * @param e the xexpression to write
+     * @param indices a sequence of integral positions in the flattened \a e
+     * @param value the scalar to write
+     */
+    template <class E, class I, class T>
+    inline auto put(xexpression<E>& e, const I& indices, const T& value) -> disable_xexpression<T, void>
+    {
+        E& de = e.derived_cast();
+        using value_type = typename E::value_type;
+        std::vector<std::size_t> idx = detail::take_indices(indices, de.size(), "put: index out of bounds");
+        value_type v = static_cast<value_type>(value);
+        detail::put_impl(de, idx, [&v](std::size_t) -> value_type { return v; });
+    }
+
     /**
      * @brief creates a filtration of \c e filtered by \a condition.
      *
@@ -11,6 +11,8 @@
 
 #include <string>
 
+#include "xlayout.hpp"
+
 #ifndef _MSC_VER
 #  if __cplusplus < 201103
 #    define CONSTEXPR11_TN
@@ -0,0 +1,222 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_INSTRUMENT_HPP
+#define XTENSOR_INSTRUMENT_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "xinfo.hpp"
+#include "xtensor_config.hpp"
+
+namespace xt
+{
+
+    /**********
+     * events *
+     **********/
+
+    /**
+     * Instrumentation of the assignment loops and of the reductions. When
+     * XTENSOR_ENABLE_INSTRUMENTATION is defined, these hot paths emit an event
+     * when they start and when they end, which the application can forward to
+     * its tracing framework (Perfetto, ITT, ...) with set_callbacks. Without
+     * the macro, no code is generated.
+     */
+    namespace instrument
+    {
+        enum class event_kind
+        {
+            assign,
+            linear_assign,
+            strided_loop_assign,
+            stepper_assign,
+            reducer_assign,
+            reduce_immediate
+        };
+
+        const char* to_string(event_kind kind) noexcept;
+
+        /**
+         * Event emitted by an instrumented path. ``expression`` is the type of
+         * the assigned or reduced expression; ``shape`` is the shape of the
+         * result of an assignment, or of the reduced expression for a
+         * reduction; ``bytes`` estimates the memory traffic from the sizes of
+         * the value types of the operands. ``elapsed`` is only set in the end
+         * events.
+         */
+        struct event
+        {
+            event_kind kind;
+            std::string expression;
+            std::vector<std::size_t> shape;
+            std::size_t size;
+            std::size_t bytes;
+            std::chrono::nanoseconds elapsed;
+        };
+
+        using callback_type = std::function<void(const event&)>;
+
+        struct callbacks_type
+        {
+            callback_type begin;
+            callback_type end;
+        };
+
+        callbacks_type& callbacks();
+        void set_callbacks(callback_type begin, callback_type end);
+        void reset_callbacks();
+        bool has_callbacks();
+
+        template <class E1, class E2>
+        std::size_t assign_bytes(const E1& e1, const E2& e2) noexcept;
+
+        /**
+         * Emits the begin event of an instrumented path upon construction and
+         * the end event, with the elapsed time, upon destruction. Nothing is
+         * done when no callback is installed.
+         */
+        class scoped_event
+        {
+        public:
+
+            using clock_type = std::chrono::steady_clock;
+
+            template <class E>
+            scoped_event(event_kind kind, const E& e, static_string expression, std::size_t bytes);
+            ~scoped_event();
+
+            scoped_event(const scoped_event&) = delete;
+            scoped_event& operator=(const scoped_event&) = delete;
+
+        private:
+
+            event m_event;
+            clock_type::time_point m_start;
+            bool m_active;
+        };
+    }
+
+#if defined(XTENSOR_ENABLE_INSTRUMENTATION)
+#define XTENSOR_INSTRUMENT_SCOPE(KIND, E, T, BYTES) \
+    ::xt::instrument::scoped_event xtensor_instrument_scope_((KIND), (E), ::xt::type_name<T>(), (BYTES))
+#else
+#define XTENSOR_INSTRUMENT_SCOPE(KIND, E, T, BYTES)
+#endif
+
+    /*************************
+     * events implementation *
+     *************************/
+
+    namespace instrument
+    {
+        inline const char* to_string(event_kind kind) noexcept
+        {
+            switch (kind)
+            {
+                case event_kind::assign:
+                    return "xt::assign";
+                case event_kind::linear_assign:
+                    return "xt::linear_assign";
+                case event_kind::strided_loop_assign:
+                    return "xt::strided_loop_assign";
+                case event_kind::stepper_assign:
+                    return "xt::stepper_assign";
+                case event_kind::reducer_assign:
+                    return "xt::reducer_assign";
+                case event_kind::reduce_immediate:
+                    return "xt::reduce_immediate";
+            }
+            return "xt::unknown";
+        }
+
+        /**
+         * Returns the callbacks installed with set_callbacks, if any.
+         */
+        inline callbacks_type& callbacks()
+        {
+            static callbacks_type cb;
+            return cb;
+        }
+
+        /**
+         * Installs the callbacks called at the beginning and at the end of the
+         * instrumented paths; either of them may be empty. The callbacks are
+         * called on the thread running the path, they must not throw, and they
+         * must not be changed while an instrumented path is running.
+         */
+        inline void set_callbacks(callback_type begin, callback_type end)
+        {
+            callbacks().begin = std::move(begin);
+            callbacks().end = std::move(end);
+        }
+
+        /**
+         * Removes the installed callbacks.
+         */
+        inline void reset_callbacks()
+        {
+            set_callbacks(callback_type(), callback_type());
+        }
+
+        inline bool has_callbacks()
+        {
+            const callbacks_type& cb = callbacks();
+            return static_cast<bool>(cb.begin) || static_cast<bool>(cb.end);
+        }
+
+        /**
+         * Estimates the bytes moved by the assignment of \c e2 to \c e1, as
+         * one read of \c e2 and one write of \c e1 per element.
+         */
+        template <class E1, class E2>
+        inline std::size_t assign_bytes(const E1& e1, const E2&) noexcept
+        {
+            return e1.size() * (sizeof(typename E1::value_type) + sizeof(typename E2::value_type));
+        }
+
+        template <class E>
+        inline scoped_event::scoped_event(event_kind kind, const E& e, static_string expression, std::size_t bytes)
+            : m_event{kind, {}, {}, 0, 0, std::chrono::nanoseconds(0)}, m_start(), m_active(has_callbacks())
+        {
+            if (m_active)
+            {
+                m_event.expression.assign(expression.data, expression.size);
+                m_event.shape.assign(e.shape().cbegin(), e.shape().cend());
+                m_event.size = e.size();
+                m_event.bytes = bytes;
+                const callbacks_type& cb = callbacks();
+                if (cb.begin)
+                {
+                    cb.begin(m_event);
+                }
+                m_start = clock_type::now();
+            }
+        }
+
+        inline scoped_event::~scoped_event()
+        {
+            if (m_active)
+            {
+                m_event.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - m_start);
+                const callbacks_type& cb = callbacks();
+                if (cb.end)
+                {
+                    cb.end(m_event);
+                }
+            }
+        }
+    }
+}
+
+#endif
@@ -16,8 +16,10 @@
 #include <numeric>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "xexpression.hpp"
+#include "xformat.hpp"
 #include "xmath.hpp"
 #include "xstrided_view.hpp"
 
@@ -94,15 +96,21 @@ namespace xt
 
     namespace detail
     {
+        // The elements are accessed through their multi-index rather than
+        // through a view: printing only evaluates the elements which appear in
+        // the output, i.e. the edge items of the summarized axes, and does not
+        // allocate per element.
+        using print_index = std::vector<std::size_t>;
+
         template <class E, class F>
         std::ostream& xoutput(std::ostream& out, const E& e,
-                              xstrided_slice_vector& slices, F& printer, std::size_t blanks,
+                              print_index& index, F& printer, std::size_t blanks,
                               std::streamsize element_width, std::size_t edgeitems, std::size_t line_width)
         {
             using size_type = typename E::size_type;
 
-            const auto view = xt::strided_view(e, slices);
-            if (view.dimension() == 0)
+            std::size_t dimension = e.dimension() - index.size();
+            if (dimension == 0)
             {
                 printer.print_next(out);
             }
@@ -110,37 +118,38 @@ namespace xt
             {
                 std::string indents(blanks, ' ');
 
+                size_type n = static_cast<size_type>(e.shape()[index.size()]);
                 size_type i = 0;
                 size_type elems_on_line = 0;
                 size_type ewp2 = static_cast<size_type>(element_width) + size_type(2);
                 size_type line_lim = static_cast<size_type>(std::floor(line_width / ewp2));
 
                 out << '{';
-                for (; i != size_type(view.shape()[0] - 1); ++i)
+                for (; i != size_type(n - 1); ++i)
                 {
-                    if (edgeitems && size_type(view.shape()[0]) > (edgeitems * 2) && i == edgeitems)
+                    if (edgeitems && n > (edgeitems * 2) && i == edgeitems)
                     {
                         out << "..., ";
-                        if (view.dimension() > 1)
+                        if (dimension > 1)
                         {
                             elems_on_line = 0;
                             out << std::endl
                                 << indents;
                         }
-                        i = size_type(view.shape()[0]) - edgeitems;
+                        i = n - edgeitems;
                     }
-                    if (view.dimension() == 1 && line_lim != 0 && elems_on_line >= line_lim)
+                    if (dimension == 1 && line_lim != 0 && elems_on_line >= line_lim)
                     {
                         out << std::endl
                             << indents;
                         elems_on_line = 0;
                     }
-                    slices.push_back(static_cast<int>(i));
-                    xoutput(out, e, slices, printer, blanks + 1, element_width, edgeitems, line_width) << ',';
-                    slices.pop_back();
+                    index.push_back(static_cast<std::size_t>(i));
+                    xoutput(out, e, index, printer, blanks + 1, element_width, edgeitems, line_width) << ',';
+                    index.pop_back();
                     elems_on_line++;
 
-                    if (view.dimension() == 1)
+                    if (dimension == 1)
                     {
                         out << ' ';
                     }
@@ -150,43 +159,43 @@ namespace xt
                             << indents;
                     }
                 }
-                if (view.dimension() == 1 && line_lim != 0 && elems_on_line >= line_lim)
+                if (dimension == 1 && line_lim != 0 && elems_on_line >= line_lim)
                 {
                     out << std::endl
                         << indents;
                 }
-                slices.push_back(static_cast<int>(i));
-                xoutput(out, e, slices, printer, blanks + 1, element_width, edgeitems, line_width) << '}';
-                slices.pop_back();
+                index.push_back(static_cast<std::size_t>(i));
+                xoutput(out, e, index, printer, blanks + 1, element_width, edgeitems, line_width) << '}';
+                index.pop_back();
             }
             return out;
         }
 
         template <class F, class E>
-        static void recurser_run(F& fn, const E& e, xstrided_slice_vector& slices, std::size_t lim = 0)
+        static void recurser_run(F& fn, const E& e, print_index& index, std::size_t lim = 0)
         {
             using size_type = typename E::size_type;
-            const auto view = strided_view(e, slices);
-            if (view.dimension() == 0)
+            if (index.size() == e.dimension())
             {
-                fn.update(view());
+                fn.update(e.element(index.cbegin(), index.cend()));
             }
             else
             {
+                size_type n = static_cast<size_type>(e.shape()[index.size()]);
                 size_type i = 0;
-                for (; i != static_cast<size_type>(view.shape()[0] - 1); ++i)
+                for (; i != size_type(n - 1); ++i)
                 {
-                    if (lim && size_type(view.shape()[0]) > (lim * 2) && i == lim)
+                    if (lim && n > (lim * 2) && i == lim)
                     {
-                        i = static_cast<size_type>(view.shape()[0]) - lim;
+                        i = n - lim;
                     }
-                    slices.push_back(static_cast<int>(i));
-                    recurser_run(fn, e, slices, lim);
-                    slices.pop_back();
+                    index.push_back(static_cast<std::size_t>(i));
+                    recurser_run(fn, e, index, lim);
+                    index.pop_back();
                 }
-                slices.push_back(static_cast<int>(i));
-                recurser_run(fn, e, slices, lim);
-                slices.pop_back();
+                index.push_back(static_cast<std::size_t>(i));
+                recurser_run(fn, e, index, lim);
+                index.pop_back();
             }
         }
 
@@ -237,51 +246,33 @@ namespace xt
 
             std::ostream& print_next(std::ostream& out)
             {
+                int width = static_cast<int>(m_width);
+                int precision = static_cast<int>(m_precision);
+                m_buffer.clear();
                 if (!m_scientific)
                 {
-                    std::stringstream buf;
-                    buf.width(m_width);
-                    buf << std::fixed;
-                    buf.precision(m_precision);
-                    buf << (*m_it);
+                    detail::format_printf(m_buffer, "%*.*f", width, precision, *m_it);
                     if (!m_required_precision)
                     {
-                        buf << '.';
+                        m_buffer.push_back('.');
                     }
-                    std::string res = buf.str();
-                    auto sit = res.rbegin();
+                    auto sit = m_buffer.rbegin();
                     while (*sit == '0')
                     {
                         *sit = ' ';
                         ++sit;
                     }
-                    out << res;
                 }
                 else
                 {
-                    if (!m_large_exponent)
+                    detail::format_printf(m_buffer, "%*.*e", width, precision, *m_it);
+                    if (m_large_exponent && m_buffer[m_buffer.size() - 4] == 'e')
                     {
-                        out << std::scientific;
-                        out.width(m_width);
-                        out << (*m_it);
-                    }
-                    else
-                    {
-                        std::stringstream buf;
-                        buf.width(m_width);
-                        buf << std::scientific;
-                        buf.precision(m_precision);
-                        buf << (*m_it);
-                        std::string res = buf.str();
-
-                        if (res[res.size() - 4] == 'e')
-                        {
-                            res.erase(0, 1);
-                            res.insert(res.size() - 2, "0");
-                        }
-                        out << res;
+                        m_buffer.erase(0, 1);
+                        m_buffer.insert(m_buffer.size() - 2, "0");
                     }
                 }
+                out.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
                 ++m_it;
                 return out;
             }
@@ -331,6 +322,7 @@ namespace xt
             std::streamsize m_precision;
             std::streamsize m_required_precision = 0;
             value_type m_max = 0;
+            std::string m_buffer;
 
             cache_type m_cache;
             cache_iterator m_it;
@@ -357,8 +349,13 @@ namespace xt
             {
                 // + enables printing of chars etc. as numbers
                 // TODO should chars be printed as numbers?
-                out.width(m_width);
-                out << +(*m_it);
+                char buffer[detail::max_format_length];
+                char* end = detail::format_integer(buffer, +(*m_it));
+                for (std::streamsize n = end - buffer; n < m_width; ++n)
+                {
+                    out.put(' ');
+                }
+                out.write(buffer, end - buffer);
                 ++m_it;
                 return out;
             }
@@ -614,11 +611,11 @@ namespace xt
 
         detail::printer<E> p(precision);
 
-        xstrided_slice_vector sv;
-        detail::recurser_run(p, d, sv, lim);
+        detail::print_index index;
+        index.reserve(d.dimension());
+        detail::recurser_run(p, d, index, lim);
         p.init();
-        sv.clear();
-        xoutput(out, d, sv, p, 1, p.width(), lim, print_options::print_options().line_width);
+        xoutput(out, d, index, p, 1, p.width(), lim, print_options::print_options().line_width);
 
         out.precision(temp_precision);  // restore precision
 
@@ -833,8 +830,8 @@ namespace xt
 
         detail::printer<E> printer(out.precision());
 
-        xstrided_slice_vector slice_vector;
-        detail::recurser_run(printer, expr, slice_vector, edgeitems);
+        detail::print_index index;
+        detail::recurser_run(printer, expr, index, edgeitems);
         printer.init();
 
         compute_nd_table(out, printer, expr, edgeitems);
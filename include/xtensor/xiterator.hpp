@@ -13,7 +13,10 @@
 #include <array>
 #include <cstddef>
 #include <iterator>
+#include <memory>
 #include <numeric>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <xtl/xiterator_base.hpp>
@@ -129,11 +132,20 @@ namespace xt
         template <class R>
         R step_simd();
 
+        template <class R>
+        R step_simd(size_type dim);
+
         value_type step_leading();
+        value_type step_leading(size_type dim);
 
         template <class R>
         void store_simd(const R& vec);
 
+        template <class T>
+        void load_run(size_type dim, size_type n, T* out);
+        template <class T>
+        void store_run(size_type dim, size_type n, const T* in);
+
     private:
 
         storage_type* p_c;
@@ -209,6 +221,10 @@ namespace xt
         void to_begin();
         void to_end(layout_type l);
 
+        template <class T, class EE = xexpression_type>
+        auto load_run(size_type dim, size_type n, T* out)
+            -> decltype(std::declval<const EE&>().prefetch_element(size_type(0)));
+
     private:
 
         xexpression_type* p_e;
@@ -384,6 +400,76 @@ namespace xt
     bool operator<(const xbounded_iterator<It, BIt>& lhs,
                    const xbounded_iterator<It, BIt>& rhs);
 
+    /**********************
+     * xdispatch_iterator *
+     **********************/
+
+    /**
+     * @class xdispatch_iterator
+     * @brief Iterator visiting the elements with a linear iterator when possible.
+     *
+     * The xdispatch_iterator holds a linear iterator, which advances the
+     * storage iterators of the operands, and a stepper based \ref xiterator,
+     * which maintains the multi-index of the current element; the one in use
+     * is chosen when the iterator is built. The linear iterator can only be
+     * used when the elements are visited in the order of the storage of all
+     * the operands, i.e. when they are contiguous with the same layout as the
+     * iteration, or scalars.
+     *
+     * @tparam LI the linear iterator type
+     * @tparam SI the stepper based iterator type
+     */
+    template <class LI, class SI>
+    class xdispatch_iterator : public xtl::xrandom_access_iterator_base<xdispatch_iterator<LI, SI>,
+                                                                        typename SI::value_type,
+                                                                        typename SI::difference_type,
+                                                                        typename SI::pointer,
+                                                                        typename SI::reference>
+    {
+    public:
+
+        using self_type = xdispatch_iterator<LI, SI>;
+
+        using linear_iterator = LI;
+        using stepper_iterator = SI;
+        using value_type = typename SI::value_type;
+        using reference = typename SI::reference;
+        using pointer = typename SI::pointer;
+        using difference_type = typename SI::difference_type;
+        using iterator_category = std::random_access_iterator_tag;
+
+        xdispatch_iterator(LI linear_it, SI stepper_it, bool linear) noexcept;
+
+        self_type& operator++();
+        self_type& operator--();
+
+        self_type& operator+=(difference_type n);
+        self_type& operator-=(difference_type n);
+
+        difference_type operator-(const self_type& rhs) const;
+
+        reference operator*() const;
+
+        bool equal(const self_type& rhs) const;
+        bool less_than(const self_type& rhs) const;
+
+        bool is_linear() const noexcept;
+
+    private:
+
+        linear_iterator m_linear_it;
+        stepper_iterator m_stepper_it;
+        bool m_linear;
+    };
+
+    template <class LI, class SI>
+    bool operator==(const xdispatch_iterator<LI, SI>& lhs,
+                    const xdispatch_iterator<LI, SI>& rhs);
+
+    template <class LI, class SI>
+    bool operator<(const xdispatch_iterator<LI, SI>& lhs,
+                   const xdispatch_iterator<LI, SI>& rhs);
+
     /*****************************
      * linear_begin / linear_end *
      *****************************/
@@ -450,6 +536,125 @@ namespace xt
         }
     }
 
+    /************************
+     * load_run / store_run *
+     ************************/
+
+    namespace detail
+    {
+        // Number of elements of the buffers holding the runs of the inner
+        // dimension (see stepper_assigner).
+        constexpr std::size_t run_buffer_size = 64;
+
+        template <class T>
+        struct run_buffer
+        {
+            // the elements are not initialized
+            run_buffer() noexcept
+            {
+            }
+
+            T data[run_buffer_size];
+        };
+
+        // Prefetches the element an iterator refers to, unless the iterator
+        // returns proxies (e.g. the bits of a bitset)
+        template <class It>
+        inline std::enable_if_t<std::is_lvalue_reference<typename std::iterator_traits<It>::reference>::value>
+        prefetch_element(const It& it, std::false_type /*write*/) noexcept
+        {
+            prefetch_read(std::addressof(*it));
+        }
+
+        template <class It>
+        inline std::enable_if_t<std::is_lvalue_reference<typename std::iterator_traits<It>::reference>::value>
+        prefetch_element(const It& it, std::true_type /*write*/) noexcept
+        {
+            prefetch_write(std::addressof(*it));
+        }
+
+        template <class It, class W>
+        inline std::enable_if_t<!std::is_lvalue_reference<typename std::iterator_traits<It>::reference>::value>
+        prefetch_element(const It& /*it*/, W /*write*/) noexcept
+        {
+        }
+
+        template <class S, class T, class = void_t<>>
+        struct has_load_run : std::false_type
+        {
+        };
+
+        template <class S, class T>
+        struct has_load_run<S, T, void_t<decltype(std::declval<S&>().load_run(std::size_t(0), std::size_t(0), std::declval<T*>()))>>
+            : std::true_type
+        {
+        };
+
+        template <class S, class T, class = void_t<>>
+        struct has_store_run : std::false_type
+        {
+        };
+
+        template <class S, class T>
+        struct has_store_run<S, T, void_t<decltype(std::declval<S&>().store_run(std::size_t(0), std::size_t(0), std::declval<const T*>()))>>
+            : std::true_type
+        {
+        };
+
+        template <class S, class T>
+        inline void load_run_impl(S& stepper, std::size_t dim, std::size_t n, T* out, std::true_type)
+        {
+            stepper.load_run(dim, n, out);
+        }
+
+        template <class S, class T>
+        inline void load_run_impl(S& stepper, std::size_t dim, std::size_t n, T* out, std::false_type)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                out[i] = convert_element<T>(*stepper);
+                stepper.step(dim);
+            }
+        }
+
+        template <class S, class T>
+        inline void store_run_impl(S& stepper, std::size_t dim, std::size_t n, const T* in, std::true_type)
+        {
+            stepper.store_run(dim, n, in);
+        }
+
+        template <class S, class T>
+        inline void store_run_impl(S& stepper, std::size_t dim, std::size_t n, const T* in, std::false_type)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                *stepper = in[i];
+                stepper.step(dim);
+            }
+        }
+
+        /**
+         * Reads the \c n elements of a run along the dimension \c dim into
+         * \c out and steps the stepper \c n times along \c dim, with a single
+         * call to the stepper when it provides load_run.
+         */
+        template <class S, class T>
+        inline void load_run(S& stepper, std::size_t dim, std::size_t n, T* out)
+        {
+            load_run_impl(stepper, dim, n, out, has_load_run<S, T>());
+        }
+
+        /**
+         * Writes the \c n elements of \c in to a run along the dimension
+         * \c dim and steps the stepper \c n times along \c dim.
+         */
+        template <class S, class T>
+        inline void store_run(S& stepper, std::size_t dim, std::size_t n, const T* in)
+        {
+            store_run_impl(stepper, dim, n, in, has_store_run<S, T>());
+        }
+    }
+
     /***************************
      * xstepper implementation *
      ***************************/
@@ -526,6 +731,21 @@ namespace xt
         return reg;
     }
 
+    /**
+     * Loads a batch along the dimension \c dim, or broadcasts the current
+     * element if the stride of \c dim is 0.
+     */
+    template <class C>
+    template <class R>
+    inline R xstepper<C>::step_simd(size_type dim)
+    {
+        if (dim < m_offset || p_c->strides()[dim - m_offset] == 0)
+        {
+            return R(*m_it);
+        }
+        return step_simd<R>();
+    }
+
     template <class C>
     template <class R>
     inline void xstepper<C>::store_simd(const R& vec)
@@ -534,6 +754,66 @@ namespace xt
         m_it += xsimd::revert_simd_traits<R>::size;;
     }
 
+    template <class C>
+    template <class T>
+    inline void xstepper<C>::load_run(size_type dim, size_type n, T* out)
+    {
+        if (dim >= m_offset)
+        {
+            difference_type stride = static_cast<difference_type>(p_c->strides()[dim - m_offset]);
+            size_type i = 0;
+            if (detail::use_stride_prefetch<value_type>(stride) && n > detail::prefetch_distance)
+            {
+                difference_type ahead = static_cast<difference_type>(detail::prefetch_distance) * stride;
+                for (; i < n - detail::prefetch_distance; ++i)
+                {
+                    detail::prefetch_element(m_it + ahead, std::false_type());
+                    out[i] = static_cast<T>(*m_it);
+                    m_it += stride;
+                }
+            }
+            for (; i < n; ++i)
+            {
+                out[i] = static_cast<T>(*m_it);
+                m_it += stride;
+            }
+        }
+        else
+        {
+            std::fill(out, out + n, static_cast<T>(*m_it));
+        }
+    }
+
+    template <class C>
+    template <class T>
+    inline void xstepper<C>::store_run(size_type dim, size_type n, const T* in)
+    {
+        if (dim >= m_offset)
+        {
+            difference_type stride = static_cast<difference_type>(p_c->strides()[dim - m_offset]);
+            size_type i = 0;
+            if (detail::use_stride_prefetch<value_type>(stride) && n > detail::prefetch_distance)
+            {
+                difference_type ahead = static_cast<difference_type>(detail::prefetch_distance) * stride;
+                for (; i < n - detail::prefetch_distance; ++i)
+                {
+                    detail::prefetch_element(m_it + ahead, std::true_type());
+                    *m_it = in[i];
+                    m_it += stride;
+                }
+            }
+            for (; i < n; ++i)
+            {
+                *m_it = in[i];
+                m_it += stride;
+            }
+        }
+        else if (n != 0)
+        {
+            *m_it = in[n - 1];
+        }
+    }
+
     template <class C>
     auto xstepper<C>::step_leading() -> value_type
     {
@@ -541,6 +821,16 @@ namespace xt
         return *m_it;
     }
 
+    template <class C>
+    auto xstepper<C>::step_leading(size_type dim) -> value_type
+    {
+        if (dim >= m_offset)
+        {
+            m_it += p_c->strides()[dim - m_offset];
+        }
+        return *m_it;
+    }
+
     template <>
     template <class S, class IT, class ST>
     void stepper_tools<layout_type::row_major>::increment_stepper(S& stepper,
@@ -928,6 +1218,36 @@ namespace xt
         std::copy(p_e->shape().begin(), p_e->shape().end(), m_index.begin());
     }
 
+    /**
+     * Reads the \c n elements of a run along the dimension \c dim of a
+     * one-dimensional expression which can prefetch its elements (e.g.
+     * an index view), prefetching the element XTENSOR_PREFETCH_DISTANCE
+     * positions ahead of the one which is read.
+     */
+    template <class C, bool is_const>
+    template <class T, class EE>
+    inline auto xindexed_stepper<C, is_const>::load_run(size_type dim, size_type n, T* out)
+        -> decltype(std::declval<const EE&>().prefetch_element(size_type(0)))
+    {
+        if (dim < m_offset)
+        {
+            std::fill(out, out + n, static_cast<T>(**this));
+            return;
+        }
+        auto& position = m_index[dim - m_offset];
+        size_type size = static_cast<size_type>(p_e->shape()[dim - m_offset]);
+        for (size_type i = 0; i < n; ++i)
+        {
+            size_type ahead = static_cast<size_type>(position) + detail::prefetch_distance;
+            if (detail::prefetch_distance != 0 && ahead < size)
+            {
+                p_e->prefetch_element(ahead);
+            }
+            out[i] = static_cast<T>(p_e->element(m_index.cbegin(), m_index.cend()));
+            ++position;
+        }
+    }
+
     /****************************
      * xiterator implementation *
      ****************************/
@@ -1164,6 +1484,123 @@ namespace xt
     {
         return lhs.less_than(rhs);
     }
+
+    /*************************************
+     * xdispatch_iterator implementation *
+     *************************************/
+
+    /**
+     * Builds an iterator using \c linear_it if \c linear is true, else
+     * \c stepper_it; the other one is never used.
+     */
+    template <class LI, class SI>
+    inline xdispatch_iterator<LI, SI>::xdispatch_iterator(LI linear_it, SI stepper_it, bool linear) noexcept
+        : m_linear_it(std::move(linear_it)), m_stepper_it(std::move(stepper_it)), m_linear(linear)
+    {
+    }
+
+    template <class LI, class SI>
+    inline auto xdispatch_iterator<LI, SI>::operator++() -> self_type&
+    {
+        if (m_linear)
+        {
+            ++m_linear_it;
+        }
+        else
+        {
+            ++m_stepper_it;
+        }
+        return *this;
+    }
+
+    template <class LI, class SI>
+    inline auto xdispatch_iterator<LI, SI>::operator--() -> self_type&
+    {
+        if (m_linear)
+        {
+            --m_linear_it;
+        }
+        else
+        {
+            --m_stepper_it;
+        }
+        return *this;
+    }
+
+    template <class LI, class SI>
+    inline auto xdispatch_iterator<LI, SI>::operator+=(difference_type n) -> self_type&
+    {
+        if (m_linear)
+        {
+            m_linear_it += n;
+        }
+        else
+        {
+            m_stepper_it += n;
+        }
+        return *this;
+    }
+
+    template <class LI, class SI>
+    inline auto xdispatch_iterator<LI, SI>::operator-=(difference_type n) -> self_type&
+    {
+        if (m_linear)
+        {
+            m_linear_it -= n;
+        }
+        else
+        {
+            m_stepper_it -= n;
+        }
+        return *this;
+    }
+
+    template <class LI, class SI>
+    inline auto xdispatch_iterator<LI, SI>::operator-(const self_type& rhs) const -> difference_type
+    {
+        return m_linear ? static_cast<difference_type>(m_linear_it - rhs.m_linear_it) : m_stepper_it - rhs.m_stepper_it;
+    }
+
+    template <class LI, class SI>
+    inline auto xdispatch_iterator<LI, SI>::operator*() const -> reference
+    {
+        return m_linear ? *m_linear_it : *m_stepper_it;
+    }
+
+    template <class LI, class SI>
+    inline bool xdispatch_iterator<LI, SI>::equal(const self_type& rhs) const
+    {
+        return m_linear ? m_linear_it == rhs.m_linear_it : m_stepper_it == rhs.m_stepper_it;
+    }
+
+    template <class LI, class SI>
+    inline bool xdispatch_iterator<LI, SI>::less_than(const self_type& rhs) const
+    {
+        return m_linear ? m_linear_it < rhs.m_linear_it : m_stepper_it < rhs.m_stepper_it;
+    }
+
+    /**
+     * Returns true if the iterator advances the linear iterator.
+     */
+    template <class LI, class SI>
+    inline bool xdispatch_iterator<LI, SI>::is_linear() const noexcept
+    {
+        return m_linear;
+    }
+
+    template <class LI, class SI>
+    inline bool operator==(const xdispatch_iterator<LI, SI>& lhs,
+                           const xdispatch_iterator<LI, SI>& rhs)
+    {
+        return lhs.equal(rhs);
+    }
+
+    template <class LI, class SI>
+    inline bool operator<(const xdispatch_iterator<LI, SI>& lhs,
+                          const xdispatch_iterator<LI, SI>& rhs)
+    {
+        return lhs.less_than(rhs);
+    }
 }
 
 #endif
@@ -9,14 +9,30 @@
 #ifndef XTENSOR_JSON_HPP
 #define XTENSOR_JSON_HPP
 
+#include <algorithm>
+#include <complex>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <stdexcept>
+#include <string>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
+#include "xarray.hpp"
 #include "xstrided_view.hpp"
 
+// binary values (CBOR byte strings, MessagePack bin) are available
+// since nlohmann_json 3.8.0
+#if defined(NLOHMANN_JSON_VERSION_MAJOR) && \
+    (NLOHMANN_JSON_VERSION_MAJOR > 3 || (NLOHMANN_JSON_VERSION_MAJOR == 3 && NLOHMANN_JSON_VERSION_MINOR >= 8))
+#define XTENSOR_JSON_BINARY 1
+#endif
+
 namespace xt
 {
     /*************************************
@@ -34,6 +50,20 @@ namespace xt
     enable_xview_semantics<E> from_json(const nlohmann::json&, E&);
     /// @endcond
 
+#if defined(XTENSOR_JSON_BINARY)
+    template <class E>
+    enable_xexpression<E> to_json_binary(nlohmann::json&, const E&);
+
+    template <class E>
+    enable_xexpression<E> from_json_binary(const nlohmann::json&, E&);
+#endif
+
+    template <class T, class I>
+    xarray<T> load_json(I&& input);
+
+    template <class I, class E>
+    void load_json(I&& input, xexpression<E>& e);
+
     /****************************************
      * to_json and from_json implementation *
      ****************************************/
@@ -139,6 +169,8 @@ namespace xt
      * serialization of user-defined types. The method is picked up by
      * argument-dependent lookup.
      *
+     * Binary JSON objects written by to_json_binary are accepted as well.
+     *
      * Note: for converting a JSON object to a value, nlohmann_json requiress
      * the value type to be default constructible, which is typically not the
      * case for expressions with a view semantics. In this case, from_json can
@@ -150,6 +182,13 @@ namespace xt
     template <class E>
     inline enable_xcontainer_semantics<E> from_json(const nlohmann::json& j, E& e)
     {
+#if defined(XTENSOR_JSON_BINARY)
+        if (j.is_object())
+        {
+            from_json_binary(j, e);
+            return;
+        }
+#endif
         auto dimension = detail::json_dimension(j);
         auto s = xtl::make_sequence<typename E::shape_type>(dimension);
         detail::json_shape(j, s);
@@ -165,6 +204,13 @@ namespace xt
     template <class E>
     inline enable_xview_semantics<E> from_json(const nlohmann::json& j, E& e)
     {
+#if defined(XTENSOR_JSON_BINARY)
+        if (j.is_object())
+        {
+            from_json_binary(j, e);
+            return;
+        }
+#endif
         typename E::shape_type s;
         detail::json_shape(j, s);
 
@@ -178,6 +224,463 @@ namespace xt
         detail::from_json_impl(j, e, sv);
     }
     /// @endcond
+
+    /****************************
+     * load_json implementation *
+     ****************************/
+
+    namespace detail
+    {
+        constexpr std::size_t json_unknown_extent = std::numeric_limits<std::size_t>::max();
+
+        // SAX handler writing the numbers of nested JSON arrays at the end of
+        // the storage of a container, overwriting its elements and growing it
+        // when needed; the shape is inferred from the nesting of the arrays.
+        // No document is built, the memory is proportional to the elements.
+        template <class S>
+        class json_sax_loader
+        {
+        public:
+
+            using json_type = nlohmann::json;
+            using value_type = typename S::value_type;
+
+            json_sax_loader(S& storage, std::ptrdiff_t dimension) noexcept
+                : m_storage(storage), m_dimension(dimension)
+            {
+            }
+
+            bool null()
+            {
+                return unsupported("null");
+            }
+
+            bool boolean(bool v)
+            {
+                return push(v);
+            }
+
+            bool number_integer(json_type::number_integer_t v)
+            {
+                return push(v);
+            }
+
+            bool number_unsigned(json_type::number_unsigned_t v)
+            {
+                return push(v);
+            }
+
+            bool number_float(json_type::number_float_t v, const json_type::string_t&)
+            {
+                return push(v);
+            }
+
+            bool string(json_type::string_t&)
+            {
+                return unsupported("string");
+            }
+
+#if defined(XTENSOR_JSON_BINARY)
+            bool binary(json_type::binary_t&)
+            {
+                return unsupported("binary value");
+            }
+#endif
+
+            bool start_object(std::size_t)
+            {
+                return unsupported("object");
+            }
+
+            bool key(json_type::string_t&)
+            {
+                return unsupported("object");
+            }
+
+            bool end_object()
+            {
+                return unsupported("object");
+            }
+
+            bool start_array(std::size_t)
+            {
+                if (m_has_shape && m_counts.size() >= m_shape.size())
+                {
+                    throw std::runtime_error("load_json: the arrays of the document are ragged");
+                }
+                if (!m_counts.empty())
+                {
+                    ++m_counts.back();
+                }
+                m_counts.push_back(0);
+                return true;
+            }
+
+            bool end_array()
+            {
+                std::size_t level = m_counts.size() - 1;
+                std::size_t n = m_counts.back();
+                m_counts.pop_back();
+                if (!m_has_shape)
+                {
+                    // an empty innermost array
+                    set_dimension(level + 1);
+                }
+                if (m_shape[level] == json_unknown_extent)
+                {
+                    m_shape[level] = n;
+                }
+                else if (m_shape[level] != n)
+                {
+                    throw std::runtime_error("load_json: the arrays of the document are ragged");
+                }
+                return true;
+            }
+
+            bool parse_error(std::size_t, const std::string&, const std::exception& ex)
+            {
+                throw std::runtime_error(std::string("load_json: ") + ex.what());
+            }
+
+            std::size_t size() const noexcept
+            {
+                return m_size;
+            }
+
+            const std::vector<std::size_t>& shape() const noexcept
+            {
+                return m_shape;
+            }
+
+        private:
+
+            void set_dimension(std::size_t dimension)
+            {
+                if (m_dimension >= 0 && static_cast<std::size_t>(m_dimension) != dimension)
+                {
+                    throw std::runtime_error("load_json: the dimension of the document does not match the container");
+                }
+                m_has_shape = true;
+                m_shape.assign(dimension, json_unknown_extent);
+            }
+
+            template <class V>
+            bool push(V v)
+            {
+                if (!m_has_shape)
+                {
+                    set_dimension(m_counts.size());
+                }
+                else if (m_counts.size() != m_shape.size())
+                {
+                    throw std::runtime_error("load_json: the arrays of the document are ragged");
+                }
+                if (!m_counts.empty())
+                {
+                    ++m_counts.back();
+                }
+                if (m_size == m_storage.size())
+                {
+                    if (m_size == m_storage.capacity())
+                    {
+                        m_storage.reserve((std::max)(2 * m_size, std::size_t(64)));
+                    }
+                    m_storage.resize(m_size + 1);
+                }
+                m_storage[m_size++] = static_cast<value_type>(v);
+                return true;
+            }
+
+            bool unsupported(const char* kind)
+            {
+                throw std::runtime_error(std::string("load_json: unexpected ") + kind +
+                                         ", only nested arrays of numbers are supported");
+            }
+
+            S& m_storage;
+            std::ptrdiff_t m_dimension;
+            std::size_t m_size = 0;
+            bool m_has_shape = false;
+            std::vector<std::size_t> m_counts;
+            std::vector<std::size_t> m_shape;
+        };
+
+        template <class S, class = void>
+        struct has_storage_reserve : std::false_type
+        {
+        };
+
+        template <class S>
+        struct has_storage_reserve<S, void_t<decltype(std::declval<S&>().reserve(std::size_t(0))),
+                                             decltype(std::declval<const S&>().capacity())>>
+            : std::true_type
+        {
+        };
+
+        // the elements are loaded in the storage of row major containers
+        // that can grow, the other expressions are assigned a loaded xarray
+        template <class E>
+        struct is_json_loadable_container
+            : std::integral_constant<bool, has_container_semantics<E>::value &&
+                                               E::static_layout == layout_type::row_major &&
+                                               has_storage_reserve<typename E::storage_type>::value>
+        {
+        };
+
+        template <class I, class E>
+        inline void load_json_impl(I&& input, E& e, std::true_type /*loadable container*/)
+        {
+            using storage_type = typename E::storage_type;
+            storage_type& storage = e.storage();
+            std::size_t old_size = storage.size();
+            json_sax_loader<storage_type> loader(storage, xt::static_dimension<typename E::shape_type>::value);
+            try
+            {
+                nlohmann::json::sax_parse(std::forward<I>(input), &loader);
+            }
+            catch (...)
+            {
+                // the container keeps its shape, not its elements
+                storage.resize(old_size);
+                throw;
+            }
+            storage.resize(loader.size());
+            e.reshape(loader.shape(), layout_type::row_major);
+        }
+
+        template <class I, class E>
+        inline void load_json_impl(I&& input, E& e, std::false_type /*loadable container*/)
+        {
+            using value_type = std::decay_t<typename E::value_type>;
+            xarray<value_type, layout_type::row_major> res;
+            load_json_impl(std::forward<I>(input), res, std::true_type());
+            if (has_container_semantics<E>::value)
+            {
+                constexpr std::ptrdiff_t dimension = xt::static_dimension<typename E::shape_type>::value;
+                if (dimension >= 0 && static_cast<std::size_t>(dimension) != res.dimension())
+                {
+                    throw std::runtime_error("load_json: the dimension of the document does not match the container");
+                }
+            }
+            else if (res.dimension() != e.dimension() ||
+                     !std::equal(res.shape().cbegin(), res.shape().cend(), e.shape().cbegin()))
+            {
+                throw std::runtime_error("load_json: shape mismatch when loading JSON to view");
+            }
+            e = res;
+        }
+    }
+
+    /**
+     * @brief Loads a JSON document holding nested arrays of numbers.
+     *
+     * Unlike from_json, the document is not parsed into a nlohmann::json
+     * value first: the numbers are written in the result as they are parsed,
+     * and its shape is inferred from the nesting of the arrays, so that the
+     * memory used is proportional to the loaded elements.
+     *
+     * @param input the document, any input accepted by nlohmann::json::sax_parse
+     *        (a std::istream, a std::string, a null-terminated string, etc)
+     * @tparam T the value type of the result
+     * @return an xarray holding the elements of the document
+     * @throw std::runtime_error if the document is invalid, holds values that
+     *        are not numbers or booleans, or ragged arrays
+     */
+    template <class T, class I>
+    inline xarray<T> load_json(I&& input)
+    {
+        xarray<T> res;
+        detail::load_json_impl(std::forward<I>(input), res, detail::is_json_loadable_container<xarray<T>>());
+        return res;
+    }
+
+    /**
+     * @brief Loads a JSON document holding nested arrays of numbers in an
+     * expression.
+     *
+     * The numbers of the document are written in the storage of row major
+     * xarray and xtensor containers, which is reused and grown as needed;
+     * a container already holding as many elements as the document is
+     * loaded without any allocation. The other containers are resized, the
+     * views must have the shape of the document.
+     *
+     * @param input the document, any input accepted by nlohmann::json::sax_parse
+     * @param e the \ref xexpression receiving the elements
+     * @throw std::runtime_error if the document is invalid, or if its
+     *        dimension does not match the container or its shape the view
+     */
+    template <class I, class E>
+    inline void load_json(I&& input, xexpression<E>& e)
+    {
+        E& de = e.derived_cast();
+        detail::load_json_impl(std::forward<I>(input), de, detail::is_json_loadable_container<E>());
+    }
+
+#if defined(XTENSOR_JSON_BINARY)
+
+    /******************************************************
+     * to_json_binary and from_json_binary implementation *
+     ******************************************************/
+
+    namespace detail
+    {
+        template <class T>
+        struct is_json_binary_type
+            : std::integral_constant<bool, std::is_arithmetic<T>::value ||
+                                               (xtl::is_complex<T>::value && std::is_floating_point<typename T::value_type>::value)>
+        {
+        };
+
+        inline char json_host_endianness()
+        {
+            const std::uint16_t one = 1;
+            char first;
+            std::memcpy(&first, &one, 1);
+            return first == 1 ? '<' : '>';
+        }
+
+        // numpy type string: byte order, kind and size, e.g. "<f8"
+        template <class T>
+        inline std::string json_dtype()
+        {
+            char kind = std::is_same<T, bool>::value ? 'b'
+                : std::is_floating_point<T>::value ? 'f'
+                : xtl::is_complex<T>::value ? 'c'
+                : (std::is_signed<T>::value || std::is_same<T, char>::value) ? 'i' : 'u';
+            char order = sizeof(T) == 1 ? '|' : json_host_endianness();
+            return std::string(1, order) + kind + std::to_string(sizeof(T));
+        }
+
+        // reverses the bytes of the components of n values of type T
+        template <class T>
+        inline void json_swap_bytes(std::uint8_t* data, std::size_t n)
+        {
+            constexpr std::size_t component = xtl::is_complex<T>::value ? sizeof(T) / 2 : sizeof(T);
+            std::size_t count = n * sizeof(T) / component;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                std::reverse(data + i * component, data + (i + 1) * component);
+            }
+        }
+
+        template <class E>
+        inline void to_json_binary_impl(nlohmann::json& j, const E& e, std::true_type)
+        {
+            using value_type = std::decay_t<typename E::value_type>;
+            auto&& eval_ex = eval(e);
+            std::vector<std::uint8_t> bytes(sizeof(value_type) * compute_size(eval_ex.shape()));
+            if (eval_ex.layout() == layout_type::row_major || eval_ex.dimension() < 2)
+            {
+                if (!bytes.empty())
+                {
+                    std::memcpy(bytes.data(), eval_ex.data(), bytes.size());
+                }
+            }
+            else
+            {
+                xarray<value_type, layout_type::row_major> row_major_ex = eval_ex;
+                std::memcpy(bytes.data(), row_major_ex.data(), bytes.size());
+            }
+            j = nlohmann::json::object();
+            j["shape"] = std::vector<std::size_t>(eval_ex.shape().cbegin(), eval_ex.shape().cend());
+            j["dtype"] = json_dtype<value_type>();
+            j["data"] = nlohmann::json::binary(std::move(bytes));
+        }
+
+        template <class E>
+        inline void to_json_binary_impl(nlohmann::json&, const E&, std::false_type)
+        {
+            throw std::runtime_error("Binary JSON serialization requires arithmetic or complex value types");
+        }
+
+        template <class E>
+        inline void from_json_binary_impl(const nlohmann::json& j, E& e, std::true_type)
+        {
+            using value_type = std::decay_t<typename E::value_type>;
+            if (!j.is_object() || !j.contains("shape") || !j.contains("dtype") || !j.contains("data") || !j["data"].is_binary())
+            {
+                throw std::runtime_error("Received a JSON that does not contain a binary tensor");
+            }
+            std::string dtype = j["dtype"].get<std::string>();
+            std::string expected = json_dtype<value_type>();
+            if (dtype.size() != expected.size() || !std::equal(dtype.cbegin() + 1, dtype.cend(), expected.cbegin() + 1))
+            {
+                throw std::runtime_error("Binary JSON dtype mismatch: " + dtype + " vs " + expected);
+            }
+            bool swap = dtype[0] != expected[0] && expected[0] != '|';
+
+            std::vector<std::size_t> shape = j["shape"].get<std::vector<std::size_t>>();
+            const auto& bytes = j["data"].get_binary();
+            std::size_t size = compute_size(shape);
+            if (bytes.size() != size * sizeof(value_type))
+            {
+                throw std::runtime_error("Binary JSON data size does not match its shape");
+            }
+
+            xarray<value_type, layout_type::row_major> res(shape);
+            if (size != 0)
+            {
+                std::memcpy(res.data(), bytes.data(), bytes.size());
+            }
+            if (swap)
+            {
+                json_swap_bytes<value_type>(reinterpret_cast<std::uint8_t*>(res.data()), size);
+            }
+            if (has_container_semantics<E>::value)
+            {
+                e = std::move(res);
+            }
+            else
+            {
+                if (shape.size() != e.dimension() || !std::equal(shape.cbegin(), shape.cend(), e.shape().cbegin()))
+                {
+                    throw std::runtime_error("Shape mismatch when deserializing JSON to view");
+                }
+                e = res;
+            }
+        }
+
+        template <class E>
+        inline void from_json_binary_impl(const nlohmann::json&, E&, std::false_type)
+        {
+            throw std::runtime_error("Binary JSON deserialization requires arithmetic or complex value types");
+        }
+    }
+
+    /**
+     * @brief Binary JSON serialization of an xtensor expression.
+     *
+     * The expression is stored as an object holding its shape, its numpy
+     * type string (e.g. "<f8") and its elements in row-major order as a
+     * single binary value. Encoded with nlohmann::json::to_cbor or
+     * nlohmann::json::to_msgpack, the elements are written as raw bytes.
+     *
+     * @param j a JSON object
+     * @param e a const \ref xexpression
+     */
+    template <class E>
+    inline enable_xexpression<E> to_json_binary(nlohmann::json& j, const E& e)
+    {
+        detail::to_json_binary_impl(j, e, detail::is_json_binary_type<std::decay_t<typename E::value_type>>());
+    }
+
+    /**
+     * @brief Deserialization of a binary JSON object written by to_json_binary.
+     *
+     * Containers are resized, views must have the shape of the stored tensor.
+     * The type string must match the value type of the expression, except
+     * for the byte order which is converted if needed.
+     *
+     * @param j a const JSON object
+     * @param e an \ref xexpression
+     */
+    template <class E>
+    inline enable_xexpression<E> from_json_binary(const nlohmann::json& j, E& e)
+    {
+        detail::from_json_binary_impl(j, e, detail::is_json_binary_type<std::decay_t<typename E::value_type>>());
+    }
+
+#endif
 }
 
 #endif
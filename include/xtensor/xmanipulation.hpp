@@ -10,6 +10,11 @@
 #ifndef XTENSOR_MANIPULATION_HPP
 #define XTENSOR_MANIPULATION_HPP
 
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include "xparallel.hpp"
 #include "xstrided_view.hpp"
 #include "xutils.hpp"
 
@@ -544,6 +549,288 @@ namespace xt
         return result;
     }
 
+    namespace detail
+    {
+        /**
+         * Copies the contiguous blocks of a split or a concatenation, each
+         * segment being a block of a source and its destination. The copy is
+         * distributed by ranges of elements, so that it is balanced even if
+         * the axis is the first one (one block per part).
+         */
+        template <class S, class D>
+        class block_copier
+        {
+        public:
+
+            void push_back(const S* src, D* dst, std::size_t size)
+            {
+                if (size != 0)
+                {
+                    m_src.push_back(src);
+                    m_dst.push_back(dst);
+                    m_first.push_back(m_size);
+                    m_size += size;
+                }
+            }
+
+            void run() const
+            {
+#if defined(XTENSOR_PARALLEL_ENABLED)
+                if (parallel::use_parallel(m_size))
+                {
+                    parallel_for(std::size_t(0), m_size, parallel::grain(1, 1),
+                                 [this](std::size_t first, std::size_t last) { copy(first, last); });
+                    return;
+                }
+#endif
+                copy(std::size_t(0), m_size);
+            }
+
+        private:
+
+            void copy(std::size_t first, std::size_t last) const
+            {
+                std::size_t i = static_cast<std::size_t>(std::upper_bound(m_first.cbegin(), m_first.cend(), first) - m_first.cbegin()) - 1;
+                while (first < last)
+                {
+                    std::size_t end = i + 1 < m_first.size() ? m_first[i + 1] : m_size;
+                    std::size_t block_last = std::min(last, end);
+                    std::size_t offset = first - m_first[i];
+                    std::copy(m_src[i] + offset, m_src[i] + offset + (block_last - first), m_dst[i] + offset);
+                    first = block_last;
+                    ++i;
+                }
+            }
+
+            std::vector<const S*> m_src;
+            std::vector<D*> m_dst;
+            std::vector<std::size_t> m_first;
+            std::size_t m_size = 0;
+        };
+
+        template <class E>
+        inline bool is_row_major_buffer(const E& e, std::true_type /*data interface*/)
+        {
+            dynamic_shape<std::ptrdiff_t> strides(e.shape().size());
+            compute_strides(e.shape(), layout_type::row_major, strides);
+            for (std::size_t i = 0; i < strides.size(); ++i)
+            {
+                if (e.shape()[i] != 1 && strides[i] != static_cast<std::ptrdiff_t>(e.strides()[i]))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        template <class E>
+        inline bool is_row_major_buffer(const E& /*e*/, std::false_type /*data interface*/)
+        {
+            return false;
+        }
+
+        template <class E>
+        inline bool is_row_major_buffer(const E& e)
+        {
+            return is_row_major_buffer(e, has_data_interface<E>());
+        }
+
+        template <class E, class O>
+        inline std::size_t check_part(const E& e, const O& part, std::size_t axis)
+        {
+            if (part.dimension() != e.dimension())
+            {
+                throw std::runtime_error("split_into / concatenate_into: the parts must have the dimension of the expression");
+            }
+            for (std::size_t i = 0; i < e.dimension(); ++i)
+            {
+                if (i != axis && static_cast<std::size_t>(part.shape()[i]) != static_cast<std::size_t>(e.shape()[i]))
+                {
+                    throw std::runtime_error("split_into / concatenate_into: the parts must have the shape of the expression, except along axis");
+                }
+            }
+            return static_cast<std::size_t>(part.shape()[axis]);
+        }
+
+        // Collects the blocks of each part of the split of a row major
+        // buffer e along an axis: the parts are blocked by the elements before
+        // the axis, each block holding the elements of the part along and
+        // after the axis.
+        template <class E, class P, class F>
+        inline void for_each_block(E& e, P& parts, std::size_t axis, F&& f)
+        {
+            std::size_t outer = 1;
+            for (std::size_t i = 0; i < axis; ++i)
+            {
+                outer *= static_cast<std::size_t>(e.shape()[i]);
+            }
+            std::size_t inner = 1;
+            for (std::size_t i = axis + 1; i < e.dimension(); ++i)
+            {
+                inner *= static_cast<std::size_t>(e.shape()[i]);
+            }
+            std::size_t line = static_cast<std::size_t>(e.shape()[axis]) * inner;
+            for (std::size_t o = 0; o < outer; ++o)
+            {
+                std::size_t offset = o * line;
+                for (auto& part : parts)
+                {
+                    std::size_t size = static_cast<std::size_t>(part.shape()[axis]) * inner;
+                    f(part, offset, o * size, size);
+                    offset += size;
+                }
+            }
+        }
+
+        template <class E, class P>
+        struct split_assigner
+        {
+            using part_type = typename P::value_type;
+            using buffers = std::integral_constant<bool, has_data_interface<E>::value && has_data_interface<part_type>::value>;
+
+            template <class V>
+            static void assign(part_type& part, V& v)
+            {
+                assign_xexpression(part, v);
+            }
+
+            static void copy_blocks(E& e, P& parts, std::size_t axis)
+            {
+                block_copier<typename E::value_type, typename part_type::value_type> copier;
+                const auto* src = e.data() + e.data_offset();
+                for_each_block(e, parts, axis, [&](part_type& part, std::size_t offset, std::size_t part_offset, std::size_t size) {
+                    copier.push_back(src + offset, part.data() + part.data_offset() + part_offset, size);
+                });
+                copier.run();
+            }
+        };
+
+        template <class E, class P>
+        struct concatenate_assigner
+        {
+            using part_type = typename P::value_type;
+            using buffers = std::integral_constant<bool, has_data_interface<E>::value && has_data_interface<part_type>::value>;
+
+            template <class V>
+            static void assign(const part_type& part, V& v)
+            {
+                assign_xexpression(v, part);
+            }
+
+            static void copy_blocks(E& e, const P& parts, std::size_t axis)
+            {
+                block_copier<typename part_type::value_type, typename E::value_type> copier;
+                auto* dst = e.data() + e.data_offset();
+                for_each_block(e, parts, axis, [&](const part_type& part, std::size_t offset, std::size_t part_offset, std::size_t size) {
+                    copier.push_back(part.data() + part.data_offset() + part_offset, dst + offset, size);
+                });
+                copier.run();
+            }
+        };
+
+        template <class A, class E, class P>
+        inline bool copy_part_blocks(E& e, P& parts, std::size_t axis, std::true_type /*buffers*/)
+        {
+            bool buffers = is_row_major_buffer(e);
+            for (const auto& part : parts)
+            {
+                buffers = buffers && is_row_major_buffer(part);
+            }
+            if (buffers)
+            {
+                A::copy_blocks(e, parts, axis);
+            }
+            return buffers;
+        }
+
+        template <class A, class E, class P>
+        inline bool copy_part_blocks(E&, P&, std::size_t, std::false_type /*buffers*/)
+        {
+            return false;
+        }
+
+        // Assigns the parts of the split of e along axis, or assigns e from
+        // them, with the assigner A
+        template <class A, class E, class P>
+        inline void copy_parts(E& e, P& parts, std::size_t axis)
+        {
+            if (axis >= e.dimension())
+            {
+                throw std::runtime_error("split_into / concatenate_into: axis out of bounds");
+            }
+            std::size_t n = 0;
+            for (const auto& part : parts)
+            {
+                n += check_part(e, part, axis);
+            }
+            if (n != static_cast<std::size_t>(e.shape()[axis]))
+            {
+                throw std::runtime_error("split_into / concatenate_into: the sizes of the parts along axis must sum to the size of the expression");
+            }
+
+            if (!copy_part_blocks<A>(e, parts, axis, typename A::buffers()))
+            {
+                xstrided_slice_vector sv(e.dimension(), all());
+                std::size_t first = 0;
+                for (auto& part : parts)
+                {
+                    std::size_t size = static_cast<std::size_t>(part.shape()[axis]);
+                    sv[axis] = range(first, first + size);
+                    auto v = strided_view(e, sv);
+                    A::assign(part, v);
+                    first += size;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Copies the parts of an xexpression split along axis into preallocated containers.
+     *
+     * The sizes of the parts along \c axis are given by the shapes of the
+     * containers, that must sum to the size of \c e, the other dimensions
+     * being those of \c e. When \c e and the parts are row major buffers, the
+     * contiguous blocks are copied directly (in parallel if enabled), the parts
+     * are assigned strided views of \c e otherwise.
+     *
+     * \code{.cpp}
+     * xt::xarray<double> a = xt::arange<double>(12);
+     * a.reshape({3, 4});
+     * std::vector<xt::xarray<double>> parts = {xt::xarray<double>::from_shape({3, 1}),
+     *                                          xt::xarray<double>::from_shape({3, 3})};
+     * xt::split_into(a, parts, 1);
+     * // => parts[1] = {{1, 2, 3}, {5, 6, 7}, {9, 10, 11}}
+     * \endcode
+     *
+     * @param e the input xexpression
+     * @param parts a sequence of containers receiving the parts
+     * @param axis the axis along which the expression is split
+     */
+    template <class E, class P>
+    inline void split_into(const xexpression<E>& e, P& parts, std::size_t axis = 0)
+    {
+        detail::copy_parts<detail::split_assigner<const E, P>>(e.derived_cast(), parts, axis);
+    }
+
+    /**
+     * @brief Concatenates a sequence of xexpressions along axis into a preallocated container.
+     *
+     * The inputs must have the shape of \c out, except along \c axis where their
+     * sizes must sum to the size of \c out. When \c out and the inputs are
+     * row major buffers, the contiguous blocks are copied directly (in
+     * parallel if enabled); the inputs are assigned to strided views of \c out
+     * otherwise. Unlike \ref concatenate, the inputs have the same type.
+     *
+     * @param inputs a sequence of xexpressions
+     * @param out the container receiving the concatenation
+     * @param axis the axis along which the inputs are concatenated
+     */
+    template <class P, class E>
+    inline void concatenate_into(const P& inputs, xexpression<E>& out, std::size_t axis = 0)
+    {
+        detail::copy_parts<detail::concatenate_assigner<E, P>>(out.derived_cast(), inputs, axis);
+    }
+
     /**
      * @brief Reverse the order of elements in an xexpression along the given axis.
      * Note: A NumPy/Matlab style `flipud(arr)` is equivalent to `xt::flip(arr, 0)`,
@@ -574,6 +861,54 @@ namespace xt
         return strided_view(std::forward<E>(e), std::move(shape), std::move(strides), offset);
     }
 
+    /**
+     * @brief Returns a view of the sliding windows of an xexpression along the given axis.
+     *
+     * The view has the shape of \c e, where the size of \c axis is replaced with
+     * the number of windows, and an additional last dimension of size \c window
+     * indexing the elements of each window. The last dimension reuses the stride of
+     * \c axis, so that no copy is made:
+     *
+     * \code{.cpp}
+     * xt::xarray<double> a = {1, 2, 3, 4, 5};
+     * auto v = xt::sliding_window_view(a, 3, 0);
+     * // => v = {{1, 2, 3}, {2, 3, 4}, {3, 4, 5}}
+     * \endcode
+     *
+     * @param e the input xexpression
+     * @param window the size of the windows
+     * @param axis the axis along which the windows slide
+     *
+     * @return returns a strided view of the windows
+     */
+    template <class E>
+    inline auto sliding_window_view(E&& e, std::size_t window, std::size_t axis)
+    {
+        if (axis >= e.dimension())
+        {
+            throw std::runtime_error("sliding_window_view: axis out of bounds");
+        }
+        if (window == 0 || window > e.shape()[axis])
+        {
+            throw std::runtime_error("sliding_window_view: window must be in [1, shape[axis]]");
+        }
+
+        using shape_type = dynamic_shape<std::size_t>;
+
+        shape_type shape(e.dimension() + 1);
+        std::copy(e.shape().cbegin(), e.shape().cend(), shape.begin());
+        shape[axis] -= window - 1;
+        shape.back() = window;
+
+        get_strides_t<shape_type> strides(e.dimension() + 1);
+        decltype(auto) old_strides = detail::get_strides(e);
+        std::copy(old_strides.cbegin(), old_strides.cend(), strides.begin());
+        strides.back() = old_strides[axis];
+
+        std::size_t offset = detail::get_offset(e);
+        return strided_view(std::forward<E>(e), std::move(shape), std::move(strides), offset);
+    }
+
     template <std::ptrdiff_t N>
     struct rot90_impl;
 
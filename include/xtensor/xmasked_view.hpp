@@ -10,9 +10,21 @@
 #ifndef XTENSOR_XMASKED_VIEW_HPP
 #define XTENSOR_XMASKED_VIEW_HPP
 
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+
+#include "xarray.hpp"
 #include "xmasked_value.hpp"
 #include "xexpression.hpp"
 #include "xiterable.hpp"
+#include "xmath.hpp"
+#include "xnoalias.hpp"
+#include "xoperation.hpp"
+#include "xoptional.hpp"
+#include "xreducer.hpp"
 #include "xutils.hpp"
 #include "xshape.hpp"
 #include "xsemantic.hpp"
@@ -230,6 +242,35 @@ namespace xt
         template <class E>
         disable_xexpression<E, self_type>& operator=(const E& e);
 
+        using semantic_base::operator+=;
+        using semantic_base::operator-=;
+        using semantic_base::operator*=;
+        using semantic_base::operator/=;
+        using semantic_base::operator%=;
+        using semantic_base::operator&=;
+        using semantic_base::operator|=;
+        using semantic_base::operator^=;
+
+        template <class E>
+        self_type& operator+=(const xexpression<E>& e);
+        template <class E>
+        self_type& operator-=(const xexpression<E>& e);
+        template <class E>
+        self_type& operator*=(const xexpression<E>& e);
+        template <class E>
+        self_type& operator/=(const xexpression<E>& e);
+        template <class E>
+        self_type& operator%=(const xexpression<E>& e);
+        template <class E>
+        self_type& operator&=(const xexpression<E>& e);
+        template <class E>
+        self_type& operator|=(const xexpression<E>& e);
+        template <class E>
+        self_type& operator^=(const xexpression<E>& e);
+
+        template <class E, class F>
+        self_type& scalar_computed_assign(const E& e, F&& f);
+
     private:
 
         CTD m_data;
@@ -237,6 +278,15 @@ namespace xt
 
         void assign_temporary_impl(temporary_type&& tmp);
 
+        template <class E, class F>
+        self_type& computed_blend(const E& e, F&& f, std::true_type);
+
+        template <class E, class F>
+        self_type& computed_blend(const E& e, F&& f, std::false_type);
+
+        template <class CT, class F>
+        self_type& computed_blend(const xscalar<CT>& e, F&& f, std::false_type);
+
         friend class xiterable<xmasked_view<CTD, CTM>>;
         friend class xconst_iterable<xmasked_view<CTD, CTM>>;
         friend class xview_semantic<xmasked_view<CTD, CTM>>;
@@ -288,6 +338,203 @@ namespace xt
         mask_stepper m_ms;
     };
 
+    namespace detail
+    {
+        /*******************
+         * masked blending *
+         *******************/
+
+        // The assignments through a masked view blend the new values into
+        // the data with xt::where, on the value and flag expressions of
+        // optional data, instead of assigning xmasked_value proxies.
+
+        template <class D, class E>
+        struct use_masked_blend
+            : std::integral_constant<bool, !is_xmasked_value<typename E::value_type>::value &&
+                                           (std::is_same<xexpression_tag_t<D>, xoptional_expression_tag>::value ||
+                                            std::is_same<xexpression_tag_t<E>, xtensor_expression_tag>::value)>
+        {
+        };
+
+        struct masked_replace
+        {
+            template <class T1, class T2>
+            const T2& operator()(const T1& /*data*/, const T2& e) const noexcept
+            {
+                return e;
+            }
+        };
+
+        // the operands are evaluated before being blended since they may
+        // depend on the data of the view
+        template <class D, class E>
+        inline auto masked_operand(const D& data, const E& e)
+        {
+            using temporary_type = typename D::temporary_type;
+            return temporary_type(broadcast(e, data.shape()));
+        }
+
+        template <class D, class CT>
+        inline const xscalar<CT>& masked_operand(const D& /*data*/, const xscalar<CT>& e) noexcept
+        {
+            return e;
+        }
+
+        template <class D, class M>
+        using use_masked_bits = std::integral_constant<bool, is_bitset_container<M>::value &&
+                                                             std::is_base_of<xcontainer<D>, D>::value>;
+
+        // Packed masks stored in the order of contiguous data are consumed a
+        // block of bits at a time: the empty blocks are skipped and the full
+        // ones are assigned without testing their bits.
+        template <class D, class M, class V>
+        inline bool masked_blend_bits(D& data, const M& mask, const V& values, std::true_type)
+        {
+            using block_type = typename bitset_source<M>::block_type;
+            constexpr std::size_t block_size = 8 * sizeof(block_type);
+            constexpr block_type full = static_cast<block_type>(~block_type(0));
+
+            std::size_t size = static_cast<std::size_t>(data.size());
+            if (mask.dimension() != data.dimension() ||
+                !std::equal(mask.shape().cbegin(), mask.shape().cend(), data.shape().cbegin()) ||
+                !bitset_source<M>::packed(mask, size) || !mask.has_linear_assign(data.strides()) ||
+                !values.has_linear_assign(data.strides()))
+            {
+                return false;
+            }
+
+            auto* dst = data.data() + data.data_offset();
+            const block_type* blocks = mask.storage().data();
+            auto src = linear_begin(values);
+            std::size_t block_count = (size + block_size - 1) / block_size;
+            for (std::size_t b = 0; b != block_count; ++b)
+            {
+                std::size_t first = b * block_size;
+                block_type bits = blocks[b];
+                if (bits == full)
+                {
+                    auto it = src;
+                    it += static_cast<std::ptrdiff_t>(first);
+                    for (std::size_t i = first; i != first + block_size; ++i, ++it)
+                    {
+                        dst[i] = *it;
+                    }
+                    continue;
+                }
+                for (; bits != block_type(0); bits &= static_cast<block_type>(bits - 1))
+                {
+                    std::size_t i = first + lowest_bit(bits);
+                    auto it = src;
+                    it += static_cast<std::ptrdiff_t>(i);
+                    dst[i] = *it;
+                }
+            }
+            return true;
+        }
+
+        template <class D, class M, class V>
+        inline bool masked_blend_bits(D& /*data*/, const M& /*mask*/, const V& /*values*/, std::false_type)
+        {
+            return false;
+        }
+
+        template <class D, class M, class E, class F, class FF>
+        inline void masked_blend(D&& data, const M& mask, const E& e, F& f, FF& /*ff*/, xtensor_expression_tag)
+        {
+            const auto& operand = masked_operand(data, e);
+            if (!masked_blend_bits(data, mask, f(data, operand), use_masked_bits<std::decay_t<D>, M>()))
+            {
+                noalias(data) = where(mask, f(data, operand), data);
+            }
+        }
+
+        template <class D, class M, class E, class F, class FF>
+        inline void masked_blend(D&& data, const M& mask, const E& e, F& f, FF& ff, xoptional_expression_tag)
+        {
+            masked_blend(xt::value(data), mask, xt::value(e), f, ff, xtensor_expression_tag());
+            masked_blend(xt::has_value(data), mask, xt::has_value(e), ff, ff, xtensor_expression_tag());
+        }
+
+        /*********************
+         * masked reductions *
+         *********************/
+
+        template <class V, class M>
+        inline bool masked_buffers(const V& values, const M& visible, std::true_type)
+        {
+            return values.size() == visible.size() && visible.has_linear_assign(values.strides());
+        }
+
+        template <class V, class M>
+        inline bool masked_buffers(const V&, const M&, std::false_type)
+        {
+            return false;
+        }
+
+        // The hidden values are replaced with the identity of the reduction by
+        // a branch-free blend into a buffer, that the contiguous kernels of
+        // the reducers consume with simd batches.
+        template <class T, class VI, class MI, class RF, class MF>
+        inline T masked_accumulate(VI values, MI visible, std::size_t n, T identity,
+                                   RF& reduce_fct, MF& merge_fct, std::size_t& count)
+        {
+            constexpr std::size_t chunk_size = 256;
+            alignas(XTENSOR_CACHE_LINE_SIZE) T buffer[chunk_size];
+            xtl::identity init_fct;
+            T res = identity;
+            for (std::size_t first = 0; first < n; first += chunk_size)
+            {
+                std::size_t size = (std::min)(chunk_size, n - first);
+                for (std::size_t i = 0; i < size; ++i, ++values, ++visible)
+                {
+                    bool flag = static_cast<bool>(*visible);
+                    buffer[i] = flag ? static_cast<T>(*values) : identity;
+                    count += static_cast<std::size_t>(flag);
+                }
+                res = merge_fct(res, reduce_contiguous_serial<T>(buffer, size, reduce_fct, init_fct, merge_fct, std::false_type()));
+            }
+            return res;
+        }
+
+        template <class T, class V, class M, class RF>
+        inline T masked_reduce_values(const V& values, const M& visible, T identity, RF reduce_fct, std::size_t& count)
+        {
+            using use_buffers = std::integral_constant<bool, has_data_interface<V>::value && conversion_source<V>::value &&
+                                                             has_data_interface<M>::value && conversion_source<M>::value>;
+            std::size_t n = static_cast<std::size_t>(values.size());
+            if (masked_buffers(values, visible, use_buffers()))
+            {
+                return masked_accumulate(conversion_source<V>::data(values), conversion_source<M>::data(visible),
+                                         n, identity, reduce_fct, reduce_fct, count);
+            }
+            return masked_accumulate(values.cbegin(), visible.cbegin(values.shape()),
+                                     n, identity, reduce_fct, reduce_fct, count);
+        }
+
+        template <class T, class CTD, class CTM, class RF>
+        inline T masked_reduce(const xmasked_view<CTD, CTM>& e, T identity, RF reduce_fct, std::size_t& count, xtensor_expression_tag)
+        {
+            return masked_reduce_values(e.value(), e.visible(), identity, reduce_fct, count);
+        }
+
+        // the missing values of optional data are hidden as well
+        template <class T, class CTD, class CTM, class RF>
+        inline T masked_reduce(const xmasked_view<CTD, CTM>& e, T identity, RF reduce_fct, std::size_t& count, xoptional_expression_tag)
+        {
+            xarray<bool> visible = e.visible() && xt::has_value(e.value());
+            return masked_reduce_values(xt::value(e.value()), visible, identity, reduce_fct, count);
+        }
+
+        template <class CTD, class CTM, class T, class RF>
+        inline T masked_reduce(const xmasked_view<CTD, CTM>& e, T identity, RF reduce_fct, std::size_t& count)
+        {
+            return masked_reduce(e, identity, reduce_fct, count, xexpression_tag_t<std::decay_t<CTD>>());
+        }
+
+        template <class CTD>
+        using masked_value_t = typename std::decay_t<decltype(xt::value(std::declval<const std::decay_t<CTD>&>()))>::value_type;
+    }
+
     /*******************************
      * xmasked_view implementation *
      *******************************/
@@ -379,7 +626,7 @@ namespace xt
     template <class T>
     inline void xmasked_view<CTD, CTM>::fill(const T& value)
     {
-        std::fill(this->begin(), this->end(), value);
+        *this = value;
     }
 
     /**
@@ -647,17 +894,70 @@ namespace xt
     template <class E>
     inline auto xmasked_view<CTD, CTM>::operator=(const xexpression<E>& e) -> self_type&
     {
-        return semantic_base::operator=(e);
+        return computed_blend(e.derived_cast(), detail::masked_replace(), detail::use_masked_blend<data_type, E>());
     }
 
     template <class CTD, class CTM>
     template <class E>
     inline auto xmasked_view<CTD, CTM>::operator=(const E& e) -> disable_xexpression<E, self_type>&
     {
-        std::fill(this->begin(), this->end(), e);
+        return computed_blend(xscalar<E>(e), detail::masked_replace(), detail::use_masked_blend<data_type, xscalar<E>>());
+    }
+
+#define XTENSOR_MASKED_COMPUTED_ASSIGN(OP, FUNCTOR)                                                                   \
+    template <class CTD, class CTM>                                                                                   \
+    template <class E>                                                                                                \
+    inline auto xmasked_view<CTD, CTM>::operator OP(const xexpression<E>& e) -> self_type&                            \
+    {                                                                                                                 \
+        return computed_blend(e.derived_cast(), FUNCTOR(), detail::use_masked_blend<data_type, E>());                \
+    }
+
+    XTENSOR_MASKED_COMPUTED_ASSIGN(+=, std::plus<>)
+    XTENSOR_MASKED_COMPUTED_ASSIGN(-=, std::minus<>)
+    XTENSOR_MASKED_COMPUTED_ASSIGN(*=, std::multiplies<>)
+    XTENSOR_MASKED_COMPUTED_ASSIGN(/=, std::divides<>)
+    XTENSOR_MASKED_COMPUTED_ASSIGN(%=, std::modulus<>)
+    XTENSOR_MASKED_COMPUTED_ASSIGN(&=, std::bit_and<>)
+    XTENSOR_MASKED_COMPUTED_ASSIGN(|=, std::bit_or<>)
+    XTENSOR_MASKED_COMPUTED_ASSIGN(^=, std::bit_xor<>)
+
+#undef XTENSOR_MASKED_COMPUTED_ASSIGN
+
+    template <class CTD, class CTM>
+    template <class E, class F>
+    inline auto xmasked_view<CTD, CTM>::scalar_computed_assign(const E& e, F&& f) -> self_type&
+    {
+        return computed_blend(xscalar<E>(e), std::forward<F>(f), detail::use_masked_blend<data_type, xscalar<E>>());
+    }
+
+    // the visible values are blended, and so are the flags of optional data,
+    // which computed assignments combine with a logical and
+    template <class CTD, class CTM>
+    template <class E, class F>
+    inline auto xmasked_view<CTD, CTM>::computed_blend(const E& e, F&& f, std::true_type) -> self_type&
+    {
+        using flag_functor = std::conditional_t<std::is_same<std::decay_t<F>, detail::masked_replace>::value,
+                                                detail::masked_replace, std::logical_and<>>;
+        flag_functor ff;
+        detail::masked_blend(m_data, m_mask, e, f, ff, xexpression_tag_t<data_type>());
         return *this;
     }
 
+    template <class CTD, class CTM>
+    template <class E, class F>
+    inline auto xmasked_view<CTD, CTM>::computed_blend(const E& e, F&& f, std::false_type) -> self_type&
+    {
+        // a temporary of xmasked_value is evaluated and copied through the proxies
+        return semantic_base::operator=(f(*this, e));
+    }
+
+    template <class CTD, class CTM>
+    template <class CT, class F>
+    inline auto xmasked_view<CTD, CTM>::computed_blend(const xscalar<CT>& e, F&& f, std::false_type) -> self_type&
+    {
+        return semantic_base::scalar_computed_assign(e(), std::forward<F>(f));
+    }
+
     template <class CTD, class CTM>
     inline void xmasked_view<CTD, CTM>::assign_temporary_impl(temporary_type&& tmp)
     {
@@ -741,6 +1041,66 @@ namespace xt
     {
         return reference(*m_vs, *m_ms);
     }
+
+    /*********************
+     * masked reductions *
+     *********************/
+
+    /**
+     * @brief Sum of the visible elements of a masked view.
+     *
+     * The values and the mask are read directly, the hidden (or missing)
+     * elements being replaced with zero before a vectorized reduction.
+     * @param e the masked view
+     * @return the sum of the visible elements, zero if none is visible
+     */
+    template <class CTD, class CTM>
+    inline auto masked_sum(const xmasked_view<CTD, CTM>& e)
+    {
+        using value_type = big_promote_type_t<detail::masked_value_t<CTD>>;
+        std::size_t count = 0;
+        return detail::masked_reduce(e, value_type(0), std::plus<value_type>(), count);
+    }
+
+    /**
+     * @brief Mean of the visible elements of a masked view.
+     *
+     * @param e the masked view
+     * @return the mean of the visible elements, NaN if none is visible
+     */
+    template <class CTD, class CTM>
+    inline auto masked_mean(const xmasked_view<CTD, CTM>& e)
+    {
+        using value_type = big_promote_type_t<detail::masked_value_t<CTD>>;
+        using result_type = std::conditional_t<std::is_integral<value_type>::value, double, value_type>;
+        std::size_t count = 0;
+        value_type res = detail::masked_reduce(e, value_type(0), std::plus<value_type>(), count);
+        if (count == 0)
+        {
+            return std::numeric_limits<result_type>::quiet_NaN();
+        }
+        return static_cast<result_type>(res) / static_cast<result_type>(count);
+    }
+
+    /**
+     * @brief Maximum of the visible elements of a masked view.
+     *
+     * @param e the masked view
+     * @return the largest visible element
+     * @throws std::runtime_error if no element is visible
+     */
+    template <class CTD, class CTM>
+    inline auto masked_amax(const xmasked_view<CTD, CTM>& e)
+    {
+        using value_type = detail::masked_value_t<CTD>;
+        std::size_t count = 0;
+        value_type res = detail::masked_reduce(e, std::numeric_limits<value_type>::lowest(), math::maximum<>(), count);
+        if (count == 0)
+        {
+            throw std::runtime_error("masked_amax: no visible element");
+        }
+        return res;
+    }
 }
 
 #endif
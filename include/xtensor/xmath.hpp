@@ -17,13 +17,19 @@
 #include <algorithm>
 #include <array>
 #include <complex>
+#include <functional>
+#include <limits>
+#include <numeric>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <xtl/xcomplex.hpp>
 
 #include "xaccumulator.hpp"
 #include "xoperation.hpp"
 #include "xreducer.hpp"
+#include "xsearch.hpp"
 #include "xslice.hpp"
 #include "xstrided_view.hpp"
 #include "xeval.hpp"
@@ -826,6 +832,80 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
      * power functions *
      *******************/
 
+    namespace detail
+    {
+        template <class E1, class E2>
+        using is_scalar_pow = xtl::conjunction<is_xexpression<std::decay_t<E1>>,
+                                               std::is_arithmetic<xvalue_type_t<std::decay_t<E1>>>,
+                                               std::is_arithmetic<std::decay_t<E2>>>;
+
+        // Raises the elements to a scalar exponent. Whether the exponent is
+        // a small integer is checked once, when the functor is built; such
+        // exponents are computed by squaring and multiplying.
+        template <class P>
+        class scalar_pow_fun
+        {
+        public:
+
+            explicit scalar_pow_fun(P exponent) noexcept
+                : m_exponent(exponent), m_integer(0), m_negative(false), m_use_integer(false)
+            {
+                double d = static_cast<double>(exponent);
+                double max_exponent = static_cast<double>(XTENSOR_POW_MAX_INTEGER_EXPONENT);
+                if (d >= -max_exponent && d <= max_exponent && std::trunc(d) == d)
+                {
+                    m_negative = d < 0.;
+                    m_integer = static_cast<unsigned int>(m_negative ? -d : d);
+                    m_use_integer = true;
+                }
+            }
+
+            template <class T>
+            auto operator()(const T& v) const
+                -> decltype(math::pow(v, std::declval<const P&>()))
+            {
+                using result_type = decltype(math::pow(v, std::declval<const P&>()));
+                return m_use_integer ? integer_pow(static_cast<result_type>(v)) : math::pow(v, m_exponent);
+            }
+
+            template <class B>
+            B simd_apply(const B& v) const
+            {
+                using math::pow;
+                return m_use_integer ? integer_pow(v)
+                                     : pow(v, B(static_cast<typename B::value_type>(m_exponent)));
+            }
+
+        private:
+
+            template <class R>
+            R integer_pow(R base) const
+            {
+                // inverting the base first keeps the intermediate powers
+                // of large bases from overflowing
+                if (m_negative)
+                {
+                    base = R(1) / base;
+                }
+                R result(1);
+                for (unsigned int n = m_integer; n != 0u; n >>= 1)
+                {
+                    if (n & 1u)
+                    {
+                        result *= base;
+                    }
+                    base *= base;
+                }
+                return result;
+            }
+
+            P m_exponent;
+            unsigned int m_integer;
+            bool m_negative;
+            bool m_use_integer;
+        };
+    }
+
     /**
      * @defgroup pow_functions Power functions
      */
@@ -836,18 +916,32 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
      *
      * Returns an \ref xfunction for the element-wise value of
      * of \em e1 raised to the power \em e2.
+     * When \em e1 is an \ref xexpression of arithmetic values and \em e2 is
+     * a scalar holding an integer no larger than XTENSOR_POW_MAX_INTEGER_EXPONENT
+     * in absolute value, the power is computed with multiplications (and one
+     * reciprocal for negative exponents) instead of std::pow.
      * @param e1 an \ref xexpression or a scalar
      * @param e2 an \ref xexpression or a scalar
      * @return an \ref xfunction
      * @note e1 and e2 can't be both scalars.
      */
-    template <class E1, class E2>
+    template <class E1, class E2, std::enable_if_t<!detail::is_scalar_pow<E1, E2>::value, int> = 0>
     inline auto pow(E1&& e1, E2&& e2) noexcept
         -> detail::xfunction_type_t<math::pow_fun, E1, E2>
     {
         return detail::make_xfunction<math::pow_fun>(std::forward<E1>(e1), std::forward<E2>(e2));
     }
 
+    /// @cond DOXYGEN_INCLUDE_SFINAE
+    template <class E1, class E2, std::enable_if_t<detail::is_scalar_pow<E1, E2>::value, int> = 0>
+    inline auto pow(E1&& e1, E2&& e2) noexcept
+    {
+        using functor_type = detail::scalar_pow_fun<std::decay_t<E2>>;
+        using xfunction_type = xfunction<functor_type, const_xclosure_t<E1>>;
+        return xfunction_type(functor_type(e2), std::forward<E1>(e1));
+    }
+    /// @endcond
+
     namespace detail
     {
         template <class F, class... T, typename = decltype(std::declval<F>()(std::declval<T>()...))>
@@ -1035,6 +1129,17 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
                 return T(1);
             }
         };
+
+        template <std::size_t N>
+        struct inverse_pow_impl
+        {
+            template <class T>
+            auto operator()(T v) const
+                -> decltype(v * v)
+            {
+                return pow_impl<N>{}(T(1) / v);
+            }
+        };
     }
 
     /**
@@ -1051,16 +1156,35 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
      * For example, `e1^20` can be expressed as `(((e1^2)^2)^2)^2*(e1^2)^2`, which is just 5 multiplications.
      *
      * @param e an \ref xexpression
-     * @tparam N the exponent (has to be positive integer)
+     * @tparam N the exponent (has to be a non-negative integer)
      * @return an \ref xfunction
      */
     template <std::size_t N, class E>
     inline auto pow(E&& e) noexcept
     {
-        static_assert(N > 0, "integer power cannot be negative");
         return make_lambda_xfunction(detail::pow_impl<N>{}, std::forward<E>(e));
     }
 
+    /**
+     * @ingroup pow_functions
+     * @brief Negative integer power function.
+     *
+     * Returns an \ref xfunction for the element-wise power of e1 to
+     * a negative integral constant, computed as the positive power of
+     * the reciprocal of e1 so that large elements do not overflow.
+     *
+     * @param e an \ref xexpression of floating point values
+     * @tparam N the exponent (has to be a negative integer)
+     * @return an \ref xfunction
+     */
+    template <int N, class E, std::enable_if_t<(N < 0), int> = 0>
+    inline auto pow(E&& e) noexcept
+    {
+        static_assert(!std::is_integral<xvalue_type_t<std::decay_t<E>>>::value,
+                      "integers cannot be raised to negative integer powers");
+        return make_lambda_xfunction(detail::inverse_pow_impl<static_cast<std::size_t>(-N)>{}, std::forward<E>(e));
+    }
+
     /**
      * @ingroup pow_functions
      * @brief Square root function.
@@ -1724,53 +1848,423 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
      * \em axes.
      * @param e an \ref xexpression
      * @param axes the axes along which the mean is computed (optional)
+     * @param es evaluation strategy of the reducer
      * @return an \ref xexpression
      */
-    template <class T = void, class E, class X>
-    inline auto mean(E&& e, X&& axes)
+    template <class T = void, class E, class X, class EVS = DEFAULT_STRATEGY_REDUCERS,
+              class = std::enable_if_t<!std::is_base_of<evaluation_strategy::base, std::decay_t<X>>::value, int>>
+    inline auto mean(E&& e, X&& axes, EVS es = EVS())
     {
         using value_type = typename std::conditional_t<std::is_same<T, void>::value, double, T>;
         auto size = e.size();
         // sum cannot always be a double. It could be a complex number which cannot operate on
         // std::plus<double>.
-        auto s = sum<T>(std::forward<E>(e), std::forward<X>(axes));
+        auto s = sum<T>(std::forward<E>(e), std::forward<X>(axes), es);
         return std::move(s) / static_cast<value_type>(size / s.size());
     }
 
-    template <class T = void, class E>
-    inline auto mean(E&& e)
+    template <class T = void, class E, class EVS = DEFAULT_STRATEGY_REDUCERS,
+              class = std::enable_if_t<std::is_base_of<evaluation_strategy::base, EVS>::value, int>>
+    inline auto mean(E&& e, EVS es = EVS())
     {
         using value_type = typename std::conditional_t<std::is_same<T, void>::value, double, T>;
         auto size = e.size();
-        return sum<T>(std::forward<E>(e)) / static_cast<value_type>(size);
+        return sum<T>(std::forward<E>(e), es) / static_cast<value_type>(size);
     }
 
 #ifdef X_OLD_CLANG
-    template <class T = void, class E, class I>
-    inline auto mean(E&& e, std::initializer_list<I> axes)
+    template <class T = void, class E, class I, class EVS = DEFAULT_STRATEGY_REDUCERS>
+    inline auto mean(E&& e, std::initializer_list<I> axes, EVS es = EVS())
     {
         using value_type = typename std::conditional_t<std::is_same<T, void>::value, double, T>;
         auto size = e.size();
-        auto s = sum<T>(std::forward<E>(e), axes);
+        auto s = sum<T>(std::forward<E>(e), axes, es);
         return std::move(s) / static_cast<value_type>(size / s.size());
     }
 #else
-    template <class T = void, class E, class I, std::size_t N>
-    inline auto mean(E&& e, const I (&axes)[N])
+    template <class T = void, class E, class I, std::size_t N, class EVS = DEFAULT_STRATEGY_REDUCERS>
+    inline auto mean(E&& e, const I (&axes)[N], EVS es = EVS())
     {
         using value_type = typename std::conditional_t<std::is_same<T, void>::value, double, T>;
         auto size = e.size();
-        auto s = sum<T>(std::forward<E>(e), axes);
+        auto s = sum<T>(std::forward<E>(e), axes, es);
         return std::move(s) / static_cast<value_type>(size / s.size());
     }
 #endif
 
+    namespace detail
+    {
+        // Accumulates the weighted sum and the sum of the weights of n
+        // contiguous elements into ws and sw.
+        template <class RS, class RW, class T, class U>
+        inline void weighted_sum_serial(const T* e, const U* w, std::size_t n, RS& ws, RW& sw, std::false_type /*simd*/)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                ws += static_cast<RS>(e[i]) * static_cast<RS>(w[i]);
+                sw += static_cast<RW>(w[i]);
+            }
+        }
+
+        // Adds the elements of row weighted by wk to out
+        template <class RS, class T>
+        inline void weighted_row(RS* out, const T* row, RS wk, std::size_t n, std::false_type /*simd*/)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                out[i] += static_cast<RS>(row[i]) * wk;
+            }
+        }
+
+        // Adds the elements of row weighted by the ones of wrow to out, and
+        // the weights to out_w
+        template <class RS, class RW, class T, class U>
+        inline void weighted_row(RS* out, RW* out_w, const T* row, const U* wrow, std::size_t n, std::false_type /*simd*/)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                out[i] += static_cast<RS>(row[i]) * static_cast<RS>(wrow[i]);
+                out_w[i] += static_cast<RW>(wrow[i]);
+            }
+        }
+
+#ifdef XTENSOR_USE_XSIMD
+        template <class RS, class RW, class T, class U>
+        inline void weighted_sum_serial(const T* e, const U* w, std::size_t n, RS& ws, RW& sw, std::true_type /*simd*/)
+        {
+            using batch_type = xsimd::simd_type<T>;
+            constexpr std::size_t simd_size = batch_type::size;
+            std::size_t simd_end = n - n % simd_size;
+            if (simd_end != 0)
+            {
+                batch_type acc_ws(T(0));
+                batch_type acc_sw(T(0));
+                for (std::size_t i = 0; i < simd_end; i += simd_size)
+                {
+                    batch_type bw = xsimd::load_simd<T, T>(w + i, xsimd::unaligned_mode());
+                    acc_ws += xsimd::load_simd<T, T>(e + i, xsimd::unaligned_mode()) * bw;
+                    acc_sw += bw;
+                }
+                alignas(XTENSOR_CACHE_LINE_SIZE) T lanes_ws[simd_size];
+                alignas(XTENSOR_CACHE_LINE_SIZE) T lanes_sw[simd_size];
+                acc_ws.store_unaligned(lanes_ws);
+                acc_sw.store_unaligned(lanes_sw);
+                for (std::size_t i = 0; i < simd_size; ++i)
+                {
+                    ws += lanes_ws[i];
+                    sw += lanes_sw[i];
+                }
+            }
+            weighted_sum_serial(e + simd_end, w + simd_end, n - simd_end, ws, sw, std::false_type());
+        }
+
+        template <class RS, class T>
+        inline void weighted_row(RS* out, const T* row, RS wk, std::size_t n, std::true_type /*simd*/)
+        {
+            using batch_type = xsimd::simd_type<T>;
+            constexpr std::size_t simd_size = batch_type::size;
+            std::size_t simd_end = n - n % simd_size;
+            batch_type bw(wk);
+            for (std::size_t i = 0; i < simd_end; i += simd_size)
+            {
+                batch_type acc = xsimd::load_simd<T, T>(out + i, xsimd::unaligned_mode());
+                acc += xsimd::load_simd<T, T>(row + i, xsimd::unaligned_mode()) * bw;
+                acc.store_unaligned(out + i);
+            }
+            weighted_row(out + simd_end, row + simd_end, wk, n - simd_end, std::false_type());
+        }
+
+        template <class RS, class RW, class T, class U>
+        inline void weighted_row(RS* out, RW* out_w, const T* row, const U* wrow, std::size_t n, std::true_type /*simd*/)
+        {
+            using batch_type = xsimd::simd_type<T>;
+            constexpr std::size_t simd_size = batch_type::size;
+            std::size_t simd_end = n - n % simd_size;
+            for (std::size_t i = 0; i < simd_end; i += simd_size)
+            {
+                batch_type bw = xsimd::load_simd<T, T>(wrow + i, xsimd::unaligned_mode());
+                batch_type acc = xsimd::load_simd<T, T>(out + i, xsimd::unaligned_mode());
+                acc += xsimd::load_simd<T, T>(row + i, xsimd::unaligned_mode()) * bw;
+                acc.store_unaligned(out + i);
+                batch_type acc_w = xsimd::load_simd<T, T>(out_w + i, xsimd::unaligned_mode()) + bw;
+                acc_w.store_unaligned(out_w + i);
+            }
+            weighted_row(out + simd_end, out_w + simd_end, row + simd_end, wrow + simd_end, n - simd_end, std::false_type());
+        }
+
+        // The elements, the weights and both sums share a simd type
+        template <class RS, class RW, class T, class U>
+        struct use_simd_weighted_sum
+        {
+            static constexpr bool value = std::is_arithmetic<T>::value && xsimd::simd_traits<T>::size > 1 &&
+                                          std::is_same<T, U>::value && std::is_same<T, RS>::value &&
+                                          std::is_same<T, RW>::value;
+        };
+#else
+        template <class RS, class RW, class T, class U>
+        struct use_simd_weighted_sum
+        {
+            static constexpr bool value = false;
+        };
+#endif
+
+        // Weighted sum and sum of the weights of n contiguous elements, in a
+        // single pass. Blocks of the elements are reduced concurrently, their
+        // number does not depend on the number of threads.
+        template <class RS, class RW, class T, class U>
+        inline void weighted_sum_contiguous(const T* e, const U* w, std::size_t n, RS& ws, RW& sw)
+        {
+            using use_simd = std::integral_constant<bool, use_simd_weighted_sum<RS, RW, T, U>::value>;
+            ws = RS(0);
+            sw = RW(0);
+#if defined(XTENSOR_PARALLEL_ENABLED)
+            constexpr std::size_t max_blocks = 64;
+            if (parallel::use_parallel(n) && n >= 2 * max_blocks)
+            {
+                std::size_t block_size = std::max((n + max_blocks - 1) / max_blocks, parallel::grain(1));
+                std::size_t nblocks = (n + block_size - 1) / block_size;
+                std::vector<std::pair<RS, RW>> partials(nblocks, std::make_pair(RS(0), RW(0)));
+                parallel_for(std::size_t(0), nblocks, std::size_t(1), [&](std::size_t b_first, std::size_t b_last)
+                {
+                    for (std::size_t b = b_first; b < b_last; ++b)
+                    {
+                        std::size_t offset = b * block_size;
+                        weighted_sum_serial(e + offset, w + offset, (std::min)(block_size, n - offset),
+                                            partials[b].first, partials[b].second, use_simd());
+                    }
+                });
+                for (const auto& p : partials)
+                {
+                    ws += p.first;
+                    sw += p.second;
+                }
+                return;
+            }
+#endif
+            weighted_sum_serial(e, w, n, ws, sw, use_simd());
+        }
+
+        // Weighted sums along the middle axis of n_slow contiguous blocks of
+        // n_axis rows of n_fast elements. The weights are either one per row,
+        // or one per element, in which case their sums are written to sw.
+        template <class RS, class RW, class T, class U>
+        inline void weighted_sum_axis(const T* e, const U* w, bool per_element, std::size_t n_slow,
+                                      std::size_t n_axis, std::size_t n_fast, RS* ws, RW* sw)
+        {
+            using use_simd = std::integral_constant<bool, use_simd_weighted_sum<RS, RW, T, U>::value>;
+#if defined(XTENSOR_PARALLEL_ENABLED)
+            std::size_t size = n_slow * n_axis * n_fast;
+#endif
+
+            // the reduced axis is contiguous: each output is a dot product
+            if (n_fast == 1)
+            {
+                auto reduce_rows = [&](std::size_t first, std::size_t last)
+                {
+                    for (std::size_t o = first; o < last; ++o)
+                    {
+                        RS s = RS(0);
+                        RW t = RW(0);
+                        weighted_sum_serial(e + o * n_axis, per_element ? w + o * n_axis : w, n_axis, s, t, use_simd());
+                        ws[o] = s;
+                        if (per_element)
+                        {
+                            sw[o] = t;
+                        }
+                    }
+                };
+#if defined(XTENSOR_PARALLEL_ENABLED)
+                if (parallel::use_parallel(size))
+                {
+                    parallel_for(std::size_t(0), n_slow, parallel::grain(n_axis), reduce_rows);
+                    return;
+                }
+#endif
+                reduce_rows(std::size_t(0), n_slow);
+                return;
+            }
+
+            // otherwise the weighted rows are added to the output row, by
+            // tiles of columns which stay in the L1 cache
+            constexpr std::size_t tile_size = XTENSOR_L1_CACHE_SIZE / (2 * sizeof(RS)) > 0 ?
+                                              XTENSOR_L1_CACHE_SIZE / (2 * sizeof(RS)) : std::size_t(1);
+            auto reduce_columns = [&](std::size_t first, std::size_t last)
+            {
+                while (first < last)
+                {
+                    std::size_t o = first / n_fast;
+                    std::size_t c_first = first - o * n_fast;
+                    std::size_t c_last = (std::min)(n_fast, c_first + (last - first));
+                    for (std::size_t t = c_first; t < c_last; t += tile_size)
+                    {
+                        std::size_t width = (std::min)(tile_size, c_last - t);
+                        RS* out = ws + o * n_fast + t;
+                        RW* out_w = per_element ? sw + o * n_fast + t : nullptr;
+                        std::fill(out, out + width, RS(0));
+                        if (per_element)
+                        {
+                            std::fill(out_w, out_w + width, RW(0));
+                        }
+                        for (std::size_t k = 0; k < n_axis; ++k)
+                        {
+                            std::size_t offset = (o * n_axis + k) * n_fast + t;
+                            if (per_element)
+                            {
+                                weighted_row(out, out_w, e + offset, w + offset, width, use_simd());
+                            }
+                            else
+                            {
+                                weighted_row(out, e + offset, static_cast<RS>(w[k]), width, use_simd());
+                            }
+                        }
+                    }
+                    first += c_last - c_first;
+                }
+            };
+#if defined(XTENSOR_PARALLEL_ENABLED)
+            if (parallel::use_parallel(size))
+            {
+                parallel_for(std::size_t(0), n_slow * n_fast, parallel::grain(n_axis), reduce_columns);
+                return;
+            }
+#endif
+            reduce_columns(std::size_t(0), n_slow * n_fast);
+        }
+
+        // Computes the weighted sums ws and the sums of the weights sw of the
+        // evaluated expression e in a single pass, returns false if e and w
+        // are not laid out for the kernels.
+        template <class E, class W, class V, class X, class RS, class RW>
+        inline bool average_contiguous(const E& e, const W& w, const V& weights_view, const X& ax, RS& ws, RW& sw)
+        {
+            layout_type l = e.layout();
+            if (e.size() == 0 || (l != layout_type::row_major && l != layout_type::column_major))
+            {
+                return false;
+            }
+            bool per_element = w.dimension() != 1 || e.dimension() == 1;
+            if (per_element && (w.size() != e.size() || (e.dimension() > 1 && w.layout() != l)))
+            {
+                return false;
+            }
+
+            if (ax.size() == e.dimension())
+            {
+                // only the complete reduction over distinct valid axes
+                if (!per_element || std::adjacent_find(ax.cbegin(), ax.cend(), std::greater_equal<std::size_t>()) != ax.cend() ||
+                    ax[ax.size() - 1] != e.dimension() - 1)
+                {
+                    return false;
+                }
+                weighted_sum_contiguous(e.data(), w.data(), e.size(), ws.data()[0], sw.data()[0]);
+                return true;
+            }
+            if (ax.size() != 1 || ax[0] >= e.dimension() || detail::is_fixed<typename RS::shape_type>::value ||
+                (RS::static_layout != layout_type::dynamic && RS::static_layout != l) ||
+                (per_element && RW::static_layout != layout_type::dynamic && RW::static_layout != l))
+            {
+                return false;
+            }
+
+            std::size_t axis = ax[0];
+            auto first = e.shape().cbegin();
+            std::ptrdiff_t sax = static_cast<std::ptrdiff_t>(axis);
+            std::size_t before = std::accumulate(first, first + sax, std::size_t(1), std::multiplies<std::size_t>());
+            std::size_t after = std::accumulate(first + sax + 1, e.shape().cend(), std::size_t(1), std::multiplies<std::size_t>());
+            bool row_major = l == layout_type::row_major;
+
+            using shape_type = typename RS::shape_type;
+            shape_type result_shape = xtl::make_sequence<shape_type>(e.dimension() - 1, std::size_t(0));
+            for (std::size_t i = 0, idx = 0; i < e.dimension(); ++i)
+            {
+                if (i != axis)
+                {
+                    result_shape[idx++] = e.shape()[i];
+                }
+            }
+            ws.resize(result_shape, l);
+            if (per_element)
+            {
+                sw.resize(result_shape, l);
+            }
+            else
+            {
+                sw = sum(weights_view, ax, evaluation_strategy::immediate{});
+            }
+            weighted_sum_axis(e.data(), w.data(), per_element, row_major ? before : after, e.shape()[axis],
+                              row_major ? after : before, ws.data(), per_element ? sw.data() : nullptr);
+            return true;
+        }
+
+        template <class E, class W, class S, class X, class EVS>
+        inline auto average_impl(E&& e, W&& weights, S&& broadcast_shape, X&& ax, EVS ev)
+        {
+            auto weights_view = reshape_view(std::forward<W>(weights), std::forward<S>(broadcast_shape));
+            auto scl = sum(weights_view, ax, xt::evaluation_strategy::immediate{});
+            return sum(std::forward<E>(e) * std::move(weights_view), std::forward<X>(ax), ev) / std::move(scl);
+        }
+
+        // Immediate averages of contiguous expressions accumulate the
+        // weighted sums and the sums of the weights in a single pass.
+        template <class E, class W, class S, class X>
+        inline auto average_impl(E&& e, W&& weights, S&& broadcast_shape, X&& ax, evaluation_strategy::immediate)
+        {
+            auto&& de = eval(std::forward<E>(e));
+            auto&& dw = eval(std::forward<W>(weights));
+            auto weights_view = reshape_view(dw, std::forward<S>(broadcast_shape));
+            using weighted_type = std::decay_t<decltype(sum(de * weights_view, ax, evaluation_strategy::immediate{}))>;
+            using weights_sum_type = std::decay_t<decltype(sum(weights_view, ax, evaluation_strategy::immediate{}))>;
+            weighted_type ws;
+            weights_sum_type sw;
+            if (!average_contiguous(de, dw, weights_view, ax, ws, sw))
+            {
+                sw = sum(weights_view, ax, evaluation_strategy::immediate{});
+                ws = sum(de * weights_view, ax, evaluation_strategy::immediate{});
+            }
+            return std::move(ws) / std::move(sw);
+        }
+
+        template <class E, class W, class EVS>
+        inline auto average_impl(E&& e, W&& weights, EVS ev)
+        {
+            auto div = sum(weights, evaluation_strategy::immediate{})();
+            return sum(std::forward<E>(e) * std::forward<W>(weights), ev) / std::move(div);
+        }
+
+        template <class E, class W>
+        inline auto average_impl(E&& e, W&& weights, evaluation_strategy::immediate)
+        {
+            auto&& de = eval(std::forward<E>(e));
+            auto&& dw = eval(std::forward<W>(weights));
+            using weighted_type = std::decay_t<decltype(sum(de * dw, evaluation_strategy::immediate{}))>;
+            using weights_sum_type = std::decay_t<decltype(sum(dw, evaluation_strategy::immediate{})())>;
+            weighted_type ws;
+            weights_sum_type div;
+            layout_type l = de.layout();
+            if (de.size() != 0 && (l == layout_type::row_major || l == layout_type::column_major) &&
+                (de.dimension() <= 1 || dw.layout() == l))
+            {
+                weighted_sum_contiguous(de.data(), dw.data(), de.size(), ws.data()[0], div);
+            }
+            else
+            {
+                div = sum(dw, evaluation_strategy::immediate{})();
+                ws = sum(de * dw, evaluation_strategy::immediate{});
+            }
+            return std::move(ws) / std::move(div);
+        }
+    }
+
     /**
      * @ingroup red_functions
      * @brief Average of elements over given axes using weights.
      *
      * Returns an \ref xreducer for the mean of elements over given
      * \em axes.
+     * With evaluation_strategy::immediate, the weighted sums and the sums
+     * of the weights of contiguous expressions are accumulated in a single
+     * pass, reduced with simd batches and distributed over the parallel
+     * backend.
      * @param e an \ref xexpression
      * @param axes the axes along which the mean is computed (optional)
      * @return an \ref xexpression
@@ -1805,9 +2299,8 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
             std::copy(e.shape().begin(), e.shape().end(), broadcast_shape.begin());
         }
 
-        auto weights_view = reshape_view(std::forward<W>(weights), std::move(broadcast_shape));
-        auto scl = sum(weights_view, ax, xt::evaluation_strategy::immediate{});
-        return sum(std::forward<E>(e) * std::move(weights_view), std::move(ax), ev) / std::move(scl);
+        return detail::average_impl(std::forward<E>(e), std::forward<W>(weights), std::move(broadcast_shape),
+                                    std::move(ax), ev);
     }
 
 #ifndef X_OLD_CLANG
@@ -1836,9 +2329,77 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
             throw std::runtime_error("Weights need to have the same shape as expression.");
         }
 
-        auto div = sum(weights, evaluation_strategy::immediate{})();
-        auto s = sum(std::forward<E>(e) * std::forward<W>(weights), ev) / std::move(div);
-        return s;
+        return detail::average_impl(std::forward<E>(e), std::forward<W>(weights), ev);
+    }
+
+    namespace detail
+    {
+        template <class T>
+        struct minmax_functor
+        {
+            using result_type = std::array<T, 2>;
+
+            result_type operator()(result_type r, const T& v) const
+            {
+                using std::min;
+                using std::max;
+                r[0] = (min)(r[0], v);
+                r[1] = (max)(r[1], v);
+                return r;
+            }
+
+            // Immediate reductions of contiguous ranges go through this
+            // kernel, which tracks both extrema in the lanes of simd batches.
+            result_type reduce_contiguous(const T* first, std::size_t n) const
+            {
+#ifdef XTENSOR_USE_XSIMD
+                using use_simd = std::integral_constant<bool, std::is_arithmetic<T>::value &&
+                                                              xsimd::simd_traits<T>::size != 1>;
+#else
+                using use_simd = std::false_type;
+#endif
+                return reduce_contiguous(first, n, use_simd());
+            }
+
+        private:
+
+            result_type reduce_contiguous(const T* first, std::size_t n, std::false_type /*simd*/) const
+            {
+                return std::accumulate(first + 1, first + n, result_type{first[0], first[0]}, *this);
+            }
+
+#ifdef XTENSOR_USE_XSIMD
+            result_type reduce_contiguous(const T* first, std::size_t n, std::true_type /*simd*/) const
+            {
+                using batch_type = xsimd::simd_type<T>;
+                constexpr std::size_t simd_size = batch_type::size;
+                std::size_t simd_end = n - n % simd_size;
+                // the lanes start with the first element, the comparisons
+                // are those of std::min and std::max so that NaN behave as
+                // in the scalar loop
+                batch_type mn = xsimd::set_simd(first[0]);
+                batch_type mx = mn;
+                for (std::size_t i = 0; i < simd_end; i += simd_size)
+                {
+                    batch_type v = xsimd::load_simd<T, T>(first + i, xsimd::unaligned_mode());
+                    mn = xsimd::select(v < mn, v, mn);
+                    mx = xsimd::select(mx < v, v, mx);
+                }
+
+                alignas(XTENSOR_CACHE_LINE_SIZE) T lanes_min[simd_size];
+                alignas(XTENSOR_CACHE_LINE_SIZE) T lanes_max[simd_size];
+                mn.store_unaligned(lanes_min);
+                mx.store_unaligned(lanes_max);
+                result_type res{first[0], first[0]};
+                for (std::size_t l = 0; l < simd_size; ++l)
+                {
+                    res[0] = (std::min)(res[0], lanes_min[l]);
+                    res[1] = (std::max)(res[1], lanes_max[l]);
+                }
+                return std::accumulate(first + simd_end, first + n, res, *this);
+            }
+#endif
+        };
     }
 
     /**
@@ -1846,6 +2407,8 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
      * @brief Minimum and maximum among the elements of an array or expression.
      *
      * Returns an \ref xreducer for the minimum and maximum of an expression's elements.
+     * With the immediate strategy, the elements of contiguous expressions are
+     * scanned once with simd batches, by several threads for large expressions.
      * @param e an \ref xexpression
      * @param es evaluation strategy to use (lazy (default), or immediate)
      * @return an \ref xexpression of type ``std::array<value_type, 2>``, whose first
@@ -1860,11 +2423,6 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
         using value_type = typename std::decay_t<E>::value_type;
         using result_type = std::array<value_type, 2>;
 
-        auto reduce_func = [](result_type r, value_type const& v) {
-            r[0] = (min)(r[0], v);
-            r[1] = (max)(r[1], v);
-            return r;
-        };
         auto init_func = [](value_type const& v) {
             return result_type{v, v};
         };
@@ -1873,55 +2431,212 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
             r[1] = (max)(r[1], s[1]);
             return r;
         };
-        return reduce(make_xreducer_functor(std::move(reduce_func),
+        return reduce(make_xreducer_functor(detail::minmax_functor<value_type>(),
                                             std::move(init_func),
                                             std::move(merge_func)),
                       std::forward<E>(e), arange(e.dimension()), es);
     }
 
     /**
-     * @defgroup acc_functions accumulating functions
+     * @ingroup red_functions
+     * @brief Statistics computed in a single pass by \ref moments.
+     *
+     * Holds the number of reduced elements, their mean, the sum of the
+     * squared deviations from the mean, their minimum and their maximum.
      */
+    template <class T>
+    struct xmoments
+    {
+        using value_type = T;
+
+        std::size_t count;
+        value_type mean;
+        value_type m2;
+        value_type min;
+        value_type max;
+
+        value_type variance(std::size_t ddof = 0) const;
+        value_type stddev(std::size_t ddof = 0) const;
+    };
 
     /**
-     * @ingroup acc_functions
-     * @brief Cumulative sum.
-     *
-     * Returns the accumulated sum for the elements over given
-     * \em axis (or flattened).
-     * @param e an \ref xexpression
-     * @param axis the axes along which the cumulative sum is computed (optional)
-     * @return an \ref xarray<T>
+     * Returns the variance of the reduced elements, computed with
+     * <tt>count - ddof</tt> degrees of freedom.
      */
-    template <class E>
-    inline auto cumsum(E&& e, std::ptrdiff_t axis)
+    template <class T>
+    inline auto xmoments<T>::variance(std::size_t ddof) const -> value_type
     {
-        using result_type = big_promote_type_t<typename std::decay_t<E>::value_type>;
-        return accumulate(make_xaccumulator_functor(std::plus<result_type>()), std::forward<E>(e), axis);
+        return m2 / static_cast<value_type>(count - ddof);
     }
 
-    template <class E>
-    inline auto cumsum(E&& e)
+    /**
+     * Returns the standard deviation of the reduced elements, computed
+     * with <tt>count - ddof</tt> degrees of freedom.
+     */
+    template <class T>
+    inline auto xmoments<T>::stddev(std::size_t ddof) const -> value_type
     {
-        using result_type = big_promote_type_t<typename std::decay_t<E>::value_type>;
-        return accumulate(make_xaccumulator_functor(std::plus<result_type>()), std::forward<E>(e));
+        using std::sqrt;
+        return sqrt(variance(ddof));
+    }
+
+    namespace detail
+    {
+        // Welford's online algorithm, partial results are combined
+        // with the parallel formula of Chan et al.
+        template <class R, class V>
+        inline auto make_moments_functor()
+        {
+            using result_type = xmoments<R>;
+
+            auto reduce_func = [](result_type r, V const& v) {
+                R x = static_cast<R>(v);
+                ++r.count;
+                R delta = x - r.mean;
+                r.mean += delta / static_cast<R>(r.count);
+                r.m2 += delta * (x - r.mean);
+                r.min = x < r.min ? x : r.min;
+                r.max = r.max < x ? x : r.max;
+                return r;
+            };
+            auto init_func = [](V const& v) {
+                R x = static_cast<R>(v);
+                return result_type{1, x, R(0), x, x};
+            };
+            auto merge_func = [](result_type r, result_type const& s) {
+                std::size_t count = r.count + s.count;
+                R delta = s.mean - r.mean;
+                R weight = static_cast<R>(s.count) / static_cast<R>(count);
+                r.mean += delta * weight;
+                r.m2 += s.m2 + delta * delta * static_cast<R>(r.count) * weight;
+                r.count = count;
+                r.min = s.min < r.min ? s.min : r.min;
+                r.max = r.max < s.max ? s.max : r.max;
+                return r;
+            };
+            return make_xreducer_functor(std::move(reduce_func), std::move(init_func), std::move(merge_func));
+        }
     }
 
     /**
-     * @ingroup acc_functions
-     * @brief Cumulative product.
+     * @ingroup red_functions
+     * @brief Mean, variance, minimum and maximum of elements over given axes.
      *
-     * Returns the accumulated product for the elements over given
-     * \em axis (or flattened).
+     * Returns an \ref xreducer whose elements are \ref xmoments computed in
+     * a single pass over the elements of \em e, instead of one pass for each
+     * statistic.
      * @param e an \ref xexpression
-     * @param axis the axes along which the cumulative product is computed (optional)
-     * @return an \ref xarray<T>
+     * @param axes the axes along which the statistics are computed (optional)
+     * @param es evaluation strategy of the reducer
+     * @tparam T the type used to compute the statistics (double by default)
+     * @return an \ref xreducer of \ref xmoments
      */
-    template <class E>
-    inline auto cumprod(E&& e, std::ptrdiff_t axis)
+    template <class T = void, class E, class X, class EVS = DEFAULT_STRATEGY_REDUCERS,
+              class = std::enable_if_t<!std::is_base_of<evaluation_strategy::base, std::decay_t<X>>::value, int>>
+    inline auto moments(E&& e, X&& axes, EVS es = EVS())
     {
-        using result_type = big_promote_type_t<typename std::decay_t<E>::value_type>;
-        return accumulate(make_xaccumulator_functor(std::multiplies<result_type>()), std::forward<E>(e), axis);
+        using stat_type = std::conditional_t<std::is_same<T, void>::value, double, T>;
+        using value_type = typename std::decay_t<E>::value_type;
+        return reduce(detail::make_moments_functor<stat_type, value_type>(), std::forward<E>(e),
+                      std::forward<X>(axes), es);
+    }
+
+    template <class T = void, class E, class EVS = DEFAULT_STRATEGY_REDUCERS,
+              class = std::enable_if_t<std::is_base_of<evaluation_strategy::base, EVS>::value, int>>
+    inline auto moments(E&& e, EVS es = EVS())
+    {
+        using stat_type = std::conditional_t<std::is_same<T, void>::value, double, T>;
+        using value_type = typename std::decay_t<E>::value_type;
+        return reduce(detail::make_moments_functor<stat_type, value_type>(), std::forward<E>(e), es);
+    }
+
+#ifdef X_OLD_CLANG
+    template <class T = void, class E, class I, class EVS = DEFAULT_STRATEGY_REDUCERS>
+    inline auto moments(E&& e, std::initializer_list<I> axes, EVS es = EVS())
+    {
+        using stat_type = std::conditional_t<std::is_same<T, void>::value, double, T>;
+        using value_type = typename std::decay_t<E>::value_type;
+        return reduce(detail::make_moments_functor<stat_type, value_type>(), std::forward<E>(e), axes, es);
+    }
+#else
+    template <class T = void, class E, class I, std::size_t N, class EVS = DEFAULT_STRATEGY_REDUCERS>
+    inline auto moments(E&& e, const I (&axes)[N], EVS es = EVS())
+    {
+        using stat_type = std::conditional_t<std::is_same<T, void>::value, double, T>;
+        using value_type = typename std::decay_t<E>::value_type;
+        return reduce(detail::make_moments_functor<stat_type, value_type>(), std::forward<E>(e), axes, es);
+    }
+#endif
+
+    /**
+     * @defgroup acc_functions accumulating functions
+     */
+
+    /**
+     * @ingroup acc_functions
+     * @brief Cumulative sum.
+     *
+     * Returns the accumulated sum for the elements over given
+     * \em axis (or flattened).
+     * @param e an \ref xexpression
+     * @param axis the axes along which the cumulative sum is computed (optional)
+     * @return an \ref xarray<T>
+     */
+    template <class E>
+    inline auto cumsum(E&& e, std::ptrdiff_t axis)
+    {
+        using result_type = big_promote_type_t<typename std::decay_t<E>::value_type>;
+        return accumulate(make_xaccumulator_functor(std::plus<result_type>()), std::forward<E>(e), axis);
+    }
+
+    template <class E>
+    inline auto cumsum(E&& e)
+    {
+        using result_type = big_promote_type_t<typename std::decay_t<E>::value_type>;
+        return accumulate(make_xaccumulator_functor(std::plus<result_type>()), std::forward<E>(e));
+    }
+
+    /**
+     * @ingroup acc_functions
+     * @brief Cumulative sum into an existing container.
+     *
+     * Writes the accumulated sum for the elements over given \em axis
+     * (or flattened) into \em out, which is resized if needed. No
+     * intermediate result is allocated.
+     * @param out the container receiving the cumulative sum
+     * @param e an \ref xexpression
+     * @param axis the axes along which the cumulative sum is computed (optional)
+     * @return a reference to \em out
+     */
+    template <class R, class E, XTENSOR_REQUIRE<is_xexpression<std::decay_t<E>>::value>>
+    inline R& cumsum(xexpression<R>& out, E&& e, std::ptrdiff_t axis)
+    {
+        using result_type = typename R::value_type;
+        return accumulate_into(out, make_xaccumulator_functor(std::plus<result_type>()), std::forward<E>(e), axis);
+    }
+
+    template <class R, class E, XTENSOR_REQUIRE<is_xexpression<std::decay_t<E>>::value>>
+    inline R& cumsum(xexpression<R>& out, E&& e)
+    {
+        using result_type = typename R::value_type;
+        return accumulate_into(out, make_xaccumulator_functor(std::plus<result_type>()), std::forward<E>(e));
+    }
+
+    /**
+     * @ingroup acc_functions
+     * @brief Cumulative product.
+     *
+     * Returns the accumulated product for the elements over given
+     * \em axis (or flattened).
+     * @param e an \ref xexpression
+     * @param axis the axes along which the cumulative product is computed (optional)
+     * @return an \ref xarray<T>
+     */
+    template <class E>
+    inline auto cumprod(E&& e, std::ptrdiff_t axis)
+    {
+        using result_type = big_promote_type_t<typename std::decay_t<E>::value_type>;
+        return accumulate(make_xaccumulator_functor(std::multiplies<result_type>()), std::forward<E>(e), axis);
     }
 
     template <class E>
@@ -1931,6 +2646,32 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
         return accumulate(make_xaccumulator_functor(std::multiplies<result_type>()), std::forward<E>(e));
     }
 
+    /**
+     * @ingroup acc_functions
+     * @brief Cumulative product into an existing container.
+     *
+     * Writes the accumulated product for the elements over given \em axis
+     * (or flattened) into \em out, which is resized if needed. No
+     * intermediate result is allocated.
+     * @param out the container receiving the cumulative product
+     * @param e an \ref xexpression
+     * @param axis the axes along which the cumulative product is computed (optional)
+     * @return a reference to \em out
+     */
+    template <class R, class E, XTENSOR_REQUIRE<is_xexpression<std::decay_t<E>>::value>>
+    inline R& cumprod(xexpression<R>& out, E&& e, std::ptrdiff_t axis)
+    {
+        using result_type = typename R::value_type;
+        return accumulate_into(out, make_xaccumulator_functor(std::multiplies<result_type>()), std::forward<E>(e), axis);
+    }
+
+    template <class R, class E, XTENSOR_REQUIRE<is_xexpression<std::decay_t<E>>::value>>
+    inline R& cumprod(xexpression<R>& out, E&& e)
+    {
+        using result_type = typename R::value_type;
+        return accumulate_into(out, make_xaccumulator_functor(std::multiplies<result_type>()), std::forward<E>(e));
+    }
+
     /*****************
      * nan functions *
      *****************/
@@ -1961,6 +2702,8 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
             }
         };
 
+        // The nan functors provide simd_apply methods replacing the NaN lanes
+        // with a blend, so that immediate reductions use simd batches.
         template <class T>
         struct nan_plus
         {
@@ -1971,6 +2714,12 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
             {
                 return !math::isnan(rhs) ? lhs + rhs : lhs;
             }
+
+            template <class B, class U = T, XTENSOR_REQUIRE<std::is_arithmetic<U>::value>>
+            B simd_apply(const B& lhs, const B& rhs) const
+            {
+                return lhs + xsimd::select(rhs == rhs, rhs, B(value_type(0)));
+            }
         };
 
         template <class T>
@@ -1983,6 +2732,12 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
             {
                 return !math::isnan(rhs) ? lhs * rhs : lhs;
             }
+
+            template <class B, class U = T, XTENSOR_REQUIRE<std::is_arithmetic<U>::value>>
+            B simd_apply(const B& lhs, const B& rhs) const
+            {
+                return lhs * xsimd::select(rhs == rhs, rhs, B(value_type(1)));
+            }
         };
 
         template <class T, int V>
@@ -1994,6 +2749,49 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
             {
                 return math::isnan(lhs) ? result_type(V) : lhs;
             }
+
+            template <class B, class U = T, XTENSOR_REQUIRE<std::is_arithmetic<U>::value>>
+            B simd_apply(const B& b) const
+            {
+                return xsimd::select(b == b, b, B(value_type(V)));
+            }
+        };
+
+        // The result is NaN only if both operands are NaN
+        template <class T>
+        struct nan_minimum
+        {
+            using value_type = T;
+            using result_type = value_type;
+
+            constexpr result_type operator()(const value_type lhs, const value_type rhs) const
+            {
+                return (rhs < lhs || math::isnan(lhs)) ? rhs : lhs;
+            }
+
+            template <class B, class U = T, XTENSOR_REQUIRE<std::is_arithmetic<U>::value>>
+            B simd_apply(const B& lhs, const B& rhs) const
+            {
+                return xsimd::select((rhs < lhs) | (lhs != lhs), rhs, lhs);
+            }
+        };
+
+        template <class T>
+        struct nan_maximum
+        {
+            using value_type = T;
+            using result_type = value_type;
+
+            constexpr result_type operator()(const value_type lhs, const value_type rhs) const
+            {
+                return (lhs < rhs || math::isnan(lhs)) ? rhs : lhs;
+            }
+
+            template <class B, class U = T, XTENSOR_REQUIRE<std::is_arithmetic<U>::value>>
+            B simd_apply(const B& lhs, const B& rhs) const
+            {
+                return xsimd::select((lhs < rhs) | (lhs != lhs), rhs, lhs);
+            }
         };
     }
 
@@ -2099,20 +2897,190 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
 #undef OLD_CLANG_NAN_REDUCER
 #undef MODERN_CLANG_NAN_REDUCER
 
+#define XTENSOR_NAN_EXTREMUM_FUNCTION(NAME, FUNCTOR)                                                             \
+    template <class E, class X, class EVS = DEFAULT_STRATEGY_REDUCERS,                                            \
+              class = std::enable_if_t<!std::is_base_of<evaluation_strategy::base, std::decay_t<X>>::value, int>> \
+    inline auto NAME(E&& e, X&& axes, EVS es = EVS())                                                             \
+    {                                                                                                             \
+        using functor_type = FUNCTOR<typename std::decay_t<E>::value_type>;                                       \
+        return reduce(make_xreducer_functor(functor_type()), std::forward<E>(e), std::forward<X>(axes), es);      \
+    }                                                                                                             \
+                                                                                                                  \
+    template <class E, class EVS = DEFAULT_STRATEGY_REDUCERS,                                                     \
+              class = std::enable_if_t<std::is_base_of<evaluation_strategy::base, EVS>::value, int>>              \
+    inline auto NAME(E&& e, EVS es = EVS())                                                                       \
+    {                                                                                                             \
+        using functor_type = FUNCTOR<typename std::decay_t<E>::value_type>;                                       \
+        return reduce(make_xreducer_functor(functor_type()), std::forward<E>(e), es);                             \
+    }
+
+#define OLD_CLANG_NAN_EXTREMUM(NAME, FUNCTOR)                                                                    \
+    template <class E, class I, class EVS = DEFAULT_STRATEGY_REDUCERS>                                            \
+    inline auto NAME(E&& e, std::initializer_list<I> axes, EVS es = EVS())                                        \
+    {                                                                                                             \
+        using functor_type = FUNCTOR<typename std::decay_t<E>::value_type>;                                       \
+        return reduce(make_xreducer_functor(functor_type()), std::forward<E>(e), axes, es);                       \
+    }
+
+#define MODERN_CLANG_NAN_EXTREMUM(NAME, FUNCTOR)                                                                 \
+    template <class E, class I, std::size_t N, class EVS = DEFAULT_STRATEGY_REDUCERS>                             \
+    inline auto NAME(E&& e, const I (&axes)[N], EVS es = EVS())                                                   \
+    {                                                                                                             \
+        using functor_type = FUNCTOR<typename std::decay_t<E>::value_type>;                                       \
+        return reduce(make_xreducer_functor(functor_type()), std::forward<E>(e), axes, es);                       \
+    }
+
+    /**
+     * @ingroup nan_functions
+     * @brief Minimum of elements over given axes, ignoring nan.
+     *
+     * Returns an \ref xreducer for the minimum of elements over given
+     * \em axes, ignoring nan. The result is nan where all the reduced
+     * elements are nan.
+     * @param e an \ref xexpression
+     * @param axes the axes along which the minimum is found (optional)
+     * @param es evaluation strategy of the reducer (optional)
+     * @return an \ref xreducer
+     */
+    XTENSOR_NAN_EXTREMUM_FUNCTION(nanmin, detail::nan_minimum)
+#ifdef X_OLD_CLANG
+    OLD_CLANG_NAN_EXTREMUM(nanmin, detail::nan_minimum)
+#else
+    MODERN_CLANG_NAN_EXTREMUM(nanmin, detail::nan_minimum)
+#endif
+
+    /**
+     * @ingroup nan_functions
+     * @brief Maximum of elements over given axes, ignoring nan.
+     *
+     * Returns an \ref xreducer for the maximum of elements over given
+     * \em axes, ignoring nan. The result is nan where all the reduced
+     * elements are nan.
+     * @param e an \ref xexpression
+     * @param axes the axes along which the maximum is found (optional)
+     * @param es evaluation strategy of the reducer (optional)
+     * @return an \ref xreducer
+     */
+    XTENSOR_NAN_EXTREMUM_FUNCTION(nanmax, detail::nan_maximum)
+#ifdef X_OLD_CLANG
+    OLD_CLANG_NAN_EXTREMUM(nanmax, detail::nan_maximum)
+#else
+    MODERN_CLANG_NAN_EXTREMUM(nanmax, detail::nan_maximum)
+#endif
+
+#undef XTENSOR_NAN_EXTREMUM_FUNCTION
+#undef OLD_CLANG_NAN_EXTREMUM
+#undef MODERN_CLANG_NAN_EXTREMUM
+
+    namespace detail
+    {
+        template <class V>
+        struct count_nonzero_functor
+        {
+            using result_type = std::size_t;
+
+            result_type operator()(result_type lhs, const V& rhs) const
+            {
+                return lhs + static_cast<result_type>(rhs != V(0));
+            }
+
+            // Immediate reductions of contiguous ranges go through this
+            // kernel, which compares simd batches to zero and counts the
+            // non-zero elements in their lanes, for the value types wide
+            // enough to hold the counts of a block; other types are counted
+            // by a loop without branches.
+            result_type reduce_contiguous(const V* first, std::size_t n) const
+            {
+#ifdef XTENSOR_USE_XSIMD
+                using use_simd = std::integral_constant<bool, std::is_arithmetic<V>::value &&
+                                                              (sizeof(V) >= 4) &&
+                                                              xsimd::simd_traits<V>::size != 1>;
+#else
+                using use_simd = std::false_type;
+#endif
+                return reduce_contiguous(first, n, use_simd());
+            }
+
+            // complete immediate reductions of bit-packed flags count the
+            // set bits of their blocks
+            template <class B>
+            result_type reduce_bitset(const B* blocks, std::size_t size) const noexcept
+            {
+                return count_bits(blocks, size);
+            }
+
+        private:
+
+            result_type reduce_contiguous(const V* first, std::size_t n, std::false_type /*simd*/) const
+            {
+                result_type res = 0;
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    res += static_cast<result_type>(first[i] != V(0));
+                }
+                return res;
+            }
+
+#ifdef XTENSOR_USE_XSIMD
+            // The lanes count the elements of blocks small enough for the
+            // counts to be exact in the value type.
+            result_type reduce_contiguous(const V* first, std::size_t n, std::true_type /*simd*/) const
+            {
+                using batch_type = xsimd::simd_type<V>;
+                constexpr std::size_t simd_size = batch_type::size;
+                constexpr std::size_t block_size = std::size_t(1) << 16;
+
+                const batch_type zero(V(0));
+                const batch_type one(V(1));
+                alignas(XTENSOR_CACHE_LINE_SIZE) V lanes[simd_size];
+                std::size_t simd_end = n - n % simd_size;
+                result_type res = 0;
+                for (std::size_t b = 0; b < simd_end; b += block_size)
+                {
+                    std::size_t b_end = (std::min)(b + block_size, simd_end);
+                    batch_type cnt = zero;
+                    for (std::size_t i = b; i < b_end; i += simd_size)
+                    {
+                        batch_type v = xsimd::load_simd<V, V>(first + i, xsimd::unaligned_mode());
+                        cnt += xsimd::select(v != zero, one, zero);
+                    }
+                    cnt.store_unaligned(lanes);
+                    for (std::size_t l = 0; l < simd_size; ++l)
+                    {
+                        res += static_cast<result_type>(lanes[l]);
+                    }
+                }
+                return res + reduce_contiguous(first + simd_end, n - simd_end, std::false_type());
+            }
+#endif
+        };
+    }
+
 #define COUNT_NON_ZEROS_CONTENT                                                 \
     using result_type = std::size_t;                                            \
     using value_type = typename std::decay_t<E>::value_type;                    \
     auto init_fct = [](value_type const& lhs) -> result_type                    \
     {                                                                           \
-        return (lhs != value_type(0)) ? result_type(1) : result_type(0);        \
-    };                                                                          \
-    auto reduce_fct = [](const result_type& lhs, const value_type& rhs)         \
-         -> result_type                                                         \
-    {                                                                           \
-        return (rhs != value_type(0)) ? lhs + result_type(1) : lhs;             \
+        return static_cast<result_type>(lhs != value_type(0));                  \
     };                                                                          \
+    auto reduce_fct = detail::count_nonzero_functor<value_type>();              \
     auto merge_func = std::plus<result_type>();                                 \
 
+    /**
+     * @ingroup red_functions
+     * @brief Number of non-zero elements over given axes.
+     *
+     * Returns an \ref xreducer for the number of non-zero elements of
+     * \em e over the given \em axes (all the axes if none is given). With
+     * the immediate strategy, the contiguous ranges of the expression are
+     * counted with simd batches, in parallel partial counts for large
+     * complete reductions and row by row for reductions over the innermost
+     * axes; other axes are counted by rows accumulated into the result.
+     * @param e an \ref xexpression
+     * @param axes the axes along which the elements are counted (optional)
+     * @param es evaluation strategy of the reducer (optional)
+     * @return an \ref xreducer
+     */
     template <class E, class EVS = DEFAULT_STRATEGY_REDUCERS,
               class = std::enable_if_t<std::is_base_of<evaluation_strategy::base, EVS>::value, int>>
     inline auto count_nonzero(E&& e, EVS es = EVS())
@@ -2201,37 +3169,536 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
 
     namespace detail
     {
-        template <class T>
-        struct diff_impl
+        // Moments of the elements which are not NaN, the count of the
+        // result is 0 if all the elements are NaN.
+        template <class R, class V>
+        struct nan_moments_functor
         {
-            template <class Arg>
-            inline void operator()(Arg& ad, const std::size_t& n,
-                                   xstrided_slice_vector& slice1, xstrided_slice_vector& slice2,
-                                   std::size_t saxis)
+            using result_type = xmoments<R>;
+
+            static result_type empty()
             {
-                for (std::size_t i = 0; i < n; ++i)
+                R nan = std::numeric_limits<R>::quiet_NaN();
+                return result_type{0, R(0), R(0), nan, nan};
+            }
+
+            static result_type init(const V& v)
+            {
+                R x = static_cast<R>(v);
+                return math::isnan(v) ? empty() : result_type{1, x, R(0), x, x};
+            }
+
+            static result_type merge(result_type r, const result_type& s)
+            {
+                if (s.count == 0)
+                {
+                    return r;
+                }
+                if (r.count == 0)
+                {
+                    return s;
+                }
+                std::size_t count = r.count + s.count;
+                R delta = s.mean - r.mean;
+                R weight = static_cast<R>(s.count) / static_cast<R>(count);
+                r.mean += delta * weight;
+                r.m2 += s.m2 + delta * delta * static_cast<R>(r.count) * weight;
+                r.count = count;
+                r.min = s.min < r.min ? s.min : r.min;
+                r.max = r.max < s.max ? s.max : r.max;
+                return r;
+            }
+
+            result_type operator()(result_type r, const V& v) const
+            {
+                if (math::isnan(v))
+                {
+                    return r;
+                }
+                if (r.count == 0)
+                {
+                    return init(v);
+                }
+                R x = static_cast<R>(v);
+                ++r.count;
+                R delta = x - r.mean;
+                r.mean += delta / static_cast<R>(r.count);
+                r.m2 += delta * (x - r.mean);
+                r.min = x < r.min ? x : r.min;
+                r.max = r.max < x ? x : r.max;
+                return r;
+            }
+
+            result_type reduce_contiguous(const V* first, std::size_t n) const
+            {
+#ifdef XTENSOR_USE_XSIMD
+                using use_simd = std::integral_constant<bool, std::is_same<R, V>::value &&
+                                                              std::is_floating_point<V>::value &&
+                                                              xsimd::simd_traits<V>::size != 1>;
+#else
+                using use_simd = std::false_type;
+#endif
+                return reduce_contiguous(first, n, use_simd());
+            }
+
+        private:
+
+            result_type reduce_contiguous(const V* first, std::size_t n, std::false_type /*simd*/) const
+            {
+                return std::accumulate(first + 1, first + n, init(first[0]), *this);
+            }
+
+#ifdef XTENSOR_USE_XSIMD
+            // Sums of the deviations from the first element which is not NaN
+            // and of their squares are accumulated with masked blends, by
+            // blocks small enough for the lane counts to be exact. The blocks
+            // are merged as partial results.
+            result_type reduce_contiguous(const V* first, std::size_t n, std::true_type /*simd*/) const
+            {
+                using batch_type = xsimd::simd_type<V>;
+                constexpr std::size_t simd_size = batch_type::size;
+                constexpr std::size_t block_size = std::size_t(1) << 16;
+
+                std::size_t k = 0;
+                while (k < n && math::isnan(first[k]))
                 {
-                    slice2[saxis] = range(xnone(), ad.shape()[saxis] - 1);
-                    ad = strided_view(ad, slice1) - strided_view(ad, slice2);
+                    ++k;
                 }
+                if (k == n)
+                {
+                    return empty();
+                }
+                const R shift = first[k];
+                result_type res = init(first[k]);
+
+                const batch_type zero(R(0));
+                const batch_type one(R(1));
+                const batch_type sh(shift);
+                alignas(XTENSOR_CACHE_LINE_SIZE) R lanes[4][simd_size];
+                for (std::size_t b = k + 1; b < n; b += block_size)
+                {
+                    std::size_t b_end = (std::min)(b + block_size, n);
+                    std::size_t simd_end = b_end - (b_end - b) % simd_size;
+                    batch_type s1 = zero, s2 = zero, cnt = zero, mn = sh, mx = sh;
+                    for (std::size_t i = b; i < simd_end; i += simd_size)
+                    {
+                        batch_type v = xsimd::load_simd<V, V>(first + i, xsimd::unaligned_mode());
+                        auto mask = v == v;
+                        batch_type d = xsimd::select(mask, v - sh, zero);
+                        s1 += d;
+                        s2 += d * d;
+                        cnt += xsimd::select(mask, one, zero);
+                        mn = xsimd::select(v < mn, v, mn);
+                        mx = xsimd::select(mx < v, v, mx);
+                    }
+                    s1.store_unaligned(lanes[0]);
+                    s2.store_unaligned(lanes[1]);
+                    mn.store_unaligned(lanes[2]);
+                    mx.store_unaligned(lanes[3]);
+                    R S1 = R(0), S2 = R(0);
+                    result_type block = init(first[k]);
+                    for (std::size_t l = 0; l < simd_size; ++l)
+                    {
+                        S1 += lanes[0][l];
+                        S2 += lanes[1][l];
+                        block.min = lanes[2][l] < block.min ? lanes[2][l] : block.min;
+                        block.max = block.max < lanes[3][l] ? lanes[3][l] : block.max;
+                    }
+                    cnt.store_unaligned(lanes[0]);
+                    R C = std::accumulate(lanes[0], lanes[0] + simd_size, R(0));
+                    for (std::size_t i = simd_end; i < b_end; ++i)
+                    {
+                        if (!math::isnan(first[i]))
+                        {
+                            R d = first[i] - shift;
+                            S1 += d;
+                            S2 += d * d;
+                            C += R(1);
+                            block.min = first[i] < block.min ? first[i] : block.min;
+                            block.max = block.max < first[i] ? first[i] : block.max;
+                        }
+                    }
+                    if (C > R(0))
+                    {
+                        block.count = static_cast<std::size_t>(C);
+                        block.mean = shift + S1 / C;
+                        block.m2 = (std::max)(S2 - S1 * S1 / C, R(0));
+                        res = merge(res, block);
+                    }
+                }
+                return res;
+            }
+#endif
+        };
+
+        template <class R, class V>
+        inline auto make_nan_moments_functor()
+        {
+            using functor_type = nan_moments_functor<R, V>;
+            auto init_func = [](V const& v) {
+                return functor_type::init(v);
+            };
+            auto merge_func = [](typename functor_type::result_type r, typename functor_type::result_type const& s) {
+                return functor_type::merge(r, s);
+            };
+            return make_xreducer_functor(functor_type(), std::move(init_func), std::move(merge_func));
+        }
+
+        template <class R>
+        struct nan_mean_of
+        {
+            R operator()(const xmoments<R>& m) const
+            {
+                return m.count == 0 ? std::numeric_limits<R>::quiet_NaN() : m.mean;
+            }
+        };
+
+        template <class R>
+        struct nan_variance_of
+        {
+            R operator()(const xmoments<R>& m) const
+            {
+                return m.count == 0 ? std::numeric_limits<R>::quiet_NaN() : m.variance();
+            }
+        };
+
+        template <class R>
+        struct nan_stddev_of
+        {
+            R operator()(const xmoments<R>& m) const
+            {
+                return m.count == 0 ? std::numeric_limits<R>::quiet_NaN() : m.stddev();
+            }
+        };
+    }
+
+#define XTENSOR_NAN_MOMENTS_FUNCTION(NAME, ACCESSOR)                                                              \
+    template <class T = void, class E, class X, class EVS = DEFAULT_STRATEGY_REDUCERS,                            \
+              class = std::enable_if_t<!std::is_base_of<evaluation_strategy::base, std::decay_t<X>>::value, int>> \
+    inline auto NAME(E&& e, X&& axes, EVS es = EVS())                                                             \
+    {                                                                                                             \
+        using stat_type = std::conditional_t<std::is_same<T, void>::value, double, T>;                            \
+        using value_type = typename std::decay_t<E>::value_type;                                                  \
+        return make_lambda_xfunction(ACCESSOR<stat_type>(),                                                       \
+                                     reduce(detail::make_nan_moments_functor<stat_type, value_type>(),            \
+                                            std::forward<E>(e), std::forward<X>(axes), es));                      \
+    }                                                                                                             \
+                                                                                                                  \
+    template <class T = void, class E, class EVS = DEFAULT_STRATEGY_REDUCERS,                                     \
+              class = std::enable_if_t<std::is_base_of<evaluation_strategy::base, EVS>::value, int>>              \
+    inline auto NAME(E&& e, EVS es = EVS())                                                                       \
+    {                                                                                                             \
+        using stat_type = std::conditional_t<std::is_same<T, void>::value, double, T>;                            \
+        using value_type = typename std::decay_t<E>::value_type;                                                  \
+        return make_lambda_xfunction(ACCESSOR<stat_type>(),                                                       \
+                                     reduce(detail::make_nan_moments_functor<stat_type, value_type>(),            \
+                                            std::forward<E>(e), es));                                             \
+    }
+
+#define OLD_CLANG_NAN_MOMENTS(NAME, ACCESSOR)                                                                     \
+    template <class T = void, class E, class I, class EVS = DEFAULT_STRATEGY_REDUCERS>                            \
+    inline auto NAME(E&& e, std::initializer_list<I> axes, EVS es = EVS())                                        \
+    {                                                                                                             \
+        using stat_type = std::conditional_t<std::is_same<T, void>::value, double, T>;                            \
+        using value_type = typename std::decay_t<E>::value_type;                                                  \
+        return make_lambda_xfunction(ACCESSOR<stat_type>(),                                                       \
+                                     reduce(detail::make_nan_moments_functor<stat_type, value_type>(),            \
+                                            std::forward<E>(e), axes, es));                                       \
+    }
+
+#define MODERN_CLANG_NAN_MOMENTS(NAME, ACCESSOR)                                                                  \
+    template <class T = void, class E, class I, std::size_t N, class EVS = DEFAULT_STRATEGY_REDUCERS>             \
+    inline auto NAME(E&& e, const I (&axes)[N], EVS es = EVS())                                                   \
+    {                                                                                                             \
+        using stat_type = std::conditional_t<std::is_same<T, void>::value, double, T>;                            \
+        using value_type = typename std::decay_t<E>::value_type;                                                  \
+        return make_lambda_xfunction(ACCESSOR<stat_type>(),                                                       \
+                                     reduce(detail::make_nan_moments_functor<stat_type, value_type>(),            \
+                                            std::forward<E>(e), axes, es));                                       \
+    }
+
+    /**
+     * @ingroup nan_functions
+     * @brief Mean of elements over given axes, ignoring nan.
+     *
+     * Returns an \ref xexpression for the mean of elements over given
+     * \em axes, ignoring nan, computed in a single pass. The result is nan
+     * where all the reduced elements are nan.
+     * @param e an \ref xexpression
+     * @param axes the axes along which the mean is computed (optional)
+     * @param es evaluation strategy of the reducer (optional)
+     * @tparam T the type used to compute the mean (double by default)
+     * @return an \ref xexpression
+     */
+    XTENSOR_NAN_MOMENTS_FUNCTION(nanmean, detail::nan_mean_of)
+#ifdef X_OLD_CLANG
+    OLD_CLANG_NAN_MOMENTS(nanmean, detail::nan_mean_of)
+#else
+    MODERN_CLANG_NAN_MOMENTS(nanmean, detail::nan_mean_of)
+#endif
+
+    /**
+     * @ingroup nan_functions
+     * @brief Variance of elements over given axes, ignoring nan.
+     *
+     * Returns an \ref xexpression for the population variance of elements
+     * over given \em axes, ignoring nan, computed in a single pass. The
+     * result is nan where all the reduced elements are nan.
+     * @param e an \ref xexpression
+     * @param axes the axes along which the variance is computed (optional)
+     * @param es evaluation strategy of the reducer (optional)
+     * @tparam T the type used to compute the variance (double by default)
+     * @return an \ref xexpression
+     */
+    XTENSOR_NAN_MOMENTS_FUNCTION(nanvar, detail::nan_variance_of)
+#ifdef X_OLD_CLANG
+    OLD_CLANG_NAN_MOMENTS(nanvar, detail::nan_variance_of)
+#else
+    MODERN_CLANG_NAN_MOMENTS(nanvar, detail::nan_variance_of)
+#endif
+
+    /**
+     * @ingroup nan_functions
+     * @brief Standard deviation of elements over given axes, ignoring nan.
+     *
+     * Returns an \ref xexpression for the population standard deviation of
+     * elements over given \em axes, ignoring nan, computed in a single pass.
+     * The result is nan where all the reduced elements are nan.
+     * @param e an \ref xexpression
+     * @param axes the axes along which the standard deviation is computed (optional)
+     * @param es evaluation strategy of the reducer (optional)
+     * @tparam T the type used to compute the standard deviation (double by default)
+     * @return an \ref xexpression
+     */
+    XTENSOR_NAN_MOMENTS_FUNCTION(nanstd, detail::nan_stddev_of)
+#ifdef X_OLD_CLANG
+    OLD_CLANG_NAN_MOMENTS(nanstd, detail::nan_stddev_of)
+#else
+    MODERN_CLANG_NAN_MOMENTS(nanstd, detail::nan_stddev_of)
+#endif
+
+#undef XTENSOR_NAN_MOMENTS_FUNCTION
+#undef OLD_CLANG_NAN_MOMENTS
+#undef MODERN_CLANG_NAN_MOMENTS
+
+    namespace detail
+    {
+        template <class T>
+        struct diff_op
+        {
+            T operator()(const T& next, const T& prev) const
+            {
+                return static_cast<T>(next - prev);
             }
         };
 
         template <>
-        struct diff_impl<bool>
+        struct diff_op<bool>
         {
-            template <class Arg>
-            inline void operator()(Arg& ad, const std::size_t& n,
-                                   xstrided_slice_vector& slice1, xstrided_slice_vector& slice2,
-                                   std::size_t saxis)
+            bool operator()(bool next, bool prev) const
             {
-                for (std::size_t i = 0; i < n; ++i)
+                return next != prev;
+            }
+        };
+
+        // Describes an expression of row major layout as n_blocks blocks
+        // of n_axis rows of row_size contiguous elements along axis.
+        struct axis_blocks
+        {
+            std::size_t n_blocks;
+            std::size_t n_axis;
+            std::size_t row_size;
+        };
+
+        template <class S>
+        inline axis_blocks make_axis_blocks(const S& shape, std::size_t axis)
+        {
+            auto first = shape.cbegin();
+            std::ptrdiff_t ax = static_cast<std::ptrdiff_t>(axis);
+            return {std::accumulate(first, first + ax, std::size_t(1), std::multiplies<std::size_t>()),
+                    static_cast<std::size_t>(shape[axis]),
+                    std::accumulate(first + ax + 1, shape.cend(), std::size_t(1), std::multiplies<std::size_t>())};
+        }
+
+        // Returns a pointer to the elements of e in row major order, copying
+        // them in tmp if the layout of e is different.
+        template <class E, class C>
+        inline const typename E::value_type* row_major_data(const E& e, C& tmp)
+        {
+            if (e.layout() == layout_type::row_major)
+            {
+                return e.data() + e.data_offset();
+            }
+            tmp = e;
+            return tmp.data();
+        }
+
+        // Calls f(first, last) on ranges of the items [0, n) of work_per_item
+        // elements each, splitting them among threads when the work is large
+        // enough.
+        template <class F>
+        inline void for_each_block(std::size_t n, std::size_t work_per_item, F&& f)
+        {
+            if (n > 1 && parallel::use_parallel(n * work_per_item))
+            {
+                parallel_for(std::size_t(0), n, parallel::grain(work_per_item), f);
+            }
+            else
+            {
+                f(std::size_t(0), n);
+            }
+        }
+
+        constexpr std::size_t diff_chunk_size = 1024;
+        constexpr std::size_t diff_tile_size = 256;
+
+        // n-th order differences of contiguous lanes: chunks of the lane are
+        // copied in a buffer staying in the L1 cache, where the n passes of
+        // differences are applied, so that the lane is read once.
+        template <class T>
+        inline void diff_lanes(const T* in, T* out, const axis_blocks& b, std::size_t n)
+        {
+            std::size_t n_out = b.n_axis - n;
+            diff_op<T> op;
+            for_each_block(b.n_blocks, b.n_axis * n, [&](std::size_t first, std::size_t last)
+            {
+                std::vector<T> buf((std::min)(diff_chunk_size, n_out) + n);
+                for (std::size_t block = first; block < last; ++block)
+                {
+                    const T* lane = in + block * b.n_axis;
+                    T* res = out + block * n_out;
+                    for (std::size_t i = 0; i < n_out; i += diff_chunk_size)
+                    {
+                        std::size_t m = (std::min)(diff_chunk_size, n_out - i);
+                        std::copy(lane + i, lane + i + m + n, buf.begin());
+                        for (std::size_t k = 0; k < n; ++k)
+                        {
+                            for (std::size_t j = 0; j + 1 < m + n - k; ++j)
+                            {
+                                buf[j] = op(buf[j + 1], buf[j]);
+                            }
+                        }
+                        std::copy(buf.begin(), buf.begin() + std::ptrdiff_t(m), res + i);
+                    }
+                }
+            });
+        }
+
+        // n-th order differences along rows of row_size > 1 elements: tiles
+        // of columns are processed with a sliding window holding the last
+        // difference of each order, each element being read once and the
+        // inner loops running over contiguous columns.
+        template <class T>
+        inline void diff_rows(const T* in, T* out, const axis_blocks& b, std::size_t n)
+        {
+            std::size_t n_tiles = (b.row_size + diff_tile_size - 1) / diff_tile_size;
+            std::size_t n_out = b.n_axis - n;
+            diff_op<T> op;
+            std::size_t tile = (std::min)(diff_tile_size, b.row_size);
+            for_each_block(b.n_blocks * n_tiles, b.n_axis * n * tile, [&](std::size_t first, std::size_t last)
+            {
+                std::vector<T> window(n * tile);
+                std::vector<T> cur(tile);
+                for (std::size_t item = first; item < last; ++item)
                 {
-                    slice2[saxis] = range(xnone(), ad.shape()[saxis] - 1);
-                    ad = not_equal(strided_view(ad, slice1), strided_view(ad, slice2));
+                    std::size_t block = item / n_tiles;
+                    std::size_t c0 = (item - block * n_tiles) * diff_tile_size;
+                    std::size_t w = (std::min)(diff_tile_size, b.row_size - c0);
+                    const T* src = in + block * b.n_axis * b.row_size + c0;
+                    T* dst = out + block * n_out * b.row_size + c0;
+                    for (std::size_t k = 0; k < b.n_axis; ++k, src += b.row_size)
+                    {
+                        std::copy(src, src + w, cur.begin());
+                        std::size_t orders = (std::min)(k, n);
+                        for (std::size_t j = 0; j < orders; ++j)
+                        {
+                            auto prev = window.begin() + std::ptrdiff_t(j * w);
+                            for (std::size_t c = 0; c < w; ++c)
+                            {
+                                T t = op(cur[c], prev[c]);
+                                prev[c] = cur[c];
+                                cur[c] = t;
+                            }
+                        }
+                        auto cur_end = cur.begin() + std::ptrdiff_t(w);
+                        if (k < n)
+                        {
+                            std::copy(cur.begin(), cur_end, window.begin() + std::ptrdiff_t(k * w));
+                        }
+                        else
+                        {
+                            std::copy(cur.begin(), cur_end, dst + (k - n) * b.row_size);
+                        }
+                    }
                 }
+            });
+        }
+
+        // Fused trapezoidal rule: out receives, for each row of the reduced
+        // axis, the sum of (y[k] + y[k + 1]) * h(k, c), where h is the half
+        // width of the interval k at the column c.
+        template <class R, class T, class H>
+        inline void trapz_rows(const T* y, R* out, const axis_blocks& b, H&& h)
+        {
+            if (b.row_size == 1)
+            {
+                // four partial sums break the dependency between the terms
+                for_each_block(b.n_blocks, b.n_axis, [&](std::size_t first, std::size_t last)
+                {
+                    std::size_t n_terms = b.n_axis > 1 ? b.n_axis - 1 : 0;
+                    for (std::size_t block = first; block < last; ++block)
+                    {
+                        const T* lane = y + block * b.n_axis;
+                        R acc[4] = {R(0), R(0), R(0), R(0)};
+                        std::size_t k = 0;
+                        for (; k + 4 <= n_terms; k += 4)
+                        {
+                            for (std::size_t u = 0; u < 4; ++u)
+                            {
+                                acc[u] += (lane[k + u] + lane[k + u + 1]) * h(block, k + u, 0);
+                            }
+                        }
+                        for (; k < n_terms; ++k)
+                        {
+                            acc[0] += (lane[k] + lane[k + 1]) * h(block, k, 0);
+                        }
+                        out[block] = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+                    }
+                });
+                return;
             }
-        };
+
+            for_each_block(b.n_blocks, b.n_axis * b.row_size, [&](std::size_t first, std::size_t last)
+            {
+                for (std::size_t block = first; block < last; ++block)
+                {
+                    const T* rows = y + block * b.n_axis * b.row_size;
+                    R* res = out + block * b.row_size;
+                    std::fill(res, res + b.row_size, R(0));
+                    for (std::size_t k = 0; k + 1 < b.n_axis; ++k)
+                    {
+                        const T* row = rows + k * b.row_size;
+                        const T* next = row + b.row_size;
+                        for (std::size_t c = 0; c < b.row_size; ++c)
+                        {
+                            res[c] += (row[c] + next[c]) * h(block, k, c);
+                        }
+                    }
+                }
+            });
+        }
+
+        template <class S>
+        inline S reduced_shape(const S& shape, std::size_t axis)
+        {
+            S res;
+            resize_container(res, shape.size() - 1);
+            auto first = shape.cbegin();
+            std::ptrdiff_t ax = static_cast<std::ptrdiff_t>(axis);
+            std::copy(first, first + ax, res.begin());
+            std::copy(first + ax + 1, shape.cend(), res.begin() + ax);
+            return res;
+        }
     }
 
     /**
@@ -2239,6 +3706,7 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
      * @brief Calculate the n-th discrete difference along the given axis.
      *
      * Calculate the n-th discrete difference along the given axis. This function is not lazy (might change in the future).
+     * The differences of all orders are computed in a single pass over the elements.
      * @param a an \ref xexpression
      * @param n The number of times values are differenced. If zero, the input is returned as-is. (optional)
      * @param axis The axis along which the difference is taken, default is the last axis.
@@ -2247,22 +3715,49 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
     template <class T>
     auto diff(const xexpression<T>& a, std::size_t n = 1, std::ptrdiff_t axis = -1)
     {
-        auto ad = a.derived_cast();
+        using value_type = typename T::value_type;
+        using result_type = typename T::temporary_type;
+        auto&& ad = eval(a.derived_cast());
         std::size_t saxis = normalize_axis(ad.dimension(), axis);
 
         if (n == 0)
         {
-            return eval(ad);
+            return result_type(ad);
         }
 
-        xstrided_slice_vector slice1(ad.dimension(), all());
-        xstrided_slice_vector slice2(ad.dimension(), all());
-        slice1[saxis] = range(1, xnone());
+        xarray<value_type> tmp;
+        const value_type* data = detail::row_major_data(ad, tmp);
+        detail::axis_blocks blocks = detail::make_axis_blocks(ad.shape(), saxis);
 
-        detail::diff_impl<typename T::value_type> impl;
-        impl(ad, n, slice1, slice2, saxis);
+        dynamic_shape<std::size_t> shape(ad.shape().cbegin(), ad.shape().cend());
+        shape[saxis] = n < blocks.n_axis ? blocks.n_axis - n : std::size_t(0);
+        auto compute = [&](value_type* out) {
+            if (blocks.n_blocks * shape[saxis] * blocks.row_size == 0)
+            {
+                return;
+            }
+            if (blocks.row_size == 1)
+            {
+                detail::diff_lanes(data, out, blocks, n);
+            }
+            else
+            {
+                detail::diff_rows(data, out, blocks, n);
+            }
+        };
 
-        return eval(ad);
+        result_type result = result_type::from_shape(shape);
+        if (result.layout() == layout_type::row_major)
+        {
+            compute(result.data());
+        }
+        else
+        {
+            auto res = xarray<value_type>::from_shape(shape);
+            compute(res.data());
+            result = res;
+        }
+        return result;
     }
 
     /**
@@ -2278,17 +3773,18 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
     template <class T>
     auto trapz(const xexpression<T>& y, double dx = 1.0, std::ptrdiff_t axis = -1)
     {
-        auto& yd = y.derived_cast();
+        using value_type = typename T::value_type;
+        using result_value_type = std::decay_t<decltype(std::declval<double>() * std::declval<value_type>())>;
+        auto&& yd = eval(y.derived_cast());
         std::size_t saxis = normalize_axis(yd.dimension(), axis);
 
-        xstrided_slice_vector slice1(yd.dimension(), all());
-        xstrided_slice_vector slice2(yd.dimension(), all());
-        slice1[saxis] = range(1, xnone());
-        slice2[saxis] = range(xnone(), yd.shape()[saxis] - 1);
-
-        auto trap = dx * (strided_view(yd, slice1) + strided_view(yd, slice2)) * 0.5;
-
-        return eval(sum(trap, {saxis}));
+        xarray<value_type> tmp;
+        const value_type* data = detail::row_major_data(yd, tmp);
+        detail::axis_blocks blocks = detail::make_axis_blocks(yd.shape(), saxis);
+        auto res = xarray<result_value_type>::from_shape(detail::reduced_shape(dynamic_shape<std::size_t>(yd.shape().cbegin(), yd.shape().cend()), saxis));
+        double half = dx * 0.5;
+        detail::trapz_rows(data, res.data(), blocks, [half](std::size_t, std::size_t, std::size_t) { return half; });
+        return res;
     }
 
     /**
@@ -2304,41 +3800,51 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
     template <class T, class E>
     auto trapz(const xexpression<T>& y, const xexpression<E>& x, std::ptrdiff_t axis = -1)
     {
-        auto& yd = y.derived_cast();
-        auto& xd = x.derived_cast();
-        decltype(diff(x)) dx;
-
+        using value_type = typename T::value_type;
+        using x_value_type = typename E::value_type;
+        using result_value_type = std::decay_t<decltype(std::declval<x_value_type>() *
+                                                        (std::declval<value_type>() + std::declval<value_type>()) * 0.5)>;
+        auto&& yd = eval(y.derived_cast());
+        const auto& xd = x.derived_cast();
         std::size_t saxis = normalize_axis(yd.dimension(), axis);
 
+        xarray<value_type> tmp;
+        const value_type* data = detail::row_major_data(yd, tmp);
+        detail::axis_blocks blocks = detail::make_axis_blocks(yd.shape(), saxis);
+        auto res = xarray<result_value_type>::from_shape(detail::reduced_shape(dynamic_shape<std::size_t>(yd.shape().cbegin(), yd.shape().cend()), saxis));
+
         if (xd.dimension() == 1)
         {
-            dx = diff(x);
-            typename std::decay_t<decltype(yd)>::shape_type shape;
-            resize_container(shape, yd.dimension());
-            std::fill(shape.begin(), shape.end(), 1);
-            shape[saxis] = dx.shape()[0];
-            dx.reshape(shape);
+            if (xd.size() != blocks.n_axis)
+            {
+                throw std::runtime_error("trapz: x must have as many elements as y along axis");
+            }
+            xtensor<x_value_type, 1> xe = xd;
+            const x_value_type* px = xe.data();
+            detail::trapz_rows(data, res.data(), blocks, [px](std::size_t, std::size_t k, std::size_t) {
+                return (px[k + 1] - px[k]) * 0.5;
+            });
         }
         else
         {
-            dx = diff(x, 1, axis);
+            // the sample points are broadcast to the shape of y
+            xarray<x_value_type> xe = broadcast(xd, yd.shape());
+            const x_value_type* px = xe.data();
+            std::size_t n_axis = blocks.n_axis;
+            std::size_t row_size = blocks.row_size;
+            detail::trapz_rows(data, res.data(), blocks, [px, n_axis, row_size](std::size_t block, std::size_t k, std::size_t c) {
+                const x_value_type* p = px + (block * n_axis + k) * row_size + c;
+                return (p[row_size] - p[0]) * 0.5;
+            });
         }
-
-        xstrided_slice_vector slice1(yd.dimension(), all());
-        xstrided_slice_vector slice2(yd.dimension(), all());
-        slice1[saxis] = range(1, xnone());
-        slice2[saxis] = range(xnone(), yd.shape()[saxis] - 1);
-
-        auto trap = dx * (strided_view(yd, slice1) + strided_view(yd, slice2)) * 0.5;
-
-        return eval(sum(trap, {saxis}));
+        return res;
     }
 
     /**
      * @ingroup basic_functions
      * @brief Returns the one-dimensional piecewise linear interpolant to a function with given discrete data points (xp, fp), evaluated at x.
      *
-     * @param x The x-coordinates at which to evaluate the interpolated values (sorted).
+     * @param x The x-coordinates at which to evaluate the interpolated values.
      * @param xp The x-coordinates of the data points (sorted).
      * @param fp The y-coordinates of the data points, same length as xp.
      * @param left Value to return for x < xp[0].
@@ -2353,66 +3859,59 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
 
         // basic checks
         XTENSOR_ASSERT( xp.dimension() == 1 );
-        XTENSOR_ASSERT( std::is_sorted(x.cbegin(), x.cend()) );
         XTENSOR_ASSERT( std::is_sorted(xp.cbegin(), xp.cend()) );
 
         // allocate output
         auto f = xtensor<value_type, 1>::from_shape(x.shape());
 
-        // counter in "x": from left
-        size_type i = 0;
-
-        // fill f[i] for x[i] <= xp[0]
-        for (; i < x.size() ; ++i)
+        // index in "xp" of the first data point not less than each x; sorted
+        // x are searched by merging
+        auto&& xpe = eval(xp);
+        auto&& fpe = eval(fp);
+        xtensor<typename E1::value_type, 1> xe = x;
+        std::vector<std::size_t> ip(xe.size());
+        detail::search_sorted(xpe.data(), xpe.size(), xe.data(), xe.size(), ip.data(), false);
+
+        const auto* pxp = xpe.data();
+        const auto* pfp = fpe.data();
+        const auto* px = xe.data();
+        value_type* pf = f.data();
+        std::size_t n = xpe.size();
+        value_type vleft = static_cast<value_type>(left);
+        value_type vright = static_cast<value_type>(right);
+
+        // the loop has no branch so that it is vectorized (with gathers of
+        // the data points), the points outside of (xp[0], xp[-1]) being
+        // selected afterwards
+        auto evaluate = [&](std::size_t first, std::size_t last)
         {
-            if (x[i] > xp[0])
+            for (std::size_t i = first; i < last; ++i)
             {
-                break;
+                std::size_t j = (std::min)((std::max)(ip[i], std::size_t(1)), n - 1);
+                double dfp = static_cast<double>(pfp[j] - pfp[j - 1]);
+                double dxp = static_cast<double>(pxp[j] - pxp[j - 1]);
+                // the query is clamped so that the unused result stays finite
+                auto xi = (std::min)((std::max)(px[i], pxp[0]), pxp[n - 1]);
+                double dx  = static_cast<double>(xi - pxp[j - 1]);
+                value_type inner = pfp[j - 1] + static_cast<value_type>(dfp / dxp * dx);
+                pf[i] = px[i] <= pxp[0] ? vleft : (px[i] >= pxp[n - 1] ? vright : inner);
             }
-            f[i] = static_cast<value_type>(left);
-        }
-
-        // counter in "x": from right
-        // (index counts one right, to terminate the reverse loop, without risking being negative)
-        size_type imax = x.size();
+        };
 
-        // fill f[i] for x[-1] >= xp[-1]
-        for (; imax > 0 ; --imax)
+        if (n < 2)
         {
-            if (x[imax-1] < xp[xp.size() - 1])
+            for (size_type i = 0; i < xe.size(); ++i)
             {
-                break;
+                pf[i] = px[i] <= pxp[0] ? vleft : vright;
             }
-            f[imax-1] = static_cast<value_type>(right);
         }
-
-        // catch edge case: all entries are "right"
-        if (imax == 0)
+        else if (parallel::use_parallel(xe.size()))
         {
-            return f;
+            parallel_for(std::size_t(0), xe.size(), parallel::grain(1), evaluate);
         }
-
-        // set "imax" as actual index
-        // (counted one right, see above)
-        --imax;
-
-        // counter in "xp"
-        size_type ip = 1;
-
-        // fill f[i] for the interior
-        for (; i <= imax ; ++i)
+        else
         {
-            // - search next value in "xp"
-            while (x[i] > xp[ip])
-            {
-                ++ip;
-            }
-            // - distances as doubles
-            double dfp = static_cast<double>(fp[ip] - fp[ip - 1]);
-            double dxp = static_cast<double>(xp[ip] - xp[ip - 1]);
-            double dx  = static_cast<double>(x[i] - xp[ip - 1]);
-            // - interpolate
-            f[i] = fp[ip - 1] + static_cast<value_type>(dfp / dxp * dx);
+            evaluate(std::size_t(0), xe.size());
         }
 
         return f;
@@ -2422,7 +3921,7 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
      * @ingroup basic_functions
      * @brief Returns the one-dimensional piecewise linear interpolant to a function with given discrete data points (xp, fp), evaluated at x.
      *
-     * @param x The x-coordinates at which to evaluate the interpolated values (sorted).
+     * @param x The x-coordinates at which to evaluate the interpolated values.
      * @param xp The x-coordinates of the data points (sorted).
      * @param fp The y-coordinates of the data points, same length as xp.
      * @return an one-dimensional xarray, same length as x.
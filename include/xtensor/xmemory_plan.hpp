@@ -0,0 +1,396 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_MEMORY_PLAN_HPP
+#define XTENSOR_MEMORY_PLAN_HPP
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xbroadcast.hpp"
+#include "xeval.hpp"
+#include "xexpression.hpp"
+#include "xfunction.hpp"
+#include "xinfo.hpp"
+#include "xreducer.hpp"
+#include "xsemantic.hpp"
+#include "xstrided_view.hpp"
+#include "xutils.hpp"
+#include "xview.hpp"
+
+namespace xt
+{
+
+    /****************
+     * xmemory_plan *
+     ****************/
+
+    /**
+     * @class xmemory_plan
+     * @brief Memory needed by the evaluation of an expression.
+     *
+     * An xmemory_plan lists the buffers involved in the evaluation of an
+     * expression, as computed by \ref memory_plan before the evaluation:
+     *
+     * - the containers held by value by the expression, such as the results
+     *   of sorts or immediate reductions it operates on, which are already
+     *   allocated and stay alive during the evaluation;
+     * - the container of the result, when the expression is evaluated into a
+     *   new one;
+     * - the temporary of an assignment without noalias when the destination
+     *   may be involved in the expression;
+     * - the new storage of a destination that has to be resized.
+     *
+     * peak_bytes bounds the memory in use during the evaluation, and
+     * arena_bytes is the size to reserve in an arena_scope so that the
+     * allocations of the evaluation draw from a block allocated up front.
+     *
+     * \code{.cpp}
+     * xt::xarray<double> a = xt::ones<double>({1000, 1000});
+     * auto plan = xt::memory_plan(a, xt::transpose(a) + 1.);
+     * // plan.allocated_bytes() == 8000000, the aliasing temporary
+     * {
+     *     xt::arena_scope scope(plan.arena_bytes());
+     *     xt::eval_into(a, xt::transpose(a) + 1., xt::arena_allocator<double>());
+     * }
+     * \endcode
+     */
+    class xmemory_plan
+    {
+    public:
+
+        enum class kind
+        {
+            held,
+            result,
+            temporary,
+            resize
+        };
+
+        /**
+         * Buffer of the evaluation: \c expression is the type of the held
+         * container or of the evaluated expression, \c shape its shape.
+         */
+        struct allocation
+        {
+            kind what;
+            std::string expression;
+            std::vector<std::size_t> shape;
+            std::size_t bytes;
+        };
+
+        using container_type = std::vector<allocation>;
+
+        template <class E>
+        void add(kind what, const E& e, static_string expression, std::size_t value_size);
+
+        const container_type& allocations() const noexcept;
+
+        std::size_t held_bytes() const noexcept;
+        std::size_t allocated_bytes() const noexcept;
+        std::size_t peak_bytes() const noexcept;
+        std::size_t arena_bytes() const noexcept;
+
+        void report(std::ostream& out) const;
+
+    private:
+
+        container_type m_allocations;
+    };
+
+    const char* to_string(xmemory_plan::kind what) noexcept;
+
+    template <class E>
+    xmemory_plan memory_plan(const xexpression<E>& e);
+
+    template <class D, class E>
+    xmemory_plan memory_plan(const xexpression<D>& out, const xexpression<E>& e);
+
+    /*******************************
+     * xmemory_plan implementation *
+     *******************************/
+
+    /**
+     * Appends the buffer of \c e, whose elements take \c value_size bytes.
+     */
+    template <class E>
+    inline void xmemory_plan::add(kind what, const E& e, static_string expression, std::size_t value_size)
+    {
+        allocation a = {what, std::string(expression.data, expression.size),
+                        std::vector<std::size_t>(e.shape().cbegin(), e.shape().cend()),
+                        static_cast<std::size_t>(e.size()) * value_size};
+        m_allocations.push_back(std::move(a));
+    }
+
+    /**
+     * Returns the buffers of the evaluation, the held containers first.
+     */
+    inline auto xmemory_plan::allocations() const noexcept -> const container_type&
+    {
+        return m_allocations;
+    }
+
+    /**
+     * Returns the bytes of the containers held by the expression.
+     */
+    inline std::size_t xmemory_plan::held_bytes() const noexcept
+    {
+        std::size_t res = 0;
+        for (const allocation& a : m_allocations)
+        {
+            res += a.what == kind::held ? a.bytes : std::size_t(0);
+        }
+        return res;
+    }
+
+    /**
+     * Returns the bytes allocated by the evaluation.
+     */
+    inline std::size_t xmemory_plan::allocated_bytes() const noexcept
+    {
+        std::size_t res = 0;
+        for (const allocation& a : m_allocations)
+        {
+            res += a.what != kind::held ? a.bytes : std::size_t(0);
+        }
+        return res;
+    }
+
+    /**
+     * Returns an upper bound of the memory in use during the evaluation:
+     * the held containers plus all the allocations, as if none of them was
+     * released before the end of the evaluation.
+     */
+    inline std::size_t xmemory_plan::peak_bytes() const noexcept
+    {
+        return held_bytes() + allocated_bytes();
+    }
+
+    /**
+     * Returns the bytes an arena needs to serve all the allocations of the
+     * evaluation, alignment and bookkeeping included.
+     */
+    inline std::size_t xmemory_plan::arena_bytes() const noexcept
+    {
+        std::size_t res = 0;
+        for (const allocation& a : m_allocations)
+        {
+            res += a.what != kind::held ? detail::arena_footprint(a.bytes) : std::size_t(0);
+        }
+        return res;
+    }
+
+    /**
+     * Writes one line per buffer, then the totals.
+     */
+    inline void xmemory_plan::report(std::ostream& out) const
+    {
+        for (const allocation& a : m_allocations)
+        {
+            out << to_string(a.what) << ' ' << a.bytes << " bytes, shape (";
+            for (std::size_t i = 0; i < a.shape.size(); ++i)
+            {
+                out << (i == 0 ? "" : ", ") << a.shape[i];
+            }
+            out << ") " << a.expression << '\n';
+        }
+        out << "peak " << peak_bytes() << " bytes, allocated " << allocated_bytes() << " bytes\n";
+    }
+
+    inline const char* to_string(xmemory_plan::kind what) noexcept
+    {
+        switch (what)
+        {
+            case xmemory_plan::kind::held:
+                return "held";
+            case xmemory_plan::kind::result:
+                return "result";
+            case xmemory_plan::kind::temporary:
+                return "temporary";
+            case xmemory_plan::kind::resize:
+                return "resize";
+        }
+        return "unknown";
+    }
+
+    /******************************
+     * memory_plan implementation *
+     ******************************/
+
+    namespace detail
+    {
+        // Containers owning their storage, held by value in an expression
+        template <class T, bool = is_container<T>::value>
+        struct owns_storage : std::false_type
+        {
+        };
+
+        template <class T>
+        struct owns_storage<T, true> : std::is_same<typename T::temporary_type, T>
+        {
+        };
+
+        /**
+         * Collects the containers held by value in the operands of functions,
+         * broadcasts, lazy reducers and views. Other expressions are leaves.
+         */
+        template <class E>
+        struct held_storage_collector
+        {
+            static void run(const E&, xmemory_plan&)
+            {
+            }
+        };
+
+        template <class CT, class E>
+        inline void collect_held_storage(const E& e, xmemory_plan& plan)
+        {
+            using expression_type = std::decay_t<CT>;
+            if (!std::is_reference<CT>::value && owns_storage<expression_type>::value)
+            {
+                plan.add(xmemory_plan::kind::held, e, type_name<expression_type>(), sizeof(typename expression_type::value_type));
+            }
+            held_storage_collector<expression_type>::run(e, plan);
+        }
+
+        template <class F, class... CT>
+        struct held_storage_collector<xfunction<F, CT...>>
+        {
+            static void run(const xfunction<F, CT...>& e, xmemory_plan& plan)
+            {
+                run_impl(e.arguments(), plan, std::make_index_sequence<sizeof...(CT)>());
+            }
+
+        private:
+
+            template <class T, std::size_t... I>
+            static void run_impl(const T& arguments, xmemory_plan& plan, std::index_sequence<I...>)
+            {
+                int dummy[] = {0, (collect_held_storage<std::tuple_element_t<I, std::tuple<CT...>>>(std::get<I>(arguments), plan), 0)...};
+                (void) dummy;
+            }
+        };
+
+        template <class CT, class X>
+        struct held_storage_collector<xbroadcast<CT, X>>
+        {
+            static void run(const xbroadcast<CT, X>& e, xmemory_plan& plan)
+            {
+                collect_held_storage<CT>(e.expression(), plan);
+            }
+        };
+
+        template <class F, class CT, class X>
+        struct held_storage_collector<xreducer<F, CT, X>>
+        {
+            static void run(const xreducer<F, CT, X>& e, xmemory_plan& plan)
+            {
+                collect_held_storage<CT>(e.expression(), plan);
+            }
+        };
+
+        template <class CT, class... S>
+        struct held_storage_collector<xview<CT, S...>>
+        {
+            static void run(const xview<CT, S...>& e, xmemory_plan& plan)
+            {
+                collect_held_storage<CT>(e.expression(), plan);
+            }
+        };
+
+        template <class CT, class S, layout_type L, class FST>
+        struct held_storage_collector<xstrided_view<CT, S, L, FST>>
+        {
+            static void run(const xstrided_view<CT, S, L, FST>& e, xmemory_plan& plan)
+            {
+                collect_held_storage<CT>(e.expression(), plan);
+            }
+        };
+    }
+
+    /**
+     * Returns the memory needed to evaluate \c e into a new container, as
+     * done by eval: the containers held by \c e and, unless \c e is itself a
+     * container, the result.
+     * @param e the expression to evaluate
+     * @return an \ref xmemory_plan
+     */
+    template <class E>
+    inline xmemory_plan memory_plan(const xexpression<E>& e)
+    {
+        const E& de = e.derived_cast();
+        xmemory_plan plan;
+        detail::collect_held_storage<const E&>(de, plan);
+        if (!detail::is_container<E>::value)
+        {
+            plan.add(xmemory_plan::kind::result, de, type_name<E>(), sizeof(typename E::value_type));
+        }
+        return plan;
+    }
+
+    /**
+     * Returns the memory needed by the assignment of \c e to \c out without
+     * noalias: the containers held by \c e, the temporary used when \c out
+     * may be involved in \c e, and the new storage of \c out when it has to
+     * be resized. The assignments with noalias never need the temporary.
+     * @param out the destination of the assignment
+     * @param e the assigned expression
+     * @return an \ref xmemory_plan
+     */
+    template <class D, class E>
+    inline xmemory_plan memory_plan(const xexpression<D>& out, const xexpression<E>& e)
+    {
+        const D& dout = out.derived_cast();
+        const E& de = e.derived_cast();
+        std::size_t value_size = sizeof(typename D::value_type);
+        xmemory_plan plan;
+        detail::collect_held_storage<const E&>(de, plan);
+        if (detail::may_overlap(dout, de))
+        {
+            plan.add(xmemory_plan::kind::temporary, de, type_name<E>(), value_size);
+        }
+        else if (detail::is_container<D>::value && static_cast<std::size_t>(de.size()) != static_cast<std::size_t>(dout.size()))
+        {
+            plan.add(xmemory_plan::kind::resize, de, type_name<E>(), value_size);
+        }
+        return plan;
+    }
+
+    /**
+     * Evaluates \c e into \c out like the assignment without noalias, the
+     * temporary needed when \c out may be involved in \c e being allocated
+     * with \c alloc, for instance an arena_allocator within an arena_scope
+     * that reserves the arena_bytes of the \ref memory_plan of the
+     * assignment.
+     * @param out the destination
+     * @param e the expression to evaluate
+     * @param alloc the allocator of the temporary
+     * @return a reference to \c out
+     */
+    template <class C, class E, class A>
+    inline C& eval_into(C& out, const xexpression<E>& e, const A& alloc)
+    {
+        if (detail::may_overlap(out, e.derived_cast()))
+        {
+            auto tmp = eval(e.derived_cast(), alloc);
+            out.assign(tmp);
+        }
+        else
+        {
+            out.assign(e);
+        }
+        return out;
+    }
+}
+
+#endif
@@ -13,10 +13,12 @@
 // std::abs(int) prior to C++ 17
 #include <complex>
 #include <cstdlib>
+#include <limits>
 
 #include "xconcepts.hpp"
 #include "xmath.hpp"
 #include "xoperation.hpp"
+#include "xtensor_simd.hpp"
 #include "xutils.hpp"
 
 namespace xt
@@ -171,6 +173,413 @@ namespace xt
             : std::pow(norm_lp_to_p(t, p), 1.0 / p);
     }
 
+    /****************
+     * norm kernels *
+     ****************/
+
+    namespace detail
+    {
+        // Element-wise norms and their combination, for scalars and, when
+        // simd is true, for simd batches of floating point values.
+        struct norm_l0_kernel
+        {
+            static constexpr bool simd = false;
+
+            template <class T>
+            static auto norm(const T& v)
+            {
+                return norm_l0(v);
+            }
+
+            template <class R>
+            static R combine(const R& lhs, const R& rhs)
+            {
+                return lhs + rhs;
+            }
+        };
+
+        struct norm_l1_kernel
+        {
+            static constexpr bool simd = true;
+
+            template <class T>
+            static auto norm(const T& v)
+            {
+                return norm_l1(v);
+            }
+
+            template <class R>
+            static R combine(const R& lhs, const R& rhs)
+            {
+                return lhs + rhs;
+            }
+
+            template <class B>
+            static B simd_norm(const B& b)
+            {
+                using std::abs;
+                return abs(b);
+            }
+
+            template <class B>
+            static B simd_combine(const B& lhs, const B& rhs)
+            {
+                return lhs + rhs;
+            }
+        };
+
+        struct norm_sq_kernel
+        {
+            static constexpr bool simd = true;
+
+            template <class T>
+            static auto norm(const T& v)
+            {
+                return norm_sq(v);
+            }
+
+            template <class R>
+            static R combine(const R& lhs, const R& rhs)
+            {
+                return lhs + rhs;
+            }
+
+            template <class B>
+            static B simd_norm(const B& b)
+            {
+                return b * b;
+            }
+
+            template <class B>
+            static B simd_combine(const B& lhs, const B& rhs)
+            {
+                return lhs + rhs;
+            }
+        };
+
+        // the comparisons are those of std::max, so that NaN behave as in
+        // the scalar reduction
+        struct norm_linf_kernel
+        {
+            static constexpr bool simd = true;
+
+            template <class T>
+            static auto norm(const T& v)
+            {
+                return norm_linf(v);
+            }
+
+            template <class R>
+            static R combine(const R& lhs, const R& rhs)
+            {
+                return (std::max)(lhs, rhs);
+            }
+
+            template <class B>
+            static B simd_norm(const B& b)
+            {
+                using std::abs;
+                return abs(b);
+            }
+
+            template <class B>
+            static B simd_combine(const B& lhs, const B& rhs)
+            {
+                return xsimd::select(lhs < rhs, rhs, lhs);
+            }
+        };
+
+        template <class T, class R, class K>
+        struct use_simd_norm
+        {
+#ifdef XTENSOR_USE_XSIMD
+            static constexpr bool value = K::simd && std::is_same<T, R>::value && std::is_floating_point<T>::value &&
+                                          xsimd::simd_traits<T>::size > 1;
+#else
+            static constexpr bool value = false;
+#endif
+        };
+
+        // Reducing functor of the norms. Immediate reductions of contiguous
+        // ranges of floating point values go through reduce_contiguous, which
+        // accumulates in four simd batches.
+        template <class T, class R, class K>
+        struct norm_functor
+        {
+            R operator()(const R& r, const T& v) const
+            {
+                return K::combine(r, static_cast<R>(K::norm(v)));
+            }
+
+            R reduce_contiguous(const T* first, std::size_t n) const
+            {
+                using use_simd = std::integral_constant<bool, use_simd_norm<T, R, K>::value>;
+                return reduce_contiguous(first, n, use_simd());
+            }
+
+        private:
+
+            R reduce_contiguous(const T* first, std::size_t n, std::false_type /*simd*/) const
+            {
+                R res = static_cast<R>(K::norm(first[0]));
+                for (std::size_t i = 1; i < n; ++i)
+                {
+                    res = (*this)(res, first[i]);
+                }
+                return res;
+            }
+
+#ifdef XTENSOR_USE_XSIMD
+            R reduce_contiguous(const T* first, std::size_t n, std::true_type /*simd*/) const
+            {
+                using batch_type = xsimd::simd_type<T>;
+                constexpr std::size_t simd_size = batch_type::size;
+                constexpr std::size_t step = 4 * simd_size;
+                if (n < step)
+                {
+                    return reduce_contiguous(first, n, std::false_type());
+                }
+
+                std::size_t simd_end = n - n % step;
+                batch_type acc0 = K::simd_norm(xsimd::load_simd<T, T>(first, xsimd::unaligned_mode()));
+                batch_type acc1 = K::simd_norm(xsimd::load_simd<T, T>(first + simd_size, xsimd::unaligned_mode()));
+                batch_type acc2 = K::simd_norm(xsimd::load_simd<T, T>(first + 2 * simd_size, xsimd::unaligned_mode()));
+                batch_type acc3 = K::simd_norm(xsimd::load_simd<T, T>(first + 3 * simd_size, xsimd::unaligned_mode()));
+                for (std::size_t i = step; i < simd_end; i += step)
+                {
+                    const T* p = first + i;
+                    acc0 = K::simd_combine(acc0, K::simd_norm(xsimd::load_simd<T, T>(p, xsimd::unaligned_mode())));
+                    acc1 = K::simd_combine(acc1, K::simd_norm(xsimd::load_simd<T, T>(p + simd_size, xsimd::unaligned_mode())));
+                    acc2 = K::simd_combine(acc2, K::simd_norm(xsimd::load_simd<T, T>(p + 2 * simd_size, xsimd::unaligned_mode())));
+                    acc3 = K::simd_combine(acc3, K::simd_norm(xsimd::load_simd<T, T>(p + 3 * simd_size, xsimd::unaligned_mode())));
+                }
+                acc0 = K::simd_combine(K::simd_combine(acc0, acc1), K::simd_combine(acc2, acc3));
+
+                alignas(XTENSOR_CACHE_LINE_SIZE) T lanes[simd_size];
+                acc0.store_unaligned(lanes);
+                R res = lanes[0];
+                for (std::size_t l = 1; l < simd_size; ++l)
+                {
+                    res = K::combine(res, lanes[l]);
+                }
+                for (std::size_t i = simd_end; i < n; ++i)
+                {
+                    res = (*this)(res, first[i]);
+                }
+                return res;
+            }
+#endif
+        };
+
+        // Reducing functor of norm_lp_to_p. The contiguous kernel handles
+        // p = 1 and p = 2 as the L1 and squared L2 norms, and evaluates the
+        // powers on simd batches otherwise.
+        template <class T, class R>
+        struct norm_lp_to_p_functor
+        {
+            explicit norm_lp_to_p_functor(double p)
+                : m_p(p)
+            {
+            }
+
+            R operator()(const R& r, const T& v) const
+            {
+                return r + norm_lp_to_p(v, m_p);
+            }
+
+            R reduce_contiguous(const T* first, std::size_t n) const
+            {
+                using floating = std::integral_constant<bool, std::is_floating_point<T>::value && std::is_same<T, R>::value>;
+                return reduce_contiguous(first, n, floating());
+            }
+
+        private:
+
+            R reduce_contiguous(const T* first, std::size_t n, std::false_type /*floating*/) const
+            {
+                R res = norm_lp_to_p(first[0], m_p);
+                for (std::size_t i = 1; i < n; ++i)
+                {
+                    res = (*this)(res, first[i]);
+                }
+                return res;
+            }
+
+            R reduce_contiguous(const T* first, std::size_t n, std::true_type /*floating*/) const
+            {
+                if (m_p == 1.0)
+                {
+                    return norm_functor<T, R, norm_l1_kernel>().reduce_contiguous(first, n);
+                }
+                if (m_p == 2.0)
+                {
+                    return norm_functor<T, R, norm_sq_kernel>().reduce_contiguous(first, n);
+                }
+#ifdef XTENSOR_USE_XSIMD
+                using batch_type = xsimd::simd_type<T>;
+                constexpr std::size_t simd_size = batch_type::size;
+                if (m_p != 0.0 && simd_size > 1 && n >= simd_size)
+                {
+                    using std::abs;
+                    using std::pow;
+                    batch_type p(static_cast<T>(m_p));
+                    std::size_t simd_end = n - n % simd_size;
+                    batch_type acc = pow(abs(xsimd::load_simd<T, T>(first, xsimd::unaligned_mode())), p);
+                    for (std::size_t i = simd_size; i < simd_end; i += simd_size)
+                    {
+                        acc += pow(abs(xsimd::load_simd<T, T>(first + i, xsimd::unaligned_mode())), p);
+                    }
+                    alignas(XTENSOR_CACHE_LINE_SIZE) T lanes[simd_size];
+                    acc.store_unaligned(lanes);
+                    R res = lanes[0];
+                    for (std::size_t l = 1; l < simd_size; ++l)
+                    {
+                        res += lanes[l];
+                    }
+                    for (std::size_t i = simd_end; i < n; ++i)
+                    {
+                        res = (*this)(res, first[i]);
+                    }
+                    return res;
+                }
+#endif
+                return reduce_contiguous(first, n, std::false_type());
+            }
+
+            double m_p;
+        };
+
+        // Sum of squares scaled by the largest magnitude, as in the nrm2
+        // function of BLAS: the L2 norm is scale * sqrt(ssq), and neither
+        // overflows nor underflows when the squares of the elements would.
+        template <class R>
+        struct scaled_ssq
+        {
+            R scale;
+            R ssq;
+        };
+
+        template <class T, class R>
+        struct norm_l2_scaled_functor
+        {
+            using result_type = scaled_ssq<R>;
+
+            static result_type init(const T& v)
+            {
+                using std::abs;
+                R a = static_cast<R>(abs(v));
+                return result_type{a, a != R(0) ? R(1) : R(0)};
+            }
+
+            static result_type merge(result_type r, const result_type& s)
+            {
+                if (r.scale < s.scale)
+                {
+                    R ratio = r.scale / s.scale;
+                    return result_type{s.scale, s.ssq + r.ssq * ratio * ratio};
+                }
+                if (s.scale != R(0))
+                {
+                    R ratio = s.scale / r.scale;
+                    r.ssq += s.ssq * ratio * ratio;
+                }
+                return r;
+            }
+
+            // NaN fail the comparison and propagate through ssq
+            result_type operator()(result_type r, const T& v) const
+            {
+                using std::abs;
+                R a = static_cast<R>(abs(v));
+                if (a != R(0))
+                {
+                    if (r.scale < a)
+                    {
+                        R ratio = r.scale / a;
+                        r.ssq = R(1) + r.ssq * ratio * ratio;
+                        r.scale = a;
+                    }
+                    else
+                    {
+                        R ratio = a / r.scale;
+                        r.ssq += ratio * ratio;
+                    }
+                }
+                return r;
+            }
+
+            // The contiguous kernel scales the range by its largest magnitude,
+            // found in a first pass, and sums the squares in a second one; both
+            // passes use simd batches. Ranges holding infinities, NaN or only
+            // elements too small to be inverted take the scalar path.
+            result_type reduce_contiguous(const T* first, std::size_t n) const
+            {
+                using use_simd = std::integral_constant<bool, use_simd_norm<T, R, norm_sq_kernel>::value>;
+                return reduce_contiguous(first, n, use_simd());
+            }
+
+        private:
+
+            result_type reduce_contiguous(const T* first, std::size_t n, std::false_type /*simd*/) const
+            {
+                result_type res = init(first[0]);
+                for (std::size_t i = 1; i < n; ++i)
+                {
+                    res = (*this)(res, first[i]);
+                }
+                return res;
+            }
+
+            result_type reduce_contiguous(const T* first, std::size_t n, std::true_type /*simd*/) const
+            {
+                R scale = norm_functor<T, R, norm_linf_kernel>().reduce_contiguous(first, n);
+                if (!(scale >= std::numeric_limits<R>::min() && scale <= std::numeric_limits<R>::max()))
+                {
+                    return reduce_contiguous(first, n, std::false_type());
+                }
+                // the elements are scaled in a temporary block so that the
+                // squares are summed by the simd kernel of norm_sq; they are
+                // divided since the inverse of a large scale is denormal
+                constexpr std::size_t block_size = 1024;
+                alignas(XTENSOR_CACHE_LINE_SIZE) T block[block_size];
+                R ssq = R(0);
+                for (std::size_t offset = 0; offset < n; offset += block_size)
+                {
+                    std::size_t size = (std::min)(block_size, n - offset);
+                    for (std::size_t i = 0; i < size; ++i)
+                    {
+                        block[i] = first[offset + i] / scale;
+                    }
+                    ssq += norm_functor<T, R, norm_sq_kernel>().reduce_contiguous(block, size);
+                }
+                return result_type{scale, ssq};
+            }
+        };
+
+        template <class T, class R>
+        inline auto make_norm_l2_scaled_functor()
+        {
+            using functor_type = norm_l2_scaled_functor<T, R>;
+            auto init_func = [](T const& v) {
+                return functor_type::init(v);
+            };
+            auto merge_func = [](typename functor_type::result_type r, typename functor_type::result_type const& s) {
+                return functor_type::merge(r, s);
+            };
+            return make_xreducer_functor(functor_type(), std::move(init_func), std::move(merge_func));
+        }
+
+        template <class R>
+        struct scaled_norm_of
+        {
+            R operator()(const scaled_ssq<R>& s) const
+            {
+                using std::sqrt;
+                return s.scale * sqrt(s.ssq);
+            }
+        };
+    }
+
     /***********************************
      * norm functions for xexpressions *
      ***********************************/
@@ -195,9 +604,7 @@ namespace xt
 #endif
 
 
-#define XTENSOR_EMPTY
-#define XTENSOR_COMMA ,
-#define XTENSOR_NORM_FUNCTION(NAME, RESULT_TYPE, REDUCE_EXPR, REDUCE_OP, MERGE_FUNC) \
+#define XTENSOR_NORM_FUNCTION(NAME, RESULT_TYPE, KERNEL, MERGE_FUNC)                 \
     template <class E, class X, class EVS = DEFAULT_STRATEGY_REDUCERS,               \
               class = disable_evaluation_strategy<X>>                                \
     inline auto NAME(E&& e, X&& axes, EVS es = EVS()) noexcept                       \
@@ -205,13 +612,12 @@ namespace xt
         using value_type = typename std::decay_t<E>::value_type;                     \
         using result_type = RESULT_TYPE;                                             \
                                                                                      \
-        auto reduce_func = [](result_type const& r, value_type const& v) {           \
-            return REDUCE_EXPR(r REDUCE_OP NAME(v));                                 \
-        };                                                                           \
         auto init_func = [](value_type const& v) {                                   \
             return NAME(v);                                                          \
         };                                                                           \
-        return reduce(make_xreducer_functor(std::move(reduce_func),                  \
+        return reduce(make_xreducer_functor(detail::norm_functor<value_type,         \
+                                                                 result_type,        \
+                                                                 KERNEL>(),          \
                                             std::move(init_func),                    \
                                             MERGE_FUNC<result_type>()),              \
                       std::forward<E>(e), std::forward<X>(axes), es);                \
@@ -225,13 +631,11 @@ namespace xt
     }                                                                                \
     XTENSOR_NORM_FUNCTION_AXES(NAME)
 
-    XTENSOR_NORM_FUNCTION(norm_l0, unsigned long long, XTENSOR_EMPTY, +, std::plus)
-    XTENSOR_NORM_FUNCTION(norm_l1, big_promote_type_t<value_type>, XTENSOR_EMPTY, +, std::plus)
-    XTENSOR_NORM_FUNCTION(norm_sq, big_promote_type_t<value_type>, XTENSOR_EMPTY, +, std::plus)
-    XTENSOR_NORM_FUNCTION(norm_linf, decltype(norm_linf(std::declval<value_type>())), (std::max<result_type>), XTENSOR_COMMA, math::maximum)
+    XTENSOR_NORM_FUNCTION(norm_l0, unsigned long long, detail::norm_l0_kernel, std::plus)
+    XTENSOR_NORM_FUNCTION(norm_l1, big_promote_type_t<value_type>, detail::norm_l1_kernel, std::plus)
+    XTENSOR_NORM_FUNCTION(norm_sq, big_promote_type_t<value_type>, detail::norm_sq_kernel, std::plus)
+    XTENSOR_NORM_FUNCTION(norm_linf, decltype(norm_linf(std::declval<value_type>())), detail::norm_linf_kernel, math::maximum)
 
-#undef XTENSOR_EMPTY
-#undef XTENSOR_COMMA
 #undef XTENSOR_NORM_FUNCTION
 #undef XTENSOR_NORM_FUNCTION_AXES
     /// @endcond
@@ -328,6 +732,53 @@ namespace xt
     }
 #endif
 
+    /**
+     * @ingroup red_functions
+     * @brief L2 norm of an array-like argument over given axes, without overflow nor underflow.
+     *
+     * Returns an \ref xexpression for the L2 norm of the elements across given \em axes,
+     * computed like the nrm2 function of BLAS: the sum of the squares is scaled by the largest
+     * magnitude, so that the result is accurate when the squares of the elements overflow or
+     * underflow. It is slower than norm_l2, especially with the lazy strategy.
+     * @param e an \ref xexpression
+     * @param axes the axes along which the norm is computed (optional)
+     * @param es evaluation strategy to use (lazy (default), or immediate)
+     * @return an \ref xexpression (specifically: an \ref xfunction of an \ref xreducer or xcontainer,
+     * depending on evaluation strategy)
+     */
+    template <class E, class X, class EVS = DEFAULT_STRATEGY_REDUCERS,
+              XTENSOR_REQUIRE<is_xexpression<E>::value>, class = disable_evaluation_strategy<X>>
+    inline auto norm_l2_scaled(E&& e, X&& axes, EVS es = EVS())
+    {
+        using value_type = typename std::decay_t<E>::value_type;
+        using result_type = real_promote_type_t<decltype(norm_l2(std::declval<value_type>()))>;
+        return make_lambda_xfunction(detail::scaled_norm_of<result_type>(),
+                                     reduce(detail::make_norm_l2_scaled_functor<value_type, result_type>(),
+                                            std::forward<E>(e), std::forward<X>(axes), es));
+    }
+
+    template <class E, class EVS = DEFAULT_STRATEGY_REDUCERS, XTENSOR_REQUIRE<is_xexpression<E>::value>>
+    inline auto norm_l2_scaled(E&& e, EVS es = EVS())
+    {
+        return norm_l2_scaled(std::forward<E>(e), arange(e.dimension()), es);
+    }
+
+#ifdef X_OLD_CLANG
+    template <class E, class I, class EVS = DEFAULT_STRATEGY_REDUCERS>
+    inline auto norm_l2_scaled(E&& e, std::initializer_list<I> axes, EVS es = EVS())
+    {
+        using axes_type = std::vector<typename std::decay_t<E>::size_type>;
+        return norm_l2_scaled(std::forward<E>(e), xtl::forward_sequence<axes_type>(axes), es);
+    }
+#else
+    template <class E, class I, std::size_t N, class EVS = DEFAULT_STRATEGY_REDUCERS>
+    inline auto norm_l2_scaled(E&& e, const I (&axes)[N], EVS es = EVS())
+    {
+        using axes_type = std::array<typename std::decay_t<E>::size_type, N>;
+        return norm_l2_scaled(std::forward<E>(e), xtl::forward_sequence<axes_type>(axes), es);
+    }
+#endif
+
     /**
      * @ingroup red_functions
      * @brief Infinity (maximum) norm of an array-like argument over given axes.
@@ -362,14 +813,11 @@ namespace xt
         using value_type = typename std::decay_t<E>::value_type;
         using result_type = norm_type_t<std::decay_t<E>>;
 
-        auto reduce_func = [p](result_type const& r, value_type const& v) {
-            return r + norm_lp_to_p(v, p);
-        };
-
         auto init_func = [p](value_type const& v) {
             return norm_lp_to_p(v, p);
         };
-        return reduce(make_xreducer_functor(std::move(reduce_func), std::move(init_func), std::plus<result_type>()),
+        return reduce(make_xreducer_functor(detail::norm_lp_to_p_functor<value_type, result_type>(p),
+                                            std::move(init_func), std::plus<result_type>()),
                       std::forward<E>(e), std::forward<X>(axes), es);
     }
 
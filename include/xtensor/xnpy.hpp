@@ -17,19 +17,33 @@
 
 #include <algorithm>
 #include <complex>
+#include <condition_variable>
 #include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
 #include <fstream>
+#include <functional>
+#include <future>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <numeric>
 #include <regex>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <typeinfo>
 #include <vector>
 
 #include "xtensor/xadapt.hpp"
+#include "xtensor/xfile_mapping.hpp"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xdtype.hpp"
 #include "xtensor/xeval.hpp"
+#include "xtensor/xhalf.hpp"
 #include "xtensor/xstrides.hpp"
 
 namespace xt
@@ -98,6 +112,7 @@ namespace xt
         template <class T>
         inline char map_type()
         {
+            if (std::is_same<T, float16>::value) return 'f';
             if (std::is_same<T, float>::value) return 'f';
             if (std::is_same<T, double>::value) return 'f';
             if (std::is_same<T, long double>::value) return 'f';
@@ -124,6 +139,16 @@ namespace xt
             throw std::runtime_error("Type not known.");
         }
 
+        template <class T>
+        struct map_type_is_complex : std::false_type
+        {
+        };
+
+        template <class T>
+        struct map_type_is_complex<std::complex<T>> : std::true_type
+        {
+        };
+
         template <class T>
         constexpr char get_endianess()
         {
@@ -346,9 +371,12 @@ namespace xt
             }
         }
 
+        // Writes the npy header and returns its length in bytes, the header is
+        // padded with spaces so that it is at least min_length bytes long.
         template <class O, class S>
-        inline void write_header(O& out, const std::string& descr,
-                                 bool fortran_order, const S& shape)
+        inline std::size_t write_header(O& out, const std::string& descr,
+                                        bool fortran_order, const S& shape,
+                                        std::size_t min_length = 0)
         {
             std::ostringstream ss_header;
             std::string s_fortran_order;
@@ -394,6 +422,10 @@ namespace xt
                 version[1] = 0;
             }
             std::size_t padding_len = 16 - metadata_len % 16;
+            if (metadata_len + padding_len < min_length)
+            {
+                padding_len = min_length - metadata_len;
+            }
             std::string padding(padding_len, ' ');
             ss_header << padding;
             ss_header << std::endl;
@@ -426,6 +458,7 @@ namespace xt
             }
 
             out << header;
+            return metadata_len + padding_len;
         }
 
         inline std::string read_header_1_0(std::istream& istream)
@@ -471,6 +504,23 @@ namespace xt
             return header;
         }
 
+        template <class T, layout_type L>
+        inline void check_npy_cast(const std::string& typestring, bool fortran_order, bool check_type)
+        {
+            // check if the typestring matches the given one
+            if (check_type && typestring != detail::build_typestring<T>())
+            {
+                throw std::runtime_error("Cast error: formats not matching "s + typestring +
+                                         " vs "s + detail::build_typestring<T>());
+            }
+
+            if ((L == layout_type::column_major && !fortran_order) ||
+                (L == layout_type::row_major && fortran_order))
+            {
+                throw std::runtime_error("Cast error: layout mismatch between npy file and requested layout.");
+            }
+        }
+
         struct npy_file
         {
             npy_file() = default;
@@ -535,18 +585,7 @@ namespace xt
                 std::vector<std::size_t> strides(m_shape.size());
                 std::size_t sz = compute_size(m_shape);
 
-                // check if the typestring matches the given one
-                if (check_type && m_typestring != detail::build_typestring<T>())
-                {
-                    throw std::runtime_error("Cast error: formats not matching "s + m_typestring +
-                                             " vs "s + detail::build_typestring<T>());
-                }
-
-                if ((L == layout_type::column_major && !m_fortran_order) ||
-                    (L == layout_type::row_major && m_fortran_order))
-                {
-                    throw std::runtime_error("Cast error: layout mismatch between npy file and requested layout.");
-                }
+                check_npy_cast<T, L>(m_typestring, m_fortran_order, check_type);
 
                 compute_strides(m_shape,
                                 m_fortran_order ? layout_type::column_major : layout_type::row_major,
@@ -599,7 +638,8 @@ namespace xt
             char* m_buffer;
         };
 
-        inline npy_file load_npy_file(std::istream& stream)
+        inline void read_npy_header(std::istream& stream, std::string& typestr,
+                                    bool& fortran_order, std::vector<std::size_t>& shape)
         {
             // check magic bytes an version number
             unsigned char v_major, v_minor;
@@ -621,11 +661,334 @@ namespace xt
             }
 
             // parse header
+            detail::parse_header(header, typestr, &fortran_order, shape);
+        }
+
+        // Returns true if the typestring describes the same type as the
+        // expected one, stored with the opposite byte order.
+        inline bool is_swapped_typestring(const std::string& typestring, const std::string& expected)
+        {
+            return typestring.size() == expected.size() && expected[0] != no_endian_char &&
+                (typestring[0] == little_endian_char || typestring[0] == big_endian_char) &&
+                typestring[0] != expected[0] &&
+                typestring.compare(1, std::string::npos, expected, 1, std::string::npos) == 0;
+        }
+
+        // Returns true if the data of the file must be byte-swapped to
+        // match the host representation of T.
+        template <class T>
+        inline bool check_npy_typestring(const std::string& typestring)
+        {
+            std::string expected = detail::build_typestring<T>();
+            if (typestring == expected)
+            {
+                return false;
+            }
+            if (!is_swapped_typestring(typestring, expected))
+            {
+                throw std::runtime_error("Load error: formats not matching "s + typestring +
+                                         " vs "s + expected);
+            }
+            return true;
+        }
+
+        // The shifts are recognized by compilers, which emit bswap (or
+        // vectorized shuffles in the loops of npy_swapper).
+        inline std::uint16_t byteswap(std::uint16_t v) noexcept
+        {
+            return static_cast<std::uint16_t>((v >> 8) | (v << 8));
+        }
+
+        inline std::uint32_t byteswap(std::uint32_t v) noexcept
+        {
+            return ((v & 0xFF000000u) >> 24) | ((v & 0x00FF0000u) >> 8) |
+                   ((v & 0x0000FF00u) << 8) | ((v & 0x000000FFu) << 24);
+        }
+
+        inline std::uint64_t byteswap(std::uint64_t v) noexcept
+        {
+            return (std::uint64_t(byteswap(static_cast<std::uint32_t>(v))) << 32) |
+                   std::uint64_t(byteswap(static_cast<std::uint32_t>(v >> 32)));
+        }
+
+        template <std::size_t N>
+        struct npy_word
+        {
+            using type = void;
+        };
+
+        template <>
+        struct npy_word<2>
+        {
+            using type = std::uint16_t;
+        };
+
+        template <>
+        struct npy_word<4>
+        {
+            using type = std::uint32_t;
+        };
+
+        template <>
+        struct npy_word<8>
+        {
+            using type = std::uint64_t;
+        };
+
+        template <std::size_t N, class W = typename npy_word<N>::type>
+        struct npy_swapper
+        {
+            static void run(char* bytes, std::size_t n) noexcept
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    W w;
+                    std::memcpy(&w, bytes + i * N, N);
+                    w = byteswap(w);
+                    std::memcpy(bytes + i * N, &w, N);
+                }
+            }
+        };
+
+        template <std::size_t N>
+        struct npy_swapper<N, void>
+        {
+            static void run(char* bytes, std::size_t n) noexcept
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    std::reverse(bytes + i * N, bytes + (i + 1) * N);
+                }
+            }
+        };
+
+        template <class T>
+        inline void swap_npy_bytes(T* data, std::size_t size)
+        {
+            // the real and imaginary parts of complex numbers are swapped separately
+            constexpr std::size_t word_size = map_type_is_complex<T>::value ? sizeof(T) / 2 : sizeof(T);
+            if (word_size > 1)
+            {
+                npy_swapper<word_size>::run(reinterpret_cast<char*>(data), size * sizeof(T) / word_size);
+            }
+        }
+
+        // Elements that must be swapped or converted are read by chunks of
+        // this size, each chunk is processed while it is still in cache.
+        constexpr std::size_t npy_chunk_bytes = std::size_t(1) << 18;
+
+        template <class T>
+        constexpr std::size_t npy_chunk_size() noexcept
+        {
+            return npy_chunk_bytes / sizeof(T) == 0 ? std::size_t(1) : npy_chunk_bytes / sizeof(T);
+        }
+
+        inline void read_npy_bytes(std::istream& stream, char* dst, std::size_t n)
+        {
+            stream.read(dst, std::streamsize(n));
+            if (!stream)
+            {
+                throw std::runtime_error("io error: failed reading file");
+            }
+        }
+
+        template <class T>
+        inline void read_npy_swapped(std::istream& stream, T* data, std::size_t size)
+        {
+            constexpr std::size_t chunk = npy_chunk_size<T>();
+            for (std::size_t i = 0; i < size; i += chunk)
+            {
+                std::size_t n = std::min(chunk, size - i);
+                read_npy_bytes(stream, reinterpret_cast<char*>(data + i), n * sizeof(T));
+                swap_npy_bytes(data + i, n);
+            }
+        }
+
+        // Complex numbers are converted from their real part
+        template <class T>
+        struct npy_real_type
+        {
+            using type = T;
+        };
+
+        template <class T>
+        struct npy_real_type<std::complex<T>>
+        {
+            using type = T;
+        };
+
+        // Reads elements of type S and converts them to T through a bounce
+        // buffer of one chunk.
+        template <class S, class T>
+        inline void read_npy_converted(std::istream& stream, T* data, std::size_t size, bool swap)
+        {
+            constexpr std::size_t chunk = npy_chunk_size<S>();
+            uvector<S> buffer(std::min(chunk, size));
+            for (std::size_t i = 0; i < size; i += chunk)
+            {
+                std::size_t n = std::min(chunk, size - i);
+                read_npy_bytes(stream, reinterpret_cast<char*>(buffer.data()), n * sizeof(S));
+                if (swap)
+                {
+                    swap_npy_bytes(buffer.data(), n);
+                }
+                std::transform(buffer.cbegin(), buffer.cbegin() + std::ptrdiff_t(n), data + i,
+                               [](const S& v)
+                               { return static_cast<T>(static_cast<typename npy_real_type<T>::type>(v)); });
+            }
+        }
+
+        template <class T>
+        struct is_npy_convertible
+            : std::integral_constant<bool, std::is_arithmetic<T>::value || map_type_is_complex<T>::value ||
+                                               std::is_same<T, float16>::value>
+        {
+        };
+
+        // The elements of a file can be converted to T if they are booleans,
+        // integers or floating point numbers.
+        template <class T>
+        inline bool is_npy_convertible_typestring(const std::string& typestring)
+        {
+            if (!is_npy_convertible<T>::value || typestring.size() < 3)
+            {
+                return false;
+            }
+            std::string word = typestring.substr(2);
+            switch (typestring[1])
+            {
+                case 'b':
+                    return word == "1";
+                case 'i':
+                case 'u':
+                    return word == "1" || word == "2" || word == "4" || word == "8";
+                case 'f':
+                    return word == "2" || word == "4" || word == "8";
+                default:
+                    return false;
+            }
+        }
+
+        enum class npy_load_mode
+        {
+            direct,
+            swap,
+            convert
+        };
+
+        // Selects how the elements described by typestring are loaded into
+        // elements of type T, throws if they cannot be loaded.
+        template <class T>
+        inline npy_load_mode get_npy_load_mode(const std::string& typestring, bool convert)
+        {
+            std::string expected = detail::build_typestring<T>();
+            if (typestring == expected)
+            {
+                return npy_load_mode::direct;
+            }
+            if (is_swapped_typestring(typestring, expected))
+            {
+                return npy_load_mode::swap;
+            }
+            if (!convert)
+            {
+                throw std::runtime_error("Load error: formats not matching "s + typestring +
+                                         " vs "s + expected);
+            }
+            if (!is_npy_convertible_typestring<T>(typestring))
+            {
+                throw std::runtime_error("Load error: cannot convert "s + typestring + " to "s + expected);
+            }
+            return npy_load_mode::convert;
+        }
+
+        template <class T>
+        inline void dispatch_npy_conversion(std::istream&, T*, std::size_t, const std::string&, std::false_type)
+        {
+        }
+
+        template <class I8, class I16, class I32, class I64, class T>
+        inline void read_npy_converted_integers(std::istream& stream, T* data, std::size_t size,
+                                                std::size_t word, bool swap)
+        {
+            if (word == 1)
+            {
+                read_npy_converted<I8>(stream, data, size, false);
+            }
+            else if (word == 2)
+            {
+                read_npy_converted<I16>(stream, data, size, swap);
+            }
+            else if (word == 4)
+            {
+                read_npy_converted<I32>(stream, data, size, swap);
+            }
+            else
+            {
+                read_npy_converted<I64>(stream, data, size, swap);
+            }
+        }
+
+        template <class T>
+        inline void dispatch_npy_conversion(std::istream& stream, T* data, std::size_t size,
+                                            const std::string& typestring, std::true_type)
+        {
+            bool swap = typestring[0] != no_endian_char && typestring[0] != host_endian_char;
+            std::size_t word = std::size_t(atoi(&typestring[2]));
+            if (typestring[1] == 'b')
+            {
+                read_npy_converted<bool>(stream, data, size, false);
+            }
+            else if (typestring[1] == 'i')
+            {
+                read_npy_converted_integers<std::int8_t, std::int16_t, std::int32_t, std::int64_t>(
+                    stream, data, size, word, swap);
+            }
+            else if (typestring[1] == 'u')
+            {
+                read_npy_converted_integers<std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t>(
+                    stream, data, size, word, swap);
+            }
+            else if (word == 2)
+            {
+                read_npy_converted<float16>(stream, data, size, swap);
+            }
+            else if (word == 4)
+            {
+                read_npy_converted<float>(stream, data, size, swap);
+            }
+            else
+            {
+                read_npy_converted<double>(stream, data, size, swap);
+            }
+        }
+
+        // Reads size elements described by typestring into data, the mode
+        // must have been selected with get_npy_load_mode.
+        template <class T>
+        inline void read_npy_data(std::istream& stream, T* data, std::size_t size,
+                                  const std::string& typestring, npy_load_mode mode)
+        {
+            switch (mode)
+            {
+                case npy_load_mode::direct:
+                    read_npy_bytes(stream, reinterpret_cast<char*>(data), size * sizeof(T));
+                    break;
+                case npy_load_mode::swap:
+                    read_npy_swapped(stream, data, size);
+                    break;
+                case npy_load_mode::convert:
+                    dispatch_npy_conversion(stream, data, size, typestring, is_npy_convertible<T>());
+                    break;
+            }
+        }
+
+        inline npy_file load_npy_file(std::istream& stream)
+        {
             bool fortran_order;
             std::string typestr;
-
             std::vector<std::size_t> shape;
-            detail::parse_header(header, typestr, &fortran_order, shape);
+            read_npy_header(stream, typestr, fortran_order, shape);
 
             npy_file result(shape, fortran_order, typestr);
             // read the data
@@ -633,6 +996,63 @@ namespace xt
             return result;
         }
 
+        // Loads the elements of the file as elements of type T, swapping
+        // and converting them if needed.
+        template <class T>
+        inline npy_file load_npy_file_as(std::istream& stream, bool convert)
+        {
+            bool fortran_order;
+            std::string typestr;
+            std::vector<std::size_t> shape;
+            read_npy_header(stream, typestr, fortran_order, shape);
+            npy_load_mode mode = get_npy_load_mode<T>(typestr, convert);
+
+            npy_file result(shape, fortran_order, build_typestring<T>());
+            read_npy_data(stream, reinterpret_cast<T*>(result.ptr()), compute_size(shape), typestr, mode);
+            return result;
+        }
+
+        // Returns the dtype of the elements described by a typestring,
+        // whatever their byte order.
+        inline dtype npy_dtype(const std::string& typestring)
+        {
+            char kind = typestring[1];
+            std::size_t word = std::size_t(atoi(&typestring[2]));
+            if (kind == 'b' && word == 1)
+            {
+                return dtype::boolean;
+            }
+            else if ((kind == 'i' || kind == 'u') && (word == 1 || word == 2 || word == 4 || word == 8))
+            {
+                return integer_dtype(word, kind == 'i');
+            }
+            else if (kind == 'f' && word == 4)
+            {
+                return dtype::float32;
+            }
+            else if (kind == 'f' && word == 8)
+            {
+                return dtype::float64;
+            }
+            throw std::runtime_error("Load error: no dtype for the format "s + typestring);
+        }
+
+        inline xdtype_array load_npy_dtype_array(std::istream& stream)
+        {
+            bool fortran_order;
+            std::string typestr;
+            std::vector<std::size_t> shape;
+            read_npy_header(stream, typestr, fortran_order, shape);
+
+            xdtype_array result(npy_dtype(typestr), xtl::forward_sequence<xdtype_array::shape_type>(shape),
+                                fortran_order ? layout_type::column_major : layout_type::row_major);
+            result.visit([&stream, &typestr](auto a) {
+                using value_type = typename decltype(a)::value_type;
+                read_npy_data(stream, a.data(), a.size(), typestr, get_npy_load_mode<value_type>(typestr, false));
+            });
+            return result;
+        }
+
         template <class O, class E>
         inline void dump_npy_stream(O& stream, const xexpression<E>& e)
         {
@@ -654,6 +1074,18 @@ namespace xt
             stream.write(reinterpret_cast<const char*>(eval_ex.data()),
                          std::streamsize((sizeof(value_type) * size)));
         }
+
+        // Adapts a buffer holding the elements of a npy file, the buffer is
+        // either mapped or allocated with alloc.
+        template <class T>
+        inline auto adapt_npy_buffer(T* ptr, std::vector<std::size_t> shape, bool fortran_order,
+                                     const mapping_allocator<T>& alloc)
+        {
+            std::size_t size = compute_size(shape);
+            std::vector<std::size_t> strides(shape.size());
+            compute_strides(shape, fortran_order ? layout_type::column_major : layout_type::row_major, strides);
+            return adapt(std::move(ptr), size, acquire_ownership(), std::move(shape), std::move(strides), alloc);
+        }
     }  // namespace detail
 
 
@@ -675,28 +1107,741 @@ namespace xt
         detail::dump_npy_stream(stream, e);
     }
 
+    /**
+     * Save an xdtype_array to NumPy npy format, the type of the file is
+     * the dtype of the array.
+     *
+     * @param filename The filename or path to dump the data
+     * @param a the array
+     */
+    inline void dump_npy(const std::string& filename, const xdtype_array& a)
+    {
+        std::ofstream stream(filename, std::ofstream::binary);
+        if (!stream)
+        {
+            throw std::runtime_error("IO Error: failed to open file: "s + filename);
+        }
+
+        a.visit([&stream](const auto& e) { detail::dump_npy_stream(stream, e); });
+    }
+
+    /**
+     * Loads a npy file (the numpy storage format) whose type is only known
+     * at runtime. The dtype of the result is read from the header of the
+     * file, whose booleans, integers and float32 or float64 numbers are
+     * swapped if they were written with the opposite byte order.
+     *
+     * @param filename The filename or path to the file
+     * @return xdtype_array with contents from npy file
+     */
+    inline xdtype_array load_npy_dtype(const std::string& filename)
+    {
+        std::ifstream stream(filename, std::ifstream::binary);
+        if (!stream)
+        {
+            throw std::runtime_error("io error: failed to open a file.");
+        }
+        return detail::load_npy_dtype_array(stream);
+    }
+
     /**
      * Loads a npy file (the numpy storage format)
      *
+     * Files written with the opposite byte order are swapped while they
+     * are read.
+     *
      * @param filename The filename or path to the file
-     * @tparam T select the type of the npy file (note: currently there is
-     *           no dynamic casting if types do not match)
+     * @param convert if true, booleans, integers and floating point numbers
+     *        of another type are converted to T while they are read,
+     *        otherwise the type of the file must be T
+     * @tparam T select the value type of the result
      * @tparam L select layout_type::column_major if you stored data in
      *           Fortran format
      * @return xarray with contents from npy file
      */
     template <typename T, layout_type L = layout_type::dynamic>
-    inline auto load_npy(const std::string& filename)
+    inline auto load_npy(const std::string& filename, bool convert = false)
     {
         std::ifstream stream(filename, std::ifstream::binary);
         if (!stream)
         {
             throw std::runtime_error("io error: failed to open a file.");
         }
-        detail::npy_file file = detail::load_npy_file(stream);
+        detail::npy_file file = detail::load_npy_file_as<T>(stream, convert);
         return std::move(file).cast<T, L>();
     }
 
+    /**
+     * Loads a npy file (the numpy storage format) into an existing container.
+     * The elements are read directly into the storage of the container, which
+     * is resized only if its shape differs from the one of the file. Files
+     * written with the opposite byte order are converted in place.
+     *
+     * @param stream the input stream, positioned at the beginning of the npy data
+     * @param e the container to fill
+     * @param convert if true, booleans, integers and floating point numbers
+     *        of another type are converted to the value type of the container
+     *        chunk by chunk, otherwise the types must match
+     */
+    template <class E>
+    inline void load_npy_into(std::istream& stream, E& e, bool convert = false)
+    {
+        using value_type = typename E::value_type;
+        using shape_type = typename E::shape_type;
+
+        bool fortran_order;
+        std::string typestr;
+        std::vector<std::size_t> shape;
+        detail::read_npy_header(stream, typestr, fortran_order, shape);
+        detail::npy_load_mode mode = detail::get_npy_load_mode<value_type>(typestr, convert);
+
+        constexpr std::ptrdiff_t static_dim = static_dimension<shape_type>::value;
+        if (static_dim != -1 && static_cast<std::size_t>(static_dim) != shape.size())
+        {
+            throw std::runtime_error("Load error: dimension mismatch between npy file and container.");
+        }
+
+        // the layout does not matter for 0-D and 1-D arrays
+        layout_type l = fortran_order && shape.size() > 1 ? layout_type::column_major : layout_type::row_major;
+        bool same_shape = e.dimension() == shape.size() &&
+            std::equal(shape.cbegin(), shape.cend(), e.shape().cbegin());
+        bool same_layout = shape.size() <= 1 || e.layout() == l;
+        if (E::static_layout == layout_type::dynamic)
+        {
+            if (!same_shape || !same_layout)
+            {
+                e.resize(shape, l);
+            }
+        }
+        else
+        {
+            if (shape.size() > 1 && E::static_layout != l)
+            {
+                throw std::runtime_error("Load error: layout mismatch between npy file and container.");
+            }
+            if (!same_shape)
+            {
+                e.resize(shape);
+            }
+        }
+
+        detail::read_npy_data(stream, e.data(), compute_size(shape), typestr, mode);
+    }
+
+    /**
+     * Loads a npy file (the numpy storage format) into an existing container.
+     *
+     * @param filename The filename or path to the file
+     * @param e the container to fill
+     * @param convert if true, the elements are converted to the value type
+     *        of the container
+     * @sa load_npy_into(std::istream&, E&, bool)
+     */
+    template <class E>
+    inline void load_npy_into(const std::string& filename, E& e, bool convert = false)
+    {
+        std::ifstream stream(filename, std::ifstream::binary);
+        if (!stream)
+        {
+            throw std::runtime_error("IO Error: failed to open file: "s + filename);
+        }
+        load_npy_into(stream, e, convert);
+    }
+
+    /**************
+     * npy_reader *
+     **************/
+
+    /**
+     * @class npy_reader
+     * @brief Reads a npy file block by block along the first axis.
+     *
+     * Only the header is read upon construction, the elements are read when
+     * the blocks are requested, so that files larger than the available memory
+     * can be processed. The data must be stored in row-major order.
+     *
+     * @tparam T the value type of the npy file
+     */
+    template <class T>
+    class npy_reader
+    {
+    public:
+
+        using value_type = T;
+        using shape_type = std::vector<std::size_t>;
+        using buffer_type = xbuffer_adaptor<value_type*, no_ownership>;
+        using block_type = xarray_adaptor<buffer_type, layout_type::row_major, shape_type>;
+
+        explicit npy_reader(const std::string& filename);
+
+        const shape_type& shape() const noexcept;
+        std::size_t rows() const noexcept;
+        std::size_t position() const noexcept;
+        bool eof() const noexcept;
+
+        void seek(std::size_t row);
+        block_type read(std::size_t n_rows);
+
+    private:
+
+        std::ifstream m_stream;
+        shape_type m_shape;
+        shape_type m_block_shape;
+        std::size_t m_row_size;
+        std::size_t m_position;
+        std::streamoff m_data_offset;
+        bool m_swap;
+        uvector<value_type> m_buffer;
+    };
+
+    /**************
+     * npy_writer *
+     **************/
+
+    /**
+     * @class npy_writer
+     * @brief Writes a npy file by appending blocks along the first axis.
+     *
+     * The header is written with room for any number of rows; the number of
+     * rows is patched when the writer is flushed or closed, so that the file
+     * can be read while it is still being written.
+     *
+     * @tparam T the value type of the npy file
+     */
+    template <class T>
+    class npy_writer
+    {
+    public:
+
+        using value_type = T;
+        using shape_type = std::vector<std::size_t>;
+
+        template <class S = shape_type>
+        npy_writer(const std::string& filename, const S& row_shape = S());
+        ~npy_writer();
+
+        npy_writer(const npy_writer&) = delete;
+        npy_writer& operator=(const npy_writer&) = delete;
+
+        template <class E>
+        void append(const xexpression<E>& e);
+
+        std::size_t rows() const noexcept;
+
+        void flush();
+        void close();
+
+    private:
+
+        void write_header(std::size_t rows);
+
+        std::ofstream m_stream;
+        shape_type m_row_shape;
+        std::size_t m_row_size;
+        std::size_t m_rows;
+        std::size_t m_header_length;
+    };
+
+    /*****************************
+     * npy_reader implementation *
+     *****************************/
+
+    /**
+     * Opens the npy file and reads its header.
+     * @param filename The filename or path to the file
+     */
+    template <class T>
+    inline npy_reader<T>::npy_reader(const std::string& filename)
+        : m_stream(filename, std::ifstream::binary), m_row_size(1), m_position(0), m_swap(false)
+    {
+        if (!m_stream)
+        {
+            throw std::runtime_error("IO Error: failed to open file: "s + filename);
+        }
+        bool fortran_order;
+        std::string typestr;
+        detail::read_npy_header(m_stream, typestr, fortran_order, m_shape);
+        m_swap = detail::check_npy_typestring<value_type>(typestr);
+        if (m_shape.empty())
+        {
+            throw std::runtime_error("npy_reader: cannot read blocks of a 0-D array.");
+        }
+        if (fortran_order && m_shape.size() > 1)
+        {
+            throw std::runtime_error("npy_reader: blocks of Fortran ordered arrays are not contiguous.");
+        }
+        m_data_offset = static_cast<std::streamoff>(m_stream.tellg());
+        m_row_size = std::accumulate(m_shape.cbegin() + 1, m_shape.cend(),
+                                     std::size_t(1), std::multiplies<std::size_t>());
+        m_block_shape = m_shape;
+    }
+
+    /**
+     * Returns the shape of the whole array stored in the file.
+     */
+    template <class T>
+    inline auto npy_reader<T>::shape() const noexcept -> const shape_type&
+    {
+        return m_shape;
+    }
+
+    /**
+     * Returns the number of rows, i.e. the size of the first axis.
+     */
+    template <class T>
+    inline std::size_t npy_reader<T>::rows() const noexcept
+    {
+        return m_shape[0];
+    }
+
+    /**
+     * Returns the index of the next row to read.
+     */
+    template <class T>
+    inline std::size_t npy_reader<T>::position() const noexcept
+    {
+        return m_position;
+    }
+
+    /**
+     * Returns true if all the rows have been read.
+     */
+    template <class T>
+    inline bool npy_reader<T>::eof() const noexcept
+    {
+        return m_position >= rows();
+    }
+
+    /**
+     * Moves to the given row, the next block starts at this row.
+     */
+    template <class T>
+    inline void npy_reader<T>::seek(std::size_t row)
+    {
+        m_position = std::min(row, rows());
+        m_stream.clear();
+        m_stream.seekg(m_data_offset + static_cast<std::streamoff>(m_position * m_row_size * sizeof(value_type)));
+    }
+
+    /**
+     * Reads the next \c n_rows rows, or the remaining rows if there are fewer.
+     * The returned adaptor points to an internal buffer, which is reused by the
+     * next call to read.
+     * @param n_rows the number of rows of the block
+     * @return an adaptor of shape (k, shape[1], ...), where k is 0 once all
+     *         the rows have been read
+     */
+    template <class T>
+    inline auto npy_reader<T>::read(std::size_t n_rows) -> block_type
+    {
+        std::size_t n = std::min(n_rows, rows() - m_position);
+        std::size_t size = n * m_row_size;
+        if (m_buffer.size() < size)
+        {
+            m_buffer.resize(size);
+        }
+        if (size != 0)
+        {
+            m_stream.read(reinterpret_cast<char*>(m_buffer.data()), std::streamsize(size * sizeof(value_type)));
+            if (!m_stream)
+            {
+                throw std::runtime_error("io error: failed reading file");
+            }
+            if (m_swap)
+            {
+                detail::swap_npy_bytes(m_buffer.data(), size);
+            }
+        }
+        m_position += n;
+        m_block_shape[0] = n;
+        return block_type(buffer_type(m_buffer.data(), size), m_block_shape);
+    }
+
+    /*****************************
+     * npy_writer implementation *
+     *****************************/
+
+    /**
+     * Creates the npy file and writes a header for an empty array.
+     * @param filename The filename or path to the file
+     * @param row_shape the shape of a row, i.e. the shape of the array
+     *                  without its first axis (empty for a 1-D array)
+     */
+    template <class T>
+    template <class S>
+    inline npy_writer<T>::npy_writer(const std::string& filename, const S& row_shape)
+        : m_stream(filename, std::ofstream::binary),
+          m_row_shape(std::begin(row_shape), std::end(row_shape)),
+          m_rows(0), m_header_length(0)
+    {
+        if (!m_stream)
+        {
+            throw std::runtime_error("IO Error: failed to open file: "s + filename);
+        }
+        m_row_size = compute_size(m_row_shape);
+        // reserve room for the largest number of rows, so that the
+        // header can be patched in place
+        shape_type shape(m_row_shape.size() + 1, std::numeric_limits<std::size_t>::max());
+        std::ostringstream reserved;
+        m_header_length = detail::write_header(reserved, detail::build_typestring<value_type>(), false, shape);
+        write_header(0);
+    }
+
+    /**
+     * Patches the header and closes the file.
+     */
+    template <class T>
+    inline npy_writer<T>::~npy_writer()
+    {
+        try
+        {
+            close();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    /**
+     * Appends rows at the end of the file.
+     * @param e an expression with the shape of a row, or with a shape
+     *          (k, row_shape...) to append k rows
+     */
+    template <class T>
+    template <class E>
+    inline void npy_writer<T>::append(const xexpression<E>& e)
+    {
+        static_assert(std::is_same<typename E::value_type, value_type>::value,
+                      "npy_writer: the value type of the expression must match the one of the file");
+        if (!m_stream.is_open())
+        {
+            throw std::runtime_error("npy_writer: the file is closed.");
+        }
+        const E& ex = e.derived_cast();
+        auto&& shape = ex.shape();
+        std::size_t dim = ex.dimension();
+        std::size_t n_rows = 0;
+        if (dim == m_row_shape.size() && std::equal(m_row_shape.cbegin(), m_row_shape.cend(), shape.begin()))
+        {
+            n_rows = 1;
+        }
+        else if (dim == m_row_shape.size() + 1 &&
+                 std::equal(m_row_shape.cbegin(), m_row_shape.cend(), shape.begin() + 1))
+        {
+            n_rows = shape[0];
+        }
+        else
+        {
+            throw std::runtime_error("npy_writer: the shape of the expression does not match the shape of the rows.");
+        }
+
+        auto&& eval_ex = eval(ex);
+        std::streamsize n_bytes = std::streamsize(n_rows * m_row_size * sizeof(value_type));
+        if (eval_ex.layout() == layout_type::row_major)
+        {
+            m_stream.write(reinterpret_cast<const char*>(eval_ex.data()), n_bytes);
+        }
+        else
+        {
+            xarray<value_type, layout_type::row_major> tmp = eval_ex;
+            m_stream.write(reinterpret_cast<const char*>(tmp.data()), n_bytes);
+        }
+        if (!m_stream)
+        {
+            throw std::runtime_error("io error: failed writing file");
+        }
+        m_rows += n_rows;
+    }
+
+    /**
+     * Returns the number of rows written so far.
+     */
+    template <class T>
+    inline std::size_t npy_writer<T>::rows() const noexcept
+    {
+        return m_rows;
+    }
+
+    /**
+     * Patches the header with the current number of rows and flushes
+     * the file, which is then a valid npy file.
+     */
+    template <class T>
+    inline void npy_writer<T>::flush()
+    {
+        if (m_stream.is_open())
+        {
+            std::ofstream::pos_type end = m_stream.tellp();
+            write_header(m_rows);
+            m_stream.seekp(end);
+            m_stream.flush();
+        }
+    }
+
+    /**
+     * Patches the header with the final number of rows and closes the file.
+     * Nothing can be appended afterwards.
+     */
+    template <class T>
+    inline void npy_writer<T>::close()
+    {
+        if (m_stream.is_open())
+        {
+            write_header(m_rows);
+            m_stream.close();
+            if (!m_stream)
+            {
+                throw std::runtime_error("io error: failed writing file");
+            }
+        }
+    }
+
+    template <class T>
+    inline void npy_writer<T>::write_header(std::size_t rows)
+    {
+        shape_type shape(m_row_shape.size() + 1, rows);
+        std::copy(m_row_shape.cbegin(), m_row_shape.cend(), shape.begin() + 1);
+        m_stream.seekp(0);
+        detail::write_header(m_stream, detail::build_typestring<value_type>(), false, shape, m_header_length);
+    }
+
+    /******************
+     * dump_npy_async *
+     ******************/
+
+    namespace detail
+    {
+        // Background thread writing the snapshots of dump_npy_async. At most
+        // XTENSOR_NPY_ASYNC_QUEUE_SIZE snapshots exist at a time: acquire
+        // blocks until one of them is written, and the buffers of the written
+        // snapshots are reused, so that the memory used stays constant.
+        class npy_async_writer
+        {
+        public:
+
+            using buffer_type = std::vector<char>;
+
+            static npy_async_writer& instance();
+
+            ~npy_async_writer();
+
+            npy_async_writer(const npy_async_writer&) = delete;
+            npy_async_writer& operator=(const npy_async_writer&) = delete;
+
+            buffer_type acquire();
+            void release(buffer_type buffer);
+            std::future<void> submit(std::string filename, buffer_type buffer);
+
+        private:
+
+            npy_async_writer();
+
+            void run();
+
+            struct job
+            {
+                std::string filename;
+                buffer_type buffer;
+                std::promise<void> promise;
+            };
+
+            std::mutex m_mutex;
+            std::condition_variable m_job_available;
+            std::condition_variable m_slot_available;
+            std::deque<job> m_jobs;
+            std::vector<buffer_type> m_pool;
+            std::size_t m_acquired;
+            bool m_stop;
+            std::thread m_thread;
+        };
+
+        inline npy_async_writer& npy_async_writer::instance()
+        {
+            static npy_async_writer writer;
+            return writer;
+        }
+
+        inline npy_async_writer::npy_async_writer()
+            : m_acquired(0), m_stop(false)
+        {
+            m_thread = std::thread([this]() { run(); });
+        }
+
+        inline npy_async_writer::~npy_async_writer()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_job_available.notify_one();
+            // the pending snapshots are written before returning
+            m_thread.join();
+        }
+
+        inline auto npy_async_writer::acquire() -> buffer_type
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_slot_available.wait(lock, [this]() { return m_acquired < std::size_t(XTENSOR_NPY_ASYNC_QUEUE_SIZE); });
+            ++m_acquired;
+            buffer_type buffer;
+            if (!m_pool.empty())
+            {
+                buffer = std::move(m_pool.back());
+                m_pool.pop_back();
+            }
+            return buffer;
+        }
+
+        inline void npy_async_writer::release(buffer_type buffer)
+        {
+            buffer.clear();
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_pool.push_back(std::move(buffer));
+                --m_acquired;
+            }
+            m_slot_available.notify_one();
+        }
+
+        inline std::future<void> npy_async_writer::submit(std::string filename, buffer_type buffer)
+        {
+            job j = {std::move(filename), std::move(buffer), std::promise<void>()};
+            std::future<void> res = j.promise.get_future();
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_jobs.push_back(std::move(j));
+            }
+            m_job_available.notify_one();
+            return res;
+        }
+
+        inline void npy_async_writer::run()
+        {
+            while (true)
+            {
+                job j;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_job_available.wait(lock, [this]() { return m_stop || !m_jobs.empty(); });
+                    if (m_jobs.empty())
+                    {
+                        return;
+                    }
+                    j = std::move(m_jobs.front());
+                    m_jobs.pop_front();
+                }
+                try
+                {
+                    std::ofstream stream(j.filename, std::ofstream::binary);
+                    if (!stream)
+                    {
+                        throw std::runtime_error("IO Error: failed to open file: "s + j.filename);
+                    }
+                    stream.write(j.buffer.data(), std::streamsize(j.buffer.size()));
+                    stream.close();
+                    if (!stream)
+                    {
+                        throw std::runtime_error("io error: failed writing file");
+                    }
+                    j.promise.set_value();
+                }
+                catch (...)
+                {
+                    j.promise.set_exception(std::current_exception());
+                }
+                release(std::move(j.buffer));
+            }
+        }
+    }
+
+    /**
+     * Saves an xexpression to NumPy npy format from a background thread.
+     *
+     * The expression is evaluated and copied in the calling thread, which can
+     * modify it as soon as the function returns; the file is written by a
+     * background thread. At most XTENSOR_NPY_ASYNC_QUEUE_SIZE (2 by default)
+     * snapshots are pending: if the writes do not keep up, the call blocks
+     * until a snapshot is written. Their buffers are reused by the next calls.
+     *
+     * @param filename The filename or path to dump the data
+     * @param e the xexpression
+     * @return a future which becomes ready when the file is written, and holds
+     *         the exception thrown if the file could not be written
+     */
+    template <typename E>
+    inline std::future<void> dump_npy_async(const std::string& filename, const xexpression<E>& e)
+    {
+        using value_type = typename E::value_type;
+        detail::npy_async_writer& writer = detail::npy_async_writer::instance();
+        detail::npy_async_writer::buffer_type buffer = writer.acquire();
+        try
+        {
+            auto&& eval_ex = eval(e.derived_cast());
+            bool fortran_order = eval_ex.layout() == layout_type::column_major && eval_ex.dimension() > 1;
+            std::ostringstream header;
+            detail::write_header(header, detail::build_typestring<value_type>(), fortran_order, eval_ex.shape());
+            std::string h = header.str();
+            std::size_t n_bytes = sizeof(value_type) * compute_size(eval_ex.shape());
+            buffer.resize(h.size() + n_bytes);
+            std::copy(h.cbegin(), h.cend(), buffer.begin());
+            if (n_bytes != 0)
+            {
+                std::memcpy(buffer.data() + h.size(), eval_ex.data(), n_bytes);
+            }
+        }
+        catch (...)
+        {
+            writer.release(std::move(buffer));
+            throw;
+        }
+        return writer.submit(filename, std::move(buffer));
+    }
+
+    /**
+     * Maps a npy file (the numpy storage format) in memory instead of reading
+     * it: only the header is read, and the elements are loaded by the operating
+     * system when they are accessed. The file must not be truncated while the
+     * returned adaptor (or a copy of its closure) is alive.
+     *
+     * @param filename The filename or path to the file
+     * @param mode mmap_mode::read_only to share the data with the file (the
+     *             elements must then not be modified), or mmap_mode::copy_on_write
+     *             to get a modifiable array whose changes are not written back
+     * @tparam T select the type of the npy file (note: there is no dynamic
+     *           casting if types do not match)
+     * @tparam L select layout_type::column_major if you stored data in
+     *           Fortran format
+     * @return xarray_adaptor over the mapped data
+     */
+    template <typename T, layout_type L = layout_type::dynamic>
+    inline auto mmap_npy(const std::string& filename, mmap_mode mode = mmap_mode::read_only)
+    {
+        std::ifstream stream(filename, std::ifstream::binary);
+        if (!stream)
+        {
+            throw std::runtime_error("IO Error: failed to open file: "s + filename);
+        }
+        bool fortran_order;
+        std::string typestr;
+        std::vector<std::size_t> shape;
+        detail::read_npy_header(stream, typestr, fortran_order, shape);
+        detail::check_npy_cast<T, L>(typestr, fortran_order, true);
+        std::size_t offset = static_cast<std::size_t>(stream.tellg());
+        stream.close();
+
+        std::size_t size = compute_size(shape);
+        auto mapping = std::make_shared<detail::file_mapping>(filename, mode);
+        if (mapping->size() < offset + size * sizeof(T))
+        {
+            throw std::runtime_error("IO Error: npy file is truncated: "s + filename);
+        }
+        // the header is padded so that the data is aligned on 16 bytes
+        T* ptr = reinterpret_cast<T*>(mapping->data() + offset);
+
+        detail::mapping_allocator<T> alloc(std::move(mapping), ptr);
+        return detail::adapt_npy_buffer(ptr, std::move(shape), fortran_order, alloc);
+    }
+
 }  // namespace xt
 
 #endif
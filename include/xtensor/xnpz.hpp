@@ -0,0 +1,939 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_NPZ_HPP
+#define XTENSOR_NPZ_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <istream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#if defined(XTENSOR_USE_ZLIB)
+#include <zlib.h>
+#endif
+
+#include "xtensor/xnpy.hpp"
+#include "xtensor/xparallel.hpp"
+
+namespace xt
+{
+    namespace detail
+    {
+        /*******************
+         * zip file format *
+         *******************/
+
+        // Only the subset of the zip format produced by numpy.savez and
+        // numpy.savez_compressed is supported: a single disk, members stored
+        // or deflated, and zip64 extensions for large archives.
+        //
+        // Members written by dump_npz_compressed with byte shuffling have a
+        // .npys extension: their npy header is followed by the elements
+        // shuffled block by block (the k-th bytes of the elements of a block
+        // are contiguous, see npz_shuffle). numpy.load returns them as raw
+        // bytes instead of misinterpreting them.
+
+        const std::uint32_t zip_local_header_signature = 0x04034b50;
+        const std::uint32_t zip_central_header_signature = 0x02014b50;
+        const std::uint32_t zip_end_signature = 0x06054b50;
+        const std::uint32_t zip64_end_signature = 0x06064b50;
+        const std::uint32_t zip64_locator_signature = 0x07064b50;
+        const std::uint16_t zip_stored = 0;
+        const std::uint16_t zip_deflated = 8;
+
+        // size in bytes of the blocks which are shuffled and compressed
+        // independently by dump_npz_compressed
+        const std::size_t npz_block_size = std::size_t(1) << 20;
+
+        template <class T>
+        inline T read_le(const char* p)
+        {
+            T res = 0;
+            for (std::size_t i = 0; i < sizeof(T); ++i)
+            {
+                res = T(res | T(T(static_cast<unsigned char>(p[i])) << (8 * i)));
+            }
+            return res;
+        }
+
+        template <class T>
+        inline void write_le(std::ostream& out, T value)
+        {
+            char bytes[sizeof(T)];
+            for (std::size_t i = 0; i < sizeof(T); ++i)
+            {
+                bytes[i] = char((value >> (8 * i)) & 0xff);
+            }
+            out.write(bytes, sizeof(T));
+        }
+
+        inline std::uint32_t zip_crc32(const char* data, std::size_t size)
+        {
+            static const std::array<std::uint32_t, 256> table = []()
+            {
+                std::array<std::uint32_t, 256> t;
+                for (std::uint32_t i = 0; i < 256; ++i)
+                {
+                    std::uint32_t c = i;
+                    for (int k = 0; k < 8; ++k)
+                    {
+                        c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+                    }
+                    t[i] = c;
+                }
+                return t;
+            }();
+
+            std::uint32_t crc = 0xffffffffu;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xff] ^ (crc >> 8);
+            }
+            return crc ^ 0xffffffffu;
+        }
+
+        struct npz_member
+        {
+            std::uint16_t method;
+            std::uint64_t compressed_size;
+            std::uint64_t uncompressed_size;
+            std::uint64_t local_header_offset;
+            bool shuffled;
+        };
+
+        // number of bytes of the shuffled blocks of elements of the given size
+        inline std::size_t npz_shuffle_block(std::size_t element_size)
+        {
+            return std::max(npz_block_size / element_size, std::size_t(1)) * element_size;
+        }
+
+        // Byte shuffling of the elements of a block: the k-th bytes of the n
+        // elements are stored contiguously, which groups the sign and exponent
+        // bytes of smooth floating point data and makes them compressible.
+        inline void npz_shuffle(const char* in, char* out, std::size_t n_bytes, std::size_t element_size)
+        {
+            std::size_t n = n_bytes / element_size;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                for (std::size_t k = 0; k < element_size; ++k)
+                {
+                    out[k * n + i] = in[i * element_size + k];
+                }
+            }
+        }
+
+        inline void npz_unshuffle(const char* in, char* out, std::size_t n_bytes, std::size_t element_size)
+        {
+            std::size_t n = n_bytes / element_size;
+            for (std::size_t k = 0; k < element_size; ++k)
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    out[i * element_size + k] = in[k * n + i];
+                }
+            }
+        }
+
+        // restores the elements of a shuffled member in place
+        inline void npz_unshuffle_blocks(char* data, std::size_t n_bytes, std::size_t element_size)
+        {
+            std::size_t block = npz_shuffle_block(element_size);
+            std::vector<char> tmp(std::min(block, n_bytes));
+            for (std::size_t first = 0; first < n_bytes; first += block)
+            {
+                std::size_t length = std::min(block, n_bytes - first);
+                npz_unshuffle(data + first, tmp.data(), length, element_size);
+                std::copy(tmp.data(), tmp.data() + length, data + first);
+            }
+        }
+
+        // Reads the central directory of the archive, the members themselves
+        // are not touched.
+        inline std::map<std::string, npz_member> read_zip_directory(const char* data, std::size_t size)
+        {
+            const std::size_t end_size = 22;
+            if (size < end_size)
+            {
+                throw std::runtime_error("npz: invalid zip archive");
+            }
+            // the end of central directory record is followed by a comment of at most 64 KB
+            std::size_t end_pos = size - end_size;
+            std::size_t lowest = size > end_size + 0xffff ? size - end_size - 0xffff : 0;
+            while (read_le<std::uint32_t>(data + end_pos) != zip_end_signature)
+            {
+                if (end_pos == lowest)
+                {
+                    throw std::runtime_error("npz: invalid zip archive");
+                }
+                --end_pos;
+            }
+
+            const char* end = data + end_pos;
+            std::uint64_t n_entries = read_le<std::uint16_t>(end + 10);
+            std::uint64_t dir_offset = read_le<std::uint32_t>(end + 16);
+            if ((n_entries == 0xffff || dir_offset == 0xffffffff) && end_pos >= 20 &&
+                read_le<std::uint32_t>(end - 20) == zip64_locator_signature)
+            {
+                std::uint64_t end64_pos = read_le<std::uint64_t>(end - 20 + 8);
+                if (end64_pos + 56 > size || read_le<std::uint32_t>(data + end64_pos) != zip64_end_signature)
+                {
+                    throw std::runtime_error("npz: invalid zip64 archive");
+                }
+                n_entries = read_le<std::uint64_t>(data + end64_pos + 32);
+                dir_offset = read_le<std::uint64_t>(data + end64_pos + 48);
+            }
+
+            std::map<std::string, npz_member> members;
+            std::uint64_t pos = dir_offset;
+            for (std::uint64_t i = 0; i < n_entries; ++i)
+            {
+                if (pos + 46 > size || read_le<std::uint32_t>(data + pos) != zip_central_header_signature)
+                {
+                    throw std::runtime_error("npz: invalid zip central directory");
+                }
+                const char* entry = data + pos;
+                npz_member m;
+                m.shuffled = false;
+                m.method = read_le<std::uint16_t>(entry + 10);
+                m.compressed_size = read_le<std::uint32_t>(entry + 20);
+                m.uncompressed_size = read_le<std::uint32_t>(entry + 24);
+                std::size_t name_length = read_le<std::uint16_t>(entry + 28);
+                std::size_t extra_length = read_le<std::uint16_t>(entry + 30);
+                std::size_t comment_length = read_le<std::uint16_t>(entry + 32);
+                m.local_header_offset = read_le<std::uint32_t>(entry + 42);
+                if (pos + 46 + name_length + extra_length > size)
+                {
+                    throw std::runtime_error("npz: invalid zip central directory");
+                }
+                std::string name(entry + 46, name_length);
+
+                // the zip64 extra field holds the values saturated in the entry, in order
+                const char* extra = entry + 46 + name_length;
+                const char* extra_end = extra + extra_length;
+                while (extra + 4 <= extra_end)
+                {
+                    std::uint16_t id = read_le<std::uint16_t>(extra);
+                    std::uint16_t length = read_le<std::uint16_t>(extra + 2);
+                    const char* field = extra + 4;
+                    const char* field_end = field + length;
+                    if (field_end > extra_end)
+                    {
+                        throw std::runtime_error("npz: invalid zip extra field");
+                    }
+                    if (id == 0x0001)
+                    {
+                        auto read_zip64 = [&field, field_end]()
+                        {
+                            if (field_end - field < 8)
+                            {
+                                throw std::runtime_error("npz: invalid zip64 extra field");
+                            }
+                            std::uint64_t value = read_le<std::uint64_t>(field);
+                            field += 8;
+                            return value;
+                        };
+                        if (m.uncompressed_size == 0xffffffff)
+                        {
+                            m.uncompressed_size = read_zip64();
+                        }
+                        if (m.compressed_size == 0xffffffff)
+                        {
+                            m.compressed_size = read_zip64();
+                        }
+                        if (m.local_header_offset == 0xffffffff)
+                        {
+                            m.local_header_offset = read_zip64();
+                        }
+                    }
+                    extra = field_end;
+                }
+
+                // numpy names the members after the arrays with a .npy extension
+                if (name.size() > 4 && name.compare(name.size() - 4, 4, ".npy") == 0)
+                {
+                    name.erase(name.size() - 4);
+                }
+                else if (name.size() > 5 && name.compare(name.size() - 5, 5, ".npys") == 0)
+                {
+                    name.erase(name.size() - 5);
+                    m.shuffled = true;
+                }
+                members[name] = m;
+                pos += 46 + name_length + extra_length + comment_length;
+            }
+            return members;
+        }
+
+        /******************
+         * member streams *
+         ******************/
+
+        // Input stream buffer over a memory range, used to parse the npy
+        // header of stored members in place.
+        class npz_memory_buf : public std::streambuf
+        {
+        public:
+
+            npz_memory_buf(char* first, char* last)
+            {
+                setg(first, first, last);
+            }
+
+            std::size_t position() const
+            {
+                return static_cast<std::size_t>(gptr() - eback());
+            }
+        };
+
+#if defined(XTENSOR_USE_ZLIB)
+        // Input stream buffer inflating a deflated member chunk by chunk.
+        class npz_inflate_buf : public std::streambuf
+        {
+        public:
+
+            npz_inflate_buf(const char* first, std::size_t size)
+                : m_buffer(65536)
+            {
+                std::memset(&m_stream, 0, sizeof(m_stream));
+                // negative window bits: raw deflate data without zlib header
+                if (inflateInit2(&m_stream, -MAX_WBITS) != Z_OK)
+                {
+                    throw std::runtime_error("npz: failed to initialize zlib");
+                }
+                std::size_t step = std::min(size, std::size_t(0xffffffff));
+                m_stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(first));
+                m_stream.avail_in = static_cast<uInt>(step);
+                m_remaining = size - step;
+                setg(m_buffer.data(), m_buffer.data(), m_buffer.data());
+            }
+
+            ~npz_inflate_buf() override
+            {
+                inflateEnd(&m_stream);
+            }
+
+            npz_inflate_buf(const npz_inflate_buf&) = delete;
+            npz_inflate_buf& operator=(const npz_inflate_buf&) = delete;
+
+        protected:
+
+            int_type underflow() override
+            {
+                if (m_finished)
+                {
+                    return traits_type::eof();
+                }
+                m_stream.next_out = reinterpret_cast<Bytef*>(m_buffer.data());
+                m_stream.avail_out = static_cast<uInt>(m_buffer.size());
+                while (m_stream.avail_out == m_buffer.size() && !m_finished)
+                {
+                    if (m_stream.avail_in == 0 && m_remaining != 0)
+                    {
+                        // members larger than 4 GB are fed in several steps
+                        std::size_t step = std::min(m_remaining, std::size_t(0xffffffff));
+                        m_stream.avail_in = static_cast<uInt>(step);
+                        m_remaining -= step;
+                    }
+                    int ret = inflate(&m_stream, Z_NO_FLUSH);
+                    if (ret == Z_STREAM_END)
+                    {
+                        m_finished = true;
+                    }
+                    else if (ret != Z_OK)
+                    {
+                        throw std::runtime_error("npz: corrupted deflated member");
+                    }
+                }
+                std::size_t produced = m_buffer.size() - m_stream.avail_out;
+                setg(m_buffer.data(), m_buffer.data(), m_buffer.data() + produced);
+                return produced == 0 ? traits_type::eof() : traits_type::to_int_type(*gptr());
+            }
+
+        private:
+
+            z_stream m_stream;
+            std::vector<char> m_buffer;
+            std::size_t m_remaining;
+            bool m_finished = false;
+        };
+#endif
+
+        template <class T, layout_type L>
+        inline bool read_npz_header(std::istream& stream, std::vector<std::size_t>& shape)
+        {
+            bool fortran_order;
+            std::string typestr;
+            read_npy_header(stream, typestr, fortran_order, shape);
+            check_npy_cast<T, L>(typestr, fortran_order, true);
+            return fortran_order;
+        }
+    }
+
+    /************
+     * npz_file *
+     ************/
+
+    /**
+     * @class npz_file
+     * @brief Archive of npy files (the numpy npz format).
+     *
+     * Only the directory of the archive is read upon opening. The members are
+     * decoded when they are accessed: stored members are mapped in memory
+     * without copy when their alignment allows it, and deflated members (written
+     * by numpy.savez_compressed) are inflated on the fly, which requires
+     * XTENSOR_USE_ZLIB.
+     */
+    class npz_file
+    {
+    public:
+
+        explicit npz_file(const std::string& filename);
+
+        std::size_t size() const noexcept;
+        bool contains(const std::string& name) const;
+        std::vector<std::string> names() const;
+
+        template <class T, layout_type L = layout_type::dynamic>
+        auto get(const std::string& name) const;
+
+    private:
+
+        std::shared_ptr<detail::file_mapping> m_mapping;
+        std::map<std::string, detail::npz_member> m_members;
+    };
+
+    npz_file load_npz(const std::string& filename);
+
+    template <class E, class... Args>
+    void dump_npz(const std::string& filename, const std::string& name, const xexpression<E>& e, const Args&... args);
+
+#if defined(XTENSOR_USE_ZLIB)
+    /**
+     * @struct npz_compression
+     * @brief Options of dump_npz_compressed.
+     */
+    struct npz_compression
+    {
+        /// the zlib compression level, from 0 (none) to 9 (best)
+        int level = Z_DEFAULT_COMPRESSION;
+        /// shuffles the bytes of the elements before compressing them
+        bool shuffle = false;
+    };
+
+    template <class E, class... Args>
+    void dump_npz_compressed(const std::string& filename, const npz_compression& options,
+                             const std::string& name, const xexpression<E>& e, const Args&... args);
+
+    template <class E, class... Args>
+    void dump_npz_compressed(const std::string& filename, const std::string& name,
+                             const xexpression<E>& e, const Args&... args);
+#endif
+
+    /***************************
+     * npz_file implementation *
+     ***************************/
+
+    /**
+     * Opens the archive and reads its central directory.
+     * @param filename The filename or path to the archive
+     */
+    inline npz_file::npz_file(const std::string& filename)
+        : m_mapping(std::make_shared<detail::file_mapping>(filename, mmap_mode::read_only))
+    {
+        m_members = detail::read_zip_directory(m_mapping->data(), m_mapping->size());
+    }
+
+    /**
+     * Returns the number of arrays in the archive.
+     */
+    inline std::size_t npz_file::size() const noexcept
+    {
+        return m_members.size();
+    }
+
+    /**
+     * Returns true if the archive holds an array with the given name.
+     */
+    inline bool npz_file::contains(const std::string& name) const
+    {
+        return m_members.find(name) != m_members.end();
+    }
+
+    /**
+     * Returns the names of the arrays of the archive, without the .npy extension.
+     */
+    inline std::vector<std::string> npz_file::names() const
+    {
+        std::vector<std::string> res;
+        res.reserve(m_members.size());
+        for (const auto& m : m_members)
+        {
+            res.push_back(m.first);
+        }
+        return res;
+    }
+
+    /**
+     * Decodes the array with the given name. The result of stored members
+     * may point to the mapped archive, its elements must not be modified.
+     * @param name the name of the array, without the .npy extension
+     * @tparam T select the type of the array (note: there is no dynamic
+     *           casting if types do not match)
+     * @tparam L select layout_type::column_major if the array was stored
+     *           in Fortran format
+     * @return xarray_adaptor holding the array
+     */
+    template <class T, layout_type L>
+    inline auto npz_file::get(const std::string& name) const
+    {
+        auto it = m_members.find(name);
+        if (it == m_members.end())
+        {
+            throw std::runtime_error("npz: no array named "s + name);
+        }
+        const detail::npz_member& m = it->second;
+
+        std::size_t archive_size = m_mapping->size();
+        if (m.local_header_offset + 30 > archive_size ||
+            detail::read_le<std::uint32_t>(m_mapping->data() + m.local_header_offset) != detail::zip_local_header_signature)
+        {
+            throw std::runtime_error("npz: invalid local header for "s + name);
+        }
+        const char* local = m_mapping->data() + m.local_header_offset;
+        std::size_t data_offset = static_cast<std::size_t>(m.local_header_offset) + 30 +
+            detail::read_le<std::uint16_t>(local + 26) + detail::read_le<std::uint16_t>(local + 28);
+        if (data_offset + m.compressed_size > archive_size)
+        {
+            throw std::runtime_error("npz: truncated member "s + name);
+        }
+        char* first = m_mapping->data() + data_offset;
+
+        std::vector<std::size_t> shape;
+        if (m.method == detail::zip_stored)
+        {
+            detail::npz_memory_buf buf(first, first + m.compressed_size);
+            std::istream stream(&buf);
+            bool fortran_order = detail::read_npz_header<T, L>(stream, shape);
+            std::size_t n_bytes = compute_size(shape) * sizeof(T);
+            if (buf.position() + n_bytes > m.compressed_size)
+            {
+                throw std::runtime_error("npz: truncated member "s + name);
+            }
+            char* elements = first + buf.position();
+            if (!m.shuffled && reinterpret_cast<std::uintptr_t>(elements) % alignof(T) == 0)
+            {
+                T* ptr = reinterpret_cast<T*>(elements);
+                return detail::adapt_npy_buffer(ptr, std::move(shape), fortran_order,
+                                                detail::mapping_allocator<T>(m_mapping, ptr));
+            }
+            // the zip format does not align the members, misaligned
+            // elements are copied
+            detail::mapping_allocator<T> alloc;
+            T* ptr = alloc.allocate(compute_size(shape));
+            std::memcpy(static_cast<void*>(ptr), elements, n_bytes);
+            if (m.shuffled)
+            {
+                detail::npz_unshuffle_blocks(reinterpret_cast<char*>(ptr), n_bytes, sizeof(T));
+            }
+            return detail::adapt_npy_buffer(ptr, std::move(shape), fortran_order, alloc);
+        }
+        else if (m.method == detail::zip_deflated)
+        {
+#if defined(XTENSOR_USE_ZLIB)
+            detail::npz_inflate_buf buf(first, static_cast<std::size_t>(m.compressed_size));
+            std::istream stream(&buf);
+            bool fortran_order = detail::read_npz_header<T, L>(stream, shape);
+            detail::mapping_allocator<T> alloc;
+            std::size_t size = compute_size(shape);
+            T* ptr = alloc.allocate(size);
+            stream.read(reinterpret_cast<char*>(ptr), std::streamsize(size * sizeof(T)));
+            if (!stream)
+            {
+                alloc.deallocate(ptr, size);
+                throw std::runtime_error("npz: truncated member "s + name);
+            }
+            if (m.shuffled)
+            {
+                detail::npz_unshuffle_blocks(reinterpret_cast<char*>(ptr), size * sizeof(T), sizeof(T));
+            }
+            return detail::adapt_npy_buffer(ptr, std::move(shape), fortran_order, alloc);
+#else
+            throw std::runtime_error("npz: reading compressed members requires XTENSOR_USE_ZLIB");
+#endif
+        }
+        throw std::runtime_error("npz: unsupported compression method for "s + name);
+    }
+
+    /**
+     * Opens a npz file (an archive of npy files, as written by numpy.savez).
+     * @param filename The filename or path to the archive
+     * @return an npz_file giving access to the arrays of the archive
+     */
+    inline npz_file load_npz(const std::string& filename)
+    {
+        return npz_file(filename);
+    }
+
+    /***************************
+     * dump_npz implementation *
+     ***************************/
+
+    namespace detail
+    {
+        class npz_archive_writer
+        {
+        public:
+
+            explicit npz_archive_writer(const std::string& filename)
+                : m_stream(filename, std::ofstream::binary)
+            {
+                if (!m_stream)
+                {
+                    throw std::runtime_error("IO Error: failed to open file: "s + filename);
+                }
+            }
+
+            void add(const std::string& name, const std::string& data)
+            {
+                add(name, data, zip_stored, zip_crc32(data.data(), data.size()), data.size());
+            }
+
+            // adds a member whose data is already encoded with the given method
+            void add(const std::string& name, const std::string& data, std::uint16_t method,
+                     std::uint32_t crc, std::uint64_t uncompressed_size)
+            {
+                std::uint64_t offset = static_cast<std::uint64_t>(m_stream.tellp());
+                if (data.size() >= 0xffffffff || uncompressed_size >= 0xffffffff ||
+                    offset >= 0xffffffff || name.size() > 0xffff)
+                {
+                    throw std::runtime_error("npz: dump_npz does not support archives larger than 4 GB");
+                }
+                entry e = { name, method, crc, static_cast<std::uint32_t>(data.size()),
+                            static_cast<std::uint32_t>(uncompressed_size), static_cast<std::uint32_t>(offset) };
+                write_le(m_stream, zip_local_header_signature);
+                write_common(e);
+                m_stream.write(name.data(), std::streamsize(name.size()));
+                m_stream.write(data.data(), std::streamsize(data.size()));
+                m_entries.push_back(std::move(e));
+            }
+
+            void finish()
+            {
+                std::uint64_t dir_offset = static_cast<std::uint64_t>(m_stream.tellp());
+                for (const auto& e : m_entries)
+                {
+                    write_le(m_stream, zip_central_header_signature);
+                    write_le(m_stream, std::uint16_t(20));  // version made by
+                    write_common(e);
+                    write_le(m_stream, std::uint16_t(0));  // comment length
+                    write_le(m_stream, std::uint16_t(0));  // disk number
+                    write_le(m_stream, std::uint16_t(0));  // internal attributes
+                    write_le(m_stream, std::uint32_t(0));  // external attributes
+                    write_le(m_stream, e.offset);
+                    m_stream.write(e.name.data(), std::streamsize(e.name.size()));
+                }
+                std::uint64_t dir_size = static_cast<std::uint64_t>(m_stream.tellp()) - dir_offset;
+                if (dir_offset + dir_size >= 0xffffffff || m_entries.size() >= 0xffff)
+                {
+                    throw std::runtime_error("npz: dump_npz does not support archives larger than 4 GB");
+                }
+                write_le(m_stream, zip_end_signature);
+                write_le(m_stream, std::uint16_t(0));  // disk number
+                write_le(m_stream, std::uint16_t(0));  // disk of the central directory
+                write_le(m_stream, static_cast<std::uint16_t>(m_entries.size()));
+                write_le(m_stream, static_cast<std::uint16_t>(m_entries.size()));
+                write_le(m_stream, static_cast<std::uint32_t>(dir_size));
+                write_le(m_stream, static_cast<std::uint32_t>(dir_offset));
+                write_le(m_stream, std::uint16_t(0));  // comment length
+                if (!m_stream)
+                {
+                    throw std::runtime_error("io error: failed writing file");
+                }
+            }
+
+        private:
+
+            struct entry
+            {
+                std::string name;
+                std::uint16_t method;
+                std::uint32_t crc;
+                std::uint32_t compressed_size;
+                std::uint32_t uncompressed_size;
+                std::uint32_t offset;
+            };
+
+            // fields shared by the local and central headers
+            void write_common(const entry& e)
+            {
+                write_le(m_stream, std::uint16_t(20));  // version needed to extract
+                write_le(m_stream, std::uint16_t(0));  // flags
+                write_le(m_stream, e.method);
+                write_le(m_stream, std::uint16_t(0));  // modification time
+                write_le(m_stream, std::uint16_t(0x21));  // modification date: 1980-01-01
+                write_le(m_stream, e.crc);
+                write_le(m_stream, e.compressed_size);
+                write_le(m_stream, e.uncompressed_size);
+                write_le(m_stream, static_cast<std::uint16_t>(e.name.size()));
+                write_le(m_stream, std::uint16_t(0));  // extra field length
+            }
+
+            std::ofstream m_stream;
+            std::vector<entry> m_entries;
+        };
+
+        inline void dump_npz_members(npz_archive_writer&)
+        {
+        }
+
+        template <class E, class... Args>
+        inline void dump_npz_members(npz_archive_writer& writer, const std::string& name,
+                                     const xexpression<E>& e, const Args&... args)
+        {
+            std::ostringstream stream(std::ios::binary);
+            dump_npy_stream(stream, e);
+            writer.add(name + ".npy", stream.str());
+            dump_npz_members(writer, args...);
+        }
+
+#if defined(XTENSOR_USE_ZLIB)
+        // Compresses a block of a member as a raw deflate stream. All blocks
+        // but the last end with a sync flush, their outputs can thus be
+        // concatenated into a single deflate stream, as pigz does.
+        inline void npz_deflate_block(const char* data, std::size_t size, int level, bool last, std::string& out)
+        {
+            z_stream stream;
+            stream.zalloc = Z_NULL;
+            stream.zfree = Z_NULL;
+            stream.opaque = Z_NULL;
+            if (deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            {
+                throw std::runtime_error("npz: failed to initialize zlib");
+            }
+            out.resize(deflateBound(&stream, static_cast<uLong>(size)) + 16);
+            stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+            stream.avail_in = static_cast<uInt>(size);
+            stream.next_out = reinterpret_cast<Bytef*>(&out[0]);
+            stream.avail_out = static_cast<uInt>(out.size());
+            int flush = last ? Z_FINISH : Z_SYNC_FLUSH;
+            int ret = Z_OK;
+            while (true)
+            {
+                ret = deflate(&stream, flush);
+                if (ret == Z_STREAM_ERROR || (last ? ret == Z_STREAM_END : stream.avail_out != 0))
+                {
+                    break;
+                }
+                std::size_t used = out.size() - stream.avail_out;
+                out.resize(2 * out.size());
+                stream.next_out = reinterpret_cast<Bytef*>(&out[used]);
+                stream.avail_out = static_cast<uInt>(out.size() - used);
+            }
+            out.resize(out.size() - stream.avail_out);
+            deflateEnd(&stream);
+            if (ret == Z_STREAM_ERROR)
+            {
+                throw std::runtime_error("npz: deflate failed");
+            }
+        }
+
+        // The data of the member is split into blocks of npz_block_size bytes
+        // (the npy header is prepended to the first one), which are shuffled
+        // and deflated in parallel.
+        template <class E>
+        inline void dump_npz_compressed_member(npz_archive_writer& writer, const npz_compression& options,
+                                               const std::string& name, const xexpression<E>& e)
+        {
+            using value_type = typename E::value_type;
+            const E& ex = e.derived_cast();
+            auto&& eval_ex = eval(ex);
+            bool fortran_order = eval_ex.layout() == layout_type::column_major && eval_ex.dimension() > 1;
+
+            std::ostringstream header_stream(std::ios::binary);
+            write_header(header_stream, build_typestring<value_type>(), fortran_order, eval_ex.shape());
+            std::string header = header_stream.str();
+
+            const char* data = reinterpret_cast<const char*>(eval_ex.data());
+            std::size_t n_bytes = sizeof(value_type) * compute_size(eval_ex.shape());
+            std::size_t block = npz_shuffle_block(sizeof(value_type));
+            std::size_t n_blocks = std::max((n_bytes + block - 1) / block, std::size_t(1));
+
+            std::vector<std::string> outputs(n_blocks);
+            std::vector<uLong> crcs(n_blocks);
+            std::vector<std::exception_ptr> errors(n_blocks);
+            auto run = [&](std::size_t first, std::size_t last)
+            {
+                std::vector<char> tmp;
+                for (std::size_t b = first; b < last; ++b)
+                {
+                    try
+                    {
+                        std::size_t offset = b * block;
+                        std::size_t length = std::min(block, n_bytes - offset);
+                        std::size_t prefix = b == 0 ? header.size() : std::size_t(0);
+                        const char* input = data + offset;
+                        if (prefix != 0 || options.shuffle)
+                        {
+                            tmp.resize(prefix + length);
+                            std::copy(header.data(), header.data() + prefix, tmp.data());
+                            if (options.shuffle)
+                            {
+                                npz_shuffle(data + offset, tmp.data() + prefix, length, sizeof(value_type));
+                            }
+                            else
+                            {
+                                std::copy(data + offset, data + offset + length, tmp.data() + prefix);
+                            }
+                            input = tmp.data();
+                        }
+                        crcs[b] = crc32(0L, reinterpret_cast<const Bytef*>(input), static_cast<uInt>(prefix + length));
+                        npz_deflate_block(input, prefix + length, options.level, b + 1 == n_blocks, outputs[b]);
+                    }
+                    catch (...)
+                    {
+                        errors[b] = std::current_exception();
+                    }
+                }
+            };
+            if (n_blocks > 1 && parallel::use_parallel(n_bytes / sizeof(value_type)))
+            {
+                parallel_for(std::size_t(0), n_blocks, std::size_t(1), run);
+            }
+            else
+            {
+                run(std::size_t(0), n_blocks);
+            }
+            for (const auto& err : errors)
+            {
+                if (err)
+                {
+                    std::rethrow_exception(err);
+                }
+            }
+
+            std::size_t compressed_size = 0;
+            for (const auto& out : outputs)
+            {
+                compressed_size += out.size();
+            }
+            std::string compressed;
+            compressed.reserve(compressed_size);
+            uLong crc = crcs[0];
+            for (std::size_t b = 0; b < n_blocks; ++b)
+            {
+                compressed += outputs[b];
+                std::string().swap(outputs[b]);
+                if (b != 0)
+                {
+                    std::size_t length = std::min(block, n_bytes - b * block);
+                    crc = crc32_combine(crc, crcs[b], static_cast<z_off_t>(length));
+                }
+            }
+            writer.add(name + (options.shuffle ? ".npys" : ".npy"), compressed, zip_deflated,
+                       static_cast<std::uint32_t>(crc), header.size() + n_bytes);
+        }
+
+        inline void dump_npz_compressed_members(npz_archive_writer&, const npz_compression&)
+        {
+        }
+
+        template <class E, class... Args>
+        inline void dump_npz_compressed_members(npz_archive_writer& writer, const npz_compression& options,
+                                                const std::string& name, const xexpression<E>& e,
+                                                const Args&... args)
+        {
+            dump_npz_compressed_member(writer, options, name, e);
+            dump_npz_compressed_members(writer, options, args...);
+        }
+#endif
+    }
+
+    /**
+     * Saves xexpressions in an uncompressed npz archive, the format of numpy.savez.
+     *
+     * \code{.cpp}
+     * xt::dump_npz("out.npz", "a", a, "b", b);
+     * auto npz = xt::load_npz("out.npz");
+     * auto b = npz.get<double>("b");
+     * \endcode
+     *
+     * @param filename The filename or path to the archive
+     * @param name the name of the first array
+     * @param e the first xexpression
+     * @param args the following pairs of names and xexpressions
+     */
+    template <class E, class... Args>
+    inline void dump_npz(const std::string& filename, const std::string& name,
+                         const xexpression<E>& e, const Args&... args)
+    {
+        static_assert(sizeof...(Args) % 2 == 0, "dump_npz expects pairs of names and expressions");
+        detail::npz_archive_writer writer(filename);
+        detail::dump_npz_members(writer, name, e, args...);
+        writer.finish();
+    }
+
+#if defined(XTENSOR_USE_ZLIB)
+    /**
+     * Saves xexpressions in a deflated npz archive. The members are split into
+     * blocks of 1 MB which are compressed in parallel according to the
+     * parallel settings (see xparallel.hpp). Without shuffling, the archive
+     * can be read by numpy.load like the ones written by numpy.savez_compressed.
+     * Shuffled members, which compress better when the elements are smooth
+     * floating point values, can only be read by load_npz.
+     *
+     * \code{.cpp}
+     * xt::npz_compression options;
+     * options.shuffle = true;
+     * xt::dump_npz_compressed("out.npz", options, "a", a, "b", b);
+     * \endcode
+     *
+     * @param filename The filename or path to the archive
+     * @param options the compression level and whether to shuffle the bytes
+     * @param name the name of the first array
+     * @param e the first xexpression
+     * @param args the following pairs of names and xexpressions
+     */
+    template <class E, class... Args>
+    inline void dump_npz_compressed(const std::string& filename, const npz_compression& options,
+                                    const std::string& name, const xexpression<E>& e, const Args&... args)
+    {
+        static_assert(sizeof...(Args) % 2 == 0, "dump_npz_compressed expects pairs of names and expressions");
+        detail::npz_archive_writer writer(filename);
+        detail::dump_npz_compressed_members(writer, options, name, e, args...);
+        writer.finish();
+    }
+
+    /**
+     * Saves xexpressions in a deflated npz archive with the default
+     * compression level and without shuffling.
+     * @param filename The filename or path to the archive
+     * @param name the name of the first array
+     * @param e the first xexpression
+     * @param args the following pairs of names and xexpressions
+     */
+    template <class E, class... Args>
+    inline void dump_npz_compressed(const std::string& filename, const std::string& name,
+                                    const xexpression<E>& e, const Args&... args)
+    {
+        dump_npz_compressed(filename, npz_compression(), name, e, args...);
+    }
+#endif
+}
+
+#endif
@@ -10,13 +10,19 @@
 #define XTENSOR_OPERATION_HPP
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
 #include <functional>
 #include <type_traits>
+#include <vector>
 
 #include <xtl/xsequence.hpp>
 
 #include "xconcepts.hpp"
 #include "xfunction.hpp"
+#include "xparallel.hpp"
 #include "xscalar.hpp"
 #include "xstrides.hpp"
 #include "xstrided_view.hpp"
@@ -126,7 +132,7 @@ namespace xt
                 template <class A1>
                 constexpr result_type operator()(const A1& arg) const
                 {
-                    return static_cast<R>(arg);
+                    return element_conversion<R, A1>::apply(arg);
                 }
                 // SIMD conversion disabled for now since it does not make sense
                 // in most of the cases
@@ -181,6 +187,97 @@ namespace xt
         template <class F, class... E>
         using xfunction_type_t = typename std::enable_if_t<has_xexpression<std::decay_t<E>...>::value,
                                                            xfunction_type<F, E...>>::type;
+
+        struct multiply_add
+        {
+            template <class T1, class T2, class T3>
+            auto operator()(const T1& arg1, const T2& arg2, const T3& arg3) const
+            {
+                using std::fma;
+                return fma(arg1, arg2, arg3);
+            }
+            template <class B>
+            auto simd_apply(const B& arg1, const B& arg2, const B& arg3) const
+            {
+                using std::fma;
+                return fma(arg1, arg2, arg3);
+            }
+        };
+
+        // Builds the expression of e1 + e2. When XTENSOR_FMA_CONTRACTION is
+        // defined, the sum of a temporary product of floating point values and
+        // a floating point expression is contracted into a multiply_add of the
+        // arguments of the product.
+        template <class E1, class E2, class = void>
+        struct plus_expression
+        {
+            using type = typename xfunction_type<plus, E1, E2>::type;
+
+            static type make(E1&& e1, E2&& e2)
+            {
+                return make_xfunction<plus>(std::forward<E1>(e1), std::forward<E2>(e2));
+            }
+        };
+
+#ifdef XTENSOR_FMA_CONTRACTION
+        template <class E>
+        struct product_arguments
+        {
+            static constexpr bool value = false;
+        };
+
+        template <class CT1, class CT2>
+        struct product_arguments<xfunction<multiplies, CT1, CT2>>
+        {
+            static constexpr bool value = true;
+
+            template <class E>
+            using fma_type = typename xfunction_type<multiply_add, CT1, CT2, E>::type;
+        };
+
+        template <class P, class E>
+        struct contract_fma
+            : xtl::conjunction<std::integral_constant<bool, !std::is_lvalue_reference<P>::value>,
+                               std::integral_constant<bool, product_arguments<std::decay_t<P>>::value>,
+                               std::is_floating_point<xvalue_type_t<std::decay_t<P>>>,
+                               std::is_floating_point<xvalue_type_t<std::decay_t<E>>>>
+        {
+        };
+
+        template <class P, class E>
+        inline auto make_multiply_add(P&& p, E&& e)
+        {
+            using type = typename product_arguments<std::decay_t<P>>::template fma_type<E>;
+            auto&& args = std::move(p).arguments();
+            return type(multiply_add(), std::get<0>(std::move(args)), std::get<1>(std::move(args)), std::forward<E>(e));
+        }
+
+        template <class E1, class E2>
+        struct plus_expression<E1, E2, std::enable_if_t<contract_fma<E1, E2>::value>>
+        {
+            using type = typename product_arguments<std::decay_t<E1>>::template fma_type<E2>;
+
+            static type make(E1&& e1, E2&& e2)
+            {
+                return make_multiply_add(std::forward<E1>(e1), std::forward<E2>(e2));
+            }
+        };
+
+        template <class E1, class E2>
+        struct plus_expression<E1, E2, std::enable_if_t<!contract_fma<E1, E2>::value && contract_fma<E2, E1>::value>>
+        {
+            using type = typename product_arguments<std::decay_t<E2>>::template fma_type<E1>;
+
+            static type make(E1&& e1, E2&& e2)
+            {
+                return make_multiply_add(std::forward<E2>(e2), std::forward<E1>(e1));
+            }
+        };
+#endif
+
+        template <class E1, class E2>
+        using plus_expression_t = typename std::enable_if_t<has_xexpression<std::decay_t<E1>, std::decay_t<E2>>::value,
+                                                            plus_expression<E1, E2>>::type;
     }
 
 #undef UNARY_OPERATOR_FUNCTOR
@@ -235,16 +332,19 @@ namespace xt
     * @brief Addition
     *
     * Returns an \ref xfunction for the element-wise addition
-    * of \a e1 and \a e2.
+    * of \a e1 and \a e2. When \c XTENSOR_FMA_CONTRACTION is defined
+    * and one of the operands is a temporary product of floating point
+    * values, as in \c a \c * \c b \c + \c c, the xfunction computes
+    * fused multiply-adds instead, with a single rounding.
     * @param e1 an \ref xexpression or a scalar
     * @param e2 an \ref xexpression or a scalar
     * @return an \ref xfunction
     */
     template <class E1, class E2>
     inline auto operator+(E1&& e1, E2&& e2) noexcept
-        -> detail::xfunction_type_t<detail::plus, E1, E2>
+        -> detail::plus_expression_t<E1, E2>
     {
-        return detail::make_xfunction<detail::plus>(std::forward<E1>(e1), std::forward<E2>(e2));
+        return detail::plus_expression<E1, E2>::make(std::forward<E1>(e1), std::forward<E2>(e2));
     }
 
     /**
@@ -546,6 +646,33 @@ namespace xt
         return detail::make_xfunction<detail::greater_equal>(std::forward<E1>(e1), std::forward<E2>(e2));
     }
 
+    namespace detail
+    {
+        // The values of contiguous expressions of the same value type are
+        // compared directly in their storage
+        template <class E1, class E2, class = void>
+        struct is_storage_comparable : std::false_type
+        {
+        };
+
+        template <class E1, class E2>
+        struct is_storage_comparable<E1, E2, std::enable_if_t<has_data_interface<E1>::value && has_data_interface<E2>::value>>
+            : std::integral_constant<bool,
+            E1::contiguous_layout && E2::contiguous_layout &&
+            !is_bitset_container<E1>::value && !is_bitset_container<E2>::value &&
+            std::is_same<typename E1::value_type, typename E2::value_type>::value &&
+            std::is_same<data_value_type_t<E1>, typename E1::value_type>::value &&
+            std::is_same<data_value_type_t<E2>, typename E2::value_type>::value>
+        {
+        };
+
+        template <class E1, class E2>
+        bool expression_equal(const E1& e1, const E2& e2, std::false_type);
+
+        template <class E1, class E2>
+        bool expression_equal(const E1& e1, const E2& e2, std::true_type);
+    }
+
     /**
      * @ingroup comparison_operators
      * @brief Equality
@@ -553,6 +680,10 @@ namespace xt
      * Returns true if \a e1 and \a e2 have the same shape
      * and hold the same values. Unlike other comparison
      * operators, this does not return an \ref xfunction.
+     * Contiguous expressions of the same value type and
+     * layout are compared by blocks of their storage, with
+     * a bitwise comparison for integral types, and the
+     * comparison stops at the first block that differs.
      * @param e1 an \ref xexpression or a scalar
      * @param e2 an \ref xexpression or a scalar
      * @return a boolean
@@ -564,14 +695,7 @@ namespace xt
         const E1& de1 = e1.derived_cast();
         const E2& de2 = e2.derived_cast();
         bool res = de1.dimension() == de2.dimension() && std::equal(de1.shape().begin(), de1.shape().end(), de2.shape().begin());
-        auto iter1 = de1.begin();
-        auto iter2 = de2.begin();
-        auto iter_end = de1.end();
-        while (res && iter1 != iter_end)
-        {
-            res = (*iter1++ == *iter2++);
-        }
-        return res;
+        return res && detail::expression_equal(de1, de2, detail::is_storage_comparable<E1, E2>());
     }
 
     /**
@@ -631,7 +755,10 @@ namespace xt
     *
     * Returns an \ref xfunction for the element-wise
     * ternary selection (i.e. operator ? :) of \a e1,
-    * \a e2 and \a e3.
+    * \a e2 and \a e3. When \a e1 is a comparison of elements of
+    * the value type of the result, or a container of booleans, and
+    * \a e2 and \a e3 have a SIMD interface, the selection is assigned
+    * with batch blends (xsimd::select) by the linear assignment.
     * @param e1 a boolean \ref xexpression
     * @param e2 an \ref xexpression or a scalar
     * @param e3 an \ref xexpression or a scalar
@@ -647,7 +774,7 @@ namespace xt
     namespace detail
     {
         template <class S, class I>
-        inline auto next_idx(const S& shape, I& idx)
+        inline void next_idx(const S& shape, I& idx)
         {
             for (std::size_t j = shape.size(); j > 0; --j)
             {
@@ -659,11 +786,217 @@ namespace xt
                 else
                 {
                     idx[i]++;
-                    return idx;
+                    return;
+                }
+            }
+        }
+
+        // row major multi-index of the flat position i
+        template <class S, class I>
+        inline void unravel_row_major(const S& shape, std::size_t i, I& idx)
+        {
+            for (std::size_t j = shape.size(); j > 0; --j)
+            {
+                std::size_t extent = static_cast<std::size_t>(shape[j - 1]);
+                idx[j - 1] = static_cast<typename I::value_type>(i % extent);
+                i /= extent;
+            }
+        }
+
+        // number of true values of the mask in [first, last), and one past
+        // the last of them
+        struct compress_count
+        {
+            std::size_t count;
+            std::size_t end;
+        };
+
+        template <class M>
+        inline compress_count count_mask(M mask, std::size_t first, std::size_t last)
+        {
+            compress_count res = {0, first};
+            mask += static_cast<std::ptrdiff_t>(first);
+            for (std::size_t i = first; i != last; ++i, ++mask)
+            {
+                bool c = static_cast<bool>(*mask);
+                res.count += static_cast<std::size_t>(c);
+                res.end = c ? i + 1 : res.end;
+            }
+            return res;
+        }
+
+        // same as count_mask for the row major positions of an expression
+        // that cannot be iterated linearly, idx being the index of first
+        template <class E, class S, class I>
+        inline compress_count count_elements(const E& e, const S& shape, I& idx, std::size_t first, std::size_t last)
+        {
+            compress_count res = {0, first};
+            for (std::size_t i = first; i != last; ++i, next_idx(shape, idx))
+            {
+                bool c = static_cast<bool>(e.element(idx.cbegin(), idx.cend()));
+                res.count += static_cast<std::size_t>(c);
+                res.end = c ? i + 1 : res.end;
+            }
+            return res;
+        }
+
+        /**
+         * Visits the non-zero elements of \c e in row major order, in two
+         * phases: the non-zero elements of every chunk of the flat range are
+         * counted, \c init is called with their total number so that the
+         * results can be allocated with their exact size, then the chunks are
+         * scanned again and \c write(k, idx) is called for the k-th non-zero
+         * element, of multi-index idx. Large expressions are processed in
+         * parallel; the count of an expression that can be iterated linearly
+         * in row major order is branchless.
+         */
+        template <class E, class F, class W>
+        inline void scan_nonzero(const E& e, F& init, W& write, std::false_type /*bitset*/)
+        {
+            using shape_type = typename E::shape_type;
+            using index_type = xindex_type_t<shape_type>;
+            using strides_type = get_strides_t<shape_type>;
+
+            const auto& shape = e.shape();
+            std::size_t dim = e.dimension();
+            std::size_t size = compute_size(shape);
+            std::size_t nb_chunks = parallel::use_parallel(size) ? std::size_t(64) : std::size_t(1);
+            std::size_t chunk_size = (size + nb_chunks - 1) / nb_chunks;
+            auto chunk_first = [chunk_size, size](std::size_t c) { return (std::min)(size, c * chunk_size); };
+            auto chunk_last = [chunk_size, size](std::size_t c) { return (std::min)(size, (c + 1) * chunk_size); };
+
+            strides_type strides = xtl::make_sequence<strides_type>(dim, 0);
+            compute_strides(shape, layout_type::row_major, strides);
+            bool linear = e.has_linear_assign(strides);
+            auto mask = linear_begin(e);
+
+            std::vector<compress_count> counts(nb_chunks);
+            parallel_for(std::size_t(0), nb_chunks, std::size_t(1), [&](std::size_t first, std::size_t last) {
+                for (std::size_t c = first; c != last; ++c)
+                {
+                    if (linear)
+                    {
+                        counts[c] = count_mask(mask, chunk_first(c), chunk_last(c));
+                    }
+                    else
+                    {
+                        index_type idx = xtl::make_sequence<index_type>(dim, 0);
+                        unravel_row_major(shape, chunk_first(c), idx);
+                        counts[c] = count_elements(e, shape, idx, chunk_first(c), chunk_last(c));
+                    }
+                }
+            });
+
+            std::vector<std::size_t> offsets(nb_chunks + 1, 0);
+            for (std::size_t c = 0; c != nb_chunks; ++c)
+            {
+                offsets[c + 1] = offsets[c] + counts[c].count;
+            }
+            init(offsets[nb_chunks]);
+
+            parallel_for(std::size_t(0), nb_chunks, std::size_t(1), [&](std::size_t first, std::size_t last) {
+                for (std::size_t c = first; c != last; ++c)
+                {
+                    if (counts[c].count == 0)
+                    {
+                        continue;
+                    }
+                    index_type idx = xtl::make_sequence<index_type>(dim, 0);
+                    unravel_row_major(shape, chunk_first(c), idx);
+                    std::size_t k = offsets[c];
+                    if (linear)
+                    {
+                        auto it = mask;
+                        it += static_cast<std::ptrdiff_t>(chunk_first(c));
+                        for (std::size_t i = chunk_first(c); i != counts[c].end; ++i, ++it, next_idx(shape, idx))
+                        {
+                            if (static_cast<bool>(*it))
+                            {
+                                write(k++, idx);
+                            }
+                        }
+                    }
+                    else
+                    {
+                        for (std::size_t i = chunk_first(c); i != counts[c].end; ++i, next_idx(shape, idx))
+                        {
+                            if (static_cast<bool>(e.element(idx.cbegin(), idx.cend())))
+                            {
+                                write(k++, idx);
+                            }
+                        }
+                    }
+                }
+            });
+        }
+
+        // Packed flags stored in row major order are counted and scanned a
+        // block of bits at a time.
+        template <class E, class F, class W>
+        inline void scan_nonzero(const E& e, F& init, W& write, std::true_type /*bitset*/)
+        {
+            using shape_type = typename E::shape_type;
+            using index_type = xindex_type_t<shape_type>;
+            using strides_type = get_strides_t<shape_type>;
+            using block_type = typename bitset_source<E>::block_type;
+            constexpr std::size_t block_size = 8 * sizeof(block_type);
+
+            const auto& shape = e.shape();
+            std::size_t dim = e.dimension();
+            std::size_t size = compute_size(shape);
+            strides_type strides = xtl::make_sequence<strides_type>(dim, 0);
+            compute_strides(shape, layout_type::row_major, strides);
+            if (!bitset_source<E>::packed(e, size) || !e.has_linear_assign(strides))
+            {
+                scan_nonzero(e, init, write, std::false_type());
+                return;
+            }
+
+            const block_type* blocks = e.storage().data();
+            std::size_t block_count = (size + block_size - 1) / block_size;
+            std::size_t nb_chunks = parallel::use_parallel(size) ? (std::max)((std::min)(std::size_t(64), block_count), std::size_t(1))
+                                                                 : std::size_t(1);
+            std::size_t chunk_size = (block_count + nb_chunks - 1) / nb_chunks;
+            auto chunk_first = [chunk_size, block_count](std::size_t c) { return (std::min)(block_count, c * chunk_size); };
+            auto chunk_last = [chunk_size, block_count](std::size_t c) { return (std::min)(block_count, (c + 1) * chunk_size); };
+
+            std::vector<std::size_t> counts(nb_chunks);
+            parallel_for(std::size_t(0), nb_chunks, std::size_t(1), [&](std::size_t first, std::size_t last) {
+                for (std::size_t c = first; c != last; ++c)
+                {
+                    counts[c] = count_bits(blocks + chunk_first(c), (chunk_last(c) - chunk_first(c)) * block_size);
                 }
+            });
+
+            std::vector<std::size_t> offsets(nb_chunks + 1, 0);
+            for (std::size_t c = 0; c != nb_chunks; ++c)
+            {
+                offsets[c + 1] = offsets[c] + counts[c];
             }
-            // return empty index, happens at last iteration step, but remains unused
-            return I();
+            init(offsets[nb_chunks]);
+
+            shape_divider divider(shape);
+            parallel_for(std::size_t(0), nb_chunks, std::size_t(1), [&](std::size_t first, std::size_t last) {
+                index_type idx = xtl::make_sequence<index_type>(dim, 0);
+                for (std::size_t c = first; c != last; ++c)
+                {
+                    std::size_t k = offsets[c];
+                    for (std::size_t b = chunk_first(c); b != chunk_last(c); ++b)
+                    {
+                        for (block_type bits = blocks[b]; bits != block_type(0); bits &= static_cast<block_type>(bits - 1))
+                        {
+                            divider.unravel(b * block_size + lowest_bit(bits), idx);
+                            write(k++, idx);
+                        }
+                    }
+                }
+            });
+        }
+
+        template <class E, class F, class W>
+        inline void scan_nonzero(const E& e, F&& init, W&& write)
+        {
+            scan_nonzero(e, init, write, is_bitset_container<E>());
         }
     }
 
@@ -671,6 +1004,10 @@ namespace xt
      * @ingroup logical_operators
      * @brief return vector of indices where T is not zero
      *
+     * The non-zero elements are counted before the indices are written,
+     * so that the vectors are allocated once with their final size; large
+     * expressions are scanned in parallel.
+     *
      * @param arr input array
      * @return vector of vectors, one for each dimension of arr, containing
      * the indices of the non-zero elements in that dimension
@@ -678,24 +1015,20 @@ namespace xt
     template <class T>
     inline auto nonzero(const T& arr)
     {
-        auto shape = arr.shape();
-        using index_type = xindex_type_t<typename T::shape_type>;
         using size_type = typename T::size_type;
 
-        auto idx = xtl::make_sequence<index_type>(arr.dimension(), 0);
         std::vector<std::vector<size_type>> indices(arr.dimension());
-
-        size_type total_size = compute_size(shape);
-        for (size_type i = 0; i < total_size; i++, detail::next_idx(shape, idx))
-        {
-            if (arr.element(std::begin(idx), std::end(idx)))
+        detail::scan_nonzero(arr, [&indices](std::size_t n) {
+            for (auto& v : indices)
             {
-                for (std::size_t n = 0; n < indices.size(); ++n)
-                {
-                    indices.at(n).push_back(idx[n]);
-                }
+                v.resize(n);
             }
-        }
+        }, [&indices](std::size_t k, const auto& idx) {
+            for (std::size_t n = 0; n < indices.size(); ++n)
+            {
+                indices[n][k] = static_cast<size_type>(idx[n]);
+            }
+        });
 
         return indices;
     }
@@ -717,7 +1050,8 @@ namespace xt
     /**
      * @ingroup logical_operators
      * @brief return vector of indices where condition is true
-     *        (equivalent to \a nonzero(condition))
+     *        (equivalent to \a nonzero(condition), with which it shares
+     *        the two-phase scan)
      *
      * @param condition input array
      * @return vector of \a index_types where condition is not equal to zero
@@ -732,29 +1066,294 @@ namespace xt
      * @ingroup logical_operators
      * @brief return vector of indices where arr is not zero
      *
+     * Like \ref nonzero, the indices are counted first and written into
+     * a vector of their exact size.
+     *
      * @param arr input array
      * @return vector of index_types where arr is not equal to zero
      */
     template <class T>
     inline auto argwhere(const T& arr)
     {
-        auto shape = arr.shape();
         using index_type = xindex_type_t<typename T::shape_type>;
-        using size_type = typename T::size_type;
 
-        auto idx = xtl::make_sequence<index_type>(arr.dimension(), 0);
         std::vector<index_type> indices;
+        detail::scan_nonzero(arr, [&indices, &arr](std::size_t n) {
+            indices.resize(n, xtl::make_sequence<index_type>(arr.dimension(), 0));
+        }, [&indices](std::size_t k, const index_type& idx) {
+            indices[k] = idx;
+        });
+
+        return indices;
+    }
 
-        size_type total_size = compute_size(shape);
-        for (size_type i = 0; i < total_size; i++, detail::next_idx(shape, idx))
+    namespace detail
+    {
+        // any and all look for a decisive element, i.e. a truthy one
+        // (All = false) or a falsy one (All = true). The elements are tested
+        // by blocks without branches, which lets the compiler vectorize the
+        // test of a block, and the scan stops after the first block holding
+        // a decisive element. The blocks of large expressions are shared
+        // among threads, which skip their remaining blocks once one of them
+        // has found a decisive element.
+        constexpr std::size_t short_circuit_block_size = 4096;
+
+        template <bool All, class It>
+        inline bool find_decisive(It it, std::size_t first, std::size_t last)
         {
-            if (arr.element(std::begin(idx), std::end(idx)))
+            it += static_cast<std::ptrdiff_t>(first);
+            bool res = false;
+            for (std::size_t i = first; i != last; ++i, ++it)
             {
-                indices.push_back(idx);
+                res |= static_cast<bool>(*it) != All;
             }
+            return res;
         }
 
-        return indices;
+        template <bool All, class T>
+        inline bool find_decisive(const T* src, std::size_t first, std::size_t last, std::false_type /*simd*/)
+        {
+            bool res = false;
+            for (std::size_t i = first; i != last; ++i)
+            {
+                res |= static_cast<bool>(src[i]) != All;
+            }
+            return res;
+        }
+
+#ifdef XTENSOR_USE_XSIMD
+        template <bool All, class T>
+        inline bool find_decisive(const T* src, std::size_t first, std::size_t last, std::true_type /*simd*/)
+        {
+            using batch_type = xsimd::simd_type<T>;
+            constexpr std::size_t simd_size = batch_type::size;
+            const batch_type zero(T(0));
+            auto decisive = [&zero](const batch_type& b) { return All ? b == zero : b != zero; };
+
+            std::size_t simd_end = last - (last - first) % simd_size;
+            bool res = false;
+            if (simd_end != first)
+            {
+                auto acc = decisive(xsimd::load_simd<T, T>(src + first, xsimd::unaligned_mode()));
+                for (std::size_t i = first + simd_size; i != simd_end; i += simd_size)
+                {
+                    acc = acc | decisive(xsimd::load_simd<T, T>(src + i, xsimd::unaligned_mode()));
+                }
+                res = xsimd::any(acc);
+            }
+            return res || find_decisive<All>(src, simd_end, last, std::false_type());
+        }
+#endif
+
+        template <bool All, class T>
+        inline bool find_decisive(const T* src, std::size_t first, std::size_t last)
+        {
+#ifdef XTENSOR_USE_XSIMD
+            using use_simd = std::integral_constant<bool, std::is_arithmetic<T>::value &&
+                                                          !std::is_same<T, bool>::value &&
+                                                          xsimd::simd_traits<T>::size != 1>;
+#else
+            using use_simd = std::false_type;
+#endif
+            return find_decisive<All>(src, first, last, use_simd());
+        }
+
+        // Returns true if found(first, last) is true for a block of the
+        // range [0, size), the blocks following it are not tested.
+        template <class F>
+        inline bool find_block(std::size_t size, F&& found_in)
+        {
+            constexpr std::size_t block_size = short_circuit_block_size;
+            std::size_t nb_blocks = (size + block_size - 1) / block_size;
+            auto block_last = [size](std::size_t b) { return (std::min)(size, (b + 1) * block_size); };
+            if (nb_blocks > 1 && parallel::use_parallel(size))
+            {
+                std::atomic<bool> found(false);
+                parallel_for(std::size_t(0), nb_blocks, parallel::grain(block_size), [&](std::size_t first, std::size_t last) {
+                    for (std::size_t b = first; b != last && !found.load(std::memory_order_relaxed); ++b)
+                    {
+                        if (found_in(b * block_size, block_last(b)))
+                        {
+                            found.store(true, std::memory_order_relaxed);
+                        }
+                    }
+                });
+                return found.load();
+            }
+            for (std::size_t b = 0; b != nb_blocks; ++b)
+            {
+                if (found_in(b * block_size, block_last(b)))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        template <bool All, class It>
+        inline bool short_circuit(It it, std::size_t size)
+        {
+            return find_block(size, [&it](std::size_t first, std::size_t last) {
+                return find_decisive<All>(it, first, last);
+            });
+        }
+
+        /***********************************
+         * expression_equal implementation *
+         ***********************************/
+
+        // the object representation of integers is their value
+        template <class T>
+        inline bool find_difference(const T* p1, const T* p2, std::size_t first, std::size_t last, std::true_type /*bitwise*/)
+        {
+            return std::memcmp(p1 + first, p2 + first, (last - first) * sizeof(T)) != 0;
+        }
+
+        template <class T>
+        inline bool find_difference(const T* p1, const T* p2, std::size_t first, std::size_t last, std::false_type /*bitwise*/)
+        {
+            bool res = false;
+            for (std::size_t i = first; i != last; ++i)
+            {
+                res |= !static_cast<bool>(p1[i] == p2[i]);
+            }
+            return res;
+        }
+
+#ifdef XTENSOR_USE_XSIMD
+        // floating point values are not compared bitwise, -0 == 0 and NaN != NaN
+        template <class T>
+        inline bool find_difference_simd(const T* p1, const T* p2, std::size_t first, std::size_t last)
+        {
+            using batch_type = xsimd::simd_type<T>;
+            constexpr std::size_t simd_size = batch_type::size;
+
+            std::size_t simd_end = last - (last - first) % simd_size;
+            bool res = false;
+            if (simd_end != first)
+            {
+                auto acc = xsimd::load_simd<T, T>(p1 + first, xsimd::unaligned_mode()) !=
+                           xsimd::load_simd<T, T>(p2 + first, xsimd::unaligned_mode());
+                for (std::size_t i = first + simd_size; i != simd_end; i += simd_size)
+                {
+                    acc = acc | (xsimd::load_simd<T, T>(p1 + i, xsimd::unaligned_mode()) !=
+                                 xsimd::load_simd<T, T>(p2 + i, xsimd::unaligned_mode()));
+                }
+                res = xsimd::any(acc);
+            }
+            return res || find_difference(p1, p2, simd_end, last, std::false_type());
+        }
+#endif
+
+        template <class T>
+        inline bool find_difference(const T* p1, const T* p2, std::size_t first, std::size_t last)
+        {
+#ifdef XTENSOR_USE_XSIMD
+            return xtl::mpl::static_if<std::is_floating_point<T>::value && xsimd::simd_traits<T>::size != 1>([&](auto self)
+            {
+                return find_difference_simd(self(p1), p2, first, last);
+            }, /*else*/ [&](auto self)
+            {
+                return find_difference(self(p1), p2, first, last, std::is_integral<T>());
+            });
+#else
+            return find_difference(p1, p2, first, last, std::is_integral<T>());
+#endif
+        }
+
+        template <class E1, class E2>
+        inline bool expression_equal(const E1& e1, const E2& e2, std::false_type)
+        {
+            bool res = true;
+            auto iter1 = e1.begin();
+            auto iter2 = e2.begin();
+            auto iter_end = e1.end();
+            while (res && iter1 != iter_end)
+            {
+                res = (*iter1++ == *iter2++);
+            }
+            return res;
+        }
+
+        template <class E1, class E2>
+        inline bool expression_equal(const E1& e1, const E2& e2, std::true_type)
+        {
+            if (e1.dimension() > 1 && e1.layout() != e2.layout())
+            {
+                return expression_equal(e1, e2, std::false_type());
+            }
+            const auto* p1 = e1.data() + e1.data_offset();
+            const auto* p2 = e2.data() + e2.data_offset();
+            return !find_block(static_cast<std::size_t>(e1.size()), [p1, p2](std::size_t first, std::size_t last) {
+                return find_difference(p1, p2, first, last);
+            });
+        }
+
+        // true if the expression can be iterated linearly, in row major or
+        // in column major order
+        template <class E>
+        inline bool has_linear_iteration(const E& e)
+        {
+            using strides_type = get_strides_t<typename E::shape_type>;
+            strides_type strides = xtl::make_sequence<strides_type>(e.dimension(), 0);
+            compute_strides(e.shape(), layout_type::row_major, strides);
+            if (e.has_linear_assign(strides))
+            {
+                return true;
+            }
+            compute_strides(e.shape(), layout_type::column_major, strides);
+            return e.has_linear_assign(strides);
+        }
+
+        template <bool All, class E>
+        inline bool find_decisive(const E& e)
+        {
+            using value_type = typename E::value_type;
+            std::size_t size = static_cast<std::size_t>(e.size());
+            return xtl::mpl::static_if<has_data_interface<E>::value && E::contiguous_layout &&
+                                       !is_bitset_container<E>::value>([&](auto self)
+            {
+                const auto& se = self(e);
+                return short_circuit<All>(se.data() + se.data_offset(), size);
+            }, /*else*/ [&](auto self)
+            {
+                const auto& se = self(e);
+                if (has_linear_iteration(se))
+                {
+                    return short_circuit<All>(linear_begin(se), size);
+                }
+                return std::any_of(se.cbegin(), se.cend(), [](const value_type& el) {
+                    return static_cast<bool>(el) != All;
+                });
+            });
+        }
+
+        template <class E>
+        inline bool any_impl(const E& e, std::false_type)
+        {
+            return find_decisive<false>(e);
+        }
+
+        // bit-packed flags are tested a block at a time
+        template <class E>
+        inline bool any_impl(const E& e, std::true_type)
+        {
+            return bitset_source<E>::packed(e, static_cast<std::size_t>(e.size())) ?
+                e.storage().any() : any_impl(e, std::false_type());
+        }
+
+        template <class E>
+        inline bool all_impl(const E& e, std::false_type)
+        {
+            return !find_decisive<true>(e);
+        }
+
+        template <class E>
+        inline bool all_impl(const E& e, std::true_type)
+        {
+            return bitset_source<E>::packed(e, static_cast<std::size_t>(e.size())) ?
+                e.storage().all() : all_impl(e, std::false_type());
+        }
     }
 
     /**
@@ -762,7 +1361,9 @@ namespace xt
     * @brief Any
     *
     * Returns true if any of the values of \a e is truthy,
-    * false otherwise.
+    * false otherwise. The elements of expressions that can be iterated
+    * linearly are tested by blocks, and the evaluation stops after the
+    * first block holding a truthy element.
     * @param e an \ref xexpression
     * @return a boolean
     */
@@ -770,8 +1371,7 @@ namespace xt
     inline bool any(E&& e)
     {
         using xtype = std::decay_t<E>;
-        using value_type = typename xtype::value_type;
-        return std::any_of(e.cbegin(), e.cend(), [](const value_type& el) { return el; });
+        return detail::any_impl(e, detail::is_bitset_container<xtype>());
     }
 
     /**
@@ -779,7 +1379,9 @@ namespace xt
     * @brief Any
     *
     * Returns true if all of the values of \a e are truthy,
-    * false otherwise.
+    * false otherwise. The elements of expressions that can be iterated
+    * linearly are tested by blocks, and the evaluation stops after the
+    * first block holding a falsy element.
     * @param e an \ref xexpression
     * @return a boolean
     */
@@ -787,8 +1389,7 @@ namespace xt
     inline bool all(E&& e)
     {
         using xtype = std::decay_t<E>;
-        using value_type = typename xtype::value_type;
-        return std::all_of(e.cbegin(), e.cend(), [](const value_type& el) { return el; });
+        return detail::all_impl(e, detail::is_bitset_container<xtype>());
     }
 
     /**
@@ -800,7 +1401,10 @@ namespace xt
      * @brief Element-wise ``static_cast``.
      *
      * Returns an \ref xfunction for the element-wise
-     * static_cast of \a e to type R.
+     * static_cast of \a e to type R. Floating point and integral
+     * values out of the range of an integral type R saturate to
+     * its bounds, and NaN are converted to 0, like in the
+     * assignments of expressions of another value type.
      *
      * @param e an \ref xexpression or a scalar
      * @return an \ref xfunction
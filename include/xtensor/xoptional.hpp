@@ -9,6 +9,7 @@
 #ifndef XTENSOR_OPTIONAL_HPP
 #define XTENSOR_OPTIONAL_HPP
 
+#include <cmath>
 #include <type_traits>
 #include <utility>
 
@@ -183,6 +184,404 @@ namespace xt
                 return (arg1 & arg2);
             }
         };
+
+        /****************
+         * nan_sentinel *
+         ****************/
+
+        // Reads the elements of a floating point expression as optional
+        // values, missing where they are NaN. The flags are computed on the
+        // fly instead of being stored.
+        template <class T>
+        struct nan_sentinel
+        {
+            static_assert(std::is_floating_point<T>::value, "nan_optional requires a floating point expression");
+
+            using argument_type = T;
+            using result_type = xtl::xoptional<T, bool>;
+
+            result_type operator()(const T& arg) const
+            {
+                return result_type(arg, !std::isnan(arg));
+            }
+        };
+
+        template <class T>
+        struct nan_sentinel_flag
+        {
+            using argument_type = T;
+            using result_type = bool;
+
+            result_type operator()(const T& arg) const
+            {
+                return !std::isnan(arg);
+            }
+        };
+    }
+
+    namespace detail
+    {
+        /*****************
+         * flag_assigner *
+         *****************/
+
+        // The flags of optional expressions are combined by optional_bitwise
+        // whatever their storage. When they are held by contiguous buffers of
+        // bool, or by bitsets, the conjunction is computed with a loop on the
+        // raw buffers, a word at a time for bitsets, instead of through the
+        // steppers of the flag expressions.
+
+        template <class E, class = void>
+        struct flag_source
+        {
+            static constexpr bool value = false;
+        };
+
+        template <class E>
+        struct flag_source<E, std::enable_if_t<conversion_source<E>::value && !bitset_source<E>::value &&
+                                               std::is_same<typename conversion_source<E>::value_type, bool>::value>>
+        {
+            static constexpr bool value = true;
+            using block_type = bool;
+
+            struct reader
+            {
+                const bool* p_data;
+
+                bool operator()(std::size_t i) const noexcept
+                {
+                    return p_data[i];
+                }
+            };
+
+            template <class S>
+            static bool linear(const E& e, const S& strides, std::size_t size) noexcept
+            {
+                return static_cast<std::size_t>(e.size()) == size && e.has_linear_assign(strides);
+            }
+
+            template <class B>
+            static reader make_reader(const E& e) noexcept
+            {
+                return reader{conversion_source<E>::data(e)};
+            }
+        };
+
+        template <class E>
+        struct flag_source<E, std::enable_if_t<std::is_base_of<xcontainer<E>, E>::value && bitset_source<E>::value>>
+        {
+            static constexpr bool value = true;
+            using block_type = typename bitset_source<E>::block_type;
+
+            struct reader
+            {
+                const block_type* p_data;
+
+                block_type operator()(std::size_t i) const noexcept
+                {
+                    return p_data[i];
+                }
+            };
+
+            template <class S>
+            static bool linear(const E& e, const S& strides, std::size_t size) noexcept
+            {
+                return bitset_source<E>::packed(e, size) && e.has_linear_assign(strides);
+            }
+
+            template <class B>
+            static reader make_reader(const E& e) noexcept
+            {
+                return reader{e.storage().data()};
+            }
+        };
+
+        template <class B>
+        constexpr B full_flag_block() noexcept
+        {
+            return static_cast<B>(~B(0));
+        }
+
+        template <>
+        constexpr bool full_flag_block<bool>() noexcept
+        {
+            return true;
+        }
+
+        template <class E>
+        struct scalar_flag_source
+        {
+            static constexpr bool value = true;
+            using block_type = void;
+
+            template <class B>
+            struct reader
+            {
+                B m_block;
+
+                B operator()(std::size_t) const noexcept
+                {
+                    return m_block;
+                }
+            };
+
+            template <class S>
+            static bool linear(const E&, const S&, std::size_t) noexcept
+            {
+                return true;
+            }
+
+            template <class B>
+            static reader<B> make_reader(const E& e) noexcept
+            {
+                return reader<B>{static_cast<bool>(scalar(e)) ? full_flag_block<B>() : B(0)};
+            }
+
+        private:
+
+            template <class CT>
+            static decltype(auto) scalar(const xscalar<CT>& e) noexcept
+            {
+                return e();
+            }
+
+            template <class CT, class X>
+            static decltype(auto) scalar(const xbroadcast<CT, X>& e) noexcept
+            {
+                return e.expression()();
+            }
+        };
+
+        template <class CT>
+        struct flag_source<xscalar<CT>, std::enable_if_t<std::is_convertible<typename xscalar<CT>::value_type, bool>::value>>
+            : scalar_flag_source<xscalar<CT>>
+        {
+        };
+
+        // the flags of optional and non optional operands, see split_optional_expression
+        template <class CT, class X>
+        struct flag_source<xbroadcast<CT, X>, std::enable_if_t<flag_source<std::decay_t<CT>>::value &&
+                                                               std::is_void<typename flag_source<std::decay_t<CT>>::block_type>::value>>
+            : scalar_flag_source<xbroadcast<CT, X>>
+        {
+        };
+
+        template <class... B>
+        struct common_flag_block;
+
+        template <>
+        struct common_flag_block<>
+        {
+            using type = void;
+        };
+
+        template <class B, class... R>
+        struct common_flag_block<B, R...>
+        {
+            using tail_type = typename common_flag_block<R...>::type;
+            static constexpr bool consistent = std::is_void<B>::value || std::is_void<tail_type>::value ||
+                                               std::is_same<B, tail_type>::value;
+            using type = std::conditional_t<consistent,
+                                            std::conditional_t<std::is_void<B>::value, tail_type, B>,
+                                            common_flag_block<>>;
+        };
+
+        template <class B>
+        inline B combine_flags(std::size_t /*i*/, const B& block) noexcept
+        {
+            return block;
+        }
+
+        template <class B, class R, class... Rs>
+        inline B combine_flags(std::size_t i, const B& block, const R& r, const Rs&... rs) noexcept
+        {
+            return combine_flags(i, static_cast<B>(block & r(i)), rs...);
+        }
+
+        template <class T, class... CT>
+        struct flag_source<xfunction<optional_bitwise<T>, CT...>,
+                           std::enable_if_t<xtl::conjunction<flag_source<std::decay_t<CT>>...>::value &&
+                                            !std::is_same<typename common_flag_block<typename flag_source<std::decay_t<CT>>::block_type...>::type,
+                                                          common_flag_block<>>::value>>
+        {
+            using function_type = xfunction<optional_bitwise<T>, CT...>;
+            static constexpr bool value = true;
+            using block_type = typename common_flag_block<typename flag_source<std::decay_t<CT>>::block_type...>::type;
+
+            template <class B>
+            using reader_tuple = std::tuple<decltype(flag_source<std::decay_t<CT>>::template make_reader<B>(std::declval<const std::decay_t<CT>&>()))...>;
+
+            template <class B>
+            struct reader
+            {
+                reader_tuple<B> m_readers;
+
+                B operator()(std::size_t i) const noexcept
+                {
+                    return read(i, std::make_index_sequence<sizeof...(CT)>());
+                }
+
+                template <std::size_t... I>
+                B read(std::size_t i, std::index_sequence<I...>) const noexcept
+                {
+                    return combine_flags(i, full_flag_block<B>(), std::get<I>(m_readers)...);
+                }
+            };
+
+            template <class S>
+            static bool linear(const function_type& e, const S& strides, std::size_t size) noexcept
+            {
+                return linear_impl(e, strides, size, std::make_index_sequence<sizeof...(CT)>());
+            }
+
+            template <class B>
+            static reader<B> make_reader(const function_type& e) noexcept
+            {
+                return make_reader_impl<B>(e, std::make_index_sequence<sizeof...(CT)>());
+            }
+
+        private:
+
+            template <class S, std::size_t... I>
+            static bool linear_impl(const function_type& e, const S& strides, std::size_t size, std::index_sequence<I...>) noexcept
+            {
+                bool res = true;
+                auto dummy = {(res = res && flag_source<std::decay_t<CT>>::linear(std::get<I>(e.arguments()), strides, size))...};
+                static_cast<void>(dummy);
+                return res;
+            }
+
+            template <class B, std::size_t... I>
+            static reader<B> make_reader_impl(const function_type& e, std::index_sequence<I...>) noexcept
+            {
+                return reader<B>{reader_tuple<B>(flag_source<std::decay_t<CT>>::template make_reader<B>(std::get<I>(e.arguments()))...)};
+            }
+        };
+
+        // the flags of a NaN sentinel are read from the buffer of the values
+        template <class T, class CT>
+        struct flag_source<xfunction<nan_sentinel_flag<T>, CT>, std::enable_if_t<conversion_source<std::decay_t<CT>>::value>>
+        {
+            using function_type = xfunction<nan_sentinel_flag<T>, CT>;
+            static constexpr bool value = true;
+            using block_type = bool;
+
+            struct reader
+            {
+                const T* p_data;
+
+                bool operator()(std::size_t i) const noexcept
+                {
+                    return !std::isnan(p_data[i]);
+                }
+            };
+
+            template <class S>
+            static bool linear(const function_type& e, const S& strides, std::size_t size) noexcept
+            {
+                const auto& arg = std::get<0>(e.arguments());
+                return static_cast<std::size_t>(arg.size()) == size && arg.has_linear_assign(strides);
+            }
+
+            template <class B>
+            static reader make_reader(const function_type& e) noexcept
+            {
+                return reader{conversion_source<std::decay_t<CT>>::data(std::get<0>(e.arguments()))};
+            }
+        };
+
+        template <class E, class = void>
+        struct flag_destination
+        {
+            static constexpr bool value = false;
+        };
+
+        template <class E>
+        struct flag_destination<E, std::enable_if_t<flag_source<E>::value && !std::is_void<typename flag_source<E>::block_type>::value>>
+        {
+            static constexpr bool value = true;
+            using block_type = typename flag_source<E>::block_type;
+        };
+
+        template <class E1, class E2, class Enable = void>
+        struct flag_assigner
+        {
+            static bool run(E1& /*e1*/, const E2& /*e2*/)
+            {
+                return false;
+            }
+        };
+
+        template <class E1, class E2>
+        struct flag_assigner<E1, E2, std::enable_if_t<flag_destination<E1>::value && flag_source<E2>::value &&
+                                                      (std::is_void<typename flag_source<E2>::block_type>::value ||
+                                                       std::is_same<typename flag_source<E2>::block_type,
+                                                                    typename flag_destination<E1>::block_type>::value)>>
+        {
+            using block_type = typename flag_destination<E1>::block_type;
+
+            static bool run(E1& e1, const E2& e2)
+            {
+                std::size_t size = static_cast<std::size_t>(e1.size());
+                if (!flag_source<E1>::linear(e1, e1.strides(), size) || !flag_source<E2>::linear(e2, e1.strides(), size))
+                {
+                    return false;
+                }
+
+                auto read = flag_source<E2>::template make_reader<block_type>(e2);
+                block_type* dst = blocks(e1);
+                std::size_t block_count = count(e1);
+                for (std::size_t i = 0; i < block_count; ++i)
+                {
+                    dst[i] = read(i);
+                }
+                clear_tail(e1, size);
+                return true;
+            }
+
+        private:
+
+            template <class E = E1>
+            static std::enable_if_t<!bitset_source<E>::value, bool*> blocks(E& e) noexcept
+            {
+                return e.data() + e.data_offset();
+            }
+
+            template <class E = E1>
+            static std::enable_if_t<bitset_source<E>::value, block_type*> blocks(E& e) noexcept
+            {
+                return e.storage().data();
+            }
+
+            template <class E = E1>
+            static std::enable_if_t<!bitset_source<E>::value, std::size_t> count(E& e) noexcept
+            {
+                return static_cast<std::size_t>(e.size());
+            }
+
+            template <class E = E1>
+            static std::enable_if_t<bitset_source<E>::value, std::size_t> count(E& e) noexcept
+            {
+                return static_cast<std::size_t>(e.storage().block_count());
+            }
+
+            template <class E = E1>
+            static std::enable_if_t<!bitset_source<E>::value> clear_tail(E&, std::size_t) noexcept
+            {
+            }
+
+            // the bits past the size in the last block must remain cleared
+            template <class E = E1>
+            static std::enable_if_t<bitset_source<E>::value> clear_tail(E& e, std::size_t size) noexcept
+            {
+                constexpr std::size_t block_size = 8 * sizeof(block_type);
+                std::size_t extra_bits = size % block_size;
+                if (extra_bits != 0)
+                {
+                    e.storage().data()[count(e) - 1] &= static_cast<block_type>((block_type(1) << extra_bits) - 1);
+                }
+            }
+        };
     }
 
     /**********************
@@ -198,6 +597,9 @@ namespace xt
     template <class E, XTENSOR_REQUIRE<is_xexpression<E>::value>>
     detail::flag_expression_t<E> has_value(E&&);
 
+    template <class E>
+    auto nan_optional(E&& e) noexcept;
+
     template <>
     class xexpression_assigner_base<xoptional_expression_tag>
     {
@@ -389,6 +791,35 @@ namespace xt
         };
     }
 
+    /**************************************************
+     * xfunction extension for NaN sentinel optionals *
+     **************************************************/
+
+    namespace extension
+    {
+        template <class T, class CT>
+        class xnan_sentinel_optional : public xoptional_empty_base<xfunction<xt::detail::nan_sentinel<T>, CT>>
+        {
+        public:
+
+            using expression_tag = xoptional_expression_tag;
+            using value_expression = const std::decay_t<CT>&;
+            using flag_expression = xfunction<xt::detail::nan_sentinel_flag<T>, const std::decay_t<CT>&>;
+            using const_value_expression = value_expression;
+            using const_flag_expression = flag_expression;
+
+            const_value_expression value() const;
+            const_flag_expression has_value() const;
+        };
+
+        // the function is an optional expression whatever the tag of its argument
+        template <class T, class CT>
+        struct xfunction_base<xt::detail::nan_sentinel<T>, CT>
+        {
+            using type = xnan_sentinel_optional<T, CT>;
+        };
+    }
+
     /****************************************************
      * xdynamic_view extension for optional expressions *
      ****************************************************/
@@ -831,6 +1262,25 @@ namespace xt
         }
     }
 
+    /*****************************************
+     * xnan_sentinel_optional implementation *
+     *****************************************/
+
+    namespace extension
+    {
+        template <class T, class CT>
+        inline auto xnan_sentinel_optional<T, CT>::value() const -> const_value_expression
+        {
+            return std::get<0>(this->derived_cast().arguments());
+        }
+
+        template <class T, class CT>
+        inline auto xnan_sentinel_optional<T, CT>::has_value() const -> const_flag_expression
+        {
+            return flag_expression(xt::detail::nan_sentinel_flag<T>(), std::get<0>(this->derived_cast().arguments()));
+        }
+    }
+
     /*****************************************
      * xdynamic_view_optional implementation *
      *****************************************/
@@ -1084,6 +1534,29 @@ namespace xt
         return detail::split_optional_expression<E>::has_value(std::forward<E>(e));
     }
 
+    /*******************************
+     * nan_optional implementation *
+     *******************************/
+
+    /**
+     * @brief Returns an optional expression whose elements are missing where
+     * the elements of \a e are NaN.
+     *
+     * Contrary to the optional assemblies, no flag is stored: \c has_value
+     * is computed on the fly and \c value returns \a e itself, so that the
+     * value expressions of missing-aware expressions and reducers are
+     * evaluated as regular, vectorized, expressions.
+     * @param e a floating point \ref xexpression
+     * @return an optional \ref xexpression
+     */
+    template <class E>
+    inline auto nan_optional(E&& e) noexcept
+    {
+        using value_type = typename std::decay_t<E>::value_type;
+        using functor_type = detail::nan_sentinel<value_type>;
+        return xfunction<functor_type, const_xclosure_t<E>>(functor_type(), std::forward<E>(e));
+    }
+
     template <class E1, class E2>
     inline void xexpression_assigner_base<xoptional_expression_tag>::assign_data(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial)
     {
@@ -1092,8 +1565,13 @@ namespace xt
 
         decltype(auto) bde1 = xt::value(de1);
         decltype(auto) hde1 = xt::has_value(de1);
+        decltype(auto) hde2 = xt::has_value(de2);
         xexpression_assigner_base<xtensor_expression_tag>::assign_data(bde1, xt::value(de2), trivial);
-        xexpression_assigner_base<xtensor_expression_tag>::assign_data(hde1, xt::has_value(de2), trivial);
+        using flag_assigner = detail::flag_assigner<std::decay_t<decltype(hde1)>, std::decay_t<decltype(hde2)>>;
+        if (!trivial || !flag_assigner::run(hde1, hde2))
+        {
+            xexpression_assigner_base<xtensor_expression_tag>::assign_data(hde1, hde2, trivial);
+        }
     }
 }
 
@@ -0,0 +1,726 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_PAD_HPP
+#define XTENSOR_PAD_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xarray.hpp"
+#include "xgenerator.hpp"
+#include "xmanipulation.hpp"
+#include "xnoalias.hpp"
+#include "xparallel.hpp"
+#include "xstrides.hpp"
+
+namespace xt
+{
+    /**
+     * @defgroup pad_functions Tiling, repetition and padding
+     *
+     * The expressions returned by tile, repeat and pad are lazy: their
+     * elements are computed from the elements of the input when they are
+     * accessed. When they are assigned to a container, the container is
+     * filled by copies of contiguous runs of the input, distributed between
+     * the threads when the parallel assignment is enabled.
+     */
+
+    /**
+     * How pad fills the elements before and after an axis.
+     * @ingroup pad_functions
+     */
+    enum class pad_mode
+    {
+        /// a constant value
+        constant,
+        /// the edge elements of the axis
+        edge,
+        /// the reflection of the axis, without repeating the edge elements
+        reflect,
+        /// the reflection of the axis, repeating the edge elements
+        symmetric,
+        /// the elements of the other end of the axis
+        wrap
+    };
+
+    namespace detail
+    {
+        using pad_shape = std::vector<std::size_t>;
+
+        // Calls f(index) for each index of shape in row major order, each
+        // call copying about size elements; the calls are distributed by
+        // ranges between the threads when the copy is large enough.
+        template <class F>
+        inline void for_each_block_index(const pad_shape& shape, std::size_t size, F&& f)
+        {
+            detail::shape_divider divider(shape);
+            std::size_t n = compute_size(shape);
+            auto run = [&](std::size_t first, std::size_t last)
+            {
+                pad_shape idx(shape.size());
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    divider.unravel(i, idx);
+                    f(idx);
+                }
+            };
+#if defined(XTENSOR_PARALLEL_ENABLED)
+            if (parallel::use_parallel(n * size))
+            {
+                parallel_for(std::size_t(0), n, parallel::grain(size, 1), run);
+                return;
+            }
+#endif
+            run(std::size_t(0), n);
+        }
+
+        inline pad_shape row_major_strides(const pad_shape& shape)
+        {
+            pad_shape strides(shape.size());
+            compute_strides(shape, layout_type::row_major, strides);
+            return strides;
+        }
+
+        // offset of the first dimensions of index in a row major buffer,
+        // shifted by before
+        inline std::size_t block_offset(const pad_shape& index, const pad_shape& strides,
+                                        const pad_shape* before = nullptr)
+        {
+            std::size_t offset = 0;
+            for (std::size_t i = 0; i < index.size(); ++i)
+            {
+                offset += (index[i] + (before != nullptr ? (*before)[i] : std::size_t(0))) * strides[i];
+            }
+            return offset;
+        }
+
+        // The elements of e in a row major buffer, e itself when it is one
+        template <class T, class E>
+        inline const T* row_major_data(const E& e, xarray<T, layout_type::row_major>& tmp, std::true_type)
+        {
+            if (is_row_major_buffer(e))
+            {
+                return e.data() + e.data_offset();
+            }
+            tmp = e;
+            return tmp.data();
+        }
+
+        template <class T, class E>
+        inline const T* row_major_data(const E& e, xarray<T, layout_type::row_major>& tmp, std::false_type)
+        {
+            tmp = e;
+            return tmp.data();
+        }
+
+        template <class T, class E>
+        inline const T* row_major_data(const E& e, xarray<T, layout_type::row_major>& tmp)
+        {
+            using direct = std::integral_constant<bool, has_data_interface<E>::value &&
+                                                        std::is_same<std::decay_t<typename E::value_type>, T>::value>;
+            return row_major_data(e, tmp, direct());
+        }
+
+        // Runs kernel(dst) on the storage of e when it is a row major buffer
+        // of T, on a temporary assigned to e afterwards otherwise
+        template <class T, class E, class K>
+        inline void assign_row_major(E& e, K&& kernel)
+        {
+            xtl::mpl::static_if<std::is_same<typename E::value_type, T>::value>([&](auto self)
+            {
+                if (is_row_major_buffer(self(e)))
+                {
+                    kernel(self(e).data() + self(e).data_offset());
+                    return;
+                }
+                auto tmp = xarray<T, layout_type::row_major>::from_shape(self(e).shape());
+                kernel(tmp.data());
+                noalias(self(e)) = tmp;
+            }, /*else*/ [&](auto self)
+            {
+                auto tmp = xarray<T, layout_type::row_major>::from_shape(self(e).shape());
+                kernel(tmp.data());
+                noalias(self(e)) = tmp;
+            });
+        }
+
+        // Maps the position x, relative to the first element of an axis of
+        // n elements, on the axis
+        inline std::size_t pad_source_index(std::ptrdiff_t x, std::size_t n, pad_mode mode) noexcept
+        {
+            std::ptrdiff_t sn = static_cast<std::ptrdiff_t>(n);
+            std::ptrdiff_t res = x;
+            switch (mode)
+            {
+                case pad_mode::edge:
+                    res = x < 0 ? 0 : (x >= sn ? sn - 1 : x);
+                    break;
+                case pad_mode::wrap:
+                    res = ((x % sn) + sn) % sn;
+                    break;
+                case pad_mode::symmetric:
+                    res = ((x % (2 * sn)) + 2 * sn) % (2 * sn);
+                    res = res < sn ? res : 2 * sn - 1 - res;
+                    break;
+                case pad_mode::reflect:
+                    if (sn == 1)
+                    {
+                        res = 0;
+                    }
+                    else
+                    {
+                        std::ptrdiff_t period = 2 * (sn - 1);
+                        res = ((x % period) + period) % period;
+                        res = res < sn ? res : period - res;
+                    }
+                    break;
+                case pad_mode::constant:
+                    break;
+            }
+            return static_cast<std::size_t>(res);
+        }
+
+        // Copies the index [first, last): the missing leading indices are
+        // zeros and the extra leading ones are dropped
+        template <class It>
+        inline dynamic_shape<std::size_t> trailing_index(It first, It last, std::size_t dim)
+        {
+            dynamic_shape<std::size_t> index;
+            for (; first != last; ++first)
+            {
+                index.push_back(static_cast<std::size_t>(*first));
+            }
+            dynamic_shape<std::size_t> res(dim, std::size_t(0));
+            std::size_t n = (std::min)(dim, index.size());
+            std::copy(index.end() - static_cast<std::ptrdiff_t>(n), index.end(), res.end() - static_cast<std::ptrdiff_t>(n));
+            return res;
+        }
+
+        /********************
+         * tile and kernels *
+         ********************/
+
+        // Writes the tiling of the row major buffer src of shape (padded with
+        // leading ones to the dimension of reps) in dst: the rows of src are
+        // copied and repeated along the last axis, then the blocks of each
+        // axis, from the last one to the first one, are repeated after
+        // themselves.
+        template <class T>
+        inline void tile_kernel(const T* src, const pad_shape& shape, const pad_shape& reps, T* dst)
+        {
+            std::size_t dim = shape.size();
+            if (dim == 0)
+            {
+                *dst = *src;
+                return;
+            }
+            pad_shape res_shape(dim);
+            for (std::size_t i = 0; i < dim; ++i)
+            {
+                res_shape[i] = shape[i] * reps[i];
+            }
+            if (compute_size(res_shape) == 0)
+            {
+                return;
+            }
+            pad_shape src_strides = row_major_strides(shape);
+            pad_shape dst_strides = row_major_strides(res_shape);
+
+            std::size_t row = shape[dim - 1];
+            pad_shape rows(shape.begin(), shape.end() - 1);
+            for_each_block_index(rows, row * reps[dim - 1], [&](const pad_shape& idx)
+            {
+                const T* s = src + block_offset(idx, src_strides);
+                T* d = dst + block_offset(idx, dst_strides);
+                std::copy(s, s + row, d);
+                for (std::size_t r = 1; r < reps[dim - 1]; ++r)
+                {
+                    std::copy(d, d + row, d + r * row);
+                }
+            });
+
+            for (std::size_t k = dim - 1; k != 0; --k)
+            {
+                std::size_t axis = k - 1;
+                std::size_t block = shape[axis] * dst_strides[axis];
+                pad_shape outer(shape.begin(), shape.begin() + static_cast<std::ptrdiff_t>(axis));
+                for_each_block_index(outer, block * (reps[axis] - 1), [&](const pad_shape& idx)
+                {
+                    T* d = dst + block_offset(idx, dst_strides);
+                    for (std::size_t r = 1; r < reps[axis]; ++r)
+                    {
+                        std::copy(d, d + block, d + r * block);
+                    }
+                });
+            }
+        }
+
+        template <class CT>
+        class tile_impl
+        {
+        public:
+
+            using size_type = std::size_t;
+            using value_type = std::decay_t<typename std::decay_t<CT>::value_type>;
+
+            tile_impl(CT e, pad_shape shape, pad_shape reps)
+                : m_e(std::forward<CT>(e)), m_shape(std::move(shape)), m_reps(std::move(reps))
+            {
+            }
+
+            template <class... Args>
+            value_type operator()(Args... args) const
+            {
+                std::array<size_type, sizeof...(Args)> idx = {static_cast<size_type>(args)...};
+                return element(idx.cbegin(), idx.cend());
+            }
+
+            template <class It>
+            value_type element(It first, It last) const
+            {
+                std::size_t dim = m_shape.size();
+                std::size_t offset = dim - m_e.dimension();
+                dynamic_shape<size_type> index = trailing_index(first, last, dim);
+                dynamic_shape<size_type> src(index.cbegin() + static_cast<std::ptrdiff_t>(offset), index.cend());
+                for (std::size_t i = 0; i < src.size(); ++i)
+                {
+                    src[i] %= m_shape[offset + i];
+                }
+                return m_e.element(src.cbegin(), src.cend());
+            }
+
+            template <class E>
+            void assign_to(xexpression<E>& e) const
+            {
+                xarray<value_type, layout_type::row_major> tmp;
+                const value_type* src = row_major_data<value_type>(m_e, tmp);
+                assign_row_major<value_type>(e.derived_cast(), [&](value_type* dst)
+                {
+                    tile_kernel(src, m_shape, m_reps, dst);
+                });
+            }
+
+        private:
+
+            CT m_e;
+            pad_shape m_shape;
+            pad_shape m_reps;
+        };
+
+        /**********************
+         * repeat and kernels *
+         **********************/
+
+        // Writes the repetition of the row major buffer src along axis in
+        // dst, offsets[i] being the position of the first copy of the i-th
+        // element along axis; each element along axis is the copy of a
+        // contiguous block of the elements after axis.
+        template <class T>
+        inline void repeat_kernel(const T* src, const pad_shape& shape, const pad_shape& offsets,
+                                  std::size_t axis, T* dst)
+        {
+            std::size_t outer = 1;
+            for (std::size_t i = 0; i < axis; ++i)
+            {
+                outer *= shape[i];
+            }
+            std::size_t inner = 1;
+            for (std::size_t i = axis + 1; i < shape.size(); ++i)
+            {
+                inner *= shape[i];
+            }
+            std::size_t n = shape[axis];
+            std::size_t line = offsets[n] * inner;
+            std::size_t average = n != 0 ? line / n : std::size_t(0);
+            for_each_block_index(pad_shape({outer, n}), average, [&](const pad_shape& idx)
+            {
+                const T* s = src + (idx[0] * n + idx[1]) * inner;
+                T* d = dst + idx[0] * line + offsets[idx[1]] * inner;
+                std::size_t count = offsets[idx[1] + 1] - offsets[idx[1]];
+                if (inner == 1)
+                {
+                    std::fill_n(d, count, *s);
+                }
+                else
+                {
+                    for (std::size_t c = 0; c < count; ++c)
+                    {
+                        std::copy(s, s + inner, d + c * inner);
+                    }
+                }
+            });
+        }
+
+        template <class CT>
+        class repeat_elements_impl
+        {
+        public:
+
+            using size_type = std::size_t;
+            using value_type = std::decay_t<typename std::decay_t<CT>::value_type>;
+
+            repeat_elements_impl(CT e, pad_shape shape, pad_shape offsets, std::size_t axis)
+                : m_e(std::forward<CT>(e)), m_shape(std::move(shape)), m_offsets(std::move(offsets)), m_axis(axis)
+            {
+            }
+
+            template <class... Args>
+            value_type operator()(Args... args) const
+            {
+                std::array<size_type, sizeof...(Args)> idx = {static_cast<size_type>(args)...};
+                return element(idx.cbegin(), idx.cend());
+            }
+
+            template <class It>
+            value_type element(It first, It last) const
+            {
+                dynamic_shape<size_type> src = trailing_index(first, last, m_shape.size());
+                // the last position whose first copy is before the index
+                auto it = std::upper_bound(m_offsets.cbegin(), m_offsets.cend(), src[m_axis]);
+                src[m_axis] = static_cast<size_type>(it - m_offsets.cbegin()) - 1;
+                return m_e.element(src.cbegin(), src.cend());
+            }
+
+            template <class E>
+            void assign_to(xexpression<E>& e) const
+            {
+                xarray<value_type, layout_type::row_major> tmp;
+                const value_type* src = row_major_data<value_type>(m_e, tmp);
+                assign_row_major<value_type>(e.derived_cast(), [&](value_type* dst)
+                {
+                    repeat_kernel(src, m_shape, m_offsets, m_axis, dst);
+                });
+            }
+
+        private:
+
+            CT m_e;
+            pad_shape m_shape;
+            pad_shape m_offsets;
+            std::size_t m_axis;
+        };
+
+        /*******************
+         * pad and kernels *
+         *******************/
+
+        // Writes the padding of the row major buffer src in dst: the rows of
+        // src are copied inside dst, then the elements before and after each
+        // axis, from the last one to the first one, are filled by blocks of
+        // the elements after the axis. When an axis is padded, the positions
+        // of the previous axes are the inner ones and the next axes are
+        // already padded, the blocks are copies of inner blocks.
+        template <class T>
+        inline void pad_kernel(const T* src, const pad_shape& shape, const pad_shape& before,
+                               const pad_shape& after, pad_mode mode, const T& value, T* dst)
+        {
+            std::size_t dim = shape.size();
+            if (dim == 0)
+            {
+                *dst = *src;
+                return;
+            }
+            pad_shape res_shape(dim);
+            for (std::size_t i = 0; i < dim; ++i)
+            {
+                res_shape[i] = before[i] + shape[i] + after[i];
+            }
+            if (compute_size(res_shape) == 0)
+            {
+                return;
+            }
+            pad_shape src_strides = row_major_strides(shape);
+            pad_shape dst_strides = row_major_strides(res_shape);
+
+            std::size_t row = shape[dim - 1];
+            pad_shape rows(shape.begin(), shape.end() - 1);
+            if (row != 0)
+            {
+                for_each_block_index(rows, row, [&](const pad_shape& idx)
+                {
+                    const T* s = src + block_offset(idx, src_strides);
+                    std::copy(s, s + row, dst + block_offset(idx, dst_strides, &before) + before[dim - 1]);
+                });
+            }
+
+            for (std::size_t k = dim; k != 0; --k)
+            {
+                std::size_t axis = k - 1;
+                std::size_t n = shape[axis];
+                std::size_t block = dst_strides[axis];
+                std::size_t padded = before[axis] + after[axis];
+                if (padded == 0)
+                {
+                    continue;
+                }
+                pad_shape outer(shape.begin(), shape.begin() + static_cast<std::ptrdiff_t>(axis));
+                for_each_block_index(outer, padded * block, [&](const pad_shape& idx)
+                {
+                    T* d = dst + block_offset(idx, dst_strides, &before);
+                    for (std::size_t p = 0; p < res_shape[axis]; ++p)
+                    {
+                        if (n != 0 && p == before[axis])
+                        {
+                            p += n - 1;
+                            continue;
+                        }
+                        T* target = d + p * block;
+                        if (mode == pad_mode::constant)
+                        {
+                            std::fill_n(target, block, value);
+                        }
+                        else
+                        {
+                            std::ptrdiff_t x = static_cast<std::ptrdiff_t>(p) - static_cast<std::ptrdiff_t>(before[axis]);
+                            const T* s = d + (before[axis] + pad_source_index(x, n, mode)) * block;
+                            std::copy(s, s + block, target);
+                        }
+                    }
+                });
+            }
+        }
+
+        template <class CT>
+        class pad_impl
+        {
+        public:
+
+            using size_type = std::size_t;
+            using value_type = std::decay_t<typename std::decay_t<CT>::value_type>;
+
+            pad_impl(CT e, pad_shape shape, pad_shape before, pad_shape after, pad_mode mode, value_type value)
+                : m_e(std::forward<CT>(e)), m_shape(std::move(shape)), m_before(std::move(before)), m_after(std::move(after)),
+                  m_mode(mode), m_value(value)
+            {
+            }
+
+            template <class... Args>
+            value_type operator()(Args... args) const
+            {
+                std::array<size_type, sizeof...(Args)> idx = {static_cast<size_type>(args)...};
+                return element(idx.cbegin(), idx.cend());
+            }
+
+            template <class It>
+            value_type element(It first, It last) const
+            {
+                dynamic_shape<size_type> src = trailing_index(first, last, m_shape.size());
+                for (std::size_t axis = 0; axis < src.size(); ++axis)
+                {
+                    std::ptrdiff_t x = static_cast<std::ptrdiff_t>(src[axis]) - static_cast<std::ptrdiff_t>(m_before[axis]);
+                    if (x < 0 || x >= static_cast<std::ptrdiff_t>(m_shape[axis]))
+                    {
+                        if (m_mode == pad_mode::constant)
+                        {
+                            return m_value;
+                        }
+                        src[axis] = pad_source_index(x, m_shape[axis], m_mode);
+                    }
+                    else
+                    {
+                        src[axis] = static_cast<size_type>(x);
+                    }
+                }
+                return m_e.element(src.cbegin(), src.cend());
+            }
+
+            template <class E>
+            void assign_to(xexpression<E>& e) const
+            {
+                xarray<value_type, layout_type::row_major> tmp;
+                const value_type* src = row_major_data<value_type>(m_e, tmp);
+                assign_row_major<value_type>(e.derived_cast(), [&](value_type* dst)
+                {
+                    pad_kernel(src, m_shape, m_before, m_after, m_mode, m_value, dst);
+                });
+            }
+
+        private:
+
+            CT m_e;
+            pad_shape m_shape;
+            pad_shape m_before;
+            pad_shape m_after;
+            pad_mode m_mode;
+            value_type m_value;
+        };
+
+        template <class E>
+        inline pad_shape expression_shape(const E& e)
+        {
+            return pad_shape(e.shape().cbegin(), e.shape().cend());
+        }
+    }
+
+    /**
+     * @ingroup pad_functions
+     * @brief Constructs an expression by repeating an expression, as numpy.tile.
+     *
+     * The result has max(e.dimension(), reps.size()) dimensions: the shape
+     * of the expression or reps is prepended with ones. The dimension i of
+     * the result is the dimension i of the expression repeated reps[i] times.
+     *
+     * \code{.cpp}
+     * xt::xarray<int> a = {{1, 2}, {3, 4}};
+     * xt::xarray<int> t = xt::tile(a, {2, 3});
+     * // => t = {{1, 2, 1, 2, 1, 2}, {3, 4, 3, 4, 3, 4}, {1, 2, 1, 2, 1, 2}, {3, 4, 3, 4, 3, 4}}
+     * \endcode
+     *
+     * @param e the input expression
+     * @param reps the number of repetitions along each axis
+     * @return a lazy expression, whose assignment to a container copies runs of the input
+     */
+    template <class E>
+    inline auto tile(E&& e, const std::vector<std::size_t>& reps)
+    {
+        detail::pad_shape shape = detail::expression_shape(e);
+        std::size_t dim = (std::max)(shape.size(), reps.size());
+        shape.insert(shape.begin(), dim - shape.size(), std::size_t(1));
+        detail::pad_shape padded_reps(dim - reps.size(), std::size_t(1));
+        padded_reps.insert(padded_reps.end(), reps.cbegin(), reps.cend());
+
+        dynamic_shape<std::size_t> res_shape(dim);
+        for (std::size_t i = 0; i < dim; ++i)
+        {
+            res_shape[i] = shape[i] * padded_reps[i];
+        }
+        using functor_type = detail::tile_impl<const_xclosure_t<E>>;
+        return detail::make_xgenerator(functor_type(std::forward<E>(e), std::move(shape), std::move(padded_reps)),
+                                       std::move(res_shape));
+    }
+
+    /**
+     * @ingroup pad_functions
+     * @brief Repeats the elements of an expression along an axis, as numpy.repeat.
+     *
+     * \code{.cpp}
+     * xt::xarray<int> a = {{1, 2}, {3, 4}};
+     * xt::xarray<int> r = xt::repeat(a, {1, 2}, 0);
+     * // => r = {{1, 2}, {3, 4}, {3, 4}}
+     * \endcode
+     *
+     * @param e the input expression
+     * @param repeats the number of repetitions of each element along axis,
+     *        or a single number of repetitions for all the elements
+     * @param axis the axis along which the elements are repeated
+     * @return a lazy expression, whose assignment to a container copies runs of the input
+     */
+    template <class E>
+    inline auto repeat(E&& e, const std::vector<std::size_t>& repeats, std::size_t axis)
+    {
+        detail::pad_shape shape = detail::expression_shape(e);
+        if (axis >= shape.size())
+        {
+            throw std::runtime_error("repeat: axis out of bounds");
+        }
+        if (repeats.size() != shape[axis] && repeats.size() != 1)
+        {
+            throw std::runtime_error("repeat: the number of repeats must be one or the size of the axis");
+        }
+        detail::pad_shape offsets(shape[axis] + 1, std::size_t(0));
+        for (std::size_t i = 0; i < shape[axis]; ++i)
+        {
+            offsets[i + 1] = offsets[i] + repeats[repeats.size() == 1 ? 0 : i];
+        }
+
+        dynamic_shape<std::size_t> res_shape(shape.cbegin(), shape.cend());
+        res_shape[axis] = offsets.back();
+        using functor_type = detail::repeat_elements_impl<const_xclosure_t<E>>;
+        return detail::make_xgenerator(functor_type(std::forward<E>(e), std::move(shape), std::move(offsets), axis),
+                                       std::move(res_shape));
+    }
+
+    /**
+     * @ingroup pad_functions
+     * @brief Repeats the elements of an expression along an axis, as numpy.repeat.
+     *
+     * @param e the input expression
+     * @param repeats the number of repetitions of each element along axis
+     * @param axis the axis along which the elements are repeated
+     * @return a lazy expression, whose assignment to a container copies runs of the input
+     */
+    template <class E>
+    inline auto repeat(E&& e, std::size_t repeats, std::size_t axis)
+    {
+        return repeat(std::forward<E>(e), std::vector<std::size_t>({repeats}), axis);
+    }
+
+    /**
+     * @ingroup pad_functions
+     * @brief Pads an expression, as numpy.pad.
+     *
+     * pad_width[i] holds the numbers of elements added before and after the
+     * axis i; a single pair pads all the axes.
+     *
+     * \code{.cpp}
+     * xt::xarray<int> a = {{1, 2}, {3, 4}};
+     * xt::xarray<int> p = xt::pad(a, {{1, 0}, {0, 2}}, xt::pad_mode::edge);
+     * // => p = {{1, 2, 2, 2}, {1, 2, 2, 2}, {3, 4, 4, 4}}
+     * \endcode
+     *
+     * @param e the input expression
+     * @param pad_width the numbers of elements added before and after each axis
+     * @param mode how the added elements are filled
+     * @param constant_value the value of the added elements in pad_mode::constant
+     * @return a lazy expression, whose assignment to a container copies runs of the input
+     */
+    template <class E, class V = std::decay_t<typename std::decay_t<E>::value_type>>
+    inline auto pad(E&& e, const std::vector<std::array<std::size_t, 2>>& pad_width,
+                    pad_mode mode = pad_mode::constant, V constant_value = V(0))
+    {
+        detail::pad_shape shape = detail::expression_shape(e);
+        std::size_t dim = shape.size();
+        if (pad_width.size() != dim && pad_width.size() != 1)
+        {
+            throw std::runtime_error("pad: the number of pad widths must be one or the dimension of the expression");
+        }
+        detail::pad_shape before(dim), after(dim);
+        dynamic_shape<std::size_t> res_shape(dim);
+        for (std::size_t i = 0; i < dim; ++i)
+        {
+            const auto& width = pad_width[pad_width.size() == 1 ? 0 : i];
+            before[i] = width[0];
+            after[i] = width[1];
+            if (mode != pad_mode::constant && shape[i] == 0 && width[0] + width[1] != 0)
+            {
+                throw std::runtime_error("pad: can't extend an empty axis in a mode other than constant");
+            }
+            res_shape[i] = width[0] + shape[i] + width[1];
+        }
+        using functor_type = detail::pad_impl<const_xclosure_t<E>>;
+        using value_type = typename functor_type::value_type;
+        return detail::make_xgenerator(functor_type(std::forward<E>(e), std::move(shape), std::move(before), std::move(after),
+                                                    mode, static_cast<value_type>(constant_value)),
+                                       std::move(res_shape));
+    }
+
+    /**
+     * @ingroup pad_functions
+     * @brief Pads all the axes of an expression by the same number of elements on both sides.
+     *
+     * @param e the input expression
+     * @param pad_width the number of elements added before and after each axis
+     * @param mode how the added elements are filled
+     * @param constant_value the value of the added elements in pad_mode::constant
+     * @return a lazy expression, whose assignment to a container copies runs of the input
+     */
+    template <class E, class V = std::decay_t<typename std::decay_t<E>::value_type>>
+    inline auto pad(E&& e, std::size_t pad_width, pad_mode mode = pad_mode::constant, V constant_value = V(0))
+    {
+        std::array<std::size_t, 2> width = {pad_width, pad_width};
+        return pad(std::forward<E>(e), std::vector<std::array<std::size_t, 2>>(1, width), mode, constant_value);
+    }
+}
+
+#endif
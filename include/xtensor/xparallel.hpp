@@ -0,0 +1,555 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_PARALLEL_HPP
+#define XTENSOR_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+
+#include "xdispatch.hpp"
+#include "xtensor_config.hpp"
+
+#if defined(XTENSOR_USE_TBB)
+#include <tbb/tbb.h>
+#endif
+
+#if defined(XTENSOR_USE_OPENMP)
+#include <omp.h>
+#endif
+
+namespace xt
+{
+
+    /*******************
+     * parallel_policy *
+     *******************/
+
+    /**
+     * Parallel backends available to the assignment machinery. Each backend
+     * exposes a static ``run(first, last, grain, f)`` method which splits the
+     * range [first, last) into chunks of at least ``grain`` elements and calls
+     * ``f(chunk_first, chunk_last)`` on each chunk, possibly concurrently.
+     */
+    namespace parallel_policy
+    {
+        struct serial
+        {
+            template <class F>
+            static void run(std::size_t first, std::size_t last, std::size_t grain, F&& f);
+        };
+
+#if defined(XTENSOR_USE_TBB)
+        struct tbb
+        {
+            template <class F>
+            static void run(std::size_t first, std::size_t last, std::size_t grain, F&& f);
+        };
+#endif
+
+#if defined(XTENSOR_USE_OPENMP)
+        struct openmp
+        {
+            template <class F>
+            static void run(std::size_t first, std::size_t last, std::size_t grain, F&& f);
+        };
+#endif
+
+        struct executor
+        {
+            template <class F>
+            static void run(std::size_t first, std::size_t last, std::size_t grain, F&& f);
+        };
+    }
+
+#if defined(XTENSOR_USE_TBB)
+    using default_parallel_policy = parallel_policy::tbb;
+#elif defined(XTENSOR_USE_OPENMP)
+    using default_parallel_policy = parallel_policy::openmp;
+#else
+    using default_parallel_policy = parallel_policy::serial;
+#endif
+
+    /***********************
+     * user-given executor *
+     ***********************/
+
+    namespace parallel
+    {
+        using body_type = std::function<void(std::size_t, std::size_t)>;
+        using executor_type = std::function<void(std::size_t, std::size_t, std::size_t, const body_type&)>;
+
+        std::shared_ptr<const executor_type> executor();
+        void set_executor(executor_type ex);
+        void reset_executor();
+        bool has_executor();
+
+        using task_type = std::function<void()>;
+        using launcher_type = std::function<void(task_type)>;
+
+        std::shared_ptr<const launcher_type> launcher();
+        void set_launcher(launcher_type l);
+        void reset_launcher();
+        void launch(task_type task);
+    }
+
+    /*********************
+     * parallel settings *
+     *********************/
+
+    namespace parallel
+    {
+        struct settings_type
+        {
+            std::size_t min_size;
+            std::size_t grain_size;
+        };
+
+        settings_type settings();
+        void set_min_size(std::size_t min_size);
+        void set_grain_size(std::size_t grain_size);
+
+        bool use_parallel(std::size_t size);
+        std::size_t grain(std::size_t item_size, std::size_t alignment = 1);
+        bool in_parallel_region();
+
+        /**
+         * Overrides the parallel settings of the calling thread for the
+         * lifetime of the object; the settings of the enclosing guard, or
+         * the global ones, apply again upon destruction. The global settings
+         * and the other threads are not affected, so that guards can be used
+         * concurrently by several threads.
+         */
+        class scoped_settings
+        {
+        public:
+
+            scoped_settings(std::size_t min_size, std::size_t grain_size);
+            ~scoped_settings();
+
+            scoped_settings(const scoped_settings&) = delete;
+            scoped_settings& operator=(const scoped_settings&) = delete;
+
+        private:
+
+            settings_type m_settings;
+            const settings_type* m_previous;
+        };
+    }
+
+    template <class F>
+    void parallel_for(std::size_t first, std::size_t last, std::size_t grain, F&& f);
+
+    /**********************************
+     * parallel_policy implementation *
+     **********************************/
+
+    namespace parallel_policy
+    {
+        template <class F>
+        inline void serial::run(std::size_t first, std::size_t last, std::size_t /*grain*/, F&& f)
+        {
+            if (first < last)
+            {
+                f(first, last);
+            }
+        }
+
+#if defined(XTENSOR_USE_TBB)
+        template <class F>
+        inline void tbb::run(std::size_t first, std::size_t last, std::size_t grain, F&& f)
+        {
+            // Assignment loops have a uniform cost per element, a static
+            // partition avoids the stealing overhead of the auto partitioner
+            ::tbb::parallel_for(::tbb::blocked_range<std::size_t>(first, last, std::max(grain, std::size_t(1))),
+                                [&f](const ::tbb::blocked_range<std::size_t>& r)
+            {
+                f(r.begin(), r.end());
+            }
+#if TBB_INTERFACE_VERSION >= 9100
+            , ::tbb::static_partitioner()
+#endif
+            );
+        }
+#endif
+
+#if defined(XTENSOR_USE_OPENMP)
+        template <class F>
+        inline void openmp::run(std::size_t first, std::size_t last, std::size_t grain, F&& f)
+        {
+            if (first >= last)
+            {
+                return;
+            }
+            std::size_t n = last - first;
+            std::size_t nthreads = static_cast<std::size_t>(omp_get_max_threads());
+            grain = std::max(grain, std::size_t(1));
+            // chunks are a multiple of the grain so that alignment
+            // constraints expressed through the grain are preserved
+            std::size_t chunk = std::max(grain, (n + nthreads - 1) / nthreads);
+            chunk = ((chunk + grain - 1) / grain) * grain;
+            std::ptrdiff_t nchunks = static_cast<std::ptrdiff_t>((n + chunk - 1) / chunk);
+            // an exception must not leave the parallel region, the first one
+            // is rethrown once all the chunks are done
+            std::exception_ptr error;
+#pragma omp parallel for schedule(static)
+            for (std::ptrdiff_t c = 0; c < nchunks; ++c)
+            {
+                try
+                {
+                    std::size_t chunk_first = first + static_cast<std::size_t>(c) * chunk;
+                    f(chunk_first, std::min(chunk_first + chunk, last));
+                }
+                catch (...)
+                {
+#pragma omp critical(xtensor_parallel_error)
+                    {
+                        if (!error)
+                        {
+                            error = std::current_exception();
+                        }
+                    }
+                }
+            }
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+#endif
+
+        template <class F>
+        inline void executor::run(std::size_t first, std::size_t last, std::size_t grain, F&& f)
+        {
+            if (first >= last)
+            {
+                return;
+            }
+            std::shared_ptr<const parallel::executor_type> ex = parallel::executor();
+            if (ex)
+            {
+                parallel::body_type body = [&f](std::size_t chunk_first, std::size_t chunk_last)
+                {
+                    f(chunk_first, chunk_last);
+                };
+                (*ex)(first, last, std::max(grain, std::size_t(1)), body);
+            }
+            else
+            {
+                default_parallel_policy::run(first, last, grain, std::forward<F>(f));
+            }
+        }
+    }
+
+    /**************************************
+     * user-given executor implementation *
+     **************************************/
+
+    namespace parallel
+    {
+        namespace detail
+        {
+            // The executor and the launcher are shared with the loops and the
+            // asynchronous evaluations running when they are replaced, which
+            // keep using the previous ones until they complete
+            inline std::shared_ptr<const executor_type>& executor_slot()
+            {
+                static std::shared_ptr<const executor_type> ex;
+                return ex;
+            }
+
+            inline std::shared_ptr<const launcher_type>& launcher_slot()
+            {
+                static std::shared_ptr<const launcher_type> l;
+                return l;
+            }
+        }
+
+        /**
+         * Returns the executor installed with set_executor, if any.
+         */
+        inline std::shared_ptr<const executor_type> executor()
+        {
+            return std::atomic_load(&detail::executor_slot());
+        }
+
+        /**
+         * Installs a user-given executor, for instance to run the parallel
+         * assignment loops on a thread pool owned by the application. The
+         * executor is called with (first, last, grain, body), and must call
+         * body(chunk_first, chunk_last) on chunks covering [first, last)
+         * exactly once before returning. Chunks may be executed concurrently.
+         * It can be replaced while other threads run parallel loops.
+         */
+        inline void set_executor(executor_type ex)
+        {
+            std::shared_ptr<const executor_type> p;
+            if (ex)
+            {
+                p = std::make_shared<const executor_type>(std::move(ex));
+            }
+            std::atomic_store(&detail::executor_slot(), std::move(p));
+        }
+
+        /**
+         * Removes the user-given executor, the default backend is used again.
+         */
+        inline void reset_executor()
+        {
+            set_executor(executor_type());
+        }
+
+        inline bool has_executor()
+        {
+            return executor() != nullptr;
+        }
+
+        /**
+         * Returns the launcher installed with set_launcher, if any.
+         */
+        inline std::shared_ptr<const launcher_type> launcher()
+        {
+            return std::atomic_load(&detail::launcher_slot());
+        }
+
+        /**
+         * Installs a user-given launcher of the asynchronous evaluations,
+         * for instance to post them to the event loop or the thread pool of
+         * the application. The launcher is called with a task that it must
+         * run exactly once, on any thread. It can be replaced while other
+         * threads start asynchronous evaluations.
+         */
+        inline void set_launcher(launcher_type l)
+        {
+            std::shared_ptr<const launcher_type> p;
+            if (l)
+            {
+                p = std::make_shared<const launcher_type>(std::move(l));
+            }
+            std::atomic_store(&detail::launcher_slot(), std::move(p));
+        }
+
+        /**
+         * Removes the user-given launcher, the default one is used again.
+         */
+        inline void reset_launcher()
+        {
+            set_launcher(launcher_type());
+        }
+
+        /**
+         * Runs the task asynchronously: with the user-given launcher if one
+         * is installed, in the task arena of TBB if XTENSOR_USE_TBB is
+         * defined, and in a new detached thread otherwise.
+         */
+        inline void launch(task_type task)
+        {
+            std::shared_ptr<const launcher_type> l = launcher();
+            if (l)
+            {
+                (*l)(std::move(task));
+            }
+            else
+            {
+#if defined(XTENSOR_USE_TBB)
+                static ::tbb::task_arena arena;
+                arena.enqueue(std::move(task));
+#else
+                std::thread(std::move(task)).detach();
+#endif
+            }
+        }
+    }
+
+    /************************************
+     * parallel settings implementation *
+     ************************************/
+
+    namespace parallel
+    {
+        namespace detail
+        {
+            struct global_settings_type
+            {
+                std::atomic<std::size_t> min_size;
+                std::atomic<std::size_t> grain_size;
+            };
+
+            inline global_settings_type& global_settings()
+            {
+                static global_settings_type s = { {XTENSOR_PARALLEL_MIN_SIZE}, {XTENSOR_PARALLEL_GRAIN_SIZE} };
+                return s;
+            }
+
+            // settings of the innermost scoped_settings of the calling thread
+            inline const settings_type*& settings_override()
+            {
+                static thread_local const settings_type* p = nullptr;
+                return p;
+            }
+        }
+
+        /**
+         * Returns the parallel settings of the calling thread: assignments
+         * of less than \c min_size elements run serially, and chunks hold at
+         * least \c grain_size elements (0 lets the backend decide). These are
+         * the settings of the innermost scoped_settings of the thread if any,
+         * the global settings otherwise, whose defaults are given by
+         * XTENSOR_PARALLEL_MIN_SIZE and XTENSOR_PARALLEL_GRAIN_SIZE.
+         */
+        inline settings_type settings()
+        {
+            const settings_type* local = detail::settings_override();
+            if (local != nullptr)
+            {
+                return *local;
+            }
+            const detail::global_settings_type& global = detail::global_settings();
+            return { global.min_size.load(std::memory_order_relaxed), global.grain_size.load(std::memory_order_relaxed) };
+        }
+
+        /**
+         * Changes the global minimal size of the parallel assignments; it can
+         * be called concurrently with running assignments.
+         */
+        inline void set_min_size(std::size_t min_size)
+        {
+            detail::global_settings().min_size.store(min_size, std::memory_order_relaxed);
+        }
+
+        /**
+         * Changes the global grain size of the parallel assignments; it can
+         * be called concurrently with running assignments.
+         */
+        inline void set_grain_size(std::size_t grain_size)
+        {
+            detail::global_settings().grain_size.store(grain_size, std::memory_order_relaxed);
+        }
+
+        /**
+         * Returns true if an assignment of \c size elements should
+         * be parallelized according to the current settings.
+         */
+        inline bool use_parallel(std::size_t size)
+        {
+            return size != 0 && size >= settings().min_size;
+        }
+
+        /**
+         * Converts the grain size of the current settings, expressed in elements,
+         * into a number of items of \c item_size elements, rounded up to a
+         * multiple of \c alignment items.
+         */
+        inline std::size_t grain(std::size_t item_size, std::size_t alignment)
+        {
+            item_size = std::max(item_size, std::size_t(1));
+            alignment = std::max(alignment, std::size_t(1));
+            std::size_t g = (settings().grain_size + item_size - 1) / item_size;
+            return std::max(((g + alignment - 1) / alignment) * alignment, alignment);
+        }
+
+        namespace detail
+        {
+            inline bool& parallel_region_flag()
+            {
+                static thread_local bool flag = false;
+                return flag;
+            }
+
+            class parallel_region_guard
+            {
+            public:
+
+                parallel_region_guard()
+                    : m_previous(parallel_region_flag())
+                {
+                    parallel_region_flag() = true;
+                }
+
+                ~parallel_region_guard()
+                {
+                    parallel_region_flag() = m_previous;
+                }
+
+                parallel_region_guard(const parallel_region_guard&) = delete;
+                parallel_region_guard& operator=(const parallel_region_guard&) = delete;
+
+            private:
+
+                bool m_previous;
+            };
+        }
+
+        /**
+         * Returns true if the calling thread is running a chunk of a
+         * parallel_for; nested parallel_for are run serially.
+         */
+        inline bool in_parallel_region()
+        {
+            return detail::parallel_region_flag();
+        }
+
+        inline scoped_settings::scoped_settings(std::size_t min_size, std::size_t grain_size)
+            : m_settings{ min_size, grain_size }, m_previous(detail::settings_override())
+        {
+            detail::settings_override() = &m_settings;
+        }
+
+        inline scoped_settings::~scoped_settings()
+        {
+            detail::settings_override() = m_previous;
+        }
+    }
+
+    /*******************************
+     * parallel_for implementation *
+     *******************************/
+
+    /**
+     * Splits the range [first, last) into chunks of at least \c grain elements
+     * and calls \c f(chunk_first, chunk_last) on each of them. The user-given
+     * executor is used if one is installed, otherwise the work is dispatched to
+     * the default backend (TBB if XTENSOR_USE_TBB is defined, OpenMP if
+     * XTENSOR_USE_OPENMP is defined, serial otherwise). When called from a chunk
+     * of another parallel_for, the whole range is processed serially by the
+     * calling thread, which avoids oversubscription and deadlocks on thread
+     * pools that do not support nested parallelism.
+     * @param first the beginning of the range
+     * @param last the end of the range
+     * @param grain the minimal number of elements in a chunk
+     * @param f the function to call on each chunk
+     */
+    template <class F>
+    inline void parallel_for(std::size_t first, std::size_t last, std::size_t grain, F&& f)
+    {
+        if (parallel::in_parallel_region())
+        {
+            parallel_policy::serial::run(first, last, grain, std::forward<F>(f));
+        }
+        else
+        {
+            // the chunks run the dispatched kernels of the instruction set
+            // selected by the calling thread, scoped_isa included
+            cpu::isa selected = cpu::selected_isa();
+            parallel_policy::executor::run(first, last, grain, [&f, selected](std::size_t chunk_first, std::size_t chunk_last)
+            {
+                parallel::detail::parallel_region_guard guard;
+                cpu::scoped_isa isa_guard(selected);
+                f(chunk_first, chunk_last);
+            });
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,248 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_PROFILE_HPP
+#define XTENSOR_PROFILE_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "xinstrument.hpp"
+
+namespace xt
+{
+
+    /*****************
+     * profile_scope *
+     *****************/
+
+    /**
+     * @class profile_scope
+     * @brief Aggregates the instrumentation events per expression.
+     *
+     * While a profile_scope is alive, the assignments and the reductions are
+     * aggregated per expression type and per path taken: number of calls,
+     * total time, elements processed and bytes moved. The path of an
+     * assignment is the first assignment loop that ran under it (linear,
+     * strided loop or stepper); an assignment completed by a specialized
+     * path (unrolled, transposed, conversion, ...) keeps its own kind. The
+     * report, sorted by decreasing total time, is printed when the scope
+     * ends. The time of an assignment nested in another one, for instance
+     * the evaluation of the argument of an immediate reduction, is also
+     * counted in the enclosing one.
+     *
+     * The events are only emitted when XTENSOR_ENABLE_INSTRUMENTATION is
+     * defined; the callbacks installed before the scope are still called,
+     * and are restored upon destruction. Profile scopes may be nested, but
+     * must be destroyed in the reverse order of their construction.
+     */
+    class profile_scope
+    {
+    public:
+
+        using event_kind = instrument::event_kind;
+
+        struct entry
+        {
+            std::string expression;
+            event_kind path;
+            std::size_t count;
+            std::size_t elements;
+            std::size_t bytes;
+            std::chrono::nanoseconds elapsed;
+
+            double gigabytes_per_second() const noexcept;
+        };
+
+        explicit profile_scope(std::ostream& out = std::clog);
+        explicit profile_scope(std::ostream* out);
+        ~profile_scope();
+
+        profile_scope(const profile_scope&) = delete;
+        profile_scope& operator=(const profile_scope&) = delete;
+
+        std::vector<entry> entries() const;
+        void report(std::ostream& out) const;
+
+    private:
+
+        struct frame
+        {
+            bool has_path;
+            event_kind path;
+        };
+
+        using key_type = std::pair<std::string, event_kind>;
+
+        static bool is_path(event_kind kind) noexcept;
+        static bool is_root(event_kind kind) noexcept;
+
+        void begin(const instrument::event& ev);
+        void end(const instrument::event& ev);
+
+        instrument::callbacks_type m_previous;
+        std::ostream* p_out;
+        mutable std::mutex m_mutex;
+        std::map<std::thread::id, std::vector<frame>> m_frames;
+        std::map<key_type, entry> m_entries;
+    };
+
+    /********************************
+     * profile_scope implementation *
+     ********************************/
+
+    /**
+     * Returns the achieved bandwidth of the entry, in GB/s.
+     */
+    inline double profile_scope::entry::gigabytes_per_second() const noexcept
+    {
+        return elapsed.count() != 0 ? static_cast<double>(bytes) / static_cast<double>(elapsed.count()) : 0.;
+    }
+
+    /**
+     * Starts profiling; the report is printed to \c out at the end of the scope.
+     */
+    inline profile_scope::profile_scope(std::ostream& out)
+        : profile_scope(&out)
+    {
+    }
+
+    /**
+     * Starts profiling; the report is printed to \c out at the end of the
+     * scope, or not printed if \c out is null.
+     */
+    inline profile_scope::profile_scope(std::ostream* out)
+        : m_previous(instrument::callbacks()), p_out(out)
+    {
+        instrument::set_callbacks([this](const instrument::event& ev) { begin(ev); },
+                                  [this](const instrument::event& ev) { end(ev); });
+    }
+
+    inline profile_scope::~profile_scope()
+    {
+        instrument::set_callbacks(std::move(m_previous.begin), std::move(m_previous.end));
+        if (p_out != nullptr)
+        {
+            report(*p_out);
+        }
+    }
+
+    /**
+     * Returns the aggregated statistics, sorted by decreasing total time.
+     */
+    inline auto profile_scope::entries() const -> std::vector<entry>
+    {
+        std::vector<entry> res;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            res.reserve(m_entries.size());
+            for (const auto& e : m_entries)
+            {
+                res.push_back(e.second);
+            }
+        }
+        std::stable_sort(res.begin(), res.end(), [](const entry& lhs, const entry& rhs) {
+            return lhs.elapsed > rhs.elapsed;
+        });
+        return res;
+    }
+
+    /**
+     * Prints the aggregated statistics to \c out, sorted by decreasing total time.
+     */
+    inline void profile_scope::report(std::ostream& out) const
+    {
+        std::vector<entry> res = entries();
+        std::ios_base::fmtflags flags = out.flags();
+        out << std::setw(12) << "time (ms)" << std::setw(10) << "calls" << std::setw(14) << "elements"
+            << std::setw(10) << "GB/s" << "  " << std::left << std::setw(26) << "path" << "expression" << std::right << "\n";
+        for (const entry& e : res)
+        {
+            out << std::fixed << std::setprecision(3) << std::setw(12) << static_cast<double>(e.elapsed.count()) * 1e-6
+                << std::setw(10) << e.count << std::setw(14) << e.elements
+                << std::setprecision(2) << std::setw(10) << e.gigabytes_per_second()
+                << "  " << std::left << std::setw(26) << instrument::to_string(e.path) << e.expression << std::right << "\n";
+        }
+        out.flags(flags);
+    }
+
+    inline bool profile_scope::is_path(event_kind kind) noexcept
+    {
+        return kind == event_kind::linear_assign || kind == event_kind::strided_loop_assign ||
+               kind == event_kind::stepper_assign;
+    }
+
+    inline bool profile_scope::is_root(event_kind kind) noexcept
+    {
+        return !is_path(kind);
+    }
+
+    inline void profile_scope::begin(const instrument::event& ev)
+    {
+        if (m_previous.begin)
+        {
+            m_previous.begin(ev);
+        }
+        if (is_root(ev.kind))
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_frames[std::this_thread::get_id()].push_back(frame{false, ev.kind});
+        }
+    }
+
+    inline void profile_scope::end(const instrument::event& ev)
+    {
+        if (m_previous.end)
+        {
+            m_previous.end(ev);
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<frame>& frames = m_frames[std::this_thread::get_id()];
+        if (frames.empty())
+        {
+            // the assignment started before the scope
+            return;
+        }
+        if (is_path(ev.kind))
+        {
+            frame& f = frames.back();
+            if (!f.has_path)
+            {
+                f.has_path = true;
+                f.path = ev.kind;
+            }
+            return;
+        }
+        event_kind path = frames.back().path;
+        frames.pop_back();
+        auto it = m_entries.find(key_type(ev.expression, path));
+        if (it == m_entries.end())
+        {
+            it = m_entries.emplace(key_type(ev.expression, path),
+                                   entry{ev.expression, path, 0, 0, 0, std::chrono::nanoseconds(0)}).first;
+        }
+        entry& e = it->second;
+        ++e.count;
+        e.elements += ev.size;
+        e.bytes += ev.bytes;
+        e.elapsed += ev.elapsed;
+    }
+}
+
+#endif
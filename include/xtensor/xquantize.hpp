@@ -0,0 +1,417 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_QUANTIZE_HPP
+#define XTENSOR_QUANTIZE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "xarray.hpp"
+#include "xfunction.hpp"
+#include "xmanipulation.hpp"
+#include "xoperation.hpp"
+#include "xparallel.hpp"
+#include "xtensor.hpp"
+#include "xtensor_config.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+    /**
+     * @defgroup quantized_functions Quantized arithmetic
+     *
+     * Arithmetic on small integer types for quantized pipelines. The
+     * element-wise functions compute in a wider integer type and clamp the
+     * result to the bounds of the element type instead of wrapping; like
+     * the other element-wise functions, they return lazy expressions. The
+     * expressions of contiguous containers are evaluated by the loops of
+     * the linear assignment, which the compiler vectorizes (see
+     * XTENSOR_PRAGMA_SIMD).
+     */
+
+    /****************************
+     * saturating functors      *
+     ****************************/
+
+    namespace detail
+    {
+        template <class T>
+        struct is_quantized_type
+            : std::integral_constant<bool, std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+                                           sizeof(T) <= 2>
+        {
+        };
+
+        // Clamps v to the range of T
+        template <class T, class W>
+        constexpr T saturate_cast(W v) noexcept
+        {
+            return static_cast<T>(v < static_cast<W>((std::numeric_limits<T>::min)()) ? static_cast<W>((std::numeric_limits<T>::min)())
+                                  : v > static_cast<W>((std::numeric_limits<T>::max)()) ? static_cast<W>((std::numeric_limits<T>::max)())
+                                  : v);
+        }
+
+        template <class A1, class A2>
+        using saturating_result_t = std::common_type_t<A1, A2>;
+
+        struct saturating_add_fun
+        {
+            template <class A1, class A2>
+            constexpr saturating_result_t<A1, A2> operator()(const A1& a, const A2& b) const noexcept
+            {
+                using result_type = saturating_result_t<A1, A2>;
+                static_assert(is_quantized_type<result_type>::value, "saturating_add: integral types of at most 16 bits are required");
+                return saturate_cast<result_type>(static_cast<std::int32_t>(a) + static_cast<std::int32_t>(b));
+            }
+        };
+
+        struct saturating_sub_fun
+        {
+            template <class A1, class A2>
+            constexpr saturating_result_t<A1, A2> operator()(const A1& a, const A2& b) const noexcept
+            {
+                using result_type = saturating_result_t<A1, A2>;
+                static_assert(is_quantized_type<result_type>::value, "saturating_sub: integral types of at most 16 bits are required");
+                return saturate_cast<result_type>(static_cast<std::int32_t>(a) - static_cast<std::int32_t>(b));
+            }
+        };
+
+        struct saturating_mul_fun
+        {
+            template <class A1, class A2>
+            constexpr saturating_result_t<A1, A2> operator()(const A1& a, const A2& b) const noexcept
+            {
+                using result_type = saturating_result_t<A1, A2>;
+                static_assert(is_quantized_type<result_type>::value, "saturating_mul: integral types of at most 16 bits are required");
+                // the products of 16 bit values do not fit in 32 bits
+                using wide_type = std::conditional_t<sizeof(result_type) == 1, std::int32_t, std::int64_t>;
+                return saturate_cast<result_type>(static_cast<wide_type>(a) * static_cast<wide_type>(b));
+            }
+        };
+
+        // Multiplies by a fixed point multiplier, shifts right with rounding
+        // to nearest (ties upwards), adds a zero point and clamps to R
+        template <class R>
+        class requantize_fun
+        {
+        public:
+
+            requantize_fun(std::int32_t multiplier, int shift, std::int32_t zero_point)
+                : m_multiplier(multiplier), m_rounding(0), m_zero_point(zero_point), m_shift(shift)
+            {
+                if (shift < 0 || shift > 62)
+                {
+                    throw std::runtime_error("requantize: shift must be in [0, 62]");
+                }
+                m_rounding = shift == 0 ? std::int64_t(0) : std::int64_t(1) << (shift - 1);
+            }
+
+            template <class T>
+            R operator()(const T& v) const noexcept
+            {
+                static_assert(std::is_integral<T>::value && sizeof(T) <= 4, "requantize: integral values of at most 32 bits are required");
+                std::int64_t p = static_cast<std::int64_t>(v) * m_multiplier;
+                return saturate_cast<R>(((p + m_rounding) >> m_shift) + m_zero_point);
+            }
+
+        private:
+
+            std::int64_t m_multiplier;
+            std::int64_t m_rounding;
+            std::int64_t m_zero_point;
+            int m_shift;
+        };
+    }
+
+    /**
+     * @ingroup quantized_functions
+     * @brief Saturating addition.
+     *
+     * Returns an \ref xfunction for the element-wise sum of \a e1 and \a e2,
+     * clamped to the range of their common type (e.g. std::int8_t) instead
+     * of wrapping or being promoted to int. Scalars should be given with the
+     * element type, an int scalar makes the common type int.
+     * @param e1 an \ref xexpression or a scalar
+     * @param e2 an \ref xexpression or a scalar
+     * @return an \ref xfunction
+     */
+    template <class E1, class E2>
+    inline auto saturating_add(E1&& e1, E2&& e2) noexcept
+        -> detail::xfunction_type_t<detail::saturating_add_fun, E1, E2>
+    {
+        return detail::make_xfunction<detail::saturating_add_fun>(std::forward<E1>(e1), std::forward<E2>(e2));
+    }
+
+    /**
+     * @ingroup quantized_functions
+     * @brief Saturating subtraction.
+     *
+     * Returns an \ref xfunction for the element-wise difference of \a e1 and
+     * \a e2, clamped to the range of their common type.
+     * @param e1 an \ref xexpression or a scalar
+     * @param e2 an \ref xexpression or a scalar
+     * @return an \ref xfunction
+     */
+    template <class E1, class E2>
+    inline auto saturating_sub(E1&& e1, E2&& e2) noexcept
+        -> detail::xfunction_type_t<detail::saturating_sub_fun, E1, E2>
+    {
+        return detail::make_xfunction<detail::saturating_sub_fun>(std::forward<E1>(e1), std::forward<E2>(e2));
+    }
+
+    /**
+     * @ingroup quantized_functions
+     * @brief Saturating multiplication.
+     *
+     * Returns an \ref xfunction for the element-wise product of \a e1 and
+     * \a e2, clamped to the range of their common type.
+     * @param e1 an \ref xexpression or a scalar
+     * @param e2 an \ref xexpression or a scalar
+     * @return an \ref xfunction
+     */
+    template <class E1, class E2>
+    inline auto saturating_mul(E1&& e1, E2&& e2) noexcept
+        -> detail::xfunction_type_t<detail::saturating_mul_fun, E1, E2>
+    {
+        return detail::make_xfunction<detail::saturating_mul_fun>(std::forward<E1>(e1), std::forward<E2>(e2));
+    }
+
+    /**
+     * @ingroup quantized_functions
+     * @brief Fixed point requantization.
+     *
+     * Returns an \ref xfunction converting integral values (typically the
+     * int32 accumulators of \ref dot_accumulate or \ref matmul_accumulate)
+     * to R: each value is multiplied by \a multiplier, shifted right by
+     * \a shift bits with rounding to nearest (ties upwards), offset by
+     * \a zero_point and clamped to the range of R. The real scale of the
+     * conversion is <tt>multiplier / 2^shift</tt>.
+     *
+     * \code{.cpp}
+     * xt::xtensor<std::int32_t, 1> acc = {-300, 5, 1000};
+     * // scale 0.25
+     * xt::xtensor<std::int8_t, 1> q = xt::requantize(acc, 1, 2);
+     * // q = {-75, 1, 127}
+     * \endcode
+     *
+     * @tparam R the integral result type (default std::int8_t)
+     * @param e an \ref xexpression of integral values
+     * @param multiplier the fixed point multiplier
+     * @param shift the number of bits of the right shift, in [0, 62]
+     * @param zero_point the value added after the scaling
+     * @return an \ref xfunction
+     */
+    template <class R = std::int8_t, class E>
+    inline auto requantize(E&& e, std::int32_t multiplier, int shift, std::int32_t zero_point = 0)
+    {
+        using functor_type = detail::requantize_fun<R>;
+        using xfunction_type = xfunction<functor_type, const_xclosure_t<E>>;
+        return xfunction_type(functor_type(multiplier, shift, zero_point), std::forward<E>(e));
+    }
+
+    /*****************************
+     * dot_accumulate            *
+     *****************************/
+
+    namespace detail
+    {
+        template <class T1, class T2>
+        using quantized_product_t = std::conditional_t<sizeof(T1) + sizeof(T2) <= 3, std::int32_t, std::int64_t>;
+
+        // Number of independent accumulators of the dot products, which
+        // the compiler maps to the lanes of vector registers
+        constexpr std::size_t dot_accumulate_lanes = 16;
+
+        // The products are accumulated modulo 2^32, like int32 accumulators
+        // wrapping on overflow, without undefined behavior
+        template <class T1, class T2>
+        inline std::uint32_t dot_accumulate_range(const T1* a, const T2* b, std::size_t n) noexcept
+        {
+            using product_type = quantized_product_t<T1, T2>;
+            std::uint32_t acc[dot_accumulate_lanes] = {};
+            std::size_t i = 0;
+            for (; i + dot_accumulate_lanes <= n; i += dot_accumulate_lanes)
+            {
+                for (std::size_t l = 0; l < dot_accumulate_lanes; ++l)
+                {
+                    acc[l] += static_cast<std::uint32_t>(static_cast<product_type>(a[i + l]) * static_cast<product_type>(b[i + l]));
+                }
+            }
+            for (std::size_t l = 0; i < n; ++i, ++l)
+            {
+                acc[l] += static_cast<std::uint32_t>(static_cast<product_type>(a[i]) * static_cast<product_type>(b[i]));
+            }
+            std::uint32_t res = 0;
+            for (std::size_t l = 0; l < dot_accumulate_lanes; ++l)
+            {
+                res += acc[l];
+            }
+            return res;
+        }
+
+        template <class T1, class T2>
+        inline std::uint32_t dot_accumulate_data(const T1* a, const T2* b, std::size_t n)
+        {
+#if defined(XTENSOR_PARALLEL_ENABLED)
+            if (parallel::use_parallel(n))
+            {
+                // the additions modulo 2^32 do not depend on the partition
+                std::atomic<std::uint32_t> res(0);
+                parallel_for(std::size_t(0), n, parallel::grain(1, XTENSOR_CACHE_LINE_SIZE),
+                             [&](std::size_t first, std::size_t last)
+                {
+                    res.fetch_add(dot_accumulate_range(a + first, b + first, last - first), std::memory_order_relaxed);
+                });
+                return res.load();
+            }
+#endif
+            return dot_accumulate_range(a, b, n);
+        }
+
+        template <class E, class = void>
+        struct has_quantized_data : std::false_type
+        {
+        };
+
+        template <class E>
+        struct has_quantized_data<E, std::enable_if_t<has_data_interface<E>::value && E::contiguous_layout &&
+                                                      std::is_same<data_value_type_t<E>, typename E::value_type>::value>>
+            : std::true_type
+        {
+        };
+
+        // Calls f with a pointer to the elements of e in row major order,
+        // copied into a temporary unless e is a contiguous row major expression
+        template <class E, class F>
+        inline auto with_row_major_data(const E& e, F&& f, std::false_type /*has data*/)
+        {
+            using value_type = typename E::value_type;
+            xarray<value_type, layout_type::row_major> tmp = e;
+            return f(static_cast<const value_type*>(tmp.data()));
+        }
+
+        template <class E, class F>
+        inline auto with_row_major_data(const E& e, F&& f, std::true_type /*has data*/)
+        {
+            if (e.dimension() < 2 || e.layout() == layout_type::row_major)
+            {
+                using value_type = typename E::value_type;
+                return f(static_cast<const value_type*>(e.data() + e.data_offset()));
+            }
+            return with_row_major_data(e, std::forward<F>(f), std::false_type());
+        }
+
+        template <class E, class F>
+        inline auto with_row_major_data(const E& e, F&& f)
+        {
+            return with_row_major_data(e, std::forward<F>(f), has_quantized_data<E>());
+        }
+    }
+
+    /**
+     * @ingroup quantized_functions
+     * @brief Dot product accumulated in 32 bits.
+     *
+     * Returns the sum of the products of the elements of \a e1 and \a e2,
+     * which must have the same shape, accumulated in an int32 like the
+     * kernels of quantized inference: the accumulation wraps around on
+     * overflow. The elements are integral values of at most 16 bits; their
+     * buffers are read directly when the expressions are contiguous row
+     * major ones, with independent accumulators that the compiler
+     * vectorizes, and large expressions are processed in parallel.
+     * @param e1 an \ref xexpression of integral values
+     * @param e2 an \ref xexpression of integral values
+     * @return the accumulated products
+     */
+    template <class E1, class E2>
+    inline std::int32_t dot_accumulate(const xexpression<E1>& e1, const xexpression<E2>& e2)
+    {
+        const E1& de1 = e1.derived_cast();
+        const E2& de2 = e2.derived_cast();
+        static_assert(detail::is_quantized_type<typename E1::value_type>::value && detail::is_quantized_type<typename E2::value_type>::value,
+                      "dot_accumulate: integral types of at most 16 bits are required");
+        if (de1.dimension() != de2.dimension() || !std::equal(de1.shape().cbegin(), de1.shape().cend(), de2.shape().cbegin()))
+        {
+            throw std::runtime_error("dot_accumulate: the expressions must have the same shape");
+        }
+        std::size_t n = static_cast<std::size_t>(de1.size());
+        std::uint32_t res = detail::with_row_major_data(de1, [&](auto a) {
+            return detail::with_row_major_data(de2, [&](auto b) {
+                return detail::dot_accumulate_data(a, b, n);
+            });
+        });
+        return static_cast<std::int32_t>(res);
+    }
+
+    /**
+     * @ingroup quantized_functions
+     * @brief Matrix product accumulated in 32 bits.
+     *
+     * Returns the product of the matrices \a e1, of shape (m, k), and \a e2,
+     * of shape (k, n), whose elements are integral values of at most 16
+     * bits: every element of the result is a \ref dot_accumulate of a row of
+     * \a e1 and a column of \a e2. The columns of \a e2 are copied once into
+     * contiguous rows, and the rows of the result are computed in parallel.
+     * @param e1 a two-dimensional \ref xexpression
+     * @param e2 a two-dimensional \ref xexpression
+     * @return a row major xtensor of int32 of shape (m, n)
+     */
+    template <class E1, class E2>
+    inline xtensor<std::int32_t, 2, layout_type::row_major> matmul_accumulate(const xexpression<E1>& e1, const xexpression<E2>& e2)
+    {
+        const E1& de1 = e1.derived_cast();
+        const E2& de2 = e2.derived_cast();
+        using value_type2 = typename E2::value_type;
+        static_assert(detail::is_quantized_type<typename E1::value_type>::value && detail::is_quantized_type<value_type2>::value,
+                      "matmul_accumulate: integral types of at most 16 bits are required");
+        if (de1.dimension() != 2 || de2.dimension() != 2 || de1.shape()[1] != de2.shape()[0])
+        {
+            throw std::runtime_error("matmul_accumulate: the expressions must be matrices of compatible shapes");
+        }
+        std::size_t m = static_cast<std::size_t>(de1.shape()[0]);
+        std::size_t k = static_cast<std::size_t>(de1.shape()[1]);
+        std::size_t n = static_cast<std::size_t>(de2.shape()[1]);
+
+        using result_type = xtensor<std::int32_t, 2, layout_type::row_major>;
+        xtensor<value_type2, 2, layout_type::row_major> columns = transpose(de2);
+        result_type res = result_type::from_shape({m, n});
+        std::int32_t* out = res.data();
+        const value_type2* b = columns.data();
+        detail::with_row_major_data(de1, [&](auto a) {
+            auto rows = [&](std::size_t first, std::size_t last)
+            {
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    for (std::size_t j = 0; j < n; ++j)
+                    {
+                        out[i * n + j] = static_cast<std::int32_t>(detail::dot_accumulate_range(a + i * k, b + j * k, k));
+                    }
+                }
+            };
+#if defined(XTENSOR_PARALLEL_ENABLED)
+            if (parallel::use_parallel(m * n * k))
+            {
+                parallel_for(std::size_t(0), m, parallel::grain(n * k), rows);
+                return 0;
+            }
+#endif
+            rows(std::size_t(0), m);
+            return 0;
+        });
+        return res;
+    }
+}
+
+#endif
@@ -13,13 +13,24 @@
 #ifndef XTENSOR_RANDOM_HPP
 #define XTENSOR_RANDOM_HPP
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <limits>
+#include <numeric>
 #include <random>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "xbuilder.hpp"
 #include "xgenerator.hpp"
+#include "xparallel.hpp"
 #include "xtensor.hpp"
+#include "xutils.hpp"
 #include "xview.hpp"
 
 namespace xt
@@ -30,6 +41,8 @@ namespace xt
 
     namespace random
     {
+        class philox_engine;
+
         using default_engine_type = std::mt19937;
         using seed_type = default_engine_type::result_type;
 
@@ -48,6 +61,22 @@ namespace xt
         auto randn(const S& shape, T mean = 0, T std_dev = 1,
                    E& engine = random::get_default_random_engine());
 
+        template <class T, class S, class E = random::default_engine_type>
+        auto binomial(const S& shape, T trials = 1, double prob = 0.5,
+                      E& engine = random::get_default_random_engine());
+
+        template <class T, class S, class E = random::default_engine_type>
+        auto poisson(const S& shape, double rate = 1.0,
+                     E& engine = random::get_default_random_engine());
+
+        template <class T, class S, class E = random::default_engine_type>
+        auto exponential(const S& shape, T rate = 1,
+                         E& engine = random::get_default_random_engine());
+
+        template <class T, class S, class E = random::default_engine_type>
+        auto gamma(const S& shape, T alpha = 1, T beta = 1,
+                   E& engine = random::get_default_random_engine());
+
 #ifdef X_OLD_CLANG
         template <class T, class I, class E = random::default_engine_type>
         auto rand(std::initializer_list<I> shape, T lower = 0, T upper = 1,
@@ -61,6 +90,22 @@ namespace xt
         template <class T, class I, class E = random::default_engine_type>
         auto randn(std::initializer_list<I>, T mean = 0, T std_dev = 1,
                    E& engine = random::get_default_random_engine());
+
+        template <class T, class I, class E = random::default_engine_type>
+        auto binomial(std::initializer_list<I> shape, T trials = 1, double prob = 0.5,
+                      E& engine = random::get_default_random_engine());
+
+        template <class T, class I, class E = random::default_engine_type>
+        auto poisson(std::initializer_list<I> shape, double rate = 1.0,
+                     E& engine = random::get_default_random_engine());
+
+        template <class T, class I, class E = random::default_engine_type>
+        auto exponential(std::initializer_list<I> shape, T rate = 1,
+                         E& engine = random::get_default_random_engine());
+
+        template <class T, class I, class E = random::default_engine_type>
+        auto gamma(std::initializer_list<I> shape, T alpha = 1, T beta = 1,
+                   E& engine = random::get_default_random_engine());
 #else
         template <class T, class I, std::size_t L, class E = random::default_engine_type>
         auto rand(const I (&shape)[L], T lower = 0, T upper = 1,
@@ -73,11 +118,30 @@ namespace xt
         template <class T, class I, std::size_t L, class E = random::default_engine_type>
         auto randn(const I (&shape)[L], T mean = 0, T std_dev = 1,
                    E& engine = random::get_default_random_engine());
+
+        template <class T, class I, std::size_t L, class E = random::default_engine_type>
+        auto binomial(const I (&shape)[L], T trials = 1, double prob = 0.5,
+                      E& engine = random::get_default_random_engine());
+
+        template <class T, class I, std::size_t L, class E = random::default_engine_type>
+        auto poisson(const I (&shape)[L], double rate = 1.0,
+                     E& engine = random::get_default_random_engine());
+
+        template <class T, class I, std::size_t L, class E = random::default_engine_type>
+        auto exponential(const I (&shape)[L], T rate = 1,
+                         E& engine = random::get_default_random_engine());
+
+        template <class T, class I, std::size_t L, class E = random::default_engine_type>
+        auto gamma(const I (&shape)[L], T alpha = 1, T beta = 1,
+                   E& engine = random::get_default_random_engine());
 #endif
 
         template <class T, class E = random::default_engine_type>
         void shuffle(xexpression<T>& e, E& engine = random::get_default_random_engine());
 
+        template <class T, class E = random::default_engine_type>
+        typename T::temporary_type shuffled(const xexpression<T>& e, E& engine = random::get_default_random_engine());
+
         template <class T, class E = random::default_engine_type>
         std::enable_if_t<std::is_integral<T>::value, xtensor<T, 1>>
         permutation(T e, E& engine = random::get_default_random_engine());
@@ -89,10 +153,369 @@ namespace xt
         template <class T, class E = random::default_engine_type>
         xtensor<typename T::value_type, 1> choice(const xexpression<T>& e, std::size_t n, bool replace = true,
                                                   E& engine = random::get_default_random_engine());
+
+        template <class T, class W, class E = random::default_engine_type>
+        xtensor<typename T::value_type, 1> choice(const xexpression<T>& e, std::size_t n, const xexpression<W>& weights,
+                                                  bool replace = true, E& engine = random::get_default_random_engine());
+    }
+
+    /*****************
+     * philox_engine *
+     *****************/
+
+    namespace random
+    {
+        /**
+         * @class philox_engine
+         * @brief Counter-based random number engine (Philox4x32-10).
+         *
+         * The numbers are the encryption of a 128 bits counter with a key
+         * derived from the seed. The upper half of the counter selects a
+         * substream and the lower half the position in this substream, so
+         * that any substream can be reached in constant time. The
+         * generators of xrandom use this property to fill containers in
+         * parallel: the elements are split into blocks of fixed size, each
+         * block being drawn from its own substream, which gives the same
+         * results whatever the number of threads.
+         *
+         * philox_engine satisfies the requirements of a random number engine
+         * and can be used with the distributions of the standard library.
+         *
+         * \code{.cpp}
+         * xt::random::philox_engine engine(42);
+         * xt::xarray<double> a = xt::random::rand<double>({1000, 1000}, 0., 1., engine);
+         * \endcode
+         */
+        class philox_engine
+        {
+        public:
+
+            using result_type = std::uint32_t;
+
+            static constexpr std::uint64_t default_seed = 20111115u;
+
+            philox_engine();
+            explicit philox_engine(std::uint64_t s);
+
+            void seed(std::uint64_t s = default_seed);
+
+            result_type operator()();
+            void discard(unsigned long long n);
+
+            philox_engine substream(std::uint64_t i) const;
+            void skip_substreams(std::uint64_t n);
+
+            static constexpr result_type min() noexcept;
+            static constexpr result_type max() noexcept;
+
+            bool operator==(const philox_engine& rhs) const noexcept;
+            bool operator!=(const philox_engine& rhs) const noexcept;
+
+        private:
+
+            using block_type = std::array<std::uint32_t, 4>;
+
+            static constexpr std::size_t block_size = 4;
+
+            void generate() noexcept;
+            void set_position(std::uint64_t position) noexcept;
+            std::uint64_t position() const noexcept;
+            std::uint64_t stream() const noexcept;
+            void set_stream(std::uint64_t stream) noexcept;
+
+            std::array<std::uint32_t, 2> m_key;
+            block_type m_counter;
+            block_type m_block;
+            std::size_t m_index;
+        };
     }
 
     namespace detail
     {
+        template <class E, class = void_t<>>
+        struct is_counter_based_engine : std::false_type
+        {
+        };
+
+        template <class E>
+        struct is_counter_based_engine<E, void_t<decltype(std::declval<const E&>().substream(std::uint64_t(0)))>>
+            : std::true_type
+        {
+        };
+
+        // Number of elements drawn from each substream of a counter-based
+        // engine; it must not depend on the parallel settings, so that the
+        // results are reproducible
+        constexpr std::size_t random_block_size = 1024;
+
+        /**********************
+         * bulk distributions *
+         **********************/
+
+        // The bulk distributions behave like their standard counterpart when
+        // drawing a single number, and additionally provide a fill method
+        // generating a whole range from the raw bits of the engine: the
+        // transformations are computed in batches of plain loops that the
+        // compiler vectorizes, instead of one call to the distribution per
+        // element.
+
+        template <class E>
+        struct has_full_random_bits
+            : std::integral_constant<bool, E::min() == 0 &&
+                                           (static_cast<std::uint64_t>(E::max()) == 0xFFFFFFFFu ||
+                                            static_cast<std::uint64_t>(E::max()) == (std::numeric_limits<std::uint64_t>::max)())>
+        {
+        };
+
+        constexpr std::size_t random_batch_size = 128;
+
+        template <class E>
+        inline std::uint32_t random_bits32(E& engine)
+        {
+            return static_cast<std::uint32_t>(engine());
+        }
+
+        // Uniform numbers in [0, 1) with the precision of T (24 bits for
+        // float, 53 bits otherwise)
+        template <class T, class E>
+        inline std::enable_if_t<std::is_same<T, float>::value, T> random_canonical(E& engine)
+        {
+            return static_cast<float>(random_bits32(engine) >> 8) * (1.f / 16777216.f);
+        }
+
+        template <class T, class E>
+        inline std::enable_if_t<!std::is_same<T, float>::value, T> random_canonical(E& engine)
+        {
+            std::uint64_t high = random_bits32(engine);
+            std::uint64_t low = random_bits32(engine);
+            std::uint64_t bits = ((high << 32) | low) >> 11;
+            return static_cast<T>(static_cast<double>(bits) * (1. / 9007199254740992.));
+        }
+
+        template <class D, class E, class It>
+        inline void fill_distribution(D& dist, E& engine, It first, It last)
+        {
+            for (; first != last; ++first)
+            {
+                *first = dist(engine);
+            }
+        }
+
+        template <class T>
+        class bulk_uniform_real_distribution : public std::uniform_real_distribution<T>
+        {
+        public:
+
+            using base_type = std::uniform_real_distribution<T>;
+            using base_type::base_type;
+
+            template <class E, class It>
+            void fill(E& engine, It first, It last)
+            {
+                fill_impl(engine, first, last, has_full_random_bits<E>());
+            }
+
+        private:
+
+            template <class E, class It>
+            void fill_impl(E& engine, It first, It last, std::false_type)
+            {
+                fill_distribution(*this, engine, first, last);
+            }
+
+            template <class E, class It>
+            void fill_impl(E& engine, It first, It last, std::true_type)
+            {
+                const T lower = this->a();
+                const T scale = this->b() - this->a();
+                std::array<T, random_batch_size> u;
+                while (first != last)
+                {
+                    std::size_t n = (std::min)(random_batch_size, static_cast<std::size_t>(std::distance(first, last)));
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        u[i] = random_canonical<T>(engine);
+                    }
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        u[i] = lower + scale * u[i];
+                    }
+                    first = std::copy(u.cbegin(), u.cbegin() + static_cast<std::ptrdiff_t>(n), first);
+                }
+            }
+        };
+
+        // Box-Muller transform, each pair of uniform numbers giving a pair
+        // of normal numbers
+        template <class T>
+        class bulk_normal_distribution : public std::normal_distribution<T>
+        {
+        public:
+
+            using base_type = std::normal_distribution<T>;
+            using base_type::base_type;
+
+            template <class E, class It>
+            void fill(E& engine, It first, It last)
+            {
+                fill_impl(engine, first, last, has_full_random_bits<E>());
+            }
+
+        private:
+
+            template <class E, class It>
+            void fill_impl(E& engine, It first, It last, std::false_type)
+            {
+                fill_distribution(*this, engine, first, last);
+            }
+
+            template <class E, class It>
+            void fill_impl(E& engine, It first, It last, std::true_type)
+            {
+                constexpr std::size_t nb_pairs = random_batch_size / 2;
+                const T two_pi = static_cast<T>(6.283185307179586476925286766559);
+                const T mean = this->mean();
+                const T std_dev = this->stddev();
+                std::array<T, nb_pairs> radius;
+                std::array<T, nb_pairs> angle;
+                std::array<T, random_batch_size> z;
+                while (first != last)
+                {
+                    std::size_t size = static_cast<std::size_t>(std::distance(first, last));
+                    std::size_t n = (std::min)(nb_pairs, (size + 1) / 2);
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        // 1 - u is in (0, 1], so that its logarithm is finite
+                        radius[i] = T(1) - random_canonical<T>(engine);
+                        angle[i] = random_canonical<T>(engine);
+                    }
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        T r = std_dev * std::sqrt(T(-2) * std::log(radius[i]));
+                        T theta = two_pi * angle[i];
+                        z[2 * i] = mean + r * std::cos(theta);
+                        z[2 * i + 1] = mean + r * std::sin(theta);
+                    }
+                    std::size_t count = (std::min)(2 * n, size);
+                    first = std::copy(z.cbegin(), z.cbegin() + static_cast<std::ptrdiff_t>(count), first);
+                }
+            }
+        };
+
+        // Inversion of the cumulative distribution function
+        template <class T>
+        class bulk_exponential_distribution : public std::exponential_distribution<T>
+        {
+        public:
+
+            using base_type = std::exponential_distribution<T>;
+            using base_type::base_type;
+
+            template <class E, class It>
+            void fill(E& engine, It first, It last)
+            {
+                fill_impl(engine, first, last, has_full_random_bits<E>());
+            }
+
+        private:
+
+            template <class E, class It>
+            void fill_impl(E& engine, It first, It last, std::false_type)
+            {
+                fill_distribution(*this, engine, first, last);
+            }
+
+            template <class E, class It>
+            void fill_impl(E& engine, It first, It last, std::true_type)
+            {
+                const T inv_rate = T(1) / this->lambda();
+                std::array<T, random_batch_size> u;
+                while (first != last)
+                {
+                    std::size_t n = (std::min)(random_batch_size, static_cast<std::size_t>(std::distance(first, last)));
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        u[i] = T(1) - random_canonical<T>(engine);
+                    }
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        u[i] = -std::log(u[i]) * inv_rate;
+                    }
+                    first = std::copy(u.cbegin(), u.cbegin() + static_cast<std::ptrdiff_t>(n), first);
+                }
+            }
+        };
+
+        // Multiply-shift method with rejection (Lemire), for the ranges of
+        // at most 2^32 values; larger ranges use the standard distribution
+        template <class T>
+        class bulk_uniform_int_distribution : public std::uniform_int_distribution<T>
+        {
+        public:
+
+            using base_type = std::uniform_int_distribution<T>;
+            using base_type::base_type;
+
+            template <class E, class It>
+            void fill(E& engine, It first, It last)
+            {
+                fill_impl(engine, first, last, has_full_random_bits<E>());
+            }
+
+        private:
+
+            template <class E, class It>
+            void fill_impl(E& engine, It first, It last, std::false_type)
+            {
+                fill_distribution(*this, engine, first, last);
+            }
+
+            template <class E, class It>
+            void fill_impl(E& engine, It first, It last, std::true_type)
+            {
+                std::uint64_t full_range = static_cast<std::uint64_t>(this->b()) - static_cast<std::uint64_t>(this->a()) + 1u;
+                if (full_range == 0 || full_range > 0xFFFFFFFFu)
+                {
+                    fill_distribution(*this, engine, first, last);
+                    return;
+                }
+                const std::uint32_t range = static_cast<std::uint32_t>(full_range);
+                const std::uint32_t threshold = static_cast<std::uint32_t>(-range) % range;
+                const std::uint64_t lower = static_cast<std::uint64_t>(this->a());
+                std::array<std::uint64_t, random_batch_size> m;
+                std::array<T, random_batch_size> res;
+                while (first != last)
+                {
+                    std::size_t n = (std::min)(random_batch_size, static_cast<std::size_t>(std::distance(first, last)));
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        m[i] = static_cast<std::uint64_t>(random_bits32(engine)) * range;
+                        while (static_cast<std::uint32_t>(m[i]) < threshold)
+                        {
+                            m[i] = static_cast<std::uint64_t>(random_bits32(engine)) * range;
+                        }
+                    }
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        res[i] = static_cast<T>(lower + (m[i] >> 32));
+                    }
+                    first = std::copy(res.cbegin(), res.cbegin() + static_cast<std::ptrdiff_t>(n), first);
+                }
+            }
+        };
+
+        template <class D, class E, class It>
+        inline auto fill_random(D& dist, E& engine, It first, It last, int) -> decltype(dist.fill(engine, first, last))
+        {
+            return dist.fill(engine, first, last);
+        }
+
+        template <class D, class E, class It>
+        inline void fill_random(D& dist, E& engine, It first, It last, long)
+        {
+            fill_distribution(dist, engine, first, last);
+        }
+
         template <class T, class E, class D>
         struct random_impl
         {
@@ -119,28 +542,221 @@ namespace xt
             inline void assign_to(xexpression<EX>& e) const noexcept
             {
                 // Note: we're not going row/col major here
-                auto& ed = e.derived_cast();
-                for (auto& el : ed.storage())
-                {
-                    el = m_dist(m_engine);
-                }
+                assign_to_impl(e.derived_cast().storage(), is_counter_based_engine<E>());
             }
 
         private:
 
+            template <class ST>
+            inline void assign_to_impl(ST& storage, std::false_type) const noexcept
+            {
+                fill_random(m_dist, m_engine, storage.begin(), storage.end(), 0);
+            }
+
+            // Each block of random_block_size elements is drawn from its
+            // own substream, with its own copy of the distribution
+            template <class ST>
+            inline void assign_to_impl(ST& storage, std::true_type) const noexcept
+            {
+                std::size_t size = storage.size();
+                std::size_t nb_blocks = (size + random_block_size - 1) / random_block_size;
+                const E& engine = m_engine;
+                const D& dist = m_dist;
+                auto fill = [&storage, &engine, &dist, size](std::size_t first, std::size_t last)
+                {
+                    for (std::size_t b = first; b != last; ++b)
+                    {
+                        E block_engine = engine.substream(static_cast<std::uint64_t>(b + 1));
+                        D block_dist = dist;
+                        block_dist.reset();
+                        std::size_t block_end = (std::min)(size, (b + 1) * random_block_size);
+                        auto block_first = storage.begin() + static_cast<std::ptrdiff_t>(b * random_block_size);
+                        auto block_last = storage.begin() + static_cast<std::ptrdiff_t>(block_end);
+                        fill_random(block_dist, block_engine, block_first, block_last, 0);
+                    }
+                };
+                if (parallel::use_parallel(size))
+                {
+                    parallel_for(std::size_t(0), nb_blocks, parallel::grain(random_block_size, 1), fill);
+                }
+                else
+                {
+                    fill(std::size_t(0), nb_blocks);
+                }
+                m_engine.skip_substreams(static_cast<std::uint64_t>(nb_blocks + 1));
+            }
+
             E& m_engine;
             mutable D m_dist;
         };
     }
 
+    namespace detail
+    {
+        /**********************
+         * shuffle algorithms *
+         **********************/
+
+        // Permutation of the rows of a shuffle: the row k of the result is
+        // the row indices[k] of the input. The draws are the same as the
+        // Fisher-Yates shuffle of the rows themselves.
+        template <class S, class E>
+        inline std::vector<S> shuffle_indices(S n, E& engine)
+        {
+            std::vector<S> indices(n);
+            std::iota(indices.begin(), indices.end(), S(0));
+            for (S i = n - 1; i > 0; --i)
+            {
+                std::uniform_int_distribution<S> dist(0, i);
+                S j = dist(engine);
+                using std::swap;
+                swap(indices[i], indices[j]);
+            }
+            return indices;
+        }
+
+        template <class E>
+        inline bool rows_are_contiguous(const E& e)
+        {
+            return e.layout() == layout_type::row_major;
+        }
+
+        // Applies the permutation in place by following its cycles, each
+        // row being moved once through a scratch row
+        template <class E, class S>
+        inline void permute_rows(E& e, const std::vector<S>& indices, std::true_type)
+        {
+            if (!rows_are_contiguous(e))
+            {
+                permute_rows(e, indices, std::false_type());
+                return;
+            }
+            using value_type = typename E::value_type;
+            std::size_t nb_rows = indices.size();
+            std::size_t row_size = e.size() / nb_rows;
+            value_type* data = e.data() + e.data_offset();
+            std::vector<value_type> scratch(row_size);
+            std::vector<std::uint8_t> done(nb_rows, 0);
+            auto row = [data, row_size](std::size_t k) { return data + static_cast<std::ptrdiff_t>(k * row_size); };
+            for (std::size_t start = 0; start < nb_rows; ++start)
+            {
+                if (done[start] || static_cast<std::size_t>(indices[start]) == start)
+                {
+                    continue;
+                }
+                std::copy(row(start), row(start) + row_size, scratch.begin());
+                std::size_t current = start;
+                std::size_t next = static_cast<std::size_t>(indices[current]);
+                while (next != start)
+                {
+                    std::copy(row(next), row(next) + row_size, row(current));
+                    done[current] = 1;
+                    current = next;
+                    next = static_cast<std::size_t>(indices[current]);
+                }
+                std::copy(scratch.cbegin(), scratch.cend(), row(current));
+                done[current] = 1;
+            }
+        }
+
+        template <class E, class S>
+        inline void permute_rows(E& e, const std::vector<S>& indices, std::false_type)
+        {
+            decltype(auto) scratch = empty_like(view(e, 0));
+            std::size_t nb_rows = indices.size();
+            std::vector<std::uint8_t> done(nb_rows, 0);
+            for (std::size_t start = 0; start < nb_rows; ++start)
+            {
+                if (done[start] || static_cast<std::size_t>(indices[start]) == start)
+                {
+                    continue;
+                }
+                scratch = view(e, start);
+                std::size_t current = start;
+                std::size_t next = static_cast<std::size_t>(indices[current]);
+                while (next != start)
+                {
+                    view(e, current) = view(e, next);
+                    done[current] = 1;
+                    current = next;
+                    next = static_cast<std::size_t>(indices[current]);
+                }
+                view(e, current) = scratch;
+                done[current] = 1;
+            }
+        }
+
+        // Copies the rows of e in the order of indices into res, a new row
+        // major container, writing res sequentially
+        template <class E, class R, class S>
+        inline void gather_rows(const E& e, R& res, const std::vector<S>& indices, std::true_type)
+        {
+            if (!rows_are_contiguous(e) || res.layout() != layout_type::row_major)
+            {
+                gather_rows(e, res, indices, std::false_type());
+                return;
+            }
+            std::size_t nb_rows = indices.size();
+            std::size_t row_size = e.size() / nb_rows;
+            const auto* src = e.data() + e.data_offset();
+            auto* dst = res.data();
+            auto gather = [src, dst, row_size, &indices](std::size_t first, std::size_t last)
+            {
+                for (std::size_t k = first; k != last; ++k)
+                {
+                    auto row = src + static_cast<std::ptrdiff_t>(static_cast<std::size_t>(indices[k]) * row_size);
+                    std::copy(row, row + row_size, dst + static_cast<std::ptrdiff_t>(k * row_size));
+                }
+            };
+            if (parallel::use_parallel(e.size()))
+            {
+                parallel_for(std::size_t(0), nb_rows, parallel::grain(row_size, 1), gather);
+            }
+            else
+            {
+                gather(std::size_t(0), nb_rows);
+            }
+        }
+
+        template <class E, class R, class S>
+        inline void gather_rows(const E& e, R& res, const std::vector<S>& indices, std::false_type)
+        {
+            for (std::size_t k = 0; k < indices.size(); ++k)
+            {
+                view(res, k) = view(e, static_cast<std::size_t>(indices[k]));
+            }
+        }
+
+        template <class R, class T, class E>
+        inline R permutation_impl(T&& e, E& engine, std::true_type)
+        {
+            return random::shuffled(e, engine);
+        }
+
+        template <class R, class T, class E>
+        inline R permutation_impl(T&& e, E& engine, std::false_type)
+        {
+            R res = e;
+            random::shuffle(res, engine);
+            return res;
+        }
+    }
+
     namespace random
     {
         /**
-         * Returns a reference to the default random number engine
+         * Returns a reference to the default random number engine. The engine
+         * is shared by all the threads, unless XTENSOR_RANDOM_THREAD_LOCAL_ENGINE
+         * is defined, in which case each thread has its own engine, seeded
+         * independently by \ref seed.
          */
         inline default_engine_type& get_default_random_engine()
         {
+#if defined(XTENSOR_RANDOM_THREAD_LOCAL_ENGINE)
+            thread_local default_engine_type mt;
+#else
             static default_engine_type mt;
+#endif
             return mt;
         }
 
@@ -157,7 +773,8 @@ namespace xt
          * xexpression with specified @p shape containing uniformly distributed random numbers
          * in the interval from @p lower to @p upper, excluding upper.
          *
-         * Numbers are drawn from @c std::uniform_real_distribution.
+         * Single numbers are drawn from @c std::uniform_real_distribution;
+         * containers are filled in bulk from the raw bits of the engine.
          *
          * @param shape shape of resulting xexpression
          * @param lower lower bound
@@ -168,7 +785,7 @@ namespace xt
         template <class T, class S, class E>
         inline auto rand(const S& shape, T lower, T upper, E& engine)
         {
-            std::uniform_real_distribution<T> dist(lower, upper);
+            detail::bulk_uniform_real_distribution<T> dist(lower, upper);
             return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
         }
 
@@ -176,7 +793,8 @@ namespace xt
          * xexpression with specified @p shape containing uniformly distributed
          * random integers in the interval from @p lower to @p upper, excluding upper.
          *
-         * Numbers are drawn from @c std::uniform_int_distribution.
+         * Single numbers are drawn from @c std::uniform_int_distribution;
+         * containers are filled in bulk with the multiply-shift method.
          *
          * @param shape shape of resulting xexpression
          * @param lower lower bound
@@ -187,7 +805,7 @@ namespace xt
         template <class T, class S, class E>
         inline auto randint(const S& shape, T lower, T upper, E& engine)
         {
-            std::uniform_int_distribution<T> dist(lower, T(upper - 1));
+            detail::bulk_uniform_int_distribution<T> dist(lower, T(upper - 1));
             return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
         }
 
@@ -196,7 +814,8 @@ namespace xt
          * the Normal (Gaussian) random number distribution with mean @p mean and
          * standard deviation @p std_dev.
          *
-         * Numbers are drawn from @c std::normal_distribution.
+         * Single numbers are drawn from @c std::normal_distribution;
+         * containers are filled in bulk with the Box-Muller transform.
          *
          * @param shape shape of resulting xexpression
          * @param mean mean of normal distribution
@@ -207,7 +826,82 @@ namespace xt
         template <class T, class S, class E>
         inline auto randn(const S& shape, T mean, T std_dev, E& engine)
         {
-            std::normal_distribution<T> dist(mean, std_dev);
+            detail::bulk_normal_distribution<T> dist(mean, std_dev);
+            return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
+        }
+
+        /**
+         * xexpression with specified @p shape containing numbers of successes
+         * of @p trials Bernoulli trials of probability @p prob.
+         *
+         * Numbers are drawn from @c std::binomial_distribution.
+         *
+         * @param shape shape of resulting xexpression
+         * @param trials number of trials
+         * @param prob probability of success of each trial
+         * @param engine random number engine
+         * @tparam T integral type to use
+         */
+        template <class T, class S, class E>
+        inline auto binomial(const S& shape, T trials, double prob, E& engine)
+        {
+            std::binomial_distribution<T> dist(trials, prob);
+            return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
+        }
+
+        /**
+         * xexpression with specified @p shape containing numbers sampled from
+         * the Poisson distribution of mean @p rate.
+         *
+         * Numbers are drawn from @c std::poisson_distribution.
+         *
+         * @param shape shape of resulting xexpression
+         * @param rate mean of the distribution
+         * @param engine random number engine
+         * @tparam T integral type to use
+         */
+        template <class T, class S, class E>
+        inline auto poisson(const S& shape, double rate, E& engine)
+        {
+            std::poisson_distribution<T> dist(rate);
+            return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
+        }
+
+        /**
+         * xexpression with specified @p shape containing numbers sampled from
+         * the exponential distribution of rate @p rate.
+         *
+         * Single numbers are drawn from @c std::exponential_distribution;
+         * containers are filled in bulk by inversion.
+         *
+         * @param shape shape of resulting xexpression
+         * @param rate rate (inverse of the mean) of the distribution
+         * @param engine random number engine
+         * @tparam T number type to use
+         */
+        template <class T, class S, class E>
+        inline auto exponential(const S& shape, T rate, E& engine)
+        {
+            detail::bulk_exponential_distribution<T> dist(rate);
+            return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
+        }
+
+        /**
+         * xexpression with specified @p shape containing numbers sampled from
+         * the gamma distribution of shape @p alpha and scale @p beta.
+         *
+         * Numbers are drawn from @c std::gamma_distribution.
+         *
+         * @param shape shape of resulting xexpression
+         * @param alpha shape parameter of the distribution
+         * @param beta scale parameter of the distribution
+         * @param engine random number engine
+         * @tparam T number type to use
+         */
+        template <class T, class S, class E>
+        inline auto gamma(const S& shape, T alpha, T beta, E& engine)
+        {
+            std::gamma_distribution<T> dist(alpha, beta);
             return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
         }
 
@@ -215,42 +909,98 @@ namespace xt
         template <class T, class I, class E>
         inline auto rand(std::initializer_list<I> shape, T lower, T upper, E& engine)
         {
-            std::uniform_real_distribution<T> dist(lower, upper);
+            detail::bulk_uniform_real_distribution<T> dist(lower, upper);
             return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
         }
 
         template <class T, class I, class E>
         inline auto randint(std::initializer_list<I> shape, T lower, T upper, E& engine)
         {
-            std::uniform_int_distribution<T> dist(lower, T(upper - 1));
+            detail::bulk_uniform_int_distribution<T> dist(lower, T(upper - 1));
             return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
         }
 
         template <class T, class I, class E>
         inline auto randn(std::initializer_list<I> shape, T mean, T std_dev, E& engine)
         {
-            std::normal_distribution<T> dist(mean, std_dev);
+            detail::bulk_normal_distribution<T> dist(mean, std_dev);
+            return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
+        }
+
+        template <class T, class I, class E>
+        inline auto binomial(std::initializer_list<I> shape, T trials, double prob, E& engine)
+        {
+            std::binomial_distribution<T> dist(trials, prob);
+            return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
+        }
+
+        template <class T, class I, class E>
+        inline auto poisson(std::initializer_list<I> shape, double rate, E& engine)
+        {
+            std::poisson_distribution<T> dist(rate);
+            return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
+        }
+
+        template <class T, class I, class E>
+        inline auto exponential(std::initializer_list<I> shape, T rate, E& engine)
+        {
+            detail::bulk_exponential_distribution<T> dist(rate);
+            return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
+        }
+
+        template <class T, class I, class E>
+        inline auto gamma(std::initializer_list<I> shape, T alpha, T beta, E& engine)
+        {
+            std::gamma_distribution<T> dist(alpha, beta);
             return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
         }
 #else
         template <class T, class I, std::size_t L, class E>
         inline auto rand(const I (&shape)[L], T lower, T upper, E& engine)
         {
-            std::uniform_real_distribution<T> dist(lower, upper);
+            detail::bulk_uniform_real_distribution<T> dist(lower, upper);
             return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
         }
 
         template <class T, class I, std::size_t L, class E>
         inline auto randint(const I (&shape)[L], T lower, T upper, E& engine)
         {
-            std::uniform_int_distribution<T> dist(lower, T(upper - 1));
+            detail::bulk_uniform_int_distribution<T> dist(lower, T(upper - 1));
             return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
         }
 
         template <class T, class I, std::size_t L, class E>
         inline auto randn(const I (&shape)[L], T mean, T std_dev, E& engine)
         {
-            std::normal_distribution<T> dist(mean, std_dev);
+            detail::bulk_normal_distribution<T> dist(mean, std_dev);
+            return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
+        }
+
+        template <class T, class I, std::size_t L, class E>
+        inline auto binomial(const I (&shape)[L], T trials, double prob, E& engine)
+        {
+            std::binomial_distribution<T> dist(trials, prob);
+            return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
+        }
+
+        template <class T, class I, std::size_t L, class E>
+        inline auto poisson(const I (&shape)[L], double rate, E& engine)
+        {
+            std::poisson_distribution<T> dist(rate);
+            return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
+        }
+
+        template <class T, class I, std::size_t L, class E>
+        inline auto exponential(const I (&shape)[L], T rate, E& engine)
+        {
+            detail::bulk_exponential_distribution<T> dist(rate);
+            return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
+        }
+
+        template <class T, class I, std::size_t L, class E>
+        inline auto gamma(const I (&shape)[L], T alpha, T beta, E& engine)
+        {
+            std::gamma_distribution<T> dist(alpha, beta);
             return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
         }
 #endif
@@ -281,21 +1031,42 @@ namespace xt
                     swap(first[i], first[j]);
                 }
             }
-            else
+            else if (de.shape()[0] > 1)
             {
-                using size_type = typename T::size_type;
-                decltype(auto) buf = empty_like(view(de, 0));
-
-                for (size_type i = de.shape()[0] - 1; i > 0; --i)
-                {
-                    std::uniform_int_distribution<size_type> dist(0, i);
-                    size_type j = dist(engine);
+                auto indices = detail::shuffle_indices(de.shape()[0], engine);
+                detail::permute_rows(de, indices, has_data_interface<T>());
+            }
+        }
 
-                    buf = view(de, j);
-                    view(de, j) = view(de, i);
-                    view(de, i) = buf;
-                }
+        /**
+         * Returns a copy of @p e whose sub-arrays along the first axis are
+         * randomly shuffled, with the same permutation as \ref shuffle for
+         * the same state of @p engine.
+         *
+         * The permutation is generated first, then the rows are gathered in
+         * order into the new container, in parallel for large expressions.
+         * This is faster than shuffling a copy in place when the rows are
+         * large, at the cost of reading @p e in a random order.
+         *
+         * @param e expression to shuffle, with a shape and stored elements
+         * (a container or a view)
+         * @param engine random number engine
+         */
+        template <class T, class E>
+        typename T::temporary_type shuffled(const xexpression<T>& e, E& engine)
+        {
+            using result_type = typename T::temporary_type;
+            const T& de = e.derived_cast();
+            if (de.dimension() < 2 || de.shape()[0] < 2)
+            {
+                result_type res = de;
+                shuffle(res, engine);
+                return res;
             }
+            auto indices = detail::shuffle_indices(de.shape()[0], engine);
+            result_type res = result_type::from_shape(de.shape());
+            detail::gather_rows(de, res, indices, has_data_interface<T>());
+            return res;
         }
 
         /**
@@ -326,9 +1097,7 @@ namespace xt
         permutation(T&& e, E& engine)
         {
             using copy_type = std::decay_t<T>;
-            copy_type res = e;
-            shuffle(res, engine);
-            return res;
+            return detail::permutation_impl<copy_type>(e, engine, std::is_same<typename copy_type::temporary_type, copy_type>());
         }
         /// @endcond
 
@@ -384,6 +1153,277 @@ namespace xt
             }
             return result;
         }
+
+        /**
+         * Randomly select n elements from xexpression e, the element i being
+         * selected with a probability proportional to weights[i].
+         *
+         * With replacement, the elements are drawn from an alias table built
+         * in linear time, each draw being done in constant time. Without
+         * replacement, the selected elements are the n largest keys
+         * <tt>log(u) / weights[i]</tt>, where u is uniform in (0, 1), which
+         * is equivalent to selecting the elements one after the other.
+         * Only 1D data is accepted.
+         *
+         * @param e expression to sample from
+         * @param n number of elements to sample
+         * @param weights non-negative weights of the elements of e
+         * @param replace whether to sample with or without replacement
+         * @param engine random number engine
+         *
+         * @return xtensor containing 1D container of sampled elements
+         */
+        template <class T, class W, class E>
+        xtensor<typename T::value_type, 1> choice(const xexpression<T>& e, std::size_t n, const xexpression<W>& weights,
+                                                  bool replace, E& engine)
+        {
+            const auto& de = e.derived_cast();
+            const auto& dw = weights.derived_cast();
+            if (de.dimension() != 1 || dw.dimension() != 1)
+            {
+                throw std::runtime_error("Sample expression and weights must be 1 dimensional");
+            }
+            if (de.size() != dw.size())
+            {
+                throw std::runtime_error("Sample expression and weights must have the same size");
+            }
+            using result_type = xtensor<typename T::value_type, 1>;
+            using size_type = typename result_type::size_type;
+            size_type size = de.size();
+
+            std::vector<double> w(size);
+            double total = 0.;
+            size_type nb_positive = 0;
+            for (size_type i = 0; i < size; ++i)
+            {
+                w[i] = static_cast<double>(dw(i));
+                if (w[i] < 0. || !std::isfinite(w[i]))
+                {
+                    throw std::runtime_error("Weights must be non-negative and finite");
+                }
+                total += w[i];
+                nb_positive += w[i] > 0. ? 1 : 0;
+            }
+            if (nb_positive == 0 || (!replace && nb_positive < n))
+            {
+                throw std::runtime_error("Not enough elements with a positive weight to sample from");
+            }
+
+            result_type result;
+            result.resize({n});
+            std::uniform_real_distribution<double> uniform(0., 1.);
+            if (replace)
+            {
+                // Vose's alias method
+                std::vector<double> prob(size);
+                std::vector<size_type> alias(size, 0);
+                std::vector<size_type> underfull, overfull;
+                for (size_type i = 0; i < size; ++i)
+                {
+                    prob[i] = w[i] * static_cast<double>(size) / total;
+                    (prob[i] < 1. ? underfull : overfull).push_back(i);
+                }
+                while (!underfull.empty() && !overfull.empty())
+                {
+                    size_type s = underfull.back();
+                    size_type l = overfull.back();
+                    underfull.pop_back();
+                    alias[s] = l;
+                    prob[l] = (prob[l] + prob[s]) - 1.;
+                    if (prob[l] < 1.)
+                    {
+                        overfull.pop_back();
+                        underfull.push_back(l);
+                    }
+                }
+                // the remaining probabilities are 1 up to rounding errors
+                for (auto i : overfull)
+                {
+                    prob[i] = 1.;
+                }
+                for (auto i : underfull)
+                {
+                    prob[i] = 1.;
+                }
+
+                std::uniform_int_distribution<size_type> index(0, size - 1);
+                for (size_type k = 0; k < n; ++k)
+                {
+                    size_type i = index(engine);
+                    result[k] = de(uniform(engine) < prob[i] ? i : alias[i]);
+                }
+            }
+            else
+            {
+                std::vector<double> keys(size);
+                std::vector<size_type> indices(size);
+                for (size_type i = 0; i < size; ++i)
+                {
+                    double u = 1. - uniform(engine);
+                    keys[i] = w[i] > 0. ? std::log(u) / w[i] : -std::numeric_limits<double>::infinity();
+                    indices[i] = i;
+                }
+                std::partial_sort(indices.begin(), indices.begin() + static_cast<std::ptrdiff_t>(n), indices.end(),
+                                  [&keys](size_type lhs, size_type rhs) { return keys[lhs] > keys[rhs]; });
+                for (size_type k = 0; k < n; ++k)
+                {
+                    result[k] = de(indices[k]);
+                }
+            }
+            return result;
+        }
+
+        /********************************
+         * philox_engine implementation *
+         ********************************/
+
+        /**
+         * Builds an engine seeded with the default seed.
+         */
+        inline philox_engine::philox_engine()
+            : philox_engine(default_seed)
+        {
+        }
+
+        /**
+         * Builds an engine seeded with @p s.
+         */
+        inline philox_engine::philox_engine(std::uint64_t s)
+        {
+            seed(s);
+        }
+
+        /**
+         * Seeds the engine with @p s and resets it to the beginning of the
+         * first substream.
+         */
+        inline void philox_engine::seed(std::uint64_t s)
+        {
+            m_key = {{ static_cast<std::uint32_t>(s), static_cast<std::uint32_t>(s >> 32) }};
+            m_counter = {{ 0u, 0u, 0u, 0u }};
+            m_index = block_size;
+        }
+
+        inline auto philox_engine::operator()() -> result_type
+        {
+            if (m_index == block_size)
+            {
+                generate();
+                set_position(position() + 1);
+                m_index = 0;
+            }
+            return m_block[m_index++];
+        }
+
+        /**
+         * Advances the engine by @p n numbers in constant time.
+         */
+        inline void philox_engine::discard(unsigned long long n)
+        {
+            std::uint64_t available = static_cast<std::uint64_t>(block_size - m_index);
+            if (n <= available)
+            {
+                m_index += static_cast<std::size_t>(n);
+                return;
+            }
+            n -= available;
+            std::uint64_t blocks = static_cast<std::uint64_t>(n / block_size);
+            std::size_t remainder = static_cast<std::size_t>(n % block_size);
+            set_position(position() + blocks);
+            m_index = block_size;
+            if (remainder != 0)
+            {
+                (*this)();
+                m_index = remainder;
+            }
+        }
+
+        /**
+         * Returns an engine generating the @p i-th substream after the
+         * current one, from its beginning. The engine itself is not modified.
+         */
+        inline philox_engine philox_engine::substream(std::uint64_t i) const
+        {
+            philox_engine res(*this);
+            res.skip_substreams(i);
+            return res;
+        }
+
+        /**
+         * Moves the engine to the beginning of the @p n-th substream after
+         * the current one.
+         */
+        inline void philox_engine::skip_substreams(std::uint64_t n)
+        {
+            set_stream(stream() + n);
+            set_position(0);
+            m_index = block_size;
+        }
+
+        constexpr auto philox_engine::min() noexcept -> result_type
+        {
+            return 0u;
+        }
+
+        constexpr auto philox_engine::max() noexcept -> result_type
+        {
+            return 0xFFFFFFFFu;
+        }
+
+        inline bool philox_engine::operator==(const philox_engine& rhs) const noexcept
+        {
+            return m_key == rhs.m_key && m_counter == rhs.m_counter && m_index == rhs.m_index &&
+                (m_index == block_size || m_block == rhs.m_block);
+        }
+
+        inline bool philox_engine::operator!=(const philox_engine& rhs) const noexcept
+        {
+            return !(*this == rhs);
+        }
+
+        inline void philox_engine::generate() noexcept
+        {
+            constexpr std::uint64_t m0 = 0xD2511F53u;
+            constexpr std::uint64_t m1 = 0xCD9E8D57u;
+            constexpr std::uint32_t w0 = 0x9E3779B9u;
+            constexpr std::uint32_t w1 = 0xBB67AE85u;
+
+            block_type c = m_counter;
+            std::uint32_t k0 = m_key[0];
+            std::uint32_t k1 = m_key[1];
+            for (std::size_t round = 0; round < 10; ++round)
+            {
+                std::uint64_t p0 = m0 * c[0];
+                std::uint64_t p1 = m1 * c[2];
+                c = {{ static_cast<std::uint32_t>(p1 >> 32) ^ c[1] ^ k0, static_cast<std::uint32_t>(p1),
+                       static_cast<std::uint32_t>(p0 >> 32) ^ c[3] ^ k1, static_cast<std::uint32_t>(p0) }};
+                k0 += w0;
+                k1 += w1;
+            }
+            m_block = c;
+        }
+
+        inline void philox_engine::set_position(std::uint64_t position) noexcept
+        {
+            m_counter[0] = static_cast<std::uint32_t>(position);
+            m_counter[1] = static_cast<std::uint32_t>(position >> 32);
+        }
+
+        inline std::uint64_t philox_engine::position() const noexcept
+        {
+            return static_cast<std::uint64_t>(m_counter[0]) | (static_cast<std::uint64_t>(m_counter[1]) << 32);
+        }
+
+        inline std::uint64_t philox_engine::stream() const noexcept
+        {
+            return static_cast<std::uint64_t>(m_counter[2]) | (static_cast<std::uint64_t>(m_counter[3]) << 32);
+        }
+
+        inline void philox_engine::set_stream(std::uint64_t stream) noexcept
+        {
+            m_counter[2] = static_cast<std::uint32_t>(stream);
+            m_counter[3] = static_cast<std::uint32_t>(stream >> 32);
+        }
     }
 }
 
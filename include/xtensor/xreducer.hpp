@@ -11,25 +11,31 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <functional>
 #include <initializer_list>
 #include <iterator>
+#include <numeric>
 #include <stdexcept>
 #include <tuple>
 #include <type_traits>
 #include <utility>
-#ifdef X_OLD_CLANG
 #include <vector>
-#endif
 
 #include <xtl/xfunctional.hpp>
 #include <xtl/xsequence.hpp>
 
 #include "xbuilder.hpp"
+#include "xdispatch.hpp"
 #include "xeval.hpp"
 #include "xexpression.hpp"
 #include "xgenerator.hpp"
+#include "xinstrument.hpp"
 #include "xiterable.hpp"
+#include "xparallel.hpp"
 #include "xreducer.hpp"
+#include "xslice.hpp"
+#include "xtensor_forward.hpp"
+#include "xtensor_simd.hpp"
 #include "xutils.hpp"
 
 namespace xt
@@ -86,8 +92,523 @@ namespace xt
         using type = xtensor_fixed<result_type, typename fixed_xreducer_shape_type<fixed_shape<I...>, fixed_shape<X...>>::type, L>;
     };
 
-    template <class F, class E, class X>
-    inline auto reduce_immediate(F&& f, E&& e, X&& axes)
+    /***************************
+     * contiguous reduce utils *
+     ***************************/
+
+    namespace detail
+    {
+        // Detects reducing functors that can be applied on simd batches,
+        // either through a simd_apply method or through the batch operators.
+        template <class F, class B, class = void>
+        struct simd_reduce
+        {
+            static constexpr bool value = false;
+        };
+
+        template <class F, class B>
+        struct simd_reduce<F, B, void_t<decltype(std::declval<const F&>().simd_apply(std::declval<const B&>(),
+                                                                                      std::declval<const B&>()))>>
+        {
+            static constexpr bool value = true;
+
+            static B apply(const F& f, const B& lhs, const B& rhs)
+            {
+                return f.simd_apply(lhs, rhs);
+            }
+        };
+
+        template <class T, class B>
+        struct simd_reduce<std::plus<T>, B, void>
+        {
+            static constexpr bool value = true;
+
+            static B apply(const std::plus<T>&, const B& lhs, const B& rhs)
+            {
+                return lhs + rhs;
+            }
+        };
+
+        template <class T, class B>
+        struct simd_reduce<std::multiplies<T>, B, void>
+        {
+            static constexpr bool value = true;
+
+            static B apply(const std::multiplies<T>&, const B& lhs, const B& rhs)
+            {
+                return lhs * rhs;
+            }
+        };
+
+        // Detects init functors that can be applied on simd batches: the
+        // identity, or functors providing a unary simd_apply method.
+        template <class F, class B, class = void>
+        struct simd_init
+        {
+            static constexpr bool value = false;
+        };
+
+        template <class B>
+        struct simd_init<xtl::identity, B, void>
+        {
+            static constexpr bool value = true;
+
+            static const B& apply(const xtl::identity&, const B& b)
+            {
+                return b;
+            }
+        };
+
+        template <class F, class B>
+        struct simd_init<F, B, void_t<decltype(std::declval<const F&>().simd_apply(std::declval<const B&>()))>>
+        {
+            static constexpr bool value = true;
+
+            static B apply(const F& f, const B& b)
+            {
+                return f.simd_apply(b);
+            }
+        };
+
+        template <class R, class T, class RF, class IF>
+        struct use_simd_reduce
+        {
+            using batch_type = xsimd::simd_type<T>;
+            static constexpr bool value = xsimd::simd_traits<T>::size > 1 &&
+                                          std::is_same<R, T>::value &&
+                                          simd_init<std::decay_t<IF>, batch_type>::value &&
+                                          simd_reduce<std::decay_t<RF>, batch_type>::value;
+        };
+
+        // Detects reducing functors providing their own kernel for contiguous
+        // ranges, through a reduce_contiguous(first, n) method applying the
+        // init functor as well.
+        template <class RF, class T, class = void>
+        struct has_contiguous_reduce : std::false_type
+        {
+        };
+
+        template <class RF, class T>
+        struct has_contiguous_reduce<RF, T, void_t<decltype(std::declval<const RF&>().reduce_contiguous(std::declval<const T*>(),
+                                                                                                           std::size_t(0)))>>
+            : std::true_type
+        {
+        };
+
+        template <class R, class T, class RF, class IF, class MF>
+        inline R reduce_contiguous_impl(const T* first, std::size_t n, RF& reduce_fct, IF& init_fct,
+                                        MF& /*merge_fct*/, std::false_type /*simd*/)
+        {
+            R tmp = init_fct(*first);
+            return std::accumulate(first + 1, first + n, tmp, reduce_fct);
+        }
+
+#ifdef XTENSOR_USE_XSIMD
+        template <class R, class T, class RF, class IF, class MF>
+        inline R reduce_contiguous_impl(const T* first, std::size_t n, RF& reduce_fct, IF& init_fct,
+                                        MF& merge_fct, std::true_type /*simd*/)
+        {
+            using batch_type = xsimd::simd_type<T>;
+            using simd_reduce_type = simd_reduce<std::decay_t<RF>, batch_type>;
+            using simd_init_type = simd_init<std::decay_t<IF>, batch_type>;
+            constexpr std::size_t simd_size = batch_type::size;
+            if (n < 2 * simd_size)
+            {
+                return reduce_contiguous_impl<R>(first, n, reduce_fct, init_fct, merge_fct, std::false_type());
+            }
+
+            // each lane of the batch accumulates a partial result, the
+            // lanes are merged once the simd part has been consumed
+            std::size_t simd_end = n - n % simd_size;
+            batch_type acc = simd_init_type::apply(init_fct, xsimd::load_simd<T, T>(first, xsimd::unaligned_mode()));
+            for (std::size_t i = simd_size; i < simd_end; i += simd_size)
+            {
+                acc = simd_reduce_type::apply(reduce_fct, acc, xsimd::load_simd<T, T>(first + i, xsimd::unaligned_mode()));
+            }
+
+            alignas(XTENSOR_CACHE_LINE_SIZE) T lanes[simd_size];
+            acc.store_unaligned(lanes);
+            R res = lanes[0];
+            for (std::size_t i = 1; i < simd_size; ++i)
+            {
+                res = merge_fct(res, lanes[i]);
+            }
+            return std::accumulate(first + simd_end, first + n, res, reduce_fct);
+        }
+#endif
+
+        // Reducing functors with a kernel selected at runtime (see xdispatch.hpp),
+        // when the values are not transformed by the init functor
+        template <class RF>
+        struct is_dispatch_reduce_functor : std::false_type
+        {
+        };
+
+        template <class T>
+        struct is_dispatch_reduce_functor<std::plus<T>> : std::true_type
+        {
+        };
+
+        template <class T>
+        struct is_dispatch_reduce_functor<std::multiplies<T>> : std::true_type
+        {
+        };
+
+        template <class R, class T, class RF, class IF>
+        using use_dispatch_reduce = std::integral_constant<bool, is_dispatch_reduce_functor<std::decay_t<RF>>::value &&
+                                                                 std::is_same<std::decay_t<IF>, xtl::identity>::value &&
+                                                                 dispatch::is_kernel_type<R>::value &&
+                                                                 dispatch::is_kernel_type<T>::value>;
+
+        template <class R, class T, class RF, class IF, class MF>
+        inline R reduce_contiguous_generic(const T* first, std::size_t n, RF& reduce_fct, IF& init_fct, MF& merge_fct)
+        {
+#ifdef XTENSOR_USE_XSIMD
+            using use_simd = std::integral_constant<bool, use_simd_reduce<R, T, RF, IF>::value>;
+#else
+            using use_simd = std::false_type;
+#endif
+            return reduce_contiguous_impl<R>(first, n, reduce_fct, init_fct, merge_fct, use_simd());
+        }
+
+        template <class R, class T, class RF, class IF, class MF>
+        inline R reduce_contiguous_runtime(const T* first, std::size_t n, RF& reduce_fct, IF& init_fct,
+                                           MF& merge_fct, std::false_type /*dispatch*/)
+        {
+            return reduce_contiguous_generic<R>(first, n, reduce_fct, init_fct, merge_fct);
+        }
+
+        template <class R, class T, class RF, class IF, class MF>
+        inline R reduce_contiguous_runtime(const T* first, std::size_t n, RF& reduce_fct, IF& init_fct,
+                                           MF& merge_fct, std::true_type /*dispatch*/)
+        {
+            R res = R();
+            if (dispatch::reduce(reduce_fct, first, n, res))
+            {
+                return res;
+            }
+            return reduce_contiguous_generic<R>(first, n, reduce_fct, init_fct, merge_fct);
+        }
+
+        template <class R, class T, class RF, class IF, class MF>
+        inline R reduce_contiguous_dispatch(const T* first, std::size_t n, RF& reduce_fct, IF& init_fct,
+                                            MF& merge_fct, std::false_type /*own kernel*/)
+        {
+            return reduce_contiguous_runtime<R>(first, n, reduce_fct, init_fct, merge_fct,
+                                                use_dispatch_reduce<R, T, RF, IF>());
+        }
+
+        template <class R, class T, class RF, class IF, class MF>
+        inline R reduce_contiguous_dispatch(const T* first, std::size_t n, RF& reduce_fct, IF& /*init_fct*/,
+                                            MF& /*merge_fct*/, std::true_type /*own kernel*/)
+        {
+            return reduce_fct.reduce_contiguous(first, n);
+        }
+
+        // Reduces n > 0 contiguous elements, using simd batches when possible.
+        template <class R, class T, class RF, class IF, class MF>
+        inline R reduce_contiguous_serial(const T* first, std::size_t n, RF& reduce_fct, IF& init_fct,
+                                          MF& merge_fct, std::false_type /*pairwise*/)
+        {
+            using own_kernel = has_contiguous_reduce<std::decay_t<RF>, T>;
+            return reduce_contiguous_dispatch<R>(first, n, reduce_fct, init_fct, merge_fct, own_kernel());
+        }
+
+        // Pairwise reduction: the range is recursively split in halves until
+        // reaching blocks small enough to be linearly reduced (with simd batches
+        // when possible). The rounding error of a sum then grows in O(log(n))
+        // instead of O(n).
+        template <class R, class T, class RF, class IF, class MF>
+        inline R reduce_contiguous_serial(const T* first, std::size_t n, RF& reduce_fct, IF& init_fct,
+                                          MF& merge_fct, std::true_type /*pairwise*/)
+        {
+            constexpr std::size_t block_size = 128;
+            if (n <= block_size)
+            {
+                return reduce_contiguous_serial<R>(first, n, reduce_fct, init_fct, merge_fct, std::false_type());
+            }
+            std::size_t half = ((n / 2 + block_size - 1) / block_size) * block_size;
+            R lhs = reduce_contiguous_serial<R>(first, half, reduce_fct, init_fct, merge_fct, std::true_type());
+            R rhs = reduce_contiguous_serial<R>(first + half, n - half, reduce_fct, init_fct, merge_fct, std::true_type());
+            return merge_fct(lhs, rhs);
+        }
+
+        template <class R, class MF>
+        inline R merge_partials(const R* first, std::size_t n, MF& merge_fct, std::false_type /*pairwise*/)
+        {
+            R res = first[0];
+            for (std::size_t i = 1; i < n; ++i)
+            {
+                res = merge_fct(res, first[i]);
+            }
+            return res;
+        }
+
+        template <class R, class MF>
+        inline R merge_partials(const R* first, std::size_t n, MF& merge_fct, std::true_type /*pairwise*/)
+        {
+            if (n == 1)
+            {
+                return first[0];
+            }
+            std::size_t half = n / 2;
+            R lhs = merge_partials(first, half, merge_fct, std::true_type());
+            R rhs = merge_partials(first + half, n - half, merge_fct, std::true_type());
+            return merge_fct(lhs, rhs);
+        }
+
+        // Reduces n > 0 contiguous elements, splitting them into blocks reduced
+        // concurrently and merged afterwards. The number of blocks does not
+        // depend on the number of threads, so the result is deterministic.
+        template <class R, class T, class RF, class IF, class MF, class P>
+        inline R reduce_contiguous(const T* first, std::size_t n, RF& reduce_fct, IF& init_fct, MF& merge_fct, P pairwise)
+        {
+#if defined(XTENSOR_PARALLEL_ENABLED)
+            constexpr std::size_t max_blocks = 64;
+            if (parallel::use_parallel(n) && n >= 2 * max_blocks)
+            {
+                std::size_t block_size = std::max((n + max_blocks - 1) / max_blocks, parallel::grain(1));
+                std::size_t nblocks = (n + block_size - 1) / block_size;
+                // not a std::vector, whose bool specialization packs the partial
+                // results of concurrent blocks into the same words
+                uvector<R> partials(nblocks);
+                parallel_for(std::size_t(0), nblocks, std::size_t(1), [&](std::size_t b_first, std::size_t b_last)
+                {
+                    for (std::size_t b = b_first; b < b_last; ++b)
+                    {
+                        std::size_t offset = b * block_size;
+                        partials[b] = reduce_contiguous_serial<R>(first + offset, (std::min)(block_size, n - offset),
+                                                                  reduce_fct, init_fct, merge_fct, pairwise);
+                    }
+                });
+                return merge_partials(partials.data(), nblocks, merge_fct, pairwise);
+            }
+#endif
+            return reduce_contiguous_serial<R>(first, n, reduce_fct, init_fct, merge_fct, pairwise);
+        }
+
+        template <class R, class T, class RF, class IF, std::size_t... I>
+        inline R reduce_unrolled(const T* first, RF& reduce_fct, IF& init_fct, std::index_sequence<I...>)
+        {
+            R res = init_fct(first[0]);
+            using swallow = int[];
+            (void) swallow{0, (res = reduce_fct(res, first[I + 1]), 0)...};
+            return res;
+        }
+
+        // Complete reductions of small fixed shapes are unrolled at compile time
+        template <class R, std::size_t N, class T, class RF, class IF, class MF, class P>
+        inline R reduce_complete(const T* first, std::size_t /*n*/, RF& reduce_fct, IF& init_fct, MF& /*merge_fct*/,
+                                 P /*pairwise*/, std::true_type /*unrolled*/)
+        {
+            return reduce_unrolled<R>(first, reduce_fct, init_fct, std::make_index_sequence<N - 1>());
+        }
+
+        template <class R, std::size_t N, class T, class RF, class IF, class MF, class P>
+        inline R reduce_complete(const T* first, std::size_t n, RF& reduce_fct, IF& init_fct, MF& merge_fct,
+                                 P pairwise, std::false_type /*unrolled*/)
+        {
+            return reduce_contiguous<R>(first, n, reduce_fct, init_fct, merge_fct, pairwise);
+        }
+
+        // Reduces each of the n_out consecutive rows of row_size > 0 elements
+        // into one element of out.
+        template <class R, class T, class RF, class IF, class MF, class P>
+        inline void reduce_contiguous_rows(const T* first, std::size_t n_out, std::size_t row_size, R* out,
+                                           RF& reduce_fct, IF& init_fct, MF& merge_fct, P pairwise)
+        {
+#if defined(XTENSOR_PARALLEL_ENABLED)
+            if (n_out == 1)
+            {
+                *out = reduce_contiguous<R>(first, row_size, reduce_fct, init_fct, merge_fct, pairwise);
+                return;
+            }
+            if (parallel::use_parallel(n_out * row_size))
+            {
+                parallel_for(std::size_t(0), n_out, parallel::grain(row_size), [&](std::size_t o_first, std::size_t o_last)
+                {
+                    for (std::size_t o = o_first; o < o_last; ++o)
+                    {
+                        out[o] = reduce_contiguous_serial<R>(first + o * row_size, row_size,
+                                                             reduce_fct, init_fct, merge_fct, pairwise);
+                    }
+                });
+                return;
+            }
+#endif
+            for (std::size_t o = 0; o < n_out; ++o)
+            {
+                out[o] = reduce_contiguous_serial<R>(first + o * row_size, row_size,
+                                                     reduce_fct, init_fct, merge_fct, pairwise);
+            }
+        }
+
+        template <class R, class T, class RF>
+        inline void reduce_row_into(R* out, const T* row, std::size_t n, RF& reduce_fct, std::false_type /*simd*/)
+        {
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                out[j] = reduce_fct(out[j], row[j]);
+            }
+        }
+
+#ifdef XTENSOR_USE_XSIMD
+        template <class R, class T, class RF>
+        inline void reduce_row_into(R* out, const T* row, std::size_t n, RF& reduce_fct, std::true_type /*simd*/)
+        {
+            using batch_type = xsimd::simd_type<T>;
+            using simd_reduce_type = simd_reduce<std::decay_t<RF>, batch_type>;
+            constexpr std::size_t simd_size = batch_type::size;
+            std::size_t simd_end = n - n % simd_size;
+            for (std::size_t j = 0; j < simd_end; j += simd_size)
+            {
+                batch_type acc = xsimd::load_simd<T, T>(out + j, xsimd::unaligned_mode());
+                acc = simd_reduce_type::apply(reduce_fct, acc, xsimd::load_simd<T, T>(row + j, xsimd::unaligned_mode()));
+                acc.store_unaligned(out + j);
+            }
+            reduce_row_into(out + simd_end, row + simd_end, n - simd_end, reduce_fct, std::false_type());
+        }
+#endif
+
+        // Reduces n_rows rows of row_size contiguous elements, separated by
+        // row_stride elements, into the row_size elements of out. Columns are
+        // processed by blocks small enough for the partial results to stay in
+        // the L1 cache while the rows are streamed; blocks are distributed
+        // over the parallel backend.
+        template <class R, class T, class RF, class IF>
+        inline void reduce_strided_rows(const T* first, std::size_t n_rows, std::size_t row_stride,
+                                        std::size_t row_size, R* out, bool merge, RF& reduce_fct, IF& init_fct)
+        {
+#ifdef XTENSOR_USE_XSIMD
+            using use_simd = std::integral_constant<bool, use_simd_reduce<R, T, RF, IF>::value>;
+#else
+            using use_simd = std::false_type;
+#endif
+            constexpr std::size_t block_size = XTENSOR_L1_CACHE_SIZE / (2 * sizeof(R)) > 0 ?
+                                               XTENSOR_L1_CACHE_SIZE / (2 * sizeof(R)) : std::size_t(1);
+            auto reduce_columns = [&](std::size_t col_first, std::size_t col_last)
+            {
+                for (std::size_t b = col_first; b < col_last; b += block_size)
+                {
+                    std::size_t n = (std::min)(block_size, col_last - b);
+                    R* block_out = out + b;
+                    const T* row = first + b;
+                    std::size_t i = 0;
+                    if (!merge)
+                    {
+                        // cast because return type of identity function is not upcasted
+                        std::transform(row, row + n, block_out, [&init_fct](const T& v) {
+                            return static_cast<R>(init_fct(v));
+                        });
+                        row += row_stride;
+                        ++i;
+                    }
+                    for (; i < n_rows; ++i, row += row_stride)
+                    {
+                        reduce_row_into(block_out, row, n, reduce_fct, use_simd());
+                    }
+                }
+            };
+#if defined(XTENSOR_PARALLEL_ENABLED)
+            if (row_size > block_size && parallel::use_parallel(n_rows * row_size))
+            {
+                parallel_for(std::size_t(0), row_size, parallel::grain(n_rows, block_size), reduce_columns);
+                return;
+            }
+#endif
+            reduce_columns(std::size_t(0), row_size);
+        }
+
+        // Copies the elements of e into dst, moving the reducing axes to the
+        // innermost position, so that each element of the result reduces a
+        // contiguous row of dst. The remaining axes keep the order in which
+        // they are laid out in the result.
+        template <class E, class X, class T>
+        inline void gather_reduced_axes(const E& e, const X& axes, T* dst)
+        {
+            std::size_t dim = e.dimension();
+            dynamic_shape<std::size_t> shape;
+            dynamic_shape<std::ptrdiff_t> strides;
+            shape.reserve(dim);
+            strides.reserve(dim);
+            auto push_axis = [&](std::size_t ax) {
+                shape.push_back(e.shape()[ax]);
+                strides.push_back(static_cast<std::ptrdiff_t>(e.strides()[ax]));
+            };
+            auto is_reduced = [&axes](std::size_t ax) {
+                return std::find(axes.cbegin(), axes.cend(), ax) != axes.cend();
+            };
+            // axes are pushed from the slowest to the fastest varying one
+            for (std::size_t i = 0; i < dim; ++i)
+            {
+                std::size_t ax = e.layout() == layout_type::row_major ? i : dim - 1 - i;
+                if (!is_reduced(ax))
+                {
+                    push_axis(ax);
+                }
+            }
+            for (std::size_t i = 0; i < dim; ++i)
+            {
+                std::size_t ax = e.layout() == layout_type::row_major ? i : dim - 1 - i;
+                if (is_reduced(ax))
+                {
+                    push_axis(ax);
+                }
+            }
+
+            const auto* src = e.data();
+            dynamic_shape<std::size_t> index(dim, std::size_t(0));
+            std::ptrdiff_t offset = 0;
+            std::size_t size = e.size();
+            for (std::size_t n = 0; n < size; ++n)
+            {
+                dst[n] = src[offset];
+                for (std::size_t i = dim; i > 0; --i)
+                {
+                    if (++index[i - 1] != shape[i - 1])
+                    {
+                        offset += strides[i - 1];
+                        break;
+                    }
+                    index[i - 1] = 0;
+                    offset -= static_cast<std::ptrdiff_t>(shape[i - 1] - 1) * strides[i - 1];
+                }
+            }
+        }
+
+        template <class E, class X>
+        inline bool reduces_inner_axes(const E& e, const X& axes)
+        {
+            std::size_t dim = e.dimension();
+            std::size_t naxes = axes.size();
+            if (e.layout() == layout_type::row_major)
+            {
+                for (std::size_t i = 0; i < naxes; ++i)
+                {
+                    if (std::size_t(axes[i]) != dim - naxes + i)
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            else if (e.layout() == layout_type::column_major)
+            {
+                for (std::size_t i = 0; i < naxes; ++i)
+                {
+                    if (std::size_t(axes[i]) != i)
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            return false;
+        }
+    }
+
+    template <class F, class E, class X, class EVS = evaluation_strategy::immediate>
+    inline auto reduce_immediate(F&& f, E&& e, X&& axes, EVS = EVS())
     {
         using shape_type = typename xreducer_shape_type<typename std::decay_t<E>::shape_type, std::decay_t<X>>::type;
 
@@ -99,6 +620,8 @@ namespace xt
         using result_type = std::decay_t<decltype(std::declval<reduce_functor_type>()(
             std::declval<init_functor_type>()(std::declval<expr_value_type>()), std::declval<expr_value_type>()))>;
 
+        using pairwise = std::integral_constant<bool, std::is_base_of<evaluation_strategy::accurate, EVS>::value>;
+
         // retrieve functors from triple struct
         auto reduce_fct = std::get<0>(f);
         auto init_fct = std::get<1>(f);
@@ -112,6 +635,8 @@ namespace xt
 
         using result_container_type = typename xreducer_result_container<std::decay_t<E>, X, result_type>::type;
         result_container_type result;
+        XTENSOR_INSTRUMENT_SCOPE(instrument::event_kind::reduce_immediate, e, std::decay_t<E>,
+                                 e.size() * sizeof(expr_value_type));
 
         if (!std::is_sorted(axes.cbegin(), axes.cend()))
         {
@@ -125,10 +650,10 @@ namespace xt
         // Fast track for complete reduction
         if (e.dimension() == axes.size())
         {
-            auto begin = e.storage().begin();
-            result_type tmp = init_fct(*begin);
-            ++begin;
-            result.data()[0] = std::accumulate(begin, e.storage().end(), tmp, reduce_fct);
+            constexpr std::size_t fixed_size = detail::fixed_shape_size<typename std::decay_t<E>::shape_type>::value;
+            using unrolled = std::integral_constant<bool, fixed_size != 0 && fixed_size <= XTENSOR_FIXED_UNROLL_SIZE>;
+            result.data()[0] = detail::reduce_complete<result_type, fixed_size>(e.data(), e.size(), reduce_fct, init_fct,
+                                                                                merge_fct, pairwise(), unrolled());
             return result;
         }
 
@@ -145,6 +670,29 @@ namespace xt
 
         result.resize(result_shape, e.layout());
 
+        // Fast track for reductions over the innermost axes: each element of the
+        // result reduces a contiguous range of the expression.
+        if (e.size() != 0 && detail::reduces_inner_axes(e, axes))
+        {
+            std::size_t n_out = result.size();
+            detail::reduce_contiguous_rows<result_type>(e.data(), n_out, e.size() / n_out, result.data(),
+                                                        reduce_fct, init_fct, merge_fct, pairwise());
+            return result;
+        }
+
+        // Accurate reductions over other axes work on a copy where the reducing
+        // axes are innermost, so that every reduction can be done pairwise.
+        if (pairwise::value && e.size() != 0 &&
+            (e.layout() == layout_type::row_major || e.layout() == layout_type::column_major))
+        {
+            uvector<expr_value_type> tmp(e.size());
+            detail::gather_reduced_axes(e, axes, tmp.data());
+            std::size_t n_out = result.size();
+            detail::reduce_contiguous_rows<result_type>(tmp.data(), n_out, e.size() / n_out, result.data(),
+                                                        reduce_fct, init_fct, merge_fct, pairwise());
+            return result;
+        }
+
         std::size_t leading_ax = axes[(e.layout() == layout_type::row_major) ? axes.size() - 1 : 0];
         auto strides_finder = e.strides().begin() + static_cast<std::ptrdiff_t>(leading_ax);
         // The computed strides contain "0" where the shape is 1 -- therefore find the next none-zero number
@@ -251,11 +799,9 @@ namespace xt
         {
             while (idx_res.first != true)
             {
-                // for unknown reasons it's much faster to use a temporary variable and
-                // std::accumulate here -- probably some cache behavior
-                result_type tmp;
-                tmp = init_fct(*begin);
-                tmp = std::accumulate(begin + 1, begin + outer_loop_size, tmp, reduce_fct);
+                // the merged outer loop is contiguous, it is reduced with simd batches when possible
+                result_type tmp = detail::reduce_contiguous_serial<result_type>(begin, outer_loop_size, reduce_fct,
+                                                                                init_fct, merge_fct, std::false_type());
 
                 // use merge function if necessary
                 *out = merge ? merge_fct(*out, tmp) : tmp;
@@ -282,20 +828,11 @@ namespace xt
         {
             while (idx_res.first != true)
             {
-                std::transform(out, out + inner_loop_size, begin, out,
-                               [merge, &init_fct, &reduce_fct](auto&& v1, auto&& v2) {
-                                    return merge ?
-                                        reduce_fct(v1, v2) :
-                                        // cast because return type of identity function is not upcasted
-                                        static_cast<result_type>(init_fct(v2));
-                               });
-
-                begin += inner_stride;
-                for (std::size_t i = 1; i < outer_loop_size; ++i)
-                {
-                    std::transform(out, out + inner_loop_size, begin, out, reduce_fct);
-                    begin += inner_stride;
-                }
+                // rows of the reduced axes are contiguous, they are accumulated
+                // into the result by cache-sized blocks
+                detail::reduce_strided_rows<result_type>(begin, outer_loop_size, inner_stride, inner_loop_size,
+                                                         out, merge, reduce_fct, init_fct);
+                begin += inner_stride * outer_loop_size;
 
                 idx_res = next_idx();
                 next_stride = idx_res.second;
@@ -532,6 +1069,9 @@ namespace xt
         shape_type m_dim_mapping;
 
         friend class xreducer_stepper<F, CT, X>;
+
+        template <class E1, class E2, class Enable>
+        friend class reducer_view_assigner;
     };
 
     /*************************
@@ -540,6 +1080,73 @@ namespace xt
 
     namespace detail
     {
+        // Detects reducing functors consuming the blocks of bit-packed flags
+        // in complete reductions, through a reduce_bitset(blocks, size) method.
+        template <class RF, class B, class = void>
+        struct has_bitset_reduce : std::false_type
+        {
+        };
+
+        template <class RF, class B>
+        struct has_bitset_reduce<RF, B, void_t<decltype(std::declval<const RF&>().reduce_bitset(std::declval<const B*>(),
+                                                                                                   std::size_t(0)))>>
+            : std::true_type
+        {
+        };
+
+        template <class RF, class E, class R>
+        inline bool reduce_bitset(const RF& reduce_fct, const E& e, R& res, std::true_type /*block reduction*/)
+        {
+            res = reduce_fct.reduce_bitset(e.storage().data(), static_cast<std::size_t>(e.size()));
+            return true;
+        }
+
+        template <class RF, class E, class R>
+        inline bool reduce_bitset(const RF& /*reduce_fct*/, const E& /*e*/, R& /*res*/, std::false_type /*block reduction*/)
+        {
+            return false;
+        }
+
+        template <class F, class E, class X, class EVS>
+        inline auto reduce_immediate_source(F&& f, E&& e, X&& axes, EVS es, std::false_type /*bitset*/)
+        {
+            return reduce_immediate(std::forward<F>(f), std::forward<E>(e), std::forward<X>(axes), es);
+        }
+
+        // The storage of bit-packed flags holds blocks of bits instead of
+        // elements: the flags are reduced on a copy holding one bool per
+        // element, unless the functor reduces the blocks of a complete
+        // reduction.
+        template <class F, class E, class X, class EVS>
+        inline auto reduce_immediate_source(F&& f, E&& e, X&& axes, EVS es, std::true_type /*bitset*/)
+        {
+            using flags_type = std::decay_t<E>;
+            using copy_type = xarray<bool, flags_type::static_layout == layout_type::dynamic ? XTENSOR_DEFAULT_LAYOUT
+                                                                                           : flags_type::static_layout>;
+            using result_container_type = std::decay_t<decltype(reduce_immediate(std::forward<F>(f), std::declval<copy_type&>(),
+                                                                                 std::forward<X>(axes), es))>;
+            using reduce_functor_type = std::decay_t<decltype(std::get<0>(f))>;
+            using block_type = typename bitset_source<flags_type>::block_type;
+
+            if (axes.size() == e.dimension() && bitset_source<flags_type>::packed(e, static_cast<std::size_t>(e.size())))
+            {
+                result_container_type result;
+                if (reduce_bitset(std::get<0>(f), e, result.data()[0], has_bitset_reduce<reduce_functor_type, block_type>()))
+                {
+                    return result;
+                }
+            }
+            copy_type flags = e;
+            return reduce_immediate(std::forward<F>(f), flags, std::forward<X>(axes), es);
+        }
+
+        template <class F, class E, class X, class EVS>
+        inline auto reduce_immediate_source(F&& f, E&& e, X&& axes, EVS es)
+        {
+            return reduce_immediate_source(std::forward<F>(f), std::forward<E>(e), std::forward<X>(axes), es,
+                                           is_bitset_container<std::decay_t<E>>());
+        }
+
         template <class F, class E, class X>
         inline auto reduce_impl(F&& f, E&& e, X&& axes, evaluation_strategy::lazy)
         {
@@ -553,7 +1160,16 @@ namespace xt
         inline auto reduce_impl(F&& f, E&& e, X&& axes, evaluation_strategy::immediate)
         {
             decltype(auto) normalized_axes = normalize_axis(e, std::forward<X>(axes));
-            return reduce_immediate(std::forward<F>(f), eval(std::forward<E>(e)), std::forward<decltype(normalized_axes)>(normalized_axes));
+            return reduce_immediate_source(std::forward<F>(f), eval(std::forward<E>(e)), std::forward<decltype(normalized_axes)>(normalized_axes),
+                                           evaluation_strategy::immediate());
+        }
+
+        template <class F, class E, class X>
+        inline auto reduce_impl(F&& f, E&& e, X&& axes, evaluation_strategy::accurate)
+        {
+            decltype(auto) normalized_axes = normalize_axis(e, std::forward<X>(axes));
+            return reduce_immediate_source(std::forward<F>(f), eval(std::forward<E>(e)), std::forward<decltype(normalized_axes)>(normalized_axes),
+                                           evaluation_strategy::accurate());
         }
     }
 
@@ -1172,6 +1788,441 @@ namespace xt
     {
         return m_reducer->m_axes[i];
     }
+
+    /****************************************
+     * reducer_view_assigner implementation *
+     ****************************************/
+
+    namespace detail
+    {
+        // Selects, in the axis of the reduced expression matching the dimension
+        // k of the reducer, the indices of the corresponding slice of the view.
+        template <class T, class M>
+        inline std::enable_if_t<xtl::is_integral<T>::value, bool>
+        reducer_view_select(const T& s, std::vector<std::vector<std::size_t>>& indices, const M& mapping, std::size_t& k)
+        {
+            if (k == mapping.size())
+            {
+                return false;
+            }
+            indices[mapping[k++]].assign(1, static_cast<std::size_t>(s));
+            return true;
+        }
+
+        template <class T, class M>
+        inline bool reducer_view_select(const xnewaxis<T>&, std::vector<std::vector<std::size_t>>&, const M&, std::size_t&)
+        {
+            return true;
+        }
+
+        template <class SL, class M>
+        inline std::enable_if_t<!xtl::is_integral<SL>::value, bool>
+        reducer_view_select(const SL& s, std::vector<std::vector<std::size_t>>& indices, const M& mapping, std::size_t& k)
+        {
+            if (k == mapping.size())
+            {
+                return false;
+            }
+            std::vector<std::size_t>& ind = indices[mapping[k++]];
+            ind.resize(static_cast<std::size_t>(s.size()));
+            for (std::size_t i = 0; i != ind.size(); ++i)
+            {
+                ind[i] = static_cast<std::size_t>(s(i));
+            }
+            return true;
+        }
+
+        template <class S>
+        inline void reducer_view_step(S& stepper, std::size_t dim, std::size_t from, std::size_t to)
+        {
+            if (to > from)
+            {
+                stepper.step(dim, to - from);
+            }
+            else if (to < from)
+            {
+                stepper.step_back(dim, from - to);
+            }
+        }
+
+        // Reduces a gathered block whose reducing axes are laid out in row-major
+        // order, with the same sequence of reduce and merge calls as the stepper
+        // of the lazy reducer, so that both give the same result.
+        template <class R, class T, class RF, class IF, class MF>
+        inline R reduce_gathered(const T* first, const std::size_t* shape, const std::size_t* strides,
+                                 std::size_t nlevels, const RF& reduce_fct, const IF& init_fct, const MF& merge_fct)
+        {
+            if (nlevels == 1)
+            {
+                R res = init_fct(first[0]);
+                for (std::size_t i = 1; i != shape[0]; ++i)
+                {
+                    res = reduce_fct(res, first[i]);
+                }
+                return res;
+            }
+            R res = reduce_gathered<R>(first, shape + 1, strides + 1, nlevels - 1, reduce_fct, init_fct, merge_fct);
+            for (std::size_t i = 1; i != shape[0]; ++i)
+            {
+                res = merge_fct(res, reduce_gathered<R>(first + i * strides[0], shape + 1, strides + 1, nlevels - 1,
+                                                        reduce_fct, init_fct, merge_fct));
+            }
+            return res;
+        }
+    }
+
+    /**
+     * Assigns a view of a lazy reducer: the elements of the reduced expression
+     * contributing to the view are gathered in a buffer, in the order of the
+     * expression, where each element of the view reduces a contiguous block.
+     * The cost is proportional to the size of the view instead of going
+     * through the nested steppers of the reducer for each element. Views
+     * broadcast to a larger shape keep the generic assignment.
+     */
+    template <class E1, class CT, class... S>
+    class reducer_view_assigner<E1, xview<CT, S...>, std::enable_if_t<detail::is_xreducer<std::decay_t<CT>>::value>>
+    {
+    public:
+
+        static bool run(E1& e1, const xview<CT, S...>& v);
+    };
+
+    template <class E1, class CT, class... S>
+    inline bool reducer_view_assigner<E1, xview<CT, S...>, std::enable_if_t<detail::is_xreducer<std::decay_t<CT>>::value>>::run(E1& e1, const xview<CT, S...>& v)
+    {
+        using reducer_type = std::decay_t<CT>;
+        using value_type = typename reducer_type::value_type;
+        using source_value_type = typename reducer_type::xexpression_type::value_type;
+
+        const reducer_type& r = v.expression();
+        const auto& e = r.m_e;
+        std::size_t ndim = e.dimension();
+        std::size_t naxes = r.m_axes.size();
+        if (naxes == 0 || e.size() == 0 ||
+            !std::equal(e1.shape().cbegin(), e1.shape().cend(), v.shape().cbegin(), v.shape().cend()))
+        {
+            return false;
+        }
+
+        std::vector<std::vector<std::size_t>> indices(ndim);
+        std::size_t k = 0;
+        bool selected = true;
+        for_each([&](const auto& s) { selected = selected && detail::reducer_view_select(s, indices, r.m_dim_mapping, k); },
+                 v.slices());
+        if (!selected)
+        {
+            return false;
+        }
+        auto select_all = [&](std::size_t axis)
+        {
+            indices[axis].resize(static_cast<std::size_t>(e.shape()[axis]));
+            std::iota(indices[axis].begin(), indices[axis].end(), std::size_t(0));
+        };
+        for (; k != r.m_dim_mapping.size(); ++k)
+        {
+            select_all(static_cast<std::size_t>(r.m_dim_mapping[k]));
+        }
+        for (auto axis : r.m_axes)
+        {
+            select_all(static_cast<std::size_t>(axis));
+        }
+
+        // the kept axes of the expression are outer in the buffer, the
+        // reducing axes inner, in the order of the reducer
+        std::vector<std::size_t> order;
+        order.reserve(ndim);
+        for (auto mapped : r.m_dim_mapping)
+        {
+            order.push_back(static_cast<std::size_t>(mapped));
+        }
+        for (auto axis : r.m_axes)
+        {
+            order.push_back(static_cast<std::size_t>(axis));
+        }
+        std::vector<std::size_t> strides(ndim);
+        std::size_t size = 1;
+        for (std::size_t i = ndim; i != 0; --i)
+        {
+            strides[order[i - 1]] = size;
+            size *= indices[order[i - 1]].size();
+        }
+        if (size == 0)
+        {
+            return false;
+        }
+        std::vector<std::size_t> reduced_shape(naxes), reduced_strides(naxes);
+        std::size_t block_size = 1;
+        for (std::size_t i = 0; i != naxes; ++i)
+        {
+            std::size_t axis = static_cast<std::size_t>(r.m_axes[i]);
+            reduced_shape[i] = indices[axis].size();
+            reduced_strides[i] = strides[axis];
+            block_size *= reduced_shape[i];
+        }
+
+        // gathers the region in the order of the expression
+        uvector<source_value_type> buffer(size);
+        auto stepper = e.stepper_begin(e.shape());
+        std::vector<std::size_t> pos(ndim, 0);
+        for (std::size_t d = 0; d != ndim; ++d)
+        {
+            detail::reducer_view_step(stepper, d, 0, indices[d][0]);
+        }
+        std::size_t offset = 0;
+        for (std::size_t c = 0; c != size; ++c)
+        {
+            buffer[offset] = *stepper;
+            for (std::size_t d = ndim; d != 0; --d)
+            {
+                const std::vector<std::size_t>& ind = indices[d - 1];
+                std::size_t& p = pos[d - 1];
+                if (++p != ind.size())
+                {
+                    detail::reducer_view_step(stepper, d - 1, ind[p - 1], ind[p]);
+                    offset += strides[d - 1];
+                    break;
+                }
+                detail::reducer_view_step(stepper, d - 1, ind[p - 1], ind[0]);
+                offset -= (ind.size() - 1) * strides[d - 1];
+                p = 0;
+            }
+        }
+
+        auto res = xarray<value_type>::from_shape(v.shape());
+        value_type* out = res.data();
+        const source_value_type* src = buffer.data();
+        std::size_t nout = size / block_size;
+        auto body = [&](std::size_t first, std::size_t last)
+        {
+            for (std::size_t o = first; o != last; ++o)
+            {
+                out[o] = detail::reduce_gathered<value_type>(src + o * block_size, reduced_shape.data(), reduced_strides.data(),
+                                                             naxes, r.m_reduce, r.m_init, r.m_merge);
+            }
+        };
+        if (parallel::use_parallel(size))
+        {
+            parallel_for(std::size_t(0), nout, parallel::grain(block_size), body);
+        }
+        else
+        {
+            body(std::size_t(0), nout);
+        }
+        assign_data(e1, res, true);
+        return true;
+    }
+
+    /************************
+     * xincremental_reducer *
+     ************************/
+
+    /**
+     * @class xincremental_reducer
+     * @brief Reducer folding chunks of data into a running result.
+     *
+     * The xincremental_reducer class holds the reduction of all the expressions
+     * passed to update so far, without storing them. Each chunk is reduced with
+     * the immediate evaluation strategy and merged into the running result with
+     * the merge function of the reducer, which is suitable for streaming data.
+     *
+     * @tparam F the xreducer_functors type of the reduction
+     * @tparam V the value type of the reduced expressions
+     * @sa make_incremental_reducer
+     */
+    template <class F, class V>
+    class xincremental_reducer
+    {
+    public:
+
+        using self_type = xincremental_reducer<F, V>;
+        using functors_type = F;
+        using reduce_functor_type = typename functors_type::reduce_functor_type;
+        using init_functor_type = typename functors_type::init_functor_type;
+        using merge_functor_type = typename functors_type::merge_functor_type;
+
+        using value_type = std::decay_t<decltype(std::declval<reduce_functor_type>()(
+            std::declval<init_functor_type>()(std::declval<V>()), std::declval<V>()))>;
+        using result_type = xarray<value_type>;
+        using axes_type = std::vector<std::size_t>;
+        using size_type = std::size_t;
+
+        explicit xincremental_reducer(const functors_type& f);
+        xincremental_reducer(const functors_type& f, axes_type axes);
+
+        template <class E>
+        self_type& update(const xexpression<E>& e);
+        void reset() noexcept;
+
+        bool empty() const noexcept;
+        size_type count() const noexcept;
+        const result_type& result() const;
+
+    private:
+
+        template <class R>
+        void merge_partial(const R& partial, size_type count);
+
+        functors_type m_functors;
+        axes_type m_axes;
+        bool m_full;
+        result_type m_result;
+        size_type m_count;
+    };
+
+    template <class V, class F>
+    auto make_incremental_reducer(F&& f);
+
+    template <class V, class F>
+    auto make_incremental_reducer(F&& f, std::vector<std::size_t> axes);
+
+    /***************************************
+     * xincremental_reducer implementation *
+     ***************************************/
+
+    /**
+     * @name Constructors
+     */
+    //@{
+    /**
+     * Builds an incremental reducer reducing the chunks over all their axes.
+     * @param f the functors of the reduction
+     */
+    template <class F, class V>
+    inline xincremental_reducer<F, V>::xincremental_reducer(const functors_type& f)
+        : m_functors(f), m_axes(), m_full(true), m_result(), m_count(0)
+    {
+    }
+
+    /**
+     * Builds an incremental reducer reducing the chunks over the given axes.
+     * All the chunks must then have the same shape along the remaining axes.
+     * @param f the functors of the reduction
+     * @param axes the axes along which the chunks are reduced
+     */
+    template <class F, class V>
+    inline xincremental_reducer<F, V>::xincremental_reducer(const functors_type& f, axes_type axes)
+        : m_functors(f), m_axes(std::move(axes)), m_full(false), m_result(), m_count(0)
+    {
+    }
+    //@}
+
+    /**
+     * Reduces the expression \c e and merges the result into the running result.
+     * Empty expressions are ignored.
+     * @param e the chunk to reduce
+     * @return a reference to the incremental reducer
+     */
+    template <class F, class V>
+    template <class E>
+    inline auto xincremental_reducer<F, V>::update(const xexpression<E>& e) -> self_type&
+    {
+        const E& de = e.derived_cast();
+        if (de.size() != 0)
+        {
+            if (m_full)
+            {
+                merge_partial(reduce(m_functors, de, evaluation_strategy::immediate()), de.size());
+            }
+            else
+            {
+                auto partial = reduce(m_functors, de, m_axes, evaluation_strategy::immediate());
+                size_type count = de.size() / partial.size();
+                merge_partial(partial, count);
+            }
+        }
+        return *this;
+    }
+
+    /**
+     * Discards the running result.
+     */
+    template <class F, class V>
+    inline void xincremental_reducer<F, V>::reset() noexcept
+    {
+        m_count = 0;
+    }
+
+    /**
+     * Returns true if no element has been reduced yet.
+     */
+    template <class F, class V>
+    inline bool xincremental_reducer<F, V>::empty() const noexcept
+    {
+        return m_count == 0;
+    }
+
+    /**
+     * Returns the number of elements reduced into each element of the result,
+     * for instance to compute a running mean from a running sum.
+     */
+    template <class F, class V>
+    inline auto xincremental_reducer<F, V>::count() const noexcept -> size_type
+    {
+        return m_count;
+    }
+
+    /**
+     * Returns the reduction of all the chunks passed to update.
+     * @throw std::runtime_error if no element has been reduced yet.
+     */
+    template <class F, class V>
+    inline auto xincremental_reducer<F, V>::result() const -> const result_type&
+    {
+        if (empty())
+        {
+            throw std::runtime_error("Incremental reducer: no element has been reduced.");
+        }
+        return m_result;
+    }
+
+    template <class F, class V>
+    template <class R>
+    inline void xincremental_reducer<F, V>::merge_partial(const R& partial, size_type count)
+    {
+        if (empty())
+        {
+            m_result = partial;
+        }
+        else
+        {
+            if (!same_shape(m_result.shape(), partial.shape()))
+            {
+                throw std::runtime_error("Incremental reducer: the shape of the reduced chunk does not match the result.");
+            }
+            auto merge_fct = std::get<2>(m_functors);
+            std::transform(m_result.cbegin(), m_result.cend(), partial.cbegin(), m_result.begin(), merge_fct);
+        }
+        m_count += count;
+    }
+
+    /**
+     * @brief Returns an \ref xincremental_reducer for the given reducing functors.
+     *
+     * @tparam V the value type of the expressions to reduce
+     * @param f the functors of the reduction, built with make_xreducer_functor
+     * @param axes the axes along which the chunks are reduced (optional, all axes
+     *        when omitted)
+     *
+     * \code{.cpp}
+     * auto running_max = xt::make_incremental_reducer<double>(
+     *     xt::make_xreducer_functor(xt::math::maximum<void>()), {0});
+     * for (const auto& batch : batches)
+     * {
+     *     running_max.update(batch);
+     * }
+     * \endcode
+     */
+    template <class V, class F>
+    inline auto make_incremental_reducer(F&& f)
+    {
+        return xincremental_reducer<std::decay_t<F>, V>(std::forward<F>(f));
+    }
+
+    template <class V, class F>
+    inline auto make_incremental_reducer(F&& f, std::vector<std::size_t> axes)
+    {
+        return xincremental_reducer<std::decay_t<F>, V>(std::forward<F>(f), std::move(axes));
+    }
 }
 
 #endif
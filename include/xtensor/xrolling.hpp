@@ -0,0 +1,245 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_ROLLING_HPP
+#define XTENSOR_ROLLING_HPP
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "xarray.hpp"
+#include "xassign.hpp"
+#include "xmanipulation.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+    /**
+     * @defgroup rolling_functions Rolling functions
+     *
+     * The rolling functions compute statistics of the sliding windows of an
+     * expression along an axis, in the same layout as the windows of
+     * \ref sliding_window_view, in O(n) operations instead of O(n * window)
+     * for a reduction of the window view.
+     */
+
+    namespace detail
+    {
+        // Calls f with a row-major buffer of the elements of e: the data of
+        // contiguous row-major expressions, a row-major copy otherwise.
+        template <class E, class F>
+        inline void rolling_source(const E& e, F&& f, std::true_type /*row-major buffer*/)
+        {
+            f(conversion_source<E>::data(e));
+        }
+
+        template <class E, class F>
+        inline void rolling_source(const E& e, F&& f, std::false_type /*row-major buffer*/)
+        {
+            xarray<typename E::value_type, layout_type::row_major> tmp = e;
+            f(tmp.data());
+        }
+
+        template <class E>
+        using rolling_row_major = std::integral_constant<bool, has_data_interface<E>::value && conversion_source<E>::value &&
+                                                               E::static_layout == layout_type::row_major>;
+
+        /**
+         * Applies kernel(x, y, n, m, inner) to each block of the row-major
+         * buffer of e that the axis splits, where x holds the n input and y the
+         * m = n - window + 1 output lines of inner contiguous elements.
+         */
+        template <class R, class E, class K>
+        inline xarray<R> rolling_apply(const xexpression<E>& expr, std::size_t window, std::size_t axis, K&& kernel)
+        {
+            const E& e = expr.derived_cast();
+            if (axis >= e.dimension())
+            {
+                throw std::runtime_error("rolling function: axis out of bounds");
+            }
+            std::size_t n = static_cast<std::size_t>(e.shape()[axis]);
+            if (window == 0 || window > n)
+            {
+                throw std::runtime_error("rolling function: window must be in [1, shape[axis]]");
+            }
+
+            dynamic_shape<std::size_t> shape(e.shape().cbegin(), e.shape().cend());
+            std::size_t m = n - window + 1;
+            shape[axis] = m;
+            xarray<R> res(shape);
+            if (res.size() == 0)
+            {
+                return res;
+            }
+
+            std::size_t outer = 1;
+            for (std::size_t i = 0; i < axis; ++i)
+            {
+                outer *= shape[i];
+            }
+            std::size_t inner = res.size() / (outer * m);
+
+            rolling_source(e, [&](const auto* src) {
+                R* dst = res.data();
+                for (std::size_t o = 0; o < outer; ++o)
+                {
+                    kernel(src + o * n * inner, dst + o * m * inner, n, m, inner);
+                }
+            }, rolling_row_major<E>());
+            return res;
+        }
+
+        // A window sum is derived from the previous one by adding the entering
+        // line and subtracting the leaving one; the inner loops are contiguous.
+        template <class R>
+        struct rolling_sum_kernel
+        {
+            std::size_t window;
+
+            template <class T>
+            void operator()(const T* x, R* y, std::size_t /*n*/, std::size_t m, std::size_t inner) const
+            {
+                for (std::size_t i = 0; i < inner; ++i)
+                {
+                    y[i] = R(0);
+                }
+                for (std::size_t k = 0; k < window; ++k)
+                {
+                    const T* line = x + k * inner;
+                    for (std::size_t i = 0; i < inner; ++i)
+                    {
+                        y[i] += static_cast<R>(line[i]);
+                    }
+                }
+                for (std::size_t k = 1; k < m; ++k)
+                {
+                    const R* prev = y + (k - 1) * inner;
+                    R* cur = y + k * inner;
+                    const T* in = x + (k + window - 1) * inner;
+                    const T* out = x + (k - 1) * inner;
+                    for (std::size_t i = 0; i < inner; ++i)
+                    {
+                        cur[i] = prev[i] + static_cast<R>(in[i]) - static_cast<R>(out[i]);
+                    }
+                }
+            }
+        };
+
+        // Monotone deque of the indices of the window: the front holds the
+        // extremum, the elements that cannot become the extremum of a later
+        // window are popped from the back.
+        template <class R, class C>
+        struct rolling_extremum_kernel
+        {
+            std::size_t window;
+            C comp;
+
+            template <class T>
+            void operator()(const T* x, R* y, std::size_t n, std::size_t /*m*/, std::size_t inner) const
+            {
+                std::vector<std::size_t> indices(n);
+                for (std::size_t i = 0; i < inner; ++i)
+                {
+                    const T* lane = x + i;
+                    std::size_t head = 0;
+                    std::size_t tail = 0;
+                    for (std::size_t k = 0; k < n; ++k)
+                    {
+                        while (tail > head && !comp(lane[indices[tail - 1] * inner], lane[k * inner]))
+                        {
+                            --tail;
+                        }
+                        indices[tail++] = k;
+                        if (indices[head] + window <= k)
+                        {
+                            ++head;
+                        }
+                        if (k + 1 >= window)
+                        {
+                            y[(k + 1 - window) * inner + i] = static_cast<R>(lane[indices[head] * inner]);
+                        }
+                    }
+                }
+            }
+        };
+    }
+
+    /**
+     * @ingroup rolling_functions
+     * @brief Sum of the sliding windows of \em e along \em axis.
+     *
+     * @param e an \ref xexpression
+     * @param window the size of the windows
+     * @param axis the axis along which the windows slide
+     * @return an \ref xarray<T> whose size along \em axis is the number of windows
+     */
+    template <class E>
+    inline auto rolling_sum(const xexpression<E>& e, std::size_t window, std::size_t axis)
+    {
+        using result_type = big_promote_type_t<typename E::value_type>;
+        return detail::rolling_apply<result_type>(e, window, axis, detail::rolling_sum_kernel<result_type>{window});
+    }
+
+    /**
+     * @ingroup rolling_functions
+     * @brief Mean of the sliding windows of \em e along \em axis.
+     *
+     * @param e an \ref xexpression
+     * @param window the size of the windows
+     * @param axis the axis along which the windows slide
+     * @return an \ref xarray<T> whose size along \em axis is the number of windows
+     */
+    template <class E>
+    inline auto rolling_mean(const xexpression<E>& e, std::size_t window, std::size_t axis)
+    {
+        using value_type = big_promote_type_t<typename E::value_type>;
+        using result_type = std::conditional_t<std::is_integral<value_type>::value, double, value_type>;
+        auto res = detail::rolling_apply<result_type>(e, window, axis, detail::rolling_sum_kernel<result_type>{window});
+        res /= static_cast<result_type>(window);
+        return res;
+    }
+
+    /**
+     * @ingroup rolling_functions
+     * @brief Minimum of the sliding windows of \em e along \em axis.
+     *
+     * @param e an \ref xexpression
+     * @param window the size of the windows
+     * @param axis the axis along which the windows slide
+     * @return an \ref xarray<T> whose size along \em axis is the number of windows
+     */
+    template <class E>
+    inline auto rolling_min(const xexpression<E>& e, std::size_t window, std::size_t axis)
+    {
+        using result_type = typename E::value_type;
+        using kernel_type = detail::rolling_extremum_kernel<result_type, std::less<>>;
+        return detail::rolling_apply<result_type>(e, window, axis, kernel_type{window, std::less<>()});
+    }
+
+    /**
+     * @ingroup rolling_functions
+     * @brief Maximum of the sliding windows of \em e along \em axis.
+     *
+     * @param e an \ref xexpression
+     * @param window the size of the windows
+     * @param axis the axis along which the windows slide
+     * @return an \ref xarray<T> whose size along \em axis is the number of windows
+     */
+    template <class E>
+    inline auto rolling_max(const xexpression<E>& e, std::size_t window, std::size_t axis)
+    {
+        using result_type = typename E::value_type;
+        using kernel_type = detail::rolling_extremum_kernel<result_type, std::greater<>>;
+        return detail::rolling_apply<result_type>(e, window, axis, kernel_type{window, std::greater<>()});
+    }
+}
+
+#endif
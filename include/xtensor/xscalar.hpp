@@ -9,6 +9,7 @@
 #ifndef XTENSOR_SCALAR_HPP
 #define XTENSOR_SCALAR_HPP
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <utility>
@@ -370,7 +371,14 @@ namespace xt
         template <class R>
         R step_simd();
 
+        template <class R>
+        R step_simd(size_type dim);
+
         value_type step_leading();
+        value_type step_leading(size_type dim);
+
+        template <class T>
+        void load_run(size_type dim, size_type n, T* out);
 
     private:
 
@@ -1063,6 +1071,27 @@ namespace xt
         return p_c->operator()();
     }
 
+    template <bool is_const, class CT>
+    template <class R>
+    inline R xscalar_stepper<is_const, CT>::step_simd(size_type /*dim*/)
+    {
+        return step_simd<R>();
+    }
+
+    template <bool is_const, class CT>
+    inline auto xscalar_stepper<is_const, CT>::step_leading(size_type /*dim*/)
+        -> value_type
+    {
+        return step_leading();
+    }
+
+    template <bool is_const, class CT>
+    template <class T>
+    inline void xscalar_stepper<is_const, CT>::load_run(size_type /*dim*/, size_type n, T* out)
+    {
+        std::fill(out, out + n, detail::convert_element<T>(p_c->operator()()));
+    }
+
     /**********************************
      * xdummy_iterator implementation *
      **********************************/
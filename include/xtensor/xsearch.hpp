@@ -0,0 +1,262 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_SEARCH_HPP
+#define XTENSOR_SEARCH_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "xparallel.hpp"
+#include "xtensor_config.hpp"
+
+namespace xt
+{
+    /**
+     * Side of the range of equal elements returned by searchsorted.
+     */
+    enum class search_side
+    {
+        left,
+        right
+    };
+
+    namespace detail
+    {
+        /***************************
+         * binary search in arrays *
+         ***************************/
+
+        // The searches below are used by searchsorted, interp and histogram.
+        // They only depend on contiguous buffers so that they can be used by
+        // any header without pulling in the containers.
+
+        template <bool Right>
+        struct search_compare
+        {
+            // true if the searched position is after x
+            template <class T, class V>
+            static bool after(const T& x, const V& v)
+            {
+                return x < v;
+            }
+        };
+
+        template <>
+        struct search_compare<true>
+        {
+            template <class T, class V>
+            static bool after(const T& x, const V& v)
+            {
+                return !(v < x);
+            }
+        };
+
+        // Branch-free binary search: the number of iterations only depends on
+        // n and the comparison results are used as offsets, which compiles to
+        // conditional moves. The queries are processed in interleaved groups so
+        // that the memory accesses of independent searches overlap.
+        template <bool Right, class T, class V>
+        inline void branchless_search(const T* sorted, std::size_t n, const V* values,
+                                      std::size_t m, std::size_t* out)
+        {
+            using cmp = search_compare<Right>;
+            constexpr std::size_t group = 8;
+            if (n == 0)
+            {
+                std::fill(out, out + m, std::size_t(0));
+                return;
+            }
+
+            std::size_t i = 0;
+            for (; i + group <= m; i += group)
+            {
+                std::array<const T*, group> base;
+                base.fill(sorted);
+                for (std::size_t len = n; len > 1;)
+                {
+                    std::size_t half = len / 2;
+                    for (std::size_t j = 0; j < group; ++j)
+                    {
+                        base[j] += cmp::after(base[j][half - 1], values[i + j]) ? half : 0;
+                    }
+                    len -= half;
+                }
+                for (std::size_t j = 0; j < group; ++j)
+                {
+                    out[i + j] = static_cast<std::size_t>(base[j] - sorted) +
+                                 (cmp::after(*base[j], values[i + j]) ? 1 : 0);
+                }
+            }
+            for (; i < m; ++i)
+            {
+                const T* base = sorted;
+                for (std::size_t len = n; len > 1;)
+                {
+                    std::size_t half = len / 2;
+                    base += cmp::after(base[half - 1], values[i]) ? half : 0;
+                    len -= half;
+                }
+                out[i] = static_cast<std::size_t>(base - sorted) + (cmp::after(*base, values[i]) ? 1 : 0);
+            }
+        }
+
+        // Copy of a sorted array in Eytzinger (breadth-first) order: the first
+        // levels of the implicit tree are shared by all the searches and stay
+        // in cache, which pays off for arrays that do not fit in the L1 cache.
+        template <class T>
+        class eytzinger_array
+        {
+        public:
+
+            eytzinger_array(const T* sorted, std::size_t n);
+
+            template <bool Right, class V>
+            void search(const V* values, std::size_t m, std::size_t* out) const;
+
+        private:
+
+            std::size_t fill(const T* sorted, std::size_t i, std::size_t k);
+
+            std::size_t m_size;
+            std::vector<T> m_keys;
+            std::vector<std::size_t> m_ranks;
+        };
+
+        template <class T>
+        inline eytzinger_array<T>::eytzinger_array(const T* sorted, std::size_t n)
+            : m_size(n), m_keys(n + 1), m_ranks(n + 1)
+        {
+            fill(sorted, 0, 1);
+        }
+
+        template <class T>
+        inline std::size_t eytzinger_array<T>::fill(const T* sorted, std::size_t i, std::size_t k)
+        {
+            if (k <= m_size)
+            {
+                i = fill(sorted, i, 2 * k);
+                m_keys[k] = sorted[i];
+                m_ranks[k] = i++;
+                i = fill(sorted, i, 2 * k + 1);
+            }
+            return i;
+        }
+
+        template <class T>
+        template <bool Right, class V>
+        inline void eytzinger_array<T>::search(const V* values, std::size_t m, std::size_t* out) const
+        {
+            using cmp = search_compare<Right>;
+            for (std::size_t i = 0; i < m; ++i)
+            {
+                std::size_t k = 1;
+                while (k <= m_size)
+                {
+                    k = 2 * k + (cmp::after(m_keys[k], values[i]) ? 1 : 0);
+                }
+                // the result is the last node where the search went left
+                while (k & 1)
+                {
+                    k >>= 1;
+                }
+                k >>= 1;
+                out[i] = k == 0 ? m_size : m_ranks[k];
+            }
+        }
+
+        // Search of sorted values by merging: each position is found by
+        // walking forward from the position of the previous value, so that
+        // the values of a chunk cost O(n + m) instead of O(m log(n)).
+        template <bool Right, class T, class V>
+        inline void merge_search(const T* sorted, std::size_t n, const V* values,
+                                 std::size_t m, std::size_t* out)
+        {
+            using cmp = search_compare<Right>;
+            if (m == 0)
+            {
+                return;
+            }
+            branchless_search<Right>(sorted, n, values, std::size_t(1), out);
+            std::size_t pos = out[0];
+            for (std::size_t i = 1; i < m; ++i)
+            {
+                while (pos < n && cmp::after(sorted[pos], values[i]))
+                {
+                    ++pos;
+                }
+                out[i] = pos;
+            }
+        }
+
+        /**
+         * Writes in \c out the positions where the m values should be inserted
+         * into the n sorted elements to keep them sorted, before (\c right false)
+         * or after (\c right true) the equal elements. Large batches of queries
+         * are split among threads. When the values are sorted and there are
+         * enough of them compared to n, the positions are found by merging.
+         */
+        template <class T, class V>
+        inline void search_sorted(const T* sorted, std::size_t n, const V* values, std::size_t m,
+                                  std::size_t* out, bool right)
+        {
+            // building the Eytzinger copy costs O(n), it is amortized
+            // when there are more queries than elements
+            bool use_merge = m >= n / 8 && std::is_sorted(values, values + m);
+            bool use_eytzinger = !use_merge && n * sizeof(T) > XTENSOR_L1_CACHE_SIZE && m >= n;
+            eytzinger_array<T> eytzinger(sorted, use_eytzinger ? n : std::size_t(0));
+
+            auto search = [&](std::size_t first, std::size_t last)
+            {
+                if (use_merge)
+                {
+                    if (right)
+                    {
+                        merge_search<true>(sorted, n, values + first, last - first, out + first);
+                    }
+                    else
+                    {
+                        merge_search<false>(sorted, n, values + first, last - first, out + first);
+                    }
+                }
+                else if (use_eytzinger)
+                {
+                    if (right)
+                    {
+                        eytzinger.template search<true>(values + first, last - first, out + first);
+                    }
+                    else
+                    {
+                        eytzinger.template search<false>(values + first, last - first, out + first);
+                    }
+                }
+                else if (right)
+                {
+                    branchless_search<true>(sorted, n, values + first, last - first, out + first);
+                }
+                else
+                {
+                    branchless_search<false>(sorted, n, values + first, last - first, out + first);
+                }
+            };
+
+            if (parallel::use_parallel(m))
+            {
+                parallel_for(std::size_t(0), m, parallel::grain(1), search);
+            }
+            else
+            {
+                search(std::size_t(0), m);
+            }
+        }
+    }
+}
+
+#endif
@@ -9,7 +9,12 @@
 #ifndef XTENSOR_SEMANTIC_HPP
 #define XTENSOR_SEMANTIC_HPP
 
+#include <cmath>
+#include <cstddef>
 #include <functional>
+#include <memory>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 
 #include "xassign.hpp"
@@ -225,6 +230,14 @@ namespace xt
 
         template <class E>
         derived_type& operator=(const xexpression<E>&);
+
+    private:
+
+        template <class E, class F>
+        derived_type& scalar_computed_assign_impl(const E& e, F&& f, std::true_type);
+
+        template <class E, class F>
+        derived_type& scalar_computed_assign_impl(const E& e, F&& f, std::false_type);
     };
 
     template <class E>
@@ -557,12 +570,186 @@ namespace xt
         return this->derived_cast().computed_assign(this->derived_cast() ^ e.derived_cast());
     }
 
+    template <class CT, class X>
+    class xbroadcast;
+
+    namespace detail
+    {
+        /**
+         * Conservative aliasing analysis: run returns false only when it can
+         * prove that the elements of the expression are not stored in the
+         * address range [first, last). Expressions with a data interface are
+         * checked against the range of their storage, functions and broadcasts
+         * recurse into their operands and any other expression is assumed to
+         * overlap.
+         */
+        template <class E, bool = has_data_interface<E>::value>
+        struct overlap_checker
+        {
+            static bool run(const E&, const void*, const void*) noexcept
+            {
+                return true;
+            }
+        };
+
+        inline bool address_ranges_overlap(const void* first1, const void* last1,
+                                           const void* first2, const void* last2) noexcept
+        {
+            std::less<const void*> less;
+            return less(first1, last2) && less(first2, last1);
+        }
+
+        template <class E>
+        struct overlap_checker<E, true>
+        {
+            static bool run(const E& e, const void* first, const void* last) noexcept
+            {
+                const auto* data = e.data();
+                return address_ranges_overlap(data, data + e.storage().size(), first, last);
+            }
+        };
+
+        template <class CT>
+        struct overlap_checker<xscalar<CT>, false>
+        {
+            static bool run(const xscalar<CT>& e, const void* first, const void* last) noexcept
+            {
+                if (!std::is_lvalue_reference<CT>::value)
+                {
+                    return false;
+                }
+                const auto* value = std::addressof(e());
+                return address_ranges_overlap(value, value + 1, first, last);
+            }
+        };
+
+        template <class F, class... CT>
+        struct overlap_checker<xfunction<F, CT...>, false>
+        {
+            static bool run(const xfunction<F, CT...>& e, const void* first, const void* last) noexcept
+            {
+                return run_impl(e.arguments(), first, last, std::make_index_sequence<sizeof...(CT)>());
+            }
+
+        private:
+
+            template <class T, std::size_t... I>
+            static bool run_impl(const T& arguments, const void* first, const void* last,
+                                 std::index_sequence<I...>) noexcept
+            {
+                bool res = false;
+                bool dummy[] = {false, (res = res || overlap_checker<std::decay_t<std::tuple_element_t<I, T>>>::run(std::get<I>(arguments), first, last))...};
+                (void) dummy;
+                return res;
+            }
+        };
+
+        template <class CT, class X>
+        struct overlap_checker<xbroadcast<CT, X>, false>
+        {
+            static bool run(const xbroadcast<CT, X>& e, const void* first, const void* last) noexcept
+            {
+                using expression_type = std::decay_t<decltype(e.expression())>;
+                return overlap_checker<expression_type>::run(e.expression(), first, last);
+            }
+        };
+
+        template <class D, class E>
+        inline bool may_overlap(const D& lhs, const E& rhs, std::true_type) noexcept
+        {
+            const auto* data = lhs.data();
+            return overlap_checker<E>::run(rhs, data, data + lhs.storage().size());
+        }
+
+        template <class D, class E>
+        inline bool may_overlap(const D&, const E&, std::false_type) noexcept
+        {
+            return true;
+        }
+
+        template <class D, class E>
+        inline bool may_overlap(const D& lhs, const E& rhs) noexcept
+        {
+            return may_overlap(lhs, rhs, has_data_interface<D>());
+        }
+
+        /**
+         * Elements stored as zero bytes: broadcasts of a zero integral or
+         * floating point scalar, such as xt::zeros. The fresh storages of the
+         * allocators returning zeroed memory already hold them.
+         */
+        template <class T>
+        inline std::enable_if_t<std::is_integral<T>::value, bool> is_zero_bytes(const T& value) noexcept
+        {
+            return value == T(0);
+        }
+
+        template <class T>
+        inline std::enable_if_t<std::is_floating_point<T>::value, bool> is_zero_bytes(const T& value) noexcept
+        {
+            return value == T(0) && !std::signbit(value);
+        }
+
+        template <class T>
+        inline std::enable_if_t<!std::is_arithmetic<T>::value, bool> is_zero_bytes(const T& /*value*/) noexcept
+        {
+            return false;
+        }
+
+        template <class E>
+        struct zero_fill_checker
+        {
+            static bool run(const E&) noexcept
+            {
+                return false;
+            }
+        };
+
+        template <class CT>
+        struct zero_fill_checker<xscalar<CT>>
+        {
+            static bool run(const xscalar<CT>& e) noexcept
+            {
+                return is_zero_bytes(e());
+            }
+        };
+
+        template <class CT, class X>
+        struct zero_fill_checker<xbroadcast<CT, X>>
+        {
+            static bool run(const xbroadcast<CT, X>& e) noexcept
+            {
+                using expression_type = std::decay_t<decltype(e.expression())>;
+                return zero_fill_checker<expression_type>::run(e.expression());
+            }
+        };
+
+        // Whether a container whose storage has just been allocated with A
+        // already holds the elements of e
+        template <class A, class E>
+        inline bool holds_zero_fill(const E& e) noexcept
+        {
+            return allocates_zeros<A>::value && zero_fill_checker<E>::run(e);
+        }
+    }
+
+    /**
+     * Assigns the xexpression \c e to \c *this. When the elements of \c *this
+     * may be involved in \c e, the expression is first evaluated into a
+     * temporary; otherwise it is assigned directly, as with noalias.
+     * @param e the xexpression to assign.
+     * @return a reference to \c *this.
+     */
     template <class D>
     template <class E>
     inline auto xsemantic_base<D>::operator=(const xexpression<E>& e) -> derived_type&
     {
-        temporary_type tmp(e);
-        return this->derived_cast().assign_temporary(std::move(tmp));
+        if (detail::may_overlap(this->derived_cast(), e.derived_cast()))
+        {
+            temporary_type tmp(e);
+            return this->derived_cast().assign_temporary(std::move(tmp));
+        }
+        return this->assign(e);
     }
 
     /**************************************
@@ -668,6 +855,21 @@ namespace xt
     template <class D>
     template <class E, class F>
     inline auto xview_semantic<D>::scalar_computed_assign(const E& e, F&& f) -> derived_type&
+    {
+        return scalar_computed_assign_impl(e, std::forward<F>(f), detail::use_scalar_function_assign<D>());
+    }
+
+    template <class D>
+    template <class E, class F>
+    inline auto xview_semantic<D>::scalar_computed_assign_impl(const E& e, F&& f, std::true_type) -> derived_type&
+    {
+        xt::scalar_computed_assign(*this, e, std::forward<F>(f));
+        return this->derived_cast();
+    }
+
+    template <class D>
+    template <class E, class F>
+    inline auto xview_semantic<D>::scalar_computed_assign_impl(const E& e, F&& f, std::false_type) -> derived_type&
     {
         D& d = this->derived_cast();
 
@@ -24,7 +24,7 @@
 namespace xt
 {
     template <class T>
-    using dynamic_shape = svector<T, 4>;
+    using dynamic_shape = svector<T, XTENSOR_DEFAULT_SHAPE_CAPACITY>;
 
     template <class T, std::size_t N>
     using static_shape = std::array<T, N>;
@@ -195,6 +195,23 @@ namespace xt
             static constexpr bool value = true;
         };
 
+        // number of elements of a fixed shape, 0 for other shapes
+        template <class S>
+        struct fixed_shape_size : std::integral_constant<std::size_t, 0>
+        {
+        };
+
+        template <>
+        struct fixed_shape_size<fixed_shape<>> : std::integral_constant<std::size_t, 1>
+        {
+        };
+
+        template <std::size_t N, std::size_t... M>
+        struct fixed_shape_size<fixed_shape<N, M...>>
+            : std::integral_constant<std::size_t, N * fixed_shape_size<fixed_shape<M...>>::value>
+        {
+        };
+
         template <class S>
         struct is_scalar_shape
         {
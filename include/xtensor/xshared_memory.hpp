@@ -0,0 +1,232 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_SHARED_MEMORY_HPP
+#define XTENSOR_SHARED_MEMORY_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "xtensor/xadapt.hpp"
+#include "xtensor/xfile_mapping.hpp"
+#include "xtensor/xnpy.hpp"
+#include "xtensor/xstrides.hpp"
+
+namespace xt
+{
+    namespace detail
+    {
+        /************************
+         * shared_tensor_header *
+         ************************/
+
+        // Header at the beginning of a shared memory object holding a tensor,
+        // followed by the shape and the strides (in elements), and then by the
+        // elements at data_offset. ready is set last, once the elements are
+        // written, so that consumers never see a partially published tensor.
+        struct shared_tensor_header
+        {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t dimension;
+            std::uint64_t data_offset;
+            std::uint64_t size;
+            char typestring[16];
+            std::atomic<std::uint32_t> ready;
+            std::uint32_t reserved;
+        };
+
+        constexpr char shared_tensor_magic[8] = {'\x93', 'X', 'T', 'S', 'H', 'M', '\0', '\0'};
+        constexpr std::uint32_t shared_tensor_version = 1;
+        // the elements are aligned on a cache line
+        constexpr std::size_t shared_tensor_alignment = 64;
+
+        inline std::size_t shared_tensor_data_offset(std::size_t dimension)
+        {
+            std::size_t n = sizeof(shared_tensor_header) + 2 * dimension * sizeof(std::uint64_t);
+            return (n + shared_tensor_alignment - 1) / shared_tensor_alignment * shared_tensor_alignment;
+        }
+
+        inline std::uint64_t* shared_tensor_dims(char* data)
+        {
+            return reinterpret_cast<std::uint64_t*>(data + sizeof(shared_tensor_header));
+        }
+
+        template <class T>
+        inline void check_shared_tensor_type()
+        {
+            static_assert(std::is_trivially_copyable<T>::value,
+                          "shared tensors only hold trivially copyable values");
+            static_assert(std::is_standard_layout<shared_tensor_header>::value,
+                          "the header of shared tensors must be standard layout");
+        }
+    }
+
+    /**
+     * Publishes an expression in a named shared memory object, so that other
+     * processes can map it without copy with open_shared. The object holds
+     * a header (shape, strides and type of the elements) followed by the
+     * elements, the tensor is visible to the consumers once it is fully
+     * written. The name must not be in use; on POSIX systems, the object
+     * outlives the process until it is removed with remove_shared.
+     *
+     * The returned adaptor is mapped on the shared elements: modifications
+     * are seen by the consumers, it is up to the user to synchronize them.
+     *
+     * @param name the name of the shared memory object
+     * @param e the \ref xexpression to publish
+     * @param l the layout of the published elements, row_major or column_major
+     * @return xarray_adaptor over the shared elements
+     */
+    template <class E>
+    inline auto publish_shared(const std::string& name, const xexpression<E>& e,
+                               layout_type l = layout_type::row_major)
+    {
+        using value_type = std::decay_t<typename E::value_type>;
+        detail::check_shared_tensor_type<value_type>();
+        if (l != layout_type::row_major && l != layout_type::column_major)
+        {
+            throw std::runtime_error("publish_shared: the layout must be row_major or column_major");
+        }
+        std::string typestring = detail::build_typestring<value_type>();
+        if (typestring.size() >= sizeof(detail::shared_tensor_header::typestring))
+        {
+            throw std::runtime_error("publish_shared: unsupported value type "s + typestring);
+        }
+
+        const E& de = e.derived_cast();
+        std::vector<std::size_t> shape(de.shape().cbegin(), de.shape().cend());
+        std::vector<std::size_t> strides(shape.size());
+        std::size_t size = compute_strides(shape, l, strides);
+        std::size_t offset = detail::shared_tensor_data_offset(shape.size());
+
+        // the object is zero filled, the tensor is not ready until the end
+        auto mapping = std::make_shared<detail::shared_memory_mapping>(name, offset + size * sizeof(value_type));
+        auto* header = new (mapping->data()) detail::shared_tensor_header();
+        std::memcpy(header->magic, detail::shared_tensor_magic, sizeof(header->magic));
+        header->version = detail::shared_tensor_version;
+        header->dimension = static_cast<std::uint32_t>(shape.size());
+        header->data_offset = static_cast<std::uint64_t>(offset);
+        header->size = static_cast<std::uint64_t>(size);
+        std::memcpy(header->typestring, typestring.c_str(), typestring.size());
+        std::uint64_t* dims = detail::shared_tensor_dims(mapping->data());
+        for (std::size_t i = 0; i != shape.size(); ++i)
+        {
+            dims[i] = static_cast<std::uint64_t>(shape[i]);
+            dims[shape.size() + i] = static_cast<std::uint64_t>(strides[i]);
+        }
+
+        value_type* ptr = reinterpret_cast<value_type*>(mapping->data() + offset);
+        detail::mapping_allocator<value_type> alloc(mapping, ptr);
+        auto res = adapt(std::move(ptr), size, acquire_ownership(), std::move(shape), std::move(strides), alloc);
+        try
+        {
+            noalias(res) = de;
+        }
+        catch (...)
+        {
+            detail::remove_shared_memory(name);
+            throw;
+        }
+        header->ready.store(1, std::memory_order_release);
+        return res;
+    }
+
+    /**
+     * Maps a tensor published with publish_shared by this or another
+     * process. Nothing is copied: the returned adaptor is mapped read-only
+     * on the shared elements, which must not be modified. The object can
+     * be removed while it is mapped, it is released with the last mapping.
+     *
+     * @param name the name of the shared memory object
+     * @tparam T the type of the published elements (there is no conversion
+     *           if the types do not match)
+     * @return xarray_adaptor over the shared elements
+     * @throw std::runtime_error if the object does not exist, is not
+     *        published yet or does not hold a tensor of \a T
+     */
+    template <class T>
+    inline auto open_shared(const std::string& name)
+    {
+        detail::check_shared_tensor_type<T>();
+        auto mapping = std::make_shared<detail::shared_memory_mapping>(name);
+        if (mapping->size() < sizeof(detail::shared_tensor_header))
+        {
+            throw std::runtime_error("IO Error: invalid shared tensor: "s + name);
+        }
+        const auto* header = reinterpret_cast<const detail::shared_tensor_header*>(mapping->data());
+        if (header->ready.load(std::memory_order_acquire) == 0)
+        {
+            throw std::runtime_error("IO Error: shared tensor is not published yet: "s + name);
+        }
+        if (std::memcmp(header->magic, detail::shared_tensor_magic, sizeof(header->magic)) != 0 ||
+            header->version != detail::shared_tensor_version)
+        {
+            throw std::runtime_error("IO Error: invalid shared tensor: "s + name);
+        }
+        const char* ts_end = std::find(header->typestring, header->typestring + sizeof(header->typestring), '\0');
+        std::string typestring(header->typestring, ts_end);
+        if (typestring != detail::build_typestring<T>())
+        {
+            throw std::runtime_error("Cast error: formats not matching "s + typestring +
+                                     " vs "s + detail::build_typestring<T>());
+        }
+
+        std::size_t dimension = header->dimension;
+        std::size_t offset = static_cast<std::size_t>(header->data_offset);
+        std::size_t size = static_cast<std::size_t>(header->size);
+        if (offset != detail::shared_tensor_data_offset(dimension) ||
+            mapping->size() < offset || (mapping->size() - offset) / sizeof(T) < size)
+        {
+            throw std::runtime_error("IO Error: invalid shared tensor: "s + name);
+        }
+        const std::uint64_t* dims = detail::shared_tensor_dims(mapping->data());
+        std::vector<std::size_t> shape(dims, dims + dimension);
+        std::vector<std::size_t> strides(dims + dimension, dims + 2 * dimension);
+
+        // only the contiguous strides of the shape are accepted
+        std::vector<std::size_t> expected(dimension);
+        bool valid = compute_strides(shape, layout_type::row_major, expected) == size && expected == strides;
+        if (!valid && dimension > 1)
+        {
+            compute_strides(shape, layout_type::column_major, expected);
+            valid = expected == strides;
+        }
+        if (!valid)
+        {
+            throw std::runtime_error("IO Error: invalid shared tensor: "s + name);
+        }
+
+        T* ptr = reinterpret_cast<T*>(mapping->data() + offset);
+        detail::mapping_allocator<T> alloc(std::move(mapping), ptr);
+        return adapt(std::move(ptr), size, acquire_ownership(), std::move(shape), std::move(strides), alloc);
+    }
+
+    /**
+     * Removes a shared memory object created by publish_shared. The
+     * processes mapping it keep their mapping, the name can be published
+     * again right away.
+     *
+     * @param name the name of the shared memory object
+     */
+    inline void remove_shared(const std::string& name)
+    {
+        detail::remove_shared_memory(name);
+    }
+}
+
+#endif
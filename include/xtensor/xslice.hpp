@@ -349,6 +349,8 @@ namespace xt
 
         bool contains(size_type i) const noexcept;
 
+        const container_type& runs() const noexcept;
+
         bool operator==(const self_type& rhs) const noexcept;
         bool operator!=(const self_type& rhs) const noexcept;
 
@@ -358,6 +360,7 @@ namespace xt
 
         container_type m_indices;
         container_type m_raw_indices;
+        container_type m_runs;
 
         template <class S>
         friend class xkeep_slice;
@@ -471,6 +474,8 @@ namespace xt
 
         bool contains(size_type i) const noexcept;
 
+        const container_type& runs() const noexcept;
+
         bool operator==(const self_type& rhs) const noexcept;
         bool operator!=(const self_type& rhs) const noexcept;
 
@@ -481,6 +486,7 @@ namespace xt
         container_type m_indices;
         container_type m_raw_indices;
         std::map<size_type, size_type> m_inc;
+        container_type m_runs;
         size_type m_size;
 
         template <class S>
@@ -1257,6 +1263,32 @@ namespace xt
         return true;
     }
 
+    namespace detail
+    {
+        template <class S, class C>
+        inline void compute_runs(const S& slice, C& runs)
+        {
+            using size_type = typename C::value_type;
+            size_type sz = slice.size();
+            runs.clear();
+            if (sz != size_type(0))
+            {
+                runs.push_back(size_type(0));
+                size_type prev = slice(size_type(0));
+                for (size_type i = 1; i < sz; ++i)
+                {
+                    size_type cur = slice(i);
+                    if (cur != prev + 1)
+                    {
+                        runs.push_back(i);
+                    }
+                    prev = cur;
+                }
+            }
+            runs.push_back(sz);
+        }
+    }
+
     /******************************
      * xkeep_slice implementation *
      ******************************/
@@ -1296,6 +1328,9 @@ namespace xt
                        [](const T& val) { return static_cast<S>(val); });
         std::transform(m_indices.cbegin(), m_indices.cend(), ret.m_indices.begin(),
                        [](const T& val) { return static_cast<S>(val); });
+        ret.m_runs.resize(m_runs.size());
+        std::transform(m_runs.cbegin(), m_runs.cend(), ret.m_runs.begin(),
+                       [](const T& val) { return static_cast<S>(val); });
         return ret;
     }
 
@@ -1315,6 +1350,7 @@ namespace xt
         {
             m_indices[i] = m_raw_indices[i] < 0 ? static_cast<std::ptrdiff_t>(shape) + m_raw_indices[i] : m_raw_indices[i];
         }
+        detail::compute_runs(*this, m_runs);
     }
 
     template <class T>
@@ -1362,6 +1398,19 @@ namespace xt
         return (std::find(m_indices.begin(), m_indices.end(), i) == m_indices.end()) ? false : true;
     }
 
+    /**
+     * Returns the positions in the slice where the runs of contiguous
+     * indices begin, followed by the size of the slice. The run \c k
+     * covers the positions <tt>[runs()[k], runs()[k + 1])</tt>, which map
+     * to consecutive indices of the underlying expression.
+     * The runs are computed when the slice is normalized.
+     */
+    template <class T>
+    inline auto xkeep_slice<T>::runs() const noexcept -> const container_type&
+    {
+        return m_runs;
+    }
+
     template <class T>
     inline bool xkeep_slice<T>::operator==(const self_type& rhs) const noexcept
     {
@@ -1413,6 +1462,9 @@ namespace xt
                        [](const T& val) { return static_cast<S>(val); });
         std::transform(m_inc.cbegin(), m_inc.cend(), std::inserter(ret.m_inc, ret.m_inc.begin()),
             [](const auto& val) { return std::make_pair(static_cast<S>(val.first), static_cast<S>(val.second)); });
+        ret.m_runs.resize(m_runs.size());
+        std::transform(m_runs.cbegin(), m_runs.cend(), ret.m_runs.begin(),
+                       [](const T& val) { return static_cast<S>(val); });
         ret.m_size = static_cast<S>(m_size);
         return ret;
     }
@@ -1449,6 +1501,7 @@ namespace xt
             m_inc[d - prev_cum] = cum;
             prev_cum = cum;
         }
+        detail::compute_runs(*this, m_runs);
     }
 
     template <class T>
@@ -1507,6 +1560,19 @@ namespace xt
         return (std::find(m_indices.begin(), m_indices.end(), i) == m_indices.end()) ? true : false;
     }
 
+    /**
+     * Returns the positions in the slice where the runs of contiguous
+     * indices begin, followed by the size of the slice. The run \c k
+     * covers the positions <tt>[runs()[k], runs()[k + 1])</tt>, which map
+     * to consecutive indices of the underlying expression.
+     * The runs are computed when the slice is normalized.
+     */
+    template <class T>
+    inline auto xdrop_slice<T>::runs() const noexcept -> const container_type&
+    {
+        return m_runs;
+    }
+
     template <class T>
     inline bool xdrop_slice<T>::operator==(const self_type& rhs) const noexcept
     {
@@ -10,16 +10,59 @@
 #define XTENSOR_SORT_HPP
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "xarray.hpp"
 #include "xeval.hpp"
 #include "xslice.hpp"  // for xnone
 #include "xmanipulation.hpp"
+#include "xparallel.hpp"
+#include "xsearch.hpp"
 #include "xtensor.hpp"
+#include "xtensor_simd.hpp"
 
 namespace xt
 {
+    /**
+     * Sorting algorithms that can be selected in sort and argsort.
+     */
+    namespace sorting_method
+    {
+        struct base
+        {
+        };
+        // radix sort for lanes of at least XTENSOR_RADIX_SORT_THRESHOLD
+        // arithmetic values that are not sorted in parallel, comparison
+        // sort otherwise
+        struct automatic : base
+        {
+        };
+        // std::sort based sort, parallelized for large lanes
+        struct comparison : base
+        {
+        };
+        // LSD radix sort, for integral and floating point value types
+        struct radix : base
+        {
+        };
+        // keeps the order of equal elements: radix sort for lanes of at
+        // least XTENSOR_RADIX_SORT_THRESHOLD arithmetic values, std::stable_sort
+        // otherwise
+        struct stable : base
+        {
+        };
+    }
+
     namespace detail
     {
         constexpr std::size_t normalize_axis(std::ptrdiff_t axis, std::size_t dim)
@@ -54,348 +97,2081 @@ namespace xt
             }
         }
 
-        template <class E>
-        inline std::size_t leading_axis(const E& e)
+        // Sorts [first, last): chunks of the range are sorted concurrently,
+        // then merged pairwise, each round of merges running concurrently.
+        template <class It, class C>
+        inline void parallel_sort(It first, It last, C comp)
         {
-            if (e.layout() == layout_type::row_major)
-            {
-                return e.dimension() - 1;
-            }
-            else if (e.layout() == layout_type::column_major)
+#if defined(XTENSOR_PARALLEL_ENABLED)
+            constexpr std::size_t max_chunks = 64;
+            std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+            if (parallel::use_parallel(n) && n >= 2 * max_chunks && !parallel::in_parallel_region())
             {
-                return 0;
+                std::size_t chunk_size = (std::max)((n + max_chunks - 1) / max_chunks, parallel::grain(1));
+                std::size_t n_chunks = (n + chunk_size - 1) / chunk_size;
+                if (n_chunks > 1)
+                {
+                    parallel_for(std::size_t(0), n_chunks, std::size_t(1), [&](std::size_t c_first, std::size_t c_last)
+                    {
+                        for (std::size_t c = c_first; c < c_last; ++c)
+                        {
+                            std::size_t lo = c * chunk_size;
+                            std::size_t hi = (std::min)(lo + chunk_size, n);
+                            std::sort(first + std::ptrdiff_t(lo), first + std::ptrdiff_t(hi), comp);
+                        }
+                    });
+                    for (std::size_t width = chunk_size; width < n; width *= 2)
+                    {
+                        std::size_t n_merges = (n + 2 * width - 1) / (2 * width);
+                        parallel_for(std::size_t(0), n_merges, std::size_t(1), [&](std::size_t m_first, std::size_t m_last)
+                        {
+                            for (std::size_t m = m_first; m < m_last; ++m)
+                            {
+                                std::size_t lo = 2 * m * width;
+                                std::size_t mid = (std::min)(lo + width, n);
+                                std::size_t hi = (std::min)(lo + 2 * width, n);
+                                if (mid < hi)
+                                {
+                                    std::inplace_merge(first + std::ptrdiff_t(lo), first + std::ptrdiff_t(mid),
+                                                       first + std::ptrdiff_t(hi), comp);
+                                }
+                            }
+                        });
+                    }
+                    return;
+                }
             }
-            throw std::runtime_error("Layout not supported.");
+#endif
+            std::sort(first, last, comp);
         }
 
-        // get permutations to transpose and reverse-transpose array
-        inline std::pair<dynamic_shape<std::size_t>, dynamic_shape<std::size_t>>
-        get_permutations(std::size_t dim, std::size_t ax, layout_type layout)
-        {
-            dynamic_shape<std::size_t> permutation(dim);
-            std::iota(permutation.begin(), permutation.end(), std::size_t(0));
-            permutation.erase(permutation.begin() + std::ptrdiff_t(ax));
-
-            if (layout == layout_type::row_major)
-            {
-                permutation.push_back(ax);
-            }
-            else
-            {
-                permutation.insert(permutation.begin(), ax);
-            }
-
-            // TODO find a more clever way to get reverse permutation?
-            dynamic_shape<std::size_t> reverse_permutation;
-            for (std::size_t i = 0; i < dim; ++i)
-            {
-                auto it = std::find(permutation.begin(), permutation.end(), i);
-                reverse_permutation.push_back(std::size_t(std::distance(permutation.begin(), it)));
-            }
-
-            return std::make_pair(std::move(permutation), std::move(reverse_permutation));
-        }
+        /**************
+         * radix sort *
+         **************/
 
-        template <class E, class R, class F>
-        inline auto run_lambda_over_axis(const E& e, R& res, std::size_t axis, F&& lambda)
+        template <class T>
+        struct is_radix_sortable
         {
-            if (axis != detail::leading_axis(res))
-            {
-                dynamic_shape<std::size_t> permutation, reverse_permutation;
-                std::tie(permutation, reverse_permutation) = get_permutations(e.dimension(), axis, e.layout());
+            static constexpr bool value = (std::is_integral<T>::value && !std::is_same<T, bool>::value) ||
+                                          std::is_same<T, float>::value || std::is_same<T, double>::value;
+        };
 
-                res = transpose(e, permutation);
-                detail::call_over_leading_axis(res, std::forward<F>(lambda));
-                res = transpose(res, reverse_permutation);
-            }
-            else
-            {
-                res = e;
-                detail::call_over_leading_axis(res, std::forward<F>(lambda));
-            }
-        }
+        template <std::size_t N>
+        struct radix_key_type;
 
-        template <class VT>
-        struct flatten_sort_result_type
+        template <>
+        struct radix_key_type<1>
         {
-            using type = VT;
+            using type = std::uint8_t;
         };
 
-        template <class VT, std::size_t N, layout_type L>
-        struct flatten_sort_result_type<xtensor<VT, N, L>>
+        template <>
+        struct radix_key_type<2>
         {
-            using type = xtensor<VT, 1, L>;
+            using type = std::uint16_t;
         };
 
-        template <class VT, class S, layout_type L>
-        struct flatten_sort_result_type<xtensor_fixed<VT, S, L>>
+        template <>
+        struct radix_key_type<4>
         {
-            using type = xtensor_fixed<VT, xshape<fixed_compute_size<S>::value>, L>;
+            using type = std::uint32_t;
         };
 
-
-        template <class E, class R = typename flatten_sort_result_type<E>::type>
-        inline auto flat_sort_impl(const xexpression<E>& e)
+        template <>
+        struct radix_key_type<8>
         {
-            const auto& de = e.derived_cast();
-            R ev;
-            ev.resize({de.size()});
+            using type = std::uint64_t;
+        };
 
-            std::copy(de.cbegin(), de.cend(), ev.begin());
-            std::sort(ev.begin(), ev.end());
+        template <class T>
+        using radix_key_t = typename radix_key_type<sizeof(T)>::type;
+
+        // Maps values to unsigned keys with the same ordering: the sign bit of
+        // signed integers is flipped, negative floating point numbers have all
+        // their bits flipped and positive ones their sign bit. The keys of the
+        // values that compare equal are equal, so that the stable radix sort
+        // keeps them in order like the comparison sort: -0 has the key of +0,
+        // and all the NaNs share the greatest key. The floating point keys
+        // are therefore not decoded back into values.
+        template <class T>
+        inline radix_key_t<T> radix_key(const T& v, std::true_type /*is_integral*/) noexcept
+        {
+            using key_type = radix_key_t<T>;
+            constexpr key_type sign_bit = std::is_signed<T>::value ? key_type(key_type(1) << (8 * sizeof(T) - 1)) : key_type(0);
+            return key_type(static_cast<key_type>(v) ^ sign_bit);
+        }
 
-            return ev;
+        template <class T>
+        inline radix_key_t<T> radix_key(const T& v, std::false_type /*is_integral*/) noexcept
+        {
+            using key_type = radix_key_t<T>;
+            constexpr key_type sign_bit = key_type(key_type(1) << (8 * sizeof(T) - 1));
+            if (v != v)
+            {
+                return key_type(~key_type(0));
+            }
+            key_type k;
+            T canonical = v == T(0) ? T(0) : v;
+            std::memcpy(&k, &canonical, sizeof(T));
+            return (k & sign_bit) ? key_type(~k) : key_type(k | sign_bit);
         }
-    }
 
-    template <class E>
-    inline auto sort(const xexpression<E>& e, placeholders::xtuph /*t*/)
-    {
-        return detail::flat_sort_impl(e);
-    }
+        template <class T>
+        inline radix_key_t<T> radix_key(const T& v) noexcept
+        {
+            return radix_key(v, std::is_integral<T>());
+        }
 
-    namespace detail
-    {
         template <class T>
-        struct sort_eval_type
+        inline T radix_value(radix_key_t<T> k, std::true_type /*is_integral*/) noexcept
         {
-            using type = typename T::temporary_type;
-        };
+            using key_type = radix_key_t<T>;
+            constexpr key_type sign_bit = std::is_signed<T>::value ? key_type(key_type(1) << (8 * sizeof(T) - 1)) : key_type(0);
+            return static_cast<T>(key_type(k ^ sign_bit));
+        }
 
-        template <class T, std::size_t... I, layout_type L>
-        struct sort_eval_type<xtensor_fixed<T, fixed_shape<I...>, L>>
+        template <class T>
+        inline T radix_value(radix_key_t<T> k, std::false_type /*is_integral*/) noexcept
         {
-            using type = xtensor<T, sizeof...(I), L>;
-        };
-    }
+            using key_type = radix_key_t<T>;
+            constexpr key_type sign_bit = key_type(key_type(1) << (8 * sizeof(T) - 1));
+            k = (k & sign_bit) ? key_type(k ^ sign_bit) : key_type(~k);
+            T v;
+            std::memcpy(&v, &k, sizeof(T));
+            return v;
+        }
 
-    /**
-     * Sort xexpression (optionally along axis)
-     * The sort is performed using the ``std::sort`` functions.
-     * A copy of the xexpression is created and returned.
-     *
-     * @param e xexpression to sort
-     * @param axis axis along which sort is performed
-     *
-     * @return sorted array (copy)
-     */
-    template <class E>
-    inline auto sort(const xexpression<E>& e, std::ptrdiff_t axis = -1)
-    {
-        using eval_type = typename detail::sort_eval_type<E>::type;
+        // Stable LSD radix sort of n keys, one byte per pass; values, if not
+        // null, are permuted along with the keys. Passes where all the keys
+        // share the same digit are skipped.
+        template <class K, class V>
+        inline void radix_sort_keys(K* keys, V* values, std::size_t n)
+        {
+            if (n < 2)
+            {
+                return;
+            }
+            std::vector<K> keys_buffer(n);
+            std::vector<V> values_buffer(values != nullptr ? n : 0);
+            K* k_src = keys;
+            K* k_dst = keys_buffer.data();
+            V* v_src = values;
+            V* v_dst = values_buffer.data();
+
+            std::array<std::size_t, 256> count;
+            for (std::size_t shift = 0; shift < 8 * sizeof(K); shift += 8)
+            {
+                count.fill(0);
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    ++count[(k_src[i] >> shift) & 0xFF];
+                }
+                if (count[(k_src[0] >> shift) & 0xFF] == n)
+                {
+                    continue;
+                }
+                std::size_t offset = 0;
+                for (std::size_t& c : count)
+                {
+                    std::size_t tmp = c;
+                    c = offset;
+                    offset += tmp;
+                }
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    std::size_t pos = count[(k_src[i] >> shift) & 0xFF]++;
+                    k_dst[pos] = k_src[i];
+                    if (v_src != nullptr)
+                    {
+                        v_dst[pos] = v_src[i];
+                    }
+                }
+                std::swap(k_src, k_dst);
+                std::swap(v_src, v_dst);
+            }
 
-        const auto& de = e.derived_cast();
+            if (k_src != keys)
+            {
+                std::copy(k_src, k_src + n, keys);
+                if (v_src != nullptr)
+                {
+                    std::copy(v_src, v_src + n, values);
+                }
+            }
+        }
 
-        if (de.dimension() == 1)
+        // The integral values are decoded from their sorted keys, the floating
+        // point ones are permuted along with their keys.
+        template <class T>
+        inline void radix_sort_values(radix_key_t<T>* keys, T* first, std::size_t n, std::true_type /*is_integral*/)
         {
-            return detail::flat_sort_impl<std::decay_t<decltype(de)>, eval_type>(de);
+            radix_sort_keys(keys, static_cast<std::size_t*>(nullptr), n);
+            std::transform(keys, keys + n, first, [](radix_key_t<T> k) {
+                return radix_value<T>(k, std::true_type());
+            });
         }
 
-        std::size_t ax = detail::normalize_axis(axis, de.dimension());
+        template <class T>
+        inline void radix_sort_values(radix_key_t<T>* keys, T* first, std::size_t n, std::false_type /*is_integral*/)
+        {
+            radix_sort_keys(keys, first, n);
+        }
 
-        eval_type res;
-        detail::run_lambda_over_axis(de, res, ax, [](auto begin, auto end) { std::sort(begin, end); });
-        return res;
-    }
+        template <class T>
+        inline void radix_sort(T* first, T* last)
+        {
+            static_assert(is_radix_sortable<T>::value, "radix sort requires an integral or floating point value type");
+            std::size_t n = static_cast<std::size_t>(last - first);
+            std::vector<radix_key_t<T>> keys(n);
+            std::transform(first, last, keys.begin(), [](const T& v) { return radix_key(v); });
+            radix_sort_values(keys.data(), first, n, std::is_integral<T>());
+        }
 
-    namespace detail
-    {
-        template <class VT, class T>
-        struct rebind_value_type
+        // Stable indirect radix sort: inds receives the indices of the n values
+        // in sorted order, get(i) returning the i-th value.
+        template <class G, class I>
+        inline void radix_argsort(G&& get, std::size_t n, I* inds)
         {
-            using type = xarray<VT, xt::layout_type::dynamic>;
-        };
+            using value_type = std::decay_t<decltype(get(std::size_t(0)))>;
+            static_assert(is_radix_sortable<value_type>::value, "radix sort requires an integral or floating point value type");
+            std::vector<radix_key_t<value_type>> keys(n);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                keys[i] = radix_key(static_cast<value_type>(get(i)));
+            }
+            std::iota(inds, inds + n, I(0));
+            radix_sort_keys(keys.data(), inds, n);
+        }
 
-        template <class VT, class EC, layout_type L>
-        struct rebind_value_type<VT, xarray<EC, L>>
+        // Returns true if a lane of n elements is sorted with the radix sort
+        // when the automatic method is selected.
+        template <class T>
+        inline bool use_radix_sort(std::size_t n)
         {
-            using type = xarray<VT, L>;
-        };
+            if (!is_radix_sortable<T>::value || n < XTENSOR_RADIX_SORT_THRESHOLD)
+            {
+                return false;
+            }
+#if defined(XTENSOR_PARALLEL_ENABLED)
+            // large lanes are sorted faster by the parallel comparison sort
+            return !parallel::use_parallel(n) || parallel::in_parallel_region();
+#else
+            return true;
+#endif
+        }
 
-        template <class VT, class EC, std::size_t N, layout_type L>
-        struct rebind_value_type<VT, xtensor<EC, N, L>>
+        // Lanes of at most XTENSOR_SORTING_NETWORK_SIZE arithmetic values are
+        // sorted with a fixed sequence of branchless compare-exchanges: the
+        // comparators of Batcher's odd-even merge sort.
+        static_assert(XTENSOR_SORTING_NETWORK_SIZE <= 256, "XTENSOR_SORTING_NETWORK_SIZE must be at most 256");
+
+        template <class T>
+        struct is_network_sortable : std::is_arithmetic<T>
         {
-            using type = xtensor<VT, N, L>;
         };
 
-        template <class VT, class ET, class S, layout_type L>
-        struct rebind_value_type<VT, xtensor_fixed<ET, S, L>>
+        template <class T>
+        inline bool use_sorting_network(std::size_t n) noexcept
         {
-            using type = xtensor_fixed<VT, S, L>;
-        };
+            return is_network_sortable<T>::value && n <= XTENSOR_SORTING_NETWORK_SIZE;
+        }
 
-        template <class VT, class T>
-        struct flatten_rebind_value_type
+        using sorting_network_type = std::vector<std::pair<std::uint8_t, std::uint8_t>>;
+
+        // The comparators of the network of the next power of two that involve
+        // the elements past n are dropped, as if these elements were greater
+        // than all the others.
+        inline sorting_network_type make_sorting_network(std::size_t n)
         {
-            using type = typename rebind_value_type<VT, T>::type;
-        };
+            sorting_network_type res;
+            for (std::size_t p = 1; p < n; p <<= 1)
+            {
+                for (std::size_t k = p; k >= 1; k >>= 1)
+                {
+                    for (std::size_t j = k % p; j + k < n; j += 2 * k)
+                    {
+                        for (std::size_t i = 0; i < k && i + j + k < n; ++i)
+                        {
+                            if ((i + j) / (2 * p) == (i + j + k) / (2 * p))
+                            {
+                                res.emplace_back(static_cast<std::uint8_t>(i + j), static_cast<std::uint8_t>(i + j + k));
+                            }
+                        }
+                    }
+                }
+            }
+            return res;
+        }
 
-        template <class VT, class EC, std::size_t N, layout_type L>
-        struct flatten_rebind_value_type<VT, xtensor<EC, N, L>>
+        inline const sorting_network_type& sorting_network(std::size_t n)
         {
-            using type = xtensor<VT, 1, L>;
-        };
+            static const std::vector<sorting_network_type> networks = []()
+            {
+                std::vector<sorting_network_type> res(XTENSOR_SORTING_NETWORK_SIZE + 1);
+                for (std::size_t i = 0; i < res.size(); ++i)
+                {
+                    res[i] = make_sorting_network(i);
+                }
+                return res;
+            }();
+            return networks[n];
+        }
 
-        template <class VT, class ET, class S, layout_type L>
-        struct flatten_rebind_value_type<VT, xtensor_fixed<ET, S, L>>
+        // The same predicate selects both outputs, so that a and b are always
+        // permuted, even if they hold NaNs.
+        template <class T>
+        inline void compare_exchange(T& a, T& b) noexcept
         {
-            using type = xtensor_fixed<VT, xshape<fixed_compute_size<S>::value>, L>;
-        };
+            T x = a;
+            T y = b;
+            bool swap = y < x;
+            a = swap ? y : x;
+            b = swap ? x : y;
+        }
 
         template <class T>
-        struct argsort_result_type
+        inline void network_sort(T* first, std::size_t n)
         {
-            using type = typename rebind_value_type<typename T::temporary_type::size_type,
-                                                    typename T::temporary_type>::type;
-        };
+            for (const auto& c : sorting_network(n))
+            {
+                compare_exchange(first[c.first], first[c.second]);
+            }
+        }
 
+        // Sorts the width lanes of n elements stored stride apart, the lanes
+        // being adjacent: each comparator is a loop of compare-exchanges
+        // over contiguous elements, which is vectorized.
         template <class T>
-        struct linear_argsort_result_type
+        inline void network_sort_columns(T* first, std::size_t n, std::size_t stride, std::size_t width)
         {
-            using type = typename flatten_rebind_value_type<typename T::temporary_type::size_type,
-                                                            typename T::temporary_type>::type;
-        };
+            for (const auto& c : sorting_network(n))
+            {
+                T* a = first + c.first * stride;
+                T* b = first + c.second * stride;
+                XTENSOR_PRAGMA_SIMD
+                for (std::size_t l = 0; l < width; ++l)
+                {
+                    compare_exchange(a[l], b[l]);
+                }
+            }
+        }
 
-        template <class Ed, class Ei>
-        inline void argsort_over_leading_axis(const Ed& data, Ei& inds)
+        // Sorts the indices by value, then by index, which is the order of a
+        // stable sort.
+        template <class G, class I>
+        inline void network_argsort(G&& get, std::size_t n, I* inds)
         {
-            std::size_t n_iters = 1;
-            std::ptrdiff_t data_secondary_stride;
-            std::ptrdiff_t inds_secondary_stride;
-            if (data.layout() == layout_type::row_major)
+            using value_type = std::decay_t<decltype(get(std::size_t(0)))>;
+            value_type keys[XTENSOR_SORTING_NETWORK_SIZE > 0 ? XTENSOR_SORTING_NETWORK_SIZE : 1];
+            for (std::size_t i = 0; i < n; ++i)
             {
-                n_iters = std::accumulate(data.shape().begin(), data.shape().end() - 1,
-                                          std::size_t(1), std::multiplies<>());
-                data_secondary_stride = static_cast<std::ptrdiff_t>(data.strides()[data.dimension() - 2]);
-                inds_secondary_stride = static_cast<std::ptrdiff_t>(inds.strides()[inds.dimension() - 2]);
+                keys[i] = get(i);
+                inds[i] = static_cast<I>(i);
             }
-            else
+            for (const auto& c : sorting_network(n))
             {
-                n_iters = std::accumulate(data.shape().begin() + 1, data.shape().end(),
-                                          std::size_t(1), std::multiplies<>());
-                data_secondary_stride = static_cast<std::ptrdiff_t>(data.strides()[1]);
-                inds_secondary_stride = static_cast<std::ptrdiff_t>(inds.strides()[1]);
+                value_type& ka = keys[c.first];
+                value_type& kb = keys[c.second];
+                I& ia = inds[c.first];
+                I& ib = inds[c.second];
+                bool swap = kb < ka || (!(ka < kb) && ib < ia);
+                value_type kx = ka;
+                I ix = ia;
+                ka = swap ? kb : ka;
+                kb = swap ? kx : kb;
+                ia = swap ? ib : ia;
+                ib = swap ? ix : ib;
             }
+        }
 
-            std::ptrdiff_t data_offset = 0;
-            std::ptrdiff_t inds_offset = 0;
-
-            for (std::size_t i = 0; i < n_iters; ++i, data_offset += data_secondary_stride,
-                    inds_offset += inds_secondary_stride)
+        template <class T>
+        inline bool try_network_sort(T* first, std::size_t n, std::true_type /*network sortable*/)
+        {
+            if (!use_sorting_network<T>(n))
             {
-                auto comp = [&data, &data_offset](std::size_t x, std::size_t y) {
-                    return (*(data.data() + data_offset + x) <
-                            *(data.data() + data_offset + y));
-                };
-                std::iota(inds.data() + inds_offset, inds.data() + inds_offset + inds_secondary_stride, 0);
-                std::sort(inds.data() + inds_offset, inds.data() + inds_offset + inds_secondary_stride, comp);
+                return false;
             }
+            network_sort(first, n);
+            return true;
         }
 
-        template <class E, class R = typename detail::linear_argsort_result_type<E>::type>
-        inline auto flatten_argsort_impl(const xexpression<E>& e)
+        template <class T>
+        inline bool try_network_sort(T*, std::size_t, std::false_type /*network sortable*/)
         {
-            using result_type = R;
-
-            const auto& de = e.derived_cast();
+            return false;
+        }
+
+        // Sorts the lane with a sorting network if it is small enough
+        template <class T>
+        inline bool try_network_sort(T* first, std::size_t n)
+        {
+            return try_network_sort(first, n, std::integral_constant<bool, is_network_sortable<T>::value>());
+        }
+
+        template <class G, class I>
+        inline bool try_network_argsort(G&& get, std::size_t n, I* inds)
+        {
+            using value_type = std::decay_t<decltype(get(std::size_t(0)))>;
+            return xtl::mpl::static_if<is_network_sortable<value_type>::value>([&](auto self)
+            {
+                if (!use_sorting_network<value_type>(n))
+                {
+                    return false;
+                }
+                network_argsort(self(get), n, inds);
+                return true;
+            }, /*else*/ [](auto /*self*/)
+            {
+                return false;
+            });
+        }
+
+        // The sorting networks leave equal values in any order, which is only
+        // visible for the stable sort of values (e.g. -0. and 0.).
+        template <class M>
+        struct sorts_with_network
+            : std::integral_constant<bool, std::is_same<M, sorting_method::automatic>::value ||
+                                           std::is_same<M, sorting_method::comparison>::value>
+        {
+        };
+
+        template <class T>
+        inline void sort_lane(T* first, T* last, sorting_method::comparison)
+        {
+            if (try_network_sort(first, static_cast<std::size_t>(last - first)))
+            {
+                return;
+            }
+            parallel_sort(first, last, std::less<>());
+        }
+
+        template <class T>
+        inline void sort_lane(T* first, T* last, sorting_method::radix)
+        {
+            radix_sort(first, last);
+        }
+
+        // Returns true if a lane of n elements is sorted with the radix sort
+        // when a stable sort is required; the parallel sort is not stable.
+        template <class T>
+        inline bool use_stable_radix_sort(std::size_t n)
+        {
+            return is_radix_sortable<T>::value && n >= XTENSOR_RADIX_SORT_THRESHOLD;
+        }
+
+        template <class T>
+        inline void stable_sort_lane_impl(T* first, T* last, std::true_type /*radix sortable*/)
+        {
+            if (use_stable_radix_sort<T>(static_cast<std::size_t>(last - first)))
+            {
+                radix_sort(first, last);
+            }
+            else
+            {
+                std::stable_sort(first, last);
+            }
+        }
+
+        template <class T>
+        inline void stable_sort_lane_impl(T* first, T* last, std::false_type /*radix sortable*/)
+        {
+            std::stable_sort(first, last);
+        }
+
+        template <class T>
+        inline void sort_lane(T* first, T* last, sorting_method::stable)
+        {
+            stable_sort_lane_impl(first, last, std::integral_constant<bool, is_radix_sortable<T>::value>());
+        }
+
+        template <class T>
+        inline void sort_lane_impl(T* first, T* last, std::true_type /*radix sortable*/)
+        {
+            if (try_network_sort(first, static_cast<std::size_t>(last - first)))
+            {
+                return;
+            }
+            if (use_radix_sort<T>(static_cast<std::size_t>(last - first)))
+            {
+                radix_sort(first, last);
+            }
+            else
+            {
+                parallel_sort(first, last, std::less<>());
+            }
+        }
+
+        template <class T>
+        inline void sort_lane_impl(T* first, T* last, std::false_type /*radix sortable*/)
+        {
+            parallel_sort(first, last, std::less<>());
+        }
+
+        template <class T>
+        inline void sort_lane(T* first, T* last, sorting_method::automatic)
+        {
+            sort_lane_impl(first, last, std::integral_constant<bool, is_radix_sortable<T>::value>());
+        }
+
+        template <class G, class I>
+        inline void argsort_lane(G&& get, std::size_t n, I* inds, sorting_method::comparison)
+        {
+            if (try_network_argsort(get, n, inds))
+            {
+                return;
+            }
+            auto comp = [&get](std::size_t x, std::size_t y) {
+                return get(x) < get(y);
+            };
+            std::iota(inds, inds + n, I(0));
+            parallel_sort(inds, inds + n, comp);
+        }
+
+        template <class G, class I>
+        inline void argsort_lane(G&& get, std::size_t n, I* inds, sorting_method::radix)
+        {
+            radix_argsort(get, n, inds);
+        }
+
+        template <class G, class I>
+        inline void stable_argsort_lane_impl(G&& get, std::size_t n, I* inds, std::true_type /*radix sortable*/)
+        {
+            using value_type = std::decay_t<decltype(get(std::size_t(0)))>;
+            if (use_stable_radix_sort<value_type>(n))
+            {
+                radix_argsort(get, n, inds);
+                return;
+            }
+            stable_argsort_lane_impl(get, n, inds, std::false_type());
+        }
+
+        template <class G, class I>
+        inline void stable_argsort_lane_impl(G&& get, std::size_t n, I* inds, std::false_type /*radix sortable*/)
+        {
+            if (try_network_argsort(get, n, inds))
+            {
+                return;
+            }
+            auto comp = [&get](std::size_t x, std::size_t y) {
+                return get(x) < get(y);
+            };
+            std::iota(inds, inds + n, I(0));
+            std::stable_sort(inds, inds + n, comp);
+        }
+
+        template <class G, class I>
+        inline void argsort_lane(G&& get, std::size_t n, I* inds, sorting_method::stable)
+        {
+            using value_type = std::decay_t<decltype(get(std::size_t(0)))>;
+            stable_argsort_lane_impl(get, n, inds, std::integral_constant<bool, is_radix_sortable<value_type>::value>());
+        }
+
+        template <class G, class I>
+        inline void argsort_lane_impl(G&& get, std::size_t n, I* inds, std::true_type /*radix sortable*/)
+        {
+            using value_type = std::decay_t<decltype(get(std::size_t(0)))>;
+            if (use_radix_sort<value_type>(n))
+            {
+                radix_argsort(get, n, inds);
+            }
+            else
+            {
+                argsort_lane(get, n, inds, sorting_method::comparison());
+            }
+        }
+
+        template <class G, class I>
+        inline void argsort_lane_impl(G&& get, std::size_t n, I* inds, std::false_type /*radix sortable*/)
+        {
+            argsort_lane(get, n, inds, sorting_method::comparison());
+        }
+
+        template <class G, class I>
+        inline void argsort_lane(G&& get, std::size_t n, I* inds, sorting_method::automatic)
+        {
+            using value_type = std::decay_t<decltype(get(std::size_t(0)))>;
+            argsort_lane_impl(get, n, inds, std::integral_constant<bool, is_radix_sortable<value_type>::value>());
+        }
+
+        // Calls f(i) for each of the n_lanes lanes of lane_size elements, the
+        // lanes are distributed over the parallel backend when there are enough
+        // of them; otherwise they are processed one after the other, and the
+        // sorting of each lane can be parallelized.
+        template <class F>
+        inline void for_each_lane(std::size_t n_lanes, std::size_t lane_size, F&& f)
+        {
+#if defined(XTENSOR_PARALLEL_ENABLED)
+            constexpr std::size_t min_lanes = 64;
+            if (n_lanes > 1 && parallel::use_parallel(n_lanes * lane_size) &&
+                (n_lanes >= min_lanes || !parallel::use_parallel(lane_size)))
+            {
+                parallel_for(std::size_t(0), n_lanes, parallel::grain(lane_size), [&f](std::size_t first, std::size_t last)
+                {
+                    for (std::size_t i = first; i < last; ++i)
+                    {
+                        f(i);
+                    }
+                });
+                return;
+            }
+#endif
+            for (std::size_t i = 0; i < n_lanes; ++i)
+            {
+                f(i);
+            }
+        }
+
+        // Same as call_over_leading_axis, but fct may be called concurrently
+        // on different lanes.
+        template <class E, class F>
+        inline void parallel_call_over_leading_axis(E& ev, F&& fct)
+        {
+            if (ev.size() == 0)
+            {
+                return;
+            }
+            std::size_t n_iters = 1;
+            std::ptrdiff_t secondary_stride;
+            if (ev.layout() == layout_type::row_major)
+            {
+                n_iters = std::accumulate(ev.shape().begin(), ev.shape().end() - 1,
+                                          std::size_t(1), std::multiplies<>());
+                secondary_stride = static_cast<std::ptrdiff_t>(ev.strides()[ev.dimension() - 2]);
+            }
+            else
+            {
+                n_iters = std::accumulate(ev.shape().begin() + 1, ev.shape().end(),
+                                          std::size_t(1), std::multiplies<>());
+                secondary_stride = static_cast<std::ptrdiff_t>(ev.strides()[1]);
+            }
+
+            std::ptrdiff_t adj_secondary_stride = (std::max)(secondary_stride, std::ptrdiff_t(1));
+            auto data = ev.data();
+            for_each_lane(n_iters, std::size_t(adj_secondary_stride), [&](std::size_t i)
+            {
+                auto begin = data + std::ptrdiff_t(i) * secondary_stride;
+                fct(begin, begin + adj_secondary_stride);
+            });
+        }
+
+        template <class E>
+        inline std::size_t leading_axis(const E& e)
+        {
+            if (e.layout() == layout_type::row_major)
+            {
+                return e.dimension() - 1;
+            }
+            else if (e.layout() == layout_type::column_major)
+            {
+                return 0;
+            }
+            throw std::runtime_error("Layout not supported.");
+        }
+
+        // get permutations to transpose and reverse-transpose array
+        inline std::pair<dynamic_shape<std::size_t>, dynamic_shape<std::size_t>>
+        get_permutations(std::size_t dim, std::size_t ax, layout_type layout)
+        {
+            dynamic_shape<std::size_t> permutation(dim);
+            std::iota(permutation.begin(), permutation.end(), std::size_t(0));
+            permutation.erase(permutation.begin() + std::ptrdiff_t(ax));
+
+            if (layout == layout_type::row_major)
+            {
+                permutation.push_back(ax);
+            }
+            else
+            {
+                permutation.insert(permutation.begin(), ax);
+            }
+
+            // TODO find a more clever way to get reverse permutation?
+            dynamic_shape<std::size_t> reverse_permutation;
+            for (std::size_t i = 0; i < dim; ++i)
+            {
+                auto it = std::find(permutation.begin(), permutation.end(), i);
+                reverse_permutation.push_back(std::size_t(std::distance(permutation.begin(), it)));
+            }
+
+            return std::make_pair(std::move(permutation), std::move(reverse_permutation));
+        }
+
+        template <class E, class R, class F>
+        inline auto run_lambda_over_axis(const E& e, R& res, std::size_t axis, F&& lambda)
+        {
+            if (axis != detail::leading_axis(res))
+            {
+                dynamic_shape<std::size_t> permutation, reverse_permutation;
+                std::tie(permutation, reverse_permutation) = get_permutations(e.dimension(), axis, e.layout());
+
+                res = transpose(e, permutation);
+                detail::parallel_call_over_leading_axis(res, std::forward<F>(lambda));
+                res = transpose(res, reverse_permutation);
+            }
+            else
+            {
+                res = e;
+                detail::parallel_call_over_leading_axis(res, std::forward<F>(lambda));
+            }
+        }
+
+        template <class VT>
+        struct flatten_sort_result_type
+        {
+            using type = VT;
+        };
+
+        template <class VT, std::size_t N, layout_type L>
+        struct flatten_sort_result_type<xtensor<VT, N, L>>
+        {
+            using type = xtensor<VT, 1, L>;
+        };
+
+        template <class VT, class S, layout_type L>
+        struct flatten_sort_result_type<xtensor_fixed<VT, S, L>>
+        {
+            using type = xtensor_fixed<VT, xshape<fixed_compute_size<S>::value>, L>;
+        };
+
+
+        template <class E, class R = typename flatten_sort_result_type<E>::type, class M = sorting_method::automatic>
+        inline auto flat_sort_impl(const xexpression<E>& e, M method = M())
+        {
+            const auto& de = e.derived_cast();
+            R ev;
+            ev.resize({de.size()});
+
+            std::copy(de.cbegin(), de.cend(), ev.begin());
+            sort_lane(ev.data(), ev.data() + ev.size(), method);
+
+            return ev;
+        }
+    }
+
+    template <class E, class M = sorting_method::automatic,
+              XTENSOR_REQUIRE<std::is_base_of<sorting_method::base, M>::value>>
+    inline auto sort(const xexpression<E>& e, placeholders::xtuph /*t*/, M method = M())
+    {
+        return detail::flat_sort_impl(e, method);
+    }
+
+    namespace detail
+    {
+        template <class T>
+        struct sort_eval_type
+        {
+            using type = typename T::temporary_type;
+        };
+
+        template <class T, std::size_t... I, layout_type L>
+        struct sort_eval_type<xtensor_fixed<T, fixed_shape<I...>, L>>
+        {
+            using type = xtensor<T, sizeof...(I), L>;
+        };
+
+        // Maximal size in bytes of the scratch buffer of the lanes sorted
+        // together by sort_strided_lanes
+        constexpr std::size_t sort_scratch_bytes = std::size_t(1) << 20;
+
+        // Number of contiguous lanes sorted together by a sorting network
+        constexpr std::size_t sorting_network_batch = 64;
+
+        // Sorts with a sorting network the lanes of a buffer of shape (outer,
+        // axis_size, inner), in place: the comparators run over blocks of
+        // adjacent lanes that fit in the L1 cache.
+        template <class T>
+        inline void network_sort_strided_lanes(T* data, std::size_t outer, std::size_t axis_size, std::size_t inner)
+        {
+            constexpr std::size_t line_size = XTENSOR_CACHE_LINE_SIZE > sizeof(T) ? XTENSOR_CACHE_LINE_SIZE / sizeof(T) : 1;
+            std::size_t block = (std::max)(line_size, XTENSOR_L1_CACHE_SIZE / (2 * axis_size * sizeof(T)) / line_size * line_size);
+            std::size_t blocks_per_outer = (inner + block - 1) / block;
+            std::size_t n_blocks = outer * blocks_per_outer;
+
+            auto sort_blocks = [&](std::size_t first, std::size_t last)
+            {
+                for (std::size_t b = first; b < last; ++b)
+                {
+                    std::size_t j = (b % blocks_per_outer) * block;
+                    T* base = data + (b / blocks_per_outer) * axis_size * inner + j;
+                    network_sort_columns(base, axis_size, inner, (std::min)(block, inner - j));
+                }
+            };
+
+#if defined(XTENSOR_PARALLEL_ENABLED)
+            if (n_blocks > 1 && parallel::use_parallel(outer * axis_size * inner))
+            {
+                parallel_for(std::size_t(0), n_blocks, parallel::grain(block * axis_size), sort_blocks);
+                return;
+            }
+#endif
+            sort_blocks(std::size_t(0), n_blocks);
+        }
+
+        // Sorts with a sorting network n_lanes contiguous lanes of axis_size
+        // elements: batches of lanes are transposed into a scratch buffer, so
+        // that the comparators run over the elements of different lanes.
+        template <class T>
+        inline void network_sort_contiguous_lanes(T* data, std::size_t n_lanes, std::size_t axis_size)
+        {
+            constexpr std::size_t batch = sorting_network_batch;
+            std::size_t n_batches = (n_lanes + batch - 1) / batch;
+
+            auto sort_batches = [&](std::size_t first, std::size_t last)
+            {
+                std::vector<T> scratch(batch * axis_size);
+                for (std::size_t b = first; b < last; ++b)
+                {
+                    std::size_t width = (std::min)(batch, n_lanes - b * batch);
+                    T* base = data + b * batch * axis_size;
+                    for (std::size_t l = 0; l < width; ++l)
+                    {
+                        for (std::size_t k = 0; k < axis_size; ++k)
+                        {
+                            scratch[k * width + l] = base[l * axis_size + k];
+                        }
+                    }
+                    network_sort_columns(scratch.data(), axis_size, width, width);
+                    for (std::size_t l = 0; l < width; ++l)
+                    {
+                        for (std::size_t k = 0; k < axis_size; ++k)
+                        {
+                            base[l * axis_size + k] = scratch[k * width + l];
+                        }
+                    }
+                }
+            };
+
+#if defined(XTENSOR_PARALLEL_ENABLED)
+            if (n_batches > 1 && parallel::use_parallel(n_lanes * axis_size))
+            {
+                parallel_for(std::size_t(0), n_batches, parallel::grain(batch * axis_size), sort_batches);
+                return;
+            }
+#endif
+            sort_batches(std::size_t(0), n_batches);
+        }
+
+        // Sorts the lanes of a buffer of shape (outer, axis_size, inner) with
+        // sorting networks if they are small enough and the method allows it
+        template <class T, class M>
+        inline bool try_network_sort_lanes(T* data, std::size_t outer, std::size_t axis_size, std::size_t inner, M)
+        {
+            return xtl::mpl::static_if<is_network_sortable<T>::value && sorts_with_network<M>::value>([&](auto self)
+            {
+                if (!use_sorting_network<T>(axis_size))
+                {
+                    return false;
+                }
+                if (inner == 1)
+                {
+                    network_sort_contiguous_lanes(self(data), outer, axis_size);
+                }
+                else
+                {
+                    network_sort_strided_lanes(self(data), outer, axis_size, inner);
+                }
+                return true;
+            }, /*else*/ [](auto /*self*/)
+            {
+                return false;
+            });
+        }
+
+        // Sorts the lanes of a buffer of shape (outer, axis_size, inner), whose
+        // elements are inner apart. Blocks of lanes adjacent in memory are
+        // gathered one after the other into a contiguous scratch buffer, so
+        // that every cache line holding them is read and written once, then
+        // sorted there and scattered back.
+        template <class T, class M>
+        inline void sort_strided_lanes(T* data, std::size_t outer, std::size_t axis_size, std::size_t inner, M method)
+        {
+            constexpr std::size_t line_size = XTENSOR_CACHE_LINE_SIZE > sizeof(T) ? XTENSOR_CACHE_LINE_SIZE / sizeof(T) : 1;
+            std::size_t block = (std::max)(std::size_t(1), (std::min)(line_size, sort_scratch_bytes / (axis_size * sizeof(T))));
+            std::size_t blocks_per_outer = (inner + block - 1) / block;
+            std::size_t n_blocks = outer * blocks_per_outer;
+
+            auto sort_blocks = [&](std::size_t first, std::size_t last)
+            {
+                std::vector<T> scratch(block * axis_size);
+                for (std::size_t b = first; b < last; ++b)
+                {
+                    std::size_t j = (b % blocks_per_outer) * block;
+                    std::size_t width = (std::min)(block, inner - j);
+                    T* base = data + (b / blocks_per_outer) * axis_size * inner + j;
+                    for (std::size_t k = 0; k < axis_size; ++k)
+                    {
+                        for (std::size_t l = 0; l < width; ++l)
+                        {
+                            scratch[l * axis_size + k] = std::move(base[k * inner + l]);
+                        }
+                    }
+                    for (std::size_t l = 0; l < width; ++l)
+                    {
+                        sort_lane(scratch.data() + l * axis_size, scratch.data() + (l + 1) * axis_size, method);
+                    }
+                    for (std::size_t k = 0; k < axis_size; ++k)
+                    {
+                        for (std::size_t l = 0; l < width; ++l)
+                        {
+                            base[k * inner + l] = std::move(scratch[l * axis_size + k]);
+                        }
+                    }
+                }
+            };
+
+#if defined(XTENSOR_PARALLEL_ENABLED)
+            if (n_blocks > 1 && parallel::use_parallel(outer * axis_size * inner))
+            {
+                parallel_for(std::size_t(0), n_blocks, parallel::grain(block * axis_size), sort_blocks);
+                return;
+            }
+#endif
+            sort_blocks(std::size_t(0), n_blocks);
+        }
+
+        // Sorts the lanes along ax of an expression whose elements are
+        // contiguous in row or column major order, in its buffer; returns
+        // false for the other layouts.
+        template <class E, class M>
+        inline bool sort_lanes_inplace(E& e, std::size_t ax, M method)
+        {
+            layout_type l = e.layout();
+            if (l != layout_type::row_major && l != layout_type::column_major)
+            {
+                return false;
+            }
+            const auto& shape = e.shape();
+            std::size_t axis_size = static_cast<std::size_t>(shape[ax]);
+            std::size_t size = static_cast<std::size_t>(e.size());
+            if (size == 0 || axis_size < 2)
+            {
+                return true;
+            }
+
+            auto first = shape.begin() + (l == layout_type::row_major ? std::ptrdiff_t(ax) + 1 : std::ptrdiff_t(0));
+            auto last = l == layout_type::row_major ? shape.end() : shape.begin() + std::ptrdiff_t(ax);
+            std::size_t inner = std::accumulate(first, last, std::size_t(1), std::multiplies<std::size_t>());
+            auto* data = e.data() + e.data_offset();
+            if (try_network_sort_lanes(data, size / (axis_size * inner), axis_size, inner, method))
+            {
+                return true;
+            }
+            if (inner == 1)
+            {
+                for_each_lane(size / axis_size, axis_size, [&](std::size_t i)
+                {
+                    sort_lane(data + i * axis_size, data + (i + 1) * axis_size, method);
+                });
+            }
+            else
+            {
+                sort_strided_lanes(data, size / (axis_size * inner), axis_size, inner, method);
+            }
+            return true;
+        }
+    }
+
+    /**
+     * Sort xexpression (optionally along axis)
+     * The sort is performed using the ``std::sort`` functions, or a LSD radix
+     * sort for integral and floating point values, depending on \c method.
+     * A copy of the xexpression is created and returned.
+     *
+     * @param e xexpression to sort
+     * @param axis axis along which sort is performed
+     * @param method sorting algorithm (sorting_method::automatic, comparison,
+     *        radix or stable)
+     *
+     * @return sorted array (copy)
+     */
+    template <class E, class M = sorting_method::automatic,
+              XTENSOR_REQUIRE<std::is_base_of<sorting_method::base, M>::value>>
+    inline auto sort(const xexpression<E>& e, std::ptrdiff_t axis = -1, M method = M())
+    {
+        using eval_type = typename detail::sort_eval_type<E>::type;
+
+        const auto& de = e.derived_cast();
+
+        if (de.dimension() == 1)
+        {
+            return detail::flat_sort_impl<std::decay_t<decltype(de)>, eval_type>(de, method);
+        }
+
+        std::size_t ax = detail::normalize_axis(axis, de.dimension());
+
+        eval_type res = de;
+        if (!detail::sort_lanes_inplace(res, ax, method))
+        {
+            detail::run_lambda_over_axis(de, res, ax, [method](auto begin, auto end) {
+                detail::sort_lane(begin, end, method);
+            });
+        }
+        return res;
+    }
+
+    /**
+     * Sorts the elements of \a e along \a axis in place, like
+     * <tt>ndarray.sort(axis)</tt> in NumPy. The lanes of containers and
+     * other expressions whose elements are contiguous in row or column
+     * major order are sorted in their buffer, without copying the whole
+     * expression: the lanes along the innermost axis are sorted directly,
+     * and the strided lanes are gathered by blocks of lanes adjacent in
+     * memory into a contiguous scratch buffer of the sorting thread, sorted
+     * there and scattered back. The other expressions are assigned their
+     * sorted copy.
+     *
+     * @param e the xexpression to sort, holding its elements
+     * @param axis axis along which the sort is performed
+     * @param method sorting algorithm (sorting_method::automatic, comparison,
+     *        radix or stable)
+     *
+     * \code{.cpp}
+     * xt::xarray<double> a = {{3., 1.}, {2., 4.}};
+     * xt::sort_inplace(a, 0);
+     * std::cout << a << std::endl; // {{2., 1.}, {3., 4.}}
+     * \endcode
+     *
+     * \sa sort
+     */
+    template <class E, class M = sorting_method::automatic,
+              XTENSOR_REQUIRE<std::is_base_of<sorting_method::base, M>::value>>
+    inline void sort_inplace(xexpression<E>& e, std::ptrdiff_t axis = -1, M method = M())
+    {
+        E& de = e.derived_cast();
+        if (de.dimension() == 0)
+        {
+            return;
+        }
+        std::size_t ax = detail::normalize_axis(axis, de.dimension());
+        if (ax >= de.dimension())
+        {
+            throw std::runtime_error("sort_inplace: axis out of bounds");
+        }
+
+        bool sorted = false;
+        xtl::mpl::static_if<has_data_interface<E>::value && E::contiguous_layout>([&](auto self)
+        {
+            sorted = detail::sort_lanes_inplace(self(de), ax, method);
+        }, /*else*/ [](auto /*self*/)
+        {
+        });
+        if (!sorted)
+        {
+            de = sort(de, static_cast<std::ptrdiff_t>(ax), method);
+        }
+    }
+
+    namespace detail
+    {
+        template <class VT, class T>
+        struct rebind_value_type
+        {
+            using type = xarray<VT, xt::layout_type::dynamic>;
+        };
+
+        template <class VT, class EC, layout_type L>
+        struct rebind_value_type<VT, xarray<EC, L>>
+        {
+            using type = xarray<VT, L>;
+        };
+
+        template <class VT, class EC, std::size_t N, layout_type L>
+        struct rebind_value_type<VT, xtensor<EC, N, L>>
+        {
+            using type = xtensor<VT, N, L>;
+        };
+
+        template <class VT, class ET, class S, layout_type L>
+        struct rebind_value_type<VT, xtensor_fixed<ET, S, L>>
+        {
+            using type = xtensor_fixed<VT, S, L>;
+        };
+
+        template <class VT, class T>
+        struct flatten_rebind_value_type
+        {
+            using type = typename rebind_value_type<VT, T>::type;
+        };
+
+        template <class VT, class EC, std::size_t N, layout_type L>
+        struct flatten_rebind_value_type<VT, xtensor<EC, N, L>>
+        {
+            using type = xtensor<VT, 1, L>;
+        };
+
+        template <class VT, class ET, class S, layout_type L>
+        struct flatten_rebind_value_type<VT, xtensor_fixed<ET, S, L>>
+        {
+            using type = xtensor_fixed<VT, xshape<fixed_compute_size<S>::value>, L>;
+        };
+
+        template <class T>
+        struct argsort_result_type
+        {
+            using type = typename rebind_value_type<typename T::temporary_type::size_type,
+                                                    typename T::temporary_type>::type;
+        };
+
+        template <class T>
+        struct linear_argsort_result_type
+        {
+            using type = typename flatten_rebind_value_type<typename T::temporary_type::size_type,
+                                                            typename T::temporary_type>::type;
+        };
+
+        template <class Ed, class Ei, class M>
+        inline void argsort_over_leading_axis(const Ed& data, Ei& inds, M method)
+        {
+            std::size_t n_iters = 1;
+            std::ptrdiff_t data_secondary_stride;
+            std::ptrdiff_t inds_secondary_stride;
+            if (data.layout() == layout_type::row_major)
+            {
+                n_iters = std::accumulate(data.shape().begin(), data.shape().end() - 1,
+                                          std::size_t(1), std::multiplies<>());
+                data_secondary_stride = static_cast<std::ptrdiff_t>(data.strides()[data.dimension() - 2]);
+                inds_secondary_stride = static_cast<std::ptrdiff_t>(inds.strides()[inds.dimension() - 2]);
+            }
+            else
+            {
+                n_iters = std::accumulate(data.shape().begin() + 1, data.shape().end(),
+                                          std::size_t(1), std::multiplies<>());
+                data_secondary_stride = static_cast<std::ptrdiff_t>(data.strides()[1]);
+                inds_secondary_stride = static_cast<std::ptrdiff_t>(inds.strides()[1]);
+            }
+
+            if (data.size() == 0)
+            {
+                return;
+            }
+
+            for_each_lane(n_iters, std::size_t(inds_secondary_stride), [&](std::size_t i)
+            {
+                auto lane = data.data() + std::ptrdiff_t(i) * data_secondary_stride;
+                auto get = [lane](std::size_t x) -> const auto& { return *(lane + x); };
+                argsort_lane(get, std::size_t(inds_secondary_stride),
+                             inds.data() + std::ptrdiff_t(i) * inds_secondary_stride, method);
+            });
+        }
+
+        template <class E, class R = typename detail::linear_argsort_result_type<E>::type,
+                  class M = sorting_method::automatic>
+        inline auto flatten_argsort_impl(const xexpression<E>& e, M method = M())
+        {
+            using result_type = R;
+
+            const auto& de = e.derived_cast();
 
             result_type result;
             result.resize({de.size()});
-            auto comp = [&de](std::size_t x, std::size_t y) {
-                return de[x] < de[y];
-            };
-            std::iota(result.begin(), result.end(), 0);
-            std::sort(result.begin(), result.end(), comp);
+            auto get = [&de](std::size_t x) { return de[x]; };
+            argsort_lane(get, de.size(), result.data(), method);
+
+            return result;
+        }
+    }
+
+    template <class E, class M = sorting_method::automatic,
+              XTENSOR_REQUIRE<std::is_base_of<sorting_method::base, M>::value>>
+    inline auto argsort(const xexpression<E>& e, placeholders::xtuph /*t*/, M method = M())
+    {
+        return detail::flatten_argsort_impl(e, method);
+    }
+
+    /**
+     * Argsort xexpression (optionally along axis)
+     * Performs an indirect sort along the given axis. Returns an xarray
+     * of indices of the same shape as e that index data along the given axis in
+     * sorted order.
+     *
+     * @param e xexpression to argsort
+     * @param axis axis along which argsort is performed
+     * @param method sorting algorithm (sorting_method::automatic, comparison, radix
+     *        or stable); the radix and stable sorts keep the order of equal elements
+     *
+     * @return argsorted index array
+     */
+    template <class E, class M = sorting_method::automatic,
+              XTENSOR_REQUIRE<std::is_base_of<sorting_method::base, M>::value>>
+    inline auto argsort(const xexpression<E>& e, std::ptrdiff_t axis = -1, M method = M())
+    {
+        using eval_type = typename detail::sort_eval_type<E>::type;
+        using result_type = typename detail::argsort_result_type<eval_type>::type;
+
+        const auto& de = e.derived_cast();
+
+        std::size_t ax = detail::normalize_axis(axis, de.dimension());
+
+        if (de.dimension() == 1)
+        {
+            return detail::flatten_argsort_impl<E, result_type>(e, method);
+        }
+
+        if (ax != detail::leading_axis(de))
+        {
+            dynamic_shape<std::size_t> permutation, reverse_permutation;
+            std::tie(permutation, reverse_permutation) = detail::get_permutations(de.dimension(), ax, de.layout());
+
+            eval_type ev = transpose(de, permutation);
+            result_type res = result_type::from_shape(ev.shape());
+            detail::argsort_over_leading_axis(ev, res, method);
+            res = transpose(res, reverse_permutation);
+            return res;
+        }
+        else
+        {
+            result_type res = result_type::from_shape(de.shape());
+            detail::argsort_over_leading_axis(de, res, method);
+            return res;
+        }
+    }
+
+    /***************************
+     * lexsort and sort_by_key *
+     ***************************/
+
+    namespace detail
+    {
+        // Sorts perm stably by the values of key at the indices it holds
+        template <class K, class I>
+        inline void stable_sort_by_key(const K& key, I* perm, std::size_t n, std::true_type /*radix sortable*/)
+        {
+            using value_type = std::decay_t<typename K::value_type>;
+            if (use_stable_radix_sort<value_type>(n))
+            {
+                std::vector<radix_key_t<value_type>> keys(n);
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    keys[i] = radix_key(static_cast<value_type>(key(perm[i])));
+                }
+                radix_sort_keys(keys.data(), perm, n);
+                return;
+            }
+            stable_sort_by_key(key, perm, n, std::false_type());
+        }
+
+        template <class K, class I>
+        inline void stable_sort_by_key(const K& key, I* perm, std::size_t n, std::false_type /*radix sortable*/)
+        {
+            std::stable_sort(perm, perm + n, [&key](I x, I y) { return key(x) < key(y); });
+        }
+
+        template <class I>
+        inline void lexsort_keys(I* /*perm*/, std::size_t /*n*/)
+        {
+        }
+
+        template <class I, class K, class... Ks>
+        inline void lexsort_keys(I* perm, std::size_t n, const K& key, const Ks&... keys)
+        {
+            using value_type = std::decay_t<typename K::value_type>;
+            if (key.dimension() != 1 || key.size() != n)
+            {
+                throw std::runtime_error("lexsort: the keys must be one-dimensional and of the same size");
+            }
+            auto&& k = eval(key);
+            stable_sort_by_key(k, perm, n, std::integral_constant<bool, is_radix_sortable<value_type>::value>());
+            lexsort_keys(perm, n, keys...);
+        }
+
+        template <class E, class S = typename E::shape_type>
+        struct sort_by_key_values_type
+        {
+            using type = xarray<std::decay_t<typename E::value_type>>;
+        };
+
+        template <class E, class T, std::size_t N>
+        struct sort_by_key_values_type<E, std::array<T, N>>
+        {
+            using type = xtensor<std::decay_t<typename E::value_type>, N>;
+        };
+
+        // Moves the rows of row elements of data to the positions given by perm
+        template <class T>
+        inline void permute_rows(T* data, const std::vector<std::size_t>& perm, std::size_t row)
+        {
+            std::vector<T> tmp(data, data + perm.size() * row);
+            for (std::size_t i = 0; i < perm.size(); ++i)
+            {
+                auto first = tmp.cbegin() + static_cast<std::ptrdiff_t>(perm[i] * row);
+                std::copy(first, first + static_cast<std::ptrdiff_t>(row), data + i * row);
+            }
+        }
+
+        template <class T>
+        struct is_radix_payload
+            : std::integral_constant<bool, std::is_trivially_copyable<T>::value && !std::is_same<T, bool>::value>
+        {
+        };
+
+        template <class K, class T>
+        inline void radix_sort_payload(K* keys, T* data, std::size_t n, std::size_t row, std::false_type /*radix payload*/)
+        {
+            std::vector<std::size_t> perm(n);
+            std::iota(perm.begin(), perm.end(), std::size_t(0));
+            radix_sort_keys(keys, perm.data(), n);
+            permute_rows(data, perm, row);
+        }
+
+        template <class K, class T>
+        inline void radix_sort_payload(K* keys, T* data, std::size_t n, std::size_t row, std::true_type /*radix payload*/)
+        {
+            if (row == 1)
+            {
+                // the payload is permuted with the keys in the same passes
+                radix_sort_keys(keys, data, n);
+                return;
+            }
+            radix_sort_payload(keys, data, n, row, std::false_type());
+        }
+
+        template <class RK, class RV>
+        inline void sort_by_key_impl(RK& keys, RV& values, std::size_t row, std::true_type /*radix sortable*/)
+        {
+            using key_type = typename RK::value_type;
+            using value_type = typename RV::value_type;
+            std::size_t n = keys.size();
+            if (!use_stable_radix_sort<key_type>(n))
+            {
+                sort_by_key_impl(keys, values, row, std::false_type());
+                return;
+            }
+            std::vector<radix_key_t<key_type>> rkeys(n);
+            std::transform(keys.cbegin(), keys.cend(), rkeys.begin(), [](const key_type& v) { return radix_key(v); });
+            if (!std::is_integral<key_type>::value)
+            {
+                // the floating point keys are not decoded: the rows follow
+                // the permutation sorting the keys
+                std::vector<std::size_t> perm(n);
+                std::iota(perm.begin(), perm.end(), std::size_t(0));
+                radix_sort_keys(rkeys.data(), perm.data(), n);
+                permute_rows(keys.data(), perm, 1);
+                permute_rows(values.data(), perm, row);
+                return;
+            }
+            radix_sort_payload(rkeys.data(), values.data(), n, row,
+                               std::integral_constant<bool, is_radix_payload<value_type>::value>());
+            std::transform(rkeys.cbegin(), rkeys.cend(), keys.begin(), [](radix_key_t<key_type> k) {
+                return radix_value<key_type>(k, std::is_integral<key_type>());
+            });
+        }
+
+        template <class RK, class RV>
+        inline void sort_by_key_impl(RK& keys, RV& values, std::size_t row, std::false_type /*radix sortable*/)
+        {
+            std::size_t n = keys.size();
+            std::vector<std::size_t> perm(n);
+            std::iota(perm.begin(), perm.end(), std::size_t(0));
+            stable_sort_by_key(keys, perm.data(), n, std::false_type());
+            permute_rows(keys.data(), perm, 1);
+            permute_rows(values.data(), perm, row);
+        }
+    }
+
+    /**
+     * Indirect stable sort on several keys, like ``numpy.lexsort``: returns
+     * the indices sorting the keys, the last key being the primary one, and
+     * the previous keys breaking its ties in turn. Each key is sorted stably
+     * once, with the radix sort for large arithmetic keys, so that sorting
+     * on k keys does not compare tuples.
+     *
+     * @param keys the one-dimensional keys, all of the same size
+     * @return xtensor of the indices in sorted order
+     */
+    template <class E, class... Es>
+    inline auto lexsort(const xexpression<E>& key, const xexpression<Es>&... keys)
+    {
+        std::size_t n = key.derived_cast().size();
+        auto res = xtensor<std::size_t, 1>::from_shape({n});
+        std::iota(res.begin(), res.end(), std::size_t(0));
+        detail::lexsort_keys(res.data(), n, key.derived_cast(), keys.derived_cast()...);
+        return res;
+    }
 
-            return result;
+    /**
+     * Stable sort of a payload by keys: returns the sorted keys and the
+     * values permuted in the same order. The values are moved along their
+     * first axis, whose size must be the number of keys, so that the rows
+     * of a table are sorted by one of its columns. For large arithmetic
+     * keys, the radix sort moves one-dimensional values along with the keys,
+     * without building the permutation and gathering the values afterwards.
+     *
+     * @param keys the one-dimensional keys
+     * @param values the payload to permute
+     * @return a pair (sorted keys, permuted values)
+     */
+    template <class K, class V>
+    inline auto sort_by_key(const xexpression<K>& keys, const xexpression<V>& values)
+    {
+        using key_type = std::decay_t<typename K::value_type>;
+        using values_type = typename detail::sort_by_key_values_type<V>::type;
+
+        const auto& dk = keys.derived_cast();
+        const auto& dv = values.derived_cast();
+        if (dk.dimension() != 1 || dv.dimension() == 0 || dv.shape()[0] != dk.size())
+        {
+            throw std::runtime_error("sort_by_key: the keys must be one-dimensional and match the first axis of the values");
         }
+        xtensor<key_type, 1> rk = dk;
+        values_type rv = dv;
+        std::size_t row = rk.size() == 0 ? std::size_t(0) : rv.size() / rk.size();
+        detail::sort_by_key_impl(rk, rv, row, std::integral_constant<bool, detail::is_radix_sortable<key_type>::value>());
+        return std::make_pair(std::move(rk), std::move(rv));
     }
 
-    template <class E>
-    inline auto argsort(const xexpression<E>& e, placeholders::xtuph /*t*/)
+    /*************
+     * selection *
+     *************/
+
+    namespace detail
     {
-        return detail::flatten_argsort_impl(e);
+        // Copies e into a container whose contiguous axis is the given axis,
+        // reverse_permutation receives the permutation restoring the original
+        // order of the axes (it is left empty when no transposition is needed).
+        template <class E>
+        inline auto copy_with_leading_axis(const E& e, std::size_t axis,
+                                           dynamic_shape<std::size_t>& reverse_permutation)
+        {
+            using eval_type = typename sort_eval_type<E>::type;
+            if (axis != leading_axis(e))
+            {
+                dynamic_shape<std::size_t> permutation;
+                std::tie(permutation, reverse_permutation) = get_permutations(e.dimension(), axis, e.layout());
+                eval_type ev = transpose(e, permutation);
+                return ev;
+            }
+            eval_type ev = e;
+            return ev;
+        }
+
+        template <class R>
+        inline void restore_axes(R& res, const dynamic_shape<std::size_t>& reverse_permutation)
+        {
+            if (!reverse_permutation.empty())
+            {
+                res = transpose(res, reverse_permutation);
+            }
+        }
+
+        // Returns a container with the type and layout of ev but value type VT,
+        // and n_out elements along its leading axis.
+        template <class VT, class E>
+        inline auto lanes_result(const E& ev, std::size_t n_out)
+        {
+            using result_type = typename rebind_value_type<VT, E>::type;
+            auto shape = ev.shape();
+            shape[leading_axis(ev)] = n_out;
+            return result_type::from_shape(shape);
+        }
+
+        // Calls f(i, lane_first) for each of the contiguous lanes of n elements
+        // of ev, possibly concurrently.
+        template <class E, class F>
+        inline void for_each_leading_lane(E& ev, std::size_t n, F&& f)
+        {
+            if (ev.size() == 0)
+            {
+                return;
+            }
+            auto data = ev.data();
+            for_each_lane(ev.size() / n, n, [data, n, &f](std::size_t i)
+            {
+                f(i, data + std::ptrdiff_t(i * n));
+            });
+        }
+
+        inline std::size_t checked_axis_size(std::size_t size, std::size_t k, const char* msg)
+        {
+            if (k >= size)
+            {
+                throw std::runtime_error(msg);
+            }
+            return size;
+        }
     }
 
     /**
-     * Argsort xexpression (optionally along axis)
-     * Performs an indirect sort along the given axis. Returns an xarray
-     * of indices of the same shape as e that index data along the given axis in
-     * sorted order.
+     * Partially sorts xexpression along axis: the element at position \c kth
+     * along the axis is the one that would be there in a sorted array, smaller
+     * or equal elements are placed before it and greater or equal ones after it,
+     * in an unspecified order. The selection is performed using ``std::nth_element``,
+     * which runs in linear time on average. A copy of the xexpression is created
+     * and returned.
      *
-     * @param e xexpression to argsort
-     * @param axis axis along which argsort is performed
+     * @param e xexpression to partition
+     * @param kth index of the element in sorted position
+     * @param axis axis along which the partition is performed
      *
-     * @return argsorted index array
+     * @return partitioned array (copy)
      */
     template <class E>
-    inline auto argsort(const xexpression<E>& e, std::ptrdiff_t axis = -1)
+    inline auto partition(const xexpression<E>& e, std::size_t kth, std::ptrdiff_t axis = -1)
     {
-        using eval_type = typename detail::sort_eval_type<E>::type;
-        using result_type = typename detail::argsort_result_type<eval_type>::type;
+        const auto& de = e.derived_cast();
+        std::size_t ax = detail::normalize_axis(axis, de.dimension());
+        std::size_t n = detail::checked_axis_size(de.shape()[ax], kth, "partition: kth out of bounds");
+
+        dynamic_shape<std::size_t> reverse_permutation;
+        auto res = detail::copy_with_leading_axis(de, ax, reverse_permutation);
+        detail::for_each_leading_lane(res, n, [n, kth](std::size_t, auto lane) {
+            std::nth_element(lane, lane + std::ptrdiff_t(kth), lane + std::ptrdiff_t(n));
+        });
+        detail::restore_axes(res, reverse_permutation);
+        return res;
+    }
 
+    /**
+     * Indirect partition of xexpression along axis. Returns an array of indices
+     * of the same shape as e that index data along the given axis in partitioned
+     * order, as returned by partition.
+     *
+     * @param e xexpression to argpartition
+     * @param kth index of the element in sorted position
+     * @param axis axis along which the argpartition is performed
+     *
+     * @return argpartitioned index array
+     */
+    template <class E>
+    inline auto argpartition(const xexpression<E>& e, std::size_t kth, std::ptrdiff_t axis = -1)
+    {
         const auto& de = e.derived_cast();
+        std::size_t ax = detail::normalize_axis(axis, de.dimension());
+        std::size_t n = detail::checked_axis_size(de.shape()[ax], kth, "argpartition: kth out of bounds");
+
+        dynamic_shape<std::size_t> reverse_permutation;
+        auto ev = detail::copy_with_leading_axis(de, ax, reverse_permutation);
+        using size_type = typename decltype(ev)::size_type;
+        auto res = detail::lanes_result<size_type>(ev, n);
+        auto inds = res.data();
+        detail::for_each_leading_lane(ev, n, [n, kth, inds](std::size_t i, auto lane) {
+            auto first = inds + std::ptrdiff_t(i * n);
+            std::iota(first, first + std::ptrdiff_t(n), size_type(0));
+            std::nth_element(first, first + std::ptrdiff_t(kth), first + std::ptrdiff_t(n),
+                             [lane](size_type x, size_type y) { return lane[x] < lane[y]; });
+        });
+        detail::restore_axes(res, reverse_permutation);
+        return res;
+    }
 
+    /**
+     * Returns the \c k largest elements of xexpression along axis, and their
+     * indices along that axis. The result arrays have the shape of e except
+     * along axis, where they hold k elements in decreasing order; equal elements
+     * are sorted by increasing index. The selection runs in O(n + k log(k)) time
+     * per lane instead of O(n log(n)) for a full argsort.
+     *
+     * @param e input xexpression
+     * @param k number of elements to select
+     * @param axis axis along which the selection is performed
+     *
+     * @return a pair (values, indices)
+     */
+    template <class E>
+    inline auto topk(const xexpression<E>& e, std::size_t k, std::ptrdiff_t axis = -1)
+    {
+        const auto& de = e.derived_cast();
         std::size_t ax = detail::normalize_axis(axis, de.dimension());
+        std::size_t n = de.shape()[ax];
+        if (k > n)
+        {
+            throw std::runtime_error("topk: k out of bounds");
+        }
 
-        if (de.dimension() == 1)
+        dynamic_shape<std::size_t> reverse_permutation;
+        auto ev = detail::copy_with_leading_axis(de, ax, reverse_permutation);
+        using eval_type = decltype(ev);
+        using size_type = typename eval_type::size_type;
+        auto values = detail::lanes_result<typename eval_type::value_type>(ev, k);
+        auto indices = detail::lanes_result<size_type>(ev, k);
+        if (k != 0)
         {
-            return detail::flatten_argsort_impl<E, result_type>(e);
+            auto vals = values.data();
+            auto inds = indices.data();
+            detail::for_each_leading_lane(ev, n, [n, k, vals, inds](std::size_t i, auto lane) {
+                std::vector<size_type> idx(n);
+                std::iota(idx.begin(), idx.end(), size_type(0));
+                auto comp = [lane](size_type x, size_type y) {
+                    return lane[y] < lane[x] || (!(lane[x] < lane[y]) && x < y);
+                };
+                std::nth_element(idx.begin(), idx.begin() + std::ptrdiff_t(k - 1), idx.end(), comp);
+                std::sort(idx.begin(), idx.begin() + std::ptrdiff_t(k), comp);
+                std::copy(idx.begin(), idx.begin() + std::ptrdiff_t(k), inds + std::ptrdiff_t(i * k));
+                std::transform(idx.begin(), idx.begin() + std::ptrdiff_t(k), vals + std::ptrdiff_t(i * k),
+                               [lane](size_type x) { return lane[x]; });
+            });
         }
+        detail::restore_axes(values, reverse_permutation);
+        detail::restore_axes(indices, reverse_permutation);
+        return std::make_pair(std::move(values), std::move(indices));
+    }
 
-        if (ax != detail::leading_axis(de))
+    /****************
+     * searchsorted *
+     ****************/
+
+    /**
+     * Finds the indices where the elements of \c values should be inserted into
+     * the one-dimensional sorted expression \c sorted to maintain its order.
+     * With search_side::left, the index of the first element that is not less
+     * than the value is returned, with search_side::right the index of the
+     * first element that is greater than the value. The searches are branch-free
+     * binary searches; large arrays are searched through a copy in Eytzinger
+     * order when there are more values than sorted elements.
+     *
+     * @param sorted one-dimensional xexpression sorted in increasing order
+     * @param values values to insert
+     * @param side side of the range of elements equal to a value
+     *
+     * @return array of indices with the shape of values
+     */
+    template <class E1, class E2>
+    inline auto searchsorted(const xexpression<E1>& sorted, const xexpression<E2>& values,
+                             search_side side = search_side::left)
+    {
+        using eval_type = typename detail::sort_eval_type<E2>::type;
+        using result_type = typename detail::argsort_result_type<eval_type>::type;
+
+        const auto& ds = sorted.derived_cast();
+        XTENSOR_ASSERT(ds.dimension() == 1);
+        XTENSOR_ASSERT(std::is_sorted(ds.cbegin(), ds.cend()));
+        auto&& s = xt::eval(ds);
+        eval_type v = values.derived_cast();
+
+        result_type res = result_type::from_shape(v.shape());
+        detail::search_sorted(s.data(), s.size(), v.data(), v.size(), res.data(), side == search_side::right);
+        return res;
+    }
+
+    /*************
+     * quantiles *
+     *************/
+
+    namespace detail
+    {
+        template <class T>
+        using quantile_value_type_t = std::conditional_t<std::is_floating_point<T>::value, T, double>;
+
+        template <class VT, class T>
+        struct quantile_result_type
         {
-            dynamic_shape<std::size_t> permutation, reverse_permutation;
-            std::tie(permutation, reverse_permutation) = detail::get_permutations(de.dimension(), ax, de.layout());
+            using type = xarray<VT>;
+        };
 
-            eval_type ev = transpose(de, permutation);
-            result_type res = result_type::from_shape(ev.shape());
-            detail::argsort_over_leading_axis(ev, res);
-            res = transpose(res, reverse_permutation);
-            return res;
+        template <class VT, class T, layout_type L>
+        struct quantile_result_type<VT, xarray<T, L>>
+        {
+            using type = xarray<VT, L>;
+        };
+
+        template <class VT, class T, std::size_t N, layout_type L>
+        struct quantile_result_type<VT, xtensor<T, N, L>>
+        {
+            using type = xtensor<VT, N - 1, L>;
+        };
+
+        // Returns the indices of the quantiles qs in increasing order of value.
+        template <class Q>
+        inline std::vector<std::size_t> quantiles_order(const Q& qs)
+        {
+            std::vector<double> q(qs.begin(), qs.end());
+            for (double v : q)
+            {
+                if (!(v >= 0. && v <= 1.))
+                {
+                    throw std::runtime_error("quantile: q must be in [0, 1]");
+                }
+            }
+            std::vector<std::size_t> order(q.size());
+            std::iota(order.begin(), order.end(), std::size_t(0));
+            std::sort(order.begin(), order.end(), [&q](std::size_t x, std::size_t y) { return q[x] < q[y]; });
+            return order;
         }
-        else
+
+        // Computes the quantiles q (visited in the given increasing order) of the n
+        // values starting at first, with linear interpolation between the closest
+        // ranks. The values are partitioned in place: each selection only scans
+        // the elements that are greater than the previous quantile. Small lanes
+        // are sorted at once with a sorting network.
+        template <class T, class R>
+        inline void select_quantiles(T* first, std::size_t n, const std::vector<double>& q,
+                                     const std::vector<std::size_t>& order, R* out)
         {
-            result_type res = result_type::from_shape(de.shape());
-            detail::argsort_over_leading_axis(de, res);
-            return res;
+            T* last = first + std::ptrdiff_t(n);
+            T* unselected = try_network_sort(first, n) ? last : first;
+            for (std::size_t j : order)
+            {
+                double pos = q[j] * static_cast<double>(n - 1);
+                std::size_t k = static_cast<std::size_t>(pos);
+                T* kth = first + std::ptrdiff_t(k);
+                if (kth >= unselected)
+                {
+                    std::nth_element(unselected, kth, last);
+                    unselected = kth + 1;
+                }
+                R frac = static_cast<R>(pos - static_cast<double>(k));
+                R lo = static_cast<R>(*kth);
+                if (frac != R(0))
+                {
+                    R hi = static_cast<R>(*std::min_element(kth + 1, last));
+                    out[j] = lo + frac * (hi - lo);
+                }
+                else
+                {
+                    out[j] = lo;
+                }
+            }
         }
+
+        template <class E, class Q>
+        inline auto quantiles_over_axis(const E& de, const Q& qs, std::size_t ax, std::size_t n_out)
+        {
+            std::vector<double> q(qs.begin(), qs.end());
+            std::vector<std::size_t> order = quantiles_order(q);
+            std::size_t n = de.shape()[ax];
+            if (n == 0)
+            {
+                throw std::runtime_error("quantile: empty axis");
+            }
+
+            dynamic_shape<std::size_t> reverse_permutation;
+            auto ev = copy_with_leading_axis(de, ax, reverse_permutation);
+            using value_type = quantile_value_type_t<typename E::value_type>;
+            auto res = lanes_result<value_type>(ev, n_out);
+            auto out = res.data();
+            std::size_t nq = q.size();
+            for_each_leading_lane(ev, n, [&q, &order, n, nq, out](std::size_t i, auto lane)
+            {
+                select_quantiles(lane, n, q, order, out + std::ptrdiff_t(i * nq));
+            });
+            return std::make_pair(std::move(res), std::move(reverse_permutation));
+        }
+    }
+
+    /**
+     * Computes the quantile \c q of xexpression along axis, using a linear
+     * interpolation between the two closest ranks like ``numpy.quantile``.
+     * The values of each lane are selected with ``std::nth_element`` on a
+     * copy of the input instead of being sorted, the lanes are processed in
+     * parallel.
+     *
+     * @param e input xexpression
+     * @param q quantile to compute, in [0, 1]
+     * @param axis axis along which the quantile is computed
+     *
+     * @return array of quantiles, with the shape of e without axis
+     */
+    template <class E>
+    inline auto quantile(const xexpression<E>& e, double q, std::ptrdiff_t axis)
+    {
+        using eval_type = typename detail::sort_eval_type<E>::type;
+        using value_type = detail::quantile_value_type_t<typename E::value_type>;
+        using result_type = typename detail::quantile_result_type<value_type, eval_type>::type;
+        using result_shape_type = typename result_type::shape_type;
+
+        const auto& de = e.derived_cast();
+        std::size_t ax = detail::normalize_axis(axis, de.dimension());
+
+        // the lanes of the intermediate result hold a single quantile, its
+        // data is laid out like the result without the reduced axis
+        auto tmp = detail::quantiles_over_axis(de, std::array<double, 1>{{q}}, ax, 1);
+        result_shape_type shape;
+        xt::resize_container(shape, de.dimension() - 1);
+        for (std::size_t i = 0, j = 0; i < de.dimension(); ++i)
+        {
+            if (i != ax)
+            {
+                shape[j++] = de.shape()[i];
+            }
+        }
+        result_type res = result_type::from_shape(shape);
+        std::copy(tmp.first.data(), tmp.first.data() + std::ptrdiff_t(res.size()), res.data());
+        return res;
+    }
+
+    /**
+     * Computes several quantiles of xexpression along axis, partitioning each
+     * lane only once for all the quantiles.
+     *
+     * @param e input xexpression
+     * @param qs quantiles to compute, in [0, 1]
+     * @param axis axis along which the quantiles are computed
+     *
+     * @return array with the shape of e, except along axis where it holds
+     *         the quantiles in the order of qs
+     */
+    template <class E, class Q, XTENSOR_REQUIRE<!std::is_arithmetic<Q>::value>>
+    inline auto quantile(const xexpression<E>& e, const Q& qs, std::ptrdiff_t axis)
+    {
+        const auto& de = e.derived_cast();
+        std::size_t ax = detail::normalize_axis(axis, de.dimension());
+        auto tmp = detail::quantiles_over_axis(de, qs, ax, std::size_t(std::distance(qs.begin(), qs.end())));
+        detail::restore_axes(tmp.first, tmp.second);
+        return std::move(tmp.first);
+    }
+
+    template <class E>
+    inline auto quantile(const xexpression<E>& e, std::initializer_list<double> qs, std::ptrdiff_t axis)
+    {
+        return quantile(e, std::vector<double>(qs), axis);
+    }
+
+    /**
+     * Computes the quantile \c q of the flattened xexpression.
+     *
+     * @param e input xexpression
+     * @param q quantile to compute, in [0, 1]
+     *
+     * @return the quantile
+     */
+    template <class E>
+    inline auto quantile(const xexpression<E>& e, double q)
+    {
+        using value_type = typename E::value_type;
+        using result_type = detail::quantile_value_type_t<value_type>;
+
+        const auto& de = e.derived_cast();
+        if (de.size() == 0)
+        {
+            throw std::runtime_error("quantile: empty expression");
+        }
+        std::vector<double> qs = {q};
+        std::vector<std::size_t> order = detail::quantiles_order(qs);
+        std::vector<value_type> values(de.cbegin(), de.cend());
+        result_type res;
+        detail::select_quantiles(values.data(), values.size(), qs, order, &res);
+        return res;
+    }
+
+    /**
+     * Computes the median of xexpression along axis.
+     * @sa quantile
+     */
+    template <class E>
+    inline auto median(const xexpression<E>& e, std::ptrdiff_t axis)
+    {
+        return quantile(e, 0.5, axis);
+    }
+
+    /**
+     * Computes the median of the flattened xexpression.
+     * @sa quantile
+     */
+    template <class E>
+    inline auto median(const xexpression<E>& e)
+    {
+        return quantile(e, 0.5);
+    }
+
+    /**
+     * Computes the percentile \c p, in [0, 100], of xexpression along axis.
+     * @sa quantile
+     */
+    template <class E>
+    inline auto percentile(const xexpression<E>& e, double p, std::ptrdiff_t axis)
+    {
+        return quantile(e, p / 100., axis);
+    }
+
+    /**
+     * Computes several percentiles of xexpression along axis.
+     * @sa quantile
+     */
+    template <class E, class P, XTENSOR_REQUIRE<!std::is_arithmetic<P>::value>>
+    inline auto percentile(const xexpression<E>& e, const P& ps, std::ptrdiff_t axis)
+    {
+        std::vector<double> qs(ps.begin(), ps.end());
+        std::transform(qs.begin(), qs.end(), qs.begin(), [](double p) { return p / 100.; });
+        return quantile(e, qs, axis);
+    }
+
+    template <class E>
+    inline auto percentile(const xexpression<E>& e, std::initializer_list<double> ps, std::ptrdiff_t axis)
+    {
+        return percentile(e, std::vector<double>(ps), axis);
+    }
+
+    /**
+     * Computes the percentile \c p, in [0, 100], of the flattened xexpression.
+     * @sa quantile
+     */
+    template <class E>
+    inline auto percentile(const xexpression<E>& e, double p)
+    {
+        return quantile(e, p / 100.);
     }
 
     namespace detail
     {
         template <class T>
-        struct argfunc_result_type
+        struct argfunc_result_type
+        {
+            using type = xarray<std::size_t>;
+        };
+
+        template <class T, std::size_t N>
+        struct argfunc_result_type<xtensor<T, N>>
+        {
+            using type = xtensor<std::size_t, N - 1>;
+        };
+
+        template <class IT, class F>
+        inline std::size_t cmp_idx(IT iter, IT end, std::ptrdiff_t inc, F&& cmp)
+        {
+            std::size_t idx = 0;
+            auto min = *iter;
+            iter += inc;
+            for (std::size_t i = 1; iter < end; iter += inc, ++i)
+            {
+                if (cmp(*iter, min))
+                {
+                    min = *iter;
+                    idx = i;
+                }
+            }
+            return idx;
+        }
+
+        // Comparisons of argmin and argmax that can be applied on simd batches
+        template <class F>
+        struct simd_arg_compare
+        {
+            static constexpr bool value = false;
+        };
+
+        template <class T>
+        struct simd_arg_compare<std::less<T>>
+        {
+            static constexpr bool value = true;
+
+            template <class B>
+            static auto apply(const B& lhs, const B& rhs)
+            {
+                return lhs < rhs;
+            }
+        };
+
+        template <class T>
+        struct simd_arg_compare<std::greater<T>>
         {
-            using type = xarray<std::size_t>;
+            static constexpr bool value = true;
+
+            template <class B>
+            static auto apply(const B& lhs, const B& rhs)
+            {
+                return lhs > rhs;
+            }
         };
 
-        template <class T, std::size_t N>
-        struct argfunc_result_type<xtensor<T, N>>
+        constexpr std::size_t arg_block_size = 1024;
+
+        // Updates best and idx with the first element of [first + begin,
+        // first + end) comparing better than best.
+        template <class T, class F>
+        inline void arg_extremum_scan(const T* first, std::size_t begin, std::size_t end,
+                                      T& best, std::size_t& idx, F& cmp, std::false_type /*simd*/)
         {
-            using type = xtensor<std::size_t, N - 1>;
-        };
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                if (cmp(first[i], best))
+                {
+                    best = first[i];
+                    idx = i;
+                }
+            }
+        }
 
-        template <class IT, class F>
-        inline std::size_t cmp_idx(IT iter, IT end, std::ptrdiff_t inc, F&& cmp)
+#ifdef XTENSOR_USE_XSIMD
+        // The extremum of each block is found with simd batches holding only
+        // values; a block is scanned again to get the position of its
+        // extremum only if it improves on best. Blocks fit in the L1 cache, so
+        // the data are read once from memory.
+        template <class T, class F>
+        inline void arg_extremum_scan(const T* first, std::size_t begin, std::size_t end,
+                                      T& best, std::size_t& idx, F& cmp, std::true_type /*simd*/)
+        {
+            using batch_type = xsimd::simd_type<T>;
+            constexpr std::size_t simd_size = batch_type::size;
+            for (std::size_t b = begin; b < end; b += arg_block_size)
+            {
+                std::size_t b_end = (std::min)(b + arg_block_size, end);
+                std::size_t simd_end = b + (b_end - b) - (b_end - b) % simd_size;
+                batch_type acc = xsimd::set_simd(best);
+                for (std::size_t i = b; i < simd_end; i += simd_size)
+                {
+                    batch_type v = xsimd::load_simd<T, T>(first + i, xsimd::unaligned_mode());
+                    acc = xsimd::select(simd_arg_compare<std::decay_t<F>>::apply(v, acc), v, acc);
+                }
+
+                alignas(XTENSOR_CACHE_LINE_SIZE) T lanes[simd_size];
+                acc.store_unaligned(lanes);
+                T block_best = best;
+                for (std::size_t l = 0; l < simd_size; ++l)
+                {
+                    block_best = cmp(lanes[l], block_best) ? lanes[l] : block_best;
+                }
+                if (cmp(block_best, best))
+                {
+                    arg_extremum_scan(first, b, simd_end, best, idx, cmp, std::false_type());
+                }
+                arg_extremum_scan(first, simd_end, b_end, best, idx, cmp, std::false_type());
+            }
+        }
+#endif
+
+        // Returns the position of the first extremum of n > 0 contiguous
+        // elements. Large ranges are split into a fixed number of chunks
+        // searched concurrently; each chunk looks for elements comparing
+        // better than the first one, so that NaN and ties give the same
+        // result as a sequential scan.
+        template <class T, class F>
+        inline std::size_t arg_extremum(const T* first, std::size_t n, F& cmp)
         {
+#ifdef XTENSOR_USE_XSIMD
+            using use_simd = std::integral_constant<bool, simd_arg_compare<std::decay_t<F>>::value &&
+                                                          xsimd::simd_traits<T>::size != 1>;
+#else
+            using use_simd = std::false_type;
+#endif
+            T best = first[0];
             std::size_t idx = 0;
-            auto min = *iter;
-            iter += inc;
-            for (std::size_t i = 1; iter < end; iter += inc, ++i)
+#if defined(XTENSOR_PARALLEL_ENABLED)
+            constexpr std::size_t max_chunks = 64;
+            if (parallel::use_parallel(n) && n >= max_chunks * arg_block_size)
             {
-                if (cmp(*iter, min))
+                std::size_t chunk_size = std::max((n + max_chunks - 1) / max_chunks, parallel::grain(1));
+                std::size_t nchunks = (n + chunk_size - 1) / chunk_size;
+                std::vector<std::pair<T, std::size_t>> partials(nchunks, std::make_pair(best, std::size_t(0)));
+                parallel_for(std::size_t(0), nchunks, std::size_t(1), [&](std::size_t c_first, std::size_t c_last)
                 {
-                    min = *iter;
-                    idx = i;
+                    for (std::size_t c = c_first; c < c_last; ++c)
+                    {
+                        std::size_t begin = (std::max)(c * chunk_size, std::size_t(1));
+                        arg_extremum_scan(first, begin, (std::min)(c * chunk_size + chunk_size, n),
+                                          partials[c].first, partials[c].second, cmp, use_simd());
+                    }
+                });
+                for (std::size_t c = 0; c < nchunks; ++c)
+                {
+                    if (cmp(partials[c].first, best))
+                    {
+                        best = partials[c].first;
+                        idx = partials[c].second;
+                    }
                 }
+                return idx;
             }
+#endif
+            arg_extremum_scan(first, std::size_t(1), n, best, idx, cmp, use_simd());
             return idx;
         }
 
         template <class E, class F>
         inline xtensor<std::size_t, 0> arg_func_impl(const E& e, F&& f)
         {
+            if (e.layout() == XTENSOR_DEFAULT_LAYOUT)
+            {
+                return arg_extremum(e.data(), e.size(), f);
+            }
             return cmp_idx(e.template begin<XTENSOR_DEFAULT_LAYOUT>(),
                            e.template end<XTENSOR_DEFAULT_LAYOUT>(), 1,
                            std::forward<F>(f));
@@ -425,19 +2201,8 @@ namespace xt
             result_type result = result_type::from_shape(std::move(alt_shape));
             auto result_iter = result.begin();
 
-            auto arg_func_lambda = [&result_iter, &cmp](auto begin, auto end) {
-                std::size_t idx = 0;
-                value_type val = *begin;
-                ++begin;
-                for (std::size_t i = 1; begin != end; ++begin, ++i)
-                {
-                    if (cmp(*begin, val))
-                    {
-                        val = *begin;
-                        idx = i;
-                    }
-                }
-                *result_iter = idx;
+            auto arg_func_lambda = [&result_iter, &cmp](const value_type* begin, const value_type* end) {
+                *result_iter = arg_extremum(begin, static_cast<std::size_t>(end - begin), cmp);
                 ++result_iter;
             };
 
@@ -508,55 +2273,537 @@ namespace xt
         return detail::arg_func_impl(ed, axis, std::greater<value_type>());
     }
 
+    /**
+     * Algorithms that can be selected in unique, unique_counts, unique_inverse
+     * and setdiff1d.
+     */
+    namespace unique_method
+    {
+        struct base
+        {
+        };
+        // sorts a flattened copy of the input, the results are sorted
+        struct sort : base
+        {
+        };
+        // hash table based, O(n); the results hold the values in order
+        // of first occurrence in the flattened input
+        struct hash : base
+        {
+        };
+        // the caller guarantees that the flattened input is sorted, it is
+        // neither copied nor sorted
+        struct assume_sorted : base
+        {
+        };
+    }
+
+    namespace detail
+    {
+        template <class T>
+        struct unique_result
+        {
+            std::vector<T> values;
+            std::vector<std::size_t> counts;
+            std::vector<std::size_t> inverse;
+        };
+
+        template <class T>
+        inline xtensor<T, 1> to_xtensor(const std::vector<T>& v)
+        {
+            auto res = xtensor<T, 1>::from_shape({v.size()});
+            std::copy(v.cbegin(), v.cend(), res.begin());
+            return res;
+        }
+
+        // Collects the distinct values of [first, last), which yields the values
+        // in sorted order; order(k), if not null, is the position in the input
+        // of the k-th value, used to build the inverse.
+        template <class It, class T>
+        inline void unique_sweep(It first, It last, const std::size_t* order, unique_result<T>& r, bool inverse)
+        {
+            std::size_t k = 0;
+            for (; first != last; ++first, ++k)
+            {
+                if (r.values.empty() || !(*first == r.values.back()))
+                {
+                    r.values.push_back(*first);
+                    r.counts.push_back(0);
+                }
+                ++r.counts.back();
+                if (inverse)
+                {
+                    r.inverse[order != nullptr ? order[k] : k] = r.values.size() - 1;
+                }
+            }
+        }
+
+        template <class E>
+        inline auto unique_impl(const E& de, unique_method::sort, bool inverse)
+        {
+            using value_type = typename E::value_type;
+            unique_result<value_type> r;
+            std::vector<value_type> values(de.cbegin(), de.cend());
+            if (inverse)
+            {
+                std::vector<std::size_t> order(values.size());
+                argsort_lane([&values](std::size_t i) -> const value_type& { return values[i]; },
+                             values.size(), order.data(), sorting_method::automatic());
+                std::vector<value_type> sorted(values.size());
+                std::transform(order.cbegin(), order.cend(), sorted.begin(),
+                               [&values](std::size_t i) { return values[i]; });
+                r.inverse.resize(values.size());
+                unique_sweep(sorted.cbegin(), sorted.cend(), order.data(), r, true);
+            }
+            else
+            {
+                sort_lane(values.data(), values.data() + values.size(), sorting_method::automatic());
+                unique_sweep(values.cbegin(), values.cend(), nullptr, r, false);
+            }
+            return r;
+        }
+
+        template <class E>
+        inline auto unique_impl(const E& de, unique_method::assume_sorted, bool inverse)
+        {
+            using value_type = typename E::value_type;
+            unique_result<value_type> r;
+            XTENSOR_ASSERT(std::is_sorted(de.cbegin(), de.cend()));
+            if (inverse)
+            {
+                r.inverse.resize(de.size());
+            }
+            unique_sweep(de.cbegin(), de.cend(), nullptr, r, inverse);
+            return r;
+        }
+
+        template <class E>
+        inline auto unique_impl(const E& de, unique_method::hash, bool inverse)
+        {
+            using value_type = typename E::value_type;
+            unique_result<value_type> r;
+            if (inverse)
+            {
+                r.inverse.reserve(de.size());
+            }
+            std::unordered_map<value_type, std::size_t> ids;
+            for (auto it = de.cbegin(); it != de.cend(); ++it)
+            {
+                auto ins = ids.emplace(*it, r.values.size());
+                if (ins.second)
+                {
+                    r.values.push_back(*it);
+                    r.counts.push_back(0);
+                }
+                ++r.counts[ins.first->second];
+                if (inverse)
+                {
+                    r.inverse.push_back(ins.first->second);
+                }
+            }
+            return r;
+        }
+    }
+
     /**
      * Find unique elements of a xexpression. This returns a flattened xtensor with
-     * sorted, unique elements from the original expression.
+     * the unique elements from the original expression, sorted unless
+     * unique_method::hash is selected.
      *
      * @param e input xexpression (will be flattened)
+     * @param method unique_method::sort (default), hash or assume_sorted
      */
-    template <class E>
-    inline auto unique(const xexpression<E>& e)
+    template <class E, class M = unique_method::sort,
+              XTENSOR_REQUIRE<std::is_base_of<unique_method::base, M>::value>>
+    inline auto unique(const xexpression<E>& e, M method = M())
     {
-        auto sorted = sort(e, xnone());
-        auto end = std::unique(sorted.begin(), sorted.end());
-        std::size_t sz = static_cast<std::size_t>(std::distance(sorted.begin(), end));
-        // TODO check if we can shrink the vector without reallocation
-        using value_type = typename E::value_type;
-        auto result = xtensor<value_type, 1>::from_shape({sz});
-        std::copy(sorted.begin(), end, result.begin());
-        return result;
+        return detail::to_xtensor(detail::unique_impl(e.derived_cast(), method, false).values);
+    }
+
+    /**
+     * Find unique elements of a xexpression and the number of times each of
+     * them appears, like ``numpy.unique(e, return_counts=True)``.
+     *
+     * @param e input xexpression (will be flattened)
+     * @param method unique_method::sort (default), hash or assume_sorted
+     * @return a pair (unique values, counts)
+     */
+    template <class E, class M = unique_method::sort,
+              XTENSOR_REQUIRE<std::is_base_of<unique_method::base, M>::value>>
+    inline auto unique_counts(const xexpression<E>& e, M method = M())
+    {
+        auto r = detail::unique_impl(e.derived_cast(), method, false);
+        return std::make_pair(detail::to_xtensor(r.values), detail::to_xtensor(r.counts));
+    }
+
+    /**
+     * Find unique elements of a xexpression and the indices of the unique
+     * values that rebuild the flattened input, like
+     * ``numpy.unique(e, return_inverse=True)``.
+     *
+     * @param e input xexpression (will be flattened)
+     * @param method unique_method::sort (default), hash or assume_sorted
+     * @return a pair (unique values, inverse)
+     */
+    template <class E, class M = unique_method::sort,
+              XTENSOR_REQUIRE<std::is_base_of<unique_method::base, M>::value>>
+    inline auto unique_inverse(const xexpression<E>& e, M method = M())
+    {
+        auto r = detail::unique_impl(e.derived_cast(), method, true);
+        return std::make_pair(detail::to_xtensor(r.values), detail::to_xtensor(r.inverse));
+    }
+
+    namespace detail
+    {
+        template <class E1, class E2, class M>
+        inline auto setdiff1d_impl(const E1& ar1, const E2& ar2, M method)
+        {
+            using value_type = typename E1::value_type;
+
+            auto unique1 = unique(ar1, method);
+            auto unique2 = unique(ar2, method);
+
+            auto tmp = xtensor<value_type, 1>::from_shape({unique1.size()});
+
+            auto end = std::set_difference(
+                unique1.begin(), unique1.end(),
+                unique2.begin(), unique2.end(),
+                tmp.begin()
+            );
+
+            std::size_t sz = static_cast<std::size_t>(std::distance(tmp.begin(), end));
+
+            auto result = xtensor<value_type, 1>::from_shape({sz});
+
+            std::copy(tmp.begin(), end, result.begin());
+
+            return result;
+        }
+
+        template <class E1, class E2>
+        inline auto setdiff1d_impl(const E1& ar1, const E2& ar2, unique_method::hash)
+        {
+            using value_type = typename E1::value_type;
+
+            std::unordered_set<value_type> excluded(ar2.cbegin(), ar2.cend());
+            std::vector<value_type> values;
+            for (auto it = ar1.cbegin(); it != ar1.cend(); ++it)
+            {
+                // inserting the kept values excludes their next occurrences
+                if (excluded.insert(*it).second)
+                {
+                    values.push_back(*it);
+                }
+            }
+            return to_xtensor(values);
+        }
     }
 
     /**
      * Find the set difference of two xexpressions. This returns a flattened xtensor with
-     * the sorted, unique values in ar1 that are not in ar2.
+     * the unique values in ar1 that are not in ar2, sorted unless unique_method::hash
+     * is selected.
      *
      * @param ar1 input xexpression (will be flattened)
      * @param ar2 input xexpression
+     * @param method unique_method::sort (default), hash or assume_sorted
      */
-    template <class E1, class E2>
-    inline auto setdiff1d(const xexpression<E1>& ar1, const xexpression<E2>& ar2)
+    template <class E1, class E2, class M = unique_method::sort,
+              XTENSOR_REQUIRE<std::is_base_of<unique_method::base, M>::value>>
+    inline auto setdiff1d(const xexpression<E1>& ar1, const xexpression<E2>& ar2, M method = M())
+    {
+        return detail::setdiff1d_impl(ar1.derived_cast(), ar2.derived_cast(), method);
+    }
+
+    /*************************
+     * sorted set operations *
+     *************************/
+
+    namespace detail
     {
-        using value_type = typename E1::value_type;
+        template <class E1, class E2>
+        using set_value_type_t = std::common_type_t<typename E1::value_type, typename E2::value_type>;
+
+        // Combines the sorted distinct values of both inputs with a linear
+        // merge scan (std::set_union, std::set_symmetric_difference)
+        template <class E1, class E2, class M, class F>
+        inline auto sorted_set_operation(const E1& ar1, const E2& ar2, M method, F&& scan)
+        {
+            using value_type = set_value_type_t<E1, E2>;
+            xtensor<value_type, 1> unique1 = unique(ar1, method);
+            xtensor<value_type, 1> unique2 = unique(ar2, method);
+            std::vector<value_type> values(unique1.size() + unique2.size());
+            auto end = scan(unique1.cbegin(), unique1.cend(), unique2.cbegin(), unique2.cend(), values.begin());
+            values.erase(end, values.end());
+            return to_xtensor(values);
+        }
+
+        template <class T>
+        inline T* intersect_sorted(const T* a, std::size_t na, const T* b, std::size_t nb, T* out, std::false_type /*simd*/)
+        {
+            return std::set_intersection(a, a + na, b, b + nb, out);
+        }
+
+#ifdef XTENSOR_USE_XSIMD
+        // Intersection of sorted distinct integers: the values of a are
+        // compared with a batch of b at once, until they exceed its last
+        // value and the next batch is loaded, so that the scan does not
+        // branch on each pair of values.
+        template <class T>
+        inline T* intersect_sorted(const T* a, std::size_t na, const T* b, std::size_t nb, T* out, std::true_type /*simd*/)
+        {
+            using batch_type = xsimd::simd_type<T>;
+            constexpr std::size_t simd_size = batch_type::size;
+            std::size_t i = 0;
+            std::size_t j = 0;
+            for (; j + simd_size <= nb && i < na; j += simd_size)
+            {
+                batch_type vb = xsimd::load_simd<T, T>(b + j, xsimd::unaligned_mode());
+                T last = b[j + simd_size - 1];
+                for (; i < na && !(last < a[i]); ++i)
+                {
+                    if (xsimd::any(vb == xsimd::set_simd(a[i])))
+                    {
+                        *out++ = a[i];
+                    }
+                }
+            }
+            return std::set_intersection(a + i, a + na, b + j, b + nb, out);
+        }
+#endif
+
+        template <class E1, class E2, class M>
+        inline auto intersect1d_impl(const E1& ar1, const E2& ar2, M method)
+        {
+            using value_type = set_value_type_t<E1, E2>;
+#ifdef XTENSOR_USE_XSIMD
+            using use_simd = std::integral_constant<bool, std::is_integral<value_type>::value &&
+                                                          !std::is_same<value_type, bool>::value &&
+                                                          xsimd::simd_traits<value_type>::size != 1>;
+#else
+            using use_simd = std::false_type;
+#endif
+            xtensor<value_type, 1> unique1 = unique(ar1, method);
+            xtensor<value_type, 1> unique2 = unique(ar2, method);
+            auto tmp = xtensor<value_type, 1>::from_shape({(std::min)(unique1.size(), unique2.size())});
+            value_type* end = intersect_sorted(unique1.data(), unique1.size(), unique2.data(), unique2.size(),
+                                               tmp.data(), use_simd());
+            auto result = xtensor<value_type, 1>::from_shape({static_cast<std::size_t>(end - tmp.data())});
+            std::copy(tmp.data(), end, result.begin());
+            return result;
+        }
+
+        template <class E1, class E2>
+        inline auto intersect1d_impl(const E1& ar1, const E2& ar2, unique_method::hash)
+        {
+            using value_type = set_value_type_t<E1, E2>;
+            std::unordered_set<value_type> set2(ar2.cbegin(), ar2.cend());
+            std::unordered_set<value_type> seen;
+            std::vector<value_type> values;
+            for (auto it = ar1.cbegin(); it != ar1.cend(); ++it)
+            {
+                if (set2.count(*it) != 0 && seen.insert(*it).second)
+                {
+                    values.push_back(*it);
+                }
+            }
+            return to_xtensor(values);
+        }
+
+        template <class E1, class E2, class M>
+        inline auto union1d_impl(const E1& ar1, const E2& ar2, M method)
+        {
+            return sorted_set_operation(ar1, ar2, method, [](auto first1, auto last1, auto first2, auto last2, auto out) {
+                return std::set_union(first1, last1, first2, last2, out);
+            });
+        }
+
+        template <class E1, class E2>
+        inline auto union1d_impl(const E1& ar1, const E2& ar2, unique_method::hash)
+        {
+            using value_type = set_value_type_t<E1, E2>;
+            std::unordered_set<value_type> seen;
+            std::vector<value_type> values;
+            auto collect = [&seen, &values](const auto& ar)
+            {
+                for (auto it = ar.cbegin(); it != ar.cend(); ++it)
+                {
+                    if (seen.insert(*it).second)
+                    {
+                        values.push_back(*it);
+                    }
+                }
+            };
+            collect(ar1);
+            collect(ar2);
+            return to_xtensor(values);
+        }
+
+        template <class E1, class E2, class M>
+        inline auto setxor1d_impl(const E1& ar1, const E2& ar2, M method)
+        {
+            return sorted_set_operation(ar1, ar2, method, [](auto first1, auto last1, auto first2, auto last2, auto out) {
+                return std::set_symmetric_difference(first1, last1, first2, last2, out);
+            });
+        }
+
+        template <class E1, class E2>
+        inline auto setxor1d_impl(const E1& ar1, const E2& ar2, unique_method::hash)
+        {
+            using value_type = set_value_type_t<E1, E2>;
+            std::unordered_set<value_type> set1(ar1.cbegin(), ar1.cend());
+            std::unordered_set<value_type> set2(ar2.cbegin(), ar2.cend());
+            std::unordered_set<value_type> seen;
+            std::vector<value_type> values;
+            auto collect = [&seen, &values](const auto& ar, const auto& excluded)
+            {
+                for (auto it = ar.cbegin(); it != ar.cend(); ++it)
+                {
+                    if (excluded.count(*it) == 0 && seen.insert(*it).second)
+                    {
+                        values.push_back(*it);
+                    }
+                }
+            };
+            collect(ar1, set2);
+            collect(ar2, set1);
+            return to_xtensor(values);
+        }
+
+        template <class E1, class E2>
+        inline auto in1d_impl(const E1& element, const E2& test, unique_method::sort)
+        {
+            auto sorted = unique(test, unique_method::sort());
+            auto res = xtensor<bool, 1>::from_shape({element.size()});
+            std::transform(element.cbegin(), element.cend(), res.begin(), [&sorted](const auto& v) {
+                return std::binary_search(sorted.cbegin(), sorted.cend(), v);
+            });
+            return res;
+        }
 
-        auto unique1 = unique(ar1);
-        auto unique2 = unique(ar2);
+        // both inputs are sorted, a single merge scan tests all the elements
+        template <class E1, class E2>
+        inline auto in1d_impl(const E1& element, const E2& test, unique_method::assume_sorted)
+        {
+            XTENSOR_ASSERT(std::is_sorted(element.cbegin(), element.cend()));
+            XTENSOR_ASSERT(std::is_sorted(test.cbegin(), test.cend()));
+            auto res = xtensor<bool, 1>::from_shape({element.size()});
+            auto t = test.cbegin();
+            auto t_end = test.cend();
+            auto out = res.begin();
+            for (auto it = element.cbegin(); it != element.cend(); ++it, ++out)
+            {
+                while (t != t_end && *t < *it)
+                {
+                    ++t;
+                }
+                *out = t != t_end && !(*it < *t);
+            }
+            return res;
+        }
 
-        auto tmp = xtensor<value_type, 1>::from_shape({unique1.size()});
+        template <class E1, class E2>
+        inline auto in1d_impl(const E1& element, const E2& test, unique_method::hash)
+        {
+            using value_type = set_value_type_t<E1, E2>;
+            std::unordered_set<value_type> set(test.cbegin(), test.cend());
+            auto res = xtensor<bool, 1>::from_shape({element.size()});
+            std::transform(element.cbegin(), element.cend(), res.begin(), [&set](const auto& v) {
+                return set.count(static_cast<value_type>(v)) != 0;
+            });
+            return res;
+        }
+    }
 
-        auto end = std::set_difference(
-            unique1.begin(), unique1.end(),
-            unique2.begin(), unique2.end(),
-            tmp.begin()
-        );
+    /**
+     * Find the intersection of two xexpressions: returns a flattened xtensor
+     * of the unique values found in both, like ``numpy.intersect1d``. The
+     * sorted distinct values are intersected in a single linear scan, which
+     * compares simd batches of values for integral types.
+     *
+     * @param ar1 input xexpression (will be flattened)
+     * @param ar2 input xexpression (will be flattened)
+     * @param method unique_method::sort (default), hash or assume_sorted; with
+     *        hash, the values are in order of first occurrence in ar1
+     */
+    template <class E1, class E2, class M = unique_method::sort,
+              XTENSOR_REQUIRE<std::is_base_of<unique_method::base, M>::value>>
+    inline auto intersect1d(const xexpression<E1>& ar1, const xexpression<E2>& ar2, M method = M())
+    {
+        return detail::intersect1d_impl(ar1.derived_cast(), ar2.derived_cast(), method);
+    }
 
-        std::size_t sz = static_cast<std::size_t>(std::distance(tmp.begin(), end));
+    /**
+     * Find the union of two xexpressions: returns a flattened xtensor of the
+     * unique values found in either, like ``numpy.union1d``.
+     *
+     * @param ar1 input xexpression (will be flattened)
+     * @param ar2 input xexpression (will be flattened)
+     * @param method unique_method::sort (default), hash or assume_sorted; with
+     *        hash, the values are in order of first occurrence in ar1, then ar2
+     */
+    template <class E1, class E2, class M = unique_method::sort,
+              XTENSOR_REQUIRE<std::is_base_of<unique_method::base, M>::value>>
+    inline auto union1d(const xexpression<E1>& ar1, const xexpression<E2>& ar2, M method = M())
+    {
+        return detail::union1d_impl(ar1.derived_cast(), ar2.derived_cast(), method);
+    }
 
-        auto result = xtensor<value_type, 1>::from_shape({sz});
+    /**
+     * Find the symmetric difference of two xexpressions: returns a flattened
+     * xtensor of the unique values found in only one of them, like
+     * ``numpy.setxor1d``.
+     *
+     * @param ar1 input xexpression (will be flattened)
+     * @param ar2 input xexpression (will be flattened)
+     * @param method unique_method::sort (default), hash or assume_sorted; with
+     *        hash, the values are in order of first occurrence in ar1, then ar2
+     */
+    template <class E1, class E2, class M = unique_method::sort,
+              XTENSOR_REQUIRE<std::is_base_of<unique_method::base, M>::value>>
+    inline auto setxor1d(const xexpression<E1>& ar1, const xexpression<E2>& ar2, M method = M())
+    {
+        return detail::setxor1d_impl(ar1.derived_cast(), ar2.derived_cast(), method);
+    }
 
-        std::copy(tmp.begin(), end, result.begin());
+    /**
+     * Test whether each element of a xexpression is also present in a second
+     * one, like ``numpy.in1d``: returns a flattened xtensor of booleans.
+     * unique_method::sort looks the elements up in the sorted distinct test
+     * values; unique_method::hash builds a hash set of the test values, which
+     * is faster for large haystacks; unique_method::assume_sorted tests all the
+     * elements in a single merge scan and requires both inputs to be sorted.
+     *
+     * @param element input xexpression (will be flattened)
+     * @param test_elements the values against which to test each element
+     * @param method unique_method::sort (default), hash or assume_sorted
+     */
+    template <class E1, class E2, class M = unique_method::sort,
+              XTENSOR_REQUIRE<std::is_base_of<unique_method::base, M>::value>>
+    inline auto in1d(const xexpression<E1>& element, const xexpression<E2>& test_elements, M method = M())
+    {
+        return detail::in1d_impl(element.derived_cast(), test_elements.derived_cast(), method);
+    }
 
-        return result;
+    /**
+     * Merge two sorted xexpressions into a flattened sorted xtensor holding
+     * the values of both, duplicates included, in linear time. Equal values
+     * of ar1 come before those of ar2.
+     *
+     * @param ar1 sorted input xexpression (will be flattened)
+     * @param ar2 sorted input xexpression (will be flattened)
+     */
+    template <class E1, class E2>
+    inline auto merge(const xexpression<E1>& ar1, const xexpression<E2>& ar2)
+    {
+        using value_type = detail::set_value_type_t<E1, E2>;
+        const auto& d1 = ar1.derived_cast();
+        const auto& d2 = ar2.derived_cast();
+        XTENSOR_ASSERT(std::is_sorted(d1.cbegin(), d1.cend()));
+        XTENSOR_ASSERT(std::is_sorted(d2.cbegin(), d2.cend()));
+        auto res = xtensor<value_type, 1>::from_shape({d1.size() + d2.size()});
+        std::merge(d1.cbegin(), d1.cend(), d2.cbegin(), d2.cend(), res.begin());
+        return res;
     }
 }
 
@@ -0,0 +1,1374 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_SPARSE_HPP
+#define XTENSOR_SPARSE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xarray.hpp"
+#include "xbroadcast.hpp"
+#include "xeval.hpp"
+#include "xexception.hpp"
+#include "xexpression.hpp"
+#include "xiterable.hpp"
+#include "xparallel.hpp"
+#include "xshape.hpp"
+#include "xstrides.hpp"
+#include "xtensor.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+
+    /********************
+     * sparse extension *
+     ********************/
+
+    namespace extension
+    {
+        template <class Tag, class T>
+        struct xcsr_matrix_base_impl;
+
+        template <class T>
+        struct xcsr_matrix_base_impl<xtensor_expression_tag, T>
+        {
+            using type = xtensor_empty_base;
+        };
+
+        template <class T>
+        struct xcsr_matrix_base : xcsr_matrix_base_impl<xexpression_tag_t<T>, T>
+        {
+        };
+
+        template <class T>
+        using xcsr_matrix_base_t = typename xcsr_matrix_base<T>::type;
+
+        template <class Tag, class T>
+        struct xcoo_tensor_base_impl;
+
+        template <class T>
+        struct xcoo_tensor_base_impl<xtensor_expression_tag, T>
+        {
+            using type = xtensor_empty_base;
+        };
+
+        template <class T>
+        struct xcoo_tensor_base : xcoo_tensor_base_impl<xexpression_tag_t<T>, T>
+        {
+        };
+
+        template <class T>
+        using xcoo_tensor_base_t = typename xcoo_tensor_base<T>::type;
+    }
+
+    template <class T>
+    class xcsr_matrix;
+
+    template <class T>
+    class xcoo_tensor;
+
+    template <class T>
+    struct xiterable_inner_types<xcsr_matrix<T>>
+    {
+        using inner_shape_type = std::array<std::size_t, 2>;
+        using const_stepper = xindexed_stepper<xcsr_matrix<T>, true>;
+        using stepper = const_stepper;
+    };
+
+    template <class T>
+    struct xiterable_inner_types<xcoo_tensor<T>>
+    {
+        using inner_shape_type = dynamic_shape<std::size_t>;
+        using const_stepper = xindexed_stepper<xcoo_tensor<T>, true>;
+        using stepper = const_stepper;
+    };
+
+    namespace detail
+    {
+        // Fills the index of an element of a sparse expression of the given
+        // shape from a sequence of indices: the leading indices beyond the
+        // dimension are ignored, the missing leading ones are 0 and the
+        // indices along the broadcast dimensions of size 1 are 0.
+        template <class S, class It, class I>
+        inline void sparse_index(const S& shape, It first, It last, I& index)
+        {
+            std::size_t dim = shape.size();
+            std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+            std::size_t d = 0;
+            if (n > dim)
+            {
+                std::advance(first, static_cast<std::ptrdiff_t>(n - dim));
+            }
+            else
+            {
+                for (; d < dim - n; ++d)
+                {
+                    index[d] = 0;
+                }
+            }
+            for (; d < dim; ++d, ++first)
+            {
+                std::size_t i = static_cast<std::size_t>(*first);
+                index[d] = shape[d] == 1 ? std::size_t(0) : i;
+            }
+        }
+
+        template <class T, class U>
+        using sparse_product_type_t = std::decay_t<decltype(std::declval<T>() * std::declval<U>())>;
+    }
+
+    /***************
+     * xcsr_matrix *
+     ***************/
+
+    /**
+     * @class xcsr_matrix
+     * @brief Two-dimensional sparse matrix in compressed sparse row format.
+     *
+     * The xcsr_matrix stores the nonzero elements of each row contiguously,
+     * sorted by column: \c values holds the nonzero elements, \c indices
+     * their column and the elements of the row \c i are in the range
+     * [indptr[i], indptr[i + 1]). The matrix is a read-only expression whose
+     * missing elements are 0: it can be broadcast and combined with any
+     * other expression, and assigned to a dense container. The kernels
+     * \ref sparse_multiply, \ref sparse_sum and \ref sparse_dot only visit
+     * the nonzero elements.
+     *
+     * \code{.cpp}
+     * xt::xcsr_matrix<double> m(xt::xarray<double>{{1., 0., 0.}, {0., 0., 2.}});
+     * xt::xtensor<double, 1> y = xt::sparse_dot(m, x);
+     * xt::xarray<double> d = m + 1.;
+     * \endcode
+     *
+     * @tparam T the value type of the elements
+     */
+    template <class T>
+    class xcsr_matrix : public xexpression<xcsr_matrix<T>>,
+                        public xconst_iterable<xcsr_matrix<T>>,
+                        public extension::xcsr_matrix_base_t<T>
+    {
+    public:
+
+        using self_type = xcsr_matrix<T>;
+
+        using extension_base = extension::xcsr_matrix_base_t<T>;
+        using expression_tag = typename extension_base::expression_tag;
+
+        using value_type = T;
+        using reference = value_type;
+        using const_reference = value_type;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        using iterable_base = xconst_iterable<self_type>;
+        using inner_shape_type = typename iterable_base::inner_shape_type;
+        using shape_type = inner_shape_type;
+
+        using stepper = typename iterable_base::stepper;
+        using const_stepper = typename iterable_base::const_stepper;
+
+        using index_storage_type = xtensor<size_type, 1>;
+        using value_storage_type = xtensor<value_type, 1>;
+
+        static constexpr layout_type static_layout = layout_type::dynamic;
+        static constexpr bool contiguous_layout = false;
+
+        xcsr_matrix(size_type rows, size_type columns);
+        xcsr_matrix(size_type rows, size_type columns, index_storage_type indptr,
+                    index_storage_type indices, value_storage_type values);
+
+        template <class E>
+        explicit xcsr_matrix(const xexpression<E>& e);
+
+        size_type size() const noexcept;
+        size_type dimension() const noexcept;
+        const inner_shape_type& shape() const noexcept;
+        layout_type layout() const noexcept;
+
+        size_type nnz() const noexcept;
+        const index_storage_type& indptr() const noexcept;
+        const index_storage_type& indices() const noexcept;
+        value_storage_type& values() noexcept;
+        const value_storage_type& values() const noexcept;
+
+        template <class... Args>
+        const_reference operator()(Args... args) const;
+        template <class... Args>
+        const_reference at(Args... args) const;
+        template <class... Args>
+        const_reference unchecked(Args... args) const;
+        template <class S>
+        disable_integral_t<S, const_reference> operator[](const S& index) const;
+        template <class I>
+        const_reference operator[](std::initializer_list<I> index) const;
+        const_reference operator[](size_type i) const;
+
+        template <class It>
+        const_reference element(It first, It last) const;
+
+        template <class O>
+        bool broadcast_shape(O& shape, bool reuse_cache = false) const;
+
+        template <class O>
+        bool has_linear_assign(const O& strides) const noexcept;
+
+        template <class O>
+        const_stepper stepper_begin(const O& shape) const noexcept;
+        template <class O>
+        const_stepper stepper_end(const O& shape, layout_type) const noexcept;
+
+    private:
+
+        const_reference get(size_type row, size_type column) const;
+        void check_structure() const;
+
+        inner_shape_type m_shape;
+        index_storage_type m_indptr;
+        index_storage_type m_indices;
+        value_storage_type m_values;
+    };
+
+    /***************
+     * xcoo_tensor *
+     ***************/
+
+    /**
+     * @class xcoo_tensor
+     * @brief N-dimensional sparse tensor in coordinate format.
+     *
+     * The xcoo_tensor stores the nonzero elements in \c values and their
+     * indices in the rows of \c coords, an (nnz, dimension) tensor, sorted in
+     * row-major order without duplicates. Like \ref xcsr_matrix it is a
+     * read-only expression whose missing elements are 0, and the kernels
+     * \ref sparse_multiply, \ref sparse_sum and \ref sparse_dot only visit
+     * the nonzero elements.
+     *
+     * @tparam T the value type of the elements
+     */
+    template <class T>
+    class xcoo_tensor : public xexpression<xcoo_tensor<T>>,
+                        public xconst_iterable<xcoo_tensor<T>>,
+                        public extension::xcoo_tensor_base_t<T>
+    {
+    public:
+
+        using self_type = xcoo_tensor<T>;
+
+        using extension_base = extension::xcoo_tensor_base_t<T>;
+        using expression_tag = typename extension_base::expression_tag;
+
+        using value_type = T;
+        using reference = value_type;
+        using const_reference = value_type;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        using iterable_base = xconst_iterable<self_type>;
+        using inner_shape_type = typename iterable_base::inner_shape_type;
+        using shape_type = inner_shape_type;
+
+        using stepper = typename iterable_base::stepper;
+        using const_stepper = typename iterable_base::const_stepper;
+
+        using coords_storage_type = xtensor<size_type, 2>;
+        using value_storage_type = xtensor<value_type, 1>;
+
+        static constexpr layout_type static_layout = layout_type::dynamic;
+        static constexpr bool contiguous_layout = false;
+
+        explicit xcoo_tensor(shape_type shape);
+        xcoo_tensor(shape_type shape, coords_storage_type coords, value_storage_type values);
+
+        template <class E>
+        explicit xcoo_tensor(const xexpression<E>& e);
+
+        size_type size() const noexcept;
+        size_type dimension() const noexcept;
+        const inner_shape_type& shape() const noexcept;
+        layout_type layout() const noexcept;
+
+        size_type nnz() const noexcept;
+        const coords_storage_type& coords() const noexcept;
+        value_storage_type& values() noexcept;
+        const value_storage_type& values() const noexcept;
+
+        template <class... Args>
+        const_reference operator()(Args... args) const;
+        template <class... Args>
+        const_reference at(Args... args) const;
+        template <class... Args>
+        const_reference unchecked(Args... args) const;
+        template <class S>
+        disable_integral_t<S, const_reference> operator[](const S& index) const;
+        template <class I>
+        const_reference operator[](std::initializer_list<I> index) const;
+        const_reference operator[](size_type i) const;
+
+        template <class It>
+        const_reference element(It first, It last) const;
+
+        template <class O>
+        bool broadcast_shape(O& shape, bool reuse_cache = false) const;
+
+        template <class O>
+        bool has_linear_assign(const O& strides) const noexcept;
+
+        template <class O>
+        const_stepper stepper_begin(const O& shape) const noexcept;
+        template <class O>
+        const_stepper stepper_end(const O& shape, layout_type) const noexcept;
+
+    private:
+
+        template <class I>
+        int compare(size_type k, const I& index) const;
+        int compare(size_type k, size_type l) const;
+
+        void canonicalize();
+
+        inner_shape_type m_shape;
+        coords_storage_type m_coords;
+        value_storage_type m_values;
+    };
+
+    /******************
+     * sparse kernels *
+     ******************/
+
+    template <class T, class E>
+    xcsr_matrix<detail::sparse_product_type_t<T, typename E::value_type>>
+    sparse_multiply(const xcsr_matrix<T>& s, const xexpression<E>& e);
+
+    template <class T, class E>
+    xcoo_tensor<detail::sparse_product_type_t<T, typename E::value_type>>
+    sparse_multiply(const xcoo_tensor<T>& s, const xexpression<E>& e);
+
+    template <class T>
+    big_promote_type_t<T> sparse_sum(const xcsr_matrix<T>& s);
+
+    template <class T>
+    big_promote_type_t<T> sparse_sum(const xcoo_tensor<T>& s);
+
+    template <class T>
+    xtensor<big_promote_type_t<T>, 1> sparse_sum(const xcsr_matrix<T>& s, std::size_t axis);
+
+    template <class T>
+    xarray<big_promote_type_t<T>> sparse_sum(const xcoo_tensor<T>& s, std::size_t axis);
+
+    template <class T, class E>
+    xtensor<detail::sparse_product_type_t<T, typename E::value_type>, 1>
+    sparse_dot(const xcsr_matrix<T>& s, const xexpression<E>& x);
+
+    template <class T, class E>
+    xtensor<detail::sparse_product_type_t<T, typename E::value_type>, 1>
+    sparse_dot(const xcoo_tensor<T>& s, const xexpression<E>& x);
+
+    /******************************
+     * xcsr_matrix implementation *
+     ******************************/
+
+    /**
+     * @name Constructors
+     */
+    //@{
+    /**
+     * Constructs a matrix of the specified shape without nonzero elements.
+     * @param rows the number of rows
+     * @param columns the number of columns
+     */
+    template <class T>
+    inline xcsr_matrix<T>::xcsr_matrix(size_type rows, size_type columns)
+        : m_shape({{rows, columns}}),
+          m_indptr({rows + 1}, size_type(0)),
+          m_indices(index_storage_type::from_shape({0})),
+          m_values(value_storage_type::from_shape({0}))
+    {
+    }
+
+    /**
+     * Constructs a matrix from its compressed sparse row arrays.
+     * @param rows the number of rows
+     * @param columns the number of columns
+     * @param indptr the rows + 1 offsets of the rows in \c indices and \c values
+     * @param indices the column of the nonzero elements, strictly increasing in each row
+     * @param values the nonzero elements
+     * @exception std::runtime_error if the arrays do not describe a valid matrix
+     */
+    template <class T>
+    inline xcsr_matrix<T>::xcsr_matrix(size_type rows, size_type columns, index_storage_type indptr,
+                                       index_storage_type indices, value_storage_type values)
+        : m_shape({{rows, columns}}),
+          m_indptr(std::move(indptr)),
+          m_indices(std::move(indices)),
+          m_values(std::move(values))
+    {
+        check_structure();
+    }
+
+    /**
+     * Constructs a matrix holding the nonzero elements of a two-dimensional
+     * expression.
+     * @param e the expression to compress
+     * @exception std::runtime_error if the expression is not two-dimensional
+     */
+    template <class T>
+    template <class E>
+    inline xcsr_matrix<T>::xcsr_matrix(const xexpression<E>& e)
+        : m_shape({{0, 0}})
+    {
+        const E& de = e.derived_cast();
+        if (de.dimension() != 2)
+        {
+            throw std::runtime_error("xcsr_matrix: the expression must be two-dimensional");
+        }
+        xtensor<value_type, 2, layout_type::row_major> dense = de;
+        m_shape = {{dense.shape()[0], dense.shape()[1]}};
+        size_type count = static_cast<size_type>(std::count_if(dense.cbegin(), dense.cend(),
+                                                               [](const value_type& v) { return v != value_type(0); }));
+        m_indptr = index_storage_type::from_shape({m_shape[0] + 1});
+        m_indices = index_storage_type::from_shape({count});
+        m_values = value_storage_type::from_shape({count});
+
+        const value_type* src = dense.data();
+        size_type k = 0;
+        m_indptr(0) = 0;
+        for (size_type i = 0; i < m_shape[0]; ++i)
+        {
+            for (size_type j = 0; j < m_shape[1]; ++j, ++src)
+            {
+                if (*src != value_type(0))
+                {
+                    m_indices(k) = j;
+                    m_values(k) = *src;
+                    ++k;
+                }
+            }
+            m_indptr(i + 1) = k;
+        }
+    }
+    //@}
+
+    /**
+     * @name Size and shape
+     */
+    //@{
+    /**
+     * Returns the number of elements of the matrix, including the zeros.
+     */
+    template <class T>
+    inline auto xcsr_matrix<T>::size() const noexcept -> size_type
+    {
+        return m_shape[0] * m_shape[1];
+    }
+
+    /**
+     * Returns the number of dimensions of the matrix.
+     */
+    template <class T>
+    inline auto xcsr_matrix<T>::dimension() const noexcept -> size_type
+    {
+        return 2;
+    }
+
+    /**
+     * Returns the shape of the matrix.
+     */
+    template <class T>
+    inline auto xcsr_matrix<T>::shape() const noexcept -> const inner_shape_type&
+    {
+        return m_shape;
+    }
+
+    template <class T>
+    inline layout_type xcsr_matrix<T>::layout() const noexcept
+    {
+        return static_layout;
+    }
+    //@}
+
+    /**
+     * @name Sparse structure
+     */
+    //@{
+    /**
+     * Returns the number of stored elements of the matrix.
+     */
+    template <class T>
+    inline auto xcsr_matrix<T>::nnz() const noexcept -> size_type
+    {
+        return m_values.size();
+    }
+
+    /**
+     * Returns the offsets of the rows in \ref indices and \ref values.
+     */
+    template <class T>
+    inline auto xcsr_matrix<T>::indptr() const noexcept -> const index_storage_type&
+    {
+        return m_indptr;
+    }
+
+    /**
+     * Returns the column of the stored elements.
+     */
+    template <class T>
+    inline auto xcsr_matrix<T>::indices() const noexcept -> const index_storage_type&
+    {
+        return m_indices;
+    }
+
+    /**
+     * Returns the stored elements, which can be modified in place.
+     */
+    template <class T>
+    inline auto xcsr_matrix<T>::values() noexcept -> value_storage_type&
+    {
+        return m_values;
+    }
+
+    /**
+     * Returns the stored elements.
+     */
+    template <class T>
+    inline auto xcsr_matrix<T>::values() const noexcept -> const value_storage_type&
+    {
+        return m_values;
+    }
+    //@}
+
+    /**
+     * @name Data
+     */
+    //@{
+    /**
+     * Returns the element at the specified position in the matrix.
+     * @param args a list of indices specifying the position in the matrix. Indices
+     * must be unsigned integers, the number of indices should be equal or greater
+     * than the number of dimensions of the matrix.
+     */
+    template <class T>
+    template <class... Args>
+    inline auto xcsr_matrix<T>::operator()(Args... args) const -> const_reference
+    {
+        XTENSOR_TRY(check_index(shape(), args...));
+        std::array<size_type, sizeof...(Args)> index = {{static_cast<size_type>(args)...}};
+        return element(index.cbegin(), index.cend());
+    }
+
+    /**
+     * Returns the element at the specified position in the matrix, after
+     * dimension and bounds checking.
+     * @param args a list of indices specifying the position in the matrix. Indices
+     * must be unsigned integers, the number of indices should be equal to the
+     * number of dimensions of the matrix.
+     * @exception std::out_of_range if the number of argument is greater than the
+     * number of dimensions or if indices are out of bounds.
+     */
+    template <class T>
+    template <class... Args>
+    inline auto xcsr_matrix<T>::at(Args... args) const -> const_reference
+    {
+        check_access(shape(), static_cast<size_type>(args)...);
+        return this->operator()(args...);
+    }
+
+    /**
+     * Returns the element at the specified position in the matrix. The number
+     * of indices must be equal to the number of dimensions of the matrix, else
+     * the behavior is undefined.
+     */
+    template <class T>
+    template <class... Args>
+    inline auto xcsr_matrix<T>::unchecked(Args... args) const -> const_reference
+    {
+        std::array<size_type, sizeof...(Args)> index = {{static_cast<size_type>(args)...}};
+        return element(index.cbegin(), index.cend());
+    }
+
+    template <class T>
+    template <class S>
+    inline auto xcsr_matrix<T>::operator[](const S& index) const -> disable_integral_t<S, const_reference>
+    {
+        return element(index.cbegin(), index.cend());
+    }
+
+    template <class T>
+    template <class I>
+    inline auto xcsr_matrix<T>::operator[](std::initializer_list<I> index) const -> const_reference
+    {
+        return element(index.begin(), index.end());
+    }
+
+    template <class T>
+    inline auto xcsr_matrix<T>::operator[](size_type i) const -> const_reference
+    {
+        return operator()(i);
+    }
+
+    /**
+     * Returns the element at the specified position in the matrix.
+     * @param first iterator starting the sequence of indices
+     * @param last iterator ending the sequence of indices
+     * The number of indices in the sequence should be equal to or greater
+     * than the number of dimensions of the matrix.
+     */
+    template <class T>
+    template <class It>
+    inline auto xcsr_matrix<T>::element(It first, It last) const -> const_reference
+    {
+        std::array<size_type, 2> index;
+        detail::sparse_index(m_shape, first, last, index);
+        return get(index[0], index[1]);
+    }
+    //@}
+
+    /**
+     * @name Broadcasting
+     */
+    //@{
+    /**
+     * Broadcast the shape of the matrix to the specified parameter.
+     * @param shape the result shape
+     * @param reuse_cache parameter for internal optimization
+     * @return a boolean indicating whether the broadcasting is trivial
+     */
+    template <class T>
+    template <class O>
+    inline bool xcsr_matrix<T>::broadcast_shape(O& shape, bool) const
+    {
+        return xt::broadcast_shape(m_shape, shape);
+    }
+
+    /**
+     * Checks whether the matrix can be linearly assigned to an expression
+     * with the specified strides.
+     * @return a boolean indicating whether a linear assign is possible
+     */
+    template <class T>
+    template <class O>
+    inline bool xcsr_matrix<T>::has_linear_assign(const O& /*strides*/) const noexcept
+    {
+        return false;
+    }
+    //@}
+
+    template <class T>
+    template <class O>
+    inline auto xcsr_matrix<T>::stepper_begin(const O& shape) const noexcept -> const_stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return const_stepper(this, offset);
+    }
+
+    template <class T>
+    template <class O>
+    inline auto xcsr_matrix<T>::stepper_end(const O& shape, layout_type) const noexcept -> const_stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return const_stepper(this, offset, true);
+    }
+
+    template <class T>
+    inline auto xcsr_matrix<T>::get(size_type row, size_type column) const -> const_reference
+    {
+        auto first = m_indices.cbegin() + static_cast<difference_type>(m_indptr(row));
+        auto last = m_indices.cbegin() + static_cast<difference_type>(m_indptr(row + 1));
+        auto it = std::lower_bound(first, last, column);
+        return (it != last && *it == column) ? m_values(static_cast<size_type>(it - m_indices.cbegin())) : value_type(0);
+    }
+
+    template <class T>
+    inline void xcsr_matrix<T>::check_structure() const
+    {
+        if (m_indptr.size() != m_shape[0] + 1 || m_indptr(0) != 0 ||
+            m_indptr(m_shape[0]) != m_indices.size() || m_indices.size() != m_values.size())
+        {
+            throw std::runtime_error("xcsr_matrix: indptr, indices and values are inconsistent");
+        }
+        for (size_type i = 0; i < m_shape[0]; ++i)
+        {
+            if (m_indptr(i) > m_indptr(i + 1))
+            {
+                throw std::runtime_error("xcsr_matrix: indptr must be non-decreasing");
+            }
+            for (size_type k = m_indptr(i); k < m_indptr(i + 1); ++k)
+            {
+                if (m_indices(k) >= m_shape[1] || (k > m_indptr(i) && m_indices(k) <= m_indices(k - 1)))
+                {
+                    throw std::runtime_error("xcsr_matrix: the column indices of a row must be increasing and in bounds");
+                }
+            }
+        }
+    }
+
+    /******************************
+     * xcoo_tensor implementation *
+     ******************************/
+
+    /**
+     * @name Constructors
+     */
+    //@{
+    /**
+     * Constructs a tensor of the specified shape without nonzero elements.
+     * @param shape the shape of the tensor
+     */
+    template <class T>
+    inline xcoo_tensor<T>::xcoo_tensor(shape_type shape)
+        : m_shape(std::move(shape)),
+          m_coords(coords_storage_type::from_shape({0, m_shape.size()})),
+          m_values(value_storage_type::from_shape({0}))
+    {
+    }
+
+    /**
+     * Constructs a tensor from the coordinates of its nonzero elements. The
+     * coordinates are sorted in row-major order and the values of duplicate
+     * coordinates are summed.
+     * @param shape the shape of the tensor
+     * @param coords the (nnz, dimension) indices of the nonzero elements
+     * @param values the nonzero elements
+     * @exception std::runtime_error if the coordinates and the values are
+     * inconsistent or the coordinates are out of bounds
+     */
+    template <class T>
+    inline xcoo_tensor<T>::xcoo_tensor(shape_type shape, coords_storage_type coords, value_storage_type values)
+        : m_shape(std::move(shape)),
+          m_coords(std::move(coords)),
+          m_values(std::move(values))
+    {
+        if (m_coords.shape()[0] != m_values.size() || (m_values.size() != 0 && m_coords.shape()[1] != m_shape.size()))
+        {
+            throw std::runtime_error("xcoo_tensor: coords must be a (nnz, dimension) tensor");
+        }
+        if (m_values.size() == 0)
+        {
+            m_coords = coords_storage_type::from_shape({0, m_shape.size()});
+        }
+        for (size_type k = 0; k < m_values.size(); ++k)
+        {
+            for (size_type d = 0; d < m_shape.size(); ++d)
+            {
+                if (m_coords(k, d) >= m_shape[d])
+                {
+                    throw std::runtime_error("xcoo_tensor: coordinates out of bounds");
+                }
+            }
+        }
+        canonicalize();
+    }
+
+    /**
+     * Constructs a tensor holding the nonzero elements of an expression.
+     * @param e the expression to compress
+     */
+    template <class T>
+    template <class E>
+    inline xcoo_tensor<T>::xcoo_tensor(const xexpression<E>& e)
+    {
+        xarray<value_type, layout_type::row_major> dense = e.derived_cast();
+        m_shape = shape_type(dense.shape().cbegin(), dense.shape().cend());
+        size_type dim = m_shape.size();
+        size_type count = static_cast<size_type>(std::count_if(dense.cbegin(), dense.cend(),
+                                                               [](const value_type& v) { return v != value_type(0); }));
+        m_coords = coords_storage_type::from_shape({count, dim});
+        m_values = value_storage_type::from_shape({count});
+
+        // the index of the current element is kept up to date in row-major
+        // order, the elements being visited in the order of the storage
+        shape_type index = xtl::make_sequence<shape_type>(dim, size_type(0));
+        const value_type* src = dense.data();
+        size_type k = 0;
+        for (size_type i = 0; i < dense.size(); ++i, ++src)
+        {
+            if (*src != value_type(0))
+            {
+                for (size_type d = 0; d < dim; ++d)
+                {
+                    m_coords(k, d) = index[d];
+                }
+                m_values(k) = *src;
+                ++k;
+            }
+            for (size_type d = dim; d > 0; --d)
+            {
+                if (++index[d - 1] != m_shape[d - 1])
+                {
+                    break;
+                }
+                index[d - 1] = 0;
+            }
+        }
+    }
+    //@}
+
+    /**
+     * @name Size and shape
+     */
+    //@{
+    /**
+     * Returns the number of elements of the tensor, including the zeros.
+     */
+    template <class T>
+    inline auto xcoo_tensor<T>::size() const noexcept -> size_type
+    {
+        return compute_size(m_shape);
+    }
+
+    /**
+     * Returns the number of dimensions of the tensor.
+     */
+    template <class T>
+    inline auto xcoo_tensor<T>::dimension() const noexcept -> size_type
+    {
+        return m_shape.size();
+    }
+
+    /**
+     * Returns the shape of the tensor.
+     */
+    template <class T>
+    inline auto xcoo_tensor<T>::shape() const noexcept -> const inner_shape_type&
+    {
+        return m_shape;
+    }
+
+    template <class T>
+    inline layout_type xcoo_tensor<T>::layout() const noexcept
+    {
+        return static_layout;
+    }
+    //@}
+
+    /**
+     * @name Sparse structure
+     */
+    //@{
+    /**
+     * Returns the number of stored elements of the tensor.
+     */
+    template <class T>
+    inline auto xcoo_tensor<T>::nnz() const noexcept -> size_type
+    {
+        return m_values.size();
+    }
+
+    /**
+     * Returns the (nnz, dimension) indices of the stored elements, sorted in
+     * row-major order.
+     */
+    template <class T>
+    inline auto xcoo_tensor<T>::coords() const noexcept -> const coords_storage_type&
+    {
+        return m_coords;
+    }
+
+    /**
+     * Returns the stored elements, which can be modified in place.
+     */
+    template <class T>
+    inline auto xcoo_tensor<T>::values() noexcept -> value_storage_type&
+    {
+        return m_values;
+    }
+
+    /**
+     * Returns the stored elements.
+     */
+    template <class T>
+    inline auto xcoo_tensor<T>::values() const noexcept -> const value_storage_type&
+    {
+        return m_values;
+    }
+    //@}
+
+    /**
+     * @name Data
+     */
+    //@{
+    /**
+     * Returns the element at the specified position in the tensor.
+     * @param args a list of indices specifying the position in the tensor. Indices
+     * must be unsigned integers, the number of indices should be equal or greater
+     * than the number of dimensions of the tensor.
+     */
+    template <class T>
+    template <class... Args>
+    inline auto xcoo_tensor<T>::operator()(Args... args) const -> const_reference
+    {
+        XTENSOR_TRY(check_index(shape(), args...));
+        std::array<size_type, sizeof...(Args)> index = {{static_cast<size_type>(args)...}};
+        return element(index.cbegin(), index.cend());
+    }
+
+    /**
+     * Returns the element at the specified position in the tensor, after
+     * dimension and bounds checking.
+     * @param args a list of indices specifying the position in the tensor. Indices
+     * must be unsigned integers, the number of indices should be equal to the
+     * number of dimensions of the tensor.
+     * @exception std::out_of_range if the number of argument is greater than the
+     * number of dimensions or if indices are out of bounds.
+     */
+    template <class T>
+    template <class... Args>
+    inline auto xcoo_tensor<T>::at(Args... args) const -> const_reference
+    {
+        check_access(shape(), static_cast<size_type>(args)...);
+        return this->operator()(args...);
+    }
+
+    /**
+     * Returns the element at the specified position in the tensor. The number
+     * of indices must be equal to the number of dimensions of the tensor, else
+     * the behavior is undefined.
+     */
+    template <class T>
+    template <class... Args>
+    inline auto xcoo_tensor<T>::unchecked(Args... args) const -> const_reference
+    {
+        std::array<size_type, sizeof...(Args)> index = {{static_cast<size_type>(args)...}};
+        return element(index.cbegin(), index.cend());
+    }
+
+    template <class T>
+    template <class S>
+    inline auto xcoo_tensor<T>::operator[](const S& index) const -> disable_integral_t<S, const_reference>
+    {
+        return element(index.cbegin(), index.cend());
+    }
+
+    template <class T>
+    template <class I>
+    inline auto xcoo_tensor<T>::operator[](std::initializer_list<I> index) const -> const_reference
+    {
+        return element(index.begin(), index.end());
+    }
+
+    template <class T>
+    inline auto xcoo_tensor<T>::operator[](size_type i) const -> const_reference
+    {
+        return operator()(i);
+    }
+
+    /**
+     * Returns the element at the specified position in the tensor, found by
+     * binary search in the coordinates.
+     * @param first iterator starting the sequence of indices
+     * @param last iterator ending the sequence of indices
+     * The number of indices in the sequence should be equal to or greater
+     * than the number of dimensions of the tensor.
+     */
+    template <class T>
+    template <class It>
+    inline auto xcoo_tensor<T>::element(It first, It last) const -> const_reference
+    {
+        shape_type index = xtl::make_sequence<shape_type>(dimension(), size_type(0));
+        detail::sparse_index(m_shape, first, last, index);
+        size_type low = 0;
+        size_type high = nnz();
+        while (low < high)
+        {
+            size_type mid = low + (high - low) / 2;
+            int c = compare(mid, index);
+            if (c == 0)
+            {
+                return m_values(mid);
+            }
+            else if (c < 0)
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+        return value_type(0);
+    }
+    //@}
+
+    /**
+     * @name Broadcasting
+     */
+    //@{
+    /**
+     * Broadcast the shape of the tensor to the specified parameter.
+     * @param shape the result shape
+     * @param reuse_cache parameter for internal optimization
+     * @return a boolean indicating whether the broadcasting is trivial
+     */
+    template <class T>
+    template <class O>
+    inline bool xcoo_tensor<T>::broadcast_shape(O& shape, bool) const
+    {
+        return xt::broadcast_shape(m_shape, shape);
+    }
+
+    /**
+     * Checks whether the tensor can be linearly assigned to an expression
+     * with the specified strides.
+     * @return a boolean indicating whether a linear assign is possible
+     */
+    template <class T>
+    template <class O>
+    inline bool xcoo_tensor<T>::has_linear_assign(const O& /*strides*/) const noexcept
+    {
+        return false;
+    }
+    //@}
+
+    template <class T>
+    template <class O>
+    inline auto xcoo_tensor<T>::stepper_begin(const O& shape) const noexcept -> const_stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return const_stepper(this, offset);
+    }
+
+    template <class T>
+    template <class O>
+    inline auto xcoo_tensor<T>::stepper_end(const O& shape, layout_type) const noexcept -> const_stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return const_stepper(this, offset, true);
+    }
+
+    // Compares the coordinates of the stored element k with an index in
+    // row-major order.
+    template <class T>
+    template <class I>
+    inline int xcoo_tensor<T>::compare(size_type k, const I& index) const
+    {
+        for (size_type d = 0; d < m_shape.size(); ++d)
+        {
+            if (m_coords(k, d) != index[d])
+            {
+                return m_coords(k, d) < index[d] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    template <class T>
+    inline int xcoo_tensor<T>::compare(size_type k, size_type l) const
+    {
+        for (size_type d = 0; d < m_shape.size(); ++d)
+        {
+            if (m_coords(k, d) != m_coords(l, d))
+            {
+                return m_coords(k, d) < m_coords(l, d) ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    // Sorts the coordinates in row-major order and sums the values of the
+    // duplicates; the coordinates built by the kernels are already sorted.
+    template <class T>
+    inline void xcoo_tensor<T>::canonicalize()
+    {
+        size_type n = nnz();
+        bool sorted = true;
+        for (size_type k = 1; k < n && sorted; ++k)
+        {
+            sorted = compare(k - 1, k) < 0;
+        }
+        if (sorted)
+        {
+            return;
+        }
+
+        std::vector<size_type> order(n);
+        std::iota(order.begin(), order.end(), size_type(0));
+        std::sort(order.begin(), order.end(), [this](size_type k, size_type l) { return compare(k, l) < 0; });
+
+        size_type dim = m_shape.size();
+        size_type count = 0;
+        for (size_type k = 0; k < n; ++k)
+        {
+            if (k == 0 || compare(order[k - 1], order[k]) != 0)
+            {
+                ++count;
+            }
+        }
+        coords_storage_type coords = coords_storage_type::from_shape({count, dim});
+        value_storage_type values = value_storage_type::from_shape({count});
+        size_type j = 0;
+        for (size_type k = 0; k < n; ++k)
+        {
+            size_type src = order[k];
+            if (k != 0 && compare(order[k - 1], src) == 0)
+            {
+                values(j - 1) += m_values(src);
+            }
+            else
+            {
+                for (size_type d = 0; d < dim; ++d)
+                {
+                    coords(j, d) = m_coords(src, d);
+                }
+                values(j) = m_values(src);
+                ++j;
+            }
+        }
+        m_coords = std::move(coords);
+        m_values = std::move(values);
+    }
+
+    /*********************************
+     * sparse kernels implementation *
+     *********************************/
+
+    /**
+     * @defgroup sparse_kernels Sparse kernels
+     *
+     * The sparse kernels work on the stored elements of the sparse
+     * expressions only, instead of all the elements visited by the
+     * generic expressions.
+     */
+
+    /**
+     * @ingroup sparse_kernels
+     * @brief Element-wise product of a sparse matrix and an expression.
+     *
+     * The expression is broadcast to the shape of the matrix and only
+     * evaluated at the stored elements, whose structure the result keeps.
+     * @param s the sparse matrix
+     * @param e an \ref xexpression broadcastable to the shape of \em s
+     * @return an \ref xcsr_matrix of the products
+     */
+    template <class T, class E>
+    inline xcsr_matrix<detail::sparse_product_type_t<T, typename E::value_type>>
+    sparse_multiply(const xcsr_matrix<T>& s, const xexpression<E>& e)
+    {
+        using result_type = xcsr_matrix<detail::sparse_product_type_t<T, typename E::value_type>>;
+        using value_storage_type = typename result_type::value_storage_type;
+        auto b = broadcast(e.derived_cast(), s.shape());
+        value_storage_type values = value_storage_type::from_shape({s.nnz()});
+        std::array<std::size_t, 2> index;
+        for (std::size_t i = 0; i < s.shape()[0]; ++i)
+        {
+            index[0] = i;
+            for (std::size_t k = s.indptr()(i); k < s.indptr()(i + 1); ++k)
+            {
+                index[1] = s.indices()(k);
+                values(k) = s.values()(k) * b.element(index.cbegin(), index.cend());
+            }
+        }
+        return result_type(s.shape()[0], s.shape()[1], s.indptr(), s.indices(), std::move(values));
+    }
+
+    /**
+     * @ingroup sparse_kernels
+     * @brief Element-wise product of a sparse tensor and an expression.
+     *
+     * The expression is broadcast to the shape of the tensor and only
+     * evaluated at the stored elements, whose coordinates the result keeps.
+     * @param s the sparse tensor
+     * @param e an \ref xexpression broadcastable to the shape of \em s
+     * @return an \ref xcoo_tensor of the products
+     */
+    template <class T, class E>
+    inline xcoo_tensor<detail::sparse_product_type_t<T, typename E::value_type>>
+    sparse_multiply(const xcoo_tensor<T>& s, const xexpression<E>& e)
+    {
+        using result_type = xcoo_tensor<detail::sparse_product_type_t<T, typename E::value_type>>;
+        using value_storage_type = typename result_type::value_storage_type;
+        auto b = broadcast(e.derived_cast(), s.shape());
+        value_storage_type values = value_storage_type::from_shape({s.nnz()});
+        std::size_t dim = s.dimension();
+        for (std::size_t k = 0; k < s.nnz(); ++k)
+        {
+            const std::size_t* index = dim == 0 ? nullptr : &s.coords()(k, 0);
+            values(k) = s.values()(k) * b.element(index, index + dim);
+        }
+        return result_type(s.shape(), s.coords(), std::move(values));
+    }
+
+    /**
+     * @ingroup sparse_kernels
+     * @brief Sum of the elements of a sparse matrix.
+     */
+    template <class T>
+    inline big_promote_type_t<T> sparse_sum(const xcsr_matrix<T>& s)
+    {
+        using result_type = big_promote_type_t<T>;
+        return std::accumulate(s.values().cbegin(), s.values().cend(), result_type(0));
+    }
+
+    /**
+     * @ingroup sparse_kernels
+     * @brief Sum of the elements of a sparse tensor.
+     */
+    template <class T>
+    inline big_promote_type_t<T> sparse_sum(const xcoo_tensor<T>& s)
+    {
+        using result_type = big_promote_type_t<T>;
+        return std::accumulate(s.values().cbegin(), s.values().cend(), result_type(0));
+    }
+
+    /**
+     * @ingroup sparse_kernels
+     * @brief Sum of the elements of a sparse matrix along an axis.
+     * @param s the sparse matrix
+     * @param axis the axis along which the elements are summed, 0 or 1
+     * @return an \ref xtensor of the sums: the sums of the columns for the
+     * axis 0, of the rows for the axis 1
+     */
+    template <class T>
+    inline xtensor<big_promote_type_t<T>, 1> sparse_sum(const xcsr_matrix<T>& s, std::size_t axis)
+    {
+        using value_type = big_promote_type_t<T>;
+        if (axis > 1)
+        {
+            throw std::runtime_error("sparse_sum: axis out of bounds");
+        }
+        std::size_t rows = s.shape()[0];
+        xtensor<value_type, 1> res({s.shape()[1 - axis]}, value_type(0));
+        for (std::size_t i = 0; i < rows; ++i)
+        {
+            for (std::size_t k = s.indptr()(i); k < s.indptr()(i + 1); ++k)
+            {
+                res(axis == 0 ? s.indices()(k) : i) += static_cast<value_type>(s.values()(k));
+            }
+        }
+        return res;
+    }
+
+    /**
+     * @ingroup sparse_kernels
+     * @brief Sum of the elements of a sparse tensor along an axis.
+     * @param s the sparse tensor
+     * @param axis the axis along which the elements are summed
+     * @return an \ref xarray of the sums, dense, whose shape is the shape of
+     * \em s without \em axis
+     */
+    template <class T>
+    inline xarray<big_promote_type_t<T>> sparse_sum(const xcoo_tensor<T>& s, std::size_t axis)
+    {
+        using value_type = big_promote_type_t<T>;
+        std::size_t dim = s.dimension();
+        if (axis >= dim)
+        {
+            throw std::runtime_error("sparse_sum: axis out of bounds");
+        }
+        dynamic_shape<std::size_t> shape(dim - 1);
+        std::copy(s.shape().cbegin(), s.shape().cbegin() + static_cast<std::ptrdiff_t>(axis), shape.begin());
+        std::copy(s.shape().cbegin() + static_cast<std::ptrdiff_t>(axis + 1), s.shape().cend(),
+                  shape.begin() + static_cast<std::ptrdiff_t>(axis));
+        xarray<value_type> res(shape, value_type(0));
+        for (std::size_t k = 0; k < s.nnz(); ++k)
+        {
+            std::size_t offset = 0;
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                if (d != axis)
+                {
+                    offset = offset * s.shape()[d] + s.coords()(k, d);
+                }
+            }
+            res.data()[offset] += static_cast<value_type>(s.values()(k));
+        }
+        return res;
+    }
+
+    /**
+     * @ingroup sparse_kernels
+     * @brief Product of a sparse matrix and a dense vector.
+     *
+     * The rows are computed in parallel when XTENSOR_PARALLEL_ENABLED is
+     * defined and the matrix has enough stored elements according to the
+     * parallel settings.
+     * @param s the sparse matrix
+     * @param x a one-dimensional \ref xexpression of size the number of
+     * columns of \em s
+     * @return an \ref xtensor of size the number of rows of \em s
+     */
+    template <class T, class E>
+    inline xtensor<detail::sparse_product_type_t<T, typename E::value_type>, 1>
+    sparse_dot(const xcsr_matrix<T>& s, const xexpression<E>& x)
+    {
+        using value_type = detail::sparse_product_type_t<T, typename E::value_type>;
+        const E& dx = x.derived_cast();
+        if (dx.dimension() != 1 || dx.shape()[0] != s.shape()[1])
+        {
+            throw std::runtime_error("sparse_dot: the vector must be one-dimensional of size the number of columns");
+        }
+        auto&& v = eval(dx);
+        std::size_t rows = s.shape()[0];
+        xtensor<value_type, 1> res = xtensor<value_type, 1>::from_shape({rows});
+        auto compute_rows = [&s, &v, &res](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i)
+            {
+                value_type acc = value_type(0);
+                for (std::size_t k = s.indptr()(i); k < s.indptr()(i + 1); ++k)
+                {
+                    acc += s.values()(k) * v.unchecked(s.indices()(k));
+                }
+                res(i) = acc;
+            }
+        };
+#if defined(XTENSOR_PARALLEL_ENABLED)
+        if (rows > 1 && parallel::use_parallel(s.nnz()))
+        {
+            std::size_t mean_row = std::max(s.nnz() / rows, std::size_t(1));
+            parallel_for(std::size_t(0), rows, parallel::grain(mean_row), compute_rows);
+            return res;
+        }
+#endif
+        compute_rows(std::size_t(0), rows);
+        return res;
+    }
+
+    /**
+     * @ingroup sparse_kernels
+     * @brief Product of a two-dimensional sparse tensor and a dense vector.
+     * @param s the two-dimensional sparse tensor
+     * @param x a one-dimensional \ref xexpression of size the number of
+     * columns of \em s
+     * @return an \ref xtensor of size the number of rows of \em s
+     */
+    template <class T, class E>
+    inline xtensor<detail::sparse_product_type_t<T, typename E::value_type>, 1>
+    sparse_dot(const xcoo_tensor<T>& s, const xexpression<E>& x)
+    {
+        using value_type = detail::sparse_product_type_t<T, typename E::value_type>;
+        const E& dx = x.derived_cast();
+        if (s.dimension() != 2)
+        {
+            throw std::runtime_error("sparse_dot: the sparse tensor must be two-dimensional");
+        }
+        if (dx.dimension() != 1 || dx.shape()[0] != s.shape()[1])
+        {
+            throw std::runtime_error("sparse_dot: the vector must be one-dimensional of size the number of columns");
+        }
+        auto&& v = eval(dx);
+        xtensor<value_type, 1> res({s.shape()[0]}, value_type(0));
+        for (std::size_t k = 0; k < s.nnz(); ++k)
+        {
+            res(s.coords()(k, 0)) += s.values()(k) * v.unchecked(s.coords()(k, 1));
+        }
+        return res;
+    }
+}
+
+#endif
@@ -0,0 +1,714 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_SPLIT_COMPLEX_HPP
+#define XTENSOR_SPLIT_COMPLEX_HPP
+
+#include <algorithm>
+#include <complex>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <xtl/xcomplex.hpp>
+
+#include "xarray.hpp"
+#include "xcomplex.hpp"
+#include "xexception.hpp"
+#include "xexpression.hpp"
+#include "xiterable.hpp"
+#include "xmath.hpp"
+#include "xstrides.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+
+    /***************************
+     * split complex extension *
+     ***************************/
+
+    namespace extension
+    {
+        template <class Tag, class T, layout_type L>
+        struct xsplit_complex_base_impl;
+
+        template <class T, layout_type L>
+        struct xsplit_complex_base_impl<xtensor_expression_tag, T, L>
+        {
+            using type = xtensor_empty_base;
+        };
+
+        template <class T, layout_type L>
+        struct xsplit_complex_base : xsplit_complex_base_impl<xexpression_tag_t<T>, T, L>
+        {
+        };
+
+        template <class T, layout_type L>
+        using xsplit_complex_base_t = typename xsplit_complex_base<T, L>::type;
+    }
+
+    template <class T, layout_type L = XTENSOR_DEFAULT_LAYOUT>
+    class xsplit_complex;
+
+    template <class T, layout_type L>
+    struct xiterable_inner_types<xsplit_complex<T, L>>
+    {
+        using inner_shape_type = typename xarray<T, L>::inner_shape_type;
+        using const_stepper = xindexed_stepper<xsplit_complex<T, L>, true>;
+        using stepper = const_stepper;
+    };
+
+    /******************
+     * xsplit_complex *
+     ******************/
+
+    /**
+     * @class xsplit_complex
+     * @brief Complex tensor stored as separate real and imaginary planes.
+     *
+     * The xsplit_complex holds the real and the imaginary parts of its
+     * elements in two real containers of the same shape, instead of the
+     * interleaved storage of a container of std::complex. \ref real and
+     * \ref imag return these containers, and the split complex kernels
+     * (\ref split_multiply, \ref split_divide, \ref split_norm, ...)
+     * operate on them with real expressions only, which are vectorized at
+     * the full width of the SIMD registers, without the deinterleaving
+     * shuffles needed by the views on the parts of a complex container.
+     *
+     * The xsplit_complex is a read-only expression of std::complex values,
+     * so that it can be assigned to an interleaved container; conversely it
+     * can be built from, or assigned, any complex or real expression.
+     *
+     * \code{.cpp}
+     * xt::xarray<std::complex<double>> c = ...;
+     * xt::xsplit_complex<double> s(c);
+     * auto p = xt::split_multiply(s, s);
+     * xt::xarray<double> n = xt::split_norm(p);
+     * xt::xarray<std::complex<double>> back = p;
+     * \endcode
+     *
+     * @tparam T the value type of the real and imaginary parts
+     * @tparam L the layout of the planes
+     */
+    template <class T, layout_type L>
+    class xsplit_complex : public xexpression<xsplit_complex<T, L>>,
+                           public xconst_iterable<xsplit_complex<T, L>>,
+                           public extension::xsplit_complex_base_t<T, L>
+    {
+    public:
+
+        using self_type = xsplit_complex<T, L>;
+
+        using extension_base = extension::xsplit_complex_base_t<T, L>;
+        using expression_tag = typename extension_base::expression_tag;
+
+        using plane_type = xarray<T, L>;
+        using value_type = std::complex<T>;
+        using reference = value_type;
+        using const_reference = value_type;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+        using size_type = typename plane_type::size_type;
+        using difference_type = typename plane_type::difference_type;
+
+        using iterable_base = xconst_iterable<self_type>;
+        using inner_shape_type = typename iterable_base::inner_shape_type;
+        using shape_type = inner_shape_type;
+
+        using stepper = typename iterable_base::stepper;
+        using const_stepper = typename iterable_base::const_stepper;
+
+        static constexpr layout_type static_layout = layout_type::dynamic;
+        static constexpr bool contiguous_layout = false;
+
+        xsplit_complex() = default;
+        explicit xsplit_complex(const shape_type& shape);
+        xsplit_complex(plane_type real, plane_type imag);
+
+        template <class E>
+        explicit xsplit_complex(const xexpression<E>& e);
+
+        template <class E>
+        self_type& operator=(const xexpression<E>& e);
+
+        void resize(const shape_type& shape);
+
+        size_type size() const noexcept;
+        size_type dimension() const noexcept;
+        const inner_shape_type& shape() const noexcept;
+        layout_type layout() const noexcept;
+
+        plane_type& real() & noexcept;
+        const plane_type& real() const & noexcept;
+        plane_type real() &&;
+        plane_type& imag() & noexcept;
+        const plane_type& imag() const & noexcept;
+        plane_type imag() &&;
+
+        template <class... Args>
+        const_reference operator()(Args... args) const;
+        template <class... Args>
+        const_reference at(Args... args) const;
+        template <class... Args>
+        const_reference unchecked(Args... args) const;
+        template <class S>
+        disable_integral_t<S, const_reference> operator[](const S& index) const;
+        template <class I>
+        const_reference operator[](std::initializer_list<I> index) const;
+        const_reference operator[](size_type i) const;
+
+        template <class It>
+        const_reference element(It first, It last) const;
+
+        template <class O>
+        bool broadcast_shape(O& shape, bool reuse_cache = false) const;
+
+        template <class O>
+        bool has_linear_assign(const O& strides) const noexcept;
+
+        template <class O>
+        const_stepper stepper_begin(const O& shape) const noexcept;
+        template <class O>
+        const_stepper stepper_end(const O& shape, layout_type) const noexcept;
+
+    private:
+
+        void check_planes() const;
+
+        plane_type m_real;
+        plane_type m_imag;
+    };
+
+    template <class T, layout_type L>
+    typename xsplit_complex<T, L>::plane_type& real(xsplit_complex<T, L>& e) noexcept;
+
+    template <class T, layout_type L>
+    const typename xsplit_complex<T, L>::plane_type& real(const xsplit_complex<T, L>& e) noexcept;
+
+    template <class T, layout_type L>
+    typename xsplit_complex<T, L>::plane_type real(xsplit_complex<T, L>&& e);
+
+    template <class T, layout_type L>
+    typename xsplit_complex<T, L>::plane_type& imag(xsplit_complex<T, L>& e) noexcept;
+
+    template <class T, layout_type L>
+    const typename xsplit_complex<T, L>::plane_type& imag(const xsplit_complex<T, L>& e) noexcept;
+
+    template <class T, layout_type L>
+    typename xsplit_complex<T, L>::plane_type imag(xsplit_complex<T, L>&& e);
+
+    /*************************
+     * split complex kernels *
+     *************************/
+
+    template <class T, layout_type L>
+    xsplit_complex<T, L> split_add(const xsplit_complex<T, L>& a, const xsplit_complex<T, L>& b);
+
+    template <class T, layout_type L>
+    xsplit_complex<T, L> split_subtract(const xsplit_complex<T, L>& a, const xsplit_complex<T, L>& b);
+
+    template <class T, layout_type L>
+    xsplit_complex<T, L> split_multiply(const xsplit_complex<T, L>& a, const xsplit_complex<T, L>& b);
+
+    template <class T, layout_type L, class E>
+    xsplit_complex<T, L> split_multiply(const xsplit_complex<T, L>& a, const xexpression<E>& e);
+
+    template <class T, layout_type L>
+    xsplit_complex<T, L> split_divide(const xsplit_complex<T, L>& a, const xsplit_complex<T, L>& b);
+
+    template <class T, layout_type L>
+    xsplit_complex<T, L> split_conj(const xsplit_complex<T, L>& a);
+
+    template <class T, layout_type L>
+    xarray<T, L> split_norm(const xsplit_complex<T, L>& a);
+
+    template <class T, layout_type L>
+    xarray<T, L> split_abs(const xsplit_complex<T, L>& a);
+
+    /*********************************
+     * xsplit_complex implementation *
+     *********************************/
+
+    /**
+     * @name Constructors
+     */
+    //@{
+    /**
+     * Constructs a tensor of the specified shape whose elements are 0.
+     * @param shape the shape of the tensor
+     */
+    template <class T, layout_type L>
+    inline xsplit_complex<T, L>::xsplit_complex(const shape_type& shape)
+        : m_real(shape, T(0)), m_imag(shape, T(0))
+    {
+    }
+
+    /**
+     * Constructs a tensor from its real and imaginary planes.
+     * @param real the real parts of the elements
+     * @param imag the imaginary parts of the elements
+     * @exception std::runtime_error if the planes do not have the same shape
+     */
+    template <class T, layout_type L>
+    inline xsplit_complex<T, L>::xsplit_complex(plane_type real, plane_type imag)
+        : m_real(std::move(real)), m_imag(std::move(imag))
+    {
+        check_planes();
+    }
+
+    /**
+     * Constructs a tensor holding the elements of a complex or real
+     * expression, whose parts are copied into the planes.
+     * @param e the expression to split
+     */
+    template <class T, layout_type L>
+    template <class E>
+    inline xsplit_complex<T, L>::xsplit_complex(const xexpression<E>& e)
+    {
+        *this = e;
+    }
+    //@}
+
+    /**
+     * Assigns the parts of a complex or real expression to the planes,
+     * which are resized to the shape of the expression.
+     * @param e the expression to split
+     */
+    template <class T, layout_type L>
+    template <class E>
+    inline auto xsplit_complex<T, L>::operator=(const xexpression<E>& e) -> self_type&
+    {
+        const E& de = e.derived_cast();
+        // the planes of the expression are evaluated before the assignment,
+        // which may alias this tensor
+        plane_type re = xt::real(de);
+        plane_type im = xt::imag(de);
+        m_real = std::move(re);
+        m_imag = std::move(im);
+        return *this;
+    }
+
+    /**
+     * Resizes the planes to the specified shape; the elements are not
+     * preserved.
+     * @param shape the new shape
+     */
+    template <class T, layout_type L>
+    inline void xsplit_complex<T, L>::resize(const shape_type& shape)
+    {
+        m_real.resize(shape);
+        m_imag.resize(shape);
+    }
+
+    /**
+     * @name Size and shape
+     */
+    //@{
+    /**
+     * Returns the number of elements of the tensor.
+     */
+    template <class T, layout_type L>
+    inline auto xsplit_complex<T, L>::size() const noexcept -> size_type
+    {
+        return m_real.size();
+    }
+
+    /**
+     * Returns the number of dimensions of the tensor.
+     */
+    template <class T, layout_type L>
+    inline auto xsplit_complex<T, L>::dimension() const noexcept -> size_type
+    {
+        return m_real.dimension();
+    }
+
+    /**
+     * Returns the shape of the tensor.
+     */
+    template <class T, layout_type L>
+    inline auto xsplit_complex<T, L>::shape() const noexcept -> const inner_shape_type&
+    {
+        return m_real.shape();
+    }
+
+    template <class T, layout_type L>
+    inline layout_type xsplit_complex<T, L>::layout() const noexcept
+    {
+        return static_layout;
+    }
+    //@}
+
+    /**
+     * @name Planes
+     */
+    //@{
+    /**
+     * Returns the contiguous container of the real parts.
+     */
+    template <class T, layout_type L>
+    inline auto xsplit_complex<T, L>::real() & noexcept -> plane_type&
+    {
+        return m_real;
+    }
+
+    /**
+     * Returns the contiguous container of the real parts.
+     */
+    template <class T, layout_type L>
+    inline auto xsplit_complex<T, L>::real() const & noexcept -> const plane_type&
+    {
+        return m_real;
+    }
+
+    /**
+     * Returns the container of the real parts, moved out of the tensor.
+     */
+    template <class T, layout_type L>
+    inline auto xsplit_complex<T, L>::real() && -> plane_type
+    {
+        return std::move(m_real);
+    }
+
+    /**
+     * Returns the contiguous container of the imaginary parts.
+     */
+    template <class T, layout_type L>
+    inline auto xsplit_complex<T, L>::imag() & noexcept -> plane_type&
+    {
+        return m_imag;
+    }
+
+    /**
+     * Returns the contiguous container of the imaginary parts.
+     */
+    template <class T, layout_type L>
+    inline auto xsplit_complex<T, L>::imag() const & noexcept -> const plane_type&
+    {
+        return m_imag;
+    }
+
+    /**
+     * Returns the container of the imaginary parts, moved out of the tensor.
+     */
+    template <class T, layout_type L>
+    inline auto xsplit_complex<T, L>::imag() && -> plane_type
+    {
+        return std::move(m_imag);
+    }
+    //@}
+
+    /**
+     * @name Data
+     */
+    //@{
+    /**
+     * Returns the element at the specified position in the tensor.
+     * @param args a list of indices specifying the position in the tensor. Indices
+     * must be unsigned integers, the number of indices should be equal or greater
+     * than the number of dimensions of the tensor.
+     */
+    template <class T, layout_type L>
+    template <class... Args>
+    inline auto xsplit_complex<T, L>::operator()(Args... args) const -> const_reference
+    {
+        return value_type(m_real(args...), m_imag(args...));
+    }
+
+    /**
+     * Returns the element at the specified position in the tensor, after
+     * dimension and bounds checking.
+     * @param args a list of indices specifying the position in the tensor. Indices
+     * must be unsigned integers, the number of indices should be equal to the
+     * number of dimensions of the tensor.
+     * @exception std::out_of_range if the number of argument is greater than the
+     * number of dimensions or if indices are out of bounds.
+     */
+    template <class T, layout_type L>
+    template <class... Args>
+    inline auto xsplit_complex<T, L>::at(Args... args) const -> const_reference
+    {
+        return value_type(m_real.at(args...), m_imag.at(args...));
+    }
+
+    /**
+     * Returns the element at the specified position in the tensor. The number
+     * of indices must be equal to the number of dimensions of the tensor, else
+     * the behavior is undefined.
+     */
+    template <class T, layout_type L>
+    template <class... Args>
+    inline auto xsplit_complex<T, L>::unchecked(Args... args) const -> const_reference
+    {
+        return value_type(m_real.unchecked(args...), m_imag.unchecked(args...));
+    }
+
+    template <class T, layout_type L>
+    template <class S>
+    inline auto xsplit_complex<T, L>::operator[](const S& index) const -> disable_integral_t<S, const_reference>
+    {
+        return element(index.cbegin(), index.cend());
+    }
+
+    template <class T, layout_type L>
+    template <class I>
+    inline auto xsplit_complex<T, L>::operator[](std::initializer_list<I> index) const -> const_reference
+    {
+        return element(index.begin(), index.end());
+    }
+
+    template <class T, layout_type L>
+    inline auto xsplit_complex<T, L>::operator[](size_type i) const -> const_reference
+    {
+        return operator()(i);
+    }
+
+    /**
+     * Returns the element at the specified position in the tensor.
+     * @param first iterator starting the sequence of indices
+     * @param last iterator ending the sequence of indices
+     * The number of indices in the sequence should be equal to or greater
+     * than the number of dimensions of the tensor.
+     */
+    template <class T, layout_type L>
+    template <class It>
+    inline auto xsplit_complex<T, L>::element(It first, It last) const -> const_reference
+    {
+        return value_type(m_real.element(first, last), m_imag.element(first, last));
+    }
+    //@}
+
+    /**
+     * @name Broadcasting
+     */
+    //@{
+    /**
+     * Broadcast the shape of the tensor to the specified parameter.
+     * @param shape the result shape
+     * @param reuse_cache parameter for internal optimization
+     * @return a boolean indicating whether the broadcasting is trivial
+     */
+    template <class T, layout_type L>
+    template <class O>
+    inline bool xsplit_complex<T, L>::broadcast_shape(O& shape, bool) const
+    {
+        return xt::broadcast_shape(m_real.shape(), shape);
+    }
+
+    /**
+     * Checks whether the tensor can be linearly assigned to an expression
+     * with the specified strides.
+     * @return a boolean indicating whether a linear assign is possible
+     */
+    template <class T, layout_type L>
+    template <class O>
+    inline bool xsplit_complex<T, L>::has_linear_assign(const O& /*strides*/) const noexcept
+    {
+        return false;
+    }
+    //@}
+
+    template <class T, layout_type L>
+    template <class O>
+    inline auto xsplit_complex<T, L>::stepper_begin(const O& shape) const noexcept -> const_stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return const_stepper(this, offset);
+    }
+
+    template <class T, layout_type L>
+    template <class O>
+    inline auto xsplit_complex<T, L>::stepper_end(const O& shape, layout_type) const noexcept -> const_stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return const_stepper(this, offset, true);
+    }
+
+    template <class T, layout_type L>
+    inline void xsplit_complex<T, L>::check_planes() const
+    {
+        if (m_real.dimension() != m_imag.dimension() ||
+            !std::equal(m_real.shape().cbegin(), m_real.shape().cend(), m_imag.shape().cbegin()))
+        {
+            throw std::runtime_error("xsplit_complex: the real and imaginary planes must have the same shape");
+        }
+    }
+
+    /**
+     * Returns the container of the real parts of \em e, see xsplit_complex::real.
+     */
+    template <class T, layout_type L>
+    inline typename xsplit_complex<T, L>::plane_type& real(xsplit_complex<T, L>& e) noexcept
+    {
+        return e.real();
+    }
+
+    template <class T, layout_type L>
+    inline const typename xsplit_complex<T, L>::plane_type& real(const xsplit_complex<T, L>& e) noexcept
+    {
+        return e.real();
+    }
+
+    template <class T, layout_type L>
+    inline typename xsplit_complex<T, L>::plane_type real(xsplit_complex<T, L>&& e)
+    {
+        return std::move(e).real();
+    }
+
+    /**
+     * Returns the container of the imaginary parts of \em e, see xsplit_complex::imag.
+     */
+    template <class T, layout_type L>
+    inline typename xsplit_complex<T, L>::plane_type& imag(xsplit_complex<T, L>& e) noexcept
+    {
+        return e.imag();
+    }
+
+    template <class T, layout_type L>
+    inline const typename xsplit_complex<T, L>::plane_type& imag(const xsplit_complex<T, L>& e) noexcept
+    {
+        return e.imag();
+    }
+
+    template <class T, layout_type L>
+    inline typename xsplit_complex<T, L>::plane_type imag(xsplit_complex<T, L>&& e)
+    {
+        return std::move(e).imag();
+    }
+
+    /****************************************
+     * split complex kernels implementation *
+     ****************************************/
+
+    /**
+     * @defgroup split_complex_kernels Split complex kernels
+     *
+     * The kernels compute with the real and imaginary planes of \ref
+     * xsplit_complex tensors, broadcast against each other, and return
+     * new xsplit_complex tensors or real containers.
+     */
+
+    /**
+     * @ingroup split_complex_kernels
+     * @brief Element-wise sum of two split complex tensors.
+     */
+    template <class T, layout_type L>
+    inline xsplit_complex<T, L> split_add(const xsplit_complex<T, L>& a, const xsplit_complex<T, L>& b)
+    {
+        using plane_type = typename xsplit_complex<T, L>::plane_type;
+        plane_type re = a.real() + b.real();
+        plane_type im = a.imag() + b.imag();
+        return xsplit_complex<T, L>(std::move(re), std::move(im));
+    }
+
+    /**
+     * @ingroup split_complex_kernels
+     * @brief Element-wise difference of two split complex tensors.
+     */
+    template <class T, layout_type L>
+    inline xsplit_complex<T, L> split_subtract(const xsplit_complex<T, L>& a, const xsplit_complex<T, L>& b)
+    {
+        using plane_type = typename xsplit_complex<T, L>::plane_type;
+        plane_type re = a.real() - b.real();
+        plane_type im = a.imag() - b.imag();
+        return xsplit_complex<T, L>(std::move(re), std::move(im));
+    }
+
+    /**
+     * @ingroup split_complex_kernels
+     * @brief Element-wise product of two split complex tensors.
+     */
+    template <class T, layout_type L>
+    inline xsplit_complex<T, L> split_multiply(const xsplit_complex<T, L>& a, const xsplit_complex<T, L>& b)
+    {
+        using plane_type = typename xsplit_complex<T, L>::plane_type;
+        const plane_type& ar = a.real();
+        const plane_type& ai = a.imag();
+        const plane_type& br = b.real();
+        const plane_type& bi = b.imag();
+        plane_type re = ar * br - ai * bi;
+        plane_type im = ar * bi + ai * br;
+        return xsplit_complex<T, L>(std::move(re), std::move(im));
+    }
+
+    /**
+     * @ingroup split_complex_kernels
+     * @brief Element-wise product of a split complex tensor and a real expression.
+     * @param a the split complex tensor
+     * @param e an \ref xexpression with real values, broadcastable with \em a
+     */
+    template <class T, layout_type L, class E>
+    inline xsplit_complex<T, L> split_multiply(const xsplit_complex<T, L>& a, const xexpression<E>& e)
+    {
+        static_assert(!xtl::is_complex<typename E::value_type>::value,
+                      "split_multiply: the expression must be real, use a split complex tensor instead");
+        using plane_type = typename xsplit_complex<T, L>::plane_type;
+        const E& de = e.derived_cast();
+        plane_type re = a.real() * de;
+        plane_type im = a.imag() * de;
+        return xsplit_complex<T, L>(std::move(re), std::move(im));
+    }
+
+    /**
+     * @ingroup split_complex_kernels
+     * @brief Element-wise quotient of two split complex tensors.
+     */
+    template <class T, layout_type L>
+    inline xsplit_complex<T, L> split_divide(const xsplit_complex<T, L>& a, const xsplit_complex<T, L>& b)
+    {
+        using plane_type = typename xsplit_complex<T, L>::plane_type;
+        const plane_type& ar = a.real();
+        const plane_type& ai = a.imag();
+        const plane_type& br = b.real();
+        const plane_type& bi = b.imag();
+        plane_type norm = br * br + bi * bi;
+        plane_type re = (ar * br + ai * bi) / norm;
+        plane_type im = (ai * br - ar * bi) / norm;
+        return xsplit_complex<T, L>(std::move(re), std::move(im));
+    }
+
+    /**
+     * @ingroup split_complex_kernels
+     * @brief Element-wise complex conjugate of a split complex tensor.
+     */
+    template <class T, layout_type L>
+    inline xsplit_complex<T, L> split_conj(const xsplit_complex<T, L>& a)
+    {
+        using plane_type = typename xsplit_complex<T, L>::plane_type;
+        plane_type re = a.real();
+        plane_type im = -a.imag();
+        return xsplit_complex<T, L>(std::move(re), std::move(im));
+    }
+
+    /**
+     * @ingroup split_complex_kernels
+     * @brief Element-wise squared magnitude of a split complex tensor.
+     */
+    template <class T, layout_type L>
+    inline xarray<T, L> split_norm(const xsplit_complex<T, L>& a)
+    {
+        return a.real() * a.real() + a.imag() * a.imag();
+    }
+
+    /**
+     * @ingroup split_complex_kernels
+     * @brief Element-wise magnitude of a split complex tensor.
+     *
+     * The magnitude is the square root of the squared magnitude, which is
+     * vectorized, unlike hypot; it overflows for parts beyond the square
+     * root of the largest value of \em T.
+     */
+    template <class T, layout_type L>
+    inline xarray<T, L> split_abs(const xsplit_complex<T, L>& a)
+    {
+        return xt::sqrt(a.real() * a.real() + a.imag() * a.imag());
+    }
+}
+
+#endif
@@ -0,0 +1,486 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_STENCIL_HPP
+#define XTENSOR_STENCIL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xarray.hpp"
+#include "xparallel.hpp"
+#include "xrolling.hpp"
+#include "xsort.hpp"
+#include "xstorage.hpp"
+#include "xtensor_config.hpp"
+
+namespace xt
+{
+    /**
+     * @defgroup stencil_functions Stencils
+     *
+     * The stencil functions compute each element of the result from the
+     * neighbors of the same element of an expression, given by their offsets.
+     * The result is split into tiles of contiguous elements processed in
+     * parallel; in the interior of the expression, where every neighbor
+     * exists, the loops run over contiguous elements for each neighbor and
+     * are vectorized, and only the halo of the expression is computed element
+     * by element with the boundary mode.
+     */
+
+    /**
+     * @ingroup stencil_functions
+     * Values of the neighbors that lie outside of the expression.
+     */
+    enum class stencil_boundary
+    {
+        /// the result only holds the elements whose neighbors all exist
+        valid,
+        /// the missing neighbors have the fill value
+        constant,
+        /// the missing neighbors have the value of the closest element
+        nearest,
+        /// the expression is repeated periodically along each axis
+        periodic
+    };
+
+    namespace detail
+    {
+        using stencil_offsets = std::vector<std::vector<std::ptrdiff_t>>;
+
+        // number of contiguous results of a tile
+        constexpr std::size_t stencil_block = 1024;
+
+        // Weighted sum of the neighbors; the rows accumulate the contribution
+        // of each neighbor into the contiguous results.
+        template <class R, class W>
+        struct stencil_weighted_kernel
+        {
+            const std::vector<W>& weights;
+
+            template <class T>
+            void row(const T* x, const std::ptrdiff_t* deltas, std::size_t count, R* y) const
+            {
+                std::fill(y, y + count, R(0));
+                for (std::size_t k = 0; k < weights.size(); ++k)
+                {
+                    R w = static_cast<R>(weights[k]);
+                    const T* xk = x + deltas[k];
+                    XTENSOR_PRAGMA_SIMD
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        y[i] += w * static_cast<R>(xk[i]);
+                    }
+                }
+            }
+
+            template <class T>
+            R point(const T* values) const
+            {
+                R res = R(0);
+                for (std::size_t k = 0; k < weights.size(); ++k)
+                {
+                    res += static_cast<R>(weights[k]) * static_cast<R>(values[k]);
+                }
+                return res;
+            }
+        };
+
+        // Function of the values of the neighbors, gathered in offset order.
+        template <class R, class F>
+        struct stencil_function_kernel
+        {
+            F& f;
+            std::size_t size;
+
+            template <class T>
+            void row(const T* x, const std::ptrdiff_t* deltas, std::size_t count, R* y) const
+            {
+                uvector<T> values(size);
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    for (std::size_t k = 0; k < size; ++k)
+                    {
+                        values[k] = x[static_cast<std::ptrdiff_t>(i) + deltas[k]];
+                    }
+                    y[i] = static_cast<R>(f(static_cast<const T*>(values.data())));
+                }
+            }
+
+            template <class T>
+            R point(const T* values) const
+            {
+                return static_cast<R>(f(values));
+            }
+        };
+
+        // Median of the neighbors. The neighbors of a batch of contiguous
+        // results are gathered one neighbor after the other, so that a sorting
+        // network sorts all of them with vectorized compare-exchanges; larger
+        // neighborhoods are partially sorted element by element.
+        template <class R>
+        struct stencil_median_kernel
+        {
+            std::size_t size;
+
+            // median of the n sorted values stride apart
+            template <class T>
+            static R sorted_median(const T* v, std::size_t n, std::size_t stride)
+            {
+                R lo = static_cast<R>(v[(n - 1) / 2 * stride]);
+                if (n % 2 == 0)
+                {
+                    R hi = static_cast<R>(v[n / 2 * stride]);
+                    return lo + R(0.5) * (hi - lo);
+                }
+                return lo;
+            }
+
+            template <class T>
+            static R select_median(T* v, std::size_t n)
+            {
+                T* mid = v + std::ptrdiff_t((n - 1) / 2);
+                std::nth_element(v, mid, v + std::ptrdiff_t(n));
+                R lo = static_cast<R>(*mid);
+                if (n % 2 == 0)
+                {
+                    R hi = static_cast<R>(*std::min_element(mid + 1, v + std::ptrdiff_t(n)));
+                    return lo + R(0.5) * (hi - lo);
+                }
+                return lo;
+            }
+
+            template <class T>
+            void row(const T* x, const std::ptrdiff_t* deltas, std::size_t count, R* y) const
+            {
+                constexpr std::size_t batch = sorting_network_batch;
+                if (use_sorting_network<T>(size))
+                {
+                    uvector<T> columns(size * batch);
+                    for (std::size_t c0 = 0; c0 < count; c0 += batch)
+                    {
+                        std::size_t width = (std::min)(batch, count - c0);
+                        for (std::size_t k = 0; k < size; ++k)
+                        {
+                            std::copy(x + deltas[k] + static_cast<std::ptrdiff_t>(c0),
+                                      x + deltas[k] + static_cast<std::ptrdiff_t>(c0 + width), columns.data() + k * width);
+                        }
+                        network_sort_columns(columns.data(), size, width, width);
+                        for (std::size_t i = 0; i < width; ++i)
+                        {
+                            y[c0 + i] = sorted_median(columns.data() + i, size, width);
+                        }
+                    }
+                    return;
+                }
+                uvector<T> values(size);
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    for (std::size_t k = 0; k < size; ++k)
+                    {
+                        values[k] = x[static_cast<std::ptrdiff_t>(i) + deltas[k]];
+                    }
+                    y[i] = select_median(values.data(), size);
+                }
+            }
+
+            template <class T>
+            R point(const T* values) const
+            {
+                uvector<T> v(values, values + size);
+                if (try_network_sort(v.data(), size))
+                {
+                    return sorted_median(v.data(), size, 1);
+                }
+                return select_median(v.data(), size);
+            }
+        };
+
+        /**
+         * Evaluates the kernel at each element of e: rows of contiguous
+         * elements whose neighbors all lie in e are passed to kernel.row with
+         * the linear offsets of the neighbors, the others to kernel.point
+         * with the values of the neighbors given by the boundary mode.
+         */
+        template <class R, class E, class K>
+        inline xarray<R, layout_type::row_major> stencil_apply(const xexpression<E>& expr, const stencil_offsets& offsets,
+                                                               const K& kernel, stencil_boundary boundary,
+                                                               const typename E::value_type& fill)
+        {
+            using value_type = typename E::value_type;
+            const E& e = expr.derived_cast();
+            std::size_t dim = e.dimension();
+            if (dim == 0)
+            {
+                throw std::runtime_error("stencil: the expression must have at least one dimension");
+            }
+            if (offsets.empty())
+            {
+                throw std::runtime_error("stencil: no neighbor");
+            }
+
+            // halos and linear offsets of the neighbors in the row-major buffer
+            std::vector<std::size_t> shape(e.shape().cbegin(), e.shape().cend());
+            std::vector<std::size_t> lo(dim, 0), hi(dim, 0);
+            std::vector<std::ptrdiff_t> strides(dim, 1);
+            for (std::size_t d = dim - 1; d > 0; --d)
+            {
+                strides[d - 1] = strides[d] * static_cast<std::ptrdiff_t>(shape[d]);
+            }
+            std::vector<std::ptrdiff_t> deltas(offsets.size(), 0);
+            for (std::size_t k = 0; k < offsets.size(); ++k)
+            {
+                if (offsets[k].size() != dim)
+                {
+                    throw std::runtime_error("stencil: the offsets must have one value per dimension");
+                }
+                for (std::size_t d = 0; d < dim; ++d)
+                {
+                    std::ptrdiff_t off = offsets[k][d];
+                    lo[d] = std::max(lo[d], static_cast<std::size_t>(off < 0 ? -off : 0));
+                    hi[d] = std::max(hi[d], static_cast<std::size_t>(off > 0 ? off : 0));
+                    deltas[k] += off * strides[d];
+                }
+            }
+
+            bool valid = boundary == stencil_boundary::valid;
+            std::vector<std::size_t> res_shape(shape);
+            std::vector<std::size_t> shift(dim, 0);
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                if (valid)
+                {
+                    res_shape[d] = shape[d] > lo[d] + hi[d] ? shape[d] - lo[d] - hi[d] : 0;
+                    shift[d] = lo[d];
+                }
+            }
+            xarray<R, layout_type::row_major> res = xarray<R, layout_type::row_major>::from_shape(res_shape);
+            if (res.size() == 0)
+            {
+                return res;
+            }
+
+            std::size_t last = dim - 1;
+            std::size_t row_size = res_shape[last];
+            std::size_t rows = res.size() / row_size;
+            std::size_t blocks = (row_size + stencil_block - 1) / stencil_block;
+            // results of the last axis whose neighbors all exist
+            std::size_t inner_first = lo[last] - shift[last];
+            std::size_t inner_last = shape[last] > hi[last] + shift[last] ? shape[last] - hi[last] - shift[last] : 0;
+
+            rolling_source(e, [&](const auto* x) {
+                auto neighbor = [&](const std::vector<std::size_t>& index, std::size_t k, bool& outside) {
+                    std::ptrdiff_t pos = 0;
+                    outside = false;
+                    for (std::size_t d = 0; d < dim; ++d)
+                    {
+                        std::ptrdiff_t n = static_cast<std::ptrdiff_t>(shape[d]);
+                        std::ptrdiff_t i = static_cast<std::ptrdiff_t>(index[d]) + offsets[k][d];
+                        if (i < 0 || i >= n)
+                        {
+                            switch (boundary)
+                            {
+                            case stencil_boundary::nearest:
+                                i = i < 0 ? 0 : n - 1;
+                                break;
+                            case stencil_boundary::periodic:
+                                i = ((i % n) + n) % n;
+                                break;
+                            default:
+                                outside = true;
+                                return pos;
+                            }
+                        }
+                        pos += i * strides[d];
+                    }
+                    return pos;
+                };
+
+                auto compute_tiles = [&](std::size_t first, std::size_t end) {
+                    std::vector<std::size_t> index(dim);
+                    uvector<value_type> values(offsets.size());
+                    for (std::size_t t = first; t < end; ++t)
+                    {
+                        std::size_t r = t / blocks;
+                        std::size_t c0 = (t % blocks) * stencil_block;
+                        std::size_t c1 = std::min(row_size, c0 + stencil_block);
+                        R* y = res.data() + r * row_size;
+
+                        // index in e of the first element of the row
+                        bool inner_row = true;
+                        std::ptrdiff_t base = 0;
+                        std::size_t rem = r;
+                        for (std::size_t d = last; d > 0; --d)
+                        {
+                            std::size_t o = rem % res_shape[d - 1];
+                            rem /= res_shape[d - 1];
+                            index[d - 1] = o + shift[d - 1];
+                            inner_row = inner_row && index[d - 1] >= lo[d - 1] && index[d - 1] + hi[d - 1] < shape[d - 1];
+                            base += static_cast<std::ptrdiff_t>(index[d - 1]) * strides[d - 1];
+                        }
+
+                        auto points = [&](std::size_t p0, std::size_t p1) {
+                            for (std::size_t c = p0; c < p1; ++c)
+                            {
+                                index[last] = c + shift[last];
+                                for (std::size_t k = 0; k < offsets.size(); ++k)
+                                {
+                                    bool outside;
+                                    std::ptrdiff_t pos = neighbor(index, k, outside);
+                                    values[k] = outside ? fill : static_cast<value_type>(x[pos]);
+                                }
+                                y[c] = kernel.point(static_cast<const value_type*>(values.data()));
+                            }
+                        };
+
+                        std::size_t i0 = inner_row ? std::min(std::max(c0, inner_first), c1) : c1;
+                        std::size_t i1 = inner_row ? std::max(std::min(c1, inner_last), i0) : c1;
+                        points(c0, i0);
+                        if (i1 > i0)
+                        {
+                            const auto* center = x + base + static_cast<std::ptrdiff_t>(i0 + shift[last]);
+                            kernel.row(center, deltas.data(), i1 - i0, y + i0);
+                        }
+                        points(i1, c1);
+                    }
+                };
+
+                std::size_t tiles = rows * blocks;
+                if (tiles > 1 && parallel::use_parallel(res.size() * offsets.size()))
+                {
+                    std::size_t tile_size = std::min(row_size, stencil_block) * offsets.size();
+                    parallel_for(std::size_t(0), tiles, parallel::grain(tile_size), compute_tiles);
+                }
+                else
+                {
+                    compute_tiles(std::size_t(0), tiles);
+                }
+            }, rolling_row_major<E>());
+            return res;
+        }
+    }
+
+    /**
+     * @ingroup stencil_functions
+     * @brief Weighted sum of the neighbors of each element of \em e.
+     *
+     * res[i] = sum_k weights[k] * e[i + offsets[k]], the neighbors outside
+     * of \em e being given by the boundary mode.
+     *
+     * \code{.cpp}
+     * // second order central difference of a 2-D field along both axes
+     * xt::xarray<double> lap = xt::stencil(u, {{-1, 0}, {1, 0}, {0, -1}, {0, 1}, {0, 0}},
+     *                                      {1., 1., 1., 1., -4.});
+     * \endcode
+     *
+     * @param e an \ref xexpression
+     * @param offsets the offsets of the neighbors, with one value per dimension
+     * @param weights the weights of the neighbors
+     * @param boundary the boundary mode
+     * @param fill the value of the missing neighbors with stencil_boundary::constant
+     * @throw std::runtime_error if the sizes of the offsets and the weights
+     * differ, or if an offset does not have one value per dimension
+     * @return an \ref xarray holding the result, whose shape is that of \em e
+     * reduced by the halo of the stencil with stencil_boundary::valid, and
+     * that of \em e otherwise
+     */
+    template <class E, class W = typename E::value_type>
+    inline auto stencil(const xexpression<E>& e, const std::vector<std::vector<std::ptrdiff_t>>& offsets,
+                        const std::vector<W>& weights, stencil_boundary boundary = stencil_boundary::valid,
+                        const typename E::value_type& fill = typename E::value_type())
+    {
+        using result_type = std::decay_t<decltype(std::declval<typename E::value_type>() * std::declval<W>())>;
+        if (weights.size() != offsets.size())
+        {
+            throw std::runtime_error("stencil: the numbers of offsets and weights differ");
+        }
+        detail::stencil_weighted_kernel<result_type, W> kernel{ weights };
+        return detail::stencil_apply<result_type>(e, offsets, kernel, boundary, fill);
+    }
+
+    /**
+     * @ingroup stencil_functions
+     * @brief Median of the neighbors of each element of \em e.
+     *
+     * res[i] is the median of the values e[i + offsets[k]], the mean of the
+     * two middle values for an even number of neighbors, as computed by
+     * \ref median; the neighbors outside of \em e are given by the boundary
+     * mode. Neighborhoods of at most XTENSOR_SORTING_NETWORK_SIZE integral or
+     * floating point values are sorted with a vectorized sorting network.
+     *
+     * \code{.cpp}
+     * // 3x3 median filter of an image
+     * std::vector<std::vector<std::ptrdiff_t>> box;
+     * for (std::ptrdiff_t i = -1; i <= 1; ++i)
+     *     for (std::ptrdiff_t j = -1; j <= 1; ++j)
+     *         box.push_back({i, j});
+     * xt::xarray<float> smooth = xt::median_filter(image, box, xt::stencil_boundary::nearest);
+     * \endcode
+     *
+     * @param e an \ref xexpression
+     * @param offsets the offsets of the neighbors, with one value per dimension
+     * @param boundary the boundary mode
+     * @param fill the value of the missing neighbors with stencil_boundary::constant
+     * @throw std::runtime_error if an offset does not have one value per dimension
+     * @return an \ref xarray holding the result, of floating point values,
+     * whose shape is that of \em e reduced by the halo of the stencil with
+     * stencil_boundary::valid, and that of \em e otherwise
+     */
+    template <class E>
+    inline auto median_filter(const xexpression<E>& e, const std::vector<std::vector<std::ptrdiff_t>>& offsets,
+                              stencil_boundary boundary = stencil_boundary::valid,
+                              const typename E::value_type& fill = typename E::value_type())
+    {
+        using result_type = detail::quantile_value_type_t<typename E::value_type>;
+        detail::stencil_median_kernel<result_type> kernel{ offsets.size() };
+        return detail::stencil_apply<result_type>(e, offsets, kernel, boundary, fill);
+    }
+
+    /**
+     * @ingroup stencil_functions
+     * @brief Applies a function to the neighbors of each element of \em e.
+     *
+     * res[i] = f(values), values being a pointer to the values of
+     * e[i + offsets[k]] in the order of the offsets, the neighbors outside of
+     * \em e being given by the boundary mode. The function may be called
+     * concurrently.
+     *
+     * \code{.cpp}
+     * // maximum of each element and its two neighbors
+     * auto m = xt::neighborhood(a, {{-1}, {0}, {1}}, [](const double* v) {
+     *     return std::max({v[0], v[1], v[2]});
+     * }, xt::stencil_boundary::nearest);
+     * \endcode
+     *
+     * @param e an \ref xexpression
+     * @param offsets the offsets of the neighbors, with one value per dimension
+     * @param f the function called with a pointer to the values of the neighbors
+     * @param boundary the boundary mode
+     * @param fill the value of the missing neighbors with stencil_boundary::constant
+     * @throw std::runtime_error if an offset does not have one value per dimension
+     * @return an \ref xarray holding the result, whose shape is that of \em e
+     * reduced by the halo of the stencil with stencil_boundary::valid, and
+     * that of \em e otherwise
+     */
+    template <class E, class F>
+    inline auto neighborhood(const xexpression<E>& e, const std::vector<std::vector<std::ptrdiff_t>>& offsets, F&& f,
+                             stencil_boundary boundary = stencil_boundary::valid,
+                             const typename E::value_type& fill = typename E::value_type())
+    {
+        using value_type = typename E::value_type;
+        using result_type = std::decay_t<decltype(f(std::declval<const value_type*>()))>;
+        detail::stencil_function_kernel<result_type, std::remove_reference_t<F>> kernel{ f, offsets.size() };
+        return detail::stencil_apply<result_type>(e, offsets, kernel, boundary, fill);
+    }
+}
+
+#endif
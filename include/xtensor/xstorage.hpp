@@ -18,6 +18,7 @@
 #include <type_traits>
 
 #include "xexception.hpp"
+#include "xparallel.hpp"
 #include "xtensor_simd.hpp"
 #include "xutils.hpp"
 
@@ -87,6 +88,10 @@ namespace xt
         size_type size() const noexcept;
         void resize(size_type size);
 
+        size_type capacity() const noexcept;
+        void reserve(size_type new_cap);
+        void shrink_to_fit();
+
         reference operator[](size_type i);
         const_reference operator[](size_type i) const;
 
@@ -125,6 +130,10 @@ namespace xt
         void init_data(I first, I last);
 
         void resize_impl(size_type new_size);
+        void reallocate(size_type new_cap);
+
+        void copy_allocator(const allocator_type& alloc, std::true_type /*propagate*/);
+        void copy_allocator(const allocator_type& alloc, std::false_type /*propagate*/) noexcept;
 
         allocator_type m_allocator;
 
@@ -132,6 +141,7 @@ namespace xt
         // storing a pointer to the beginning and the size of the container
         pointer p_begin;
         pointer p_end;
+        pointer p_capacity;
     };
 
     template <class T, class A>
@@ -161,6 +171,50 @@ namespace xt
 
     namespace detail
     {
+#if defined(XTENSOR_PARALLEL_ENABLED) && defined(XTENSOR_PARALLEL_FIRST_TOUCH)
+        // Touches every page of a freshly allocated buffer with the same
+        // partition as the linear parallel assignment, so that with a first
+        // touch NUMA policy the pages land on the node of the thread that
+        // computes on them.
+        template <class T>
+        inline void parallel_first_touch(T* ptr, std::size_t size)
+        {
+            constexpr std::size_t line_size = XTENSOR_CACHE_LINE_SIZE > sizeof(T) ?
+                                              XTENSOR_CACHE_LINE_SIZE / sizeof(T) : 1;
+            constexpr std::size_t page_size = XTENSOR_PAGE_SIZE;
+            if (ptr == nullptr || !parallel::use_parallel(size))
+            {
+                return;
+            }
+            parallel_for(std::size_t(0), size, parallel::grain(1, line_size), [ptr](std::size_t first, std::size_t last)
+            {
+                char* it = reinterpret_cast<char*>(ptr + first);
+                char* end = reinterpret_cast<char*>(ptr + last);
+                for (; it < end; it += page_size)
+                {
+                    *static_cast<volatile char*>(it) = 0;
+                }
+            });
+        }
+
+        template <class P>
+        inline void parallel_first_touch(P, std::size_t)
+        {
+        }
+#endif
+
+        // Whether the pages of the new buffers of trivial types are touched
+        // with XTENSOR_PARALLEL_FIRST_TOUCH. The buffers of an allocator
+        // returning zeroed memory, such as zero_page_allocator, are not: their
+        // pages are only materialized when they are written, which touching
+        // them would defeat.
+        template <class A>
+        struct first_touches_pages
+            : std::integral_constant<bool, xtrivially_default_constructible<typename A::value_type>::value &&
+                                           !allocates_zeros<A>::value>
+        {
+        };
+
         template <class A>
         inline typename A::pointer safe_init_allocate(A& alloc, typename A::size_type size)
         {
@@ -174,11 +228,19 @@ namespace xt
                     alloc.construct(p, value_type());
                 }
             }
+#if defined(XTENSOR_PARALLEL_ENABLED) && defined(XTENSOR_PARALLEL_FIRST_TOUCH)
+            else if (first_touches_pages<A>::value)
+            {
+                parallel_first_touch(res, static_cast<std::size_t>(size));
+            }
+#endif
             return res;
         }
 
+        // destroys the size first elements of a buffer of capacity elements
         template <class A>
-        inline void safe_destroy_deallocate(A& alloc, typename A::pointer ptr, typename A::size_type size)
+        inline void safe_destroy_deallocate(A& alloc, typename A::pointer ptr, typename A::size_type size,
+                                            typename A::size_type capacity)
         {
             using pointer = typename A::pointer;
             using value_type = typename A::value_type;
@@ -191,9 +253,15 @@ namespace xt
                         alloc.destroy(p);
                     }
                 }
-                alloc.deallocate(ptr, size);
+                alloc.deallocate(ptr, capacity);
             }
         }
+
+        template <class A>
+        inline void safe_destroy_deallocate(A& alloc, typename A::pointer ptr, typename A::size_type size)
+        {
+            safe_destroy_deallocate(alloc, ptr, size, size);
+        }
     }
 
     template <class T, class A>
@@ -206,22 +274,91 @@ namespace xt
             p_begin = m_allocator.allocate(size);
             std::uninitialized_copy(first, last, p_begin);
             p_end = p_begin + size;
+            p_capacity = p_end;
         }
     }
 
+    // The buffer is kept when the new size fits in the capacity, the elements
+    // are then preserved up to the new size, unless the vector shrinks below a
+    // quarter of the capacity: the elements are then moved to a buffer of
+    // exactly new_size elements. Otherwise a buffer of exactly new_size
+    // elements is allocated, and the elements are not preserved.
     template <class T, class A>
     inline void uvector<T, A>::resize_impl(size_type new_size)
     {
         size_type old_size = size();
-        pointer old_begin = p_begin;
-        if (new_size != old_size)
+        if (new_size == old_size)
+        {
+            return;
+        }
+        if (new_size <= capacity())
+        {
+            pointer new_end = p_begin + new_size;
+            if (!xtrivially_default_constructible<value_type>::value)
+            {
+                for (pointer p = new_end; p < p_end; ++p)
+                {
+                    m_allocator.destroy(p);
+                }
+                for (pointer p = p_end; p < new_end; ++p)
+                {
+                    m_allocator.construct(p, value_type());
+                }
+            }
+            p_end = new_end;
+            if (new_size < old_size && new_size < capacity() / 4)
+            {
+                reallocate(new_size);
+            }
+        }
+        else
         {
+            pointer old_begin = p_begin;
+            size_type old_capacity = capacity();
             p_begin = detail::safe_init_allocate(m_allocator, new_size);
             p_end = p_begin + new_size;
-            detail::safe_destroy_deallocate(m_allocator, old_begin, old_size);
+            p_capacity = p_end;
+            detail::safe_destroy_deallocate(m_allocator, old_begin, old_size, old_capacity);
         }
     }
 
+    // moves the elements to a buffer of new_cap elements
+    template <class T, class A>
+    inline void uvector<T, A>::reallocate(size_type new_cap)
+    {
+        size_type old_size = size();
+        pointer new_begin = nullptr;
+        if (new_cap != size_type(0))
+        {
+            new_begin = m_allocator.allocate(new_cap);
+            std::uninitialized_copy(std::make_move_iterator(p_begin), std::make_move_iterator(p_end), new_begin);
+        }
+        detail::safe_destroy_deallocate(m_allocator, p_begin, old_size, capacity());
+        p_begin = new_begin;
+        p_end = p_begin + old_size;
+        p_capacity = p_begin + new_cap;
+    }
+
+    // the buffer allocated by the current allocator is released when the
+    // propagated one cannot deallocate it
+    template <class T, class A>
+    inline void uvector<T, A>::copy_allocator(const allocator_type& alloc, std::true_type /*propagate*/)
+    {
+        if (!(m_allocator == alloc))
+        {
+            detail::safe_destroy_deallocate(m_allocator, p_begin, size(), capacity());
+            p_begin = nullptr;
+            p_end = nullptr;
+            p_capacity = nullptr;
+        }
+        m_allocator = alloc;
+    }
+
+    template <class T, class A>
+    inline void uvector<T, A>::copy_allocator(const allocator_type& /*alloc*/, std::false_type /*propagate*/) noexcept
+    {
+    }
+
     template <class T, class A>
     inline uvector<T, A>::uvector() noexcept
         : uvector(allocator_type())
@@ -230,29 +367,31 @@ namespace xt
 
     template <class T, class A>
     inline uvector<T, A>::uvector(const allocator_type& alloc) noexcept
-        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr)
+        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr), p_capacity(nullptr)
     {
     }
 
     template <class T, class A>
     inline uvector<T, A>::uvector(size_type count, const allocator_type& alloc)
-        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr)
+        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr), p_capacity(nullptr)
     {
         if (count != 0)
         {
             p_begin = detail::safe_init_allocate(m_allocator, count);
             p_end = p_begin + count;
+            p_capacity = p_end;
         }
     }
 
     template <class T, class A>
     inline uvector<T, A>::uvector(size_type count, const_reference value, const allocator_type& alloc)
-        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr)
+        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr), p_capacity(nullptr)
     {
         if (count != 0)
         {
             p_begin = m_allocator.allocate(count);
             p_end = p_begin + count;
+            p_capacity = p_end;
             std::uninitialized_fill(p_begin, p_end, value);
         }
     }
@@ -260,14 +399,14 @@ namespace xt
     template <class T, class A>
     template <class InputIt, class>
     inline uvector<T, A>::uvector(InputIt first, InputIt last, const allocator_type& alloc)
-        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr)
+        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr), p_capacity(nullptr)
     {
         init_data(first, last);
     }
 
     template <class T, class A>
     inline uvector<T, A>::uvector(std::initializer_list<T> init, const allocator_type& alloc)
-        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr)
+        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr), p_capacity(nullptr)
     {
         init_data(init.begin(), init.end());
     }
@@ -275,22 +414,23 @@ namespace xt
     template <class T, class A>
     inline uvector<T, A>::~uvector()
     {
-        detail::safe_destroy_deallocate(m_allocator, p_begin, size());
+        detail::safe_destroy_deallocate(m_allocator, p_begin, size(), capacity());
         p_begin = nullptr;
         p_end = nullptr;
+        p_capacity = nullptr;
     }
 
     template <class T, class A>
     inline uvector<T, A>::uvector(const uvector& rhs)
         : m_allocator(std::allocator_traits<allocator_type>::select_on_container_copy_construction(rhs.get_allocator())),
-          p_begin(nullptr), p_end(nullptr)
+          p_begin(nullptr), p_end(nullptr), p_capacity(nullptr)
     {
         init_data(rhs.p_begin, rhs.p_end);
     }
 
     template <class T, class A>
     inline uvector<T, A>::uvector(const uvector& rhs, const allocator_type& alloc)
-        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr)
+        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr), p_capacity(nullptr)
     {
         init_data(rhs.p_begin, rhs.p_end);
     }
@@ -301,7 +441,8 @@ namespace xt
         // No copy and swap idiom here due to performance issues
         if (this != &rhs)
         {
-            m_allocator = std::allocator_traits<allocator_type>::select_on_container_copy_construction(rhs.get_allocator());
+            copy_allocator(rhs.m_allocator,
+                           typename std::allocator_traits<allocator_type>::propagate_on_container_copy_assignment());
             resize_impl(rhs.size());
             if (xtrivially_default_constructible<value_type>::value)
             {
@@ -317,18 +458,20 @@ namespace xt
 
     template <class T, class A>
     inline uvector<T, A>::uvector(uvector&& rhs) noexcept
-        : m_allocator(std::move(rhs.m_allocator)), p_begin(rhs.p_begin), p_end(rhs.p_end)
+        : m_allocator(std::move(rhs.m_allocator)), p_begin(rhs.p_begin), p_end(rhs.p_end), p_capacity(rhs.p_capacity)
     {
         rhs.p_begin = nullptr;
         rhs.p_end = nullptr;
+        rhs.p_capacity = nullptr;
     }
 
     template <class T, class A>
     inline uvector<T, A>::uvector(uvector&& rhs, const allocator_type& alloc) noexcept
-        : m_allocator(alloc), p_begin(rhs.p_begin), p_end(rhs.p_end)
+        : m_allocator(alloc), p_begin(rhs.p_begin), p_end(rhs.p_end), p_capacity(rhs.p_capacity)
     {
         rhs.p_begin = nullptr;
         rhs.p_end = nullptr;
+        rhs.p_capacity = nullptr;
     }
 
     template <class T, class A>
@@ -338,6 +481,7 @@ namespace xt
         uvector tmp(std::move(rhs));
         swap(p_begin, tmp.p_begin);
         swap(p_end, tmp.p_end);
+        swap(p_capacity, tmp.p_capacity);
         return *this;
     }
 
@@ -359,12 +503,53 @@ namespace xt
         return static_cast<size_type>(p_end - p_begin);
     }
 
+    /**
+     * Resizes the vector. The buffer is kept when \c size does not exceed the
+     * capacity, unless the vector shrinks below a quarter of it: the buffer
+     * is then shrunk to \c size elements. The elements are preserved up to \c size
+     * in both cases. Otherwise a buffer of exactly \c size elements is
+     * allocated and the elements are not preserved.
+     */
     template <class T, class A>
     inline void uvector<T, A>::resize(size_type size)
     {
         resize_impl(size);
     }
 
+    /**
+     * Returns the number of elements that the allocated buffer can hold.
+     */
+    template <class T, class A>
+    inline auto uvector<T, A>::capacity() const noexcept -> size_type
+    {
+        return static_cast<size_type>(p_capacity - p_begin);
+    }
+
+    /**
+     * Increases the capacity to at least \c new_cap elements, the elements
+     * are preserved.
+     */
+    template <class T, class A>
+    inline void uvector<T, A>::reserve(size_type new_cap)
+    {
+        if (new_cap > capacity())
+        {
+            reallocate(new_cap);
+        }
+    }
+
+    /**
+     * Releases the unused capacity, the elements are preserved.
+     */
+    template <class T, class A>
+    inline void uvector<T, A>::shrink_to_fit()
+    {
+        if (capacity() != size())
+        {
+            reallocate(size());
+        }
+    }
+
     template <class T, class A>
     inline auto uvector<T, A>::operator[](size_type i) -> reference
     {
@@ -492,6 +677,7 @@ namespace xt
         swap(m_allocator, rhs.m_allocator);
         swap(p_begin, rhs.p_begin);
         swap(p_end, rhs.p_end);
+        swap(p_capacity, rhs.p_capacity);
     }
 
     template <class T, class A>
@@ -11,9 +11,11 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <stdexcept>
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <xtl/xsequence.hpp>
 #include <xtl/xvariant.hpp>
@@ -204,6 +206,7 @@ namespace xt
         using base_type::storage;
         using base_type::data;
         using base_type::data_offset;
+        using base_type::reset_offset;
         using base_type::expression;
 
         using base_type::broadcast_shape;
@@ -247,6 +250,30 @@ namespace xt
         template <class E>
         rebind_t<E> build_view(E&& e) const;
 
+        //
+        // SIMD interface
+        //
+
+        template <class requested_type>
+        using simd_return_type = xsimd::simd_return_type<value_type, requested_type>;
+
+        template <class T, class R>
+        using enable_simd_interface = std::enable_if_t<has_data_interface<T>::value && has_simd_interface<T>::value, R>;
+
+        template <class align, class simd, class T = xexpression_type>
+        enable_simd_interface<T, void> store_simd(size_type i, const simd& e);
+
+        template <class align, class requested_type = value_type,
+                  std::size_t N = xsimd::simd_traits<requested_type>::size,
+                  class T = xexpression_type>
+        enable_simd_interface<T, simd_return_type<requested_type>> load_simd(size_type i) const;
+
+        template <class T = xexpression_type>
+        enable_simd_interface<T, reference> data_element(size_type i);
+
+        template <class T = xexpression_type>
+        enable_simd_interface<T, const_reference> data_element(size_type i) const;
+
     private:
 
         container_iterator data_xbegin() noexcept;
@@ -309,6 +336,12 @@ namespace xt
     template <class E>
     auto strided_view(E&& e, const xstrided_slice_vector& slices);
 
+    template <class E, class S, class X>
+    bool try_reshape_strides(const E& e, const S& shape, X& strides, layout_type layout = XTENSOR_DEFAULT_LAYOUT);
+
+    template <class E, class S>
+    auto reshape_strided(E&& e, S&& shape, layout_type layout = XTENSOR_DEFAULT_LAYOUT);
+
     /********************************
      * xstrided_view implementation *
      ********************************/
@@ -542,6 +575,35 @@ namespace xt
         return rebind_t<E>(std::forward<E>(e), std::move(sh), std::move(str), base_type::data_offset(), this->layout());
     }
 
+    template <class CT, class S, layout_type L, class FST>
+    template <class align, class simd, class T>
+    inline auto xstrided_view<CT, S, L, FST>::store_simd(size_type i, const simd& e) -> enable_simd_interface<T, void>
+    {
+        using simd_value = typename simd::value_type;
+        xsimd::store_simd<value_type, simd_value>(&(storage()[data_offset() + i]), e, xsimd::unaligned_mode());
+    }
+
+    template <class CT, class S, layout_type L, class FST>
+    template <class align, class requested_type, std::size_t N, class T>
+    inline auto xstrided_view<CT, S, L, FST>::load_simd(size_type i) const -> enable_simd_interface<T, simd_return_type<requested_type>>
+    {
+        return xsimd::load_simd<value_type, requested_type>(&(storage()[data_offset() + i]), xsimd::unaligned_mode());
+    }
+
+    template <class CT, class S, layout_type L, class FST>
+    template <class T>
+    inline auto xstrided_view<CT, S, L, FST>::data_element(size_type i) -> enable_simd_interface<T, reference>
+    {
+        return storage()[data_offset() + i];
+    }
+
+    template <class CT, class S, layout_type L, class FST>
+    template <class T>
+    inline auto xstrided_view<CT, S, L, FST>::data_element(size_type i) const -> enable_simd_interface<T, const_reference>
+    {
+        return storage()[data_offset() + i];
+    }
+
     /*****************************************
      * xstrided_view builders implementation *
      *****************************************/
@@ -715,6 +777,203 @@ namespace xt
         return reshape_view(std::forward<E>(e), xtl::forward_sequence<shape_type>(shape), l);
     }
 #endif
+
+    /**********************************
+     * reshape_strided implementation *
+     **********************************/
+
+    namespace detail
+    {
+        // Computes the strides reading the elements of an expression of shape
+        // old_shape and strides old_strides in row major order with new_shape.
+        // The dimensions are grouped into the smallest chunks of equal size;
+        // each chunk of the old shape must be contiguous, i.e. its strides
+        // must be those of a row major block.
+        template <class S1, class X1, class S2, class X2>
+        inline bool row_major_reshape_strides(const S1& old_shape, const X1& old_strides,
+                                              const S2& new_shape, X2& new_strides)
+        {
+            // the dimensions of size 1 do not constrain the strides
+            std::vector<std::size_t> shape;
+            std::vector<std::ptrdiff_t> strides;
+            for (std::size_t i = 0; i < old_shape.size(); ++i)
+            {
+                if (old_shape[i] != 1)
+                {
+                    shape.push_back(static_cast<std::size_t>(old_shape[i]));
+                    strides.push_back(static_cast<std::ptrdiff_t>(old_strides[i]));
+                }
+            }
+
+            std::size_t old_dim = shape.size();
+            std::size_t new_dim = new_shape.size();
+            std::size_t oi = 0, oj = 1, ni = 0, nj = 1;
+            while (ni < new_dim && oi < old_dim)
+            {
+                std::size_t np = static_cast<std::size_t>(new_shape[ni]);
+                std::size_t op = shape[oi];
+                while (np != op)
+                {
+                    if (np < op)
+                    {
+                        np *= static_cast<std::size_t>(new_shape[nj++]);
+                    }
+                    else
+                    {
+                        op *= shape[oj++];
+                    }
+                }
+
+                for (std::size_t k = oi; k + 1 < oj; ++k)
+                {
+                    if (strides[k] != static_cast<std::ptrdiff_t>(shape[k + 1]) * strides[k + 1])
+                    {
+                        return false;
+                    }
+                }
+
+                new_strides[nj - 1] = strides[oj - 1];
+                for (std::size_t k = nj - 1; k > ni; --k)
+                {
+                    new_strides[k - 1] = new_strides[k] * static_cast<std::ptrdiff_t>(new_shape[k]);
+                }
+                ni = nj++;
+                oi = oj++;
+            }
+
+            // trailing dimensions of size 1
+            for (; ni < new_dim; ++ni)
+            {
+                new_strides[ni] = 0;
+            }
+            return true;
+        }
+
+        template <class E, class S>
+        inline auto reshape_strided_impl(E&& e, S&& shape, layout_type layout, std::true_type /*data interface*/)
+        {
+            get_strides_t<std::decay_t<S>> strides;
+            xt::resize_container(strides, shape.size());
+            if (!try_reshape_strides(e, shape, strides, layout))
+            {
+                throw std::runtime_error("reshape_strided: the reshape requires a copy of the expression");
+            }
+            std::size_t offset = e.data_offset();
+            return strided_view(std::forward<E>(e), std::forward<S>(shape), std::move(strides), offset);
+        }
+
+        template <class E, class S>
+        inline auto reshape_strided_impl(E&& e, S&& shape, layout_type layout, std::false_type /*data interface*/)
+        {
+            using temporary_type = xarray<typename std::decay_t<E>::value_type, layout_type::dynamic>;
+            using shape_type = typename temporary_type::shape_type;
+            temporary_type tmp(shape_type(e.shape().cbegin(), e.shape().cend()), layout);
+            assign_xexpression(tmp, e);
+            return reshape_strided_impl(std::move(tmp), std::forward<S>(shape), layout, std::true_type());
+        }
+    }
+
+    /**
+     * @brief Computes the strides of a reshape without copy.
+     *
+     * Computes the strides of a view of \c e with the shape \c shape, reading
+     * the elements of \c e in the order given by \c layout, that only changes
+     * the strides of \c e. This is possible when the dimensions of \c e that
+     * are merged are contiguous in \c layout order, for instance for any reshape
+     * of a contiguous container, or for splitting the dimensions of a strided
+     * view.
+     *
+     * @param e the expression to reshape
+     * @param shape the new shape
+     * @param strides the computed strides, with \c shape.size() elements
+     * @param layout the order in which the elements are read
+     *
+     * @return false if \c e has no data interface or if the reshape
+     * requires a copy
+     * @throws std::runtime_error if the sizes do not match
+     */
+    template <class E, class S, class X>
+    inline bool try_reshape_strides(const E& e, const S& shape, X& strides, layout_type layout)
+    {
+        if (compute_size(shape) != e.size())
+        {
+            throw std::runtime_error("reshape_strided: cannot reshape with incorrect number of elements");
+        }
+        if (!has_data_interface<E>::value || layout == layout_type::dynamic || layout == layout_type::any)
+        {
+            return false;
+        }
+
+        decltype(auto) old_strides = detail::get_strides(e);
+        if (e.size() == 0)
+        {
+            compute_strides(shape, layout, strides);
+            return true;
+        }
+        if (layout == layout_type::row_major)
+        {
+            return detail::row_major_reshape_strides(e.shape(), old_strides, shape, strides);
+        }
+
+        // column major reshapes are row major reshapes of the reversed dimensions
+        std::vector<std::size_t> rshape(e.shape().crbegin(), e.shape().crend());
+        std::vector<std::ptrdiff_t> rstrides(old_strides.crbegin(), old_strides.crend());
+        std::vector<std::size_t> rnew_shape(shape.crbegin(), shape.crend());
+        std::vector<std::ptrdiff_t> rnew_strides(rnew_shape.size());
+        if (!detail::row_major_reshape_strides(rshape, rstrides, rnew_shape, rnew_strides))
+        {
+            return false;
+        }
+        std::copy(rnew_strides.crbegin(), rnew_strides.crend(), strides.begin());
+        return true;
+    }
+
+    /**
+     * @brief Returns a reshaped view without per-element index mapping.
+     *
+     * Unlike \ref reshape_view, the elements are accessed with the strides
+     * computed by \ref try_reshape_strides, directly in the data of \c e.
+     * An expression without data interface is evaluated once in a temporary
+     * held by the view.
+     *
+     * \code{.cpp}
+     * xt::xarray<double> a = xt::arange<double>(24);
+     * a.reshape({4, 6});
+     * // splits the columns of a strided view
+     * auto v = xt::reshape_strided(xt::strided_view(a, {xt::all(), xt::range(0, 4)}), {4, 2, 2});
+     * // => v(1, 1, 0) == a(1, 2)
+     * \endcode
+     *
+     * @param e the expression to reshape
+     * @param shape the new shape
+     * @param layout the order in which the elements are read
+     *
+     * @return a strided view with the new shape
+     * @throws std::runtime_error if \c e has a data interface and the reshape
+     * requires a copy; \c xt::eval(e) can be reshaped instead.
+     */
+    template <class E, class S>
+    inline auto reshape_strided(E&& e, S&& shape, layout_type layout)
+    {
+        return detail::reshape_strided_impl(std::forward<E>(e), std::forward<S>(shape), layout,
+                                            has_data_interface<std::decay_t<E>>());
+    }
+
+#if !defined(X_OLD_CLANG)
+    template <class E, class I, std::size_t N>
+    inline auto reshape_strided(E&& e, const I(&shape)[N], layout_type layout = XTENSOR_DEFAULT_LAYOUT)
+    {
+        using shape_type = std::array<std::size_t, N>;
+        return reshape_strided(std::forward<E>(e), xtl::forward_sequence<shape_type>(shape), layout);
+    }
+#else
+    template <class E, class I>
+    inline auto reshape_strided(E&& e, const std::initializer_list<I>& shape, layout_type layout = XTENSOR_DEFAULT_LAYOUT)
+    {
+        using shape_type = xt::dynamic_shape<std::size_t>;
+        return reshape_strided(std::forward<E>(e), xtl::forward_sequence<shape_type>(shape), layout);
+    }
+#endif
 }
 
 #endif
@@ -121,6 +121,7 @@ namespace xt
         std::enable_if_t<has_data_interface<std::decay_t<E>>::value, const value_type*>
         data() const noexcept;
         size_type data_offset() const noexcept;
+        void reset_offset(size_type offset) noexcept;
 
         xexpression_type& expression() noexcept;
         const xexpression_type& expression() const noexcept;
@@ -144,6 +145,8 @@ namespace xt
         template <class It>
         offset_type compute_element_index(It first, It last) const;
 
+        void reset_geometry(S&& shape, strides_type&& strides, size_type offset, layout_type layout) noexcept;
+
     private:
 
         CT m_e;
@@ -701,6 +704,18 @@ namespace xt
         return m_offset;
     }
 
+    /**
+     * Moves the view to another position of the underlying container by
+     * replacing its offset, the shape and the strides are kept. This allows
+     * to visit several slices of the same geometry with a single view.
+     * @param offset the new offset of the first element in the view
+     */
+    template <class CT, class S, layout_type L, class FST>
+    inline void xstrided_view_base<CT, S, L, FST>::reset_offset(size_type offset) noexcept
+    {
+        m_offset = offset;
+    }
+
     /**
      * Returns a reference to the underlying expression of the view.
      */
@@ -772,6 +787,20 @@ namespace xt
         return static_cast<offset_type>(m_offset) + xt::element_offset<offset_type>(strides(), first, last);
     }
 
+    // Replaces the shape, strides, offset and layout of the view, used by
+    // the views that can be rebound to new slices.
+    template <class CT, class S, layout_type L, class FST>
+    inline void xstrided_view_base<CT, S, L, FST>::reset_geometry(S&& shape, strides_type&& strides,
+                                                                   size_type offset, layout_type layout) noexcept
+    {
+        m_shape = std::move(shape);
+        m_strides = std::move(strides);
+        m_offset = offset;
+        m_layout = layout;
+        resize_container(m_backstrides, m_shape.size());
+        adapt_strides(m_shape, m_strides, m_backstrides);
+    }
+
     /******************************************
      * flat_expression_adaptor implementation *
      ******************************************/
@@ -10,8 +10,14 @@
 #define XTENSOR_STRIDES_HPP
 
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <numeric>
+#include <vector>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
 
 #include "xexception.hpp"
 #include "xtensor_forward.hpp"
@@ -49,6 +55,10 @@ namespace xt
     std::size_t compute_strides(const shape_type& shape, layout_type l,
                                 strides_type& strides, backstrides_type& backstrides);
 
+    template <class shape_type, class strides_type, class backstrides_type>
+    std::size_t compute_padded_strides(const shape_type& shape, layout_type l, std::size_t padding,
+                                       strides_type& strides, backstrides_type& backstrides);
+
     template <class shape_type, class strides_type>
     void adapt_strides(const shape_type& shape, strides_type& strides) noexcept;
 
@@ -317,6 +327,39 @@ namespace xt
         return detail::compute_strides<L>(shape, l, strides, &backstrides);
     }
 
+    /**
+     * Computes the strides of a row major or column major layout whose
+     * leading dimension is rounded up to a multiple of \c padding elements,
+     * so that each row (resp. column) starts at the same alignment as the
+     * first one.
+     * @return the number of elements of the buffer, padding included
+     */
+    template <class shape_type, class strides_type, class backstrides_type>
+    inline std::size_t compute_padded_strides(const shape_type& shape, layout_type l, std::size_t padding,
+                                              strides_type& strides, backstrides_type& backstrides)
+    {
+        using strides_value_type = std::decay_t<decltype(strides[0])>;
+        std::size_t dim = shape.size();
+        if (dim == 0)
+        {
+            return 1;
+        }
+        strides_value_type pad = static_cast<strides_value_type>(padding != 0 ? padding : 1);
+        strides_value_type data_size = 1;
+        for (std::size_t n = 0; n < dim; ++n)
+        {
+            std::size_t i = l == layout_type::row_major ? dim - 1 - n : n;
+            strides[i] = data_size;
+            data_size = strides[i] * static_cast<strides_value_type>(shape[i]);
+            if (n == 0 && dim > 1)
+            {
+                data_size = (data_size + pad - 1) / pad * pad;
+            }
+            detail::adapt_strides(shape, strides, &backstrides, i);
+        }
+        return static_cast<std::size_t>(data_size);
+    }
+
     template <class shape_type, class strides_type>
     inline bool do_strides_match(const shape_type& shape, const strides_type& strides, layout_type l)
     {
@@ -422,6 +465,174 @@ namespace xt
         return unravel_from_strides(static_cast<strides_value_type>(index), strides, l);
     }
 
+    namespace detail
+    {
+        /*****************
+         * index_divider *
+         *****************/
+
+        inline std::uint64_t mulhi(std::uint64_t a, std::uint64_t b) noexcept
+        {
+#if defined(__SIZEOF_INT128__)
+            return static_cast<std::uint64_t>((static_cast<unsigned __int128>(a) * b) >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+            return __umulh(a, b);
+#else
+            std::uint64_t a_lo = a & 0xffffffffULL, a_hi = a >> 32;
+            std::uint64_t b_lo = b & 0xffffffffULL, b_hi = b >> 32;
+            std::uint64_t lo_lo = a_lo * b_lo;
+            std::uint64_t hi_lo = a_hi * b_lo;
+            std::uint64_t lo_hi = a_lo * b_hi;
+            std::uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xffffffffULL) + lo_hi;
+            return a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+#endif
+        }
+
+        // Division of the unsigned integers by a divisor known at runtime but
+        // invariant, with a multiplication and two shifts instead of a
+        // division (Granlund and Montgomery, "Division by invariant integers
+        // using multiplication"). Preparing the divisor costs a division, the
+        // dividers are meant to be reused for many indices.
+        class index_divider
+        {
+        public:
+
+            index_divider() noexcept = default;
+            explicit index_divider(std::size_t divisor) noexcept;
+
+            std::size_t divisor() const noexcept;
+            std::size_t divide(std::size_t n) const noexcept;
+            // returns n % divisor and replaces n with n / divisor
+            std::size_t divmod(std::size_t& n) const noexcept;
+
+        private:
+
+            std::uint64_t m_magic = 1;
+            std::uint64_t m_divisor = 1;
+            unsigned int m_shift1 = 0;
+            unsigned int m_shift2 = 0;
+        };
+
+        // a null divisor is handled as 1, so that the shapes with a zero
+        // extent, which have no index to unravel, can be prepared
+        inline index_divider::index_divider(std::size_t divisor) noexcept
+            : m_divisor(divisor == 0 ? 1 : static_cast<std::uint64_t>(divisor))
+        {
+            unsigned int l = 0;
+            while (l < 64 && (std::uint64_t(1) << l) < m_divisor)
+            {
+                ++l;
+            }
+            // magic = floor(2^64 * (2^l - d) / d) + 1, where 2^l - d < d
+            std::uint64_t high = (l == 64 ? std::uint64_t(0) : std::uint64_t(1) << l) - m_divisor;
+#if defined(__SIZEOF_INT128__)
+            m_magic = static_cast<std::uint64_t>((static_cast<unsigned __int128>(high) << 64) / m_divisor) + 1;
+#else
+            std::uint64_t quotient = 0;
+            for (int i = 0; i != 64; ++i)
+            {
+                bool carry = (high >> 63) != 0;
+                high <<= 1;
+                quotient <<= 1;
+                if (carry || high >= m_divisor)
+                {
+                    high -= m_divisor;
+                    quotient |= 1;
+                }
+            }
+            m_magic = quotient + 1;
+#endif
+            m_shift1 = l < 1 ? l : 1;
+            m_shift2 = l < 1 ? 0 : l - 1;
+        }
+
+        inline std::size_t index_divider::divisor() const noexcept
+        {
+            return static_cast<std::size_t>(m_divisor);
+        }
+
+        inline std::size_t index_divider::divide(std::size_t n) const noexcept
+        {
+            std::uint64_t x = static_cast<std::uint64_t>(n);
+            std::uint64_t t = mulhi(m_magic, x);
+            return static_cast<std::size_t>((t + ((x - t) >> m_shift1)) >> m_shift2);
+        }
+
+        inline std::size_t index_divider::divmod(std::size_t& n) const noexcept
+        {
+            std::size_t q = divide(n);
+            std::size_t r = n - q * static_cast<std::size_t>(m_divisor);
+            n = q;
+            return r;
+        }
+
+        /*****************
+         * shape_divider *
+         *****************/
+
+        // Dividers of the extents of a shape, unravelling the flat indices
+        // of many elements without division.
+        class shape_divider
+        {
+        public:
+
+            shape_divider() = default;
+
+            template <class S>
+            explicit shape_divider(const S& shape);
+
+            std::size_t size() const noexcept;
+            const index_divider& operator[](std::size_t i) const noexcept;
+
+            template <class I>
+            void unravel(std::size_t index, I& idx, layout_type l = layout_type::row_major) const noexcept;
+
+        private:
+
+            std::vector<index_divider> m_dividers;
+        };
+
+        template <class S>
+        inline shape_divider::shape_divider(const S& shape)
+        {
+            m_dividers.reserve(shape.size());
+            for (auto s : shape)
+            {
+                m_dividers.emplace_back(static_cast<std::size_t>(s));
+            }
+        }
+
+        inline std::size_t shape_divider::size() const noexcept
+        {
+            return m_dividers.size();
+        }
+
+        inline const index_divider& shape_divider::operator[](std::size_t i) const noexcept
+        {
+            return m_dividers[i];
+        }
+
+        template <class I>
+        inline void shape_divider::unravel(std::size_t index, I& idx, layout_type l) const noexcept
+        {
+            using value_type = typename I::value_type;
+            if (l == layout_type::column_major)
+            {
+                for (std::size_t d = 0; d != m_dividers.size(); ++d)
+                {
+                    idx[d] = static_cast<value_type>(m_dividers[d].divmod(index));
+                }
+            }
+            else
+            {
+                for (std::size_t d = m_dividers.size(); d != 0; --d)
+                {
+                    idx[d - 1] = static_cast<value_type>(m_dividers[d - 1].divmod(index));
+                }
+            }
+        }
+    }
+
     template <class S1, class S2>
     inline bool broadcast_shape(const S1& input, S2& output)
     {
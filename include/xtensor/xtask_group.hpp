@@ -0,0 +1,278 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_TASK_GROUP_HPP
+#define XTENSOR_TASK_GROUP_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xasync.hpp"
+#include "xexpression.hpp"
+#include "xparallel.hpp"
+
+namespace xt
+{
+
+    /**************
+     * task_group *
+     **************/
+
+    /**
+     * @class task_group
+     * @brief Batch of assignments evaluated concurrently.
+     *
+     * The assignments of small expressions are too short to be split by the
+     * parallel backend; the task_group collects them and runs them in
+     * parallel with each other instead. A task may depend on tasks added
+     * before it, in which case it starts once they are complete. Tasks are
+     * run by as many workers as there are cores, each of them pulling the
+     * next ready task when it is done with the previous one, so that the
+     * load is balanced whatever the cost of the tasks. The assignments
+     * performed by a task are run serially.
+     *
+     * \code{.cpp}
+     * xt::task_group g;
+     * for (std::size_t i = 0; i < n; ++i)
+     * {
+     *     auto t = g.assign(tmp[i], a[i] * b[i]);
+     *     g.assign(res[i], xt::sum(tmp[i]), {t});
+     * }
+     * g.wait();
+     * \endcode
+     *
+     * The expressions are copied or moved into the tasks, their lvalue
+     * operands and the destinations must outlive the call to wait().
+     */
+    class task_group
+    {
+    public:
+
+        using task_id = std::size_t;
+        using dependency_list = std::vector<task_id>;
+
+        task_group() = default;
+
+        template <class F>
+        task_id run(F&& f, const dependency_list& dependencies = {});
+
+        template <class E1, class E2>
+        task_id assign(E1&& out, E2&& e, const dependency_list& dependencies = {});
+
+        void wait();
+
+        std::size_t size() const noexcept;
+        bool empty() const noexcept;
+
+    private:
+
+        struct node
+        {
+            std::function<void()> body;
+            std::vector<task_id> successors;
+            std::size_t npredecessors;
+        };
+
+        class scheduler;
+
+        std::vector<node> m_nodes;
+    };
+
+    /*****************************
+     * task_group implementation *
+     *****************************/
+
+    class task_group::scheduler
+    {
+    public:
+
+        explicit scheduler(std::vector<node>& nodes);
+
+        void work();
+        void rethrow();
+
+    private:
+
+        std::vector<node>& m_nodes;
+        std::vector<task_id> m_ready;
+        std::size_t m_remaining;
+        std::exception_ptr m_error;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+    };
+
+    inline task_group::scheduler::scheduler(std::vector<node>& nodes)
+        : m_nodes(nodes), m_remaining(nodes.size())
+    {
+        // the ready tasks are taken from the back, the first ones start first
+        for (std::size_t i = nodes.size(); i != 0; --i)
+        {
+            if (nodes[i - 1].npredecessors == 0)
+            {
+                m_ready.push_back(i - 1);
+            }
+        }
+    }
+
+    inline void task_group::scheduler::work()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (m_remaining != 0)
+        {
+            if (m_ready.empty())
+            {
+                // the tasks that are running will make others ready
+                m_condition.wait(lock);
+                continue;
+            }
+            task_id id = m_ready.back();
+            m_ready.pop_back();
+            bool skip = static_cast<bool>(m_error);
+            lock.unlock();
+
+            std::exception_ptr error;
+            if (!skip)
+            {
+                try
+                {
+                    m_nodes[id].body();
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+            }
+
+            lock.lock();
+            if (error && !m_error)
+            {
+                m_error = error;
+            }
+            std::size_t nready = m_ready.size();
+            for (task_id succ : m_nodes[id].successors)
+            {
+                if (--m_nodes[succ].npredecessors == 0)
+                {
+                    m_ready.push_back(succ);
+                }
+            }
+            // tasks most recently made ready run first, which keeps the
+            // results of a task in cache for its successors
+            std::reverse(m_ready.begin() + static_cast<std::ptrdiff_t>(nready), m_ready.end());
+            --m_remaining;
+            if (m_remaining == 0 || m_ready.size() > nready + 1)
+            {
+                m_condition.notify_all();
+            }
+            else if (m_ready.size() > nready)
+            {
+                m_condition.notify_one();
+            }
+        }
+    }
+
+    inline void task_group::scheduler::rethrow()
+    {
+        if (m_error)
+        {
+            std::rethrow_exception(m_error);
+        }
+    }
+
+    /**
+     * Adds a task calling f().
+     * @param f the function to call
+     * @param dependencies the tasks that must complete before f is called
+     * @return the identifier of the task, valid until the next call to wait()
+     */
+    template <class F>
+    inline auto task_group::run(F&& f, const dependency_list& dependencies) -> task_id
+    {
+        task_id id = m_nodes.size();
+        for (task_id dep : dependencies)
+        {
+            if (dep >= id)
+            {
+                throw std::runtime_error("task_group: dependency on a task that was not added before");
+            }
+        }
+        m_nodes.push_back({ std::function<void()>(std::forward<F>(f)), {}, dependencies.size() });
+        for (task_id dep : dependencies)
+        {
+            m_nodes[dep].successors.push_back(id);
+        }
+        return id;
+    }
+
+    /**
+     * Adds a task assigning e to out. out may also be the result of noalias.
+     * @param out the destination, which must outlive the call to wait()
+     * @param e the expression to assign, moved or copied into the task
+     * @param dependencies the tasks that must complete before the assignment
+     * @return the identifier of the task, valid until the next call to wait()
+     */
+    template <class E1, class E2>
+    inline auto task_group::assign(E1&& out, E2&& e, const dependency_list& dependencies) -> task_id
+    {
+        using expression_type = std::decay_t<E2>;
+        return run([dst = detail::async_target<E1>{ std::forward<E1>(out) },
+                    expr = expression_type(std::forward<E2>(e))]() mutable {
+            dst.target = expr;
+        }, dependencies);
+    }
+
+    /**
+     * Runs all the tasks and returns when they are complete. If a task
+     * throws, the tasks that have not started yet are skipped and the
+     * exception is rethrown. The group is empty afterwards and can be
+     * reused.
+     */
+    inline void task_group::wait()
+    {
+        std::vector<node> nodes = std::move(m_nodes);
+        m_nodes.clear();
+        if (nodes.empty())
+        {
+            return;
+        }
+
+        scheduler s(nodes);
+        std::size_t ncores = std::max(static_cast<std::size_t>(std::thread::hardware_concurrency()), std::size_t(1));
+        std::size_t nworkers = std::min(nodes.size(), ncores);
+        // each chunk runs one worker, the serial backend runs a single one
+        parallel_for(std::size_t(0), nworkers, std::size_t(1), [&s](std::size_t, std::size_t)
+        {
+            s.work();
+        });
+        s.rethrow();
+    }
+
+    /**
+     * Returns the number of tasks added since the last call to wait().
+     */
+    inline std::size_t task_group::size() const noexcept
+    {
+        return m_nodes.size();
+    }
+
+    inline bool task_group::empty() const noexcept
+    {
+        return m_nodes.empty();
+    }
+}
+
+#endif
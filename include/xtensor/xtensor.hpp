@@ -381,7 +381,15 @@ namespace xt
         {
             detail::resize_data_container(m_storage, std::size_t(1));
         }
-        semantic_base::assign(e);
+        if (detail::holds_zero_fill<allocator_type>(e.derived_cast()))
+        {
+            // the storage allocated by the resize is already zeroed
+            base_type::resize(e.derived_cast().shape());
+        }
+        else
+        {
+            semantic_base::assign(e);
+        }
     }
 
     /**
@@ -41,13 +41,30 @@
 #define XTENSOR_DEFAULT_DATA_CONTAINER(T, A) uvector<T, A>
 #endif
 
+#ifndef XTENSOR_DEFAULT_SHAPE_CAPACITY
+#define XTENSOR_DEFAULT_SHAPE_CAPACITY 4
+#endif
+
 #ifndef XTENSOR_DEFAULT_SHAPE_CONTAINER
 #define XTENSOR_DEFAULT_SHAPE_CONTAINER(T, EA, SA) \
-    xt::svector<typename XTENSOR_DEFAULT_DATA_CONTAINER(T, EA)::size_type, 4, SA>
+    xt::svector<typename XTENSOR_DEFAULT_DATA_CONTAINER(T, EA)::size_type, XTENSOR_DEFAULT_SHAPE_CAPACITY, SA>
 #endif
 
 #ifndef XTENSOR_DEFAULT_ALLOCATOR
-#ifdef XTENSOR_ALLOC_TRACKING
+#if (defined(XTENSOR_USE_NUMA) + defined(XTENSOR_USE_ARENA) + defined(XTENSOR_USE_HUGE_PAGES) + \
+     defined(XTENSOR_ALLOC_TRACKING)) > 1
+    #error "XTENSOR_USE_NUMA, XTENSOR_USE_ARENA, XTENSOR_USE_HUGE_PAGES and XTENSOR_ALLOC_TRACKING select different default allocators, at most one of them can be defined"
+#endif
+#if defined(XTENSOR_USE_NUMA)
+    #define XTENSOR_DEFAULT_ALLOCATOR(T) \
+        xt::numa_interleave_allocator<T>
+#elif defined(XTENSOR_USE_ARENA)
+    #define XTENSOR_DEFAULT_ALLOCATOR(T) \
+        xt::arena_allocator<T>
+#elif defined(XTENSOR_USE_HUGE_PAGES)
+    #define XTENSOR_DEFAULT_ALLOCATOR(T) \
+        xt::huge_page_allocator<T>
+#elif defined(XTENSOR_ALLOC_TRACKING)
     #ifndef XTENSOR_ALLOC_TRACKING_POLICY
         #define XTENSOR_ALLOC_TRACKING_POLICY xt::alloc_tracking::policy::print
     #endif
@@ -71,6 +88,113 @@
 #endif
 #endif
 
+// Assignment loops are dispatched through parallel_for (see xparallel.hpp)
+// whenever a parallel backend is available
+#if defined(XTENSOR_USE_TBB) || defined(XTENSOR_USE_OPENMP) || defined(XTENSOR_USE_PARALLEL_EXECUTOR)
+#define XTENSOR_PARALLEL_ENABLED
+#endif
+
+// Assignments of less than XTENSOR_PARALLEL_MIN_SIZE elements are never
+// parallelized. A grain size of 0 lets the backend choose the chunk size.
+#ifndef XTENSOR_PARALLEL_MIN_SIZE
+#define XTENSOR_PARALLEL_MIN_SIZE 32768
+#endif
+
+#ifndef XTENSOR_PARALLEL_GRAIN_SIZE
+#define XTENSOR_PARALLEL_GRAIN_SIZE 0
+#endif
+
+#ifndef XTENSOR_CACHE_LINE_SIZE
+#define XTENSOR_CACHE_LINE_SIZE 64
+#endif
+
+#ifndef XTENSOR_PAGE_SIZE
+#define XTENSOR_PAGE_SIZE 4096
+#endif
+
+#ifndef XTENSOR_PREFETCH_DISTANCE
+#define XTENSOR_PREFETCH_DISTANCE 16
+#endif
+
+#ifndef XTENSOR_L1_CACHE_SIZE
+#define XTENSOR_L1_CACHE_SIZE 32768
+#endif
+
+#ifndef XTENSOR_FIXED_UNROLL_SIZE
+#define XTENSOR_FIXED_UNROLL_SIZE 64
+#endif
+
+#ifndef XTENSOR_RADIX_SORT_THRESHOLD
+#define XTENSOR_RADIX_SORT_THRESHOLD 2048
+#endif
+
+#ifndef XTENSOR_SORTING_NETWORK_SIZE
+#define XTENSOR_SORTING_NETWORK_SIZE 32
+#endif
+
+#ifndef XTENSOR_POW_MAX_INTEGER_EXPONENT
+#define XTENSOR_POW_MAX_INTEGER_EXPONENT 32
+#endif
+
+#ifndef XTENSOR_NPY_ASYNC_QUEUE_SIZE
+#define XTENSOR_NPY_ASYNC_QUEUE_SIZE 2
+#endif
+
+#ifndef XTENSOR_ARENA_BLOCK_SIZE
+#define XTENSOR_ARENA_BLOCK_SIZE 1048576
+#endif
+
+#ifndef XTENSOR_POOL_MAX_CLASS_BITS
+#define XTENSOR_POOL_MAX_CLASS_BITS 28
+#endif
+
+#ifndef XTENSOR_POOL_CACHE_SIZE
+#define XTENSOR_POOL_CACHE_SIZE 8
+#endif
+
+#ifndef XTENSOR_POOL_DEPOT_SIZE
+#define XTENSOR_POOL_DEPOT_SIZE 64
+#endif
+
+#ifndef XTENSOR_HUGE_PAGE_SIZE
+#define XTENSOR_HUGE_PAGE_SIZE 2097152
+#endif
+
+#ifndef XTENSOR_HUGE_PAGE_THRESHOLD
+#define XTENSOR_HUGE_PAGE_THRESHOLD XTENSOR_HUGE_PAGE_SIZE
+#endif
+
+#ifndef XTENSOR_NUMA_THRESHOLD
+#define XTENSOR_NUMA_THRESHOLD 1048576
+#endif
+
+#ifndef XTENSOR_ZERO_PAGE_THRESHOLD
+#define XTENSOR_ZERO_PAGE_THRESHOLD 131072
+#endif
+
+// Linear SIMD assignments writing at least XTENSOR_STREAMING_STORE_MIN_BYTES
+// bytes use non-temporal stores, which bypass the caches
+#ifndef XTENSOR_STREAMING_STORE_MIN_BYTES
+#define XTENSOR_STREAMING_STORE_MIN_BYTES 33554432
+#endif
+
+// Annotates the loops over raw pointers of linear assignments evaluated
+// without xsimd, so that the compiler vectorizes them (omp simd when OpenMP
+// is enabled, the ivdep or vectorize pragma of the compiler otherwise)
+#ifndef XTENSOR_PRAGMA_SIMD
+#if defined(_OPENMP)
+#define XTENSOR_PRAGMA_SIMD _Pragma("omp simd")
+#elif defined(__clang__)
+#define XTENSOR_PRAGMA_SIMD _Pragma("clang loop vectorize(enable) interleave(enable)")
+#elif defined(__GNUC__)
+#define XTENSOR_PRAGMA_SIMD _Pragma("GCC ivdep")
+#elif defined(_MSC_VER)
+#define XTENSOR_PRAGMA_SIMD __pragma(loop(ivdep))
+#else
+#define XTENSOR_PRAGMA_SIMD
+#endif
+#endif
+
 #ifndef XTENSOR_DEFAULT_LAYOUT
 #define XTENSOR_DEFAULT_LAYOUT ::xt::layout_type::row_major
 #endif
@@ -63,6 +63,29 @@ namespace xt
               class SA = std::allocator<typename std::vector<T, A>::size_type>>
     using xarray = xarray_container<XTENSOR_DEFAULT_DATA_CONTAINER(T, A), L, XTENSOR_DEFAULT_SHAPE_CONTAINER(T, A, SA)>;
 
+    struct shared_ownership;
+
+    template <class CP, class O, class A>
+    class xbuffer_adaptor;
+
+    /**
+     * @typedef xarray_shared
+     * Alias template on xarray_container whose elements are held by a
+     * reference counted buffer. Copies share the buffer, which is copied
+     * when one of them is accessed through a non-const method, so that
+     * copies of large arrays that are only read cost no copy of the elements.
+     *
+     * @tparam T The value type of the elements.
+     * @tparam L The layout_type of the xarray_container (default: row_major).
+     * @tparam A The allocator of the buffer holding the elements.
+     * @tparam SA The allocator of the containers holding the shape and the strides.
+     */
+    template <class T,
+              layout_type L = XTENSOR_DEFAULT_LAYOUT,
+              class A = XTENSOR_DEFAULT_ALLOCATOR(T),
+              class SA = std::allocator<typename std::vector<T, A>::size_type>>
+    using xarray_shared = xarray_container<xbuffer_adaptor<T*, shared_ownership, A>, L, XTENSOR_DEFAULT_SHAPE_CONTAINER(T, A, SA)>;
+
     template <class EC,
               layout_type L = XTENSOR_DEFAULT_LAYOUT,
               class SC = XTENSOR_DEFAULT_SHAPE_CONTAINER(typename EC::value_type,
@@ -88,6 +111,23 @@ namespace xt
               class SA = std::allocator<typename std::vector<T, A>::size_type>>
     using xarray_optional = xarray_container<xtl::xoptional_vector<T, A, BC>, L, XTENSOR_DEFAULT_SHAPE_CONTAINER(T, A, SA), xoptional_expression_tag>;
 
+    /**
+     * @typedef xarray_bitset
+     * Alias template on xarray_container holding boolean flags packed in the
+     * blocks of an xtl::xdynamic_bitset. Used as the flag expression of an
+     * xoptional_assembly, it takes one bit per element instead of one byte,
+     * and its buffer is laid out as an Arrow validity bitmap on little-endian
+     * platforms.
+     *
+     * @tparam L The layout_type of the container (default: row_major).
+     * @tparam B The type of the blocks holding the flags.
+     * @tparam SA The allocator of the containers holding the shape and the strides.
+     */
+    template <layout_type L = XTENSOR_DEFAULT_LAYOUT,
+              class B = std::size_t,
+              class SA = std::allocator<std::size_t>>
+    using xarray_bitset = xarray_container<xtl::xdynamic_bitset<B>, L, XTENSOR_DEFAULT_SHAPE_CONTAINER(B, XTENSOR_DEFAULT_ALLOCATOR(B), SA)>;
+
     template <class EC, std::size_t N, layout_type L = XTENSOR_DEFAULT_LAYOUT, class Tag = xtensor_expression_tag>
     class xtensor_container;
 
@@ -117,6 +157,22 @@ namespace xt
               class A = XTENSOR_DEFAULT_ALLOCATOR(T)>
     using xtensor = xtensor_container<XTENSOR_DEFAULT_DATA_CONTAINER(T, A), N, L>;
 
+    /**
+     * @typedef xtensor_shared
+     * Alias template on xtensor_container whose elements are held by a
+     * reference counted, copy-on-write buffer (see xarray_shared).
+     *
+     * @tparam T The value type of the elements.
+     * @tparam N The dimension of the tensor.
+     * @tparam L The layout_type of the tensor (default: row_major).
+     * @tparam A The allocator of the buffer holding the elements.
+     */
+    template <class T,
+              std::size_t N,
+              layout_type L = XTENSOR_DEFAULT_LAYOUT,
+              class A = XTENSOR_DEFAULT_ALLOCATOR(T)>
+    using xtensor_shared = xtensor_container<xbuffer_adaptor<T*, shared_ownership, A>, N, L>;
+
     template <class EC, std::size_t N, layout_type L = XTENSOR_DEFAULT_LAYOUT, class Tag = xtensor_expression_tag>
     class xtensor_adaptor;
 
@@ -178,6 +234,20 @@ namespace xt
               class BC = xtl::xdynamic_bitset<std::size_t>>
     using xtensor_optional = xtensor_container<xtl::xoptional_vector<T, A, BC>, N, L, xoptional_expression_tag>;
 
+    /**
+     * @typedef xtensor_bitset
+     * Alias template on xtensor_container holding boolean flags packed in the
+     * blocks of an xtl::xdynamic_bitset (see xarray_bitset).
+     *
+     * @tparam N The dimension of the tensor.
+     * @tparam L The layout_type of the tensor (default: row_major).
+     * @tparam B The type of the blocks holding the flags.
+     */
+    template <std::size_t N,
+              layout_type L = XTENSOR_DEFAULT_LAYOUT,
+              class B = std::size_t>
+    using xtensor_bitset = xtensor_container<xtl::xdynamic_bitset<B>, N, L>;
+
     template <class CT, class... S>
     class xview;
 
@@ -205,6 +275,11 @@ namespace xt
         struct lazy : base
         {
         };
+        // immediate evaluation with pairwise reduction, for
+        // sums and norms that are less sensitive to rounding
+        struct accurate : immediate
+        {
+        };
         /*
         struct cached
         {
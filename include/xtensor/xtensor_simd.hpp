@@ -9,6 +9,10 @@
 #ifndef XTENSOR_SIMD_HPP
 #define XTENSOR_SIMD_HPP
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
 #include <vector>
 
 #include "xstorage.hpp"
@@ -183,6 +187,169 @@ namespace xt
         : test_simd_interface_impl<E>
     {
     };
+
+    /**********************
+     * streaming settings *
+     **********************/
+
+    namespace streaming
+    {
+        std::size_t min_bytes();
+        void set_min_bytes(std::size_t bytes);
+        bool use_streaming(std::size_t bytes);
+
+        /**
+         * Overrides the minimal size of the streaming assignments of the
+         * calling thread for the lifetime of the object; the value of the
+         * enclosing guard, or the global one, applies again upon destruction.
+         * The other threads are not affected. A value of 0 makes every
+         * eligible assignment of the scope use non-temporal stores.
+         */
+        class scoped_min_bytes
+        {
+        public:
+
+            explicit scoped_min_bytes(std::size_t bytes);
+            ~scoped_min_bytes();
+
+            scoped_min_bytes(const scoped_min_bytes&) = delete;
+            scoped_min_bytes& operator=(const scoped_min_bytes&) = delete;
+
+        private:
+
+            std::size_t m_bytes;
+            const std::size_t* m_previous;
+        };
+    }
+
+    namespace detail
+    {
+        // Non-temporal store of a batch to a destination aligned on the size
+        // of the batch, available for the batches of T held in a register type
+        // with a streaming store instruction
+        template <class T, class B>
+        struct stream_storer : std::false_type
+        {
+        };
+
+#if defined(XTENSOR_USE_XSIMD) && defined(XSIMD_X86_INSTR_SET)
+
+#define XTENSOR_STREAM_STORER(T, N, R, STORE)                         \
+        template <>                                                   \
+        struct stream_storer<T, xsimd::batch<T, N>> : std::true_type  \
+        {                                                             \
+            static void store(T* dst, const xsimd::batch<T, N>& b)    \
+            {                                                         \
+                STORE(reinterpret_cast<R*>(dst), b);                  \
+            }                                                         \
+        }
+
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_AVX512_VERSION
+        XTENSOR_STREAM_STORER(float, 16, float, _mm512_stream_ps);
+        XTENSOR_STREAM_STORER(double, 8, double, _mm512_stream_pd);
+        XTENSOR_STREAM_STORER(std::int32_t, 16, __m512i, _mm512_stream_si512);
+        XTENSOR_STREAM_STORER(std::int64_t, 8, __m512i, _mm512_stream_si512);
+#elif XSIMD_X86_INSTR_SET >= XSIMD_X86_AVX_VERSION
+        XTENSOR_STREAM_STORER(float, 8, float, _mm256_stream_ps);
+        XTENSOR_STREAM_STORER(double, 4, double, _mm256_stream_pd);
+        XTENSOR_STREAM_STORER(std::int32_t, 8, __m256i, _mm256_stream_si256);
+        XTENSOR_STREAM_STORER(std::int64_t, 4, __m256i, _mm256_stream_si256);
+#elif XSIMD_X86_INSTR_SET >= XSIMD_X86_SSE2_VERSION
+        XTENSOR_STREAM_STORER(float, 4, float, _mm_stream_ps);
+        XTENSOR_STREAM_STORER(double, 2, double, _mm_stream_pd);
+        XTENSOR_STREAM_STORER(std::int32_t, 4, __m128i, _mm_stream_si128);
+        XTENSOR_STREAM_STORER(std::int64_t, 2, __m128i, _mm_stream_si128);
+#endif
+
+#undef XTENSOR_STREAM_STORER
+
+        // orders the non-temporal stores of the thread before the following stores
+        inline void stream_fence() noexcept
+        {
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_SSE2_VERSION
+            _mm_sfence();
+#endif
+        }
+
+#else
+
+        inline void stream_fence() noexcept
+        {
+        }
+
+#endif
+
+        template <class T>
+        using has_stream_store = stream_storer<T, xsimd::simd_type<T>>;
+    }
+
+    /*************************************
+     * streaming settings implementation *
+     *************************************/
+
+    namespace streaming
+    {
+        namespace detail
+        {
+            inline std::atomic<std::size_t>& global_min_bytes()
+            {
+                static std::atomic<std::size_t> bytes(XTENSOR_STREAMING_STORE_MIN_BYTES);
+                return bytes;
+            }
+
+            // value of the innermost scoped_min_bytes of the calling thread
+            inline const std::size_t*& min_bytes_override()
+            {
+                static thread_local const std::size_t* p = nullptr;
+                return p;
+            }
+        }
+
+        /**
+         * Returns the minimal number of bytes written by a linear SIMD
+         * assignment for it to use non-temporal stores, that write to memory
+         * without reading the destination into the caches nor evicting their
+         * content. It only pays off for destinations much larger than the
+         * last level cache that are not read again soon. The default is given
+         * by XTENSOR_STREAMING_STORE_MIN_BYTES. This is the value of the
+         * innermost scoped_min_bytes of the calling thread if any, the global
+         * value otherwise.
+         */
+        inline std::size_t min_bytes()
+        {
+            const std::size_t* local = detail::min_bytes_override();
+            return local != nullptr ? *local : detail::global_min_bytes().load(std::memory_order_relaxed);
+        }
+
+        /**
+         * Changes the global minimal size of the streaming assignments; it
+         * can be called concurrently with running assignments.
+         */
+        inline void set_min_bytes(std::size_t bytes)
+        {
+            detail::global_min_bytes().store(bytes, std::memory_order_relaxed);
+        }
+
+        /**
+         * Returns true if an assignment writing \c bytes bytes should use
+         * non-temporal stores according to the current settings.
+         */
+        inline bool use_streaming(std::size_t bytes)
+        {
+            return bytes != 0 && bytes >= min_bytes();
+        }
+
+        inline scoped_min_bytes::scoped_min_bytes(std::size_t bytes)
+            : m_bytes(bytes), m_previous(detail::min_bytes_override())
+        {
+            detail::min_bytes_override() = &m_bytes;
+        }
+
+        inline scoped_min_bytes::~scoped_min_bytes()
+        {
+            detail::min_bytes_override() = m_previous;
+        }
+    }
 }
 
 #endif
@@ -0,0 +1,371 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_TILED_HPP
+#define XTENSOR_TILED_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "xadapt.hpp"
+#include "xexpression.hpp"
+#include "xnoalias.hpp"
+#include "xparallel.hpp"
+#include "xshape.hpp"
+#include "xstorage.hpp"
+#include "xtensor_config.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+    template <class E1, class F, class... E>
+    void tiled_assign(xexpression<E1>& e1, F&& f, const xexpression<E>&... e);
+
+    template <class E1, class E, class F>
+    void reduce_lanes(xexpression<E1>& e1, const xexpression<E>& e, std::size_t axis, F&& f);
+
+    template <class E1, class E, class F>
+    void transform_lanes(xexpression<E1>& e1, const xexpression<E>& e, std::size_t axis, F&& f);
+
+    /*******************************
+     * tiled_assign implementation *
+     *******************************/
+
+    namespace detail
+    {
+        template <class T>
+        inline auto make_tile(uvector<T>& buffer, std::size_t size)
+        {
+            return adapt(buffer.data(), size, no_ownership(), std::array<std::size_t, 1>({size}));
+        }
+
+        template <class... T>
+        struct sum_of_sizes;
+
+        template <>
+        struct sum_of_sizes<>
+        {
+            static constexpr std::size_t value = 0;
+        };
+
+        template <class T, class... U>
+        struct sum_of_sizes<T, U...>
+        {
+            static constexpr std::size_t value = sizeof(T) + sum_of_sizes<U...>::value;
+        };
+
+        // number of elements of a tile, such that the scratch buffers of
+        // the operands and of the result fit in half of the L1 cache
+        template <class... T>
+        constexpr std::size_t tile_length()
+        {
+            return std::max(XTENSOR_L1_CACHE_SIZE / (2 * sum_of_sizes<T...>::value), std::size_t(64));
+        }
+
+        template <class E, class S>
+        inline auto resize_tiled(E& e, const S& shape, int) -> decltype(e.resize(shape), void())
+        {
+            e.resize(shape);
+        }
+
+        template <class E, class S>
+        inline void resize_tiled(E& e, const S& shape, long)
+        {
+            if (e.dimension() != shape.size() || !std::equal(shape.cbegin(), shape.cend(), e.shape().cbegin()))
+            {
+                throw std::runtime_error("tiled_assign: the shape of the subexpressions does not match the assigned expression");
+            }
+        }
+
+        template <class E1, class F, class... E, std::size_t... I>
+        inline void tiled_assign_impl(E1& e1, F& f, std::tuple<const E&...> e,
+                                      std::index_sequence<I...>)
+        {
+            using shape_type = dynamic_shape<std::size_t>;
+            using value_type = typename E1::value_type;
+            constexpr layout_type L = XTENSOR_DEFAULT_LAYOUT;
+            constexpr std::size_t tile = tile_length<value_type, typename E::value_type...>();
+
+            shape_type shape(e1.shape().cbegin(), e1.shape().cend());
+            std::size_t size = compute_size(shape);
+            std::size_t n_tiles = (size + tile - 1) / tile;
+
+            auto run_tiles = [&](std::size_t first, std::size_t last)
+            {
+                using difference_type = std::ptrdiff_t;
+                difference_type offset = static_cast<difference_type>(first * tile);
+
+                std::tuple<uvector<typename E::value_type>...> buffers(uvector<typename E::value_type>(tile)...);
+                uvector<value_type> result(tile);
+                auto its = std::make_tuple((std::get<I>(e).template cbegin<L>(shape) + offset)...);
+                auto out = e1.template begin<L>() + offset;
+
+                for (std::size_t t = first; t < last; ++t)
+                {
+                    std::size_t n = std::min(tile, size - t * tile);
+                    // each subexpression is evaluated once per element
+                    using swallow = int[];
+                    (void) swallow{0, (std::get<I>(its) = std::copy_n(std::get<I>(its), n, std::get<I>(buffers).begin()), 0)...};
+
+                    auto res_tile = make_tile(result, n);
+                    noalias(res_tile) = f(make_tile(std::get<I>(buffers), n)...);
+                    out = std::copy_n(result.cbegin(), n, out);
+                }
+            };
+
+#if defined(XTENSOR_PARALLEL_ENABLED)
+            if (parallel::use_parallel(size))
+            {
+                parallel_for(std::size_t(0), n_tiles, parallel::grain(tile, 1), run_tiles);
+                return;
+            }
+#endif
+            run_tiles(std::size_t(0), n_tiles);
+        }
+    }
+
+    /**
+     * @brief Assigns \c f(e...) to \c e1, evaluating each of the expressions
+     * \c e only once per element.
+     *
+     * The expressions \c e are broadcast to \c e1, which is resized to their
+     * broadcast shape (a view must already have this shape), and evaluated by
+     * tiles fitting in the L1 cache. \c f is called with one-dimensional
+     * tensors holding the values of a tile, and must return an expression of
+     * them. Subexpressions used several times in
+     * a computation should be passed as one of the \c e:
+     *
+     * \code{.cpp}
+     * // a * b is computed once
+     * xt::tiled_assign(d, [](auto&& ab) { return ab + xt::sin(ab); }, a * b);
+     * \endcode
+     *
+     * @param e1 the expression to assign to
+     * @param f the function of the tiles
+     * @param e the subexpressions
+     */
+    template <class E1, class F, class... E>
+    inline void tiled_assign(xexpression<E1>& e1, F&& f, const xexpression<E>&... e)
+    {
+        static_assert(sizeof...(E) != 0, "tiled_assign requires at least one subexpression");
+        using size_type = typename E1::size_type;
+        using shape_type = dynamic_shape<size_type>;
+
+        E1& de1 = e1.derived_cast();
+        size_type dim = std::max({e.derived_cast().dimension()...});
+        shape_type shape(dim, size_type(0));
+        using swallow = int[];
+        (void) swallow{0, (e.derived_cast().broadcast_shape(shape), 0)...};
+        detail::resize_tiled(de1, shape, 0);
+
+        detail::tiled_assign_impl(de1, f, std::tuple<const E&...>(e.derived_cast()...),
+                                  std::make_index_sequence<sizeof...(E)>());
+    }
+
+    /***************************************************
+     * reduce_lanes and transform_lanes implementation *
+     ***************************************************/
+
+    namespace detail
+    {
+        template <class R>
+        inline auto lane_value(const R& r, std::true_type /*is_xexpression*/)
+        {
+            return r();
+        }
+
+        template <class R>
+        inline const R& lane_value(const R& r, std::false_type /*is_xexpression*/)
+        {
+            return r;
+        }
+
+        // Calls f for the slabs of lanes of e. The slab of the outer index o
+        // holds its lanes, i.e. the axis and the dimensions after it, and is
+        // read from e in row major order once. Lanes are gathered in a
+        // contiguous buffer, unless the axis is the last one. With R != void,
+        // f also gets buffers for an output lane and an output slab.
+        template <class R, class E, class F>
+        inline void run_lanes(const E& e, std::size_t axis, F&& f)
+        {
+            using value_type = typename E::value_type;
+            using result_type = std::conditional_t<std::is_void<R>::value, value_type, R>;
+            using difference_type = std::ptrdiff_t;
+            constexpr bool has_output = !std::is_void<R>::value;
+
+            if (axis >= e.dimension())
+            {
+                throw std::runtime_error("lanes: axis out of bounds");
+            }
+            std::size_t outer = 1;
+            std::size_t inner = 1;
+            for (std::size_t i = 0; i < axis; ++i)
+            {
+                outer *= e.shape()[i];
+            }
+            for (std::size_t i = axis + 1; i < e.dimension(); ++i)
+            {
+                inner *= e.shape()[i];
+            }
+            std::size_t length = e.shape()[axis];
+            std::size_t slab_size = length * inner;
+
+            auto run_slabs = [&](std::size_t first, std::size_t last)
+            {
+                uvector<value_type> slab(slab_size);
+                uvector<value_type> lane(inner == 1 ? 0 : length);
+                uvector<result_type> out_lane(has_output ? length : 0);
+                uvector<result_type> out_slab(has_output && inner != 1 ? slab_size : 0);
+                auto it = e.template cbegin<layout_type::row_major>() + static_cast<difference_type>(first * slab_size);
+                for (std::size_t o = first; o < last; ++o)
+                {
+                    it = std::copy_n(it, slab_size, slab.begin());
+                    f(o, inner, length, slab, lane, out_lane, out_slab);
+                }
+            };
+
+#if defined(XTENSOR_PARALLEL_ENABLED)
+            if (parallel::use_parallel(e.size()))
+            {
+                parallel_for(std::size_t(0), outer, parallel::grain(slab_size, 1), run_slabs);
+                return;
+            }
+#endif
+            run_slabs(std::size_t(0), outer);
+        }
+
+        template <class T>
+        inline auto gather_lane(std::size_t inner, std::size_t length, uvector<T>& slab, uvector<T>& lane, std::size_t q)
+        {
+            if (inner == 1)
+            {
+                return make_tile(slab, length);
+            }
+            for (std::size_t j = 0; j < length; ++j)
+            {
+                lane[j] = slab[j * inner + q];
+            }
+            return make_tile(lane, length);
+        }
+    }
+
+    /**
+     * @brief Reduces the lanes of \c e along \c axis with \c f.
+     *
+     * Each lane is copied once in a contiguous buffer, a one-dimensional
+     * tensor holding this buffer is passed to \c f, and the value or the
+     * 0-D expression returned by \c f is stored in \c e1. \c e1 is resized
+     * to the shape of \c e without \c axis (a view must already have this
+     * shape). Pipelines reducing a lane several times then read it from the
+     * cache instead of evaluating \c e again:
+     *
+     * \code{.cpp}
+     * // denominators of the softmax of the rows of a
+     * xt::reduce_lanes(d, a, 1, [](auto&& row) { return xt::sum(xt::exp(row - xt::amax(row)())); });
+     * \endcode
+     *
+     * @param e1 the expression to assign to
+     * @param e the expression whose lanes are reduced
+     * @param axis the axis of the lanes
+     * @param f the reduction of a lane
+     */
+    template <class E1, class E, class F>
+    inline void reduce_lanes(xexpression<E1>& e1, const xexpression<E>& e, std::size_t axis, F&& f)
+    {
+        using size_type = typename E1::size_type;
+        using difference_type = std::ptrdiff_t;
+        E1& de1 = e1.derived_cast();
+        const E& de = e.derived_cast();
+
+        dynamic_shape<size_type> shape;
+        for (std::size_t i = 0; i < de.dimension(); ++i)
+        {
+            if (i != axis)
+            {
+                shape.push_back(static_cast<size_type>(de.shape()[i]));
+            }
+        }
+        if (axis < de.dimension())
+        {
+            detail::resize_tiled(de1, shape, 0);
+        }
+
+        detail::run_lanes<void>(de, axis, [&](std::size_t o, std::size_t inner, std::size_t length,
+                                              auto& slab, auto& lane, auto& /*out_lane*/, auto& /*out_slab*/)
+        {
+            auto out = de1.template begin<layout_type::row_major>() + static_cast<difference_type>(o * inner);
+            for (std::size_t q = 0; q < inner; ++q, ++out)
+            {
+                // the tile must outlive the expression returned by f
+                auto tile = detail::gather_lane(inner, length, slab, lane, q);
+                auto r = f(tile);
+                *out = detail::lane_value(r, is_xexpression<decltype(r)>());
+            }
+        });
+    }
+
+    /**
+     * @brief Assigns to the lanes of \c e1 along \c axis the result of \c f
+     * applied to the lanes of \c e.
+     *
+     * Each lane is copied once in a contiguous buffer, and \c f must return
+     * a one-dimensional expression of the tensor holding it, with the length
+     * of the lane. \c e1 is resized to the shape of \c e (a view must already
+     * have this shape). Reductions of the lane used by the result are then
+     * evaluated once per lane:
+     *
+     * \code{.cpp}
+     * // softmax of the rows of a
+     * xt::transform_lanes(s, a, 1, [](auto&& row)
+     * {
+     *     auto ex = xt::exp(row - xt::amax(row)());
+     *     return xt::eval(ex / xt::sum(ex)());
+     * });
+     * \endcode
+     *
+     * @param e1 the expression to assign to
+     * @param e the expression whose lanes are transformed
+     * @param axis the axis of the lanes
+     * @param f the transformation of a lane
+     */
+    template <class E1, class E, class F>
+    inline void transform_lanes(xexpression<E1>& e1, const xexpression<E>& e, std::size_t axis, F&& f)
+    {
+        using value_type = typename E1::value_type;
+        using difference_type = std::ptrdiff_t;
+        E1& de1 = e1.derived_cast();
+        const E& de = e.derived_cast();
+
+        dynamic_shape<typename E1::size_type> shape(de.shape().cbegin(), de.shape().cend());
+        detail::resize_tiled(de1, shape, 0);
+
+        detail::run_lanes<value_type>(de, axis, [&](std::size_t o, std::size_t inner, std::size_t length,
+                                                    auto& slab, auto& lane, auto& out_lane, auto& out_slab)
+        {
+            for (std::size_t q = 0; q < inner; ++q)
+            {
+                auto res_tile = detail::make_tile(out_lane, length);
+                noalias(res_tile) = f(detail::gather_lane(inner, length, slab, lane, q));
+                for (std::size_t j = 0; inner != 1 && j < length; ++j)
+                {
+                    out_slab[j * inner + q] = out_lane[j];
+                }
+            }
+            auto out = de1.template begin<layout_type::row_major>() + static_cast<difference_type>(o * length * inner);
+            const auto& src = inner == 1 ? out_lane : out_slab;
+            std::copy(src.cbegin(), src.cend(), out);
+        });
+    }
+}
+
+#endif
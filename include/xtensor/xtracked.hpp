@@ -0,0 +1,644 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_TRACKED_HPP
+#define XTENSOR_TRACKED_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <xtl/xtype_traits.hpp>
+
+#include "xexpression.hpp"
+#include "xparallel.hpp"
+#include "xslice.hpp"
+#include "xutils.hpp"
+#include "xview.hpp"
+
+namespace xt
+{
+
+    /************
+     * xtracked *
+     ************/
+
+    template <class C>
+    class xtracked;
+
+    template <class C0, class E, class C, class... CS>
+    void incremental_assign(xtracked<C0>& out, const xexpression<E>& e,
+                            const xtracked<C>& input, const xtracked<CS>&... inputs);
+
+    /**
+     * @class xtracked
+     * @brief Container recording the blocks that have been modified.
+     *
+     * The xtracked class owns a container split in blocks of the same
+     * shape, the blocks on the upper edges being smaller, and flags the
+     * blocks that are written through its interface: the views returned by
+     * region() mark the blocks they cover, a full assignment marks all of
+     * them. The container is read through get(). \ref incremental_assign
+     * then re-evaluates an elementwise expression of tracked containers on
+     * their dirty blocks only, and clear_dirty() resets the flags once all
+     * the dependent arrays have been updated.
+     *
+     * \code{.cpp}
+     * xt::xtracked<xt::xarray<double>> a(xt::zeros<double>({1024, 1024}), {64, 64});
+     * xt::xarray<double> b = 2. * a.get();
+     * a.region(3, xt::range(100, 120)) = 1.;
+     * xt::incremental_assign(b, 2. * a.get(), a); // computes one block
+     * a.clear_dirty();
+     * \endcode
+     *
+     * @tparam C the type of the container
+     */
+    template <class C>
+    class xtracked
+    {
+    public:
+
+        using container_type = C;
+        using value_type = typename container_type::value_type;
+        using const_reference = typename container_type::const_reference;
+        using size_type = typename container_type::size_type;
+        using inner_shape_type = typename container_type::inner_shape_type;
+        using block_shape_type = std::vector<size_type>;
+
+        template <class S>
+        xtracked(container_type c, const S& block_shape);
+
+        template <class I, std::size_t N>
+        xtracked(container_type c, const I (&block_shape)[N]);
+
+        template <class E>
+        xtracked& operator=(const xexpression<E>& e);
+
+        const container_type& get() const noexcept;
+
+        size_type dimension() const noexcept;
+        const inner_shape_type& shape() const noexcept;
+        const block_shape_type& block_shape() const noexcept;
+        const block_shape_type& grid_shape() const noexcept;
+
+        template <class... Args>
+        const_reference operator()(Args... args) const;
+
+        template <class... S>
+        auto region(S&&... slices);
+
+        void mark_dirty();
+
+        template <class... S>
+        void mark_dirty(S&&... slices);
+
+        template <class O>
+        void mark_box(const O& origin, const O& box);
+
+        void clear_dirty() noexcept;
+
+        bool is_dirty() const noexcept;
+        bool is_dirty(size_type block) const;
+        size_type block_count() const noexcept;
+        std::vector<size_type> dirty_blocks() const;
+
+        template <class O>
+        void block_box(size_type block, O& origin, O& box) const;
+
+    private:
+
+        void init_blocks();
+
+        template <class V>
+        void mark_view(const V& v);
+
+        void mark_product(const std::vector<std::vector<size_type>>& blocks);
+
+        container_type m_container;
+        block_shape_type m_block_shape;
+        block_shape_type m_grid_shape;
+        std::vector<bool> m_dirty;
+
+        template <class C0, class E, class C1, class... CS>
+        friend void incremental_assign(xtracked<C0>& out, const xexpression<E>& e,
+                                       const xtracked<C1>& input, const xtracked<CS>&... inputs);
+    };
+
+    template <class E1, class E2, class C, class... CS>
+    void incremental_assign(xexpression<E1>& out, const xexpression<E2>& e,
+                            const xtracked<C>& input, const xtracked<CS>&... inputs);
+
+    /***************************
+     * xtracked implementation *
+     ***************************/
+
+    namespace detail
+    {
+        // Adds the blocks along the axis dim holding the indices selected by
+        // a slice of a view, newaxis does not consume an axis.
+        template <class T, class B>
+        inline std::enable_if_t<xtl::is_integral<T>::value>
+        tracked_select(const T& s, std::vector<std::vector<std::size_t>>& blocks, const B& block_shape, std::size_t& dim)
+        {
+            blocks[dim].assign(1, static_cast<std::size_t>(s) / block_shape[dim]);
+            ++dim;
+        }
+
+        template <class T, class B>
+        inline void tracked_select(const xnewaxis<T>&, std::vector<std::vector<std::size_t>>&, const B&, std::size_t&)
+        {
+        }
+
+        template <class SL, class B>
+        inline std::enable_if_t<!xtl::is_integral<SL>::value>
+        tracked_select(const SL& s, std::vector<std::vector<std::size_t>>& blocks, const B& block_shape, std::size_t& dim)
+        {
+            std::vector<std::size_t>& b = blocks[dim];
+            b.clear();
+            for (std::size_t i = 0; i != static_cast<std::size_t>(s.size()); ++i)
+            {
+                b.push_back(static_cast<std::size_t>(s(i)) / block_shape[dim]);
+            }
+            std::sort(b.begin(), b.end());
+            b.erase(std::unique(b.begin(), b.end()), b.end());
+            ++dim;
+        }
+
+        // Assigns the box of e starting at origin to the same box of out,
+        // e having the shape of out.
+        template <class E1, class E2, class O>
+        inline void assign_box(E1& out, const E2& e, const O& origin, const O& box)
+        {
+            using value_type = typename E1::value_type;
+
+            const auto& shape = out.shape();
+            std::size_t dim = box.size();
+            auto dst = out.stepper_begin(shape);
+            auto src = e.stepper_begin(shape);
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                dst.step(d, origin[d]);
+                src.step(d, origin[d]);
+            }
+            if (dim == 0)
+            {
+                *dst = static_cast<value_type>(*src);
+                return;
+            }
+
+            std::size_t last = dim - 1;
+            std::size_t inner = box[last];
+            std::size_t outer = compute_size(box) / inner;
+            std::vector<std::size_t> index(dim, std::size_t(0));
+            for (std::size_t o = 0; o < outer; ++o)
+            {
+                for (std::size_t i = 0; i < inner; ++i)
+                {
+                    *dst = static_cast<value_type>(*src);
+                    dst.step(last);
+                    src.step(last);
+                }
+                dst.step_back(last, inner);
+                src.step_back(last, inner);
+                for (std::size_t d = last; d > 0; --d)
+                {
+                    if (++index[d - 1] < box[d - 1])
+                    {
+                        dst.step(d - 1);
+                        src.step(d - 1);
+                        break;
+                    }
+                    index[d - 1] = 0;
+                    dst.step_back(d - 1, box[d - 1] - 1);
+                    src.step_back(d - 1, box[d - 1] - 1);
+                }
+            }
+        }
+
+        template <class C>
+        inline void tracked_union(std::vector<bool>& dirty, const xtracked<C>& t)
+        {
+            for (auto block : t.dirty_blocks())
+            {
+                dirty[block] = true;
+            }
+        }
+
+        // Checks the tracked operands, returns false if out has to be
+        // assigned in full, fills blocks with the dirty blocks otherwise.
+        template <class S, class E, class C, class... CS>
+        inline bool tracked_dirty_blocks(const S& out_shape, const E& e, std::vector<std::size_t>& blocks,
+                                         const xtracked<C>& input, const xtracked<CS>&... inputs)
+        {
+            bool shapes = same_shape(input.shape(), e.shape());
+            bool block_shapes = true;
+            for_each([&](const auto& t) {
+                shapes = shapes && same_shape(t.shape(), e.shape());
+                block_shapes = block_shapes && t.block_shape() == input.block_shape();
+            }, std::forward_as_tuple(inputs...));
+            if (!shapes || !block_shapes)
+            {
+                throw std::runtime_error("incremental_assign: the tracked operands must have the shape of the expression and the same block shape");
+            }
+            if (!same_shape(out_shape, e.shape()))
+            {
+                return false;
+            }
+
+            std::vector<bool> dirty(input.block_count(), false);
+            tracked_union(dirty, input);
+            for_each([&dirty](const auto& t) { tracked_union(dirty, t); }, std::forward_as_tuple(inputs...));
+            blocks.clear();
+            for (std::size_t i = 0; i != dirty.size(); ++i)
+            {
+                if (dirty[i])
+                {
+                    blocks.push_back(i);
+                }
+            }
+            return true;
+        }
+
+        // Assigns the blocks of e to out, in parallel over the blocks when
+        // XTENSOR_PARALLEL_ENABLED is defined.
+        template <class E1, class E2, class C>
+        inline void assign_tracked_blocks(E1& out, const E2& e, const xtracked<C>& input,
+                                          const std::vector<std::size_t>& blocks)
+        {
+            auto assign_range = [&](std::size_t first, std::size_t last)
+            {
+                std::vector<std::size_t> origin, box;
+                for (std::size_t i = first; i != last; ++i)
+                {
+                    input.block_box(blocks[i], origin, box);
+                    assign_box(out, e, origin, box);
+                }
+            };
+#if defined(XTENSOR_PARALLEL_ENABLED)
+            std::size_t block_size = compute_size(input.block_shape());
+            if (blocks.size() > 1 && parallel::use_parallel(blocks.size() * block_size))
+            {
+                parallel_for(std::size_t(0), blocks.size(), parallel::grain(block_size), assign_range);
+                return;
+            }
+#endif
+            assign_range(std::size_t(0), blocks.size());
+        }
+    }
+
+    /**
+     * @name Constructors
+     */
+    //@{
+    /**
+     * Wraps the container \c c, split in blocks of shape \c block_shape.
+     * No block is dirty.
+     * @param c the container
+     * @param block_shape the shape of the blocks
+     * @throw std::runtime_error if the block shape has a different dimension
+     * from the container or a zero extent.
+     */
+    template <class C>
+    template <class S>
+    inline xtracked<C>::xtracked(container_type c, const S& block_shape)
+        : m_container(std::move(c)), m_block_shape(block_shape.cbegin(), block_shape.cend())
+    {
+        init_blocks();
+    }
+
+    template <class C>
+    template <class I, std::size_t N>
+    inline xtracked<C>::xtracked(container_type c, const I (&block_shape)[N])
+        : m_container(std::move(c)), m_block_shape(block_shape, block_shape + N)
+    {
+        init_blocks();
+    }
+    //@}
+
+    /**
+     * Assigns \c e to the container and marks all the blocks.
+     * @throw std::runtime_error if the dimension of the container changes.
+     */
+    template <class C>
+    template <class E>
+    inline auto xtracked<C>::operator=(const xexpression<E>& e) -> xtracked&
+    {
+        m_container = e;
+        init_blocks();
+        mark_dirty();
+        return *this;
+    }
+
+    /**
+     * Returns a constant reference to the container.
+     */
+    template <class C>
+    inline auto xtracked<C>::get() const noexcept -> const container_type&
+    {
+        return m_container;
+    }
+
+    template <class C>
+    inline auto xtracked<C>::dimension() const noexcept -> size_type
+    {
+        return m_container.dimension();
+    }
+
+    template <class C>
+    inline auto xtracked<C>::shape() const noexcept -> const inner_shape_type&
+    {
+        return m_container.shape();
+    }
+
+    template <class C>
+    inline auto xtracked<C>::block_shape() const noexcept -> const block_shape_type&
+    {
+        return m_block_shape;
+    }
+
+    /**
+     * Returns the number of blocks along each axis.
+     */
+    template <class C>
+    inline auto xtracked<C>::grid_shape() const noexcept -> const block_shape_type&
+    {
+        return m_grid_shape;
+    }
+
+    template <class C>
+    template <class... Args>
+    inline auto xtracked<C>::operator()(Args... args) const -> const_reference
+    {
+        return m_container(args...);
+    }
+
+    /**
+     * Returns a view on the container and marks the blocks it covers,
+     * whether they are written or not.
+     * @param slices the slices of the view, see \ref view
+     */
+    template <class C>
+    template <class... S>
+    inline auto xtracked<C>::region(S&&... slices)
+    {
+        auto v = view(m_container, std::forward<S>(slices)...);
+        mark_view(v);
+        return v;
+    }
+
+    /**
+     * Marks all the blocks.
+     */
+    template <class C>
+    inline void xtracked<C>::mark_dirty()
+    {
+        std::fill(m_dirty.begin(), m_dirty.end(), true);
+    }
+
+    /**
+     * Marks the blocks covered by the view of the container with the
+     * specified slices, after the container has been modified in a way
+     * that xtracked cannot see.
+     */
+    template <class C>
+    template <class... S>
+    inline void xtracked<C>::mark_dirty(S&&... slices)
+    {
+        mark_view(view(m_container, std::forward<S>(slices)...));
+    }
+
+    /**
+     * Marks the blocks intersecting the box of shape \c box starting at
+     * \c origin.
+     */
+    template <class C>
+    template <class O>
+    inline void xtracked<C>::mark_box(const O& origin, const O& box)
+    {
+        std::vector<std::vector<size_type>> blocks(m_block_shape.size());
+        for (std::size_t d = 0; d != blocks.size(); ++d)
+        {
+            if (box[d] == 0)
+            {
+                return;
+            }
+            size_type first = static_cast<size_type>(origin[d]) / m_block_shape[d];
+            size_type last = (static_cast<size_type>(origin[d] + box[d]) - 1) / m_block_shape[d];
+            for (size_type b = first; b <= last; ++b)
+            {
+                blocks[d].push_back(b);
+            }
+        }
+        mark_product(blocks);
+    }
+
+    /**
+     * Resets the flags of all the blocks.
+     */
+    template <class C>
+    inline void xtracked<C>::clear_dirty() noexcept
+    {
+        std::fill(m_dirty.begin(), m_dirty.end(), false);
+    }
+
+    /**
+     * Returns true if a block is dirty.
+     */
+    template <class C>
+    inline bool xtracked<C>::is_dirty() const noexcept
+    {
+        return std::find(m_dirty.cbegin(), m_dirty.cend(), true) != m_dirty.cend();
+    }
+
+    /**
+     * Returns true if the block of index \c block, in the row-major order
+     * of the grid, is dirty.
+     */
+    template <class C>
+    inline bool xtracked<C>::is_dirty(size_type block) const
+    {
+        return m_dirty[block];
+    }
+
+    template <class C>
+    inline auto xtracked<C>::block_count() const noexcept -> size_type
+    {
+        return m_dirty.size();
+    }
+
+    /**
+     * Returns the indices of the dirty blocks, in the row-major order of
+     * the grid.
+     */
+    template <class C>
+    inline auto xtracked<C>::dirty_blocks() const -> std::vector<size_type>
+    {
+        std::vector<size_type> res;
+        for (size_type i = 0; i != m_dirty.size(); ++i)
+        {
+            if (m_dirty[i])
+            {
+                res.push_back(i);
+            }
+        }
+        return res;
+    }
+
+    /**
+     * Computes the origin and the shape of the block of index \c block.
+     */
+    template <class C>
+    template <class O>
+    inline void xtracked<C>::block_box(size_type block, O& origin, O& box) const
+    {
+        std::size_t dim = m_grid_shape.size();
+        origin.resize(dim);
+        box.resize(dim);
+        for (std::size_t d = dim; d != 0; --d)
+        {
+            size_type b = block % m_grid_shape[d - 1];
+            block /= m_grid_shape[d - 1];
+            origin[d - 1] = b * m_block_shape[d - 1];
+            box[d - 1] = std::min(m_block_shape[d - 1], static_cast<size_type>(shape()[d - 1]) - origin[d - 1]);
+        }
+    }
+
+    template <class C>
+    inline void xtracked<C>::init_blocks()
+    {
+        std::size_t dim = m_container.dimension();
+        if (m_block_shape.size() != dim ||
+            std::find(m_block_shape.cbegin(), m_block_shape.cend(), size_type(0)) != m_block_shape.cend())
+        {
+            throw std::runtime_error("xtracked: the block shape must have the dimension of the container and no zero extent");
+        }
+        m_grid_shape.resize(dim);
+        for (std::size_t d = 0; d != dim; ++d)
+        {
+            size_type n = static_cast<size_type>(shape()[d]);
+            m_grid_shape[d] = (n + m_block_shape[d] - 1) / m_block_shape[d];
+        }
+        m_dirty.assign(compute_size(m_grid_shape), false);
+    }
+
+    template <class C>
+    template <class V>
+    inline void xtracked<C>::mark_view(const V& v)
+    {
+        std::vector<std::vector<size_type>> blocks(m_block_shape.size());
+        std::size_t dim = 0;
+        for_each([&](const auto& s) { detail::tracked_select(s, blocks, m_block_shape, dim); }, v.slices());
+        for (; dim != blocks.size(); ++dim)
+        {
+            blocks[dim].resize(m_grid_shape[dim]);
+            std::iota(blocks[dim].begin(), blocks[dim].end(), size_type(0));
+        }
+        mark_product(blocks);
+    }
+
+    // Marks the blocks whose indices along each axis are in blocks
+    template <class C>
+    inline void xtracked<C>::mark_product(const std::vector<std::vector<size_type>>& blocks)
+    {
+        std::size_t dim = blocks.size();
+        for (const auto& b : blocks)
+        {
+            if (b.empty())
+            {
+                return;
+            }
+        }
+        std::vector<std::size_t> index(dim, std::size_t(0));
+        while (true)
+        {
+            size_type flat = 0;
+            for (std::size_t d = 0; d != dim; ++d)
+            {
+                flat = flat * m_grid_shape[d] + blocks[d][index[d]];
+            }
+            m_dirty[flat] = true;
+
+            std::size_t d = dim;
+            while (d != 0 && ++index[d - 1] == blocks[d - 1].size())
+            {
+                index[d - 1] = 0;
+                --d;
+            }
+            if (d == 0)
+            {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @name Incremental assignment
+     */
+    //@{
+    /**
+     * Re-evaluates the elementwise expression \c e on the dirty blocks of
+     * the tracked operands of the expression only. \c out must hold the
+     * result of the previous evaluation of \c e; if its shape is not the
+     * shape of \c e, it is assigned in full instead. The flags of the
+     * operands are not reset, so that other arrays depending on them can be
+     * updated before clear_dirty() is called. The expression must not
+     * involve \c out, nor values at other positions than the one being
+     * computed, such as reductions or views shifting their operand.
+     * @param out the container to update
+     * @param e the elementwise expression
+     * @param input the tracked operands of \c e, read through get()
+     * @throw std::runtime_error if the operands do not have the shape of
+     * \c e or have different block shapes.
+     */
+    template <class E1, class E2, class C, class... CS>
+    inline void incremental_assign(xexpression<E1>& out, const xexpression<E2>& e,
+                                   const xtracked<C>& input, const xtracked<CS>&... inputs)
+    {
+        E1& dout = out.derived_cast();
+        const E2& de = e.derived_cast();
+        std::vector<std::size_t> blocks;
+        if (!detail::tracked_dirty_blocks(dout.shape(), de, blocks, input, inputs...))
+        {
+            dout = de;
+            return;
+        }
+        detail::assign_tracked_blocks(dout, de, input, blocks);
+    }
+
+    /**
+     * Version of incremental_assign updating a tracked container, whose
+     * blocks intersecting the recomputed ones are marked, so that the
+     * arrays depending on it can be updated in turn.
+     */
+    template <class C0, class E, class C, class... CS>
+    inline void incremental_assign(xtracked<C0>& out, const xexpression<E>& e,
+                                   const xtracked<C>& input, const xtracked<CS>&... inputs)
+    {
+        const E& de = e.derived_cast();
+        std::vector<std::size_t> blocks;
+        if (!detail::tracked_dirty_blocks(out.shape(), de, blocks, input, inputs...))
+        {
+            out = de;
+            return;
+        }
+        detail::assign_tracked_blocks(out.m_container, de, input, blocks);
+        std::vector<std::size_t> origin, box;
+        for (auto block : blocks)
+        {
+            input.block_box(block, origin, box);
+            out.mark_box(origin, box);
+        }
+    }
+    //@}
+}
+
+#endif
@@ -11,13 +11,21 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cmath>
 #include <complex>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <initializer_list>
 #include <iostream>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <string>
 #include <tuple>
 #include <type_traits>
+#include <typeinfo>
 #include <utility>
 #include <vector>
 
@@ -28,6 +36,14 @@
 
 #include "xtensor_config.hpp"
 
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#endif
+
+#if defined(XTENSOR_USE_NUMA)
+#include <numa.h>
+#endif
+
 namespace xt
 {
     /****************
@@ -659,6 +675,110 @@ namespace xt
         return N;
     }
 
+    /*********************************
+     * element_conversion definition *
+     *********************************/
+
+    namespace detail
+    {
+        template <class T>
+        using is_saturating_arithmetic = std::integral_constant<bool, std::is_arithmetic<T>::value &&
+                                                                      !std::is_same<T, bool>::value>;
+
+        // whether all the values of the integral type S are values of D
+        template <class D, class S>
+        using is_integral_subrange = std::integral_constant<bool, (std::is_signed<D>::value || !std::is_signed<S>::value) &&
+                                                                  std::numeric_limits<S>::digits <= std::numeric_limits<D>::digits>;
+
+        /**
+         * Whether the conversion of a value of type S to the integral type D
+         * saturates to the bounds of D, i.e. whether S is a floating point
+         * type or an integral type with values that D cannot represent.
+         * Specialized by the headers of other arithmetic types.
+         */
+        template <class D, class S, class = void>
+        struct is_saturating_conversion : std::false_type
+        {
+        };
+
+        template <class D, class S>
+        struct is_saturating_conversion<D, S, std::enable_if_t<std::is_integral<D>::value && is_saturating_arithmetic<D>::value &&
+                                                               is_saturating_arithmetic<S>::value && !std::is_same<D, S>::value &&
+                                                               (std::is_floating_point<S>::value ||
+                                                                !is_integral_subrange<D, S>::value)>>
+            : std::true_type
+        {
+        };
+
+        template <class D, class S, class = void>
+        struct element_conversion
+        {
+            static constexpr D apply(const S& v) noexcept
+            {
+                return static_cast<D>(v);
+            }
+        };
+
+        // Converting an out of range floating point value to an integral
+        // type is undefined; the value saturates instead, NaN giving 0
+        template <class D, class S>
+        struct element_conversion<D, S, std::enable_if_t<is_saturating_conversion<D, S>::value &&
+                                                         std::is_floating_point<S>::value>>
+        {
+            static constexpr D apply(const S& v) noexcept
+            {
+                using limits = std::numeric_limits<D>;
+                // 2^digits is exact in S, its predecessor may not be
+                return v != v ? D(0) :
+                       v < static_cast<S>((limits::min)()) ? (limits::min)() :
+                       v >= static_cast<S>((limits::max)() / 2 + 1) * S(2) ? (limits::max)() :
+                       static_cast<D>(v);
+            }
+        };
+
+        // Integral values out of the range of a narrower integral type
+        // saturate to its bounds instead of wrapping around
+        template <class D, class S>
+        struct element_conversion<D, S, std::enable_if_t<is_saturating_conversion<D, S>::value &&
+                                                         std::is_integral<S>::value>>
+        {
+            static constexpr D apply(const S& v) noexcept
+            {
+                using limits = std::numeric_limits<D>;
+                return std::is_signed<S>::value && static_cast<std::intmax_t>(v) < static_cast<std::intmax_t>((limits::min)()) ?
+                           (limits::min)() :
+                       !(std::is_signed<S>::value && static_cast<std::intmax_t>(v) < 0) &&
+                               static_cast<std::uintmax_t>(v) > static_cast<std::uintmax_t>((limits::max)()) ?
+                           (limits::max)() :
+                           static_cast<D>(v);
+            }
+        };
+
+        template <class D, class S>
+        constexpr D convert_element_impl(S&& v, std::true_type /*saturating*/) noexcept
+        {
+            return element_conversion<D, std::decay_t<S>>::apply(v);
+        }
+
+        template <class D, class S>
+        constexpr D convert_element_impl(S&& v, std::false_type /*saturating*/)
+        {
+            return static_cast<D>(std::forward<S>(v));
+        }
+
+        /**
+         * Converts an element to the value type D of a destination: like
+         * static_cast, except for the saturating conversions (see
+         * is_saturating_conversion). All the assignment loops convert
+         * their elements with this function.
+         */
+        template <class D, class S>
+        constexpr D convert_element(S&& v)
+        {
+            return convert_element_impl<D>(std::forward<S>(v), is_saturating_conversion<D, std::decay_t<S>>());
+        }
+    }
+
     /*************************************
      * has_data_interface implementation *
      *************************************/
@@ -685,6 +805,54 @@ namespace xt
     {
     };
 
+    /************
+     * prefetch *
+     ************/
+
+    namespace detail
+    {
+        // Number of elements ahead of the loops over strided or indexed
+        // data whose memory is prefetched
+        constexpr std::size_t prefetch_distance = XTENSOR_PREFETCH_DISTANCE;
+
+        // The hardware prefetchers do not follow accesses crossing a page
+        // at every step: strides of at least a page are prefetched in
+        // software
+        constexpr std::size_t prefetch_min_stride_bytes = XTENSOR_PAGE_SIZE;
+
+        // The expressions smaller than this number of bytes are assumed to
+        // fit in the caches
+        constexpr std::size_t prefetch_min_bytes = std::size_t(1) << 21;
+
+        template <class T>
+        inline void prefetch_read(const T* p) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(p, 0, 0);
+#else
+            (void)p;
+#endif
+        }
+
+        template <class T>
+        inline void prefetch_write(T* p) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(p, 1, 0);
+#else
+            (void)p;
+#endif
+        }
+
+        template <class T>
+        inline bool use_stride_prefetch(std::ptrdiff_t stride) noexcept
+        {
+            constexpr std::size_t min_stride = prefetch_min_stride_bytes / sizeof(T);
+            std::size_t abs_stride = static_cast<std::size_t>(stride < 0 ? -stride : stride);
+            return prefetch_distance != 0 && abs_stride >= (min_stride == 0 ? std::size_t(1) : min_stride);
+        }
+    }
+
     /******************
      * enable_if_type *
      ******************/
@@ -729,13 +897,14 @@ namespace xt
         template <class U>
         inline auto operator()(U&& u) const
         {
-            return static_cast<T>(std::forward<U>(u));
+            return detail::convert_element<T>(std::forward<U>(u));
         }
     };
 
     /**
      * @brief Perform a type cast when a condition is true.
-     * If <tt>condition</tt> is true, return <tt>static_cast<T>(u)</tt>,
+     * If <tt>condition</tt> is true, return <tt>static_cast<T>(u)</tt>, with
+     * the out of range values of a conversion to an integral type saturated,
      * otherwise return <tt>u</tt> unchanged. This is useful when an unconditional
      * static_cast would force undesired type conversions in some situations where
      * an error or warning would be desired. The condition determines when the
@@ -1086,7 +1255,164 @@ namespace xt
         enum policy
         {
             print,
-            assert
+            assert,
+            count
+        };
+
+        /**
+         * Counters of the allocations made through tracking allocators with
+         * the count policy, which are always updated, and of the requests
+         * of pool_allocator served from its caches (hits) or from the global
+         * operator new (misses), updated while tracking is enabled. The
+         * counters are relaxed atomics: they can be read at any time, by any
+         * thread.
+         */
+        struct statistics_type
+        {
+            std::atomic<std::size_t> allocations;
+            std::atomic<std::size_t> deallocations;
+            std::atomic<std::size_t> allocated_bytes;
+            std::atomic<std::size_t> live_bytes;
+            std::atomic<std::size_t> peak_bytes;
+            std::atomic<std::size_t> pool_hits;
+            std::atomic<std::size_t> pool_misses;
+        };
+
+        namespace detail
+        {
+            struct statistics_registry
+            {
+                std::mutex mutex;
+                std::vector<std::pair<std::string, statistics_type*>> entries;
+            };
+
+            inline statistics_registry& registry()
+            {
+                static statistics_registry instance;
+                return instance;
+            }
+
+            template <class T>
+            struct type_statistics
+            {
+                type_statistics()
+                {
+                    statistics_registry& reg = registry();
+                    std::lock_guard<std::mutex> lock(reg.mutex);
+                    reg.entries.emplace_back(typeid(T).name(), &stats);
+                }
+
+                statistics_type stats{};
+            };
+
+            inline void record_allocation(statistics_type& stats, std::size_t bytes) noexcept
+            {
+                stats.allocations.fetch_add(1, std::memory_order_relaxed);
+                stats.allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+                std::size_t live = stats.live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+                std::size_t peak = stats.peak_bytes.load(std::memory_order_relaxed);
+                while (live > peak && !stats.peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+                {
+                }
+            }
+
+            inline void record_deallocation(statistics_type& stats, std::size_t bytes) noexcept
+            {
+                stats.deallocations.fetch_add(1, std::memory_order_relaxed);
+                stats.live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+            }
+
+            inline void reset(statistics_type& stats) noexcept
+            {
+                stats.allocations = 0;
+                stats.deallocations = 0;
+                stats.allocated_bytes = 0;
+                stats.peak_bytes = stats.live_bytes.load();
+                stats.pool_hits = 0;
+                stats.pool_misses = 0;
+            }
+
+            inline std::size_t& no_allocation_depth()
+            {
+                static thread_local std::size_t depth = 0;
+                return depth;
+            }
+        }
+
+        /**
+         * Returns the counters of all the tracked allocations.
+         */
+        inline statistics_type& statistics()
+        {
+            static statistics_type stats;
+            return stats;
+        }
+
+        /**
+         * Returns the counters of the tracked allocations of elements of type T.
+         */
+        template <class T>
+        inline statistics_type& statistics()
+        {
+            static detail::type_statistics<T> instance;
+            return instance.stats;
+        }
+
+        /**
+         * Returns the counters of the tracked allocations per element type, as
+         * pairs of the name of the type (given by typeid) and its counters.
+         */
+        inline std::vector<std::pair<std::string, const statistics_type*>> statistics_by_type()
+        {
+            detail::statistics_registry& reg = detail::registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            return std::vector<std::pair<std::string, const statistics_type*>>(reg.entries.begin(), reg.entries.end());
+        }
+
+        /**
+         * Resets the counters; the peak is reset to the memory currently allocated.
+         */
+        inline void reset_statistics()
+        {
+            detail::reset(statistics());
+            detail::statistics_registry& reg = detail::registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            for (auto& entry : reg.entries)
+            {
+                detail::reset(*entry.second);
+            }
+        }
+
+        /**
+         * @class no_allocation_guard
+         * @brief Forbids the allocations through tracking allocators.
+         *
+         * While a guard is alive, any allocation of the calling thread through
+         * a tracking allocator, whatever its policy, throws a std::runtime_error.
+         *
+         * \code{.cpp}
+         * {
+         *     xt::alloc_tracking::no_allocation_guard guard;
+         *     xt::noalias(res) = a + b;
+         * }
+         * \endcode
+         */
+        class no_allocation_guard
+        {
+        public:
+
+            no_allocation_guard()
+            {
+                ++detail::no_allocation_depth();
+            }
+
+            ~no_allocation_guard()
+            {
+                --detail::no_allocation_depth();
+            }
+
+            no_allocation_guard(const no_allocation_guard&) = delete;
+            no_allocation_guard& operator=(const no_allocation_guard&) = delete;
         };
     }
 
@@ -1107,6 +1433,10 @@ namespace xt
 
         T* allocate(std::size_t n)
         {
+            if (alloc_tracking::detail::no_allocation_depth() != 0)
+            {
+                throw std::runtime_error("xtensor allocation of " + std::to_string(n) + " elements in a no_allocation_guard");
+            }
             if (alloc_tracking::enabled())
             {
                 if (P == alloc_tracking::print)
@@ -1118,10 +1448,25 @@ namespace xt
                     throw std::runtime_error("xtensor allocation of " + std::to_string(n) + " elements detected");
                 }
             }
-            return base_type::allocate(n);
+            T* res = base_type::allocate(n);
+            if (P == alloc_tracking::count)
+            {
+                alloc_tracking::detail::record_allocation(alloc_tracking::statistics(), n * sizeof(T));
+                alloc_tracking::detail::record_allocation(alloc_tracking::statistics<T>(), n * sizeof(T));
+            }
+            return res;
+        }
+
+        void deallocate(T* p, std::size_t n)
+        {
+            if (P == alloc_tracking::count)
+            {
+                alloc_tracking::detail::record_deallocation(alloc_tracking::statistics(), n * sizeof(T));
+                alloc_tracking::detail::record_deallocation(alloc_tracking::statistics<T>(), n * sizeof(T));
+            }
+            base_type::deallocate(p, n);
         }
 
-        using base_type::deallocate;
         using base_type::construct;
         using base_type::destroy;
 
@@ -1144,6 +1489,1094 @@ namespace xt
       return !(a == b);
     }
 
+    /**********************
+     * aligned allocation *
+     **********************/
+
+    namespace detail
+    {
+        // Alignment of the allocations of the allocators of xtensor that do
+        // not map pages, large enough for any SIMD instruction set supported
+        // by xsimd.
+        constexpr std::size_t allocation_alignment = 64;
+
+        inline char* align_allocation(char* p) noexcept
+        {
+            std::uintptr_t address = reinterpret_cast<std::uintptr_t>(p);
+            std::uintptr_t aligned = (address + allocation_alignment - 1) & ~std::uintptr_t(allocation_alignment - 1);
+            return p + (aligned - address);
+        }
+
+        // The address returned by operator new is stored right before the
+        // aligned block.
+        inline void* aligned_new(std::size_t size)
+        {
+            char* base = static_cast<char*>(::operator new(size + sizeof(void*) + allocation_alignment));
+            char* res = align_allocation(base + sizeof(void*));
+            std::memcpy(res - sizeof(void*), &base, sizeof(void*));
+            return res;
+        }
+
+        inline void aligned_delete(void* p) noexcept
+        {
+            void* base;
+            std::memcpy(&base, static_cast<char*>(p) - sizeof(void*), sizeof(void*));
+            ::operator delete(base);
+        }
+    }
+
+#if defined(XTENSOR_USE_NUMA)
+    /**
+     * Allocator interleaving the pages of its allocations of at least
+     * XTENSOR_NUMA_THRESHOLD bytes across the NUMA nodes of the machine,
+     * based on libnuma; this memory is page aligned. The smaller
+     * allocations, and all of them if NUMA is not available on the system,
+     * are aligned for the SIMD instructions and made with the global
+     * operator new.
+     */
+    template <class T>
+    struct numa_interleave_allocator
+    {
+        using value_type = T;
+        using reference = T&;
+        using const_reference = const T&;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        template <class U>
+        struct rebind
+        {
+            using other = numa_interleave_allocator<U>;
+        };
+
+        numa_interleave_allocator() noexcept = default;
+
+        template <class U>
+        numa_interleave_allocator(const numa_interleave_allocator<U>&) noexcept
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            if (n == 0)
+            {
+                return nullptr;
+            }
+            if (n > (std::size_t(-1) - sizeof(void*) - detail::allocation_alignment) / sizeof(T))
+            {
+                throw std::bad_alloc();
+            }
+            std::size_t size = n * sizeof(T);
+            if (!interleaved(size))
+            {
+                return static_cast<T*>(detail::aligned_new(size));
+            }
+            void* res = numa_alloc_interleaved(size);
+            if (res == nullptr)
+            {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(res);
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept
+        {
+            if (p == nullptr)
+            {
+                return;
+            }
+            std::size_t size = n * sizeof(T);
+            if (interleaved(size))
+            {
+                numa_free(p, size);
+            }
+            else
+            {
+                detail::aligned_delete(p);
+            }
+        }
+
+        template <class U, class... Args>
+        void construct(U* p, Args&&... args)
+        {
+            new ((void*)p) U(std::forward<Args>(args)...);
+        }
+
+        template <class U>
+        void destroy(U* p)
+        {
+            p->~U();
+        }
+
+    private:
+
+        static bool numa_enabled()
+        {
+            static const bool enabled = numa_available() >= 0;
+            return enabled;
+        }
+
+        static bool interleaved(std::size_t size)
+        {
+            return size >= XTENSOR_NUMA_THRESHOLD && numa_enabled();
+        }
+    };
+
+    template <class T, class U>
+    inline bool operator==(const numa_interleave_allocator<T>&, const numa_interleave_allocator<U>&)
+    {
+        return true;
+    }
+
+    template <class T, class U>
+    inline bool operator!=(const numa_interleave_allocator<T>&, const numa_interleave_allocator<U>&)
+    {
+        return false;
+    }
+#endif
+
+    /*******************
+     * arena_allocator *
+     *******************/
+
+    namespace detail
+    {
+        // Blocks of memory of an arena. The block counts its live allocations
+        // plus one while it belongs to an arena; it is freed when the count
+        // drops to zero, i.e. when the last of the allocations that outlive
+        // the arena_scope is deallocated.
+        struct arena_block
+        {
+            std::atomic<std::size_t> live;
+            std::size_t capacity;
+
+            char* data() noexcept
+            {
+                return reinterpret_cast<char*>(this + 1);
+            }
+        };
+
+        // Stored right before every allocation of arena_allocator: block is
+        // null for the allocations made outside of an arena_scope.
+        struct arena_header
+        {
+            arena_block* block;
+            void* base;
+        };
+
+        // Bytes of the arena taken by an allocation of size bytes, padding
+        // and header included
+        inline std::size_t arena_footprint(std::size_t size) noexcept
+        {
+            return size + sizeof(arena_header) + allocation_alignment;
+        }
+
+        class arena
+        {
+        public:
+
+            static arena& current()
+            {
+                static thread_local arena instance;
+                return instance;
+            }
+
+            arena() = default;
+            ~arena();
+
+            arena(const arena&) = delete;
+            arena& operator=(const arena&) = delete;
+
+            void enter() noexcept;
+            void leave() noexcept;
+
+            void reserve(std::size_t size);
+            void* allocate(std::size_t size);
+            static void deallocate(void* p) noexcept;
+
+        private:
+
+            static void release(arena_block* block) noexcept;
+            void add_block(std::size_t size);
+
+            std::vector<arena_block*> m_blocks;
+            std::size_t m_offset = 0;
+            std::size_t m_depth = 0;
+        };
+
+        inline arena::~arena()
+        {
+            for (arena_block* block : m_blocks)
+            {
+                release(block);
+            }
+        }
+
+        inline void arena::enter() noexcept
+        {
+            ++m_depth;
+        }
+
+        // Releases the memory of the arena when the outermost scope ends. The
+        // largest block is kept for the next scope if all its allocations are
+        // deallocated.
+        inline void arena::leave() noexcept
+        {
+            if (--m_depth != 0 || m_blocks.empty())
+            {
+                return;
+            }
+            arena_block* kept = m_blocks.back();
+            m_blocks.pop_back();
+            for (arena_block* block : m_blocks)
+            {
+                release(block);
+            }
+            m_blocks.clear();
+            if (kept->live.load(std::memory_order_acquire) == 1)
+            {
+                m_blocks.push_back(kept);
+            }
+            else
+            {
+                release(kept);
+            }
+            m_offset = 0;
+        }
+
+        // Makes sure that size bytes can be allocated from the current block;
+        // since the largest block is kept by leave, the reserved memory is
+        // reused by the next scopes of the thread.
+        inline void arena::reserve(std::size_t size)
+        {
+            if (m_blocks.empty() || m_blocks.back()->capacity - m_offset < size)
+            {
+                add_block(size);
+            }
+        }
+
+        inline void* arena::allocate(std::size_t size)
+        {
+            std::size_t needed = arena_footprint(size);
+            if (needed < size)
+            {
+                throw std::bad_alloc();
+            }
+            char* base;
+            arena_block* block = nullptr;
+            if (m_depth == 0)
+            {
+                base = static_cast<char*>(::operator new(needed));
+            }
+            else
+            {
+                if (m_blocks.empty() || m_blocks.back()->capacity - m_offset < needed)
+                {
+                    add_block(needed);
+                }
+                block = m_blocks.back();
+                base = block->data() + m_offset;
+            }
+            char* res = align_allocation(base + sizeof(arena_header));
+            if (block != nullptr)
+            {
+                m_offset = static_cast<std::size_t>(res + size - block->data());
+                block->live.fetch_add(1, std::memory_order_relaxed);
+            }
+            arena_header header = {block, base};
+            std::memcpy(res - sizeof(arena_header), &header, sizeof(arena_header));
+            return res;
+        }
+
+        inline void arena::deallocate(void* p) noexcept
+        {
+            arena_header header;
+            std::memcpy(&header, static_cast<char*>(p) - sizeof(arena_header), sizeof(arena_header));
+            if (header.block == nullptr)
+            {
+                ::operator delete(header.base);
+            }
+            else
+            {
+                release(header.block);
+            }
+        }
+
+        inline void arena::release(arena_block* block) noexcept
+        {
+            if (block->live.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                block->~arena_block();
+                ::operator delete(static_cast<void*>(block));
+            }
+        }
+
+        // The blocks grow geometrically, so that a scope allocating n bytes
+        // only needs O(log(n)) blocks.
+        inline void arena::add_block(std::size_t size)
+        {
+            std::size_t capacity = m_blocks.empty() ? std::size_t(XTENSOR_ARENA_BLOCK_SIZE) : 2 * m_blocks.back()->capacity;
+            capacity = std::max(capacity, size);
+            void* memory = ::operator new(sizeof(arena_block) + capacity);
+            arena_block* block = new (memory) arena_block;
+            block->live.store(1, std::memory_order_relaxed);
+            block->capacity = capacity;
+            m_blocks.push_back(block);
+            m_offset = 0;
+        }
+    }
+
+    /**
+     * @class arena_scope
+     * @brief Makes the arena allocators of the current thread allocate from an arena.
+     *
+     * While an arena_scope object is alive, the memory requested through
+     * arena_allocator by the calling thread is carved out of large blocks
+     * owned by a thread-local arena, and deallocating it is a no-op. The
+     * blocks are released at once when the outermost scope ends. Containers
+     * that outlive the scope remain valid: the blocks holding their memory
+     * are freed when they are destroyed.
+     *
+     * \code{.cpp}
+     * {
+     *     xt::arena_scope scope;
+     *     // the temporaries of eval, sort, accumulators and immediate
+     *     // reductions draw from the arena
+     *     process(request);
+     * }
+     * \endcode
+     *
+     * The scope can reserve the memory that the evaluations it runs are known
+     * to need, for instance from the arena_bytes of an \ref xmemory_plan, so
+     * that they draw from a single preallocated block. When the scope ends,
+     * the block is kept for the next scopes of the thread.
+     */
+    class arena_scope
+    {
+    public:
+
+        arena_scope()
+        {
+            detail::arena::current().enter();
+        }
+
+        explicit arena_scope(std::size_t reserved_bytes)
+        {
+            detail::arena::current().reserve(reserved_bytes);
+            detail::arena::current().enter();
+        }
+
+        ~arena_scope()
+        {
+            detail::arena::current().leave();
+        }
+
+        arena_scope(const arena_scope&) = delete;
+        arena_scope& operator=(const arena_scope&) = delete;
+    };
+
+    /**
+     * Allocator drawing from the arena of the calling thread while an
+     * arena_scope is active, and from the global operator new otherwise.
+     * The allocated memory is aligned on 64 bytes. It is the default
+     * allocator of the containers when XTENSOR_USE_ARENA is defined.
+     */
+    template <class T>
+    struct arena_allocator
+    {
+        using value_type = T;
+        using reference = T&;
+        using const_reference = const T&;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        template <class U>
+        struct rebind
+        {
+            using other = arena_allocator<U>;
+        };
+
+        arena_allocator() noexcept = default;
+
+        template <class U>
+        arena_allocator(const arena_allocator<U>&) noexcept
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            if (n == 0)
+            {
+                return nullptr;
+            }
+            if (n > std::size_t(-1) / sizeof(T))
+            {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(detail::arena::current().allocate(n * sizeof(T)));
+        }
+
+        void deallocate(T* p, std::size_t) noexcept
+        {
+            if (p != nullptr)
+            {
+                detail::arena::deallocate(p);
+            }
+        }
+
+        template <class U, class... Args>
+        void construct(U* p, Args&&... args)
+        {
+            new ((void*)p) U(std::forward<Args>(args)...);
+        }
+
+        template <class U>
+        void destroy(U* p)
+        {
+            p->~U();
+        }
+    };
+
+    template <class T, class U>
+    inline bool operator==(const arena_allocator<T>&, const arena_allocator<U>&)
+    {
+        return true;
+    }
+
+    template <class T, class U>
+    inline bool operator!=(const arena_allocator<T>&, const arena_allocator<U>&)
+    {
+        return false;
+    }
+
+    /******************
+     * pool_allocator *
+     ******************/
+
+    namespace detail
+    {
+        // Size classes of pool_allocator: 64 bytes, then four classes per
+        // power of two, which bounds the memory wasted by rounding to 25%.
+        constexpr std::size_t pool_min_class_bits = 6;
+        constexpr std::size_t pool_max_class_bits = XTENSOR_POOL_MAX_CLASS_BITS;
+        constexpr std::size_t pool_class_count = 1 + 4 * (pool_max_class_bits - pool_min_class_bits);
+
+        inline std::size_t pool_size_class(std::size_t size) noexcept
+        {
+            if (size <= (std::size_t(1) << pool_min_class_bits))
+            {
+                return 0;
+            }
+            std::size_t bits = pool_min_class_bits;
+            while ((std::size_t(1) << (bits + 1)) < size)
+            {
+                ++bits;
+            }
+            std::size_t step = std::size_t(1) << (bits - 2);
+            std::size_t k = (size - (std::size_t(1) << bits) + step - 1) / step;
+            return 1 + 4 * (bits - pool_min_class_bits) + (k - 1);
+        }
+
+        inline std::size_t pool_class_size(std::size_t index) noexcept
+        {
+            if (index == 0)
+            {
+                return std::size_t(1) << pool_min_class_bits;
+            }
+            std::size_t bits = pool_min_class_bits + (index - 1) / 4;
+            std::size_t k = (index - 1) % 4 + 1;
+            return (std::size_t(1) << bits) + k * (std::size_t(1) << (bits - 2));
+        }
+
+        // Free blocks shared by all the threads, they are exchanged with the
+        // thread caches in batches. The depot is never destroyed, so that
+        // containers with static storage duration can be destroyed safely.
+        class pool_depot
+        {
+        public:
+
+            static pool_depot& instance()
+            {
+                static pool_depot* depot = new pool_depot;
+                return *depot;
+            }
+
+            // moves up to count blocks of the class into list
+            void take(std::size_t index, std::vector<void*>& list, std::size_t count)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                std::vector<void*>& blocks = m_blocks[index];
+                std::size_t n = std::min(count, blocks.size());
+                list.insert(list.end(), blocks.end() - static_cast<std::ptrdiff_t>(n), blocks.end());
+                blocks.resize(blocks.size() - n);
+            }
+
+            // keeps the first blocks of list and moves the other ones to the
+            // depot, the blocks exceeding its capacity are freed
+            void give(std::size_t index, std::vector<void*>& list, std::size_t keep) noexcept
+            {
+                std::size_t n = list.size();
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    std::vector<void*>& blocks = m_blocks[index];
+                    while (n > keep && blocks.size() < XTENSOR_POOL_DEPOT_SIZE)
+                    {
+                        blocks.push_back(list[--n]);
+                    }
+                }
+                for (std::size_t i = keep; i < n; ++i)
+                {
+                    aligned_delete(list[i]);
+                }
+                list.resize(std::min(keep, list.size()));
+            }
+
+            void put(std::size_t index, void* p) noexcept
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    std::vector<void*>& blocks = m_blocks[index];
+                    if (blocks.size() < XTENSOR_POOL_DEPOT_SIZE)
+                    {
+                        blocks.push_back(p);
+                        return;
+                    }
+                }
+                aligned_delete(p);
+            }
+
+            void release() noexcept
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                for (auto& blocks : m_blocks)
+                {
+                    for (void* p : blocks)
+                    {
+                        aligned_delete(p);
+                    }
+                    blocks.clear();
+                }
+            }
+
+        private:
+
+            pool_depot()
+            {
+                for (auto& blocks : m_blocks)
+                {
+                    blocks.reserve(XTENSOR_POOL_DEPOT_SIZE);
+                }
+            }
+
+            std::mutex m_mutex;
+            std::array<std::vector<void*>, pool_class_count> m_blocks;
+        };
+
+        // Per-thread cache of free blocks: allocations and deallocations do
+        // not lock as long as the cache holds between 0 and
+        // XTENSOR_POOL_CACHE_SIZE blocks of the class.
+        class pool_cache
+        {
+        public:
+
+            // returns null once the cache of the thread is destroyed, the
+            // blocks are then exchanged with the depot directly
+            static pool_cache* current()
+            {
+                static thread_local pool_cache cache;
+                return alive() ? &cache : nullptr;
+            }
+
+            ~pool_cache()
+            {
+                release();
+                alive() = false;
+            }
+
+            pool_cache(const pool_cache&) = delete;
+            pool_cache& operator=(const pool_cache&) = delete;
+
+            void* allocate(std::size_t index)
+            {
+                std::vector<void*>& list = m_blocks[index];
+                if (list.empty())
+                {
+                    pool_depot::instance().take(index, list, XTENSOR_POOL_CACHE_SIZE / 2 + 1);
+                }
+                if (!list.empty())
+                {
+                    if (alloc_tracking::enabled())
+                    {
+                        alloc_tracking::statistics().pool_hits.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    void* res = list.back();
+                    list.pop_back();
+                    return res;
+                }
+                if (alloc_tracking::enabled())
+                {
+                    alloc_tracking::statistics().pool_misses.fetch_add(1, std::memory_order_relaxed);
+                }
+                return aligned_new(pool_class_size(index));
+            }
+
+            void deallocate(void* p, std::size_t index) noexcept
+            {
+                std::vector<void*>& list = m_blocks[index];
+                if (list.size() >= XTENSOR_POOL_CACHE_SIZE)
+                {
+                    pool_depot::instance().give(index, list, XTENSOR_POOL_CACHE_SIZE / 2);
+                }
+                list.push_back(p);
+            }
+
+            void release() noexcept
+            {
+                for (std::size_t i = 0; i < pool_class_count; ++i)
+                {
+                    pool_depot::instance().give(i, m_blocks[i], 0);
+                }
+            }
+
+        private:
+
+            pool_cache()
+            {
+                for (auto& list : m_blocks)
+                {
+                    list.reserve(XTENSOR_POOL_CACHE_SIZE + 1);
+                }
+                alive() = true;
+            }
+
+            static bool& alive() noexcept
+            {
+                static thread_local bool flag = false;
+                return flag;
+            }
+
+            std::array<std::vector<void*>, pool_class_count> m_blocks;
+        };
+    }
+
+    /**
+     * Frees the blocks cached by the pool allocators: the cache of the
+     * calling thread is flushed, then the blocks shared by all the threads
+     * are returned to the system.
+     */
+    inline void release_pooled_memory()
+    {
+        if (detail::pool_cache* cache = detail::pool_cache::current())
+        {
+            cache->release();
+        }
+        detail::pool_depot::instance().release();
+    }
+
+    /**
+     * Allocator recycling the memory of the deallocated buffers. The requests
+     * are rounded up to size classes; the freed blocks are kept in a cache
+     * local to the thread, which exchanges them in batches with a pool
+     * shared by all the threads, so that most allocations and deallocations
+     * do not lock. Requests larger than 2^XTENSOR_POOL_MAX_CLASS_BITS bytes
+     * go to the global operator new. The allocated memory is aligned on 64
+     * bytes. Combined with tracking_allocator and the count policy, the
+     * hits and misses of the pool are reported in alloc_tracking::statistics.
+     *
+     * \code{.cpp}
+     * using tensor_type = xt::xtensor_container<xt::uvector<double, xt::pool_allocator<double>>, 3,
+     *                                           xt::layout_type::row_major>;
+     * \endcode
+     */
+    template <class T>
+    struct pool_allocator
+    {
+        using value_type = T;
+        using reference = T&;
+        using const_reference = const T&;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        template <class U>
+        struct rebind
+        {
+            using other = pool_allocator<U>;
+        };
+
+        pool_allocator() noexcept = default;
+
+        template <class U>
+        pool_allocator(const pool_allocator<U>&) noexcept
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            if (n == 0)
+            {
+                return nullptr;
+            }
+            if (n > (std::size_t(-1) - sizeof(void*) - detail::allocation_alignment) / sizeof(T))
+            {
+                throw std::bad_alloc();
+            }
+            std::size_t size = n * sizeof(T);
+            if (size > (std::size_t(1) << detail::pool_max_class_bits))
+            {
+                return static_cast<T*>(detail::aligned_new(size));
+            }
+            std::size_t index = detail::pool_size_class(size);
+            detail::pool_cache* cache = detail::pool_cache::current();
+            return static_cast<T*>(cache != nullptr ? cache->allocate(index) : detail::aligned_new(detail::pool_class_size(index)));
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept
+        {
+            if (p == nullptr)
+            {
+                return;
+            }
+            std::size_t size = n * sizeof(T);
+            if (size > (std::size_t(1) << detail::pool_max_class_bits))
+            {
+                detail::aligned_delete(p);
+            }
+            else
+            {
+                std::size_t index = detail::pool_size_class(size);
+                detail::pool_cache* cache = detail::pool_cache::current();
+                if (cache != nullptr)
+                {
+                    cache->deallocate(p, index);
+                }
+                else
+                {
+                    detail::pool_depot::instance().put(index, p);
+                }
+            }
+        }
+
+        template <class U, class... Args>
+        void construct(U* p, Args&&... args)
+        {
+            new ((void*)p) U(std::forward<Args>(args)...);
+        }
+
+        template <class U>
+        void destroy(U* p)
+        {
+            p->~U();
+        }
+    };
+
+    template <class T, class U>
+    inline bool operator==(const pool_allocator<T>&, const pool_allocator<U>&)
+    {
+        return true;
+    }
+
+    template <class T, class U>
+    inline bool operator!=(const pool_allocator<T>&, const pool_allocator<U>&)
+    {
+        return false;
+    }
+
+    /***********************
+     * huge_page_allocator *
+     ***********************/
+
+    namespace detail
+    {
+        inline std::size_t huge_page_length(std::size_t size) noexcept
+        {
+            return (size + XTENSOR_HUGE_PAGE_SIZE - 1) / XTENSOR_HUGE_PAGE_SIZE * XTENSOR_HUGE_PAGE_SIZE;
+        }
+
+        // Maps a region aligned on the huge page size, and advises the kernel
+        // to back it with transparent huge pages. The advice is ignored when
+        // they are disabled; on systems without mmap the memory comes from
+        // the global operator new.
+        inline void* huge_page_allocate(std::size_t size)
+        {
+#if defined(_WIN32)
+            return aligned_new(size);
+#else
+            std::size_t length = huge_page_length(size);
+            if (length < size || length + XTENSOR_HUGE_PAGE_SIZE < length)
+            {
+                throw std::bad_alloc();
+            }
+            void* region = mmap(nullptr, length + XTENSOR_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (region == MAP_FAILED)
+            {
+                throw std::bad_alloc();
+            }
+            // trims the region to the aligned part
+            char* first = static_cast<char*>(region);
+            std::uintptr_t address = reinterpret_cast<std::uintptr_t>(first);
+            std::size_t head = static_cast<std::size_t>((XTENSOR_HUGE_PAGE_SIZE - address % XTENSOR_HUGE_PAGE_SIZE) % XTENSOR_HUGE_PAGE_SIZE);
+            if (head != 0)
+            {
+                munmap(first, head);
+            }
+            if (head != XTENSOR_HUGE_PAGE_SIZE)
+            {
+                munmap(first + head + length, XTENSOR_HUGE_PAGE_SIZE - head);
+            }
+#if defined(MADV_HUGEPAGE)
+            madvise(first + head, length, MADV_HUGEPAGE);
+#endif
+            return first + head;
+#endif
+        }
+
+        inline void huge_page_deallocate(void* p, std::size_t size) noexcept
+        {
+#if defined(_WIN32)
+            (void) size;
+            aligned_delete(p);
+#else
+            munmap(p, huge_page_length(size));
+#endif
+        }
+    }
+
+    /**
+     * Allocator backing large buffers with transparent huge pages, which
+     * reduces the TLB misses of strided accesses. The allocations of at least
+     * XTENSOR_HUGE_PAGE_THRESHOLD bytes are mapped on regions aligned on
+     * XTENSOR_HUGE_PAGE_SIZE bytes (2 MB by default) advised with
+     * MADV_HUGEPAGE where available; the smaller ones, and all of them on
+     * Windows, come from the global operator new aligned on 64 bytes. It is
+     * the default allocator of the containers when XTENSOR_USE_HUGE_PAGES
+     * is defined.
+     */
+    template <class T>
+    struct huge_page_allocator
+    {
+        using value_type = T;
+        using reference = T&;
+        using const_reference = const T&;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        template <class U>
+        struct rebind
+        {
+            using other = huge_page_allocator<U>;
+        };
+
+        huge_page_allocator() noexcept = default;
+
+        template <class U>
+        huge_page_allocator(const huge_page_allocator<U>&) noexcept
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            if (n == 0)
+            {
+                return nullptr;
+            }
+            if (n > (std::size_t(-1) - sizeof(void*) - detail::allocation_alignment) / sizeof(T))
+            {
+                throw std::bad_alloc();
+            }
+            std::size_t size = n * sizeof(T);
+            if (size < XTENSOR_HUGE_PAGE_THRESHOLD)
+            {
+                return static_cast<T*>(detail::aligned_new(size));
+            }
+            return static_cast<T*>(detail::huge_page_allocate(size));
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept
+        {
+            if (p == nullptr)
+            {
+                return;
+            }
+            std::size_t size = n * sizeof(T);
+            if (size < XTENSOR_HUGE_PAGE_THRESHOLD)
+            {
+                detail::aligned_delete(p);
+            }
+            else
+            {
+                detail::huge_page_deallocate(p, size);
+            }
+        }
+
+        template <class U, class... Args>
+        void construct(U* p, Args&&... args)
+        {
+            new ((void*)p) U(std::forward<Args>(args)...);
+        }
+
+        template <class U>
+        void destroy(U* p)
+        {
+            p->~U();
+        }
+    };
+
+    template <class T, class U>
+    inline bool operator==(const huge_page_allocator<T>&, const huge_page_allocator<U>&)
+    {
+        return true;
+    }
+
+    template <class T, class U>
+    inline bool operator!=(const huge_page_allocator<T>&, const huge_page_allocator<U>&)
+    {
+        return false;
+    }
+
+    /***********************
+     * zero_page_allocator *
+     ***********************/
+
+    namespace detail
+    {
+        // Maps anonymous memory, which the kernel backs with the shared zero
+        // page until it is written: only the pages actually touched are
+        // faulted in and zeroed. The small allocations, and all of them on
+        // Windows, are zeroed by memset.
+        inline void* zero_page_allocate(std::size_t size)
+        {
+#if !defined(_WIN32)
+            if (size >= XTENSOR_ZERO_PAGE_THRESHOLD)
+            {
+                void* region = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (region == MAP_FAILED)
+                {
+                    throw std::bad_alloc();
+                }
+                return region;
+            }
+#endif
+            void* p = aligned_new(size);
+            std::memset(p, 0, size);
+            return p;
+        }
+
+        inline void zero_page_deallocate(void* p, std::size_t size) noexcept
+        {
+#if !defined(_WIN32)
+            if (size >= XTENSOR_ZERO_PAGE_THRESHOLD)
+            {
+                munmap(p, size);
+                return;
+            }
+#else
+            (void) size;
+#endif
+            aligned_delete(p);
+        }
+    }
+
+    /**
+     * Allocator returning zeroed memory. The allocations of at least
+     * XTENSOR_ZERO_PAGE_THRESHOLD bytes are anonymous mappings, whose pages
+     * are only materialized when they are first written: a large accumulator
+     * of which only a few regions are touched costs the memory of these
+     * regions, and nothing is written upfront. The containers using it skip
+     * the assignment of xt::zeros when they are built from it.
+     * @sa zeros_container
+     */
+    template <class T>
+    struct zero_page_allocator
+    {
+        using value_type = T;
+        using reference = T&;
+        using const_reference = const T&;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        template <class U>
+        struct rebind
+        {
+            using other = zero_page_allocator<U>;
+        };
+
+        zero_page_allocator() noexcept = default;
+
+        template <class U>
+        zero_page_allocator(const zero_page_allocator<U>&) noexcept
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            if (n == 0)
+            {
+                return nullptr;
+            }
+            if (n > (std::size_t(-1) - sizeof(void*) - detail::allocation_alignment) / sizeof(T))
+            {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(detail::zero_page_allocate(n * sizeof(T)));
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept
+        {
+            if (p != nullptr)
+            {
+                detail::zero_page_deallocate(p, n * sizeof(T));
+            }
+        }
+
+        template <class U, class... Args>
+        void construct(U* p, Args&&... args)
+        {
+            new ((void*)p) U(std::forward<Args>(args)...);
+        }
+
+        template <class U>
+        void destroy(U* p)
+        {
+            p->~U();
+        }
+    };
+
+    template <class T, class U>
+    inline bool operator==(const zero_page_allocator<T>&, const zero_page_allocator<U>&)
+    {
+        return true;
+    }
+
+    template <class T, class U>
+    inline bool operator!=(const zero_page_allocator<T>&, const zero_page_allocator<U>&)
+    {
+        return false;
+    }
+
+    /**
+     * Whether the memory returned by an allocator is zeroed.
+     */
+    template <class A>
+    struct allocates_zeros : std::false_type
+    {
+    };
+
+    template <class T>
+    struct allocates_zeros<zero_page_allocator<T>> : std::true_type
+    {
+    };
+
     template <class E1, class E2, class = void>
     struct has_assign_to : std::false_type
     {
@@ -9,6 +9,7 @@
 #ifndef XTENSOR_VECTORIZE_HPP
 #define XTENSOR_VECTORIZE_HPP
 
+#include <cstddef>
 #include <type_traits>
 #include <utility>
 
@@ -18,6 +19,102 @@
 namespace xt
 {
 
+    namespace detail
+    {
+        template <class T, std::size_t I>
+        struct repeat_type
+        {
+            using type = T;
+        };
+
+        template <class F, class B, class S, class = void>
+        struct is_batch_callable_impl : std::false_type
+        {
+        };
+
+        template <class F, class B, std::size_t... I>
+        struct is_batch_callable_impl<F, B, std::index_sequence<I...>,
+                                      void_t<decltype(std::declval<const F&>()(std::declval<const typename repeat_type<B, I>::type&>()...))>>
+            : std::is_convertible<decltype(std::declval<const F&>()(std::declval<const typename repeat_type<B, I>::type&>()...)), B>
+        {
+        };
+
+        // Checks whether F can be called with N batches of type B. Generic
+        // lambdas must declare their return type (-> decltype(...)) so that
+        // a body that is not valid for batches disables the detection instead
+        // of failing to compile.
+        template <class F, class B, std::size_t N>
+        using is_batch_callable = is_batch_callable_impl<std::remove_reference_t<F>, B, std::make_index_sequence<N>>;
+
+        /**
+         * Adapts a functor that can be called with xsimd batches to the
+         * simd_apply protocol of xfunction. The first batch gives the batch
+         * type, which the other ones must have too.
+         */
+        template <class F, class S>
+        class xvectorize_batch_adaptor;
+
+        template <class F, std::size_t... I>
+        class xvectorize_batch_adaptor<F, std::index_sequence<I...>>
+        {
+        public:
+
+            using functor_type = std::remove_reference_t<F>;
+
+            template <class Func, class = std::enable_if_t<!std::is_same<std::decay_t<Func>, xvectorize_batch_adaptor>::value>>
+            explicit xvectorize_batch_adaptor(Func&& f)
+                : m_f(std::forward<Func>(f))
+            {
+            }
+
+            template <class... T>
+            auto operator()(T&&... args) const -> decltype(std::declval<const functor_type&>()(std::forward<T>(args)...))
+            {
+                return m_f(std::forward<T>(args)...);
+            }
+
+            template <class B>
+            auto simd_apply(const B& first, const typename repeat_type<B, I>::type&... args) const
+                -> decltype(std::declval<const functor_type&>()(first, args...))
+            {
+                return m_f(first, args...);
+            }
+
+        private:
+
+            functor_type m_f;
+        };
+
+        // The operands of a SIMD xfunction are loaded as batches of its value
+        // type, the functor is adapted if it accepts such batches
+        template <class F, class... E>
+        struct xvectorize_functor
+        {
+            using value_type = std::decay_t<decltype(std::declval<F>()(std::declval<xvalue_type_t<std::decay_t<E>>>()...))>;
+            using batch_type = xsimd::simd_type<value_type>;
+
+            static constexpr std::size_t arity = sizeof...(E);
+            static constexpr bool use_batches = arity != 0 && !std::is_same<batch_type, value_type>::value &&
+                                                is_batch_callable<F, batch_type, arity>::value;
+
+            using adaptor_type = xvectorize_batch_adaptor<F, std::make_index_sequence<arity == 0 ? 0 : arity - 1>>;
+            using type = std::conditional_t<use_batches, adaptor_type, F>;
+        };
+
+        template <class F, class... E>
+        using xvectorize_functor_t = typename xvectorize_functor<F, E...>::type;
+
+        template <class F, class = void>
+        struct has_function_type : std::false_type
+        {
+        };
+
+        template <class F>
+        struct has_function_type<F, void_t<decltype(&std::remove_reference_t<F>::operator())>> : std::true_type
+        {
+        };
+    }
+
     /***************
      * xvectorizer *
      ***************/
@@ -28,7 +125,7 @@ namespace xt
     public:
 
         template <class... E>
-        using xfunction_type = xfunction<F, xclosure_t<E>...>;
+        using xfunction_type = xfunction<detail::xvectorize_functor_t<F, E...>, xclosure_t<E>...>;
 
         template <class Func, class = std::enable_if_t<!std::is_same<std::decay_t<Func>, xvectorizer>::value>>
         xvectorizer(Func&& f);
@@ -61,6 +158,9 @@ namespace xt
     auto vectorize(F&& f) -> decltype(vectorize(std::forward<F>(f), std::declval<detail::get_function_type<F>*>()));
 #endif
 
+    template <class F, class = std::enable_if_t<std::is_class<std::decay_t<F>>::value && !detail::has_function_type<F>::value>>
+    xvectorizer<F, void> vectorize(F&& f);
+
     /******************************
      * xvectorizer implementation *
      ******************************/
@@ -96,6 +196,24 @@ namespace xt
     {
         return vectorize(std::forward<F>(f), static_cast<detail::get_function_type<F>*>(nullptr));
     }
+
+    /**
+     * Vectorizes a functor with a generic call operator, such as a generic
+     * lambda, which has no function type. The value type of the resulting
+     * expressions is the return type of the functor for the value types of
+     * the arguments. If the functor can also be called with xsimd batches,
+     * the expressions are used in the SIMD assignment.
+     *
+     * \code{.cpp}
+     * auto f = xt::vectorize([](const auto& x, const auto& y) -> decltype(x * y + x) { return x * y + x; });
+     * xt::xarray<double> res = f(a, b);
+     * \endcode
+     */
+    template <class F, class>
+    inline xvectorizer<F, void> vectorize(F&& f)
+    {
+        return xvectorizer<F, void>(std::forward<F>(f));
+    }
 }
 
 #endif
@@ -1729,6 +1729,171 @@ namespace xt
         return detail::make_view_impl(std::forward<E>(e), std::make_index_sequence<sizeof...(S)>(), std::forward<S>(slices)...);
     }
 
+    /**************************
+     * run_assigner for xview *
+     **************************/
+
+    namespace detail
+    {
+        template <class S>
+        using is_run_slice = xtl::disjunction<is_xkeep_slice<S>, is_xdrop_slice<S>>;
+
+        // Index of the keep or drop slice of a view when it is the only one
+        // and the view has no newaxis, sizeof...(S) otherwise
+        template <class... S>
+        constexpr std::size_t run_slice_index()
+        {
+            constexpr bool is_run[] = {false, is_run_slice<S>::value...};
+            std::size_t count = 0;
+            std::size_t index = sizeof...(S);
+            for (std::size_t i = 0; i < sizeof...(S); ++i)
+            {
+                if (is_run[i + 1])
+                {
+                    ++count;
+                    index = i;
+                }
+            }
+            return (count == 1 && newaxis_count<S...>() == 0) ? index : sizeof...(S);
+        }
+
+        template <class E>
+        struct has_run_slice : std::false_type
+        {
+        };
+
+        template <class CT, class... S>
+        struct has_run_slice<xview<CT, S...>>
+            : std::integral_constant<bool, run_slice_index<S...>() != sizeof...(S)>
+        {
+        };
+
+        // The runs are assigned one by one only when they are long enough
+        // to amortize the construction of the views of each run
+        constexpr std::size_t min_average_run_length = 8;
+
+        template <class SL>
+        inline bool use_run_assign(const SL& slice)
+        {
+            std::size_t nb_runs = slice.runs().size() - 1;
+            return nb_runs != 0 && static_cast<std::size_t>(slice.size()) >= min_average_run_length * nb_runs;
+        }
+
+        template <bool replace>
+        struct run_slice
+        {
+            template <class SL>
+            static SL get(const SL& slice, std::size_t /*start*/, std::size_t /*stop*/)
+            {
+                return slice;
+            }
+        };
+
+        template <>
+        struct run_slice<true>
+        {
+            template <class SL>
+            static auto get(const SL& /*slice*/, std::size_t start, std::size_t stop)
+            {
+                using size_type = typename SL::size_type;
+                return xrange<size_type>(static_cast<size_type>(start), static_cast<size_type>(stop));
+            }
+        };
+
+        // View of the underlying expression of v where the keep or drop
+        // slice at index P is replaced with the range [start, stop)
+        template <std::size_t P, class V, std::size_t... I>
+        inline auto underlying_run_view(V& v, std::size_t start, std::size_t stop, std::index_sequence<I...>)
+        {
+            return view(v.expression(), run_slice<I == P>::get(std::get<I>(v.slices()), start, stop)...);
+        }
+
+        // View of e where the dimension D is restricted to [start, stop)
+        template <std::size_t D, class E, std::size_t... I>
+        inline auto dimension_run_view(E& e, std::size_t start, std::size_t stop, std::index_sequence<I...>)
+        {
+            return view(e, (static_cast<void>(I), all())..., range(start, stop));
+        }
+
+        // Assigns the view v and the expression e run by run, each run
+        // of the keep or drop slice at index P of v being a range of the
+        // dimension D of e
+        template <std::size_t P, std::size_t D>
+        struct run_assign
+        {
+            template <class V, class E, bool view_on_lhs>
+            static void run(V& v, E& e, std::integral_constant<bool, view_on_lhs> lhs)
+            {
+                constexpr std::size_t nb_slices = std::tuple_size<std::decay_t<decltype(v.slices())>>::value;
+                const auto& slice = std::get<P>(v.slices());
+                const auto& runs = slice.runs();
+                for (std::size_t k = 0; k + 1 < runs.size(); ++k)
+                {
+                    std::size_t first = static_cast<std::size_t>(runs[k]);
+                    std::size_t last = static_cast<std::size_t>(runs[k + 1]);
+                    std::size_t start = static_cast<std::size_t>(slice(runs[k]));
+                    auto vrun = underlying_run_view<P>(v, start, start + last - first, std::make_index_sequence<nb_slices>());
+                    auto erun = dimension_run_view<D>(e, first, last, std::make_index_sequence<D>());
+                    assign_run(vrun, erun, lhs);
+                }
+            }
+
+            template <class VR, class ER>
+            static void assign_run(VR& vrun, ER& erun, std::true_type)
+            {
+                xexpression_assigner_base<xtensor_expression_tag>::assign_data(vrun, erun, true);
+            }
+
+            template <class VR, class ER>
+            static void assign_run(VR& vrun, ER& erun, std::false_type)
+            {
+                xexpression_assigner_base<xtensor_expression_tag>::assign_data(erun, vrun, true);
+            }
+        };
+    }
+
+    template <class E1, class CT, class... S>
+    class run_assigner<E1, xview<CT, S...>, std::enable_if_t<detail::has_run_slice<xview<CT, S...>>::value>>
+    {
+    public:
+
+        using view_type = xview<CT, S...>;
+        static constexpr std::size_t slice_index = detail::run_slice_index<S...>();
+        static constexpr std::size_t dimension_index = slice_index - integral_count_before<S...>(slice_index);
+
+        static bool run(E1& e1, const view_type& e2)
+        {
+            if (!detail::use_run_assign(std::get<slice_index>(e2.slices())))
+            {
+                return false;
+            }
+            detail::run_assign<slice_index, dimension_index>::run(e2, e1, std::false_type());
+            return true;
+        }
+    };
+
+    template <class CT, class... S, class E2>
+    class run_assigner<xview<CT, S...>, E2, std::enable_if_t<detail::has_run_slice<xview<CT, S...>>::value &&
+                                                             !detail::has_run_slice<E2>::value &&
+                                                             has_data_interface<E2>::value>>
+    {
+    public:
+
+        using view_type = xview<CT, S...>;
+        static constexpr std::size_t slice_index = detail::run_slice_index<S...>();
+        static constexpr std::size_t dimension_index = slice_index - integral_count_before<S...>(slice_index);
+
+        static bool run(view_type& e1, const E2& e2)
+        {
+            if (!detail::use_run_assign(std::get<slice_index>(e1.slices())))
+            {
+                return false;
+            }
+            detail::run_assign<slice_index, dimension_index>::run(e1, e2, std::true_type());
+            return true;
+        }
+    };
+
     /***************
      * stepper api *
      ***************/
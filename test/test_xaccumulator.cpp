@@ -6,6 +6,9 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <cmath>
+#include <limits>
+
 #include "gtest/gtest.h"
 #include "xtensor/xaccumulator.hpp"
 #include "xtensor/xarray.hpp"
@@ -212,4 +215,148 @@ namespace xt
         truth = std::is_same<typename decltype(res_0)::shape_type, xshape<4, 3>>::value;
         EXPECT_TRUE(truth);
     }
-}
\ No newline at end of file
+
+    TEST(xaccumulator, parallel_scan)
+    {
+        xtensor<int, 1> a = xt::ones<int>({10000});
+        std::iota(a.begin(), a.end(), -5000);
+        xtensor<long long, 1> expected = xt::ones<long long>({10000});
+        expected(0) = a(0);
+        for (std::size_t i = 1; i < a.size(); ++i)
+        {
+            expected(i) = expected(i - 1) + a(i);
+        }
+
+        parallel::scoped_settings guard(0, 0);
+        EXPECT_EQ(cumsum(a), expected);
+        EXPECT_EQ(cumsum(a, 0), expected);
+
+        xtensor<int, 2> b = xt::ones<int>({3, 5000});
+        xtensor<int, 2, layout_type::column_major> cb = b;
+        xtensor<long long, 2> res_b = cumsum(b, 1);
+        xtensor<long long, 2> res_cb = cumsum(cb, 1);
+        xtensor<long long, 2> res_cb0 = cumsum(cb, 0);
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            EXPECT_EQ(res_b(i, 4999), 5000);
+            EXPECT_EQ(res_cb(i, 2999), 3000);
+            EXPECT_EQ(res_cb0(i, 10), static_cast<long long>(i + 1));
+        }
+
+        xtensor<int, 3> c = xt::ones<int>({4, 1, 3});
+        EXPECT_EQ(cumsum(c, 1), c);
+    }
+
+    namespace
+    {
+        // exponential moving average, which is not associative
+        struct moving_average
+        {
+            using result_type = double;
+
+            double operator()(double acc, double x) const
+            {
+                return 0.9 * acc + x;
+            }
+        };
+    }
+
+    TEST(xaccumulator, non_associative)
+    {
+        xtensor<double, 1> a = xt::ones<double>({10000});
+        std::iota(a.begin(), a.end(), -5000.);
+        xtensor<double, 1> expected = a;
+        for (std::size_t i = 1; i < a.size(); ++i)
+        {
+            expected(i) = 0.9 * expected(i - 1) + a(i);
+        }
+
+        // the lanes of a non associative function are scanned serially
+        parallel::scoped_settings guard(0, 0);
+        xtensor<double, 1> res = accumulate(make_xaccumulator_functor(moving_average()), a);
+        EXPECT_EQ(res, expected);
+        xtensor<double, 1> res0 = accumulate(make_xaccumulator_functor(moving_average()), a, 0);
+        EXPECT_EQ(res0, expected);
+    }
+
+    TEST(xaccumulator, outer_axis)
+    {
+        // rows wider than a tile, and not a multiple of the simd size
+        std::size_t n = 5;
+        std::size_t m = 4099;
+        xtensor<double, 2> a = xt::ones<double>({n, m});
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            for (std::size_t j = 0; j < m; ++j)
+            {
+                a(i, j) = 1. + static_cast<double>((i * 7 + j) % 5) / 4.;
+            }
+        }
+        a(2, 3) = std::numeric_limits<double>::quiet_NaN();
+        a(0, 4098) = std::numeric_limits<double>::quiet_NaN();
+
+        xtensor<double, 2> sum = a;
+        xtensor<double, 2> prod = a;
+        xtensor<double, 2> nsum = a;
+        xtensor<double, 2> nprod = a;
+        for (std::size_t j = 0; j < m; ++j)
+        {
+            nsum(0, j) = std::isnan(a(0, j)) ? 0. : a(0, j);
+            nprod(0, j) = std::isnan(a(0, j)) ? 1. : a(0, j);
+            for (std::size_t i = 1; i < n; ++i)
+            {
+                sum(i, j) = sum(i - 1, j) + a(i, j);
+                prod(i, j) = prod(i - 1, j) * a(i, j);
+                nsum(i, j) = std::isnan(a(i, j)) ? nsum(i - 1, j) : nsum(i - 1, j) + a(i, j);
+                nprod(i, j) = std::isnan(a(i, j)) ? nprod(i - 1, j) : nprod(i - 1, j) * a(i, j);
+            }
+        }
+
+        xtensor<double, 2> res_sum = cumsum(a, 0);
+        xtensor<double, 2> res_prod = cumprod(a, 0);
+        EXPECT_TRUE(all(isclose(res_sum, sum, 1e-12, 0., true)));
+        EXPECT_TRUE(all(isclose(res_prod, prod, 1e-12, 0., true)));
+        EXPECT_EQ(xtensor<double, 2>(nancumsum(a, 0)), nsum);
+        EXPECT_EQ(xtensor<double, 2>(nancumprod(a, 0)), nprod);
+
+        // middle axis of a 3-D array
+        xtensor<int, 3> b = xt::ones<int>({2, 6, 37});
+        xtensor<long long, 3> res_b = cumsum(b, 1);
+        EXPECT_EQ(res_b(1, 5, 36), 6);
+        EXPECT_EQ(res_b(0, 2, 0), 3);
+
+        parallel::scoped_settings guard(0, 0);
+        xtensor<double, 2> res_par = nancumsum(a, 0);
+        EXPECT_EQ(res_par, nsum);
+    }
+
+    TEST(xaccumulator, accumulate_into)
+    {
+        xtensor<double, 2> arr = {{1, 2, 3}, {4, 5, 6}};
+        xtensor<double, 2> out = xt::zeros<double>({2, 3});
+        const double* data = out.data();
+
+        cumsum(out, arr, 0);
+        xtensor<double, 2> expected_0 = {{1, 2, 3}, {5, 7, 9}};
+        EXPECT_EQ(out, expected_0);
+        EXPECT_EQ(out.data(), data);
+
+        cumsum(out, arr, 1);
+        xtensor<double, 2> expected_1 = {{1, 3, 6}, {4, 9, 15}};
+        EXPECT_EQ(out, expected_1);
+        EXPECT_EQ(out.data(), data);
+
+        cumprod(out, out, 1);
+        xtensor<double, 2> expected_prod = {{1, 3, 18}, {4, 36, 540}};
+        EXPECT_EQ(out, expected_prod);
+
+        xarray<double> flat;
+        cumsum(flat, arr + 1.);
+        xarray<double> expected_flat = {2, 5, 9, 14, 20, 27};
+        EXPECT_EQ(flat, expected_flat);
+
+        auto& res = accumulate_into(flat, make_xaccumulator_functor(std::plus<double>()), arr, -1);
+        EXPECT_EQ(&res, &flat);
+        EXPECT_EQ(flat, expected_1);
+    }
+}
@@ -9,6 +9,7 @@
 #include "gtest/gtest.h"
 #include "xtensor/xadapt.hpp"
 #include "xtensor/xstrides.hpp"
+#include "xtensor/xview.hpp"
 
 namespace xt
 {
@@ -112,6 +113,40 @@ namespace xt
         EXPECT_EQ(1, *data3);
     }
 
+    TEST(xarray_adaptor, external_ownership)
+    {
+        size_t size = 4;
+        int released = 0;
+        int* data = new int[size];
+        using shape_type = std::vector<vec_type::size_type>;
+        shape_type s({2, 2});
+
+        {
+            auto release = [data, &released]() { delete[] data; ++released; };
+            auto a1 = adapt(data, size, external_ownership(release), s);
+            a1(1, 0) = 2;
+            EXPECT_EQ(2, data[2]);
+
+            // the view keeps the buffer alive after a1 is moved into it
+            auto v = view(std::move(a1), 1);
+            {
+                auto a2 = v;
+            }
+            EXPECT_EQ(0, released);
+            EXPECT_EQ(2, v(0));
+        }
+        EXPECT_EQ(1, released);
+
+        auto handle = std::make_shared<vec_type>(size, 3);
+        {
+            auto a3 = adapt(handle->data(), size, external_ownership(handle), s);
+            EXPECT_EQ(2, handle.use_count());
+            EXPECT_EQ(3, a3(1, 1));
+            EXPECT_THROW(a3.resize({4, 4}), std::runtime_error);
+        }
+        EXPECT_EQ(1, handle.use_count());
+    }
+
     TEST(xarray_adaptor, ptr_adapt_layout)
     {
         size_t size = 4;
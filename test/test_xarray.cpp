@@ -148,6 +148,89 @@ namespace xt
         test_resize(a);
     }
 
+    TEST(xarray, resize_geometric)
+    {
+        xarray<double> a;
+        std::size_t reallocations = 0;
+        const double* data = nullptr;
+        for (std::size_t i = 0; i < 100; ++i)
+        {
+            a.resize({i + 1, 3}, resize_mode::geometric);
+            a(i, 0) = double(i);
+            a(i, 1) = 0.;
+            a(i, 2) = double(2 * i);
+            if (a.data() != data)
+            {
+                ++reallocations;
+                data = a.data();
+            }
+        }
+        EXPECT_LE(reallocations, std::size_t(8));
+        EXPECT_GE(a.storage().capacity(), std::size_t(300));
+        for (std::size_t i = 0; i < 100; ++i)
+        {
+            EXPECT_EQ(a(i, 0), double(i));
+            EXPECT_EQ(a(i, 2), double(2 * i));
+        }
+
+        // shrinking keeps the buffer, unless it becomes mostly unused
+        a.resize({40, 3});
+        EXPECT_EQ(a.data(), data);
+        EXPECT_EQ(a(39, 2), 78.);
+        a.resize({2, 3});
+        EXPECT_EQ(a.storage().capacity(), std::size_t(6));
+        EXPECT_EQ(a(1, 2), 2.);
+    }
+
+    TEST(xarray, shape_capacity)
+    {
+        using shape_allocator = tracking_allocator<std::size_t, std::allocator<std::size_t>, alloc_tracking::count>;
+        using small_array = xarray_container<uvector<double>, layout_type::row_major,
+                                             svector<std::size_t, 4, shape_allocator>>;
+        using large_array = xarray_container<uvector<double>, layout_type::row_major,
+                                             svector<std::size_t, 8, shape_allocator>>;
+        typename large_array::shape_type large_shape = {2, 1, 2, 1, 2, 1};
+        typename small_array::shape_type small_shape = {2, 1, 2, 1, 2, 1};
+
+        const alloc_tracking::statistics_type& stats = alloc_tracking::statistics();
+        std::size_t allocations = stats.allocations.load();
+        large_array a(large_shape);
+        EXPECT_EQ(stats.allocations.load(), allocations);
+        EXPECT_EQ(a.dimension(), std::size_t(6));
+        EXPECT_EQ(a.strides()[0], std::ptrdiff_t(4));
+
+        // shape, strides and backstrides exceed the inline capacity
+        small_array b(small_shape);
+        EXPECT_GE(stats.allocations.load(), allocations + 3);
+        EXPECT_EQ(b.strides()[0], std::ptrdiff_t(4));
+    }
+
+    TEST(xarray, shared)
+    {
+        xarray_shared<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        xarray_shared<double> b = a;
+        const xarray_shared<double>& ca = a;
+        const xarray_shared<double>& cb = b;
+        EXPECT_EQ(ca.data(), cb.data());
+        EXPECT_EQ(cb(1, 2), 6.);
+
+        xarray<double> res = ca + cb;
+        EXPECT_EQ(res(1, 2), 12.);
+        EXPECT_EQ(ca.data(), cb.data());
+
+        b(0, 0) = 10.;
+        EXPECT_NE(ca.data(), cb.data());
+        EXPECT_EQ(a(0, 0), 1.);
+        EXPECT_EQ(b(0, 0), 10.);
+        EXPECT_EQ(b(1, 2), 6.);
+
+        xtensor_shared<double, 2> c = a;
+        xtensor_shared<double, 2> d = c;
+        d += 1.;
+        EXPECT_EQ(c(1, 1), 5.);
+        EXPECT_EQ(d(1, 1), 6.);
+    }
+
     TEST(xarray, reshape)
     {
         xarray_dynamic a;
@@ -0,0 +1,106 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xasync.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xparallel.hpp"
+#include "xtensor/xtensor.hpp"
+
+namespace xt
+{
+    TEST(xasync, eval_async)
+    {
+        xarray<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        xarray<double> b = {10., 20., 30.};
+        auto f = eval_async(a + b);
+        xarray<double> expected = a + b;
+        EXPECT_EQ(f.get(), expected);
+
+        xtensor<double, 1> t = {1., 4., 9.};
+        auto ft = eval_async(sqrt(t));
+        xtensor<double, 1> texpected = {1., 2., 3.};
+        EXPECT_EQ(ft.get(), texpected);
+    }
+
+    TEST(xasync, keep_alive)
+    {
+        std::future<xarray<double>> f;
+        {
+            // the temporary operand is moved into the task
+            xarray<double> tmp = arange<double>(1000.);
+            f = eval_async(std::move(tmp) * 2.);
+        }
+        xarray<double> expected = arange<double>(1000.) * 2.;
+        EXPECT_EQ(f.get(), expected);
+
+        std::future<xarray<double>> g;
+        {
+            auto shared = make_xshared(xarray<double>(arange<double>(10.)));
+            g = eval_async(shared + shared);
+        }
+        xarray<double> gexpected = arange<double>(10.) * 2.;
+        EXPECT_EQ(g.get(), gexpected);
+    }
+
+    TEST(xasync, async_assign)
+    {
+        xarray<double> a = {1., 2., 3.};
+        xarray<double> b = {{1.}, {2.}};
+        xarray<double> out;
+        async_assign(out, a * b).get();
+        xarray<double> expected = a * b;
+        EXPECT_EQ(out, expected);
+
+        xarray<double> nout = zeros<double>({2, 3});
+        double* data = nout.data();
+        async_assign(noalias(nout), a - b).get();
+        xarray<double> nexpected = a - b;
+        EXPECT_EQ(nout, nexpected);
+        EXPECT_EQ(nout.data(), data);
+
+        xtensor<double, 1> c = {1., 2.};
+        xtensor<double, 1> d = {1., 2., 3.};
+        xtensor<double, 1> tout;
+        EXPECT_THROW(async_assign(tout, c + d).get(), std::runtime_error);
+    }
+
+    TEST(xasync, launcher)
+    {
+        std::vector<parallel::task_type> tasks;
+        parallel::set_launcher([&tasks](parallel::task_type task) { tasks.push_back(std::move(task)); });
+
+        xarray<double> a = {1., 2., 3.};
+        xarray<double> out;
+        auto f = eval_async(a * a);
+        auto done = async_assign(out, a + a);
+        EXPECT_EQ(tasks.size(), std::size_t(2));
+        EXPECT_EQ(done.wait_for(std::chrono::seconds(0)), std::future_status::timeout);
+        for (auto& task : tasks)
+        {
+            task();
+        }
+        parallel::reset_launcher();
+
+        xarray<double> expected = {1., 4., 9.};
+        EXPECT_EQ(f.get(), expected);
+        done.get();
+        xarray<double> oexpected = {2., 4., 6.};
+        EXPECT_EQ(out, oexpected);
+    }
+}
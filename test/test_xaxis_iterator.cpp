@@ -6,9 +6,12 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <atomic>
+
 #include "gtest/gtest.h"
 #include "xtensor/xarray.hpp"
 #include "xtensor/xaxis_iterator.hpp"
+#include "xtensor/xmath.hpp"
 
 namespace xt
 {
@@ -91,4 +94,35 @@ namespace xt
         EXPECT_EQ(a(1, 1, 1), (*iter)(1, 1));
         EXPECT_EQ(a(1, 2, 3), (*iter)(2, 3));
     }
+
+    TEST(xaxis_iterator, parallel_for_each_axis)
+    {
+        parallel::scoped_settings settings(1, 1);
+        xarray<int> a = get_test_array();
+        xarray<int> expected = a;
+        for (size_t k = 0; k < 4; ++k)
+        {
+            xt::view(expected, xt::all(), xt::all(), k) *= static_cast<int>(k + 1);
+        }
+        parallel_for_each_axis(a, 2, [](auto& s) {
+            EXPECT_EQ(size_t(2), s.dimension());
+            int factor = s(0, 0);
+            s *= factor;
+        });
+        EXPECT_EQ(a, expected);
+
+        std::atomic<int> total(0);
+        std::atomic<int> count(0);
+        const xarray<int> b = get_test_array();
+        parallel_for_each_axis(b + 1, 1, [&](const auto& s) {
+            EXPECT_EQ(b.shape()[0], s.shape()[0]);
+            EXPECT_EQ(b.shape()[2], s.shape()[1]);
+            total += xt::sum(s)();
+            ++count;
+        });
+        EXPECT_EQ(total.load(), xt::sum(b + 1)());
+        EXPECT_EQ(count.load(), 3);
+
+        EXPECT_THROW(parallel_for_each_axis(a, 3, [](auto&) {}), std::runtime_error);
+    }
 }
@@ -0,0 +1,56 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbatch.hpp"
+#include "xtensor/xbuilder.hpp"
+
+namespace xt
+{
+    using batch_type = xbatch<xtensor_fixed<double, xshape<2, 3>>>;
+
+    TEST(xbatch, slots)
+    {
+        batch_type b(4);
+        EXPECT_EQ(b.size(), std::size_t(4));
+        EXPECT_EQ(b.tensor().shape()[2], std::size_t(4));
+        b.tensor().fill(0.);
+
+        b[1] = xtensor_fixed<double, xshape<2, 3>>({{1., 2., 3.}, {4., 5., 6.}});
+        EXPECT_EQ(b[1].shape()[0], std::size_t(2));
+        EXPECT_EQ(b(1, 1, 2), 6.);
+        EXPECT_EQ(b.tensor()(1, 2, 1), 6.);
+        EXPECT_EQ(b(0, 1, 2), 0.);
+
+        xtensor_fixed<double, xshape<2, 3>> s = b.get(1);
+        EXPECT_EQ(s(0, 1), 2.);
+
+        b.resize(10);
+        EXPECT_EQ(b.size(), std::size_t(10));
+    }
+
+    TEST(xbatch, components)
+    {
+        batch_type a(5), c(5);
+        xarray<double> r = arange<double>(30);
+        r.resize({2, 3, 5});
+        a.tensor() = r;
+        c.tensor() = 2. * a.tensor();
+        EXPECT_EQ(c(3, 1, 1), 2. * a(3, 1, 1));
+
+        auto col = a.component(0, 2);
+        EXPECT_EQ(col.dimension(), std::size_t(1));
+        EXPECT_EQ(col.size(), std::size_t(5));
+        c.component(0, 0) = col + a.component(1, 2);
+        for (std::size_t i = 0; i < 5; ++i)
+        {
+            EXPECT_EQ(c(i, 0, 0), a(i, 0, 2) + a(i, 1, 2));
+        }
+    }
+}
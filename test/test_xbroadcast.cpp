@@ -9,6 +9,9 @@
 #include "gtest/gtest.h"
 #include "xtensor/xbroadcast.hpp"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xparallel.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
 
 namespace xt
 {
@@ -155,4 +158,38 @@ namespace xt
             EXPECT_EQ(iter, iter_end);
         }
     }
+
+    TEST(xbroadcast, replicate_assign)
+    {
+        xarray<int> row = {1, 2, 3};
+        xarray<int> expected = {{1, 2, 3}, {1, 2, 3}, {1, 2, 3}, {1, 2, 3}};
+        xarray<int> a = broadcast(row, {4, 3});
+        EXPECT_EQ(a, expected);
+        xtensor<double, 2> b = broadcast(row * 2, {4, 3});
+        EXPECT_EQ(b, expected * 2);
+
+        // the source keeps its leading dimensions of size one
+        xarray<int> col = {{1}, {2}};
+        xarray<int> row2 = {{5, 6}};
+        xarray<int> c = broadcast(row2, {3, 1, 2});
+        EXPECT_EQ(c, xarray<int>({{{5, 6}}, {{5, 6}}, {{5, 6}}}));
+        xarray<int> d = broadcast(col, {3, 2, 2});
+        EXPECT_EQ(d, xarray<int>({{{1, 1}, {2, 2}}, {{1, 1}, {2, 2}}, {{1, 1}, {2, 2}}}));
+
+        // the assignment of expressions of lower dimension
+        xarray<int> e = xarray<int>::from_shape({4, 3});
+        noalias(e) = row + 1;
+        EXPECT_EQ(e, expected + 1);
+        xarray<int> v = xarray<int>::from_shape({2, 4, 3});
+        noalias(view(v, 1)) = row;
+        EXPECT_EQ(view(v, 1), expected);
+
+        xarray<int, layout_type::column_major> f = broadcast(row, {4, 3});
+        EXPECT_EQ(f, expected);
+        {
+            parallel::scoped_settings settings(0, 0);
+            xarray<int> g = broadcast(row, {5, 3});
+            EXPECT_EQ(g, broadcast(row, {5, 3}));
+        }
+    }
 }
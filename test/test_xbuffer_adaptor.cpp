@@ -14,6 +14,7 @@ namespace xt
     using buffer_adaptor = xbuffer_adaptor<double*>;
     using allocator = std::allocator<double>;
     using owner_adaptor = xbuffer_adaptor<double*&, acquire_ownership>;
+    using shared_adaptor = xbuffer_adaptor<double*, shared_ownership>;
 
     TEST(xbuffer_adaptor, owner_destructor)
     {
@@ -177,4 +178,50 @@ namespace xt
 
         delete[] data;
     }
+
+    TEST(xbuffer_adaptor, shared_copy)
+    {
+        size_t size = 100;
+        double* data = allocator{}.allocate(size);
+        std::fill(data, data + size, 1.5);
+        shared_adaptor adapt1(data, size);
+        shared_adaptor adapt2(adapt1);
+
+        const shared_adaptor& cadapt1 = adapt1;
+        const shared_adaptor& cadapt2 = adapt2;
+        EXPECT_EQ(cadapt1.data(), data);
+        EXPECT_EQ(cadapt2.data(), data);
+        EXPECT_EQ(adapt1.use_count(), 2);
+        EXPECT_EQ(cadapt2[size - 1], 1.5);
+
+        adapt2[0] = 2.5;
+        EXPECT_EQ(cadapt1.data(), data);
+        EXPECT_NE(cadapt2.data(), data);
+        EXPECT_EQ(adapt1.use_count(), 1);
+        EXPECT_EQ(adapt1[0], 1.5);
+        EXPECT_EQ(adapt2[0], 2.5);
+        EXPECT_EQ(adapt2[size - 1], 1.5);
+
+        // the last owner writes in place
+        adapt1[0] = 3.5;
+        EXPECT_EQ(cadapt1.data(), data);
+    }
+
+    TEST(xbuffer_adaptor, shared_move_resize)
+    {
+        shared_adaptor adapt1(size_t(10), 1.);
+        EXPECT_EQ(adapt1.size(), size_t(10));
+        EXPECT_EQ(adapt1[9], 1.);
+
+        shared_adaptor adapt2;
+        adapt2 = adapt1;
+        shared_adaptor adapt3(std::move(adapt2));
+        EXPECT_EQ(adapt2.size(), size_t(0));
+        EXPECT_EQ(adapt3.use_count(), 2);
+
+        adapt3.resize(20);
+        EXPECT_EQ(adapt3.size(), size_t(20));
+        EXPECT_EQ(adapt1.use_count(), 1);
+        EXPECT_EQ(adapt1.size(), size_t(10));
+    }
 }
@@ -11,6 +11,7 @@
 #include "xtensor/xarray.hpp"
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xfixed.hpp"
+#include "xtensor/xmath.hpp"
 
 #include "xtensor/xio.hpp"
 #include <sstream>
@@ -223,6 +224,50 @@ namespace xt
         ASSERT_TRUE((e[{2, 2}]));
     }
 
+    TEST(xbuilder, eye_offset)
+    {
+        xarray<int> lower = eye<int>(3, -1);
+        xarray<int> expected_lower = {{0, 0, 0}, {1, 0, 0}, {0, 1, 0}};
+        EXPECT_EQ(lower, expected_lower);
+        EXPECT_EQ(eye<int>(3, -1)(1, 0), 1);
+
+        xarray<int, layout_type::column_major> upper = eye<int>({2, 3, 4}, 1);
+        for (std::size_t m = 0; m < 2; ++m)
+        {
+            for (std::size_t r = 0; r < 3; ++r)
+            {
+                for (std::size_t c = 0; c < 4; ++c)
+                {
+                    EXPECT_EQ(upper(m, r, c), c == r + 1 ? 1 : 0);
+                }
+            }
+        }
+    }
+
+    TEST(xbuilder, linear_generators)
+    {
+        auto a = arange(0., 2., 0.25);
+        EXPECT_TRUE(has_simd_interface<decltype(a)>::value);
+        EXPECT_TRUE(a.has_linear_assign(std::vector<std::ptrdiff_t>({1})));
+        EXPECT_FALSE(a.has_linear_assign(std::vector<std::ptrdiff_t>({2})));
+        EXPECT_FALSE(has_simd_interface<decltype(eye(3))>::value);
+
+        xtensor<double, 1> s = sin(linspace(0., 1., 11));
+        auto ls = linspace(0., 1., 11);
+        for (std::size_t i = 0; i < 11; ++i)
+        {
+            EXPECT_EQ(s(i), std::sin(ls(i)));
+        }
+
+        xarray<float> f = arange<int>(1, 20) + 0.5f;
+        EXPECT_EQ(f(0), 1.5f);
+        EXPECT_EQ(f(18), 19.5f);
+
+        xarray<double> l = logspace(0., 3., 4);
+        xarray<double> expected_l = {1., 10., 100., 1000.};
+        EXPECT_TRUE(allclose(l, expected_l));
+    }
+
     TEST(xbuilder, concatenate)
     {
         xarray<double> a = {{{0, 1, 2}, {3, 4, 5}}, {{6, 7, 8}, {9, 10, 11}}};
@@ -252,6 +297,25 @@ namespace xt
         ASSERT_TRUE(arange(8) == t);
     }
 
+    TEST(xbuilder, concatenate_assign)
+    {
+        xarray<double> a = {{1, 2}, {3, 4}};
+        xarray<int> b = {{5, 6}};
+        xarray<double> c = concatenate(xtuple(a, b, a + 10.));
+        xarray<double> expected_c = {{1, 2}, {3, 4}, {5, 6}, {11, 12}, {13, 14}};
+        EXPECT_EQ(c, expected_c);
+
+        xarray<double, layout_type::column_major> d = concatenate(xtuple(a, transpose(a)), 1);
+        xarray<double> expected_d = {{1, 2, 1, 3}, {3, 4, 2, 4}};
+        EXPECT_EQ(d, expected_d);
+
+        xtensor<double, 3> s = stack(xtuple(a, transpose(a), a * 2.), 1);
+        EXPECT_EQ(s.shape()[1], 3u);
+        EXPECT_EQ(s(0, 1, 1), 3.);
+        EXPECT_EQ(s(1, 2, 0), 6.);
+        EXPECT_EQ(s(1, 0, 1), 4.);
+    }
+
     TEST(xbuilder, access)
     {
         xarray<double> a = { { { 0, 1, 2 },{ 3, 4, 5 } },{ { 6, 7, 8 },{ 9, 10, 11 } } };
@@ -315,6 +379,33 @@ namespace xt
         stream << std::get<0>(grid) << std::endl;
     }
 
+    TEST(xbuilder, broadcast_meshgrid)
+    {
+        xarray<double> x = {0., 0.5, 1.};
+        xtensor<double, 1> y = {0., 1.};
+        auto mesh = meshgrid(x, y);
+        auto grid = broadcast_meshgrid(x, y);
+        std::array<std::size_t, 2> expected_shape = {3, 2};
+        EXPECT_TRUE(std::equal(expected_shape.cbegin(), expected_shape.cend(), std::get<0>(grid).shape().cbegin()));
+        EXPECT_EQ(std::get<0>(grid).strides()[1], 0);
+        EXPECT_EQ(std::get<0>(grid), std::get<0>(mesh));
+        EXPECT_EQ(std::get<1>(grid), std::get<1>(mesh));
+
+        xarray<double> sum = std::get<0>(grid) * 2. + std::get<1>(grid);
+        xarray<double> expected_sum = std::get<0>(mesh) * 2. + std::get<1>(mesh);
+        EXPECT_EQ(sum, expected_sum);
+
+        auto arange_grid = broadcast_meshgrid(arange(3), arange(2));
+        EXPECT_EQ(std::get<0>(arange_grid)(2, 1), 2);
+        EXPECT_EQ(std::get<1>(arange_grid)(2, 1), 1);
+
+        auto sparse = sparse_meshgrid(x, y);
+        EXPECT_EQ(std::get<0>(sparse).shape()[1], 1u);
+        EXPECT_EQ(std::get<1>(sparse).shape()[0], 1u);
+        xarray<double> sparse_sum = std::get<0>(sparse) * 2. + std::get<1>(sparse);
+        EXPECT_EQ(sparse_sum, expected_sum);
+    }
+
     TEST(xbuilder, triu)
     {
         xarray<double> e = {{1, 2, 3}, {4, 5, 6}, {7, 8, 9}};
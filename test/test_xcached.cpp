@@ -0,0 +1,98 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xcached.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xreducer.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xvectorize.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    TEST(xcached, partial_access)
+    {
+        std::size_t count = 0;
+        auto twice = vectorize([&count](double x) { ++count; return 2. * x; });
+        xarray<double> a = arange<double>(100.);
+        a.reshape({10, 10});
+
+        auto c = cached(twice(a), 8);
+        EXPECT_EQ(c.shape(), a.shape());
+        EXPECT_EQ(count, std::size_t(0));
+        EXPECT_EQ(c(0, 3), 6.);
+        EXPECT_EQ(count, std::size_t(8));
+        EXPECT_EQ(c(0, 5), 10.);
+        EXPECT_EQ(c(0, 3), 6.);
+        EXPECT_EQ(count, std::size_t(8));
+        EXPECT_EQ(c(9, 9), 198.);
+        EXPECT_EQ(count, std::size_t(12));
+        EXPECT_FALSE(c.is_evaluated());
+
+        // the assignment only evaluates the missing tiles
+        xarray<double> res = c + 1.;
+        xarray<double> expected = 2. * a + 1.;
+        EXPECT_EQ(res, expected);
+        EXPECT_EQ(count, std::size_t(100));
+        EXPECT_TRUE(c.is_evaluated());
+        res = c;
+        EXPECT_EQ(count, std::size_t(100));
+
+        std::vector<std::size_t> idx = {4, 2};
+        EXPECT_EQ(c[idx], 84.);
+        EXPECT_EQ(c.at(4, 2), 84.);
+        EXPECT_THROW(c.at(10, 0), std::out_of_range);
+    }
+
+    TEST(xcached, reducer)
+    {
+        xarray<double> a = arange<double>(60.);
+        a.reshape({3, 4, 5});
+        auto m = cached(mean(a, {2}));
+        xarray<double> expected = mean(a, {2});
+        EXPECT_EQ(m(1, 2), expected(1, 2));
+        xarray<double> row = view(m, 2, all());
+        xarray<double> row_expected = view(expected, 2, all());
+        EXPECT_EQ(row, row_expected);
+        xarray<double> full = m;
+        EXPECT_EQ(full, expected);
+
+        xtensor<double, 2> t = sum(a, {0});
+        auto s = cached(sum(a, {0}));
+        EXPECT_EQ(xtensor<double, 2>(s), t);
+    }
+
+    TEST(xcached, invalidate)
+    {
+        xarray<double> a = {1., 2., 3., 4.};
+        auto c = cached(a * a);
+        xarray<double> expected = {1., 4., 9., 16.};
+        EXPECT_EQ(c.evaluate(), expected);
+
+        a(0) = 10.;
+        EXPECT_EQ(c(0), 1.);
+        c.invalidate();
+        EXPECT_FALSE(c.is_evaluated());
+        EXPECT_EQ(c(0), 100.);
+        xarray<double> res = c;
+        xarray<double> rexpected = {100., 4., 9., 16.};
+        EXPECT_EQ(res, rexpected);
+
+        auto copy = c;
+        EXPECT_TRUE(copy.is_evaluated());
+        EXPECT_EQ(copy(3), 16.);
+    }
+}
@@ -0,0 +1,65 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstdio>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xchunk_file_store.hpp"
+#include "xtensor/xmath.hpp"
+
+namespace xt
+{
+    template <class A>
+    void remove_chunk_files(const A& a)
+    {
+        for (std::size_t i = 0; i < a.chunk_count(); ++i)
+        {
+            std::remove(a.chunks().chunk_filename(i).c_str());
+        }
+    }
+
+    TEST(xchunk_file_store, filenames)
+    {
+        auto a = chunked_file_array<double>("data.", {5, 6}, {2, 4}, 2);
+        EXPECT_EQ(a.chunk_count(), std::size_t(6));
+        EXPECT_EQ(a.chunks().chunk_filename(0), "data.0.0.npy");
+        EXPECT_EQ(a.chunks().chunk_filename(5), "data.2.1.npy");
+        EXPECT_THROW(chunked_file_array<double>("data.", {5, 6}, {2, 4}, 0), std::runtime_error);
+    }
+
+    TEST(xchunk_file_store, write_back)
+    {
+        std::string prefix = std::string(std::tmpnam(nullptr)) + ".";
+        xarray<double> expected = arange<double>(42);
+        expected.reshape({6, 7});
+        {
+            auto a = chunked_file_array<double>(prefix, {6, 7}, {2, 3}, 2, 1);
+            // chunks without file hold zeros
+            EXPECT_EQ(a(5, 6), 0.);
+            a = expected;
+            EXPECT_LE(a.chunks().cached_count(), std::size_t(2));
+            EXPECT_EQ(xarray<double>(a), expected);
+        }
+        {
+            auto a = chunked_file_array<double>(prefix, {6, 7}, {2, 3}, 3, 2);
+            const auto& ca = a;
+            EXPECT_EQ(xarray<double>(ca), expected);
+            a += 1.;
+            a.chunks().flush();
+            expected += 1.;
+
+            auto b = chunked_file_array<double>(prefix, {6, 7}, {2, 3}, 1, 0);
+            EXPECT_EQ(xarray<double>(b), expected);
+            EXPECT_EQ(b.chunks().cached_count(), std::size_t(1));
+            remove_chunk_files(a);
+        }
+    }
+}
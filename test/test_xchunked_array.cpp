@@ -0,0 +1,110 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xchunked_array.hpp"
+#include "xtensor/xmath.hpp"
+
+namespace xt
+{
+    TEST(xchunked_array, shape)
+    {
+        auto a = chunked_array<double>({10, 7}, {4, 3});
+        EXPECT_EQ(a.dimension(), std::size_t(2));
+        EXPECT_EQ(a.size(), std::size_t(70));
+        EXPECT_EQ(a.shape()[1], std::size_t(7));
+        EXPECT_EQ(a.chunk_count(), std::size_t(9));
+        EXPECT_EQ(a.grid_shape()[0], std::size_t(3));
+        EXPECT_EQ(a.grid_shape()[1], std::size_t(3));
+        EXPECT_EQ(a.chunks()(2, 2).shape()[0], std::size_t(2));
+        EXPECT_EQ(a.chunks()(2, 2).shape()[1], std::size_t(1));
+
+        std::vector<std::size_t> shape = {5, 6, 2};
+        std::vector<std::size_t> chunk_shape = {2, 2, 2};
+        auto b = chunked_array<int>(shape, chunk_shape);
+        EXPECT_EQ(b.chunk_count(), std::size_t(9));
+
+        EXPECT_THROW(chunked_array<double>({10, 7}, {4, 0}), std::runtime_error);
+    }
+
+    TEST(xchunked_array, access)
+    {
+        auto a = chunked_array<double>({5, 4}, {2, 3});
+        a.fill(0.);
+        a(4, 3) = 2.;
+        a(1, 2) = 1.;
+        EXPECT_EQ(a.chunks()(2, 1)(0, 0), 2.);
+        EXPECT_EQ(a.chunks()(0, 0)(1, 2), 1.);
+        EXPECT_EQ(a(1, 2), 1.);
+        EXPECT_EQ(a(1, 1, 2), 1.);
+        EXPECT_EQ(a.at(4, 3), 2.);
+        EXPECT_THROW(a.at(5, 0), std::out_of_range);
+
+        xarray<double> b = a;
+        EXPECT_EQ(b(4, 3), 2.);
+        EXPECT_EQ(sum(a)(), 3.);
+    }
+
+    TEST(xchunked_array, assign)
+    {
+        xarray<double> b = arange<double>(42);
+        b.reshape({6, 7});
+        xarray<double> c = {1., 2., 3., 4., 5., 6., 7.};
+
+        auto a = chunked_array<double>({6, 7}, {4, 3});
+        a = b + 2. * c;
+        xarray<double> expected = b + 2. * c;
+        EXPECT_EQ(xarray<double>(a), expected);
+
+        a += b;
+        expected += b;
+        EXPECT_EQ(xarray<double>(a), expected);
+
+        a *= 2.;
+        expected *= 2.;
+        EXPECT_EQ(xarray<double>(a), expected);
+
+        a = a - c;
+        expected = expected - c;
+        EXPECT_EQ(xarray<double>(a), expected);
+
+        a = 3.;
+        EXPECT_EQ(a(5, 6), 3.);
+
+        xarray<double> d = arange<double>(12);
+        d.reshape({3, 4});
+        a = d;
+        EXPECT_EQ(a.shape()[0], std::size_t(3));
+        EXPECT_EQ(a.chunk_count(), std::size_t(2));
+        EXPECT_EQ(xarray<double>(a), d);
+
+        EXPECT_THROW(a += b, broadcast_error);
+    }
+
+    TEST(xchunked_array, chunks)
+    {
+        xarray<int> b = arange<int>(30);
+        b.reshape({5, 6});
+        xchunked_array<xarray<xtensor<int, 2>>> a(b, std::vector<std::size_t>{2, 4});
+        EXPECT_EQ(a.chunk_count(), std::size_t(6));
+
+        std::size_t count = 0;
+        a.for_each_chunk([&b, &count](const auto& chunk, const auto& origin) {
+            EXPECT_EQ(chunk(0, 0), b(origin[0], origin[1]));
+            count += chunk.size();
+        });
+        EXPECT_EQ(count, b.size());
+
+        a.for_each_chunk([](auto& chunk, const auto&) { chunk += 1; });
+        EXPECT_EQ(xarray<int>(a), b + 1);
+    }
+}
@@ -256,4 +256,16 @@ namespace xt
         EXPECT_TRUE(isclose(c_t(5, 5), c_t(5, -5))() == false);
 
     }
-}
\ No newline at end of file
+
+    TEST(xcomplex, functor_view_simd)
+    {
+        xarray<std::complex<double>> e =
+            {{1.0       , 1.0 + 2.0i, 3.0       },
+             {1.0 - 1.0i, 2.0       , 4.0 + 4.0i}};
+        EXPECT_TRUE(has_simd_interface<decltype(real(e))>::value);
+
+        xarray<double> res = real(e) + imag(e);
+        xarray<double> expected = {{1., 3., 3.}, {0., 2., 8.}};
+        EXPECT_EQ(res, expected);
+    }
+}
@@ -686,4 +686,40 @@ namespace xt
             EXPECT_EQ(tester.res_ru, b);
         }
     }
+
+    TYPED_TEST(container_semantic, assign_overlap)
+    {
+        operation_tester<std::plus<>, TypeParam> tester;
+
+        {
+            SCOPED_TRACE("no overlap");
+            TypeParam b(tester.ca.shape(), 0);
+            const int* storage = b.data();
+            b = tester.a + tester.ra;
+            EXPECT_EQ(tester.res_rr, b);
+            EXPECT_EQ(storage, b.data());
+        }
+
+        {
+            SCOPED_TRACE("lhs involved in the expression");
+            TypeParam b = tester.a;
+            b = b + tester.ra;
+            EXPECT_EQ(tester.res_rr, b);
+        }
+
+        {
+            SCOPED_TRACE("lhs broadcast and resized");
+            TypeParam b = tester.ua;
+            b = b + tester.a;
+            EXPECT_EQ(tester.res_ru, b);
+        }
+
+        {
+            SCOPED_TRACE("scalar referring to an element of lhs");
+            TypeParam b = tester.a;
+            TypeParam expected = tester.ra + tester.a(0, 0, 0);
+            b = tester.ra + xscalar<const int&>(b(0, 0, 0));
+            EXPECT_EQ(expected, b);
+        }
+    }
 }
@@ -0,0 +1,262 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xcontraction.hpp"
+#include "xtensor/xmanipulation.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xparallel.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    namespace
+    {
+        // integer valued operands, so that the products are exact in any order
+        xarray<double> contraction_operand(const std::vector<std::size_t>& shape, int seed)
+        {
+            xarray<double> res = xarray<double>::from_shape(shape);
+            for (std::size_t i = 0; i < res.size(); ++i)
+            {
+                res.data()[i] = static_cast<double>((static_cast<int>(i) * 7 + seed) % 11 - 5);
+            }
+            return res;
+        }
+
+        xarray<double> naive_matmul(const xarray<double>& a, const xarray<double>& b)
+        {
+            std::size_t m = a.shape()[0];
+            std::size_t k = a.shape()[1];
+            std::size_t n = b.shape()[1];
+            xarray<double> res = zeros<double>({m, n});
+            for (std::size_t i = 0; i < m; ++i)
+            {
+                for (std::size_t p = 0; p < k; ++p)
+                {
+                    for (std::size_t j = 0; j < n; ++j)
+                    {
+                        res(i, j) += a(i, p) * b(p, j);
+                    }
+                }
+            }
+            return res;
+        }
+    }
+
+    TEST(xcontraction, matrix_product)
+    {
+        xarray<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        xarray<double> b = {{1., 0.}, {0., 1.}, {2., -1.}};
+        xarray<double> expected = {{7., -1.}, {16., -1.}};
+        EXPECT_EQ(tensordot(a, b, 1), expected);
+        EXPECT_EQ(tensordot(a, b, {1}, {0}), expected);
+
+        xarray<double> bt = transpose(b);
+        EXPECT_EQ(tensordot(a, bt, {1}, {1}), expected);
+        EXPECT_EQ(tensordot(transpose(bt), transpose(a), {0}, {1}), transpose(expected));
+    }
+
+    TEST(xcontraction, outer_and_full)
+    {
+        xtensor<double, 1> x = {1., 2., 3.};
+        xtensor<double, 1> y = {4., 5.};
+        xarray<double> outer = tensordot(x, y, 0);
+        xarray<double> expected = {{4., 5.}, {8., 10.}, {12., 15.}};
+        EXPECT_EQ(outer, expected);
+
+        xarray<double> dot = tensordot(x, x, 1);
+        EXPECT_EQ(dot.dimension(), std::size_t(0));
+        EXPECT_EQ(dot(), 14.);
+    }
+
+    TEST(xcontraction, axes)
+    {
+        xarray<double> a = contraction_operand({3, 4, 5, 2}, 1);
+        xarray<double> b = contraction_operand({4, 3, 2, 6}, 3);
+        xarray<double> res = tensordot(a, b, {0, 3}, {1, 2});
+        ASSERT_EQ(res.shape(), (std::vector<std::size_t>{4, 5, 4, 6}));
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            for (std::size_t j = 0; j < 5; ++j)
+            {
+                for (std::size_t k = 0; k < 4; ++k)
+                {
+                    for (std::size_t l = 0; l < 6; ++l)
+                    {
+                        double expected = 0.;
+                        for (std::size_t p = 0; p < 3; ++p)
+                        {
+                            for (std::size_t q = 0; q < 2; ++q)
+                            {
+                                expected += a(p, i, j, q) * b(k, p, q, l);
+                            }
+                        }
+                        EXPECT_EQ(res(i, j, k, l), expected);
+                    }
+                }
+            }
+        }
+
+        // the order of the pairs of axes does not matter
+        EXPECT_EQ(tensordot(a, b, {3, 0}, {2, 1}), res);
+        xarray<double> c = contraction_operand({5, 2, 6}, 2);
+        xarray<double> last = tensordot(a, c, 2);
+        xarray<double> explicit_axes = tensordot(a, c, {2, 3}, {0, 1});
+        EXPECT_EQ(last, explicit_axes);
+    }
+
+    TEST(xcontraction, mixed_types)
+    {
+        xarray<int> a = {{1, 2}, {3, 4}};
+        xarray<double> b = {{0.5, 1.}, {1.5, 2.}};
+        auto res = tensordot(a, b, 1);
+        static_assert(std::is_same<decltype(res)::value_type, double>::value, "double result");
+        xarray<double> expected = {{3.5, 5.}, {7.5, 11.}};
+        EXPECT_EQ(res, expected);
+
+        xarray<int> ires = tensordot(a, a * 2, 1);
+        xarray<int> iexpected = {{14, 20}, {30, 44}};
+        EXPECT_EQ(ires, iexpected);
+    }
+
+    TEST(xcontraction, large)
+    {
+        // sizes that are not multiples of the blocks and register tiles
+        xarray<double> a = contraction_operand({203, 301}, 1);
+        xarray<double> b = contraction_operand({301, 157}, 4);
+        xarray<double> expected = naive_matmul(a, b);
+        EXPECT_EQ(tensordot(a, b, 1), expected);
+        {
+            parallel::scoped_settings settings(0, 0);
+            EXPECT_EQ(tensordot(a, b, 1), expected);
+            xarray<double> at = transpose(a);
+            EXPECT_EQ(tensordot(at, b, {0}, {0}), expected);
+        }
+
+        xarray<float> af = cast<float>(a);
+        xarray<float> bf = cast<float>(b);
+        xarray<float> resf = tensordot(af, bf, 1);
+        EXPECT_EQ(resf, cast<float>(expected));
+
+        xarray<int> ai = cast<int>(a);
+        xarray<int> bi = cast<int>(b);
+        xarray<int> resi = tensordot(ai, bi, 1);
+        EXPECT_EQ(resi, cast<int>(expected));
+    }
+
+    TEST(xcontraction, errors)
+    {
+        xarray<double> a = zeros<double>({2, 3});
+        xarray<double> b = zeros<double>({4, 2});
+        EXPECT_THROW(tensordot(a, b, 1), std::runtime_error);
+        EXPECT_THROW(tensordot(a, b, 3), std::runtime_error);
+        EXPECT_THROW(tensordot(a, b, {0}, {0, 1}), std::runtime_error);
+        EXPECT_THROW(tensordot(a, b, {2}, {1}), std::runtime_error);
+        EXPECT_THROW(tensordot(a, a, {0, 0}, {0, 1}), std::runtime_error);
+        EXPECT_NO_THROW(tensordot(a, b, {0}, {1}));
+    }
+
+    TEST(xcontraction, einsum_products)
+    {
+        xarray<double> a = contraction_operand({3, 4}, 1);
+        xarray<double> b = contraction_operand({4, 5}, 2);
+        xarray<double> c = contraction_operand({5, 2}, 3);
+        xarray<double> ab = tensordot(a, b, 1);
+        EXPECT_EQ(einsum("ij,jk->ik", a, b), ab);
+        EXPECT_EQ(einsum("ij,jk", a, b), ab);
+        EXPECT_EQ(einsum("ij,jk->ki", a, b), transpose(ab));
+        EXPECT_EQ(einsum("ij, jk, kl -> il", a, b, c), tensordot(ab, c, 1));
+        EXPECT_EQ(einsum("kl,ij,jk->il", c, a, b), tensordot(ab, c, 1));
+
+        xarray<double> outer = einsum("i,j->ij", xarray<double>(view(a, 0)), xarray<double>(view(b, 1)));
+        EXPECT_EQ(outer, tensordot(xarray<double>(view(a, 0)), xarray<double>(view(b, 1)), 0));
+
+        // labels summed over before any product
+        xarray<double> rows = einsum("ij,kl->ik", a, c);
+        EXPECT_EQ(rows, tensordot(xarray<double>(sum(a, {1})), xarray<double>(sum(c, {1})), 0));
+
+        xarray<int> ia = cast<int>(a);
+        auto mixed = einsum("ij,jk->ik", ia, b);
+        static_assert(std::is_same<decltype(mixed)::value_type, double>::value, "double result");
+        EXPECT_EQ(mixed, ab);
+    }
+
+    TEST(xcontraction, einsum_batch)
+    {
+        xarray<double> x = contraction_operand({6, 3, 4}, 1);
+        xarray<double> y = contraction_operand({6, 4, 5}, 2);
+        xarray<double> res = einsum("bij,bjk->bik", x, y);
+        ASSERT_EQ(res.shape(), (std::vector<std::size_t>{6, 3, 5}));
+        for (std::size_t t = 0; t < 6; ++t)
+        {
+            xarray<double> xs = view(x, t);
+            xarray<double> ys = view(y, t);
+            EXPECT_EQ(xarray<double>(view(res, t)), tensordot(xs, ys, 1));
+        }
+        EXPECT_EQ(einsum("...ij,...jk->...ik", x, y), res);
+        EXPECT_EQ(einsum("bij,bjk->ikb", x, y), transpose(res, {1, 2, 0}));
+        {
+            parallel::scoped_settings settings(0, 0);
+            EXPECT_EQ(einsum("bij,bjk->bik", x, y), res);
+        }
+
+        // elementwise product and sum over a shared label
+        xarray<double> z = contraction_operand({6, 3, 4}, 5);
+        EXPECT_EQ(einsum("bij,bij->bij", x, z), x * z);
+        EXPECT_EQ(einsum("bij,bij->b", x, z), sum(x * z, {1, 2}));
+    }
+
+    TEST(xcontraction, einsum_diagonals)
+    {
+        xarray<double> a = contraction_operand({4, 4}, 1);
+        double trace = 0.;
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            trace += a(i, i);
+        }
+        xarray<double> t = einsum("ii", a);
+        EXPECT_EQ(t.dimension(), std::size_t(0));
+        EXPECT_EQ(t(), trace);
+        EXPECT_EQ(einsum("ii->i", a), diagonal(a));
+        EXPECT_EQ(einsum("ij->", a)(), sum(a)());
+        EXPECT_EQ(einsum("ij->ji", a), transpose(a));
+
+        xarray<double> b = contraction_operand({3, 4, 3}, 2);
+        xarray<double> d = einsum("iji->j", b);
+        for (std::size_t j = 0; j < 4; ++j)
+        {
+            EXPECT_EQ(d(j), b(0, j, 0) + b(1, j, 1) + b(2, j, 2));
+        }
+        xarray<double> v = contraction_operand({4}, 3);
+        EXPECT_EQ(einsum("ii,i->i", a, v), diagonal(a) * v);
+    }
+
+    TEST(xcontraction, einsum_errors)
+    {
+        xarray<double> a = zeros<double>({2, 3});
+        xarray<double> b = zeros<double>({4, 2});
+        EXPECT_THROW(einsum("ij,jk->ik", a, b), std::runtime_error);
+        EXPECT_THROW(einsum("ij", a, b), std::runtime_error);
+        EXPECT_THROW(einsum("ij,jk,kl", a, b), std::runtime_error);
+        EXPECT_THROW(einsum("ijk", a), std::runtime_error);
+        EXPECT_THROW(einsum("ij->k", a), std::runtime_error);
+        EXPECT_THROW(einsum("ij->ii", a), std::runtime_error);
+        EXPECT_THROW(einsum("i1", a), std::runtime_error);
+        EXPECT_THROW(einsum("ii", a), std::runtime_error);
+        EXPECT_NO_THROW(einsum("ij,ki->jk", a, b));
+    }
+}
@@ -0,0 +1,192 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <complex>
+#include <cstddef>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xconvolve.hpp"
+#include "xtensor/xmanipulation.hpp"
+#include "xtensor/xparallel.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    namespace
+    {
+        // full 2-D convolution computed from its definition
+        xarray<double> naive_convolve(const xarray<double>& a, const xarray<double>& v)
+        {
+            std::size_t m0 = a.shape()[0], m1 = a.shape()[1];
+            std::size_t n0 = v.shape()[0], n1 = v.shape()[1];
+            xarray<double> res = zeros<double>({m0 + n0 - 1, m1 + n1 - 1});
+            for (std::size_t i = 0; i < m0; ++i)
+            {
+                for (std::size_t j = 0; j < m1; ++j)
+                {
+                    for (std::size_t k = 0; k < n0; ++k)
+                    {
+                        for (std::size_t l = 0; l < n1; ++l)
+                        {
+                            res(i + k, j + l) += a(i, j) * v(k, l);
+                        }
+                    }
+                }
+            }
+            return res;
+        }
+
+        xarray<double> convolve_operand(std::size_t m, std::size_t n, int seed)
+        {
+            xarray<double> res = xarray<double>::from_shape({m, n});
+            for (std::size_t i = 0; i < res.size(); ++i)
+            {
+                res.data()[i] = static_cast<double>((static_cast<int>(i) * 5 + seed) % 9 - 4);
+            }
+            return res;
+        }
+    }
+
+    TEST(xconvolve, convolve_1d)
+    {
+        xarray<double> a = {1., 2., 3.};
+        xarray<double> v = {0., 1., 0.5};
+        xarray<double> full = {0., 1., 2.5, 4., 1.5};
+        xarray<double> same = {1., 2.5, 4.};
+        xarray<double> valid = {2.5};
+        EXPECT_EQ(convolve(a, v), full);
+        EXPECT_EQ(convolve(a, v, convolve_mode::same), same);
+        EXPECT_EQ(convolve(a, v, convolve_mode::valid), valid);
+
+        // the convolution is commutative
+        xarray<double> b = {1., -1., 2., 0., 3.};
+        xarray<double> ab_same = convolve(a, b, convolve_mode::same);
+        EXPECT_EQ(ab_same, convolve(b, a, convolve_mode::same));
+        EXPECT_EQ(ab_same.size(), std::size_t(5));
+        EXPECT_EQ(convolve(a, b, convolve_mode::valid), convolve(b, a, convolve_mode::valid));
+
+        xtensor<int, 1> ia = {1, 2, 3};
+        xtensor<int, 1> iv = {1, 1};
+        xarray<int> iexpected = {1, 3, 5, 3};
+        EXPECT_EQ(convolve(ia, iv), iexpected);
+
+        // strided operands
+        xarray<double> strided = view(convolve_operand(2, 6, 1), 1, range(0, 6, 2));
+        xarray<double> sexpected = convolve(xarray<double>(strided), v);
+        EXPECT_EQ(convolve(view(convolve_operand(2, 6, 1), 1, range(0, 6, 2)), v), sexpected);
+    }
+
+    TEST(xconvolve, correlate_1d)
+    {
+        xarray<double> a = {1., 2., 3.};
+        xarray<double> v = {0., 1., 0.5};
+        xarray<double> full = {0.5, 2., 3.5, 3., 0.};
+        xarray<double> same = {2., 3.5, 3.};
+        xarray<double> valid = {3.5};
+        EXPECT_EQ(correlate(a, v, convolve_mode::full), full);
+        EXPECT_EQ(correlate(a, v, convolve_mode::same), same);
+        EXPECT_EQ(correlate(a, v), valid);
+
+        // a longer kernel, for which numpy swaps the operands
+        xarray<double> c = {1., 2.};
+        xarray<double> d = {1., 2., 3.};
+        xarray<double> cd_full = {3., 8., 5., 2.};
+        xarray<double> cd_same = {8., 5., 2.};
+        xarray<double> cd_valid = {8., 5.};
+        EXPECT_EQ(correlate(c, d, convolve_mode::full), cd_full);
+        EXPECT_EQ(correlate(c, d, convolve_mode::same), cd_same);
+        EXPECT_EQ(correlate(c, d), cd_valid);
+
+        using complex_type = std::complex<double>;
+        xarray<complex_type> ca = {complex_type(1., 1.), complex_type(2., 0.), complex_type(0., -1.)};
+        xarray<complex_type> cv = {complex_type(0., 1.), complex_type(1., 0.)};
+        xarray<complex_type> cres = correlate(ca, cv);
+        ASSERT_EQ(cres.size(), std::size_t(2));
+        EXPECT_EQ(cres(0), ca(0) * std::conj(cv(0)) + ca(1) * std::conj(cv(1)));
+        EXPECT_EQ(cres(1), ca(1) * std::conj(cv(0)) + ca(2) * std::conj(cv(1)));
+    }
+
+    TEST(xconvolve, large_1d)
+    {
+        std::size_t n = 5003;
+        xarray<double> a = xarray<double>::from_shape({n});
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            a(i) = static_cast<double>(static_cast<int>(i * 7 % 13) - 6);
+        }
+        xarray<double> v = {1., -2., 0., 3., 1., -1., 2.};
+        xarray<double> expected = zeros<double>({n + 6});
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            for (std::size_t t = 0; t < 7; ++t)
+            {
+                expected(i + t) += a(i) * v(t);
+            }
+        }
+        EXPECT_EQ(convolve(a, v), expected);
+        {
+            parallel::scoped_settings settings(0, 0);
+            EXPECT_EQ(convolve(a, v), expected);
+            xarray<double> valid = view(expected, range(6, n));
+            EXPECT_EQ(convolve(a, v, convolve_mode::valid), valid);
+        }
+    }
+
+    TEST(xconvolve, convolve_2d)
+    {
+        xarray<double> a = convolve_operand(13, 11, 1);
+        xarray<double> v = convolve_operand(4, 3, 2);
+        xarray<double> full = naive_convolve(a, v);
+        EXPECT_EQ(convolve(a, v), full);
+        xarray<double> same = view(full, range(1, 14), range(1, 12));
+        EXPECT_EQ(convolve(a, v, convolve_mode::same), same);
+        xarray<double> valid = view(full, range(3, 13), range(2, 11));
+        EXPECT_EQ(convolve(a, v, convolve_mode::valid), valid);
+        {
+            parallel::scoped_settings settings(0, 0);
+            EXPECT_EQ(convolve(a, v), full);
+            EXPECT_EQ(convolve(transpose(a), transpose(v)), transpose(full));
+        }
+
+        // the correlation is the convolution with the flipped kernel
+        xarray<double> flipped = flip(flip(v, 0), 1);
+        EXPECT_EQ(correlate(a, v), convolve(a, flipped, convolve_mode::valid));
+        EXPECT_EQ(correlate(a, v, convolve_mode::full), convolve(a, flipped));
+    }
+
+    TEST(xconvolve, separable)
+    {
+        xarray<double> a = convolve_operand(37, 29, 3);
+        xarray<double> v0 = {1., 2., 1.};
+        xarray<double> v1 = {-1., 0., 1., 2.};
+        xarray<double> v = {{-1., 0., 1., 2.}, {-2., 0., 2., 4.}, {-1., 0., 1., 2.}};
+        EXPECT_EQ(convolve_separable(a, v0, v1), convolve(a, v));
+        EXPECT_EQ(convolve_separable(a, v0, v1, convolve_mode::same), convolve(a, v, convolve_mode::same));
+        {
+            parallel::scoped_settings settings(0, 0);
+            EXPECT_EQ(convolve_separable(a, v0, v1, convolve_mode::valid), convolve(a, v, convolve_mode::valid));
+        }
+    }
+
+    TEST(xconvolve, errors)
+    {
+        xarray<double> a = {1., 2., 3.};
+        xarray<double> m = zeros<double>({2, 2});
+        xarray<double> empty = xarray<double>::from_shape({0});
+        EXPECT_THROW(convolve(a, m), std::runtime_error);
+        EXPECT_THROW(correlate(a, empty), std::runtime_error);
+        EXPECT_THROW(convolve(zeros<double>({2, 2, 2}), zeros<double>({2, 2, 2})), std::runtime_error);
+        EXPECT_THROW(convolve_separable(a, a, a), std::runtime_error);
+        EXPECT_THROW(convolve_separable(m, m, a), std::runtime_error);
+    }
+}
@@ -8,12 +8,19 @@
 
 #include "gtest/gtest.h"
 
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
 #include <sstream>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
 
 #include "xtensor/xcsv.hpp"
 #include "xtensor/xmath.hpp" 
 #include "xtensor/xio.hpp" 
+#include "xtensor/xparallel.hpp"
 
 namespace xt
 {
@@ -45,4 +52,132 @@ namespace xt
         dump_csv(res, data);
         ASSERT_EQ("1,2,3,4\n10,12,15,18\n", res.str());
     }
+
+    TEST(xcsv, dump_round_trip)
+    {
+        xtensor<double, 2> data
+            {{0.1, 1. / 3., -2.5e-300, 1e20},
+             {0.1 + 0.2, -0., 123456.75, 5e-324}};
+
+        std::stringstream res;
+        dump_csv(res, data);
+        EXPECT_EQ(res.str().substr(0, 24), "0.1,0.3333333333333333,-");
+        xtensor<double, 2> loaded = load_csv<double>(res);
+        EXPECT_EQ(loaded, data);
+
+        std::stringstream res_precision;
+        dump_csv(res_precision, data, 3);
+        EXPECT_EQ(res_precision.str(), "0.1,0.333,-2.5e-300,1e+20\n0.3,-0,1.23e+05,4.94e-324\n");
+
+        xtensor<float, 2> fdata = {{0.1f, 1.f / 3.f}};
+        std::stringstream fres;
+        dump_csv(fres, fdata);
+        EXPECT_EQ(fres.str(), "0.1,0.33333334\n");
+
+        xtensor<std::int64_t, 2> idata = {{std::numeric_limits<std::int64_t>::min(), 0, 42}};
+        std::stringstream ires;
+        dump_csv(ires, idata);
+        EXPECT_EQ(ires.str(), "-9223372036854775808,0,42\n");
+    }
+
+    TEST(xcsv, load_formats)
+    {
+        std::stringstream source("1e3,-2.5E-2, .5 \r\n5.,-0,7\n");
+        xtensor<double, 2> res = load_csv<double>(source);
+        xtensor<double, 2> exp = {{1000., -0.025, 0.5}, {5., 0., 7.}};
+        EXPECT_EQ(res, exp);
+
+        std::stringstream isource("1,-2147483648\n2147483647,0");
+        xtensor<int, 2> ires = load_csv<int>(isource);
+        xtensor<int, 2> iexp = {{1, -2147483647 - 1}, {2147483647, 0}};
+        EXPECT_EQ(ires, iexp);
+
+        std::stringstream empty_cell("1,,2");
+        EXPECT_THROW(load_csv<double>(empty_cell), std::runtime_error);
+        std::stringstream invalid("1,abc");
+        EXPECT_THROW(load_csv<double>(invalid), std::runtime_error);
+        std::stringstream overflow("2147483648");
+        EXPECT_THROW(load_csv<int>(overflow), std::out_of_range);
+        std::stringstream inconsistent("1,2\n3");
+        EXPECT_THROW(load_csv<double>(inconsistent), std::runtime_error);
+    }
+
+    TEST(xcsv, load_large)
+    {
+        // larger than the internal buffer of the parser
+        std::string source;
+        std::size_t nrows = 20000;
+        for (std::size_t i = 0; i < nrows; ++i)
+        {
+            source += std::to_string(i) + ".25," + std::to_string(i) + "e-2\n";
+        }
+        std::stringstream source_stream(source);
+        xtensor<double, 2> res = load_csv<double>(source_stream);
+        ASSERT_EQ(res.shape()[0], nrows);
+        ASSERT_EQ(res.shape()[1], std::size_t(2));
+        for (std::size_t i = 0; i < nrows; ++i)
+        {
+            EXPECT_EQ(res(i, 0), double(i) + 0.25);
+            EXPECT_EQ(res(i, 1), std::stod(std::to_string(i) + "e-2"));
+        }
+    }
+
+    TEST(xcsv, load_file)
+    {
+        std::string filename = std::tmpnam(nullptr);
+        {
+            std::ofstream out(filename, std::ios::binary);
+            out << "id;x;y\r\n1;0.5;-3\r\n\n2;1.5;-4\r\n";
+        }
+
+        csv_options options;
+        options.delimiter = ';';
+        options.skip_rows = 1;
+        xtensor<double, 2> res = load_csv<double>(filename, options);
+        xtensor<double, 2> exp = {{1., 0.5, -3.}, {2., 1.5, -4.}};
+        EXPECT_EQ(res, exp);
+
+        options.columns = {2, 0};
+        xtensor<int, 2> ires = load_csv<int>(filename, options);
+        xtensor<int, 2> iexp = {{-3, 1}, {-4, 2}};
+        EXPECT_EQ(ires, iexp);
+
+        options.columns = {1};
+        options.dtypes = {csv_dtype::value_type, csv_dtype::floating};
+        xtensor<int, 2> fres = load_csv<int>(filename, options);
+        xtensor<int, 2> fexp = {{0}, {1}};
+        EXPECT_EQ(fres, fexp);
+
+        options.columns = {3};
+        EXPECT_THROW(load_csv<double>(filename, options), std::runtime_error);
+        options.columns = {};
+        options.skip_rows = 0;
+        EXPECT_THROW(load_csv<double>(filename, options), std::runtime_error);
+        EXPECT_THROW(load_csv<double>(filename + ".missing"), std::runtime_error);
+        std::remove(filename.c_str());
+    }
+
+    TEST(xcsv, load_file_parallel)
+    {
+        std::string filename = std::tmpnam(nullptr);
+        std::size_t nrows = 50000;
+        {
+            std::ofstream out(filename, std::ios::binary);
+            for (std::size_t i = 0; i < nrows; ++i)
+            {
+                out << i << ',' << -double(i) << '\n';
+            }
+        }
+
+        parallel::scoped_settings settings(0, 0);
+        xtensor<double, 2> res = load_csv<double>(filename);
+        ASSERT_EQ(res.shape()[0], nrows);
+        ASSERT_EQ(res.shape()[1], std::size_t(2));
+        for (std::size_t i = 0; i < nrows; ++i)
+        {
+            EXPECT_EQ(res(i, 0), double(i));
+            EXPECT_EQ(res(i, 1), -double(i));
+        }
+        std::remove(filename.c_str());
+    }
 }
@@ -0,0 +1,85 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xdevice.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    TEST(xdevice, transfer)
+    {
+        xarray<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        auto d = device::to_device(a);
+        EXPECT_EQ(d.size(), std::size_t(6));
+        EXPECT_EQ(d.dimension(), std::size_t(2));
+        EXPECT_EQ(device::to_host(d), a);
+
+        xarray<double, layout_type::column_major> c = a;
+        EXPECT_EQ(device::to_host(device::to_device(c)), a);
+        EXPECT_EQ(device::to_host(device::to_device(view(a, all(), 1))), xarray<double>({2., 5.}));
+
+        xdevice_array<double> copy = d;
+        d = device::to_device(a + 1.);
+        EXPECT_EQ(device::to_host(copy), a);
+        EXPECT_EQ(device::to_host(d), a + 1.);
+
+        xdevice_array<double> empty = device::to_device(xarray<double>::from_shape({0, 3}));
+        EXPECT_EQ(empty.size(), std::size_t(0));
+        EXPECT_EQ(device::to_host(empty).shape()[1], std::size_t(3));
+    }
+
+    TEST(xdevice, elementwise)
+    {
+        xarray<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        xarray<double> b = {10., 20., 30.};
+        auto da = device::to_device(a);
+        auto db = device::to_device(b);
+
+        xdevice_array<double> r = da * 2. + db;
+        EXPECT_EQ(device::to_host(r), a * 2. + b);
+
+        r = exp(da) - da / db;
+        EXPECT_TRUE(allclose(device::to_host(r), exp(a) - a / b));
+
+        // the result can be one of the operands
+        r = da;
+        r = r * r + 1.;
+        EXPECT_EQ(device::to_host(r), a * a + 1.);
+
+        auto mask = device::eval(da > 3.);
+        EXPECT_EQ(device::to_host(mask), a > 3.);
+
+        // the result is resized to the broadcast shape
+        xdevice_array<double> s = db;
+        s = da - db;
+        EXPECT_EQ(s.dimension(), std::size_t(2));
+        EXPECT_EQ(device::to_host(s), a - b);
+    }
+
+    TEST(xdevice, reductions)
+    {
+        xarray<int> a = {{1, -7, 3}, {4, 5, 6}};
+        auto d = device::to_device(a);
+        EXPECT_EQ(device::sum(d), sum(a)());
+        EXPECT_EQ(device::amax(d), 6);
+        EXPECT_EQ(device::sum(d * 2 + 1), sum(a * 2 + 1)());
+        EXPECT_EQ(device::amax(abs(d)), 7);
+
+        xdevice_array<int> empty({0});
+        EXPECT_EQ(device::sum(empty), 0);
+        EXPECT_THROW(device::amax(empty), std::runtime_error);
+    }
+}
@@ -0,0 +1,119 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xdispatch.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xparallel.hpp"
+#include "xtensor/xtensor.hpp"
+
+namespace xt
+{
+    TEST(xdispatch, isa)
+    {
+        EXPECT_LE(static_cast<int>(cpu::compiled_isa()), static_cast<int>(cpu::detected_isa()));
+        EXPECT_LE(static_cast<int>(cpu::selected_isa()), static_cast<int>(cpu::detected_isa()));
+        EXPECT_EQ(std::string(cpu::to_string(cpu::isa::avx2)), "avx2");
+        EXPECT_EQ(std::string(cpu::to_string(cpu::isa::generic)), "generic");
+
+        cpu::isa selected = cpu::selected_isa();
+        {
+            cpu::scoped_isa guard(cpu::isa::generic);
+            EXPECT_EQ(cpu::selected_isa(), cpu::isa::generic);
+            EXPECT_EQ(cpu::dispatch_isa(), cpu::isa::generic);
+        }
+        EXPECT_EQ(cpu::selected_isa(), selected);
+        {
+            // the selection is bounded by the processor
+            cpu::scoped_isa guard(cpu::isa::avx512);
+            EXPECT_EQ(cpu::selected_isa(), cpu::detected_isa());
+        }
+        {
+            // the guard only applies to the calling thread
+            cpu::scoped_isa guard(cpu::isa::generic);
+            cpu::isa other = cpu::isa::generic;
+            std::thread t([&other]() { other = cpu::selected_isa(); });
+            t.join();
+            EXPECT_EQ(other, selected);
+            EXPECT_EQ(cpu::selected_isa(), cpu::isa::generic);
+        }
+    }
+
+    TEST(xdispatch, linear_assign)
+    {
+        parallel::scoped_settings settings(0, 0);
+        std::size_t n = 1003;
+        xtensor<double, 1> a = arange<double>(double(n));
+        xtensor<double, 1> b = arange<double>(double(n)) * 0.5 + 1.;
+
+        xtensor<double, 1> sum_ref, prod_ref, div_ref, scal_ref;
+        xtensor<float, 1> conv_ref;
+        {
+            cpu::scoped_isa guard(cpu::isa::generic);
+            sum_ref = a + b;
+            prod_ref = a * b;
+            div_ref = a / b;
+            scal_ref = a * 2. - 1.;
+            conv_ref = a;
+        }
+
+        xtensor<double, 1> res = zeros<double>({n});
+        noalias(res) = a + b;
+        EXPECT_EQ(res, sum_ref);
+        noalias(res) = a * b;
+        EXPECT_EQ(res, prod_ref);
+        noalias(res) = a / b;
+        EXPECT_EQ(res, div_ref);
+        noalias(res) = a - b;
+        EXPECT_EQ(res(10), a(10) - b(10));
+        xtensor<double, 1> scal = a * 2. - 1.;
+        EXPECT_EQ(scal, scal_ref);
+        xtensor<float, 1> conv = a;
+        EXPECT_EQ(conv, conv_ref);
+        xarray<int> ia = arange<int>(int(n));
+        xarray<int> isum = ia + ia;
+        EXPECT_EQ(isum(n - 1), 2 * int(n - 1));
+    }
+
+    TEST(xdispatch, reducers)
+    {
+        std::size_t n = 4099;
+        // values whose sums and products are exact in any order
+        xtensor<double, 1> a = arange<double>(double(n));
+        xtensor<double, 1> b = ones<double>({n});
+        b(7) = 2.;
+        b(2000) = 0.5;
+        b(n - 1) = 4.;
+
+        double sum_ref, prod_ref;
+        {
+            cpu::scoped_isa guard(cpu::isa::generic);
+            sum_ref = sum(a, evaluation_strategy::immediate())();
+            prod_ref = prod(b, evaluation_strategy::immediate())();
+        }
+        EXPECT_EQ(sum_ref, double(n * (n - 1) / 2));
+        EXPECT_EQ(prod_ref, 4.);
+        EXPECT_EQ(sum(a, evaluation_strategy::immediate())(), sum_ref);
+        EXPECT_EQ(prod(b, evaluation_strategy::immediate())(), prod_ref);
+
+        xtensor<int, 1> ia = arange<int>(int(n));
+        EXPECT_EQ(sum(ia, evaluation_strategy::immediate())(), int(n * (n - 1) / 2));
+
+        // too small to fill the lanes of the kernel
+        xtensor<double, 1> small = arange<double>(10.);
+        EXPECT_EQ(sum(small, evaluation_strategy::immediate())(), 45.);
+    }
+}
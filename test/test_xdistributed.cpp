@@ -0,0 +1,86 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xdistributed.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    using shape_vector = std::vector<std::size_t>;
+
+    TEST(xdistributed, partition)
+    {
+        std::vector<std::size_t> shape = {10, 9, 4};
+        std::size_t total = 0;
+        for (int r = 0; r < 6; ++r)
+        {
+            distributed::partition p(shape, {0, 1}, 6, r);
+            EXPECT_EQ(p.grid_shape(), shape_vector({3, 2, 1}));
+            total += p.local_shape()[0] * p.local_shape()[1] * p.local_shape()[2];
+        }
+        EXPECT_EQ(total, std::size_t(360));
+
+        distributed::partition p(shape, {0, 1}, 6, 3);
+        EXPECT_EQ(p.coordinates(), shape_vector({1, 1, 0}));
+        EXPECT_EQ(p.local_shape(), shape_vector({3, 4, 4}));
+        EXPECT_EQ(p.local_offset(), shape_vector({4, 5, 0}));
+        EXPECT_EQ(p.neighbor(0, -1), 1);
+        EXPECT_EQ(p.neighbor(0, 1), 5);
+        EXPECT_EQ(p.neighbor(1, -1), 2);
+        EXPECT_EQ(p.neighbor(1, 1), distributed::no_rank);
+
+        distributed::partition single(shape, {2}, 1, 0);
+        EXPECT_EQ(single.local_shape(), shape);
+        EXPECT_EQ(single.neighbor(2, 1), distributed::no_rank);
+
+        EXPECT_THROW(distributed::partition(shape, {0, 0}, 2, 0), std::runtime_error);
+        EXPECT_THROW(distributed::partition(shape, {3}, 2, 0), std::runtime_error);
+        EXPECT_THROW(distributed::partition(shape, {2}, 5, 0), std::runtime_error);
+        EXPECT_THROW(distributed::partition(shape, {}, 2, 0), std::runtime_error);
+    }
+
+#ifndef XTENSOR_USE_MPI
+    TEST(xdistributed, single_rank)
+    {
+        xtensor<double, 2> g = {{1., 2., 3.}, {4., 5., 6.}, {7., 8., 9.}, {10., 11., 12.}};
+        xdistributed<double, 2> d({4, 3}, {0}, 1);
+        EXPECT_EQ(d.local_data().shape()[0], std::size_t(6));
+        EXPECT_EQ(d.local_data().shape()[1], std::size_t(3));
+
+        d.local() = g;
+        EXPECT_EQ(d.local(), g);
+        EXPECT_EQ(distributed::sum(d), 78.);
+        EXPECT_EQ(distributed::amax(d), 12.);
+        EXPECT_EQ(distributed::mean(d), 6.5);
+
+        // boundary conditions in the halos are kept by the exchange
+        view(d.local_data(), 0, all()) = 0.;
+        view(d.local_data(), 5, all()) = 0.;
+        d.exchange_halos();
+        xtensor<double, 2> diff = d.shifted(0, 1) - d.shifted(0, -1);
+        xtensor<double, 2> expected = {{4., 5., 6.}, {6., 6., 6.}, {6., 6., 6.}, {-7., -8., -9.}};
+        EXPECT_EQ(diff, expected);
+
+        xdistributed<double, 2> e({4, 3}, {0}, 1);
+        e.local() = 2. * d.local() + 1.;
+        EXPECT_EQ(e.local(), 2. * g + 1.);
+
+        EXPECT_THROW(d.shifted(0, 2), std::runtime_error);
+        EXPECT_THROW(d.shifted(1, 1), std::runtime_error);
+        EXPECT_THROW((xdistributed<double, 2>({4, 3}, {0}, 5)), std::runtime_error);
+    }
+#endif
+}
@@ -0,0 +1,72 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xdlpack.hpp"
+#include "xtensor/xtensor.hpp"
+
+namespace xt
+{
+    TEST(xdlpack, round_trip)
+    {
+        xarray<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        const double* data = a.data();
+
+        DLManagedTensor* tensor = to_dlpack(std::move(a));
+        EXPECT_EQ(tensor->dl_tensor.data, data);
+        EXPECT_EQ(tensor->dl_tensor.ndim, 2);
+        EXPECT_EQ(tensor->dl_tensor.shape[1], 3);
+        EXPECT_EQ(tensor->dl_tensor.strides[0], 3);
+        EXPECT_EQ(tensor->dl_tensor.dtype.code, std::uint8_t(kDLFloat));
+        EXPECT_EQ(tensor->dl_tensor.dtype.bits, std::uint8_t(64));
+
+        auto b = from_dlpack<double>(tensor);
+        EXPECT_EQ(b.data(), data);
+        EXPECT_EQ(b.layout(), layout_type::row_major);
+        EXPECT_EQ(b(1, 2), 6.);
+        b(0, 0) = 10.;
+        EXPECT_EQ(*data, 10.);
+
+        DLManagedTensor* exported = to_dlpack(b);
+        EXPECT_THROW(from_dlpack<float>(exported), std::runtime_error);
+        exported->deleter(exported);
+    }
+
+    TEST(xdlpack, strides)
+    {
+        xtensor<int, 2> a = {{1, 2, 3}, {4, 5, 6}};
+        std::vector<std::int64_t> shape = {3, 2};
+        std::vector<std::int64_t> strides = {1, 3};
+
+        bool released = false;
+        DLManagedTensor tensor;
+        tensor.dl_tensor.data = a.data();
+        tensor.dl_tensor.device.device_type = kDLCPU;
+        tensor.dl_tensor.device.device_id = 0;
+        tensor.dl_tensor.ndim = 2;
+        tensor.dl_tensor.dtype.code = kDLInt;
+        tensor.dl_tensor.dtype.bits = 32;
+        tensor.dl_tensor.dtype.lanes = 1;
+        tensor.dl_tensor.shape = shape.data();
+        tensor.dl_tensor.strides = strides.data();
+        tensor.dl_tensor.byte_offset = 0;
+        tensor.manager_ctx = &released;
+        tensor.deleter = [](DLManagedTensor* self) { *static_cast<bool*>(self->manager_ctx) = true; };
+
+        {
+            auto b = from_dlpack<int>(&tensor);
+            EXPECT_EQ(b.layout(), layout_type::column_major);
+            EXPECT_EQ(b(2, 0), 3);
+            EXPECT_EQ(b(0, 1), 4);
+            auto c = b;
+            EXPECT_FALSE(released);
+        }
+        EXPECT_TRUE(released);
+    }
+}
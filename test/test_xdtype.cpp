@@ -0,0 +1,140 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xdtype.hpp"
+#include "xtensor/xnpy.hpp"
+#include "xtensor/xstrided_view.hpp"
+#include "xtensor/xtensor.hpp"
+
+namespace xt
+{
+    TEST(xdtype, dtype)
+    {
+        EXPECT_EQ(dtype_of<bool>::value, dtype::boolean);
+        EXPECT_EQ(dtype_of<std::int16_t>::value, dtype::int16);
+        EXPECT_EQ(dtype_of<unsigned long long>::value, dtype::uint64);
+        EXPECT_EQ(dtype_of<double>::value, dtype::float64);
+        EXPECT_EQ(itemsize(dtype::uint32), std::size_t(4));
+        EXPECT_EQ(std::string(to_string(dtype::float32)), "float32");
+
+        EXPECT_EQ(promote_types(dtype::boolean, dtype::int8), dtype::int8);
+        EXPECT_EQ(promote_types(dtype::int8, dtype::uint8), dtype::int16);
+        EXPECT_EQ(promote_types(dtype::int16, dtype::uint32), dtype::int64);
+        EXPECT_EQ(promote_types(dtype::int64, dtype::uint64), dtype::float64);
+        EXPECT_EQ(promote_types(dtype::uint16, dtype::float32), dtype::float32);
+        EXPECT_EQ(promote_types(dtype::int32, dtype::float32), dtype::float64);
+        EXPECT_EQ(promote_types(dtype::float32, dtype::float64), dtype::float64);
+    }
+
+    TEST(xdtype, array)
+    {
+        xarray<int> a = {{1, 2, 3}, {4, 5, 6}};
+        xdtype_array d(a);
+        EXPECT_EQ(d.type(), dtype::int32);
+        EXPECT_EQ(d.dimension(), std::size_t(2));
+        EXPECT_EQ(d.size(), std::size_t(6));
+        EXPECT_EQ(d.nbytes(), 6 * sizeof(int));
+        EXPECT_EQ(d.as<int>(), a);
+        EXPECT_THROW(d.as<float>(), std::runtime_error);
+
+        d.as<int>()(1, 2) = 7;
+        std::size_t size = d.visit([](const auto& e) { return e.size(); });
+        EXPECT_EQ(size, std::size_t(6));
+
+        xdtype_array f = d.astype(dtype::float32);
+        EXPECT_EQ(f.type(), dtype::float32);
+        EXPECT_EQ(f.as<float>(), xarray<float>({{1.f, 2.f, 3.f}, {4.f, 5.f, 7.f}}));
+
+        xdtype_array c(dtype::int16, {2, 2}, layout_type::column_major);
+        c.as<std::int16_t>() = xarray<std::int16_t>({{1, 2}, {3, 4}});
+        EXPECT_EQ(c.layout(), layout_type::column_major);
+        EXPECT_EQ(static_cast<const std::int16_t*>(c.data())[1], std::int16_t(3));
+    }
+
+    TEST(xdtype, operators)
+    {
+        xdtype_array a(xarray<std::int8_t>({{1, 2, 3}, {4, 5, 6}}));
+        xdtype_array b(xarray<std::uint8_t>({10, 20, 30}));
+        xdtype_array c(xarray<float>({{0.5f, 1.5f, 2.5f}, {3.5f, 4.5f, 5.5f}}));
+
+        xdtype_array s = a + b;
+        EXPECT_EQ(s.type(), dtype::int16);
+        EXPECT_EQ(s.as<std::int16_t>(), xarray<std::int16_t>({{11, 22, 33}, {14, 25, 36}}));
+
+        xdtype_array m = a * c;
+        EXPECT_EQ(m.type(), dtype::float32);
+        EXPECT_EQ(m.as<float>(), xarray<float>({{0.5f, 3.f, 7.5f}, {14.f, 22.5f, 33.f}}));
+
+        xdtype_array d = b - a;
+        EXPECT_EQ(d.as<std::int16_t>(), xarray<std::int16_t>({{9, 18, 27}, {6, 15, 24}}));
+
+        // the division of integers is a true division
+        xdtype_array q = a / xdtype_array(xarray<std::int32_t>({2}));
+        EXPECT_EQ(q.type(), dtype::float64);
+        EXPECT_EQ(q.as<double>(), xarray<double>({{0.5, 1., 1.5}, {2., 2.5, 3.}}));
+    }
+
+    TEST(xdtype, reducers)
+    {
+        xarray<std::int16_t> a = reshape_view(arange<std::int16_t>(12), {3, 4});
+        xdtype_array d(a);
+
+        xdtype_array s = d.sum();
+        EXPECT_EQ(s.type(), dtype_of<big_promote_type_t<std::int16_t>>::value);
+        EXPECT_EQ(s.dimension(), std::size_t(0));
+        EXPECT_EQ(s.as<big_promote_type_t<std::int16_t>>()(), big_promote_type_t<std::int16_t>(66));
+
+        xdtype_array s1 = d.sum({1});
+        xarray<big_promote_type_t<std::int16_t>> expected1 = sum(a, {1});
+        EXPECT_EQ(s1.as<big_promote_type_t<std::int16_t>>(), expected1);
+
+        xdtype_array mn = d.amin({0});
+        EXPECT_EQ(mn.type(), dtype::int16);
+        EXPECT_EQ(mn.as<std::int16_t>(), xarray<std::int16_t>({0, 1, 2, 3}));
+        EXPECT_EQ(d.amax().as<std::int16_t>()(), std::int16_t(11));
+
+        xdtype_array mean0 = d.mean({0});
+        EXPECT_EQ(mean0.type(), dtype::float64);
+        EXPECT_EQ(mean0.as<double>(), xarray<double>({4., 5., 6., 7.}));
+
+        xdtype_array p = xdtype_array(xarray<double>({1., 2., 3., 4.})).prod();
+        EXPECT_EQ(p.as<double>()(), 24.);
+    }
+
+    TEST(xdtype, npy)
+    {
+        xarray<double> expected = load_npy<double>("files/xnpy_files/double.npy");
+        xdtype_array d = load_npy_dtype("files/xnpy_files/double.npy");
+        EXPECT_EQ(d.type(), dtype::float64);
+        EXPECT_EQ(d.as<double>(), expected);
+
+        xdtype_array b = load_npy_dtype("files/xnpy_files/bool.npy");
+        EXPECT_EQ(b.type(), dtype::boolean);
+        EXPECT_EQ(b.as<bool>(), load_npy<bool>("files/xnpy_files/bool.npy"));
+
+        std::string filename = std::tmpnam(nullptr);
+        filename += ".npy";
+        xdtype_array i(xarray<std::uint16_t>({{1, 2}, {3, 4}}));
+        dump_npy(filename, i);
+        xdtype_array li = load_npy_dtype(filename);
+        EXPECT_EQ(li.type(), dtype::uint16);
+        EXPECT_EQ(li.as<std::uint16_t>(), i.as<std::uint16_t>());
+        std::remove(filename.c_str());
+    }
+}
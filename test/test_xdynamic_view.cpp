@@ -188,6 +188,41 @@ namespace xt
         EXPECT_EQ(view0, exp);
     }
 
+    TEST(xdynamic_view, reset_slices)
+    {
+        xarray<int> a = { {{0, 1, 2, 3},
+                           {4, 5, 6, 7},
+                           {8, 9, 10, 11}},
+                          {{12, 13, 14, 15},
+                           {16, 17, 18, 19},
+                           {20, 21, 22, 23}} };
+
+        std::array<xdynamic_slice<std::ptrdiff_t>, 2> slices = {{ 0, range(1, 3) }};
+        auto v = dynamic_view(a, slices);
+        xarray<int> exp0 = { {4, 5, 6, 7}, {8, 9, 10, 11} };
+        EXPECT_EQ(v, exp0);
+
+        slices[0] = 1;
+        slices[1] = range(0, 2);
+        v.reset_slices(slices);
+        xarray<int> exp1 = { {12, 13, 14, 15}, {16, 17, 18, 19} };
+        EXPECT_EQ(v, exp1);
+
+        xdynamic_slice_vector sv = { 1, keep(0, 2), range(1, 4) };
+        v.reset_slices(sv);
+        xarray<int> exp2 = { {13, 14, 15}, {21, 22, 23} };
+        EXPECT_EQ(v, exp2);
+        v(1, 0) = 100;
+        EXPECT_EQ(a(1, 2, 1), 100);
+
+        slices[0] = all();
+        slices[1] = 2;
+        v.reset_slices(slices);
+        xarray<int> exp3 = { {8, 9, 10, 11}, {20, 21, 22, 23} };
+        exp3(1, 1) = 100;
+        EXPECT_EQ(v, exp3);
+    }
+
     TEST(xdynamic_view, slice_conversion)
     {
         xrange<std::size_t> ru(std::size_t(1), std::size_t(12));
@@ -13,6 +13,8 @@
 #include "xtensor/xbuilder.hpp"
 #include "xtensor/xarray.hpp"
 #include "xtensor/xtensor.hpp"
+#include "xtensor/xmanipulation.hpp"
+#include "xtensor/xutils.hpp"
 
 namespace xt
 {
@@ -59,4 +61,42 @@ namespace xt
         EXPECT_TRUE(type_eq_2);
 #endif
     }
+
+    TEST(xeval, allocator)
+    {
+        xarray<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        xtensor<double, 2> t = a;
+
+        auto r = eval(a * 2., arena_allocator<float>());
+        bool type_eq = std::is_same<decltype(r), xarray<double, XTENSOR_DEFAULT_LAYOUT, arena_allocator<double>>>::value;
+        EXPECT_TRUE(type_eq);
+        EXPECT_EQ(r, a * 2.);
+
+        auto u = eval(transpose(t), std::allocator<double>());
+        bool type_eq_2 = std::is_same<decltype(u), xtensor<double, 2, XTENSOR_DEFAULT_LAYOUT, std::allocator<double>>>::value;
+        EXPECT_TRUE(type_eq_2);
+        EXPECT_EQ(u, transpose(t));
+
+        // containers are copied as well
+        auto c = eval(a, std::allocator<double>());
+        EXPECT_NE(c.data(), a.data());
+        EXPECT_EQ(c, a);
+    }
+
+    TEST(xeval, eval_into)
+    {
+        xarray<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        xarray<double> out;
+        eval_into(out, a + 1.);
+        EXPECT_EQ(out, a + 1.);
+
+        const double* data = out.data();
+        eval_into(out, transpose(a) * 2.);
+        EXPECT_EQ(out, transpose(a) * 2.);
+        EXPECT_EQ(out.data(), data);
+
+        xtensor<double, 2> t = xt::zeros<double>({2, 3});
+        EXPECT_EQ(&eval_into(t, a - 1.), &t);
+        EXPECT_EQ(t, a - 1.);
+    }
 }
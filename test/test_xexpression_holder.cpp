@@ -9,6 +9,10 @@
 
 #include "gtest/gtest.h"
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
 #include "xtensor/xarray.hpp"
 #include "xtensor/xexpression_holder.hpp"
 
@@ -69,4 +73,27 @@ namespace xt
 
         ASSERT_EQ(a, b);
     }
+
+#if defined(XTENSOR_JSON_BINARY)
+    TEST(xexpression_holder, binary)
+    {
+        xarray<int> a = {{2, 3, 4, 5}, {6, 7, 8, 9}};
+        xexpression_holder holder_a = xexpression_holder(a);
+
+        nlohmann::json json_out;
+        to_json_binary(json_out, holder_a);
+        std::vector<std::uint8_t> msgpack = nlohmann::json::to_msgpack(json_out);
+
+        xexpression_holder holder_b;
+        from_json(nlohmann::json::from_msgpack(msgpack), holder_b);
+        nlohmann::json json_b;
+        to_json(json_b, holder_b);
+        ASSERT_EQ(json_b[0][0], 2);
+        ASSERT_EQ(json_b[1][3], 9);
+
+        xarray<std::string> s = {"a", "b"};
+        xexpression_holder holder_s(s);
+        EXPECT_THROW(to_json_binary(json_out, holder_s), std::runtime_error);
+    }
+#endif
 }
@@ -0,0 +1,126 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+#include "gtest/gtest.h"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xfast_math.hpp"
+#include "xtensor/xtensor.hpp"
+
+namespace xt
+{
+    namespace
+    {
+        // maximal relative error of res against f(x), or absolute error if
+        // relative is false
+        template <class E1, class E2, class F>
+        double max_error(const E1& x, const E2& res, F f, bool relative = true)
+        {
+            double err = 0.;
+            for (std::size_t i = 0; i < x.size(); ++i)
+            {
+                double ref = f(static_cast<double>(x(i)));
+                double diff = std::abs(static_cast<double>(res(i)) - ref);
+                err = std::max(err, relative && ref != 0. ? diff / std::abs(ref) : diff);
+            }
+            return err;
+        }
+
+        double std_exp(double x) { return std::exp(x); }
+        double std_log(double x) { return std::log(x); }
+        double std_sin(double x) { return std::sin(x); }
+        double std_cos(double x) { return std::cos(x); }
+        double std_tanh(double x) { return std::tanh(x); }
+        double std_erf(double x) { return std::erf(x); }
+    }
+
+    TEST(xfast_math, exp)
+    {
+        xtensor<double, 1> x = linspace<double>(-708., 709., 100001);
+        xtensor<double, 1> res = fast::exp(x);
+        EXPECT_LT(max_error(x, res, std_exp), 1e-6);
+
+        xtensor<float, 1> xf = linspace<float>(-87.f, 88.f, 100001);
+        xtensor<float, 1> resf = fast::exp(xf);
+        EXPECT_LT(max_error(xf, resf, std_exp), 1e-6);
+
+        xtensor<double, 1> special = {-1000., 1000., std::numeric_limits<double>::quiet_NaN()};
+        xtensor<double, 1> ress = fast::exp(special);
+        EXPECT_EQ(ress(0), 0.);
+        EXPECT_EQ(ress(1), std::numeric_limits<double>::infinity());
+        EXPECT_TRUE(std::isnan(ress(2)));
+    }
+
+    TEST(xfast_math, log)
+    {
+        xtensor<double, 1> x = exp(linspace<double>(-740., 700., 100001));
+        xtensor<double, 1> res = fast::log(x);
+        EXPECT_LT(max_error(x, res, std_log), 1e-6);
+
+        xtensor<float, 1> xf = linspace<float>(0.5f, 2.f, 100001);
+        xtensor<float, 1> resf = fast::log(xf);
+        EXPECT_LT(max_error(xf, resf, std_log), 1e-6);
+
+        xtensor<double, 1> special = {0., -1., std::numeric_limits<double>::infinity(), std::numeric_limits<double>::denorm_min()};
+        xtensor<double, 1> ress = fast::log(special);
+        EXPECT_EQ(ress(0), -std::numeric_limits<double>::infinity());
+        EXPECT_TRUE(std::isnan(ress(1)));
+        EXPECT_EQ(ress(2), std::numeric_limits<double>::infinity());
+        EXPECT_NEAR(ress(3), std::log(std::numeric_limits<double>::denorm_min()), 1e-3);
+    }
+
+    TEST(xfast_math, sin_cos)
+    {
+        xtensor<double, 1> x = linspace<double>(-1e4, 1e4, 100001);
+        xtensor<double, 1> s = fast::sin(x);
+        xtensor<double, 1> c = fast::cos(x);
+        EXPECT_LT(max_error(x, s, std_sin, false), 1e-6);
+        EXPECT_LT(max_error(x, c, std_cos, false), 1e-6);
+
+        xtensor<float, 1> xf = linspace<float>(-1e4f, 1e4f, 100001);
+        xtensor<float, 1> sf = fast::sin(xf);
+        xtensor<float, 1> cf = fast::cos(xf);
+        EXPECT_LT(max_error(xf, sf, std_sin, false), 1e-6);
+        EXPECT_LT(max_error(xf, cf, std_cos, false), 1e-6);
+    }
+
+    TEST(xfast_math, tanh_erf)
+    {
+        xtensor<double, 1> x = linspace<double>(-20., 20., 100001);
+        xtensor<double, 1> t = fast::tanh(x);
+        xtensor<double, 1> e = fast::erf(x);
+        EXPECT_LT(max_error(x, t, std_tanh), 1e-5);
+        EXPECT_LT(max_error(x, e, std_erf), 1e-5);
+
+        xtensor<float, 1> xf = linspace<float>(-20.f, 20.f, 100001);
+        xtensor<float, 1> tf = fast::tanh(xf);
+        xtensor<float, 1> ef = fast::erf(xf);
+        EXPECT_LT(max_error(xf, tf, std_tanh), 1e-5);
+        EXPECT_LT(max_error(xf, ef, std_erf), 1e-5);
+    }
+
+    TEST(xfast_math, expression)
+    {
+        xarray<double> a = {{0.5, 1., 2.}, {3., 4., 5.}};
+        xarray<int> b = {1, 2, 3};
+        xarray<double> res = fast::exp(fast::log(a)) + fast::sin(b) * fast::cos(b);
+        for (std::size_t i = 0; i < 2; ++i)
+        {
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                double expected = a(i, j) + std::sin(b(j)) * std::cos(b(j));
+                EXPECT_NEAR(res(i, j), expected, 1e-5);
+            }
+        }
+    }
+}
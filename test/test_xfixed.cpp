@@ -18,6 +18,8 @@
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xnoalias.hpp"
 #include "xtensor/xmanipulation.hpp"
+#include "xtensor/xreducer.hpp"
+#include "xtensor/xmath.hpp"
 
 // On VS2015, when compiling in x86 mode, alignas(T) leads to C2718
 // when used for a function parameter, even indirectly. This means that
@@ -270,6 +272,25 @@ namespace xt
         xt::noalias(Eps) = Epsd * 123;
         // Eps = Epsd * 123; <-- Enable after XTL release!
     }
+
+    TEST(xtensor_fixed, unrolled_assignment)
+    {
+        xtensor_fixed<double, xshape<3, 3>> a = {{1., 2., 3.}, {4., 5., 6.}, {7., 8., 9.}};
+        xtensor_fixed<double, xshape<3, 3>> b = {{1., 1., 1.}, {2., 2., 2.}, {3., 3., 3.}};
+        xtensor_fixed<double, xshape<3, 3>> c;
+        c = 2. * a + b;
+        EXPECT_EQ(c(0, 0), 3.);
+        EXPECT_EQ(c(1, 2), 14.);
+        EXPECT_EQ(c(2, 2), 21.);
+
+        xtensor_fixed<float, xshape<3, 3>> d = a - b;
+        EXPECT_EQ(d(2, 1), 5.f);
+
+        auto s = sum(a, evaluation_strategy::immediate());
+        EXPECT_EQ(s(), 45.);
+        auto m = amax(c, evaluation_strategy::immediate());
+        EXPECT_EQ(m(), 21.);
+    }
 }
 
 #endif
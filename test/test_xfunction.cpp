@@ -6,9 +6,13 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <numeric>
+
 #include "gtest/gtest.h"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xstrided_view.hpp"
 #include "xtensor/xview.hpp"
+#include "xtensor/xbuilder.hpp"
 #include "test_common.hpp"
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xfixed.hpp"
@@ -336,6 +340,52 @@ namespace xt
         }
     }
 
+    TEST(xfunction, linear_iterator)
+    {
+        xtensor<double, 2> a = {{1., 2., 3.}, {4., 5., 6.}};
+        xtensor<double, 2> b = {{6., 5., 4.}, {3., 2., 1.}};
+        xtensor<double, 1> c = {1., 2., 3.};
+
+        auto f = a * b + 2.;
+        EXPECT_TRUE(f.begin().is_linear());
+        EXPECT_EQ(std::accumulate(f.begin(), f.end(), 0.), 68.);
+        EXPECT_EQ(f.end() - f.begin(), 6);
+        EXPECT_EQ(*(f.begin() + 4), 12.);
+        EXPECT_EQ(*f.rbegin(), 8.);
+        EXPECT_EQ(*f.begin<layout_type::column_major>(), 8.);
+
+        auto g = a + c;
+        EXPECT_FALSE(g.begin().is_linear());
+        EXPECT_EQ(std::accumulate(g.begin(), g.end(), 0.), 33.);
+        EXPECT_EQ(*(g.begin() + 4), 7.);
+        EXPECT_EQ(*g.rbegin(), 9.);
+    }
+
+    TEST(xfunction, stepper_assign_runs)
+    {
+        // Rows longer than the run buffer, broadcast and scalar operands
+        xarray<double> a = xt::reshape_view(xt::arange<double>(3 * 150), {3, 1, 150});
+        xarray<int> b = xt::reshape_view(xt::arange<int>(5 * 150), {5, 150});
+        auto f = 2. * a - b + 1;
+
+        xarray<double> row_major = f;
+        xarray<double, layout_type::column_major> column_major = f;
+        xarray<long> converted = f;
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            for (std::size_t j = 0; j < 5; ++j)
+            {
+                for (std::size_t k = 0; k < 150; ++k)
+                {
+                    double expected = 2. * a(i, 0, k) - b(j, k) + 1;
+                    EXPECT_EQ(row_major(i, j, k), expected);
+                    EXPECT_EQ(column_major(i, j, k), expected);
+                    EXPECT_EQ(converted(i, j, k), static_cast<long>(expected));
+                }
+            }
+        }
+    }
+
     TEST(xfunction, xfunction_in_xfunction)
     {
         using Point3 = xt::xtensor_fixed<double, xshape<3>>;
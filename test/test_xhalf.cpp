@@ -0,0 +1,176 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xhalf.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    TEST(xhalf, float16_conversion)
+    {
+        EXPECT_EQ(float16(1.f).bits(), 0x3c00);
+        EXPECT_EQ(float16(-2.f).bits(), 0xc000);
+        EXPECT_EQ(float16(0.f).bits(), 0x0000);
+        EXPECT_EQ(float16(65504.f).bits(), 0x7bff);
+        EXPECT_EQ(float16(65519.f).bits(), 0x7bff);
+        EXPECT_EQ(float16(65520.f).bits(), 0x7c00);
+        EXPECT_EQ(float16(std::ldexp(1.f, -24)).bits(), 0x0001);
+        EXPECT_EQ(float16(std::ldexp(1.f, -25)).bits(), 0x0000);
+        EXPECT_EQ(float16(std::ldexp(1.5f, -25)).bits(), 0x0001);
+        EXPECT_EQ(float16(std::ldexp(1.f, -14)).bits(), 0x0400);
+        // ties round to even
+        EXPECT_EQ(float16(1.f + std::ldexp(1.f, -11)).bits(), 0x3c00);
+        EXPECT_EQ(float16(1.f + 3.f * std::ldexp(1.f, -11)).bits(), 0x3c02);
+        EXPECT_TRUE(std::isnan(static_cast<float>(float16(std::numeric_limits<float>::quiet_NaN()))));
+        EXPECT_EQ(float16(std::numeric_limits<float>::infinity()).bits(), 0x7c00);
+
+        // doubles are rounded once
+        double above_tie = 1. + std::ldexp(1., -11) + std::ldexp(1., -40);
+        EXPECT_EQ(float16(above_tie).bits(), 0x3c01);
+        EXPECT_EQ(float16(1e10).bits(), 0x7c00);
+        EXPECT_EQ(float16(3).bits(), 0x4200);
+
+        // every value converts exactly to float and back
+        for (std::uint32_t b = 0; b < 0x10000u; ++b)
+        {
+            float16 h = float16::from_bits(static_cast<std::uint16_t>(b));
+            float f = h;
+            if (std::isnan(f))
+            {
+                EXPECT_TRUE(std::isnan(static_cast<float>(float16(f))));
+            }
+            else
+            {
+                EXPECT_EQ(float16(f).bits(), h.bits());
+            }
+        }
+    }
+
+    TEST(xhalf, bfloat16_conversion)
+    {
+        EXPECT_EQ(bfloat16(1.f).bits(), 0x3f80);
+        EXPECT_EQ(bfloat16(-2.f).bits(), 0xc000);
+        EXPECT_EQ(static_cast<float>(bfloat16::from_bits(0x4049)), 3.140625f);
+        // ties round to even
+        EXPECT_EQ(bfloat16(1.f + std::ldexp(1.f, -8)).bits(), 0x3f80);
+        EXPECT_EQ(bfloat16(1.f + 3.f * std::ldexp(1.f, -8)).bits(), 0x3f82);
+        EXPECT_EQ(bfloat16(std::numeric_limits<float>::max()).bits(), 0x7f80);
+        EXPECT_TRUE(std::isnan(static_cast<float>(bfloat16(std::numeric_limits<float>::quiet_NaN()))));
+
+        for (std::uint32_t b = 0; b < 0x10000u; ++b)
+        {
+            bfloat16 h = bfloat16::from_bits(static_cast<std::uint16_t>(b));
+            float f = h;
+            if (!std::isnan(f))
+            {
+                EXPECT_EQ(bfloat16(f).bits(), h.bits());
+            }
+        }
+    }
+
+    TEST(xhalf, limits)
+    {
+        using limits = std::numeric_limits<float16>;
+        EXPECT_EQ(static_cast<float>((limits::max)()), 65504.f);
+        EXPECT_EQ(static_cast<float>(limits::lowest()), -65504.f);
+        EXPECT_EQ(static_cast<float>((limits::min)()), std::ldexp(1.f, -14));
+        EXPECT_EQ(static_cast<float>(limits::epsilon()), std::ldexp(1.f, -10));
+        EXPECT_EQ(static_cast<float>(limits::denorm_min()), std::ldexp(1.f, -24));
+        EXPECT_TRUE(std::isinf(static_cast<float>(limits::infinity())));
+        EXPECT_TRUE(std::isnan(static_cast<float>(limits::quiet_NaN())));
+
+        using blimits = std::numeric_limits<bfloat16>;
+        EXPECT_EQ(static_cast<float>(blimits::epsilon()), std::ldexp(1.f, -7));
+        EXPECT_EQ(static_cast<float>((blimits::min)()), (std::numeric_limits<float>::min)());
+    }
+
+    TEST(xhalf, bulk_conversion)
+    {
+        std::size_t n = 1003;
+        std::vector<float> src(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            src[i] = std::ldexp(static_cast<float>(i) - 500.f, static_cast<int>(i % 40) - 20) / 3.f;
+        }
+        std::vector<float16> h(n);
+        std::vector<bfloat16> bh(n);
+        std::vector<float> back(n);
+        float_to_half(src.data(), h.data(), n);
+        float_to_half(src.data(), bh.data(), n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            EXPECT_EQ(h[i].bits(), float16(src[i]).bits());
+            EXPECT_EQ(bh[i].bits(), bfloat16(src[i]).bits());
+        }
+        half_to_float(h.data(), back.data(), n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            EXPECT_EQ(back[i], static_cast<float>(h[i]));
+        }
+        half_to_float(bh.data(), back.data(), n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            EXPECT_EQ(back[i], static_cast<float>(bh[i]));
+        }
+    }
+
+    TEST(xhalf, containers)
+    {
+        std::size_t n = 1003;
+        xtensor<float, 1> f = linspace<float>(-10.f, 10.f, n);
+        xtensor<float16, 1> h = f;
+        xarray<bfloat16> bh = f;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            EXPECT_EQ(h(i).bits(), float16(f(i)).bits());
+            EXPECT_EQ(bh(i).bits(), bfloat16(f(i)).bits());
+        }
+
+        // arithmetic computes in float
+        xtensor<float, 1> sum_f = h + h * 2.f;
+        xtensor<float16, 1> sum_h = h + h * 2.f;
+        xtensor<float, 1> mixed = h * f - bh;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            float hi = h(i);
+            EXPECT_EQ(sum_f(i), hi + hi * 2.f);
+            EXPECT_EQ(sum_h(i).bits(), float16(hi + hi * 2.f).bits());
+            EXPECT_EQ(mixed(i), hi * f(i) - static_cast<float>(bh(i)));
+        }
+
+        noalias(h) = h * 0.5f;
+        EXPECT_EQ(static_cast<float>(h(n - 1)), 5.f);
+        xtensor<double, 1> d = h;
+        EXPECT_EQ(d(0), -5.);
+        xtensor<int, 1> ih = cast<int>(h);
+        EXPECT_EQ(ih(0), -5);
+
+        // element access and strided views
+        h(1) += 1.f;
+        EXPECT_EQ(static_cast<float>(h(1)), static_cast<float>(float16(f(1) * 0.5f)) + 1.f);
+        xtensor<float, 1> strided = view(h, range(0, 10, 2));
+        EXPECT_EQ(strided(1), static_cast<float>(h(2)));
+
+        xtensor<float16, 1> ones_h = ones<float16>({n});
+        EXPECT_EQ(sum(ones_h)(), double(n));
+        EXPECT_EQ(static_cast<float>(amax(ones_h)()), 1.f);
+    }
+}
@@ -0,0 +1,81 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <complex>
+#include <cstddef>
+#include <unordered_map>
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xhash.hpp"
+#include "xtensor/xmanipulation.hpp"
+#include "xtensor/xstrided_view.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    TEST(xhash, values)
+    {
+        xarray<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        xarray<double> b = a;
+        EXPECT_EQ(hash(a), hash(b));
+        b(1, 2) = 7.;
+        EXPECT_NE(hash(a), hash(b));
+
+        xtensor<double, 2> t = a;
+        xarray<double, layout_type::column_major> c = a;
+        EXPECT_EQ(hash(a), hash(t));
+        EXPECT_EQ(hash(a), hash(c));
+        EXPECT_EQ(hash(a), hash(a + 0.));
+        EXPECT_EQ(hash(view(a, 1, all())), hash(xarray<double>({4., 5., 6.})));
+
+        xarray<double> z = {0., 1.};
+        xarray<double> nz = {-0., 1.};
+        EXPECT_EQ(hash(z), hash(nz));
+
+        xarray<std::complex<double>> cplx = {std::complex<double>(1., 2.), std::complex<double>(3., 4.)};
+        xarray<std::complex<double>> cplx2 = cplx;
+        EXPECT_EQ(hash(cplx), hash(cplx2));
+    }
+
+    TEST(xhash, shape_and_type)
+    {
+        xarray<int> a = {1, 2, 3, 4, 5, 6};
+        xarray<int> b = a;
+        b.reshape({2, 3});
+        xarray<double> d = a;
+        xarray<unsigned int> u = a;
+        EXPECT_NE(hash(a), hash(b));
+        EXPECT_NE(hash(a), hash(d));
+        EXPECT_NE(hash(a), hash(u));
+
+        xarray<int> empty = xarray<int>::from_shape({0});
+        xarray<int> empty2 = xarray<int>::from_shape({2, 0});
+        EXPECT_NE(hash(empty), hash(empty2));
+    }
+
+    TEST(xhash, blocks)
+    {
+        parallel::scoped_settings guard(0, 0);
+        xarray<double> a = reshape_view(arange<double>(50000.), {250, 200});
+        xarray<double, layout_type::column_major> c = a;
+        // the storage of a is hashed by blocks, the values of c one by one
+        EXPECT_EQ(hash(a), hash(c));
+        EXPECT_EQ(hash(transpose(a)), hash(xarray<double>(transpose(a))));
+
+        std::unordered_map<xarray<double>, int, expression_hash> cache;
+        cache[a] = 1;
+        xarray<double> b = a;
+        EXPECT_EQ(cache.count(b), std::size_t(1));
+        b(100, 100) = -1.;
+        EXPECT_EQ(cache.count(b), std::size_t(0));
+    }
+}
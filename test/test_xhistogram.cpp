@@ -6,13 +6,16 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <algorithm>
 #include <complex>
 #include <limits>
 
 #include "gtest/gtest.h"
 #include "xtensor/xtensor.hpp"
+#include "xtensor/xbuilder.hpp"
 #include "xtensor/xhistogram.hpp"
 #include "xtensor/xrandom.hpp"
+#include "xtensor/xview.hpp"
 
 namespace xt
 {
@@ -39,6 +42,60 @@ namespace xt
         }
     }
 
+    TEST(xhistogram, histogram2d)
+    {
+        xt::xtensor<double, 1> x = {0.5, 1.5, 1.5, 2.5, 0.1, 3.0};
+        xt::xtensor<double, 1> y = {0.2, 0.2, 1.8, 1.1, 1.9, 2.0};
+        xt::xtensor<double, 1> x_edges = {0., 1., 2., 3.};
+        xt::xtensor<double, 1> y_edges = {0., 0.5, 2.};
+
+        xt::xtensor<double, 2> count = xt::histogram2d(x, y, x_edges, y_edges);
+        xt::xtensor<double, 2> expected = {{1., 1.}, {1., 1.}, {0., 2.}};
+        EXPECT_EQ(count, expected);
+
+        xt::xtensor<double, 1> w = {1., 2., 3., 4., 5., 6.};
+        xt::xtensor<double, 2> wcount = xt::histogram2d(x, y, x_edges, y_edges, w);
+        xt::xtensor<double, 2> wexpected = {{1., 5.}, {2., 3.}, {0., 10.}};
+        EXPECT_EQ(wcount, wexpected);
+
+        xt::xtensor<double, 2> density = xt::histogram2d(x, y, x_edges, y_edges, true);
+        xt::xtensor<double, 2> volumes = {{0.5, 1.5}, {0.5, 1.5}, {0.5, 1.5}};
+        EXPECT_TRUE(xt::allclose(xt::sum(density * volumes)(), 1.));
+
+        xt::xtensor<double, 2> sample = xt::stack(xt::xtuple(x, y), 1);
+        std::vector<xt::xtensor<double, 1>> edges = {x_edges, y_edges};
+        xt::xarray<double> dd = xt::histogramdd(sample, edges, w);
+        EXPECT_EQ(dd, wexpected);
+
+        xt::xtensor<double, 2> c10 = xt::histogram2d(x, y, std::size_t(3));
+        EXPECT_EQ(c10.shape()[0], std::size_t(3));
+        EXPECT_EQ(xt::sum(c10)(), 6.);
+    }
+
+    TEST(xhistogram, histogramdd_parallel)
+    {
+        parallel::scoped_settings guard(0, 0);
+
+        xt::xtensor<double, 2> sample = xt::random::rand<double>({20000, 3});
+        std::vector<xt::xtensor<double, 1>> edges = {xt::linspace<double>(0., 1., 5),
+                                                     xt::linspace<double>(0., 1., 3),
+                                                     {0., 0.2, 0.3, 1.}};
+        xt::xarray<double> count = xt::histogramdd(sample, edges);
+        xt::xarray<double> expected = xt::zeros<double>({4, 2, 3});
+        for (std::size_t i = 0; i < sample.shape()[0]; ++i)
+        {
+            std::size_t idx[3];
+            for (std::size_t d = 0; d < 3; ++d)
+            {
+                const auto& e = edges[d];
+                std::size_t ibin = std::size_t(std::upper_bound(e.cbegin(), e.cend(), sample(i, d)) - e.cbegin()) - 1;
+                idx[d] = std::min(ibin, e.size() - 2);
+            }
+            expected(idx[0], idx[1], idx[2]) += 1.;
+        }
+        EXPECT_EQ(count, expected);
+    }
+
     TEST(xhistogram, bincount)
     {
         xtensor<int, 1> data = {1,2,3,1,1,1,1,2,3,2,3,3,3,3};
@@ -54,4 +111,36 @@ namespace xt
         EXPECT_EQ(bc3.size(), std::size_t(10));
         EXPECT_EQ(bc3(3), expc(3));
     }
+
+    TEST(xhistogram, parallel)
+    {
+        parallel::scoped_settings guard(0, 0);
+
+        xt::xtensor<double, 1> data = xt::random::rand<double>({10000}, 0., 4.);
+        xt::xtensor<double, 1> weights = xt::random::rand<double>({10000});
+
+        // uniform bins, with data-points on the edges
+        xt::xtensor<double, 1> edges = xt::linspace<double>(0., 4., 9);
+        xt::view(data, xt::range(0, 9)) = edges;
+        // non-uniform bins
+        xt::xtensor<double, 1> nu_edges = {0., 0.1, 0.5, 2., 3.5, 4.};
+
+        for (const auto& e : {edges, nu_edges})
+        {
+            xt::xtensor<double, 1> count = xt::histogram(data, e, weights);
+            xt::xtensor<double, 1> expected = xt::zeros<double>({e.size() - 1});
+            for (std::size_t i = 0; i < data.size(); ++i)
+            {
+                std::size_t ibin = std::size_t(std::upper_bound(e.cbegin(), e.cend(), data(i)) - e.cbegin()) - 1;
+                expected(std::min(ibin, e.size() - 2)) += weights(i);
+            }
+            EXPECT_TRUE(xt::allclose(count, expected));
+        }
+
+        xtensor<int, 1> ids = xt::random::randint<int>({10000}, 0, 50);
+        xtensor<int, 1> bc = bincount(ids);
+        EXPECT_EQ(bc.size(), std::size_t(50));
+        EXPECT_EQ(xt::sum(bc)(), 10000);
+        EXPECT_EQ(bc(7), std::count(ids.cbegin(), ids.cend(), 7));
+    }
 }
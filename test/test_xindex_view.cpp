@@ -9,9 +9,11 @@
 #include "gtest/gtest.h"
 #include "xtensor/xarray.hpp"
 #include "xtensor/xadapt.hpp"
+#include "xtensor/xbuilder.hpp"
 #include "xtensor/xrandom.hpp"
 #include "xtensor/xindex_view.hpp"
 #include "xtensor/xbroadcast.hpp"
+#include "xtensor/xstrided_view.hpp"
 #include "xtensor/xview.hpp"
 #include "test_common.hpp"
 
@@ -144,6 +146,28 @@ namespace xt
         EXPECT_EQ(expected, a);
     }
 
+    TEST(xindex_view, filtration_blend)
+    {
+        xtensor<double, 1> a = arange(-8., 9.);
+        xtensor<double, 1> expected = where(a < 0., 0., a);
+        filtration(a, a < 0.) = 0;
+        EXPECT_EQ(a, expected);
+
+        xarray<int> b = {{1, -2, 3}, {-4, 5, -6}};
+        filtration(b, b < 0) *= -1;
+        filtration(b, b % 2 == 0) -= 1;
+        filtration(b, b > 3) /= 2;
+        filtration(b, b > 1) %= 2;
+        xarray<int> expected_b = {{1, 1, 1}, {1, 0, 0}};
+        EXPECT_EQ(b, expected_b);
+
+        xarray<double> c = {{1., 2.}, {3., 4.}};
+        xarray<bool> mask = {true, false};
+        filtration(c, mask) += 10.;
+        xarray<double> expected_c = {{11., 2.}, {13., 4.}};
+        EXPECT_EQ(c, expected_c);
+    }
+
     TEST(xindex_view, filter)
     {
         xarray<double> a = {{ 1, 5, 3 },{ 4, 5, 6 }};
@@ -153,6 +177,28 @@ namespace xt
         EXPECT_EQ(expected, a);
     }
 
+    TEST(xindex_view, extract)
+    {
+        xarray<double> a = {{1, 5, 3}, {4, 5, 6}};
+        xtensor<double, 1> b = extract(a >= 5, a);
+        xtensor<double, 1> expected = {5, 5, 6};
+        EXPECT_EQ(b, expected);
+
+        xarray<double, layout_type::column_major> c = a;
+        EXPECT_EQ(extract(c >= 5, c), expected);
+        EXPECT_EQ(extract(a > 10, a).size(), 0u);
+
+        xtensor<int, 1> d = arange<int>(1000);
+        xtensor<bool, 1> mask = (d % 7) == 3;
+        parallel::scoped_settings guard(0, 0);
+        xtensor<int, 1> e = extract(mask, d);
+        xtensor<int, 1> expected_e = filter(d, mask);
+        EXPECT_EQ(e, expected_e);
+        EXPECT_EQ(extract(d > 994, d), arange<int>(995, 1000));
+
+        EXPECT_THROW(extract(mask, a), std::runtime_error);
+    }
+
     TEST(xindex_view, const_adapt_filter)
     {
         const std::vector<double> av({1,2,3,4,5,6});
@@ -162,4 +208,118 @@ namespace xt
         xarray<double> expected = {{1, 2, 3}, {5, 7, 9}};
         EXPECT_EQ(expected, b);
     }
+
+    TEST(xindex_view, take)
+    {
+        xarray<double> a = {{1, 5, 3}, {4, 5, 6}};
+        xtensor<double, 1> b = take(a, std::vector<int>{5, 0, -2});
+        xtensor<double, 1> expected = {6, 1, 5};
+        EXPECT_EQ(b, expected);
+
+        xarray<double, layout_type::column_major> c = a;
+        EXPECT_EQ(take(c, std::vector<int>{5, 0, -2}), expected);
+        EXPECT_EQ(take(a + 1., std::vector<int>{5, 0, -2}), xtensor<double, 1>(expected + 1.));
+
+        xarray<double> rows = take(a, std::vector<std::size_t>{1, 1, 0}, 0);
+        xarray<double> expected_rows = {{4, 5, 6}, {4, 5, 6}, {1, 5, 3}};
+        EXPECT_EQ(rows, expected_rows);
+        xarray<double> cols = take(a, std::vector<int>{2, 0}, 1);
+        xarray<double> expected_cols = {{3, 1}, {6, 4}};
+        EXPECT_EQ(cols, expected_cols);
+        EXPECT_EQ(take(c, std::vector<int>{2, 0}, 1), expected_cols);
+
+        xarray<int> d = reshape_view(arange<int>(2 * 50 * 30), {2, 50, 30});
+        std::vector<std::size_t> idx(200);
+        for (std::size_t i = 0; i < idx.size(); ++i)
+        {
+            idx[i] = (i * 37) % 50;
+        }
+        parallel::scoped_settings guard(0, 0);
+        xarray<int> middle = take(d, idx, 1);
+        ASSERT_EQ(middle.shape(), std::vector<std::size_t>({2, 200, 30}));
+        xarray<int> last = take(d, std::vector<std::size_t>{29, 3}, 2);
+        ASSERT_EQ(last.shape(), std::vector<std::size_t>({2, 50, 2}));
+        for (std::size_t i = 0; i < 2; ++i)
+        {
+            for (std::size_t k = 0; k < idx.size(); ++k)
+            {
+                EXPECT_EQ(middle(i, k, 7), d(i, idx[k], 7));
+            }
+            for (std::size_t j = 0; j < 50; ++j)
+            {
+                EXPECT_EQ(last(i, j, 0), d(i, j, 29));
+                EXPECT_EQ(last(i, j, 1), d(i, j, 3));
+            }
+        }
+        xtensor<int, 1> flat = take(d, idx);
+        for (std::size_t k = 0; k < idx.size(); ++k)
+        {
+            EXPECT_EQ(flat(k), static_cast<int>(idx[k]));
+        }
+
+        EXPECT_THROW(take(a, std::vector<int>{6}), std::runtime_error);
+        EXPECT_THROW(take(a, std::vector<int>{-7}), std::runtime_error);
+        EXPECT_THROW(take(a, std::vector<int>{0}, 2), std::runtime_error);
+    }
+
+    TEST(xindex_view, prefetched_assign)
+    {
+        // the indexed expression does not fit in the caches: the elements
+        // ahead of the assigned one are prefetched
+        std::size_t n = 512;
+        xtensor<double, 2> a = reshape_view(arange<double>(double(n * n)), {n, n});
+        std::vector<std::array<std::size_t, 2>> indices;
+        for (std::size_t i = 0; i < 100; ++i)
+        {
+            indices.push_back({(i * 37) % n, (i * 101) % n});
+        }
+        xtensor<double, 1> res = index_view(a, indices);
+        xtensor<double, 1> shifted = index_view(a, indices) + 1.;
+        bool equal = true;
+        for (std::size_t i = 0; i < indices.size(); ++i)
+        {
+            double expected = a(indices[i][0], indices[i][1]);
+            equal = equal && res(i) == expected && shifted(i) == expected + 1.;
+        }
+        EXPECT_TRUE(equal);
+    }
+
+    TEST(xindex_view, put)
+    {
+        xarray<double> a = {{1, 5, 3}, {4, 5, 6}};
+        put(a, std::vector<int>{0, -1}, xarray<double>{10, 20});
+        xarray<double> expected = {{10, 5, 3}, {4, 5, 20}};
+        EXPECT_EQ(a, expected);
+
+        put(a, std::vector<int>{1, 2, 3}, xarray<double>{7, 8});
+        expected = {{10, 7, 8}, {7, 5, 20}};
+        EXPECT_EQ(a, expected);
+        put(a, std::vector<int>{4}, 0.);
+        expected(1, 1) = 0.;
+        EXPECT_EQ(a, expected);
+
+        xarray<double, layout_type::column_major> c = {{1, 5, 3}, {4, 5, 6}};
+        put(c, std::vector<int>{0, 5}, xarray<double>{10, 20});
+        xarray<double> expected_c = {{10, 5, 3}, {4, 5, 20}};
+        EXPECT_EQ(c, expected_c);
+
+        xtensor<int, 1> d = zeros<int>({1000});
+        std::vector<std::size_t> idx(3000);
+        xtensor<int, 1> values = arange<int>(3000);
+        for (std::size_t i = 0; i < idx.size(); ++i)
+        {
+            idx[i] = (i * 7) % 1000;
+        }
+        parallel::scoped_settings guard(0, 0);
+        put(d, idx, values);
+        for (std::size_t i = 0; i < 1000; ++i)
+        {
+            // the last occurrence of every index wins
+            EXPECT_EQ(d(i), static_cast<int>(((i * 143) % 1000) + 2000));
+        }
+
+        EXPECT_THROW(put(a, std::vector<int>{6}, 1.), std::runtime_error);
+        EXPECT_THROW(put(a, std::vector<int>{0}, xarray<double>::from_shape({0})), std::runtime_error);
+    }
 }
+
@@ -0,0 +1,136 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_ENABLE_INSTRUMENTATION
+#define XTENSOR_ENABLE_INSTRUMENTATION
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xinstrument.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xstrided_view.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    namespace
+    {
+        struct event_recorder
+        {
+            std::vector<instrument::event> begins;
+            std::vector<instrument::event> ends;
+
+            event_recorder()
+            {
+                instrument::set_callbacks([this](const instrument::event& ev) { begins.push_back(ev); },
+                                          [this](const instrument::event& ev) { ends.push_back(ev); });
+            }
+
+            ~event_recorder()
+            {
+                instrument::reset_callbacks();
+            }
+
+            bool has(instrument::event_kind kind) const
+            {
+                return std::any_of(ends.cbegin(), ends.cend(),
+                                   [kind](const instrument::event& ev) { return ev.kind == kind; });
+            }
+
+            const instrument::event& find(instrument::event_kind kind) const
+            {
+                return *std::find_if(ends.cbegin(), ends.cend(),
+                                     [kind](const instrument::event& ev) { return ev.kind == kind; });
+            }
+        };
+    }
+
+    TEST(xinstrument, callbacks)
+    {
+        EXPECT_FALSE(instrument::has_callbacks());
+        {
+            event_recorder rec;
+            EXPECT_TRUE(instrument::has_callbacks());
+        }
+        EXPECT_FALSE(instrument::has_callbacks());
+        EXPECT_EQ(std::string(instrument::to_string(instrument::event_kind::stepper_assign)), "xt::stepper_assign");
+    }
+
+    TEST(xinstrument, linear_assign)
+    {
+        xarray<double> a = reshape_view(arange<double>(24.), {4, 6});
+        xarray<double> b = zeros<double>({4, 6});
+        event_recorder rec;
+        noalias(b) = a + a;
+
+        ASSERT_TRUE(rec.has(instrument::event_kind::assign));
+        ASSERT_TRUE(rec.has(instrument::event_kind::linear_assign));
+        EXPECT_EQ(rec.begins.size(), rec.ends.size());
+        const instrument::event& ev = rec.find(instrument::event_kind::assign);
+        EXPECT_EQ(ev.shape, std::vector<std::size_t>({4, 6}));
+        EXPECT_EQ(ev.size, std::size_t(24));
+        EXPECT_EQ(ev.bytes, 24 * 2 * sizeof(double));
+        EXPECT_GE(ev.elapsed.count(), 0);
+        EXPECT_EQ(ev.expression, rec.find(instrument::event_kind::linear_assign).expression);
+        EXPECT_FALSE(ev.expression.empty());
+        // the innermost path ends first
+        EXPECT_EQ(rec.ends.back().kind, instrument::event_kind::assign);
+    }
+
+    TEST(xinstrument, strided_assign)
+    {
+        xarray<double> a = reshape_view(arange<double>(24.), {4, 6});
+        xarray<double> b = zeros<double>({4, 3});
+        event_recorder rec;
+        noalias(b) = view(a, all(), range(0, 6, 2));
+
+        EXPECT_TRUE(rec.has(instrument::event_kind::assign));
+        EXPECT_TRUE(rec.has(instrument::event_kind::stepper_assign) ||
+                    rec.has(instrument::event_kind::strided_loop_assign));
+        EXPECT_FALSE(rec.has(instrument::event_kind::linear_assign));
+    }
+
+    TEST(xinstrument, reducers)
+    {
+        xarray<double> a = reshape_view(arange<double>(24.), {4, 6});
+        {
+            event_recorder rec;
+            xarray<double> res = sum(a, {1});
+            ASSERT_TRUE(rec.has(instrument::event_kind::reducer_assign));
+            EXPECT_EQ(rec.find(instrument::event_kind::reducer_assign).shape, std::vector<std::size_t>({4}));
+        }
+        {
+            event_recorder rec;
+            xarray<double> res = sum(a, {1}, evaluation_strategy::immediate());
+            ASSERT_TRUE(rec.has(instrument::event_kind::reduce_immediate));
+            const instrument::event& ev = rec.find(instrument::event_kind::reduce_immediate);
+            EXPECT_EQ(ev.shape, std::vector<std::size_t>({4, 6}));
+            EXPECT_EQ(ev.bytes, 24 * sizeof(double));
+        }
+    }
+
+    TEST(xinstrument, no_callbacks)
+    {
+        xarray<double> a = reshape_view(arange<double>(24.), {4, 6});
+        std::size_t count = 0;
+        instrument::set_callbacks(nullptr, [&count](const instrument::event&) { ++count; });
+        instrument::reset_callbacks();
+        xarray<double> b = a + a;
+        EXPECT_EQ(count, std::size_t(0));
+        EXPECT_EQ(b(1, 1), 14.);
+    }
+}
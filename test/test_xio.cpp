@@ -19,6 +19,7 @@
 #include "xtensor/xrandom.hpp"
 #include "xtensor/xbuilder.hpp"
 #include "xtensor/xview.hpp"
+#include "xtensor/xvectorize.hpp"
 
 #include "files/xio_expected_results.hpp"
 
@@ -276,4 +277,23 @@ namespace xt
         std::string exp = "{1, 1, 1, 1, 1}";
         EXPECT_EQ(exp, out.str());
     }
+
+    TEST(xio, summarized_lazy_expression)
+    {
+        std::size_t count = 0;
+        auto counted = xt::vectorize([&count](int i) { ++count; return i; });
+        auto e = counted(xt::arange<int>(1000000));
+
+        std::stringstream out;
+        out << e;
+        // only the printed edge items are evaluated
+        EXPECT_EQ(count, std::size_t(6));
+        EXPECT_NE(out.str().find("..."), std::string::npos);
+
+        count = 0;
+        auto e2 = counted(xt::ones<int>({1000, 3000}));
+        std::stringstream out2;
+        out2 << e2;
+        EXPECT_EQ(count, std::size_t(36));
+    }
 }
@@ -8,7 +8,11 @@
 
 #include "gtest/gtest.h"
 
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #include "xtensor/xarray.hpp"
 #include "xtensor/xtensor.hpp"
@@ -61,4 +65,83 @@ namespace xt
             {3, 4}}});
         EXPECT_TRUE(all(equal(arr, ref)));
     }
+
+    TEST(xjson, load_json)
+    {
+        auto arr = load_json<double>("[[[1.0,2.0],[3.0,4.0]],[[5,6],[7,8]]]");
+        EXPECT_EQ(arr, xt::xarray<double>({{{1, 2}, {3, 4}}, {{5, 6}, {7, 8}}}));
+
+        std::istringstream stream("[[1, -2, 3], [4, 5, 6]]");
+        xt::xtensor<int, 2> t;
+        load_json(stream, t);
+        EXPECT_EQ(t, xt::xtensor<int, 2>({{1, -2, 3}, {4, 5, 6}}));
+
+        // a container of the size of the document is reused
+        xt::xtensor<int, 2> pre = xt::xtensor<int, 2>::from_shape({3, 2});
+        const int* data = pre.data();
+        load_json(std::string("[[6, 5, 4], [3, 2, 1]]"), pre);
+        EXPECT_EQ(pre.data(), data);
+        EXPECT_EQ(pre, xt::xtensor<int, 2>({{6, 5, 4}, {3, 2, 1}}));
+
+        EXPECT_EQ(load_json<double>("2.5")(), 2.5);
+        EXPECT_EQ(load_json<bool>("[true, false]"), xt::xarray<bool>({true, false}));
+        auto empty = load_json<double>("[[], []]");
+        EXPECT_EQ(empty.dimension(), std::size_t(2));
+        EXPECT_EQ(empty.shape()[0], std::size_t(2));
+        EXPECT_EQ(empty.size(), std::size_t(0));
+
+        // other layouts and views are assigned
+        xt::xarray<double, layout_type::column_major> cm;
+        load_json("[[1, 2], [3, 4]]", cm);
+        EXPECT_EQ(cm, xt::xarray<double>({{1, 2}, {3, 4}}));
+        xt::xarray<double> a = xt::zeros<double>({2, 2, 2});
+        auto v = xt::view(a, 1);
+        load_json("[[1, 2], [3, 4]]", v);
+        EXPECT_EQ(xt::view(a, 1), xt::xarray<double>({{1, 2}, {3, 4}}));
+        EXPECT_THROW(load_json("[1, 2]", v), std::runtime_error);
+
+        EXPECT_THROW(load_json<double>("[[1, 2], [3]]"), std::runtime_error);
+        EXPECT_THROW(load_json<double>("[[1, 2], 3]"), std::runtime_error);
+        EXPECT_THROW(load_json<double>("[1, \"a\"]"), std::runtime_error);
+        EXPECT_THROW(load_json<double>("[1, 2"), std::runtime_error);
+        xt::xtensor<int, 2> keep = {{1, 2}};
+        EXPECT_THROW(load_json("[1, 2, 3]", keep), std::runtime_error);
+        EXPECT_EQ(keep.size(), std::size_t(2));
+    }
+
+#if defined(XTENSOR_JSON_BINARY)
+    TEST(xjson, binary)
+    {
+        xt::xtensor<double, 2> t = {{1., 2., 3.}, {4., 5., 6.}};
+        nlohmann::json j;
+        to_json_binary(j, t);
+        EXPECT_EQ(j["shape"], nlohmann::json({2, 3}));
+        EXPECT_TRUE(j["data"].is_binary());
+        EXPECT_EQ(j["data"].get_binary().size(), 6 * sizeof(double));
+
+        std::vector<std::uint8_t> cbor = nlohmann::json::to_cbor(j);
+        xt::xtensor<double, 2> res;
+        from_json_binary(nlohmann::json::from_cbor(cbor), res);
+        EXPECT_EQ(res, t);
+
+        // from_json and get accept binary objects too
+        auto msgpack = nlohmann::json::from_msgpack(nlohmann::json::to_msgpack(j));
+        EXPECT_EQ(msgpack.get<xt::xarray<double>>(), t);
+
+        xt::xtensor<double, 2, layout_type::column_major> cm = t;
+        nlohmann::json jcm;
+        to_json_binary(jcm, cm);
+        EXPECT_EQ(jcm["data"], j["data"]);
+
+        xt::xarray<double> arr = xt::zeros<double>({2, 2, 3});
+        auto v = xt::view(arr, 1);
+        from_json(j, v);
+        EXPECT_EQ(xt::view(arr, 1), t);
+        auto bad_view = xt::view(arr, 1, 0);
+        EXPECT_THROW(from_json(j, bad_view), std::runtime_error);
+
+        xt::xarray<float> f;
+        EXPECT_THROW(from_json_binary(j, f), std::runtime_error);
+    }
+#endif
 }
@@ -13,6 +13,7 @@
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xbuilder.hpp"
 #include "xtensor/xmanipulation.hpp"
+#include "xtensor/xview.hpp"
 
 namespace xt
 {
@@ -30,6 +31,31 @@ namespace xt
         EXPECT_ANY_THROW(vt.at(0, 0, 0, 0));
     }
 
+    TEST(xstrided_view, transpose_tiled_assign)
+    {
+        xarray<double> e = xt::arange<double>(70 * 45);
+        e.resize({70, 45});
+        xtensor<double, 2> a = e;
+        xtensor<double, 2> b = transpose(a);
+        ASSERT_EQ(b.shape()[0], std::size_t(45));
+        bool equal = true;
+        for (std::size_t i = 0; i < 70; ++i)
+        {
+            for (std::size_t j = 0; j < 45; ++j)
+            {
+                equal = equal && b(j, i) == a(i, j);
+            }
+        }
+        EXPECT_TRUE(equal);
+
+        xarray<float> c = xt::arange<float>(3 * 40 * 33);
+        c.resize({3, 40, 33});
+        xarray<float> d = transpose(c, {0, 2, 1});
+        EXPECT_EQ(d(2, 32, 39), c(2, 39, 32));
+        EXPECT_EQ(d(1, 5, 17), c(1, 17, 5));
+        EXPECT_EQ(d(0, 0, 1), c(0, 1, 0));
+    }
+
     TEST(xstrided_view, transpose_layout_swap)
     {
         xarray<double, layout_type::row_major> a = xt::ones<double>({5, 5});
@@ -129,6 +155,35 @@ namespace xt
         EXPECT_EQ(s3[2](0, 1), b(0, 2, 1));
     }
 
+    TEST(xstrided_view, split_into_concatenate_into)
+    {
+        xarray<double> a = arange<double>(24);
+        a.reshape({2, 3, 4});
+
+        std::vector<xarray<double>> parts = {xarray<double>::from_shape({2, 1, 4}),
+                                             xarray<double>::from_shape({2, 2, 4})};
+        split_into(a, parts, 1);
+        EXPECT_EQ(parts[0], view(a, all(), range(0, 1), all()));
+        EXPECT_EQ(parts[1], view(a, all(), range(1, 3), all()));
+
+        xarray<double> b = zeros<double>({2, 3, 4});
+        concatenate_into(parts, b, 1);
+        EXPECT_EQ(a, b);
+
+        // strided parts are assigned views
+        std::vector<xarray<double, layout_type::column_major>> cparts = {xarray<double, layout_type::column_major>::from_shape({1, 3, 4}),
+                                                                          xarray<double, layout_type::column_major>::from_shape({1, 3, 4})};
+        split_into(a + 1., cparts, 0);
+        EXPECT_EQ(cparts[1], view(a + 1., range(1, 2), all(), all()));
+        xarray<double> c = zeros<double>({2, 3, 4});
+        concatenate_into(cparts, c, 0);
+        EXPECT_EQ(c, a + 1.);
+
+        parts[1].resize({2, 3, 4});
+        EXPECT_THROW(split_into(a, parts, 1), std::runtime_error);
+        EXPECT_THROW(split_into(a, parts, 3), std::runtime_error);
+    }
+
     TEST(xstrided_view, squeeze)
     {
         auto b = xt::xarray<double>::from_shape({3, 3, 1, 1, 2, 1, 3});
@@ -311,4 +366,52 @@ namespace xt
         xarray<double> expected5 = {{{1, 3}, {0, 2}}, {{5, 7}, {4, 6}}};
         ASSERT_EQ(expected5, xt::rot90(e3, {1, 2}));
     }
+
+    TEST(xstrided_view, flip_rot90_assign)
+    {
+        xarray<double> e = arange<double>(300.);
+        xarray<double> fe = flip(e, 0);
+        EXPECT_EQ(fe(0), 299.);
+        EXPECT_EQ(fe(299), 0.);
+
+        e.reshape({3, 10, 10});
+        xarray<double> f = flip(e, 2);
+        xarray<double> r1 = rot90(e, {1, 2});
+        xtensor<double, 3> r2 = rot90<2>(e, {1, 2});
+        xarray<double, layout_type::column_major> r3 = rot90<3>(e, {1, 2});
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            for (std::size_t j = 0; j < 10; ++j)
+            {
+                for (std::size_t k = 0; k < 10; ++k)
+                {
+                    EXPECT_EQ(f(i, j, k), e(i, j, 9 - k));
+                    EXPECT_EQ(r1(i, j, k), e(i, k, 9 - j));
+                    EXPECT_EQ(r2(i, j, k), e(i, 9 - j, 9 - k));
+                    EXPECT_EQ(r3(i, j, k), e(i, 9 - k, j));
+                }
+            }
+        }
+    }
+
+    TEST(xstrided_view, sliding_window_view)
+    {
+        xarray<double> e = {{1, 2, 3, 4}, {5, 6, 7, 8}};
+        auto v = xt::sliding_window_view(e, 3, 1);
+        xarray<double> expected = {{{1, 2, 3}, {2, 3, 4}},
+                                   {{5, 6, 7}, {6, 7, 8}}};
+        ASSERT_EQ(expected, v);
+        ASSERT_EQ(e.data(), &v(0, 0, 0));
+
+        v(1, 1, 2) = 10;
+        ASSERT_EQ(10, e(1, 3));
+
+        auto w = xt::sliding_window_view(e, 2, 0);
+        xarray<double> expected_2 = {{{1, 5}, {2, 6}, {3, 7}, {4, 10}}};
+        ASSERT_EQ(expected_2, w);
+
+        ASSERT_ANY_THROW(xt::sliding_window_view(e, 5, 1));
+        ASSERT_ANY_THROW(xt::sliding_window_view(e, 0, 1));
+        ASSERT_ANY_THROW(xt::sliding_window_view(e, 2, 2));
+    }
 }
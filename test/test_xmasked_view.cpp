@@ -7,11 +7,15 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <cmath>
+
 #include "gtest/gtest.h"
 
 #include "xtensor/xoptional_assembly.hpp"
 #include "xtensor/xmasked_view.hpp"
 #include "xtensor/xio.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xstrided_view.hpp"
 
 namespace xt
 {
@@ -219,4 +223,85 @@ namespace xt
                                     {6.65, 8.  , 6.65}};
         EXPECT_EQ(data, expected2);
     }
+
+    TEST(xmasked_view, expression_assign)
+    {
+        xarray<double> data = {{ 1., 2., 3.},
+                               { 4., 5., 6.}};
+        xarray<bool> mask = {{ true, false,  true},
+                             {false,  true, false}};
+        xarray<double> b = {{10., 20., 30.},
+                            {40., 50., 60.}};
+
+        auto masked_data = masked_view(data, mask);
+        masked_data += b;
+        xarray<double> expected1 = {{11., 2., 33.},
+                                    { 4., 55., 6.}};
+        EXPECT_EQ(data, expected1);
+
+        masked_data = b;
+        xarray<double> expected2 = {{10., 2., 30.},
+                                    { 4., 50., 6.}};
+        EXPECT_EQ(data, expected2);
+
+        auto opt_data = make_test_data();
+        auto masked_opt = make_masked_data(opt_data);
+        masked_opt *= 2.;
+        EXPECT_EQ(opt_data(0, 0), 2.);
+        EXPECT_EQ(opt_data(0, 2), xtl::missing<double>());
+        EXPECT_EQ(opt_data(1, 1), 5.);
+        EXPECT_EQ(opt_data(2, 2), 18.);
+    }
+
+    TEST(xmasked_view, reducers)
+    {
+        xarray<int> data = {{ 1, -2,  3},
+                            { 4,  5, -6},
+                            { 7,  8, -9}};
+        xarray<bool> mask = {{ true,  true,  true},
+                             { true, false, false},
+                             { true, false,  true}};
+        auto masked_data = masked_view(data, mask);
+
+        EXPECT_EQ(masked_sum(masked_data), 4);
+        EXPECT_DOUBLE_EQ(masked_mean(masked_data), 4. / 6.);
+        EXPECT_EQ(masked_amax(masked_data), 7);
+
+        xarray<bool> hidden = zeros<bool>(data.shape());
+        auto hidden_data = masked_view(data, hidden);
+        EXPECT_EQ(masked_sum(hidden_data), 0);
+        EXPECT_TRUE(std::isnan(masked_mean(hidden_data)));
+        EXPECT_THROW(masked_amax(hidden_data), std::runtime_error);
+
+        // the missing values are ignored as well
+        auto opt_data = make_test_data();
+        auto masked_opt = make_masked_data(opt_data);
+        EXPECT_EQ(masked_sum(masked_opt), 27.);
+        EXPECT_DOUBLE_EQ(masked_mean(masked_opt), 5.4);
+        EXPECT_EQ(masked_amax(masked_opt), 9.);
+    }
+
+    TEST(xmasked_view, bitset_mask)
+    {
+        xarray<double> data = reshape_view(arange<double>(150.), {10, 15});
+        xarray<bool> mask = (data < 70.) || ((data > 75.) && (data < 140.));
+        mask(9, 14) = true;
+        xarray_bitset<> bits = mask;
+        xarray<double> b = 2. * data;
+
+        xarray<double> expected = data;
+        auto masked_expected = masked_view(expected, mask);
+        masked_expected += b;
+        masked_expected *= 3.;
+
+        auto masked_data = masked_view(data, bits);
+        masked_data += b;
+        masked_data *= 3.;
+        EXPECT_EQ(data, expected);
+
+        masked_expected = b;
+        masked_data = b;
+        EXPECT_EQ(data, expected);
+        EXPECT_EQ(masked_sum(masked_data), masked_sum(masked_expected));
+    }
 }
@@ -6,13 +6,21 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <algorithm>
+#include <cmath>
 #include <complex>
+#include <cstdint>
 #include <limits>
+#include <type_traits>
 
 #include "gtest/gtest.h"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmanipulation.hpp"
 #include "xtensor/xmath.hpp"
 #include "xtensor/xrandom.hpp"
+#include "xtensor/xstrided_view.hpp"
+#include "xtensor/xtensor.hpp"
 
 namespace xt
 {
@@ -576,6 +584,78 @@ namespace xt
 
     }
 
+    TEST(xmath, negative_integer_pow)
+    {
+        xarray<double> a = {0.5, 2., -3., 1.5};
+        xarray<double> b = pow<-3>(a);
+        EXPECT_TRUE(allclose(b, 1. / (a * a * a)));
+        b = pow<-1>(a);
+        EXPECT_TRUE(allclose(b, 1. / a));
+        b = pow<0>(a);
+        EXPECT_EQ(b, xarray<double>({1., 1., 1., 1.}));
+
+        // the reciprocal is raised to the power, so large bases do not overflow
+        xarray<double> big = {1e160, -1e200};
+        xarray<double> c = pow<-2>(big);
+        EXPECT_GT(c(0), 0.);
+        EXPECT_NEAR(c(0), 1e-320, 1e-323);
+        EXPECT_EQ(c(1), 0.);
+        c = pow(big, -2);
+        EXPECT_GT(c(0), 0.);
+        EXPECT_NEAR(c(0), 1e-320, 1e-323);
+        EXPECT_EQ(c(1), 0.);
+    }
+
+    template <std::size_t N>
+    auto unsigned_pow(const xarray<double>& a)
+    {
+        return pow<N>(a);
+    }
+
+    TEST(xmath, unsigned_integer_pow)
+    {
+        xarray<double> a = {0.5, 2., -3.};
+        xarray<double> b = unsigned_pow<3>(a);
+        EXPECT_TRUE(allclose(b, a * a * a));
+        b = pow<std::size_t(2)>(a);
+        EXPECT_TRUE(allclose(b, a * a));
+    }
+
+    TEST(xmath, scalar_pow)
+    {
+        xarray<double> a = {0.5, 2., -3., 1.5, 0.};
+        for (int p : {-4, -1, 0, 1, 2, 3, 7, 32})
+        {
+            xarray<double> b = pow(a, p);
+            xarray<double> expected = a;
+            std::transform(a.cbegin(), a.cend(), expected.begin(), [p](double v) { return std::pow(v, p); });
+            EXPECT_TRUE(allclose(b, expected));
+        }
+
+        // integral floating point exponents, and the others through std::pow
+        xarray<double> p3 = pow(a, 3.);
+        EXPECT_TRUE(allclose(p3, a * a * a));
+        xarray<double> b = abs(a);
+        xarray<double> p25 = pow(b, 2.5);
+        EXPECT_EQ(p25(1), std::pow(2., 2.5));
+        xarray<double> p40 = pow(b, 40);
+        EXPECT_EQ(p40(1), std::pow(2., 40));
+
+        // the elements of integral expressions are promoted as with std::pow
+        xarray<int> i = {1, 2, 3};
+        auto ip = pow(i, 2);
+        EXPECT_TRUE((std::is_same<decltype(ip)::value_type, double>::value));
+        EXPECT_EQ(ip(2), 9.);
+        xarray<double> ineg = pow(i, -1);
+        EXPECT_EQ(ineg(1), 0.5);
+
+#if XTENSOR_USE_XSIMD
+        auto f = pow(a, 3);
+        using assign_traits = xassign_traits<xarray<double>, decltype(f)>;
+        EXPECT_TRUE(assign_traits::simd_assign());
+#endif
+    }
+
     TEST(xmath, cube)
     {
         shape_type shape = {3, 2};
@@ -877,6 +957,31 @@ namespace xt
         EXPECT_EQ(lm, lz);
     }
 
+    TEST(xmath, count_nonzero_blocks)
+    {
+        parallel::scoped_settings guard(0, 0);
+
+        xtensor<float, 2> f = xt::cast<float>(reshape_view(arange<int>(150000), {300, 500}) % 7);
+        f(299, 499) = std::numeric_limits<float>::quiet_NaN();
+        std::size_t expected = 0;
+        for (float v : f)
+        {
+            expected += v != 0.f ? 1 : 0;
+        }
+        EXPECT_EQ(count_nonzero(f, evaluation_strategy::immediate())(), expected);
+        EXPECT_EQ(count_nonzero(f)(), expected);
+        EXPECT_EQ(count_nonzero(f, {1}, evaluation_strategy::immediate()), count_nonzero(f, {1}));
+        EXPECT_EQ(count_nonzero(f, {0}, evaluation_strategy::immediate()), count_nonzero(f, {0}));
+
+        xtensor<bool, 2> m = f > 3.f;
+        xtensor<std::size_t, 1> rows = count_nonzero(m, {1}, evaluation_strategy::immediate());
+        EXPECT_EQ(rows, count_nonzero(m, {1}));
+        EXPECT_EQ(sum(rows)(), count_nonzero(m, evaluation_strategy::immediate())());
+
+        xtensor<std::int64_t, 1> l = arange<std::int64_t>(1001) % 3;
+        EXPECT_EQ(count_nonzero(l, evaluation_strategy::immediate())(), std::size_t(667));
+    }
+
     TEST(xmath, diff)
     {
         xt::xarray<int> a = {1, 2, 4, 7, 0};
@@ -898,6 +1003,29 @@ namespace xt
         EXPECT_EQ(xt::diff(c, 2), expected7);
     }
 
+    TEST(xmath, diff_high_order)
+    {
+        xt::xarray<double> a = xt::square(xt::arange<double>(3000.)) * 0.5;
+        a.reshape({3, 1000});
+        xt::xarray<double> rep = a;
+        for (std::size_t k = 0; k < 3; ++k)
+        {
+            rep = xt::diff(rep);
+        }
+        EXPECT_EQ(xt::diff(a, 3), rep);
+        EXPECT_EQ(xt::diff(a, 3), xt::zeros<double>({3, 997}));
+
+        xt::xarray<int> b = xt::arange<int>(2 * 5 * 300);
+        b.reshape({2, 5, 300});
+        b = b * b;
+        xt::xarray<int> rb = xt::diff(xt::diff(b, 1, 1), 1, 1);
+        EXPECT_EQ(xt::diff(b, 2, 1), rb);
+        EXPECT_EQ(xt::diff(b, 5, 1).shape()[1], std::size_t(0));
+
+        xt::xarray<int, xt::layout_type::column_major> c = b;
+        EXPECT_EQ(xt::diff(c, 2, 1), rb);
+    }
+
     TEST(xmath, trapz)
     {
         xt::xarray<int> a = {{0, 1, 2},
@@ -920,6 +1048,13 @@ namespace xt
         xt::xarray<int> d_x = {4, 6, 8};
         auto res5 = trapz(d, d_x);
         EXPECT_EQ(res5[0], 8.0);
+
+        xt::xarray<double> e = {{0., 1., 4.}, {1., 2., 3.}};
+        xt::xarray<double> e_x = {{0., 1., 3.}, {0., 2., 4.}};
+        xt::xarray<double> expected6 = {0.5 + 5., 3. + 5.};
+        EXPECT_EQ(trapz(e, e_x), expected6);
+        xt::xarray<double> expected7 = {0.5, 1.5, 3.5};
+        EXPECT_EQ(trapz(e, xt::xarray<double>{0., 1.}, 0), expected7);
     }
 
     /************************
@@ -939,4 +1074,30 @@ namespace xt
             EXPECT_EQ(f[i], x[i]);
         }
     }
+
+    TEST(xmath, interp_sorted_queries)
+    {
+        xt::xtensor<double, 1> xp = {0.0, 1.0, 3.0, 4.0};
+        xt::xtensor<double, 1> fp = {1.0, 3.0, -1.0, 2.0};
+        xt::xtensor<double, 1> x = xt::linspace<double>(-1.0, 5.0, 1001);
+        xt::xtensor<double, 1> expected = xt::zeros<double>({x.size()});
+        for (std::size_t i = 0; i < x.size(); ++i)
+        {
+            std::size_t j = 1;
+            while (j < xp.size() - 1 && xp[j] < x[i])
+            {
+                ++j;
+            }
+            double v = fp[j - 1] + (fp[j] - fp[j - 1]) / (xp[j] - xp[j - 1]) * (x[i] - xp[j - 1]);
+            expected[i] = x[i] <= xp[0] ? -10.0 : (x[i] >= xp[3] ? 10.0 : v);
+        }
+
+        auto sorted = xt::interp(x, xp, fp, -10.0, 10.0);
+        EXPECT_TRUE(xt::allclose(sorted, expected));
+
+        xt::xtensor<double, 1> rx = xt::flip(x, 0);
+        xt::xtensor<double, 1> rexpected = xt::flip(expected, 0);
+        auto unsorted = xt::interp(rx, xp, fp, -10.0, 10.0);
+        EXPECT_TRUE(xt::allclose(unsorted, rexpected));
+    }
 }
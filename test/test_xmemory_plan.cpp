@@ -0,0 +1,113 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmanipulation.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xmemory_plan.hpp"
+#include "xtensor/xsort.hpp"
+#include "xtensor/xstrided_view.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    using kind = xmemory_plan::kind;
+
+    TEST(xmemory_plan, eval)
+    {
+        xarray<double> a = reshape_view(arange<double>(12.), {3, 4});
+        xarray<double> b = ones<double>({3, 4});
+
+        xmemory_plan none = memory_plan(a);
+        EXPECT_TRUE(none.allocations().empty());
+        EXPECT_EQ(none.peak_bytes(), std::size_t(0));
+
+        xmemory_plan plan = memory_plan(a + b * 2.);
+        ASSERT_EQ(plan.allocations().size(), std::size_t(1));
+        EXPECT_EQ(plan.allocations()[0].what, kind::result);
+        EXPECT_EQ(plan.allocations()[0].shape, (std::vector<std::size_t>{3, 4}));
+        EXPECT_EQ(plan.allocated_bytes(), 12 * sizeof(double));
+        EXPECT_EQ(plan.peak_bytes(), 12 * sizeof(double));
+        EXPECT_GE(plan.arena_bytes(), plan.allocated_bytes());
+
+        // the results of sorts and immediate reductions held by the
+        // expression are already allocated
+        xtensor<float, 1> v = {3.f, 1.f, 2.f};
+        auto held = memory_plan(sum(a, {1}, evaluation_strategy::immediate) + sort(v));
+        ASSERT_EQ(held.allocations().size(), std::size_t(3));
+        EXPECT_EQ(held.allocations()[0].what, kind::held);
+        EXPECT_EQ(held.allocations()[1].what, kind::held);
+        EXPECT_EQ(held.held_bytes(), 3 * sizeof(double) + 3 * sizeof(float));
+        EXPECT_EQ(held.allocated_bytes(), 3 * sizeof(double));
+        EXPECT_EQ(held.peak_bytes(), held.held_bytes() + 3 * sizeof(double));
+
+        // lazy reducers and views are traversed
+        auto lazy = memory_plan(sum(a + xarray<double>(b), {0}));
+        EXPECT_EQ(lazy.held_bytes(), 12 * sizeof(double));
+        EXPECT_EQ(lazy.allocated_bytes(), 4 * sizeof(double));
+
+        std::ostringstream out;
+        held.report(out);
+        EXPECT_NE(out.str().find("held"), std::string::npos);
+        EXPECT_NE(out.str().find("result"), std::string::npos);
+    }
+
+    TEST(xmemory_plan, assign)
+    {
+        xarray<double> a = reshape_view(arange<double>(12.), {3, 4});
+        xarray<double> b = ones<double>({3, 4});
+        xarray<double> c = zeros<double>({3, 4});
+
+        // the destination is not involved: the assignment is direct
+        EXPECT_TRUE(memory_plan(c, a + b).allocations().empty());
+
+        // the destination is an operand: a temporary is needed
+        auto alias = memory_plan(a, 2. * a + b);
+        ASSERT_EQ(alias.allocations().size(), std::size_t(1));
+        EXPECT_EQ(alias.allocations()[0].what, kind::temporary);
+        EXPECT_EQ(alias.allocated_bytes(), 12 * sizeof(double));
+
+        // the destination must be resized
+        xarray<double> d;
+        auto resize = memory_plan(d, a + b);
+        ASSERT_EQ(resize.allocations().size(), std::size_t(1));
+        EXPECT_EQ(resize.allocations()[0].what, kind::resize);
+        EXPECT_EQ(resize.allocated_bytes(), 12 * sizeof(double));
+    }
+
+    TEST(xmemory_plan, arena)
+    {
+        xarray<double> a = reshape_view(arange<double>(12.), {3, 4});
+        xarray<double> expected = transpose(a) + 1.;
+        xtensor<double, 2> sq = reshape_view(arange<double>(16.), {4, 4});
+        xtensor<double, 2> sq_expected = transpose(sq) + 1.;
+
+        auto plan = memory_plan(sq, transpose(sq) + 1.);
+        EXPECT_EQ(plan.allocated_bytes(), 16 * sizeof(double));
+        {
+            arena_scope scope(plan.arena_bytes());
+            eval_into(sq, transpose(sq) + 1., arena_allocator<double>());
+            auto tmp = eval(transpose(a) + 1., arena_allocator<double>());
+            EXPECT_EQ(tmp, expected);
+        }
+        EXPECT_EQ(sq, sq_expected);
+
+        xarray<double> c;
+        eval_into(c, a + 1., arena_allocator<double>());
+        EXPECT_EQ(c, a + 1.);
+    }
+}
@@ -10,6 +10,8 @@
 #include "xtensor/xarray.hpp"
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xmath.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xindex_view.hpp"
 #include "xtensor/xstrided_view.hpp"
 
 namespace xt
@@ -107,4 +109,54 @@ namespace xt
         EXPECT_EQ(nancumprod(nantest::xN, 2), cumprod(nantest::xP, 2));
     }
 
+    TEST(xnanfunctions, nanmin_nanmax)
+    {
+        EXPECT_EQ(nanmin(nantest::aN)(), 1.);
+        EXPECT_EQ(nanmax(nantest::aN)(), 123.);
+
+        xarray<double> emin0 = {1, 1, 123, 3};
+        xarray<double> emax1 = {123, 3, 3};
+        EXPECT_EQ(nanmin(nantest::aN, {0}), emin0);
+        EXPECT_EQ(nanmax(nantest::aN, {1}), emax1);
+        EXPECT_EQ(nanmax(nantest::aN, {1}, evaluation_strategy::immediate()), emax1);
+
+        xarray<double> all_nan = {nanv, nanv};
+        EXPECT_TRUE(std::isnan(nanmin(all_nan)()));
+    }
+
+    TEST(xnanfunctions, nanmean_nanvar_nanstd)
+    {
+        xarray<double> emean1 = {63., 2., 5. / 3.};
+        EXPECT_TRUE(allclose(nanmean(nantest::aN, {1}), emean1));
+        EXPECT_DOUBLE_EQ(nanmean(nantest::aN)(), 137. / 8.);
+
+        // variance of {1, 2, 3}
+        EXPECT_DOUBLE_EQ(nanvar(nantest::aN, {1})(1), 2. / 3.);
+        EXPECT_DOUBLE_EQ(nanstd(nantest::aN, {1})(1), std::sqrt(2. / 3.));
+
+        xarray<double> all_nan = {nanv, nanv};
+        EXPECT_TRUE(std::isnan(nanmean(all_nan)()));
+        EXPECT_TRUE(std::isnan(nanvar(all_nan)()));
+    }
+
+    TEST(xnanfunctions, immediate)
+    {
+        xtensor<double, 1> a = arange<double>(1000.);
+        xtensor<double, 1> r = a;
+        for (std::size_t i = 0; i < a.size(); i += 7)
+        {
+            a(i) = nanv;
+            r(i) = 0.;
+        }
+        r(0) = 0.;
+        auto ev = evaluation_strategy::immediate();
+        EXPECT_EQ(nansum(a, ev)(), sum(r)());
+        EXPECT_EQ(nanmin(a, ev)(), 1.);
+        EXPECT_EQ(nanmax(a, ev)(), 999.);
+
+        xtensor<double, 1> valid = filter(a, !isnan(a));
+        EXPECT_NEAR(nanmean(a, ev)(), mean(valid)(), 1e-10);
+        EXPECT_NEAR(nanvar(a, ev)(), mean(square(valid - mean(valid)()))(), 1e-8);
+        EXPECT_NEAR(nanvar(a, ev)(), nanvar(a)(), 1e-8);
+    }
 }
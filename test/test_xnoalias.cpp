@@ -6,8 +6,17 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <algorithm>
+#include <thread>
+#include <tuple>
+#include <vector>
 #include "gtest/gtest.h"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xfixed.hpp"
+#include "xtensor/xstrided_view.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xmanipulation.hpp"
 #include "xtensor/xnoalias.hpp"
 #include "xtensor/xio.hpp"
 #include "xtensor/xview.hpp"
@@ -366,4 +375,198 @@ namespace xt
         xt::view(b, 1) = 10;
         EXPECT_EQ(a, b);
     }
+
+    TEST(xnoalias, assign_all)
+    {
+        xarray<double> a = {{1., 2., 3., 4., 5.}, {6., 7., 8., 9., 10.}};
+        xarray<double> b = {{2., 2., 2., 2., 2.}, {3., 3., 3., 3., 3.}};
+        xarray<double> x;
+        xarray<int> y;
+        assign_all(std::tie(x, y), a + b, a * b);
+        EXPECT_EQ(x, xarray<double>(a + b));
+        EXPECT_EQ(y, xarray<int>(a * b));
+
+        // different shapes are assigned one after the other
+        xarray<double> z;
+        auto v = view(a, 1);
+        assign_all(std::tie(x, z), a - b, 2. * v);
+        EXPECT_EQ(x, xarray<double>(a - b));
+        EXPECT_EQ(z, xarray<double>(2. * v));
+    }
+
+    TEST(xnoalias, assign_plan)
+    {
+        std::vector<xtensor<double, 2>> a(4, xtensor<double, 2>({{1., 2.}, {3., 4.}}));
+        std::vector<xtensor<double, 2>> b(4, xtensor<double, 2>({{1., 1.}, {2., 2.}}));
+        std::vector<xtensor<double, 2>> res(4);
+        a[2](1, 1) = 10.;
+
+        auto plan = make_assign_plan(res[0], a[0] * b[0]);
+        EXPECT_TRUE(plan.trivial_broadcast());
+        EXPECT_TRUE(plan.linear_assign());
+        for (std::size_t i = 0; i < res.size(); ++i)
+        {
+            res[i].resize({2, 2});
+            plan.run(res[i], a[i] * b[i]);
+        }
+        EXPECT_EQ(res[0], xtensor<double, 2>({{1., 2.}, {6., 8.}}));
+        EXPECT_EQ(res[2](1, 1), 20.);
+    }
+
+    TEST(xnoalias, assign_kind)
+    {
+        using tensor_type = xtensor<double, 2>;
+        tensor_type a = {{1., 2.}, {3., 4.}};
+        tensor_type res;
+        using product_type = decltype(a * a);
+        using transpose_type = decltype(transpose(a));
+#if XTENSOR_USE_XSIMD
+        EXPECT_EQ((assign_plan<tensor_type, product_type>::kind), assign_kind::simd_linear);
+        require_simd_assign(res, a * a);
+#else
+        EXPECT_EQ((assign_plan<tensor_type, product_type>::kind), assign_kind::linear);
+#endif
+        EXPECT_NE((assign_plan<tensor_type, transpose_type>::kind), assign_kind::linear);
+        EXPECT_NE((assign_plan<tensor_type, transpose_type>::kind), assign_kind::simd_linear);
+        EXPECT_EQ((assign_plan<xtensor_fixed<double, xshape<2, 2>>, xtensor_fixed<double, xshape<2, 2>>>::kind), assign_kind::unrolled);
+    }
+
+    TEST(xnoalias, where_simd)
+    {
+        using tensor_type = xtensor<double, 1>;
+        tensor_type a = linspace<double>(-1., 1., 37);
+        tensor_type b = 2. * a;
+        tensor_type res = zeros<double>({37});
+        xtensor<bool, 1> cond = a > b;
+        using clamp_type = decltype(where(a < -0.5, -0.5, where(a > 0.5, 0.5, a)));
+        using select_type = decltype(where(cond, a, b));
+#if XTENSOR_USE_XSIMD
+        EXPECT_EQ((assign_plan<tensor_type, clamp_type>::kind), assign_kind::simd_linear);
+        EXPECT_EQ((assign_plan<tensor_type, select_type>::kind), assign_kind::simd_linear);
+        require_simd_assign(res, where(a > 0., a, b));
+#else
+        EXPECT_EQ((assign_plan<tensor_type, clamp_type>::kind), assign_kind::linear);
+        EXPECT_EQ((assign_plan<tensor_type, select_type>::kind), assign_kind::linear);
+#endif
+        noalias(res) = where(a < -0.5, -0.5, where(a > 0.5, 0.5, a));
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            EXPECT_EQ(res(i), std::min(std::max(a(i), -0.5), 0.5));
+        }
+        noalias(res) = where(cond, a, b) + 1.;
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            EXPECT_EQ(res(i), (cond(i) ? a(i) : b(i)) + 1.);
+        }
+    }
+
+    TEST(xnoalias, streaming_store)
+    {
+        EXPECT_TRUE(streaming::use_streaming(streaming::min_bytes()));
+        EXPECT_FALSE(streaming::use_streaming(0));
+
+        xtensor<double, 1> a = linspace<double>(0., 1., 1003);
+        xtensor<double, 1> res = zeros<double>({1003});
+        xtensor<int, 1> ia = arange<int>(1003);
+        xtensor<int, 1> ires = zeros<int>({1003});
+        {
+            streaming::scoped_min_bytes guard(0);
+            EXPECT_TRUE(streaming::use_streaming(1));
+            noalias(res) = 2. * a + 1.;
+            noalias(ires) = ia * 3;
+            auto v = view(res, range(1, 1002));
+            v = view(a, range(0, 1001));
+        }
+        EXPECT_FALSE(streaming::use_streaming(1));
+        {
+            // the guard only applies to the calling thread
+            streaming::scoped_min_bytes guard(0);
+            bool other_thread = true;
+            std::thread t([&other_thread]() { other_thread = streaming::use_streaming(1); });
+            t.join();
+            EXPECT_FALSE(other_thread);
+            EXPECT_TRUE(streaming::use_streaming(1));
+        }
+        EXPECT_EQ(res(0), 1.);
+        EXPECT_EQ(res(1002), 3.);
+        for (std::size_t i = 1; i < 1002; ++i)
+        {
+            EXPECT_EQ(res(i), a(i - 1));
+            EXPECT_EQ(ires(i), 3 * ia(i));
+        }
+    }
+
+    TEST(xnoalias, loop_assign)
+    {
+        using tensor_type = xtensor<double, 1>;
+        using function_type = decltype(std::declval<const tensor_type&>() * 2. + std::declval<const tensor_type&>());
+        EXPECT_TRUE((detail::use_loop_assign<tensor_type, function_type>::value));
+
+        xtensor<double, 1> a = linspace<double>(0., 1., 1003);
+        xtensor<double, 1> b = linspace<double>(1., 2., 1003);
+        xtensor<int, 1> ia = arange<int>(1003);
+        xtensor<double, 1> res = zeros<double>({1003});
+        xtensor<int, 1> ires = zeros<int>({1003});
+        xtensor<bool, 1> bres = zeros<bool>({1003});
+
+        noalias(res) = a * b + 2. * a - b / 3.;
+        noalias(ires) = ia * 2 + 1;
+        noalias(bres) = a < 0.5;
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            EXPECT_EQ(res(i), a(i) * b(i) + 2. * a(i) - b(i) / 3.);
+            EXPECT_EQ(ires(i), ia(i) * 2 + 1);
+            EXPECT_EQ(bres(i), a(i) < 0.5);
+        }
+
+        // mixed value types and casts
+        noalias(res) = cast<double>(ia) / 2 + a;
+        noalias(ires) = cast<int>(a * 10.);
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            EXPECT_EQ(res(i), double(ia(i)) / 2 + a(i));
+            EXPECT_EQ(ires(i), int(a(i) * 10.));
+        }
+
+        // the destination is an operand
+        noalias(res) = res * 2. + 1.;
+        EXPECT_EQ(res(2), (double(ia(2)) / 2 + a(2)) * 2. + 1.);
+    }
+
+    TEST(xnoalias, loop_order)
+    {
+        xtensor<double, 2> a = reshape_view(arange<double>(70 * 45), {70, 45});
+        xtensor<double, 2, layout_type::column_major> ca = a;
+        xtensor<double, 2> res = zeros<double>({70, 45});
+
+        std::vector<std::size_t> outer;
+        std::size_t inner = 0, tiled = 0;
+        // same layouts, no planning
+        EXPECT_FALSE(loop_order_detail::plan_loop_order(res, a + 1., outer, inner, tiled));
+        // the destination and the operand prefer different inner dimensions
+        EXPECT_TRUE(loop_order_detail::plan_loop_order(res, ca + 1., outer, inner, tiled));
+        EXPECT_EQ(inner, std::size_t(0));
+        EXPECT_EQ(tiled, std::size_t(1));
+        EXPECT_TRUE(outer.empty());
+
+        noalias(res) = ca * 2. + a;
+        EXPECT_EQ(res, a * 3.);
+        noalias(res) = ca * ca + ca;
+        EXPECT_EQ(res, a * a + a);
+
+        xtensor<int, 2> ires = zeros<int>({70, 45});
+        noalias(ires) = ca / 2.;
+        EXPECT_EQ(ires(69, 44), int(a(69, 44) / 2.));
+
+        xarray<float> c = reshape_view(arange<float>(3 * 40 * 33), {3, 40, 33});
+        xarray<float> tc = transpose(c, {0, 2, 1});
+        xarray<float, layout_type::column_major> cc = c;
+        xarray<float> d = zeros<float>({3, 40, 33});
+        noalias(d) = transpose(tc, {0, 2, 1}) + cc;
+        EXPECT_EQ(d, c * 2.f);
+        EXPECT_TRUE(loop_order_detail::plan_loop_order(d, cc + c, outer, inner, tiled));
+        EXPECT_EQ(outer, std::vector<std::size_t>({0}));
+        EXPECT_EQ(inner, std::size_t(1));
+        EXPECT_EQ(tiled, std::size_t(2));
+    }
 }
@@ -13,6 +13,7 @@
 #include "xtensor/xview.hpp"
 #include "xtensor/xnoalias.hpp"
 
+#include <cmath>
 #include <limits>
 
 namespace xt
@@ -147,4 +148,63 @@ namespace xt
         EXPECT_EQ(norm_induced_l1(a, evaluation_strategy::immediate())(), 6.0);
         EXPECT_EQ(norm_induced_linf(a, evaluation_strategy::immediate())(), 7.0);
     }
+    TEST(xnorm, immediate_kernels)
+    {
+        xarray<double> a = arange<double>(-500., 523.) * 0.25;
+        double l1 = 0., sq = 0., linf = 0., l3 = 0.;
+        for (double v : a)
+        {
+            l1 += std::abs(v);
+            sq += v * v;
+            linf = (std::max)(linf, std::abs(v));
+            l3 += std::pow(std::abs(v), 3.);
+        }
+
+        EXPECT_NEAR(norm_l1(a, evaluation_strategy::immediate())(), l1, 1e-12 * l1);
+        EXPECT_NEAR(norm_sq(a, evaluation_strategy::immediate())(), sq, 1e-12 * sq);
+        EXPECT_EQ(norm_linf(a, evaluation_strategy::immediate())(), linf);
+        EXPECT_NEAR(norm_lp_to_p(a, 3., evaluation_strategy::immediate())(), l3, 1e-10 * l3);
+        EXPECT_NEAR(norm_lp_to_p(a, 2., evaluation_strategy::immediate())(), sq, 1e-12 * sq);
+        EXPECT_NEAR(norm_lp(a, 1., evaluation_strategy::immediate())(), l1, 1e-12 * l1);
+        EXPECT_EQ(norm_l0(a, evaluation_strategy::immediate())(), 1022u);
+
+        xarray<float> f = cast<float>(a);
+        EXPECT_NEAR(norm_sq(f, evaluation_strategy::immediate())(), sq, 1e-12 * sq);
+        EXPECT_EQ(norm_linf(f, evaluation_strategy::immediate())(), static_cast<float>(linf));
+
+        xarray<double> m = a;
+        m.reshape({31, 33});
+        EXPECT_TRUE(allclose(norm_l1(m, {1}, evaluation_strategy::immediate()), norm_l1(m, {1})));
+        EXPECT_TRUE(allclose(norm_sq(m, {0}, evaluation_strategy::immediate()), norm_sq(m, {0})));
+        EXPECT_TRUE(allclose(norm_linf(m, {1}, evaluation_strategy::immediate()), norm_linf(m, {1})));
+
+        a(700) = std::numeric_limits<double>::quiet_NaN();
+        EXPECT_TRUE(std::isnan(norm_sq(a, evaluation_strategy::immediate())()));
+    }
+
+    TEST(xnorm, l2_scaled)
+    {
+        xarray<double> a = {3e300, 4e300};
+        EXPECT_NEAR(norm_l2_scaled(a)() / 5e300, 1., 1e-15);
+        EXPECT_NEAR(norm_l2_scaled(a, evaluation_strategy::immediate())() / 5e300, 1., 1e-15);
+
+        xarray<double> b = {3e-300, 4e-300};
+        EXPECT_NEAR(norm_l2_scaled(b)() / 5e-300, 1., 1e-15);
+
+        xarray<double> c = ones<double>({1000}) * 1e200;
+        c(10) = -1e200;
+        EXPECT_NEAR(norm_l2_scaled(c)() / (std::sqrt(1000.) * 1e200), 1., 1e-13);
+        EXPECT_NEAR(norm_l2_scaled(c, evaluation_strategy::immediate())() / (std::sqrt(1000.) * 1e200), 1., 1e-13);
+
+        xarray<double> m = {{3., 4.}, {6., 8.}};
+        xarray<double> rows = norm_l2_scaled(m, {1});
+        xarray<double> expected = {5., 10.};
+        EXPECT_TRUE(allclose(rows, expected));
+        EXPECT_EQ(norm_l2_scaled(xarray<double>(zeros<double>({4})))(), 0.);
+
+        xarray<double> d = {1., std::numeric_limits<double>::quiet_NaN(), 2.};
+        EXPECT_TRUE(std::isnan(norm_l2_scaled(d)()));
+        xarray<double> e = {1., std::numeric_limits<double>::infinity(), 2.};
+        EXPECT_EQ(norm_l2_scaled(e, evaluation_strategy::immediate())(), std::numeric_limits<double>::infinity());
+    }
 }  // namespace xt
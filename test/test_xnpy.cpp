@@ -10,9 +10,17 @@
 
 #include "xtensor/xnpy.hpp"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xcomplex.hpp"
+#include "xtensor/xtensor.hpp"
 
+#include <algorithm>
+#include <complex>
 #include <fstream>
+#include <future>
 #include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
 
 namespace xt
 {
@@ -116,4 +124,232 @@ namespace xt
         xarray<char> adc = dc;
         EXPECT_EQ(adc(0, 0), 0);
     }
-}
\ No newline at end of file
+
+    TEST(xnpy, float16)
+    {
+        std::string filename = get_filename();
+        xtensor<float16, 2> h = {{0.5f, -1.f, 2.f}, {65504.f, 1e-3f, 3.f}};
+        dump_npy(filename, h);
+        {
+            std::ifstream stream(filename, std::ifstream::binary);
+            std::stringstream content;
+            content << stream.rdbuf();
+            EXPECT_NE(content.str().find("'descr': '<f2'"), std::string::npos);
+        }
+        auto loaded = load_npy<float16>(filename);
+        ASSERT_EQ(loaded.dimension(), std::size_t(2));
+        EXPECT_EQ(loaded.shape()[1], std::size_t(3));
+        for (std::size_t i = 0; i < h.size(); ++i)
+        {
+            EXPECT_EQ(loaded.data()[i].bits(), h.data()[i].bits());
+        }
+        EXPECT_THROW(load_npy<float>(filename), std::runtime_error);
+        std::remove(filename.c_str());
+    }
+
+    TEST(xnpy, mmap)
+    {
+        auto dmapped = mmap_npy<double>("files/xnpy_files/double.npy");
+        auto dloaded = load_npy<double>("files/xnpy_files/double.npy");
+        EXPECT_EQ(dmapped.shape(), dloaded.shape());
+        EXPECT_TRUE(all(equal(dmapped, dloaded)));
+
+        auto dfmapped = mmap_npy<double, layout_type::column_major>("files/xnpy_files/double_fortran.npy");
+        EXPECT_TRUE(all(equal(dfmapped, dloaded)));
+        EXPECT_THROW(mmap_npy<double, layout_type::row_major>("files/xnpy_files/double_fortran.npy"), std::runtime_error);
+        EXPECT_THROW(mmap_npy<float>("files/xnpy_files/double.npy"), std::runtime_error);
+
+        std::string filename = get_filename();
+        xtensor<int, 2> a = {{1, 2, 3}, {4, 5, 6}};
+        dump_npy(filename, a);
+        {
+            auto cow = mmap_npy<int>(filename, mmap_mode::copy_on_write);
+            EXPECT_EQ(cow, a);
+            cow(1, 2) = 42;
+            EXPECT_EQ(cow(1, 2), 42);
+
+            // changes are not written back to the file
+            auto ro = mmap_npy<int>(filename);
+            EXPECT_EQ(ro, a);
+
+            xarray<int> copy = cow;
+            cow = copy + 1;
+            EXPECT_EQ(cow(1, 2), 43);
+        }
+        EXPECT_EQ(load_npy<int>(filename), a);
+        std::remove(filename.c_str());
+    }
+
+    TEST(xnpy, load_into)
+    {
+        xarray<double> expected = load_npy<double>("files/xnpy_files/double.npy");
+
+        xtensor<double, 3> t;
+        load_npy_into("files/xnpy_files/double.npy", t);
+        EXPECT_EQ(t, expected);
+
+        // same shape: the existing storage is reused
+        const double* data = t.data();
+        load_npy_into("files/xnpy_files/double.npy", t);
+        EXPECT_EQ(t.data(), data);
+        EXPECT_EQ(t, expected);
+
+        xtensor<double, 3, layout_type::column_major> ct;
+        load_npy_into("files/xnpy_files/double_fortran.npy", ct);
+        EXPECT_EQ(ct, expected);
+        EXPECT_THROW(load_npy_into("files/xnpy_files/double_fortran.npy", t), std::runtime_error);
+
+        xarray<double, layout_type::dynamic> dt;
+        load_npy_into("files/xnpy_files/double_fortran.npy", dt);
+        EXPECT_EQ(dt.layout(), layout_type::column_major);
+        EXPECT_EQ(dt, expected);
+
+        xtensor<double, 2> t2;
+        EXPECT_THROW(load_npy_into("files/xnpy_files/double.npy", t2), std::runtime_error);
+        xtensor<float, 3> ft;
+        EXPECT_THROW(load_npy_into("files/xnpy_files/double.npy", ft), std::runtime_error);
+
+        // file written with the opposite byte order
+        xtensor<int, 1> a = {1, 256, -2, 70000};
+        std::string descr = detail::build_typestring<int>();
+        descr[0] = detail::big_endian ? detail::little_endian_char : detail::big_endian_char;
+        std::stringstream stream;
+        detail::write_header(stream, descr, false, a.shape());
+        for (int i : a)
+        {
+            char bytes[sizeof(int)];
+            std::copy(reinterpret_cast<char*>(&i), reinterpret_cast<char*>(&i) + sizeof(int), bytes);
+            std::reverse(bytes, bytes + sizeof(int));
+            stream.write(bytes, sizeof(int));
+        }
+        xarray<int> b;
+        load_npy_into(stream, b);
+        EXPECT_EQ(b, a);
+    }
+
+    TEST(xnpy, convert)
+    {
+        xarray<double> expected = load_npy<double>("files/xnpy_files/double.npy");
+        xarray<float> fexpected = cast<float>(expected);
+
+        auto f = load_npy<float>("files/xnpy_files/double.npy", true);
+        EXPECT_EQ(f, fexpected);
+        xtensor<float, 3> ft;
+        load_npy_into("files/xnpy_files/double.npy", ft, true);
+        EXPECT_EQ(ft, fexpected);
+        EXPECT_THROW(load_npy<float>("files/xnpy_files/double.npy"), std::runtime_error);
+
+        auto i = load_npy<int>("files/xnpy_files/bool.npy", true);
+        xarray<bool> bexpected = load_npy<bool>("files/xnpy_files/bool.npy");
+        xarray<int> iexpected = cast<int>(bexpected);
+        EXPECT_EQ(i, iexpected);
+
+        // files written with the opposite byte order, swapped while read or
+        // swapped before the conversion
+        xtensor<std::int16_t, 1> a = {1, 256, -2, 3000};
+        std::string descr = detail::build_typestring<std::int16_t>();
+        descr[0] = detail::big_endian ? detail::little_endian_char : detail::big_endian_char;
+        std::string filename = get_filename();
+        {
+            std::ofstream stream(filename, std::ofstream::binary);
+            detail::write_header(stream, descr, false, a.shape());
+            for (std::int16_t v : a)
+            {
+                char bytes[sizeof(std::int16_t)];
+                std::copy(reinterpret_cast<char*>(&v), reinterpret_cast<char*>(&v) + sizeof(std::int16_t), bytes);
+                std::reverse(bytes, bytes + sizeof(std::int16_t));
+                stream.write(bytes, sizeof(std::int16_t));
+            }
+        }
+        EXPECT_EQ(load_npy<std::int16_t>(filename), a);
+        xarray<double> d;
+        load_npy_into(filename, d, true);
+        xarray<double> dexpected = cast<double>(a);
+        EXPECT_EQ(d, dexpected);
+        EXPECT_THROW(load_npy<std::complex<double>>("files/xnpy_files/double.npy"), std::runtime_error);
+        auto c = load_npy<std::complex<double>>("files/xnpy_files/double.npy", true);
+        EXPECT_TRUE(all(equal(real(c), expected)));
+        std::remove(filename.c_str());
+    }
+
+    TEST(xnpy, reader_writer)
+    {
+        std::string filename = get_filename();
+        xtensor<double, 2> block = {{1., 2., 3.}, {4., 5., 6.}};
+        {
+            npy_writer<double> writer(filename, std::vector<std::size_t>({3}));
+            writer.append(block);
+            xtensor<double, 1> row = {7., 8., 9.};
+            writer.append(row);
+            writer.flush();
+            EXPECT_EQ(load_npy<double>(filename).shape()[0], std::size_t(3));
+
+            xtensor<double, 2, layout_type::column_major> cm_block = block + 10.;
+            writer.append(cm_block);
+            xtensor<double, 1> wrong = {1., 2.};
+            EXPECT_THROW(writer.append(wrong), std::runtime_error);
+            EXPECT_EQ(writer.rows(), std::size_t(5));
+        }
+
+        auto loaded = load_npy<double>(filename);
+        ASSERT_EQ(loaded.shape(), std::vector<std::size_t>({5, 3}));
+        EXPECT_EQ(loaded(2, 1), 8.);
+        EXPECT_EQ(loaded(4, 2), 16.);
+
+        npy_reader<double> reader(filename);
+        EXPECT_EQ(reader.rows(), std::size_t(5));
+        std::vector<double> values;
+        while (!reader.eof())
+        {
+            auto b = reader.read(2);
+            EXPECT_EQ(b.dimension(), std::size_t(2));
+            EXPECT_EQ(b.shape()[1], std::size_t(3));
+            values.insert(values.end(), b.cbegin(), b.cend());
+        }
+        EXPECT_TRUE(std::equal(values.cbegin(), values.cend(), loaded.cbegin()));
+        EXPECT_EQ(reader.read(2).shape()[0], std::size_t(0));
+
+        reader.seek(1);
+        auto b = reader.read(1);
+        EXPECT_EQ(b, xtensor<double, 2>({{4., 5., 6.}}));
+
+        EXPECT_THROW(npy_reader<double>("files/xnpy_files/double_fortran.npy"), std::runtime_error);
+        std::remove(filename.c_str());
+    }
+
+    TEST(xnpy, dump_async)
+    {
+        std::vector<std::string> filenames;
+        std::vector<std::future<void>> futures;
+        xtensor<double, 2> a = {{1., 2., 3.}, {4., 5., 6.}};
+        for (std::size_t i = 0; i < 5; ++i)
+        {
+            filenames.push_back(get_filename());
+            futures.push_back(dump_npy_async(filenames.back(), a));
+            // the snapshot is taken before returning
+            a += 1.;
+        }
+        xtensor<int, 2, layout_type::column_major> b = {{1, 2}, {3, 4}};
+        filenames.push_back(get_filename());
+        futures.push_back(dump_npy_async(filenames.back(), b));
+        b += 1;
+
+        for (auto& f : futures)
+        {
+            f.get();
+        }
+        for (std::size_t i = 0; i < 5; ++i)
+        {
+            xtensor<double, 2> expected = a - double(5 - i);
+            EXPECT_EQ(load_npy<double>(filenames[i]), expected);
+        }
+        EXPECT_EQ((load_npy<int, layout_type::column_major>(filenames.back())), b + 1);
+        for (const auto& f : filenames)
+        {
+            std::remove(f.c_str());
+        }
+
+        auto failed = dump_npy_async("not_a_directory/out.npy", a);
+        EXPECT_THROW(failed.get(), std::runtime_error);
+    }
+}
@@ -0,0 +1,153 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xnpz.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xtensor.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace xt
+{
+    TEST(xnpz, load)
+    {
+        auto darr = load_npy<double>("files/xnpy_files/double.npy");
+        auto barr = load_npy<bool>("files/xnpy_files/bool.npy");
+
+        npz_file npz = load_npz("files/xnpy_files/arrays.npz");
+        EXPECT_EQ(npz.size(), std::size_t(2));
+        EXPECT_EQ(npz.names(), std::vector<std::string>({"double", "flag"}));
+        EXPECT_TRUE(npz.contains("double"));
+        EXPECT_FALSE(npz.contains("double.npy"));
+
+        EXPECT_EQ(npz.get<double>("double"), darr);
+        EXPECT_EQ(npz.get<bool>("flag"), barr);
+        EXPECT_THROW(npz.get<double>("missing"), std::runtime_error);
+        EXPECT_THROW(npz.get<float>("double"), std::runtime_error);
+
+        npz_file cnpz = load_npz("files/xnpy_files/arrays_compressed.npz");
+        EXPECT_EQ(cnpz.size(), std::size_t(2));
+#if defined(XTENSOR_USE_ZLIB)
+        EXPECT_EQ(cnpz.get<double>("double"), darr);
+        EXPECT_EQ(cnpz.get<bool>("flag"), barr);
+#else
+        EXPECT_THROW(cnpz.get<double>("double"), std::runtime_error);
+#endif
+    }
+
+    namespace
+    {
+        // central directory of one member whose uncompressed size is
+        // given in a zip64 extra field of field_length bytes
+        std::string zip64_directory(std::uint16_t field_length)
+        {
+            std::ostringstream out;
+            detail::write_le<std::uint32_t>(out, detail::zip_central_header_signature);
+            out << std::string(6, '\0');
+            detail::write_le<std::uint16_t>(out, detail::zip_stored);
+            out << std::string(8, '\0');
+            detail::write_le<std::uint32_t>(out, 16);
+            detail::write_le<std::uint32_t>(out, 0xffffffff);
+            detail::write_le<std::uint16_t>(out, 5);
+            detail::write_le<std::uint16_t>(out, std::uint16_t(4 + field_length));
+            out << std::string(14, '\0');
+            out << "a.npy";
+            detail::write_le<std::uint16_t>(out, 0x0001);
+            detail::write_le<std::uint16_t>(out, field_length);
+            for (std::uint16_t i = 0; i < field_length; ++i)
+            {
+                out << (i == 0 ? char(80) : '\0');
+            }
+            std::size_t dir_size = static_cast<std::size_t>(out.tellp());
+            detail::write_le<std::uint32_t>(out, detail::zip_end_signature);
+            out << std::string(4, '\0');
+            detail::write_le<std::uint16_t>(out, 1);
+            detail::write_le<std::uint16_t>(out, 1);
+            detail::write_le<std::uint32_t>(out, static_cast<std::uint32_t>(dir_size));
+            detail::write_le<std::uint32_t>(out, 0);
+            out << std::string(2, '\0');
+            return out.str();
+        }
+    }
+
+    TEST(xnpz, zip64_extra_field)
+    {
+        std::string valid = zip64_directory(8);
+        auto members = detail::read_zip_directory(valid.data(), valid.size());
+        ASSERT_EQ(members.size(), std::size_t(1));
+        EXPECT_EQ(members["a"].uncompressed_size, std::uint64_t(80));
+        EXPECT_EQ(members["a"].compressed_size, std::uint64_t(16));
+
+        // the field is too short for the value it must hold
+        std::string truncated = zip64_directory(4);
+        EXPECT_THROW(detail::read_zip_directory(truncated.data(), truncated.size()), std::runtime_error);
+    }
+
+    TEST(xnpz, dump)
+    {
+        std::string filename = std::tmpnam(nullptr);
+        filename += ".npz";
+
+        xtensor<double, 2> a = {{1., 2., 3.}, {4., 5., 6.}};
+        xtensor<int, 2, layout_type::column_major> b = {{1, 2}, {3, 4}};
+        xarray<double> c = {7., 8.};
+        // names of odd lengths misalign the members
+        dump_npz(filename, "a", a, "bbb", b, "cc", c + 1.);
+
+        {
+            npz_file npz = load_npz(filename);
+            EXPECT_EQ(npz.names(), std::vector<std::string>({"a", "bbb", "cc"}));
+            EXPECT_EQ(npz.get<double>("a"), a);
+            EXPECT_EQ((npz.get<int, layout_type::column_major>("bbb")), b);
+            EXPECT_EQ(npz.get<double>("cc"), c + 1.);
+        }
+        std::remove(filename.c_str());
+    }
+
+#if defined(XTENSOR_USE_ZLIB)
+    TEST(xnpz, dump_compressed)
+    {
+        std::string filename = std::tmpnam(nullptr);
+        filename += ".npz";
+
+        xtensor<double, 2> a = {{1., 2., 3.}, {4., 5., 6.}};
+        // spans several compressed blocks
+        xarray<double> big = arange<double>(300000) * 0.5;
+        xtensor<int, 1> empty(std::array<std::size_t, 1>({0}));
+
+        for (bool shuffle : {false, true})
+        {
+            npz_compression options;
+            options.shuffle = shuffle;
+            dump_npz_compressed(filename, options, "a", a, "big", big, "empty", empty);
+
+            npz_file npz = load_npz(filename);
+            EXPECT_EQ(npz.names(), std::vector<std::string>({"a", "big", "empty"}));
+            EXPECT_EQ(npz.get<double>("a"), a);
+            EXPECT_EQ(npz.get<double>("big"), big);
+            EXPECT_EQ(npz.get<int>("empty").size(), std::size_t(0));
+        }
+
+        {
+            parallel::scoped_settings settings(0, 0);
+            dump_npz_compressed(filename, "big", big);
+            npz_file npz = load_npz(filename);
+            EXPECT_EQ(npz.get<double>("big"), big);
+        }
+        std::remove(filename.c_str());
+    }
+#endif
+}
@@ -8,9 +8,19 @@
 
 #include "gtest/gtest.h"
 
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
 #include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xfixed.hpp"
+#include "xtensor/xindex_view.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xstrided_view.hpp"
 #include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
 
 namespace xt
 {
@@ -418,6 +428,44 @@ namespace xt
         EXPECT_TRUE(all(equal(a, b)));
     }
 
+    TYPED_TEST(operation, any_all_blocks)
+    {
+        using bool_container = xop_test::rebind_container_t<TypeParam, bool>;
+        using shape_type = typename TypeParam::shape_type;
+
+        shape_type s = {100, 123};
+        TypeParam a(s, 1.);
+        bool_container m(s, false);
+        parallel::scoped_settings guard(0, 0);
+
+        EXPECT_TRUE(all(a));
+        EXPECT_TRUE(any(a));
+        EXPECT_FALSE(any(m));
+        EXPECT_FALSE(all(m));
+        EXPECT_TRUE(all(a > 0.));
+        EXPECT_TRUE(allclose(a, a + 1e-9));
+
+        a(99, 122) = 0.;
+        m(99, 122) = true;
+        EXPECT_FALSE(all(a));
+        EXPECT_TRUE(any(m));
+        EXPECT_FALSE(all(m));
+        EXPECT_FALSE(all(a > 0.));
+        EXPECT_TRUE(any(equal(a, 0.)));
+        EXPECT_FALSE(allclose(a, a + 1.));
+        EXPECT_TRUE(all(view(a, range(0, 99), all())));
+        EXPECT_FALSE(any(view(m, all(), range(0, 122))));
+
+        a(99, 122) = std::numeric_limits<double>::quiet_NaN();
+        EXPECT_TRUE(all(a));
+        EXPECT_FALSE(allclose(a, a));
+
+        shape_type es = {0, 3};
+        TypeParam e(es);
+        EXPECT_TRUE(all(e));
+        EXPECT_FALSE(any(e));
+    }
+
     TYPED_TEST(operation, nonzero)
     {
         using int_container_2d = xop_test::rebind_container_t<TypeParam, int>;
@@ -523,6 +571,55 @@ namespace xt
         EXPECT_EQ(last_idx, d_nz.back());
     }
 
+    TYPED_TEST(operation, nonzero_chunks)
+    {
+        using container_3d = redim_container_t<TypeParam, 3>;
+        using int_container = xop_test::rebind_container_t<container_3d, int>;
+        using shape_type = typename int_container::shape_type;
+        using index_type = xindex_type_t<shape_type>;
+
+        shape_type s = {7, 11, 13};
+        int_container a(s);
+        std::vector<std::vector<std::size_t>> expected(3);
+        std::vector<index_type> expected_arg;
+        std::vector<std::vector<std::size_t>> expected_gt(3);
+        for (std::size_t i = 0; i < 7; ++i)
+        {
+            for (std::size_t j = 0; j < 11; ++j)
+            {
+                for (std::size_t k = 0; k < 13; ++k)
+                {
+                    int v = static_cast<int>((i * 143 + j * 13 + k) % 5);
+                    a(i, j, k) = v;
+                    if (v != 0)
+                    {
+                        expected[0].push_back(i);
+                        expected[1].push_back(j);
+                        expected[2].push_back(k);
+                        expected_arg.push_back({i, j, k});
+                    }
+                    if (v > 2)
+                    {
+                        expected_gt[0].push_back(i);
+                        expected_gt[1].push_back(j);
+                        expected_gt[2].push_back(k);
+                    }
+                }
+            }
+        }
+
+        parallel::scoped_settings guard(0, 0);
+        EXPECT_EQ(expected, nonzero(a));
+        EXPECT_EQ(expected_arg, argwhere(a));
+        EXPECT_EQ(expected_gt, nonzero(a > 2));
+        EXPECT_EQ(expected_gt, where(a > 2));
+        EXPECT_EQ(expected_gt[0].size(), argwhere(a > 2).size());
+
+        int_container z(s, 0);
+        EXPECT_TRUE(argwhere(z).empty());
+        EXPECT_TRUE(nonzero(z)[2].empty());
+    }
+
     TYPED_TEST(operation, cast)
     {
         using int_container_t = xop_test::rebind_container_t<TypeParam, int>;
@@ -681,4 +778,183 @@ namespace xt
         EXPECT_EQ(expected1, res1);
         EXPECT_EQ(expected2, res2);
     }
+
+    TEST(operation, inner_broadcast)
+    {
+        xtensor<double, 2> a = {{0., 1., 2., 3., 4.}, {5., 6., 7., 8., 9.}, {10., 11., 12., 13., 14.}};
+        xtensor<double, 2> b = {{1.}, {2.}, {3.}};
+        xtensor<double, 1> c = {1., 2., 3., 4., 5.};
+
+        xtensor<double, 2> res1 = a + b;
+        xtensor<double, 2> res2 = (a - b) * c;
+        for (std::size_t i = 0; i < a.shape()[0]; ++i)
+        {
+            for (std::size_t j = 0; j < a.shape()[1]; ++j)
+            {
+                EXPECT_EQ(res1(i, j), a(i, j) + b(i, 0));
+                EXPECT_EQ(res2(i, j), (a(i, j) - b(i, 0)) * c(j));
+            }
+        }
+
+        xarray<int> d = xarray<int>::from_shape({2, 3, 4});
+        std::iota(d.begin(), d.end(), 0);
+        xarray<int> e = {{{100}}, {{200}}};
+        xarray<int> res3 = d + e;
+        EXPECT_EQ(res3(0, 2, 3), 111);
+        EXPECT_EQ(res3(1, 0, 0), 212);
+    }
+
+    TEST(operation, multiply_add)
+    {
+        // the product is 1 - 2^-54, which rounds to 1
+        xarray<double> a = {1. + std::ldexp(1., -27), 2.};
+        xarray<double> b = {1. - std::ldexp(1., -27), 3.};
+        xarray<double> c = {-1., 1.};
+
+        xarray<double> res1 = a * b + c;
+        xarray<double> res2 = c + a * b;
+        xarray<double> res3 = a * b + a * b;
+        xarray<double> res4 = 2. * a + 1.;
+        auto p = a * b;
+        xarray<double> res5 = p + c;
+        EXPECT_NEAR(res1(0), 0., 1e-15);
+        EXPECT_EQ(res1(1), 7.);
+        EXPECT_EQ(res2(1), 7.);
+        EXPECT_EQ(res3(1), 12.);
+        EXPECT_EQ(res4(1), 5.);
+        EXPECT_EQ(res5(1), 7.);
+
+        xarray<int> ia = {1, 2};
+        xarray<int> ib = {3, 4};
+        xarray<int> ires = ia * ib + ia;
+        EXPECT_EQ(ires(1), 10);
+
+#if defined(XTENSOR_FMA_CONTRACTION) && (!defined(XTENSOR_USE_XSIMD) || defined(__FMA__))
+        using fma_type = typename decltype(a * b + c)::functor_type;
+        using plus_type = typename decltype(p + c)::functor_type;
+        EXPECT_TRUE((std::is_same<fma_type, detail::multiply_add>::value));
+        EXPECT_TRUE((std::is_same<plus_type, detail::plus>::value));
+        EXPECT_EQ(res1(0), -std::ldexp(1., -54));
+        EXPECT_EQ(res2(0), -std::ldexp(1., -54));
+#endif
+    }
+
+    TEST(operation, conversion_assign)
+    {
+        xarray<std::uint8_t> pixels = {{0, 17}, {128, 255}};
+        xarray<float> f = pixels;
+        EXPECT_EQ(f(0, 1), 17.f);
+        EXPECT_EQ(f(1, 1), 255.f);
+
+        xtensor<double, 2> d = f;
+        EXPECT_EQ(d(1, 0), 128.);
+
+        xarray<double> values = {-1e30, -2.5, 300., 1e30, std::nan("")};
+        xarray<int> i = values;
+        EXPECT_EQ(i(0), std::numeric_limits<int>::min());
+        EXPECT_EQ(i(1), -2);
+        EXPECT_EQ(i(2), 300);
+        EXPECT_EQ(i(3), std::numeric_limits<int>::max());
+        EXPECT_EQ(i(4), 0);
+
+        xarray<std::uint8_t> u = cast<std::uint8_t>(values);
+        EXPECT_EQ(u(0), 0);
+        EXPECT_EQ(u(2), 255);
+        EXPECT_EQ(u(3), 255);
+
+        xarray<float> g = cast<float>(pixels);
+        EXPECT_EQ(g, f);
+        xarray<int> h = cast<double>(f) + 1.;
+        EXPECT_EQ(h(1, 1), 256);
+    }
+
+    TEST(operation, saturating_conversion)
+    {
+        xarray<int> values = {-1000, -128, 127, 1000};
+        // container, linear xfunction, unrolled and stepper assignments
+        xarray<std::int8_t> a = values;
+        xarray<std::int8_t> b = values * 2;
+        xtensor_fixed<std::int8_t, xshape<4>> c = values;
+        xarray<std::int8_t> d = view(values, range(placeholders::_, placeholders::_, -1));
+        xarray<std::int8_t> expected = {-128, -128, 127, 127};
+        EXPECT_EQ(a, expected);
+        EXPECT_EQ(b, expected);
+        EXPECT_EQ(c(0), -128);
+        EXPECT_EQ(c(3), 127);
+        xarray<std::int8_t> reversed = {127, 127, -128, -128};
+        EXPECT_EQ(d, reversed);
+        xarray<std::int8_t> e = cast<std::int8_t>(values);
+        EXPECT_EQ(e, expected);
+
+        xarray<std::uint8_t> u = values;
+        EXPECT_EQ(u(0), 0);
+        EXPECT_EQ(u(2), 127);
+        EXPECT_EQ(u(3), 255);
+        xarray<unsigned int> ui = values;
+        EXPECT_EQ(ui(0), 0u);
+        xarray<std::int16_t> s = xarray<unsigned int>({70000u, 5u});
+        EXPECT_EQ(s(0), std::numeric_limits<std::int16_t>::max());
+        EXPECT_EQ(s(1), 5);
+
+        xarray<double> f = {-1e30, 1e30};
+        xarray<int> i = view(f, range(placeholders::_, placeholders::_, -1)) * 2.;
+        EXPECT_EQ(i(0), std::numeric_limits<int>::max());
+        EXPECT_EQ(i(1), std::numeric_limits<int>::min());
+    }
+
+    TEST(operation, bitset_mask)
+    {
+        parallel::scoped_settings guard(0, 0);
+        xarray<double> a = reshape_view(arange<double>(1000.), {10, 100});
+        a = sin(a);
+        xarray_bitset<> m = a > 0.25;
+        xarray<bool> b = a > 0.25;
+        ASSERT_EQ(m.shape(), b.shape());
+        for (std::size_t i = 0; i < b.size(); ++i)
+        {
+            EXPECT_EQ(bool(m.storage()[i]), b.storage()[i]);
+        }
+
+        EXPECT_EQ(nonzero(m), nonzero(b));
+        EXPECT_EQ(argwhere(m), argwhere(b));
+        EXPECT_EQ(where(m), where(b));
+        EXPECT_EQ(count_nonzero(m, evaluation_strategy::immediate())(), count_nonzero(b)());
+        xarray<std::size_t> counts = count_nonzero(m, {1}, evaluation_strategy::immediate());
+        xarray<std::size_t> expected_counts = count_nonzero(b, {1});
+        EXPECT_EQ(counts, expected_counts);
+        EXPECT_EQ(filter(a, m), filter(a, b));
+        EXPECT_EQ(any(m), any(b));
+        EXPECT_EQ(all(m), all(b));
+
+        xarray_bitset<> tail = view(a, 0, range(0, 70)) > 2.;
+        EXPECT_EQ(count_nonzero(tail, evaluation_strategy::immediate())(), std::size_t(0));
+        EXPECT_TRUE(nonzero(tail)[0].empty());
+    }
+
+    TEST(operation, storage_equality)
+    {
+        parallel::scoped_settings guard(0, 0);
+        xarray<int> a = reshape_view(arange<int>(20000), {100, 200});
+        xarray<int> b = a;
+        xtensor<int, 2> t = a;
+        EXPECT_TRUE(a == b);
+        EXPECT_TRUE(a == t);
+        b(99, 199) = 0;
+        EXPECT_TRUE(a != b);
+        b(99, 199) = a(99, 199);
+        b(0, 0) = 1;
+        EXPECT_FALSE(a == b);
+
+        xarray<int, layout_type::column_major> c = a;
+        EXPECT_TRUE(a == c);
+        EXPECT_TRUE(view(a, range(10, 20), all()) == view(t, range(10, 20), all()));
+        EXPECT_FALSE(view(a, range(10, 20), all()) == view(t, range(11, 21), all()));
+
+        xarray<double> z = {0., 1., std::nan("")};
+        xarray<double> nz = {-0., 1., std::nan("")};
+        EXPECT_FALSE(z == nz);
+        z(2) = 2.;
+        nz(2) = 2.;
+        EXPECT_TRUE(z == nz);
+    }
 }
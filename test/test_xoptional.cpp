@@ -9,6 +9,8 @@
 #include "gtest/gtest.h"
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -333,6 +335,46 @@ namespace xt
         EXPECT_FALSE(hvred(1));
     }
 
+    TEST(xoptional, nan_optional)
+    {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        xarray<double> a = {{1., nan, 3.},
+                            {4., 5., 6.}};
+        auto o = nan_optional(a);
+
+        EXPECT_EQ(o(0, 0).value(), 1.);
+        EXPECT_FALSE(o(0, 1).has_value());
+        EXPECT_TRUE(o(1, 1).has_value());
+        EXPECT_EQ(&value(o), &a);
+
+        xarray<bool> hv = has_value(o);
+        EXPECT_EQ(hv, xarray<bool>({{true, false, true}, {true, true, true}}));
+
+        xarray_optional<double> res = o + 1.;
+        EXPECT_EQ(res(0, 2).value(), 4.);
+        EXPECT_FALSE(res(0, 1).has_value());
+        EXPECT_TRUE(res(1, 0).has_value());
+
+        xtensor_optional<double, 2> m = {{1., 2., 3.}, {4., 5., xtl::missing<double>()}};
+        xtensor_optional<double, 2> mixed = o * m;
+        EXPECT_EQ(mixed(0, 2).value(), 9.);
+        EXPECT_FALSE(mixed(0, 1).has_value());
+        EXPECT_FALSE(mixed(1, 2).has_value());
+        EXPECT_TRUE(mixed(1, 1).has_value());
+
+        auto red = sum(o, {1});
+        auto vred = red.value();
+        auto hvred = red.has_value();
+        EXPECT_EQ(vred(1), 15.);
+        EXPECT_FALSE(hvred(0));
+        EXPECT_TRUE(hvred(1));
+
+        // the value expression of a sentinel propagates the NaN
+        xarray<double> v = value(o * 2.);
+        EXPECT_TRUE(std::isnan(v(0, 1)));
+        EXPECT_EQ(v(1, 2), 12.);
+    }
+
     TEST(xoptional, strided_view)
     {
         xarray_optional<int> a = {{{0, 1, 2, 3},
@@ -10,6 +10,7 @@
 
 #include "xtensor/xarray.hpp"
 #include "xtensor/xio.hpp"
+#include "xtensor/xnoalias.hpp"
 #include "xtensor/xoptional_assembly.hpp"
 
 #include "test_common.hpp"
@@ -532,4 +533,57 @@ namespace xt
         dyn_opt_ass_type g = opt(2, true) * a;
         EXPECT_EQ(res, f);
     }
+
+    TEST(xoptional_assembly, bitset_flags)
+    {
+        using bitset_ass_type = xoptional_assembly<xarray<double>, xarray_bitset<>>;
+        std::vector<std::size_t> shape = {2, 35};
+        xarray<double> v(shape, 1.);
+        xarray_bitset<> hv(shape, true);
+        hv(1, 33) = false;
+
+        bitset_ass_type a(v, hv);
+        EXPECT_FALSE(a(1, 33).has_value());
+        EXPECT_TRUE(a(1, 34).has_value());
+        EXPECT_FALSE(all(a.has_value()));
+        EXPECT_TRUE(any(a.has_value()));
+
+        bitset_ass_type b(shape);
+        b = a + a;
+        EXPECT_EQ(b.has_value().storage().count(), 69u);
+        EXPECT_FALSE(b(1, 33).has_value());
+        EXPECT_EQ(b(0, 0).value(), 2.);
+
+        noalias(b.has_value()) = true;
+        EXPECT_TRUE(all(b.has_value()));
+        EXPECT_EQ(b.has_value().storage().count(), 70u);
+
+        noalias(b.has_value()) = false;
+        EXPECT_FALSE(any(b.has_value()));
+    }
+
+    TEST(xoptional_assembly, split_flags)
+    {
+        using bitset_ass_type = xoptional_assembly<xarray<double>, xarray_bitset<>>;
+        std::vector<std::size_t> shape = {3, 30};
+        bitset_ass_type a(shape, 2.);
+        bitset_ass_type b(shape, 3.);
+        a(0, 1) = xtl::missing<double>();
+        b(2, 29) = xtl::missing<double>();
+        xarray<double> c(shape, 1.);
+
+        bitset_ass_type res = a * b + c;
+        EXPECT_EQ(res.has_value().storage().count(), 88u);
+        EXPECT_FALSE(res(0, 1).has_value());
+        EXPECT_FALSE(res(2, 29).has_value());
+        EXPECT_EQ(res(1, 5), xtl::xoptional<double>(7.));
+
+        opt_ass_type d = {{1, 2, 3}, {4, 5, 6}};
+        d(1, 1) = xtl::missing<int>();
+        opt_ass_type e = d + xtl::xoptional<int>(1);
+        EXPECT_FALSE(e(1, 1).has_value());
+        EXPECT_EQ(e(1, 2), xtl::xoptional<int>(7));
+        opt_ass_type f = d + xtl::missing<int>();
+        EXPECT_FALSE(any(f.has_value()));
+    }
 }
@@ -0,0 +1,138 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xpad.hpp"
+#include "xtensor/xparallel.hpp"
+#include "xtensor/xstrided_view.hpp"
+#include "xtensor/xtensor.hpp"
+
+namespace xt
+{
+    TEST(xpad, tile)
+    {
+        xarray<int> a = {{1, 2}, {3, 4}};
+        xarray<int> expected = {{1, 2, 1, 2, 1, 2}, {3, 4, 3, 4, 3, 4}, {1, 2, 1, 2, 1, 2}, {3, 4, 3, 4, 3, 4}};
+        xarray<int> t = tile(a, {2, 3});
+        EXPECT_EQ(t, expected);
+        EXPECT_EQ(tile(a, {2, 3}), expected);
+        EXPECT_EQ(tile(a, {2, 3})(3, 5), 4);
+
+        // the inputs and the results of other layouts go through temporaries
+        xarray<int, layout_type::column_major> ca = a;
+        xarray<int> tc = tile(ca, {2, 3});
+        EXPECT_EQ(tc, expected);
+        xarray<int, layout_type::column_major> ct = tile(a, {2, 3});
+        EXPECT_EQ(ct, expected);
+        xarray<double> td = tile(a + 1, {1, 2});
+        EXPECT_EQ(td, xarray<double>({{2., 3., 2., 3.}, {4., 5., 4., 5.}}));
+
+        // the shape or the repetitions are prepended with ones
+        xarray<int> t1 = tile(a, {2});
+        EXPECT_EQ(t1, xarray<int>({{1, 2, 1, 2}, {3, 4, 3, 4}}));
+        xarray<int> v = {1, 2, 3};
+        xarray<int> t3 = tile(v, {2, 1, 2});
+        EXPECT_EQ(t3, xarray<int>({{{1, 2, 3, 1, 2, 3}}, {{1, 2, 3, 1, 2, 3}}}));
+        xarray<int> t0 = tile(a, {0, 2});
+        EXPECT_EQ(t0.shape()[0], std::size_t(0));
+        EXPECT_EQ(t0.shape()[1], std::size_t(4));
+    }
+
+    TEST(xpad, repeat)
+    {
+        xarray<int> a = {{1, 2}, {3, 4}};
+        xarray<int> r0 = repeat(a, {1, 2}, 0);
+        EXPECT_EQ(r0, xarray<int>({{1, 2}, {3, 4}, {3, 4}}));
+        xarray<int> r1 = repeat(a, 2, 1);
+        EXPECT_EQ(r1, xarray<int>({{1, 1, 2, 2}, {3, 3, 4, 4}}));
+        EXPECT_EQ(repeat(a, 2, 1)(1, 2), 4);
+        xtensor<int, 2> r2 = repeat(a, {0, 3}, 1);
+        EXPECT_EQ(r2, xarray<int>({{2, 2, 2}, {4, 4, 4}}));
+
+        EXPECT_THROW(repeat(a, {1, 2, 3}, 0), std::runtime_error);
+        EXPECT_THROW(repeat(a, 2, 2), std::runtime_error);
+    }
+
+    TEST(xpad, pad)
+    {
+        xarray<int> a = {{1, 2}, {3, 4}};
+        xarray<int> e = pad(a, {{1, 0}, {0, 2}}, pad_mode::edge);
+        EXPECT_EQ(e, xarray<int>({{1, 2, 2, 2}, {1, 2, 2, 2}, {3, 4, 4, 4}}));
+        xarray<int> c = pad(a, 1);
+        EXPECT_EQ(c, xarray<int>({{0, 0, 0, 0}, {0, 1, 2, 0}, {0, 3, 4, 0}, {0, 0, 0, 0}}));
+        xarray<int> c9 = pad(a, 1, pad_mode::constant, 9);
+        EXPECT_EQ(c9(0, 0), 9);
+        EXPECT_EQ(c9(2, 2), 4);
+        xarray<int> w = pad(a, 1, pad_mode::wrap);
+        EXPECT_EQ(w, xarray<int>({{4, 3, 4, 3}, {2, 1, 2, 1}, {4, 3, 4, 3}, {2, 1, 2, 1}}));
+
+        xarray<int> v = {1, 2, 3};
+        xarray<int> reflect = pad(v, 2, pad_mode::reflect);
+        EXPECT_EQ(reflect, xarray<int>({3, 2, 1, 2, 3, 2, 1}));
+        xarray<int> symmetric = pad(v, 2, pad_mode::symmetric);
+        EXPECT_EQ(symmetric, xarray<int>({2, 1, 1, 2, 3, 3, 2}));
+        xarray<int> wrap = pad(v, 2, pad_mode::wrap);
+        EXPECT_EQ(wrap, xarray<int>({2, 3, 1, 2, 3, 1, 2}));
+        xarray<int> wide = pad(v, 5, pad_mode::reflect);
+        EXPECT_EQ(wide, xarray<int>({2, 1, 2, 3, 2, 1, 2, 3, 2, 1, 2, 3, 2}));
+
+        // the padding of an empty axis is constant
+        xarray<int> empty = xarray<int>::from_shape({0, 2});
+        xarray<int> pe = pad(empty, {{1, 1}, {0, 0}}, pad_mode::constant, 5);
+        EXPECT_EQ(pe, xarray<int>({{5, 5}, {5, 5}}));
+        EXPECT_THROW(pad(empty, 1, pad_mode::edge), std::runtime_error);
+        EXPECT_THROW(pad(a, {{1, 1}, {1, 1}, {1, 1}}), std::runtime_error);
+    }
+
+    TEST(xpad, lazy_and_kernels)
+    {
+        // the kernels fill the containers as the elements of the expressions
+        xarray<int> a = reshape_view(arange<int>(2 * 3 * 4), {2, 3, 4});
+        std::vector<std::array<std::size_t, 2>> width = {{1, 2}, {0, 3}, {2, 1}};
+        for (auto mode : {pad_mode::constant, pad_mode::edge, pad_mode::reflect, pad_mode::symmetric, pad_mode::wrap})
+        {
+            auto lazy = pad(a, width, mode, -1);
+            xarray<int> res = lazy;
+            xarray<int> res_cm = xarray<int, layout_type::column_major>(lazy);
+            bool equal = true;
+            for (std::size_t i = 0; i < res.shape()[0]; ++i)
+            {
+                for (std::size_t j = 0; j < res.shape()[1]; ++j)
+                {
+                    for (std::size_t k = 0; k < res.shape()[2]; ++k)
+                    {
+                        equal = equal && res(i, j, k) == lazy(i, j, k) && res_cm(i, j, k) == lazy(i, j, k);
+                    }
+                }
+            }
+            EXPECT_TRUE(equal);
+        }
+
+        xarray<int> t = tile(a, {2, 1, 3});
+        EXPECT_EQ(t, tile(a, {2, 1, 3}));
+        xarray<int> r = repeat(a, {3, 0, 1}, 1);
+        EXPECT_EQ(r, repeat(a, {3, 0, 1}, 1));
+        {
+            parallel::scoped_settings settings(0, 0);
+            xarray<int> tp = tile(a, {2, 1, 3});
+            EXPECT_EQ(tp, t);
+            xarray<int> rp = repeat(a, {3, 0, 1}, 1);
+            EXPECT_EQ(rp, r);
+            xarray<int> pp = pad(a, width, pad_mode::reflect);
+            EXPECT_EQ(pp, pad(a, width, pad_mode::reflect));
+        }
+    }
+}
@@ -0,0 +1,234 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmanipulation.hpp"
+#include "xtensor/xparallel.hpp"
+#include "xtensor/xtensor.hpp"
+
+namespace xt
+{
+    namespace
+    {
+        struct chunked_executor
+        {
+            std::size_t* p_calls;
+
+            void operator()(std::size_t first, std::size_t last, std::size_t grain,
+                            const parallel::body_type& body) const
+            {
+                for (std::size_t i = first; i < last; i += grain)
+                {
+                    ++(*p_calls);
+                    body(i, std::min(i + grain, last));
+                }
+            }
+        };
+    }
+
+    TEST(xparallel, parallel_for)
+    {
+        std::vector<int> v(1000, 0);
+        parallel_for(std::size_t(0), v.size(), std::size_t(16), [&v](std::size_t first, std::size_t last)
+        {
+            for (std::size_t i = first; i < last; ++i)
+            {
+                v[i] += 1;
+            }
+        });
+        EXPECT_TRUE(std::all_of(v.cbegin(), v.cend(), [](int i) { return i == 1; }));
+    }
+
+    TEST(xparallel, parallel_for_exception)
+    {
+        parallel::scoped_settings settings(0, 0);
+        std::atomic<std::size_t> count(0);
+        auto body = [&count](std::size_t first, std::size_t last)
+        {
+            count += last - first;
+            if (first == 0)
+            {
+                throw std::runtime_error("parallel_for: test");
+            }
+        };
+        EXPECT_THROW(parallel_for(std::size_t(0), std::size_t(1000), std::size_t(16), body), std::runtime_error);
+        EXPECT_GT(count.load(), std::size_t(0));
+        EXPECT_FALSE(parallel::in_parallel_region());
+    }
+
+    TEST(xparallel, user_executor)
+    {
+        std::size_t calls = 0;
+        parallel::set_executor(chunked_executor{&calls});
+        EXPECT_TRUE(parallel::has_executor());
+
+        std::vector<int> v(1000, 0);
+        parallel_for(std::size_t(0), v.size(), std::size_t(10), [&v](std::size_t first, std::size_t last)
+        {
+            for (std::size_t i = first; i < last; ++i)
+            {
+                v[i] += 1;
+            }
+        });
+        EXPECT_EQ(calls, std::size_t(100));
+        EXPECT_TRUE(std::all_of(v.cbegin(), v.cend(), [](int i) { return i == 1; }));
+
+        parallel_for(std::size_t(5), std::size_t(5), std::size_t(10), [](std::size_t, std::size_t) {});
+        EXPECT_EQ(calls, std::size_t(100));
+
+        parallel::reset_executor();
+        EXPECT_FALSE(parallel::has_executor());
+    }
+
+    TEST(xparallel, assign_with_executor)
+    {
+        std::size_t calls = 0;
+        parallel::set_executor(chunked_executor{&calls});
+        parallel::scoped_settings guard(0, 0);
+
+        xtensor<double, 2> a = xt::ones<double>({64, 64});
+        xtensor<double, 2> b = xt::ones<double>({64, 64});
+        xtensor<double, 2> res = a + 2. * b;
+        EXPECT_TRUE(std::all_of(res.cbegin(), res.cend(), [](double d) { return d == 3.; }));
+
+        xarray<int> ia = xt::ones<int>({100});
+        xarray<double> dres = ia;
+        EXPECT_TRUE(std::all_of(dres.cbegin(), dres.cend(), [](double d) { return d == 1.; }));
+
+#if defined(XTENSOR_PARALLEL_ENABLED)
+        EXPECT_GT(calls, std::size_t(0));
+#endif
+        parallel::reset_executor();
+    }
+
+    TEST(xparallel, strided_assign_with_executor)
+    {
+        std::size_t calls = 0;
+        parallel::set_executor(chunked_executor{&calls});
+        parallel::scoped_settings guard(0, 0);
+
+        xtensor<double, 3> a = xt::ones<double>({4, 5, 6});
+        std::iota(a.begin(), a.end(), 0.);
+        xtensor<double, 3> b = xt::ones<double>({4, 5, 6});
+        xtensor<double, 3> res = transpose(a) + transpose(b);
+        for (std::size_t i = 0; i < 6; ++i)
+        {
+            for (std::size_t j = 0; j < 5; ++j)
+            {
+                for (std::size_t k = 0; k < 4; ++k)
+                {
+                    EXPECT_EQ(res(i, j, k), a(k, j, i) + 1.);
+                }
+            }
+        }
+
+        xtensor<double, 3> cm_res = xtensor<double, 3, layout_type::column_major>(a + b);
+        EXPECT_EQ(cm_res, a + b);
+
+        parallel::reset_executor();
+    }
+
+    TEST(xparallel, stepper_assign_with_executor)
+    {
+        std::size_t calls = 0;
+        parallel::set_executor(chunked_executor{&calls});
+        parallel::scoped_settings guard(0, 0);
+
+        xarray<double> a = xt::ones<double>({7, 1});
+        xarray<double> b = xt::ones<double>({1, 9});
+        std::iota(a.begin(), a.end(), 0.);
+        std::iota(b.begin(), b.end(), 0.);
+
+        xarray<double> res = a + b;
+        ASSERT_EQ(res.shape()[0], std::size_t(7));
+        ASSERT_EQ(res.shape()[1], std::size_t(9));
+        for (std::size_t i = 0; i < 7; ++i)
+        {
+            for (std::size_t j = 0; j < 9; ++j)
+            {
+                EXPECT_EQ(res(i, j), double(i + j));
+            }
+        }
+
+        xarray<double, layout_type::column_major> cm_res = a + b;
+        EXPECT_EQ(cm_res, res);
+
+        parallel::reset_executor();
+    }
+
+    TEST(xparallel, settings)
+    {
+        parallel::settings_type previous = parallel::settings();
+        {
+            parallel::scoped_settings guard(100, 48);
+            EXPECT_FALSE(parallel::use_parallel(99));
+            EXPECT_TRUE(parallel::use_parallel(100));
+            EXPECT_EQ(parallel::grain(1), std::size_t(48));
+            EXPECT_EQ(parallel::grain(10), std::size_t(5));
+            EXPECT_EQ(parallel::grain(1, 32), std::size_t(64));
+        }
+        EXPECT_EQ(parallel::settings().min_size, previous.min_size);
+        EXPECT_EQ(parallel::settings().grain_size, previous.grain_size);
+
+        parallel::scoped_settings guard(0, 0);
+        EXPECT_FALSE(parallel::use_parallel(0));
+        EXPECT_EQ(parallel::grain(7), std::size_t(1));
+    }
+
+    TEST(xparallel, settings_threads)
+    {
+        parallel::settings_type global = parallel::settings();
+        parallel::scoped_settings outer(10, 20);
+        {
+            // the guards of a thread apply to that thread only
+            std::atomic<int> failures(0);
+            auto run = [&failures](std::size_t min_size, std::size_t grain_size)
+            {
+                if (parallel::settings().grain_size == 20)
+                {
+                    ++failures;
+                }
+                for (int i = 0; i < 1000; ++i)
+                {
+                    parallel::scoped_settings guard(min_size, grain_size);
+                    {
+                        parallel::scoped_settings nested(min_size + 1, grain_size + 1);
+                        failures += parallel::settings().min_size != min_size + 1;
+                    }
+                    failures += parallel::settings().min_size != min_size;
+                    failures += parallel::settings().grain_size != grain_size;
+                }
+            };
+            std::thread t1(run, std::size_t(100), std::size_t(1));
+            std::thread t2(run, std::size_t(200), std::size_t(2));
+            t1.join();
+            t2.join();
+            EXPECT_EQ(failures.load(), 0);
+        }
+        EXPECT_EQ(parallel::settings().min_size, std::size_t(10));
+        EXPECT_EQ(parallel::settings().grain_size, std::size_t(20));
+
+        std::size_t previous = global.min_size;
+        parallel::set_min_size(previous + 1);
+        EXPECT_EQ(parallel::settings().min_size, std::size_t(10));
+        std::thread t([previous]() { EXPECT_EQ(parallel::settings().min_size, previous + 1); });
+        t.join();
+        parallel::set_min_size(previous);
+    }
+}
@@ -0,0 +1,97 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_ENABLE_INSTRUMENTATION
+#define XTENSOR_ENABLE_INSTRUMENTATION
+#endif
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xprofile.hpp"
+#include "xtensor/xstrided_view.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    using event_kind = instrument::event_kind;
+
+    TEST(xprofile, entries)
+    {
+        xarray<double> a = reshape_view(arange<double>(24.), {4, 6});
+        xarray<double> b = zeros<double>({4, 6});
+        xarray<double> c = zeros<double>({4, 3});
+        std::ostringstream out;
+        {
+            profile_scope prof(out);
+            for (std::size_t i = 0; i < 3; ++i)
+            {
+                noalias(b) = a + a;
+            }
+            noalias(c) = view(a, all(), range(0, 6, 2));
+
+            auto entries = prof.entries();
+            ASSERT_EQ(entries.size(), std::size_t(2));
+            std::size_t linear = entries[0].path == event_kind::linear_assign ? 0 : 1;
+            EXPECT_EQ(entries[linear].path, event_kind::linear_assign);
+            EXPECT_EQ(entries[linear].count, std::size_t(3));
+            EXPECT_EQ(entries[linear].elements, std::size_t(72));
+            EXPECT_EQ(entries[linear].bytes, 72 * 2 * sizeof(double));
+            EXPECT_FALSE(entries[linear].expression.empty());
+
+            const auto& strided = entries[1 - linear];
+            EXPECT_TRUE(strided.path == event_kind::stepper_assign || strided.path == event_kind::strided_loop_assign);
+            EXPECT_EQ(strided.count, std::size_t(1));
+            EXPECT_NE(strided.expression, entries[linear].expression);
+            EXPECT_GE(entries[0].elapsed, entries[1].elapsed);
+        }
+        std::string report = out.str();
+        EXPECT_NE(report.find("xt::linear_assign"), std::string::npos);
+        EXPECT_FALSE(instrument::has_callbacks());
+    }
+
+    TEST(xprofile, reducers)
+    {
+        xarray<double> a = reshape_view(arange<double>(24.), {4, 6});
+        profile_scope prof(nullptr);
+        xarray<double> r1 = sum(a, {1});
+        xarray<double> r2 = sum(a, {1}, evaluation_strategy::immediate());
+
+        bool has_reduce_immediate = false;
+        for (const auto& e : prof.entries())
+        {
+            has_reduce_immediate |= e.path == event_kind::reduce_immediate;
+            EXPECT_EQ(e.count, std::size_t(1));
+        }
+        EXPECT_TRUE(has_reduce_immediate);
+    }
+
+    TEST(xprofile, chained_callbacks)
+    {
+        xarray<double> a = reshape_view(arange<double>(24.), {4, 6});
+        std::size_t count = 0;
+        instrument::set_callbacks(nullptr, [&count](const instrument::event&) { ++count; });
+        {
+            profile_scope prof(nullptr);
+            xarray<double> b = a + a;
+            EXPECT_EQ(prof.entries().size(), std::size_t(1));
+        }
+        EXPECT_NE(count, std::size_t(0));
+        std::size_t previous = count;
+        xarray<double> c = a * a;
+        EXPECT_GT(count, previous);
+        instrument::reset_callbacks();
+    }
+}
@@ -0,0 +1,125 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xparallel.hpp"
+#include "xtensor/xquantize.hpp"
+#include "xtensor/xstrided_view.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    using i8 = std::int8_t;
+    using i16 = std::int16_t;
+
+    TEST(xquantize, saturating)
+    {
+        xtensor<i8, 1> a = {i8(100), i8(-100), i8(5), i8(-128), i8(127)};
+        xtensor<i8, 1> b = {i8(100), i8(-100), i8(-7), i8(-1), i8(1)};
+
+        xtensor<i8, 1> sum = saturating_add(a, b);
+        EXPECT_EQ(sum, (xtensor<i8, 1>{i8(127), i8(-128), i8(-2), i8(-128), i8(127)}));
+        xtensor<i8, 1> diff = saturating_sub(a, b);
+        EXPECT_EQ(diff, (xtensor<i8, 1>{i8(0), i8(0), i8(12), i8(-127), i8(126)}));
+        xtensor<i8, 1> prod = saturating_mul(a, b);
+        EXPECT_EQ(prod, (xtensor<i8, 1>{i8(127), i8(127), i8(-35), i8(127), i8(127)}));
+        EXPECT_EQ(saturating_add(a, i8(100))(0), i8(127));
+
+        xtensor<std::uint8_t, 1> u = {std::uint8_t(200), std::uint8_t(3)};
+        xtensor<std::uint8_t, 1> us = saturating_sub(u, std::uint8_t(10));
+        EXPECT_EQ(us, (xtensor<std::uint8_t, 1>{std::uint8_t(190), std::uint8_t(0)}));
+
+        xarray<i16> s = {i16(30000), i16(-30000), i16(200)};
+        xarray<i16> sp = saturating_mul(s, s);
+        EXPECT_EQ(sp, (xarray<i16>{i16(32767), i16(32767), i16(32767)}));
+
+        // the linear and the strided assignments agree
+        xarray<i8> big = reshape_view(arange<int>(-120, 120), {16, 15});
+        xarray<i8> res = saturating_mul(big, i8(3));
+        xarray<i8> col = saturating_mul(view(big, all(), range(0, 15, 2)), i8(3));
+        EXPECT_EQ(col, view(res, all(), range(0, 15, 2)));
+        EXPECT_EQ(res(0, 0), i8(-128));
+        EXPECT_EQ(res(8, 0), i8(0));
+        EXPECT_EQ(res(15, 14), i8(127));
+    }
+
+    TEST(xquantize, requantize)
+    {
+        xtensor<std::int32_t, 1> acc = {-300, 5, 1000, -6, 6};
+        xtensor<i8, 1> q = requantize(acc, 1, 2);
+        EXPECT_EQ(q, (xtensor<i8, 1>{i8(-75), i8(1), i8(127), i8(-1), i8(2)}));
+
+        xtensor<i8, 1> qz = requantize(acc, 3, 4, -10);
+        EXPECT_EQ(qz, (xtensor<i8, 1>{i8(-66), i8(-9), i8(127), i8(-11), i8(-9)}));
+
+        auto q16 = requantize<i16>(acc, 1000, 0);
+        EXPECT_EQ(q16(0), i16(-32768));
+        EXPECT_EQ(q16(1), i16(5000));
+
+        EXPECT_THROW(requantize(acc, 1, -1), std::runtime_error);
+        EXPECT_THROW(requantize(acc, 1, 63), std::runtime_error);
+    }
+
+    TEST(xquantize, dot_accumulate)
+    {
+        xarray<i8> a = arange<int>(1000) % 255 - 127;
+        xarray<i8> b = (arange<int>(1000) * 7) % 255 - 127;
+        std::int32_t expected = 0;
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            expected += std::int32_t(a(i)) * std::int32_t(b(i));
+        }
+        EXPECT_EQ(dot_accumulate(a, b), expected);
+
+        // the expressions without a row major buffer are evaluated first
+        xarray<i8> a2 = reshape_view(a, {40, 25});
+        xarray<i8, layout_type::column_major> b2 = reshape_view(b, {40, 25});
+        EXPECT_EQ(dot_accumulate(a2, b2), expected);
+        EXPECT_EQ(dot_accumulate(a2, saturating_add(reshape_view(b, {40, 25}), i8(0))), expected);
+
+        // the accumulation wraps around like an int32
+        xtensor<i16, 1> s = xtensor<i16, 1>::from_shape({5000});
+        s.fill(i16(32767));
+        std::int64_t wide = std::int64_t(5000) * 32767 * 32767;
+        EXPECT_EQ(dot_accumulate(s, s), static_cast<std::int32_t>(static_cast<std::uint32_t>(wide)));
+
+        {
+            parallel::scoped_settings settings(0, 0);
+            EXPECT_EQ(dot_accumulate(a, b), expected);
+        }
+
+        EXPECT_THROW(dot_accumulate(a, a2), std::runtime_error);
+    }
+
+    TEST(xquantize, matmul_accumulate)
+    {
+        xtensor<i8, 2> a = {{1, 2, 3}, {-4, 5, -6}};
+        xtensor<i8, 2> b = {{7, 8}, {9, -10}, {11, 12}};
+        xtensor<std::int32_t, 2> c = matmul_accumulate(a, b);
+        EXPECT_EQ(c, (xtensor<std::int32_t, 2>{{58, 24}, {-49, -154}}));
+
+        xtensor<i8, 2> big = reshape_view(arange<int>(24 * 33) % 200 - 100, {24, 33});
+        xtensor<i8, 2> bigt = transpose(big);
+        xtensor<std::int32_t, 2> r = matmul_accumulate(big, bigt);
+        EXPECT_EQ(r(3, 5), dot_accumulate(view(big, 3), view(big, 5)));
+        {
+            parallel::scoped_settings settings(0, 0);
+            EXPECT_EQ(matmul_accumulate(big, bigt), r);
+        }
+
+        EXPECT_THROW(matmul_accumulate(a, a), std::runtime_error);
+    }
+}
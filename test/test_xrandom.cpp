@@ -6,6 +6,11 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <random>
+
 #include "gtest/gtest.h"
 #include "xtensor/xrandom.hpp"
 #include "xtensor/xarray.hpp"
@@ -49,6 +54,92 @@ namespace xt
         ASSERT_NE(p1, p3);
     }
 
+    TEST(xrandom, philox_engine)
+    {
+        random::philox_engine e1(42);
+        random::philox_engine e2(42);
+        EXPECT_EQ(e1, e2);
+        EXPECT_EQ(e1(), e2());
+
+        for (int i = 0; i < 9; ++i)
+        {
+            e1();
+        }
+        e2.discard(9);
+        EXPECT_EQ(e1, e2);
+        EXPECT_EQ(e1(), e2());
+
+        random::philox_engine s1 = e1.substream(3);
+        random::philox_engine s2 = e1.substream(1).substream(2);
+        EXPECT_EQ(s1(), s2());
+        EXPECT_NE(s1(), e1());
+
+        std::uniform_real_distribution<double> dist(0., 1.);
+        double d = dist(e1);
+        EXPECT_GE(d, 0.);
+        EXPECT_LT(d, 1.);
+    }
+
+    TEST(xrandom, philox_parallel)
+    {
+        random::philox_engine e1(7);
+        xarray<double> a;
+        {
+            parallel::scoped_settings settings(1, 1);
+            a = random::randn<double>({100, 100}, 0., 1., e1);
+        }
+
+        random::philox_engine e2(7);
+        xarray<double> b;
+        {
+            parallel::scoped_settings settings(std::size_t(-1), 0);
+            b = random::randn<double>({100, 100}, 0., 1., e2);
+        }
+        EXPECT_EQ(a, b);
+        EXPECT_EQ(e1, e2);
+        EXPECT_NE(a(0, 0), a(0, 1));
+
+        xarray<double> c = random::randn<double>({100, 100}, 0., 1., e1);
+        EXPECT_NE(a, c);
+
+        xarray<int> r = random::randint<int>({1000}, 0, 10, e1);
+        EXPECT_GE(*std::min_element(r.cbegin(), r.cend()), 0);
+        EXPECT_LT(*std::max_element(r.cbegin(), r.cend()), 10);
+    }
+
+    TEST(xrandom, bulk_distributions)
+    {
+        random::seed(0);
+        xarray<double> n = random::randn<double>({100001}, 2., 3.);
+        double mean = std::accumulate(n.cbegin(), n.cend(), 0.) / double(n.size());
+        double var = 0.;
+        for (auto v : n)
+        {
+            var += (v - mean) * (v - mean);
+        }
+        var /= double(n.size());
+        EXPECT_NEAR(mean, 2., 0.05);
+        EXPECT_NEAR(var, 9., 0.2);
+
+        xarray<float> u = random::rand<float>({10000}, -1.f, 3.f);
+        EXPECT_GE(*std::min_element(u.cbegin(), u.cend()), -1.f);
+        EXPECT_LT(*std::max_element(u.cbegin(), u.cend()), 3.f);
+        EXPECT_NEAR(std::accumulate(u.cbegin(), u.cend(), 0.) / 10000., 1., 0.1);
+
+        xarray<int> r = random::randint<int>({10000}, -3, 4);
+        std::array<std::size_t, 7> counts = {};
+        for (auto v : r)
+        {
+            ASSERT_GE(v, -3);
+            ASSERT_LT(v, 4);
+            ++counts[static_cast<std::size_t>(v + 3)];
+        }
+        for (auto c : counts)
+        {
+            EXPECT_GT(c, 1000u);
+        }
+    }
+
     TEST(xrandom, choice)
     {
         xarray<double> a = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
@@ -76,6 +167,60 @@ namespace xt
         ASSERT_THROW(xt::random::choice(multidim_input, 5, true), std::runtime_error);
     }
 
+    TEST(xrandom, weighted_choice)
+    {
+        xarray<int> a = {0, 1, 2, 3};
+        xarray<double> w = {1., 0., 3., 4.};
+        random::seed(42);
+        auto c = random::choice(a, 8000, w);
+        std::array<std::size_t, 4> counts = {};
+        for (auto v : c)
+        {
+            ++counts[static_cast<std::size_t>(v)];
+        }
+        EXPECT_EQ(counts[1], 0u);
+        EXPECT_NEAR(double(counts[0]) / 8000., 0.125, 0.03);
+        EXPECT_NEAR(double(counts[3]) / 8000., 0.5, 0.03);
+
+        auto d = random::choice(a, 3, w, false);
+        std::sort(d.begin(), d.end());
+        xtensor<int, 1> exp_d = {0, 2, 3};
+        EXPECT_EQ(d, exp_d);
+
+        EXPECT_THROW(random::choice(a, 4, w, false), std::runtime_error);
+        xarray<double> neg = {1., -1., 1., 1.};
+        EXPECT_THROW(random::choice(a, 2, neg), std::runtime_error);
+    }
+
+    TEST(xrandom, distributions)
+    {
+        random::philox_engine engine(3);
+        xarray<double> e = random::exponential<double>({20000}, 2., engine);
+        EXPECT_GE(*std::min_element(e.cbegin(), e.cend()), 0.);
+        EXPECT_NEAR(std::accumulate(e.cbegin(), e.cend(), 0.) / 20000., 0.5, 0.02);
+
+        xarray<int> b = random::binomial<int>({20000}, 10, 0.3, engine);
+        EXPECT_GE(*std::min_element(b.cbegin(), b.cend()), 0);
+        EXPECT_LE(*std::max_element(b.cbegin(), b.cend()), 10);
+        EXPECT_NEAR(std::accumulate(b.cbegin(), b.cend(), 0.) / 20000., 3., 0.1);
+
+        xarray<int> p = random::poisson<int>({20000}, 4., engine);
+        EXPECT_NEAR(std::accumulate(p.cbegin(), p.cend(), 0.) / 20000., 4., 0.1);
+
+        xarray<double> g = random::gamma<double>({20000}, 2., 3., engine);
+        EXPECT_NEAR(std::accumulate(g.cbegin(), g.cend(), 0.) / 20000., 6., 0.2);
+
+        random::philox_engine e1(5);
+        random::philox_engine e2(5);
+        xarray<double> g1 = random::gamma<double>({3000}, 2., 1., e1);
+        xarray<double> g2;
+        {
+            parallel::scoped_settings settings(1, 1);
+            g2 = random::gamma<double>({3000}, 2., 1., e2);
+        }
+        EXPECT_EQ(g1, g2);
+    }
+
     TEST(xrandom, shuffle)
     {
         xarray<double> a = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
@@ -128,6 +273,38 @@ namespace xt
 
     }
 
+    TEST(xrandom, shuffled)
+    {
+        xarray<double> a = arange<double>(60.);
+        a.reshape({20, 3});
+
+        xt::random::seed(7);
+        auto b = xt::random::shuffled(a);
+        xarray<double> c = a;
+        xt::random::seed(7);
+        xt::random::shuffle(c);
+        EXPECT_EQ(b, c);
+        EXPECT_NE(b, a);
+
+        std::vector<double> rows;
+        for (std::size_t i = 0; i < 20; ++i)
+        {
+            EXPECT_EQ(b(i, 1), b(i, 0) + 1.);
+            EXPECT_EQ(b(i, 2), b(i, 0) + 2.);
+            rows.push_back(b(i, 0));
+        }
+        std::sort(rows.begin(), rows.end());
+        for (std::size_t i = 0; i < 20; ++i)
+        {
+            EXPECT_EQ(rows[i], 3. * double(i));
+        }
+
+        xarray<double, layout_type::column_major> d = a;
+        xt::random::seed(7);
+        xt::random::shuffle(d);
+        EXPECT_EQ(d, c);
+    }
+
     TEST(xrandom, permutation)
     {
         xt::random::seed(123);
@@ -238,6 +238,47 @@ namespace xt
         EXPECT_TRUE(all(equal(avg_d1, expect1)));
     }
 
+    TEST(xreducer, average_fused)
+    {
+        // the immediate averages accumulate both sums in a single pass
+        xtensor<double, 3> a = xt::random::rand<double>({7, 65, 33});
+        xtensor<double, 3> w = 1. + xt::random::rand<double>({7, 65, 33});
+        xtensor<double, 1> w1 = 1. + xt::random::rand<double>({65});
+        xtensor<double, 3, layout_type::column_major> ca = a;
+        xtensor<double, 3, layout_type::column_major> cw = w;
+
+        for (std::size_t ax = 0; ax < 3; ++ax)
+        {
+            xtensor<double, 2> expected = sum(a * w, {ax}) / sum(w, {ax});
+            xtensor<double, 2> res = average(a, w, {ax}, evaluation_strategy::immediate());
+            EXPECT_TRUE(allclose(res, expected));
+            xtensor<double, 2> cres = average(ca, cw, {ax}, evaluation_strategy::immediate());
+            EXPECT_TRUE(allclose(cres, expected));
+        }
+
+        xtensor<double, 2> expected1 = average(a, w1, {1});
+        xtensor<double, 2> res1 = average(a, w1, {1}, evaluation_strategy::immediate());
+        EXPECT_TRUE(allclose(res1, expected1));
+        xtensor<double, 2> cres1 = average(ca, w1, {1}, evaluation_strategy::immediate());
+        EXPECT_TRUE(allclose(cres1, expected1));
+
+        double expected_all = sum(a * w)() / sum(w)();
+        EXPECT_NEAR(average(a, w, evaluation_strategy::immediate())(), expected_all, 1e-12);
+        EXPECT_NEAR(average(a, w, {0, 1, 2}, evaluation_strategy::immediate())(), expected_all, 1e-12);
+        EXPECT_NEAR(average(ca, cw, evaluation_strategy::immediate())(), expected_all, 1e-12);
+
+        {
+            parallel::scoped_settings guard(0, 0);
+            xtensor<double, 2> pres = average(a, w, {1}, evaluation_strategy::immediate());
+            EXPECT_TRUE(allclose(pres, average(a, w, {1})));
+            xtensor<double, 2> pres2 = average(a, w, {2}, evaluation_strategy::immediate());
+            EXPECT_TRUE(allclose(pres2, average(a, w, {2})));
+            xtensor<double, 2> pres1 = average(a, w1, {1}, evaluation_strategy::immediate());
+            EXPECT_TRUE(allclose(pres1, expected1));
+            EXPECT_NEAR(average(a, w, evaluation_strategy::immediate())(), expected_all, 1e-12);
+        }
+    }
+
     TEST(xreducer, minmax)
     {
         using A = std::array<double, 2>;
@@ -245,6 +286,76 @@ namespace xt
         xtensor<double, 2> input
             {{-1.0, 0.0}, {1.0, 0.0}};
         EXPECT_EQ(minmax(input)(), (A{-1.0, 1.0}));
+
+        xtensor<float, 1> large = arange<float>(1000.f) - 300.f;
+        large(517) = -1000.f;
+        large(42) = 2000.f;
+        EXPECT_EQ(minmax(large, evaluation_strategy::immediate())(), (std::array<float, 2>{-1000.f, 2000.f}));
+        EXPECT_EQ(minmax(large, evaluation_strategy::immediate())(), minmax(large)());
+    }
+
+    TEST(xreducer, moments)
+    {
+        xtensor<double, 2> input
+            {{-1.0, 0.0, 4.0}, {1.0, 2.0, 6.0}};
+
+        auto m = moments(input)();
+        EXPECT_EQ(m.count, std::size_t(6));
+        EXPECT_DOUBLE_EQ(m.mean, 2.);
+        EXPECT_DOUBLE_EQ(m.variance(), 34. / 6.);
+        EXPECT_DOUBLE_EQ(m.stddev(1), std::sqrt(34. / 5.));
+        EXPECT_EQ(m.min, -1.);
+        EXPECT_EQ(m.max, 6.);
+
+        auto lz = moments(input, {1});
+        xtensor<xmoments<double>, 1> gd = moments(input, {1}, evaluation_strategy::immediate());
+        for (std::size_t i = 0; i < 2; ++i)
+        {
+            EXPECT_DOUBLE_EQ(lz(i).mean, gd(i).mean);
+            EXPECT_DOUBLE_EQ(lz(i).m2, gd(i).m2);
+            EXPECT_EQ(lz(i).min, gd(i).min);
+            EXPECT_EQ(lz(i).max, gd(i).max);
+        }
+        EXPECT_DOUBLE_EQ(gd(0).mean, 1.);
+        EXPECT_DOUBLE_EQ(gd(1).variance(), 14. / 3.);
+
+        xtensor<int, 1> large = xt::ones<int>({100000});
+        std::iota(large.begin(), large.end(), 0);
+        parallel::scoped_settings guard(0, 0);
+        auto ml = moments(large, evaluation_strategy::immediate())();
+        EXPECT_DOUBLE_EQ(ml.mean, 49999.5);
+        EXPECT_NEAR(ml.variance(), (1e10 - 1.) / 12., 1e-3);
+        EXPECT_EQ(ml.max, 99999.);
+    }
+
+    TEST(xreducer, incremental)
+    {
+        xtensor<double, 2> a = xt::ones<double>({9, 4});
+        std::iota(a.begin(), a.end(), -10.);
+
+        auto running_sum = make_incremental_reducer<double>(make_xreducer_functor(std::plus<double>()));
+        EXPECT_TRUE(running_sum.empty());
+        EXPECT_THROW(running_sum.result(), std::runtime_error);
+
+        auto running_max = make_incremental_reducer<double>(make_xreducer_functor(math::maximum<void>()), {0});
+        for (std::size_t i = 0; i < 9; i += 3)
+        {
+            auto chunk = view(a, range(i, i + 3), all());
+            running_sum.update(chunk);
+            running_max.update(chunk);
+        }
+        EXPECT_EQ(running_sum.count(), std::size_t(36));
+        EXPECT_EQ(running_sum.result()(), sum(a)());
+        EXPECT_EQ(running_max.count(), std::size_t(9));
+        EXPECT_EQ(running_max.result(), amax(a, {0}));
+
+        xtensor<double, 1> wrong = xt::ones<double>({3});
+        EXPECT_THROW(running_max.update(wrong), std::runtime_error);
+
+        running_sum.reset();
+        EXPECT_TRUE(running_sum.empty());
+        running_sum.update(xtensor<double, 1>({1., 2.}));
+        EXPECT_EQ(running_sum.result()(), 3.);
     }
 
     TEST(xreducer, immediate)
@@ -368,6 +479,81 @@ namespace xt
         EXPECT_EQ(a_lz, a_gd_2);
     }
 
+    TEST(xreducer, immediate_inner_axes)
+    {
+        xtensor<double, 3> a;
+        a.resize({4, 5, 67});
+        std::iota(a.storage().begin(), a.storage().end(), 0);
+        xtensor<double, 3, layout_type::column_major> ca = a;
+
+        xarray<double> lz = sum(a, {1, 2});
+        EXPECT_EQ(lz, sum(a, {1, 2}, evaluation_strategy::immediate()));
+        lz = sum(ca, {0, 1});
+        EXPECT_EQ(lz, sum(ca, {0, 1}, evaluation_strategy::immediate()));
+        lz = amax(a, {2});
+        EXPECT_EQ(lz, amax(a, {2}, evaluation_strategy::immediate()));
+        lz = amin(ca, {0});
+        EXPECT_EQ(lz, amin(ca, {0}, evaluation_strategy::immediate()));
+
+        parallel::scoped_settings guard(0, 0);
+        lz = sum(a, {2});
+        EXPECT_EQ(lz, sum(a, {2}, evaluation_strategy::immediate()));
+        lz = amax(a);
+        EXPECT_EQ(lz, amax(a, evaluation_strategy::immediate()));
+        lz = sum(a, {0, 2});
+        EXPECT_EQ(lz, sum(a, {0, 2}, evaluation_strategy::immediate()));
+    }
+
+    TEST(xreducer, immediate_outer_axes)
+    {
+        xtensor<double, 2> a = xt::ones<double>({20, 5000});
+        std::iota(a.begin(), a.end(), 0.);
+        xtensor<double, 2, layout_type::column_major> ca = transpose(a);
+
+        xarray<double> lz = sum(a, {0});
+        EXPECT_EQ(lz, sum(a, {0}, evaluation_strategy::immediate()));
+        lz = amax(ca, {1});
+        EXPECT_EQ(lz, amax(ca, {1}, evaluation_strategy::immediate()));
+
+        xtensor<double, 3> b = xt::ones<double>({6, 7, 800});
+        std::iota(b.begin(), b.end(), 0.);
+        parallel::scoped_settings guard(0, 0);
+        lz = sum(b, {0, 1});
+        EXPECT_EQ(lz, sum(b, {0, 1}, evaluation_strategy::immediate()));
+        lz = amin(b, {1});
+        EXPECT_EQ(lz, amin(b, {1}, evaluation_strategy::immediate()));
+    }
+
+    TEST(xreducer, accurate)
+    {
+        xtensor<float, 1> a = xt::ones<float>({1 << 20}) * 0.1f;
+        double expected = double(1 << 20) * double(0.1f);
+        float s = sum<float>(a, evaluation_strategy::accurate())();
+        EXPECT_NEAR(double(s), expected, 0.1);
+        float m = mean<float>(a, evaluation_strategy::accurate())();
+        EXPECT_NEAR(double(m), double(0.1f), 1e-6);
+        double n1 = norm_l1(a, evaluation_strategy::accurate())();
+        EXPECT_NEAR(n1, expected, 1e-6);
+
+        xtensor<float, 2> b = xt::ones<float>({1 << 16, 3}) * 0.1f;
+        xtensor<float, 1> sb = sum<float>(b, {0}, evaluation_strategy::accurate());
+        xtensor<float, 2, layout_type::column_major> cb = b;
+        xtensor<float, 1> scb = sum<float>(cb, {0}, evaluation_strategy::accurate());
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            EXPECT_NEAR(sb(i), double(1 << 16) * double(0.1f), 0.01);
+            EXPECT_EQ(sb(i), scb(i));
+        }
+
+        xtensor<double, 3> c;
+        c.resize({4, 5, 6});
+        std::iota(c.storage().begin(), c.storage().end(), 0);
+        xarray<double> lz = sum(c, {0, 2});
+        EXPECT_EQ(lz, sum(c, {0, 2}, evaluation_strategy::accurate()));
+        lz = sum(c, {1});
+        EXPECT_EQ(lz, sum(c, {1}, evaluation_strategy::accurate()));
+    }
+
     TEST(xreducer, xfixed_reduction)
     {
         xtensor_fixed<double, xshape<3, 3, 3>> a;
@@ -456,6 +642,52 @@ namespace xt
         EXPECT_EQ(vx0, vx1);
     }
 
+    TEST(xreducer, view_region)
+    {
+        xt::xarray<double> a = xt::random::randn<double>({6, 7, 8});
+        xt::xarray<double> s = xt::sum(a, {2});
+
+        // element-wise evaluation through the reducer steppers
+        auto red = xt::sum(a, {2});
+        xt::xarray<double> row = xt::view(red, 5, xt::all());
+        xt::xarray<double> row_expected = xt::zeros<double>({7});
+        for (std::size_t j = 0; j < 7; ++j)
+        {
+            row_expected(j) = red(5, j);
+        }
+        EXPECT_EQ(row, row_expected);
+        EXPECT_EQ(row, xt::xarray<double>(xt::view(s, 5, xt::all())));
+
+        xt::xarray<double> kept = xt::view(xt::sum(a, {0, 2}), xt::keep(4, 1, 6));
+        xt::xarray<double> all_sums = xt::sum(a, {0, 2});
+        xt::xarray<double> kept_expected = {all_sums(4), all_sums(1), all_sums(6)};
+        EXPECT_EQ(kept, kept_expected);
+
+        xt::xtensor<double, 3> cube = xt::view(xt::amax(a, {1}), xt::range(1, 5, 2), xt::newaxis(), xt::range(2, 4));
+        xt::xarray<double> m = xt::amax(a, {1});
+        ASSERT_EQ(cube.shape(), (std::array<std::size_t, 3>{2, 1, 2}));
+        EXPECT_EQ(cube(1, 0, 1), m(3, 3));
+        EXPECT_EQ(cube(0, 0, 0), m(1, 2));
+
+        // the same sequence of reduce and merge calls as the lazy reducer
+        auto f = xt::make_xreducer_functor([](double x, double y) { return 0.5 * x + y; },
+                                           [](double x) { return x + 1.; },
+                                           [](double x, double y) { return x - 2. * y; });
+        auto lazy = xt::reduce(f, a, {0, 2});
+        xt::xarray<double> sub = xt::view(lazy, xt::range(2, 6));
+        for (std::size_t j = 0; j < 4; ++j)
+        {
+            EXPECT_EQ(sub(j), lazy(j + 2));
+        }
+
+        // assignment to a view and broadcast to a larger shape
+        xt::xarray<double> dst = xt::zeros<double>({3, 7});
+        xt::view(dst, 1, xt::all()) = xt::view(red, 0, xt::all());
+        EXPECT_EQ(xt::xarray<double>(xt::view(dst, 1, xt::all())), xt::xarray<double>(xt::view(s, 0, xt::all())));
+        xt::view(dst, xt::range(0, 2), xt::all()) = xt::view(red, 2, xt::all());
+        EXPECT_EQ(xt::xarray<double>(xt::view(dst, 1, xt::all())), xt::xarray<double>(xt::view(s, 2, xt::all())));
+    }
+
     TEST(xreducer, wrong_number_of_indices)
     {
         xt::xtensor<double, 4> a = xt::random::rand<double>({5, 5, 5, 5});
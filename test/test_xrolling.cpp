@@ -0,0 +1,57 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xrolling.hpp"
+#include "xtensor/xtensor.hpp"
+
+namespace xt
+{
+    TEST(xrolling, sum_mean)
+    {
+        xarray<int> a = {{1, 3, 2, 5, 4}, {0, 6, 1, 7, 2}};
+
+        xarray<long long> expected_sum = {{6, 10, 11}, {7, 14, 10}};
+        EXPECT_EQ(rolling_sum(a, 3, 1), expected_sum);
+
+        xarray<double> expected_mean = {{2., 10. / 3., 11. / 3.}, {7. / 3., 14. / 3., 10. / 3.}};
+        EXPECT_TRUE(allclose(rolling_mean(a, 3, 1), expected_mean));
+
+        xarray<long long> expected_col = {{1, 9, 3, 12, 6}};
+        EXPECT_EQ(rolling_sum(a, 2, 0), expected_col);
+
+        EXPECT_THROW(rolling_sum(a, 6, 1), std::runtime_error);
+        EXPECT_THROW(rolling_sum(a, 0, 1), std::runtime_error);
+        EXPECT_THROW(rolling_sum(a, 2, 2), std::runtime_error);
+    }
+
+    TEST(xrolling, min_max)
+    {
+        xarray<double> a = {{1, 3, 2, 5, 4}, {0, 6, 1, 7, 2}};
+
+        xarray<double> expected_min = {{1, 2, 2}, {0, 1, 1}};
+        xarray<double> expected_max = {{3, 5, 5}, {6, 7, 7}};
+        EXPECT_EQ(rolling_min(a, 3, 1), expected_min);
+        EXPECT_EQ(rolling_max(a, 3, 1), expected_max);
+    }
+
+    TEST(xrolling, window_view)
+    {
+        xtensor<double, 3, layout_type::column_major> a = reshape_view(arange<double>(60.), {3, 4, 5});
+        auto windows = sliding_window_view(a, 3, 1);
+
+        xarray<double> expected_sum = sum(windows, {3});
+        EXPECT_TRUE(allclose(rolling_sum(a, 3, 1), expected_sum));
+        xarray<double> expected_max = amax(windows, {3});
+        EXPECT_EQ(rolling_max(a + 1., 3, 1), expected_max + 1.);
+    }
+}
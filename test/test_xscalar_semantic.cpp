@@ -8,6 +8,8 @@
 
 #include "gtest/gtest.h"
 #include "xtensor/xnoalias.hpp"
+#include "xtensor/xstrided_view.hpp"
+#include "xtensor/xview.hpp"
 #include "test_xsemantic.hpp"
 
 namespace xt
@@ -293,4 +295,37 @@ namespace xt
             EXPECT_TRUE(full_equal(tester.res_u, a));
         }
     }
+
+    TEST(scalar_semantic, inplace_views)
+    {
+        xarray<double> a = {{1., 2., 3., 4.}, {5., 6., 7., 8.}, {9., 10., 11., 12.}};
+        xarray<double> expected = a;
+
+        auto col = view(a, all(), 1);
+        col *= 2;
+        auto st = strided_view(a, {range(0, 3, 2), range(0, 4, 3)});
+        st += 0.5;
+        a *= 3.;
+
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            expected(i, 1) *= 2;
+        }
+        expected(0, 0) += 0.5;
+        expected(0, 3) += 0.5;
+        expected(2, 0) += 0.5;
+        expected(2, 3) += 0.5;
+        for (auto& v : expected)
+        {
+            v *= 3.;
+        }
+        EXPECT_EQ(expected, a);
+
+        xarray<int> ia = {1, 2, 3, 4, 5};
+        ia *= 2.5;
+        EXPECT_EQ(xarray<int>({2, 5, 7, 10, 12}), ia);
+        auto iv = view(ia, range(1, 4));
+        iv -= 1.5;
+        EXPECT_EQ(xarray<int>({2, 3, 5, 8, 12}), ia);
+    }
 }
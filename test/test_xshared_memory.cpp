@@ -0,0 +1,74 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xshared_memory.hpp"
+#include "xtensor/xstrided_view.hpp"
+#include "xtensor/xtensor.hpp"
+
+#ifndef _WIN32
+#include <unistd.h>
+
+namespace xt
+{
+    // the objects are shared by the whole system, the names must not collide
+    // with other test runs
+    inline std::string shared_test_name(const std::string& name)
+    {
+        return "xtensor_test_"s + std::to_string(::getpid()) + "_" + name;
+    }
+
+    TEST(xshared_memory, publish_open)
+    {
+        std::string name = shared_test_name("publish_open");
+        xarray<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        auto producer = publish_shared(name, a + 1.);
+        EXPECT_EQ(producer, a + 1.);
+
+        auto consumer = open_shared<double>(name);
+        EXPECT_EQ(consumer, a + 1.);
+        EXPECT_EQ(consumer.shape(), producer.shape());
+
+        // the elements are shared, not copied
+        producer(1, 2) = -1.;
+        EXPECT_EQ(consumer(1, 2), -1.);
+
+        EXPECT_THROW(publish_shared(name, a), std::runtime_error);
+        EXPECT_THROW(open_shared<float>(name), std::runtime_error);
+
+        // the mappings outlive the name
+        remove_shared(name);
+        EXPECT_THROW(open_shared<double>(name), std::runtime_error);
+        EXPECT_EQ(consumer(0, 0), 2.);
+        EXPECT_THROW(remove_shared(name), std::runtime_error);
+    }
+
+    TEST(xshared_memory, layout)
+    {
+        std::string name = shared_test_name("layout");
+        xtensor<std::int32_t, 3> a = reshape_view(arange<std::int32_t>(24), {2, 3, 4});
+        auto producer = publish_shared(name, a, layout_type::column_major);
+        auto consumer = open_shared<std::int32_t>(name);
+        EXPECT_EQ(consumer.strides(), producer.strides());
+        EXPECT_EQ(consumer, a);
+        EXPECT_EQ(consumer.data()[1], a(1, 0, 0));
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(consumer.data()) % 64, std::uintptr_t(0));
+        remove_shared(name);
+
+        EXPECT_THROW(publish_shared(name, a, layout_type::dynamic), std::runtime_error);
+        EXPECT_THROW(open_shared<std::int32_t>(shared_test_name("missing")), std::runtime_error);
+    }
+}
+#endif
@@ -6,12 +6,23 @@
  * The full license is in the file LICENSE, distributed with this software. *
  ****************************************************************************/
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xstrided_view.hpp"
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xfixed.hpp"
 #include "xtensor/xio.hpp"
 #include "xtensor/xinfo.hpp"
+#include "xtensor/xmath.hpp"
 #include "xtensor/xview.hpp"
 #include "xtensor/xrandom.hpp"
 #include "xtensor/xslice.hpp"
@@ -145,6 +156,31 @@ namespace xt
         EXPECT_EQ(res(), 0);
     }
 
+    TEST(xsort, argminmax_large)
+    {
+        xtensor<double, 1> a = xt::fmod(arange<double>(100000.), 97.);
+        a(3) = std::numeric_limits<double>::quiet_NaN();
+        a(54321) = -1.;
+        a(60000) = -1.;
+        a(77777) = 500.;
+        EXPECT_EQ(argmin(a)(), std::size_t(54321));
+        EXPECT_EQ(argmax(a)(), std::size_t(77777));
+
+        // ties give the first position
+        xtensor<int, 1> b = xt::zeros<int>({5000});
+        b(4093) = 3;
+        b(4999) = 3;
+        EXPECT_EQ(argmax(b)(), std::size_t(4093));
+        EXPECT_EQ(argmin(b)(), std::size_t(0));
+
+        xtensor<float, 2> c = xt::ones<float>({3, 1500});
+        c(1, 1499) = 0.f;
+        c(2, 700) = 0.f;
+        c(2, 1000) = 0.f;
+        xtensor<std::size_t, 1> expected = {0, 1499, 700};
+        EXPECT_EQ(argmin(c, 1), expected);
+    }
+
     TEST(xsort, sort_large_prob)
     {
         for (std::size_t i = 0; i < 20; ++i)
@@ -169,6 +205,403 @@ namespace xt
         }
     }
 
+    TEST(xsort, parallel)
+    {
+        parallel::scoped_settings guard(0, 0);
+
+        xtensor<double, 1> a = xt::random::rand<double>({5000});
+        xtensor<double, 1> sa = sort(a);
+        EXPECT_TRUE(std::is_sorted(sa.begin(), sa.end()));
+        xtensor<std::size_t, 1> ia = argsort(a);
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            EXPECT_EQ(a(ia(i)), sa(i));
+        }
+
+        xtensor<double, 2> b = xt::random::rand<double>({100, 200});
+        xtensor<double, 2> sb0 = sort(b, 0);
+        xtensor<double, 2> sb1 = sort(b, 1);
+        xtensor<std::size_t, 2> ib1 = argsort(b, 1);
+        for (std::size_t i = 0; i < 100; ++i)
+        {
+            auto row = view(sb1, i, xt::all());
+            EXPECT_TRUE(std::is_sorted(row.begin(), row.end()));
+            for (std::size_t j = 0; j < 200; ++j)
+            {
+                EXPECT_EQ(b(i, ib1(i, j)), sb1(i, j));
+            }
+        }
+        for (std::size_t j = 0; j < 200; ++j)
+        {
+            auto col = view(sb0, xt::all(), j);
+            EXPECT_TRUE(std::is_sorted(col.begin(), col.end()));
+        }
+
+        xtensor<double, 2> c = xt::random::rand<double>({2, 3000});
+        xtensor<double, 2> sc = sort(c, 1);
+        for (std::size_t i = 0; i < 2; ++i)
+        {
+            auto row = view(sc, i, xt::all());
+            EXPECT_TRUE(std::is_sorted(row.begin(), row.end()));
+        }
+    }
+
+    TEST(xsort, sort_inplace)
+    {
+        xtensor<double, 3> a = xt::random::rand<double>({20, 30, 40});
+        for (std::ptrdiff_t axis : {0, 1, 2, -1})
+        {
+            xtensor<double, 3> b = a;
+            sort_inplace(b, axis);
+            EXPECT_EQ(b, sort(a, axis));
+
+            xtensor<double, 3, layout_type::column_major> c = a;
+            sort_inplace(c, axis, sorting_method::stable());
+            EXPECT_EQ(c, sort(a, axis));
+        }
+
+        xarray<int> d = {{3, 1, 2}, {0, 5, 4}};
+        sort_inplace(d, 0);
+        EXPECT_EQ(d, xarray<int>({{0, 1, 2}, {3, 5, 4}}));
+        sort_inplace(d);
+        EXPECT_EQ(d, xarray<int>({{0, 1, 2}, {3, 4, 5}}));
+
+        // the lanes of the views which are not contiguous are assigned
+        xtensor<int, 2> e = {{5, 1, 4, 2}, {3, 8, 0, 7}};
+        auto v = view(e, xt::all(), xt::range(0, 4, 2));
+        sort_inplace(v, 0);
+        EXPECT_EQ(e, xtensor<int, 2>({{3, 1, 0, 2}, {5, 8, 4, 7}}));
+
+        xtensor<int, 2> r = xt::random::randint<int>({500, 300}, -1000, 1000);
+        xtensor<int, 2> sr = sort(r, 0);
+        {
+            parallel::scoped_settings guard(0, 0);
+            sort_inplace(r, 0);
+        }
+        EXPECT_EQ(r, sr);
+        EXPECT_THROW(sort_inplace(r, 2), std::runtime_error);
+    }
+
+    TEST(xsort, radix)
+    {
+        xtensor<int, 1> a = xt::random::randint<int>({3000}, -1000, 1000);
+        xtensor<int, 1> sa = sort(a, -1, sorting_method::radix());
+        std::vector<int> ref(a.begin(), a.end());
+        std::sort(ref.begin(), ref.end());
+        EXPECT_TRUE(std::equal(ref.begin(), ref.end(), sa.begin()));
+        EXPECT_EQ(sa, sort(a, -1, sorting_method::comparison()));
+        EXPECT_EQ(sa, sort(a));
+
+        // the radix argsort is stable
+        xtensor<std::size_t, 1> ia = argsort(a, -1, sorting_method::radix());
+        std::vector<std::size_t> iref(a.size());
+        std::iota(iref.begin(), iref.end(), std::size_t(0));
+        std::stable_sort(iref.begin(), iref.end(), [&a](std::size_t x, std::size_t y) { return a(x) < a(y); });
+        EXPECT_TRUE(std::equal(iref.begin(), iref.end(), ia.begin()));
+
+        xarray<unsigned int> u = {7u, 4294967295u, 0u, 3u, 2147483648u};
+        xarray<unsigned int> su = {0u, 3u, 7u, 2147483648u, 4294967295u};
+        EXPECT_EQ(sort(u, -1, sorting_method::radix()), su);
+
+        xarray<float> f = {{3.5f, -1.f, 0.f, -2.5f}, {-0.5f, 2.f, -7.f, 1e10f}};
+        xarray<float> sf = {{-2.5f, -1.f, 0.f, 3.5f}, {-7.f, -0.5f, 2.f, 1e10f}};
+        xarray<std::size_t> iff = {{3, 1, 2, 0}, {2, 0, 1, 3}};
+        EXPECT_EQ(sort(f, 1, sorting_method::radix()), sf);
+        EXPECT_EQ(argsort(f, 1, sorting_method::radix()), iff);
+
+        xtensor<double, 2> d = xt::random::randn<double>({3000, 3});
+        xtensor<double, 2> sd = sort(d, 0, sorting_method::radix());
+        EXPECT_EQ(sd, sort(d, 0, sorting_method::comparison()));
+        xtensor<double, 1> fd = sort(d, placeholders::xtuph(), sorting_method::radix());
+        std::vector<double> dref(d.begin(), d.end());
+        std::sort(dref.begin(), dref.end());
+        EXPECT_TRUE(std::equal(dref.begin(), dref.end(), fd.begin()));
+        EXPECT_EQ(argsort(a, placeholders::xtuph(), sorting_method::radix()), ia);
+    }
+
+    TEST(xsort, radix_signed_zeros_and_nans)
+    {
+        // -0 and +0 compare equal and keep their order, the NaNs go last in
+        // their order; only the lanes longer than the radix threshold hold
+        // NaNs, which the comparison sort cannot order
+        auto nan_last = [](double x, double y) { return std::isnan(y) ? !std::isnan(x) : x < y; };
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        const double values[] = {0., -0., 1., -1., nan, -nan};
+        for (std::size_t n : {std::size_t(40), std::size_t(XTENSOR_RADIX_SORT_THRESHOLD) + 1000})
+        {
+            std::size_t n_values = n > 40 ? 6 : 4;
+            xtensor<double, 1> a = xtensor<double, 1>::from_shape({n});
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                a(i) = values[(i * 7) % n_values];
+            }
+            std::vector<std::size_t> iref(n);
+            std::iota(iref.begin(), iref.end(), std::size_t(0));
+            std::stable_sort(iref.begin(), iref.end(), [&](std::size_t x, std::size_t y) { return nan_last(a(x), a(y)); });
+
+            xtensor<std::size_t, 1> ia = argsort(a, -1, sorting_method::stable());
+            EXPECT_TRUE(std::equal(iref.begin(), iref.end(), ia.begin()));
+
+            xtensor<double, 1> payload = a;
+            auto res = sort_by_key(a, payload);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                double v = a(iref[i]);
+                EXPECT_EQ(std::isnan(res.first(i)), std::isnan(v));
+                EXPECT_EQ(std::signbit(res.first(i)), std::signbit(v));
+                EXPECT_EQ(std::signbit(res.second(i)), std::signbit(v));
+            }
+        }
+
+        // the values sorted with the radix sort keep their sign bits
+        xtensor<double, 1> a = xtensor<double, 1>::from_shape({3000});
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            a(i) = values[(i * 7) % 6];
+        }
+        xtensor<double, 1> sa = sort(a, -1, sorting_method::radix());
+        auto negative_zeros = [](const xtensor<double, 1>& v)
+        {
+            return std::count_if(v.cbegin(), v.cend(), [](double x) { return x == 0. && std::signbit(x); });
+        };
+        EXPECT_EQ(negative_zeros(sa), negative_zeros(a));
+        EXPECT_FALSE(std::isnan(sa(1999)));
+        EXPECT_TRUE(std::isnan(sa(2000)));
+    }
+
+    TEST(xsort, sorting_network)
+    {
+        // the lanes of at most XTENSOR_SORTING_NETWORK_SIZE elements, contiguous
+        // or strided, are sorted by a network
+        for (std::size_t n : {1u, 2u, 3u, 7u, 16u, 25u, 32u})
+        {
+            xtensor<int, 2> a = xt::random::randint<int>(std::vector<std::size_t>{n, 70}, -5, 5);
+            xtensor<int, 2> at = transpose(a);
+            xtensor<int, 2> sa = sort(a, 0);
+            xtensor<int, 2> sat = sort(at, 1);
+            EXPECT_EQ(sat, transpose(sa));
+            xtensor<int, 2, layout_type::column_major> c = a;
+            sort_inplace(c, 0);
+            EXPECT_EQ(c, sa);
+            for (std::size_t j = 0; j < 70; ++j)
+            {
+                std::vector<int> ref(n);
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    ref[i] = a(i, j);
+                }
+                std::sort(ref.begin(), ref.end());
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    EXPECT_EQ(sa(i, j), ref[i]);
+                }
+            }
+
+            // the argsort of the network keeps the ties in order
+            xtensor<std::size_t, 2> ia = argsort(at, 1);
+            for (std::size_t j = 0; j < 70; ++j)
+            {
+                std::vector<std::size_t> iref(n);
+                std::iota(iref.begin(), iref.end(), std::size_t(0));
+                std::stable_sort(iref.begin(), iref.end(), [&at, j](std::size_t x, std::size_t y) { return at(j, x) < at(j, y); });
+                EXPECT_TRUE(std::equal(iref.begin(), iref.end(), view(ia, j).begin()));
+            }
+
+            xtensor<double, 1> m = median(at, 1);
+            xtensor<double, 1> q = quantile(at, 0.5, 1);
+            for (std::size_t j = 0; j < 70; ++j)
+            {
+                EXPECT_DOUBLE_EQ(m(j), q(j));
+                EXPECT_DOUBLE_EQ(m(j), n % 2 ? double(sat(j, n / 2)) : (sat(j, n / 2 - 1) + sat(j, n / 2)) / 2.);
+            }
+        }
+
+        xtensor<float, 1> f = {2.5f, -0.f, 1e10f, -7.f, 0.5f};
+        EXPECT_EQ(sort(f), (xtensor<float, 1>{-7.f, -0.f, 0.5f, 2.5f, 1e10f}));
+        {
+            parallel::scoped_settings settings(0, 0);
+            xtensor<short, 2> s = xt::random::randint<short>({9, 500}, short(-100), short(100));
+            xtensor<short, 2> ss = s;
+            sort_inplace(ss, 0);
+            EXPECT_EQ(ss, sort(s, 0, sorting_method::stable()));
+        }
+    }
+
+    TEST(xsort, stable)
+    {
+        xarray<int> a = {{3, 1, 3, 0, 1}, {2, 2, 2, 1, 2}};
+        xarray<std::size_t> ia = {{3, 1, 4, 0, 2}, {3, 0, 1, 2, 4}};
+        EXPECT_EQ(argsort(a, 1, sorting_method::stable()), ia);
+        EXPECT_EQ(sort(a, 1, sorting_method::stable()), sort(a, 1));
+
+        xtensor<double, 1> d = {2.5, -1., 2.5, -1., 0.};
+        xtensor<std::size_t, 1> id = {1, 3, 4, 0, 2};
+        EXPECT_EQ(argsort(d, placeholders::xtuph(), sorting_method::stable()), id);
+
+        // the large lanes are sorted with the radix sort
+        xtensor<int, 1> r = xt::random::randint<int>({3000}, 0, 10);
+        EXPECT_EQ(argsort(r, -1, sorting_method::stable()), argsort(r, -1, sorting_method::radix()));
+    }
+
+    TEST(xsort, lexsort)
+    {
+        xarray<int> first = {1, 5, 1, 4, 3, 4, 4};
+        xarray<int> last = {9, 4, 0, 4, 0, 2, 1};
+        // sorts by last, then by first
+        xtensor<std::size_t, 1> expected = {2, 4, 6, 5, 3, 1, 0};
+        EXPECT_EQ(lexsort(first, last), expected);
+        EXPECT_EQ(lexsort(first), argsort(first, -1, sorting_method::stable()));
+
+        xarray<double> d = {0.5, 0.5, -1., 0.5};
+        xarray<int> k = {1, 0, 1, 0};
+        xtensor<std::size_t, 1> dk = {1, 3, 2, 0};
+        EXPECT_EQ(lexsort(d, k), dk);
+        EXPECT_EQ(lexsort(d * 2., k), dk);
+
+        xtensor<int, 1> r1 = xt::random::randint<int>({3000}, 0, 10);
+        xtensor<int, 1> r2 = xt::random::randint<int>({3000}, 0, 10);
+        auto ir = lexsort(r1, r2);
+        bool sorted = true;
+        for (std::size_t i = 1; i < ir.size(); ++i)
+        {
+            std::size_t x = ir(i - 1), y = ir(i);
+            sorted = sorted && (r2(x) < r2(y) || (r2(x) == r2(y) && (r1(x) < r1(y) || (r1(x) == r1(y) && x < y))));
+        }
+        EXPECT_TRUE(sorted);
+
+        xarray<int> bad = {1, 2};
+        EXPECT_THROW(lexsort(first, bad), std::runtime_error);
+    }
+
+    TEST(xsort, sort_by_key)
+    {
+        xarray<int> keys = {3, 1, 2, 1};
+        xarray<double> values = {30., 10., 20., 11.};
+        auto res = sort_by_key(keys, values);
+        EXPECT_EQ(res.first, xtensor<int, 1>({1, 1, 2, 3}));
+        EXPECT_EQ(res.second, xtensor<double, 1>({10., 11., 20., 30.}));
+
+        // the rows of the values are sorted
+        xtensor<int, 2> rows = {{3, 3}, {1, 1}, {2, 2}, {0, 0}};
+        auto rres = sort_by_key(keys, rows);
+        EXPECT_EQ(rres.second, xtensor<int, 2>({{1, 1}, {0, 0}, {2, 2}, {3, 3}}));
+
+        xarray<std::string> names = {"c", "a", "b", "d"};
+        auto sres = sort_by_key(keys, names);
+        EXPECT_EQ(sres.second, xarray<std::string>({"a", "d", "b", "c"}));
+
+        xtensor<int, 1> r = xt::random::randint<int>({3000}, 0, 100);
+        xtensor<std::size_t, 1> payload = arange<std::size_t>(3000);
+        auto lres = sort_by_key(r, payload);
+        EXPECT_EQ(lres.first, sort(r));
+        EXPECT_EQ(lres.second, argsort(r, -1, sorting_method::stable()));
+        xtensor<std::size_t, 2> wide = reshape_view(arange<std::size_t>(6000), {3000, 2});
+        auto wres = sort_by_key(r, wide);
+        EXPECT_EQ(xtensor<std::size_t, 1>(view(wres.second, all(), 0)), lres.second * std::size_t(2));
+
+        EXPECT_THROW(sort_by_key(keys, xarray<int>({1, 2})), std::runtime_error);
+    }
+
+    TEST(xsort, partition)
+    {
+        xarray<double> a = {{5, 3, 8, 1, 9, 2}, {4, 7, 0, 6, 2, 5}};
+        xarray<double> sa = sort(a, 1);
+        xarray<double> pa = partition(a, 2, 1);
+        xarray<std::size_t> ipa = argpartition(a, 2, 1);
+        for (std::size_t i = 0; i < 2; ++i)
+        {
+            EXPECT_EQ(pa(i, 2), sa(i, 2));
+            EXPECT_EQ(a(i, ipa(i, 2)), sa(i, 2));
+            for (std::size_t j = 0; j < 6; ++j)
+            {
+                EXPECT_EQ(pa(i, j) <= pa(i, 2), j <= 2);
+                EXPECT_EQ(a(i, ipa(i, j)) <= sa(i, 2), j <= 2);
+            }
+        }
+
+        xarray<double> pa0 = partition(a, 0, 0);
+        EXPECT_EQ(pa0, sort(a, 0));
+        EXPECT_THROW(partition(a, 6, 1), std::runtime_error);
+
+        xtensor<int, 1> b = {3, 1, 4, 1, 5, 9, 2, 6};
+        EXPECT_EQ(partition(b, 7)(7), 9);
+        EXPECT_EQ(b(argpartition(b, 0)(0)), 1);
+    }
+
+    TEST(xsort, topk)
+    {
+        xtensor<double, 2> a = {{5, 3, 8, 1, 9, 3}, {4, 7, 0, 6, 2, 5}};
+        auto r = topk(a, 3);
+        xtensor<double, 2> ev = {{9, 8, 5}, {7, 6, 5}};
+        xtensor<std::size_t, 2> ei = {{4, 2, 0}, {1, 3, 5}};
+        EXPECT_EQ(r.first, ev);
+        EXPECT_EQ(r.second, ei);
+
+        xarray<double> b = {{5, 3, 8, 1, 9, 3}, {4, 7, 0, 6, 2, 5}};
+        auto r0 = topk(b, 1, 0);
+        xarray<double> ev0 = {{5, 7, 8, 6, 9, 5}};
+        xarray<std::size_t> ei0 = {{0, 1, 0, 1, 0, 1}};
+        EXPECT_EQ(r0.first, ev0);
+        EXPECT_EQ(r0.second, ei0);
+
+        // ties are ordered by index
+        auto r1 = topk(a, 6);
+        EXPECT_EQ(r1.second(0, 3), std::size_t(1));
+        EXPECT_EQ(r1.second(0, 4), std::size_t(5));
+        EXPECT_EQ(topk(a, 0).first.shape()[1], std::size_t(0));
+        EXPECT_THROW(topk(a, 7), std::runtime_error);
+    }
+
+    TEST(xsort, quantile)
+    {
+        xarray<int> a = {{3, 1, 4, 1}, {5, 9, 2, 6}, {5, 3, 5, 8}};
+        EXPECT_EQ(median(a), 4.5);
+        EXPECT_EQ(quantile(a, 0.), 1.);
+        EXPECT_EQ(quantile(a, 1.), 9.);
+        EXPECT_DOUBLE_EQ(percentile(a, 25.), 2.75);
+
+        xarray<double> m0 = {5., 3., 4., 6.};
+        xarray<double> m1 = {2., 5.5, 5.};
+        EXPECT_EQ(median(a, 0), m0);
+        EXPECT_EQ(median(a, 1), m1);
+
+        xtensor<double, 2> b = {{3, 1, 4, 1}, {5, 9, 2, 6}, {5, 3, 5, 8}};
+        xtensor<double, 1> q1 = quantile(b, 0.75, 1);
+        xtensor<double, 1> eq1 = {3.25, 6.75, 5.75};
+        EXPECT_TRUE(allclose(q1, eq1));
+
+        xtensor<double, 2> qs = quantile(b, {0.75, 0., 0.5}, 1);
+        xtensor<double, 2> eqs = {{3.25, 1., 2.}, {6.75, 2., 5.5}, {5.75, 3., 5.}};
+        EXPECT_TRUE(allclose(qs, eqs));
+
+        xtensor<double, 2> ps = percentile(b, std::vector<double>({50., 100.}), 0);
+        xtensor<double, 2> eps = {{5., 3., 4., 6.}, {5., 9., 5., 8.}};
+        EXPECT_EQ(ps, eps);
+
+        EXPECT_THROW(quantile(b, 1.5, 0), std::runtime_error);
+    }
+
+    TEST(xsort, searchsorted)
+    {
+        xtensor<double, 1> a = {1., 2., 2., 3., 5.};
+        xarray<double> v = {{0., 2., 4.}, {5., 6., 3.}};
+        xarray<std::size_t> el = {{0, 1, 4}, {4, 5, 3}};
+        xarray<std::size_t> er = {{0, 3, 4}, {5, 5, 4}};
+        EXPECT_EQ(searchsorted(a, v), el);
+        EXPECT_EQ(searchsorted(a, v, search_side::right), er);
+
+        // large enough to be searched in Eytzinger order
+        xtensor<int, 1> b = arange<int>(0, 40000, 2);
+        xtensor<int, 1> w = xt::random::randint<int>({50000}, -10, 40010);
+        xtensor<std::size_t, 1> ib = searchsorted(b, w);
+        xtensor<std::size_t, 1> ibr = searchsorted(b, w, search_side::right);
+        for (std::size_t i = 0; i < w.size(); ++i)
+        {
+            EXPECT_EQ(ib(i), std::size_t(std::lower_bound(b.cbegin(), b.cend(), w(i)) - b.cbegin()));
+            EXPECT_EQ(ibr(i), std::size_t(std::upper_bound(b.cbegin(), b.cend(), w(i)) - b.cbegin()));
+        }
+    }
+
     TEST(xsort, argmax_prob)
     {
         for (std::size_t i = 0; i < 20; ++i)
@@ -220,6 +653,37 @@ namespace xt
         EXPECT_EQ(unique(bb), bbx);
     }
 
+    TEST(xsort, unique_methods)
+    {
+        xarray<int> a = {{7, 2, 7}, {3, 2, 9}};
+        xarray<int> ah = {7, 2, 3, 9};
+        xarray<int> as = {2, 3, 7, 9};
+        EXPECT_EQ(unique(a, unique_method::hash()), ah);
+
+        xarray<std::size_t> counts = {2, 1, 2, 1};
+        auto rc = unique_counts(a);
+        EXPECT_EQ(rc.first, as);
+        EXPECT_EQ(rc.second, counts);
+        xarray<std::size_t> hcounts = {2, 2, 1, 1};
+        EXPECT_EQ(unique_counts(a, unique_method::hash()).second, hcounts);
+
+        xarray<std::size_t> inverse = {2, 0, 2, 1, 0, 3};
+        auto ri = unique_inverse(a);
+        EXPECT_EQ(ri.first, as);
+        EXPECT_EQ(ri.second, inverse);
+        auto rh = unique_inverse(a, unique_method::hash());
+        xarray<std::size_t> hinverse = {0, 1, 0, 2, 1, 3};
+        EXPECT_EQ(rh.second, hinverse);
+
+        xarray<int> b = {1, 1, 2, 4, 4, 4, 8};
+        xarray<int> bx = {1, 2, 4, 8};
+        xarray<std::size_t> bcounts = {2, 1, 3, 1};
+        xarray<std::size_t> binverse = {0, 0, 1, 2, 2, 2, 3};
+        EXPECT_EQ(unique(b, unique_method::assume_sorted()), bx);
+        EXPECT_EQ(unique_counts(b, unique_method::assume_sorted()).second, bcounts);
+        EXPECT_EQ(unique_inverse(b, unique_method::assume_sorted()).second, binverse);
+    }
+
     TEST(xsort, setdiff1d)
     {
         {
@@ -235,5 +699,74 @@ namespace xt
             xarray<size_t> out = {2,3,5,6,7};
             EXPECT_EQ(setdiff1d(ar1, ar2), out);
         }
+
+        {
+            xarray<size_t> ar1 = {{5,6,7},{4,4,4},{1,2,3},{6,5,1}};
+            xarray<size_t> ar2 = {4,1};
+            xarray<size_t> out = {5,6,7,2,3};
+            EXPECT_EQ(setdiff1d(ar1, ar2, unique_method::hash()), out);
+        }
+
+        {
+            xarray<size_t> ar1 = {1,2,2,3,5,8};
+            xarray<size_t> ar2 = {2,5};
+            xarray<size_t> out = {1,3,8};
+            EXPECT_EQ(setdiff1d(ar1, ar2, unique_method::assume_sorted()), out);
+        }
+    }
+
+    TEST(xsort, set_operations)
+    {
+        xarray<int> ar1 = {{5, 1, 3}, {3, 9, 7}};
+        xarray<int> ar2 = {7, 2, 5, 5, 4};
+        EXPECT_EQ(intersect1d(ar1, ar2), xtensor<int, 1>({5, 7}));
+        EXPECT_EQ(union1d(ar1, ar2), xtensor<int, 1>({1, 2, 3, 4, 5, 7, 9}));
+        EXPECT_EQ(setxor1d(ar1, ar2), xtensor<int, 1>({1, 2, 3, 4, 9}));
+
+        EXPECT_EQ(intersect1d(ar1, ar2, unique_method::hash()), xtensor<int, 1>({5, 7}));
+        EXPECT_EQ(union1d(ar1, ar2, unique_method::hash()), xtensor<int, 1>({5, 1, 3, 9, 7, 2, 4}));
+        EXPECT_EQ(setxor1d(ar1, ar2, unique_method::hash()), xtensor<int, 1>({1, 3, 9, 2, 4}));
+
+        xarray<int> s1 = {1, 2, 2, 4, 6};
+        xarray<int> s2 = {2, 3, 4, 4};
+        EXPECT_EQ(intersect1d(s1, s2, unique_method::assume_sorted()), xtensor<int, 1>({2, 4}));
+        EXPECT_EQ(union1d(s1, s2, unique_method::assume_sorted()), xtensor<int, 1>({1, 2, 3, 4, 6}));
+        EXPECT_EQ(setxor1d(s1, s2, unique_method::assume_sorted()), xtensor<int, 1>({1, 3, 6}));
+
+        xarray<double> d = {0.5, 2., 4.};
+        EXPECT_EQ(intersect1d(s1, d), xtensor<double, 1>({2., 4.}));
+
+        // the intersection of long integer ranges goes through batches
+        xtensor<int, 1> evens = arange<int>(0, 3000, 2);
+        xtensor<int, 1> threes = arange<int>(0, 3000, 3);
+        EXPECT_EQ(intersect1d(evens, threes), xtensor<int, 1>(arange<int>(0, 3000, 6)));
+        EXPECT_EQ(intersect1d(threes, evens, unique_method::assume_sorted()), xtensor<int, 1>(arange<int>(0, 3000, 6)));
+        xtensor<int, 1> empty = xtensor<int, 1>::from_shape({0});
+        EXPECT_EQ(intersect1d(evens, empty).size(), std::size_t(0));
+        EXPECT_EQ(union1d(empty, s2), xtensor<int, 1>({2, 3, 4}));
+    }
+
+    TEST(xsort, in1d)
+    {
+        xarray<int> element = {{0, 1, 2}, {5, 0, 7}};
+        xarray<int> test = {0, 2, 7, 7};
+        xtensor<bool, 1> expected = {true, false, true, false, true, true};
+        EXPECT_EQ(in1d(element, test), expected);
+        EXPECT_EQ(in1d(element, test, unique_method::hash()), expected);
+
+        xarray<int> sorted_element = {0, 0, 1, 2, 5, 7};
+        xtensor<bool, 1> sorted_expected = {true, true, false, true, false, true};
+        EXPECT_EQ(in1d(sorted_element, test, unique_method::assume_sorted()), sorted_expected);
+        EXPECT_EQ(in1d(sorted_element, test), sorted_expected);
+    }
+
+    TEST(xsort, merge)
+    {
+        xarray<int> ar1 = {1, 3, 3, 8};
+        xarray<int> ar2 = {{2, 3}, {9, 10}};
+        EXPECT_EQ(merge(ar1, ar2), xtensor<int, 1>({1, 2, 3, 3, 3, 8, 9, 10}));
+        xarray<double> d = {0.5, 3.5};
+        EXPECT_EQ(merge(ar1, d), xtensor<double, 1>({0.5, 1., 3., 3., 3.5, 8.}));
+        EXPECT_EQ(merge(ar1, xtensor<int, 1>::from_shape({0})), xtensor<int, 1>(ar1));
     }
 }
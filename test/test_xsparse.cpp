@@ -0,0 +1,123 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xsparse.hpp"
+#include "xtensor/xtensor.hpp"
+
+namespace xt
+{
+    TEST(xsparse, csr_matrix)
+    {
+        xarray<double> d = {{1., 0., 0., 2.}, {0., 0., 0., 0.}, {0., 3., 0., 4.}};
+        xcsr_matrix<double> m(d);
+        EXPECT_EQ(m.nnz(), std::size_t(4));
+        EXPECT_EQ(m.shape()[0], std::size_t(3));
+        EXPECT_EQ(m.shape()[1], std::size_t(4));
+        EXPECT_EQ(m.indptr()(1), std::size_t(2));
+        EXPECT_EQ(m.indptr()(2), std::size_t(2));
+        EXPECT_EQ(m.indices()(2), std::size_t(1));
+        EXPECT_EQ(m(2, 3), 4.);
+        EXPECT_EQ(m(1, 3), 0.);
+        EXPECT_EQ(m(0, 2, 1), 3.);
+        EXPECT_THROW(m.at(3, 0), std::out_of_range);
+
+        xarray<double> copy = m;
+        EXPECT_EQ(copy, d);
+        xarray<double> shifted = m + xarray<double>{1., 2., 3., 4.};
+        EXPECT_EQ(shifted, d + xarray<double>{1., 2., 3., 4.});
+
+        xtensor<std::size_t, 1> indptr = {0, 1, 1};
+        xtensor<std::size_t, 1> indices = {2};
+        xtensor<double, 1> values = {5.};
+        xcsr_matrix<double> n(2, 3, indptr, indices, values);
+        EXPECT_EQ(n(0, 2), 5.);
+        xtensor<std::size_t, 1> bad_indices = {3};
+        EXPECT_THROW(xcsr_matrix<double>(2, 3, indptr, bad_indices, values), std::runtime_error);
+        EXPECT_THROW(xcsr_matrix<double>(xarray<double>::from_shape({2, 2, 2})), std::runtime_error);
+    }
+
+    TEST(xsparse, coo_tensor)
+    {
+        xarray<int> d = zeros<int>({2, 3, 4});
+        d(0, 1, 2) = 1;
+        d(1, 0, 3) = 2;
+        d(1, 2, 0) = 3;
+        xcoo_tensor<int> t(d);
+        EXPECT_EQ(t.nnz(), std::size_t(3));
+        EXPECT_EQ(t.coords()(1, 2), std::size_t(3));
+        EXPECT_EQ(t(1, 2, 0), 3);
+        EXPECT_EQ(t(1, 2, 1), 0);
+        xarray<int> copy = t;
+        EXPECT_EQ(copy, d);
+
+        xtensor<std::size_t, 2> coords = {{1, 1}, {0, 2}, {1, 1}};
+        xtensor<double, 1> values = {1., 2., 3.};
+        xcoo_tensor<double> u({2, 3}, coords, values);
+        EXPECT_EQ(u.nnz(), std::size_t(2));
+        EXPECT_EQ(u.coords()(0, 1), std::size_t(2));
+        EXPECT_EQ(u(1, 1), 4.);
+        EXPECT_EQ(u(0, 2), 2.);
+        xtensor<std::size_t, 2> bad_coords = {{2, 0}};
+        xtensor<double, 1> bad_values = {1.};
+        EXPECT_THROW(xcoo_tensor<double>({2, 3}, bad_coords, bad_values), std::runtime_error);
+    }
+
+    TEST(xsparse, multiply)
+    {
+        xarray<double> d = {{1., 0., 2.}, {0., 3., 0.}};
+        xarray<double> b = {10., 20., 30.};
+        xcsr_matrix<double> m(d);
+        auto p = sparse_multiply(m, b);
+        EXPECT_EQ(p.nnz(), m.nnz());
+        xarray<double> pd = p;
+        EXPECT_EQ(pd, d * b);
+
+        xcoo_tensor<double> t(d);
+        auto q = sparse_multiply(t, b);
+        xarray<double> qd = q;
+        EXPECT_EQ(qd, d * b);
+
+        EXPECT_THROW(sparse_multiply(m, xarray<double>{1., 2.}), std::runtime_error);
+    }
+
+    TEST(xsparse, sum)
+    {
+        xarray<int> d = {{1, 0, 2}, {0, 3, 0}};
+        xcsr_matrix<int> m(d);
+        EXPECT_EQ(sparse_sum(m), 6);
+        xtensor<long long, 1> columns = sparse_sum(m, 0);
+        EXPECT_EQ(columns, (xtensor<long long, 1>{1, 3, 2}));
+        xtensor<long long, 1> rows = sparse_sum(m, 1);
+        EXPECT_EQ(rows, (xtensor<long long, 1>{3, 3}));
+        EXPECT_THROW(sparse_sum(m, 2), std::runtime_error);
+
+        xarray<int> e = arange<int>(24);
+        e.reshape({2, 3, 4});
+        xcoo_tensor<int> t(e);
+        EXPECT_EQ(sparse_sum(t), 276);
+        xarray<long long> s1 = sparse_sum(t, 1);
+        xarray<long long> expected = sum(e, {1});
+        EXPECT_EQ(s1, expected);
+    }
+
+    TEST(xsparse, dot)
+    {
+        xarray<double> d = {{1., 0., 2.}, {0., 0., 0.}, {0., 3., 4.}};
+        xtensor<double, 1> x = {1., 2., 3.};
+        xcsr_matrix<double> m(d);
+        xtensor<double, 1> y = sparse_dot(m, x);
+        EXPECT_EQ(y, (xtensor<double, 1>{7., 0., 18.}));
+        xtensor<double, 1> z = sparse_dot(xcoo_tensor<double>(d), x + 0.);
+        EXPECT_EQ(z, y);
+        EXPECT_THROW(sparse_dot(m, xtensor<double, 1>{1., 2.}), std::runtime_error);
+    }
+}
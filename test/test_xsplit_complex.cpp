@@ -0,0 +1,80 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <complex>
+
+#include "gtest/gtest.h"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xcomplex.hpp"
+#include "xtensor/xsplit_complex.hpp"
+
+namespace xt
+{
+    using cplx = std::complex<double>;
+
+    TEST(xsplit_complex, construction)
+    {
+        xarray<cplx> c = {{cplx(1., 2.), cplx(3., -1.)}, {cplx(0., 1.), cplx(-2., 0.5)}};
+        xsplit_complex<double> s(c);
+        EXPECT_EQ(s.dimension(), std::size_t(2));
+        EXPECT_EQ(s.shape(), c.shape());
+        EXPECT_EQ(s.real(), xarray<double>({{1., 3.}, {0., -2.}}));
+        EXPECT_EQ(imag(s), xarray<double>({{2., -1.}, {1., 0.5}}));
+        EXPECT_EQ(s(1, 1), cplx(-2., 0.5));
+        EXPECT_EQ(s(0, 1, 0), cplx(0., 1.));
+
+        xarray<cplx> back = s;
+        EXPECT_EQ(back, c);
+        xarray<cplx> shifted = s + cplx(1., 1.);
+        EXPECT_EQ(shifted(0, 0), cplx(2., 3.));
+
+        xsplit_complex<double> r(xarray<double>({1., 2.}));
+        EXPECT_EQ(r(1), cplx(2., 0.));
+
+        real(s)(0, 0) = 5.;
+        EXPECT_EQ(s(0, 0), cplx(5., 2.));
+
+        dynamic_shape<std::size_t> shape = {2, 3};
+        xsplit_complex<double> z(shape);
+        EXPECT_EQ(z(1, 2), cplx(0., 0.));
+        EXPECT_THROW(xsplit_complex<double>(xarray<double>({1., 2.}), xarray<double>({1.})), std::runtime_error);
+    }
+
+    TEST(xsplit_complex, arithmetic)
+    {
+        xarray<cplx> ca = {{cplx(1., 2.), cplx(3., -1.)}, {cplx(0., 1.), cplx(-2., 0.5)}};
+        xarray<cplx> cb = {cplx(2., -3.), cplx(0.5, 4.)};
+        xsplit_complex<double> a(ca);
+        xsplit_complex<double> b(cb);
+
+        xarray<cplx> sum = split_add(a, b);
+        xarray<cplx> difference = split_subtract(a, b);
+        xarray<cplx> product = split_multiply(a, b);
+        xarray<cplx> quotient = split_divide(a, b);
+        xarray<cplx> conjugate = split_conj(a);
+        xarray<cplx> scaled = split_multiply(a, xarray<double>({2., -1.}));
+        xarray<double> norm = split_norm(a);
+        xarray<double> magnitude = split_abs(a);
+
+        for (std::size_t i = 0; i < 2; ++i)
+        {
+            for (std::size_t j = 0; j < 2; ++j)
+            {
+                EXPECT_EQ(sum(i, j), ca(i, j) + cb(j));
+                EXPECT_EQ(difference(i, j), ca(i, j) - cb(j));
+                EXPECT_EQ(product(i, j), ca(i, j) * cb(j));
+                EXPECT_NEAR(quotient(i, j).real(), (ca(i, j) / cb(j)).real(), 1e-12);
+                EXPECT_NEAR(quotient(i, j).imag(), (ca(i, j) / cb(j)).imag(), 1e-12);
+                EXPECT_EQ(conjugate(i, j), std::conj(ca(i, j)));
+                EXPECT_EQ(scaled(i, j), ca(i, j) * (j == 0 ? 2. : -1.));
+                EXPECT_DOUBLE_EQ(norm(i, j), std::norm(ca(i, j)));
+                EXPECT_DOUBLE_EQ(magnitude(i, j), std::abs(ca(i, j)));
+            }
+        }
+    }
+}
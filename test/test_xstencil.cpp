@@ -0,0 +1,186 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmanipulation.hpp"
+#include "xtensor/xparallel.hpp"
+#include "xtensor/xstencil.hpp"
+#include "xtensor/xstrided_view.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    TEST(xstencil, valid)
+    {
+        xarray<double> a = {1., 4., 9., 16., 25., 36.};
+        xarray<double> expected = {2., 2., 2., 2.};
+        EXPECT_EQ(stencil(a, {{-1}, {0}, {1}}, {1., -2., 1.}), expected);
+
+        // same result as the sum of shifted views
+        xarray<double> u = arange<double>(60.);
+        u.reshape({6, 10});
+        u = u * u;
+        xarray<double> lap = view(u, range(0, -2), range(1, -1)) + view(u, range(2, _), range(1, -1)) +
+                             view(u, range(1, -1), range(0, -2)) + view(u, range(1, -1), range(2, _)) -
+                             4. * view(u, range(1, -1), range(1, -1));
+        auto res = stencil(u, {{-1, 0}, {1, 0}, {0, -1}, {0, 1}, {0, 0}}, {1., 1., 1., 1., -4.});
+        EXPECT_EQ(res, lap);
+
+        // one sided stencils only remove their halo
+        xarray<double> forward = stencil(a, {{0}, {2}}, {-1., 1.});
+        xarray<double> forward_expected = {8., 12., 16., 20.};
+        EXPECT_EQ(forward, forward_expected);
+
+        xarray<int> ia = {1, 2, 3, 4};
+        xarray<int> isum = stencil(ia, {{0}, {1}}, {1, 1});
+        xarray<int> isum_expected = {3, 5, 7};
+        EXPECT_EQ(isum, isum_expected);
+    }
+
+    TEST(xstencil, boundaries)
+    {
+        xarray<double> a = {1., 2., 4., 8.};
+        std::vector<std::vector<std::ptrdiff_t>> offsets = {{-1}, {1}};
+        std::vector<double> weights = {1., 10.};
+
+        xarray<double> constant = {20., 41., 82., 4.};
+        EXPECT_EQ(stencil(a, offsets, weights, stencil_boundary::constant), constant);
+        xarray<double> filled = {25., 41., 82., 54.};
+        EXPECT_EQ(stencil(a, offsets, weights, stencil_boundary::constant, 5.), filled);
+        xarray<double> nearest = {21., 41., 82., 84.};
+        EXPECT_EQ(stencil(a, offsets, weights, stencil_boundary::nearest), nearest);
+        xarray<double> periodic = {28., 41., 82., 14.};
+        EXPECT_EQ(stencil(a, offsets, weights, stencil_boundary::periodic), periodic);
+
+        // the interior of a 2-D periodic stencil matches the valid one
+        xarray<double> u = arange<double>(35.);
+        u.reshape({5, 7});
+        std::vector<std::vector<std::ptrdiff_t>> cross = {{-1, 0}, {1, 0}, {0, -2}, {0, 1}};
+        std::vector<double> cross_weights = {1., 2., 3., 4.};
+        xarray<double> p = stencil(u, cross, cross_weights, stencil_boundary::periodic);
+        xarray<double> v = stencil(u, cross, cross_weights);
+        EXPECT_EQ(xarray<double>(view(p, range(1, 4), range(2, 6))), v);
+        EXPECT_EQ(p(0, 0), u(4, 0) + 2. * u(1, 0) + 3. * u(0, 5) + 4. * u(0, 1));
+    }
+
+    TEST(xstencil, large)
+    {
+        // several tiles per row and non contiguous operand
+        xarray<double> u = arange<double>(3. * 2500.);
+        u.reshape({3, 2500});
+        u = u * 0.5 - 7.;
+        std::vector<std::vector<std::ptrdiff_t>> offsets = {{0, -2}, {0, -1}, {0, 0}, {1, 1}, {-1, 3}};
+        std::vector<double> weights = {1., -1., 2., 0.5, 3.};
+        xarray<double> expected = stencil(u, offsets, weights, stencil_boundary::nearest);
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            for (std::size_t j = 0; j < 2500; ++j)
+            {
+                auto at = [&](std::ptrdiff_t di, std::ptrdiff_t dj) {
+                    std::ptrdiff_t ii = std::min(std::max(static_cast<std::ptrdiff_t>(i) + di, std::ptrdiff_t(0)), std::ptrdiff_t(2));
+                    std::ptrdiff_t jj = std::min(std::max(static_cast<std::ptrdiff_t>(j) + dj, std::ptrdiff_t(0)), std::ptrdiff_t(2499));
+                    return u(static_cast<std::size_t>(ii), static_cast<std::size_t>(jj));
+                };
+                double e = at(0, -2) - at(0, -1) + 2. * at(0, 0) + 0.5 * at(1, 1) + 3. * at(-1, 3);
+                EXPECT_EQ(expected(i, j), e);
+            }
+        }
+        {
+            parallel::scoped_settings settings(0, 0);
+            EXPECT_EQ(stencil(u, offsets, weights, stencil_boundary::nearest), expected);
+        }
+
+        xarray<double> ut = transpose(u);
+        std::vector<std::vector<std::ptrdiff_t>> toffsets = {{-2, 0}, {-1, 0}, {0, 0}, {1, 1}, {3, -1}};
+        EXPECT_EQ(stencil(transpose(ut), offsets, weights, stencil_boundary::nearest), expected);
+        EXPECT_EQ(stencil(ut, toffsets, weights, stencil_boundary::nearest), transpose(expected));
+    }
+
+    TEST(xstencil, neighborhood)
+    {
+        xarray<double> a = {3., 1., 4., 1., 5., 9., 2., 6.};
+        auto max3 = [](const double* v) { return std::max({v[0], v[1], v[2]}); };
+        xarray<double> valid = {4., 4., 5., 9., 9., 9.};
+        EXPECT_EQ(neighborhood(a, {{-1}, {0}, {1}}, max3), valid);
+        xarray<double> nearest = {3., 4., 4., 5., 9., 9., 9., 6.};
+        EXPECT_EQ(neighborhood(a, {{-1}, {0}, {1}}, max3, stencil_boundary::nearest), nearest);
+
+        xarray<int> m = {{1, 0, 1}, {1, 1, 1}, {0, 1, 1}};
+        auto inside = [](const int* v) { return v[0] && v[1] && v[2] && v[3] && v[4]; };
+        xarray<bool> eroded = neighborhood(m, {{0, 0}, {-1, 0}, {1, 0}, {0, -1}, {0, 1}}, inside, stencil_boundary::constant, 1);
+        xarray<bool> expected = {{false, false, false}, {false, false, true}, {false, false, true}};
+        EXPECT_EQ(eroded, expected);
+    }
+
+    TEST(xstencil, median_filter)
+    {
+        xarray<int> a = {3, 1, 4, 1, 5, 9, 2, 6};
+        xarray<double> valid = {3., 1., 4., 5., 5., 6.};
+        EXPECT_EQ(median_filter(a, {{-1}, {0}, {1}}), valid);
+        xarray<double> nearest = {3., 3., 1., 4., 5., 5., 6., 6.};
+        EXPECT_EQ(median_filter(a, {{-1}, {0}, {1}}, stencil_boundary::nearest), nearest);
+        xarray<double> even = {2., 2.5, 2.5, 3., 7., 5.5, 4.};
+        EXPECT_EQ(median_filter(a, {{0}, {1}}), even);
+
+        // the rows sorted by a network, the large neighborhoods by selection,
+        // and the halo agree with the median of the gathered values
+        xarray<float> u = reshape_view(arange<int>(120 * 90) * 37 % 101, {120, 90});
+        for (std::ptrdiff_t r : {1, 3})
+        {
+            std::vector<std::vector<std::ptrdiff_t>> box;
+            for (std::ptrdiff_t i = -r; i <= r; ++i)
+            {
+                for (std::ptrdiff_t j = -r; j <= r; ++j)
+                {
+                    box.push_back({i, j});
+                }
+            }
+            xarray<float> med = median_filter(u, box, stencil_boundary::periodic);
+            auto reference = [&](std::size_t i, std::size_t j)
+            {
+                std::vector<float> v;
+                for (const auto& o : box)
+                {
+                    std::ptrdiff_t ii = (std::ptrdiff_t(i) + o[0] + 120) % 120;
+                    std::ptrdiff_t jj = (std::ptrdiff_t(j) + o[1] + 90) % 90;
+                    v.push_back(u(std::size_t(ii), std::size_t(jj)));
+                }
+                std::nth_element(v.begin(), v.begin() + std::ptrdiff_t(v.size() / 2), v.end());
+                return v[v.size() / 2];
+            };
+            for (std::size_t i : {std::size_t(0), std::size_t(5), std::size_t(119)})
+            {
+                for (std::size_t j : {std::size_t(0), std::size_t(40), std::size_t(89)})
+                {
+                    EXPECT_EQ(med(i, j), reference(i, j));
+                }
+            }
+            parallel::scoped_settings settings(0, 0);
+            EXPECT_EQ(median_filter(u, box, stencil_boundary::periodic), med);
+        }
+    }
+
+    TEST(xstencil, errors)
+    {
+        xarray<double> a = {1., 2., 3.};
+        EXPECT_THROW(stencil(a, {{-1}, {1}}, {1.}), std::runtime_error);
+        EXPECT_THROW(stencil(a, {{-1, 0}}, {1.}), std::runtime_error);
+        EXPECT_THROW(stencil(a, {}, {}), std::runtime_error);
+        xarray<double> small = stencil(a, {{-2}, {2}}, {1., 1.});
+        EXPECT_EQ(small.size(), std::size_t(0));
+    }
+}
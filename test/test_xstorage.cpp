@@ -9,7 +9,11 @@
 #include "gtest/gtest.h"
 #include "xtensor/xtensor_config.hpp"
 #include "xtensor/xstorage.hpp"
+#include <cstddef>
+#include <memory>
 #include <numeric>
+#include <string>
+#include <type_traits>
 
 namespace xt
 {
@@ -47,6 +51,121 @@ namespace xt
         }
     }
 
+    TEST(uvector, capacity)
+    {
+        vector_type a(10);
+        std::iota(a.begin(), a.end(), 0.);
+        EXPECT_EQ(size_t(10), a.capacity());
+
+        a.reserve(100);
+        EXPECT_EQ(size_t(100), a.capacity());
+        EXPECT_EQ(size_t(10), a.size());
+        EXPECT_EQ(9., a[9]);
+
+        const double* data = a.data();
+        a.resize(50);
+        EXPECT_EQ(data, a.data());
+        EXPECT_EQ(9., a[9]);
+        a.resize(25);
+        EXPECT_EQ(data, a.data());
+        EXPECT_EQ(size_t(100), a.capacity());
+        EXPECT_EQ(4., a[4]);
+
+        a.shrink_to_fit();
+        EXPECT_EQ(size_t(25), a.capacity());
+        EXPECT_EQ(4., a[4]);
+
+        // a buffer that becomes mostly unused is released
+        a.resize(5);
+        EXPECT_EQ(size_t(5), a.capacity());
+        EXPECT_EQ(4., a[4]);
+
+        vector_type b;
+        b.swap(a);
+        EXPECT_EQ(size_t(5), b.capacity());
+        EXPECT_EQ(size_t(0), a.capacity());
+
+        uvector<std::string> s(2, std::string("xtensor"));
+        s.reserve(10);
+        s.resize(4);
+        EXPECT_EQ("xtensor", s[1]);
+        EXPECT_EQ("", s[3]);
+        s.resize(1);
+        s.shrink_to_fit();
+        EXPECT_EQ("xtensor", s[0]);
+    }
+
+    namespace
+    {
+        std::size_t live_buffers[2] = {0, 0};
+
+        template <class T>
+        struct tagged_allocator : std::allocator<T>
+        {
+            using propagate_on_container_copy_assignment = std::true_type;
+
+            template <class U>
+            struct rebind
+            {
+                using other = tagged_allocator<U>;
+            };
+
+            tagged_allocator(std::size_t i = 0) noexcept
+                : tag(i)
+            {
+            }
+
+            template <class U>
+            tagged_allocator(const tagged_allocator<U>& rhs) noexcept
+                : tag(rhs.tag)
+            {
+            }
+
+            T* allocate(std::size_t n)
+            {
+                ++live_buffers[tag];
+                return std::allocator<T>::allocate(n);
+            }
+
+            void deallocate(T* p, std::size_t n)
+            {
+                --live_buffers[tag];
+                std::allocator<T>::deallocate(p, n);
+            }
+
+            std::size_t tag;
+        };
+
+        template <class T, class U>
+        bool operator==(const tagged_allocator<T>& lhs, const tagged_allocator<U>& rhs) noexcept
+        {
+            return lhs.tag == rhs.tag;
+        }
+
+        template <class T, class U>
+        bool operator!=(const tagged_allocator<T>& lhs, const tagged_allocator<U>& rhs) noexcept
+        {
+            return !(lhs == rhs);
+        }
+    }
+
+    TEST(uvector, copy_assign_allocator)
+    {
+        using tagged_vector = uvector<double, tagged_allocator<double>>;
+        {
+            tagged_vector a(10, 1., tagged_allocator<double>(0));
+            tagged_vector b(5, 2., tagged_allocator<double>(1));
+            // the buffer of a is large enough, but belongs to another allocator
+            a = b;
+            EXPECT_EQ(a.get_allocator().tag, std::size_t(1));
+            EXPECT_EQ(live_buffers[0], std::size_t(0));
+            EXPECT_EQ(live_buffers[1], std::size_t(2));
+            EXPECT_EQ(a.size(), std::size_t(5));
+            EXPECT_EQ(a[4], 2.);
+        }
+        EXPECT_EQ(live_buffers[1], std::size_t(0));
+    }
+
     TEST(uvector, access)
     {
         vector_type a(10);
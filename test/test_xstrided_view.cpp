@@ -703,4 +703,53 @@ namespace xt
         EXPECT_EQ(v3(0), 3);
         EXPECT_EQ(v3(1), 5);
     }
+
+    TEST(xstrided_view, simd_interface)
+    {
+        xarray<double> a = {{0., 1., 2., 3.}, {4., 5., 6., 7.}, {8., 9., 10., 11.}};
+        auto v = strided_view(a, {all(), range(1, 3)});
+        EXPECT_TRUE(has_simd_interface<decltype(v)>::value);
+
+        xtensor<double, 2> b = {{1., 1.}, {2., 2.}, {3., 3.}};
+        xtensor<double, 2> res = v + b;
+        xtensor<double, 2> expected = {{2., 3.}, {7., 8.}, {12., 13.}};
+        EXPECT_EQ(res, expected);
+
+        v = b * 2.;
+        EXPECT_EQ(a(1, 2), 4.);
+        EXPECT_EQ(a(1, 3), 7.);
+    }
+
+    TEST(xstrided_view, reshape_strided)
+    {
+        xarray<double> a = arange<double>(24);
+        a.reshape({4, 6});
+
+        auto sv = strided_view(a, {all(), range(0, 4)});
+        std::array<std::ptrdiff_t, 3> strides;
+        EXPECT_TRUE(try_reshape_strides(sv, std::array<std::size_t, 3>({4, 2, 2}), strides));
+        EXPECT_EQ(strides[0], 6);
+        EXPECT_EQ(strides[1], 2);
+        EXPECT_EQ(strides[2], 1);
+        std::array<std::ptrdiff_t, 1> flat_strides;
+        EXPECT_FALSE(try_reshape_strides(sv, std::array<std::size_t, 1>({16}), flat_strides));
+        EXPECT_THROW(try_reshape_strides(sv, std::array<std::size_t, 1>({15}), flat_strides), std::runtime_error);
+
+        auto v = reshape_strided(sv, {4, 2, 2});
+        EXPECT_EQ(v(1, 1, 0), a(1, 2));
+        EXPECT_EQ(v(3, 1, 1), a(3, 3));
+        v(2, 0, 1) = -1.;
+        EXPECT_EQ(a(2, 1), -1.);
+        EXPECT_THROW(reshape_strided(sv, {16}), std::runtime_error);
+
+        xarray<double, layout_type::column_major> c = a;
+        auto t = reshape_strided(c, {6, 4}, layout_type::column_major);
+        xarray<double> expected = reshape_view(c, {6, 4}, layout_type::column_major);
+        EXPECT_EQ(t, expected);
+        EXPECT_THROW(reshape_strided(a, {6, 4}, layout_type::column_major), std::runtime_error);
+
+        // expressions without data interface are evaluated once
+        auto f = reshape_strided(a + 1., {2, 12});
+        EXPECT_EQ(f(1, 0), a(2, 0) + 1.);
+    }
 }
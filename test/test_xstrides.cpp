@@ -6,6 +6,9 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <limits>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "xtensor/xarray.hpp"
 #include "test_common.hpp"
@@ -77,4 +80,40 @@ namespace xt
             EXPECT_TRUE(std::equal(unrav_index.cbegin(), unrav_index.cend(), index.cbegin()));
         }
     }
-}
\ No newline at end of file
+
+    TEST(xstrides, index_divider)
+    {
+        std::vector<std::size_t> divisors = {1, 2, 3, 7, 10, 64, 641, 1000003, std::size_t(1) << 31,
+                                             (std::numeric_limits<std::size_t>::max)()};
+        std::vector<std::size_t> values = {0, 1, 2, 3, 63, 64, 65, 12345678, std::size_t(1) << 31,
+                                           (std::numeric_limits<std::size_t>::max)() - 1,
+                                           (std::numeric_limits<std::size_t>::max)()};
+        for (std::size_t d : divisors)
+        {
+            detail::index_divider divider(d);
+            for (std::size_t v : values)
+            {
+                EXPECT_EQ(divider.divide(v), v / d);
+                std::size_t n = v;
+                EXPECT_EQ(divider.divmod(n), v % d);
+                EXPECT_EQ(n, v / d);
+            }
+        }
+    }
+
+    TEST(xstrides, shape_divider)
+    {
+        std::vector<std::size_t> shape = {3, 1, 5, 4};
+        detail::shape_divider divider(shape);
+        std::vector<std::ptrdiff_t> idx(4);
+        for (std::size_t i = 0; i != 60; ++i)
+        {
+            divider.unravel(i, idx);
+            auto expected = unravel_index(i, shape, layout_type::row_major);
+            EXPECT_TRUE(std::equal(idx.cbegin(), idx.cend(), expected.cbegin()));
+            divider.unravel(i, idx, layout_type::column_major);
+            expected = unravel_index(i, shape, layout_type::column_major);
+            EXPECT_TRUE(std::equal(idx.cbegin(), idx.cend(), expected.cbegin()));
+        }
+    }
+}
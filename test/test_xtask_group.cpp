@@ -0,0 +1,116 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xreducer.hpp"
+#include "xtensor/xtask_group.hpp"
+#include "xtensor/xtensor.hpp"
+
+namespace xt
+{
+    TEST(xtask_group, assign)
+    {
+        std::size_t n = 500;
+        std::vector<xtensor<double, 1>> a(n), res(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            a[i] = arange<double>(static_cast<double>(i % 7 + 1));
+        }
+
+        task_group g;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            g.assign(res[i], a[i] * 2. + 1.);
+        }
+        EXPECT_EQ(g.size(), n);
+        g.wait();
+        EXPECT_TRUE(g.empty());
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            xtensor<double, 1> expected = a[i] * 2. + 1.;
+            EXPECT_EQ(res[i], expected);
+        }
+    }
+
+    TEST(xtask_group, dependencies)
+    {
+        std::size_t n = 200;
+        std::vector<xarray<double>> tmp(n), res(n);
+        xarray<double> a = {{1., 2.}, {3., 4.}};
+        xarray<double> total = zeros<double>({2, 2});
+
+        task_group g;
+        std::vector<task_group::task_id> last;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto t = g.assign(tmp[i], a * static_cast<double>(i));
+            last.push_back(g.assign(res[i], tmp[i] + a, {t}));
+        }
+        // tmp[i] is complete before g.run is called
+        g.run([&]()
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                total += res[i];
+            }
+        }, last);
+        g.wait();
+
+        xarray<double> expected = a * static_cast<double>(n * (n - 1) / 2) + a * static_cast<double>(n);
+        EXPECT_EQ(total, expected);
+
+        // a chain of tasks runs in order
+        std::vector<std::size_t> order;
+        task_group::task_id prev = g.run([&]() { order.push_back(0); });
+        for (std::size_t i = 1; i < 50; ++i)
+        {
+            prev = g.run([&order, i]() { order.push_back(i); }, {prev});
+        }
+        g.wait();
+        ASSERT_EQ(order.size(), std::size_t(50));
+        for (std::size_t i = 0; i < 50; ++i)
+        {
+            EXPECT_EQ(order[i], i);
+        }
+    }
+
+    TEST(xtask_group, noalias)
+    {
+        xtensor<double, 2> a = {{1., 2.}, {3., 4.}};
+        xtensor<double, 2> out = zeros<double>({2, 2});
+        double* data = out.data();
+        task_group g;
+        g.assign(noalias(out), a * a);
+        g.wait();
+        xtensor<double, 2> expected = a * a;
+        EXPECT_EQ(out, expected);
+        EXPECT_EQ(out.data(), data);
+    }
+
+    TEST(xtask_group, errors)
+    {
+        task_group g;
+        EXPECT_THROW(g.run([]() {}, {0}), std::runtime_error);
+
+        std::atomic<int> count(0);
+        auto t = g.run([]() { throw std::runtime_error("failure"); });
+        g.run([&count]() { ++count; }, {t});
+        EXPECT_THROW(g.wait(), std::runtime_error);
+        EXPECT_EQ(count.load(), 0);
+        EXPECT_TRUE(g.empty());
+    }
+}
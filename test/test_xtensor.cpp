@@ -283,4 +283,31 @@ namespace xt
         EXPECT_EQ(a.layout(), c.layout());
     }
 
+    TEST(xtensor, resize_padded)
+    {
+        xtensor<double, 2, layout_type::dynamic> a;
+        a.resize_padded({3, 5}, layout_type::row_major, 4);
+        EXPECT_EQ(a.strides()[0], 8);
+        EXPECT_EQ(a.strides()[1], 1);
+        EXPECT_EQ(a.storage().size(), 24u);
+        EXPECT_EQ(a.size(), 15u);
+        EXPECT_EQ(a.layout(), layout_type::dynamic);
+
+        xtensor<double, 2> b = {{0., 1., 2., 3., 4.}, {5., 6., 7., 8., 9.}, {10., 11., 12., 13., 14.}};
+        a = b + 1.;
+        EXPECT_EQ(a(0, 4), 5.);
+        EXPECT_EQ(a(2, 0), 11.);
+        EXPECT_EQ(a.storage()[8], 6.);
+
+        xtensor<double, 2> c = a * 2.;
+        EXPECT_EQ(c, 2. * (b + 1.));
+
+        xtensor<double, 2, layout_type::dynamic> d;
+        d.resize_padded({3, 4}, layout_type::column_major, 4);
+        EXPECT_EQ(d.strides()[1], 4);
+        EXPECT_EQ(d.layout(), layout_type::column_major);
+
+        xtensor<double, 2> e;
+        EXPECT_THROW(e.resize_padded({3, 5}), std::runtime_error);
+    }
 }
@@ -0,0 +1,83 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cmath>
+#include "gtest/gtest.h"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xreducer.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xtiled.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    TEST(xtiled, common_subexpression)
+    {
+        xarray<double> a = xt::linspace<double>(0., 1., 5000);
+        a.resize({50, 100});
+        xarray<double> b = 2. * a + 1.;
+
+        xarray<double> res;
+        tiled_assign(res, [](auto&& ab) { return ab + sin(ab); }, a * b);
+        xarray<double> expected = a * b + sin(a * b);
+        ASSERT_EQ(res.shape(), expected.shape());
+        EXPECT_TRUE(allclose(res, expected));
+    }
+
+    TEST(xtiled, broadcast)
+    {
+        xtensor<double, 2> a = {{1., 2., 3.}, {4., 5., 6.}};
+        xtensor<double, 1> b = {1., 2., 3.};
+
+        xtensor<double, 2> res;
+        tiled_assign(res, [](auto&& x, auto&& y) { return x * y + x; }, a, b);
+        xtensor<double, 2> expected = a * b + a;
+        EXPECT_EQ(res, expected);
+
+        xtensor<double, 2> c = zeros<double>({2, 6});
+        auto v = view(c, all(), range(0, 3));
+        tiled_assign(v, [](auto&& x) { return 2. * x; }, a);
+        EXPECT_EQ(c(1, 2), 12.);
+        EXPECT_EQ(c(1, 3), 0.);
+        xtensor<double, 1> d = {1., 2.};
+        EXPECT_THROW(tiled_assign(v, [](auto&& x) { return x; }, d), std::runtime_error);
+    }
+
+    TEST(xtiled, reduce_lanes)
+    {
+        xarray<double> a = {{{1., 2., 3.}, {4., 5., 6.}}, {{7., 8., 9.}, {10., 11., 12.}}};
+
+        xarray<double> d;
+        reduce_lanes(d, a, 2, [](auto&& row) { return sum(exp(row - amax(row)())); });
+        // every row holds consecutive values
+        double denominator = std::exp(-2.) + std::exp(-1.) + 1.;
+        ASSERT_EQ(d.dimension(), std::size_t(2));
+        EXPECT_TRUE(allclose(d, xarray<double>({{denominator, denominator}, {denominator, denominator}})));
+
+        xtensor<double, 2> m;
+        reduce_lanes(m, a, 1, [](auto&& col) { return amax(col)(); });
+        EXPECT_EQ(m, xtensor<double, 2>(amax(a, {1})));
+        EXPECT_THROW(reduce_lanes(m, a, 3, [](auto&& col) { return amax(col)(); }), std::runtime_error);
+    }
+
+    TEST(xtiled, transform_lanes)
+    {
+        xarray<double> a = {{{1., 2., 3.}, {4., 6., 8.}}, {{7., 8., 9.}, {10., 11., 12.}}};
+
+        xarray<double> s;
+        transform_lanes(s, a, 1, [](auto&& col) { return col - amin(col)(); });
+        xarray<double> expected = {{{0., 0., 0.}, {3., 4., 5.}}, {{0., 0., 0.}, {3., 3., 3.}}};
+        EXPECT_EQ(s, expected);
+
+        transform_lanes(s, a, 2, [](auto&& row) { return row / sum(row)(); });
+        EXPECT_TRUE(allclose(sum(s, {2}), ones<double>({2, 2})));
+        EXPECT_DOUBLE_EQ(s(0, 1, 2), 8. / 18.);
+    }
+}
@@ -0,0 +1,112 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xtracked.hpp"
+#include "xtensor/xvectorize.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    using tracked_array = xtracked<xarray<double>>;
+
+    TEST(xtracked, region)
+    {
+        tracked_array a(zeros<double>({10, 8}), {4, 4});
+        EXPECT_EQ(a.grid_shape(), std::vector<std::size_t>({3, 2}));
+        EXPECT_EQ(a.block_count(), std::size_t(6));
+        EXPECT_FALSE(a.is_dirty());
+
+        a.region(range(1, 3), 5) = 1.;
+        EXPECT_EQ(a(2, 5), 1.);
+        EXPECT_EQ(a.dirty_blocks(), std::vector<std::size_t>({1}));
+
+        a.region(9) = 2.;
+        EXPECT_EQ(a.dirty_blocks(), std::vector<std::size_t>({1, 4, 5}));
+
+        std::vector<std::size_t> origin, box;
+        a.block_box(5, origin, box);
+        EXPECT_EQ(origin, std::vector<std::size_t>({8, 4}));
+        EXPECT_EQ(box, std::vector<std::size_t>({2, 4}));
+
+        a.clear_dirty();
+        a.region(newaxis(), all(), keep(0, 7)) = 3.;
+        EXPECT_EQ(a.dirty_blocks(), std::vector<std::size_t>({0, 1, 2, 3, 4, 5}));
+
+        a.clear_dirty();
+        a.mark_dirty(range(4, 8), range(0, 4));
+        EXPECT_EQ(a.dirty_blocks(), std::vector<std::size_t>({2}));
+
+        a.clear_dirty();
+        a = ones<double>({10, 8});
+        EXPECT_EQ(a.dirty_blocks().size(), a.block_count());
+
+        EXPECT_THROW(tracked_array(zeros<double>({4, 4}), {2}), std::runtime_error);
+        EXPECT_THROW(tracked_array(zeros<double>({4, 4}), {2, 0}), std::runtime_error);
+    }
+
+    TEST(xtracked, incremental_assign)
+    {
+        std::size_t count = 0;
+        auto twice = vectorize([&count](double x) { ++count; return 2. * x; });
+        xarray<double> init = arange<double>(64.);
+        init.reshape({8, 8});
+        tracked_array a(init, {4, 4});
+        tracked_array b(ones<double>({8, 8}), {4, 4});
+        xarray<double> c = twice(a.get()) + b.get();
+        count = 0;
+
+        a.region(5, range(0, 2)) = -1.;
+        b.region(0, 0) = 3.;
+        incremental_assign(c, twice(a.get()) + b.get(), a, b);
+        EXPECT_EQ(count, std::size_t(32));
+        xarray<double> expected = 2. * a.get() + b.get();
+        EXPECT_EQ(c, expected);
+        a.clear_dirty();
+        b.clear_dirty();
+
+        count = 0;
+        incremental_assign(c, twice(a.get()) + b.get(), a, b);
+        EXPECT_EQ(count, std::size_t(0));
+
+        // a destination of another shape is assigned in full
+        xarray<double> d;
+        incremental_assign(d, twice(a.get()) + b.get(), a, b);
+        EXPECT_EQ(d, expected);
+
+        tracked_array small(zeros<double>({4, 4}), {4, 4});
+        EXPECT_THROW(incremental_assign(c, a.get() + 1., a, small), std::runtime_error);
+    }
+
+    TEST(xtracked, propagation)
+    {
+        tracked_array a(zeros<double>({6, 6}), {2, 2});
+        tracked_array b(zeros<double>({6, 6}), {3, 3});
+        xtensor<double, 2> c = zeros<double>({6, 6});
+
+        a.region(range(2, 4), range(2, 4)) = 4.;
+        incremental_assign(b, a.get() + 1., a);
+        EXPECT_EQ(b.dirty_blocks(), std::vector<std::size_t>({0, 1, 2, 3}));
+        EXPECT_EQ(b(0, 0), 0.);
+        EXPECT_EQ(b(3, 3), 5.);
+        a.clear_dirty();
+
+        incremental_assign(c, b.get() * 2., b);
+        xtensor<double, 2> expected = zeros<double>({6, 6});
+        view(expected, range(2, 4), range(2, 4)) = 10.;
+        EXPECT_EQ(c, expected);
+    }
+}
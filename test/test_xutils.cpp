@@ -7,14 +7,24 @@
 ****************************************************************************/
 
 #include "gtest/gtest.h"
+#include <algorithm>
+#include <cmath>
 #include <initializer_list>
 #include <type_traits>
 #include <tuple>
+#include <typeinfo>
 #include <complex>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
 
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
 #include "xtensor/xfixed.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xnoalias.hpp"
 #include "xtensor/xstrided_view.hpp"
 #include "xtensor/xshape.hpp"
 #include "xtensor/xutils.hpp"
@@ -277,6 +287,214 @@ namespace xt
         EXPECT_NO_THROW(arr_t c = a);
     }
 
+    TEST(utils, arena_allocator)
+    {
+        using arr_t = xarray<double, layout_type::row_major, arena_allocator<double>>;
+
+        arr_t a = {{1, 2, 3}, {5, 6, 7}};
+        arr_t escaped;
+        {
+            arena_scope scope;
+            arr_t b = a + 1.;
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b.data()) % 64, std::uintptr_t(0));
+            for (std::size_t i = 0; i < 100; ++i)
+            {
+                arr_t tmp = b * double(i);
+                EXPECT_EQ(tmp(1, 2), 8. * double(i));
+            }
+            {
+                arena_scope inner;
+                escaped = b * 2.;
+            }
+        }
+        // memory allocated inside the scope remains valid after its end
+        EXPECT_EQ(escaped(1, 2), 16.);
+        arr_t c = escaped - a;
+        EXPECT_EQ(c(0, 0), 3.);
+    }
+
+    TEST(utils, allocation_statistics)
+    {
+        using arr_t = xarray<double, layout_type::row_major,
+                             tracking_allocator<double, std::allocator<double>, alloc_tracking::count>>;
+        using iarr_t = xarray<int, layout_type::row_major,
+                              tracking_allocator<int, std::allocator<int>, alloc_tracking::count>>;
+
+        alloc_tracking::reset_statistics();
+        const alloc_tracking::statistics_type& stats = alloc_tracking::statistics<double>();
+        std::size_t live = stats.live_bytes.load();
+        {
+            arr_t a = {{1, 2, 3}, {5, 6, 7}};
+            iarr_t b = {1, 2};
+            {
+                arr_t c = a + 1.;
+                EXPECT_EQ(stats.live_bytes.load(), live + 12 * sizeof(double));
+            }
+            EXPECT_EQ(stats.allocations.load(), std::size_t(2));
+            EXPECT_EQ(stats.deallocations.load(), std::size_t(1));
+            EXPECT_EQ(stats.allocated_bytes.load(), 12 * sizeof(double));
+            EXPECT_EQ(stats.peak_bytes.load(), live + 12 * sizeof(double));
+            EXPECT_EQ(alloc_tracking::statistics<int>().allocated_bytes.load(), 2 * sizeof(int));
+            EXPECT_GE(alloc_tracking::statistics().allocations.load(), std::size_t(3));
+
+            auto by_type = alloc_tracking::statistics_by_type();
+            auto it = std::find_if(by_type.begin(), by_type.end(),
+                                   [](const auto& entry) { return entry.first == typeid(double).name(); });
+            ASSERT_TRUE(it != by_type.end());
+            EXPECT_EQ(it->second, &stats);
+
+            {
+                alloc_tracking::no_allocation_guard guard;
+                EXPECT_NO_THROW(a += 1.);
+                EXPECT_THROW(arr_t d = a * 2., std::runtime_error);
+            }
+            EXPECT_NO_THROW(arr_t d = a * 2.);
+        }
+        EXPECT_EQ(stats.live_bytes.load(), live);
+    }
+
+    TEST(utils, pool_allocator)
+    {
+        using allocator_type = tracking_allocator<double, pool_allocator<double>, alloc_tracking::count>;
+        using tensor_type = xtensor_container<uvector<double, allocator_type>, 3, layout_type::row_major>;
+
+        tensor_type a = xt::ones<double>({10, 20, 30});
+        alloc_tracking::reset_statistics();
+        alloc_tracking::enable();
+        for (std::size_t i = 0; i < 10; ++i)
+        {
+            tensor_type tmp = a * double(i);
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(tmp.data()) % 64, std::uintptr_t(0));
+            EXPECT_EQ(tmp(9, 19, 29), double(i));
+        }
+        alloc_tracking::disable();
+
+        alloc_tracking::statistics_type& stats = alloc_tracking::statistics();
+        EXPECT_EQ(stats.allocations.load(), std::size_t(10));
+        EXPECT_EQ(stats.deallocations.load(), std::size_t(10));
+        // the buffer freed by an iteration is recycled by the next one
+        EXPECT_GE(stats.pool_hits.load(), std::size_t(9));
+        release_pooled_memory();
+    }
+
+    TEST(utils, allocation_free_operations)
+    {
+        using allocator_type = tracking_allocator<double, std::allocator<double>, alloc_tracking::count>;
+        using tensor_type = xtensor_container<uvector<double, allocator_type>, 2, layout_type::row_major>;
+        using vector_type = xtensor_container<uvector<double, allocator_type>, 1, layout_type::row_major>;
+
+        tensor_type a = {{1., 2., 3.}, {4., 5., 6.}};
+        tensor_type b = {{6., 5., 4.}, {3., 2., 1.}};
+        tensor_type res = xt::zeros<double>({2, 3});
+        vector_type row = xt::zeros<double>({3});
+        xtensor_fixed<double, xshape<2, 3>> f = {{1., 1., 1.}, {2., 2., 2.}};
+        xtensor_fixed<double, xshape<2, 3>> fres;
+
+        alloc_tracking::reset_statistics();
+        {
+            alloc_tracking::no_allocation_guard guard;
+            // assignments into preallocated containers
+            EXPECT_NO_THROW(noalias(res) = a + b * 2.);
+            EXPECT_NO_THROW(res = a - b);
+            EXPECT_NO_THROW(res += a);
+            EXPECT_NO_THROW(res *= 2.);
+            // views
+            EXPECT_NO_THROW(noalias(row) = view(a, 1, all()) + view(b, 0, all()));
+            EXPECT_NO_THROW(view(res, 0, all()) = view(a, 1, all()));
+            EXPECT_NO_THROW(view(res, all(), range(0, 2)) += 1.);
+            // fixed-size math and lazy reductions
+            EXPECT_NO_THROW(fres = f * f + 1.);
+            EXPECT_NO_THROW(noalias(res) = a * f);
+            EXPECT_NO_THROW(noalias(row) = sum(a, {0}));
+            // an aliased operand needs a temporary
+            EXPECT_THROW(res = a + res, std::runtime_error);
+        }
+        EXPECT_EQ(alloc_tracking::statistics<double>().allocations.load(), std::size_t(0));
+        EXPECT_EQ(res(1, 2), 12.);
+        EXPECT_EQ(row(2), 9.);
+        EXPECT_EQ(fres(1, 0), 5.);
+    }
+
+    TEST(utils, huge_page_allocator)
+    {
+        using arr_t = xarray<double, layout_type::row_major, huge_page_allocator<double>>;
+
+        arr_t small = {{1, 2, 3}, {5, 6, 7}};
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(small.data()) % 64, std::uintptr_t(0));
+
+        arr_t large = xt::ones<double>({512, 1024});
+        large += small(1, 2);
+#if !defined(_WIN32)
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(large.data()) % XTENSOR_HUGE_PAGE_SIZE, std::uintptr_t(0));
+#endif
+        EXPECT_EQ(large(511, 1023), 8.);
+        large.resize({1024, 1024});
+        large.fill(2.);
+        EXPECT_EQ(large(1023, 1023), 2.);
+    }
+
+#if defined(XTENSOR_USE_NUMA)
+    TEST(utils, numa_interleave_allocator)
+    {
+        using arr_t = xarray<double, layout_type::row_major, numa_interleave_allocator<double>>;
+
+        // the small allocations are not interleaved, all are aligned
+        arr_t small = {{1, 2, 3}, {5, 6, 7}};
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(small.data()) % 64, std::uintptr_t(0));
+
+        arr_t large = xt::ones<double>({512, 1024});
+        EXPECT_GE(large.size() * sizeof(double), std::size_t(XTENSOR_NUMA_THRESHOLD));
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(large.data()) % 64, std::uintptr_t(0));
+        large += small(1, 2);
+        EXPECT_EQ(large(511, 1023), 8.);
+        large.resize({2, 2});
+        large.fill(2.);
+        EXPECT_EQ(large(1, 1), 2.);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(large.data()) % 64, std::uintptr_t(0));
+
+        numa_interleave_allocator<double> alloc;
+        EXPECT_EQ(alloc.allocate(0), nullptr);
+        EXPECT_THROW(alloc.allocate(std::size_t(-1) / 4), std::bad_alloc);
+    }
+#endif
+
+    TEST(utils, zero_page_allocator)
+    {
+        using alloc_t = zero_page_allocator<double>;
+        using arr_t = xarray<double, layout_type::row_major, alloc_t>;
+        EXPECT_TRUE(allocates_zeros<alloc_t>::value);
+        EXPECT_FALSE(allocates_zeros<std::allocator<double>>::value);
+        // the pages of zeroed buffers are not touched with XTENSOR_PARALLEL_FIRST_TOUCH
+        EXPECT_FALSE(detail::first_touches_pages<alloc_t>::value);
+        EXPECT_TRUE(detail::first_touches_pages<std::allocator<double>>::value);
+
+        auto small = zeros_container<double>(std::vector<std::size_t>({2, 3}));
+        EXPECT_EQ(small, zeros<double>({2, 3}));
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(small.data()) % 64, std::uintptr_t(0));
+
+        auto large = zeros_container<double>({512, 1024});
+        EXPECT_EQ(large.dimension(), std::size_t(2));
+        EXPECT_EQ(large(511, 1023), 0.);
+        large(100, 7) = 3.;
+        EXPECT_EQ(sum(large)(), 3.);
+
+        // the assignment of zeros is skipped, the other ones are not
+        EXPECT_TRUE(detail::holds_zero_fill<alloc_t>(zeros<double>({2, 3})));
+        EXPECT_FALSE(detail::holds_zero_fill<alloc_t>(ones<double>({2, 3})));
+        EXPECT_FALSE(detail::holds_zero_fill<alloc_t>(broadcast(-0., {2, 3})));
+        EXPECT_FALSE(detail::holds_zero_fill<std::allocator<double>>(zeros<double>({2, 3})));
+        arr_t z = zeros<double>({300, 200});
+        EXPECT_EQ(z.shape()[1], std::size_t(200));
+        EXPECT_EQ(z(299, 199), 0.);
+        arr_t nz = broadcast(-0., {4, 5});
+        EXPECT_TRUE(std::signbit(nz(3, 4)));
+        arr_t scalar = zeros<double>(std::vector<std::size_t>());
+        EXPECT_EQ(scalar(), 0.);
+
+        xtensor<int, 1, layout_type::row_major, zero_page_allocator<int>> ones_t = ones<int>({70000});
+        EXPECT_EQ(ones_t(69999), 1);
+    }
+
     TEST(utils, static_dimension)
     {
         std::ptrdiff_t sdim = static_dimension<std::vector<int>>::value;
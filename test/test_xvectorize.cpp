@@ -9,6 +9,7 @@
 #include "gtest/gtest.h"
 
 #include "xtensor/xarray.hpp"
+#include "xtensor/xassign.hpp"
 #include "xtensor/xvectorize.hpp"
 
 namespace xt
@@ -68,4 +69,33 @@ namespace xt
         a = vecfunc();
         EXPECT_EQ(size_t(0), a.dimension());
     }
+
+    TEST(xvectorize, generic_lambda)
+    {
+        auto vec_lambda = vectorize([](const auto& x, const auto& y) -> decltype(x * y + x) { return x * y + x; });
+        shape_type shape = {3, 7};
+        xarray<double> a(shape, 1.5);
+        xarray<double> b(shape, 2.);
+        a(2, 6) = 3.;
+        auto f = vec_lambda(a, b);
+        xarray<double> c = f;
+        EXPECT_EQ(c(0, 0), 4.5);
+        EXPECT_EQ(c(2, 6), 9.);
+
+        using assign_traits = xassign_traits<xarray<double>, decltype(f)>;
+#if XTENSOR_USE_XSIMD
+        EXPECT_TRUE(assign_traits::simd_assign());
+#endif
+
+        // batches cannot be cast to integers, the expression
+        // is evaluated element by element
+        auto vec_trunc = vectorize([](const auto& x) -> decltype(static_cast<double>(static_cast<long>(x))) {
+            return static_cast<double>(static_cast<long>(x));
+        });
+        auto g = vec_trunc(a + b);
+        xarray<double> d = g;
+        EXPECT_EQ(d(0, 0), 3.);
+        EXPECT_EQ(d(2, 6), 5.);
+        EXPECT_FALSE((xassign_traits<xarray<double>, decltype(g)>::simd_assign()));
+    }
 }
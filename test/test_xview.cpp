@@ -1072,6 +1072,55 @@ namespace xt
         EXPECT_EQ(v1, exp_v1);
     }
 
+    TEST(xview, keep_drop_runs)
+    {
+        xarray<double> a = arange<double>(120.);
+        a.resize({40, 3});
+
+        std::vector<int> indices;
+        for (int i = 0; i < 10; ++i)
+        {
+            indices.push_back(i);
+        }
+        for (int i = 20; i < 40; ++i)
+        {
+            indices.push_back(i);
+        }
+
+        auto kv = view(a, keep(indices), all());
+        EXPECT_EQ(std::get<0>(kv.slices()).runs(), (svector<int>{0, 10, 30}));
+        xarray<double> k = kv;
+        ASSERT_EQ(k.shape()[0], 30u);
+        for (std::size_t i = 0; i < 30; ++i)
+        {
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                EXPECT_EQ(k(i, j), a(static_cast<std::size_t>(indices[i]), j));
+            }
+        }
+
+        auto dv = view(a, drop(10, 11, 12, 13, 14, 15, 16, 17, 18, 19), all());
+        EXPECT_EQ(std::get<0>(dv.slices()).runs(), (svector<std::ptrdiff_t>{0, 10, 30}));
+        xarray<double> d = dv;
+        EXPECT_EQ(d, k);
+
+        xarray<double> c = zeros<double>({40, 3});
+        view(c, keep(indices), all()) = k;
+        for (std::size_t i = 0; i < 40; ++i)
+        {
+            double expected = (i < 10 || i >= 20) ? a(i, 1) : 0.;
+            EXPECT_EQ(c(i, 1), expected);
+        }
+
+        xarray<double> b = arange<double>(120.);
+        b.resize({3, 40});
+        xarray<double> t = view(b, 1, keep(indices));
+        ASSERT_EQ(t.dimension(), 1u);
+        EXPECT_EQ(t(0), b(1, 0));
+        EXPECT_EQ(t(10), b(1, 20));
+        EXPECT_EQ(t(29), b(1, 39));
+    }
+
     TEST(xview, mixed_types)
     {
         xt::xarray<std::uint8_t> input;
@@ -1302,4 +1351,59 @@ namespace xt
         auto result = xt::view(str_view, xt::all(), xt::all());
         EXPECT_EQ(result(0), 0.f);
     }
+
+    TEST(xview, runtime_contiguous_assign)
+    {
+        xtensor<double, 2> a = {{0., 1., 2.}, {3., 4., 5.}, {6., 7., 8.}, {9., 10., 11.}};
+        std::size_t last = 3;
+        auto v = view(a, all(), range(0, last));
+        EXPECT_EQ(v.layout(), layout_type::row_major);
+
+        xtensor<double, 2> b = v + 1.;
+        EXPECT_EQ(b, a + 1.);
+
+        v = b * 2.;
+        EXPECT_EQ(a(0, 0), 2.);
+        EXPECT_EQ(a(3, 2), 24.);
+
+        auto w = view(a, all(), range(1, last));
+        EXPECT_EQ(w.layout(), layout_type::dynamic);
+        w = view(b, all(), range(0, 2)) * 0.;
+        EXPECT_EQ(a(1, 0), 8.);
+        EXPECT_EQ(a(1, 1), 0.);
+    }
+
+    TEST(xview, prefetched_assign)
+    {
+        // the outer strides span more than a page: the next rows and the
+        // elements ahead of the runs are prefetched
+        std::size_t rows = 64;
+        std::size_t cols = 1024;
+        xtensor<double, 2> a = xt::reshape_view(xt::arange<double>(double(rows * cols)), {rows, cols});
+
+        auto v = view(a, range(0, rows, 2), range(0, 8));
+        xtensor<double, 2> b = v + 1.;
+        bool equal = true;
+        for (std::size_t i = 0; i < rows / 2; ++i)
+        {
+            for (std::size_t j = 0; j < 8; ++j)
+            {
+                equal = equal && b(i, j) == a(2 * i, j) + 1.;
+            }
+        }
+        EXPECT_TRUE(equal);
+
+        xtensor<double, 2> c = zeros<double>({rows, cols});
+        auto w = view(c, range(0, rows, 2), range(0, 8));
+        w = b;
+        EXPECT_EQ(w, b);
+        EXPECT_EQ(c(1, 0), 0.);
+
+        xtensor<double, 2> t = transpose(a);
+        EXPECT_EQ(t(5, 3), a(3, 5));
+        EXPECT_EQ(t(cols - 1, rows - 1), a(rows - 1, cols - 1));
+        auto ct = transpose(c);
+        ct = transpose(a);
+        EXPECT_EQ(c, a);
+    }
 }